@@ -18,7 +18,9 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "xls/codegen/codegen_pass.h"
+#include "xls/ir/block.h"
 #include "xls/codegen/register_legalization_pass.h"
 #include "xls/codegen/vast.h"
 #include "xls/common/logging/logging.h"
@@ -923,6 +925,7 @@ class CloneNodesIntoBlockHandler {
                                     int64_t stage) {
     Function* as_func = dynamic_cast<Function*>(function_base_);
 
+    std::vector<Node*> live_out_nodes;
     for (Node* function_base_node : function_base_->nodes()) {
       if (schedule.cycle(function_base_node) > stage) {
         continue;
@@ -943,16 +946,37 @@ class CloneNodesIntoBlockHandler {
       };
 
       if (is_live_out_of_stage(function_base_node)) {
-        Node* node = node_map_.at(function_base_node);
+        live_out_nodes.push_back(function_base_node);
+      }
+    }
 
-        XLS_ASSIGN_OR_RETURN(
-            Node * node_after_stage,
-            CreatePipelineRegistersForNode(
-                PipelineSignalName(node->GetName(), stage), node,
-                result_.pipeline_registers.at(stage), block_));
+    // Precompute the (already unique) register names for every live-out node
+    // and create all of the stage's registers in one batch rather than one
+    // map insertion at a time.
+    std::vector<Block::RegisterSpec> register_specs;
+    for (Node* function_base_node : live_out_nodes) {
+      Node* node = node_map_.at(function_base_node);
+      AppendPipelineRegisterSpecs(PipelineSignalName(node->GetName(), stage),
+                                  node, &register_specs);
+    }
+    XLS_ASSIGN_OR_RETURN(std::vector<Register*> registers,
+                         block_->AddRegisters(register_specs));
 
-        node_map_[function_base_node] = node_after_stage;
-      }
+    int64_t register_index = 0;
+    for (Node* function_base_node : live_out_nodes) {
+      Node* node = node_map_.at(function_base_node);
+      int64_t register_count = NumPipelineRegistersForNode(node);
+
+      XLS_ASSIGN_OR_RETURN(
+          Node * node_after_stage,
+          CreatePipelineRegistersForNode(
+              node,
+              absl::MakeConstSpan(registers)
+                  .subspan(register_index, register_count),
+              result_.pipeline_registers.at(stage)));
+      register_index += register_count;
+
+      node_map_[function_base_node] = node_after_stage;
     }
 
     return absl::OkStatus();
@@ -1141,14 +1165,13 @@ class CloneNodesIntoBlockHandler {
     return node->CloneInNewFunction(new_operands, block_);
   }
 
-  // Create a pipeline register for the given node.
+  // Creates the read and write operations for a pipeline register (already
+  // created via Block::AddRegisters) holding the given node.
   //
   // Returns a PipelineRegister whose reg_read field can be used
   // to chain dependent ops to.
-  absl::StatusOr<PipelineRegister> CreatePipelineRegister(
-      absl::string_view name, Node* node, Block* block) {
-    XLS_ASSIGN_OR_RETURN(Register * reg,
-                         block_->AddRegister(name, node->GetType()));
+  absl::StatusOr<PipelineRegister> CreatePipelineRegister(Register* reg,
+                                                          Node* node) {
     XLS_ASSIGN_OR_RETURN(
         RegisterWrite * reg_write,
         block_->MakeNode<RegisterWrite>(node->loc(), node,
@@ -1161,6 +1184,39 @@ class CloneNodesIntoBlockHandler {
     return PipelineRegister{reg, reg_write, reg_read};
   }
 
+  // Returns the number of pipeline registers CreatePipelineRegistersForNode
+  // creates for the given node: one per top-level tuple element for tuples
+  // with zero-width elements (which are split), otherwise one.
+  int64_t NumPipelineRegistersForNode(Node* node) {
+    Type* node_type = node->GetType();
+    if (node_type->IsTuple() &&
+        HasZeroWidthType(node_type->AsTupleOrDie())) {
+      return node_type->AsTupleOrDie()->size();
+    }
+    return 1;
+  }
+
+  // Appends the register specs (names and types) of the pipeline registers
+  // for the given node to `specs`; one spec per register counted by
+  // NumPipelineRegistersForNode(). The specs of a whole stage are created in
+  // one Block::AddRegisters() batch.
+  void AppendPipelineRegisterSpecs(absl::string_view base_name, Node* node,
+                                   std::vector<Block::RegisterSpec>* specs) {
+    Type* node_type = node->GetType();
+    if (node_type->IsTuple() &&
+        HasZeroWidthType(node_type->AsTupleOrDie())) {
+      TupleType* tuple_type = node_type->AsTupleOrDie();
+      for (int64_t i = 0; i < tuple_type->size(); ++i) {
+        specs->push_back(Block::RegisterSpec{
+            absl::StrFormat("%s_index%d", base_name, i),
+            tuple_type->element_type(i)});
+      }
+      return;
+    }
+    specs->push_back(
+        Block::RegisterSpec{std::string(base_name), node_type});
+  }
+
   // Returns true if tuple_type has a zero width element at the top level.
   bool HasZeroWidthType(TupleType* tuple_type) {
     XLS_CHECK(tuple_type != nullptr);
@@ -1174,7 +1230,9 @@ class CloneNodesIntoBlockHandler {
     return false;
   }
 
-  // Creates pipeline registers for a given node.
+  // Creates the read and write operations of the pipeline registers for a
+  // given node. `registers` holds the node's registers, batch-created from
+  // the specs produced by AppendPipelineRegisterSpecs().
   //
   // Depending on the type of node, multiple pipeline registers
   // may be created.
@@ -1184,8 +1242,8 @@ class CloneNodesIntoBlockHandler {
   //     the same type as the input node is returned.
   //
   absl::StatusOr<Node*> CreatePipelineRegistersForNode(
-      absl::string_view base_name, Node* node,
-      std::vector<PipelineRegister>& pipeline_registers_list, Block* block) {
+      Node* node, absl::Span<Register* const> registers,
+      std::vector<PipelineRegister>& pipeline_registers_list) {
     // As a special case, check if the node is a tuple
     // containing types that are of zero-width.  If so, separate them out so
     // that future optimization passes can remove them.
@@ -1204,10 +1262,9 @@ class CloneNodesIntoBlockHandler {
           XLS_ASSIGN_OR_RETURN(Node * split_node, block_->MakeNode<TupleIndex>(
                                                       node->loc(), node, i));
 
-          XLS_ASSIGN_OR_RETURN(PipelineRegister pipe_reg,
-                               CreatePipelineRegister(
-                                   absl::StrFormat("%s_index%d", base_name, i),
-                                   split_node, block));
+          XLS_ASSIGN_OR_RETURN(
+              PipelineRegister pipe_reg,
+              CreatePipelineRegister(registers[i], split_node));
 
           split_registers.at(i) = pipe_reg.reg_read;
           pipeline_registers_list.push_back(pipe_reg);
@@ -1224,7 +1281,7 @@ class CloneNodesIntoBlockHandler {
 
     // Create a single register to store the node
     XLS_ASSIGN_OR_RETURN(PipelineRegister pipe_reg,
-                         CreatePipelineRegister(base_name, node, block));
+                         CreatePipelineRegister(registers.front(), node));
 
     pipeline_registers_list.push_back(pipe_reg);
     return pipe_reg.reg_read;
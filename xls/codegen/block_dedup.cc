@@ -0,0 +1,141 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/codegen/block_dedup.h"
+
+#include <cstdint>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "xls/common/logging/logging.h"
+#include "xls/ir/instantiation.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/register.h"
+
+namespace xls {
+namespace verilog {
+namespace {
+
+// Returns whether the character can appear in an IR identifier.
+bool IsNameChar(char c) {
+  return absl::ascii_isalnum(c) || c == '_' || c == '.';
+}
+
+// Rewrites the identifier tokens of the block's text IR into a canonical
+// form. Tokens with an entry in `fixed_renames` take that replacement; tokens
+// in `renameable` are numbered "$<k>" in order of first appearance; all other
+// tokens (port names, literal values, attribute keywords) pass through
+// unchanged. Text inside double quotes (e.g. trace format strings) is left
+// verbatim so a message is never conflated with a signal name.
+std::string CanonicalizeNames(
+    absl::string_view text,
+    const absl::flat_hash_map<std::string, std::string>& fixed_renames,
+    const absl::flat_hash_set<std::string>& renameable) {
+  std::string result;
+  result.reserve(text.size());
+  absl::flat_hash_map<std::string, std::string> numbering;
+  bool in_quotes = false;
+  const int64_t size = static_cast<int64_t>(text.size());
+  for (int64_t i = 0; i < size;) {
+    char c = text[i];
+    if (c == '"') {
+      in_quotes = !in_quotes;
+    }
+    if (in_quotes || !IsNameChar(c)) {
+      result.push_back(c);
+      ++i;
+      continue;
+    }
+    int64_t start = i;
+    while (i < size && IsNameChar(text[i])) {
+      ++i;
+    }
+    std::string token(text.substr(start, i - start));
+    auto fixed_it = fixed_renames.find(token);
+    if (fixed_it != fixed_renames.end()) {
+      absl::StrAppend(&result, fixed_it->second);
+      continue;
+    }
+    if (renameable.contains(token)) {
+      auto [it, inserted] =
+          numbering.insert({token, absl::StrCat("$", numbering.size())});
+      absl::StrAppend(&result, it->second);
+      continue;
+    }
+    absl::StrAppend(&result, token);
+  }
+  return result;
+}
+
+}  // namespace
+
+std::string BlockStructuralFingerprint(
+    Block* block, const absl::flat_hash_map<Block*, Block*>& representatives) {
+  // Names of constructs which are internal to the generated module and so are
+  // immaterial to its structure: the block itself, instantiation instance
+  // names, register names, and the names of all non-port nodes.
+  absl::flat_hash_set<std::string> renameable;
+  renameable.insert(block->name());
+  // Instantiated blocks are identified by representative so that equivalent
+  // submodules do not make their (equivalent) parents appear distinct.
+  absl::flat_hash_map<std::string, std::string> fixed_renames;
+  for (xls::Instantiation* instantiation : block->GetInstantiations()) {
+    renameable.insert(instantiation->name());
+    if (auto* block_instantiation =
+            dynamic_cast<BlockInstantiation*>(instantiation)) {
+      Block* instantiated = block_instantiation->instantiated_block();
+      auto it = representatives.find(instantiated);
+      if (it != representatives.end() && it->second != instantiated) {
+        fixed_renames[instantiated->name()] = it->second->name();
+      }
+    }
+  }
+  for (Register* reg : block->GetRegisters()) {
+    renameable.insert(reg->name());
+  }
+  for (Node* node : block->nodes()) {
+    if (node->Is<InputPort>() || node->Is<OutputPort>()) {
+      continue;
+    }
+    renameable.insert(node->GetName());
+  }
+  return CanonicalizeNames(block->DumpIr(), fixed_renames, renameable);
+}
+
+absl::flat_hash_map<Block*, Block*> DeduplicateBlocks(
+    absl::Span<Block* const> blocks) {
+  absl::flat_hash_map<Block*, Block*> representatives;
+  absl::flat_hash_map<std::string, Block*> by_fingerprint;
+  for (Block* block : blocks) {
+    std::string fingerprint =
+        BlockStructuralFingerprint(block, representatives);
+    auto [it, inserted] = by_fingerprint.insert({fingerprint, block});
+    representatives[block] = it->second;
+    if (!inserted) {
+      XLS_VLOG(2) << absl::StreamFormat(
+          "Block `%s` is structurally equivalent to block `%s`",
+          block->name(), it->second->name());
+    }
+  }
+  return representatives;
+}
+
+}  // namespace verilog
+}  // namespace xls
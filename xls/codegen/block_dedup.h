@@ -0,0 +1,55 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_CODEGEN_BLOCK_DEDUP_H_
+#define XLS_CODEGEN_BLOCK_DEDUP_H_
+
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
+#include "xls/ir/block.h"
+
+namespace xls {
+namespace verilog {
+
+// Structural deduplication of blocks for codegen. Instantiating the same DSLX
+// parametric multiple times produces distinct but structurally identical
+// Block objects, each of which would be emitted as its own (identical modulo
+// names) Verilog module. These utilities detect such blocks so codegen can
+// emit one module definition and instantiate it multiply.
+
+// Returns a fingerprint of the block's structure: two blocks with equal
+// fingerprints differ at most in their names and the names of their interior
+// nodes, registers, and instantiations, and so generate functionally
+// identical Verilog modules. Port names are part of the generated module's
+// interface and are included verbatim. `representatives` maps previously
+// deduplicated blocks to their representative (as returned by
+// DeduplicateBlocks); instantiated blocks are identified by their
+// representative so equivalence propagates up the instantiation hierarchy.
+std::string BlockStructuralFingerprint(
+    Block* block, const absl::flat_hash_map<Block*, Block*>& representatives);
+
+// Groups the given blocks by structural fingerprint and returns a map from
+// each block to the representative of its group (the group's first block, or
+// the block itself if no earlier block is equivalent). Blocks must be ordered
+// with instantiated blocks before their instantiating blocks (DFS post
+// order) so nested duplicates are discovered bottom-up.
+absl::flat_hash_map<Block*, Block*> DeduplicateBlocks(
+    absl::Span<Block* const> blocks);
+
+}  // namespace verilog
+}  // namespace xls
+
+#endif  // XLS_CODEGEN_BLOCK_DEDUP_H_
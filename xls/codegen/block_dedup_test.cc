@@ -0,0 +1,168 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/codegen/block_dedup.h"
+
+#include "xls/codegen/block_generator.h"
+#include "xls/codegen/codegen_options.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/package.h"
+#include "xls/ir/type.h"
+
+namespace xls {
+namespace verilog {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+class BlockDedupTest : public IrTestBase {
+ protected:
+  // Makes and returns a block which subtracts two u32 numbers.
+  absl::StatusOr<Block*> MakeSubtractBlock(absl::string_view name,
+                                           Package* package) {
+    Type* u32 = package->GetBitsType(32);
+    BlockBuilder bb(name, package);
+    BValue a = bb.InputPort("a", u32);
+    BValue b = bb.InputPort("b", u32);
+    bb.OutputPort("result", bb.Subtract(a, b));
+    return bb.Build();
+  }
+};
+
+TEST_F(BlockDedupTest, StructurallyIdenticalBlocksShareFingerprint) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(Block * sub0,
+                           MakeSubtractBlock("subtractor0", &package));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * sub1,
+                           MakeSubtractBlock("subtractor1", &package));
+  // The blocks have different block and node names but identical structure.
+  EXPECT_EQ(BlockStructuralFingerprint(sub0, {}),
+            BlockStructuralFingerprint(sub1, {}));
+}
+
+TEST_F(BlockDedupTest, DifferentLogicHasDifferentFingerprint) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(Block * sub,
+                           MakeSubtractBlock("subtractor", &package));
+  Type* u32 = package.GetBitsType(32);
+  BlockBuilder bb("adder", &package);
+  bb.OutputPort("result", bb.Add(bb.InputPort("a", u32),
+                                 bb.InputPort("b", u32)));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * add, bb.Build());
+  EXPECT_NE(BlockStructuralFingerprint(sub, {}),
+            BlockStructuralFingerprint(add, {}));
+}
+
+TEST_F(BlockDedupTest, DifferentPortNamesHaveDifferentFingerprint) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(Block * sub,
+                           MakeSubtractBlock("subtractor", &package));
+  Type* u32 = package.GetBitsType(32);
+  BlockBuilder bb("renamed_ports", &package);
+  bb.OutputPort("result", bb.Subtract(bb.InputPort("x", u32),
+                                      bb.InputPort("y", u32)));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * renamed, bb.Build());
+  // Port names are part of the module interface so the blocks are not
+  // interchangeable.
+  EXPECT_NE(BlockStructuralFingerprint(sub, {}),
+            BlockStructuralFingerprint(renamed, {}));
+}
+
+TEST_F(BlockDedupTest, DeduplicateBlocksPicksFirstAsRepresentative) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(Block * sub0,
+                           MakeSubtractBlock("subtractor0", &package));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * sub1,
+                           MakeSubtractBlock("subtractor1", &package));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * sub2,
+                           MakeSubtractBlock("subtractor2", &package));
+  absl::flat_hash_map<Block*, Block*> representatives =
+      DeduplicateBlocks({sub0, sub1, sub2});
+  EXPECT_EQ(representatives.at(sub0), sub0);
+  EXPECT_EQ(representatives.at(sub1), sub0);
+  EXPECT_EQ(representatives.at(sub2), sub0);
+}
+
+TEST_F(BlockDedupTest, ParentsOfEquivalentChildrenAreEquivalent) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(Block * sub0,
+                           MakeSubtractBlock("subtractor0", &package));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * sub1,
+                           MakeSubtractBlock("subtractor1", &package));
+
+  Type* u32 = package.GetBitsType(32);
+  auto make_wrapper = [&](absl::string_view name,
+                          Block* child) -> absl::StatusOr<Block*> {
+    BlockBuilder bb(name, &package);
+    XLS_ASSIGN_OR_RETURN(xls::Instantiation * instantiation,
+                         bb.block()->AddBlockInstantiation("inst", child));
+    bb.InstantiationInput(instantiation, "a", bb.InputPort("a", u32));
+    bb.InstantiationInput(instantiation, "b", bb.InputPort("b", u32));
+    bb.OutputPort("result", bb.InstantiationOutput(instantiation, "result"));
+    return bb.Build();
+  };
+  XLS_ASSERT_OK_AND_ASSIGN(Block * wrapper0, make_wrapper("wrapper0", sub0));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * wrapper1, make_wrapper("wrapper1", sub1));
+
+  // The wrappers instantiate different Block objects but the instantiated
+  // blocks are themselves equivalent, so bottom-up deduplication unifies the
+  // wrappers as well.
+  absl::flat_hash_map<Block*, Block*> representatives =
+      DeduplicateBlocks({sub0, sub1, wrapper0, wrapper1});
+  EXPECT_EQ(representatives.at(sub1), sub0);
+  EXPECT_EQ(representatives.at(wrapper1), wrapper0);
+}
+
+TEST_F(BlockDedupTest, GenerateVerilogEmitsOneModulePerEquivalenceClass) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(Block * sub0,
+                           MakeSubtractBlock("subtractor0", &package));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * sub1,
+                           MakeSubtractBlock("subtractor1", &package));
+
+  Type* u32 = package.GetBitsType(32);
+  BlockBuilder bb("top", &package);
+  XLS_ASSERT_OK_AND_ASSIGN(xls::Instantiation * inst0,
+                           bb.block()->AddBlockInstantiation("inst0", sub0));
+  XLS_ASSERT_OK_AND_ASSIGN(xls::Instantiation * inst1,
+                           bb.block()->AddBlockInstantiation("inst1", sub1));
+  BValue x = bb.InputPort("x", u32);
+  BValue y = bb.InputPort("y", u32);
+  bb.InstantiationInput(inst0, "a", x);
+  bb.InstantiationInput(inst0, "b", y);
+  bb.InstantiationInput(inst1, "a", y);
+  bb.InstantiationInput(inst1, "b", x);
+  BValue x_minus_y = bb.InstantiationOutput(inst0, "result");
+  BValue y_minus_x = bb.InstantiationOutput(inst1, "result");
+  bb.OutputPort("x_minus_y", x_minus_y);
+  bb.OutputPort("y_minus_x", y_minus_x);
+  XLS_ASSERT_OK_AND_ASSIGN(Block * top, bb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::string verilog,
+                           GenerateVerilog(top, CodegenOptions()));
+
+  // Only the representative subtractor module is defined; both instantiations
+  // refer to it.
+  EXPECT_THAT(verilog, HasSubstr("module subtractor0"));
+  EXPECT_THAT(verilog, Not(HasSubstr("module subtractor1")));
+  EXPECT_THAT(verilog, HasSubstr("subtractor0 inst0"));
+  EXPECT_THAT(verilog, HasSubstr("subtractor0 inst1"));
+}
+
+}  // namespace
+}  // namespace verilog
+}  // namespace xls
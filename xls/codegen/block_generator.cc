@@ -15,15 +15,20 @@
 #include "xls/codegen/block_generator.h"
 
 #include <deque>
+#include <memory>
+#include <ostream>
+#include <sstream>
 
 #include "absl/status/status.h"
 #include "xls/codegen/block_conversion.h"
+#include "xls/codegen/block_dedup.h"
 #include "xls/codegen/flattening.h"
 #include "xls/codegen/module_builder.h"
 #include "xls/codegen/node_expressions.h"
 #include "xls/codegen/vast.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/thread.h"
 #include "xls/ir/instantiation.h"
 #include "xls/ir/node_iterator.h"
 #include "xls/ir/node_util.h"
@@ -271,9 +276,13 @@ absl::StatusOr<std::vector<Stage>> SplitBlockIntoStages(Block* block) {
 class BlockGenerator {
  public:
   // Generates (System)Verilog from the given block into the given Verilog file
-  // using the given options.
-  static absl::Status Generate(Block* block, VerilogFile* file,
-                               const CodegenOptions& options) {
+  // using the given options. `representatives`, if given, maps structurally
+  // equivalent blocks to a single representative (see DeduplicateBlocks);
+  // instantiations of a deduplicated block refer to the representative's
+  // module, whose definition is the only one emitted.
+  static absl::Status Generate(
+      Block* block, VerilogFile* file, const CodegenOptions& options,
+      const absl::flat_hash_map<Block*, Block*>* representatives = nullptr) {
     XLS_ASSIGN_OR_RETURN(absl::optional<ResetProto> reset_proto,
                          GetBlockResetProto(block));
     absl::optional<std::string> clock_name;
@@ -284,18 +293,21 @@ class BlockGenerator {
           "Block has registers but no clock port");
     }
 
-    BlockGenerator generator(block, options, clock_name, reset_proto, file);
+    BlockGenerator generator(block, options, clock_name, reset_proto, file,
+                             representatives);
     return generator.Emit();
   }
 
  private:
   BlockGenerator(Block* block, const CodegenOptions& options,
                  absl::optional<std::string> clock_name,
-                 absl::optional<ResetProto> reset_proto, VerilogFile* file)
+                 absl::optional<ResetProto> reset_proto, VerilogFile* file,
+                 const absl::flat_hash_map<Block*, Block*>* representatives)
       : block_(block),
         options_(options),
         reset_proto_(reset_proto),
         file_(file),
+        representatives_(representatives),
         mb_(block->name(), file_, options.use_system_verilog(), clock_name,
             reset_proto) {}
 
@@ -606,9 +618,15 @@ class BlockGenerator {
               Connection{output->port_name(),
                          absl::get<Expression*>(node_exprs_.at(output))});
         }
+        // Instantiate the representative's module if the instantiated block
+        // was deduplicated away.
+        Block* instantiated = block_instantiation->instantiated_block();
+        if (representatives_ != nullptr &&
+            representatives_->contains(instantiated)) {
+          instantiated = representatives_->at(instantiated);
+        }
         mb_.instantiation_section()->Add<Instantiation>(
-            block_instantiation->instantiated_block()->name(),
-            block_instantiation->name(),
+            instantiated->name(), block_instantiation->name(),
             /*parameters=*/std::vector<Connection>(), connections);
       }
     }
@@ -662,6 +680,11 @@ class BlockGenerator {
   absl::optional<ResetProto> reset_proto_;
 
   VerilogFile* file_;
+
+  // Maps structurally equivalent blocks to their representative, or nullptr
+  // if no deduplication was performed.
+  const absl::flat_hash_map<Block*, Block*>* representatives_;
+
   ModuleBuilder mb_;
 
   // Map from Node* to the Verilog expression representing its value.
@@ -707,24 +730,74 @@ absl::StatusOr<std::vector<Block*>> GatherInstantiatedBlocks(Block* top) {
 
 }  // namespace
 
-absl::StatusOr<std::string> GenerateVerilog(Block* top,
-                                            const CodegenOptions& options) {
+absl::Status GenerateVerilog(Block* top, const CodegenOptions& options,
+                             std::ostream& os) {
   XLS_VLOG(2) << absl::StreamFormat(
       "Generating Verilog for packge with with top level block `%s`:",
       top->name());
   XLS_VLOG_LINES(2, top->DumpIr());
 
-  XLS_ASSIGN_OR_RETURN(std::vector<Block*> blocks,
+  XLS_ASSIGN_OR_RETURN(std::vector<Block*> all_blocks,
                        GatherInstantiatedBlocks(top));
-  VerilogFile file(options.use_system_verilog());
-  for (Block* block : blocks) {
-    XLS_RETURN_IF_ERROR(BlockGenerator::Generate(block, &file, options));
-    if (block != blocks.back()) {
-      file.Add(file.Make<BlankLine>());
-      file.Add(file.Make<BlankLine>());
+
+  // Structurally equivalent blocks (e.g. multiple pipeline instantiations of
+  // the same parametric) are emitted as a single module definition which is
+  // instantiated multiply. The post order of GatherInstantiatedBlocks
+  // discovers nested duplicates bottom-up. The top block always emits under
+  // its own name as it forms the module interface of the generated file.
+  absl::flat_hash_map<Block*, Block*> representatives =
+      DeduplicateBlocks(all_blocks);
+  representatives[top] = top;
+  std::vector<Block*> blocks;
+  for (Block* block : all_blocks) {
+    if (representatives.at(block) == block) {
+      blocks.push_back(block);
     }
   }
-  std::string text = file.Emit();
+
+  // Blocks only refer to one another by module name in instantiations, so
+  // each block can be lowered into its own VerilogFile on its own thread. The
+  // files are emitted in DFS post order below which keeps the output
+  // identical to sequential lowering into a single file. Lowering within a
+  // block remains sequential: VAST nodes are arena-allocated in their
+  // VerilogFile and ModuleBuilder uniquifies names as it goes.
+  std::vector<std::unique_ptr<VerilogFile>> files;
+  for (int64_t i = 0; i < blocks.size(); ++i) {
+    files.push_back(
+        std::make_unique<VerilogFile>(options.use_system_verilog()));
+  }
+  std::vector<absl::Status> statuses(blocks.size());
+  auto generate = [&](int64_t i) {
+    statuses[i] = BlockGenerator::Generate(blocks[i], files[i].get(), options,
+                                           &representatives);
+  };
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int64_t i = 1; i < blocks.size(); ++i) {
+    threads.push_back(
+        std::make_unique<Thread>([&generate, i]() { generate(i); }));
+  }
+  generate(0);
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+  for (const absl::Status& status : statuses) {
+    XLS_RETURN_IF_ERROR(status);
+  }
+
+  for (int64_t i = 0; i < blocks.size(); ++i) {
+    files[i]->Emit(os);
+    if (i != blocks.size() - 1) {
+      os << "\n\n";
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::string> GenerateVerilog(Block* top,
+                                            const CodegenOptions& options) {
+  std::ostringstream os;
+  XLS_RETURN_IF_ERROR(GenerateVerilog(top, options, os));
+  std::string text = os.str();
   XLS_VLOG(2) << "Verilog output:";
   XLS_VLOG_LINES(2, text);
 
@@ -15,6 +15,8 @@
 #ifndef XLS_CODEGEN_BLOCK_GENERATOR_H_
 #define XLS_CODEGEN_BLOCK_GENERATOR_H_
 
+#include <iosfwd>
+
 #include "absl/status/statusor.h"
 #include "xls/codegen/codegen_options.h"
 #include "xls/ir/block.h"
@@ -28,6 +30,12 @@ namespace verilog {
 absl::StatusOr<std::string> GenerateVerilog(Block* top,
                                             const CodegenOptions& options);
 
+// As above, but streams the emitted Verilog through `os` as it is generated
+// rather than returning it as a string, keeping peak memory proportional to
+// the largest emitted construct rather than the whole file.
+absl::Status GenerateVerilog(Block* top, const CodegenOptions& options,
+                             std::ostream& os);
+
 }  // namespace verilog
 }  // namespace xls
 
@@ -14,6 +14,9 @@
 
 #include "xls/codegen/codegen_pass.h"
 
+#include <ostream>
+#include <sstream>
+
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
@@ -21,18 +24,22 @@
 namespace xls::verilog {
 
 std::string CodegenPassUnit::DumpIr() const {
+  std::ostringstream os;
+  DumpIrTo(os);
+  return os.str();
+}
+
+void CodegenPassUnit::DumpIrTo(std::ostream& os) const {
   // Dump the Package and metadata. The metadata is commented out ('//') so the
   // output is parsable.
-  std::string out =
-      absl::StrFormat("// Generating code for proc: %s\n\n", block->name());
-  absl::StrAppend(&out, package->DumpIr());
+  os << absl::StrFormat("// Generating code for proc: %s\n\n", block->name());
+  package->DumpIrTo(os);
   if (signature.has_value()) {
-    absl::StrAppend(&out, "\n\n// Module signature:\n");
+    os << "\n\n// Module signature:\n";
     for (auto line : absl::StrSplit(signature->ToString(), '\n')) {
-      absl::StrAppend(&out, "// ", line, "\n");
+      os << "// " << line << "\n";
     }
   }
-  return out;
 }
 
 }  // namespace xls::verilog
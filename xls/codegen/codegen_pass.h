@@ -15,6 +15,8 @@
 #ifndef XLS_CODEGEN_CODEGEN_PASS_H_
 #define XLS_CODEGEN_CODEGEN_PASS_H_
 
+#include <iosfwd>
+
 #include "absl/types/optional.h"
 #include "xls/codegen/codegen_options.h"
 #include "xls/codegen/module_signature.h"
@@ -59,7 +61,12 @@ struct CodegenPassUnit {
 
   // These methods are required by CompoundPassBase.
   std::string DumpIr() const;
+  void DumpIrTo(std::ostream& os) const;
   const std::string& name() const { return block->name(); }
+
+  // Number of nodes in the block being lowered. Used by the pass pipeline to
+  // record per-pass node-count deltas in the pass profile.
+  int64_t GetNodeCount() const { return block->node_count(); }
 };
 
 using CodegenPass = PassBase<CodegenPassUnit, CodegenPassOptions, PassResults>;
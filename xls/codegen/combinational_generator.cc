@@ -14,6 +14,8 @@
 
 #include "xls/codegen/combinational_generator.h"
 
+#include <ostream>
+
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -63,7 +65,8 @@ absl::StatusOr<ModuleGeneratorResult> GenerateCombinationalModule(
 }
 
 absl::StatusOr<ModuleGeneratorResult> GenerateCombinationalModule(
-    FunctionBase* module, const CodegenOptions& options) {
+    FunctionBase* module, const CodegenOptions& options,
+    std::ostream* verilog_stream, PassResults* pass_results) {
   std::string module_name(
       options.module_name().value_or(SanitizeIdentifier(module->name())));
 
@@ -84,11 +87,17 @@ absl::StatusOr<ModuleGeneratorResult> GenerateCombinationalModule(
   CodegenPassOptions codegen_pass_options;
   codegen_pass_options.codegen_options = options;
 
-  PassResults results;
+  PassResults local_results;
+  PassResults* results =
+      pass_results == nullptr ? &local_results : pass_results;
   XLS_RETURN_IF_ERROR(CreateCodegenPassPipeline()
-                          ->Run(&unit, codegen_pass_options, &results)
+                          ->Run(&unit, codegen_pass_options, results)
                           .status());
   XLS_RET_CHECK(unit.signature.has_value());
+  if (verilog_stream != nullptr) {
+    XLS_RETURN_IF_ERROR(GenerateVerilog(block, options, *verilog_stream));
+    return ModuleGeneratorResult{"", unit.signature.value()};
+  }
   XLS_ASSIGN_OR_RETURN(std::string verilog, GenerateVerilog(block, options));
 
   return ModuleGeneratorResult{verilog, unit.signature.value()};
@@ -15,6 +15,7 @@
 #ifndef XLS_CODEGEN_COMBINATIONAL_GENERATOR_H_
 #define XLS_CODEGEN_COMBINATIONAL_GENERATOR_H_
 
+#include <iosfwd>
 #include <string>
 
 #include "absl/container/flat_hash_map.h"
@@ -27,6 +28,9 @@
 #include "xls/ir/proc.h"
 
 namespace xls {
+
+struct PassResults;
+
 namespace verilog {
 
 // Emits the given function as a combinational Verilog module. If
@@ -41,8 +45,17 @@ absl::StatusOr<ModuleGeneratorResult> GenerateCombinationalModule(
 //
 // If given a proc, the proc must be able to be represented as a purely
 // combinational block.
+//
+// If `verilog_stream` is non-null the Verilog text is streamed through it as
+// it is emitted and the verilog_text field of the returned result is left
+// empty; this keeps peak memory independent of the size of the emitted text.
+//
+// If `pass_results` is non-null the per-pass invocation records of the
+// codegen pass pipeline (timing, node-count and peak-RSS deltas) are
+// accumulated into it.
 absl::StatusOr<ModuleGeneratorResult> GenerateCombinationalModule(
-    FunctionBase* module, const CodegenOptions& options);
+    FunctionBase* module, const CodegenOptions& options,
+    std::ostream* verilog_stream = nullptr, PassResults* pass_results = nullptr);
 
 }  // namespace verilog
 }  // namespace xls
@@ -27,6 +27,7 @@
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/package.h"
+#include "xls/passes/pass_base.h"
 #include "xls/simulation/module_simulator.h"
 #include "xls/simulation/verilog_simulators.h"
 #include "xls/simulation/verilog_test_base.h"
@@ -1426,6 +1427,32 @@ TEST_P(CombinationalGeneratorTest, ArraySliceWiderThanInputArray) {
                                  result.verilog_text);
 }
 
+TEST_P(CombinationalGeneratorTest, PassResultsAreRecorded) {
+  Package package(TestBaseName());
+  FunctionBuilder fb(TestBaseName(), &package);
+  Type* u8 = package.GetBitsType(8);
+  auto a = fb.Param("a", u8);
+  auto b = fb.Param("b", u8);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.BuildWithReturnValue(fb.Add(a, b)));
+
+  CodegenOptions options;
+  options.use_system_verilog(UseSystemVerilog());
+  PassResults pass_results;
+  XLS_ASSERT_OK(GenerateCombinationalModule(f, options,
+                                            /*verilog_stream=*/nullptr,
+                                            &pass_results)
+                    .status());
+
+  // One record per pass invocation, starting with signature generation.
+  ASSERT_FALSE(pass_results.invocations.empty());
+  EXPECT_EQ(pass_results.invocations.front().pass_name, "signature_generation");
+  for (const PassInvocation& invocation : pass_results.invocations) {
+    // Peak RSS is monotone for the process, so recorded deltas can never be
+    // negative.
+    EXPECT_GE(invocation.peak_rss_delta_bytes, 0);
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(CombinationalGeneratorTestInstantiation,
                          CombinationalGeneratorTest,
                          testing::ValuesIn(kDefaultSimulationTargets),
@@ -22,16 +22,26 @@
 namespace xls {
 namespace verilog {
 
-void FsmBlockBase::EmitAssignments(StatementBlock* statement_block) const {
+void FsmBlockBase::EmitAssignments(
+    StatementBlock* statement_block,
+    const absl::flat_hash_map<LogicRef*, LogicRef*>* lhs_map) const {
+  auto mapped_lhs = [&](LogicRef* lhs) {
+    if (lhs_map == nullptr) {
+      return lhs;
+    }
+    auto it = lhs_map->find(lhs);
+    return it == lhs_map->end() ? lhs : it->second;
+  };
   for (const auto& assignment : assignments_) {
-    statement_block->Add<BlockingAssignment>(assignment.lhs, assignment.rhs);
+    statement_block->Add<BlockingAssignment>(mapped_lhs(assignment.lhs),
+                                             assignment.rhs);
   }
   for (const ConditionalFsmBlock& cond_block : conditional_blocks_) {
     if (cond_block.HasAssignments()) {
       Conditional* conditional =
           statement_block->Add<Conditional>(cond_block.condition());
       cond_block.EmitConditionalAssignments(conditional,
-                                            conditional->consequent());
+                                            conditional->consequent(), lhs_map);
     }
   }
 }
@@ -93,14 +103,16 @@ UnconditionalFsmBlock& ConditionalFsmBlock::Else() {
 }
 
 void ConditionalFsmBlock::EmitConditionalAssignments(
-    Conditional* conditional, StatementBlock* statement_block) const {
-  EmitAssignments(statement_block);
+    Conditional* conditional, StatementBlock* statement_block,
+    const absl::flat_hash_map<LogicRef*, LogicRef*>* lhs_map) const {
+  EmitAssignments(statement_block, lhs_map);
   if (next_alternate_ != nullptr && next_alternate_->HasAssignments()) {
     next_alternate_->EmitConditionalAssignments(
-        conditional, conditional->AddAlternate(next_alternate_->condition()));
+        conditional, conditional->AddAlternate(next_alternate_->condition()),
+        lhs_map);
   } else if (final_alternate_ != nullptr &&
              final_alternate_->HasAssignments()) {
-    final_alternate_->EmitAssignments(conditional->AddAlternate());
+    final_alternate_->EmitAssignments(conditional->AddAlternate(), lhs_map);
   }
 }
 
@@ -197,15 +209,12 @@ FsmRegister* FsmBuilder::AddExistingRegister(LogicRef* reg) {
 }
 
 FsmState* FsmBuilder::AddState(absl::string_view name) {
-  if (state_local_param_ == nullptr) {
-    state_local_param_ = file_->Make<LocalParam>();
-  }
   XLS_CHECK(!absl::c_any_of(states_, [&](const FsmState& s) {
     return s.name() == name;
   })) << absl::StrFormat("State with name \"%s\" already exists.", name);
-  Expression* state_value = state_local_param_->AddItem(
-      absl::StrCat("State", name), file_->PlainLiteral(states_.size()));
-  states_.emplace_back(name, file_, state_value);
+  // The numeric encoding of the state is not assigned until Build is called
+  // when the state encoding (and hence state register width) is known.
+  states_.emplace_back(name, file_, /*state_value=*/nullptr);
   return &states_.back();
 }
 
@@ -231,10 +240,10 @@ absl::Status FsmBuilder::BuildStateTransitionLogic(LogicRef* state,
     fsm_state.EmitStateTransitions(
         case_statement->AddCaseArm(fsm_state.state_value()), state_next);
   }
-  // If the number of states is not a power of two then add an unreachable
-  // default case which sets the next state to X. This ensures all values of
-  // the case are covered.
-  if (states_.size() != 1 << StateRegisterWidth()) {
+  // If the state register can hold values which do not encode any state then
+  // add an unreachable default case which sets the next state to X. This
+  // ensures all values of the case are covered.
+  if (HasUnusedStateEncodings()) {
     StatementBlock* statements = case_statement->AddCaseArm(DefaultSentinel());
     statements->Add<BlockingAssignment>(
         state_next, file_->Make<XSentinel>(StateRegisterWidth()));
@@ -414,11 +423,36 @@ absl::StatusOr<Expression*> FsmBlockBase::HoistCommonConditionalAssignments(
   return nullptr;
 }
 
-absl::Status FsmBuilder::BuildOutputLogic(LogicRef* state) {
+absl::Status FsmBuilder::VerifyOutputsAreUnconditional() const {
+  for (const FsmState& fsm_state : states_) {
+    for (const FsmOutput& output : outputs_) {
+      for (const ConditionalFsmBlock& cond_block :
+           fsm_state.conditional_blocks_) {
+        if (cond_block.HasAssignmentToOutput(output)) {
+          return absl::InvalidArgumentError(absl::StrFormat(
+              "Registered output \"%s\" is conditionally assigned in state "
+              "\"%s\". Registered outputs may only depend on the FSM state.",
+              output.logic_ref->GetName(), fsm_state.name()));
+        }
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status FsmBuilder::BuildOutputLogic(LogicRef* state,
+                                          LogicRef* state_next) {
   if (registers_.empty() && outputs_.empty() && counters_.empty()) {
     return absl::OkStatus();
   }
 
+  // Registered outputs are decoded from the next state and flopped (in
+  // Build) so they are driven directly from registers. The decoded values
+  // are computed into shadow "_next" regs here.
+  LogicRef* output_case_key = register_outputs_ ? state_next : state;
+  const absl::flat_hash_map<LogicRef*, LogicRef*>* lhs_map =
+      register_outputs_ ? &output_next_map_ : nullptr;
+
   // Construct an always block encapsulating the combinational logic for
   // determining output values, next counter values, and next assignment values.
   module_->Add<BlankLine>();
@@ -458,19 +492,21 @@ absl::Status FsmBuilder::BuildOutputLogic(LogicRef* state) {
     ac->statements()->Add<BlockingAssignment>(
         counter.next, file_->Sub(counter.logic_ref, file_->PlainLiteral(1)));
   }
-  Case* case_statement = ac->statements()->Add<Case>(state);
+  Case* case_statement = ac->statements()->Add<Case>(output_case_key);
   for (const auto& fsm_state : states_) {
     fsm_state.EmitAssignments(
-        case_statement->AddCaseArm(fsm_state.state_value()));
+        case_statement->AddCaseArm(fsm_state.state_value()), lhs_map);
   }
 
   // If the state vector is wide enough to allow values not encoded in the state
   // enum add a default case and assign outputs to the default value.
-  if (states_.size() != 1 << StateRegisterWidth()) {
+  if (HasUnusedStateEncodings()) {
     StatementBlock* statements = case_statement->AddCaseArm(DefaultSentinel());
     for (const FsmOutput& output : outputs_) {
-      statements->Add<BlockingAssignment>(output.logic_ref,
-                                          output.default_value);
+      LogicRef* lhs = register_outputs_
+                          ? output_next_map_.at(output.logic_ref)
+                          : output.logic_ref;
+      statements->Add<BlockingAssignment>(lhs, output.default_value);
     }
   }
 
@@ -483,6 +519,10 @@ absl::Status FsmBuilder::Build() {
   }
   is_built_ = true;
 
+  if (register_outputs_) {
+    XLS_RETURN_IF_ERROR(VerifyOutputsAreUnconditional());
+  }
+
   module_->Add<BlankLine>();
   module_->Add<Comment>(absl::StrCat(name_, " ", "FSM:"));
 
@@ -490,7 +530,22 @@ absl::Status FsmBuilder::Build() {
       "StateBits", file_->PlainLiteral(StateRegisterWidth()));
 
   // For each state, define its numeric encoding as a LocalParam gathered in
-  // state_values.
+  // state_values. The encoding is only now known as it depends on the state
+  // count and the configured state encoding.
+  FsmStateEncoding encoding = ResolvedStateEncoding();
+  state_local_param_ = file_->Make<LocalParam>();
+  int64_t state_index = 0;
+  for (FsmState& fsm_state : states_) {
+    Expression* encoded_value =
+        encoding == FsmStateEncoding::kOneHot
+            ? file_->Literal(
+                  Bits::PowerOfTwo(state_index, StateRegisterWidth()),
+                  FormatPreference::kBinary)
+            : file_->PlainLiteral(state_index);
+    fsm_state.state_value_ = state_local_param_->AddItem(
+        absl::StrCat("State", fsm_state.name()), encoded_value);
+    ++state_index;
+  }
   module_->AddModuleMember(state_local_param_);
 
   Expression* initial_state_value = states_.front().state_value();
@@ -499,12 +554,21 @@ absl::Status FsmBuilder::Build() {
   LogicRef* state = module_->AddReg("state", type, initial_state_value);
   LogicRef* state_next =
       module_->AddReg("state_next", type, initial_state_value);
+  if (register_outputs_) {
+    // Declare a shadow "_next" reg per output which holds the decoded output
+    // value which is flopped into the output reg below.
+    for (const FsmOutput& output : outputs_) {
+      output_next_map_[output.logic_ref] =
+          AddRegDef(absl::StrCat(output.logic_ref->GetName(), "_next"),
+                    output.logic_ref->def()->data_type());
+    }
+  }
   for (RegDef* def : defs_) {
     module_->AddModuleMember(def);
   }
 
   XLS_RETURN_IF_ERROR(BuildStateTransitionLogic(state, state_next));
-  XLS_RETURN_IF_ERROR(BuildOutputLogic(state));
+  XLS_RETURN_IF_ERROR(BuildOutputLogic(state, state_next));
 
   AlwaysFlop* af = reset_.has_value()
                        ? module_->Add<AlwaysFlop>(clk_, reset_.value())
@@ -517,6 +581,13 @@ absl::Status FsmBuilder::Build() {
   } else {
     af->AddRegister(state, state_next);
   }
+  if (register_outputs_) {
+    for (const FsmOutput& output : outputs_) {
+      af->AddRegister(
+          output.logic_ref, output_next_map_.at(output.logic_ref),
+          /*reset_value=*/reset_.has_value() ? output.default_value : nullptr);
+    }
+  }
   for (const FsmRegister& reg : registers_) {
     af->AddRegister(reg.logic_ref, reg.next, /*reset_value=*/reg.reset_value);
   }
@@ -88,8 +88,14 @@ class FsmBlockBase {
 
   // Emits the output assignments contained in this block as blocking
   // assignments in the given VAST StatementBlock including any nested
-  // conditional assignments.
-  void EmitAssignments(StatementBlock* statement_block) const;
+  // conditional assignments. If `lhs_map` is non-null, assignments whose
+  // left-hand side appears in the map are emitted to the mapped LogicRef
+  // instead (used to redirect output assignments to their shadow "_next"
+  // regs when FSM outputs are registered).
+  void EmitAssignments(
+      StatementBlock* statement_block,
+      const absl::flat_hash_map<LogicRef*, LogicRef*>* lhs_map =
+          nullptr) const;
 
   // Emits the state transition (if any) contained in this block as a blocking
   // assignment in the given VAST StatementBlock including any nested state
@@ -260,9 +266,12 @@ class ConditionalFsmBlock : public FsmBlock<ConditionalFsmBlock> {
 
   // Emits the VAST conditional ladder for this conditional block and the nested
   // assignments (state transitions). 'conditional' is the VAST conditional
-  // statement corresponding to this conditional block.
-  void EmitConditionalAssignments(Conditional* conditional,
-                                  StatementBlock* statement_block) const;
+  // statement corresponding to this conditional block. See
+  // FsmBlockBase::EmitAssignments for `lhs_map`.
+  void EmitConditionalAssignments(
+      Conditional* conditional, StatementBlock* statement_block,
+      const absl::flat_hash_map<LogicRef*, LogicRef*>* lhs_map =
+          nullptr) const;
   void EmitConditionalStateTransitions(Conditional* conditional,
                                        StatementBlock* statement_block,
                                        LogicRef* state_next_var) const;
@@ -314,14 +323,34 @@ class FsmState : public UnconditionalFsmBlock {
   std::string name() const { return name_; }
 
   // The VAST expression of the numeric encoding of this state in the FSM state
-  // variable.
+  // variable. The encoding is chosen when FsmBuilder::Build is called; the
+  // value is null before then.
   Expression* state_value() const { return state_value_; }
 
  protected:
+  friend class FsmBuilder;
+
   std::string name_;
   Expression* state_value_;
 };
 
+// How the states of an FSM are encoded in the state register.
+enum class FsmStateEncoding {
+  // States are numbered 0, 1, 2, ... in a register of minimum width.
+  kBinary,
+
+  // One register bit per state with exactly one bit set at a time. Wider
+  // state register, but shallower next-state and output decode logic which
+  // helps timing closure of control-heavy blocks.
+  kOneHot,
+
+  // Chooses between kBinary and kOneHot based on the number of states: FSMs
+  // with more than FsmBuilder::kAutoOneHotStateLimit states use one-hot
+  // encoding (the binary decode tree is the critical path for larger state
+  // counts), smaller FSMs use binary encoding.
+  kAuto,
+};
+
 // Abstraction for building finite state machines in Verilog using VAST.
 class FsmBuilder {
  public:
@@ -378,6 +407,24 @@ class FsmBuilder {
   // Configures FSM so that on reset, the state will be set to reset_state.
   void SetResetState(FsmState* reset_state) { reset_state_ = reset_state; }
 
+  // With kAuto encoding, FSMs with more than this many states are one-hot
+  // encoded.
+  static constexpr int64_t kAutoOneHotStateLimit = 4;
+
+  // Sets the state encoding to use. Must be called before Build. The default
+  // is binary encoding.
+  void SetStateEncoding(FsmStateEncoding encoding) {
+    state_encoding_ = encoding;
+  }
+
+  // If enabled, FSM outputs are registered (Moore style): output values are
+  // computed from the next state and flopped, so outputs are driven directly
+  // from registers rather than through the state decode logic. Cycle-level
+  // behavior is unchanged. Requires every output to be assigned
+  // unconditionally within each state which assigns it (outputs may not
+  // depend on signals other than the state).
+  void SetRegisterOutputs(bool value) { register_outputs_ = value; }
+
  private:
   // Creates a RegDef of the given type and optional initial
   // value. Returns a LogicRef referring to it. The RegDef is added to the
@@ -388,14 +435,42 @@ class FsmBuilder {
   // Build the always block containing the logic for state transitions.
   absl::Status BuildStateTransitionLogic(LogicRef* state, LogicRef* state_next);
 
-  // Build the always block containing the logic for the FSM outputs.
-  absl::Status BuildOutputLogic(LogicRef* state);
+  // Build the always block containing the logic for the FSM outputs. The
+  // output logic is decoded from `state`, or from `state_next` when outputs
+  // are registered.
+  absl::Status BuildOutputLogic(LogicRef* state, LogicRef* state_next);
+
+  // Returns the encoding used for the state register with kAuto resolved to
+  // kBinary or kOneHot based on the number of states.
+  FsmStateEncoding ResolvedStateEncoding() const {
+    if (state_encoding_ == FsmStateEncoding::kAuto) {
+      return static_cast<int64_t>(states_.size()) > kAutoOneHotStateLimit
+                 ? FsmStateEncoding::kOneHot
+                 : FsmStateEncoding::kBinary;
+    }
+    return state_encoding_;
+  }
 
   // Returns the state register width.
   int64_t StateRegisterWidth() const {
+    if (ResolvedStateEncoding() == FsmStateEncoding::kOneHot) {
+      return std::max(int64_t{1}, static_cast<int64_t>(states_.size()));
+    }
     return std::max(int64_t{1}, Bits::MinBitCountUnsigned(states_.size() - 1));
   }
 
+  // Returns true if the state register can hold values which do not encode
+  // any state (in which case decode case statements need a default arm).
+  bool HasUnusedStateEncodings() const {
+    int64_t width = StateRegisterWidth();
+    return width >= 63 ||
+           static_cast<int64_t>(states_.size()) != (int64_t{1} << width);
+  }
+
+  // Returns an error if an FSM output is assigned conditionally within a
+  // state. Only called when outputs are registered.
+  absl::Status VerifyOutputsAreUnconditional() const;
+
   std::string name_;
   Module* module_;
   VerilogFile* file_;
@@ -416,6 +491,13 @@ class FsmBuilder {
   // method may only be called once.
   bool is_built_ = false;
 
+  FsmStateEncoding state_encoding_ = FsmStateEncoding::kBinary;
+  bool register_outputs_ = false;
+
+  // When outputs are registered, maps each output reg to the shadow reg
+  // holding its next value. Populated during Build.
+  absl::flat_hash_map<LogicRef*, LogicRef*> output_next_map_;
+
   FsmState* reset_state_ = nullptr;
   std::list<FsmState> states_;
   std::list<FsmCounter> counters_;
@@ -16,6 +16,7 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
 #include "xls/codegen/vast.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/matchers.h"
@@ -285,6 +286,110 @@ TEST_P(FiniteStateMachineTest, OutputAssignments) {
                                  f.Emit());
 }
 
+TEST_P(FiniteStateMachineTest, OneHotFsm) {
+  VerilogFile f(UseSystemVerilog());
+  Module* module = f.Add(f.Make<Module>(TestBaseName()));
+
+  LogicRef* clk = module->AddInput("clk", f.ScalarType());
+  FsmBuilder fsm("OneHotFsm", module, clk, UseSystemVerilog());
+  fsm.SetStateEncoding(FsmStateEncoding::kOneHot);
+  auto foo = fsm.AddState("Foo");
+  auto bar = fsm.AddState("Bar");
+  auto qux = fsm.AddState("Qux");
+
+  foo->NextState(bar);
+  bar->NextState(qux);
+  qux->NextState(foo);
+
+  XLS_ASSERT_OK(fsm.Build());
+  XLS_VLOG(1) << f.Emit();
+  // One register bit per state, with one-hot state values.
+  EXPECT_THAT(f.Emit(), HasSubstr("StateBits = 3"));
+  EXPECT_THAT(f.Emit(), HasSubstr("3'b001"));
+  EXPECT_THAT(f.Emit(), HasSubstr("3'b010"));
+  EXPECT_THAT(f.Emit(), HasSubstr("3'b100"));
+}
+
+TEST_P(FiniteStateMachineTest, AutoEncodingIsBinaryForSmallFsms) {
+  VerilogFile f(UseSystemVerilog());
+  Module* module = f.Add(f.Make<Module>(TestBaseName()));
+
+  LogicRef* clk = module->AddInput("clk", f.ScalarType());
+  FsmBuilder fsm("AutoFsm", module, clk, UseSystemVerilog());
+  fsm.SetStateEncoding(FsmStateEncoding::kAuto);
+  auto foo = fsm.AddState("Foo");
+  auto bar = fsm.AddState("Bar");
+  foo->NextState(bar);
+  bar->NextState(foo);
+
+  XLS_ASSERT_OK(fsm.Build());
+  XLS_VLOG(1) << f.Emit();
+  EXPECT_THAT(f.Emit(), HasSubstr("StateBits = 1"));
+}
+
+TEST_P(FiniteStateMachineTest, AutoEncodingIsOneHotForLargeFsms) {
+  VerilogFile f(UseSystemVerilog());
+  Module* module = f.Add(f.Make<Module>(TestBaseName()));
+
+  LogicRef* clk = module->AddInput("clk", f.ScalarType());
+  FsmBuilder fsm("AutoFsm", module, clk, UseSystemVerilog());
+  fsm.SetStateEncoding(FsmStateEncoding::kAuto);
+  for (int64_t i = 0; i < FsmBuilder::kAutoOneHotStateLimit + 1; ++i) {
+    fsm.AddState(absl::StrCat("S", i));
+  }
+
+  XLS_ASSERT_OK(fsm.Build());
+  XLS_VLOG(1) << f.Emit();
+  EXPECT_THAT(f.Emit(),
+              HasSubstr(absl::StrCat("StateBits = ",
+                                     FsmBuilder::kAutoOneHotStateLimit + 1)));
+}
+
+TEST_P(FiniteStateMachineTest, RegisteredOutputs) {
+  VerilogFile f(UseSystemVerilog());
+  Module* module = f.Add(f.Make<Module>(TestBaseName()));
+
+  LogicRef* clk = module->AddInput("clk", f.ScalarType());
+  LogicRef* rst_n = module->AddInput("rst_n", f.ScalarType());
+
+  FsmBuilder fsm("MooreFsm", module, clk, UseSystemVerilog(),
+                 Reset{rst_n, /*async=*/false, /*active_low=*/true});
+  fsm.SetRegisterOutputs(true);
+  auto out = fsm.AddOutput("out", /*width=*/8, /*default_value=*/0);
+
+  auto idle = fsm.AddState("Idle");
+  auto busy = fsm.AddState("Busy");
+  idle->NextState(busy);
+  busy->SetOutput(out, 123).NextState(idle);
+
+  XLS_ASSERT_OK(fsm.Build());
+  XLS_VLOG(1) << f.Emit();
+  // The output value is decoded from the next state into a shadow reg and
+  // flopped into the output reg.
+  EXPECT_THAT(f.Emit(), HasSubstr("out_next"));
+  EXPECT_THAT(f.Emit(), HasSubstr("case (state_next)"));
+}
+
+TEST_P(FiniteStateMachineTest, RegisteredOutputsRejectConditionalAssignment) {
+  VerilogFile f(UseSystemVerilog());
+  Module* module = f.Add(f.Make<Module>(TestBaseName()));
+
+  LogicRef* clk = module->AddInput("clk", f.ScalarType());
+  LogicRef* a = module->AddInput("a", f.ScalarType());
+
+  FsmBuilder fsm("MealyFsm", module, clk, UseSystemVerilog());
+  fsm.SetRegisterOutputs(true);
+  auto out = fsm.AddOutput("out", /*width=*/8, /*default_value=*/0);
+
+  auto state = fsm.AddState("State");
+  state->OnCondition(a).SetOutput(out, 44);
+
+  EXPECT_THAT(fsm.Build(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Registered output \"out\" is conditionally "
+                                 "assigned")));
+}
+
 TEST_P(FiniteStateMachineTest, MultipleAssignments) {
   VerilogFile f(UseSystemVerilog());
   Module* module = f.Add(f.Make<Module>(TestBaseName()));
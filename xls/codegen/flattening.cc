@@ -24,11 +24,14 @@
 
 namespace xls {
 
-// Gathers the Bits objects at the leaves of the Value.
-static void GatherValueLeaves(const Value& value, std::vector<Bits>* leaves) {
+// Gathers pointers to the Bits objects at the leaves of the Value. Pointers
+// rather than copies are gathered to avoid cloning each leaf's backing store
+// only to concatenate and discard the clones.
+static void GatherValueLeaves(const Value& value,
+                              std::vector<const Bits*>* leaves) {
   switch (value.kind()) {
     case ValueKind::kBits:
-      leaves->push_back(value.bits());
+      leaves->push_back(&value.bits());
       break;
     case ValueKind::kTuple:
       for (const Value& e : value.elements()) {
@@ -46,7 +49,7 @@ static void GatherValueLeaves(const Value& value, std::vector<Bits>* leaves) {
 }
 
 Bits FlattenValueToBits(const Value& value) {
-  std::vector<Bits> leaves;
+  std::vector<const Bits*> leaves;
   GatherValueLeaves(value, &leaves);
   return bits_ops::Concat(leaves);
 }
@@ -103,11 +106,10 @@ absl::StatusOr<Value> UnflattenBitsToValue(const Bits& bits,
 int64_t GetFlatBitIndexOfElement(const TupleType* tuple_type, int64_t index) {
   XLS_CHECK_GE(index, 0);
   XLS_CHECK_LT(index, tuple_type->size());
-  int64_t flat_index = 0;
-  for (int64_t i = tuple_type->size() - 1; i > index; --i) {
-    flat_index += tuple_type->element_type(i)->GetFlatBitCount();
-  }
-  return flat_index;
+  // The offset table is precomputed when the type is constructed, so
+  // element-by-element queries over wide tuples do not re-walk the element
+  // list once per query.
+  return tuple_type->GetFlatBitOffsetOfElement(index);
 }
 
 int64_t GetFlatBitIndexOfElement(const ArrayType* array_type, int64_t index) {
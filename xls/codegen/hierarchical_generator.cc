@@ -0,0 +1,194 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/codegen/hierarchical_generator.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "xls/codegen/module_builder.h"
+#include "xls/codegen/vast.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/node_iterator.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/type.h"
+
+namespace xls {
+namespace verilog {
+namespace {
+
+// Appends the functions transitively invoked by "f", callees before callers,
+// to "post_order". A function's module must be emitted before any module
+// which instantiates it.
+void InvokedFunctionsPostOrder(Function* f,
+                               absl::flat_hash_set<Function*>* visited,
+                               std::vector<Function*>* post_order) {
+  if (!visited->insert(f).second) {
+    return;
+  }
+  for (Node* node : f->nodes()) {
+    if (node->Is<Invoke>()) {
+      InvokedFunctionsPostOrder(node->As<Invoke>()->to_apply(), visited,
+                                post_order);
+    }
+  }
+  post_order->push_back(f);
+}
+
+// Emits "func" as a combinational module named "module_name" in "file".
+// Invoke nodes become instantiations of the callee's module, looked up in
+// "module_names".
+absl::Status EmitFunctionModule(
+    Function* func, absl::string_view module_name,
+    const absl::flat_hash_map<Function*, std::string>& module_names,
+    const CodegenOptions& options, VerilogFile* file) {
+  ModuleBuilder mb(module_name, file, options.use_system_verilog());
+
+  absl::flat_hash_map<Node*, Expression*> node_exprs;
+  for (Param* param : func->params()) {
+    XLS_ASSIGN_OR_RETURN(node_exprs[param],
+                         mb.AddInputPort(param->name(), param->GetType()));
+  }
+
+  for (Node* node : TopoSort(func)) {
+    if (node->Is<Param>()) {
+      continue;
+    }
+
+    // Emit non-bits-typed literals as module-level constants because in
+    // general these complicated types cannot be handled inline.
+    if (node->Is<xls::Literal>() && !node->GetType()->IsBits()) {
+      XLS_ASSIGN_OR_RETURN(
+          node_exprs[node],
+          mb.DeclareModuleConstant(node->GetName(),
+                                   node->As<xls::Literal>()->value()));
+      continue;
+    }
+
+    std::vector<Expression*> inputs;
+    for (Node* operand : node->operands()) {
+      inputs.push_back(node_exprs.at(operand));
+    }
+
+    if (node->Is<Invoke>()) {
+      Invoke* invoke = node->As<Invoke>();
+      Function* callee = invoke->to_apply();
+      LogicRef* out = mb.DeclareVariable(node->GetName(), node->GetType());
+      std::vector<Connection> connections;
+      for (int64_t i = 0; i < callee->params().size(); ++i) {
+        connections.push_back(Connection{
+            SanitizeIdentifier(callee->param(i)->name()), inputs[i]});
+      }
+      connections.push_back(Connection{"out", out});
+      mb.instantiation_section()->Add<Instantiation>(
+          module_names.at(callee),
+          absl::StrCat(SanitizeIdentifier(node->GetName()), "_inst"),
+          /*parameters=*/std::vector<Connection>(), connections);
+      node_exprs[node] = out;
+      continue;
+    }
+
+    // If the node has an assigned name then don't emit as an inline
+    // expression. This ensures the name appears in the generated Verilog.
+    if (node->HasAssignedName() || node->users().size() > 1 ||
+        func->HasImplicitUse(node) || !mb.CanEmitAsInlineExpression(node)) {
+      XLS_ASSIGN_OR_RETURN(node_exprs[node],
+                           mb.EmitAsAssignment(node->GetName(), node, inputs));
+    } else {
+      XLS_ASSIGN_OR_RETURN(node_exprs[node],
+                           mb.EmitAsInlineExpression(node, inputs));
+    }
+  }
+
+  return mb.AddOutputPort("out", func->return_value()->GetType(),
+                          node_exprs.at(func->return_value()));
+}
+
+}  // namespace
+
+absl::StatusOr<ModuleGeneratorResult> GenerateHierarchicalCombinationalModule(
+    Function* top, const CodegenOptions& options) {
+  std::vector<Function*> functions;
+  {
+    absl::flat_hash_set<Function*> visited;
+    InvokedFunctionsPostOrder(top, &visited, &functions);
+  }
+
+  // Invoked functions become instances with one flat port per parameter plus
+  // the output, so their interfaces must be bits-typed.
+  for (Function* func : functions) {
+    if (func == top) {
+      continue;
+    }
+    bool bits_typed = func->return_value()->GetType()->IsBits();
+    for (Param* param : func->params()) {
+      bits_typed = bits_typed && param->GetType()->IsBits();
+    }
+    if (!bits_typed) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Cannot emit invoked function '%s' as a module: its parameters and "
+          "return value must be bits-typed. Inline it before codegen.",
+          func->name()));
+    }
+  }
+
+  VerilogFile file(options.use_system_verilog());
+
+  // Assign every function a unique module name; the top function gets the
+  // requested module name.
+  absl::flat_hash_map<Function*, std::string> module_names;
+  absl::flat_hash_set<std::string> taken_names;
+  module_names[top] =
+      std::string(options.module_name().value_or(SanitizeIdentifier(
+          top->name())));
+  taken_names.insert(module_names.at(top));
+  for (Function* func : functions) {
+    if (func == top) {
+      continue;
+    }
+    std::string name = SanitizeIdentifier(func->name());
+    int64_t suffix = 0;
+    while (!taken_names.insert(name).second) {
+      name = absl::StrCat(SanitizeIdentifier(func->name()), "_", suffix++);
+    }
+    module_names[func] = name;
+  }
+
+  for (Function* func : functions) {
+    XLS_RETURN_IF_ERROR(EmitFunctionModule(func, module_names.at(func),
+                                           module_names, options, &file));
+  }
+
+  ModuleSignatureBuilder sig_builder(module_names.at(top));
+  for (Param* param : top->params()) {
+    sig_builder.AddDataInput(SanitizeIdentifier(param->name()),
+                             param->GetType()->GetFlatBitCount());
+  }
+  sig_builder.AddDataOutput(
+      "out", top->return_value()->GetType()->GetFlatBitCount());
+  sig_builder.WithCombinationalInterface();
+  sig_builder.WithFunctionType(top->GetType());
+  XLS_ASSIGN_OR_RETURN(ModuleSignature signature, sig_builder.Build());
+
+  return ModuleGeneratorResult{file.Emit(), signature};
+}
+
+}  // namespace verilog
+}  // namespace xls
@@ -0,0 +1,43 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_CODEGEN_HIERARCHICAL_GENERATOR_H_
+#define XLS_CODEGEN_HIERARCHICAL_GENERATOR_H_
+
+#include "absl/status/statusor.h"
+#include "xls/codegen/codegen_options.h"
+#include "xls/codegen/module_signature.h"
+#include "xls/ir/function.h"
+
+namespace xls {
+namespace verilog {
+
+// Emits the given function and every function it transitively invokes as
+// separate combinational Verilog modules in a single file, one module per IR
+// function, with invoke nodes lowered to module instantiations instead of
+// requiring the callees to be inlined. The module hierarchy mirrors the IR
+// function hierarchy, so downstream synthesis and place-and-route can work
+// per module and an unchanged callee emits byte-identical Verilog.
+//
+// Every invoked function's parameters and return value must be bits-typed
+// because they become flat instance ports; functions with compound-typed
+// interfaces must be inlined before codegen. The returned signature
+// describes the top module.
+absl::StatusOr<ModuleGeneratorResult> GenerateHierarchicalCombinationalModule(
+    Function* top, const CodegenOptions& options);
+
+}  // namespace verilog
+}  // namespace xls
+
+#endif  // XLS_CODEGEN_HIERARCHICAL_GENERATOR_H_
@@ -0,0 +1,126 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/codegen/hierarchical_generator.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+
+namespace xls {
+namespace verilog {
+namespace {
+
+using status_testing::StatusIs;
+using ::testing::HasSubstr;
+
+class HierarchicalGeneratorTest : public IrTestBase {};
+
+TEST_F(HierarchicalGeneratorTest, InvokeBecomesInstantiation) {
+  auto p = CreatePackage();
+  Type* u32 = p->GetBitsType(32);
+
+  FunctionBuilder callee_fb("add_one", p.get());
+  callee_fb.Add(callee_fb.Param("x", u32),
+                callee_fb.Literal(UBits(1, 32)));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * callee, callee_fb.Build());
+
+  FunctionBuilder top_fb("top", p.get());
+  BValue a = top_fb.Param("a", u32);
+  BValue first = top_fb.Invoke({a}, callee);
+  top_fb.Invoke({first}, callee);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * top, top_fb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ModuleGeneratorResult result,
+      GenerateHierarchicalCombinationalModule(top, CodegenOptions()));
+
+  // One module per function, callee defined before the top module, and one
+  // instantiation per invoke.
+  EXPECT_THAT(result.verilog_text, HasSubstr("module add_one"));
+  EXPECT_THAT(result.verilog_text, HasSubstr("module top"));
+  EXPECT_LT(result.verilog_text.find("module add_one"),
+            result.verilog_text.find("module top"));
+  EXPECT_THAT(result.verilog_text, HasSubstr("add_one invoke"));
+  EXPECT_THAT(result.verilog_text, HasSubstr(".x("));
+  EXPECT_THAT(result.verilog_text, HasSubstr(".out("));
+
+  EXPECT_EQ(result.signature.module_name(), "top");
+  EXPECT_TRUE(result.signature.proto().has_combinational());
+}
+
+TEST_F(HierarchicalGeneratorTest, NestedInvokesEmitEveryFunctionOnce) {
+  auto p = CreatePackage();
+  Type* u16 = p->GetBitsType(16);
+
+  FunctionBuilder leaf_fb("leaf", p.get());
+  leaf_fb.Negate(leaf_fb.Param("x", u16));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * leaf, leaf_fb.Build());
+
+  FunctionBuilder mid_fb("mid", p.get());
+  BValue mid_x = mid_fb.Param("x", u16);
+  mid_fb.Add(mid_fb.Invoke({mid_x}, leaf), mid_x);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * mid, mid_fb.Build());
+
+  FunctionBuilder top_fb("top", p.get());
+  BValue a = top_fb.Param("a", u16);
+  // Both the middle function and the leaf are invoked from the top; the leaf
+  // module must still only be emitted once.
+  top_fb.Add(top_fb.Invoke({a}, mid), top_fb.Invoke({a}, leaf));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * top, top_fb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ModuleGeneratorResult result,
+      GenerateHierarchicalCombinationalModule(top, CodegenOptions()));
+
+  auto count_occurrences = [](absl::string_view text, absl::string_view sub) {
+    int64_t count = 0;
+    for (size_t pos = text.find(sub); pos != absl::string_view::npos;
+         pos = text.find(sub, pos + 1)) {
+      ++count;
+    }
+    return count;
+  };
+  EXPECT_EQ(count_occurrences(result.verilog_text, "module leaf"), 1);
+  EXPECT_EQ(count_occurrences(result.verilog_text, "module mid"), 1);
+}
+
+TEST_F(HierarchicalGeneratorTest, CompoundCalleeInterfaceIsAnError) {
+  auto p = CreatePackage();
+  Type* u8 = p->GetBitsType(8);
+  Type* tuple_type = p->GetTupleType({u8, u8});
+
+  FunctionBuilder callee_fb("tuple_callee", p.get());
+  BValue t = callee_fb.Param("t", tuple_type);
+  callee_fb.Add(callee_fb.TupleIndex(t, 0), callee_fb.TupleIndex(t, 1));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * callee, callee_fb.Build());
+
+  FunctionBuilder top_fb("top", p.get());
+  BValue a = top_fb.Param("a", u8);
+  top_fb.Invoke({top_fb.Tuple({a, a})}, callee);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * top, top_fb.Build());
+
+  EXPECT_THAT(
+      GenerateHierarchicalCombinationalModule(top, CodegenOptions()).status(),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("bits-typed")));
+}
+
+}  // namespace
+}  // namespace verilog
+}  // namespace xls
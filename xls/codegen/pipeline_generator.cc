@@ -15,6 +15,7 @@
 #include "xls/codegen/pipeline_generator.h"
 
 #include <algorithm>
+#include <ostream>
 
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
@@ -33,14 +34,16 @@ namespace verilog {
 
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PipelineSchedule& schedule, Function* func,
-    const CodegenOptions& options) {
+    const CodegenOptions& options, std::ostream* verilog_stream,
+    PassResults* pass_results) {
   return ToPipelineModuleText(schedule, static_cast<FunctionBase*>(func),
-                              options);
+                              options, verilog_stream, pass_results);
 }
 
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PipelineSchedule& schedule, FunctionBase* module,
-    const CodegenOptions& options) {
+    const CodegenOptions& options, std::ostream* verilog_stream,
+    PassResults* pass_results) {
   XLS_VLOG(2) << "Generating pipelined module for module:";
   XLS_VLOG_LINES(2, module->DumpIr());
   XLS_VLOG_LINES(2, schedule.ToString());
@@ -68,10 +71,17 @@ absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
   }
 
   CodegenPassUnit unit(module->package(), block);
-  PassResults results;
+  PassResults local_results;
+  PassResults* results =
+      pass_results == nullptr ? &local_results : pass_results;
   XLS_RETURN_IF_ERROR(
-      CreateCodegenPassPipeline()->Run(&unit, pass_options, &results).status());
+      CreateCodegenPassPipeline()->Run(&unit, pass_options, results).status());
   XLS_RET_CHECK(unit.signature.has_value());
+  if (verilog_stream != nullptr) {
+    XLS_RETURN_IF_ERROR(
+        GenerateVerilog(block, pass_options.codegen_options, *verilog_stream));
+    return ModuleGeneratorResult{"", unit.signature.value()};
+  }
   XLS_ASSIGN_OR_RETURN(std::string verilog,
                        GenerateVerilog(block, pass_options.codegen_options));
 
@@ -15,6 +15,7 @@
 #ifndef XLS_CODEGEN_PIPELINE_GENERATOR_H_
 #define XLS_CODEGEN_PIPELINE_GENERATOR_H_
 
+#include <iosfwd>
 #include <string>
 
 #include "absl/status/statusor.h"
@@ -28,6 +29,9 @@
 #include "xls/scheduling/pipeline_schedule.h"
 
 namespace xls {
+
+struct PassResults;
+
 namespace verilog {
 
 // Class setting up default options passed to the pipeline generator.
@@ -41,17 +45,24 @@ inline CodegenOptions BuildPipelineOptions() {
 
 // Emits the given function as a verilog module which follows the given
 // schedule. The module is pipelined with a latency and initiation interval
-// given in the signature.
+// given in the signature. If `verilog_stream` is non-null the Verilog text is
+// streamed through it as it is emitted and the verilog_text field of the
+// returned result is left empty; this keeps peak memory independent of the
+// size of the emitted text. If `pass_results` is non-null the per-pass
+// invocation records of the codegen pass pipeline (timing, node-count and
+// peak-RSS deltas) are accumulated into it.
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PipelineSchedule& schedule, Function* func,
-    const CodegenOptions& options = BuildPipelineOptions());
+    const CodegenOptions& options = BuildPipelineOptions(),
+    std::ostream* verilog_stream = nullptr, PassResults* pass_results = nullptr);
 
 // Emits the given function or proc as a verilog module which follows the given
 // schedule. The module is pipelined with a latency and initiation interval
 // given in the signature.
 absl::StatusOr<ModuleGeneratorResult> ToPipelineModuleText(
     const PipelineSchedule& schedule, FunctionBase* module,
-    const CodegenOptions& options = BuildPipelineOptions());
+    const CodegenOptions& options = BuildPipelineOptions(),
+    std::ostream* verilog_stream = nullptr, PassResults* pass_results = nullptr);
 
 }  // namespace verilog
 }  // namespace xls
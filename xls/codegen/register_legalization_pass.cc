@@ -23,31 +23,31 @@ namespace xls::verilog {
 absl::StatusOr<bool> RegisterLegalizationPass::RunInternal(
     CodegenPassUnit* unit, const CodegenPassOptions& options,
     PassResults* results) const {
-  bool changed = false;
   Block* block = unit->block;
 
-  std::vector<Register*> registers(block->GetRegisters().begin(),
-                                   block->GetRegisters().end());
-  for (Register* reg : registers) {
+  std::vector<Register*> zero_width_registers;
+  for (Register* reg : block->GetRegisters()) {
     if (reg->type()->GetFlatBitCount() == 0) {
-      // Replace the uses of RegisterRead of a zero-width register with a
-      // zero-valued literal and delete the register, RegisterRead, and
-      // RegisterWrite.
-      XLS_ASSIGN_OR_RETURN(RegisterRead * reg_read,
-                           block->GetRegisterRead(reg));
-      XLS_ASSIGN_OR_RETURN(RegisterWrite * reg_write,
-                           block->GetRegisterWrite(reg));
-      XLS_RETURN_IF_ERROR(
-          reg_read->ReplaceUsesWithNew<xls::Literal>(ZeroOfType(reg->type()))
-              .status());
-      XLS_RETURN_IF_ERROR(block->RemoveNode(reg_read));
-      XLS_RETURN_IF_ERROR(block->RemoveNode(reg_write));
-      XLS_RETURN_IF_ERROR(block->RemoveRegister(reg));
-      changed = true;
+      zero_width_registers.push_back(reg);
     }
   }
+  for (Register* reg : zero_width_registers) {
+    // Replace the uses of RegisterRead of a zero-width register with a
+    // zero-valued literal and delete the RegisterRead and RegisterWrite.
+    XLS_ASSIGN_OR_RETURN(RegisterRead * reg_read, block->GetRegisterRead(reg));
+    XLS_ASSIGN_OR_RETURN(RegisterWrite * reg_write,
+                         block->GetRegisterWrite(reg));
+    XLS_RETURN_IF_ERROR(
+        reg_read->ReplaceUsesWithNew<xls::Literal>(ZeroOfType(reg->type()))
+            .status());
+    XLS_RETURN_IF_ERROR(block->RemoveNode(reg_read));
+    XLS_RETURN_IF_ERROR(block->RemoveNode(reg_write));
+  }
+  // Remove the registers themselves in one batch; removing one at a time is
+  // linear in the number of registers in the block per removal.
+  XLS_RETURN_IF_ERROR(block->RemoveRegisters(zero_width_registers));
 
-  return changed;
+  return !zero_width_registers.empty();
 }
 
 }  // namespace xls::verilog
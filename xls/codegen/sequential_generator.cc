@@ -14,6 +14,7 @@
 
 #include "xls/codegen/sequential_generator.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
@@ -24,6 +25,7 @@
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "xls/codegen/finite_state_machine.h"
@@ -33,6 +35,7 @@
 #include "xls/codegen/pipeline_generator.h"
 #include "xls/codegen/vast.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/logging/vlog_is_on.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/delay_model/delay_estimator.h"
@@ -67,6 +70,9 @@ absl::Status SequentialModuleBuilder::AddFsm(
   // Create states.
   FsmBuilder fsm("sequential_fsm", module(), port_references_.clk,
                  sequential_options_.use_system_verilog(), reset);
+  // Let the state count pick the encoding; control-heavy FSMs get one-hot
+  // encoded to shorten the next-state decode path.
+  fsm.SetStateEncoding(FsmStateEncoding::kAuto);
   // Null state is used as the initial state to force a state transition to
   // Ready state when the FSM is reset. Without this, FSM outputs may not
   // simulate correctly in the ready state (b/159519643). The null state is not
@@ -377,6 +383,48 @@ SequentialModuleBuilder::GenerateModuleSignature() {
   return std::move(signature);
 }
 
+// Logs (at VLOG level 1) how the expensive operators (multiplies and
+// divides) of the loop body are distributed over the pipeline stages of the
+// given schedule. Only one loop iteration is in flight at a time in the
+// sequential module, so the stage with the most expensive operators bounds
+// how much further an initiation-interval sweep could spread them out.
+static void LogResourceSharingAnalysis(const PipelineSchedule& schedule,
+                                       Function* loop_body) {
+  if (!XLS_VLOG_IS_ON(1)) {
+    return;
+  }
+  auto is_expensive = [](Node* node) {
+    switch (node->op()) {
+      case Op::kUMul:
+      case Op::kSMul:
+      case Op::kUDiv:
+      case Op::kSDiv:
+        return true;
+      default:
+        return false;
+    }
+  };
+  int64_t total = 0;
+  int64_t max_per_stage = 0;
+  for (int64_t stage = 0; stage < schedule.length(); ++stage) {
+    int64_t in_stage = 0;
+    for (Node* node : schedule.nodes_in_cycle(stage)) {
+      if (is_expensive(node)) {
+        ++in_stage;
+      }
+    }
+    XLS_VLOG(1) << absl::StrFormat(
+        "Sequential module loop body %s stage %d: %d expensive operator(s)",
+        loop_body->name(), stage, in_stage);
+    total += in_stage;
+    max_per_stage = std::max(max_per_stage, in_stage);
+  }
+  XLS_VLOG(1) << absl::StrFormat(
+      "Sequential module loop body %s: %d expensive operator(s) over %d "
+      "stage(s), at most %d per stage",
+      loop_body->name(), total, schedule.length(), max_per_stage);
+}
+
 absl::StatusOr<std::unique_ptr<ModuleGeneratorResult>>
 SequentialModuleBuilder::GenerateLoopBodyPipeline() {
   // Set pipeline options.
@@ -389,14 +437,36 @@ SequentialModuleBuilder::GenerateLoopBodyPipeline() {
                   reset_options.active_low(), reset_options.reset_data_path());
   }
 
-  // Get schedule.
+  // Get schedule. An explicit initiation interval determines the number of
+  // pipeline stages of the loop body: the single body instance is
+  // time-multiplexed across iterations, so one iteration is started every
+  // 'initiation interval' cycles.
   Function* loop_body_function = loop_->body();
+  SchedulingOptions scheduling_options =
+      sequential_options_.pipeline_scheduling_options();
+  int64_t initiation_interval = sequential_options_.initiation_interval();
+  if (initiation_interval < 1) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Initiation interval must be at least 1, got %d.",
+                        initiation_interval));
+  }
+  if (initiation_interval > 1) {
+    if (scheduling_options.pipeline_stages().has_value() &&
+        scheduling_options.pipeline_stages().value() != initiation_interval) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Initiation interval (%d) conflicts with explicitly specified "
+          "pipeline stage count (%d).",
+          initiation_interval, scheduling_options.pipeline_stages().value()));
+    }
+    scheduling_options.pipeline_stages(initiation_interval);
+  }
   XLS_ASSIGN_OR_RETURN(
       PipelineSchedule schedule,
       PipelineSchedule::Run(loop_body_function,
                             *sequential_options_.delay_estimator(),
-                            sequential_options_.pipeline_scheduling_options()));
+                            scheduling_options));
   XLS_RETURN_IF_ERROR(schedule.Verify());
+  LogResourceSharingAnalysis(schedule, loop_body_function);
 
   std::unique_ptr<ModuleGeneratorResult> result =
       std::make_unique<ModuleGeneratorResult>();
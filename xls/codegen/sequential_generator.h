@@ -83,12 +83,28 @@ class SequentialOptions {
   }
   bool use_system_verilog() const { return use_system_verilog_; }
 
+  // Number of cycles between the start of successive loop iterations. The
+  // sequential module instantiates the loop body datapath once and
+  // time-multiplexes it across iterations, so the initiation interval is the
+  // number of pipeline stages the loop body is scheduled into (per the delay
+  // estimator). Larger values spread an iteration's operations over more,
+  // shorter cycles; smaller values use fewer pipeline registers at a longer
+  // clock period. The default of 1 leaves the stage count to
+  // pipeline_scheduling_options(). Intended to be swept programmatically for
+  // area/latency trade-off exploration.
+  SequentialOptions& initiation_interval(int64_t value) {
+    initiation_interval_ = value;
+    return *this;
+  }
+  int64_t initiation_interval() const { return initiation_interval_; }
+
  private:
   const DelayEstimator* delay_estimator_ = &GetStandardDelayEstimator();
   absl::optional<std::string> module_name_;
   absl::optional<ResetProto> reset_proto_;
   SchedulingOptions pipeline_scheduling_options_;
   bool use_system_verilog_ = true;
+  int64_t initiation_interval_ = 1;
   // TODO(jbaileyhandle): Interface options.
 };
 
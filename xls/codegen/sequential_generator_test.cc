@@ -127,6 +127,54 @@ fn __LoopBodyPipelineTest__main() -> bits[32] {
 
 // TODO(jbaileyhandle): Test reset signature for pipeline.
 
+TEST_P(SequentialGeneratorTest, LoopBodyPipelineInitiationInterval) {
+  std::string text = R"(
+package LoopBodyPipelineInitiationInterval
+
+fn body(index: bits[32], acc: bits[32]) -> bits[32] {
+  add.5: bits[32] = add(acc, index)
+  literal.6: bits[32] = literal(value=3)
+  add.7: bits[32] = add(add.5, literal.6)
+  literal.8: bits[32] = literal(value=4)
+  ret add.9: bits[32] = add(add.7, literal.8)
+}
+
+fn main() -> bits[32] {
+  literal.1: bits[32] = literal(value=0)
+  ret counted_for.10: bits[32] = counted_for(literal.1, trip_count=4, stride=1, body=body)
+}
+
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(text));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * main, package->EntryFunction());
+  XLS_ASSERT_OK_AND_ASSIGN(Node * node_loop, main->GetNode("counted_for.10"));
+  CountedFor* loop = node_loop->As<CountedFor>();
+
+  // The initiation interval determines the number of loop body pipeline
+  // stages (latency is one less than the stage count).
+  SequentialOptions sequential_options;
+  sequential_options.use_system_verilog(UseSystemVerilog());
+  sequential_options.initiation_interval(3);
+  SequentialModuleBuilder builder(sequential_options, loop);
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ModuleGeneratorResult> loop_body,
+                           builder.GenerateLoopBodyPipeline());
+  ASSERT_TRUE(loop_body->signature.proto().has_pipeline());
+  EXPECT_EQ(loop_body->signature.proto().pipeline().latency(), 2);
+
+  // A conflicting explicit pipeline stage count is an error.
+  SequentialOptions conflicting_options;
+  conflicting_options.use_system_verilog(UseSystemVerilog());
+  conflicting_options.initiation_interval(3);
+  conflicting_options.pipeline_scheduling_options(
+      SchedulingOptions().pipeline_stages(2));
+  SequentialModuleBuilder conflicting_builder(conflicting_options, loop);
+  EXPECT_THAT(conflicting_builder.GenerateLoopBodyPipeline().status(),
+              status_testing::StatusIs(
+                  absl::StatusCode::kInvalidArgument,
+                  ::testing::HasSubstr("Initiation interval")));
+}
+
 TEST_P(SequentialGeneratorTest, ModuleSignatureTestSimple) {
   std::string text = R"(
 package LoopBodyPipelineTest
@@ -14,6 +14,9 @@
 
 #include "xls/codegen/vast.h"
 
+#include <ostream>
+#include <sstream>
+
 #include "absl/flags/flag.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/ascii.h"
@@ -21,6 +24,7 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
+#include "absl/strings/str_split.h"
 #include "absl/strings/strip.h"
 #include "xls/common/indent.h"
 #include "xls/common/logging/logging.h"
@@ -48,6 +52,10 @@ std::string SanitizeIdentifier(absl::string_view name) {
   return sanitized;
 }
 
+absl::string_view InternIdentifier(VerilogFile* file, absl::string_view name) {
+  return file->Intern(name);
+}
+
 std::string ToString(Direction direction) {
   switch (direction) {
     case Direction::kInput:
@@ -118,20 +126,20 @@ DataType* VerilogFile::UnpackedArrayType(int64_t element_bit_count,
 }
 
 std::string VerilogFile::Emit() const {
-  auto file_member_str = [](const FileMember& member) -> std::string {
-    return absl::visit(
-        Visitor{[](Include* m) -> std::string { return m->Emit(); },
-                [](Module* m) -> std::string { return m->Emit(); },
-                [](BlankLine* m) -> std::string { return m->Emit(); },
-                [](Comment* m) -> std::string { return m->Emit(); }},
-        member);
-  };
+  std::ostringstream out;
+  Emit(out);
+  return out.str();
+}
 
-  std::string out;
+void VerilogFile::Emit(std::ostream& os) const {
   for (const FileMember& member : members_) {
-    absl::StrAppend(&out, file_member_str(member), "\n");
+    absl::visit(Visitor{[&](Include* m) { os << m->Emit(); },
+                        [&](Module* m) { m->Emit(os); },
+                        [&](BlankLine* m) { os << m->Emit(); },
+                        [&](Comment* m) { os << m->Emit(); }},
+                member);
+    os << "\n";
   }
-  return out;
 }
 
 LocalParamItemRef* LocalParam::AddItem(absl::string_view name,
@@ -193,7 +201,7 @@ absl::StatusOr<PortProto> Port::ToProto() const {
 VerilogFunction::VerilogFunction(absl::string_view name, DataType* result_type,
                                  VerilogFile* file)
     : VastNode(file),
-      name_(name),
+      name_(InternIdentifier(file, name)),
       return_value_def_(file->Make<RegDef>(name, result_type)),
       statement_block_(file->Make<StatementBlock>()) {}
 
@@ -409,6 +417,22 @@ std::string EmitModuleMember(const ModuleMember& member) {
       member);
 }
 
+// Streams `text` to `os` indented by two spaces, line by line. Matches
+// Indent() (empty lines are not indented) without building an indented copy
+// of the whole string.
+void EmitIndented(absl::string_view text, std::ostream& os) {
+  bool first = true;
+  for (absl::string_view line : absl::StrSplit(text, '\n')) {
+    if (!first) {
+      os << "\n";
+    }
+    first = false;
+    if (!line.empty()) {
+      os << "  " << line;
+    }
+  }
+}
+
 }  // namespace
 
 std::vector<ModuleMember> ModuleSection::GatherMembers() const {
@@ -444,7 +468,7 @@ std::string Comment::Emit() const {
 
 std::string InlineVerilogStatement::Emit() const { return text_; }
 
-std::string InlineVerilogRef::Emit() const { return name_; }
+std::string InlineVerilogRef::Emit() const { return std::string(name_); }
 
 std::string Assert::Emit() const {
   // The $fatal statement takes finish_number as the first argument which is a
@@ -490,22 +514,35 @@ std::string SystemFunctionCall::Emit() const {
 }
 
 std::string Module::Emit() const {
-  std::string result = absl::StrCat("module ", name_);
+  std::ostringstream out;
+  Emit(out);
+  return out.str();
+}
+
+void Module::Emit(std::ostream& os) const {
+  os << "module " << name_;
   if (ports_.empty()) {
-    absl::StrAppend(&result, ";\n");
+    os << ";\n";
   } else {
-    absl::StrAppend(&result, "(\n  ");
-    absl::StrAppend(
-        &result,
-        absl::StrJoin(ports_, ",\n  ", [](std::string* out, const Port& port) {
-          absl::StrAppendFormat(out, "%s %s", ToString(port.direction),
-                                port.wire->EmitNoSemi());
-        }));
-    absl::StrAppend(&result, "\n);\n");
-  }
-  absl::StrAppend(&result, Indent(top_.Emit()), "\n");
-  absl::StrAppend(&result, "endmodule");
-  return result;
+    os << "(\n  ";
+    os << absl::StrJoin(ports_, ",\n  ", [](std::string* out,
+                                            const Port& port) {
+      absl::StrAppendFormat(out, "%s %s", ToString(port.direction),
+                            port.wire->EmitNoSemi());
+    });
+    os << "\n);\n";
+  }
+  // Emit the body member by member, indenting as the text is streamed, so the
+  // entire body is never materialized as one string.
+  std::vector<ModuleMember> members = top_.GatherMembers();
+  if (members.empty()) {
+    os << "\n";
+  }
+  for (const ModuleMember& member : members) {
+    EmitIndented(EmitModuleMember(member), os);
+    os << "\n";
+  }
+  os << "endmodule";
 }
 
 std::string Literal::Emit() const {
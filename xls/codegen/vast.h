@@ -18,6 +18,7 @@
 #ifndef XLS_CODEGEN_VAST_H_
 #define XLS_CODEGEN_VAST_H_
 
+#include <iosfwd>
 #include <limits>
 #include <memory>
 #include <string>
@@ -25,6 +26,7 @@
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/container/node_hash_set.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/strip.h"
@@ -49,6 +51,11 @@ class Unary;
 // characters are replaced with '_'.
 std::string SanitizeIdentifier(absl::string_view name);
 
+// Returns a view of `name` owned by `file`'s identifier table (see
+// VerilogFile::Intern). Used by VAST nodes to share storage for repeated
+// identifiers rather than holding a std::string per node.
+absl::string_view InternIdentifier(VerilogFile* file, absl::string_view name);
+
 // Base type for a VAST node. All nodes are owned by a VerilogFile.
 class VastNode {
  public:
@@ -180,7 +187,7 @@ class Def : public Statement {
   Def(absl::string_view name, DataKind data_kind, DataType* data_type,
       VerilogFile* file)
       : Statement(file),
-        name_(name),
+        name_(InternIdentifier(file, name)),
         data_kind_(data_kind),
         data_type_(std::move(data_type)) {}
 
@@ -189,12 +196,12 @@ class Def : public Statement {
   // Emit the definition without the trailing semicolon.
   std::string EmitNoSemi() const;
 
-  const std::string& GetName() const { return name_; }
+  std::string GetName() const { return std::string(name_); }
   DataKind data_kind() const { return data_kind_; }
   DataType* data_type() const { return data_type_; }
 
  private:
-  std::string name_;
+  absl::string_view name_;
   DataKind data_kind_;
   DataType* data_type_;
 };
@@ -550,16 +557,16 @@ class Instantiation : public VastNode {
                 absl::Span<const Connection> parameters,
                 absl::Span<const Connection> connections, VerilogFile* file)
       : VastNode(file),
-        module_name_(module_name),
-        instance_name_(instance_name),
+        module_name_(InternIdentifier(file, module_name)),
+        instance_name_(InternIdentifier(file, instance_name)),
         parameters_(parameters.begin(), parameters.end()),
         connections_(connections.begin(), connections.end()) {}
 
   std::string Emit() const override;
 
  private:
-  std::string module_name_;
-  std::string instance_name_;
+  absl::string_view module_name_;
+  absl::string_view instance_name_;
   std::vector<Connection> parameters_;
   std::vector<Connection> connections_;
 };
@@ -567,26 +574,26 @@ class Instantiation : public VastNode {
 // Represents a reference to an already-defined macro.
 class MacroRef : public Expression {
  public:
-  MacroRef(std::string name, VerilogFile* file)
-      : Expression(file), name_(name) {}
+  MacroRef(absl::string_view name, VerilogFile* file)
+      : Expression(file), name_(InternIdentifier(file, name)) {}
 
   std::string Emit() const override;
 
  private:
-  std::string name_;
+  absl::string_view name_;
 };
 
 // Defines a module parameter.
 class Parameter : public NamedTrait {
  public:
   Parameter(absl::string_view name, Expression* rhs, VerilogFile* file)
-      : NamedTrait(file), name_(name), rhs_(rhs) {}
+      : NamedTrait(file), name_(InternIdentifier(file, name)), rhs_(rhs) {}
 
   std::string Emit() const override;
-  std::string GetName() const override { return name_; }
+  std::string GetName() const override { return std::string(name_); }
 
  private:
-  std::string name_;
+  absl::string_view name_;
   Expression* rhs_;
 };
 
@@ -594,14 +601,14 @@ class Parameter : public NamedTrait {
 class LocalParamItem : public NamedTrait {
  public:
   LocalParamItem(absl::string_view name, Expression* rhs, VerilogFile* file)
-      : NamedTrait(file), name_(name), rhs_(rhs) {}
+      : NamedTrait(file), name_(InternIdentifier(file, name)), rhs_(rhs) {}
 
-  std::string GetName() const override { return name_; }
+  std::string GetName() const override { return std::string(name_); }
 
   std::string Emit() const override;
 
  private:
-  std::string name_;
+  absl::string_view name_;
   Expression* rhs_;
 };
 
@@ -1065,12 +1072,14 @@ class InlineVerilogRef : public IndexableExpression {
  public:
   InlineVerilogRef(absl::string_view name,
                    InlineVerilogStatement* raw_statement, VerilogFile* file)
-      : IndexableExpression(file), name_(name), raw_statement_(raw_statement) {}
+      : IndexableExpression(file),
+        name_(InternIdentifier(file, name)),
+        raw_statement_(raw_statement) {}
 
   std::string Emit() const override;
 
  private:
-  std::string name_;
+  absl::string_view name_;
   InlineVerilogStatement* raw_statement_;
 };
 
@@ -1079,19 +1088,19 @@ class SystemTaskCall : public Statement {
  public:
   // An argumentless invocation of a system task such as: $finish;
   SystemTaskCall(absl::string_view name, VerilogFile* file)
-      : Statement(file), name_(name) {}
+      : Statement(file), name_(InternIdentifier(file, name)) {}
 
   // An invocation of a system task with arguments.
   SystemTaskCall(absl::string_view name, absl::Span<Expression* const> args,
                  VerilogFile* file)
       : Statement(file),
-        name_(name),
+        name_(InternIdentifier(file, name)),
         args_(std::vector<Expression*>(args.begin(), args.end())) {}
 
   std::string Emit() const override;
 
  private:
-  std::string name_;
+  absl::string_view name_;
   absl::optional<std::vector<Expression*>> args_;
 };
 
@@ -1100,19 +1109,19 @@ class SystemFunctionCall : public Expression {
  public:
   // An argumentless invocation of a system function such as: $time;
   SystemFunctionCall(absl::string_view name, VerilogFile* file)
-      : Expression(file), name_(name) {}
+      : Expression(file), name_(InternIdentifier(file, name)) {}
 
   // An invocation of a system function with arguments.
   SystemFunctionCall(absl::string_view name, absl::Span<Expression* const> args,
                      VerilogFile* file)
       : Expression(file),
-        name_(name),
+        name_(InternIdentifier(file, name)),
         args_(std::vector<Expression*>(args.begin(), args.end())) {}
 
   std::string Emit() const override;
 
  private:
-  std::string name_;
+  absl::string_view name_;
   absl::optional<std::vector<Expression*>> args_;
 };
 
@@ -1185,12 +1194,12 @@ class VerilogFunction : public VastNode {
   LogicRef* return_value_ref();
 
   // Returns the name of the function.
-  std::string name() const { return name_; }
+  std::string name() const { return std::string(name_); }
 
   std::string Emit() const override;
 
  private:
-  std::string name_;
+  absl::string_view name_;
   RegDef* return_value_def_;
 
   // The block containing all of the statements of the function. SystemVerilog
@@ -1279,7 +1288,7 @@ struct Port {
   static Port FromProto(const PortProto& proto, VerilogFile* file);
 
   absl::StatusOr<PortProto> ToProto() const;
-  const std::string& name() const { return wire->GetName(); }
+  std::string name() const { return wire->GetName(); }
   std::string ToString() const;
 
   Direction direction;
@@ -1290,7 +1299,7 @@ struct Port {
 class Module : public VastNode {
  public:
   Module(absl::string_view name, VerilogFile* file)
-      : VastNode(file), name_(name), top_(file) {}
+      : VastNode(file), name_(InternIdentifier(file, name)), top_(file) {}
 
   // Constructs and adds a node to the module. Ownership is maintained by the
   // parent VerilogFile. Most constructs should be added to the module. The
@@ -1324,17 +1333,22 @@ class Module : public VastNode {
   ModuleSection* top() { return &top_; }
 
   absl::Span<const Port> ports() const { return ports_; }
-  const std::string& name() const { return name_; }
+  std::string name() const { return std::string(name_); }
 
   std::string Emit() const override;
 
+  // Streams the emitted module through `os`. The module body is emitted
+  // member by member with indentation applied as the text is written, so the
+  // body is never materialized as a single string.
+  void Emit(std::ostream& os) const;
+
  private:
   // Add the given Def as a port on the module.
   LogicRef* AddPortDef(Direction direction, Def* def);
 
   std::string EmitMember(ModuleMember* member);
 
-  std::string name_;
+  absl::string_view name_;
   std::vector<Port> ports_;
 
   ModuleSection top_;
@@ -1380,6 +1394,18 @@ class VerilogFile {
 
   std::string Emit() const;
 
+  // Streams the emitted file through `os` rather than returning it as a
+  // string. Modules are emitted piecewise so peak memory is proportional to
+  // the largest member of the file rather than the entire emitted text.
+  void Emit(std::ostream& os) const;
+
+  // Returns a view of `name` owned by this file's identifier table.
+  // Identical names share a single copy and the view remains valid for the
+  // lifetime of the file.
+  absl::string_view Intern(absl::string_view name) {
+    return *interned_identifiers_.insert(std::string(name)).first;
+  }
+
   verilog::Slice* Slice(IndexableExpression* subject, Expression* hi,
                         Expression* lo) {
     return Make<verilog::Slice>(subject, hi, lo);
@@ -1598,6 +1624,10 @@ class VerilogFile {
   bool use_system_verilog_;
   std::vector<FileMember> members_;
   std::vector<std::unique_ptr<VastNode>> nodes_;
+
+  // Deduplicated identifier storage for the string_view name fields of VAST
+  // nodes. node_hash_set guarantees the stability of element addresses.
+  absl::node_hash_set<std::string> interned_identifiers_;
 };
 
 template <typename T, typename... Args>
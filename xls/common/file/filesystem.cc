@@ -16,6 +16,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -66,6 +67,9 @@ class ParseTextProtoFileErrorCollector : public google::protobuf::io::ErrorColle
   const google::protobuf::Message& proto_;
 };
 
+// Number of buffered bytes at which BufferedFileWriter flushes to the file.
+constexpr size_t kWriterBufferSize = 64 * 1024;
+
 enum class SetOrAppend { kSet, kAppend };
 
 absl::Status SetFileContentsOrAppend(const std::filesystem::path& file_name,
@@ -180,6 +184,145 @@ absl::StatusOr<std::string> GetFileContents(
   return std::move(result);
 }
 
+absl::StatusOr<MappedFileContents> MappedFileContents::Map(
+    const std::filesystem::path& file_name) {
+  // Use POSIX C APIs instead of C++ iostreams to avoid exceptions.
+  int fd = open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return ErrNoToStatusWithFilename(errno, file_name);
+  }
+
+  MappedFileContents result;
+  struct stat statbuf;
+  if (fstat(fd, &statbuf) == 0 && S_ISREG(statbuf.st_mode) &&
+      statbuf.st_size > 0) {
+    void* data = mmap(nullptr, statbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      result.data_ = data;
+      result.size_ = statbuf.st_size;
+      // The mapping outlives the descriptor.
+      close(fd);
+      return std::move(result);
+    }
+  }
+
+  // Empty file, not a regular file (e.g. a pipe), or mmap failed: fall back
+  // to reading the contents into an owned buffer.
+  close(fd);
+  XLS_ASSIGN_OR_RETURN(result.fallback_, GetFileContents(file_name));
+  return std::move(result);
+}
+
+MappedFileContents::~MappedFileContents() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+}
+
+MappedFileContents::MappedFileContents(MappedFileContents&& other)
+    : data_(other.data_),
+      size_(other.size_),
+      fallback_(std::move(other.fallback_)) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
+MappedFileContents& MappedFileContents::operator=(MappedFileContents&& other) {
+  if (this != &other) {
+    if (data_ != nullptr) {
+      munmap(data_, size_);
+    }
+    data_ = other.data_;
+    size_ = other.size_;
+    fallback_ = std::move(other.fallback_);
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+  return *this;
+}
+
+absl::StatusOr<BufferedFileWriter> BufferedFileWriter::Open(
+    const std::filesystem::path& file_name) {
+  // Use POSIX C APIs instead of C++ iostreams to avoid exceptions.
+  int fd =
+      open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0664);
+  if (fd == -1) {
+    return ErrNoToStatusWithFilename(errno, file_name);
+  }
+  return BufferedFileWriter(file_name, fd);
+}
+
+BufferedFileWriter::~BufferedFileWriter() {
+  if (fd_ == -1) {
+    return;
+  }
+  absl::Status status = Close();
+  if (!status.ok()) {
+    XLS_LOG(WARNING) << "Error closing " << file_name_.string() << ": "
+                     << status;
+  }
+}
+
+BufferedFileWriter::BufferedFileWriter(BufferedFileWriter&& other)
+    : file_name_(std::move(other.file_name_)),
+      fd_(other.fd_),
+      buffer_(std::move(other.buffer_)) {
+  other.fd_ = -1;
+}
+
+BufferedFileWriter& BufferedFileWriter::operator=(BufferedFileWriter&& other) {
+  if (this != &other) {
+    if (fd_ != -1) {
+      absl::Status status = Close();
+      if (!status.ok()) {
+        XLS_LOG(WARNING) << "Error closing " << file_name_.string() << ": "
+                         << status;
+      }
+    }
+    file_name_ = std::move(other.file_name_);
+    fd_ = other.fd_;
+    buffer_ = std::move(other.buffer_);
+    other.fd_ = -1;
+  }
+  return *this;
+}
+
+absl::Status BufferedFileWriter::Append(absl::string_view data) {
+  XLS_RET_CHECK_NE(fd_, -1) << "Append() called after Close()";
+  buffer_.append(data.data(), data.size());
+  if (buffer_.size() >= kWriterBufferSize) {
+    return Flush();
+  }
+  return absl::OkStatus();
+}
+
+absl::Status BufferedFileWriter::Close() {
+  XLS_RET_CHECK_NE(fd_, -1) << "Close() called twice";
+  absl::Status status = Flush();
+  int fd = fd_;
+  fd_ = -1;
+  if (close(fd) != 0 && status.ok()) {
+    return ErrNoToStatusWithFilename(errno, file_name_);
+  }
+  return status;
+}
+
+absl::Status BufferedFileWriter::Flush() {
+  ssize_t written = 0;
+  while (written < buffer_.size()) {
+    ssize_t n = write(fd_, buffer_.data() + written, buffer_.size() - written);
+    if (n < 0) {
+      if (errno == EAGAIN) {
+        continue;
+      }
+      return ErrNoToStatusWithFilename(errno, file_name_);
+    }
+    written += n;
+  }
+  buffer_.clear();
+  return absl::OkStatus();
+}
+
 absl::Status SetFileContents(const std::filesystem::path& file_name,
                              absl::string_view content) {
   return SetFileContentsOrAppend(file_name, content, SetOrAppend::kSet);
@@ -16,10 +16,12 @@
 #define XLS_COMMON_FILE_FILESYSTEM_H_
 
 #include <filesystem>
+#include <string>
 
 #include "google/protobuf/message.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 
 namespace xls {
 
@@ -76,6 +78,51 @@ absl::Status RecursivelyDeletePath(const std::filesystem::path& path);
 absl::StatusOr<std::string> GetFileContents(
     const std::filesystem::path& file_name);
 
+// Read-only view of the contents of a file. Where possible the contents are
+// memory-mapped rather than copied onto the heap, so opening a very large IR
+// or netlist file costs page-table entries instead of a full copy and the
+// pages are faulted in lazily as the parser walks them. Files which cannot be
+// mapped (empty files, pipes such as /dev/stdin, or an mmap failure) are
+// transparently read into an owned buffer instead; callers see no difference.
+//
+// The view returned by contents() is valid only for the lifetime of this
+// object.
+//
+// Typical return codes from Map (not guaranteed exhaustive):
+//  * StatusCode::kOk
+//  * StatusCode::kPermissionDenied (file not readable)
+//  * StatusCode::kNotFound (no such file)
+class MappedFileContents {
+ public:
+  // Opens `file_name` and maps (or, as a fallback, reads) its contents.
+  static absl::StatusOr<MappedFileContents> Map(
+      const std::filesystem::path& file_name);
+
+  ~MappedFileContents();
+
+  // MappedFileContents is movable but not copyable.
+  MappedFileContents(MappedFileContents&& other);
+  MappedFileContents& operator=(MappedFileContents&& other);
+  MappedFileContents(const MappedFileContents&) = delete;
+  MappedFileContents& operator=(const MappedFileContents&) = delete;
+
+  // The contents of the file.
+  absl::string_view contents() const {
+    return data_ == nullptr
+               ? absl::string_view(fallback_)
+               : absl::string_view(static_cast<const char*>(data_), size_);
+  }
+
+ private:
+  MappedFileContents() = default;
+
+  // Start and length of the mapped region; `data_` is nullptr when the read()
+  // fallback was taken and `fallback_` owns the contents instead.
+  void* data_ = nullptr;
+  size_t size_ = 0;
+  std::string fallback_;
+};
+
 // Writes the data provided in `content` to the file `file_name`, overwriting
 // any existing content. Fails if directory does not exist.
 //
@@ -113,6 +160,52 @@ absl::Status SetFileContents(const std::filesystem::path& file_name,
 absl::Status AppendStringToFile(const std::filesystem::path& file_name,
                                 absl::string_view content);
 
+// Streaming file writer which accumulates appended data in an internal buffer
+// and flushes it to the underlying file in large chunks. Useful for emitting
+// large outputs piecewise without paying one write() call per piece and
+// without materializing the whole output in memory first.
+//
+// WARNING: The file update is NOT guaranteed to be atomic.
+class BufferedFileWriter {
+ public:
+  // Opens `file_name` for writing, truncating any existing contents.
+  //
+  // Typical return codes (not guaranteed exhaustive):
+  //  * StatusCode::kOk
+  //  * StatusCode::kPermissionDenied (file not writable)
+  //  * StatusCode::kNotFound (an Open error occurred)
+  static absl::StatusOr<BufferedFileWriter> Open(
+      const std::filesystem::path& file_name);
+
+  ~BufferedFileWriter();
+
+  // BufferedFileWriter is movable but not copyable.
+  BufferedFileWriter(BufferedFileWriter&& other);
+  BufferedFileWriter& operator=(BufferedFileWriter&& other);
+  BufferedFileWriter(const BufferedFileWriter&) = delete;
+  BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+  // Appends `data` to the stream. The data may be retained in the internal
+  // buffer; it is guaranteed to be on disk only after a successful Close().
+  absl::Status Append(absl::string_view data);
+
+  // Flushes any buffered data and closes the file. Must be called at most
+  // once. Errors from a flush performed by the destructor are logged and
+  // otherwise lost, so prefer calling Close() explicitly.
+  absl::Status Close();
+
+ private:
+  BufferedFileWriter(const std::filesystem::path& file_name, int fd)
+      : file_name_(file_name), fd_(fd) {}
+
+  // Writes the contents of the internal buffer to the file.
+  absl::Status Flush();
+
+  std::filesystem::path file_name_;
+  int fd_ = -1;
+  std::string buffer_;
+};
+
 // Reads a single text formatted protobuf from a file.
 //
 // REQUIRES: `file_name` can be opened for reading.
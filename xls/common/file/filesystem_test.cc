@@ -178,6 +178,100 @@ TEST(FilesystemTest, GetFileContentsOfDirectoryFails) {
   EXPECT_THAT(contents, StatusIs(absl::StatusCode::kFailedPrecondition));
 }
 
+TEST(FilesystemTest, MappedFileContentsViewsFile) {
+  static constexpr char kContents[] = "h\ne\0y!";
+  // Make sure to include the \0 in the string, to verify that binary data can
+  // be mapped.
+  std::string contents(kContents, sizeof(kContents));
+
+  absl::StatusOr<TempFile> temp_file = TempFile::CreateWithContent(contents);
+  XLS_ASSERT_OK(temp_file);
+
+  absl::StatusOr<MappedFileContents> mapped =
+      MappedFileContents::Map(temp_file->path());
+
+  XLS_ASSERT_OK(mapped);
+  EXPECT_EQ(mapped->contents(), contents);
+}
+
+TEST(FilesystemTest, MappedFileContentsOfEmptyFileIsEmpty) {
+  absl::StatusOr<TempFile> temp_file = TempFile::Create();
+  XLS_ASSERT_OK(temp_file);
+
+  absl::StatusOr<MappedFileContents> mapped =
+      MappedFileContents::Map(temp_file->path());
+
+  XLS_ASSERT_OK(mapped);
+  EXPECT_TRUE(mapped->contents().empty());
+}
+
+TEST(FilesystemTest, MappedFileContentsOfNonexistingFileFails) {
+  absl::StatusOr<TempDirectory> temp_dir = TempDirectory::Create();
+  XLS_ASSERT_OK(temp_dir);
+
+  EXPECT_THAT(MappedFileContents::Map(temp_dir->path() / "nonexisting"),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST(FilesystemTest, MappedFileContentsIsMovable) {
+  absl::StatusOr<TempFile> temp_file = TempFile::CreateWithContent("hello");
+  XLS_ASSERT_OK(temp_file);
+
+  absl::StatusOr<MappedFileContents> mapped =
+      MappedFileContents::Map(temp_file->path());
+  XLS_ASSERT_OK(mapped);
+
+  MappedFileContents moved = std::move(*mapped);
+  EXPECT_EQ(moved.contents(), "hello");
+}
+
+TEST(FilesystemTest, BufferedFileWriterWritesAppendedData) {
+  absl::StatusOr<TempDirectory> temp_dir = TempDirectory::Create();
+  XLS_ASSERT_OK(temp_dir);
+  std::filesystem::path path = temp_dir->path() / "file";
+
+  absl::StatusOr<BufferedFileWriter> writer = BufferedFileWriter::Open(path);
+  XLS_ASSERT_OK(writer);
+  XLS_EXPECT_OK(writer->Append("hello"));
+  XLS_EXPECT_OK(writer->Append(" "));
+  XLS_EXPECT_OK(writer->Append("world"));
+  XLS_EXPECT_OK(writer->Close());
+
+  EXPECT_THAT(GetFileContents(path), IsOkAndHolds("hello world"));
+}
+
+TEST(FilesystemTest, BufferedFileWriterWritesDataLargerThanItsBuffer) {
+  absl::StatusOr<TempDirectory> temp_dir = TempDirectory::Create();
+  XLS_ASSERT_OK(temp_dir);
+  std::filesystem::path path = temp_dir->path() / "file";
+  std::string big(1024, 'x');
+
+  absl::StatusOr<BufferedFileWriter> writer = BufferedFileWriter::Open(path);
+  XLS_ASSERT_OK(writer);
+  for (int64_t i = 0; i < 256; ++i) {
+    XLS_EXPECT_OK(writer->Append(big));
+  }
+  XLS_EXPECT_OK(writer->Close());
+
+  absl::StatusOr<std::string> read_contents = GetFileContents(path);
+  XLS_ASSERT_OK(read_contents);
+  EXPECT_EQ(read_contents->size(), 256 * 1024);
+}
+
+TEST(FilesystemTest, BufferedFileWriterFlushesOnDestruction) {
+  absl::StatusOr<TempDirectory> temp_dir = TempDirectory::Create();
+  XLS_ASSERT_OK(temp_dir);
+  std::filesystem::path path = temp_dir->path() / "file";
+
+  {
+    absl::StatusOr<BufferedFileWriter> writer = BufferedFileWriter::Open(path);
+    XLS_ASSERT_OK(writer);
+    XLS_EXPECT_OK(writer->Append("hello"));
+  }
+
+  EXPECT_THAT(GetFileContents(path), IsOkAndHolds("hello"));
+}
+
 TEST(FilesystemTest, SetFileContentsCreatesFileWhenMissing) {
   absl::StatusOr<TempDirectory> temp_dir = TempDirectory::Create();
   XLS_ASSERT_OK(temp_dir);
@@ -17,6 +17,7 @@
 #include "absl/flags/parse.h"
 #include "xls/common/file/get_runfile_path.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/sampling_profiler.h"
 
 namespace xls {
 
@@ -27,6 +28,8 @@ std::vector<absl::string_view> InitXls(absl::string_view usage, int argc,
   std::vector<char*> remaining = absl::ParseCommandLine(argc, argv);
   XLS_CHECK_GE(argc, 1);
 
+  InitSamplingProfilerFromEnvironment();
+
   return std::vector<absl::string_view>(remaining.begin() + 1, remaining.end());
 }
 
@@ -0,0 +1,191 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/sampling_profiler.h"
+
+#include <signal.h>
+#include <sys/time.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "absl/debugging/stacktrace.h"
+#include "absl/debugging/symbolize.h"
+#include "absl/strings/str_cat.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/logging/logging.h"
+
+namespace xls {
+namespace {
+
+constexpr int kMaxStackDepth = 32;
+constexpr int kMaxSamples = 1 << 15;
+
+// A single captured stack. Filled in from the signal handler so the layout is
+// fixed-size and requires no allocation.
+struct Sample {
+  int depth;
+  void* pcs[kMaxStackDepth];
+  char annotation[kProfilerAnnotationLength];
+};
+
+// The annotation active on this thread; copied into each sample captured
+// while the thread is executing. A fixed buffer (rather than a pointer) so
+// the signal handler never chases potentially dangling storage.
+thread_local char current_annotation[kProfilerAnnotationLength] = {0};
+
+// Sample storage, preallocated at profiler initialization so the signal
+// handler only ever writes into existing memory. `sample_count` may run past
+// kMaxSamples; excess samples are dropped and reported at dump time.
+std::vector<Sample>* samples = nullptr;
+std::atomic<int64_t> sample_count(0);
+
+// Path the profile is written to at process exit.
+std::string* profile_path = nullptr;
+
+void SigprofHandler(int signum) {
+  int64_t index = sample_count.fetch_add(1, std::memory_order_relaxed);
+  if (index >= kMaxSamples) {
+    return;
+  }
+  Sample& sample = (*samples)[index];
+  // Skip the handler and signal trampoline frames.
+  sample.depth =
+      absl::GetStackTrace(sample.pcs, kMaxStackDepth, /*skip_count=*/2);
+  memcpy(sample.annotation, current_annotation, kProfilerAnnotationLength);
+}
+
+// Symbolizes the accumulated samples and writes them out in collapsed-stack
+// format. Registered with atexit() when the profiler is enabled.
+void DumpProfile() {
+  // Stop sampling before tearing anything down.
+  struct itimerval disable;
+  memset(&disable, 0, sizeof(disable));
+  setitimer(ITIMER_PROF, &disable, nullptr);
+
+  int64_t count = std::min<int64_t>(sample_count.load(), kMaxSamples);
+  if (sample_count.load() > kMaxSamples) {
+    XLS_LOG(WARNING) << "Sampling profiler dropped "
+                     << sample_count.load() - kMaxSamples
+                     << " samples; buffer of " << kMaxSamples << " was full.";
+  }
+
+  // Aggregate identical stacks. Symbol names are cached per PC as the same
+  // frames recur across most samples.
+  std::map<std::string, int64_t> folded_counts;
+  std::map<void*, std::string> symbol_cache;
+  std::array<char, 1024> symbol_buffer;
+  auto symbolize = [&](void* pc) -> const std::string& {
+    auto it = symbol_cache.find(pc);
+    if (it != symbol_cache.end()) {
+      return it->second;
+    }
+    std::string name;
+    if (absl::Symbolize(pc, symbol_buffer.data(), symbol_buffer.size())) {
+      name = symbol_buffer.data();
+    } else {
+      name = absl::StrCat(
+          "[unknown:", absl::Hex(reinterpret_cast<uintptr_t>(pc)), "]");
+    }
+    // Semicolons delimit frames in the folded format.
+    std::replace(name.begin(), name.end(), ';', ':');
+    return symbol_cache.emplace(pc, std::move(name)).first->second;
+  };
+
+  for (int64_t i = 0; i < count; ++i) {
+    const Sample& sample = (*samples)[i];
+    std::string line = sample.annotation[0] != '\0'
+                           ? std::string(sample.annotation)
+                           : std::string("(untagged)");
+    // Emit root-first so flame graphs grow from main() upwards.
+    for (int64_t frame = sample.depth - 1; frame >= 0; --frame) {
+      absl::StrAppend(&line, ";", symbolize(sample.pcs[frame]));
+    }
+    folded_counts[line] += 1;
+  }
+
+  std::string contents;
+  for (const auto& [line, n] : folded_counts) {
+    absl::StrAppend(&contents, line, " ", n, "\n");
+  }
+  absl::Status status = SetFileContents(*profile_path, contents);
+  if (!status.ok()) {
+    XLS_LOG(ERROR) << "Unable to write sample profile to " << *profile_path
+                   << ": " << status;
+    return;
+  }
+  XLS_LOG(INFO) << "Wrote " << count << " profile samples to "
+                << *profile_path;
+}
+
+}  // namespace
+
+void InitSamplingProfilerFromEnvironment() {
+  const char* path = getenv("XLS_SAMPLE_PROFILE");
+  if (path == nullptr || *path == '\0') {
+    return;
+  }
+  int64_t hz = 100;
+  if (const char* hz_str = getenv("XLS_SAMPLE_PROFILE_HZ")) {
+    hz = strtol(hz_str, nullptr, 10);
+    if (hz <= 0) {
+      XLS_LOG(WARNING) << "Invalid XLS_SAMPLE_PROFILE_HZ value '" << hz_str
+                       << "'; sampling profiler disabled.";
+      return;
+    }
+  }
+
+  profile_path = new std::string(path);
+  samples = new std::vector<Sample>(kMaxSamples);
+  atexit(DumpProfile);
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = SigprofHandler;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  XLS_CHECK_EQ(sigaction(SIGPROF, &action, nullptr), 0);
+
+  struct itimerval timer;
+  memset(&timer, 0, sizeof(timer));
+  int64_t interval_us = 1000000 / hz;
+  timer.it_interval.tv_sec = interval_us / 1000000;
+  timer.it_interval.tv_usec = interval_us % 1000000;
+  timer.it_value = timer.it_interval;
+  XLS_CHECK_EQ(setitimer(ITIMER_PROF, &timer, nullptr), 0);
+
+  XLS_LOG(INFO) << "Sampling profiler enabled at " << hz
+                << " Hz; writing profile to " << *profile_path;
+}
+
+ProfilerAnnotation::ProfilerAnnotation(absl::string_view label) {
+  memcpy(saved_, current_annotation, kProfilerAnnotationLength);
+  size_t length =
+      std::min<size_t>(label.size(), kProfilerAnnotationLength - 1);
+  memcpy(current_annotation, label.data(), length);
+  current_annotation[length] = '\0';
+}
+
+ProfilerAnnotation::~ProfilerAnnotation() {
+  memcpy(current_annotation, saved_, kProfilerAnnotationLength);
+}
+
+}  // namespace xls
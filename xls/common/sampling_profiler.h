@@ -0,0 +1,60 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Opt-in sampling profiler for XLS binaries. When enabled, a SIGPROF timer
+// periodically captures the call stack of the running thread; on process exit
+// the accumulated samples are symbolized and written out in collapsed-stack
+// ("folded") format, one `annotation;frame;frame;... count` line per distinct
+// stack, which flamegraph and pprof-style tooling consume directly. Samples
+// are tagged with the annotation (e.g. the currently running optimization
+// pass) that was active on the sampled thread.
+
+#ifndef XLS_COMMON_SAMPLING_PROFILER_H_
+#define XLS_COMMON_SAMPLING_PROFILER_H_
+
+#include "absl/strings/string_view.h"
+
+namespace xls {
+
+// Maximum length of a profiler annotation, including the terminating NUL.
+// Longer annotations are truncated.
+inline constexpr int kProfilerAnnotationLength = 64;
+
+// Installs the sampling profiler if the XLS_SAMPLE_PROFILE environment
+// variable is set to the path the profile should be written to. The sampling
+// frequency defaults to 100 Hz and may be overridden with
+// XLS_SAMPLE_PROFILE_HZ. Called by InitXls; a no-op if the variable is unset
+// so unprofiled runs pay nothing.
+void InitSamplingProfilerFromEnvironment();
+
+// RAII annotation for profile samples. While an instance is in scope, samples
+// captured on this thread are tagged with `label`; on destruction the
+// previously active annotation (if any) is restored, so nested annotations
+// attribute samples to the innermost scope. Construction is a small
+// thread-local copy whether or not the profiler is enabled.
+class ProfilerAnnotation {
+ public:
+  explicit ProfilerAnnotation(absl::string_view label);
+  ~ProfilerAnnotation();
+
+  ProfilerAnnotation(const ProfilerAnnotation&) = delete;
+  ProfilerAnnotation& operator=(const ProfilerAnnotation&) = delete;
+
+ private:
+  char saved_[kProfilerAnnotationLength];
+};
+
+}  // namespace xls
+
+#endif  // XLS_COMMON_SAMPLING_PROFILER_H_
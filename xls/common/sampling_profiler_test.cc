@@ -0,0 +1,45 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/sampling_profiler.h"
+
+#include <cstdlib>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace xls {
+namespace {
+
+TEST(SamplingProfilerTest, InitWithoutEnvVarIsNoOp) {
+  unsetenv("XLS_SAMPLE_PROFILE");
+  // Nothing to observe; this just must not install a timer or crash.
+  InitSamplingProfilerFromEnvironment();
+}
+
+TEST(SamplingProfilerTest, AnnotationsNest) {
+  ProfilerAnnotation outer("outer");
+  {
+    ProfilerAnnotation inner("inner");
+    { ProfilerAnnotation innermost("innermost"); }
+  }
+}
+
+TEST(SamplingProfilerTest, OverlongAnnotationIsTruncated) {
+  std::string long_label(2 * kProfilerAnnotationLength, 'x');
+  ProfilerAnnotation annotation(long_label);
+}
+
+}  // namespace
+}  // namespace xls
@@ -0,0 +1,185 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/thread_pool.h"
+
+#include <algorithm>
+#include <thread>  // NOLINT(build/c++11) for hardware_concurrency only.
+#include <utility>
+
+#include "xls/common/logging/logging.h"
+
+namespace xls {
+
+ThreadPool::ThreadPool(int64_t thread_count) {
+  XLS_CHECK_GE(thread_count, 1);
+  threads_.reserve(thread_count);
+  for (int64_t i = 0; i < thread_count; ++i) {
+    threads_.push_back(std::make_unique<Thread>([this]() { WorkerLoop(); }));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    absl::MutexLock lock(&mutex_);
+    // Wait for scheduled work to drain before shutting down the workers.
+    mutex_.Await(absl::Condition(
+        +[](int64_t* pending) { return *pending == 0; }, &pending_));
+    shutdown_ = true;
+  }
+  for (std::unique_ptr<Thread>& thread : threads_) {
+    thread->Join();
+  }
+}
+
+void ThreadPool::Schedule(std::function<void()> fn) {
+  absl::MutexLock lock(&mutex_);
+  XLS_CHECK(!shutdown_);
+  queue_.push_back(std::move(fn));
+  ++pending_;
+}
+
+void ThreadPool::WorkerLoop() {
+  while (true) {
+    std::function<void()> fn;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(
+          +[](ThreadPool* pool) {
+            pool->mutex_.AssertHeld();
+            return pool->shutdown_ || !pool->queue_.empty();
+          },
+          this));
+      if (queue_.empty()) {
+        return;
+      }
+      fn = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    fn();
+    {
+      absl::MutexLock lock(&mutex_);
+      --pending_;
+    }
+  }
+}
+
+/* static */ ThreadPool& ThreadPool::Global() {
+  static ThreadPool* global = new ThreadPool(std::max(
+      int64_t{1}, static_cast<int64_t>(std::thread::hardware_concurrency())));
+  return *global;
+}
+
+namespace {
+
+// Shared state of one ParallelForEach call. Iteration chunks are claimed
+// from 'next' under the mutex; the first error by index wins. Held by
+// shared_ptr because helper tasks queued behind other pool work may start
+// only after the call has already returned; such stragglers find all
+// iterations claimed (or an error recorded) and return without touching the
+// caller's iteration function.
+struct ParallelForState {
+  absl::Mutex mutex;
+  int64_t next ABSL_GUARDED_BY(mutex) = 0;
+  int64_t active_workers ABSL_GUARDED_BY(mutex) = 0;
+  absl::Status first_error ABSL_GUARDED_BY(mutex) = absl::OkStatus();
+  int64_t first_error_index ABSL_GUARDED_BY(mutex) = -1;
+
+  bool Done(int64_t count) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    return (next >= count || !first_error.ok()) && active_workers == 0;
+  }
+};
+
+}  // namespace
+
+absl::Status ParallelForEach(int64_t count, int64_t chunk_size,
+                             ThreadPool* pool,
+                             const std::function<absl::Status(int64_t)>& fn) {
+  XLS_CHECK_GE(chunk_size, 1);
+  if (count <= 0) {
+    return absl::OkStatus();
+  }
+
+  auto state = std::make_shared<ParallelForState>();
+  // 'fn' is captured by reference; workers only call it for chunks claimed
+  // before all iterations are exhausted or an error is recorded, both of
+  // which the caller waits for, so the reference cannot dangle.
+  auto run_worker = [state, count, chunk_size, &fn]() {
+    {
+      absl::MutexLock lock(&state->mutex);
+      ++state->active_workers;
+    }
+    while (true) {
+      int64_t begin;
+      int64_t end;
+      {
+        absl::MutexLock lock(&state->mutex);
+        // Once an error is recorded, unclaimed iterations are abandoned;
+        // chunks below the failing index were claimed earlier and still run,
+        // so the smallest failing index is always observed.
+        if (state->next >= count || !state->first_error.ok()) {
+          break;
+        }
+        begin = state->next;
+        end = std::min(count, begin + chunk_size);
+        state->next = end;
+      }
+      bool failed = false;
+      for (int64_t i = begin; i < end; ++i) {
+        absl::Status status = fn(i);
+        if (!status.ok()) {
+          absl::MutexLock lock(&state->mutex);
+          // Keep the error of the smallest failing index so the returned
+          // status is deterministic regardless of scheduling.
+          if (state->first_error_index == -1 ||
+              i < state->first_error_index) {
+            state->first_error = status;
+            state->first_error_index = i;
+          }
+          failed = true;
+          break;
+        }
+      }
+      if (failed) {
+        break;
+      }
+    }
+    absl::MutexLock lock(&state->mutex);
+    --state->active_workers;
+  };
+
+  int64_t helper_count =
+      std::min(pool->thread_count(), (count + chunk_size - 1) / chunk_size - 1);
+  for (int64_t i = 0; i < helper_count; ++i) {
+    pool->Schedule(run_worker);
+  }
+  // The calling thread participates rather than blocking idle; this also
+  // guarantees progress when the pool itself is saturated.
+  run_worker();
+
+  struct DoneCondition {
+    ParallelForState* state;
+    int64_t count;
+  } done_condition{state.get(), count};
+  absl::MutexLock lock(&state->mutex);
+  state->mutex.Await(absl::Condition(
+      +[](DoneCondition* arg) {
+        arg->state->mutex.AssertHeld();
+        return arg->state->Done(arg->count);
+      },
+      &done_condition));
+  return state->first_error;
+}
+
+}  // namespace xls
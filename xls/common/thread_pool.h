@@ -0,0 +1,113 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_COMMON_THREAD_POOL_H_
+#define XLS_COMMON_THREAD_POOL_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+#include "xls/common/thread.h"
+
+namespace xls {
+
+// A fixed-size pool of worker threads executing scheduled closures. The
+// shared foundation for parallelism in the compiler; subsystems should
+// schedule work here rather than spawning their own threads.
+//
+// Determinism note: closures run in an unspecified order on unspecified
+// threads. Code which must produce reproducible results independent of
+// scheduling should use ParallelForEach/ParallelMap below, which define
+// their result and error ordering by index rather than by completion time.
+class ThreadPool {
+ public:
+  // Creates a pool with the given number of worker threads (at least one).
+  explicit ThreadPool(int64_t thread_count);
+
+  // Blocks until all scheduled closures have completed, then joins the
+  // workers.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Schedules a closure for execution on some worker thread.
+  void Schedule(std::function<void()> fn);
+
+  int64_t thread_count() const { return threads_.size(); }
+
+  // Returns a process-wide pool sized to the hardware concurrency. Lives for
+  // the duration of the process.
+  static ThreadPool& Global();
+
+ private:
+  void WorkerLoop();
+
+  absl::Mutex mutex_;
+  std::deque<std::function<void()>> queue_ ABSL_GUARDED_BY(mutex_);
+  // Number of scheduled closures not yet completed (queued or running).
+  int64_t pending_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+  std::vector<std::unique_ptr<Thread>> threads_;
+};
+
+// Runs fn(i) for each i in [0, count) on the given pool (the calling thread
+// participates as well) and blocks until all iterations complete. Iterations
+// are claimed in contiguous chunks of 'chunk_size' to amortize
+// synchronization. If any iteration returns an error, the error of the
+// iteration with the *smallest index* is returned — deterministic regardless
+// of how iterations were scheduled — and remaining unclaimed iterations are
+// skipped.
+absl::Status ParallelForEach(int64_t count, int64_t chunk_size,
+                             ThreadPool* pool,
+                             const std::function<absl::Status(int64_t)>& fn);
+
+// As ParallelForEach but collects fn's results into a vector in index order,
+// so the output is identical to a sequential map regardless of scheduling.
+template <typename T>
+absl::StatusOr<std::vector<T>> ParallelMap(
+    int64_t count, int64_t chunk_size, ThreadPool* pool,
+    const std::function<absl::StatusOr<T>(int64_t)>& fn) {
+  std::vector<absl::optional<T>> results(count);
+  absl::Status status = ParallelForEach(
+      count, chunk_size, pool, [&](int64_t i) -> absl::Status {
+        absl::StatusOr<T> result = fn(i);
+        if (!result.ok()) {
+          return result.status();
+        }
+        results[i] = std::move(result).value();
+        return absl::OkStatus();
+      });
+  if (!status.ok()) {
+    return status;
+  }
+  std::vector<T> unwrapped;
+  unwrapped.reserve(count);
+  for (absl::optional<T>& result : results) {
+    unwrapped.push_back(std::move(*result));
+  }
+  return unwrapped;
+}
+
+}  // namespace xls
+
+#endif  // XLS_COMMON_THREAD_POOL_H_
@@ -0,0 +1,107 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/thread_pool.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "xls/common/status/matchers.h"
+
+namespace xls {
+namespace {
+
+using status_testing::StatusIs;
+using ::testing::HasSubstr;
+
+TEST(ThreadPoolTest, ScheduleRunsAllClosures) {
+  std::atomic<int64_t> counter(0);
+  {
+    ThreadPool pool(4);
+    for (int64_t i = 0; i < 100; ++i) {
+      pool.Schedule([&counter]() { ++counter; });
+    }
+    // The destructor drains the queue before joining.
+  }
+  EXPECT_EQ(counter.load(), 100);
+}
+
+TEST(ThreadPoolTest, ParallelForEachVisitsEveryIndexOnce) {
+  ThreadPool pool(4);
+  std::vector<std::atomic<int64_t>> visits(1000);
+  XLS_ASSERT_OK(ParallelForEach(1000, /*chunk_size=*/7, &pool,
+                                [&](int64_t i) -> absl::Status {
+                                  ++visits[i];
+                                  return absl::OkStatus();
+                                }));
+  for (int64_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(visits[i].load(), 1) << "index " << i;
+  }
+}
+
+TEST(ThreadPoolTest, ParallelForEachReturnsSmallestIndexError) {
+  ThreadPool pool(4);
+  // Indices 100 and 900 fail; the returned error must be index 100's
+  // regardless of which worker observed its failure first.
+  for (int64_t trial = 0; trial < 10; ++trial) {
+    absl::Status status = ParallelForEach(
+        1000, /*chunk_size=*/3, &pool, [&](int64_t i) -> absl::Status {
+          if (i == 100 || i == 900) {
+            return absl::InvalidArgumentError(absl::StrCat("index ", i));
+          }
+          return absl::OkStatus();
+        });
+    EXPECT_THAT(status, StatusIs(absl::StatusCode::kInvalidArgument,
+                                 HasSubstr("index 100")));
+  }
+}
+
+TEST(ThreadPoolTest, ParallelForEachEmptyRange) {
+  ThreadPool pool(2);
+  XLS_ASSERT_OK(ParallelForEach(
+      0, /*chunk_size=*/1, &pool,
+      [&](int64_t i) -> absl::Status { return absl::InternalError("never"); }));
+}
+
+TEST(ThreadPoolTest, ParallelMapPreservesIndexOrder) {
+  ThreadPool pool(4);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::string> results,
+      ParallelMap<std::string>(100, /*chunk_size=*/5, &pool,
+                               [](int64_t i) -> absl::StatusOr<std::string> {
+                                 return absl::StrCat("value_", i);
+                               }));
+  ASSERT_EQ(results.size(), 100);
+  for (int64_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(results[i], absl::StrCat("value_", i));
+  }
+}
+
+TEST(ThreadPoolTest, GlobalPoolIsUsable) {
+  std::atomic<int64_t> sum(0);
+  XLS_ASSERT_OK(ParallelForEach(100, /*chunk_size=*/10, &ThreadPool::Global(),
+                                [&](int64_t i) -> absl::Status {
+                                  sum += i;
+                                  return absl::OkStatus();
+                                }));
+  EXPECT_EQ(sum.load(), 99 * 100 / 2);
+}
+
+}  // namespace
+}  // namespace xls
@@ -132,7 +132,106 @@ BddNodeIndex BinaryDecisionDiagram::IfThenElse(BddNodeIndex cond,
 BddNodeIndex BinaryDecisionDiagram::NewVariable() {
   BddVariable var = next_var_;
   ++next_var_;
-  return GetOrCreateNode(var, one(), zero());
+  BddNodeIndex base_node = GetOrCreateNode(var, one(), zero());
+  variable_base_nodes_.push_back(base_node);
+  return base_node;
+}
+
+std::vector<BddNodeIndex> BinaryDecisionDiagram::GarbageCollect(
+    absl::Span<const BddNodeIndex> roots) {
+  // Mark phase: flood from the roots through the high/low edges. The leaf
+  // nodes and the base node of every variable are unconditionally live; base
+  // nodes are required to evaluate expressions over their variables.
+  std::vector<bool> live(nodes_.size(), false);
+  live[zero().value()] = true;
+  live[one().value()] = true;
+  std::vector<BddNodeIndex> worklist(roots.begin(), roots.end());
+  worklist.insert(worklist.end(), variable_base_nodes_.begin(),
+                  variable_base_nodes_.end());
+  while (!worklist.empty()) {
+    BddNodeIndex index = worklist.back();
+    worklist.pop_back();
+    if (live[index.value()]) {
+      continue;
+    }
+    live[index.value()] = true;
+    const BddNode& node = nodes_[index.value()];
+    worklist.push_back(node.high);
+    worklist.push_back(node.low);
+  }
+
+  // Compact phase: slide live nodes down in index order. This preserves the
+  // relative order of nodes so node indices remain topologically sorted
+  // (children have lower indices than their parents).
+  std::vector<BddNodeIndex> remap(nodes_.size(), BddNodeIndex(-1));
+  int64_t next_index = 0;
+  for (int64_t i = 0; i < static_cast<int64_t>(nodes_.size()); ++i) {
+    if (live[i]) {
+      remap[i] = BddNodeIndex(next_index++);
+    }
+  }
+  if (next_index == static_cast<int64_t>(nodes_.size())) {
+    // Nothing was collected.
+    return remap;
+  }
+  for (int64_t i = 2; i < static_cast<int64_t>(nodes_.size()); ++i) {
+    if (!live[i]) {
+      continue;
+    }
+    BddNode node = nodes_[i];
+    node.high = remap[node.high.value()];
+    node.low = remap[node.low.value()];
+    nodes_[remap[i].value()] = node;
+  }
+  nodes_.resize(next_index);
+
+  // Rebuild the unique table from the surviving nodes and remap the variable
+  // base nodes.
+  node_map_.clear();
+  for (int64_t i = 2; i < static_cast<int64_t>(nodes_.size()); ++i) {
+    const BddNode& node = nodes_[i];
+    node_map_[std::make_tuple(node.variable, node.high, node.low)] =
+        BddNodeIndex(i);
+  }
+  for (BddNodeIndex& base_node : variable_base_nodes_) {
+    base_node = remap[base_node.value()];
+  }
+
+  // Drop memoized if-then-else results which refer to collected nodes; they
+  // will simply be recomputed on demand. Surviving entries are remapped.
+  absl::flat_hash_map<IteKey, BddNodeIndex> old_ite_map = std::move(ite_map_);
+  ite_map_.clear();
+  for (const auto& [key, value] : old_ite_map) {
+    BddNodeIndex cond = remap[std::get<0>(key).value()];
+    BddNodeIndex if_true = remap[std::get<1>(key).value()];
+    BddNodeIndex if_false = remap[std::get<2>(key).value()];
+    BddNodeIndex result = remap[value.value()];
+    if (cond == BddNodeIndex(-1) || if_true == BddNodeIndex(-1) ||
+        if_false == BddNodeIndex(-1) || result == BddNodeIndex(-1)) {
+      continue;
+    }
+    ite_map_[std::make_tuple(cond, if_true, if_false)] = result;
+  }
+  return remap;
+}
+
+std::vector<BddNodeIndex> BinaryDecisionDiagram::ImportExpressions(
+    const BinaryDecisionDiagram& other, BddVariable variable_offset) {
+  XLS_CHECK_GE(variable_count(),
+               variable_offset.value() + other.variable_count());
+  std::vector<BddNodeIndex> translation(other.size());
+  translation[zero().value()] = zero();
+  translation[one().value()] = one();
+  // Node indices are topologically sorted (children precede their parents) so
+  // a single pass in index order suffices. Structure shared with existing
+  // expressions in this BDD is deduplicated by GetOrCreateNode.
+  for (int64_t i = 2; i < other.size(); ++i) {
+    const BddNode& node = other.nodes_[i];
+    translation[i] = GetOrCreateNode(
+        BddVariable(node.variable.value() + variable_offset.value()),
+        translation[node.high.value()], translation[node.low.value()]);
+  }
+  return translation;
 }
 
 BddNodeIndex BinaryDecisionDiagram::Not(BddNodeIndex expr) {
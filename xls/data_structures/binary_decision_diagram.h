@@ -16,9 +16,12 @@
 #define XLS_DATA_STRUCTURES_BINARY_DECISION_DIAGRAM_H_
 
 #include <cstdint>
+#include <string>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "xls/common/strong_int.h"
 
 namespace xls {
@@ -112,6 +115,26 @@ class BinaryDecisionDiagram {
     return GetNode(expr).high == one() && GetNode(expr).low == zero();
   }
 
+  // Reclaims the storage of all nodes which are not reachable from 'roots'.
+  // The leaf nodes and the base node of every variable are always retained.
+  // Node storage is compacted in place (mark-compact), so surviving nodes are
+  // renumbered: the returned vector maps each old node index to its new index,
+  // or to BddNodeIndex(-1) for collected nodes. Callers must remap any node
+  // indices they hold. Useful for discarding the dead intermediate nodes
+  // produced while building large expressions.
+  std::vector<BddNodeIndex> GarbageCollect(
+      absl::Span<const BddNodeIndex> roots);
+
+  // Imports every expression of 'other' into this BDD and returns the mapping
+  // from node index in 'other' to the corresponding node index in this BDD.
+  // Variable i of 'other' is mapped to variable 'variable_offset' + i of this
+  // BDD, all of which must already exist. The relative order of the mapped
+  // variables is preserved so the imported expressions remain canonical. Used
+  // to merge BDDs constructed independently (e.g. on worker threads) for
+  // expressions over disjoint sets of variables.
+  std::vector<BddNodeIndex> ImportExpressions(
+      const BinaryDecisionDiagram& other, BddVariable variable_offset);
+
  private:
   // Helper for constructing a DNF string respresentation.
   void ToStringDnfHelper(BddNodeIndex expr, int64_t* minterms_to_emit,
@@ -133,16 +156,21 @@ class BinaryDecisionDiagram {
 
   // Returns the node corresponding to the value of the given variable.
   BddNodeIndex GetVariableBaseNode(BddVariable variable) const {
-    return node_map_.at({variable, one(), zero()});
+    return variable_base_nodes_.at(variable.value());
   }
 
   // The numeric id to use for the next created variable. Increments with each
   // call to NewVariable which
   BddVariable next_var_ = BddVariable(0);
 
-  // The vector of all the nodes in the BDD.
+  // The vector of all the nodes in the BDD. Serves as the arena backing node
+  // storage; GarbageCollect compacts it in place.
   std::vector<BddNode> nodes_;
 
+  // The base node of each variable, indexed by variable number. Base nodes are
+  // always kept live by GarbageCollect so variables can be evaluated.
+  std::vector<BddNodeIndex> variable_base_nodes_;
+
   // A map from BDD node content (variable id, high child, low child) to the
   // index of the respective node. This map is used to ensure that no duplicate
   // nodes are created.
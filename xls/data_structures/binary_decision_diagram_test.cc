@@ -251,6 +251,107 @@ TEST(BinaryDecisionDiagramTest, Parity) {
               IsOkAndHolds(false));
 }
 
+TEST(BinaryDecisionDiagramTest, GarbageCollect) {
+  BinaryDecisionDiagram bdd;
+  BddNodeIndex var1 = bdd.NewVariable();
+  BddNodeIndex var2 = bdd.NewVariable();
+  BddNodeIndex var3 = bdd.NewVariable();
+
+  BddNodeIndex keep = bdd.Or(bdd.And(var1, var2), var3);
+  // Build some expressions which will not be rooted.
+  BddNodeIndex dead = bdd.And(bdd.Not(var1), bdd.Not(var2));
+  bdd.Or(dead, bdd.And(var2, var3));
+
+  int64_t size_before = bdd.size();
+  std::vector<BddNodeIndex> remap = bdd.GarbageCollect({keep});
+  EXPECT_LT(bdd.size(), size_before);
+
+  // The rooted expression and the variable base nodes survive; indices must be
+  // translated through the returned mapping.
+  keep = remap.at(keep.value());
+  var1 = remap.at(var1.value());
+  var2 = remap.at(var2.value());
+  var3 = remap.at(var3.value());
+  ASSERT_NE(keep, BddNodeIndex(-1));
+  ASSERT_NE(var1, BddNodeIndex(-1));
+  ASSERT_NE(var2, BddNodeIndex(-1));
+  ASSERT_NE(var3, BddNodeIndex(-1));
+  EXPECT_TRUE(bdd.IsVariableBaseNode(var1));
+
+  for (bool v1 : {false, true}) {
+    for (bool v2 : {false, true}) {
+      for (bool v3 : {false, true}) {
+        EXPECT_THAT(
+            bdd.Evaluate(keep, {{var1, v1}, {var2, v2}, {var3, v3}}),
+            IsOkAndHolds((v1 && v2) || v3));
+      }
+    }
+  }
+
+  // Reconstructing the rooted expression must not create new nodes.
+  int64_t size_after_gc = bdd.size();
+  EXPECT_EQ(bdd.Or(bdd.And(var1, var2), var3), keep);
+  EXPECT_EQ(bdd.size(), size_after_gc);
+
+  // Collecting with every node as a root is the identity mapping.
+  std::vector<BddNodeIndex> all_nodes;
+  for (int64_t i = 0; i < bdd.size(); ++i) {
+    all_nodes.push_back(BddNodeIndex(i));
+  }
+  std::vector<BddNodeIndex> identity = bdd.GarbageCollect(all_nodes);
+  for (int64_t i = 0; i < bdd.size(); ++i) {
+    EXPECT_EQ(identity[i], BddNodeIndex(i));
+  }
+}
+
+TEST(BinaryDecisionDiagramTest, ImportExpressions) {
+  // Build expressions over disjoint variable sets in two separate BDDs and
+  // merge them into one.
+  BinaryDecisionDiagram bdd_a;
+  BddNodeIndex a1 = bdd_a.NewVariable();
+  BddNodeIndex a2 = bdd_a.NewVariable();
+  BddNodeIndex expr_a = bdd_a.Or(bdd_a.And(a1, a2), bdd_a.Not(a1));
+
+  BinaryDecisionDiagram bdd_b;
+  BddNodeIndex b1 = bdd_b.NewVariable();
+  BddNodeIndex b2 = bdd_b.NewVariable();
+  BddNodeIndex b3 = bdd_b.NewVariable();
+  BddNodeIndex expr_b = bdd_b.And(bdd_b.Or(b1, b2), b3);
+
+  BinaryDecisionDiagram merged;
+  std::vector<BddNodeIndex> vars;
+  for (int64_t i = 0; i < 5; ++i) {
+    vars.push_back(merged.NewVariable());
+  }
+  std::vector<BddNodeIndex> translation_a =
+      merged.ImportExpressions(bdd_a, BddVariable(0));
+  std::vector<BddNodeIndex> translation_b =
+      merged.ImportExpressions(bdd_b, BddVariable(2));
+  BddNodeIndex merged_a = translation_a.at(expr_a.value());
+  BddNodeIndex merged_b = translation_b.at(expr_b.value());
+
+  for (int64_t assignment = 0; assignment < 32; ++assignment) {
+    absl::flat_hash_map<BddNodeIndex, bool> values;
+    for (int64_t i = 0; i < 5; ++i) {
+      values[vars[i]] = (assignment >> i) & 1;
+    }
+    bool v1 = (assignment >> 0) & 1;
+    bool v2 = (assignment >> 1) & 1;
+    bool v3 = (assignment >> 2) & 1;
+    bool v4 = (assignment >> 3) & 1;
+    bool v5 = (assignment >> 4) & 1;
+    EXPECT_THAT(merged.Evaluate(merged_a, values),
+                IsOkAndHolds((v1 && v2) || !v1));
+    EXPECT_THAT(merged.Evaluate(merged_b, values),
+                IsOkAndHolds((v3 || v4) && v5));
+  }
+
+  // Imported structure is deduplicated against existing nodes: building the
+  // translated expression directly yields the identical node.
+  EXPECT_EQ(merged.Or(merged.And(vars[0], vars[1]), merged.Not(vars[0])),
+            merged_a);
+}
+
 TEST(BinaryDecisionDiagramTest, ThreeVariableExhaustive) {
   // Generate all three-variable boolean functions and test each with all
   // possible inputs.
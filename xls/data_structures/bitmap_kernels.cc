@@ -0,0 +1,184 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/data_structures/bitmap_kernels.h"
+
+#include "xls/common/logging/logging.h"
+
+#if defined(__x86_64__) && (defined(__clang__) || defined(__GNUC__))
+#define XLS_BITMAP_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace xls {
+namespace bitmap_kernels {
+namespace {
+
+// Signature of a two-input bulk word kernel.
+using BinaryKernel = void (*)(const uint64_t*, const uint64_t*, uint64_t*,
+                              int64_t);
+using UnaryKernel = void (*)(const uint64_t*, uint64_t*, int64_t);
+
+// Scalar fallbacks. The trip-count-known loops below are simple enough that
+// compilers auto-vectorize them for the target baseline (SSE2 on x86-64, NEON
+// on aarch64); the explicit AVX variants exist to exploit wider registers
+// than the baseline permits.
+#define XLS_DEFINE_SCALAR_BINARY_KERNEL(NAME, EXPR)                       \
+  void NAME(const uint64_t* lhs, const uint64_t* rhs, uint64_t* out,      \
+            int64_t count) {                                              \
+    for (int64_t i = 0; i < count; ++i) {                                 \
+      out[i] = (EXPR);                                                    \
+    }                                                                     \
+  }
+XLS_DEFINE_SCALAR_BINARY_KERNEL(AndScalar, lhs[i] & rhs[i])
+XLS_DEFINE_SCALAR_BINARY_KERNEL(OrScalar, lhs[i] | rhs[i])
+XLS_DEFINE_SCALAR_BINARY_KERNEL(XorScalar, lhs[i] ^ rhs[i])
+#undef XLS_DEFINE_SCALAR_BINARY_KERNEL
+
+void NotScalar(const uint64_t* input, uint64_t* out, int64_t count) {
+  for (int64_t i = 0; i < count; ++i) {
+    out[i] = ~input[i];
+  }
+}
+
+#ifdef XLS_BITMAP_KERNELS_X86
+
+// AVX2: four words per vector, unaligned loads/stores as InlineBitmap storage
+// has no alignment guarantee beyond that of uint64_t.
+#define XLS_DEFINE_AVX2_BINARY_KERNEL(NAME, INTRINSIC, SCALAR_EXPR)        \
+  __attribute__((target("avx2"))) void NAME(                               \
+      const uint64_t* lhs, const uint64_t* rhs, uint64_t* out,             \
+      int64_t count) {                                                     \
+    int64_t i = 0;                                                         \
+    for (; i + 4 <= count; i += 4) {                                       \
+      __m256i a = _mm256_loadu_si256(                                      \
+          reinterpret_cast<const __m256i*>(lhs + i));                      \
+      __m256i b = _mm256_loadu_si256(                                      \
+          reinterpret_cast<const __m256i*>(rhs + i));                      \
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),             \
+                          INTRINSIC(a, b));                                \
+    }                                                                      \
+    for (; i < count; ++i) {                                               \
+      out[i] = (SCALAR_EXPR);                                              \
+    }                                                                      \
+  }
+XLS_DEFINE_AVX2_BINARY_KERNEL(AndAvx2, _mm256_and_si256, lhs[i] & rhs[i])
+XLS_DEFINE_AVX2_BINARY_KERNEL(OrAvx2, _mm256_or_si256, lhs[i] | rhs[i])
+XLS_DEFINE_AVX2_BINARY_KERNEL(XorAvx2, _mm256_xor_si256, lhs[i] ^ rhs[i])
+#undef XLS_DEFINE_AVX2_BINARY_KERNEL
+
+__attribute__((target("avx2"))) void NotAvx2(const uint64_t* input,
+                                             uint64_t* out, int64_t count) {
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  int64_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i a =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                        _mm256_xor_si256(a, ones));
+  }
+  for (; i < count; ++i) {
+    out[i] = ~input[i];
+  }
+}
+
+// AVX-512F: eight words per vector.
+#define XLS_DEFINE_AVX512_BINARY_KERNEL(NAME, INTRINSIC, SCALAR_EXPR)      \
+  __attribute__((target("avx512f"))) void NAME(                            \
+      const uint64_t* lhs, const uint64_t* rhs, uint64_t* out,             \
+      int64_t count) {                                                     \
+    int64_t i = 0;                                                         \
+    for (; i + 8 <= count; i += 8) {                                       \
+      __m512i a = _mm512_loadu_si512(lhs + i);                             \
+      __m512i b = _mm512_loadu_si512(rhs + i);                             \
+      _mm512_storeu_si512(out + i, INTRINSIC(a, b));                       \
+    }                                                                      \
+    for (; i < count; ++i) {                                               \
+      out[i] = (SCALAR_EXPR);                                              \
+    }                                                                      \
+  }
+XLS_DEFINE_AVX512_BINARY_KERNEL(AndAvx512, _mm512_and_si512, lhs[i] & rhs[i])
+XLS_DEFINE_AVX512_BINARY_KERNEL(OrAvx512, _mm512_or_si512, lhs[i] | rhs[i])
+XLS_DEFINE_AVX512_BINARY_KERNEL(XorAvx512, _mm512_xor_si512, lhs[i] ^ rhs[i])
+#undef XLS_DEFINE_AVX512_BINARY_KERNEL
+
+__attribute__((target("avx512f"))) void NotAvx512(const uint64_t* input,
+                                                  uint64_t* out,
+                                                  int64_t count) {
+  const __m512i ones = _mm512_set1_epi64(-1);
+  int64_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m512i a = _mm512_loadu_si512(input + i);
+    _mm512_storeu_si512(out + i, _mm512_xor_si512(a, ones));
+  }
+  for (; i < count; ++i) {
+    out[i] = ~input[i];
+  }
+}
+
+#endif  // XLS_BITMAP_KERNELS_X86
+
+// Kernels resolved once at first use based on runtime CPU detection.
+struct Kernels {
+  BinaryKernel and_kernel;
+  BinaryKernel or_kernel;
+  BinaryKernel xor_kernel;
+  UnaryKernel not_kernel;
+};
+
+const Kernels& GetKernels() {
+  static const Kernels kernels = [] {
+#ifdef XLS_BITMAP_KERNELS_X86
+    if (__builtin_cpu_supports("avx512f")) {
+      return Kernels{AndAvx512, OrAvx512, XorAvx512, NotAvx512};
+    }
+    if (__builtin_cpu_supports("avx2")) {
+      return Kernels{AndAvx2, OrAvx2, XorAvx2, NotAvx2};
+    }
+#endif
+    return Kernels{AndScalar, OrScalar, XorScalar, NotScalar};
+  }();
+  return kernels;
+}
+
+}  // namespace
+
+void AndWords(absl::Span<const uint64_t> lhs, absl::Span<const uint64_t> rhs,
+              absl::Span<uint64_t> out) {
+  XLS_DCHECK_EQ(lhs.size(), rhs.size());
+  XLS_DCHECK_EQ(lhs.size(), out.size());
+  GetKernels().and_kernel(lhs.data(), rhs.data(), out.data(), lhs.size());
+}
+
+void OrWords(absl::Span<const uint64_t> lhs, absl::Span<const uint64_t> rhs,
+             absl::Span<uint64_t> out) {
+  XLS_DCHECK_EQ(lhs.size(), rhs.size());
+  XLS_DCHECK_EQ(lhs.size(), out.size());
+  GetKernels().or_kernel(lhs.data(), rhs.data(), out.data(), lhs.size());
+}
+
+void XorWords(absl::Span<const uint64_t> lhs, absl::Span<const uint64_t> rhs,
+              absl::Span<uint64_t> out) {
+  XLS_DCHECK_EQ(lhs.size(), rhs.size());
+  XLS_DCHECK_EQ(lhs.size(), out.size());
+  GetKernels().xor_kernel(lhs.data(), rhs.data(), out.data(), lhs.size());
+}
+
+void NotWords(absl::Span<const uint64_t> input, absl::Span<uint64_t> out) {
+  XLS_DCHECK_EQ(input.size(), out.size());
+  GetKernels().not_kernel(input.data(), out.data(), input.size());
+}
+
+}  // namespace bitmap_kernels
+}  // namespace xls
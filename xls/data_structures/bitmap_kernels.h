@@ -0,0 +1,42 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DATA_STRUCTURES_BITMAP_KERNELS_H_
+#define XLS_DATA_STRUCTURES_BITMAP_KERNELS_H_
+
+#include <cstdint>
+
+#include "absl/types/span.h"
+
+namespace xls {
+namespace bitmap_kernels {
+
+// Bulk word-level kernels backing InlineBitmap and the wide-Bits paths of
+// bits_ops. On x86-64 explicitly vectorized (AVX2 / AVX-512) implementations
+// are selected at runtime via CPU detection; elsewhere a scalar loop is used
+// which compilers auto-vectorize (e.g. to NEON). All spans must have the same
+// length; 'out' may alias either input.
+
+void AndWords(absl::Span<const uint64_t> lhs, absl::Span<const uint64_t> rhs,
+              absl::Span<uint64_t> out);
+void OrWords(absl::Span<const uint64_t> lhs, absl::Span<const uint64_t> rhs,
+             absl::Span<uint64_t> out);
+void XorWords(absl::Span<const uint64_t> lhs, absl::Span<const uint64_t> rhs,
+              absl::Span<uint64_t> out);
+void NotWords(absl::Span<const uint64_t> input, absl::Span<uint64_t> out);
+
+}  // namespace bitmap_kernels
+}  // namespace xls
+
+#endif  // XLS_DATA_STRUCTURES_BITMAP_KERNELS_H_
@@ -15,13 +15,17 @@
 #ifndef XLS_DATA_STRUCTURES_INLINE_BITMAP_H_
 #define XLS_DATA_STRUCTURES_INLINE_BITMAP_H_
 
+#include <algorithm>
 #include <cstdint>
+#include <utility>
 
 #include "absl/base/casts.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/types/span.h"
 #include "xls/common/bits_util.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/math_util.h"
+#include "xls/data_structures/bitmap_kernels.h"
 
 namespace xls {
 
@@ -42,6 +46,25 @@ class InlineBitmap {
     XLS_DCHECK_GE(bit_count, 0);
   }
 
+  // The type of the backing store of the bitmap.
+  using Storage = absl::InlinedVector<uint64_t, 1>;
+
+  // Constructs a zeroed bitmap of 'bit_count' bits which adopts the given
+  // storage (resized as necessary) as its backing store. Used by
+  // ScratchBitmapPool to recycle the backing stores of transient bitmaps.
+  InlineBitmap(int64_t bit_count, Storage&& storage)
+      : bit_count_(bit_count), data_(std::move(storage)) {
+    XLS_DCHECK_GE(bit_count, 0);
+    data_.resize(CeilOfRatio(bit_count, kWordBits));
+    std::fill(data_.begin(), data_.end(), 0);
+  }
+
+  // Moves the backing store out of the bitmap, leaving it empty.
+  Storage TakeStorage() && {
+    bit_count_ = 0;
+    return std::move(data_);
+  }
+
   bool operator==(const InlineBitmap& other) const {
     if (bit_count_ != other.bit_count_) {
       return false;
@@ -106,6 +129,13 @@ class InlineBitmap {
     return data_[wordno];
   }
 
+  // Sets the wordno'th backing word. Any bits in 'value' beyond bit_count()
+  // are masked off.
+  void SetWord(int64_t wordno, uint64_t value) {
+    XLS_DCHECK_LT(wordno, word_count());
+    data_[wordno] = value & MaskForWord(wordno);
+  }
+
   // Sets a byte in the data underlying the bitmap.
   //
   // Setting byte i as {b_7, b_6, b_5, ..., b_0} sets the bit at i*8 to b_0, the
@@ -133,6 +163,46 @@ class InlineBitmap {
 
   int64_t byte_count() const { return CeilOfRatio(bit_count_, int64_t{8}); }
 
+  // The backing words of the bitmap. Bits beyond bit_count() in the last word
+  // are kept zero.
+  absl::Span<const uint64_t> words() const {
+    return absl::MakeConstSpan(data_.data(), data_.size());
+  }
+
+  // Mutable access to the backing words for bulk writers (e.g. the
+  // destination-passing operations in bits_ops). Callers must keep the bits
+  // beyond bit_count() in the last word zero; use SetWord() when writing a
+  // word that may spill past bit_count().
+  absl::Span<uint64_t> mutable_words() {
+    return absl::MakeSpan(data_.data(), data_.size());
+  }
+
+  // In-place bulk bitwise operations with 'other', which must have the same
+  // bit count. Backed by the runtime-dispatched vectorized kernels in
+  // bitmap_kernels.h; these are the fast path for wide bit vectors.
+  void And(const InlineBitmap& other) {
+    XLS_DCHECK_EQ(bit_count_, other.bit_count_);
+    bitmap_kernels::AndWords(other.words(), words(),
+                             absl::MakeSpan(data_.data(), data_.size()));
+  }
+  void Or(const InlineBitmap& other) {
+    XLS_DCHECK_EQ(bit_count_, other.bit_count_);
+    bitmap_kernels::OrWords(other.words(), words(),
+                            absl::MakeSpan(data_.data(), data_.size()));
+  }
+  void Xor(const InlineBitmap& other) {
+    XLS_DCHECK_EQ(bit_count_, other.bit_count_);
+    bitmap_kernels::XorWords(other.words(), words(),
+                             absl::MakeSpan(data_.data(), data_.size()));
+  }
+  void Not() {
+    bitmap_kernels::NotWords(words(),
+                             absl::MakeSpan(data_.data(), data_.size()));
+    if (word_count() > 0) {
+      MaskLastWord();
+    }
+  }
+
   template <typename H>
   friend H AbslHashValue(H h, const InlineBitmap& ib) {
     return H::combine(std::move(h), ib.bit_count_, ib.data_);
@@ -156,7 +226,7 @@ class InlineBitmap {
   }
 
   int64_t bit_count_;
-  absl::InlinedVector<uint64_t, 1> data_;
+  Storage data_;
 };
 
 }  // namespace xls
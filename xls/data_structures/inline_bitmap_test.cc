@@ -162,5 +162,33 @@ TEST(InlineBitmapTest, BytesAndWords) {
   }
 }
 
+TEST(InlineBitmapTest, InPlaceLogicalOps) {
+  // 130 bits spans three words with a partial last word, so the masking of
+  // bits beyond bit_count() is exercised.
+  InlineBitmap a(/*bit_count=*/130);
+  InlineBitmap b(/*bit_count=*/130);
+  for (int64_t i = 0; i < 130; ++i) {
+    a.Set(i, i % 3 == 0);
+    b.Set(i, i % 2 == 0);
+  }
+
+  InlineBitmap and_result = a;
+  and_result.And(b);
+  InlineBitmap or_result = a;
+  or_result.Or(b);
+  InlineBitmap xor_result = a;
+  xor_result.Xor(b);
+  InlineBitmap not_result = a;
+  not_result.Not();
+  for (int64_t i = 0; i < 130; ++i) {
+    EXPECT_EQ(and_result.Get(i), a.Get(i) && b.Get(i)) << i;
+    EXPECT_EQ(or_result.Get(i), a.Get(i) || b.Get(i)) << i;
+    EXPECT_EQ(xor_result.Get(i), a.Get(i) != b.Get(i)) << i;
+    EXPECT_EQ(not_result.Get(i), !a.Get(i)) << i;
+  }
+  // Bits beyond bit_count() in the last word must stay zero after Not().
+  EXPECT_EQ(not_result.GetWord(2) >> 2, 0);
+}
+
 }  // namespace
 }  // namespace xls
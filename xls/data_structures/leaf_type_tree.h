@@ -15,6 +15,8 @@
 #ifndef XLS_DATA_STRUCTURES_LEAF_TYPE_TREE_H_
 #define XLS_DATA_STRUCTURES_LEAF_TYPE_TREE_H_
 
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "absl/types/span.h"
@@ -23,6 +25,86 @@
 
 namespace xls {
 
+// Describes the shape of a potentially-recursive XLS type as seen by
+// LeafTypeTree: the flat sequence of leaf (bits or token) types, plus offset
+// tables for translating a type index path into an element offset. The
+// descriptor depends only on the type, so one instance can be shared by every
+// tree of that type; Package::GetLeafTypeShape returns a per-package cached
+// descriptor. Sharing the descriptor rather than rebuilding it per tree
+// roughly halves the memory of analyses which keep one tree per node.
+class LeafTypeShape {
+ public:
+  explicit LeafTypeShape(Type* type) : type_(type) {
+    leaf_types_.reserve(type->leaf_count());
+    BuildNodes(type, /*leaf_offset=*/0);
+  }
+
+  Type* type() const { return type_; }
+
+  // Returns the number of leaves in the type.
+  int64_t leaf_count() const { return leaf_types_.size(); }
+
+  // Returns the types of each leaf, in element order.
+  absl::Span<Type* const> leaf_types() const { return leaf_types_; }
+
+  // Returns a pair containing the subtype and element offset for the given
+  // type index. Runs in O(|index|) using the precomputed offset tables.
+  std::pair<Type*, int64_t> GetSubtypeAndOffset(
+      absl::Span<int64_t const> index) const {
+    int64_t node_index = 0;
+    for (int64_t i : index) {
+      const ShapeNode& node = nodes_[node_index];
+      XLS_CHECK_LT(i, node.child_count);
+      node_index = child_nodes_[node.children_start + i];
+    }
+    return {nodes_[node_index].type, nodes_[node_index].leaf_offset};
+  }
+
+ private:
+  // A subtype reachable by a type index path through the type.
+  struct ShapeNode {
+    Type* type;
+    // Offset of the first leaf of this subtree within the flat element order.
+    int64_t leaf_offset;
+    // Index within child_nodes_ of this node's first child.
+    int64_t children_start;
+    int64_t child_count;
+  };
+
+  static bool IsLeafType(Type* t) { return t->IsBits() || t->IsToken(); }
+
+  // Recursively builds the node and child-index tables for the subtree rooted
+  // at "t" whose leaves start at "leaf_offset". Returns the node's index.
+  int64_t BuildNodes(Type* t, int64_t leaf_offset) {
+    int64_t node_index = nodes_.size();
+    nodes_.push_back(
+        ShapeNode{t, leaf_offset, /*children_start=*/-1, /*child_count=*/0});
+    if (IsLeafType(t)) {
+      leaf_types_.push_back(t);
+      return node_index;
+    }
+    int64_t child_count = t->IsArray() ? t->AsArrayOrDie()->size()
+                                       : t->AsTupleOrDie()->size();
+    int64_t children_start = child_nodes_.size();
+    nodes_[node_index].children_start = children_start;
+    nodes_[node_index].child_count = child_count;
+    child_nodes_.resize(children_start + child_count);
+    for (int64_t i = 0; i < child_count; ++i) {
+      Type* child_type = t->IsArray()
+                             ? t->AsArrayOrDie()->element_type()
+                             : t->AsTupleOrDie()->element_type(i);
+      child_nodes_[children_start + i] = BuildNodes(child_type, leaf_offset);
+      leaf_offset += child_type->leaf_count();
+    }
+    return node_index;
+  }
+
+  Type* type_;
+  std::vector<Type*> leaf_types_;
+  std::vector<ShapeNode> nodes_;
+  std::vector<int64_t> child_nodes_;
+};
+
 // A container which stores values of an arbitrary type T, one value for each
 // leaf element (Bits value) of a potentially-recursive XLS type. Values are
 // stored in a flat vector which provides fast iteration, but indexing through
@@ -53,22 +135,35 @@ namespace xls {
 template <typename T>
 class LeafTypeTree {
  public:
-  LeafTypeTree() : type_(nullptr) {}
+  LeafTypeTree() = default;
   LeafTypeTree(const LeafTypeTree<T>& other) = default;
   LeafTypeTree& operator=(const LeafTypeTree<T>& other) = default;
 
   explicit LeafTypeTree(Type* type)
-      : type_(type), elements_(type->leaf_count()) {
-    MakeLeafTypes(type);
-  }
+      : owned_shape_(std::make_shared<LeafTypeShape>(type)),
+        shape_(owned_shape_.get()),
+        elements_(shape_->leaf_count()) {}
   LeafTypeTree(Type* type, const T& init_value)
-      : type_(type), elements_(type->leaf_count(), init_value) {
-    MakeLeafTypes(type);
+      : owned_shape_(std::make_shared<LeafTypeShape>(type)),
+        shape_(owned_shape_.get()),
+        elements_(shape_->leaf_count(), init_value) {}
+
+  // Constructors which share an externally owned shape descriptor rather than
+  // building one per tree. "shape" must outlive this object (and its copies);
+  // typically it is owned by the package (Package::GetLeafTypeShape).
+  explicit LeafTypeTree(const LeafTypeShape* shape)
+      : shape_(shape), elements_(shape->leaf_count()) {}
+  LeafTypeTree(const LeafTypeShape* shape, const T& init_value)
+      : shape_(shape), elements_(shape->leaf_count(), init_value) {}
+  LeafTypeTree(const LeafTypeShape* shape, absl::Span<const T> elements)
+      : shape_(shape), elements_(elements.begin(), elements.end()) {
+    XLS_CHECK_EQ(shape->leaf_count(), elements_.size());
   }
 
   // Constructor for tuples/arrays where members are provided as a span.
   LeafTypeTree(Type* type, absl::Span<LeafTypeTree<T> const> init_values)
-      : type_(type) {
+      : owned_shape_(std::make_shared<LeafTypeShape>(type)),
+        shape_(owned_shape_.get()) {
     // Validate types of given values.
     if (type->IsArray()) {
       XLS_CHECK_EQ(type->AsArrayOrDie()->size(), init_values.size());
@@ -85,7 +180,7 @@ class LeafTypeTree {
       XLS_LOG(FATAL) << "Invalid constructor for bits types";
     }
 
-    MakeLeafTypes(type);
+    elements_.reserve(shape_->leaf_count());
     for (int64_t i = 0; i < init_values.size(); ++i) {
       for (int64_t j = 0; j < init_values[i].size(); ++j) {
         const T& leaf = init_values[i].elements()[j];
@@ -95,11 +190,14 @@ class LeafTypeTree {
   }
 
   LeafTypeTree(Type* type, absl::Span<const T> elements)
-      : type_(type), elements_(elements.begin(), elements.end()) {
-    MakeLeafTypes(type_);
-  }
+      : owned_shape_(std::make_shared<LeafTypeShape>(type)),
+        shape_(owned_shape_.get()),
+        elements_(elements.begin(), elements.end()) {}
 
-  Type* type() const { return type_; }
+  Type* type() const { return shape_ == nullptr ? nullptr : shape_->type(); }
+
+  // Returns the shape descriptor describing this object's XLS type.
+  const LeafTypeShape* shape() const { return shape_; }
 
   // Returns the number of values in the container (equivalently number of
   // leaves of the type).
@@ -109,8 +207,7 @@ class LeafTypeTree {
   // recursive traversal through the object's XLS type. The Type index must
   // correspond to a leaf Bits-type element in the object's XLS type.
   T& Get(absl::Span<int64_t const> index) {
-    std::pair<Type*, int64_t> type_offset =
-        GetSubtypeAndOffset(type_, index, /*offset=*/0);
+    std::pair<Type*, int64_t> type_offset = shape_->GetSubtypeAndOffset(index);
     // The index must refer to a leaf node (bits or token type).
     XLS_CHECK(IsLeafType(type_offset.first));
     return elements_[type_offset.second];
@@ -121,8 +218,7 @@ class LeafTypeTree {
 
   // Sets the element at the given Type index to the given value.
   void Set(absl::Span<int64_t const> index, const T& value) {
-    std::pair<Type*, int64_t> type_offset =
-        GetSubtypeAndOffset(type_, index, /*offset=*/0);
+    std::pair<Type*, int64_t> type_offset = shape_->GetSubtypeAndOffset(index);
     // The index must refer to a leaf node (bits or token type).
     XLS_CHECK(IsLeafType(type_offset.first));
     elements_[type_offset.second] = value;
@@ -136,13 +232,15 @@ class LeafTypeTree {
 
   // Returns the types of each leaf in the XLS type of this object. The order of
   // these types corresponds to the order of elements().
-  absl::Span<Type* const> leaf_types() const { return leaf_types_; }
+  absl::Span<Type* const> leaf_types() const {
+    return shape_ == nullptr ? absl::Span<Type* const>()
+                             : shape_->leaf_types();
+  }
 
   // Copies and returns the subtree rooted at the given type index as a
   // LeafTypeTree.
   LeafTypeTree<T> CopySubtree(absl::Span<int64_t const> const index) const {
-    std::pair<Type*, int64_t> type_offset =
-        GetSubtypeAndOffset(type_, index, /*offset=*/0);
+    std::pair<Type*, int64_t> type_offset = shape_->GetSubtypeAndOffset(index);
     Type* subtype = type_offset.first;
     LeafTypeTree subtree(subtype);
     for (int64_t i = 0; i < subtype->leaf_count(); ++i) {
@@ -172,13 +270,10 @@ class LeafTypeTree {
 
   friend bool operator==(const LeafTypeTree<T>& lhs,
                          const LeafTypeTree<T>& rhs) {
-    if (!lhs.type_->IsEqualTo(rhs.type_)) {
+    if (!lhs.type()->IsEqualTo(rhs.type())) {
       return false;
     }
-    XLS_CHECK_EQ(lhs.leaf_types_.size(), rhs.leaf_types_.size());
-    for (int64_t i = 0; i < lhs.leaf_types_.size(); ++i) {
-      XLS_CHECK(lhs.leaf_types_[i]->IsEqualTo(rhs.leaf_types_[i]));
-    }
+    XLS_CHECK_EQ(lhs.size(), rhs.size());
     return lhs.elements_ == rhs.elements_;
   }
 
@@ -190,54 +285,13 @@ class LeafTypeTree {
  private:
   static bool IsLeafType(Type* t) { return t->IsBits() || t->IsToken(); }
 
-  // Creates the vector of leaf types.
-  void MakeLeafTypes(Type* t) {
-    if (IsLeafType(t)) {
-      leaf_types_.push_back(t);
-      return;
-    }
-    if (t->IsArray()) {
-      for (int64_t i = 0; i < t->AsArrayOrDie()->size(); ++i) {
-        MakeLeafTypes(t->AsArrayOrDie()->element_type());
-      }
-      return;
-    }
-    XLS_CHECK(t->IsTuple());
-    for (int64_t i = 0; i < t->AsTupleOrDie()->size(); ++i) {
-      MakeLeafTypes(t->AsTupleOrDie()->element_type(i));
-    }
-  }
-
-  // Returns a pair containing the Type and element offset for the given type
-  // index.
-  std::pair<Type*, int64_t> GetSubtypeAndOffset(Type* t,
-                                                absl::Span<int64_t const> index,
-                                                int64_t offset) const {
-    if (index.empty()) {
-      return {t, offset};
-    }
-    if (t->IsArray()) {
-      XLS_CHECK(!index.empty());
-      XLS_CHECK_LT(index[0], t->AsArrayOrDie()->size());
-      Type* element_type = t->AsArrayOrDie()->element_type();
-      return GetSubtypeAndOffset(
-          element_type, index.subspan(1),
-          offset + index[0] * element_type->leaf_count());
-    }
-    XLS_CHECK(t->IsTuple());
-    TupleType* tuple_type = t->AsTupleOrDie();
-    XLS_CHECK_LT(index[0], tuple_type->size());
-    int64_t element_offset = 0;
-    for (int64_t i = 0; i < index[0]; ++i) {
-      element_offset += tuple_type->element_type(i)->leaf_count();
-    }
-    return GetSubtypeAndOffset(tuple_type->element_type(index[0]),
-                               index.subspan(1), offset + element_offset);
-  }
-
-  Type* type_;
+  // Set only when this tree built its own shape descriptor (the Type*
+  // constructors); shared among copies. Trees built from an external
+  // descriptor (e.g. Package::GetLeafTypeShape) leave this null and store
+  // only the element array plus a borrowed pointer.
+  std::shared_ptr<const LeafTypeShape> owned_shape_;
+  const LeafTypeShape* shape_ = nullptr;
   std::vector<T> elements_;
-  std::vector<Type*> leaf_types_;
 };
 
 }  // namespace xls
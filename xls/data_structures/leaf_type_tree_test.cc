@@ -193,6 +193,33 @@ TEST_F(LeafTypeTreeTest, EmptyTuple) {
   EXPECT_TRUE(tree.leaf_types().empty());
 }
 
+TEST_F(LeafTypeTreeTest, SharedShapeDescriptor) {
+  Package package("SharedShapeDescriptor");
+  Type* type =
+      Parser::ParseType("((bits[2], bits[4])[3], bits[8])", &package).value();
+
+  // The package caches one descriptor per distinct type.
+  const LeafTypeShape* shape = package.GetLeafTypeShape(type);
+  EXPECT_EQ(package.GetLeafTypeShape(type), shape);
+  EXPECT_EQ(shape->type(), type);
+  EXPECT_EQ(shape->leaf_count(), 7);
+
+  // Trees sharing the descriptor must index identically to trees which build
+  // their own.
+  LeafTypeTree<int64_t> shared_tree(shape, 0);
+  LeafTypeTree<int64_t> owned_tree(type, 0);
+  EXPECT_EQ(shared_tree.type(), type);
+  EXPECT_EQ(shared_tree.shape(), shape);
+  shared_tree.Set({0, 1, 0}, 42);
+  owned_tree.Set({0, 1, 0}, 42);
+  shared_tree.Set({1}, 7);
+  owned_tree.Set({1}, 7);
+  EXPECT_EQ(shared_tree.Get({0, 1, 0}), 42);
+  EXPECT_EQ(shared_tree.Get({1}), 7);
+  EXPECT_EQ(shared_tree.elements(), owned_tree.elements());
+  EXPECT_EQ(shared_tree, owned_tree);
+}
+
 TEST_F(LeafTypeTreeTest, Token) {
   LeafTypeTree<int64_t> tree(AsType("token"));
   EXPECT_EQ(tree.size(), 1);
@@ -14,16 +14,20 @@
 
 #include "xls/data_structures/min_cut.h"
 
+#include <algorithm>
 #include <deque>
 #include <set>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/numeric/int128.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/types/optional.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/logging/vlog_is_on.h"
+#include "xls/data_structures/graph_contraction.h"
 
 namespace xls {
 namespace min_cut {
@@ -267,20 +271,85 @@ int64_t AugmentFlow(const Graph& graph, NodeId source, NodeId sink,
   return 0;
 }
 
-}  // namespace
+// Maximizes flow in the residual graph using the FIFO push-relabel method.
+// Unlike the augmenting path method the run time is independent of the
+// number of augmenting paths (worst case O(V^3)) which makes it much faster
+// on dense graphs with large edge weights.
+void MaximizeFlowPushRelabel(const Graph& graph, NodeId source, NodeId sink,
+                             ResidualGraph* residual_graph) {
+  const int64_t node_count = graph.node_count();
+  std::vector<int64_t> height(node_count, 0);
+  // Excesses are sums of up to E edge capacities each of which may be as
+  // large as INT64_MAX (scheduling uses maximum-weight edges as uncuttable
+  // sentinels) so they are accumulated in 128 bits.
+  std::vector<absl::int128> excess(node_count, 0);
+  height[int64_t{source}] = node_count;
+
+  std::deque<NodeId> active;
+  auto add_excess = [&](NodeId node, int64_t amount) {
+    excess[int64_t{node}] += amount;
+    if (excess[int64_t{node}] == amount && node != source && node != sink) {
+      active.push_back(node);
+    }
+  };
+
+  // Saturate all edges out of the source.
+  for (EdgeId edge_id : residual_graph->successors(source)) {
+    ResidualEdge& edge = residual_graph->edge(edge_id);
+    if (edge.capacity > 0 && edge.to != source) {
+      int64_t amount = edge.capacity;
+      residual_graph->PushFlow(amount, &edge);
+      add_excess(edge.to, amount);
+    }
+  }
 
-GraphCut MinCutBetweenNodes(const Graph& graph, NodeId source, NodeId sink) {
-  // This loop is the core of the Ford-Fulkerson method. Starting with zero flow
-  // on all edges, flow is increased along a path from source to sink with
-  // residual capacity (called an augmenting path). When no further augmenting
-  // paths exist, flow has been maximized. 'flow' is the flow of each edge in
-  // the graph indexed by EdgeId.
-  ResidualGraph residual_graph(graph);
-  while (AugmentFlow(graph, source, sink, &residual_graph) > 0) {
+  while (!active.empty()) {
+    NodeId node = active.front();
+    active.pop_front();
+    // Discharge 'node': push excess along admissible edges (positive residual
+    // capacity and height exactly one greater than the target's) and relabel
+    // when no admissible edge remains.
+    while (excess[int64_t{node}] > 0) {
+      int64_t min_successor_height = std::numeric_limits<int64_t>::max();
+      for (EdgeId edge_id : residual_graph->successors(node)) {
+        ResidualEdge& edge = residual_graph->edge(edge_id);
+        if (edge.capacity <= 0) {
+          continue;
+        }
+        if (height[int64_t{node}] == height[int64_t{edge.to}] + 1) {
+          int64_t amount = static_cast<int64_t>(std::min(
+              excess[int64_t{node}], absl::int128(edge.capacity)));
+          residual_graph->PushFlow(amount, &edge);
+          excess[int64_t{node}] -= amount;
+          add_excess(edge.to, amount);
+          if (excess[int64_t{node}] == 0) {
+            break;
+          }
+        } else {
+          min_successor_height =
+              std::min(min_successor_height, height[int64_t{edge.to}]);
+        }
+      }
+      if (excess[int64_t{node}] == 0) {
+        break;
+      }
+      if (min_successor_height == std::numeric_limits<int64_t>::max()) {
+        // No residual edge out of the node at all; the remaining excess is
+        // trapped. This cannot happen because every push creates a reverse
+        // residual edge back toward the source.
+        XLS_LOG(FATAL) << "Node with excess has no residual successors: "
+                       << graph.name(node);
+      }
+      height[int64_t{node}] = min_successor_height + 1;
+    }
   }
+}
 
-  // Once a maximum flow is found, walk the residual graph from the source. All
-  // reachable nodes form one partition.
+// Walks the residual graph of a maximum flow from the source and forms the
+// cut partitions from the set of reachable nodes.
+GraphCut ComputeCutFromResidualGraph(const Graph& graph, NodeId source,
+                                     NodeId sink,
+                                     const ResidualGraph& residual_graph) {
   absl::flat_hash_set<NodeId> reachable_from_source;
   std::deque<NodeId> frontier = {source};
   reachable_from_source.insert(source);
@@ -319,5 +388,280 @@ GraphCut MinCutBetweenNodes(const Graph& graph, NodeId source, NodeId sink) {
   return min_cut;
 }
 
+}  // namespace
+
+GraphCut MinCutBetweenNodes(const Graph& graph, NodeId source, NodeId sink) {
+  // This loop is the core of the Ford-Fulkerson method. Starting with zero flow
+  // on all edges, flow is increased along a path from source to sink with
+  // residual capacity (called an augmenting path). When no further augmenting
+  // paths exist, flow has been maximized. 'flow' is the flow of each edge in
+  // the graph indexed by EdgeId.
+  ResidualGraph residual_graph(graph);
+  while (AugmentFlow(graph, source, sink, &residual_graph) > 0) {
+  }
+
+  // Once a maximum flow is found, walk the residual graph from the source. All
+  // reachable nodes form one partition.
+  return ComputeCutFromResidualGraph(graph, source, sink, residual_graph);
+}
+
+GraphCut MinCutBetweenNodesPushRelabel(const Graph& graph, NodeId source,
+                                       NodeId sink) {
+  ResidualGraph residual_graph(graph);
+  MaximizeFlowPushRelabel(graph, source, sink, &residual_graph);
+  return ComputeCutFromResidualGraph(graph, source, sink, residual_graph);
+}
+
+namespace {
+
+// Adds edge weights, saturating at INT64_MAX. Contracted parallel edges may
+// each carry the maximum weight (used as an uncuttable sentinel).
+int64_t SaturatingAddWeights(int64_t a, int64_t b) {
+  if (a > std::numeric_limits<int64_t>::max() - b) {
+    return std::numeric_limits<int64_t>::max();
+  }
+  return a + b;
+}
+
+// Builds a GraphCut for 'graph' from the given source-side node set,
+// computing the weight by summing the crossing edges.
+GraphCut CutFromSourceSet(const Graph& graph,
+                          const absl::flat_hash_set<NodeId>& source_set) {
+  GraphCut cut;
+  cut.weight = 0;
+  for (NodeId node_id = NodeId(0); node_id <= graph.max_node_id(); ++node_id) {
+    if (source_set.contains(node_id)) {
+      cut.source_partition.push_back(node_id);
+    } else {
+      cut.sink_partition.push_back(node_id);
+    }
+    for (EdgeId edge_id : graph.successors(node_id)) {
+      const Edge& edge = graph.edge(edge_id);
+      if (source_set.contains(edge.from) && !source_set.contains(edge.to)) {
+        cut.weight = SaturatingAddWeights(cut.weight, edge.weight);
+      }
+    }
+  }
+  return cut;
+}
+
+// Refines a source-side node set by rerunning exact max-flow on a reduced
+// graph in which only nodes within 'radius' undirected hops of the cut
+// boundary are free to switch sides; all other nodes are merged into a
+// source or sink super-node. Returns the refined source-side set.
+absl::flat_hash_set<NodeId> RefineCutBoundary(
+    const Graph& graph, NodeId source, NodeId sink,
+    const absl::flat_hash_set<NodeId>& source_set, int64_t radius) {
+  // Collect the nodes within 'radius' hops of any edge crossing the
+  // partition (in either direction) via BFS over the undirected graph.
+  std::vector<std::vector<NodeId>> neighbors(graph.node_count());
+  for (EdgeId edge_id = EdgeId(0); edge_id <= graph.max_edge_id();
+       edge_id += EdgeId(1)) {
+    const Edge& edge = graph.edge(edge_id);
+    neighbors[int64_t{edge.from}].push_back(edge.to);
+    neighbors[int64_t{edge.to}].push_back(edge.from);
+  }
+  absl::flat_hash_map<NodeId, int64_t> distance;
+  std::deque<NodeId> frontier;
+  for (EdgeId edge_id = EdgeId(0); edge_id <= graph.max_edge_id();
+       edge_id += EdgeId(1)) {
+    const Edge& edge = graph.edge(edge_id);
+    if (source_set.contains(edge.from) != source_set.contains(edge.to)) {
+      for (NodeId node : {edge.from, edge.to}) {
+        if (!distance.contains(node)) {
+          distance[node] = 0;
+          frontier.push_back(node);
+        }
+      }
+    }
+  }
+  while (!frontier.empty()) {
+    NodeId node = frontier.front();
+    frontier.pop_front();
+    if (distance.at(node) == radius) {
+      continue;
+    }
+    for (NodeId neighbor : neighbors[int64_t{node}]) {
+      if (!distance.contains(neighbor)) {
+        distance[neighbor] = distance.at(node) + 1;
+        frontier.push_back(neighbor);
+      }
+    }
+  }
+  // The source and sink themselves must stay merged into their super-nodes.
+  distance.erase(source);
+  distance.erase(sink);
+
+  // Build the reduced graph: one super-node per side plus the free nodes.
+  Graph reduced;
+  NodeId reduced_source = reduced.AddNode("source");
+  NodeId reduced_sink = reduced.AddNode("sink");
+  absl::flat_hash_map<NodeId, NodeId> reduced_id;
+  auto reduced_node = [&](NodeId node) {
+    if (distance.contains(node)) {
+      auto it = reduced_id.find(node);
+      if (it == reduced_id.end()) {
+        it = reduced_id.insert({node, reduced.AddNode(graph.name(node))})
+                 .first;
+      }
+      return it->second;
+    }
+    return source_set.contains(node) ? reduced_source : reduced_sink;
+  };
+  for (EdgeId edge_id = EdgeId(0); edge_id <= graph.max_edge_id();
+       edge_id += EdgeId(1)) {
+    const Edge& edge = graph.edge(edge_id);
+    NodeId from = reduced_node(edge.from);
+    NodeId to = reduced_node(edge.to);
+    if (from != to) {
+      reduced.AddEdge(from, to, edge.weight);
+    }
+  }
+
+  GraphCut reduced_cut =
+      MinCutBetweenNodesPushRelabel(reduced, reduced_source, reduced_sink);
+  absl::flat_hash_set<NodeId> reduced_source_partition(
+      reduced_cut.source_partition.begin(),
+      reduced_cut.source_partition.end());
+  absl::flat_hash_set<NodeId> refined;
+  for (NodeId node_id = NodeId(0); node_id <= graph.max_node_id(); ++node_id) {
+    if (distance.contains(node_id)) {
+      if (reduced_source_partition.contains(reduced_id.at(node_id))) {
+        refined.insert(node_id);
+      }
+    } else if (source_set.contains(node_id)) {
+      refined.insert(node_id);
+    }
+  }
+  return refined;
+}
+
+}  // namespace
+
+GraphCut MinCutBetweenNodesMultilevel(const Graph& graph, NodeId source,
+                                      NodeId sink,
+                                      const MultilevelMinCutOptions& options) {
+  if (graph.node_count() <= options.coarse_node_limit) {
+    return MinCutBetweenNodesPushRelabel(graph, source, sink);
+  }
+
+  // Coarsening: contract the graph down to the node limit with rounds of
+  // heavy-edge matching. Contracting an edge assumes its endpoints end up on
+  // the same side of the cut, so heavier (less likely to be cut) edges are
+  // contracted first. Vertex weights count the contracted group sizes; edge
+  // weights of parallel edges accumulate.
+  GraphContraction<NodeId, int64_t, int64_t> contraction;
+  for (NodeId node_id = NodeId(0); node_id <= graph.max_node_id(); ++node_id) {
+    contraction.AddVertex(node_id, 1);
+  }
+  for (EdgeId edge_id = EdgeId(0); edge_id <= graph.max_edge_id();
+       edge_id += EdgeId(1)) {
+    const Edge& edge = graph.edge(edge_id);
+    absl::optional<int64_t> existing =
+        contraction.WeightOf(edge.from, edge.to);
+    contraction.AddEdge(
+        edge.from, edge.to,
+        existing.has_value() ? SaturatingAddWeights(*existing, edge.weight)
+                             : edge.weight);
+  }
+  auto vertex_merge = [](int64_t a, int64_t b) { return a + b; };
+  int64_t vertex_count = graph.node_count();
+  while (vertex_count > options.coarse_node_limit) {
+    // One round of matching: each vertex is merged with at most one other.
+    std::vector<NodeId> order(contraction.Vertices().begin(),
+                              contraction.Vertices().end());
+    std::sort(order.begin(), order.end());
+    absl::flat_hash_set<NodeId> matched;
+    int64_t merges = 0;
+    for (NodeId vertex : order) {
+      if (vertex_count - merges <= options.coarse_node_limit) {
+        break;
+      }
+      if (matched.contains(vertex)) {
+        continue;
+      }
+      NodeId source_rep = *contraction.RepresentativeOf(source);
+      NodeId sink_rep = *contraction.RepresentativeOf(sink);
+      // Pick the heaviest incident edge to an unmatched neighbor. Never
+      // merge the source group with the sink group.
+      absl::optional<NodeId> best;
+      int64_t best_weight = 0;
+      auto consider = [&](NodeId neighbor, int64_t weight) {
+        if (neighbor == vertex || matched.contains(neighbor)) {
+          return;
+        }
+        if ((vertex == source_rep && neighbor == sink_rep) ||
+            (vertex == sink_rep && neighbor == source_rep)) {
+          return;
+        }
+        if (!best.has_value() || weight > best_weight) {
+          best = neighbor;
+          best_weight = weight;
+        }
+      };
+      for (const auto& [neighbor, weight] : contraction.EdgesOutOf(vertex)) {
+        consider(neighbor, weight);
+      }
+      for (const auto& [neighbor, weight] : contraction.EdgesInto(vertex)) {
+        consider(neighbor, weight);
+      }
+      if (best.has_value()) {
+        XLS_CHECK(contraction.IdentifyVertices(vertex, *best, vertex_merge,
+                                               SaturatingAddWeights));
+        matched.insert(vertex);
+        matched.insert(*best);
+        ++merges;
+      }
+    }
+    if (merges == 0) {
+      break;
+    }
+    vertex_count -= merges;
+  }
+
+  // Build the coarse graph and solve it exactly.
+  Graph coarse;
+  absl::flat_hash_map<NodeId, NodeId> coarse_id;
+  std::vector<NodeId> representatives(contraction.Vertices().begin(),
+                                      contraction.Vertices().end());
+  std::sort(representatives.begin(), representatives.end());
+  for (NodeId rep : representatives) {
+    coarse_id[rep] = coarse.AddNode(graph.name(rep));
+  }
+  for (NodeId rep : representatives) {
+    for (const auto& [target, weight] : contraction.EdgesOutOf(rep)) {
+      if (target != rep) {
+        coarse.AddEdge(coarse_id.at(rep), coarse_id.at(target), weight);
+      }
+    }
+  }
+  GraphCut coarse_cut = MinCutBetweenNodesPushRelabel(
+      coarse, coarse_id.at(*contraction.RepresentativeOf(source)),
+      coarse_id.at(*contraction.RepresentativeOf(sink)));
+
+  // Project the coarse cut back onto the original graph: every node lands on
+  // the side of its representative. The projected weight equals the coarse
+  // cut weight since contracted groups stay whole.
+  absl::flat_hash_set<NodeId> coarse_source_partition(
+      coarse_cut.source_partition.begin(), coarse_cut.source_partition.end());
+  absl::flat_hash_set<NodeId> source_set;
+  for (NodeId node_id = NodeId(0); node_id <= graph.max_node_id(); ++node_id) {
+    if (coarse_source_partition.contains(
+            coarse_id.at(*contraction.RepresentativeOf(node_id)))) {
+      source_set.insert(node_id);
+    }
+  }
+
+  // Uncoarsening: locally re-optimize around the projected cut boundary.
+  if (options.refinement_radius > 0) {
+    source_set = RefineCutBoundary(graph, source, sink, source_set,
+                                   options.refinement_radius);
+  }
+
+  GraphCut cut = CutFromSourceSet(graph, source_set);
+  XLS_VLOG_LINES(4, cut.ToString(graph));
+  return cut;
+}
+
 }  // namespace min_cut
 }  // namespace xls
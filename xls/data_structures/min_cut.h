@@ -101,6 +101,38 @@ struct GraphCut {
 // a worst case run time of O(V^2 * E).
 GraphCut MinCutBetweenNodes(const Graph& graph, NodeId source, NodeId sink);
 
+// As MinCutBetweenNodes but maximizes flow with the FIFO push-relabel method
+// rather than augmenting paths. Produces a (possibly different) cut of the
+// same minimum weight. Push-relabel has a worst case run time of O(V^2 * E)
+// independent of the number of augmenting paths and is typically much faster
+// on dense graphs with large edge weights.
+GraphCut MinCutBetweenNodesPushRelabel(const Graph& graph, NodeId source,
+                                       NodeId sink);
+
+// Options for the multilevel min-cut scheme.
+struct MultilevelMinCutOptions {
+  // Coarsening stops once the contracted graph has at most this many nodes;
+  // exact max-flow runs on the contracted graph.
+  int64_t coarse_node_limit = 512;
+
+  // During refinement, nodes within this many (undirected) hops of the
+  // projected cut boundary are freed while all other nodes stay merged into
+  // two super-nodes; exact max-flow then runs on this reduced graph.
+  int64_t refinement_radius = 2;
+};
+
+// Computes a cut of the given graph using a multilevel scheme: the graph is
+// coarsened via heavy-edge matching (see graph_contraction.h) down to
+// 'coarse_node_limit' nodes, an exact min cut of the coarse graph is
+// computed with push-relabel, and the projected cut is refined with an exact
+// max-flow restricted to the neighborhood of the cut boundary. The result is
+// always a valid source/sink-separating cut but may be slightly heavier than
+// the true minimum; in exchange max-flow never runs on the full graph. For
+// graphs no larger than 'coarse_node_limit' this is exact.
+GraphCut MinCutBetweenNodesMultilevel(
+    const Graph& graph, NodeId source, NodeId sink,
+    const MultilevelMinCutOptions& options = MultilevelMinCutOptions());
+
 }  // namespace min_cut
 }  // namespace xls
 
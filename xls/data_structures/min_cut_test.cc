@@ -276,6 +276,113 @@ TEST(MinCutTest, LargeDirectedGraphs) {
   }
 }
 
+TEST(MinCutTest, PushRelabelComplexGraph) {
+  // Same graph as ComplexGraph, solved with push-relabel.
+  Graph graph;
+  auto a = graph.AddNode("a");
+  auto b = graph.AddNode("b");
+  auto c = graph.AddNode("c");
+  auto d = graph.AddNode("d");
+  auto e = graph.AddNode("e");
+  auto f = graph.AddNode("f");
+  auto g = graph.AddNode("g");
+  graph.AddEdge(a, b, 100);
+  graph.AddEdge(a, c, 16);
+  graph.AddEdge(b, d, 42);
+  graph.AddEdge(c, d, 8);
+  graph.AddEdge(c, e, 123);
+  graph.AddEdge(d, g, 33);
+  graph.AddEdge(d, f, 6);
+  graph.AddEdge(e, f, 4);
+  graph.AddEdge(f, g, 12);
+  GraphCut min_cut = MinCutBetweenNodesPushRelabel(graph, a, g);
+  EXPECT_EQ(min_cut.weight, 43);
+  EXPECT_THAT(min_cut.source_partition, UnorderedElementsAre(a, b, c, d, e));
+  EXPECT_THAT(min_cut.sink_partition, UnorderedElementsAre(f, g));
+}
+
+TEST(MinCutTest, PushRelabelMatchesAugmentingPath) {
+  // Push-relabel must find a cut of exactly the same weight as the
+  // augmenting path method on random graphs, including graphs with
+  // maximum-weight sentinel edges adjacent to source and sink.
+  for (bool acyclic : {false, true}) {
+    for (int64_t layer_count = 5; layer_count < 16; layer_count += 2) {
+      for (int64_t nodes_in_layer = 5; nodes_in_layer < 16;
+           nodes_in_layer += 2) {
+        NodeId source;
+        NodeId sink;
+        Graph graph = MakeLargeGraph(acyclic, &source, &sink, layer_count,
+                                     nodes_in_layer);
+        GraphCut expected = MinCutBetweenNodes(graph, source, sink);
+        GraphCut actual = MinCutBetweenNodesPushRelabel(graph, source, sink);
+        EXPECT_EQ(actual.weight, expected.weight);
+        EXPECT_EQ(actual.source_partition.size() +
+                      actual.sink_partition.size(),
+                  graph.node_count());
+        absl::flat_hash_set<NodeId> source_set(actual.source_partition.begin(),
+                                               actual.source_partition.end());
+        absl::flat_hash_set<NodeId> sink_set(actual.sink_partition.begin(),
+                                             actual.sink_partition.end());
+        EXPECT_TRUE(source_set.contains(source));
+        EXPECT_TRUE(sink_set.contains(sink));
+        EXPECT_EQ(actual.weight, CutCost(graph, source_set, sink_set));
+      }
+    }
+  }
+}
+
+TEST(MinCutTest, MultilevelExactBelowCoarseLimit) {
+  // At or below the coarse node limit the multilevel scheme delegates to
+  // exact push-relabel.
+  Graph graph;
+  auto a = graph.AddNode("a");
+  auto b = graph.AddNode("b");
+  auto c = graph.AddNode("c");
+  auto d = graph.AddNode("d");
+  graph.AddEdge(a, b, 10);
+  graph.AddEdge(a, c, 2);
+  graph.AddEdge(b, d, 3);
+  graph.AddEdge(c, d, 10);
+  GraphCut min_cut = MinCutBetweenNodesMultilevel(graph, a, d);
+  EXPECT_EQ(min_cut.weight, 5);
+  EXPECT_THAT(min_cut.source_partition, UnorderedElementsAre(a, b, c));
+  EXPECT_THAT(min_cut.sink_partition, UnorderedElementsAre(d));
+}
+
+TEST(MinCutTest, MultilevelOnLargeGraphs) {
+  // Force coarsening with a small coarse node limit. The multilevel result
+  // must always be a valid source/sink-separating cut; its weight is at
+  // least the exact minimum.
+  MultilevelMinCutOptions options;
+  options.coarse_node_limit = 16;
+  for (bool acyclic : {false, true}) {
+    for (int64_t layer_count = 5; layer_count < 16; layer_count += 4) {
+      for (int64_t nodes_in_layer = 5; nodes_in_layer < 16;
+           nodes_in_layer += 4) {
+        NodeId source;
+        NodeId sink;
+        Graph graph = MakeLargeGraph(acyclic, &source, &sink, layer_count,
+                                     nodes_in_layer);
+        GraphCut exact = MinCutBetweenNodes(graph, source, sink);
+        GraphCut multilevel =
+            MinCutBetweenNodesMultilevel(graph, source, sink, options);
+        EXPECT_EQ(multilevel.source_partition.size() +
+                      multilevel.sink_partition.size(),
+                  graph.node_count());
+        absl::flat_hash_set<NodeId> source_set(
+            multilevel.source_partition.begin(),
+            multilevel.source_partition.end());
+        absl::flat_hash_set<NodeId> sink_set(multilevel.sink_partition.begin(),
+                                             multilevel.sink_partition.end());
+        EXPECT_TRUE(source_set.contains(source));
+        EXPECT_TRUE(sink_set.contains(sink));
+        EXPECT_EQ(multilevel.weight, CutCost(graph, source_set, sink_set));
+        EXPECT_GE(multilevel.weight, exact.weight);
+      }
+    }
+  }
+}
+
 TEST(MinCutTest, MaxFlowToMinCutTraversalTest) {
   // Test a fix for b/155115565 where the residual graph was not properly
   // traversed to identify the partitions after max flow was computed.
@@ -0,0 +1,76 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/data_structures/scratch_bitmap_pool.h"
+
+#include <utility>
+
+#include "xls/common/math_util.h"
+
+namespace xls {
+
+/* static */ ScratchBitmapPool& ScratchBitmapPool::ThreadLocal() {
+  // Heap-allocated so the pool is never destroyed; avoids
+  // destruction-order issues with thread-local Bits values.
+  thread_local ScratchBitmapPool* pool = new ScratchBitmapPool;
+  return *pool;
+}
+
+/* static */ int64_t ScratchBitmapPool::SizeClass(int64_t word_count) {
+  int64_t size_class = 0;
+  while ((int64_t{1} << size_class) < word_count) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+InlineBitmap ScratchBitmapPool::Acquire(int64_t bit_count) {
+  int64_t word_count = CeilOfRatio<int64_t>(bit_count, 64);
+  if (word_count > 0) {
+    int64_t size_class = SizeClass(word_count);
+    if (size_class < kNumSizeClasses && !classes_[size_class].empty()) {
+      InlineBitmap::Storage storage = std::move(classes_[size_class].back());
+      classes_[size_class].pop_back();
+      return InlineBitmap(bit_count, std::move(storage));
+    }
+  }
+  return InlineBitmap(bit_count);
+}
+
+void ScratchBitmapPool::Release(InlineBitmap&& bitmap) {
+  InlineBitmap::Storage storage = std::move(bitmap).TakeStorage();
+  if (storage.empty()) {
+    return;
+  }
+  int64_t size_class = SizeClass(storage.size());
+  if (size_class >= kNumSizeClasses ||
+      static_cast<int64_t>(classes_[size_class].size()) >=
+          kMaxBuffersPerClass) {
+    return;
+  }
+  // Round the buffer up to the class size so a class hit always provides
+  // sufficient capacity.
+  storage.resize(int64_t{1} << size_class, 0);
+  classes_[size_class].push_back(std::move(storage));
+}
+
+int64_t ScratchBitmapPool::cached_buffer_count() const {
+  int64_t total = 0;
+  for (const std::vector<InlineBitmap::Storage>& size_class : classes_) {
+    total += size_class.size();
+  }
+  return total;
+}
+
+}  // namespace xls
@@ -0,0 +1,68 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DATA_STRUCTURES_SCRATCH_BITMAP_POOL_H_
+#define XLS_DATA_STRUCTURES_SCRATCH_BITMAP_POOL_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "xls/data_structures/inline_bitmap.h"
+
+namespace xls {
+
+// A thread-local pool of InlineBitmap backing stores with size-classed
+// reuse. Bitmaps which are built and discarded in tight loops (BitsRope
+// construction, value flattening, interpreter evaluation) draw their storage
+// from the pool instead of allocating a fresh backing store per use.
+//
+// Backing stores are pooled in power-of-two word-count size classes; class c
+// holds buffers of exactly 2^c words. Acquire() pops a buffer from the
+// smallest sufficient class if one is cached. Release() rounds a buffer up
+// to its class size and caches it; oversized buffers and full classes are
+// simply dropped. Storage which escapes the pool (e.g. moved into a built
+// Bits) is never returned, and the pool replenishes lazily on later
+// releases.
+class ScratchBitmapPool {
+ public:
+  // Returns the pool of the current thread.
+  static ScratchBitmapPool& ThreadLocal();
+
+  // Returns a zeroed bitmap of the given bit count, drawing the backing
+  // store from the pool when a sufficiently large one is cached.
+  InlineBitmap Acquire(int64_t bit_count);
+
+  // Returns the given bitmap's backing store to the pool. The bitmap must
+  // not be used afterwards.
+  void Release(InlineBitmap&& bitmap);
+
+  // The total number of cached backing stores. Exposed for tests.
+  int64_t cached_buffer_count() const;
+
+ private:
+  // Buffers of more than 2^(kNumSizeClasses-1) words (4 MiB) are not pooled;
+  // each class holds at most kMaxBuffersPerClass buffers. Memory retained
+  // per thread is thereby bounded.
+  static constexpr int64_t kNumSizeClasses = 20;
+  static constexpr int64_t kMaxBuffersPerClass = 8;
+
+  // Returns the smallest c such that 2^c >= word_count.
+  static int64_t SizeClass(int64_t word_count);
+
+  std::vector<InlineBitmap::Storage> classes_[kNumSizeClasses];
+};
+
+}  // namespace xls
+
+#endif  // XLS_DATA_STRUCTURES_SCRATCH_BITMAP_POOL_H_
@@ -0,0 +1,74 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/data_structures/scratch_bitmap_pool.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/data_structures/inline_bitmap.h"
+
+namespace xls {
+namespace {
+
+TEST(ScratchBitmapPoolTest, ReleaseThenAcquireReusesStorage) {
+  ScratchBitmapPool pool;
+  EXPECT_EQ(pool.cached_buffer_count(), 0);
+
+  // A multi-word bitmap so the backing store is heap-allocated.
+  pool.Release(InlineBitmap(1000));
+  EXPECT_EQ(pool.cached_buffer_count(), 1);
+
+  // A smaller bit count from the same size class draws from the pool.
+  InlineBitmap bitmap = pool.Acquire(700);
+  EXPECT_EQ(pool.cached_buffer_count(), 0);
+  EXPECT_EQ(bitmap.bit_count(), 700);
+  EXPECT_TRUE(bitmap.IsAllZeroes());
+}
+
+TEST(ScratchBitmapPoolTest, AcquiredBitmapsAreZeroed) {
+  ScratchBitmapPool pool;
+  InlineBitmap dirty(256);
+  dirty.Set(0, true);
+  dirty.Set(255, true);
+  pool.Release(std::move(dirty));
+
+  InlineBitmap bitmap = pool.Acquire(256);
+  EXPECT_TRUE(bitmap.IsAllZeroes());
+}
+
+TEST(ScratchBitmapPoolTest, MissAllocatesFresh) {
+  ScratchBitmapPool pool;
+  InlineBitmap bitmap = pool.Acquire(128);
+  EXPECT_EQ(bitmap.bit_count(), 128);
+  EXPECT_TRUE(bitmap.IsAllZeroes());
+  EXPECT_EQ(pool.cached_buffer_count(), 0);
+}
+
+TEST(ScratchBitmapPoolTest, ClassSizeIsBounded) {
+  ScratchBitmapPool pool;
+  // Release more buffers of one size class than the pool retains.
+  for (int64_t i = 0; i < 100; ++i) {
+    pool.Release(InlineBitmap(1024));
+  }
+  EXPECT_LT(pool.cached_buffer_count(), 100);
+}
+
+TEST(ScratchBitmapPoolTest, ThreadLocalSingleton) {
+  ScratchBitmapPool& a = ScratchBitmapPool::ThreadLocal();
+  ScratchBitmapPool& b = ScratchBitmapPool::ThreadLocal();
+  EXPECT_EQ(&a, &b);
+}
+
+}  // namespace
+}  // namespace xls
@@ -14,31 +14,78 @@
 
 #include "xls/delay_model/analyze_critical_path.h"
 
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/delay_model/delay_estimator.h"
 #include "xls/ir/function.h"
 #include "xls/ir/node_iterator.h"
 #include "xls/ir/proc.h"
 
 namespace xls {
+namespace {
 
-absl::StatusOr<std::vector<CriticalPathEntry>> AnalyzeCriticalPath(
-    FunctionBase* f, absl::optional<int64_t> clock_period_ps,
+// The delay to the output of a node along with whether the node was pushed
+// out by a cycle boundary.
+using OutputDelayMap = absl::flat_hash_map<Node*, std::pair<int64_t, bool>>;
+
+// Computes the delay to the output of each node in the transitive cone of
+// `sinks`. Nodes outside the cone are not visited (and do not appear in the
+// returned map). Within each topological level nodes are independent of each
+// other so large levels are computed in parallel; `delay_estimator` must
+// therefore be safe for concurrent queries, which holds for the stateless
+// delay models and for CachingDelayEstimator.
+absl::StatusOr<OutputDelayMap> ComputeOutputDelays(
+    FunctionBase* f, absl::Span<Node* const> sinks,
+    absl::optional<int64_t> clock_period_ps,
     const DelayEstimator& delay_estimator) {
-  absl::flat_hash_map<Node*, std::pair<int64_t, bool>> node_to_output_delay;
+  // Gather the transitive cone of the sinks.
+  absl::flat_hash_set<Node*> cone;
+  std::vector<Node*> worklist(sinks.begin(), sinks.end());
+  while (!worklist.empty()) {
+    Node* node = worklist.back();
+    worklist.pop_back();
+    if (cone.insert(node).second) {
+      for (Node* operand : node->operands()) {
+        worklist.push_back(operand);
+      }
+    }
+  }
 
-  auto get_max_operands_delay = [&](Node* node) {
-    int64_t earliest = 0;
+  // Group the cone by topological level; a node's level is one more than the
+  // maximum level of its operands.
+  absl::flat_hash_map<Node*, int64_t> level_of;
+  std::vector<std::vector<Node*>> levels;
+  OutputDelayMap node_to_output_delay;
+  for (Node* node : TopoSort(f)) {
+    if (!cone.contains(node)) {
+      continue;
+    }
+    int64_t level = 0;
     for (Node* operand : node->operands()) {
-      earliest = std::max(earliest, node_to_output_delay[operand].first);
+      level = std::max(level, level_of.at(operand) + 1);
     }
-    return earliest;
-  };
+    level_of[node] = level;
+    if (level >= levels.size()) {
+      levels.resize(level + 1);
+    }
+    levels[level].push_back(node);
+    // Insert the slot up front so the parallel passes below only write to
+    // existing map entries and never mutate the map structure.
+    node_to_output_delay[node] = {0, false};
+  }
 
-  for (Node* node : TopoSort(f)) {
-    int64_t earliest = get_max_operands_delay(node);
+  auto process_node = [&](Node* node) -> absl::Status {
+    int64_t earliest = 0;
+    for (Node* operand : node->operands()) {
+      earliest = std::max(earliest, node_to_output_delay.at(operand).first);
+    }
     XLS_ASSIGN_OR_RETURN(int64_t node_effort,
                          delay_estimator.GetOperationDelayInPs(node));
     bool bumped = false;
@@ -53,21 +100,66 @@ absl::StatusOr<std::vector<CriticalPathEntry>> AnalyzeCriticalPath(
       earliest = new_earliest;
       bumped = true;
     }
-    node_to_output_delay[node] = {earliest + node_effort, bumped};
+    node_to_output_delay.at(node) = {earliest + node_effort, bumped};
+    return absl::OkStatus();
+  };
+
+  // Only spread a level across threads when it has enough nodes to amortize
+  // thread startup.
+  constexpr int64_t kMinNodesPerThread = 256;
+  const int64_t max_threads = std::max<int64_t>(
+      1, static_cast<int64_t>(std::thread::hardware_concurrency()));
+  for (const std::vector<Node*>& level : levels) {
+    int64_t num_chunks = std::min<int64_t>(
+        max_threads, level.size() / kMinNodesPerThread);
+    if (num_chunks <= 1) {
+      for (Node* node : level) {
+        XLS_RETURN_IF_ERROR(process_node(node));
+      }
+      continue;
+    }
+    std::vector<absl::Status> chunk_statuses(num_chunks);
+    auto run_chunk = [&](int64_t chunk) {
+      for (int64_t i = chunk; i < level.size(); i += num_chunks) {
+        chunk_statuses[chunk] = process_node(level[i]);
+        if (!chunk_statuses[chunk].ok()) {
+          return;
+        }
+      }
+    };
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int64_t chunk = 1; chunk < num_chunks; ++chunk) {
+      threads.push_back(
+          std::make_unique<Thread>([&run_chunk, chunk]() { run_chunk(chunk); }));
+    }
+    run_chunk(0);
+    for (auto& thread : threads) {
+      thread->Join();
+    }
+    for (const absl::Status& status : chunk_statuses) {
+      XLS_RETURN_IF_ERROR(status);
+    }
   }
+  return node_to_output_delay;
+}
 
+// Walks the worst-arrival chain of operands backwards from `sink` and returns
+// the decorated path, sink first.
+absl::StatusOr<std::vector<CriticalPathEntry>> TraceCriticalPath(
+    Node* sink, const OutputDelayMap& node_to_output_delay,
+    const DelayEstimator& delay_estimator) {
   std::vector<CriticalPathEntry> critical_path;
-
-  Node* n = f->IsFunction() ? f->AsFunctionOrDie()->return_value()
-                            : f->AsProcOrDie()->NextState();
+  Node* n = sink;
   while (true) {
+    XLS_ASSIGN_OR_RETURN(int64_t node_delay,
+                         delay_estimator.GetOperationDelayInPs(n));
     critical_path.push_back(CriticalPathEntry{
-        n, delay_estimator.GetOperationDelayInPs(n).value(),
-        node_to_output_delay[n].first, node_to_output_delay[n].second});
+        n, node_delay, node_to_output_delay.at(n).first,
+        node_to_output_delay.at(n).second});
     Node* next = nullptr;
     int64_t next_delay = 0;
     for (Node* operand : n->operands()) {
-      int64_t operand_delay = node_to_output_delay[operand].first;
+      int64_t operand_delay = node_to_output_delay.at(operand).first;
       if (operand_delay > next_delay) {
         next = operand;
         next_delay = operand_delay;
@@ -78,10 +170,71 @@ absl::StatusOr<std::vector<CriticalPathEntry>> AnalyzeCriticalPath(
     }
     n = next;
   }
-
   return critical_path;
 }
 
+}  // namespace
+
+absl::StatusOr<std::vector<CriticalPathEntry>> AnalyzeCriticalPath(
+    FunctionBase* f, absl::optional<int64_t> clock_period_ps,
+    const DelayEstimator& delay_estimator) {
+  Node* sink = f->IsFunction() ? f->AsFunctionOrDie()->return_value()
+                               : f->AsProcOrDie()->NextState();
+  // Arrival times are only needed in the cone of the sink.
+  XLS_ASSIGN_OR_RETURN(
+      OutputDelayMap node_to_output_delay,
+      ComputeOutputDelays(f, absl::MakeConstSpan(&sink, 1), clock_period_ps,
+                          delay_estimator));
+  return TraceCriticalPath(sink, node_to_output_delay, delay_estimator);
+}
+
+absl::StatusOr<std::vector<std::vector<CriticalPathEntry>>>
+AnalyzeTopKCriticalPaths(FunctionBase* f,
+                         absl::optional<int64_t> clock_period_ps,
+                         const DelayEstimator& delay_estimator,
+                         int64_t max_paths) {
+  // The sinks are the nodes without users plus the conventional sink of the
+  // function (or proc) which may itself have users.
+  std::vector<Node*> sinks;
+  for (Node* node : f->nodes()) {
+    if (node->users().empty()) {
+      sinks.push_back(node);
+    }
+  }
+  Node* conventional_sink = f->IsFunction()
+                                ? f->AsFunctionOrDie()->return_value()
+                                : f->AsProcOrDie()->NextState();
+  if (!conventional_sink->users().empty()) {
+    sinks.push_back(conventional_sink);
+  }
+
+  XLS_ASSIGN_OR_RETURN(
+      OutputDelayMap node_to_output_delay,
+      ComputeOutputDelays(f, sinks, clock_period_ps, delay_estimator));
+
+  std::vector<std::vector<CriticalPathEntry>> paths;
+  paths.reserve(sinks.size());
+  for (Node* sink : sinks) {
+    XLS_ASSIGN_OR_RETURN(
+        std::vector<CriticalPathEntry> path,
+        TraceCriticalPath(sink, node_to_output_delay, delay_estimator));
+    paths.push_back(std::move(path));
+  }
+  // Order by decreasing path delay; break ties by node id for determinism.
+  std::sort(paths.begin(), paths.end(),
+            [](const std::vector<CriticalPathEntry>& a,
+               const std::vector<CriticalPathEntry>& b) {
+              if (a.front().path_delay_ps != b.front().path_delay_ps) {
+                return a.front().path_delay_ps > b.front().path_delay_ps;
+              }
+              return a.front().node->id() < b.front().node->id();
+            });
+  if (static_cast<int64_t>(paths.size()) > max_paths) {
+    paths.resize(max_paths);
+  }
+  return paths;
+}
+
 std::string CriticalPathToString(
     absl::Span<const CriticalPathEntry> critical_path,
     absl::optional<std::function<std::string(Node*)>> extra_info) {
@@ -57,6 +57,17 @@ absl::StatusOr<std::vector<CriticalPathEntry>> AnalyzeCriticalPath(
     FunctionBase* f, absl::optional<int64_t> clock_period_ps,
     const DelayEstimator& delay_estimator);
 
+// Returns up to `max_paths` critical paths ordered by decreasing path delay,
+// one per sink of the function (the nodes without users plus the return value
+// or recurrent state value). Arrival times are computed once and shared
+// across the paths so this costs little more than a single AnalyzeCriticalPath
+// call.
+absl::StatusOr<std::vector<std::vector<CriticalPathEntry>>>
+AnalyzeTopKCriticalPaths(FunctionBase* f,
+                         absl::optional<int64_t> clock_period_ps,
+                         const DelayEstimator& delay_estimator,
+                         int64_t max_paths);
+
 // Returns a string representation of the critical-path. Includes delay
 // information for each node as well as cumulative delay. Example output:
 //
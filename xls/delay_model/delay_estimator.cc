@@ -14,11 +14,14 @@
 
 #include "xls/delay_model/delay_estimator.h"
 
+#include <algorithm>
+
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "xls/common/status/status_builder.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/ir/function_base.h"
 #include "xls/ir/nodes.h"
 #include "xls/netlist/logical_effort.h"
 
@@ -80,6 +83,48 @@ absl::Status DelayEstimatorManager::RegisterDelayEstimator(
   return absl::OkStatus();
 }
 
+/* static */ CachingDelayEstimator::NodeSignature
+CachingDelayEstimator::SignatureOf(Node* node) {
+  NodeSignature signature;
+  signature.op = node->op();
+  signature.result_type = node->GetType();
+  signature.operand_types.reserve(node->operand_count());
+  signature.has_literal_operand = false;
+  for (Node* operand : node->operands()) {
+    signature.operand_types.push_back(operand->GetType());
+    signature.has_literal_operand |= operand->Is<Literal>();
+  }
+  // Matches the OPERANDS_IDENTICAL specialization predicate of the generated
+  // delay models.
+  signature.operands_identical =
+      std::all_of(node->operands().begin(), node->operands().end(),
+                  [&](Node* operand) { return operand == node->operand(0); });
+  return signature;
+}
+
+absl::StatusOr<int64_t> CachingDelayEstimator::GetOperationDelayInPs(
+    Node* node) const {
+  NodeSignature signature = SignatureOf(node);
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = cache_.find(signature);
+    if (it != cache_.end()) {
+      return it->second;
+    }
+  }
+  XLS_ASSIGN_OR_RETURN(int64_t delay, wrapped_.GetOperationDelayInPs(node));
+  absl::MutexLock lock(&mutex_);
+  cache_.insert({std::move(signature), delay});
+  return delay;
+}
+
+absl::Status CachingDelayEstimator::PrefetchDelays(FunctionBase* f) const {
+  for (Node* node : f->nodes()) {
+    XLS_RETURN_IF_ERROR(GetOperationDelayInPs(node).status());
+  }
+  return absl::OkStatus();
+}
+
 namespace {
 
 // TODO(leary): 2019-08-19 Read all of the curve-fit values from a
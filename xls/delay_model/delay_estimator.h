@@ -17,8 +17,10 @@
 
 #include <cstdint>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/node.h"
@@ -40,6 +42,62 @@ class DelayEstimator {
                                                            int64_t tau_in_ps);
 };
 
+// A delay estimator which wraps another delay estimator and memoizes its
+// results. Delays are cached by a signature of the queried node -- its op, its
+// result and operand types, and whether it matches one of the delay model
+// specializations (identical operands, literal operand) -- rather than by node
+// identity, so structurally identical nodes share a single computed
+// delay. This assumes the wrapped estimator derives its estimate solely from
+// these properties, which holds for the regression-based delay models. Useful
+// for callers such as schedulers which query the delays of the same nodes many
+// times. Queries are thread-safe, but because type pointers appear in
+// signatures a single cache must not be shared across packages.
+class CachingDelayEstimator : public DelayEstimator {
+ public:
+  // `wrapped` must outlive this object.
+  explicit CachingDelayEstimator(const DelayEstimator& wrapped)
+      : wrapped_(wrapped) {}
+
+  absl::StatusOr<int64_t> GetOperationDelayInPs(Node* node) const override;
+
+  // Computes and caches the delay of every node in `f`. Calling this once up
+  // front makes every subsequent query for a node in `f` a cache hit.
+  absl::Status PrefetchDelays(FunctionBase* f) const;
+
+ private:
+  // The properties of a node from which the wrapped estimator is assumed to
+  // compute its delay. Types are owned and uniqued by the Package so type
+  // pointer equality implies type equality.
+  struct NodeSignature {
+    Op op;
+    Type* result_type;
+    std::vector<Type*> operand_types;
+    bool operands_identical;
+    bool has_literal_operand;
+
+    template <typename H>
+    friend H AbslHashValue(H h, const NodeSignature& signature) {
+      return H::combine(std::move(h), signature.op, signature.result_type,
+                        signature.operand_types, signature.operands_identical,
+                        signature.has_literal_operand);
+    }
+    bool operator==(const NodeSignature& other) const {
+      return op == other.op && result_type == other.result_type &&
+             operand_types == other.operand_types &&
+             operands_identical == other.operands_identical &&
+             has_literal_operand == other.has_literal_operand;
+    }
+  };
+
+  static NodeSignature SignatureOf(Node* node);
+
+  const DelayEstimator& wrapped_;
+
+  mutable absl::Mutex mutex_;
+  mutable absl::flat_hash_map<NodeSignature, int64_t> cache_
+      ABSL_GUARDED_BY(mutex_);
+};
+
 enum class DelayEstimatorPrecedence {
   kLow = 1,
   kMedium = 2,
@@ -43,6 +43,20 @@ class TestDelayEstimator : public DelayEstimator {
   int64_t delay_;
 };
 
+// A test delay estimator which counts how many times it is invoked.
+class CountingDelayEstimator : public DelayEstimator {
+ public:
+  absl::StatusOr<int64_t> GetOperationDelayInPs(Node* node) const override {
+    ++call_count_;
+    return 42;
+  }
+
+  int64_t call_count() const { return call_count_; }
+
+ private:
+  mutable int64_t call_count_ = 0;
+};
+
 class DelayEstimatorTest : public IrTestBase {};
 
 TEST_F(DelayEstimatorTest, DelayEstimatorManager) {
@@ -76,6 +90,29 @@ TEST_F(DelayEstimatorTest, DelayEstimatorManager) {
               StatusIs(absl::StatusCode::kNotFound));
 }
 
+TEST_F(DelayEstimatorTest, CachingDelayEstimator) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  auto x = fb.Param("x", p->GetBitsType(32));
+  auto not_x = fb.Not(x);
+  fb.Not(not_x);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  CountingDelayEstimator wrapped;
+  CachingDelayEstimator caching(wrapped);
+  XLS_ASSERT_OK(caching.PrefetchDelays(f));
+
+  // The two nots have identical signatures (op, operand and result types) and
+  // should share a single underlying delay computation.
+  EXPECT_EQ(wrapped.call_count(), 2);
+
+  // Subsequent queries are all cache hits.
+  for (Node* node : f->nodes()) {
+    EXPECT_THAT(caching.GetOperationDelayInPs(node), IsOkAndHolds(42));
+  }
+  EXPECT_EQ(wrapped.call_count(), 2);
+}
+
 TEST_F(DelayEstimatorTest, LogicalEffortForXors) {
   {
     // Two-input XOR.
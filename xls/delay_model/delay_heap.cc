@@ -60,6 +60,42 @@ absl::Status DelayHeap::Add(Node* node) {
   return absl::OkStatus();
 }
 
+absl::Status DelayHeap::AddNodes(absl::Span<Node* const> nodes) {
+  path_lengths_.reserve(path_lengths_.size() + nodes.size());
+
+  // First compute the path lengths of all added nodes. Because the nodes are
+  // in (reverse) topological order the predecessors of each node are computed
+  // before the node itself.
+  for (Node* node : nodes) {
+    XLS_CHECK(!contains(node));
+    XLS_ASSIGN_OR_RETURN(int64_t node_delay,
+                         delay_estimator_.GetOperationDelayInPs(node));
+    PathLength path = MaxAmongPredecessors(node);
+    path_lengths_[node] = {path.critical_path_delay + node_delay,
+                           path.longest_path + 1};
+  }
+
+  // Then update the frontier. Nodes covered up by the added nodes leave the
+  // frontier and added nodes with no successors in the heap join it. Unlike
+  // repeated calls to Add, interior nodes of the batch never touch the
+  // frontier set.
+  for (Node* node : nodes) {
+    for (Node* p : predecessors(node)) {
+      if (contains(p)) {
+        auto it = frontier_.find(p);
+        if (it != frontier_.end()) {
+          frontier_.erase(it);
+        }
+      }
+    }
+    if (std::none_of(successors(node).begin(), successors(node).end(),
+                     [&](Node* n) { return contains(n); })) {
+      frontier_.insert(node);
+    }
+  }
+  return absl::OkStatus();
+}
+
 DelayHeap::FrontierSet::iterator DelayHeap::Remove(Node* node) {
   XLS_DCHECK(!std::any_of(successors(node).begin(), successors(node).end(),
                           [&](Node* n) { return contains(n); }));
@@ -112,6 +148,36 @@ int64_t DelayHeap::CriticalPathDelayAfterRemoving(Node* node) const {
                   predecessor_delay);
 }
 
+std::vector<std::vector<Node*>> DelayHeap::TopCriticalPaths(int64_t k) const {
+  std::vector<std::vector<Node*>> paths;
+  for (Node* frontier_node : frontier_) {
+    if (static_cast<int64_t>(paths.size()) == k) {
+      break;
+    }
+    // Walk from the frontier node toward the start of the heap, at each step
+    // following the predecessor with the longest path length (ties broken by
+    // node id for determinism).
+    std::vector<Node*> path;
+    Node* node = frontier_node;
+    while (node != nullptr) {
+      path.push_back(node);
+      Node* best = nullptr;
+      for (Node* p : predecessors(node)) {
+        if (contains(p) &&
+            (best == nullptr || path_lengths_.at(best) < path_lengths_.at(p) ||
+             (path_lengths_.at(best) == path_lengths_.at(p) &&
+              p->id() < best->id()))) {
+          best = p;
+        }
+      }
+      node = best;
+    }
+    std::reverse(path.begin(), path.end());
+    paths.push_back(std::move(path));
+  }
+  return paths;
+}
+
 std::string DelayHeap::ToString() const {
   std::string out;
   absl::StrAppend(&out, "Nodes in DelayHeap:\n");
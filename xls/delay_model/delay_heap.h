@@ -100,6 +100,16 @@ class DelayHeap {
   // the heap.
   absl::Status Add(Node* node);
 
+  // Adds all of the given nodes to the heap in a single pass. The nodes must
+  // be in topological order (reverse topological order if the heap grows
+  // toward operands) and obey the same membership constraints as Add.
+  // Equivalent to calling Add on each node in turn, but the bookkeeping is
+  // preallocated and frontier set operations are only performed for nodes
+  // which end up on (or are covered off) the frontier rather than for every
+  // node, which is substantially cheaper when populating a heap wholesale
+  // (e.g. seeding it with an entire pipeline stage).
+  absl::Status AddNodes(absl::Span<Node* const> nodes);
+
   // Removes the given node to the data structure. Necessarily this node must be
   // in the frontier set of the heap. Updates the frontier set and critical-path
   // delay of the heap. Returns the iterator to the next node on the frontier.
@@ -151,6 +161,12 @@ class DelayHeap {
   // delay.
   Node* top() const { return *frontier_.begin(); }
 
+  // Returns up to 'k' critical paths through the heap, longest first, one per
+  // frontier node. Each path contains only nodes in the heap and is ordered
+  // from the start of the path (a node with no predecessors in the heap) to
+  // the frontier node whose critical-path delay the path realizes.
+  std::vector<std::vector<Node*>> TopCriticalPaths(int64_t k) const;
+
   std::string ToString() const;
 
  private:
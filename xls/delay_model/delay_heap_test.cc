@@ -197,6 +197,74 @@ TEST_F(DelayHeapTest, BenchmarkTest) {
     EXPECT_EQ(heap.CriticalPathDelay(), 0);
   }
 }
+TEST_F(DelayHeapTest, BulkAddMatchesIncrementalAdd) {
+  // Adding all nodes of a function in one batch should yield the same heap as
+  // adding them one at a time.
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  auto x = fb.Param("x", p->GetBitsType(32));
+  auto neg = fb.Negate(x);
+  auto not_x = fb.Not(x);
+  fb.Add(neg, not_x);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  for (Direction direction :
+       {Direction::kGrowsTowardUsers, Direction::kGrowsTowardOperands}) {
+    std::vector<Node*> order;
+    for (Node* node : direction == Direction::kGrowsTowardUsers
+                          ? TopoSort(f)
+                          : ReverseTopoSort(f)) {
+      order.push_back(node);
+    }
+
+    DelayHeap incremental_heap(direction, delay_estimator_);
+    for (Node* node : order) {
+      XLS_ASSERT_OK(incremental_heap.Add(node));
+    }
+
+    DelayHeap bulk_heap(direction, delay_estimator_);
+    XLS_ASSERT_OK(bulk_heap.AddNodes(order));
+
+    EXPECT_EQ(bulk_heap.size(), incremental_heap.size());
+    EXPECT_EQ(bulk_heap.CriticalPathDelay(),
+              incremental_heap.CriticalPathDelay());
+    EXPECT_THAT(bulk_heap.frontier(),
+                ::testing::ElementsAreArray(incremental_heap.frontier()));
+    for (Node* node : order) {
+      EXPECT_TRUE(bulk_heap.contains(node));
+      EXPECT_EQ(bulk_heap.CriticalPathDelay(node),
+                incremental_heap.CriticalPathDelay(node));
+    }
+  }
+}
+
+TEST_F(DelayHeapTest, TopCriticalPaths) {
+  // Two independent chains of different length. The longer chain should be
+  // returned first.
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  auto x = fb.Param("x", p->GetBitsType(32));
+  auto y = fb.Param("y", p->GetBitsType(32));
+  auto neg = fb.Negate(x);
+  auto rev = fb.Reverse(neg);
+  auto not_y = fb.Not(y);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  DelayHeap heap(Direction::kGrowsTowardUsers, delay_estimator_);
+  XLS_ASSERT_OK(heap.AddNodes(TopoSort(f).AsVector()));
+
+  EXPECT_THAT(heap.TopCriticalPaths(0), ::testing::IsEmpty());
+  EXPECT_THAT(
+      heap.TopCriticalPaths(1),
+      ElementsAre(ElementsAre(x.node(), neg.node(), rev.node())));
+  // Asking for more paths than frontier nodes returns one path per frontier
+  // node.
+  EXPECT_THAT(
+      heap.TopCriticalPaths(10),
+      ElementsAre(ElementsAre(x.node(), neg.node(), rev.node()),
+                  ElementsAre(y.node(), not_y.node())));
+}
+
 }  // namespace
 }  // namespace sched
 }  // namespace xls
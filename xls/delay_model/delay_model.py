@@ -437,13 +437,59 @@ class RegressionEstimator(Estimator):
     """Returns the delay with delay expressions passed in as floats."""
     return self.delay_function(xargs)
 
-  def cpp_delay_code(self, node_identifier: Text) -> Text:
+  def _cpp_formula(self, expression_strs: Sequence[Text]) -> Text:
+    """Returns the C++ expression evaluating the fitted regression curve.
+
+    Args:
+      expression_strs: C++ expressions (one per delay expression) yielding the
+        float value of each independent variable.
+    """
     terms = [str(self.params[0])]
-    for i, expression in enumerate(self.delay_expressions):
-      e_str = _delay_expression_cpp_expression(expression, node_identifier)
+    for i, e_str in enumerate(expression_strs):
       terms.append('{} * {}'.format(self.params[2 * i + 1], e_str))
       terms.append('{} * std::log2({})'.format(self.params[2 * i + 2], e_str))
-    return 'return std::round({});'.format(' + '.join(terms))
+    return 'std::round({})'.format(' + '.join(terms))
+
+  def cpp_delay_code(self, node_identifier: Text) -> Text:
+    expression_strs = [
+        _delay_expression_cpp_expression(expression, node_identifier)
+        for expression in self.delay_expressions
+    ]
+    if (len(self.delay_expressions) == 1 and
+        self.delay_expressions[0].HasField('factor')):
+      # Delay depends on a single integer factor (the common case). Precompute
+      # the regression curve over the factor range seen in the training data
+      # so the hot path is a bounds check and a table load rather than
+      # std::log2 evaluations; the exact formula remains as fallback for
+      # values beyond the table.
+      max_x = max(int(p[0]) for p in self.raw_data_points)
+      table_size = 64
+      while table_size < max_x and table_size < 1024:
+        table_size *= 2
+      factor_str = _delay_factor_cpp_expression(
+          self.delay_expressions[0].factor, node_identifier)
+      lines = [
+          'static const std::array<int64_t, {n}>& delay_table = *[]() {{',
+          '  auto* table = new std::array<int64_t, {n}>();',
+          '  for (int64_t i = 0; i < {n}; ++i) {{',
+          '    float x = static_cast<float>(std::max<int64_t>(i, 1));',
+          '    (*table)[i] = {table_formula};',
+          '  }}',
+          '  return table;',
+          '}}();',
+          'int64_t x_value = {factor};',
+          'if (x_value >= 1 && x_value <= {max_index}) {{',
+          '  return delay_table[x_value];',
+          '}}',
+          'return {formula};',
+      ]
+      return '\n'.join(lines).format(
+          n=table_size + 1,
+          max_index=table_size,
+          table_formula=self._cpp_formula(['x']),
+          factor=factor_str,
+          formula=self._cpp_formula(expression_strs))
+    return 'return {};'.format(self._cpp_formula(expression_strs))
 
 
 class BoundingBoxEstimator(Estimator):
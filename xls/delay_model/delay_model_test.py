@@ -170,6 +170,18 @@ class DelayModelTest(absltest.TestCase):
         delta=2)
     self.assertEqualIgnoringWhitespaceAndFloats(
         foo.cpp_delay_code('node'), r"""
+          static const std::array<int64_t, 65>& delay_table = *[]() {
+            auto* table = new std::array<int64_t, 65>();
+            for (int64_t i = 0; i < 65; ++i) {
+              float x = static_cast<float>(std::max<int64_t>(i, 1));
+              (*table)[i] = std::round(0.0 + 0.0 * x + 0.0 * std::log2(x));
+            }
+            return table;
+          }();
+          int64_t x_value = node->GetType()->GetFlatBitCount();
+          if (x_value >= 1 && x_value <= 64) {
+            return delay_table[x_value];
+          }
           return std::round(
               0.0 + 0.0 * static_cast<float>(node->GetType()->GetFlatBitCount()) +
               0.0 * std::log2(static_cast<float>(node->GetType()->GetFlatBitCount())));
@@ -201,6 +213,18 @@ class DelayModelTest(absltest.TestCase):
         foo.operation_delay(_parse_operation(gen_operation(256))), 18, delta=1)
     self.assertEqualIgnoringWhitespaceAndFloats(
         foo.cpp_delay_code('node'), r"""
+          static const std::array<int64_t, 65>& delay_table = *[]() {
+            auto* table = new std::array<int64_t, 65>();
+            for (int64_t i = 0; i < 65; ++i) {
+              float x = static_cast<float>(std::max<int64_t>(i, 1));
+              (*table)[i] = std::round(0.0 + 0.0 * x + 0.0 * std::log2(x));
+            }
+            return table;
+          }();
+          int64_t x_value = node->operand_count();
+          if (x_value >= 1 && x_value <= 64) {
+            return delay_table[x_value];
+          }
           return std::round(
               0.0 + 0.0 * static_cast<float>(node->operand_count()) +
               0.0 * std::log2(static_cast<float>(node->operand_count())));
@@ -793,6 +817,18 @@ class DelayModelTest(absltest.TestCase):
                 "Unhandled node for delay estimation: " +
                 node->ToStringWithOperandTypes());
             }
+            static const std::array<int64_t, 65>& delay_table = *[]() {
+              auto* table = new std::array<int64_t, 65>();
+              for (int64_t i = 0; i < 65; ++i) {
+                float x = static_cast<float>(std::max<int64_t>(i, 1));
+                (*table)[i] = std::round(0.0 + 0.0 * x + 0.0 * std::log2(x));
+              }
+              return table;
+            }();
+            int64_t x_value = node->GetType()->GetFlatBitCount();
+            if (x_value >= 1 && x_value <= 64) {
+              return delay_table[x_value];
+            }
             return std::round(
                 0.0 + 0.0 * static_cast<float>(node->GetType()->GetFlatBitCount()) +
                 0.0 * std::log2(static_cast<float>(node->GetType()->GetFlatBitCount())));
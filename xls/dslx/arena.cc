@@ -0,0 +1,60 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/arena.h"
+
+#include <algorithm>
+
+namespace xls::dslx {
+namespace {
+
+// Large enough that typical modules use a handful of blocks; small enough
+// that a tiny module does not pin megabytes.
+constexpr int64_t kBlockSize = int64_t{256} * 1024;
+
+}  // namespace
+
+Arena::~Arena() {
+  // Destroy in reverse allocation order: later objects may point at earlier
+  // ones.
+  for (auto it = cleanups_.rbegin(); it != cleanups_.rend(); ++it) {
+    it->destroy(it->object);
+  }
+}
+
+void* Arena::AllocateAligned(int64_t size, int64_t alignment) {
+  if (!blocks_.empty()) {
+    Block& block = blocks_.back();
+    int64_t offset = (block.used + alignment - 1) & ~(alignment - 1);
+    if (offset + size <= block.size) {
+      block.used = offset + size;
+      return block.data.get() + offset;
+    }
+  }
+
+  // Oversized requests get a dedicated block; note it is pushed behind the
+  // current block (if any) so the current block keeps filling up.
+  int64_t block_size = std::max(size, kBlockSize);
+  Block block{std::unique_ptr<char[]>(new char[block_size]), block_size,
+              size};
+  char* data = block.data.get();
+  if (block_size == kBlockSize || blocks_.empty()) {
+    blocks_.push_back(std::move(block));
+  } else {
+    blocks_.insert(blocks_.end() - 1, std::move(block));
+  }
+  return data;
+}
+
+}  // namespace xls::dslx
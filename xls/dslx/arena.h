@@ -0,0 +1,82 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_ARENA_H_
+#define XLS_DSLX_ARENA_H_
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace xls::dslx {
+
+// Bump allocator used for AST node storage (see Module::Make).
+//
+// Parsing a large module creates millions of small nodes; allocating them
+// out of a handful of large blocks avoids a malloc/free per node and keeps
+// nodes that are created together (and thus typically visited together)
+// adjacent in memory. Objects are destroyed when the arena is destroyed:
+// destructors of non-trivially-destructible objects are recorded at
+// allocation time and run in reverse allocation order, then the blocks are
+// freed wholesale.
+class Arena {
+ public:
+  Arena() = default;
+  ~Arena();
+
+  // The arena hands out interior pointers, so it must not move.
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  // Allocates and constructs a T; the object lives until the arena is
+  // destroyed.
+  template <typename T, typename... Args>
+  T* New(Args&&... args) {
+    void* storage = AllocateAligned(sizeof(T), alignof(T));
+    T* object = new (storage) T(std::forward<Args>(args)...);
+    if (!std::is_trivially_destructible<T>::value) {
+      cleanups_.push_back(
+          Cleanup{object, [](void* p) { static_cast<T*>(p)->~T(); }});
+    }
+    return object;
+  }
+
+  // Number of blocks allocated so far (exposed for testing).
+  int64_t block_count() const { return blocks_.size(); }
+
+ private:
+  struct Cleanup {
+    void* object;
+    void (*destroy)(void*);
+  };
+
+  struct Block {
+    std::unique_ptr<char[]> data;
+    int64_t size;
+    int64_t used;
+  };
+
+  // Returns a pointer to "size" bytes with the given alignment, starting a
+  // new block if the current one is exhausted.
+  void* AllocateAligned(int64_t size, int64_t alignment);
+
+  std::vector<Block> blocks_;
+  std::vector<Cleanup> cleanups_;
+};
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_ARENA_H_
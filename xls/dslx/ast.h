@@ -28,6 +28,7 @@
 #include "xls/common/casts.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/dslx/arena.h"
 #include "xls/dslx/pos.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/format_strings.h"
@@ -2668,10 +2669,8 @@ class Module : public AstNode {
 
   template <typename T, typename... Args>
   T* Make(Args&&... args) {
-    std::unique_ptr<T> node =
-        std::make_unique<T>(this, std::forward<Args>(args)...);
-    T* ptr = node.get();
-    nodes_.push_back(std::move(node));
+    T* ptr = arena_.New<T>(this, std::forward<Args>(args)...);
+    nodes_.push_back(ptr);
     return ptr;
   }
 
@@ -2755,10 +2754,10 @@ class Module : public AstNode {
   const std::string& name() const { return name_; }
 
   const AstNode* FindNode(AstNodeKind kind, const Span& span) const {
-    for (const auto& node : nodes_) {
+    for (AstNode* node : nodes_) {
       if (node->kind() == kind && node->GetSpan().has_value() &&
           node->GetSpan().value() == span) {
-        return node.get();
+        return node;
       }
     }
     return nullptr;
@@ -2793,7 +2792,11 @@ class Module : public AstNode {
 
   std::string name_;               // Name of this module.
   std::vector<ModuleMember> top_;  // Top-level members of this module.
-  std::vector<std::unique_ptr<AstNode>> nodes_;  // Lifetime-owned AST nodes.
+
+  // Storage for the nodes created via Make(); the arena destroys them (and
+  // releases their memory in bulk) when the module is destroyed.
+  Arena arena_;
+  std::vector<AstNode*> nodes_;  // All nodes created via Make().
 };
 
 // Helper for determining whether an AST node is constant (e.g. can be
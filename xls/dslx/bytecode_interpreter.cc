@@ -0,0 +1,305 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/bytecode_interpreter.h"
+
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/dslx/concrete_type.h"
+
+namespace xls::dslx {
+namespace {
+
+absl::Status Unsupported(absl::string_view what) {
+  return absl::UnimplementedError(
+      absl::StrFormat("Bytecode compilation does not support %s.", what));
+}
+
+}  // namespace
+
+// Compiles the expression tree of a function body into a linear instruction
+// sequence, resolving each NameDef to a slot index.
+class BytecodeFunction::Compiler {
+ public:
+  explicit Compiler(TypeInfo* type_info) : type_info_(type_info) {}
+
+  absl::Status AddParam(NameDef* name_def) {
+    return AllocateSlot(name_def).status();
+  }
+
+  absl::Status CompileExpr(Expr* expr) {
+    if (auto* number = dynamic_cast<Number*>(expr)) {
+      return CompileNumber(number);
+    }
+    if (auto* name_ref = dynamic_cast<NameRef*>(expr)) {
+      return CompileNameRef(name_ref);
+    }
+    if (auto* let = dynamic_cast<Let*>(expr)) {
+      return CompileLet(let);
+    }
+    if (auto* binop = dynamic_cast<Binop*>(expr)) {
+      XLS_RETURN_IF_ERROR(CompileExpr(binop->lhs()));
+      XLS_RETURN_IF_ERROR(CompileExpr(binop->rhs()));
+      code_.push_back(Instruction{Opcode::kBinop, 0, binop->binop_kind()});
+      return absl::OkStatus();
+    }
+    if (auto* unop = dynamic_cast<Unop*>(expr)) {
+      XLS_RETURN_IF_ERROR(CompileExpr(unop->operand()));
+      Instruction instruction{Opcode::kUnop};
+      instruction.unop = unop->unop_kind();
+      code_.push_back(std::move(instruction));
+      return absl::OkStatus();
+    }
+    if (auto* ternary = dynamic_cast<Ternary*>(expr)) {
+      return CompileTernary(ternary);
+    }
+    if (auto* tuple = dynamic_cast<XlsTuple*>(expr)) {
+      for (Expr* member : tuple->members()) {
+        XLS_RETURN_IF_ERROR(CompileExpr(member));
+      }
+      code_.push_back(Instruction{
+          Opcode::kMakeTuple, static_cast<int64_t>(tuple->members().size())});
+      return absl::OkStatus();
+    }
+    return Unsupported(expr->GetNodeTypeName());
+  }
+
+  std::vector<Instruction> TakeCode() { return std::move(code_); }
+  int64_t slot_count() const { return next_slot_; }
+
+ private:
+  absl::StatusOr<int64_t> AllocateSlot(NameDef* name_def) {
+    int64_t slot = next_slot_++;
+    slots_[name_def] = slot;
+    return slot;
+  }
+
+  absl::Status CompileNumber(Number* number) {
+    // The type of every number is known post-typechecking; sizing the
+    // literal here is what lets evaluation skip type resolution entirely.
+    absl::optional<ConcreteType*> type = type_info_->GetItem(number);
+    if (!type.has_value()) {
+      return Unsupported("numbers without type information");
+    }
+    auto* bits_type = dynamic_cast<BitsType*>(type.value());
+    if (bits_type == nullptr) {
+      return Unsupported("non-bits-typed numbers");
+    }
+    if (!absl::holds_alternative<InterpValue>(bits_type->size().value())) {
+      return Unsupported("numbers of parametric width");
+    }
+    XLS_ASSIGN_OR_RETURN(int64_t bit_count, bits_type->size().GetAsInt64());
+    XLS_ASSIGN_OR_RETURN(Bits bits, number->GetBits(bit_count));
+    Instruction instruction{Opcode::kLiteral};
+    instruction.literal =
+        InterpValue::MakeBits(bits_type->is_signed(), std::move(bits));
+    code_.push_back(std::move(instruction));
+    return absl::OkStatus();
+  }
+
+  absl::Status CompileNameRef(NameRef* name_ref) {
+    if (!absl::holds_alternative<NameDef*>(name_ref->name_def())) {
+      return Unsupported("references to builtin names");
+    }
+    auto it = slots_.find(absl::get<NameDef*>(name_ref->name_def()));
+    if (it == slots_.end()) {
+      // E.g. a module-level constant or an enclosing-scope name.
+      return Unsupported("references to names outside the function");
+    }
+    code_.push_back(Instruction{Opcode::kLoad, it->second});
+    return absl::OkStatus();
+  }
+
+  absl::Status CompileLet(Let* let) {
+    NameDefTree* name_def_tree = let->name_def_tree();
+    if (!name_def_tree->is_leaf() ||
+        !absl::holds_alternative<NameDef*>(name_def_tree->leaf())) {
+      return Unsupported("destructuring lets");
+    }
+    XLS_RETURN_IF_ERROR(CompileExpr(let->rhs()));
+    XLS_ASSIGN_OR_RETURN(
+        int64_t slot, AllocateSlot(absl::get<NameDef*>(name_def_tree->leaf())));
+    code_.push_back(Instruction{Opcode::kStore, slot});
+    return CompileExpr(let->body());
+  }
+
+  absl::Status CompileTernary(Ternary* ternary) {
+    XLS_RETURN_IF_ERROR(CompileExpr(ternary->test()));
+    int64_t branch_index = static_cast<int64_t>(code_.size());
+    code_.push_back(Instruction{Opcode::kJumpIfFalse});
+    XLS_RETURN_IF_ERROR(CompileExpr(ternary->consequent()));
+    int64_t jump_index = static_cast<int64_t>(code_.size());
+    code_.push_back(Instruction{Opcode::kJump});
+    code_[branch_index].arg = static_cast<int64_t>(code_.size());
+    XLS_RETURN_IF_ERROR(CompileExpr(ternary->alternate()));
+    code_[jump_index].arg = static_cast<int64_t>(code_.size());
+    return absl::OkStatus();
+  }
+
+  TypeInfo* type_info_;
+  absl::flat_hash_map<NameDef*, int64_t> slots_;
+  int64_t next_slot_ = 0;
+  std::vector<Instruction> code_;
+};
+
+/* static */ absl::StatusOr<BytecodeFunction> BytecodeFunction::Compile(
+    Function* f, TypeInfo* type_info) {
+  if (f->IsParametric()) {
+    // Literal widths in a parametric body depend on the instantiation.
+    return Unsupported("parametric functions");
+  }
+  Compiler compiler(type_info);
+  for (Param* param : f->params()) {
+    XLS_RETURN_IF_ERROR(compiler.AddParam(param->name_def()));
+  }
+  XLS_RETURN_IF_ERROR(compiler.CompileExpr(f->body()));
+  int64_t slot_count = compiler.slot_count();
+  return BytecodeFunction(compiler.TakeCode(),
+                          static_cast<int64_t>(f->params().size()), slot_count);
+}
+
+absl::StatusOr<InterpValue> BytecodeFunction::Execute(
+    absl::Span<const InterpValue> args) const {
+  XLS_RET_CHECK_EQ(static_cast<int64_t>(args.size()), param_count_);
+  std::vector<InterpValue> slots(args.begin(), args.end());
+  slots.resize(slot_count_, InterpValue::MakeUnit());
+  std::vector<InterpValue> stack;
+
+  auto pop = [&stack]() {
+    InterpValue value = std::move(stack.back());
+    stack.pop_back();
+    return value;
+  };
+
+  int64_t pc = 0;
+  const int64_t code_size = static_cast<int64_t>(code_.size());
+  while (pc < code_size) {
+    const Instruction& instruction = code_[pc];
+    switch (instruction.op) {
+      case Opcode::kLiteral:
+        stack.push_back(*instruction.literal);
+        ++pc;
+        break;
+      case Opcode::kLoad:
+        stack.push_back(slots[instruction.arg]);
+        ++pc;
+        break;
+      case Opcode::kStore:
+        slots[instruction.arg] = pop();
+        ++pc;
+        break;
+      case Opcode::kBinop: {
+        InterpValue rhs = pop();
+        InterpValue lhs = pop();
+        XLS_ASSIGN_OR_RETURN(InterpValue result,
+                             EvalBinop(instruction.binop, lhs, rhs));
+        stack.push_back(std::move(result));
+        ++pc;
+        break;
+      }
+      case Opcode::kUnop: {
+        InterpValue operand = pop();
+        switch (instruction.unop) {
+          case UnopKind::kInvert: {
+            XLS_ASSIGN_OR_RETURN(InterpValue result, operand.BitwiseNegate());
+            stack.push_back(std::move(result));
+            break;
+          }
+          case UnopKind::kNegate: {
+            XLS_ASSIGN_OR_RETURN(InterpValue result,
+                                 operand.ArithmeticNegate());
+            stack.push_back(std::move(result));
+            break;
+          }
+        }
+        ++pc;
+        break;
+      }
+      case Opcode::kJump:
+        pc = instruction.arg;
+        break;
+      case Opcode::kJumpIfFalse: {
+        InterpValue test = pop();
+        pc = test.IsTrue() ? pc + 1 : instruction.arg;
+        break;
+      }
+      case Opcode::kMakeTuple: {
+        std::vector<InterpValue> members(instruction.arg,
+                                         InterpValue::MakeUnit());
+        for (int64_t i = instruction.arg - 1; i >= 0; --i) {
+          members[i] = pop();
+        }
+        stack.push_back(InterpValue::MakeTuple(std::move(members)));
+        ++pc;
+        break;
+      }
+    }
+  }
+  XLS_RET_CHECK_EQ(stack.size(), 1);
+  return std::move(stack.back());
+}
+
+/* static */ absl::StatusOr<InterpValue> BytecodeFunction::EvalBinop(
+    BinopKind kind, const InterpValue& lhs, const InterpValue& rhs) {
+  // Mirrors EvaluateBinop()/EvaluateShift() in evaluate.cc; logical and/or
+  // operate on single-bit values so they share the bitwise implementation.
+  switch (kind) {
+    case BinopKind::kAdd:
+      return lhs.Add(rhs);
+    case BinopKind::kSub:
+      return lhs.Sub(rhs);
+    case BinopKind::kConcat:
+      return lhs.Concat(rhs);
+    case BinopKind::kMul:
+      return lhs.Mul(rhs);
+    case BinopKind::kDiv:
+      return lhs.FloorDiv(rhs);
+    case BinopKind::kOr:
+    case BinopKind::kLogicalOr:
+      return lhs.BitwiseOr(rhs);
+    case BinopKind::kAnd:
+    case BinopKind::kLogicalAnd:
+      return lhs.BitwiseAnd(rhs);
+    case BinopKind::kXor:
+      return lhs.BitwiseXor(rhs);
+    case BinopKind::kEq:
+      return InterpValue::MakeBool(lhs.Eq(rhs));
+    case BinopKind::kNe:
+      return InterpValue::MakeBool(lhs.Ne(rhs));
+    case BinopKind::kGt:
+      return lhs.Gt(rhs);
+    case BinopKind::kLt:
+      return lhs.Lt(rhs);
+    case BinopKind::kLe:
+      return lhs.Le(rhs);
+    case BinopKind::kGe:
+      return lhs.Ge(rhs);
+    case BinopKind::kShl:
+      return lhs.Shl(rhs);
+    case BinopKind::kShr:
+      if (lhs.IsSigned()) {
+        return lhs.Shra(rhs);
+      }
+      return lhs.Shrl(rhs);
+  }
+  return absl::InternalError(absl::StrFormat("Invalid binary operation kind: %d",
+                                             static_cast<int64_t>(kind)));
+}
+
+}  // namespace xls::dslx
@@ -0,0 +1,95 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_BYTECODE_INTERPRETER_H_
+#define XLS_DSLX_BYTECODE_INTERPRETER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "xls/dslx/ast.h"
+#include "xls/dslx/interp_value.h"
+#include "xls/dslx/type_info.h"
+
+namespace xls::dslx {
+
+// A DSLX function compiled to a linear bytecode: locals are resolved to slot
+// indices at compile time (no InterpBindings chain lookups at evaluation
+// time), literals are folded to InterpValues once, and evaluation is a tight
+// dispatch loop over a value stack.
+//
+// This is a fast tier underneath the AST tree-walking evaluator, not a
+// replacement: Compile() handles the scalar-expression subset of the
+// language (literals, locals, let, binary and unary operations, ternaries,
+// and tuple construction) for non-parametric functions and returns an
+// unimplemented error otherwise, in which case callers fall back to the
+// tree-walker. The Interpreter does this automatically and caches compiled
+// functions, so invocation-heavy workloads (test execution, constexpr
+// evaluation during typechecking) pay compilation once per function.
+class BytecodeFunction {
+ public:
+  // Compiles the body of "f" using the type information in "type_info"
+  // (which must be the root type info of f's module, used to size number
+  // literals). Returns an unimplemented error if the function uses language
+  // features outside the supported subset.
+  static absl::StatusOr<BytecodeFunction> Compile(Function* f,
+                                                  TypeInfo* type_info);
+
+  // Evaluates the compiled function with the given argument values.
+  absl::StatusOr<InterpValue> Execute(absl::Span<const InterpValue> args) const;
+
+  int64_t slot_count() const { return slot_count_; }
+  int64_t instruction_count() const {
+    return static_cast<int64_t>(code_.size());
+  }
+
+ private:
+  enum class Opcode : uint8_t {
+    kLiteral,      // Pushes the instruction's literal value.
+    kLoad,         // Pushes the value in slot "arg".
+    kStore,        // Pops into slot "arg".
+    kBinop,        // Pops rhs then lhs, pushes the binop result.
+    kUnop,         // Pops the operand, pushes the unop result.
+    kJump,         // Unconditional jump to instruction "arg".
+    kJumpIfFalse,  // Pops the test; jumps to "arg" if it is false.
+    kMakeTuple,    // Pops "arg" values, pushes them as a tuple.
+  };
+
+  struct Instruction {
+    Opcode op;
+    int64_t arg = 0;
+    BinopKind binop = BinopKind::kAdd;
+    UnopKind unop = UnopKind::kInvert;
+    absl::optional<InterpValue> literal;
+  };
+
+  class Compiler;
+
+  BytecodeFunction(std::vector<Instruction> code, int64_t param_count,
+                   int64_t slot_count)
+      : code_(std::move(code)),
+        param_count_(param_count),
+        slot_count_(slot_count) {}
+
+  std::vector<Instruction> code_;
+  int64_t param_count_;
+  int64_t slot_count_;
+};
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_BYTECODE_INTERPRETER_H_
@@ -0,0 +1,119 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/bytecode_interpreter.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/dslx/parse_and_typecheck.h"
+
+namespace xls::dslx {
+namespace {
+
+using status_testing::StatusIs;
+
+// Parses/typechecks "program" and compiles the function named "fn_name" to
+// bytecode.
+absl::StatusOr<BytecodeFunction> CompileFunction(absl::string_view program,
+                                                 absl::string_view fn_name) {
+  auto import_data = ImportData::CreateForTest();
+  XLS_ASSIGN_OR_RETURN(
+      TypecheckedModule tm,
+      ParseAndTypecheck(program, "test.x", "test", &import_data));
+  XLS_ASSIGN_OR_RETURN(Function * f, tm.module->GetFunctionOrError(fn_name));
+  return BytecodeFunction::Compile(f, tm.type_info);
+}
+
+TEST(BytecodeInterpreterTest, ArithmeticWithLets) {
+  const char* program = R"(
+fn main(x: u32, y: u32) -> u32 {
+  let sum = x + y;
+  let shifted = sum << u32:1;
+  shifted - x
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(BytecodeFunction bf,
+                           CompileFunction(program, "main"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      InterpValue result,
+      bf.Execute({InterpValue::MakeU32(3), InterpValue::MakeU32(4)}));
+  // (3 + 4) << 1 - 3 = 11
+  EXPECT_EQ(result, InterpValue::MakeU32(11));
+}
+
+TEST(BytecodeInterpreterTest, TernarySelectsBranch) {
+  const char* program = R"(
+fn main(x: s32) -> s32 {
+  if x < s32:0 { -x } else { x }
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(BytecodeFunction bf,
+                           CompileFunction(program, "main"));
+  XLS_ASSERT_OK_AND_ASSIGN(InterpValue result,
+                           bf.Execute({InterpValue::MakeSBits(32, -5)}));
+  EXPECT_EQ(result, InterpValue::MakeSBits(32, 5));
+  XLS_ASSERT_OK_AND_ASSIGN(result,
+                           bf.Execute({InterpValue::MakeSBits(32, 7)}));
+  EXPECT_EQ(result, InterpValue::MakeSBits(32, 7));
+}
+
+TEST(BytecodeInterpreterTest, TupleConstruction) {
+  const char* program = R"(
+fn main(x: u8) -> (u8, u8) {
+  (x, x + u8:1)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(BytecodeFunction bf,
+                           CompileFunction(program, "main"));
+  XLS_ASSERT_OK_AND_ASSIGN(InterpValue result,
+                           bf.Execute({InterpValue::MakeUBits(8, 42)}));
+  EXPECT_EQ(result, InterpValue::MakeTuple({InterpValue::MakeUBits(8, 42),
+                                            InterpValue::MakeUBits(8, 43)}));
+}
+
+TEST(BytecodeInterpreterTest, SignedShiftRightIsArithmetic) {
+  const char* program = R"(
+fn main(x: s8) -> s8 {
+  x >> u8:1
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(BytecodeFunction bf,
+                           CompileFunction(program, "main"));
+  XLS_ASSERT_OK_AND_ASSIGN(InterpValue result,
+                           bf.Execute({InterpValue::MakeSBits(8, -4)}));
+  EXPECT_EQ(result, InterpValue::MakeSBits(8, -2));
+}
+
+TEST(BytecodeInterpreterTest, UnsupportedFeaturesAreUnimplemented) {
+  // Invocations are outside the bytecode subset; callers fall back to the
+  // tree-walking evaluator.
+  const char* program = R"(
+fn g(x: u32) -> u32 { x }
+fn main(x: u32) -> u32 { g(x) }
+)";
+  EXPECT_THAT(CompileFunction(program, "main").status(),
+              StatusIs(absl::StatusCode::kUnimplemented));
+}
+
+TEST(BytecodeInterpreterTest, ParametricFunctionsAreUnimplemented) {
+  const char* program = R"(
+fn main<N: u32>(x: bits[N]) -> bits[N] { x }
+)";
+  EXPECT_THAT(CompileFunction(program, "main").status(),
+              StatusIs(absl::StatusCode::kUnimplemented));
+}
+
+}  // namespace
+}  // namespace xls::dslx
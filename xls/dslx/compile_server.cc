@@ -0,0 +1,295 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/compile_server.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/common/strerror.h"
+#include "xls/dslx/command_line_utils.h"
+#include "xls/dslx/interpreter.h"
+#include "xls/dslx/parser.h"
+#include "xls/dslx/scanner.h"
+#include "xls/dslx/typecheck.h"
+
+namespace xls::dslx {
+namespace {
+
+// Renders an error status as a response payload.
+CompileServerResponse ErrorResponse(const absl::Status& status) {
+  return CompileServerResponse{/*ok=*/false, std::string(status.message())};
+}
+
+}  // namespace
+
+std::string FormatResponse(const CompileServerResponse& response) {
+  return absl::StrFormat("%s %d\n%s", response.ok ? "ok" : "error",
+                         response.payload.size(), response.payload);
+}
+
+CompileServer::CompileServer(CompileServerOptions options)
+    : options_(std::move(options)) {
+  import_data_.emplace(options_.stdlib_path, options_.dslx_paths);
+}
+
+absl::StatusOr<CompileServer::EntryInfo*> CompileServer::GetOrTypecheckEntry(
+    absl::string_view path) {
+  XLS_ASSIGN_OR_RETURN(std::string text,
+                       GetFileContents(std::filesystem::path(std::string(path))));
+  auto it = entries_.find(path);
+  if (it != entries_.end() && it->second.text == text) {
+    return &it->second;
+  }
+
+  XLS_ASSIGN_OR_RETURN(std::string module_name, PathToName(path));
+  Scanner scanner{std::string(path), text};
+  Parser parser(module_name, &scanner);
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Module> module, parser.ParseModule());
+  XLS_ASSIGN_OR_RETURN(TypeInfo * type_info,
+                       CheckModule(module.get(), &import_data_.value()));
+
+  // Note: replacing an edited entry drops its Module; the type information
+  // minted for the old version stays in the session's TypeInfoOwner until a
+  // "reset", which is the usual retained-memory/latency trade for a warm
+  // compile session.
+  EntryInfo& entry = entries_[std::string(path)];
+  entry.text = std::move(text);
+  entry.module = std::move(module);
+  entry.type_info = type_info;
+  return &entry;
+}
+
+CompileServerResponse CompileServer::HandleParse(absl::string_view path) {
+  absl::StatusOr<std::string> text_or =
+      GetFileContents(std::filesystem::path(std::string(path)));
+  if (!text_or.ok()) {
+    return ErrorResponse(text_or.status());
+  }
+  absl::StatusOr<std::string> module_name_or = PathToName(path);
+  if (!module_name_or.ok()) {
+    return ErrorResponse(module_name_or.status());
+  }
+  Scanner scanner{std::string(path), std::move(text_or).value()};
+  Parser parser(module_name_or.value(), &scanner);
+  absl::StatusOr<std::unique_ptr<Module>> module_or = parser.ParseModule();
+  if (!module_or.ok()) {
+    return ErrorResponse(module_or.status());
+  }
+  return CompileServerResponse{/*ok=*/true, module_or.value()->ToString()};
+}
+
+CompileServerResponse CompileServer::HandleTypecheck(absl::string_view path) {
+  absl::StatusOr<EntryInfo*> entry_or = GetOrTypecheckEntry(path);
+  if (!entry_or.ok()) {
+    return ErrorResponse(entry_or.status());
+  }
+  return CompileServerResponse{/*ok=*/true, /*payload=*/""};
+}
+
+CompileServerResponse CompileServer::HandleConvert(absl::string_view path) {
+  absl::StatusOr<EntryInfo*> entry_or = GetOrTypecheckEntry(path);
+  if (!entry_or.ok()) {
+    return ErrorResponse(entry_or.status());
+  }
+  absl::StatusOr<std::string> ir_or =
+      ConvertModule(entry_or.value()->module.get(), &import_data_.value(),
+                    options_.convert_options);
+  if (!ir_or.ok()) {
+    return ErrorResponse(ir_or.status());
+  }
+  return CompileServerResponse{/*ok=*/true, std::move(ir_or).value()};
+}
+
+CompileServerResponse CompileServer::HandleRun(absl::string_view path) {
+  absl::StatusOr<EntryInfo*> entry_or = GetOrTypecheckEntry(path);
+  if (!entry_or.ok()) {
+    return ErrorResponse(entry_or.status());
+  }
+  Module* module = entry_or.value()->module.get();
+
+  auto typecheck_callback = [this](Module* m) {
+    return CheckModule(m, &import_data_.value());
+  };
+  Interpreter interpreter(module, typecheck_callback, &import_data_.value());
+
+  std::vector<std::string> lines;
+  int64_t failed = 0;
+  for (const std::string& test_name : module->GetTestNames()) {
+    absl::Status status = interpreter.RunTest(test_name);
+    if (status.ok()) {
+      lines.push_back(absl::StrCat("PASS ", test_name));
+    } else {
+      failed += 1;
+      lines.push_back(
+          absl::StrCat("FAIL ", test_name, ": ", status.message()));
+    }
+  }
+  lines.push_back(absl::StrFormat("%d test(s) ran; %d failed.",
+                                  module->GetTestNames().size(), failed));
+  return CompileServerResponse{/*ok=*/failed == 0,
+                               absl::StrJoin(lines, "\n")};
+}
+
+CompileServerResponse CompileServer::HandleRequest(absl::string_view line) {
+  std::pair<absl::string_view, absl::string_view> pieces =
+      absl::StrSplit(line, absl::MaxSplits(' ', 1));
+  absl::string_view verb = pieces.first;
+  absl::string_view arg = pieces.second;
+
+  if (verb == "reset") {
+    entries_.clear();
+    import_data_.emplace(options_.stdlib_path, options_.dslx_paths);
+    return CompileServerResponse{/*ok=*/true, /*payload=*/""};
+  }
+  if (arg.empty()) {
+    return CompileServerResponse{
+        /*ok=*/false,
+        absl::StrCat("Missing path argument in request: `", line, "`")};
+  }
+  if (verb == "parse") {
+    return HandleParse(arg);
+  }
+  if (verb == "typecheck") {
+    return HandleTypecheck(arg);
+  }
+  if (verb == "convert") {
+    return HandleConvert(arg);
+  }
+  if (verb == "run") {
+    return HandleRun(arg);
+  }
+  return CompileServerResponse{
+      /*ok=*/false, absl::StrCat("Unknown request verb: `", verb, "`")};
+}
+
+namespace {
+
+// Writes all of "data" to the given file descriptor.
+absl::Status SendAll(int fd, absl::string_view data) {
+  while (!data.empty()) {
+    ssize_t written = write(fd, data.data(), data.size());
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return absl::InternalError(
+          absl::StrCat("write() failed: ", Strerror(errno)));
+    }
+    data.remove_prefix(written);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status CompileServer::Serve(const std::filesystem::path& socket_path) {
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  const std::string path_str = socket_path.string();
+  if (path_str.size() >= sizeof(addr.sun_path)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Socket path is too long: ", path_str));
+  }
+  std::memcpy(addr.sun_path, path_str.c_str(), path_str.size() + 1);
+
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listener < 0) {
+    return absl::InternalError(
+        absl::StrCat("socket() failed: ", Strerror(errno)));
+  }
+  // Replace any stale socket file from a previous server instance.
+  unlink(path_str.c_str());
+  if (bind(listener, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) <
+      0) {
+    close(listener);
+    return absl::InternalError(absl::StrCat("bind() failed for ", path_str,
+                                            ": ", Strerror(errno)));
+  }
+  if (listen(listener, /*backlog=*/8) < 0) {
+    close(listener);
+    return absl::InternalError(
+        absl::StrCat("listen() failed: ", Strerror(errno)));
+  }
+
+  bool done = false;
+  while (!done) {
+    int client = accept(listener, nullptr, nullptr);
+    if (client < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      close(listener);
+      return absl::InternalError(
+          absl::StrCat("accept() failed: ", Strerror(errno)));
+    }
+
+    std::string buffer;
+    char chunk[4096];
+    bool client_ok = true;
+    while (!done && client_ok) {
+      // Handle any complete request lines already buffered.
+      std::string::size_type newline;
+      while (!done && client_ok &&
+             (newline = buffer.find('\n')) != std::string::npos) {
+        std::string line = buffer.substr(0, newline);
+        buffer.erase(0, newline + 1);
+        absl::Status send_status;
+        if (line == "quit") {
+          done = true;
+          send_status = SendAll(
+              client, FormatResponse(CompileServerResponse{true, ""}));
+        } else {
+          send_status = SendAll(client, FormatResponse(HandleRequest(line)));
+        }
+        if (!send_status.ok()) {
+          XLS_LOG(WARNING) << send_status;
+          client_ok = false;
+        }
+      }
+      if (done || !client_ok) {
+        break;
+      }
+
+      ssize_t count = read(client, chunk, sizeof(chunk));
+      if (count < 0 && errno == EINTR) {
+        continue;
+      }
+      if (count <= 0) {
+        break;  // Client disconnected.
+      }
+      buffer.append(chunk, count);
+    }
+    close(client);
+  }
+
+  close(listener);
+  unlink(path_str.c_str());
+  return absl::OkStatus();
+}
+
+}  // namespace xls::dslx
@@ -0,0 +1,130 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A compilation session server for DSLX tooling.
+//
+// Every standalone tool invocation (interpreter_main, ir_converter_main, ...)
+// pays process startup plus re-parsing/typechecking of the standard library
+// and any imported modules. The server keeps a warm ImportData across
+// requests so that build-system and editor integrations only pay for the
+// entry file itself on warm paths.
+//
+// The wire protocol is line oriented over a Unix-domain stream socket. Each
+// request is a single line:
+//
+//   parse <path>      -- parses <path>, responds with the module pretty-print
+//   typecheck <path>  -- parses and typechecks <path>
+//   convert <path>    -- parses/typechecks <path> and responds with its IR
+//   run <path>        -- runs the #![test] constructs in <path>, responding
+//                        with one "PASS <name>"/"FAIL <name>: ..." line per
+//                        test; the response status is "error" if any failed
+//   reset             -- drops all cached state (e.g. after an imported
+//                        module changed on disk)
+//   quit              -- shuts the server down
+//
+// and each response is framed as:
+//
+//   <status> <payload-byte-count>\n<payload>
+//
+// where <status> is "ok" or "error".
+//
+// Entry files are cached by content: re-requesting an unchanged file reuses
+// its parsed/typechecked module. Imported modules are cached by the
+// underlying ImportData for the lifetime of the session, so clients should
+// issue "reset" (or restart the server) when a module imported by their entry
+// files changes on disk.
+
+#ifndef XLS_DSLX_COMPILE_SERVER_H_
+#define XLS_DSLX_COMPILE_SERVER_H_
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+#include "xls/dslx/default_dslx_stdlib_path.h"
+#include "xls/dslx/import_data.h"
+#include "xls/dslx/ir_converter.h"
+
+namespace xls::dslx {
+
+// Options used to set up the compilation session.
+struct CompileServerOptions {
+  std::string stdlib_path = xls::kDefaultDslxStdlibPath;
+  std::vector<std::filesystem::path> dslx_paths;
+  ConvertOptions convert_options;
+};
+
+// Result of handling a single request; see FormatResponse() for the wire
+// encoding.
+struct CompileServerResponse {
+  bool ok;
+  std::string payload;
+};
+
+// Renders a response in the wire format described in the file comment.
+std::string FormatResponse(const CompileServerResponse& response);
+
+class CompileServer {
+ public:
+  explicit CompileServer(CompileServerOptions options);
+
+  // Handles a single request line (without trailing newline). Failures to
+  // parse/typecheck/convert/run are reported in the response (ok == false)
+  // rather than as a status, so the transport treats them uniformly.
+  //
+  // "quit" is handled by the transport (see Serve) and is not a valid input
+  // here.
+  CompileServerResponse HandleRequest(absl::string_view line);
+
+  // Binds a Unix-domain stream socket at "socket_path" (replacing any stale
+  // socket file) and serves requests from one client at a time until a
+  // client sends "quit".
+  absl::Status Serve(const std::filesystem::path& socket_path);
+
+  // Number of entry files currently cached (exposed for testing).
+  int64_t cached_entry_count() const { return entries_.size(); }
+
+ private:
+  // A parsed-and-typechecked entry file, keyed in entries_ by path and
+  // validated against the file contents it was built from.
+  struct EntryInfo {
+    std::string text;
+    std::unique_ptr<Module> module;
+    TypeInfo* type_info;
+  };
+
+  // Returns the (possibly cached) typechecked module for the entry file at
+  // "path", re-parsing and re-typechecking if the file contents changed.
+  absl::StatusOr<EntryInfo*> GetOrTypecheckEntry(absl::string_view path);
+
+  CompileServerResponse HandleParse(absl::string_view path);
+  CompileServerResponse HandleTypecheck(absl::string_view path);
+  CompileServerResponse HandleConvert(absl::string_view path);
+  CompileServerResponse HandleRun(absl::string_view path);
+
+  CompileServerOptions options_;
+
+  // Held in an optional so "reset" can recreate the session in place.
+  absl::optional<ImportData> import_data_;
+
+  absl::flat_hash_map<std::string, EntryInfo> entries_;
+};
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_COMPILE_SERVER_H_
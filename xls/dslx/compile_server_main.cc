@@ -0,0 +1,64 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "absl/flags/flag.h"
+#include "absl/strings/str_split.h"
+#include "xls/common/init_xls.h"
+#include "xls/dslx/compile_server.h"
+
+ABSL_FLAG(std::string, socket_path, "",
+          "Path at which to create the Unix-domain socket the server "
+          "listens on (required).");
+ABSL_FLAG(std::string, dslx_path, "",
+          "Additional paths to search for modules (colon delimited).");
+
+namespace xls::dslx {
+namespace {
+
+const char* kUsage = R"(
+Runs a persistent DSLX compilation session server on a Unix-domain socket.
+
+The server keeps the parsed standard library and previously imported modules
+warm across requests so build-system and editor integrations get fast
+responses. See compile_server.h for the request protocol.
+)";
+
+absl::Status RealMain(const std::filesystem::path& socket_path,
+                      std::vector<std::filesystem::path> dslx_paths) {
+  CompileServerOptions options;
+  options.dslx_paths = std::move(dslx_paths);
+  CompileServer server(std::move(options));
+  return server.Serve(socket_path);
+}
+
+}  // namespace
+}  // namespace xls::dslx
+
+int main(int argc, char* argv[]) {
+  xls::InitXls(xls::dslx::kUsage, argc, argv);
+
+  std::string socket_path = absl::GetFlag(FLAGS_socket_path);
+  XLS_QCHECK(!socket_path.empty()) << "-socket_path is required";
+
+  std::string dslx_path = absl::GetFlag(FLAGS_dslx_path);
+  std::vector<std::string> dslx_path_strs = absl::StrSplit(dslx_path, ':');
+  std::vector<std::filesystem::path> dslx_paths;
+  dslx_paths.reserve(dslx_path_strs.size());
+  for (const auto& path : dslx_path_strs) {
+    dslx_paths.push_back(std::filesystem::path(path));
+  }
+
+  XLS_QCHECK_OK(xls::dslx::RealMain(socket_path, std::move(dslx_paths)));
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,184 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/compile_server.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/matchers.h"
+#include "xls/common/thread.h"
+
+namespace xls::dslx {
+namespace {
+
+using testing::HasSubstr;
+
+TEST(CompileServerTest, TypecheckReusesUnchangedEntry) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  std::filesystem::path path = tempdir.path() / "m.x";
+  XLS_ASSERT_OK(SetFileContents(path, "fn f(x: u32) -> u32 { x + u32:1 }"));
+
+  CompileServer server(CompileServerOptions{});
+  CompileServerResponse response =
+      server.HandleRequest(absl::StrCat("typecheck ", path.string()));
+  EXPECT_TRUE(response.ok) << response.payload;
+  EXPECT_EQ(server.cached_entry_count(), 1);
+
+  // Unchanged file: served from the entry cache.
+  response = server.HandleRequest(absl::StrCat("typecheck ", path.string()));
+  EXPECT_TRUE(response.ok) << response.payload;
+  EXPECT_EQ(server.cached_entry_count(), 1);
+}
+
+TEST(CompileServerTest, EditedEntryIsRetypechecked) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  std::filesystem::path path = tempdir.path() / "m.x";
+  XLS_ASSERT_OK(SetFileContents(path, "fn f(x: u32) -> u32 { x }"));
+
+  CompileServer server(CompileServerOptions{});
+  CompileServerResponse response =
+      server.HandleRequest(absl::StrCat("typecheck ", path.string()));
+  EXPECT_TRUE(response.ok) << response.payload;
+
+  // Rewrite the file with a type error; the edit must be observed.
+  XLS_ASSERT_OK(SetFileContents(path, "fn f(x: u32) -> u8 { x }"));
+  response = server.HandleRequest(absl::StrCat("typecheck ", path.string()));
+  EXPECT_FALSE(response.ok);
+  EXPECT_THAT(response.payload, HasSubstr("uN[32] vs uN[8]"));
+}
+
+TEST(CompileServerTest, ConvertProducesIr) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  std::filesystem::path path = tempdir.path() / "m.x";
+  XLS_ASSERT_OK(SetFileContents(path, "fn f(x: u32) -> u32 { x + u32:1 }"));
+
+  CompileServer server(CompileServerOptions{});
+  CompileServerResponse response =
+      server.HandleRequest(absl::StrCat("convert ", path.string()));
+  EXPECT_TRUE(response.ok) << response.payload;
+  EXPECT_THAT(response.payload, HasSubstr("package m"));
+  EXPECT_THAT(response.payload, HasSubstr("fn "));
+}
+
+TEST(CompileServerTest, RunReportsTestResults) {
+  constexpr absl::string_view kProgram = R"(
+#![test]
+fn test_passes() { assert_eq(u32:1, u32:1) }
+
+#![test]
+fn test_fails() { assert_eq(u32:1, u32:2) }
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  std::filesystem::path path = tempdir.path() / "m.x";
+  XLS_ASSERT_OK(SetFileContents(path, kProgram));
+
+  CompileServer server(CompileServerOptions{});
+  CompileServerResponse response =
+      server.HandleRequest(absl::StrCat("run ", path.string()));
+  EXPECT_FALSE(response.ok);
+  EXPECT_THAT(response.payload, HasSubstr("PASS test_passes"));
+  EXPECT_THAT(response.payload, HasSubstr("FAIL test_fails"));
+  EXPECT_THAT(response.payload, HasSubstr("2 test(s) ran; 1 failed."));
+}
+
+TEST(CompileServerTest, UnknownVerbIsAnError) {
+  CompileServer server(CompileServerOptions{});
+  CompileServerResponse response = server.HandleRequest("frobnicate /tmp/x");
+  EXPECT_FALSE(response.ok);
+  EXPECT_THAT(response.payload, HasSubstr("Unknown request verb"));
+}
+
+TEST(CompileServerTest, ResetClearsEntryCache) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  std::filesystem::path path = tempdir.path() / "m.x";
+  XLS_ASSERT_OK(SetFileContents(path, "fn f() -> u32 { u32:0 }"));
+
+  CompileServer server(CompileServerOptions{});
+  CompileServerResponse response =
+      server.HandleRequest(absl::StrCat("typecheck ", path.string()));
+  EXPECT_TRUE(response.ok) << response.payload;
+  EXPECT_EQ(server.cached_entry_count(), 1);
+
+  response = server.HandleRequest("reset");
+  EXPECT_TRUE(response.ok);
+  EXPECT_EQ(server.cached_entry_count(), 0);
+}
+
+// Connects to the given socket path and performs a typecheck request
+// followed by "quit", returning everything the server sent back.
+std::string RoundTrip(const std::filesystem::path& socket_path,
+                      const std::filesystem::path& file_path) {
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  std::string path_str = socket_path.string();
+  std::memcpy(addr.sun_path, path_str.c_str(), path_str.size() + 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  XLS_CHECK_GE(fd, 0);
+  // The server binds the socket shortly after it starts; retry briefly.
+  for (int i = 0; i < 100; ++i) {
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) ==
+        0) {
+      break;
+    }
+    usleep(10'000);
+  }
+
+  std::string request =
+      absl::StrCat("typecheck ", file_path.string(), "\nquit\n");
+  XLS_CHECK_EQ(write(fd, request.data(), request.size()),
+               static_cast<ssize_t>(request.size()));
+
+  std::string reply;
+  char chunk[4096];
+  ssize_t count;
+  while ((count = read(fd, chunk, sizeof(chunk))) > 0) {
+    reply.append(chunk, count);
+  }
+  close(fd);
+  return reply;
+}
+
+TEST(CompileServerTest, SocketRoundTrip) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  std::filesystem::path file_path = tempdir.path() / "m.x";
+  XLS_ASSERT_OK(SetFileContents(file_path, "fn f() -> u32 { u32:42 }"));
+  std::filesystem::path socket_path = tempdir.path() / "server.sock";
+
+  CompileServer server(CompileServerOptions{});
+  absl::Status serve_status = absl::OkStatus();
+  Thread server_thread(
+      [&]() { serve_status = server.Serve(socket_path); });
+
+  std::string reply = RoundTrip(socket_path, file_path);
+  server_thread.Join();
+
+  XLS_EXPECT_OK(serve_status);
+  // One response for the typecheck request and one for "quit".
+  EXPECT_EQ(reply, "ok 0\nok 0\n");
+}
+
+}  // namespace
+}  // namespace xls::dslx
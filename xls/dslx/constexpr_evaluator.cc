@@ -59,11 +59,18 @@ void ConstexprEvaluator::HandleNumber(Number* expr) {
     env = MakeConstexprEnv(expr, ctx_->fn_stack().back().symbolic_bindings(),
                            ctx_->type_info());
   }
+  std::string env_key = ConstexprMemo::MakeEnvKey(env, /*type_context=*/nullptr);
+  if (absl::optional<InterpValue> memoized =
+          ctx_->constexpr_memo()->Lookup(expr, env_key)) {
+    ctx_->type_info()->NoteConstExpr(expr, memoized.value());
+    return;
+  }
   absl::StatusOr<InterpValue> value = Interpreter::InterpretExpr(
       expr->owner(), ctx_->import_data()->GetRootTypeInfoForNode(expr).value(),
       ctx_->typecheck_module(), ctx_->import_data(), env, expr);
   status_ = value.status();
   if (value.ok()) {
+    ctx_->constexpr_memo()->Insert(expr, std::move(env_key), value.value());
     ctx_->type_info()->NoteConstExpr(expr, value.value());
   }
 }
@@ -93,11 +100,20 @@ absl::Status ConstexprEvaluator::SimpleEvaluate(Expr* expr) {
     }
   }
 
+  std::string env_key = ConstexprMemo::MakeEnvKey(env, concrete_type_);
+  if (absl::optional<InterpValue> memoized =
+          ctx_->constexpr_memo()->Lookup(expr, env_key)) {
+    ctx_->type_info()->NoteConstExpr(expr, memoized.value());
+    return absl::OkStatus();
+  }
+
   absl::StatusOr<InterpValue> constexpr_value = Interpreter::InterpretExpr(
       expr->owner(), ctx_->type_info(), ctx_->typecheck_module(),
       ctx_->import_data(), env, expr,
       fn_ctx.has_value() ? &fn_ctx.value() : nullptr, concrete_type_);
   if (constexpr_value.ok()) {
+    ctx_->constexpr_memo()->Insert(expr, std::move(env_key),
+                                   constexpr_value.value());
     ctx_->type_info()->NoteConstExpr(expr, constexpr_value.value());
   }
 
@@ -115,6 +115,35 @@ fn Foo() -> u64 {
   EXPECT_EQ(maybe_value.value().GetBitValueInt64().value(), 13);
 }
 
+TEST(ConstexprEvaluatorTest, MemoHitsForMatchingExprAndEnv) {
+  constexpr absl::string_view kModule = R"(
+const kFoo = u32:7;
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(TestData test_data, CreateTestData(kModule));
+  XLS_ASSERT_OK_AND_ASSIGN(ConstantDef * constant_def,
+                           test_data.module->GetConstantDef("kFoo"));
+  Number* number = down_cast<Number*>(constant_def->value());
+
+  ConstexprMemo memo;
+  absl::flat_hash_map<std::string, InterpValue> env = {
+      {"N", InterpValue::MakeU32(4)}};
+  std::string env_key = ConstexprMemo::MakeEnvKey(env, /*type_context=*/nullptr);
+  // The key is canonical: recomputing it for the same environment matches.
+  EXPECT_EQ(env_key, ConstexprMemo::MakeEnvKey(env, /*type_context=*/nullptr));
+
+  EXPECT_EQ(memo.Lookup(number, env_key), absl::nullopt);
+  memo.Insert(number, env_key, InterpValue::MakeU32(7));
+  ASSERT_TRUE(memo.Lookup(number, env_key).has_value());
+  EXPECT_EQ(memo.Lookup(number, env_key)->GetBitValueInt64().value(), 7);
+
+  // A different parametric binding misses.
+  env["N"] = InterpValue::MakeU32(5);
+  EXPECT_EQ(
+      memo.Lookup(number, ConstexprMemo::MakeEnvKey(env, nullptr)),
+      absl::nullopt);
+}
+
 TEST(ConstexprEvaluatorTest, HandleStructInstance_Simple) {
   constexpr absl::string_view kModule = R"(
 struct MyStruct {
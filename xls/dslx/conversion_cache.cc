@@ -0,0 +1,136 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/conversion_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/dslx/import_routines.h"
+#include "xls/dslx/parser.h"
+#include "xls/dslx/scanner.h"
+
+namespace xls::dslx {
+namespace {
+
+// Stable 64-bit FNV-1a hash. The key names an on-disk entry that must be
+// found again by later processes, so a per-process-seeded hash such as
+// absl::Hash cannot be used.
+uint64_t StableHash(absl::string_view data,
+                    uint64_t hash = 0xcbf29ce484222325ULL) {
+  for (char c : data) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// Parses "text" and returns the import subjects of the module.
+absl::StatusOr<std::vector<ImportTokens>> GetImportSubjects(
+    const std::filesystem::path& path, absl::string_view text) {
+  Scanner scanner(std::string(path), std::string(text));
+  Parser parser(/*module_name=*/path.stem().string(), &scanner);
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Module> module, parser.ParseModule());
+  std::vector<ImportTokens> subjects;
+  for (const auto& [name, import] : module->GetImportByName()) {
+    subjects.push_back(ImportTokens(import->subject()));
+  }
+  return subjects;
+}
+
+}  // namespace
+
+ConversionCache::ConversionCache(std::filesystem::path cache_dir)
+    : cache_dir_(std::move(cache_dir)) {
+  absl::Status status = RecursivelyCreateDir(cache_dir_);
+  if (!status.ok()) {
+    XLS_LOG(WARNING) << "Unable to create conversion cache directory "
+                     << cache_dir_ << ": " << status;
+  }
+}
+
+/* static */ absl::StatusOr<std::string> ConversionCache::MakeCacheKey(
+    absl::Span<const std::filesystem::path> paths,
+    absl::string_view stdlib_path,
+    absl::Span<const std::filesystem::path> additional_search_paths,
+    absl::string_view config) {
+  // Breadth-first walk of the import closure. Files are identified by their
+  // resolved path so a module imported under several subjects is hashed once.
+  std::deque<std::filesystem::path> to_visit(paths.begin(), paths.end());
+  absl::flat_hash_set<std::string> visited;
+  std::vector<std::string> contents;
+  int64_t total_bytes = 0;
+  while (!to_visit.empty()) {
+    std::filesystem::path path = to_visit.front();
+    to_visit.pop_front();
+    if (!visited.insert(std::string(path)).second) {
+      continue;
+    }
+    XLS_ASSIGN_OR_RETURN(std::string text, GetFileContents(path));
+    XLS_ASSIGN_OR_RETURN(std::vector<ImportTokens> subjects,
+                         GetImportSubjects(path, text));
+    total_bytes += text.size();
+    contents.push_back(std::move(text));
+    const Span fake_span(Pos(std::string(path), 0, 0),
+                         Pos(std::string(path), 0, 0));
+    for (const ImportTokens& subject : subjects) {
+      XLS_ASSIGN_OR_RETURN(
+          std::filesystem::path imported,
+          FindExistingPath(subject, stdlib_path, additional_search_paths,
+                           fake_span));
+      to_visit.push_back(std::move(imported));
+    }
+  }
+  // Hash order must not depend on traversal order, which can vary with
+  // import map iteration; sort the contents for a stable key. Each piece is
+  // length-prefixed so concatenation boundaries cannot alias.
+  std::sort(contents.begin(), contents.end());
+  uint64_t hash = StableHash(absl::StrCat(config.size(), ":", config));
+  for (const std::string& text : contents) {
+    hash = StableHash(absl::StrCat(text.size(), ":"), hash);
+    hash = StableHash(text, hash);
+  }
+  return absl::StrFormat("xls-dslx-ir-%d-%016x", total_bytes, hash);
+}
+
+absl::optional<std::string> ConversionCache::Lookup(
+    absl::string_view key) const {
+  absl::StatusOr<std::string> contents = GetFileContents(EntryPath(key));
+  if (!contents.ok()) {
+    return absl::nullopt;
+  }
+  XLS_VLOG(2) << "Conversion cache hit for " << key;
+  return *std::move(contents);
+}
+
+absl::Status ConversionCache::Store(absl::string_view key,
+                                    absl::string_view ir_text) const {
+  return SetFileContents(EntryPath(key), ir_text);
+}
+
+std::filesystem::path ConversionCache::EntryPath(absl::string_view key) const {
+  return cache_dir_ / absl::StrCat(key, ".ir");
+}
+
+}  // namespace xls::dslx
@@ -0,0 +1,72 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_CONVERSION_CACHE_H_
+#define XLS_DSLX_CONVERSION_CACHE_H_
+
+#include <filesystem>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+
+namespace xls::dslx {
+
+// Persistent on-disk cache of DSLX-to-IR conversion results, keyed by a hash
+// of the file contents of the input module's transitive import closure plus a
+// caller-provided configuration string. An incremental tool run whose inputs
+// (and their imports, recursively, including the stdlib) are byte-identical
+// to a previous run loads the converted IR text directly instead of
+// re-parsing, re-typechecking, and re-converting the world.
+//
+// The key is computed with a parse-only pass over the closure -- no
+// typechecking -- so computing it is cheap relative to conversion. Entries
+// are never evicted; the caller owns the lifetime of the cache directory.
+class ConversionCache {
+ public:
+  // Creates a cache rooted at "cache_dir". The directory is created if it
+  // does not already exist.
+  explicit ConversionCache(std::filesystem::path cache_dir);
+
+  // Computes the cache key for converting the module files at "paths": each
+  // file and its transitive imports are parsed and resolved (against
+  // "stdlib_path" and "additional_search_paths", as imports are during
+  // typechecking) and all file contents are hashed together with "config",
+  // which should fold in every option that affects the converted output
+  // (entry, package name, conversion flags). Returns an error if a file
+  // cannot be read, parsed, or its import resolved.
+  static absl::StatusOr<std::string> MakeCacheKey(
+      absl::Span<const std::filesystem::path> paths,
+      absl::string_view stdlib_path,
+      absl::Span<const std::filesystem::path> additional_search_paths,
+      absl::string_view config);
+
+  // Returns the cached IR text for "key", or nullopt if not present.
+  absl::optional<std::string> Lookup(absl::string_view key) const;
+
+  // Stores the IR text for "key" on disk.
+  absl::Status Store(absl::string_view key, absl::string_view ir_text) const;
+
+ private:
+  std::filesystem::path EntryPath(absl::string_view key) const;
+
+  std::filesystem::path cache_dir_;
+};
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_CONVERSION_CACHE_H_
@@ -72,10 +72,14 @@ absl::StatusOr<Sources> TranspileColonRef(const TranspileData& xpile_data,
   return absl::UnimplementedError("TranspileColonRef not yet implemented.");
 }
 
+absl::StatusOr<std::string> TypeAnnotationToPackedViewString(
+    const TranspileData& xpile_data, TypeAnnotation* annot);
+
 absl::StatusOr<Sources> TranspileEnumDef(const TranspileData& xpile_data,
                                          const EnumDef* enum_def) {
   constexpr absl::string_view kTemplate =
-      "enum class %s {\n%s\n};\nconstexpr int64_t k%sNumElements = %d;";
+      "enum class %s {\n%s\n};\nconstexpr int64_t k%sNumElements = %d;\n"
+      "using %sView = %s;";
   constexpr absl::string_view kMemberTemplate = "  %s = %s,";
 
   std::vector<std::string> members;
@@ -119,9 +123,13 @@ absl::StatusOr<Sources> TranspileEnumDef(const TranspileData& xpile_data,
   }
 
   std::string camelized_id = CheckedCamelize(enum_def->identifier());
+  XLS_ASSIGN_OR_RETURN(
+      std::string view_str,
+      TypeAnnotationToPackedViewString(xpile_data,
+                                       enum_def->type_annotation()));
   return Sources{
       absl::StrFormat(kTemplate, camelized_id, absl::StrJoin(members, "\n"),
-                      camelized_id, members.size()),
+                      camelized_id, members.size(), camelized_id, view_str),
       ""};
 }
 
@@ -150,6 +158,29 @@ absl::StatusOr<std::string> BuiltinTypeAnnotationToString(
   }
 }
 
+// Returns the (constexpr-evaluated) dimension of the given array type
+// annotation.
+absl::StatusOr<uint64_t> GetArrayDim(const TranspileData& xpile_data,
+                                     const ArrayTypeAnnotation* annot) {
+  if (auto* number = dynamic_cast<Number*>(annot->dim())) {
+    return number->GetAsUint64();
+  }
+  auto typecheck_fn = [&xpile_data](Module* module) {
+    return CheckModule(module, xpile_data.import_data);
+  };
+  XLS_ASSIGN_OR_RETURN(
+      InterpValue dim_value,
+      Interpreter::InterpretExpr(xpile_data.module, xpile_data.type_info,
+                                 typecheck_fn, xpile_data.import_data, {},
+                                 annot->dim()));
+  // TODO(rspringer): Handle multidimensional arrays.
+  if (!dim_value.IsBits()) {
+    return absl::UnimplementedError(
+        "Multidimensional arrays aren't yet supported.");
+  }
+  return dim_value.GetBitValueUint64();
+}
+
 absl::StatusOr<std::string> ArrayTypeAnnotationToString(
     const TranspileData& xpile_data, const ArrayTypeAnnotation* annot) {
   XLS_ASSIGN_OR_RETURN(absl::optional<BuiltinType> as_builtin_type,
@@ -164,26 +195,7 @@ absl::StatusOr<std::string> ArrayTypeAnnotationToString(
   XLS_ASSIGN_OR_RETURN(
       std::string element_type,
       TypeAnnotationToString(xpile_data, annot->element_type()));
-
-  uint64_t dim_int;
-  if (auto* number = dynamic_cast<Number*>(annot->dim())) {
-    XLS_ASSIGN_OR_RETURN(dim_int, number->GetAsUint64());
-  } else {
-    auto typecheck_fn = [&xpile_data](Module* module) {
-      return CheckModule(module, xpile_data.import_data);
-    };
-    XLS_ASSIGN_OR_RETURN(
-        InterpValue dim_value,
-        Interpreter::InterpretExpr(xpile_data.module, xpile_data.type_info,
-                                   typecheck_fn, xpile_data.import_data, {},
-                                   annot->dim()));
-    // TODO(rspringer): Handle multidimensional arrays.
-    if (!dim_value.IsBits()) {
-      return absl::UnimplementedError(
-          "Multidimensional arrays aren't yet supported.");
-    }
-    XLS_ASSIGN_OR_RETURN(dim_int, dim_value.GetBitValueUint64());
-  }
+  XLS_ASSIGN_OR_RETURN(uint64_t dim_int, GetArrayDim(xpile_data, annot));
   return absl::StrCat(element_type, "[", dim_int, "]");
 }
 
@@ -222,14 +234,64 @@ absl::StatusOr<std::string> TypeAnnotationToString(
   }
 }
 
+// Returns the packed-view type (see xls/ir/value_view.h) with the same layout
+// as the given type annotation, e.g. `xls::PackedBitsView<7>` for `u7`. Named
+// types reference the "FooView" alias emitted alongside their definition, so
+// view types compose the same way the generated value types do.
+absl::StatusOr<std::string> TypeAnnotationToPackedViewString(
+    const TranspileData& xpile_data, TypeAnnotation* annot) {
+  XLS_ASSIGN_OR_RETURN(absl::optional<BuiltinType> as_builtin_type,
+                       GetAsBuiltinType(xpile_data.module, xpile_data.type_info,
+                                        xpile_data.import_data, annot));
+  if (as_builtin_type.has_value()) {
+    XLS_ASSIGN_OR_RETURN(int64_t bit_count,
+                         GetBuiltinTypeBitCount(as_builtin_type.value()));
+    return absl::StrFormat("xls::PackedBitsView<%d>", bit_count);
+  }
+
+  if (auto* array_type = dynamic_cast<ArrayTypeAnnotation*>(annot)) {
+    // GetAsBuiltinType covers the bits-like array case above.
+    XLS_ASSIGN_OR_RETURN(std::string element_view,
+                         TypeAnnotationToPackedViewString(
+                             xpile_data, array_type->element_type()));
+    XLS_ASSIGN_OR_RETURN(uint64_t dim_int, GetArrayDim(xpile_data, array_type));
+    return absl::StrFormat("xls::PackedArrayView<%s, %d>", element_view,
+                           dim_int);
+  }
+
+  if (auto* tuple_type = dynamic_cast<TupleTypeAnnotation*>(annot)) {
+    std::vector<std::string> element_views;
+    for (TypeAnnotation* member : tuple_type->members()) {
+      XLS_ASSIGN_OR_RETURN(std::string element_view,
+                           TypeAnnotationToPackedViewString(xpile_data,
+                                                            member));
+      element_views.push_back(element_view);
+    }
+    return absl::StrCat("xls::PackedTupleView<",
+                        absl::StrJoin(element_views, ", "), ">");
+  }
+
+  if (auto* typeref_type = dynamic_cast<TypeRefTypeAnnotation*>(annot)) {
+    return absl::StrCat(CheckedCamelize(typeref_type->ToString()), "View");
+  }
+
+  return absl::InvalidArgumentError(absl::StrCat(
+      "Cannot express type as a packed view: ", annot->ToString()));
+}
+
 absl::StatusOr<Sources> TranspileTypeDef(const TranspileData& xpile_data,
                                          const TypeDef* type_def) {
   XLS_ASSIGN_OR_RETURN(
       std::string annot_str,
       TypeAnnotationToString(xpile_data, type_def->type_annotation()));
+  XLS_ASSIGN_OR_RETURN(
+      std::string view_str,
+      TypeAnnotationToPackedViewString(xpile_data,
+                                       type_def->type_annotation()));
+  std::string camelized_id = CheckedCamelize(type_def->identifier());
   return Sources{
-      absl::StrFormat("using %s = %s;", CheckedCamelize(type_def->identifier()),
-                      CheckedCamelize(annot_str)),
+      absl::StrFormat("using %s = %s;\nusing %sView = %s;", camelized_id,
+                      CheckedCamelize(annot_str), camelized_id, view_str),
       ""};
 }
 
@@ -536,10 +598,12 @@ absl::StatusOr<std::string> TranspileStructDefHeader(
   friend std::ostream& operator<<(std::ostream& os, const $0& data);
 
 $1$2
-};)";
+};
+using $0View = xls::PackedTupleView<$3>;)";
 
   std::string struct_body;
   std::vector<std::string> member_decls;
+  std::vector<std::string> member_views;
   std::vector<std::string> scalar_widths;
   for (int i = 0; i < struct_def->members().size(); i++) {
     std::string member_name = struct_def->members()[i].first->identifier();
@@ -557,6 +621,10 @@ $1$2
     member_decls.push_back(
         absl::StrFormat("  %s %s;", CheckedCamelize(type_str), member_name));
 
+    XLS_ASSIGN_OR_RETURN(std::string member_view,
+                         TypeAnnotationToPackedViewString(xpile_data, type));
+    member_views.push_back(member_view);
+
     XLS_ASSIGN_OR_RETURN(absl::optional<int64_t> width,
                          GetFieldWidth(xpile_data, type));
     if (width.has_value()) {
@@ -572,7 +640,8 @@ $1$2
   }
   return absl::Substitute(kStructTemplate,
                           CheckedCamelize(struct_def->identifier()),
-                          absl::StrJoin(member_decls, "\n"), width_block);
+                          absl::StrJoin(member_decls, "\n"), width_block,
+                          absl::StrJoin(member_views, ", "));
 }
 
 absl::StatusOr<std::string> TranspileStructDefBody(
@@ -33,6 +33,11 @@ namespace xls::dslx {
 // setters and converters into XLS Value types, each with appropriate size and
 // completeness validation. See the associated unit test for concrete examples.
 //
+// Alongside each type a "FooView" alias is emitted naming the packed-view
+// layout of the type (see xls/ir/value_view.h), so callers can pass flat data
+// buffers directly into packed-view JIT entry points (e.g.
+// IrJit::RunWithPackedViews) without materializing xls::Values at all.
+//
 // Note that the given Module must have been typechecked.
 //
 // The APIs emitted here are not guaranteed to be stable over time. For example,
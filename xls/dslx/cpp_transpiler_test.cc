@@ -51,6 +51,7 @@ enum class MyEnum {
   kE = 4294967295,
 };
 constexpr int64_t kMyEnumNumElements = 4;
+using MyEnumView = xls::PackedBitsView<32>;
 
 #endif  // FAKE_PATH_H_
 )";
@@ -95,6 +96,7 @@ enum class MyEnum {
   kC = 289,
 };
 constexpr int64_t kMyEnumNumElements = 3;
+using MyEnumView = xls::PackedBitsView<32>;
 
 #endif  // FAKE_PATH_H_
 )";
@@ -137,20 +139,28 @@ type MyFirstTuple = (u7, s8, MyType, MySignedType, MyArrayType1, MyArrayType2);
 namespace robs::secret::space {
 
 using MyType = uint8_t;
+using MyTypeView = xls::PackedBitsView<6>;
 
 using MySignedType = int8_t;
+using MySignedTypeView = xls::PackedBitsView<8>;
 
 using MyThirdType = int16_t;
+using MyThirdTypeView = xls::PackedBitsView<9>;
 
 using MyArrayType1 = uint32_t[8];
+using MyArrayType1View = xls::PackedArrayView<xls::PackedBitsView<31>, 8>;
 
 using MyArrayType2 = uint32_t[4];
+using MyArrayType2View = xls::PackedArrayView<xls::PackedBitsView<31>, 4>;
 
 using MyArrayType3 = MySignedType[4];
+using MyArrayType3View = xls::PackedArrayView<MySignedTypeView, 4>;
 
 using MyArrayType4 = int8_t[4];
+using MyArrayType4View = xls::PackedArrayView<xls::PackedBitsView<8>, 4>;
 
 using MyFirstTuple = std::tuple<uint8_t, int8_t, MyType, MySignedType, MyArrayType1, MyArrayType2>;
+using MyFirstTupleView = xls::PackedTupleView<xls::PackedBitsView<7>, xls::PackedBitsView<8>, MyTypeView, MySignedTypeView, MyArrayType1View, MyArrayType2View>;
 
 }  // namespace robs::secret::space
 
@@ -202,6 +212,7 @@ struct MyStruct {
   static constexpr int64_t kZWidth = 8;
   static constexpr int64_t kWWidth = 63;
 };
+using MyStructView = xls::PackedTupleView<xls::PackedBitsView<32>, xls::PackedBitsView<15>, xls::PackedBitsView<8>, xls::PackedBitsView<63>>;
 
 #endif  // FAKE_PATH_H_
 )";
@@ -295,6 +306,7 @@ struct MyStruct {
   int8_t y[8];
   uint8_t z[7];
 };
+using MyStructView = xls::PackedTupleView<xls::PackedArrayView<xls::PackedBitsView<32>, 32>, xls::PackedArrayView<xls::PackedBitsView<7>, 8>, xls::PackedArrayView<xls::PackedBitsView<8>, 7>>;
 
 #endif  // FAKE_PATH_H_
 )";
@@ -412,6 +424,7 @@ struct InnerStruct {
   static constexpr int64_t kXWidth = 32;
   static constexpr int64_t kYWidth = 16;
 };
+using InnerStructView = xls::PackedTupleView<xls::PackedBitsView<32>, xls::PackedBitsView<16>>;
 
 struct OuterStruct {
   static absl::StatusOr<OuterStruct> FromValue(const xls::Value& value);
@@ -426,6 +439,7 @@ struct OuterStruct {
 
   static constexpr int64_t kXWidth = 32;
 };
+using OuterStructView = xls::PackedTupleView<xls::PackedBitsView<32>, InnerStructView, InnerStructView>;
 
 #endif  // FAKE_PATH_H_
 )";
@@ -572,6 +586,7 @@ struct InnerStruct {
   static constexpr int64_t kXWidth = 32;
   static constexpr int64_t kYWidth = 16;
 };
+using InnerStructView = xls::PackedTupleView<xls::PackedBitsView<32>, xls::PackedBitsView<16>>;
 
 struct MiddleStruct {
   static absl::StatusOr<MiddleStruct> FromValue(const xls::Value& value);
@@ -585,6 +600,7 @@ struct MiddleStruct {
 
   static constexpr int64_t kZWidth = 48;
 };
+using MiddleStructView = xls::PackedTupleView<xls::PackedBitsView<48>, InnerStructView>;
 
 struct OtherMiddleStruct {
   static absl::StatusOr<OtherMiddleStruct> FromValue(const xls::Value& value);
@@ -598,6 +614,7 @@ struct OtherMiddleStruct {
 
   static constexpr int64_t kWWidth = 64;
 };
+using OtherMiddleStructView = xls::PackedTupleView<InnerStructView, xls::PackedBitsView<64>>;
 
 struct OuterStruct {
   static absl::StatusOr<OuterStruct> FromValue(const xls::Value& value);
@@ -613,6 +630,7 @@ struct OuterStruct {
 
   static constexpr int64_t kVWidth = 8;
 };
+using OuterStructView = xls::PackedTupleView<InnerStructView, MiddleStructView, OtherMiddleStructView, xls::PackedBitsView<8>>;
 
 #endif  // FAKE_PATH_H_
 )";
@@ -117,6 +117,15 @@ static absl::Status ValidateParametricInvocation(
       return absl::OkStatus();
     }
 
+    if (absl::optional<TypeInfo*> memoized = ctx->instantiation_memo()->Lookup(
+            parametric_fn, symbolic_bindings)) {
+      // Another callsite already typechecked this function with these
+      // bindings; reuse its type info for this invocation.
+      ctx->type_info()->SetInstantiationTypeInfo(
+          invocation, /*caller=*/symbolic_bindings, /*type_info=*/*memoized);
+      return absl::OkStatus();
+    }
+
     ColonRef::Subject subject = colon_ref->subject();
     // TODO(leary): 2020-12-14 Seems possible to violate this assertion? Attempt
     // to make a test that hits it.
@@ -152,6 +161,8 @@ static absl::Status ValidateParametricInvocation(
     ctx->type_info()->SetInstantiationTypeInfo(
         invocation, /*caller=*/symbolic_bindings,
         /*type_info=*/invocation_imported_type_info);
+    ctx->instantiation_memo()->Insert(parametric_fn, symbolic_bindings,
+                                      invocation_imported_type_info);
     return absl::OkStatus();
   }
 
@@ -163,6 +174,15 @@ static absl::Status ValidateParametricInvocation(
   }
 
   if (!ctx->type_info()->Contains(parametric_fn->body())) {
+    if (absl::optional<TypeInfo*> memoized = ctx->instantiation_memo()->Lookup(
+            parametric_fn, symbolic_bindings)) {
+      // Another callsite already typechecked this function with these
+      // bindings; reuse its type info for this invocation.
+      ctx->type_info()->SetInstantiationTypeInfo(
+          invocation, /*caller=*/symbolic_bindings, /*type_info=*/*memoized);
+      return absl::OkStatus();
+    }
+
     // Typecheck this parametric function using the symbolic bindings we just
     // derived to make sure they check out ok.
     AstNode* type_missing_error_node = ToAstNode(name_ref->name_def());
@@ -185,6 +205,8 @@ static absl::Status ValidateParametricInvocation(
               << "; instantiated: " << ctx->type_info();
   ctx->type_info()->parent()->SetInstantiationTypeInfo(
       invocation, symbolic_bindings, ctx->type_info());
+  ctx->instantiation_memo()->Insert(parametric_fn, symbolic_bindings,
+                                    ctx->type_info());
   XLS_RETURN_IF_ERROR(ctx->PopDerivedTypeInfo());
   return absl::OkStatus();
 }
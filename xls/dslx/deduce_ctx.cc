@@ -14,7 +14,11 @@
 
 #include "xls/dslx/deduce_ctx.h"
 
+#include <algorithm>
+
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/strip.h"
 #include "absl/types/variant.h"
@@ -22,6 +26,21 @@
 
 namespace xls::dslx {
 
+/* static */ std::string ConstexprMemo::MakeEnvKey(
+    const absl::flat_hash_map<std::string, InterpValue>& env,
+    const ConcreteType* type_context) {
+  std::vector<std::string> parts;
+  parts.reserve(env.size() + 1);
+  for (const auto& [name, value] : env) {
+    parts.push_back(absl::StrCat(name, ":", value.ToString()));
+  }
+  std::sort(parts.begin(), parts.end());
+  if (type_context != nullptr) {
+    parts.push_back(absl::StrCat("type:", type_context->ToString()));
+  }
+  return absl::StrJoin(parts, ",");
+}
+
 std::string FnStackEntry::ToReprString() const {
   return absl::StrFormat("FnStackEntry{\"%s\", %s}", name_,
                          symbolic_bindings_.ToString());
@@ -68,6 +68,83 @@ class FnStackEntry {
   SymbolicBindings symbolic_bindings_;
 };
 
+// Memoization table for constexpr evaluation results.
+//
+// The same constant expression node is re-evaluated (via the interpreter)
+// under every parametric instantiation of its enclosing function, so for
+// heavily parameterized code constexpr evaluation dominates typechecking
+// time. Results are keyed by the expression node and a canonical rendering
+// of the constexpr environment it was evaluated under, so instantiations
+// that bind the same parametric values reuse the previously computed value.
+//
+// The table is shared by all DeduceCtx instances derived (via MakeCtx) from
+// the same root context.
+class ConstexprMemo {
+ public:
+  // Builds the canonical key component for "env" (plus the optional type
+  // context the expression is evaluated under). Map iteration order is
+  // nondeterministic, so entries are sorted before being joined.
+  static std::string MakeEnvKey(
+      const absl::flat_hash_map<std::string, InterpValue>& env,
+      const ConcreteType* type_context);
+
+  // Returns the memoized value for evaluating "expr" under "env_key", if
+  // present.
+  absl::optional<InterpValue> Lookup(const Expr* expr,
+                                     const std::string& env_key) const {
+    auto it = memo_.find(std::make_pair(expr, env_key));
+    if (it == memo_.end()) {
+      return absl::nullopt;
+    }
+    return it->second;
+  }
+
+  void Insert(const Expr* expr, std::string env_key, InterpValue value) {
+    memo_.emplace(std::make_pair(expr, std::move(env_key)), std::move(value));
+  }
+
+  int64_t size() const { return memo_.size(); }
+
+ private:
+  absl::flat_hash_map<std::pair<const Expr*, std::string>, InterpValue> memo_;
+};
+
+// Records the (derived) TypeInfo produced by typechecking a parametric
+// function body under a particular set of symbolic bindings.
+//
+// Distinct callsites frequently instantiate the same function with the same
+// parametric environment -- heavily parameterized libraries produce thousands
+// of such repeats -- and the body typecheck result only depends on the
+// (function, bindings) pair. Later callsites reuse the recorded TypeInfo
+// instead of re-typechecking the body.
+//
+// The table is shared by all DeduceCtx instances derived (via MakeCtx) from
+// the same root context, like ConstexprMemo above.
+class InstantiationMemo {
+ public:
+  // Returns the TypeInfo recorded for typechecking "f" under "bindings", if
+  // present.
+  absl::optional<TypeInfo*> Lookup(const Function* f,
+                                   const SymbolicBindings& bindings) const {
+    auto it = memo_.find(std::make_pair(f, bindings.ToString()));
+    if (it == memo_.end()) {
+      return absl::nullopt;
+    }
+    return it->second;
+  }
+
+  void Insert(const Function* f, const SymbolicBindings& bindings,
+              TypeInfo* type_info) {
+    memo_.emplace(std::make_pair(f, bindings.ToString()), type_info);
+  }
+
+  int64_t size() const { return memo_.size(); }
+
+ private:
+  absl::flat_hash_map<std::pair<const Function*, std::string>, TypeInfo*>
+      memo_;
+};
+
 class DeduceCtx;  // Forward decl.
 
 // Callback signature for the "top level" of the node type-deduction process.
@@ -92,9 +169,15 @@ class DeduceCtx {
   // Note that the resulting DeduceCtx has an empty fn_stack.
   std::unique_ptr<DeduceCtx> MakeCtx(TypeInfo* new_type_info,
                                      Module* new_module) const {
-    return std::make_unique<DeduceCtx>(new_type_info, new_module,
-                                       deduce_function_, typecheck_function_,
-                                       typecheck_module_, import_data_);
+    auto ctx = std::make_unique<DeduceCtx>(new_type_info, new_module,
+                                           deduce_function_,
+                                           typecheck_function_,
+                                           typecheck_module_, import_data_);
+    // Derived contexts share the memo tables so results computed for one
+    // parametric instantiation are visible to the others.
+    ctx->constexpr_memo_ = constexpr_memo_;
+    ctx->instantiation_memo_ = instantiation_memo_;
+    return ctx;
   }
 
   // Helper that calls back to the top-level deduce procedure for the given
@@ -149,6 +232,11 @@ class DeduceCtx {
     return import_data_->type_info_owner();
   }
 
+  ConstexprMemo* constexpr_memo() const { return constexpr_memo_.get(); }
+  InstantiationMemo* instantiation_memo() const {
+    return instantiation_memo_.get();
+  }
+
  private:
   // Maps AST nodes to their deduced types.
   TypeInfo* type_info_ = nullptr;
@@ -170,6 +258,15 @@ class DeduceCtx {
   // Cache used for imported modules, may be nullptr.
   ImportData* import_data_;
 
+  // Constexpr evaluation results, shared with contexts created via MakeCtx().
+  std::shared_ptr<ConstexprMemo> constexpr_memo_ =
+      std::make_shared<ConstexprMemo>();
+
+  // Parametric instantiation typecheck results, shared with contexts created
+  // via MakeCtx().
+  std::shared_ptr<InstantiationMemo> instantiation_memo_ =
+      std::make_shared<InstantiationMemo>();
+
   // -- Metadata
 
   // Keeps track of the function we're currently typechecking and the symbolic
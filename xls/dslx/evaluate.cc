@@ -910,7 +910,12 @@ absl::StatusOr<InterpValue> EvaluateBinop(Binop* expr, InterpBindings* bindings,
   XLS_VLOG(6) << "EvaluateBinop: " << expr->ToString() << " @ " << expr->span();
   XLS_ASSIGN_OR_RETURN(InterpValue lhs, interp->Eval(expr->lhs(), bindings));
   XLS_ASSIGN_OR_RETURN(InterpValue rhs, interp->Eval(expr->rhs(), bindings));
+  return EvaluateBinopValues(expr, lhs, rhs);
+}
 
+absl::StatusOr<InterpValue> EvaluateBinopValues(Binop* expr,
+                                                const InterpValue& lhs,
+                                                const InterpValue& rhs) {
   // Check some preconditions; e.g. all logical operands are guaranteed to have
   // single-bit inputs by type checking so we can share the implementation with
   // bitwise or/and.
@@ -186,6 +186,14 @@ absl::StatusOr<InterpValue> EvaluateBinop(Binop* expr, InterpBindings* bindings,
                                           ConcreteType* type_context,
                                           AbstractInterpreter* interp);
 
+// Evaluates a (non-shift) binary operation whose operands have already been
+// evaluated to "lhs" and "rhs". Exposed separately so that symbolic evaluation
+// -- which needs the operand values to build its expression tree -- can
+// evaluate each operand subtree exactly once.
+absl::StatusOr<InterpValue> EvaluateBinopValues(Binop* expr,
+                                                const InterpValue& lhs,
+                                                const InterpValue& rhs);
+
 // Evaluates a ternary expression; e.g. `foo if bar else baz`.
 absl::StatusOr<InterpValue> EvaluateTernary(Ternary* expr,
                                             InterpBindings* bindings,
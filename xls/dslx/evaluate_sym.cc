@@ -154,10 +154,13 @@ absl::StatusOr<InterpValue> EvaluateSymBinop(Binop* expr,
     return EvaluateSymShift(expr, bindings, type_context, interp);
   }
 
-  XLS_ASSIGN_OR_RETURN(InterpValue result,
-                       EvaluateBinop(expr, bindings, type_context, interp));
+  // Evaluate each operand subtree exactly once and compute the result from
+  // the values. Evaluating the operands again after EvaluateBinop (which
+  // evaluates them internally) makes symbolic evaluation of nested binary
+  // operations exponential in the expression depth.
   XLS_ASSIGN_OR_RETURN(InterpValue lhs, interp->Eval(expr->lhs(), bindings));
   XLS_ASSIGN_OR_RETURN(InterpValue rhs, interp->Eval(expr->rhs(), bindings));
+  XLS_ASSIGN_OR_RETURN(InterpValue result, EvaluateBinopValues(expr, lhs, rhs));
 
   if (lhs.sym() == nullptr || rhs.sym() == nullptr)
     return absl::InternalError(
@@ -0,0 +1,107 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/function_ir_cache.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/logging/logging.h"
+
+namespace xls::dslx {
+namespace {
+
+// Stable 64-bit FNV-1a hash. Fingerprints name on-disk entries that must be
+// found again by later processes, so a per-process-seeded hash such as
+// absl::Hash cannot be used.
+uint64_t StableHash(absl::string_view data,
+                    uint64_t hash = 0xcbf29ce484222325ULL) {
+  for (char c : data) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+}  // namespace
+
+FunctionIrCache::FunctionIrCache(std::filesystem::path cache_dir)
+    : cache_dir_(std::move(cache_dir)) {
+  absl::Status status = RecursivelyCreateDir(cache_dir_);
+  if (!status.ok()) {
+    XLS_LOG(WARNING) << "Unable to create function IR cache directory "
+                     << cache_dir_ << ": " << status;
+  }
+}
+
+/* static */ std::string FunctionIrCache::Fingerprint(
+    const ConversionRecord& record, absl::string_view config,
+    absl::Span<const std::string> callee_fingerprints) {
+  std::vector<std::string> parts = {
+      record.module()->name(),
+      record.f()->ToString(),
+      record.symbolic_bindings().ToString(),
+      std::string(config),
+  };
+  for (const std::string& callee_fingerprint : callee_fingerprints) {
+    parts.push_back(callee_fingerprint);
+  }
+  // Length-prefix each part so concatenation boundaries cannot alias.
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const std::string& part : parts) {
+    hash = StableHash(absl::StrCat(part.size(), ":"), hash);
+    hash = StableHash(part, hash);
+  }
+  return absl::StrFormat("xls-dslx-fn-%016x", hash);
+}
+
+absl::optional<std::string> FunctionIrCache::Lookup(
+    absl::string_view fingerprint) const {
+  absl::StatusOr<std::string> contents = GetFileContents(EntryPath(fingerprint));
+  if (!contents.ok()) {
+    return absl::nullopt;
+  }
+  XLS_VLOG(2) << "Function IR cache hit for " << fingerprint;
+  return *std::move(contents);
+}
+
+absl::Status FunctionIrCache::Store(absl::string_view fingerprint,
+                                    absl::string_view ir_text) const {
+  return SetFileContents(EntryPath(fingerprint), ir_text);
+}
+
+std::filesystem::path FunctionIrCache::EntryPath(
+    absl::string_view fingerprint) const {
+  return cache_dir_ / absl::StrCat(fingerprint, ".ir");
+}
+
+std::vector<std::string> SplitIrFunctions(absl::string_view ir_text) {
+  std::vector<std::string> functions;
+  for (absl::string_view line : absl::StrSplit(ir_text, '\n')) {
+    if (absl::StartsWith(line, "fn ")) {
+      functions.emplace_back();
+    }
+    if (!functions.empty()) {
+      absl::StrAppend(&functions.back(), line, "\n");
+    }
+  }
+  return functions;
+}
+
+}  // namespace xls::dslx
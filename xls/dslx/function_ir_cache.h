@@ -0,0 +1,79 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_FUNCTION_IR_CACHE_H_
+#define XLS_DSLX_FUNCTION_IR_CACHE_H_
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "xls/dslx/extract_conversion_order.h"
+
+namespace xls::dslx {
+
+// Persistent per-function cache enabling incremental DSLX-to-IR conversion.
+//
+// Each conversion record (a function instance in the conversion order) is
+// fingerprinted from its AST text, its symbolic bindings, the conversion
+// configuration, and the fingerprints of its callees -- so editing a function
+// dirties exactly that function and its transitive callers, while the rest of
+// the conversion order reloads previously converted IR text instead of being
+// reconverted.
+//
+// Entries are never evicted; the caller owns the lifetime of the cache
+// directory.
+class FunctionIrCache {
+ public:
+  // Creates a cache rooted at "cache_dir". The directory is created if it
+  // does not already exist.
+  explicit FunctionIrCache(std::filesystem::path cache_dir);
+
+  // Computes the fingerprint for converting "record". "config" should fold in
+  // every conversion option that affects the emitted IR;
+  // "callee_fingerprints" are the fingerprints of the record's callees (in
+  // record.callees() order), which transitively incorporate the callees' own
+  // definitions.
+  static std::string Fingerprint(
+      const ConversionRecord& record, absl::string_view config,
+      absl::Span<const std::string> callee_fingerprints);
+
+  // Returns the IR text previously stored for "fingerprint" (one or more IR
+  // function definitions in creation order), or nullopt if not present.
+  absl::optional<std::string> Lookup(absl::string_view fingerprint) const;
+
+  // Stores "ir_text" for "fingerprint" on disk.
+  absl::Status Store(absl::string_view fingerprint,
+                     absl::string_view ir_text) const;
+
+ private:
+  std::filesystem::path EntryPath(absl::string_view fingerprint) const;
+
+  std::filesystem::path cache_dir_;
+};
+
+// Splits concatenated IR function definitions (as emitted by
+// Function::DumpIr(), one per cache entry line group) back into the
+// individual definitions, preserving order. Definitions are recognized by a
+// "fn " prefix at the start of a line; body lines are indented so they never
+// match.
+std::vector<std::string> SplitIrFunctions(absl::string_view ir_text);
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_FUNCTION_IR_CACHE_H_
@@ -0,0 +1,102 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/function_ir_cache.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/dslx/ir_converter.h"
+#include "xls/dslx/parse_and_typecheck.h"
+
+namespace xls::dslx {
+namespace {
+
+TEST(FunctionIrCacheTest, SplitIrFunctions) {
+  constexpr absl::string_view kIrText = R"(fn first(x: bits[32]) -> bits[32] {
+  ret x: bits[32] = param(name=x)
+}
+
+fn second(y: bits[8]) -> bits[8] {
+  ret y: bits[8] = param(name=y)
+}
+)";
+  std::vector<std::string> functions = SplitIrFunctions(kIrText);
+  ASSERT_EQ(functions.size(), 2);
+  EXPECT_THAT(functions[0], testing::HasSubstr("fn first"));
+  EXPECT_THAT(functions[1], testing::HasSubstr("fn second"));
+}
+
+TEST(FunctionIrCacheTest, FingerprintSensitivity) {
+  constexpr absl::string_view kProgram = R"(
+fn main(x: u32) -> u32 { x + u32:1 }
+)";
+  auto import_data = ImportData::CreateForTest();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypecheckedModule tm,
+      ParseAndTypecheck(kProgram, "test_module.x", "test_module",
+                        &import_data));
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<ConversionRecord> order,
+                           GetOrder(tm.module, tm.type_info));
+  ASSERT_EQ(order.size(), 1);
+
+  std::string fingerprint = FunctionIrCache::Fingerprint(
+      order[0], /*config=*/"config", /*callee_fingerprints=*/{});
+  // Stable for identical inputs.
+  EXPECT_EQ(fingerprint,
+            FunctionIrCache::Fingerprint(order[0], "config",
+                                         /*callee_fingerprints=*/{}));
+  // Sensitive to the configuration and to callee fingerprints.
+  EXPECT_NE(fingerprint,
+            FunctionIrCache::Fingerprint(order[0], "other",
+                                         /*callee_fingerprints=*/{}));
+  std::vector<std::string> callee_fingerprints = {"xls-dslx-fn-abc"};
+  EXPECT_NE(fingerprint, FunctionIrCache::Fingerprint(order[0], "config",
+                                                      callee_fingerprints));
+}
+
+TEST(FunctionIrCacheTest, IncrementalConversionRoundTrip) {
+  constexpr absl::string_view kProgram = R"(
+fn callee(x: u32) -> u32 { x + u32:1 }
+fn main(x: u32) -> u32 { callee(x) + callee(x) }
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  FunctionIrCache cache(tempdir.path() / "cache");
+  ConvertOptions options;
+  options.function_cache = &cache;
+
+  // First conversion populates the cache.
+  auto import_data = ImportData::CreateForTest();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypecheckedModule tm,
+      ParseAndTypecheck(kProgram, "test_module.x", "test_module",
+                        &import_data));
+  XLS_ASSERT_OK_AND_ASSIGN(std::string first,
+                           ConvertModule(tm.module, &import_data, options));
+
+  // The second conversion reloads both functions from the cache; the emitted
+  // package must be identical to a from-scratch conversion.
+  auto import_data2 = ImportData::CreateForTest();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TypecheckedModule tm2,
+      ParseAndTypecheck(kProgram, "test_module.x", "test_module",
+                        &import_data2));
+  XLS_ASSERT_OK_AND_ASSIGN(std::string second,
+                           ConvertModule(tm2.module, &import_data2, options));
+  EXPECT_EQ(first, second);
+}
+
+}  // namespace
+}  // namespace xls::dslx
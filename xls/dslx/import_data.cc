@@ -24,24 +24,54 @@ namespace xls::dslx {
   return ImportTokens(absl::StrSplit(module_name, '.'));
 }
 
+bool ImportData::Contains(const ImportTokens& target) const {
+  absl::MutexLock lock(mutex_.get());
+  return cache_.find(target) != cache_.end();
+}
+
 absl::StatusOr<const ModuleInfo*> ImportData::Get(
     const ImportTokens& subject) const {
+  absl::MutexLock lock(mutex_.get());
   auto it = cache_.find(subject);
   if (it == cache_.end()) {
     return absl::NotFoundError("Module information was not found for import " +
                                subject.ToString());
   }
-  return &it->second;
+  return it->second.get();
 }
 
 absl::StatusOr<const ModuleInfo*> ImportData::Put(const ImportTokens& subject,
                                                   ModuleInfo module_info) {
-  auto it = cache_.insert({subject, std::move(module_info)});
+  absl::MutexLock lock(mutex_.get());
+  auto it = cache_.insert(
+      {subject, std::make_unique<ModuleInfo>(std::move(module_info))});
   if (!it.second) {
     return absl::InvalidArgumentError(
         "Module is already loaded for import of " + subject.ToString());
   }
-  return &it.first->second;
+  // Releasing the mutex wakes any threads blocked in GetOrReserveForImport().
+  in_flight_imports_.erase(subject);
+  return it.first->second.get();
+}
+
+const ModuleInfo* ImportData::GetOrReserveForImport(
+    const ImportTokens& subject) {
+  absl::MutexLock lock(mutex_.get());
+  auto not_in_flight = [this, &subject]() {
+    return !in_flight_imports_.contains(subject);
+  };
+  mutex_->Await(absl::Condition(&not_in_flight));
+  auto it = cache_.find(subject);
+  if (it != cache_.end()) {
+    return it->second.get();
+  }
+  in_flight_imports_.insert(subject);
+  return nullptr;
+}
+
+void ImportData::AbandonImport(const ImportTokens& subject) {
+  absl::MutexLock lock(mutex_.get());
+  in_flight_imports_.erase(subject);
 }
 
 absl::StatusOr<TypeInfo*> ImportData::GetRootTypeInfoForNode(AstNode* node) {
@@ -54,6 +84,7 @@ absl::StatusOr<TypeInfo*> ImportData::GetRootTypeInfo(Module* module) {
 }
 
 InterpBindings& ImportData::GetOrCreateTopLevelBindings(Module* module) {
+  absl::MutexLock lock(mutex_.get());
   auto it = top_level_bindings_.find(module);
   if (it == top_level_bindings_.end()) {
     it = top_level_bindings_
@@ -66,6 +97,7 @@ InterpBindings& ImportData::GetOrCreateTopLevelBindings(Module* module) {
 
 void ImportData::SetTopLevelBindings(Module* module,
                                      std::unique_ptr<InterpBindings> tlb) {
+  absl::MutexLock lock(mutex_.get());
   auto it = top_level_bindings_.emplace(module, std::move(tlb));
   XLS_CHECK(it.second) << "Module already had top level bindings: "
                        << module->name();
@@ -18,6 +18,8 @@
 #include <filesystem>
 #include <memory>
 
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
 #include "xls/dslx/ast.h"
 #include "xls/dslx/default_dslx_stdlib_path.h"
 #include "xls/dslx/interp_bindings.h"
@@ -76,6 +78,13 @@ class ImportTokens {
 
 // Wrapper around a {subject: module_info} mapping that modules can be imported
 // into.
+//
+// The import cache and related per-module maps are internally synchronized so
+// distinct modules may be typechecked and inserted concurrently (see
+// ParseAndTypecheckInParallel in parallel_typecheck.h). Note this does not
+// make the modules or type information themselves safe for concurrent
+// mutation; concurrent importers of the same subject are serialized via
+// GetOrReserveForImport().
 class ImportData {
  public:
   static ImportData CreateForTest() {
@@ -88,20 +97,32 @@ class ImportData {
 
   ImportData(std::string stdlib_path,
              absl::Span<const std::filesystem::path> additional_search_paths)
-      : stdlib_path_(std::move(stdlib_path)),
+      : mutex_(std::make_unique<absl::Mutex>()),
+        stdlib_path_(std::move(stdlib_path)),
         additional_search_paths_(additional_search_paths) {}
 
-  bool Contains(const ImportTokens& target) const {
-    return cache_.find(target) != cache_.end();
-  }
+  bool Contains(const ImportTokens& target) const;
 
-  // Note: returned pointer is not stable across mutations.
+  // Note: returned pointer is stable across mutations (module info is
+  // heap-allocated and owned by the cache).
   absl::StatusOr<const ModuleInfo*> Get(const ImportTokens& subject) const;
 
-  // Note: returned pointer is not stable across mutations.
+  // Note: returned pointer is stable across mutations. Completes any import
+  // reservation for the subject (see GetOrReserveForImport).
   absl::StatusOr<const ModuleInfo*> Put(const ImportTokens& subject,
                                         ModuleInfo module_info);
 
+  // Returns the cached module info for the subject if present, first blocking
+  // if another thread is mid-import of the subject. Returns nullptr if the
+  // subject is uncached, in which case the import is reserved for the calling
+  // thread: the caller must complete it with Put() or release it with
+  // AbandonImport() on failure.
+  const ModuleInfo* GetOrReserveForImport(const ImportTokens& subject);
+
+  // Releases an import reservation made by GetOrReserveForImport() without
+  // inserting a module, e.g. because the import failed.
+  void AbandonImport(const ImportTokens& subject);
+
   TypeInfoOwner& type_info_owner() { return type_info_owner_; }
 
   // Helper that gets the "root" type information for the module of the given
@@ -125,12 +146,14 @@ class ImportData {
   // work-in-progress. "node" may be set as nullptr when done with the entire
   // module.
   void SetTypecheckWorkInProgress(Module* module, AstNode* node) {
+    absl::MutexLock lock(mutex_.get());
     typecheck_wip_[module] = node;
   }
 
   // Retrieves which node was noted as currently work-in-progress, getter for
   // SetTypecheckWorkInProgress() above.
   AstNode* GetTypecheckWorkInProgress(Module* module) {
+    absl::MutexLock lock(mutex_.get());
     return typecheck_wip_[module];
   }
 
@@ -140,23 +163,58 @@ class ImportData {
   // hitting a work-in-progress indicator) those completed bindings can be
   // re-used after that without any need for re-evaluation.
   bool IsTopLevelBindingsDone(Module* module) const {
+    absl::MutexLock lock(mutex_.get());
     return top_level_bindings_done_.contains(module);
   }
   void MarkTopLevelBindingsDone(Module* module) {
+    absl::MutexLock lock(mutex_.get());
     top_level_bindings_done_.insert(module);
   }
 
+  // Notes the contents of the file backing a not-yet-imported module so that
+  // importing it need not read the filesystem; see PrefetchImportedFiles() in
+  // import_routines.h.
+  void PutPrefetchedFileContents(const std::filesystem::path& path,
+                                 std::string contents) {
+    absl::MutexLock lock(mutex_.get());
+    prefetched_file_contents_.insert_or_assign(path.string(),
+                                               std::move(contents));
+  }
+
+  // Removes and returns the prefetched contents for the file at the given
+  // path, or nullopt if the file was not prefetched.
+  absl::optional<std::string> TakePrefetchedFileContents(
+      const std::filesystem::path& path) {
+    absl::MutexLock lock(mutex_.get());
+    auto it = prefetched_file_contents_.find(path.string());
+    if (it == prefetched_file_contents_.end()) {
+      return absl::nullopt;
+    }
+    std::string contents = std::move(it->second);
+    prefetched_file_contents_.erase(it);
+    return contents;
+  }
+
   const std::string& stdlib_path() const { return stdlib_path_; }
   absl::Span<const std::filesystem::path> additional_search_paths() {
     return additional_search_paths_;
   }
 
  private:
-  absl::flat_hash_map<ImportTokens, ModuleInfo> cache_;
+  // Guards the maps below. Held in a unique_ptr so ImportData remains
+  // movable (e.g. CreateForTest() returns by value); moves must not race
+  // with concurrent use.
+  mutable std::unique_ptr<absl::Mutex> mutex_;
+  absl::flat_hash_map<ImportTokens, std::unique_ptr<ModuleInfo>> cache_;
+  // Subjects currently being imported by some thread; see
+  // GetOrReserveForImport().
+  absl::flat_hash_set<ImportTokens> in_flight_imports_;
   absl::flat_hash_map<Module*, std::unique_ptr<InterpBindings>>
       top_level_bindings_;
   absl::flat_hash_set<Module*> top_level_bindings_done_;
   absl::flat_hash_map<Module*, AstNode*> typecheck_wip_;
+  // File contents loaded ahead of import by the prefetcher, keyed by path.
+  absl::flat_hash_map<std::string, std::string> prefetched_file_contents_;
   TypeInfoOwner type_info_owner_;
   std::string stdlib_path_;
   absl::Span<const std::filesystem::path> additional_search_paths_;
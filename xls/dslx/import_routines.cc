@@ -14,18 +14,24 @@
 
 #include "xls/dslx/import_routines.h"
 
+#include <algorithm>
+#include <memory>
+
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
 #include "xls/common/config/xls_config.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/file/get_runfile_path.h"
 #include "xls/common/status/ret_check.h"
+#include "xls/common/thread.h"
 #include "xls/dslx/parser.h"
 #include "xls/dslx/scanner.h"
 
 namespace xls::dslx {
 
-static absl::StatusOr<std::filesystem::path> FindExistingPath(
+absl::StatusOr<std::filesystem::path> FindExistingPath(
     const ImportTokens& subject, absl::string_view stdlib_path,
     absl::Span<const std::filesystem::path> additional_search_paths,
     const Span& import_span) {
@@ -120,32 +126,157 @@ static absl::StatusOr<std::filesystem::path> FindExistingPath(
                       GetCurrentDirectory().value(), stdlib_path));
 }
 
+absl::StatusOr<std::vector<ImportTokens>> ScanForImports(
+    absl::string_view path, absl::string_view text) {
+  Scanner scanner{std::string(path), std::string(text)};
+  std::vector<ImportTokens> imports;
+  while (!scanner.AtEof()) {
+    XLS_ASSIGN_OR_RETURN(Token tok, scanner.Pop());
+    if (!tok.IsKeyword(Keyword::kImport)) {
+      continue;
+    }
+    // Collect the dotted subject following the import keyword.
+    std::vector<std::string> pieces;
+    while (!scanner.AtEof()) {
+      XLS_ASSIGN_OR_RETURN(Token piece, scanner.Pop());
+      if (piece.kind() != TokenKind::kIdentifier) {
+        break;
+      }
+      pieces.push_back(piece.GetStringValue());
+      if (scanner.AtEof()) {
+        break;
+      }
+      XLS_ASSIGN_OR_RETURN(Token dot, scanner.Pop());
+      if (dot.kind() != TokenKind::kDot) {
+        break;
+      }
+    }
+    if (!pieces.empty()) {
+      imports.push_back(ImportTokens(std::move(pieces)));
+    }
+  }
+  return imports;
+}
+
+void PrefetchImportedFiles(absl::string_view path, absl::string_view text,
+                           ImportData* import_data, int64_t num_threads) {
+  // Seed the frontier with the imports of the root file; subjects whose files
+  // were loaded in one wave have their own imports scanned and loaded in the
+  // next.
+  std::vector<ImportTokens> frontier;
+  if (absl::StatusOr<std::vector<ImportTokens>> imports =
+          ScanForImports(path, text);
+      imports.ok()) {
+    frontier = std::move(*imports);
+  }
+
+  absl::flat_hash_set<std::string> visited;
+  while (!frontier.empty()) {
+    std::vector<ImportTokens> wave;
+    for (ImportTokens& subject : frontier) {
+      if (visited.insert(subject.ToString()).second &&
+          !import_data->Contains(subject)) {
+        wave.push_back(std::move(subject));
+      }
+    }
+    frontier.clear();
+    if (wave.empty()) {
+      break;
+    }
+
+    // Workers pull wave members from a shared cursor and load them.
+    std::vector<std::vector<ImportTokens>> discovered(wave.size());
+    absl::Mutex mutex;
+    int64_t cursor = 0;
+    auto run_worker = [&]() {
+      while (true) {
+        int64_t item;
+        {
+          absl::MutexLock lock(&mutex);
+          if (cursor == static_cast<int64_t>(wave.size())) {
+            return;
+          }
+          item = cursor++;
+        }
+        absl::StatusOr<std::filesystem::path> found_path = FindExistingPath(
+            wave[item], import_data->stdlib_path(),
+            import_data->additional_search_paths(), Span::Fake());
+        if (!found_path.ok()) {
+          continue;
+        }
+        absl::StatusOr<std::string> contents = GetFileContents(*found_path);
+        if (!contents.ok()) {
+          continue;
+        }
+        if (absl::StatusOr<std::vector<ImportTokens>> imports =
+                ScanForImports(found_path->string(), *contents);
+            imports.ok()) {
+          discovered[item] = std::move(*imports);
+        }
+        import_data->PutPrefetchedFileContents(*found_path,
+                                               std::move(*contents));
+      }
+    };
+    int64_t worker_count =
+        std::min(num_threads, static_cast<int64_t>(wave.size()));
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int64_t i = 1; i < worker_count; ++i) {
+      threads.push_back(std::make_unique<Thread>(run_worker));
+    }
+    run_worker();
+    for (std::unique_ptr<Thread>& thread : threads) {
+      thread->Join();
+    }
+
+    for (std::vector<ImportTokens>& imports : discovered) {
+      for (ImportTokens& subject : imports) {
+        frontier.push_back(std::move(subject));
+      }
+    }
+  }
+}
+
 absl::StatusOr<const ModuleInfo*> DoImport(
     const TypecheckFn& ftypecheck, const ImportTokens& subject,
     ImportData* import_data, const Span& import_span) {
   XLS_RET_CHECK(import_data != nullptr);
-  if (import_data->Contains(subject)) {
-    return import_data->Get(subject);
+  // This blocks if another thread is mid-import of the same subject, and on
+  // the nullptr return path the import is reserved for this thread.
+  if (const ModuleInfo* cached = import_data->GetOrReserveForImport(subject)) {
+    return cached;
   }
 
-  XLS_VLOG(3) << "DoImport (uncached) subject: " << subject.ToString();
+  auto import_uncached = [&]() -> absl::StatusOr<const ModuleInfo*> {
+    XLS_VLOG(3) << "DoImport (uncached) subject: " << subject.ToString();
 
-  XLS_ASSIGN_OR_RETURN(
-      std::filesystem::path found_path,
-      FindExistingPath(subject, import_data->stdlib_path(),
-                       import_data->additional_search_paths(), import_span));
-  XLS_ASSIGN_OR_RETURN(std::string contents, GetFileContents(found_path));
+    XLS_ASSIGN_OR_RETURN(
+        std::filesystem::path found_path,
+        FindExistingPath(subject, import_data->stdlib_path(),
+                         import_data->additional_search_paths(), import_span));
+    std::string contents;
+    if (absl::optional<std::string> prefetched =
+            import_data->TakePrefetchedFileContents(found_path)) {
+      contents = std::move(*prefetched);
+    } else {
+      XLS_ASSIGN_OR_RETURN(contents, GetFileContents(found_path));
+    }
 
-  absl::Span<std::string const> pieces = subject.pieces();
-  std::string fully_qualified_name = absl::StrJoin(pieces, ".");
-  XLS_VLOG(3) << "Parsing and typechecking " << fully_qualified_name
-              << ": start";
-
-  Scanner scanner(found_path, contents);
-  Parser parser(/*module_name=*/fully_qualified_name, &scanner);
-  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Module> module, parser.ParseModule());
-  XLS_ASSIGN_OR_RETURN(TypeInfo * type_info, ftypecheck(module.get()));
-  return import_data->Put(subject, ModuleInfo{std::move(module), type_info});
+    absl::Span<std::string const> pieces = subject.pieces();
+    std::string fully_qualified_name = absl::StrJoin(pieces, ".");
+    XLS_VLOG(3) << "Parsing and typechecking " << fully_qualified_name
+                << ": start";
+
+    Scanner scanner(found_path, contents);
+    Parser parser(/*module_name=*/fully_qualified_name, &scanner);
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<Module> module, parser.ParseModule());
+    XLS_ASSIGN_OR_RETURN(TypeInfo * type_info, ftypecheck(module.get()));
+    return import_data->Put(subject, ModuleInfo{std::move(module), type_info});
+  };
+  absl::StatusOr<const ModuleInfo*> result = import_uncached();
+  if (!result.ok()) {
+    import_data->AbandonImport(subject);
+  }
+  return result;
 }
 
 }  // namespace xls::dslx
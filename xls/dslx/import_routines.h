@@ -17,6 +17,7 @@
 
 #include <filesystem>
 #include <string>
+#include <vector>
 
 #include "xls/dslx/ast.h"
 #include "xls/dslx/import_data.h"
@@ -27,6 +28,35 @@ namespace xls::dslx {
 // Type-checking callback lambda.
 using TypecheckFn = std::function<absl::StatusOr<TypeInfo*>(Module*)>;
 
+// Resolves the DSLX source file for the given import subject against the
+// standard library path, the working directory, and the additional search
+// paths, in the same way DoImport() does. "import_span" is used for error
+// reporting only.
+absl::StatusOr<std::filesystem::path> FindExistingPath(
+    const ImportTokens& subject, absl::string_view stdlib_path,
+    absl::Span<const std::filesystem::path> additional_search_paths,
+    const Span& import_span);
+
+// Scans the DSLX "text" for import statements and returns the import subjects
+// found, in order of appearance. This is a token-level scan -- the text is not
+// parsed -- so it is cheap enough to run ahead of typechecking to discover the
+// import graph. "path" is used for error reporting only.
+absl::StatusOr<std::vector<ImportTokens>> ScanForImports(
+    absl::string_view path, absl::string_view text);
+
+// Loads the contents of every file in the transitive import closure of the
+// DSLX "text" (at "path") into "import_data"'s prefetched-contents cache,
+// reading up to "num_threads" files in parallel. DoImport() consumes the
+// prefetched contents instead of touching the filesystem, so running this
+// ahead of (or concurrently with) typechecking keeps cold-cache compiles from
+// serializing on file I/O latency.
+//
+// Prefetching is best effort: files that cannot be resolved, read, or scanned
+// are skipped here and the corresponding import reports the error with a
+// proper span.
+void PrefetchImportedFiles(absl::string_view path, absl::string_view text,
+                           ImportData* import_data, int64_t num_threads);
+
 // Imports the module identified (globally) by 'subject'.
 //
 // Importing means: locating, parsing, typechecking, and caching in the import
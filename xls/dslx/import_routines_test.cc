@@ -0,0 +1,65 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/import_routines.h"
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/logging/logging.h"
+
+namespace xls::dslx {
+namespace {
+
+std::vector<std::string> ScanForImportStrings(absl::string_view text) {
+  absl::StatusOr<std::vector<ImportTokens>> imports =
+      ScanForImports("test.x", text);
+  XLS_CHECK_OK(imports.status());
+  std::vector<std::string> result;
+  for (const ImportTokens& subject : *imports) {
+    result.push_back(subject.ToString());
+  }
+  return result;
+}
+
+TEST(ScanForImportsTest, SimpleAndDottedImports) {
+  EXPECT_THAT(ScanForImportStrings(R"(import std
+import xls.examples.foo
+
+fn main(x: u32) -> u32 { std::clog2(x) }
+)"),
+              ::testing::ElementsAre("std", "xls.examples.foo"));
+}
+
+TEST(ScanForImportsTest, AliasedImport) {
+  EXPECT_THAT(ScanForImportStrings("import xls.examples.foo as bar\n"),
+              ::testing::ElementsAre("xls.examples.foo"));
+}
+
+TEST(ScanForImportsTest, NoImports) {
+  EXPECT_THAT(ScanForImportStrings("fn main() -> u32 { u32:42 }\n"),
+              ::testing::IsEmpty());
+}
+
+TEST(ScanForImportsTest, ImportInCommentIsIgnored) {
+  EXPECT_THAT(ScanForImportStrings(R"(// import std
+fn main() -> u32 { u32:42 }
+)"),
+              ::testing::IsEmpty());
+}
+
+}  // namespace
+}  // namespace xls::dslx
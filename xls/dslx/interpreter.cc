@@ -341,28 +341,64 @@ absl::StatusOr<InterpValue> Interpreter::CallFnValue(
                                     symbolic_bindings);
 }
 
+absl::StatusOr<absl::optional<InterpValue>> Interpreter::TryRunBytecode(
+    Function* f, absl::Span<const InterpValue> args) {
+  auto it = bytecode_cache_.find(f);
+  if (it == bytecode_cache_.end()) {
+    absl::StatusOr<BytecodeFunction> compiled =
+        BytecodeFunction::Compile(f, current_type_info_);
+    if (compiled.ok()) {
+      it = bytecode_cache_
+               .emplace(f, std::make_shared<const BytecodeFunction>(
+                               *std::move(compiled)))
+               .first;
+    } else if (absl::IsUnimplemented(compiled.status())) {
+      XLS_VLOG(3) << "Function " << f->identifier()
+                  << " is outside the bytecode subset: " << compiled.status();
+      it = bytecode_cache_.emplace(f, nullptr).first;
+    } else {
+      return compiled.status();
+    }
+  }
+  if (it->second == nullptr) {
+    return absl::nullopt;
+  }
+  XLS_ASSIGN_OR_RETURN(InterpValue result, it->second->Execute(args));
+  return result;
+}
+
 absl::StatusOr<InterpValue> Interpreter::EvaluateAndCompareInternal(
     Function* f, absl::Span<const InterpValue> args, const Span& span,
     Invocation* invocation, const SymbolicBindings* symbolic_bindings) {
-  XLS_ASSIGN_OR_RETURN(
-      InterpValue interpreter_value,
-      run_concolic_
-          ? EvaluateSymFunction(f, args, span,
-                                symbolic_bindings == nullptr
-                                    ? SymbolicBindings()
-                                    : *symbolic_bindings,
-                                abstract_adapter_.get())
-          : EvaluateFunction(f, args, span,
-                             symbolic_bindings == nullptr ? SymbolicBindings()
-                                                          : *symbolic_bindings,
-                             abstract_adapter_.get()));
+  absl::optional<InterpValue> interpreter_value;
+  if (!run_concolic_) {
+    // Fast path: functions in the bytecode subset skip the AST tree-walk
+    // entirely. (The concolic engine needs the tree-walk's symbolic
+    // bookkeeping, so it always takes the slow path.)
+    XLS_ASSIGN_OR_RETURN(interpreter_value, TryRunBytecode(f, args));
+  }
+  if (!interpreter_value.has_value()) {
+    XLS_ASSIGN_OR_RETURN(
+        interpreter_value,
+        run_concolic_
+            ? EvaluateSymFunction(f, args, span,
+                                  symbolic_bindings == nullptr
+                                      ? SymbolicBindings()
+                                      : *symbolic_bindings,
+                                  abstract_adapter_.get())
+            : EvaluateFunction(f, args, span,
+                               symbolic_bindings == nullptr
+                                   ? SymbolicBindings()
+                                   : *symbolic_bindings,
+                               abstract_adapter_.get()));
+  }
 
   if (post_fn_eval_hook_ != nullptr) {
     XLS_RETURN_IF_ERROR(
-        post_fn_eval_hook_(f, args, symbolic_bindings, interpreter_value));
+        post_fn_eval_hook_(f, args, symbolic_bindings, *interpreter_value));
   }
 
-  return interpreter_value;
+  return *interpreter_value;
 }
 
 absl::StatusOr<InterpValue> Interpreter::EvaluateFormatMacro(
@@ -17,6 +17,7 @@
 
 #include "xls/dslx/abstract_interpreter.h"
 #include "xls/dslx/ast.h"
+#include "xls/dslx/bytecode_interpreter.h"
 #include "xls/dslx/import_routines.h"
 #include "xls/dslx/interp_bindings.h"
 #include "xls/dslx/interp_value.h"
@@ -202,6 +203,13 @@ class Interpreter {
       Invocation* invocation, const SymbolicBindings* symbolic_bindings);
 
   // Calls function values, either a builtin or user defined function.
+  // Attempts to evaluate "f" on the bytecode fast tier: compiles it on first
+  // use (caching the result per function) and executes the compiled form.
+  // Returns nullopt if "f" uses features outside the bytecode subset, in
+  // which case the caller falls back to the AST tree-walking evaluator.
+  absl::StatusOr<absl::optional<InterpValue>> TryRunBytecode(
+      Function* f, absl::Span<const InterpValue> args);
+
   absl::StatusOr<InterpValue> CallFnValue(
       const InterpValue& fv, absl::Span<InterpValue const> args,
       const Span& span, Invocation* invocation,
@@ -258,6 +266,12 @@ class Interpreter {
 
   std::unique_ptr<AbstractInterpreter> abstract_adapter_;
 
+  // Compiled-bytecode cache for TryRunBytecode(); a nullptr entry records
+  // that the function was tried and does not compile (outside the bytecode
+  // subset) so we don't re-attempt compilation on every invocation.
+  absl::flat_hash_map<Function*, std::shared_ptr<const BytecodeFunction>>
+      bytecode_cache_;
+
   // Tracking for incomplete module evaluation status; e.g. on recursive calls
   // during module import; see IsWip().
   absl::flat_hash_map<AstNode*, absl::optional<InterpValue>> wip_;
@@ -42,6 +42,9 @@ ABSL_FLAG(
 // TODO(leary): 2021-01-19 allow filters with wildcards.
 ABSL_FLAG(std::string, test_filter, "",
           "Target (currently *single*) test name to run.");
+ABSL_FLAG(int64_t, test_parallelism, 1,
+          "Number of threads used to execute the unit tests in the module; "
+          "1 runs the tests serially.");
 
 namespace xls::dslx {
 namespace {
@@ -62,7 +65,8 @@ absl::Status RealMain(absl::string_view entry_module_path,
                       bool run_concolic,
                       FormatPreference trace_format_preference,
                       CompareFlag compare_flag, bool execute,
-                      absl::optional<int64_t> seed, bool* printed_error) {
+                      absl::optional<int64_t> seed, int64_t test_parallelism,
+                      bool* printed_error) {
   XLS_ASSIGN_OR_RETURN(std::string program, GetFileContents(entry_module_path));
   XLS_ASSIGN_OR_RETURN(std::string module_name, PathToName(entry_module_path));
   absl::optional<RunComparator> run_comparator;
@@ -85,6 +89,7 @@ absl::Status RealMain(absl::string_view entry_module_path,
       .run_comparator = run_comparator ? &run_comparator.value() : nullptr,
       .execute = execute,
       .seed = seed,
+      .test_parallelism = test_parallelism,
   };
   XLS_ASSIGN_OR_RETURN(
       TestResult test_result,
@@ -148,10 +153,15 @@ int main(int argc, char* argv[]) {
   XLS_QCHECK_OK(preference.status())
       << "-trace_format_preference accepts default|binary|hex|decimal";
 
+  int64_t test_parallelism = absl::GetFlag(FLAGS_test_parallelism);
+  XLS_QCHECK_GT(test_parallelism, 0)
+      << "-test_parallelism must be a positive thread count";
+
   bool printed_error = false;
   absl::Status status = xls::dslx::RealMain(
       args[0], dslx_paths, test_filter, trace_all, run_concolic,
-      preference.value(), compare_flag, execute, seed, &printed_error);
+      preference.value(), compare_flag, execute, seed, test_parallelism,
+      &printed_error);
   if (printed_error) {
     return EXIT_FAILURE;
   }
@@ -32,6 +32,7 @@
 #include "xls/dslx/builtins_metadata.h"
 #include "xls/dslx/deduce_ctx.h"
 #include "xls/dslx/extract_conversion_order.h"
+#include "xls/dslx/function_ir_cache.h"
 #include "xls/dslx/interpreter.h"
 #include "xls/dslx/ir_conversion_utils.h"
 #include "xls/dslx/mangle.h"
@@ -40,6 +41,7 @@
 #include "xls/dslx/typecheck.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/function.h"
+#include "xls/ir/ir_parser.h"
 #include "xls/ir/lsb_or_msb.h"
 
 namespace xls::dslx {
@@ -3188,11 +3190,90 @@ static absl::Status ConvertCallGraph(absl::Span<const ConversionRecord> order,
   // ConvertOneFunctionInternal().
   absl::flat_hash_map<ProcId, std::vector<ProcConfigValue>> proc_id_to_args;
   absl::flat_hash_map<ProcId, MemberNameToValue> proc_id_to_members;
+
+  // Fingerprints of already-processed records when incremental conversion is
+  // enabled; keyed by (function, symbolic bindings) so callee fingerprints
+  // fold into their callers'.
+  absl::flat_hash_map<std::pair<Function*, std::string>, std::string>
+      record_fingerprints;
+  const std::string cache_config =
+      options.function_cache == nullptr
+          ? std::string()
+          : absl::StrFormat("positions=%d,fail-as-assert=%d",
+                            options.emit_positions,
+                            options.emit_fail_as_assert);
+
   for (const ConversionRecord& record : order) {
+    // Fingerprint the record if it is cacheable: a normal function (procs
+    // have channel side effects and implicit-token functions participate in
+    // entry wrapping) whose callees all have known fingerprints.
+    absl::optional<std::string> fingerprint;
+    if (options.function_cache != nullptr && !record.proc_id().has_value() &&
+        record.f()->tag() == Function::Tag::kNormal &&
+        !GetRequiresImplicitToken(record.f(), import_data, options)) {
+      std::vector<std::string> callee_fingerprints;
+      bool callees_known = true;
+      for (const Callee& callee : record.callees()) {
+        auto it = record_fingerprints.find(
+            std::make_pair(callee.f(), callee.sym_bindings().ToString()));
+        if (it == record_fingerprints.end()) {
+          callees_known = false;
+          break;
+        }
+        callee_fingerprints.push_back(it->second);
+      }
+      if (callees_known) {
+        fingerprint = FunctionIrCache::Fingerprint(record, cache_config,
+                                                   callee_fingerprints);
+      }
+    }
+
+    if (fingerprint.has_value()) {
+      if (absl::optional<std::string> cached =
+              options.function_cache->Lookup(fingerprint.value())) {
+        XLS_VLOG(3) << "Reusing cached IR for: " << record.ToString();
+        xls::Function* last_parsed = nullptr;
+        for (const std::string& fn_text : SplitIrFunctions(cached.value())) {
+          XLS_ASSIGN_OR_RETURN(
+              last_parsed,
+              xls::Parser::ParseFunction(fn_text, package_data.package));
+        }
+        // The record's own function is emitted after any helpers (e.g.
+        // for-loop bodies), so the last definition is the one to map back.
+        if (last_parsed != nullptr) {
+          package_data.ir_to_dslx[last_parsed] = record.f();
+        }
+        record_fingerprints.emplace(
+            std::make_pair(record.f(), record.symbolic_bindings().ToString()),
+            *std::move(fingerprint));
+        continue;
+      }
+    }
+
     XLS_VLOG(3) << "Converting to IR: " << record.ToString();
+    int64_t functions_before = package_data.package->functions().size();
     XLS_RETURN_IF_ERROR(ConvertOneFunctionInternal(
         package_data, record, import_data, &proc_id_to_args,
         &proc_id_to_members, options));
+
+    if (fingerprint.has_value()) {
+      std::string ir_text;
+      for (int64_t i = functions_before;
+           i < static_cast<int64_t>(package_data.package->functions().size());
+           ++i) {
+        absl::StrAppend(&ir_text, package_data.package->functions()[i]->DumpIr(),
+                        "\n");
+      }
+      absl::Status store_status =
+          options.function_cache->Store(fingerprint.value(), ir_text);
+      if (!store_status.ok()) {
+        XLS_LOG(WARNING) << "Unable to store function IR cache entry: "
+                         << store_status;
+      }
+      record_fingerprints.emplace(
+          std::make_pair(record.f(), record.symbolic_bindings().ToString()),
+          *std::move(fingerprint));
+    }
   }
 
   XLS_VLOG(3) << "Verifying converted package";
@@ -28,6 +28,8 @@
 
 namespace xls::dslx {
 
+class FunctionIrCache;
+
 // Bundles together options (common among the API routines below) used in
 // DSLX-to-IR conversion.
 struct ConvertOptions {
@@ -42,6 +44,12 @@ struct ConvertOptions {
 
   // Should the generated IR be verified?
   bool verify_ir = true;
+
+  // Optional (not owned) per-function cache enabling incremental conversion:
+  // functions whose fingerprint (AST text, symbolic bindings, callee
+  // fingerprints) matches a previous conversion are reloaded from the cache
+  // instead of reconverted. See FunctionIrCache in function_ir_cache.h.
+  FunctionIrCache* function_cache = nullptr;
 };
 
 // Converts the contents of a module to IR form.
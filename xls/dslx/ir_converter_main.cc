@@ -20,6 +20,8 @@
 #include "xls/common/file/filesystem.h"
 #include "xls/common/init_xls.h"
 #include "xls/dslx/command_line_utils.h"
+#include "xls/dslx/conversion_cache.h"
+#include "xls/dslx/function_ir_cache.h"
 #include "xls/dslx/default_dslx_stdlib_path.h"
 #include "xls/dslx/error_printer.h"
 #include "xls/dslx/ir_converter.h"
@@ -44,6 +46,17 @@ ABSL_FLAG(bool, emit_fail_as_assert, true,
           "Feature flag for emitting fail!() in the DSL as an assert IR op.");
 ABSL_FLAG(bool, verify, true,
           "If true, verifies the generated IR for correctness.");
+ABSL_FLAG(std::string, conversion_cache_dir, "",
+          "If set, directory in which converted IR is cached, keyed by a "
+          "hash of the input files' transitive import closure and the "
+          "conversion options. Repeated invocations with byte-identical "
+          "inputs then print cached IR instead of re-parsing, "
+          "re-typechecking, and re-converting.");
+ABSL_FLAG(std::string, function_ir_cache_dir, "",
+          "If set, directory in which per-function converted IR is cached. "
+          "Functions whose definition (and transitive callees) are unchanged "
+          "since a previous run are reloaded from the cache, so an edit only "
+          "reconverts the dirty subtree of the conversion order.");
 
 namespace xls::dslx {
 namespace {
@@ -143,17 +156,62 @@ absl::Status RealMain(absl::Span<const absl::string_view> paths,
            "input path to know where to resolve the entry function)";
   }
 
+  absl::optional<FunctionIrCache> function_cache;
+  if (!absl::GetFlag(FLAGS_function_ir_cache_dir).empty()) {
+    function_cache.emplace(absl::GetFlag(FLAGS_function_ir_cache_dir));
+  }
+
   const ConvertOptions convert_options = {
       .emit_positions = true,
       .emit_fail_as_assert = emit_fail_as_assert,
       .verify_ir = verify_ir,
+      .function_cache =
+          function_cache.has_value() ? &function_cache.value() : nullptr,
   };
+
+  // When a conversion cache is configured and the key is computable (all
+  // imports resolve during a parse-only scan), identical inputs reuse the IR
+  // of a previous run. Key computation failures fall through to normal
+  // conversion, which reports the underlying problem properly.
+  absl::optional<ConversionCache> cache;
+  absl::optional<std::string> cache_key;
+  if (!absl::GetFlag(FLAGS_conversion_cache_dir).empty()) {
+    cache.emplace(absl::GetFlag(FLAGS_conversion_cache_dir));
+    std::vector<std::filesystem::path> fs_paths(paths.begin(), paths.end());
+    std::string config = absl::StrJoin(
+        {std::string(entry.value_or("")), std::string(package_name.value_or("")),
+         std::string(emit_fail_as_assert ? "fail-as-assert" : ""),
+         std::string(verify_ir ? "verify" : "")},
+        "\n");
+    absl::StatusOr<std::string> key = ConversionCache::MakeCacheKey(
+        fs_paths, stdlib_path, dslx_paths, config);
+    if (key.ok()) {
+      cache_key = *std::move(key);
+      if (absl::optional<std::string> hit = cache->Lookup(*cache_key)) {
+        std::cout << *hit;
+        return absl::OkStatus();
+      }
+    } else {
+      XLS_VLOG(1) << "Could not compute conversion cache key: "
+                  << key.status();
+    }
+  }
+
   for (absl::string_view path : paths) {
     XLS_RETURN_IF_ERROR(AddPathToPackage(path, entry, convert_options,
                                          stdlib_path, dslx_paths,
                                          &package.value(), printed_error));
   }
-  std::cout << package->DumpIr();
+  std::string ir_text = package->DumpIr();
+  std::cout << ir_text;
+  if (cache.has_value() && cache_key.has_value()) {
+    absl::Status store_status = cache->Store(*cache_key, ir_text);
+    if (!store_status.ok()) {
+      // A write failure only costs a reconversion on the next run.
+      XLS_LOG(WARNING) << "Unable to write conversion cache entry: "
+                       << store_status;
+    }
+  }
 
   return absl::OkStatus();
 }
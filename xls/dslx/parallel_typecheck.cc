@@ -0,0 +1,164 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/parallel_typecheck.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
+#include "xls/dslx/parser.h"
+#include "xls/dslx/scanner.h"
+
+namespace xls::dslx {
+namespace {
+
+// Returns, for each path, the indices of the other input paths it imports
+// (directly), determined by a parse-only pass over each file. Imports of
+// modules outside the input set (e.g. the standard library) are resolved on
+// demand during typechecking and do not appear here.
+absl::StatusOr<std::vector<std::vector<int64_t>>> BuildDependencyEdges(
+    absl::Span<const std::filesystem::path> paths,
+    absl::Span<const std::string> texts) {
+  absl::flat_hash_map<std::string, int64_t> stem_to_index;
+  for (int64_t i = 0; i < static_cast<int64_t>(paths.size()); ++i) {
+    stem_to_index[paths[i].stem().string()] = i;
+  }
+  std::vector<std::vector<int64_t>> edges(paths.size());
+  for (int64_t i = 0; i < static_cast<int64_t>(paths.size()); ++i) {
+    Scanner scanner(std::string(paths[i]), texts[i]);
+    Parser parser(/*module_name=*/paths[i].stem().string(), &scanner);
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<Module> module, parser.ParseModule());
+    for (const auto& [name, import] : module->GetImportByName()) {
+      // The trailing piece of the import subject is the imported module's
+      // file stem.
+      auto it = stem_to_index.find(import->subject().back());
+      if (it != stem_to_index.end() && it->second != i) {
+        edges[i].push_back(it->second);
+      }
+    }
+  }
+  return edges;
+}
+
+// Partitions the path indices into topological waves: every dependency of a
+// wave member lies in an earlier wave. Returns an error on a dependency
+// cycle among the input files.
+absl::StatusOr<std::vector<std::vector<int64_t>>> BuildWaves(
+    absl::Span<const std::vector<int64_t>> edges) {
+  std::vector<int64_t> wave_of(edges.size(), -1);
+  std::vector<std::vector<int64_t>> waves;
+  int64_t placed = 0;
+  while (placed < static_cast<int64_t>(edges.size())) {
+    std::vector<int64_t> wave;
+    for (int64_t i = 0; i < static_cast<int64_t>(edges.size()); ++i) {
+      if (wave_of[i] != -1) {
+        continue;
+      }
+      bool ready = std::all_of(
+          edges[i].begin(), edges[i].end(),
+          [&](int64_t dep) { return wave_of[dep] != -1; });
+      if (ready) {
+        wave.push_back(i);
+      }
+    }
+    if (wave.empty()) {
+      return absl::InvalidArgumentError(
+          "Cycle detected among import dependencies of the given modules.");
+    }
+    for (int64_t i : wave) {
+      wave_of[i] = waves.size();
+    }
+    placed += wave.size();
+    waves.push_back(std::move(wave));
+  }
+  return waves;
+}
+
+}  // namespace
+
+absl::StatusOr<std::vector<TypecheckedModule>> ParseAndTypecheckInParallel(
+    absl::Span<const std::filesystem::path> paths, ImportData* import_data,
+    int64_t num_threads) {
+  XLS_RET_CHECK(import_data != nullptr);
+  XLS_RET_CHECK_GT(num_threads, 0);
+
+  std::vector<std::string> texts;
+  texts.reserve(paths.size());
+  for (const std::filesystem::path& path : paths) {
+    XLS_ASSIGN_OR_RETURN(std::string text, GetFileContents(path));
+    texts.push_back(std::move(text));
+  }
+
+  XLS_ASSIGN_OR_RETURN(std::vector<std::vector<int64_t>> edges,
+                       BuildDependencyEdges(paths, texts));
+  XLS_ASSIGN_OR_RETURN(std::vector<std::vector<int64_t>> waves,
+                       BuildWaves(edges));
+
+  std::vector<TypecheckedModule> results(paths.size());
+  std::vector<absl::Status> statuses(paths.size(), absl::OkStatus());
+
+  for (const std::vector<int64_t>& wave : waves) {
+    // Workers pull path indices of the current wave from a shared cursor.
+    absl::Mutex mutex;
+    int64_t cursor = 0;
+    auto run_worker = [&]() {
+      while (true) {
+        int64_t item;
+        {
+          absl::MutexLock lock(&mutex);
+          if (cursor == static_cast<int64_t>(wave.size())) {
+            return;
+          }
+          item = wave[cursor++];
+        }
+        absl::StatusOr<TypecheckedModule> result = ParseAndTypecheck(
+            texts[item], std::string(paths[item]),
+            paths[item].stem().string(), import_data);
+        if (result.ok()) {
+          results[item] = std::move(result).value();
+        } else {
+          statuses[item] = result.status();
+        }
+      }
+    };
+
+    int64_t worker_count =
+        std::min(num_threads, static_cast<int64_t>(wave.size()));
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int64_t i = 1; i < worker_count; ++i) {
+      threads.push_back(std::make_unique<Thread>(run_worker));
+    }
+    run_worker();
+    for (auto& thread : threads) {
+      thread->Join();
+    }
+
+    // Report the first error in "paths" order before starting dependents.
+    for (const absl::Status& status : statuses) {
+      XLS_RETURN_IF_ERROR(status);
+    }
+  }
+
+  return results;
+}
+
+}  // namespace xls::dslx
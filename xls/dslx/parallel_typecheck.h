@@ -0,0 +1,47 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_DSLX_PARALLEL_TYPECHECK_H_
+#define XLS_DSLX_PARALLEL_TYPECHECK_H_
+
+#include <filesystem>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/dslx/import_data.h"
+#include "xls/dslx/parse_and_typecheck.h"
+
+namespace xls::dslx {
+
+// Parses and typechecks the given module files on a pool of "num_threads"
+// worker threads, returning the typechecked modules in the same order as
+// "paths". Module names are derived from the file stems.
+//
+// All modules share "import_data", whose caches are safe for concurrent
+// insertion of distinct modules; concurrent imports of the same subject
+// (e.g. two workers both importing std) are serialized inside DoImport, with
+// the second worker reusing the first's result. Files are scheduled so that
+// any input file imported by another input file is typechecked first, which
+// keeps workers from blocking on each other's imports; correctness does not
+// depend on the schedule.
+//
+// On any failure the first error in "paths" order is returned.
+absl::StatusOr<std::vector<TypecheckedModule>> ParseAndTypecheckInParallel(
+    absl::Span<const std::filesystem::path> paths, ImportData* import_data,
+    int64_t num_threads);
+
+}  // namespace xls::dslx
+
+#endif  // XLS_DSLX_PARALLEL_TYPECHECK_H_
@@ -0,0 +1,76 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/dslx/parallel_typecheck.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/dslx/import_data.h"
+
+namespace xls::dslx {
+namespace {
+
+TEST(ParallelTypecheckTest, IndependentAndDependentModules) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+
+  // "mid" imports "leaf"; "other" is independent of both. The import subject
+  // resolves to leaf.x under the temp directory via the additional search
+  // paths (the parent component of the subject is stripped during lookup).
+  const std::filesystem::path leaf_path = tempdir.path() / "leaf.x";
+  const std::filesystem::path mid_path = tempdir.path() / "mid.x";
+  const std::filesystem::path other_path = tempdir.path() / "other.x";
+  XLS_ASSERT_OK(SetFileContents(leaf_path, R"(
+pub fn double(x: u32) -> u32 { x + x }
+)"));
+  XLS_ASSERT_OK(SetFileContents(mid_path, R"(
+import test.leaf as leaf
+fn quad(x: u32) -> u32 { leaf::double(leaf::double(x)) }
+)"));
+  XLS_ASSERT_OK(SetFileContents(other_path, R"(
+fn inc(x: u32) -> u32 { x + u32:1 }
+)"));
+
+  std::vector<std::filesystem::path> search_paths = {tempdir.path()};
+  ImportData import_data(kDefaultDslxStdlibPath, search_paths);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<TypecheckedModule> modules,
+      ParseAndTypecheckInParallel({leaf_path, mid_path, other_path},
+                                  &import_data, /*num_threads=*/4));
+  ASSERT_EQ(modules.size(), 3);
+  EXPECT_EQ(modules[0].module->name(), "leaf");
+  EXPECT_EQ(modules[1].module->name(), "mid");
+  EXPECT_EQ(modules[2].module->name(), "other");
+  for (const TypecheckedModule& tm : modules) {
+    EXPECT_NE(tm.type_info, nullptr);
+  }
+}
+
+TEST(ParallelTypecheckTest, TypeErrorIsReported) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory tempdir, TempDirectory::Create());
+  const std::filesystem::path bad_path = tempdir.path() / "bad.x";
+  XLS_ASSERT_OK(SetFileContents(bad_path, R"(
+fn broken(x: u32) -> u8 { x }
+)"));
+
+  ImportData import_data = ImportData::CreateForTest();
+  EXPECT_FALSE(
+      ParseAndTypecheckInParallel({bad_path}, &import_data, /*num_threads=*/2)
+          .ok());
+}
+
+}  // namespace
+}  // namespace xls::dslx
@@ -14,15 +14,30 @@
 
 #include "xls/dslx/parse_and_typecheck.h"
 
+#include "xls/common/thread.h"
 #include "xls/dslx/parser.h"
 #include "xls/dslx/scanner.h"
 #include "xls/dslx/typecheck.h"
 
 namespace xls::dslx {
+namespace {
+
+// Number of files the background prefetcher reads concurrently.
+constexpr int64_t kPrefetchThreads = 4;
+
+}  // namespace
 
 absl::StatusOr<TypecheckedModule> ParseAndTypecheck(
     absl::string_view text, absl::string_view path,
     absl::string_view module_name, ImportData* import_data) {
+  // Load the transitive import closure in the background while this module is
+  // parsed and typechecked; imports triggered by the typechecker then consume
+  // the prefetched contents instead of performing serialized filesystem reads.
+  // The thread joins when this scope exits (including on early error returns).
+  Thread prefetch_thread(
+      [path = std::string(path), text = std::string(text), import_data]() {
+        PrefetchImportedFiles(path, text, import_data, kPrefetchThreads);
+      });
   Scanner scanner{std::string{path}, std::string{text}};
   Parser parser(std::string{module_name}, &scanner);
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<Module> module, parser.ParseModule());
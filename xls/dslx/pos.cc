@@ -19,6 +19,12 @@
 
 namespace xls::dslx {
 
+/* static */ const std::shared_ptr<const std::string>& Pos::EmptyFilename() {
+  static const auto* empty = new std::shared_ptr<const std::string>(
+      std::make_shared<const std::string>());
+  return *empty;
+}
+
 /* static */ absl::StatusOr<Span> Span::FromString(absl::string_view s) {
   std::string filename;
   int64_t start_lineno, start_colno, limit_lineno, limit_colno;
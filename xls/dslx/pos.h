@@ -16,6 +16,7 @@
 #define XLS_DSLX_POS_H_
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #include "absl/status/statusor.h"
@@ -25,27 +26,39 @@
 namespace xls::dslx {
 
 // Represents a position in the text (file, line, column).
+//
+// The filename is held via a shared pointer so that copying positions (which
+// happens for every token and AST node span) bumps a reference count instead
+// of copying the string -- producers like the scanner create one filename
+// string per file and share it across all the positions they mint.
 class Pos {
  public:
   static absl::StatusOr<Pos> FromString(absl::string_view s);
 
-  Pos() : filename_(""), lineno_(0), colno_(0) {}
+  Pos() : filename_(EmptyFilename()), lineno_(0), colno_(0) {}
   Pos(std::string filename, int64_t lineno, int64_t colno)
+      : filename_(std::make_shared<const std::string>(std::move(filename))),
+        lineno_(lineno),
+        colno_(colno) {}
+  // Overload that shares an already-materialized filename (see class
+  // comment).
+  Pos(std::shared_ptr<const std::string> filename, int64_t lineno,
+      int64_t colno)
       : filename_(std::move(filename)), lineno_(lineno), colno_(colno) {}
 
   std::string ToString() const {
-    return absl::StrFormat("%s:%d:%d", filename_, lineno_ + 1, colno_ + 1);
+    return absl::StrFormat("%s:%d:%d", *filename_, lineno_ + 1, colno_ + 1);
   }
   std::string ToStringNoFile() const {
     return absl::StrFormat("%d:%d", lineno_ + 1, colno_ + 1);
   }
 
   std::string ToRepr() const {
-    return absl::StrFormat("Pos(\"%s\", %d, %d)", filename_, lineno_, colno_);
+    return absl::StrFormat("Pos(\"%s\", %d, %d)", *filename_, lineno_, colno_);
   }
 
   bool operator<(const Pos& other) const {
-    XLS_CHECK_EQ(filename_, other.filename_);
+    XLS_CHECK_EQ(filename(), other.filename());
     if (lineno_ < other.lineno_) {
       return true;
     }
@@ -58,7 +71,7 @@ class Pos {
     return false;
   }
   bool operator==(const Pos& other) const {
-    XLS_CHECK_EQ(filename_, other.filename_);
+    XLS_CHECK_EQ(filename(), other.filename());
     return lineno_ == other.lineno_ && colno_ == other.colno_;
   }
   bool operator!=(const Pos& other) const { return !(*this == other); }
@@ -67,14 +80,17 @@ class Pos {
   }
   bool operator>=(const Pos& other) const { return !((*this) < other); }
 
-  const std::string& filename() const { return filename_; }
+  const std::string& filename() const { return *filename_; }
   int64_t lineno() const { return lineno_; }
   int64_t colno() const { return colno_; }
 
   Pos BumpCol() const { return Pos(filename_, lineno_, colno_ + 1); }
 
  private:
-  std::string filename_;
+  // Shared empty filename used by default-constructed positions.
+  static const std::shared_ptr<const std::string>& EmptyFilename();
+
+  std::shared_ptr<const std::string> filename_;
   int64_t lineno_;
   int64_t colno_;
 };
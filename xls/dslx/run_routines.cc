@@ -14,8 +14,12 @@
 
 #include "xls/dslx/run_routines.h"
 
+#include <algorithm>
+#include <memory>
 #include <random>
 
+#include "absl/synchronization/mutex.h"
+#include "xls/common/thread.h"
 #include "xls/dslx/bindings.h"
 #include "xls/dslx/command_line_utils.h"
 #include "xls/dslx/error_printer.h"
@@ -34,7 +38,7 @@ constexpr int kUnitSpaces = 7;
 constexpr int kQuickcheckSpaces = 15;
 }  // namespace
 
-absl::StatusOr<IrJit*> RunComparator::GetOrCompileJitFunction(
+absl::StatusOr<IrJit*> RunComparator::GetOrCompileJitFunctionLocked(
     std::string ir_name, xls::Function* ir_function) {
   auto it = jit_cache_.find(ir_name);
   if (it != jit_cache_.end()) {
@@ -46,10 +50,20 @@ absl::StatusOr<IrJit*> RunComparator::GetOrCompileJitFunction(
   return result;
 }
 
+absl::StatusOr<IrJit*> RunComparator::GetOrCompileJitFunction(
+    std::string ir_name, xls::Function* ir_function) {
+  absl::MutexLock lock(&mutex_);
+  return GetOrCompileJitFunctionLocked(std::move(ir_name), ir_function);
+}
+
 absl::Status RunComparator::RunComparison(
     Package* ir_package, bool requires_implicit_token, dslx::Function* f,
     absl::Span<InterpValue const> args,
     const SymbolicBindings* symbolic_bindings, const InterpValue& got) {
+  // Tests may execute in parallel (see ParseAndTestOptions::test_parallelism);
+  // serialize both the cache access and the reference execution.
+  absl::MutexLock lock(&mutex_);
+
   XLS_RET_CHECK(ir_package != nullptr);
 
   XLS_ASSIGN_OR_RETURN(
@@ -91,7 +105,7 @@ absl::Status RunComparator::RunComparison(
       // TODO(https://github.com/google/xls/issues/506): Also compare events
       // once the DSLX interpreter supports them (and the JIT supports traces).
       XLS_ASSIGN_OR_RETURN(IrJit * jit,
-                           GetOrCompileJitFunction(ir_name, ir_function));
+                           GetOrCompileJitFunctionLocked(ir_name, ir_function));
       XLS_ASSIGN_OR_RETURN(ir_result, DropInterpreterEvents(jit->Run(ir_args)));
       mode_str = "JIT";
       break;
@@ -342,19 +356,75 @@ absl::StatusOr<TestResult> ParseAndTest(absl::string_view program,
                           options.trace_format_preference, post_fn_eval_hook);
 
   // Run unit tests.
+  std::vector<std::string> test_names;
   for (const std::string& test_name : entry_module->GetTestNames()) {
     if (!TestMatchesFilter(test_name, options.test_filter)) {
       skipped += 1;
       continue;
     }
+    test_names.push_back(test_name);
+  }
 
-    ran += 1;
-    std::cerr << "[ RUN UNITTEST  ] " << test_name << std::endl;
-    absl::Status status = interpreter.RunTest(test_name);
-    if (status.ok()) {
-      std::cerr << "[            OK ]" << std::endl;
-    } else {
-      handle_error(status, test_name, /*is_quickcheck=*/false);
+  // Concolic execution drives test generation through a single engine, so it
+  // always runs on one thread.
+  int64_t parallelism = options.run_concolic ? 1 : options.test_parallelism;
+  if (parallelism > 1 && test_names.size() > 1) {
+    // Tests share the (immutable once typechecked) module and type
+    // information, but each worker evaluates with its own interpreter (and
+    // thus its own bindings) for isolation. Workers pull test indices from a
+    // shared cursor.
+    std::vector<absl::Status> statuses(test_names.size(), absl::OkStatus());
+    absl::Mutex mutex;
+    int64_t cursor = 0;
+    auto run_worker = [&]() {
+      Interpreter test_interpreter(
+          entry_module, typecheck_callback, &import_data, options.trace_all,
+          /*run_concolic=*/false, options.trace_format_preference,
+          post_fn_eval_hook);
+      while (true) {
+        int64_t item;
+        {
+          absl::MutexLock lock(&mutex);
+          if (cursor == static_cast<int64_t>(test_names.size())) {
+            return;
+          }
+          item = cursor++;
+        }
+        statuses[item] = test_interpreter.RunTest(test_names[item]);
+      }
+    };
+
+    int64_t worker_count =
+        std::min(parallelism, static_cast<int64_t>(test_names.size()));
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int64_t i = 1; i < worker_count; ++i) {
+      threads.push_back(std::make_unique<Thread>(run_worker));
+    }
+    run_worker();
+    for (auto& thread : threads) {
+      thread->Join();
+    }
+
+    // Report results in module-definition order, as in the serial path.
+    for (int64_t i = 0; i < static_cast<int64_t>(test_names.size()); ++i) {
+      ran += 1;
+      std::cerr << "[ RUN UNITTEST  ] " << test_names[i] << std::endl;
+      if (statuses[i].ok()) {
+        std::cerr << "[            OK ]" << std::endl;
+      } else {
+        handle_error(statuses[i], test_names[i], /*is_quickcheck=*/false);
+      }
+    }
+  } else {
+    for (const std::string& test_name : test_names) {
+      ran += 1;
+      std::cerr << "[ RUN UNITTEST  ] " << test_name << std::endl;
+      absl::Status status = interpreter.RunTest(test_name);
+      if (status.ok()) {
+        std::cerr << "[            OK ]" << std::endl;
+      } else {
+        handle_error(status, test_name, /*is_quickcheck=*/false);
+      }
     }
   }
 
@@ -18,6 +18,7 @@
 #ifndef XLS_DSLX_RUN_ROUTINES_H_
 #define XLS_DSLX_RUN_ROUTINES_H_
 
+#include "absl/synchronization/mutex.h"
 #include "xls/dslx/default_dslx_stdlib_path.h"
 #include "xls/dslx/interp_value.h"
 #include "xls/dslx/interpreter.h"
@@ -57,8 +58,8 @@ class RunComparator {
   // already been mangled (see MangleDslxName) so it should be unique in the
   // program and is used as the cache key.
   //
-  // Note: There is no locking in jit compilation or on the jit function cache
-  // so this function is *not* thread-safe.
+  // Note: comparisons are serialized internally (see mutex_), so a single
+  // RunComparator may be shared by tests executing on multiple threads.
   absl::StatusOr<IrJit*> GetOrCompileJitFunction(std::string ir_name,
                                                  xls::Function* ir_function);
 
@@ -67,6 +68,15 @@ class RunComparator {
   friend class RunRoutinesTest_QuickcheckInvokedFunctionDoesJit_Test;
   friend class RunRoutinesTest_NoSeedStillQuickChecks_Test;
 
+  // Implementation of GetOrCompileJitFunction; callers must hold mutex_.
+  absl::StatusOr<IrJit*> GetOrCompileJitFunctionLocked(
+      std::string ir_name, xls::Function* ir_function);
+
+  // Guards the JIT cache and comparison execution so tests running in
+  // parallel (see ParseAndTestOptions::test_parallelism) can share this
+  // object.
+  absl::Mutex mutex_;
+
   absl::flat_hash_map<std::string, std::unique_ptr<IrJit>> jit_cache_;
   CompareMode mode_;
 };
@@ -82,6 +92,10 @@ class RunComparator {
 //   seed: Seed for QuickCheck random input stimulus.
 //   convert_options: Options used in IR conversion, see `ConvertOptions` for
 //    details.
+//   test_parallelism: Number of threads used to execute the unit tests in the
+//    module. Each worker runs tests in its own interpreter over the shared
+//    (immutable once typechecked) module/type information; results are
+//    reported in module-definition order regardless of completion order.
 struct ParseAndTestOptions {
   std::string stdlib_path = xls::kDefaultDslxStdlibPath;
   absl::Span<const std::filesystem::path> dslx_paths = {};
@@ -93,6 +107,7 @@ struct ParseAndTestOptions {
   bool execute = true;
   absl::optional<int64_t> seed = absl::nullopt;
   ConvertOptions convert_options;
+  int64_t test_parallelism = 1;
 };
 
 enum class TestResult {
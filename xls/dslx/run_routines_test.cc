@@ -88,6 +88,49 @@ fn trivial(x: u5) -> bool { id(true) }
   EXPECT_EQ(jit_comparator.jit_cache_.begin()->first, "__test__trivial");
 }
 
+TEST(RunRoutinesTest, ParallelTestExecutionAllPass) {
+  constexpr const char* kProgram = R"(
+fn triple(x: u32) -> u32 { x * u32:3 }
+
+#![test]
+fn test_a() { assert_eq(triple(u32:1), u32:3) }
+
+#![test]
+fn test_b() { assert_eq(triple(u32:2), u32:6) }
+
+#![test]
+fn test_c() { assert_eq(triple(u32:3), u32:9) }
+
+#![test]
+fn test_d() { assert_eq(triple(u32:4), u32:12) }
+)";
+  RunComparator jit_comparator(CompareMode::kJit);
+  ParseAndTestOptions options;
+  options.run_comparator = &jit_comparator;
+  options.test_parallelism = 4;
+  absl::StatusOr<TestResult> result =
+      ParseAndTest(kProgram, "test", "test.x", options);
+  EXPECT_THAT(result, status_testing::IsOkAndHolds(TestResult::kAllPassed));
+}
+
+TEST(RunRoutinesTest, ParallelTestExecutionReportsFailure) {
+  constexpr const char* kProgram = R"(
+#![test]
+fn test_passes() { assert_eq(u32:1, u32:1) }
+
+#![test]
+fn test_fails() { assert_eq(u32:1, u32:2) }
+
+#![test]
+fn test_also_passes() { assert_eq(u32:3, u32:3) }
+)";
+  ParseAndTestOptions options;
+  options.test_parallelism = 2;
+  absl::StatusOr<TestResult> result =
+      ParseAndTest(kProgram, "test", "test.x", options);
+  EXPECT_THAT(result, status_testing::IsOkAndHolds(TestResult::kSomeFailed));
+}
+
 TEST(RunRoutinesTest, FailingQuickCheck) {
   constexpr const char* kProgram = R"(
 #![quickcheck(test_count=2)]
@@ -15,6 +15,7 @@
 #ifndef XLS_DSLX_CPP_SCANNER_H_
 #define XLS_DSLX_CPP_SCANNER_H_
 
+#include <memory>
 #include <string>
 
 #include "absl/container/flat_hash_map.h"
@@ -190,7 +191,7 @@ class Scanner {
  public:
   Scanner(std::string filename, std::string text,
           bool include_whitespace_and_comments = false)
-      : filename_(std::move(filename)),
+      : filename_(std::make_shared<const std::string>(std::move(filename))),
         text_(std::move(text)),
         include_whitespace_and_comments_(include_whitespace_and_comments) {}
 
@@ -198,6 +199,9 @@ class Scanner {
   // the token stream can change on a Pop(), because whitespace and comments
   // may be discarded.
   //
+  // Note: the filename is shared into the returned position (reference count
+  // bump) rather than copied, so minting positions is cheap.
+  //
   // TODO(leary): 2020-09-08 Attempt to privatize this, ideally consumers would
   // only care about the positions of tokens, not of the scanner itself.
   Pos GetPos() const {
@@ -265,17 +269,27 @@ class Scanner {
 
   // Scans from the current position until ftake returns false or EOF is
   // reached.
-  std::string ScanWhile(std::string s, const std::function<bool(char)>& ftake) {
-    while (!AtCharEof()) {
-      char peek = PeekChar();
-      if (!ftake(peek)) {
-        break;
+  //
+  // Templated on the predicate (rather than taking a std::function) so the
+  // per-character test inlines, and the accepted range is appended in one
+  // exact-sized chunk rather than character by character.
+  template <typename TakeF>
+  std::string ScanWhile(std::string s, const TakeF& ftake) {
+    const int64_t start = index_;
+    while (!AtCharEof() && ftake(text_[index_])) {
+      if (text_[index_] == '\n') {
+        lineno_ += 1;
+        colno_ = 0;
+      } else {
+        colno_ += 1;
       }
-      s.append(1, PopChar());
+      index_ += 1;
     }
+    s.append(text_, start, index_ - start);
     return s;
   }
-  std::string ScanWhile(char c, const std::function<bool(char)>& ftake) {
+  template <typename TakeF>
+  std::string ScanWhile(char c, const TakeF& ftake) {
     return ScanWhile(std::string(1, c), ftake);
   }
 
@@ -369,7 +383,8 @@ class Scanner {
   // are valid constituents of a string.
   absl::StatusOr<std::string> ProcessNextStringChar();
 
-  std::string filename_;
+  // Shared with every Pos handed out by GetPos().
+  std::shared_ptr<const std::string> filename_;
   std::string text_;
   bool include_whitespace_and_comments_;
   int64_t index_ = 0;
@@ -32,6 +32,7 @@ std::string InstantiationData::ToString() const {
 // -- class TypeInfoOwner
 
 absl::StatusOr<TypeInfo*> TypeInfoOwner::New(Module* module, TypeInfo* parent) {
+  absl::MutexLock lock(mutex_.get());
   // Note: private constructor so not using make_unique.
   type_infos_.push_back(absl::WrapUnique(new TypeInfo(module, parent)));
   TypeInfo* result = type_infos_.back().get();
@@ -52,6 +53,7 @@ absl::StatusOr<TypeInfo*> TypeInfoOwner::New(Module* module, TypeInfo* parent) {
 }
 
 absl::StatusOr<TypeInfo*> TypeInfoOwner::GetRootTypeInfo(Module* module) {
+  absl::MutexLock lock(mutex_.get());
   auto it = module_to_root_.find(module);
   if (it == module_to_root_.end()) {
     return absl::NotFoundError(absl::StrCat(
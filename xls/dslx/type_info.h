@@ -17,6 +17,9 @@
 #ifndef XLS_DSLX_TYPE_INFO_H_
 #define XLS_DSLX_TYPE_INFO_H_
 
+#include <memory>
+
+#include "absl/synchronization/mutex.h"
 #include "xls/dslx/ast.h"
 #include "xls/dslx/concrete_type.h"
 #include "xls/dslx/symbolic_bindings.h"
@@ -74,6 +77,9 @@ class TypeInfoOwner {
  public:
   // Returns an error status iff parent is nullptr and "module" already has a
   // root type info.
+  //
+  // Thread-safe: type info for distinct modules (and parametric
+  // instantiations) may be created concurrently; see ImportData.
   absl::StatusOr<TypeInfo*> New(Module* module, TypeInfo* parent = nullptr);
 
   // Retrieves the root type information for the given module, or a not-found
@@ -81,6 +87,10 @@ class TypeInfoOwner {
   absl::StatusOr<TypeInfo*> GetRootTypeInfo(Module* module);
 
  private:
+  // Guards the members below; held in a unique_ptr so the owner (a member of
+  // the movable ImportData) remains movable.
+  mutable std::unique_ptr<absl::Mutex> mutex_ = std::make_unique<absl::Mutex>();
+
   // Mapping from module to the "root" (or "parentmost") type info -- these have
   // nullptr as their parent. There should only be one of these for any given
   // module.
@@ -200,6 +200,16 @@ static absl::StatusOr<NameDef*> InstantiateBuiltinParametricMap(
     return nullptr;
   }
 
+  if (absl::optional<TypeInfo*> memoized =
+          ctx->instantiation_memo()->Lookup(map_fn, tab.symbolic_bindings)) {
+    // Another callsite already typechecked the mapped function with these
+    // bindings; reuse its type info for this invocation.
+    ctx->type_info()->SetInstantiationTypeInfo(
+        invocation, /*caller=*/tab.symbolic_bindings,
+        /*type_info=*/*memoized);
+    return nullptr;
+  }
+
   // If the higher order function is parametric, we need to typecheck its body
   // with the symbolic bindings we just computed.
   if (auto* colon_ref = dynamic_cast<ColonRef*>(map_fn_ref)) {
@@ -225,6 +235,8 @@ static absl::StatusOr<NameDef*> InstantiateBuiltinParametricMap(
     ctx->type_info()->SetInstantiationTypeInfo(
         invocation, /*caller=*/tab.symbolic_bindings,
         /*type_info=*/invocation_imported_type_info);
+    ctx->instantiation_memo()->Insert(map_fn, tab.symbolic_bindings,
+                                      invocation_imported_type_info);
     return nullptr;
   }
 
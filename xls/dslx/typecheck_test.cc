@@ -151,6 +151,31 @@ fn f() -> (u32, u32) { p(u32:3) }
   XLS_EXPECT_OK(Typecheck(program));
 }
 
+TEST(TypecheckTest, ParametricInstantiationRepeatedAcrossCallsites) {
+  // Several callsites instantiate `p` with the same parametric environment
+  // (the body typecheck is reused across them) alongside a callsite with a
+  // distinct environment.
+  std::string program = R"(
+fn p<N: u32>(x: bits[N]) -> bits[N] { x + bits[N]:1 }
+fn f() -> u32 { p(u32:3) + p(u32:4) }
+fn g() -> u32 { p(u32:5) }
+fn h() -> u8 { p(u8:7) }
+)";
+  XLS_EXPECT_OK(Typecheck(program));
+}
+
+TEST(TypecheckTest, ParametricMapRepeatedAcrossCallsites) {
+  // The mapped function is instantiated directly and then twice via map()
+  // with the same parametric environment.
+  std::string program = R"(
+fn add_one<N: u32>(x: bits[N]) -> bits[N] { x + bits[N]:1 }
+fn f() -> u32 { add_one(u32:1) }
+fn g() -> u32[3] { map(u32[3]:[1, 2, 3], add_one) }
+fn h() -> u32[3] { map(u32[3]:[4, 5, 6], add_one) }
+)";
+  XLS_EXPECT_OK(Typecheck(program));
+}
+
 TEST(TypecheckTest, DoubleParametricInvocation) {
   std::string program = R"(
 fn p<N: u32>(x: bits[N]) -> bits[N] { x + bits[N]:1 }
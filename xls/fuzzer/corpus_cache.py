@@ -0,0 +1,101 @@
+# Lint as: python3
+#
+# Copyright 2021 The XLS Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Content-addressed corpus cache for deduplicating fuzz samples."""
+
+import hashlib
+import os
+from typing import Optional, Text
+
+from xls.common import gfile
+from xls.fuzzer.python.cpp_sample import Sample
+
+
+def canonicalize_dslx(text: Text) -> Text:
+  """Returns DSLX text in a canonical form for content hashing.
+
+  Strips comments, trailing whitespace, and blank lines so that samples which
+  differ only in formatting or commentary hash to the same digest.
+  """
+  lines = []
+  for line in text.splitlines():
+    line = line.split('//', 1)[0].rstrip()
+    if line:
+      lines.append(line)
+  return '\n'.join(lines)
+
+
+def sample_digest(sample: Sample) -> Text:
+  """Returns the content digest of a sample.
+
+  The digest is a SHA-256 hash of the canonicalized DSLX text and the sample
+  options, so two samples with the same code modulo formatting and the same
+  options map to the same digest. The input arguments are deliberately not
+  part of the digest: a sample with the same code and options covers the same
+  point in the program space.
+  """
+  hasher = hashlib.sha256()
+  hasher.update(canonicalize_dslx(sample.input_text).encode('utf-8'))
+  hasher.update(b'\0')
+  hasher.update(sample.options.to_json().encode('utf-8'))
+  return hasher.hexdigest()
+
+
+class CorpusCache:
+  """Content-addressed store of fuzz samples which have already been run.
+
+  Samples are keyed by their content digest (see sample_digest). If a corpus
+  path is given the store is persistent: each newly added sample is written to
+  a file in the directory named by its digest, and existing entries are loaded
+  on construction so points covered by earlier invocations are skipped as
+  well. The corpus path must be a local directory.
+  """
+
+  def __init__(self, corpus_path: Optional[Text] = None):
+    self._corpus_path = corpus_path
+    self._digests = set()
+    if corpus_path:
+      gfile.make_dirs(corpus_path)
+      for name in os.listdir(corpus_path):
+        digest, ext = os.path.splitext(name)
+        if ext == '.x':
+          self._digests.add(digest)
+
+  def __len__(self) -> int:
+    return len(self._digests)
+
+  def contains(self, sample: Sample) -> bool:
+    """Returns whether the sample's content digest is already in the corpus."""
+    return sample_digest(sample) in self._digests
+
+  def add(self, sample: Sample) -> bool:
+    """Records the sample in the corpus.
+
+    Returns False if a sample with the same content digest was already
+    present, in which case the store is unchanged.
+
+    Args:
+      sample: The sample to record.
+    """
+    digest = sample_digest(sample)
+    if digest in self._digests:
+      return False
+    self._digests.add(digest)
+    if self._corpus_path:
+      with gfile.open(os.path.join(self._corpus_path, digest + '.x'),
+                      'w') as f:
+        f.write(sample.input_text)
+    return True
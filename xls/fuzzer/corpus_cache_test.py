@@ -0,0 +1,76 @@
+# Lint as: python3
+#
+# Copyright 2021 The XLS Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from absl.testing import absltest
+from xls.fuzzer import corpus_cache
+from xls.fuzzer.python import cpp_sample as sample
+
+
+def _make_sample(input_text: str, **options_kwargs) -> sample.Sample:
+  return sample.Sample(input_text, sample.SampleOptions(**options_kwargs), [])
+
+
+class CorpusCacheTest(absltest.TestCase):
+
+  def test_canonicalize_dslx(self):
+    self.assertEqual(
+        corpus_cache.canonicalize_dslx(
+            '// A comment.\nfn main() -> u32 {  \n\n  u32:42  // trailing\n}'),
+        'fn main() -> u32 {\n  u32:42\n}')
+
+  def test_digest_ignores_formatting(self):
+    a = _make_sample('fn main() -> u32 { u32:42 }')
+    b = _make_sample('// Same sample, different commentary.\n'
+                     'fn main() -> u32 { u32:42 }   \n')
+    self.assertEqual(
+        corpus_cache.sample_digest(a), corpus_cache.sample_digest(b))
+
+  def test_digest_depends_on_text_and_options(self):
+    a = _make_sample('fn main() -> u32 { u32:42 }')
+    b = _make_sample('fn main() -> u32 { u32:43 }')
+    c = _make_sample('fn main() -> u32 { u32:42 }', codegen=True)
+    self.assertNotEqual(
+        corpus_cache.sample_digest(a), corpus_cache.sample_digest(b))
+    self.assertNotEqual(
+        corpus_cache.sample_digest(a), corpus_cache.sample_digest(c))
+
+  def test_add_and_contains(self):
+    cache = corpus_cache.CorpusCache()
+    s = _make_sample('fn main() -> u32 { u32:42 }')
+    self.assertFalse(cache.contains(s))
+    self.assertTrue(cache.add(s))
+    self.assertTrue(cache.contains(s))
+    # A second add of an equivalent sample reports a duplicate.
+    self.assertFalse(
+        cache.add(_make_sample('fn main() -> u32 { u32:42 }  // dup\n')))
+    self.assertLen(cache, 1)
+
+  def test_persistent_corpus(self):
+    corpus_path = self.create_tempdir().full_path
+    s = _make_sample('fn main() -> u32 { u32:42 }')
+
+    cache = corpus_cache.CorpusCache(corpus_path)
+    self.assertTrue(cache.add(s))
+
+    # A new cache over the same directory sees the previously added sample.
+    reloaded = corpus_cache.CorpusCache(corpus_path)
+    self.assertLen(reloaded, 1)
+    self.assertTrue(reloaded.contains(s))
+    self.assertFalse(reloaded.add(s))
+
+
+if __name__ == '__main__':
+  absltest.main()
@@ -0,0 +1,155 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11) For hardware_concurrency only.
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/init_xls.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
+#include "xls/fuzzer/cpp_sample_runner.h"
+#include "xls/fuzzer/sample.h"
+#include "xls/fuzzer/sample_generator.h"
+
+const char kUsage[] = R"(
+Generates and runs random fuzz samples entirely in-process on a pool of
+worker threads. Each sample is generated with the C++ sample generator,
+converted from DSLX to IR in memory, evaluated with the IR interpreter as the
+reference, then evaluated with the JIT before and after optimization. Any
+result mismatch is reported as a crasher. Keeping the workers warm and the IR
+in memory avoids the per-sample process startup and text round-trips of the
+Python fuzzer driver. Usage:
+
+    cpp_run_fuzz_multiprocess_main --sample_count=10000 --worker_count=8
+)";
+
+ABSL_FLAG(int64_t, worker_count, 0,
+          "Number of worker threads. 0 means use the number of hardware "
+          "threads.");
+ABSL_FLAG(int64_t, sample_count, 1024,
+          "Total number of samples to generate and run, divided among the "
+          "workers.");
+ABSL_FLAG(int64_t, calls_per_sample, 128,
+          "Number of argument sets to evaluate per sample.");
+ABSL_FLAG(int64_t, seed, 42,
+          "Seed for sample generation. Sample i is generated from an "
+          "independent stream derived from (seed, i), so any sample can be "
+          "regenerated in isolation and results do not depend on the worker "
+          "count.");
+ABSL_FLAG(std::string, crasher_dir, "",
+          "If nonempty, samples which fail are written to this directory in "
+          "crasher format.");
+
+namespace xls {
+namespace {
+
+// Number of samples completed across all workers, for progress logging.
+std::atomic<int64_t> samples_completed{0};
+
+// Worker which generates and runs the samples with global indices
+// [start_sample, start_sample + num_samples). Each sample derives its own RNG
+// stream from (seed, sample index), so the sharding has no effect on which
+// samples are generated. On a sample failure the crasher is written (if
+// requested) and the error returned.
+absl::Status RunWorker(int64_t start_sample, int64_t num_samples) {
+  dslx::AstGeneratorOptions ast_options;
+  SampleOptions sample_options;
+  sample_options.set_codegen(false);
+  sample_options.set_simulate(false);
+
+  for (int64_t i = start_sample; i < start_sample + num_samples; ++i) {
+    RngState rng = RngState::ForSample(absl::GetFlag(FLAGS_seed), i);
+    XLS_ASSIGN_OR_RETURN(
+        Sample sample,
+        GenerateSample(ast_options, absl::GetFlag(FLAGS_calls_per_sample),
+                       sample_options, &rng));
+    absl::Status status = RunSampleInProcess(sample);
+    if (!status.ok()) {
+      std::string crasher_dir = absl::GetFlag(FLAGS_crasher_dir);
+      if (!crasher_dir.empty()) {
+        XLS_RETURN_IF_ERROR(SetFileContents(
+            absl::StrFormat("%s/crasher_s%d.x", crasher_dir, i),
+            sample.ToCrasher(status.message())));
+      }
+      return status;
+    }
+    int64_t completed = samples_completed.fetch_add(1) + 1;
+    if (completed % 100 == 0) {
+      XLS_LOG(INFO) << absl::StreamFormat("Completed %d samples.", completed);
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status RealMain() {
+  int64_t worker_count = absl::GetFlag(FLAGS_worker_count);
+  if (worker_count <= 0) {
+    worker_count = std::thread::hardware_concurrency();
+  }
+  int64_t sample_count = absl::GetFlag(FLAGS_sample_count);
+  worker_count = std::min(worker_count, sample_count);
+
+  XLS_LOG(INFO) << absl::StreamFormat("Running %d samples on %d workers.",
+                                      sample_count, worker_count);
+  absl::Time start = absl::Now();
+
+  std::vector<absl::Status> statuses(worker_count);
+  {
+    std::vector<std::unique_ptr<Thread>> threads;
+    int64_t start_sample = 0;
+    for (int64_t i = 0; i < worker_count; ++i) {
+      // Distribute the remainder of the division among the first workers.
+      int64_t num_samples =
+          sample_count / worker_count + (i < sample_count % worker_count);
+      threads.push_back(
+          std::make_unique<Thread>([i, start_sample, num_samples, &statuses]() {
+            statuses[i] = RunWorker(start_sample, num_samples);
+          }));
+      start_sample += num_samples;
+    }
+    for (auto& thread : threads) {
+      thread->Join();
+    }
+  }
+
+  absl::Duration elapsed = absl::Now() - start;
+  XLS_LOG(INFO) << absl::StreamFormat(
+      "Ran %d samples in %s (%.1f samples/s).", sample_count,
+      absl::FormatDuration(elapsed),
+      sample_count / absl::ToDoubleSeconds(elapsed));
+
+  for (const absl::Status& status : statuses) {
+    XLS_RETURN_IF_ERROR(status);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+}  // namespace xls
+
+int main(int argc, char** argv) {
+  xls::InitXls(kUsage, argc, argv);
+  XLS_QCHECK_OK(xls::RealMain());
+  return 0;
+}
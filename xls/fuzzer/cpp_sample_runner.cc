@@ -0,0 +1,87 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fuzzer/cpp_sample_runner.h"
+
+#include <memory>
+#include <vector>
+
+#include "absl/strings/str_format.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/dslx/import_data.h"
+#include "xls/dslx/interp_value.h"
+#include "xls/dslx/ir_converter.h"
+#include "xls/dslx/parse_and_typecheck.h"
+#include "xls/interpreter/function_interpreter.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+#include "xls/jit/ir_jit.h"
+#include "xls/passes/standard_pipeline.h"
+
+namespace xls {
+
+absl::Status RunSampleInProcess(const Sample& sample) {
+  dslx::ImportData import_data(/*stdlib_path=*/"",
+                               /*additional_search_paths=*/{});
+  XLS_ASSIGN_OR_RETURN(
+      dslx::TypecheckedModule tm,
+      dslx::ParseAndTypecheck(sample.input_text(), "sample.x", "sample",
+                              &import_data));
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<Package> package,
+      dslx::ConvertModuleToPackage(tm.module, &import_data,
+                                   dslx::ConvertOptions{}));
+  XLS_ASSIGN_OR_RETURN(Function * entry, package->EntryFunction());
+
+  // Convert the DSLX argument sets to IR values once up front.
+  std::vector<std::vector<Value>> args_batch;
+  args_batch.reserve(sample.args_batch().size());
+  for (const std::vector<dslx::InterpValue>& args : sample.args_batch()) {
+    XLS_ASSIGN_OR_RETURN(std::vector<Value> ir_args,
+                         dslx::InterpValue::ConvertValuesToIr(args));
+    args_batch.push_back(std::move(ir_args));
+  }
+
+  // The interpreter on the unoptimized IR is the reference.
+  std::vector<Value> expected;
+  expected.reserve(args_batch.size());
+  for (const std::vector<Value>& args : args_batch) {
+    XLS_ASSIGN_OR_RETURN(Value result, DropInterpreterEvents(InterpretFunction(
+                                           entry, args)));
+    expected.push_back(std::move(result));
+  }
+
+  auto compare_with_jit = [&](absl::string_view stage) -> absl::Status {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<IrJit> jit, IrJit::Create(entry));
+    for (int64_t i = 0; i < static_cast<int64_t>(args_batch.size()); ++i) {
+      XLS_ASSIGN_OR_RETURN(Value result, DropInterpreterEvents(
+                                             jit->Run(args_batch[i])));
+      if (result != expected[i]) {
+        return absl::InternalError(absl::StrFormat(
+            "Result miscompare for sample %d (%s IR): JIT produced %s, "
+            "interpreter produced %s",
+            i, stage, result.ToString(), expected[i].ToString()));
+      }
+    }
+    return absl::OkStatus();
+  };
+
+  XLS_RETURN_IF_ERROR(compare_with_jit("unoptimized"));
+  XLS_RETURN_IF_ERROR(RunStandardPassPipeline(package.get()).status());
+  // The entry function pointer is stable across optimization.
+  XLS_RETURN_IF_ERROR(compare_with_jit("optimized"));
+  return absl::OkStatus();
+}
+
+}  // namespace xls
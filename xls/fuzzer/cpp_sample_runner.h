@@ -0,0 +1,32 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_FUZZER_CPP_SAMPLE_RUNNER_H_
+#define XLS_FUZZER_CPP_SAMPLE_RUNNER_H_
+
+#include "absl/status/status.h"
+#include "xls/fuzzer/sample.h"
+
+namespace xls {
+
+// Runs the functional portion of a fuzz sample entirely in-process: the
+// sample is converted from DSLX to IR in memory, evaluated with the IR
+// interpreter as the reference, then evaluated with the JIT before and after
+// optimization. Returns an error on any conversion failure or result
+// mismatch. Codegen and simulation options of the sample are not exercised.
+absl::Status RunSampleInProcess(const Sample& sample);
+
+}  // namespace xls
+
+#endif  // XLS_FUZZER_CPP_SAMPLE_RUNNER_H_
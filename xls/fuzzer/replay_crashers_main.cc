@@ -0,0 +1,192 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11) For hardware_concurrency only.
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/init_xls.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
+#include "xls/fuzzer/cpp_sample_runner.h"
+#include "xls/fuzzer/sample.h"
+
+const char kUsage[] = R"(
+Replays the checked-in crasher corpus concurrently on a pool of worker
+threads. Each crasher is deserialized and its functional portion run
+in-process (interpreter reference versus JIT, before and after
+optimization). With --cache_dir, crashers which passed with the same file
+contents and --toolchain_revision are skipped on subsequent runs, so an
+incremental CI run only replays crashers affected by a toolchain change.
+Usage:
+
+    replay_crashers_main --crasher_dir=xls/fuzzer/crashers \
+        --cache_dir=/tmp/crasher_cache \
+        --toolchain_revision=$(git rev-parse HEAD)
+)";
+
+ABSL_FLAG(std::string, crasher_dir, "xls/fuzzer/crashers",
+          "Directory containing crasher files (*.x) to replay.");
+ABSL_FLAG(int64_t, worker_count, 0,
+          "Number of worker threads. 0 means use the number of hardware "
+          "threads.");
+ABSL_FLAG(std::string, cache_dir, "",
+          "If nonempty, directory in which pass results are cached. A crasher "
+          "is skipped when it previously passed with identical contents and "
+          "the same --toolchain_revision. Failures are never cached.");
+ABSL_FLAG(std::string, toolchain_revision, "",
+          "Revision string mixed into the cache key (e.g. the git revision of "
+          "the toolchain). Cached passes from other revisions are not "
+          "reused.");
+
+namespace xls {
+namespace {
+
+// FNV-1a 64-bit hash. The cache key must be stable across processes and
+// toolchain versions, which rules out absl::Hash and std::hash.
+uint64_t Fnv1aHash(absl::string_view data,
+                   uint64_t state = 0xcbf29ce484222325ULL) {
+  for (char c : data) {
+    state ^= static_cast<uint8_t>(c);
+    state *= 0x100000001b3ULL;
+  }
+  return state;
+}
+
+// Path of the pass-marker file for a crasher with the given contents, or the
+// empty path if caching is disabled.
+std::filesystem::path CacheMarkerPath(absl::string_view contents) {
+  std::string cache_dir = absl::GetFlag(FLAGS_cache_dir);
+  if (cache_dir.empty()) {
+    return std::filesystem::path();
+  }
+  uint64_t key =
+      Fnv1aHash(contents, Fnv1aHash(absl::GetFlag(FLAGS_toolchain_revision)));
+  return std::filesystem::path(cache_dir) /
+         absl::StrFormat("%016x.pass", key);
+}
+
+// Replays a single crasher file, consulting and updating the pass cache.
+// Sets *cached to true if the result came from the cache.
+absl::Status ReplayCrasher(const std::filesystem::path& path, bool* cached) {
+  XLS_ASSIGN_OR_RETURN(std::string contents, GetFileContents(path));
+  std::filesystem::path marker = CacheMarkerPath(contents);
+  *cached = !marker.empty() && FileExists(marker).ok();
+  if (*cached) {
+    return absl::OkStatus();
+  }
+  XLS_ASSIGN_OR_RETURN(Sample sample, Sample::Deserialize(contents));
+  XLS_RETURN_IF_ERROR(RunSampleInProcess(sample));
+  if (!marker.empty()) {
+    XLS_RETURN_IF_ERROR(SetFileContents(marker, ""));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status RealMain() {
+  XLS_ASSIGN_OR_RETURN(
+      std::vector<std::filesystem::path> entries,
+      GetDirectoryEntries(absl::GetFlag(FLAGS_crasher_dir)));
+  std::vector<std::filesystem::path> crashers;
+  for (const std::filesystem::path& entry : entries) {
+    if (entry.extension() == ".x") {
+      crashers.push_back(entry);
+    }
+  }
+  std::sort(crashers.begin(), crashers.end());
+
+  if (!absl::GetFlag(FLAGS_cache_dir).empty()) {
+    XLS_RETURN_IF_ERROR(
+        RecursivelyCreateDir(absl::GetFlag(FLAGS_cache_dir)));
+  }
+
+  int64_t worker_count = absl::GetFlag(FLAGS_worker_count);
+  if (worker_count <= 0) {
+    worker_count = std::thread::hardware_concurrency();
+  }
+  worker_count =
+      std::min(worker_count, static_cast<int64_t>(crashers.size()));
+
+  XLS_LOG(INFO) << absl::StreamFormat("Replaying %d crashers on %d workers.",
+                                      crashers.size(), worker_count);
+  absl::Time start = absl::Now();
+
+  // Workers pull crasher indices from a shared counter so a handful of slow
+  // crashers do not leave other workers idle.
+  std::atomic<int64_t> next_crasher{0};
+  std::atomic<int64_t> cache_hits{0};
+  std::vector<absl::Status> statuses(crashers.size(), absl::OkStatus());
+  {
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int64_t w = 0; w < worker_count; ++w) {
+      threads.push_back(std::make_unique<Thread>(
+          [&crashers, &next_crasher, &cache_hits, &statuses]() {
+            while (true) {
+              int64_t i = next_crasher.fetch_add(1);
+              if (i >= static_cast<int64_t>(crashers.size())) {
+                return;
+              }
+              bool cached = false;
+              statuses[i] = ReplayCrasher(crashers[i], &cached);
+              if (cached) {
+                cache_hits.fetch_add(1);
+              }
+            }
+          }));
+    }
+    for (auto& thread : threads) {
+      thread->Join();
+    }
+  }
+
+  absl::Duration elapsed = absl::Now() - start;
+  XLS_LOG(INFO) << absl::StreamFormat(
+      "Replayed %d crashers (%d cached) in %s.", crashers.size(),
+      cache_hits.load(), absl::FormatDuration(elapsed));
+
+  absl::Status result = absl::OkStatus();
+  for (int64_t i = 0; i < static_cast<int64_t>(crashers.size()); ++i) {
+    if (!statuses[i].ok()) {
+      XLS_LOG(ERROR) << absl::StreamFormat("FAILED: %s: %s",
+                                           crashers[i].string(),
+                                           statuses[i].message());
+      if (result.ok()) {
+        result = statuses[i];
+      }
+    }
+  }
+  return result;
+}
+
+}  // namespace
+}  // namespace xls
+
+int main(int argc, char** argv) {
+  xls::InitXls(kUsage, argc, argv);
+  XLS_QCHECK_OK(xls::RealMain());
+  return 0;
+}
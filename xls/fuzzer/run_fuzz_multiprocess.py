@@ -33,6 +33,7 @@ import termcolor
 
 from xls.common import gfile
 from xls.common import multiprocess
+from xls.fuzzer import corpus_cache as corpus_cache_mod
 from xls.fuzzer import run_fuzz
 from xls.fuzzer import sample_runner
 from xls.fuzzer.python import cpp_ast_generator as ast_generator
@@ -178,11 +179,14 @@ def do_generator_task(queues: Tuple[mp.Queue, ...],
                       calls_per_sample: int,
                       default_sample_options: SampleOptions,
                       duration: Optional[datetime.timedelta] = None,
-                      print_samples: bool = False) -> int:
+                      print_samples: bool = False,
+                      corpus_cache: Optional[
+                          corpus_cache_mod.CorpusCache] = None) -> int:
   """Makes DSLX text / args as fuzz samples and pushes them to workers."""
   start = datetime.datetime.now()
   i = 0
   queue_sweeps = 0
+  duplicates_skipped = 0
   rng = ast_generator.RngState(seed)
   while True:
     if duration:  # Note: duration overrides sample count.
@@ -214,6 +218,13 @@ def do_generator_task(queues: Tuple[mp.Queue, ...],
                                              calls_per_sample,
                                              default_sample_options, rng)
 
+    if corpus_cache is not None and not corpus_cache.add(sample):
+      # The corpus already covers this point; skip it without dispatching to a
+      # worker.
+      duplicates_skipped += 1
+      i += 1
+      continue
+
     if print_samples:
       print_with_linenos(sample.input_text)
     message = QueueMessage(
@@ -246,6 +257,9 @@ def do_generator_task(queues: Tuple[mp.Queue, ...],
 
   print('-- Putting stop command in worker queues after generating {} samples'
         .format(i))
+  if corpus_cache is not None:
+    print('-- Skipped {} samples already covered by the corpus'.format(
+        duplicates_skipped))
   sys.stdout.flush()
 
   for queue in queues:
@@ -32,6 +32,7 @@ import psutil
 from xls.common import gfile
 from xls.common import multiprocess
 from xls.fuzzer import cli_helpers
+from xls.fuzzer import corpus_cache as corpus_cache_mod
 from xls.fuzzer import run_fuzz_multiprocess
 from xls.fuzzer.python import cpp_ast_generator as ast_generator
 from xls.fuzzer.python import cpp_sample as sample
@@ -90,6 +91,16 @@ flags.DEFINE_boolean(
 flags.DEFINE_integer(
     'timeout_seconds', 300,
     'The timeout value in seconds for each subcommand invocation.')
+flags.DEFINE_boolean(
+    'dedupe_samples', True,
+    'Skip generated samples whose canonicalized DSLX text and options match '
+    'a previously generated sample instead of re-running them.')
+flags.DEFINE_string(
+    'sample_corpus_path', None,
+    'Local directory used as a persistent content-addressed corpus of '
+    'already-run samples. Entries from earlier invocations are loaded on '
+    'startup and newly run samples are added. If unspecified, samples are '
+    'only deduplicated within this invocation. Requires --dedupe_samples.')
 FLAGS = flags.FLAGS
 
 QUEUE_MAX_BACKLOG = 16
@@ -159,6 +170,16 @@ def main(argv):
       simulator=FLAGS.simulator,
       use_system_verilog=FLAGS.use_system_verilog,
       timeout_seconds=FLAGS.timeout_seconds)
+  corpus_cache = None
+  if FLAGS.dedupe_samples:
+    corpus_cache = corpus_cache_mod.CorpusCache(FLAGS.sample_corpus_path)
+    if len(corpus_cache):
+      print('-- Loaded {} samples from corpus at {}'.format(
+          len(corpus_cache), FLAGS.sample_corpus_path))
+  elif FLAGS.sample_corpus_path:
+    raise app.UsageError(
+        '--sample_corpus_path requires --dedupe_samples.')
+
   sample_count = run_fuzz_multiprocess.do_generator_task(
       queues,
       seed,
@@ -167,7 +188,8 @@ def main(argv):
       FLAGS.calls_per_sample,
       default_sample_options=default_sample_options,
       duration=duration,
-      print_samples=FLAGS.print_samples)
+      print_samples=FLAGS.print_samples,
+      corpus_cache=corpus_cache)
 
   for i, worker in enumerate(workers):
     print('-- Joining on worker {}'.format(i))
@@ -34,6 +34,29 @@ using dslx::InterpValueTag;
 using dslx::TupleType;
 using dslx::TypecheckedModule;
 
+namespace {
+
+// SplitMix64 finalizer. Consecutive (seed, sample index) pairs differ in only
+// a few bits; the finalizer spreads those differences across the whole word
+// so the derived engine states are decorrelated.
+uint64_t MixBits(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+}  // namespace
+
+/* static */ RngState RngState::ForSample(uint64_t seed, int64_t sample_index) {
+  uint64_t a = MixBits(seed ^ MixBits(static_cast<uint64_t>(sample_index)));
+  uint64_t b = MixBits(a);
+  std::seed_seq seq{
+      static_cast<uint32_t>(a), static_cast<uint32_t>(a >> 32),
+      static_cast<uint32_t>(b), static_cast<uint32_t>(b >> 32)};
+  return RngState(std::mt19937(seq));
+}
+
 double RngState::RandomDouble() {
   std::uniform_real_distribution<double> d(0.0, 1.0);
   return d(rng_);
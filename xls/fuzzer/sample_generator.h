@@ -15,6 +15,7 @@
 #ifndef XLS_FUZZER_SAMPLE_GENERATOR_H_
 #define XLS_FUZZER_SAMPLE_GENERATOR_H_
 
+#include <cstdint>
 #include <random>
 
 #include "xls/dslx/concrete_type.h"
@@ -29,6 +30,13 @@ class RngState {
  public:
   explicit RngState(std::mt19937 rng) : rng_(std::move(rng)) {}
 
+  // Returns an RNG state for the given (seed, sample index) pair. The engine
+  // is seeded with a mix of the two values, so every sample index yields an
+  // independent, reproducible stream: sample i of a fuzz run can be
+  // regenerated in isolation without replaying samples 0..i-1, and parallel
+  // shards need no RNG coordination.
+  static RngState ForSample(uint64_t seed, int64_t sample_index);
+
   // Returns a random double value in the range [0.0, 1.0).
   double RandomDouble();
 
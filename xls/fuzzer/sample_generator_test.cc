@@ -14,6 +14,8 @@
 
 #include "xls/fuzzer/sample_generator.h"
 
+#include <vector>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "xls/common/status/matchers.h"
@@ -67,6 +69,24 @@ TEST(SampleGeneratorTest, RngRandomDouble) {
   }
 }
 
+TEST(SampleGeneratorTest, ForSampleStreamsAreReproducibleAndIndependent) {
+  auto draw = [](xls::RngState rng) {
+    std::vector<int64_t> values;
+    for (int64_t i = 0; i < 16; ++i) {
+      values.push_back(rng.RandRange(int64_t{1} << 20));
+    }
+    return values;
+  };
+  // The same (seed, sample index) pair always yields the same stream.
+  EXPECT_EQ(draw(xls::RngState::ForSample(/*seed=*/42, /*sample_index=*/7)),
+            draw(xls::RngState::ForSample(/*seed=*/42, /*sample_index=*/7)));
+  // Neighboring sample indices and seeds yield different streams.
+  EXPECT_NE(draw(xls::RngState::ForSample(/*seed=*/42, /*sample_index=*/7)),
+            draw(xls::RngState::ForSample(/*seed=*/42, /*sample_index=*/8)));
+  EXPECT_NE(draw(xls::RngState::ForSample(/*seed=*/42, /*sample_index=*/7)),
+            draw(xls::RngState::ForSample(/*seed=*/43, /*sample_index=*/7)));
+}
+
 TEST(SampleGeneratorTest, GenerateEmptyArguments) {
   xls::RngState rng(std::mt19937{});
 
@@ -14,8 +14,12 @@
 
 #include "xls/interpreter/block_interpreter.h"
 
+#include <functional>
+#include <queue>
+
 #include "absl/status/status.h"
 #include "xls/ir/bits.h"
+#include "xls/ir/node_iterator.h"
 #include "xls/ir/value_helpers.h"
 
 namespace xls {
@@ -134,7 +138,7 @@ class BlockInterpreter : public IrInterpreter {
  private:
   BlockInterpreter(const absl::flat_hash_map<std::string, Value>& inputs,
                    const absl::flat_hash_map<std::string, Value>& reg_state)
-      : IrInterpreter(/*args=*/{}), inputs_(inputs), reg_state_(reg_state) {}
+      : IrInterpreter(), inputs_(inputs), reg_state_(reg_state) {}
   // Values fed to the input ports.
   const absl::flat_hash_map<std::string, Value> inputs_;
 
@@ -145,6 +149,180 @@ class BlockInterpreter : public IrInterpreter {
   absl::flat_hash_map<std::string, Value> next_reg_state_;
 };
 
+// An event-driven interpreter for XLS blocks. Node values are retained from
+// cycle to cycle and a node is re-evaluated only if it lies in the fanout
+// cone (followed via the user edges on Node) of an input port or register
+// whose value changed, so cycle cost scales with switching activity rather
+// than block size.
+class EventDrivenBlockInterpreter : public IrInterpreter {
+ public:
+  explicit EventDrivenBlockInterpreter(Block* block)
+      : IrInterpreter(block), block_(block) {
+    // Initial register state is zero for all registers, matching
+    // InterpretSequentialBlock.
+    for (Register* reg : block->GetRegisters()) {
+      reg_state_[reg->name()] = ZeroOfType(reg->type());
+    }
+    for (Node* node : TopoSort(block)) {
+      topo_index_[node] = topo_order_.size();
+      topo_order_.push_back(node);
+      if (node->Is<RegisterRead>()) {
+        register_users_[node->As<RegisterRead>()->GetRegister()->name()]
+            .push_back(node);
+      } else if (node->Is<RegisterWrite>()) {
+        // RegisterWrite reads the current register value directly (not via a
+        // RegisterRead node) when its load enable is deasserted, so it must
+        // also be re-evaluated when the register value changes.
+        register_users_[node->As<RegisterWrite>()->GetRegister()->name()]
+            .push_back(node);
+      }
+    }
+  }
+
+  // Runs a single cycle with the given input port values and returns the
+  // values of the output ports. Registers are clocked at the end of the
+  // cycle.
+  absl::StatusOr<absl::flat_hash_map<std::string, Value>> RunCycle(
+      const absl::flat_hash_map<std::string, Value>& inputs) {
+    inputs_ = &inputs;
+
+    // Nodes pending evaluation, ordered by topological index. The scheduled_
+    // bitmap deduplicates insertions.
+    std::priority_queue<int64_t, std::vector<int64_t>, std::greater<int64_t>>
+        pending;
+    std::vector<bool> scheduled(topo_order_.size(), false);
+    auto schedule = [&](Node* node) {
+      int64_t index = topo_index_.at(node);
+      if (!scheduled[index]) {
+        scheduled[index] = true;
+        pending.push(index);
+      }
+    };
+
+    if (first_cycle_) {
+      for (Node* node : topo_order_) {
+        schedule(node);
+      }
+    } else {
+      // Seed the worklist with the sources whose value changed since the
+      // last cycle: input ports with new values and the reads (and writes,
+      // see above) of registers which toggled at the last clock edge.
+      for (InputPort* port : block_->GetInputPorts()) {
+        if (!inputs.contains(port->GetName())) {
+          return absl::InvalidArgumentError(absl::StrFormat(
+              "Missing input for port '%s'", port->GetName()));
+        }
+        if (inputs.at(port->GetName()) != ResolveAsValue(port)) {
+          schedule(port);
+        }
+      }
+      for (const std::string& reg_name : changed_registers_) {
+        for (Node* node : register_users_.at(reg_name)) {
+          schedule(node);
+        }
+      }
+    }
+
+    while (!pending.empty()) {
+      Node* node = topo_order_[pending.top()];
+      pending.pop();
+      Value old_value = HasResult(node) ? ResolveAsValue(node) : Value();
+      // Clear the stale result so SetValueResult accepts the new one.
+      frame_[node->id()] = Value();
+      XLS_RETURN_IF_ERROR(node->VisitSingleNode(this));
+      if (ResolveAsValue(node) != old_value) {
+        for (Node* user : node->users()) {
+          schedule(user);
+        }
+      }
+    }
+
+    absl::flat_hash_map<std::string, Value> outputs;
+    for (Node* port : block_->GetOutputPorts()) {
+      outputs[port->GetName()] = ResolveAsValue(port->operand(0));
+    }
+
+    // Clock edge: advance the register state and record which registers
+    // toggled for seeding the next cycle.
+    changed_registers_.clear();
+    for (auto& [reg_name, next_value] : next_reg_state_) {
+      if (next_value != reg_state_.at(reg_name)) {
+        changed_registers_.push_back(reg_name);
+        reg_state_[reg_name] = next_value;
+      }
+    }
+    first_cycle_ = false;
+    return std::move(outputs);
+  }
+
+  absl::Status HandleInputPort(InputPort* input_port) override {
+    if (!inputs_->contains(input_port->GetName())) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Missing input for port '%s'", input_port->GetName()));
+    }
+    return SetValueResult(input_port, inputs_->at(input_port->GetName()));
+  }
+
+  absl::Status HandleOutputPort(OutputPort* output_port) override {
+    // Output ports have empty tuple types.
+    return SetValueResult(output_port, Value::Tuple({}));
+  }
+
+  absl::Status HandleRegisterRead(RegisterRead* reg_read) override {
+    return SetValueResult(reg_read,
+                          reg_state_.at(reg_read->GetRegister()->name()));
+  }
+
+  absl::Status HandleRegisterWrite(RegisterWrite* reg_write) override {
+    auto get_next_reg_state = [&]() -> Value {
+      if (reg_write->reset().has_value()) {
+        bool reset_signal = ResolveAsBool(reg_write->reset().value());
+        const Reset& reset = reg_write->GetRegister()->reset().value();
+        if ((reset_signal && !reset.active_low) ||
+            (!reset_signal && reset.active_low)) {
+          return reset.reset_value;
+        }
+      }
+      if (reg_write->load_enable().has_value() &&
+          !ResolveAsBool(reg_write->load_enable().value())) {
+        return reg_state_.at(reg_write->GetRegister()->name());
+      }
+      return ResolveAsValue(reg_write->data());
+    };
+
+    next_reg_state_[reg_write->GetRegister()->name()] = get_next_reg_state();
+
+    // Register writes have empty tuple types.
+    return SetValueResult(reg_write, Value::Tuple({}));
+  }
+
+ private:
+  Block* block_;
+
+  // The nodes of the block in topological order and the position of each
+  // node within that order.
+  std::vector<Node*> topo_order_;
+  absl::flat_hash_map<Node*, int64_t> topo_index_;
+
+  // The RegisterRead and RegisterWrite nodes of each register, keyed by
+  // register name.
+  absl::flat_hash_map<std::string, std::vector<Node*>> register_users_;
+
+  // Values fed to the input ports for the cycle being run.
+  const absl::flat_hash_map<std::string, Value>* inputs_ = nullptr;
+
+  // The current and next state of the registers. Entries of next_reg_state_
+  // persist across cycles: a RegisterWrite which is not re-evaluated
+  // necessarily produces the same next value as the previous cycle.
+  absl::flat_hash_map<std::string, Value> reg_state_;
+  absl::flat_hash_map<std::string, Value> next_reg_state_;
+
+  // Names of the registers which changed value at the last clock edge.
+  std::vector<std::string> changed_registers_;
+
+  bool first_cycle_ = true;
+};
+
 }  // namespace
 
 // Converts each uint64_t input to a Value and returns the resulting map. There
@@ -244,6 +422,85 @@ InterpretSequentialBlock(
   return std::move(outputs);
 }
 
+absl::StatusOr<std::vector<absl::flat_hash_map<std::string, Value>>>
+InterpretSequentialBlockEventDriven(
+    Block* block,
+    absl::Span<const absl::flat_hash_map<std::string, Value>> inputs) {
+  // Verify each input corresponds to an input port. The reverse check is made
+  // inside the interpreter as input ports are evaluated.
+  absl::flat_hash_set<std::string> input_port_names;
+  for (InputPort* port : block->GetInputPorts()) {
+    input_port_names.insert(port->GetName());
+  }
+  for (const absl::flat_hash_map<std::string, Value>& input_set : inputs) {
+    for (const auto& [name, value] : input_set) {
+      if (!input_port_names.contains(name)) {
+        return absl::InvalidArgumentError(
+            absl::StrFormat("Block has no input port '%s'", name));
+      }
+    }
+  }
+
+  EventDrivenBlockInterpreter interpreter(block);
+  std::vector<absl::flat_hash_map<std::string, Value>> outputs;
+  for (const absl::flat_hash_map<std::string, Value>& input_set : inputs) {
+    XLS_ASSIGN_OR_RETURN(absl::flat_hash_map<std::string, Value> output_set,
+                         interpreter.RunCycle(input_set));
+    outputs.push_back(std::move(output_set));
+  }
+  return std::move(outputs);
+}
+
+absl::StatusOr<std::vector<absl::flat_hash_map<std::string, Value>>>
+InterpretSequentialBlockWithCapture(
+    Block* block,
+    absl::Span<const absl::flat_hash_map<std::string, Value>> inputs,
+    WaveformCapture* capture) {
+  // One capture column per input port, output port, and register. Values are
+  // flattened to bits; the capture stores a change only when a value toggles.
+  absl::flat_hash_map<std::string, int64_t> input_signals;
+  absl::flat_hash_map<std::string, int64_t> output_signals;
+  absl::flat_hash_map<std::string, int64_t> reg_signals;
+  for (InputPort* port : block->GetInputPorts()) {
+    input_signals[port->GetName()] = capture->AddSignal(
+        port->GetName(), port->GetType()->GetFlatBitCount());
+  }
+  for (OutputPort* port : block->GetOutputPorts()) {
+    output_signals[port->GetName()] = capture->AddSignal(
+        port->GetName(), port->operand(0)->GetType()->GetFlatBitCount());
+  }
+  for (Register* reg : block->GetRegisters()) {
+    reg_signals[reg->name()] =
+        capture->AddSignal(reg->name(), reg->type()->GetFlatBitCount());
+  }
+
+  // Initial register state is zero for all registers.
+  absl::flat_hash_map<std::string, Value> reg_state;
+  for (Register* reg : block->GetRegisters()) {
+    reg_state[reg->name()] = ZeroOfType(reg->type());
+  }
+
+  std::vector<absl::flat_hash_map<std::string, Value>> outputs;
+  int64_t cycle = 0;
+  for (const absl::flat_hash_map<std::string, Value>& input_set : inputs) {
+    XLS_ASSIGN_OR_RETURN(BlockInterpreter::RunResult result,
+                         BlockInterpreter::Run(input_set, reg_state, block));
+    for (const auto& [name, value] : input_set) {
+      capture->RecordValue(input_signals.at(name), cycle, value);
+    }
+    for (const auto& [name, value] : result.outputs) {
+      capture->RecordValue(output_signals.at(name), cycle, value);
+    }
+    for (const auto& [name, value] : result.reg_state) {
+      capture->RecordValue(reg_signals.at(name), cycle, value);
+    }
+    outputs.push_back(std::move(result.outputs));
+    reg_state = std::move(result.reg_state);
+    ++cycle;
+  }
+  return std::move(outputs);
+}
+
 absl::StatusOr<std::vector<absl::flat_hash_map<std::string, uint64_t>>>
 InterpretSequentialBlock(
     Block* block,
@@ -22,6 +22,7 @@
 #include "xls/interpreter/ir_interpreter.h"
 #include "xls/ir/block.h"
 #include "xls/ir/value.h"
+#include "xls/ir/waveform_capture.h"
 
 namespace xls {
 
@@ -52,6 +53,27 @@ InterpretSequentialBlock(
     Block* block,
     absl::Span<const absl::flat_hash_map<std::string, uint64_t>> inputs);
 
+// Event-driven equivalent of InterpretSequentialBlock. Node values are
+// retained from cycle to cycle and a node is only re-evaluated if it is
+// downstream of an input port or register whose value changed, so the cost of
+// each cycle scales with the amount of switching activity rather than the
+// size of the block. Produces identical results to InterpretSequentialBlock.
+absl::StatusOr<std::vector<absl::flat_hash_map<std::string, Value>>>
+InterpretSequentialBlockEventDriven(
+    Block* block,
+    absl::Span<const absl::flat_hash_map<std::string, Value>> inputs);
+
+// As InterpretSequentialBlock, but additionally records the per-cycle values
+// of the input ports, output ports, and registers of the block into
+// `capture`. Signal columns are added to the capture on entry; the capture's
+// change-only encoding keeps overhead proportional to switching activity
+// rather than cycle count.
+absl::StatusOr<std::vector<absl::flat_hash_map<std::string, Value>>>
+InterpretSequentialBlockWithCapture(
+    Block* block,
+    absl::Span<const absl::flat_hash_map<std::string, Value>> inputs,
+    WaveformCapture* capture);
+
 }  // namespace xls
 
 #endif  // XLS_INTERPRETER_BLOCK_INTERPRETER_H_
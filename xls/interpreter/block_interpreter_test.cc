@@ -286,5 +286,81 @@ TEST_F(BlockInterpreterTest, AccumulatorRegister) {
   EXPECT_THAT(outputs.at(4), UnorderedElementsAre(Pair("out", 15)));
 }
 
+TEST_F(BlockInterpreterTest, EventDrivenPipelinedAdder) {
+  auto package = CreatePackage();
+  BlockBuilder b(TestName(), package.get());
+  XLS_ASSERT_OK(b.block()->AddClockPort("clk"));
+
+  BValue x = b.InputPort("x", package->GetBitsType(32));
+  BValue y = b.InputPort("y", package->GetBitsType(32));
+
+  BValue x_d = b.InsertRegister("x_d", x);
+  BValue y_d = b.InsertRegister("y_d", y);
+
+  BValue x_plus_y = b.Add(x_d, y_d);
+
+  BValue x_plus_y_d = b.InsertRegister("x_plus_y_d", x_plus_y);
+
+  b.OutputPort("out", x_plus_y_d);
+
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  // Includes runs of identical inputs during which little of the block is
+  // re-evaluated.
+  std::vector<absl::flat_hash_map<std::string, Value>> inputs;
+  for (uint64_t x_value : {1, 1, 1, 42, 42, 0, 0, 0}) {
+    inputs.push_back({{"x", Value(UBits(x_value, 32))},
+                      {"y", Value(UBits(2 * x_value, 32))}});
+  }
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto expected, InterpretSequentialBlock(
+                                              block, absl::MakeSpan(inputs)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto outputs,
+      InterpretSequentialBlockEventDriven(block, absl::MakeSpan(inputs)));
+  EXPECT_EQ(outputs, expected);
+}
+
+TEST_F(BlockInterpreterTest, EventDrivenRegisterWithResetAndLoadEnable) {
+  auto package = CreatePackage();
+  BlockBuilder b(TestName(), package.get());
+  XLS_ASSERT_OK(b.block()->AddClockPort("clk"));
+
+  BValue x = b.InputPort("x", package->GetBitsType(32));
+  BValue rst = b.InputPort("rst", package->GetBitsType(1));
+  BValue le = b.InputPort("le", package->GetBitsType(1));
+
+  BValue x_d =
+      b.InsertRegister("x_d", x, rst,
+                       Reset{Value(UBits(42, 32)), /*asynchronous=*/false,
+                             /*active_low=*/false},
+                       le);
+
+  b.OutputPort("out", x_d);
+
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  std::vector<absl::flat_hash_map<std::string, Value>> inputs;
+  auto input_set = [](uint64_t rst_value, uint64_t le_value,
+                      uint64_t x_value) -> absl::flat_hash_map<std::string, Value> {
+    return {{"rst", Value(UBits(rst_value, 1))},
+            {"le", Value(UBits(le_value, 1))},
+            {"x", Value(UBits(x_value, 32))}};
+  };
+  inputs.push_back(input_set(0, 1, 1));
+  inputs.push_back(input_set(0, 0, 2));
+  inputs.push_back(input_set(0, 0, 3));
+  inputs.push_back(input_set(1, 0, 4));
+  inputs.push_back(input_set(0, 1, 5));
+  inputs.push_back(input_set(0, 0, 5));
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto expected, InterpretSequentialBlock(
+                                              block, absl::MakeSpan(inputs)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto outputs,
+      InterpretSequentialBlockEventDriven(block, absl::MakeSpan(inputs)));
+  EXPECT_EQ(outputs, expected);
+}
+
 }  // namespace
 }  // namespace xls
@@ -0,0 +1,231 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/interpreter/bytecode_interpreter.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/interpreter/ir_interpreter.h"
+#include "xls/ir/bits_ops.h"
+#include "xls/ir/node_iterator.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/op.h"
+
+namespace xls {
+
+absl::StatusOr<std::unique_ptr<BytecodeInterpreter>>
+BytecodeInterpreter::Create(Function* function) {
+  auto interpreter = absl::WrapUnique(new BytecodeInterpreter(function));
+  XLS_RETURN_IF_ERROR(interpreter->Compile());
+  return interpreter;
+}
+
+absl::Status BytecodeInterpreter::Compile() {
+  absl::flat_hash_map<Node*, int32_t> slot_of_node;
+  for (Node* node : TopoSort(function_)) {
+    if (node->Is<Assert>() || node->Is<Trace>() || node->Is<Cover>()) {
+      return absl::UnimplementedError(absl::StrCat(
+          "BytecodeInterpreter does not support side-effecting op in node: ",
+          node->ToString()));
+    }
+    Instruction instruction;
+    instruction.node = node;
+    if (node->Is<Param>()) {
+      // Parameters read straight from the argument span; the "operand" is the
+      // parameter's index.
+      XLS_ASSIGN_OR_RETURN(int64_t param_index,
+                           function_->GetParamIndex(node->As<Param>()));
+      instruction.operand_slots.push_back(static_cast<int32_t>(param_index));
+    } else {
+      instruction.operand_slots.reserve(node->operand_count());
+      for (Node* operand : node->operands()) {
+        instruction.operand_slots.push_back(slot_of_node.at(operand));
+      }
+    }
+    instruction.result_slot = static_cast<int32_t>(program_.size());
+    slot_of_node[node] = instruction.result_slot;
+    program_.push_back(std::move(instruction));
+  }
+  return_slot_ = slot_of_node.at(function_->return_value());
+  return absl::OkStatus();
+}
+
+absl::StatusOr<InterpreterResult<Value>> BytecodeInterpreter::Run(
+    absl::Span<const Value> args) {
+  XLS_RET_CHECK_EQ(args.size(), function_->params().size());
+  std::vector<Value> slots(program_.size());
+
+  // Scratch space reused across instructions for the ops which take a
+  // std::vector<Bits> or a gathered operand span.
+  std::vector<Bits> bits_operands;
+  std::vector<Value> value_operands;
+
+  for (const Instruction& instruction : program_) {
+    Node* node = instruction.node;
+    absl::Span<const int32_t> ops = instruction.operand_slots;
+    Value& result = slots[instruction.result_slot];
+
+    // Returns the i'th operand as Bits; only call on bits-typed operands.
+    auto bits_op = [&](int64_t i) -> const Bits& {
+      return slots[ops[i]].bits();
+    };
+
+    switch (node->op()) {
+      case Op::kParam:
+        result = args[ops[0]];
+        break;
+      case Op::kLiteral:
+        result = node->As<Literal>()->value();
+        break;
+      case Op::kIdentity:
+        result = slots[ops[0]];
+        break;
+      case Op::kAdd:
+        result = Value(bits_ops::Add(bits_op(0), bits_op(1)));
+        break;
+      case Op::kSub:
+        result = Value(bits_ops::Sub(bits_op(0), bits_op(1)));
+        break;
+      case Op::kNeg:
+        result = Value(bits_ops::Negate(bits_op(0)));
+        break;
+      case Op::kNot:
+        result = Value(bits_ops::Not(bits_op(0)));
+        break;
+      case Op::kAnd:
+      case Op::kOr:
+      case Op::kXor:
+      case Op::kNand:
+      case Op::kNor: {
+        bits_operands.clear();
+        for (int32_t slot : ops) {
+          bits_operands.push_back(slots[slot].bits());
+        }
+        switch (node->op()) {
+          case Op::kAnd:
+            result = Value(bits_ops::NaryAnd(bits_operands));
+            break;
+          case Op::kOr:
+            result = Value(bits_ops::NaryOr(bits_operands));
+            break;
+          case Op::kXor:
+            result = Value(bits_ops::NaryXor(bits_operands));
+            break;
+          case Op::kNand:
+            result = Value(bits_ops::NaryNand(bits_operands));
+            break;
+          default:
+            result = Value(bits_ops::NaryNor(bits_operands));
+            break;
+        }
+        break;
+      }
+      case Op::kEq:
+        if (!node->operand(0)->GetType()->IsBits()) {
+          break;  // Falls through to the generic path below.
+        }
+        result = Value(UBits(bits_op(0) == bits_op(1) ? 1 : 0, 1));
+        break;
+      case Op::kNe:
+        if (!node->operand(0)->GetType()->IsBits()) {
+          break;
+        }
+        result = Value(UBits(bits_op(0) != bits_op(1) ? 1 : 0, 1));
+        break;
+      case Op::kULt:
+        result = Value(UBits(bits_ops::ULessThan(bits_op(0), bits_op(1)), 1));
+        break;
+      case Op::kULe:
+        result = Value(
+            UBits(bits_ops::ULessThanOrEqual(bits_op(0), bits_op(1)), 1));
+        break;
+      case Op::kUGt:
+        result =
+            Value(UBits(bits_ops::UGreaterThan(bits_op(0), bits_op(1)), 1));
+        break;
+      case Op::kUGe:
+        result = Value(
+            UBits(bits_ops::UGreaterThanOrEqual(bits_op(0), bits_op(1)), 1));
+        break;
+      case Op::kSLt:
+        result = Value(UBits(bits_ops::SLessThan(bits_op(0), bits_op(1)), 1));
+        break;
+      case Op::kSLe:
+        result = Value(
+            UBits(bits_ops::SLessThanOrEqual(bits_op(0), bits_op(1)), 1));
+        break;
+      case Op::kSGt:
+        result =
+            Value(UBits(bits_ops::SGreaterThan(bits_op(0), bits_op(1)), 1));
+        break;
+      case Op::kSGe:
+        result = Value(
+            UBits(bits_ops::SGreaterThanOrEqual(bits_op(0), bits_op(1)), 1));
+        break;
+      case Op::kConcat: {
+        bits_operands.clear();
+        for (int32_t slot : ops) {
+          bits_operands.push_back(slots[slot].bits());
+        }
+        result = Value(bits_ops::Concat(bits_operands));
+        break;
+      }
+      case Op::kZeroExt:
+        result = Value(bits_ops::ZeroExtend(
+            bits_op(0), node->As<ExtendOp>()->new_bit_count()));
+        break;
+      case Op::kSignExt:
+        result = Value(bits_ops::SignExtend(
+            bits_op(0), node->As<ExtendOp>()->new_bit_count()));
+        break;
+      case Op::kBitSlice: {
+        BitSlice* bit_slice = node->As<BitSlice>();
+        result =
+            Value(bits_op(0).Slice(bit_slice->start(), bit_slice->width()));
+        break;
+      }
+      case Op::kTuple: {
+        value_operands.clear();
+        for (int32_t slot : ops) {
+          value_operands.push_back(slots[slot]);
+        }
+        result = Value::Tuple(value_operands);
+        break;
+      }
+      case Op::kTupleIndex:
+        result = slots[ops[0]].element(node->As<TupleIndex>()->index());
+        break;
+      default:
+        break;
+    }
+
+    if (result.kind() == ValueKind::kInvalid) {
+      // Uncommon op (or a compound-typed comparison): evaluate it with the
+      // generic single-node interpreter using the pre-resolved operands.
+      value_operands.clear();
+      for (int32_t slot : ops) {
+        value_operands.push_back(slots[slot]);
+      }
+      XLS_ASSIGN_OR_RETURN(result, InterpretNode(node, value_operands));
+    }
+  }
+
+  return InterpreterResult<Value>{slots[return_slot_], InterpreterEvents()};
+}
+
+}  // namespace xls
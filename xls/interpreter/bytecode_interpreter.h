@@ -0,0 +1,74 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_INTERPRETER_BYTECODE_INTERPRETER_H_
+#define XLS_INTERPRETER_BYTECODE_INTERPRETER_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/ir/events.h"
+#include "xls/ir/function.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+
+// An execution tier between the tree-walking IrInterpreter and the LLVM JIT.
+// Create() compiles a Function once into a linear sequence of instructions
+// with pre-resolved operand slots; Run() then evaluates that sequence with a
+// tight dispatch loop over a flat value array, with no per-node visitor
+// dispatch or operand hash lookups. Compilation is cheap (one pass over the
+// nodes), so this tier pays off even for one-shot evaluations where LLVM
+// compilation would dominate, while repeated evaluations run several times
+// faster than the tree walk.
+//
+// Functions containing side-effecting assert or trace operations are not
+// supported and are rejected by Create(); use the IrInterpreter or the JIT
+// for those.
+class BytecodeInterpreter {
+ public:
+  static absl::StatusOr<std::unique_ptr<BytecodeInterpreter>> Create(
+      Function* function);
+
+  // Evaluates the compiled function against the given arguments. Run() may be
+  // called any number of times; calls are not thread-safe with respect to
+  // each other.
+  absl::StatusOr<InterpreterResult<Value>> Run(absl::Span<const Value> args);
+
+  Function* function() const { return function_; }
+
+ private:
+  // One step of the compiled program. The common-op fast paths in Run() read
+  // operand values straight out of the slot array via these pre-resolved
+  // indices; everything else falls back to InterpretNode() with the same
+  // operand values.
+  struct Instruction {
+    Node* node;
+    std::vector<int32_t> operand_slots;
+    int32_t result_slot;
+  };
+
+  explicit BytecodeInterpreter(Function* function) : function_(function) {}
+  absl::Status Compile();
+
+  Function* function_;
+  std::vector<Instruction> program_;
+  int32_t return_slot_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_INTERPRETER_BYTECODE_INTERPRETER_H_
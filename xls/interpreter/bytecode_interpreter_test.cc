@@ -0,0 +1,129 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/interpreter/bytecode_interpreter.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/interpreter/function_interpreter.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+using status_testing::StatusIs;
+
+// Runs both the bytecode interpreter and the tree-walking interpreter on the
+// given function and expects identical results.
+void ExpectMatchesInterpreter(Function* function,
+                              absl::Span<const Value> args) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto bytecode,
+                           BytecodeInterpreter::Create(function));
+  XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> bytecode_result,
+                           bytecode->Run(args));
+  XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> reference_result,
+                           InterpretFunction(function, args));
+  EXPECT_EQ(bytecode_result.value, reference_result.value);
+}
+
+TEST(BytecodeInterpreterTest, FastPathOps) {
+  const std::string ir_text = R"(
+fn fast_path(x: bits[16], y: bits[16]) -> bits[17] {
+  add.3: bits[16] = add(x, y)
+  sub.4: bits[16] = sub(add.3, y)
+  and.5: bits[16] = and(add.3, sub.4)
+  not.6: bits[16] = not(and.5)
+  ult.7: bits[1] = ult(x, y)
+  ret concat.8: bits[17] = concat(ult.7, not.6)
+}
+)";
+  Package package("p");
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  ExpectMatchesInterpreter(
+      function, {Value(UBits(1234, 16)), Value(UBits(4321, 16))});
+  ExpectMatchesInterpreter(function,
+                           {Value(UBits(65535, 16)), Value(UBits(1, 16))});
+}
+
+TEST(BytecodeInterpreterTest, FallbackOps) {
+  // sel, umul and shll have no fast path and exercise the generic
+  // InterpretNode() fallback.
+  const std::string ir_text = R"(
+fn fallback(x: bits[8], y: bits[8], p: bits[1]) -> bits[8] {
+  umul.4: bits[8] = umul(x, y)
+  shll.5: bits[8] = shll(x, y)
+  ret sel.6: bits[8] = sel(p, cases=[umul.4, shll.5])
+}
+)";
+  Package package("p");
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  for (uint64_t p = 0; p < 2; p++) {
+    ExpectMatchesInterpreter(function, {Value(UBits(7, 8)), Value(UBits(3, 8)),
+                                        Value(UBits(p, 1))});
+  }
+}
+
+TEST(BytecodeInterpreterTest, CompoundTypes) {
+  const std::string ir_text = R"(
+fn compound(x: bits[8], y: bits[8]) -> bits[8] {
+  tuple.3: (bits[8], bits[8]) = tuple(x, y)
+  tuple_index.4: bits[8] = tuple_index(tuple.3, index=1)
+  ret identity.5: bits[8] = identity(tuple_index.4)
+}
+)";
+  Package package("p");
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  ExpectMatchesInterpreter(function,
+                           {Value(UBits(12, 8)), Value(UBits(34, 8))});
+}
+
+TEST(BytecodeInterpreterTest, RepeatedRuns) {
+  const std::string ir_text = R"(
+fn double(x: bits[32]) -> bits[32] {
+  ret add.2: bits[32] = add(x, x)
+}
+)";
+  Package package("p");
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(auto bytecode,
+                           BytecodeInterpreter::Create(function));
+  for (int i = 0; i < 10; i++) {
+    XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> result,
+                             bytecode->Run({Value(UBits(i, 32))}));
+    EXPECT_EQ(result.value, Value(UBits(2 * i, 32)));
+  }
+}
+
+TEST(BytecodeInterpreterTest, RejectsAssert) {
+  const std::string ir_text = R"(
+fn asserts(tkn: token, x: bits[1]) -> token {
+  ret assert.3: token = assert(tkn, x, message="boom")
+}
+)";
+  Package package("p");
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  EXPECT_THAT(BytecodeInterpreter::Create(function),
+              StatusIs(absl::StatusCode::kUnimplemented));
+}
+
+}  // namespace
+}  // namespace xls
@@ -24,6 +24,28 @@
 
 namespace xls {
 
+absl::Status ChannelQueue::EnqueueAll(absl::Span<const Value> values) {
+  for (const Value& value : values) {
+    XLS_RETURN_IF_ERROR(Enqueue(value));
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::vector<Value>> ChannelQueue::DequeueAll(int64_t count) {
+  if (size() < count) {
+    return absl::NotFoundError(absl::StrFormat(
+        "Attempting to dequeue %d values from channel %s (%d) holding only %d",
+        count, channel_->name(), channel_->id(), size()));
+  }
+  std::vector<Value> values;
+  values.reserve(count);
+  for (int64_t i = 0; i < count; ++i) {
+    XLS_ASSIGN_OR_RETURN(Value value, Dequeue());
+    values.push_back(std::move(value));
+  }
+  return std::move(values);
+}
+
 absl::Status FifoChannelQueue::Enqueue(const Value& value) {
   XLS_VLOG(4) << absl::StreamFormat("Enqueuing value on channel %s: { %s }",
                                     channel_->name(), value.ToString());
@@ -40,12 +62,14 @@ absl::Status FifoChannelQueue::Enqueue(const Value& value) {
 }
 
 absl::StatusOr<Value> FifoChannelQueue::Dequeue() {
-  if (empty()) {
+  // The emptiness check must be made under the same lock as the pop so a
+  // concurrent dequeuer cannot drain the queue in between.
+  absl::MutexLock lock(&mutex_);
+  if (queue_.empty()) {
     return absl::NotFoundError(
         absl::StrFormat("Attempting to dequeue data from empty channel %s (%d)",
                         channel_->name(), channel_->id()));
   }
-  absl::MutexLock lock(&mutex_);
   Value value = queue_.front();
   queue_.pop_front();
   XLS_VLOG(4) << absl::StreamFormat("Dequeuing data on channel %s: %s",
@@ -95,6 +119,76 @@ absl::StatusOr<Value> SingleValueChannelQueue::Dequeue() {
   return value_.value();
 }
 
+absl::Status RingBufferChannelQueue::EnqueueInternal(const Value& value) {
+  if (!ValueConformsToType(value, channel_->type())) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Channel %s expects values to have type %s, got: %s", channel_->name(),
+        channel_->type()->ToString(), value.ToString()));
+  }
+  if (size_ == capacity()) {
+    return absl::ResourceExhaustedError(
+        absl::StrFormat("Queue for channel %s (%d) is full (capacity %d)",
+                        channel_->name(), channel_->id(), capacity()));
+  }
+  slots_[(head_ + size_) % capacity()] = value;
+  ++size_;
+  return absl::OkStatus();
+}
+
+Value RingBufferChannelQueue::DequeueInternal() {
+  Value value = std::move(slots_[head_]);
+  head_ = (head_ + 1) % capacity();
+  --size_;
+  return value;
+}
+
+absl::Status RingBufferChannelQueue::Enqueue(const Value& value) {
+  XLS_VLOG(4) << absl::StreamFormat("Enqueuing value on channel %s: { %s }",
+                                    channel_->name(), value.ToString());
+  absl::MutexLock lock(&mutex_);
+  return EnqueueInternal(value);
+}
+
+absl::StatusOr<Value> RingBufferChannelQueue::Dequeue() {
+  absl::MutexLock lock(&mutex_);
+  if (size_ == 0) {
+    return absl::NotFoundError(
+        absl::StrFormat("Attempting to dequeue data from empty channel %s (%d)",
+                        channel_->name(), channel_->id()));
+  }
+  return DequeueInternal();
+}
+
+absl::Status RingBufferChannelQueue::EnqueueAll(absl::Span<const Value> values) {
+  absl::MutexLock lock(&mutex_);
+  if (size_ + static_cast<int64_t>(values.size()) > capacity()) {
+    return absl::ResourceExhaustedError(absl::StrFormat(
+        "Cannot enqueue %d values on queue for channel %s (%d) holding %d of "
+        "capacity %d",
+        values.size(), channel_->name(), channel_->id(), size_, capacity()));
+  }
+  for (const Value& value : values) {
+    XLS_RETURN_IF_ERROR(EnqueueInternal(value));
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::vector<Value>> RingBufferChannelQueue::DequeueAll(
+    int64_t count) {
+  absl::MutexLock lock(&mutex_);
+  if (size_ < count) {
+    return absl::NotFoundError(absl::StrFormat(
+        "Attempting to dequeue %d values from channel %s (%d) holding only %d",
+        count, channel_->name(), channel_->id(), size_));
+  }
+  std::vector<Value> values;
+  values.reserve(count);
+  for (int64_t i = 0; i < count; ++i) {
+    values.push_back(DequeueInternal());
+  }
+  return std::move(values);
+}
+
 static bool IsSingleValueChannelQueue(ChannelQueue* queue) {
   return dynamic_cast<SingleValueChannelQueue*>(queue) != nullptr;
 }
@@ -103,7 +197,13 @@ static bool IsSingleValueChannelQueue(ChannelQueue* queue) {
 absl::StatusOr<std::unique_ptr<ChannelQueueManager>>
 ChannelQueueManager::Create(
     std::vector<std::unique_ptr<ChannelQueue>>&& user_defined_queues,
-    Package* package) {
+    Package* package, int64_t streaming_queue_capacity) {
+  if (streaming_queue_capacity != kUnboundedQueueCapacity &&
+      streaming_queue_capacity <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Streaming queue capacity must be positive, got %d",
+                        streaming_queue_capacity));
+  }
   auto manager = absl::WrapUnique(new ChannelQueueManager(package));
 
   // Verify there is an receive-only queue for every ReceiveOnly channel in the
@@ -154,8 +254,11 @@ ChannelQueueManager::Create(
     if (channel->kind() == ChannelKind::kSingleValue) {
       manager->queues_[channel] =
           std::make_unique<SingleValueChannelQueue>(channel);
-    } else {
+    } else if (streaming_queue_capacity == kUnboundedQueueCapacity) {
       manager->queues_[channel] = std::make_unique<FifoChannelQueue>(channel);
+    } else {
+      manager->queues_[channel] = std::make_unique<RingBufferChannelQueue>(
+          channel, streaming_queue_capacity);
     }
   }
 
@@ -21,6 +21,7 @@
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/package.h"
 #include "xls/ir/value.h"
@@ -29,8 +30,9 @@ namespace xls {
 
 // Abstract base class for queues which represent channels during IR
 // interpretation. During interpretation of a network of procs each channel is
-// backed by exactly one ChannelQueue. ChannelQueues are thread-compatible, but
-// not thread-safe.
+// backed by exactly one ChannelQueue. The concrete queues defined below are
+// thread-safe so queues of distinct channels may be accessed concurrently from
+// procs running on different threads.
 class ChannelQueue {
  public:
   ChannelQueue(Channel* channel)
@@ -60,12 +62,22 @@ class ChannelQueue {
   // channel is empty.
   virtual absl::StatusOr<Value> Dequeue() = 0;
 
+  // Enqueues all of the given values on to the channel. The default
+  // implementation enqueues one value at a time; queues with cheaper batch
+  // paths (e.g., RingBufferChannelQueue) override this to pay for the lock
+  // only once.
+  virtual absl::Status EnqueueAll(absl::Span<const Value> values);
+
+  // Dequeues and returns 'count' values from the channel. Returns an error if
+  // the channel holds fewer than 'count' values.
+  virtual absl::StatusOr<std::vector<Value>> DequeueAll(int64_t count);
+
  protected:
   Channel* channel_;
 };
 
 // A queue representing an arbitrary-depth FIFO. This matches the abstract
-// semantics of streaming channels. FifoChannelQueues are thread--safe.
+// semantics of streaming channels. FifoChannelQueues are thread-safe.
 class FifoChannelQueue : public ChannelQueue {
  public:
   FifoChannelQueue(Channel* channel) : ChannelQueue(channel) {}
@@ -97,6 +109,51 @@ class FifoChannelQueue : public ChannelQueue {
   mutable absl::Mutex mutex_;
 };
 
+// A fixed-capacity FIFO queue backed by a ring buffer whose element slots are
+// preallocated in a single slab at construction time, so steady-state
+// enqueue/dequeue does no allocation for the queue structure itself. Matches
+// the semantics of streaming channels up to the capacity; enqueuing on to a
+// full queue returns an error. RingBufferChannelQueues are thread-safe.
+class RingBufferChannelQueue : public ChannelQueue {
+ public:
+  RingBufferChannelQueue(Channel* channel, int64_t capacity)
+      : ChannelQueue(channel), slots_(capacity) {}
+  virtual ~RingBufferChannelQueue() = default;
+
+  // Returns the maximum number of elements the queue can hold.
+  int64_t capacity() const { return slots_.size(); }
+
+  int64_t size() const override {
+    absl::MutexLock lock(&mutex_);
+    return size_;
+  }
+
+  bool empty() const override {
+    absl::MutexLock lock(&mutex_);
+    return size_ == 0;
+  }
+
+  absl::Status Enqueue(const Value& value) override;
+  absl::StatusOr<Value> Dequeue() override;
+
+  // Batch operations which acquire the lock a single time for all elements.
+  absl::Status EnqueueAll(absl::Span<const Value> values) override;
+  absl::StatusOr<std::vector<Value>> DequeueAll(int64_t count) override;
+
+ protected:
+  absl::Status EnqueueInternal(const Value& value)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  Value DequeueInternal() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // The preallocated element slots. Elements occupy the 'size_' slots
+  // beginning at 'head_' and wrapping around the end of the vector.
+  std::vector<Value> slots_ ABSL_GUARDED_BY(mutex_);
+  int64_t head_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t size_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  mutable absl::Mutex mutex_;
+};
+
 // A queue backing a receive-only channel. Receive-only channels provide inputs
 // to a network of procs and are enqueued by components outside of XLS.
 class GeneratedChannelQueue : public ChannelQueue {
@@ -181,14 +238,21 @@ class SingleValueChannelQueue : public ChannelQueue {
 // convenience methods.
 class ChannelQueueManager {
  public:
+  // Sentinel value for streaming_queue_capacity indicating streaming channel
+  // queues should be unbounded (deque-backed).
+  static constexpr int64_t kUnboundedQueueCapacity = -1;
+
   // Creates and returns a queue manager for the given package.
   // user_defined_queues can optionally contain user-constructed queues to use
   // with some or all of the receive-only channels. This is useful for testing
   // where the test may want to use a GeneratedChannelQueue or FixedChannelQueue
-  // to feed inputs to the test.
+  // to feed inputs to the test. If streaming_queue_capacity is not
+  // kUnboundedQueueCapacity then streaming channels without a user-defined
+  // queue are backed by RingBufferChannelQueues of the given capacity.
   static absl::StatusOr<std::unique_ptr<ChannelQueueManager>> Create(
       std::vector<std::unique_ptr<ChannelQueue>>&& user_defined_queues,
-      Package* package);
+      Package* package,
+      int64_t streaming_queue_capacity = kUnboundedQueueCapacity);
 
   // Get the channel queue associated with the channel with the given id/name.
   ChannelQueue& GetQueue(Channel* channel) { return *queues_.at(channel); }
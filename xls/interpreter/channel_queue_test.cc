@@ -60,6 +60,110 @@ TEST_F(ChannelQueueTest, FifoChannelQueueTest) {
   EXPECT_TRUE(queue.empty());
 }
 
+TEST_F(ChannelQueueTest, RingBufferChannelQueueTest) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  RingBufferChannelQueue queue(channel, /*capacity=*/3);
+  EXPECT_EQ(queue.channel(), channel);
+  EXPECT_EQ(queue.capacity(), 3);
+  EXPECT_EQ(queue.size(), 0);
+  EXPECT_TRUE(queue.empty());
+
+  // Fill, drain, and refill the queue so the contents wrap around the
+  // underlying buffer.
+  for (int64_t offset : {0, 100, 200}) {
+    XLS_ASSERT_OK(queue.Enqueue(Value(UBits(offset + 1, 32))));
+    XLS_ASSERT_OK(queue.Enqueue(Value(UBits(offset + 2, 32))));
+    XLS_ASSERT_OK(queue.Enqueue(Value(UBits(offset + 3, 32))));
+    EXPECT_EQ(queue.size(), 3);
+
+    EXPECT_THAT(queue.Enqueue(Value(UBits(0, 32))),
+                StatusIs(absl::StatusCode::kResourceExhausted,
+                         HasSubstr("full (capacity 3)")));
+
+    EXPECT_THAT(queue.Dequeue(), IsOkAndHolds(Value(UBits(offset + 1, 32))));
+    EXPECT_THAT(queue.Dequeue(), IsOkAndHolds(Value(UBits(offset + 2, 32))));
+    EXPECT_THAT(queue.Dequeue(), IsOkAndHolds(Value(UBits(offset + 3, 32))));
+    EXPECT_TRUE(queue.empty());
+  }
+
+  EXPECT_THAT(
+      queue.Dequeue(),
+      StatusIs(
+          absl::StatusCode::kNotFound,
+          HasSubstr(
+              "Attempting to dequeue data from empty channel my_channel")));
+}
+
+TEST_F(ChannelQueueTest, RingBufferBatchOperations) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  RingBufferChannelQueue queue(channel, /*capacity=*/4);
+
+  std::vector<Value> values = {Value(UBits(1, 32)), Value(UBits(2, 32)),
+                               Value(UBits(3, 32))};
+  XLS_ASSERT_OK(queue.EnqueueAll(values));
+  EXPECT_EQ(queue.size(), 3);
+
+  // A batch which does not fit is rejected without enqueuing anything.
+  EXPECT_THAT(queue.EnqueueAll(values),
+              StatusIs(absl::StatusCode::kResourceExhausted,
+                       HasSubstr("Cannot enqueue 3 values")));
+  EXPECT_EQ(queue.size(), 3);
+
+  EXPECT_THAT(queue.DequeueAll(4),
+              StatusIs(absl::StatusCode::kNotFound,
+                       HasSubstr("holding only 3")));
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Value> dequeued, queue.DequeueAll(3));
+  EXPECT_EQ(dequeued, values);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(ChannelQueueTest, FifoBatchOperations) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  FifoChannelQueue queue(channel);
+
+  std::vector<Value> values = {Value(UBits(10, 32)), Value(UBits(20, 32))};
+  XLS_ASSERT_OK(queue.EnqueueAll(values));
+  EXPECT_EQ(queue.size(), 2);
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Value> dequeued, queue.DequeueAll(2));
+  EXPECT_EQ(dequeued, values);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(ChannelQueueTest, ManagerWithRingBufferQueues) {
+  Package package(TestName());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ChannelQueueManager> manager,
+      ChannelQueueManager::Create(/*user_defined_queues=*/{}, &package,
+                                  /*streaming_queue_capacity=*/2));
+  ChannelQueue& queue = manager->GetQueue(channel);
+  XLS_ASSERT_OK(queue.Enqueue(Value(UBits(1, 32))));
+  XLS_ASSERT_OK(queue.Enqueue(Value(UBits(2, 32))));
+  EXPECT_THAT(queue.Enqueue(Value(UBits(3, 32))),
+              StatusIs(absl::StatusCode::kResourceExhausted,
+                       HasSubstr("full (capacity 2)")));
+
+  EXPECT_THAT(ChannelQueueManager::Create(/*user_defined_queues=*/{}, &package,
+                                          /*streaming_queue_capacity=*/0),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("capacity must be positive")));
+}
+
 TEST_F(ChannelQueueTest, ErrorConditions) {
   Package package(TestName());
   XLS_ASSERT_OK_AND_ASSIGN(
@@ -24,8 +24,11 @@ namespace {
 // An interpreter for XLS functions.
 class FunctionInterpreter : public IrInterpreter {
  public:
-  explicit FunctionInterpreter(absl::Span<const Value> args)
-      : args_(args.begin(), args.end()) {}
+  FunctionInterpreter(Function* function, absl::Span<const Value> args,
+                      absl::Span<FunctionMemoCache* const> memo_caches)
+      : IrInterpreter(function), args_(args.begin(), args.end()) {
+    SetMemoCaches(memo_caches);
+  }
 
   absl::Status HandleParam(Param* param) override {
     XLS_ASSIGN_OR_RETURN(int64_t index,
@@ -45,8 +48,33 @@ class FunctionInterpreter : public IrInterpreter {
 
 }  // namespace
 
+const InterpreterResult<Value>* FunctionMemoCache::Lookup(
+    const std::vector<Value>& args) {
+  auto it = cache_.find(args);
+  if (it == cache_.end()) {
+    ++miss_count_;
+    return nullptr;
+  }
+  ++hit_count_;
+  return &it->second;
+}
+
+void FunctionMemoCache::Insert(std::vector<Value> args,
+                               InterpreterResult<Value> result) {
+  if (static_cast<int64_t>(cache_.size()) >= max_entries_) {
+    cache_.clear();
+  }
+  cache_.insert({std::move(args), std::move(result)});
+}
+
 absl::StatusOr<InterpreterResult<Value>> InterpretFunction(
     Function* function, absl::Span<const Value> args) {
+  return InterpretFunctionWithMemo(function, args, /*memo_caches=*/{});
+}
+
+absl::StatusOr<InterpreterResult<Value>> InterpretFunctionWithMemo(
+    Function* function, absl::Span<const Value> args,
+    absl::Span<FunctionMemoCache* const> memo_caches) {
   XLS_VLOG(3) << "Interpreting function " << function->name();
   if (args.size() != function->params().size()) {
     return absl::InvalidArgumentError(absl::StrFormat(
@@ -64,12 +92,34 @@ absl::StatusOr<InterpreterResult<Value>> InterpretFunction(
           value.ToString(), argno, param_type->ToString()));
     }
   }
-  FunctionInterpreter visitor(args);
+
+  FunctionMemoCache* cache = nullptr;
+  for (FunctionMemoCache* c : memo_caches) {
+    if (c->function() == function) {
+      cache = c;
+      break;
+    }
+  }
+  std::vector<Value> cache_key;
+  if (cache != nullptr) {
+    cache_key.assign(args.begin(), args.end());
+    if (const InterpreterResult<Value>* hit = cache->Lookup(cache_key)) {
+      XLS_VLOG(3) << "Memoized result = " << hit->value;
+      return *hit;
+    }
+  }
+
+  FunctionInterpreter visitor(function, args, memo_caches);
   XLS_RETURN_IF_ERROR(function->Accept(&visitor));
   Value result = visitor.ResolveAsValue(function->return_value());
   XLS_VLOG(2) << "Result = " << result;
   InterpreterEvents events = visitor.GetInterpreterEvents();
-  return InterpreterResult<Value>{std::move(result), std::move(events)};
+  InterpreterResult<Value> interpreter_result{std::move(result),
+                                              std::move(events)};
+  if (cache != nullptr) {
+    cache->Insert(std::move(cache_key), interpreter_result);
+  }
+  return interpreter_result;
 }
 
 /* static */
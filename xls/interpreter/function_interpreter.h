@@ -15,6 +15,8 @@
 #ifndef XLS_INTERPRETER_FUNCTION_INTERPRETER_H_
 #define XLS_INTERPRETER_FUNCTION_INTERPRETER_H_
 
+#include <vector>
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -25,12 +27,58 @@
 
 namespace xls {
 
+// A bounded memoization cache for interpretation of a single pure function.
+// Caches the complete interpreter result (value and events) keyed by the
+// argument values, so repeated calls with identical arguments skip
+// re-evaluation entirely. Functions are deterministic so cached events are
+// identical to re-evaluated ones. When the cache reaches its maximum size it
+// is flushed, keeping memory bounded under adversarial argument streams.
+class FunctionMemoCache {
+ public:
+  static constexpr int64_t kDefaultMaxEntries = 1 << 16;
+
+  explicit FunctionMemoCache(Function* function,
+                             int64_t max_entries = kDefaultMaxEntries)
+      : function_(function), max_entries_(max_entries) {}
+
+  Function* function() const { return function_; }
+
+  // Returns the cached result for the given arguments, or nullptr on a
+  // miss. The returned pointer is invalidated by the next Insert.
+  const InterpreterResult<Value>* Lookup(const std::vector<Value>& args);
+
+  // Records the result of interpreting the function with the given arguments.
+  void Insert(std::vector<Value> args, InterpreterResult<Value> result);
+
+  int64_t size() const { return cache_.size(); }
+  int64_t hit_count() const { return hit_count_; }
+  int64_t miss_count() const { return miss_count_; }
+
+ private:
+  Function* function_;
+  int64_t max_entries_;
+  int64_t hit_count_ = 0;
+  int64_t miss_count_ = 0;
+  absl::flat_hash_map<std::vector<Value>, InterpreterResult<Value>> cache_;
+};
+
 // Runs the interpreter on the given function. 'args' are the argument values
 // indexed by parameter name. Returns both the value and any events that
 // happened while running.
 absl::StatusOr<InterpreterResult<Value>> InterpretFunction(
     Function* function, absl::Span<const Value> args);
 
+// As InterpretFunction, but consults (and fills) the given memoization
+// caches. Each cache memoizes calls of its own function: the top-level call
+// if its function is 'function', and any invoke, map, or counted_for
+// evaluation of its function at any depth within the call. Only enable
+// memoization for functions without side-effecting semantics the caller cares
+// to observe repeatedly; cached trace and assert events are replayed
+// verbatim on a hit.
+absl::StatusOr<InterpreterResult<Value>> InterpretFunctionWithMemo(
+    Function* function, absl::Span<const Value> args,
+    absl::Span<FunctionMemoCache* const> memo_caches);
+
 // Runs the interpreter on the function where the arguments are given by name.
 // Returns both the result alue and any events that happened while running.
 absl::StatusOr<InterpreterResult<Value>> InterpretFunctionKwargs(
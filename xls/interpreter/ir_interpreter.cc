@@ -17,6 +17,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
@@ -74,7 +75,7 @@ absl::StatusOr<Value> InterpretNode(Node* node,
 absl::Status IrInterpreter::AddInterpreterEvents(
     const InterpreterEvents& events) {
   for (const std::string& trace_msg : events.trace_msgs) {
-    events_.trace_msgs.push_back(trace_msg);
+    events_.RecordTrace(trace_msg);
   }
 
   for (const std::string& assert_msg : events.assert_msgs) {
@@ -107,31 +108,36 @@ absl::Status IrInterpreter::HandleXorReduce(BitwiseReductionOp* xor_reduce) {
 absl::Status IrInterpreter::HandleNaryAnd(NaryOp* and_op) {
   std::vector<Bits> operands = ResolveAsBitsVector(and_op->operands());
   Bits accum = bits_ops::NaryAnd(operands);
-  return SetBitsResult(and_op, accum);
+  RecycleBits(absl::MakeSpan(operands));
+  return SetBitsResult(and_op, std::move(accum));
 }
 
 absl::Status IrInterpreter::HandleNaryNand(NaryOp* nand_op) {
   std::vector<Bits> operands = ResolveAsBitsVector(nand_op->operands());
   Bits accum = bits_ops::NaryNand(operands);
-  return SetBitsResult(nand_op, accum);
+  RecycleBits(absl::MakeSpan(operands));
+  return SetBitsResult(nand_op, std::move(accum));
 }
 
 absl::Status IrInterpreter::HandleNaryNor(NaryOp* nor_op) {
   std::vector<Bits> operands = ResolveAsBitsVector(nor_op->operands());
   Bits accum = bits_ops::NaryNor(operands);
-  return SetBitsResult(nor_op, accum);
+  RecycleBits(absl::MakeSpan(operands));
+  return SetBitsResult(nor_op, std::move(accum));
 }
 
 absl::Status IrInterpreter::HandleNaryOr(NaryOp* or_op) {
   std::vector<Bits> operands = ResolveAsBitsVector(or_op->operands());
   Bits accum = bits_ops::NaryOr(operands);
-  return SetBitsResult(or_op, accum);
+  RecycleBits(absl::MakeSpan(operands));
+  return SetBitsResult(or_op, std::move(accum));
 }
 
 absl::Status IrInterpreter::HandleNaryXor(NaryOp* xor_op) {
   std::vector<Bits> operands = ResolveAsBitsVector(xor_op->operands());
   Bits accum = bits_ops::NaryXor(operands);
-  return SetBitsResult(xor_op, accum);
+  RecycleBits(absl::MakeSpan(operands));
+  return SetBitsResult(xor_op, std::move(accum));
 }
 
 absl::Status IrInterpreter::HandleAfterAll(AfterAll* after_all) {
@@ -222,13 +228,16 @@ absl::Status IrInterpreter::HandleDynamicBitSlice(
   const Bits& operand = ResolveAsBits(dynamic_bit_slice->operand(0));
   Bits shifted_value = bits_ops::ShiftRightLogical(operand, start);
   Bits truncated_value = shifted_value.Slice(0, dynamic_bit_slice->width());
-  return SetBitsResult(dynamic_bit_slice, truncated_value);
+  return SetBitsResult(dynamic_bit_slice, std::move(truncated_value));
 }
 
 absl::Status IrInterpreter::HandleConcat(Concat* concat) {
-  std::vector<Bits> operand_values;
+  // Gather pointers to the operand values rather than copies; the values
+  // live in the node value map for the duration of the call.
+  std::vector<const Bits*> operand_values;
+  operand_values.reserve(concat->operand_count());
   for (Node* operand : concat->operands()) {
-    operand_values.push_back(ResolveAsBits(operand));
+    operand_values.push_back(&ResolveAsValue(operand).bits());
   }
   return SetBitsResult(concat, bits_ops::Concat(operand_values));
 }
@@ -257,7 +266,7 @@ absl::Status IrInterpreter::HandleCountedFor(CountedFor* counted_for) {
       args_for_body.push_back(value);
     }
     XLS_ASSIGN_OR_RETURN(InterpreterResult<Value> loop_result,
-                         InterpretFunction(body, args_for_body));
+                         InterpretFunctionWithMemo(body, args_for_body, memo_caches_));
     XLS_RETURN_IF_ERROR(AddInterpreterEvents(loop_result.events));
     loop_state = loop_result.value;
   }
@@ -310,10 +319,10 @@ absl::Status IrInterpreter::HandleDynamicCountedFor(
       args_for_body.push_back(value);
     }
     XLS_ASSIGN_OR_RETURN(InterpreterResult<Value> loop_result,
-                         InterpretFunction(body, args_for_body));
+                         InterpretFunctionWithMemo(body, args_for_body, memo_caches_));
     XLS_RETURN_IF_ERROR(AddInterpreterEvents(loop_result.events));
     loop_state = loop_result.value;
-    index = bits_ops::Add(index, extended_stride);
+    bits_ops::AddInto(index, extended_stride, &index);
   }
 
   return SetValueResult(dynamic_counted_for, loop_state);
@@ -321,13 +330,8 @@ absl::Status IrInterpreter::HandleDynamicCountedFor(
 
 absl::Status IrInterpreter::HandleEncode(Encode* encode) {
   const Bits& input = ResolveAsBits(encode->operand(0));
-  Bits result(encode->BitCountOrDie());
-  for (int64_t i = 0; i < input.bit_count(); ++i) {
-    if (input.Get(i)) {
-      result = bits_ops::Or(result, UBits(i, encode->BitCountOrDie()));
-    }
-  }
-  return SetBitsResult(encode, result);
+  return SetBitsResult(encode,
+                       bits_ops::Encode(input, encode->BitCountOrDie()));
 }
 
 absl::Status IrInterpreter::HandleUDiv(BinOp* div) {
@@ -525,7 +529,7 @@ absl::Status IrInterpreter::HandleTrace(Trace* trace_op) {
 
     XLS_VLOG(3) << "Trace output: " << trace_output;
 
-    events_.trace_msgs.push_back(trace_output);
+    events_.RecordTrace(std::move(trace_output));
   }
   return SetValueResult(trace_op, Value::Token());
 }
@@ -542,7 +546,7 @@ absl::Status IrInterpreter::HandleInvoke(Invoke* invoke) {
     args.push_back(ResolveAsValue(invoke->operand(i)));
   }
   XLS_ASSIGN_OR_RETURN(InterpreterResult<Value> result,
-                       InterpretFunction(to_apply, args));
+                       InterpretFunctionWithMemo(to_apply, args, memo_caches_));
   XLS_RETURN_IF_ERROR(AddInterpreterEvents(result.events));
   return SetValueResult(invoke, result.value);
 }
@@ -593,7 +597,7 @@ absl::Status IrInterpreter::HandleMap(Map* map) {
   for (const Value& operand_element :
        ResolveAsValue(map->operand(0)).elements()) {
     XLS_ASSIGN_OR_RETURN(InterpreterResult<Value> result,
-                         InterpretFunction(to_apply, {operand_element}));
+                         InterpretFunctionWithMemo(to_apply, {operand_element}, memo_caches_));
     XLS_RETURN_IF_ERROR(AddInterpreterEvents(result.events));
     results.push_back(result.value);
   }
@@ -610,7 +614,7 @@ absl::Status IrInterpreter::HandleSMul(ArithOp* mul) {
   } else if (result.bit_count() < mul_width) {
     return SetBitsResult(mul, bits_ops::SignExtend(result, mul_width));
   }
-  return SetBitsResult(mul, result);
+  return SetBitsResult(mul, std::move(result));
 }
 
 absl::Status IrInterpreter::HandleUMul(ArithOp* mul) {
@@ -622,7 +626,7 @@ absl::Status IrInterpreter::HandleUMul(ArithOp* mul) {
   } else if (result.bit_count() < mul_width) {
     return SetBitsResult(mul, bits_ops::ZeroExtend(result, mul_width));
   }
-  return SetBitsResult(mul, result);
+  return SetBitsResult(mul, std::move(result));
 }
 
 absl::Status IrInterpreter::HandleNe(CompareOp* ne) {
@@ -641,21 +645,10 @@ absl::Status IrInterpreter::HandleNot(UnOp* not_op) {
 }
 
 absl::Status IrInterpreter::HandleOneHot(OneHot* one_hot) {
-  int64_t output_width = one_hot->BitCountOrDie();
   const Bits& input = ResolveAsBits(one_hot->operand(0));
-  const int64_t input_width = input.bit_count();
-  for (int64_t i = 0; i < input.bit_count(); ++i) {
-    int64_t index =
-        one_hot->priority() == LsbOrMsb::kLsb ? i : input_width - i - 1;
-    if (ResolveAsBits(one_hot->operand(0)).Get(index)) {
-      auto one = UBits(1, /*bit_count=*/output_width);
-      return SetBitsResult(one_hot, bits_ops::ShiftLeftLogical(one, index));
-    }
-  }
-  // No bits of the operand are set so assert the msb of the output indicating
-  // the default value.
-  return SetBitsResult(one_hot, bits_ops::ShiftLeftLogical(
-                                    UBits(1, output_width), output_width - 1));
+  return SetBitsResult(one_hot, one_hot->priority() == LsbOrMsb::kLsb
+                                    ? bits_ops::OneHotLsbToMsb(input)
+                                    : bits_ops::OneHotMsbToLsb(input));
 }
 
 absl::Status IrInterpreter::HandleOneHotSel(OneHotSelect* sel) {
@@ -790,16 +783,24 @@ absl::Status IrInterpreter::SetUint64Result(Node* node, uint64_t result) {
   return SetValueResult(node, Value(UBits(result, node->BitCountOrDie())));
 }
 
-absl::Status IrInterpreter::SetBitsResult(Node* node, const Bits& result) {
+absl::Status IrInterpreter::SetBitsResult(Node* node, Bits result) {
   XLS_RET_CHECK(node->GetType()->IsBits());
   XLS_RET_CHECK_EQ(node->BitCountOrDie(), result.bit_count());
-  return SetValueResult(node, Value(result));
+  return SetValueResult(node, Value(std::move(result)));
+}
+
+IrInterpreter::IrInterpreter(FunctionBase* function_base) {
+  int64_t max_id = 0;
+  for (Node* node : function_base->nodes()) {
+    max_id = std::max(max_id, node->id());
+  }
+  frame_.resize(max_id + 1);
 }
 
 absl::Status IrInterpreter::SetValueResult(Node* node, Value result) {
   if (XLS_VLOG_IS_ON(4) &&
       std::all_of(node->operands().begin(), node->operands().end(),
-                  [this](Node* o) { return node_values_.contains(o); })) {
+                  [this](Node* o) { return HasResult(o); })) {
     XLS_VLOG(4) << absl::StreamFormat("%s operands:", node->GetName());
     for (int64_t i = 0; i < node->operand_count(); ++i) {
       XLS_VLOG(4) << absl::StreamFormat(
@@ -810,13 +811,17 @@ absl::Status IrInterpreter::SetValueResult(Node* node, Value result) {
   XLS_VLOG(3) << absl::StreamFormat("Result of %s: %s", node->ToString(),
                                     result.ToString());
 
-  XLS_RET_CHECK(!node_values_.contains(node));
+  XLS_RET_CHECK(!HasResult(node));
   if (!ValueConformsToType(result, node->GetType())) {
     return absl::InternalError(absl::StrFormat(
         "Expected value %s to match type %s of node %s", result.ToString(),
         node->GetType()->ToString(), node->GetName()));
   }
-  node_values_[node] = std::move(result);
+  if (UsesFrame()) {
+    frame_[node->id()] = std::move(result);
+  } else {
+    node_values_[node] = std::move(result);
+  }
   return absl::OkStatus();
 }
 
@@ -24,6 +24,8 @@
 
 namespace xls {
 
+class FunctionMemoCache;
+
 // Evaluates the given node using the given operand values and returns the
 // result.
 absl::StatusOr<Value> InterpretNode(Node* node,
@@ -34,6 +36,23 @@ class IrInterpreter : public DfsVisitor {
  public:
   IrInterpreter() = default;
 
+  // Constructs an interpreter with a preallocated flat register file for the
+  // nodes of "function_base": node results live in one contiguous Value array
+  // indexed by node id rather than in a hash map, so storing and resolving a
+  // result does no hashing and no per-node allocation. Use this form when
+  // evaluating a whole function or proc; the default constructor remains for
+  // node-at-a-time use (see InterpretNode()).
+  explicit IrInterpreter(FunctionBase* function_base);
+
+  // Sets the memoization caches consulted when evaluating invoke, map, and
+  // counted_for nodes; calls of a cached function with previously seen
+  // arguments return the cached result without re-evaluation. The caches are
+  // not owned and must outlive the interpreter. See FunctionMemoCache in
+  // function_interpreter.h.
+  void SetMemoCaches(absl::Span<FunctionMemoCache* const> memo_caches) {
+    memo_caches_.assign(memo_caches.begin(), memo_caches.end());
+  }
+
   // Sets the evaluated value for 'node' to the given Value. 'value' must be
   // passed in by value (ha!) because a use case is passing in a previously
   // evaluated value and inserting a into flat_hash_map (done below) invalidates
@@ -42,7 +61,7 @@ class IrInterpreter : public DfsVisitor {
 
   // Returns the previously evaluated value of 'node' as a Value.
   const Value& ResolveAsValue(Node* node) const {
-    return node_values_.at(node);
+    return UsesFrame() ? frame_[node->id()] : node_values_.at(node);
   }
 
   const InterpreterEvents& GetInterpreterEvents() const { return events_; }
@@ -50,7 +69,10 @@ class IrInterpreter : public DfsVisitor {
   absl::Status AddInterpreterEvents(const InterpreterEvents& events);
 
   // Returns true if a value has been set for the result of the given node.
-  bool HasResult(Node* node) const { return node_values_.contains(node); }
+  bool HasResult(Node* node) const {
+    return UsesFrame() ? frame_[node->id()].kind() != ValueKind::kInvalid
+                       : node_values_.contains(node);
+  }
 
   absl::Status HandleAdd(BinOp* add) override;
   absl::Status HandleAfterAll(AfterAll* after_all) override;
@@ -152,9 +174,10 @@ class IrInterpreter : public DfsVisitor {
   // error if 'node' is not a bits type or the result does not fit in the type.
   absl::Status SetUint64Result(Node* node, uint64_t result);
 
-  // Sets the evaluated value for 'node' to the given bits value. Returns an
-  // error if 'node' is not a bits type.
-  absl::Status SetBitsResult(Node* node, const Bits& result);
+  // Sets the evaluated value for 'node' to the given bits value. Takes the
+  // value by value so callers can move in freshly computed results without a
+  // copy. Returns an error if 'node' is not a bits type.
+  absl::Status SetBitsResult(Node* node, Bits result);
 
   // Performs a logical OR of the given inputs. If 'inputs' is a not a Bits type
   // (ie, tuple or array) the element a recursively traversed and the Bits-typed
@@ -162,11 +185,24 @@ class IrInterpreter : public DfsVisitor {
   absl::StatusOr<Value> DeepOr(Type* input_type,
                                absl::Span<const Value* const> inputs);
 
-  // The evaluated values for the nodes in the Function.
+  // True if node results are stored in the flat frame_ rather than the
+  // node_values_ map.
+  bool UsesFrame() const { return !frame_.empty(); }
+
+  // The evaluated values for the nodes in the Function, when constructed
+  // without a FunctionBase (node-at-a-time use).
   absl::flat_hash_map<Node*, Value> node_values_;
 
+  // Flat register file of node results indexed by node id, preallocated by
+  // the FunctionBase constructor. An entry of kind ValueKind::kInvalid means
+  // the node has not been evaluated yet.
+  std::vector<Value> frame_;
+
   // Events observed while interpreting (currently only trace messages).
   InterpreterEvents events_;
+
+  // Memoization caches for function calls; see SetMemoCaches(). Not owned.
+  std::vector<FunctionMemoCache*> memo_caches_;
 };
 
 }  // namespace xls
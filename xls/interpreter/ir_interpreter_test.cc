@@ -102,6 +102,47 @@ TEST_F(IrInterpreterOnlyTest, SideEffectingNodes) {
       IsOkAndHolds(Value(UBits(17, 5))));
 }
 
+TEST_F(IrInterpreterOnlyTest, MemoizedFunctionCalls) {
+  Package package("my_package");
+  const std::string fn_text = R"(
+    fn callee(x: bits[8]) -> bits[8] {
+      ret umul.1: bits[8] = umul(x, x, id=1)
+    }
+    )";
+  const std::string caller_text = R"(
+    fn caller(x: bits[8]) -> bits[8] {
+      invoke.5: bits[8] = invoke(x, to_apply=callee, id=5)
+      ret invoke.6: bits[8] = invoke(invoke.5, to_apply=callee, id=6)
+    }
+    )";
+  XLS_ASSERT_OK_AND_ASSIGN(Function * callee,
+                           Parser::ParseFunction(fn_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * caller,
+                           Parser::ParseFunction(caller_text, &package));
+
+  FunctionMemoCache memo(callee);
+  // Memoizing the top-level call directly.
+  EXPECT_THAT(InterpretFunctionWithMemo(callee, {Value(UBits(3, 8))}, {&memo}),
+              IsOkAndHolds(testing::Field(&InterpreterResult<Value>::value,
+                                          Value(UBits(9, 8)))));
+  EXPECT_EQ(memo.hit_count(), 0);
+  EXPECT_EQ(memo.miss_count(), 1);
+  EXPECT_THAT(InterpretFunctionWithMemo(callee, {Value(UBits(3, 8))}, {&memo}),
+              IsOkAndHolds(testing::Field(&InterpreterResult<Value>::value,
+                                          Value(UBits(9, 8)))));
+  EXPECT_EQ(memo.hit_count(), 1);
+  EXPECT_EQ(memo.size(), 1);
+
+  // Memoizing invoke nodes within another function: 3^2 = 9, 9^2 = 81. The
+  // first invoke hits the entry cached above; the second misses.
+  EXPECT_THAT(InterpretFunctionWithMemo(caller, {Value(UBits(3, 8))}, {&memo}),
+              IsOkAndHolds(testing::Field(&InterpreterResult<Value>::value,
+                                          Value(UBits(81, 8)))));
+  EXPECT_EQ(memo.hit_count(), 2);
+  EXPECT_EQ(memo.miss_count(), 2);
+  EXPECT_EQ(memo.size(), 2);
+}
+
 // TODO(https://github.com/google/xls/issues/506): 2021-10-05 Move these to the
 // common IR evaluator tests and make them more comprehensive once the JIT
 // supports the full range of trace operations.
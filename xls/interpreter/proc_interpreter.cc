@@ -24,13 +24,55 @@
 namespace xls {
 namespace {
 
+// Appends pointers to the leaf (bits or token) elements of "value" to
+// "leaves" in the depth-first order used by LeafTypeTree.
+void FlattenValueLeaves(const Value& value, std::vector<const Value*>* leaves) {
+  if (value.IsBits() || value.IsToken()) {
+    leaves->push_back(&value);
+    return;
+  }
+  for (const Value& element : value.elements()) {
+    FlattenValueLeaves(element, leaves);
+  }
+}
+
+// Recomposes a Value of the given type from a flat span of leaf elements
+// ordered as in LeafTypeTree. Advances *linear_index past the consumed
+// leaves.
+Value ComposeValueFromLeaves(Type* type, absl::Span<const Value> leaves,
+                             int64_t* linear_index) {
+  if (type->IsBits() || type->IsToken()) {
+    return leaves[(*linear_index)++];
+  }
+  std::vector<Value> elements;
+  if (type->IsArray()) {
+    ArrayType* array_type = type->AsArrayOrDie();
+    elements.reserve(array_type->size());
+    for (int64_t i = 0; i < array_type->size(); ++i) {
+      elements.push_back(ComposeValueFromLeaves(array_type->element_type(),
+                                                leaves, linear_index));
+    }
+    return Value::ArrayOrDie(elements);
+  }
+  TupleType* tuple_type = type->AsTupleOrDie();
+  elements.reserve(tuple_type->size());
+  for (int64_t i = 0; i < tuple_type->size(); ++i) {
+    elements.push_back(ComposeValueFromLeaves(tuple_type->element_type(i),
+                                              leaves, linear_index));
+  }
+  return Value::TupleOwned(std::move(elements));
+}
+
 // A visitor for interpreting procs. Adds handlers for send and receive
 // communcate via ChannelQueues.
 class ProcIrInterpreter : public IrInterpreter {
  public:
-  // "state" is the value to use for the proc state during interpretation.
-  ProcIrInterpreter(const Value& state, ChannelQueueManager* queue_manager)
-      : IrInterpreter(), state_(state), queue_manager_(queue_manager) {}
+  // "state" is the value to use for the proc state during interpretation. The
+  // pointed-to Value is owned by the ProcInterpreter and is not copied; it
+  // must outlive this object.
+  ProcIrInterpreter(Proc* proc, const Value* state,
+                    ChannelQueueManager* queue_manager)
+      : IrInterpreter(proc), state_(state), queue_manager_(queue_manager) {}
 
   absl::Status HandleReceive(Receive* receive) override {
     XLS_ASSIGN_OR_RETURN(ChannelQueue * queue,
@@ -70,12 +112,12 @@ class ProcIrInterpreter : public IrInterpreter {
     if (index == 0) {
       return SetValueResult(param, Value::Token());
     } else {
-      return SetValueResult(param, state_);
+      return SetValueResult(param, *state_);
     }
   }
 
  private:
-  Value state_;
+  const Value* state_;
 
   ChannelQueueManager* queue_manager_;
 };
@@ -98,7 +140,46 @@ ProcInterpreter::ProcInterpreter(Proc* proc, ChannelQueueManager* queue_manager)
     : proc_(proc),
       queue_manager_(queue_manager),
       topo_sort_(TopoSort(proc)),
-      current_iteration_(0) {}
+      current_iteration_(0),
+      state_leaves_(proc->StateType()),
+      state_(proc->InitValue()) {
+  // Lay out the initial state flat, one Value per leaf element.
+  std::vector<const Value*> leaves;
+  leaves.reserve(state_leaves_.size());
+  FlattenValueLeaves(state_, &leaves);
+  XLS_CHECK_EQ(static_cast<int64_t>(leaves.size()), state_leaves_.size());
+  absl::Span<Value> elements = state_leaves_.elements();
+  for (int64_t i = 0; i < state_leaves_.size(); ++i) {
+    elements[i] = *leaves[i];
+  }
+}
+
+void ProcInterpreter::SetNextState(const Value& next_state) {
+  std::vector<const Value*> leaves;
+  leaves.reserve(state_leaves_.size());
+  FlattenValueLeaves(next_state, &leaves);
+  XLS_CHECK_EQ(static_cast<int64_t>(leaves.size()), state_leaves_.size());
+
+  // Update the flat storage element-wise. Only leaves whose value actually
+  // changed are written so unchanged elements of large state tuples (e.g.,
+  // line buffers) are not copied.
+  bool changed = false;
+  absl::Span<Value> elements = state_leaves_.elements();
+  for (int64_t i = 0; i < state_leaves_.size(); ++i) {
+    if (elements[i] != *leaves[i]) {
+      elements[i] = *leaves[i];
+      changed = true;
+    }
+  }
+
+  // The composed Value handed to the visitor is only rebuilt if a leaf
+  // changed; an unchanged state costs no copies at all.
+  if (changed) {
+    int64_t linear_index = 0;
+    state_ = ComposeValueFromLeaves(proc_->StateType(),
+                                    state_leaves_.elements(), &linear_index);
+  }
+}
 
 bool ProcInterpreter::IsIterationComplete() const {
   return visitor_ == nullptr || (visitor_->IsVisited(proc_->NextState()) &&
@@ -117,15 +198,15 @@ ProcInterpreter::RunIterationUntilCompleteOrBlocked() {
     // Previous iteration was complete or this the first time this method has
     // been called. Create a new visitor for evaluating the nodes this
     // iteration.
-    if (visitor_ == nullptr) {
-      // This is the first time the proc has run. Proc state is the init value.
-      visitor_ = std::make_unique<ProcIrInterpreter>(proc_->InitValue(),
-                                                     queue_manager_);
-    } else {
-      const Value& next_state = visitor_->ResolveAsValue(proc_->NextState());
-      visitor_ =
-          std::make_unique<ProcIrInterpreter>(next_state, queue_manager_);
+    if (visitor_ != nullptr) {
+      // Fold the next-state value into the flat state storage element-wise
+      // before the old visitor (which owns the resolved value) is replaced.
+      SetNextState(visitor_->ResolveAsValue(proc_->NextState()));
     }
+    // On the first run the state holds the init value laid out by the
+    // constructor.
+    visitor_ =
+        std::make_unique<ProcIrInterpreter>(proc_, &state_, queue_manager_);
   }
 
   RunResult result{.iteration_complete = true,
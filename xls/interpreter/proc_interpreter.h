@@ -24,6 +24,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "xls/data_structures/leaf_type_tree.h"
 #include "xls/interpreter/channel_queue.h"
 #include "xls/interpreter/ir_interpreter.h"
 #include "xls/ir/channel.h"
@@ -84,6 +85,10 @@ class ProcInterpreter {
   Value ResolveState() { return visitor_->ResolveAsValue(proc_->NextState()); }
 
  private:
+  // Folds the given next-state value into state_leaves_ element-wise, writing
+  // only the leaves whose value changed, and recomposes state_ if necessary.
+  void SetNextState(const Value& next_state);
+
   Proc* proc_;
   ChannelQueueManager* queue_manager_;
 
@@ -94,6 +99,16 @@ class ProcInterpreter {
   // that the proc has executed.
   int64_t current_iteration_;
 
+  // The proc state laid out flat in a contiguous vector, one Value per leaf
+  // (bits) element of the state type. Updated element-wise at the end of each
+  // iteration so unchanged elements of large state tuples are not copied.
+  LeafTypeTree<Value> state_leaves_;
+
+  // The proc state as a composed Value. The visitor references (rather than
+  // copies) this value; it is recomposed from state_leaves_ only when a leaf
+  // changes.
+  Value state_;
+
   // The interpreter used for evaluating nodes in the proc.
   std::unique_ptr<IrInterpreter> visitor_;
 };
@@ -91,6 +91,45 @@ TEST_F(ProcInterpreterTest, ProcIota) {
   EXPECT_TRUE(ch0_queue.empty());
 }
 
+TEST_F(ProcInterpreterTest, TupleStateUpdatedElementwise) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package->CreateStreamingChannel("count_out", ChannelOps::kSendOnly,
+                                      package->GetBitsType(32)));
+
+  // A proc with tuple state where only the first element changes; the second
+  // element is carried through unchanged every iteration.
+  ProcBuilder pb("tuple_state",
+                 /*init_value=*/
+                 Value::Tuple({Value(UBits(0, 32)), Value(UBits(123, 16))}),
+                 /*token_name=*/"tok", /*state_name=*/"st", package.get());
+  BValue count = pb.TupleIndex(pb.GetStateParam(), 0);
+  BValue constant = pb.TupleIndex(pb.GetStateParam(), 1);
+  BValue send_token = pb.Send(channel, pb.GetTokenParam(), {count});
+  BValue next_count = pb.Add(count, pb.Literal(UBits(1, 32)));
+  XLS_ASSERT_OK(
+      pb.Build(send_token, pb.Tuple({next_count, constant})).status());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ChannelQueueManager> queue_manager,
+      ChannelQueueManager::Create(/*user_defined_queues=*/{}, package.get()));
+  ProcInterpreter interpreter(FindProc("tuple_state", package.get()),
+                              queue_manager.get());
+  ChannelQueue& queue = queue_manager->GetQueue(channel);
+
+  for (int64_t i = 0; i < 3; ++i) {
+    ASSERT_THAT(
+        interpreter.RunIterationUntilCompleteOrBlocked(),
+        IsOkAndHolds(ProcInterpreter::RunResult{.iteration_complete = true,
+                                                .progress_made = true,
+                                                .blocked_channels = {}}));
+    EXPECT_THAT(queue.Dequeue(), IsOkAndHolds(Value(UBits(i, 32))));
+  }
+  EXPECT_EQ(interpreter.ResolveState(),
+            Value::Tuple({Value(UBits(3, 32)), Value(UBits(123, 16))}));
+}
+
 TEST_F(ProcInterpreterTest, ProcWhichReturnsPreviousResults) {
   Package package(TestName());
   ProcBuilder pb("prev", /*init_value=*/Value(UBits(55, 32)),
@@ -14,16 +14,77 @@
 
 #include "xls/interpreter/proc_network_interpreter.h"
 
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <numeric>
+
 #include "absl/status/statusor.h"
 #include "absl/strings/str_join.h"
+#include "xls/common/thread.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/proc_firing_order.h"
 
 namespace xls {
+namespace {
+
+// Returns the procs of the package grouped into partitions where two procs
+// are in the same partition iff they are (transitively) connected by a
+// channel. Computed with a union-find over the proc indices.
+std::vector<std::vector<int64_t>> PartitionProcsByConnectivity(
+    Package* package) {
+  std::vector<int64_t> parent(package->procs().size());
+  std::iota(parent.begin(), parent.end(), 0);
+  std::function<int64_t(int64_t)> find = [&](int64_t i) {
+    while (parent[i] != i) {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  };
+
+  // Procs which send or receive on the same channel belong together.
+  absl::flat_hash_map<int64_t, int64_t> channel_user;
+  for (int64_t proc_index = 0; proc_index < package->procs().size();
+       ++proc_index) {
+    for (Node* node : package->procs()[proc_index]->nodes()) {
+      int64_t channel_id;
+      if (node->Is<Send>()) {
+        channel_id = node->As<Send>()->channel_id();
+      } else if (node->Is<Receive>()) {
+        channel_id = node->As<Receive>()->channel_id();
+      } else {
+        continue;
+      }
+      auto [it, inserted] = channel_user.insert({channel_id, proc_index});
+      if (!inserted) {
+        parent[find(proc_index)] = find(it->second);
+      }
+    }
+  }
+
+  absl::flat_hash_map<int64_t, int64_t> partition_of_root;
+  std::vector<std::vector<int64_t>> partitions;
+  for (int64_t proc_index = 0; proc_index < parent.size(); ++proc_index) {
+    int64_t root = find(proc_index);
+    auto [it, inserted] = partition_of_root.insert({root, partitions.size()});
+    if (inserted) {
+      partitions.push_back({});
+    }
+    partitions[it->second].push_back(proc_index);
+  }
+  return partitions;
+}
+
+}  // namespace
 
 /* static */
 absl::StatusOr<std::unique_ptr<ProcNetworkInterpreter>>
 ProcNetworkInterpreter::Create(
     Package* package,
-    std::vector<std::unique_ptr<ChannelQueue>>&& user_defined_queues) {
+    std::vector<std::unique_ptr<ChannelQueue>>&& user_defined_queues,
+    bool parallel_tick) {
   // Create a queue manager for the queues. This factory verifies that there an
   // receive only queue for every receive only channel.
   XLS_ASSIGN_OR_RETURN(
@@ -32,13 +93,49 @@ ProcNetworkInterpreter::Create(
 
   // Create a network interpreter.
   auto interpreter = absl::WrapUnique(
-      new ProcNetworkInterpreter(std::move(queue_manager)));
+      new ProcNetworkInterpreter(std::move(queue_manager), parallel_tick));
 
   for (auto& proc : package->procs()) {
     interpreter->proc_interpreters_.push_back(std::make_unique<ProcInterpreter>(
         proc.get(), &interpreter->queue_manager()));
   }
 
+  // Order procs by the static firing schedule over the inter-proc channel
+  // graph so each proc runs after the procs feeding it. Feed-forward networks
+  // then complete each tick in a single pass of the retry loop in
+  // TickPartition rather than blocking partway and being retried.
+  std::vector<Proc*> firing_order = ComputeFlatProcFiringOrder(package);
+  absl::flat_hash_map<Proc*, int64_t> firing_position;
+  for (int64_t i = 0; i < firing_order.size(); ++i) {
+    firing_position[firing_order[i]] = i;
+  }
+  auto by_firing_order = [&firing_position](ProcInterpreter* a,
+                                            ProcInterpreter* b) {
+    return firing_position.at(a->proc()) < firing_position.at(b->proc());
+  };
+
+  // Group the procs into partitions which can tick independently. Without
+  // parallel ticking a single partition holds all procs.
+  if (parallel_tick) {
+    for (const std::vector<int64_t>& partition :
+         PartitionProcsByConnectivity(package)) {
+      std::vector<ProcInterpreter*> interpreters;
+      for (int64_t proc_index : partition) {
+        interpreters.push_back(
+            interpreter->proc_interpreters_[proc_index].get());
+      }
+      std::sort(interpreters.begin(), interpreters.end(), by_firing_order);
+      interpreter->partitions_.push_back(std::move(interpreters));
+    }
+  } else {
+    std::vector<ProcInterpreter*> interpreters;
+    for (auto& proc_interpreter : interpreter->proc_interpreters_) {
+      interpreters.push_back(proc_interpreter.get());
+    }
+    std::sort(interpreters.begin(), interpreters.end(), by_firing_order);
+    interpreter->partitions_.push_back(std::move(interpreters));
+  }
+
   // Inject initial values into channels.
   for (Channel* channel : package->channels()) {
     ChannelQueue& queue = interpreter->queue_manager().GetQueue(channel);
@@ -52,35 +149,89 @@ ProcNetworkInterpreter::Create(
 }
 
 absl::Status ProcNetworkInterpreter::Tick() {
+  if (partitions_.size() <= 1) {
+    return partitions_.empty() ? absl::OkStatus()
+                               : TickPartition(partitions_.front());
+  }
+
+  // Tick the partitions concurrently, running the first partition on this
+  // thread. Partitions share no channel queues so their execution order is
+  // immaterial.
+  std::vector<absl::Status> statuses(partitions_.size());
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int64_t i = 1; i < partitions_.size(); ++i) {
+    threads.push_back(std::make_unique<Thread>(
+        [this, &statuses, i]() { statuses[i] = TickPartition(partitions_[i]); }));
+  }
+  statuses[0] = TickPartition(partitions_[0]);
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+  for (const absl::Status& status : statuses) {
+    XLS_RETURN_IF_ERROR(status);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ProcNetworkInterpreter::TickPartition(
+    absl::Span<ProcInterpreter* const> partition) {
+  // Event-driven scheduling: procs run from a ready queue and suspend when
+  // blocked on an empty receive channel. A suspended proc is requeued only
+  // when a channel it is blocked on becomes non-empty, rather than being
+  // blindly retried each sweep, so a tick costs time proportional to the
+  // progress made instead of the number of blocked procs. The queue is
+  // seeded in firing order so feed-forward networks complete in one pass.
+  std::deque<ProcInterpreter*> ready(partition.begin(), partition.end());
+  absl::flat_hash_set<ProcInterpreter*> in_ready(partition.begin(),
+                                                 partition.end());
   absl::flat_hash_set<ProcInterpreter*> completed_procs;
-  absl::flat_hash_set<Channel*> blocked_channels;
+  // Procs suspended on each channel, awaiting data. Entries may be stale (a
+  // waiter woken via one channel remains listed under its other blocking
+  // channels); the in_ready/completed checks at wake time filter them.
+  absl::flat_hash_map<Channel*, std::vector<ProcInterpreter*>> waiters;
   bool global_progress_made = false;
-  bool progress_made_this_loop = true;
-  while (progress_made_this_loop) {
-    progress_made_this_loop = false;
-    blocked_channels.clear();
-    for (auto& interpreter : proc_interpreters_) {
-      if (completed_procs.contains(interpreter.get())) {
+  while (!ready.empty()) {
+    ProcInterpreter* interpreter = ready.front();
+    ready.pop_front();
+    in_ready.erase(interpreter);
+    XLS_ASSIGN_OR_RETURN(ProcInterpreter::RunResult result,
+                         interpreter->RunIterationUntilCompleteOrBlocked());
+
+    global_progress_made |= result.progress_made;
+    if (result.iteration_complete) {
+      completed_procs.insert(interpreter);
+    } else {
+      for (Channel* channel : result.blocked_channels) {
+        waiters[channel].push_back(interpreter);
+      }
+    }
+    if (!result.progress_made) {
+      continue;
+    }
+    // The proc may have sent on channels others are suspended on. Wake the
+    // waiters of every channel which now holds data.
+    for (auto it = waiters.begin(); it != waiters.end();) {
+      if (queue_manager_->GetQueue(it->first).empty()) {
+        ++it;
         continue;
       }
-      XLS_ASSIGN_OR_RETURN(ProcInterpreter::RunResult result,
-                           interpreter->RunIterationUntilCompleteOrBlocked());
-
-      progress_made_this_loop |= result.progress_made;
-      if (result.iteration_complete) {
-        completed_procs.insert(interpreter.get());
+      for (ProcInterpreter* waiter : it->second) {
+        if (!completed_procs.contains(waiter) &&
+            in_ready.insert(waiter).second) {
+          ready.push_back(waiter);
+        }
       }
-      blocked_channels.insert(result.blocked_channels.begin(),
-                              result.blocked_channels.end());
+      waiters.erase(it++);
     }
-    global_progress_made |= progress_made_this_loop;
   }
   if (!global_progress_made) {
     // Not a single instruction executed on any proc. This is necessarily a
     // deadlock. Sort blocked channels by channel id so the return message is
     // stable.
-    std::vector<Channel*> blocked_vec(blocked_channels.begin(),
-                                      blocked_channels.end());
+    std::vector<Channel*> blocked_vec;
+    for (const auto& [channel, unused] : waiters) {
+      blocked_vec.push_back(channel);
+    }
     std::sort(blocked_vec.begin(), blocked_vec.end(),
               [](Channel* a, Channel* b) { return a->id() < b->id(); });
     return absl::InternalError(absl::StrFormat(
@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "xls/interpreter/channel_queue.h"
 #include "xls/interpreter/proc_interpreter.h"
 #include "xls/ir/package.h"
@@ -32,21 +33,30 @@ class ProcNetworkInterpreter {
  public:
   // Creates and returns an proc network interpreter for the given
   // package. user_defined_queues must contain a queue for each receive-only
-  // channel in the package.
+  // channel in the package. If parallel_tick is true then procs are
+  // partitioned by channel connectivity and each call to Tick() executes
+  // independent partitions concurrently on separate threads.
   static absl::StatusOr<std::unique_ptr<ProcNetworkInterpreter>> Create(
       Package* package,
-      std::vector<std::unique_ptr<ChannelQueue>>&& user_defined_queues);
+      std::vector<std::unique_ptr<ChannelQueue>>&& user_defined_queues,
+      bool parallel_tick = false);
 
-  // Execute (up to) a single iteration of every proc in the package. In a
-  // round-robin fashion each proc is executed until no further progress can be
-  // made. If no conditional send/receive nodes exist in the package then
-  // calling Tick will execute exactly one iteration for all procs in the
-  // package. If conditional send/receive nodes do exist, then some procs may be
+  // Execute (up to) a single iteration of every proc in the package. Procs
+  // are executed in a statically computed firing order (senders before the
+  // procs receiving from them, see ComputeProcFiringOrder) so feed-forward
+  // networks complete a tick with each proc running exactly once; procs
+  // which block on an empty channel are suspended and resumed when the
+  // channel receives data. If
+  // no conditional send/receive nodes exist in the package then calling Tick
+  // will execute exactly one iteration for all procs in the package. If
+  // conditional send/receive nodes do exist, then some procs may be
   // blocked in a state where the iteration is partially complete. In this case,
   // the call to Tick() will not execute a complete iteration of the
   // proc. Calling Tick() again will resume these procs from their partially
   // executed state. Returns an error if no progress can be made due to a
-  // deadlock.
+  // deadlock. In parallel tick mode the partitions of connected procs are
+  // ticked concurrently; procs in different partitions share no channels so
+  // the result is identical to serial execution.
   absl::Status Tick();
 
   ChannelQueueManager& queue_manager() { return *queue_manager_; }
@@ -55,13 +65,32 @@ class ProcNetworkInterpreter {
   absl::flat_hash_map<Proc*, Value> ResolveState();
 
  private:
-  ProcNetworkInterpreter(std::unique_ptr<ChannelQueueManager>&& queue_manager)
-      : queue_manager_(std::move(queue_manager)) {}
+  ProcNetworkInterpreter(std::unique_ptr<ChannelQueueManager>&& queue_manager,
+                         bool parallel_tick)
+      : queue_manager_(std::move(queue_manager)),
+        parallel_tick_(parallel_tick) {}
+
+  // Runs the procs in "partition" from a ready queue until each has
+  // completed an iteration or no further progress can be made. Procs which
+  // block on an empty receive channel are suspended and resumed when the
+  // channel receives data. Returns an error if the partition is deadlocked.
+  absl::Status TickPartition(absl::Span<ProcInterpreter* const> partition);
 
   std::unique_ptr<ChannelQueueManager> queue_manager_;
 
+  // Whether Tick() executes independent partitions on separate threads.
+  bool parallel_tick_;
+
   // The vector of interpreters for each proc in the package.
   std::vector<std::unique_ptr<ProcInterpreter>> proc_interpreters_;
+
+  // The proc interpreters grouped by channel connectivity: two procs are in
+  // the same partition iff they are connected (transitively) by a
+  // channel. With parallel_tick disabled there is a single partition holding
+  // all procs. Partitions share no channel queues so they may tick
+  // concurrently. Within a partition the interpreters are ordered by the
+  // static firing schedule of the inter-proc channel graph.
+  std::vector<std::vector<ProcInterpreter*>> partitions_;
 };
 
 }  // namespace xls
@@ -18,13 +18,36 @@
 #include "xls/interpreter/function_interpreter.h"
 
 namespace xls {
+namespace {
 
-Value RandomValue(Type* type, std::minstd_rand* engine) {
+// Fills 'bytes' with 'byte_count' uniformly distributed random bytes. Draws 32
+// bits from the engine per iteration rather than paying a distribution call
+// per byte.
+void FillRandomBytes(int64_t byte_count, std::minstd_rand* engine,
+                     std::vector<uint8_t>* bytes) {
+  bytes->clear();
+  std::uniform_int_distribution<uint32_t> generator;
+  for (int64_t i = 0; i < byte_count; i += 4) {
+    uint32_t word = generator(*engine);
+    for (int64_t j = i; j < byte_count && j < i + 4; ++j) {
+      bytes->push_back(word & 0xff);
+      word >>= 8;
+    }
+  }
+}
+
+// Implementation of RandomValue which threads a reusable scratch buffer for
+// the random bytes of each bits-typed leaf so bulk generation does not
+// allocate per leaf.
+Value RandomValueInternal(Type* type, std::minstd_rand* engine,
+                          std::vector<uint8_t>* byte_buffer) {
   if (type->IsTuple()) {
     TupleType* tuple_type = type->AsTupleOrDie();
     std::vector<Value> elements;
     for (int64_t i = 0; i < tuple_type->size(); ++i) {
-      elements.push_back(RandomValue(tuple_type->element_type(i), engine));
+      elements.push_back(
+          RandomValueInternal(tuple_type->element_type(i), engine,
+                              byte_buffer));
     }
     return Value::Tuple(elements);
   }
@@ -32,7 +55,9 @@ Value RandomValue(Type* type, std::minstd_rand* engine) {
     ArrayType* array_type = type->AsArrayOrDie();
     std::vector<Value> elements;
     for (int64_t i = 0; i < array_type->size(); ++i) {
-      elements.push_back(RandomValue(array_type->element_type(), engine));
+      elements.push_back(
+          RandomValueInternal(array_type->element_type(), engine,
+                              byte_buffer));
     }
     return Value::Array(elements).value();
   }
@@ -40,23 +65,46 @@ Value RandomValue(Type* type, std::minstd_rand* engine) {
     return Value::Token();
   }
   int64_t bit_count = type->AsBitsOrDie()->bit_count();
-  std::vector<uint8_t> bytes;
-  std::uniform_int_distribution<uint8_t> generator(0, 255);
-  for (int64_t i = 0; i < bit_count; i += 8) {
-    bytes.push_back(generator(*engine));
-  }
-  return Value(Bits::FromBytes(bytes, bit_count));
+  FillRandomBytes((bit_count + 7) / 8, engine, byte_buffer);
+  return Value(Bits::FromBytes(*byte_buffer, bit_count));
+}
+
+}  // namespace
+
+Value RandomValue(Type* type, std::minstd_rand* engine) {
+  std::vector<uint8_t> byte_buffer;
+  return RandomValueInternal(type, engine, &byte_buffer);
 }
 
 std::vector<Value> RandomFunctionArguments(Function* f,
                                            std::minstd_rand* engine) {
   std::vector<Value> inputs;
+  std::vector<uint8_t> byte_buffer;
   for (Param* param : f->params()) {
-    inputs.push_back(RandomValue(param->GetType(), engine));
+    inputs.push_back(RandomValueInternal(param->GetType(), engine,
+                                         &byte_buffer));
   }
   return inputs;
 }
 
+std::vector<std::vector<Value>> RandomFunctionArgumentsBatch(
+    Function* f, std::minstd_rand* engine, int64_t num_samples) {
+  // A single scratch buffer serves every leaf of every sample.
+  std::vector<uint8_t> byte_buffer;
+  std::vector<std::vector<Value>> samples;
+  samples.reserve(num_samples);
+  for (int64_t i = 0; i < num_samples; ++i) {
+    std::vector<Value> inputs;
+    inputs.reserve(f->params().size());
+    for (Param* param : f->params()) {
+      inputs.push_back(RandomValueInternal(param->GetType(), engine,
+                                           &byte_buffer));
+    }
+    samples.push_back(std::move(inputs));
+  }
+  return samples;
+}
+
 absl::StatusOr<std::vector<Value>> RandomFunctionArguments(
     Function* f, std::minstd_rand* engine, Function* validator,
     int64_t max_attempts) {
@@ -33,6 +33,14 @@ Value RandomValue(Type* type, std::minstd_rand* engine);
 std::vector<Value> RandomFunctionArguments(Function* f,
                                            std::minstd_rand* engine);
 
+// Returns 'num_samples' sets of random argument values for the given
+// function. Equivalent to calling RandomFunctionArguments in a loop but
+// amortizes the scratch allocations of leaf generation across the whole
+// batch, which matters when generating very large numbers of samples (e.g.,
+// eval_ir_main --random_inputs).
+std::vector<std::vector<Value>> RandomFunctionArgumentsBatch(
+    Function* f, std::minstd_rand* engine, int64_t num_samples);
+
 absl::StatusOr<std::vector<Value>> RandomFunctionArguments(
     Function* f, std::minstd_rand* engine, Function* validator,
     int64_t max_attempts);
@@ -47,11 +47,18 @@ namespace xls {
 //     ...
 //
 // And define non-virtual methods One, Zero, Not, And, and Or.
-template <typename ElementT, typename EvaluatorT>
+//
+// The optional VectorT parameter selects the container backing Vector.
+// Evaluators which overwhelmingly process narrow values (e.g., control logic)
+// can pass an absl::InlinedVector with inline capacity 64 so that vectors of
+// common bit widths never touch the heap; the default std::vector is
+// appropriate when vectors are long-lived or elements are large.
+template <typename ElementT, typename EvaluatorT,
+          typename VectorT = std::vector<ElementT>>
 class AbstractEvaluator {
  public:
   using Element = ElementT;
-  using Vector = std::vector<Element>;
+  using Vector = VectorT;
 
   Element One() const { return static_cast<const EvaluatorT*>(this)->One(); }
   Element Zero() const { return static_cast<const EvaluatorT*>(this)->Zero(); }
@@ -18,9 +18,11 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/optional.h"
+#include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/node.h"
 #include "xls/ir/nodes.h"
+#include "xls/ir/ternary.h"
 
 namespace xls {
 
@@ -282,6 +284,50 @@ absl::StatusOr<typename AbstractEvaluatorT::Vector> AbstractEvaluate(
   XLS_LOG(FATAL) << "Invalid op: " << static_cast<int64_t>(node->op());
 }
 
+// As AbstractEvaluate above, but seeded with bits of the node's value which a
+// prior analysis (e.g., a QueryEngine) has already established. Bits which
+// 'seed' marks as known are forced to the evaluator's literal zero/one
+// elements in the returned vector, so the evaluator only constructs
+// expressions for the still-unknown bits: a fully known node skips the
+// operation evaluation entirely, and expressions downstream of the forced
+// constants fold away. This makes running an expensive evaluator (e.g., BDD)
+// after a cheap one (e.g., ternary) over the same function a refinement
+// rather than a recomputation. 'node' must be bits-typed and 'seed' must have
+// one entry per bit of the node.
+template <typename AbstractEvaluatorT>
+absl::StatusOr<typename AbstractEvaluatorT::Vector> AbstractEvaluateSeeded(
+    Node* node, absl::Span<const typename AbstractEvaluatorT::Vector> operands,
+    AbstractEvaluatorT* evaluator,
+    std::function<typename AbstractEvaluatorT::Vector(Node*)> default_handler,
+    const TernaryVector& seed) {
+  using Vector = typename AbstractEvaluatorT::Vector;
+  XLS_RET_CHECK(node->GetType()->IsBits()) << node->ToString();
+  XLS_RET_CHECK_EQ(static_cast<int64_t>(seed.size()), node->BitCountOrDie());
+  auto seed_element = [&](TernaryValue value) {
+    return value == TernaryValue::kKnownOne ? evaluator->One()
+                                            : evaluator->Zero();
+  };
+  if (ternary_ops::NumberOfKnownBits(seed) ==
+      static_cast<int64_t>(seed.size())) {
+    // Every bit is already known; the operation need not be evaluated at all.
+    Vector result;
+    for (TernaryValue value : seed) {
+      result.push_back(seed_element(value));
+    }
+    return result;
+  }
+  XLS_ASSIGN_OR_RETURN(
+      Vector result,
+      AbstractEvaluate(node, operands, evaluator, std::move(default_handler)));
+  XLS_RET_CHECK_EQ(result.size(), seed.size());
+  for (int64_t i = 0; i < static_cast<int64_t>(result.size()); ++i) {
+    if (seed[i] != TernaryValue::kUnknown) {
+      result[i] = seed_element(seed[i]);
+    }
+  }
+  return result;
+}
+
 }  // namespace xls
 
 #endif  // XLS_IR_ABSTRACT_NODE_EVALUATOR_H_
@@ -14,44 +14,104 @@
 
 #include "xls/ir/big_int.h"
 
+#include <limits>
+
+#include "absl/numeric/int128.h"
 #include "absl/status/statusor.h"
 #include "openssl/bn.h"
 #include "xls/common/logging/logging.h"
 
 namespace xls {
+namespace {
+
+// Returns whether the given value fits in the inline (int64_t)
+// representation. Inline operands are widened to 128 bits before arithmetic
+// so intermediate results can never overflow; only results passing this test
+// are narrowed back.
+bool FitsInSmall(absl::int128 value) {
+  return value >= absl::int128(std::numeric_limits<int64_t>::min()) &&
+         value <= absl::int128(std::numeric_limits<int64_t>::max());
+}
+
+}  // namespace
 
-BigInt::BigInt() { BN_init(&bn_); }
+BigInt::BigInt() : is_small_(true), small_(0) { BN_init(&bn_); }
 
-BigInt::BigInt(const BigInt& other) {
+BigInt::BigInt(const BigInt& other)
+    : is_small_(other.is_small_), small_(other.small_) {
   BN_init(&bn_);
-  BN_copy(&bn_, &other.bn_);
+  if (!is_small_) {
+    BN_copy(&bn_, &other.bn_);
+  }
 }
 
-BigInt::BigInt(BigInt&& other) {
+BigInt::BigInt(BigInt&& other)
+    : is_small_(other.is_small_), small_(other.small_) {
   memcpy(&bn_, &other.bn_, sizeof(bn_));
   BN_init(&other.bn_);
+  other.is_small_ = true;
+  other.small_ = 0;
 }
 
 BigInt::~BigInt() { BN_free(&bn_); }
 
 BigInt& BigInt::operator=(const BigInt& other) {
-  BN_copy(&bn_, &other.bn_);
+  is_small_ = other.is_small_;
+  small_ = other.small_;
+  if (!is_small_) {
+    BN_copy(&bn_, &other.bn_);
+  }
   return *this;
 }
 
 BigInt& BigInt::operator=(BigInt&& other) {
+  is_small_ = other.is_small_;
+  small_ = other.small_;
   memcpy(&bn_, &other.bn_, sizeof(bn_));
   BN_init(&other.bn_);
+  other.is_small_ = true;
+  other.small_ = 0;
   return *this;
 }
 
 bool BigInt::operator==(const BigInt& other) const {
-  return BN_cmp(&bn_, &other.bn_) == 0;
+  if (is_small_ && other.is_small_) {
+    return small_ == other.small_;
+  }
+  BigInt lhs_storage;
+  BigInt rhs_storage;
+  return BN_cmp(AsBn(*this, &lhs_storage), AsBn(other, &rhs_storage)) == 0;
+}
+
+/* static */ BigInt BigInt::MakeSmall(int64_t value) {
+  BigInt result;
+  result.small_ = value;
+  return result;
+}
+
+/* static */ const BIGNUM* BigInt::AsBn(const BigInt& value, BigInt* storage) {
+  if (!value.is_small_) {
+    return &value.bn_;
+  }
+  uint64_t magnitude = value.small_ < 0 ? -static_cast<uint64_t>(value.small_)
+                                        : static_cast<uint64_t>(value.small_);
+  BN_set_word(&storage->bn_, magnitude);
+  BN_set_negative(&storage->bn_, value.small_ < 0 ? 1 : 0);
+  storage->is_small_ = false;
+  return &storage->bn_;
+}
+
+bool BigInt::IsNegative() const {
+  return is_small_ ? small_ < 0 : BN_is_negative(&bn_);
 }
 
 /* static */
 BigInt BigInt::MakeUnsigned(const Bits& bits) {
+  if (bits.bit_count() <= 63) {
+    return MakeSmall(static_cast<int64_t>(bits.ToUint64().value()));
+  }
   BigInt value;
+  value.is_small_ = false;
   std::vector<uint8_t> byte_vector = bits.ToBytes();
   BN_bin2bn(byte_vector.data(), byte_vector.size(), &value.bn_);
   return value;
@@ -62,7 +122,11 @@ BigInt BigInt::MakeSigned(const Bits& bits) {
   if (bits.bit_count() == 0 || !bits.msb()) {
     return MakeUnsigned(bits);
   }
+  if (bits.bit_count() <= 64) {
+    return MakeSmall(bits.ToInt64().value());
+  }
   BigInt value;
+  value.is_small_ = false;
   // 'bits' is a twos-complement negative number, invert the bits and add one to
   // get the magnitude. Then negate it to produce the correct value in the
   // BigInt.
@@ -84,6 +148,9 @@ BigInt BigInt::MakeSigned(const Bits& bits) {
 }
 
 Bits BigInt::ToSignedBits() const {
+  if (is_small_) {
+    return SBits(small_, Bits::MinBitCountSigned(small_));
+  }
   if (BN_is_zero(&bn_)) {
     return Bits();
   }
@@ -116,6 +183,10 @@ Bits BigInt::ToSignedBits() const {
 }
 
 Bits BigInt::ToUnsignedBits() const {
+  if (is_small_) {
+    XLS_CHECK_GE(small_, 0);
+    return UBits(small_, Bits::MinBitCountUnsigned(small_));
+  }
   XLS_CHECK(!BN_is_negative(&bn_));
   int64_t bit_count = BN_num_bits(&bn_);
   std::vector<uint8_t> byte_vector;
@@ -137,7 +208,7 @@ absl::StatusOr<Bits> BigInt::ToSignedBitsWithBitCount(int64_t bit_count) const {
   BitsRope rope(bit_count);
   Bits bits = ToSignedBits();
   rope.push_back(bits);
-  if (BN_is_negative(&bn_)) {
+  if (IsNegative()) {
     rope.push_back(Bits::AllOnes(bit_count - min_bit_count));
   } else {
     rope.push_back(Bits(bit_count - min_bit_count));
@@ -163,6 +234,9 @@ absl::StatusOr<Bits> BigInt::ToUnsignedBitsWithBitCount(
 }
 
 int64_t BigInt::SignedBitCount() const {
+  if (is_small_) {
+    return Bits::MinBitCountSigned(small_);
+  }
   if (BN_is_zero(&bn_)) {
     return 0;
   }
@@ -181,6 +255,10 @@ int64_t BigInt::SignedBitCount() const {
 }
 
 int64_t BigInt::UnsignedBitCount() const {
+  if (is_small_) {
+    XLS_CHECK_GE(small_, 0) << "Value must be non-negative.";
+    return Bits::MinBitCountUnsigned(small_);
+  }
   XLS_CHECK_EQ(BN_is_negative(&bn_), 0) << "Value must be non-negative.";
   if (BN_is_negative(&bn_)) {
     return 0;
@@ -189,55 +267,117 @@ int64_t BigInt::UnsignedBitCount() const {
 }
 
 /* static */ BigInt BigInt::Add(const BigInt& lhs, const BigInt& rhs) {
+  if (lhs.is_small_ && rhs.is_small_) {
+    absl::int128 sum = absl::int128(lhs.small_) + absl::int128(rhs.small_);
+    if (FitsInSmall(sum)) {
+      return MakeSmall(static_cast<int64_t>(sum));
+    }
+  }
   BigInt value;
-  BN_add(&value.bn_, &lhs.bn_, &rhs.bn_);
+  value.is_small_ = false;
+  BigInt lhs_storage;
+  BigInt rhs_storage;
+  BN_add(&value.bn_, AsBn(lhs, &lhs_storage), AsBn(rhs, &rhs_storage));
   return value;
 }
 
 /* static */ BigInt BigInt::Sub(const BigInt& lhs, const BigInt& rhs) {
+  if (lhs.is_small_ && rhs.is_small_) {
+    absl::int128 diff = absl::int128(lhs.small_) - absl::int128(rhs.small_);
+    if (FitsInSmall(diff)) {
+      return MakeSmall(static_cast<int64_t>(diff));
+    }
+  }
   BigInt value;
-  BN_sub(&value.bn_, &lhs.bn_, &rhs.bn_);
+  value.is_small_ = false;
+  BigInt lhs_storage;
+  BigInt rhs_storage;
+  BN_sub(&value.bn_, AsBn(lhs, &lhs_storage), AsBn(rhs, &rhs_storage));
   return value;
 }
 
 /* static */ BigInt BigInt::Mul(const BigInt& lhs, const BigInt& rhs) {
+  if (lhs.is_small_ && rhs.is_small_) {
+    absl::int128 product = absl::int128(lhs.small_) * absl::int128(rhs.small_);
+    if (FitsInSmall(product)) {
+      return MakeSmall(static_cast<int64_t>(product));
+    }
+  }
   BigInt value;
+  value.is_small_ = false;
+  BigInt lhs_storage;
+  BigInt rhs_storage;
   // Note: The documentation about BN_CTX in bn.h indicates that it's possible
   // to pass null to public methods that take a BN_CTX*, but that's not true.
   BN_CTX* ctx = BN_CTX_new();
-  BN_mul(&value.bn_, &lhs.bn_, &rhs.bn_, ctx);
+  BN_mul(&value.bn_, AsBn(lhs, &lhs_storage), AsBn(rhs, &rhs_storage), ctx);
   BN_CTX_free(ctx);
   return value;
 }
 
 /* static */ BigInt BigInt::Div(const BigInt& lhs, const BigInt& rhs) {
+  if (lhs.is_small_ && rhs.is_small_ && rhs.small_ != 0) {
+    // Widening to 128 bits also sidesteps the INT64_MIN / -1 overflow case.
+    absl::int128 quotient =
+        absl::int128(lhs.small_) / absl::int128(rhs.small_);
+    if (FitsInSmall(quotient)) {
+      return MakeSmall(static_cast<int64_t>(quotient));
+    }
+  }
   BigInt value;
+  value.is_small_ = false;
+  BigInt lhs_storage;
+  BigInt rhs_storage;
   // Note: The documentation about BN_CTX in bn.h indicates that it's possible
   // to pass null to public methods that take a BN_CTX*, but that's not true.
   BN_CTX* ctx = BN_CTX_new();
-  BN_div(&value.bn_, /*rem=*/nullptr, &lhs.bn_, &rhs.bn_, ctx);
+  BN_div(&value.bn_, /*rem=*/nullptr, AsBn(lhs, &lhs_storage),
+         AsBn(rhs, &rhs_storage), ctx);
   BN_CTX_free(ctx);
   return value;
 }
 
 /* static */ BigInt BigInt::Mod(const BigInt& lhs, const BigInt& rhs) {
+  if (lhs.is_small_ && rhs.is_small_ && rhs.small_ != 0) {
+    absl::int128 remainder =
+        absl::int128(lhs.small_) % absl::int128(rhs.small_);
+    if (FitsInSmall(remainder)) {
+      return MakeSmall(static_cast<int64_t>(remainder));
+    }
+  }
   BigInt value;
+  value.is_small_ = false;
+  BigInt lhs_storage;
+  BigInt rhs_storage;
   // Note: The documentation about BN_CTX in bn.h indicates that it's possible
   // to pass null to public methods that take a BN_CTX*, but that's not true.
   BN_CTX* ctx = BN_CTX_new();
-  BN_div(/*quotient=*/nullptr, /*rem=*/&value.bn_, &lhs.bn_, &rhs.bn_, ctx);
+  BN_div(/*quotient=*/nullptr, /*rem=*/&value.bn_, AsBn(lhs, &lhs_storage),
+         AsBn(rhs, &rhs_storage), ctx);
   BN_CTX_free(ctx);
   return value;
 }
 
 /* static */ BigInt BigInt::Negate(const BigInt& input) {
-  BigInt value = input;
+  if (input.is_small_ &&
+      input.small_ != std::numeric_limits<int64_t>::min()) {
+    return MakeSmall(-input.small_);
+  }
+  BigInt value;
+  value.is_small_ = false;
+  BigInt storage;
+  BN_copy(&value.bn_, AsBn(input, &storage));
   BN_set_negative(&value.bn_, !BN_is_negative(&value.bn_));
   return value;
 }
 
 /* static */ bool BigInt::LessThan(const BigInt& lhs, const BigInt& rhs) {
-  return BN_cmp(&lhs.bn_, &rhs.bn_) < 0;
+  if (lhs.is_small_ && rhs.is_small_) {
+    return lhs.small_ < rhs.small_;
+  }
+  BigInt lhs_storage;
+  BigInt rhs_storage;
+  return BN_cmp(AsBn(lhs, &lhs_storage), AsBn(rhs, &rhs_storage)) < 0;
 }
 
 std::ostream& operator<<(std::ostream& os, const BigInt& big_int) {
@@ -22,7 +22,10 @@
 namespace xls {
 
 // Class which wraps OpenSSL's bignum library to provide support for arbitrary
-// width integer arithmetic operations.
+// width integer arithmetic operations. Values whose magnitude fits in a
+// signed 64-bit word -- the overwhelming majority of constants folded by the
+// optimizer -- are stored inline and computed with native integer arithmetic;
+// the heap-allocating bignum representation is used only for true wide math.
 class BigInt {
  public:
   // Make (un)signed BigInt from the given bits object. MakeSigned assumes a
@@ -68,6 +71,20 @@ class BigInt {
   static bool LessThan(const BigInt& lhs, const BigInt& rhs);
 
  private:
+  // Returns a BigInt holding the given value in the inline representation.
+  static BigInt MakeSmall(int64_t value);
+
+  // Returns a BIGNUM view of 'value'. If 'value' uses the inline
+  // representation it is materialized into '*storage' and storage's BIGNUM is
+  // returned.
+  static const BIGNUM* AsBn(const BigInt& value, BigInt* storage);
+
+  bool IsNegative() const;
+
+  // If true the value is held in small_ and bn_ is unused (but initialized so
+  // destruction is uniform).
+  bool is_small_;
+  int64_t small_;
   BIGNUM bn_;
 };
 
@@ -329,6 +329,26 @@ TEST_F(BigIntTest, Modulus) {
       MakeBigInt("0xf_ffff"));
 }
 
+// The boundary where values no longer fit in the inline 64-bit
+// representation and must promote to the bignum representation.
+TEST_F(BigIntTest, NarrowWideBoundary) {
+  BigInt int64_max = MakeBigInt("0x7fff_ffff_ffff_ffff");
+  BigInt int64_min = BigInt::Negate(MakeBigInt("0x8000_0000_0000_0000"));
+
+  EXPECT_EQ(BigInt::Add(int64_max, MakeBigInt(1)),
+            MakeBigInt("0x8000_0000_0000_0000"));
+  EXPECT_EQ(BigInt::Sub(int64_min, MakeBigInt(1)),
+            BigInt::Negate(MakeBigInt("0x8000_0000_0000_0001")));
+  EXPECT_EQ(BigInt::Mul(int64_max, int64_max),
+            MakeBigInt("0x3fff_ffff_ffff_ffff_0000_0000_0000_0001"));
+  EXPECT_EQ(BigInt::Div(MakeBigInt("0x3fff_ffff_ffff_ffff_0000_0000_0000_0001"),
+                        int64_max),
+            int64_max);
+  EXPECT_EQ(BigInt::Negate(int64_min), MakeBigInt("0x8000_0000_0000_0000"));
+  EXPECT_TRUE(BigInt::LessThan(int64_max, MakeBigInt("0x8000_0000_0000_0000")));
+  EXPECT_TRUE(BigInt::LessThan(int64_min, MakeBigInt(0)));
+}
+
 TEST_F(BigIntTest, LessThan) {
   EXPECT_TRUE(BigInt::LessThan(MakeBigInt(2), MakeBigInt(10)));
   EXPECT_FALSE(BigInt::LessThan(MakeBigInt(10), MakeBigInt(10)));
@@ -14,6 +14,8 @@
 
 #include "xls/ir/bits.h"
 
+#include <algorithm>
+
 #include "absl/base/casts.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/escaping.h"
@@ -23,6 +25,15 @@
 #include "xls/common/logging/logging.h"
 
 namespace xls {
+namespace {
+
+// Number of bits in an InlineBitmap storage word. The bit-counting methods
+// below operate a word at a time with hardware bit-count instructions rather
+// than bit by bit; they rely on the InlineBitmap invariant that the unused
+// high bits of the last storage word are zero.
+constexpr int64_t kWordBits = 64;
+
+}  // namespace
 
 /* static */ Bits Bits::FromBytes(absl::Span<const uint8_t> bytes,
                                   int64_t bit_count) {
@@ -108,45 +119,60 @@ bool Bits::IsOne() const { return PopCount() == 1 && Get(0); }
 
 int64_t Bits::PopCount() const {
   int64_t count = 0;
-  for (int64_t i = 0; i < bit_count(); ++i) {
-    if (Get(i)) {
-      ++count;
-    }
+  for (int64_t wordno = 0; wordno < bitmap_.word_count(); ++wordno) {
+    count += __builtin_popcountll(bitmap_.GetWord(wordno));
   }
   return count;
 }
 
 int64_t Bits::CountLeadingZeros() const {
-  for (int64_t i = 0; i < bit_count(); ++i) {
-    if (Get(bit_count() - 1 - i)) {
-      return i;
+  for (int64_t wordno = bitmap_.word_count() - 1; wordno >= 0; --wordno) {
+    uint64_t word = bitmap_.GetWord(wordno);
+    if (word != 0) {
+      int64_t msb_index =
+          wordno * kWordBits + (kWordBits - 1 - __builtin_clzll(word));
+      return bit_count() - 1 - msb_index;
     }
   }
   return bit_count();
 }
 
 int64_t Bits::CountLeadingOnes() const {
-  for (int64_t i = 0; i < bit_count(); ++i) {
-    if (!Get(bit_count() - 1 - i)) {
-      return i;
+  for (int64_t wordno = bitmap_.word_count() - 1; wordno >= 0; --wordno) {
+    uint64_t inverted = ~bitmap_.GetWord(wordno);
+    // Mask off the unused (always zero, so inverted always one) high bits of
+    // the last word.
+    int64_t valid_bits = bit_count() - wordno * kWordBits;
+    if (valid_bits < kWordBits) {
+      inverted &= (uint64_t{1} << valid_bits) - 1;
+    }
+    if (inverted != 0) {
+      int64_t msb_index =
+          wordno * kWordBits + (kWordBits - 1 - __builtin_clzll(inverted));
+      return bit_count() - 1 - msb_index;
     }
   }
   return bit_count();
 }
 
 int64_t Bits::CountTrailingZeros() const {
-  for (int64_t i = 0; i < bit_count(); ++i) {
-    if (Get(i)) {
-      return i;
+  for (int64_t wordno = 0; wordno < bitmap_.word_count(); ++wordno) {
+    uint64_t word = bitmap_.GetWord(wordno);
+    if (word != 0) {
+      return wordno * kWordBits + __builtin_ctzll(word);
     }
   }
   return bit_count();
 }
 
 int64_t Bits::CountTrailingOnes() const {
-  for (int64_t i = 0; i < bit_count(); ++i) {
-    if (!Get(i)) {
-      return i;
+  for (int64_t wordno = 0; wordno < bitmap_.word_count(); ++wordno) {
+    uint64_t inverted = ~bitmap_.GetWord(wordno);
+    if (inverted != 0) {
+      // The first zero bit may be one of the unused (always zero) high bits
+      // of the last word, in which case every bit in the value is one.
+      return std::min<int64_t>(wordno * kWordBits + __builtin_ctzll(inverted),
+                               bit_count());
     }
   }
   return bit_count();
@@ -332,4 +358,11 @@ std::string Bits::ToRawDigits(FormatPreference preference,
   return result;
 }
 
+void RecycleBits(absl::Span<Bits> bits) {
+  ScratchBitmapPool& pool = ScratchBitmapPool::ThreadLocal();
+  for (Bits& b : bits) {
+    pool.Release(std::move(b).TakeBitmap());
+  }
+}
+
 }  // namespace xls
@@ -28,9 +28,14 @@
 #include "xls/common/logging/logging.h"
 #include "xls/common/math_util.h"
 #include "xls/data_structures/inline_bitmap.h"
+#include "xls/data_structures/scratch_bitmap_pool.h"
 #include "xls/ir/bit_push_buffer.h"
 #include "xls/ir/format_preference.h"
 
+#ifdef XLS_IR_COPY_AUDIT
+#include "xls/ir/copy_audit.h"
+#endif
+
 namespace xls {
 namespace internal {
 
@@ -60,6 +65,29 @@ class Bits {
   // absl::InlinedVector instead.
   explicit Bits(absl::Span<bool const> bits);
 
+#ifdef XLS_IR_COPY_AUDIT
+  // Audit builds spell out the otherwise-defaulted copy/move operations so
+  // each one can be counted (and copies charged for the bytes of backing
+  // storage duplicated) under the enclosing copy_audit::AuditScope. See
+  // xls/ir/copy_audit.h.
+  Bits(const Bits& other) : bitmap_(other.bitmap_) {
+    copy_audit::RecordCopy("Bits", bitmap_.byte_count());
+  }
+  Bits& operator=(const Bits& other) {
+    bitmap_ = other.bitmap_;
+    copy_audit::RecordCopy("Bits", bitmap_.byte_count());
+    return *this;
+  }
+  Bits(Bits&& other) : bitmap_(std::move(other.bitmap_)) {
+    copy_audit::RecordMove("Bits");
+  }
+  Bits& operator=(Bits&& other) {
+    bitmap_ = std::move(other.bitmap_);
+    copy_audit::RecordMove("Bits");
+    return *this;
+  }
+#endif
+
   // Returns a Bits object with all ones. If 'bit_count' is zero, an empty Bits
   // object is returned as, vacuously, an empty bits object has all of its bits
   // set to one.
@@ -251,6 +279,11 @@ class Bits {
 
   const InlineBitmap& bitmap() const { return bitmap_; }
 
+  // Moves the backing bitmap out of this Bits object, leaving it in a
+  // valid-but-unspecified state. Used by the destination-passing operations in
+  // bits_ops.h to recycle the allocation of a dead value.
+  InlineBitmap&& TakeBitmap() && { return std::move(bitmap_); }
+
   template <typename H>
   friend H AbslHashValue(H h, const Bits& bits) {
     return H::combine(std::move(h), bits.bitmap_);
@@ -266,11 +299,28 @@ class Bits {
   InlineBitmap bitmap_;
 };
 
+// Returns the backing stores of the given dead Bits values to the
+// thread-local scratch pool so later BitsRope constructions can reuse them.
+// The values must not be used afterwards.
+void RecycleBits(absl::Span<Bits> bits);
+
 // Helper for "stringing together" bits objects into a final result, avoiding
-// intermediate allocations.
+// intermediate allocations. The backing store is drawn from the thread-local
+// ScratchBitmapPool; a rope destroyed without calling Build() returns it to
+// the pool, while a built Bits owns its store outright.
 class BitsRope {
  public:
-  explicit BitsRope(int64_t total_bit_count) : bitmap_(total_bit_count) {}
+  explicit BitsRope(int64_t total_bit_count)
+      : bitmap_(ScratchBitmapPool::ThreadLocal().Acquire(total_bit_count)) {}
+
+  BitsRope(const BitsRope&) = delete;
+  BitsRope& operator=(const BitsRope&) = delete;
+
+  ~BitsRope() {
+    if (!built_) {
+      ScratchBitmapPool::ThreadLocal().Release(std::move(bitmap_));
+    }
+  }
 
   // Pushes the bits object into the bit string being built.
   //
@@ -296,12 +346,14 @@ class BitsRope {
 
   Bits Build() {
     XLS_CHECK_EQ(index_, bitmap_.bit_count());
+    built_ = true;
     return Bits{std::move(bitmap_)};
   }
 
  private:
   InlineBitmap bitmap_;
   int64_t index_ = 0;
+  bool built_ = false;
 };
 
 // Creates an Bits object which holds the given unsigned/signed value. Width
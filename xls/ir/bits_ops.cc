@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "xls/common/logging/logging.h"
+#include "xls/data_structures/bitmap_kernels.h"
 #include "xls/ir/big_int.h"
 
 namespace xls {
@@ -35,74 +36,152 @@ Bits TruncateOrSignExtend(const Bits& bits, int64_t bit_count) {
   }
 }
 
+// Reclaims the backing storage of '*out' for writing a 'bit_count'-wide
+// result; allocates only if the existing storage does not match. The returned
+// bitmap holds the previous contents of '*out' when no allocation was needed,
+// which the aliasing-aware callers below rely upon.
+InlineBitmap ReclaimBitmap(Bits* out, int64_t bit_count) {
+  InlineBitmap bitmap = std::move(*out).TakeBitmap();
+  if (bitmap.bit_count() != bit_count ||
+      bitmap.words().size() != CeilOfRatio(bit_count, int64_t{64})) {
+    return InlineBitmap(bit_count);
+  }
+  return bitmap;
+}
+
+// Shared body of the bitwise destination-passing operations; 'kernel' is one
+// of the bulk word kernels from bitmap_kernels.h.
+void BinaryWordOpInto(void (*kernel)(absl::Span<const uint64_t>,
+                                     absl::Span<const uint64_t>,
+                                     absl::Span<uint64_t>),
+                      const Bits& lhs, const Bits& rhs, Bits* out) {
+  XLS_CHECK_EQ(lhs.bit_count(), rhs.bit_count());
+  InlineBitmap result = ReclaimBitmap(out, lhs.bit_count());
+  // If 'out' aliases an operand its storage now lives in 'result'.
+  absl::Span<const uint64_t> lhs_words =
+      (out == &lhs) ? result.words() : lhs.bitmap().words();
+  absl::Span<const uint64_t> rhs_words =
+      (out == &rhs) ? result.words() : rhs.bitmap().words();
+  kernel(lhs_words, rhs_words, result.mutable_words());
+  *out = Bits::FromBitmap(std::move(result));
+}
+
 }  // namespace
 
+void AndInto(const Bits& lhs, const Bits& rhs, Bits* out) {
+  BinaryWordOpInto(bitmap_kernels::AndWords, lhs, rhs, out);
+}
+
+void OrInto(const Bits& lhs, const Bits& rhs, Bits* out) {
+  BinaryWordOpInto(bitmap_kernels::OrWords, lhs, rhs, out);
+}
+
+void XorInto(const Bits& lhs, const Bits& rhs, Bits* out) {
+  BinaryWordOpInto(bitmap_kernels::XorWords, lhs, rhs, out);
+}
+
+void NotInto(const Bits& bits, Bits* out) {
+  InlineBitmap result = ReclaimBitmap(out, bits.bit_count());
+  absl::Span<const uint64_t> words =
+      (out == &bits) ? result.words() : bits.bitmap().words();
+  bitmap_kernels::NotWords(words, result.mutable_words());
+  if (!result.words().empty()) {
+    // Re-mask the bits beyond bit_count() in the last word.
+    result.SetWord(result.words().size() - 1, result.words().back());
+  }
+  *out = Bits::FromBitmap(std::move(result));
+}
+
+void AddInto(const Bits& lhs, const Bits& rhs, Bits* out) {
+  XLS_CHECK_EQ(lhs.bit_count(), rhs.bit_count());
+  InlineBitmap result = ReclaimBitmap(out, lhs.bit_count());
+  absl::Span<const uint64_t> lhs_words =
+      (out == &lhs) ? result.words() : lhs.bitmap().words();
+  absl::Span<const uint64_t> rhs_words =
+      (out == &rhs) ? result.words() : rhs.bitmap().words();
+  absl::Span<uint64_t> out_words = result.mutable_words();
+  const int64_t word_count = out_words.size();
+  uint64_t carry = 0;
+  for (int64_t i = 0; i < word_count; ++i) {
+    uint64_t sum = lhs_words[i] + carry;
+    uint64_t carry_out = (sum < carry) ? 1 : 0;
+    sum += rhs_words[i];
+    carry_out |= (sum < rhs_words[i]) ? 1 : 0;
+    out_words[i] = sum;
+    carry = carry_out;
+  }
+  if (word_count > 0) {
+    // Truncate the carried-out bits beyond bit_count() in the last word.
+    result.SetWord(word_count - 1, out_words[word_count - 1]);
+  }
+  *out = Bits::FromBitmap(std::move(result));
+}
+
+void SubInto(const Bits& lhs, const Bits& rhs, Bits* out) {
+  XLS_CHECK_EQ(lhs.bit_count(), rhs.bit_count());
+  InlineBitmap result = ReclaimBitmap(out, lhs.bit_count());
+  absl::Span<const uint64_t> lhs_words =
+      (out == &lhs) ? result.words() : lhs.bitmap().words();
+  absl::Span<const uint64_t> rhs_words =
+      (out == &rhs) ? result.words() : rhs.bitmap().words();
+  absl::Span<uint64_t> out_words = result.mutable_words();
+  const int64_t word_count = out_words.size();
+  uint64_t borrow = 0;
+  for (int64_t i = 0; i < word_count; ++i) {
+    uint64_t borrow_out = (lhs_words[i] < borrow) ? 1 : 0;
+    uint64_t diff = lhs_words[i] - borrow;
+    borrow_out |= (diff < rhs_words[i]) ? 1 : 0;
+    out_words[i] = diff - rhs_words[i];
+    borrow = borrow_out;
+  }
+  if (word_count > 0) {
+    // Truncate the borrowed-out bits beyond bit_count() in the last word.
+    result.SetWord(word_count - 1, out_words[word_count - 1]);
+  }
+  *out = Bits::FromBitmap(std::move(result));
+}
+
 Bits And(const Bits& lhs, const Bits& rhs) {
   XLS_CHECK_EQ(lhs.bit_count(), rhs.bit_count());
-  if (lhs.bit_count() <= 64) {
-    return UBits(lhs.ToUint64().value() & rhs.ToUint64().value(),
-                 lhs.bit_count());
-  }
-  std::vector<uint8_t> bytes = lhs.ToBytes();
-  std::vector<uint8_t> rhs_bytes = rhs.ToBytes();
-  for (int64_t i = 0; i < bytes.size(); ++i) {
-    bytes[i] = bytes[i] & rhs_bytes[i];
-  }
-  return Bits::FromBytes(bytes, lhs.bit_count());
+  InlineBitmap result = lhs.bitmap();
+  result.And(rhs.bitmap());
+  return Bits::FromBitmap(std::move(result));
 }
 
 Bits NaryAnd(absl::Span<const Bits> operands) {
   Bits accum = operands.at(0);
   for (int64_t i = 1; i < operands.size(); ++i) {
-    accum = And(accum, operands[i]);
+    AndInto(accum, operands[i], &accum);
   }
   return accum;
 }
 
 Bits Or(const Bits& lhs, const Bits& rhs) {
   XLS_CHECK_EQ(lhs.bit_count(), rhs.bit_count());
-  if (lhs.bit_count() <= 64) {
-    uint64_t lhs_int = lhs.ToUint64().value();
-    uint64_t rhs_int = rhs.ToUint64().value();
-    uint64_t result = (lhs_int | rhs_int);
-    return UBits(result, lhs.bit_count());
-  }
-  std::vector<uint8_t> bytes = lhs.ToBytes();
-  std::vector<uint8_t> rhs_bytes = rhs.ToBytes();
-  for (int64_t i = 0; i < bytes.size(); ++i) {
-    bytes[i] = bytes[i] | rhs_bytes[i];
-  }
-  return Bits::FromBytes(bytes, lhs.bit_count());
+  InlineBitmap result = lhs.bitmap();
+  result.Or(rhs.bitmap());
+  return Bits::FromBitmap(std::move(result));
 }
 
 Bits NaryOr(absl::Span<const Bits> operands) {
   Bits accum = operands.at(0);
   for (int64_t i = 1; i < operands.size(); ++i) {
-    accum = Or(accum, operands[i]);
+    OrInto(accum, operands[i], &accum);
   }
   return accum;
 }
 
 Bits Xor(const Bits& lhs, const Bits& rhs) {
   XLS_CHECK_EQ(lhs.bit_count(), rhs.bit_count());
-  if (lhs.bit_count() <= 64) {
-    uint64_t lhs_int = lhs.ToUint64().value();
-    uint64_t rhs_int = rhs.ToUint64().value();
-    uint64_t result = (lhs_int ^ rhs_int);
-    return UBits(result, lhs.bit_count());
-  }
-  std::vector<uint8_t> bytes = lhs.ToBytes();
-  std::vector<uint8_t> rhs_bytes = rhs.ToBytes();
-  for (int64_t i = 0; i < bytes.size(); ++i) {
-    bytes[i] = bytes[i] ^ rhs_bytes[i];
-  }
-  return Bits::FromBytes(bytes, lhs.bit_count());
+  InlineBitmap result = lhs.bitmap();
+  result.Xor(rhs.bitmap());
+  return Bits::FromBitmap(std::move(result));
 }
 
 Bits NaryXor(absl::Span<const Bits> operands) {
   Bits accum = operands.at(0);
   for (int64_t i = 1; i < operands.size(); ++i) {
-    accum = Xor(accum, operands[i]);
+    XorInto(accum, operands[i], &accum);
   }
   return accum;
 }
@@ -114,20 +193,19 @@ Bits Nand(const Bits& lhs, const Bits& rhs) {
                      Mask(lhs.bit_count()),
                  lhs.bit_count());
   }
-  std::vector<uint8_t> bytes = lhs.ToBytes();
-  std::vector<uint8_t> rhs_bytes = rhs.ToBytes();
-  for (int64_t i = 0; i < bytes.size(); ++i) {
-    bytes[i] = ~(bytes[i] & rhs_bytes[i]);
-  }
-  return Bits::FromBytes(bytes, lhs.bit_count());
+  Bits result;
+  AndInto(lhs, rhs, &result);
+  NotInto(result, &result);
+  return result;
 }
 
 Bits NaryNand(absl::Span<const Bits> operands) {
   Bits accum = operands.at(0);
   for (int64_t i = 1; i < operands.size(); ++i) {
-    accum = And(accum, operands[i]);
+    AndInto(accum, operands[i], &accum);
   }
-  return Not(accum);
+  NotInto(accum, &accum);
+  return accum;
 }
 
 Bits Nor(const Bits& lhs, const Bits& rhs) {
@@ -137,32 +215,25 @@ Bits Nor(const Bits& lhs, const Bits& rhs) {
                      Mask(lhs.bit_count()),
                  lhs.bit_count());
   }
-  std::vector<uint8_t> bytes = lhs.ToBytes();
-  std::vector<uint8_t> rhs_bytes = rhs.ToBytes();
-  for (int64_t i = 0; i < bytes.size(); ++i) {
-    bytes[i] = ~(bytes[i] | rhs_bytes[i]);
-  }
-  return Bits::FromBytes(bytes, lhs.bit_count());
+  Bits result;
+  OrInto(lhs, rhs, &result);
+  NotInto(result, &result);
+  return result;
 }
 
 Bits NaryNor(absl::Span<const Bits> operands) {
   Bits accum = operands.at(0);
   for (int64_t i = 1; i < operands.size(); ++i) {
-    accum = Or(accum, operands[i]);
+    OrInto(accum, operands[i], &accum);
   }
-  return Not(accum);
+  NotInto(accum, &accum);
+  return accum;
 }
 
 Bits Not(const Bits& bits) {
-  if (bits.bit_count() <= 64) {
-    return UBits((~bits.ToUint64().value()) & Mask(bits.bit_count()),
-                 bits.bit_count());
-  }
-  std::vector<uint8_t> bytes = bits.ToBytes();
-  for (uint8_t& byte : bytes) {
-    byte = ~byte;
-  }
-  return Bits::FromBytes(bytes, bits.bit_count());
+  InlineBitmap result = bits.bitmap();
+  result.Not();
+  return Bits::FromBitmap(std::move(result));
 }
 
 Bits AndReduce(const Bits& operand) {
@@ -189,9 +260,9 @@ Bits Add(const Bits& lhs, const Bits& rhs) {
     return UBits(result, lhs.bit_count());
   }
 
-  Bits sum = BigInt::Add(BigInt::MakeSigned(lhs), BigInt::MakeSigned(rhs))
-                 .ToSignedBits();
-  return TruncateOrSignExtend(sum, lhs.bit_count());
+  Bits sum;
+  AddInto(lhs, rhs, &sum);
+  return sum;
 }
 
 Bits Sub(const Bits& lhs, const Bits& rhs) {
@@ -202,9 +273,9 @@ Bits Sub(const Bits& lhs, const Bits& rhs) {
     uint64_t result = (lhs_int - rhs_int) & Mask(lhs.bit_count());
     return UBits(result, lhs.bit_count());
   }
-  Bits diff = BigInt::Sub(BigInt::MakeSigned(lhs), BigInt::MakeSigned(rhs))
-                  .ToSignedBits();
-  return TruncateOrSignExtend(diff, lhs.bit_count());
+  Bits diff;
+  SubInto(lhs, rhs, &diff);
+  return diff;
 }
 
 Bits Mul(const Bits& lhs, const Bits& rhs) {
@@ -415,6 +486,20 @@ Bits Concat(absl::Span<const Bits> inputs) {
   return rope.Build();
 }
 
+Bits Concat(absl::Span<const Bits* const> inputs) {
+  int64_t new_bit_count = 0;
+  for (const Bits* bits : inputs) {
+    new_bit_count += bits->bit_count();
+  }
+  // Iterate in reverse order because the first input becomes the
+  // most-significant bits.
+  BitsRope rope(new_bit_count);
+  for (int64_t i = 0; i < inputs.size(); ++i) {
+    rope.push_back(*inputs[inputs.size() - i - 1]);
+  }
+  return rope.Build();
+}
+
 Bits Negate(const Bits& bits) {
   if (bits.bit_count() < 64) {
     return UBits((-bits.ToInt64().value()) & Mask(bits.bit_count()),
@@ -455,21 +540,39 @@ Bits ShiftRightArith(const Bits& bits, int64_t shift_amount) {
 }
 
 Bits OneHotLsbToMsb(const Bits& bits) {
-  for (int64_t i = 0; i < bits.bit_count(); ++i) {
-    if (bits.Get(i)) {
-      return Bits::PowerOfTwo(i, bits.bit_count() + 1);
-    }
-  }
-  return Bits::PowerOfTwo(bits.bit_count(), bits.bit_count() + 1);
+  // CountTrailingZeros (a word-wise bit scan) is the index of the first set
+  // bit, or bit_count() if no bit is set which is exactly the index of the
+  // default bit of the result.
+  return Bits::PowerOfTwo(bits.CountTrailingZeros(), bits.bit_count() + 1);
 }
 
 Bits OneHotMsbToLsb(const Bits& bits) {
-  for (int64_t i = bits.bit_count() - 1; i >= 0; --i) {
-    if (bits.Get(i)) {
-      return Bits::PowerOfTwo(i, bits.bit_count() + 1);
+  int64_t leading_zeros = bits.CountLeadingZeros();
+  if (leading_zeros == bits.bit_count()) {
+    // No bit is set; assert the default bit.
+    return Bits::PowerOfTwo(bits.bit_count(), bits.bit_count() + 1);
+  }
+  return Bits::PowerOfTwo(bits.bit_count() - 1 - leading_zeros,
+                          bits.bit_count() + 1);
+}
+
+Bits Encode(const Bits& bits, int64_t result_bit_count) {
+  // The encode operation ORs together the indices of all set bits. Scan the
+  // operand a storage word at a time, peeling set bits off with trailing-zero
+  // counts rather than testing every bit position.
+  constexpr int64_t kWordBits = 64;
+  uint64_t accumulated = 0;
+  for (int64_t wordno = 0; wordno < bits.bitmap().word_count(); ++wordno) {
+    uint64_t word = bits.bitmap().GetWord(wordno);
+    while (word != 0) {
+      accumulated |= wordno * kWordBits + __builtin_ctzll(word);
+      word &= word - 1;
     }
   }
-  return Bits::PowerOfTwo(bits.bit_count(), bits.bit_count() + 1);
+  if (result_bit_count < 64) {
+    accumulated &= Mask(result_bit_count);
+  }
+  return UBits(accumulated, result_bit_count);
 }
 
 Bits Reverse(const Bits& bits) {
@@ -45,6 +45,18 @@ Bits XorReduce(const Bits& operand);
 Bits Add(const Bits& lhs, const Bits& rhs);
 Bits Sub(const Bits& lhs, const Bits& rhs);
 
+// Destination-passing variants of the bitwise and add/sub operations above.
+// The result is written into '*out', recycling its existing backing storage
+// when its width already matches the result width, so steady-state calls
+// (e.g. per-node evaluation in the interpreter) do not allocate. 'out' may
+// alias an input operand; any previous value of '*out' is discarded.
+void AndInto(const Bits& lhs, const Bits& rhs, Bits* out);
+void OrInto(const Bits& lhs, const Bits& rhs, Bits* out);
+void XorInto(const Bits& lhs, const Bits& rhs, Bits* out);
+void NotInto(const Bits& bits, Bits* out);
+void AddInto(const Bits& lhs, const Bits& rhs, Bits* out);
+void SubInto(const Bits& lhs, const Bits& rhs, Bits* out);
+
 // Signed/unsigned multiplication. The rhs and lhs can be different widths. The
 // width of the result of the operation is the sum of the widths of the
 // operands.
@@ -122,10 +134,20 @@ Bits Abs(const Bits& bits);
 // span becomes the most significant bits in the returned Bits object.
 Bits Concat(absl::Span<const Bits> inputs);
 
+// Overload taking pointers to the inputs. Avoids copying the inputs into a
+// contiguous vector at gather-heavy call sites such as value flattening and
+// the IR interpreter's concat handler.
+Bits Concat(absl::Span<const Bits* const> inputs);
+
 // Performs an operation equivalent to the XLS IR Op::kOneHot operation.
 Bits OneHotLsbToMsb(const Bits& bits);
 Bits OneHotMsbToLsb(const Bits& bits);
 
+// Performs an operation equivalent to the XLS IR Op::kEncode operation: the
+// OR of the indices of all set bits of the operand, as a value of
+// 'result_bit_count' bits.
+Bits Encode(const Bits& bits, int64_t result_bit_count);
+
 inline int64_t CountLeadingOnes(const Bits& bits) {
   return Not(bits).CountLeadingZeros();
 }
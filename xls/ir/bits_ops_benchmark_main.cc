@@ -0,0 +1,87 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmark for the bulk logical operations in bits_ops. Reports
+// nanoseconds per operation across a range of bit widths so regressions in
+// the word-level kernels (and their vectorized variants) are easy to spot:
+//
+//   bazel run -c opt //xls/ir:bits_ops_benchmark_main
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/common/init_xls.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/bits_ops.h"
+
+ABSL_FLAG(int64_t, iterations, 100000,
+          "Number of operations to time per (operation, width) pair.");
+
+namespace xls {
+namespace {
+
+// Returns a Bits of the given width with a deterministic bit pattern.
+Bits MakeBits(int64_t bit_count, uint64_t seed) {
+  InlineBitmap bitmap(bit_count);
+  for (int64_t i = 0; i < bitmap.byte_count(); ++i) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    bitmap.SetByte(i, static_cast<uint8_t>(seed >> 32));
+  }
+  return Bits::FromBitmap(std::move(bitmap));
+}
+
+template <typename F>
+void RunBenchmark(absl::string_view name, int64_t bit_count,
+                  int64_t iterations, F f) {
+  // Warm up to resolve the runtime kernel dispatch and fault in pages.
+  f();
+  absl::Time start = absl::Now();
+  for (int64_t i = 0; i < iterations; ++i) {
+    f();
+  }
+  absl::Duration elapsed = absl::Now() - start;
+  std::cout << absl::StreamFormat(
+      "%-8s %6d bits: %8.1f ns/op\n", name, bit_count,
+      absl::ToDoubleNanoseconds(elapsed) / iterations);
+}
+
+void RealMain() {
+  const int64_t iterations = absl::GetFlag(FLAGS_iterations);
+  for (int64_t bit_count : {64, 256, 1024, 4096, 16384}) {
+    Bits lhs = MakeBits(bit_count, /*seed=*/0x12345678);
+    Bits rhs = MakeBits(bit_count, /*seed=*/0x9abcdef0);
+    RunBenchmark("And", bit_count, iterations,
+                 [&] { return bits_ops::And(lhs, rhs); });
+    RunBenchmark("Or", bit_count, iterations,
+                 [&] { return bits_ops::Or(lhs, rhs); });
+    RunBenchmark("Xor", bit_count, iterations,
+                 [&] { return bits_ops::Xor(lhs, rhs); });
+    RunBenchmark("Not", bit_count, iterations,
+                 [&] { return bits_ops::Not(lhs); });
+  }
+}
+
+}  // namespace
+}  // namespace xls
+
+int main(int argc, char** argv) {
+  xls::InitXls(argv[0], argc, argv);
+  xls::RealMain();
+  return 0;
+}
@@ -681,6 +681,21 @@ TEST(BitsOpsTest, OneHot) {
             UBits(0b100000000, 9));
 }
 
+TEST(BitsOpsTest, Encode) {
+  EXPECT_EQ(bits_ops::Encode(Bits(0), 0), Bits(0));
+  EXPECT_EQ(bits_ops::Encode(UBits(0, 8), 3), UBits(0, 3));
+  EXPECT_EQ(bits_ops::Encode(UBits(0b00100000, 8), 3), UBits(5, 3));
+  // Multiple set bits OR their indices together.
+  EXPECT_EQ(bits_ops::Encode(UBits(0b101000, 6), 3), UBits(3 | 5, 3));
+  // Result width may be wider than strictly necessary.
+  EXPECT_EQ(bits_ops::Encode(UBits(0b10, 2), 16), UBits(1, 16));
+  // A set bit beyond the first storage word.
+  EXPECT_EQ(bits_ops::Encode(Bits::PowerOfTwo(100, 130), 8), UBits(100, 8));
+  EXPECT_EQ(bits_ops::Encode(
+                bits_ops::Or(Bits::PowerOfTwo(100, 130), UBits(0b100, 130)), 8),
+            UBits(100 | 2, 8));
+}
+
 TEST(BitsOpsTest, Nor3) {
   std::vector<std::pair<std::array<uint8_t, 3>, uint8_t>> cases = {
       {{0, 0, 0}, 1},  //
@@ -828,5 +843,57 @@ TEST(BitsOpsTest, LongestCommonPrefixLSBMoreThan2) {
   EXPECT_EQ(bits_ops::LongestCommonPrefixLSB({x, y, z}), expected);
 }
 
+TEST(BitsOpsTest, DestinationPassingForms) {
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Bits wide_lhs,
+      ParseNumber("0x1fff_ffff_ffff_ffff_ffff_0000_0000_0000_0000_0042"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Bits wide_rhs,
+      ParseNumber("0x1000_0000_0000_0000_0001_1234_4444_3333_0000_1234"));
+
+  // The Into forms must agree with their value-returning counterparts,
+  // including when the destination already holds a matching-width value
+  // (storage recycling) and when it aliases an operand.
+  Bits out;
+  bits_ops::AndInto(wide_lhs, wide_rhs, &out);
+  EXPECT_EQ(out, bits_ops::And(wide_lhs, wide_rhs));
+  bits_ops::OrInto(wide_lhs, wide_rhs, &out);
+  EXPECT_EQ(out, bits_ops::Or(wide_lhs, wide_rhs));
+  bits_ops::XorInto(wide_lhs, wide_rhs, &out);
+  EXPECT_EQ(out, bits_ops::Xor(wide_lhs, wide_rhs));
+  bits_ops::NotInto(wide_lhs, &out);
+  EXPECT_EQ(out, bits_ops::Not(wide_lhs));
+  bits_ops::AddInto(wide_lhs, wide_rhs, &out);
+  EXPECT_EQ(out, bits_ops::Add(wide_lhs, wide_rhs));
+  bits_ops::SubInto(wide_lhs, wide_rhs, &out);
+  EXPECT_EQ(out, bits_ops::Sub(wide_lhs, wide_rhs));
+
+  // Aliased destinations.
+  Bits accum = wide_lhs;
+  bits_ops::AddInto(accum, wide_rhs, &accum);
+  EXPECT_EQ(accum, bits_ops::Add(wide_lhs, wide_rhs));
+  accum = wide_lhs;
+  bits_ops::SubInto(wide_rhs, accum, &accum);
+  EXPECT_EQ(accum, bits_ops::Sub(wide_rhs, wide_lhs));
+  accum = wide_lhs;
+  bits_ops::XorInto(accum, accum, &accum);
+  EXPECT_EQ(accum, Bits(wide_lhs.bit_count()));
+  accum = wide_lhs;
+  bits_ops::NotInto(accum, &accum);
+  EXPECT_EQ(accum, bits_ops::Not(wide_lhs));
+
+  // Narrow (sub-word) values with truncation of the carried-out bit.
+  Bits narrow = UBits(10, 4);
+  bits_ops::AddInto(narrow, UBits(13, 4), &narrow);
+  EXPECT_EQ(narrow, UBits(7, 4));
+  bits_ops::SubInto(narrow, UBits(9, 4), &narrow);
+  EXPECT_EQ(narrow, UBits(14, 4));
+
+  // Zero-width values.
+  Bits empty;
+  bits_ops::AddInto(Bits(), Bits(), &empty);
+  EXPECT_EQ(empty, Bits());
+}
+
 }  // namespace
 }  // namespace xls
@@ -14,8 +14,13 @@
 
 #include "xls/ir/block.h"
 
+#include <algorithm>
+#include <ostream>
+#include <sstream>
+
 #include "absl/container/btree_set.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
@@ -193,6 +198,12 @@ std::vector<Node*> Block::DumpOrder() const {
 }
 
 std::string Block::DumpIr() const {
+  std::ostringstream os;
+  DumpIrTo(os);
+  return os.str();
+}
+
+void Block::DumpIrTo(std::ostream& os) const {
   std::vector<std::string> port_strings;
   for (const Port& port : GetPorts()) {
     if (absl::holds_alternative<ClockPort*>(port)) {
@@ -208,22 +219,21 @@ std::string Block::DumpIr() const {
           absl::get<OutputPort*>(port)->operand(0)->GetType()->ToString()));
     }
   }
-  std::string res = absl::StrFormat("block %s(%s) {\n", name(),
-                                    absl::StrJoin(port_strings, ", "));
+  os << absl::StrFormat("block %s(%s) {\n", name(),
+                        absl::StrJoin(port_strings, ", "));
 
   for (Instantiation* instantiation : GetInstantiations()) {
-    absl::StrAppendFormat(&res, "  %s\n", instantiation->ToString());
+    os << absl::StrFormat("  %s\n", instantiation->ToString());
   }
 
   for (Register* reg : GetRegisters()) {
-    absl::StrAppendFormat(&res, "  %s\n", reg->ToString());
+    os << absl::StrFormat("  %s\n", reg->ToString());
   }
 
   for (Node* node : DumpOrder()) {
-    absl::StrAppend(&res, "  ", node->ToString(), "\n");
+    os << "  " << node->ToString() << "\n";
   }
-  absl::StrAppend(&res, "}\n");
-  return res;
+  os << "}\n";
 }
 
 absl::Status Block::SetPortNameExactly(absl::string_view name, Node* node) {
@@ -322,6 +332,47 @@ absl::StatusOr<Register*> Block::AddRegister(absl::string_view name, Type* type,
   return register_vec_.back();
 }
 
+absl::StatusOr<std::vector<Register*>> Block::AddRegisters(
+    absl::Span<const RegisterSpec> registers) {
+  // Validate the entire batch before mutating any state so a failure leaves
+  // the block unchanged.
+  absl::flat_hash_set<absl::string_view> batch_names;
+  batch_names.reserve(registers.size());
+  for (const RegisterSpec& spec : registers) {
+    if (registers_.contains(spec.name) ||
+        !batch_names.insert(spec.name).second) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Register already exists with name %s", spec.name));
+    }
+    if (spec.reset.has_value() &&
+        spec.type != package()->GetTypeForValue(spec.reset->reset_value)) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Reset value %s for register %s is not of type %s",
+          spec.reset->reset_value.ToString(), spec.name,
+          spec.type->ToString()));
+    }
+  }
+
+  // Grow each container once for the whole batch.
+  registers_.reserve(registers_.size() + registers.size());
+  register_reads_.reserve(register_reads_.size() + registers.size());
+  register_writes_.reserve(register_writes_.size() + registers.size());
+  register_vec_.reserve(register_vec_.size() + registers.size());
+
+  std::vector<Register*> result;
+  result.reserve(registers.size());
+  for (const RegisterSpec& spec : registers) {
+    registers_[spec.name] =
+        std::make_unique<Register>(spec.name, spec.type, spec.reset);
+    Register* reg = registers_[spec.name].get();
+    register_vec_.push_back(reg);
+    register_reads_[reg] = {};
+    register_writes_[reg] = {};
+    result.push_back(reg);
+  }
+  return result;
+}
+
 absl::Status Block::RemoveRegister(Register* reg) {
   if (!IsOwned(reg)) {
     return absl::InvalidArgumentError("Register is not owned by block.");
@@ -343,6 +394,43 @@ absl::Status Block::RemoveRegister(Register* reg) {
   return absl::OkStatus();
 }
 
+absl::Status Block::RemoveRegisters(absl::Span<Register* const> registers) {
+  if (registers.empty()) {
+    return absl::OkStatus();
+  }
+  absl::flat_hash_set<Register*> to_remove;
+  to_remove.reserve(registers.size());
+  for (Register* reg : registers) {
+    if (!IsOwned(reg)) {
+      return absl::InvalidArgumentError("Register is not owned by block.");
+    }
+    if (!register_reads_.at(reg).empty() ||
+        !register_writes_.at(reg).empty()) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Register %s can't be removed because a register "
+                          "read or write operation for this register still "
+                          "exists",
+                          reg->name()));
+    }
+    if (!to_remove.insert(reg).second) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Register %s specified more than once", reg->name()));
+    }
+  }
+  // A single pass over the register vector rather than one linear erase per
+  // removed register.
+  register_vec_.erase(
+      std::remove_if(register_vec_.begin(), register_vec_.end(),
+                     [&](Register* reg) { return to_remove.contains(reg); }),
+      register_vec_.end());
+  for (Register* reg : registers) {
+    register_reads_.erase(reg);
+    register_writes_.erase(reg);
+    registers_.erase(reg->name());
+  }
+  return absl::OkStatus();
+}
+
 absl::StatusOr<Register*> Block::GetRegister(absl::string_view name) const {
   if (!registers_.contains(name)) {
     return absl::NotFoundError(absl::StrFormat(
@@ -95,10 +95,33 @@ class Block : public FunctionBase {
       absl::string_view name, Type* type,
       absl::optional<Reset> reset = absl::nullopt);
 
+  // Describes one register of a batch passed to AddRegisters().
+  struct RegisterSpec {
+    std::string name;
+    Type* type;
+    absl::optional<Reset> reset;
+  };
+
+  // Batch variant of AddRegister(). Validates the entire batch (no name may
+  // collide with an existing register or another entry of the batch) before
+  // mutating any state, grows the underlying containers once for the whole
+  // batch, and returns the created registers in the order given. Useful when
+  // creating many registers at once (e.g. the pipeline registers of a stage
+  // during block conversion) as repeated single insertions into the growing
+  // register map are avoided.
+  absl::StatusOr<std::vector<Register*>> AddRegisters(
+      absl::Span<const RegisterSpec> registers);
+
   // Removes the given register from the block. If the register is not owned by
   // the block then an error is returned.
   absl::Status RemoveRegister(Register* reg);
 
+  // Batch variant of RemoveRegister(). Removes the given registers with a
+  // single pass over the register list rather than one linear erase per
+  // register. No register may be removed while a register read or write
+  // operation for it remains in the block.
+  absl::Status RemoveRegisters(absl::Span<Register* const> registers);
+
   // Returns the unique register read or write operation associated with the
   // given register. Returns an error if the register is not owned by the block
   // or if no or more than one such read/write operation exists. A block with a
@@ -150,6 +173,7 @@ class Block : public FunctionBase {
   bool HasImplicitUse(Node* node) const override { return false; }
 
   std::string DumpIr() const override;
+  void DumpIrTo(std::ostream& os) const override;
 
  private:
   static std::string PortName(const Port& port);
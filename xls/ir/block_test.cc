@@ -412,6 +412,43 @@ TEST_F(BlockTest, RemoveRegisters) {
                HasSubstr("Block my_block has no register named my_reg")));
 }
 
+TEST_F(BlockTest, AddAndRemoveRegisterBatch) {
+  Package p(TestName());
+  Block* blk = p.AddBlock(std::make_unique<Block>("block1", &p));
+  XLS_ASSERT_OK(blk->AddClockPort("clk"));
+  Type* u8 = p.GetBitsType(8);
+  Type* u32 = p.GetBitsType(32);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<Register*> regs,
+      blk->AddRegisters({Block::RegisterSpec{"reg_a", u32},
+                         Block::RegisterSpec{"reg_b", u8},
+                         Block::RegisterSpec{"reg_c", u32}}));
+  ASSERT_EQ(regs.size(), 3);
+  EXPECT_THAT(blk->GetRegisters(),
+              ElementsAre(regs[0], regs[1], regs[2]));
+  EXPECT_THAT(blk->GetRegister("reg_b"), IsOkAndHolds(regs[1]));
+  EXPECT_EQ(regs[1]->type(), u8);
+
+  XLS_ASSERT_OK(blk->RemoveRegisters({regs[0], regs[2]}));
+  EXPECT_THAT(blk->GetRegisters(), ElementsAre(regs[1]));
+  EXPECT_THAT(blk->GetRegister("reg_a").status(),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST_F(BlockTest, AddRegisterBatchWithDuplicateName) {
+  Package p(TestName());
+  Block* blk = p.AddBlock(std::make_unique<Block>("block1", &p));
+  XLS_ASSERT_OK(blk->AddClockPort("clk"));
+  Type* u32 = p.GetBitsType(32);
+  // A name collision anywhere in the batch leaves the block unchanged.
+  EXPECT_THAT(blk->AddRegisters({Block::RegisterSpec{"reg_a", u32},
+                                 Block::RegisterSpec{"reg_a", u32}})
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Register already exists with name reg_a")));
+  EXPECT_TRUE(blk->GetRegisters().empty());
+}
+
 TEST_F(BlockTest, RegisterWithInvalidResetValue) {
   auto p = CreatePackage();
   Block* blk = p->AddBlock(std::make_unique<Block>("block1", p.get()));
@@ -0,0 +1,146 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/copy_audit.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+
+namespace xls {
+namespace copy_audit {
+namespace {
+
+struct Counters {
+  int64_t constructions = 0;
+  int64_t copies = 0;
+  int64_t moves = 0;
+  int64_t copied_bytes = 0;
+};
+
+// Counts keyed by (scope label, type). Labels are string literals so pointer
+// identity suffices in practice, but keys are materialized as strings to be
+// safe.
+struct Registry {
+  absl::Mutex mutex;
+  absl::flat_hash_map<std::pair<std::string, std::string>, Counters> counts
+      ABSL_GUARDED_BY(mutex);
+};
+
+Registry& GetRegistry() {
+  static Registry* registry = new Registry;
+  return *registry;
+}
+
+thread_local const char* current_label = nullptr;
+
+const char* CurrentLabel() {
+  return current_label == nullptr ? "(unscoped)" : current_label;
+}
+
+void DumpAtExit() {
+  std::string report = ReportToString();
+  std::fputs(report.c_str(), stderr);
+}
+
+// Registers the at-exit dump the first time anything is recorded, so builds
+// which link this library but never record print nothing.
+void EnsureDumpRegistered() {
+  static const bool registered = []() {
+    std::atexit(DumpAtExit);
+    return true;
+  }();
+  (void)registered;
+}
+
+Counters& GetCounters(const char* type)
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(GetRegistry().mutex) {
+  return GetRegistry().counts[{std::string(CurrentLabel()),
+                               std::string(type)}];
+}
+
+}  // namespace
+
+AuditScope::AuditScope(const char* label) : previous_label_(current_label) {
+  current_label = label;
+}
+
+AuditScope::~AuditScope() { current_label = previous_label_; }
+
+void RecordConstruction(const char* type, int64_t bytes) {
+  EnsureDumpRegistered();
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  Counters& counters = GetCounters(type);
+  ++counters.constructions;
+  (void)bytes;
+}
+
+void RecordCopy(const char* type, int64_t bytes) {
+  EnsureDumpRegistered();
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  Counters& counters = GetCounters(type);
+  ++counters.copies;
+  counters.copied_bytes += bytes;
+}
+
+void RecordMove(const char* type) {
+  EnsureDumpRegistered();
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  ++GetCounters(type).moves;
+}
+
+std::string ReportToString() {
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  std::vector<std::pair<std::pair<std::string, std::string>, Counters>> rows(
+      registry.counts.begin(), registry.counts.end());
+  std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+    if (a.second.copied_bytes != b.second.copied_bytes) {
+      return a.second.copied_bytes > b.second.copied_bytes;
+    }
+    return a.first < b.first;
+  });
+  std::string result = absl::StrFormat(
+      "%-40s %-6s %10s %10s %10s %12s\n", "scope", "type", "ctors", "copies",
+      "moves", "bytes");
+  for (const auto& [key, counters] : rows) {
+    absl::StrAppend(
+        &result,
+        absl::StrFormat("%-40s %-6s %10d %10d %10d %12d\n", key.first,
+                        key.second, counters.constructions, counters.copies,
+                        counters.moves, counters.copied_bytes));
+  }
+  return result;
+}
+
+void ResetForTest() {
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  registry.counts.clear();
+}
+
+}  // namespace copy_audit
+}  // namespace xls
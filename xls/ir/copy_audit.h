@@ -0,0 +1,68 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_IR_COPY_AUDIT_H_
+#define XLS_IR_COPY_AUDIT_H_
+
+#include <cstdint>
+#include <string>
+
+namespace xls {
+namespace copy_audit {
+
+// Instrumentation for locating hidden Bits/Value copy costs. When the build
+// is compiled with -DXLS_IR_COPY_AUDIT the copy and move operations of Bits
+// and Value record themselves here, attributed to the innermost enclosing
+// AuditScope on the calling thread. The accumulated counts are written to
+// stderr at process exit (and are available programmatically via
+// ReportToString), grouped by scope label and sorted by copied bytes. In
+// ordinary builds the recording calls are compiled out and this library is
+// inert.
+
+// Establishes an attribution label for Bits/Value operations performed on
+// this thread while the scope is live. Scopes nest; the innermost label
+// wins. Operations outside any scope are attributed to "(unscoped)". The
+// label must outlive the scope (string literals in practice).
+class AuditScope {
+ public:
+  explicit AuditScope(const char* label);
+  ~AuditScope();
+
+  AuditScope(const AuditScope&) = delete;
+  AuditScope& operator=(const AuditScope&) = delete;
+
+ private:
+  const char* previous_label_;
+};
+
+// Records a construction/copy/move of an object of the given type ("Bits" or
+// "Value") under the current scope label. 'bytes' is the size of the copied
+// backing storage; reference-count bumps record zero bytes.
+void RecordConstruction(const char* type, int64_t bytes);
+void RecordCopy(const char* type, int64_t bytes);
+void RecordMove(const char* type);
+
+// Returns the accumulated counts as a table grouped by (scope, type), sorted
+// by copied bytes descending:
+//
+//   scope                          type   ctors    copies   moves    bytes
+std::string ReportToString();
+
+// Discards all accumulated counts. Intended for tests.
+void ResetForTest();
+
+}  // namespace copy_audit
+}  // namespace xls
+
+#endif  // XLS_IR_COPY_AUDIT_H_
@@ -0,0 +1,91 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/copy_audit.h"
+
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace xls {
+namespace copy_audit {
+namespace {
+
+using ::testing::HasSubstr;
+
+class CopyAuditTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ResetForTest(); }
+};
+
+TEST_F(CopyAuditTest, EmptyReportHasOnlyHeader) {
+  std::string report = ReportToString();
+  EXPECT_THAT(report, HasSubstr("scope"));
+  EXPECT_THAT(report, HasSubstr("bytes"));
+  EXPECT_EQ(report.find('\n'), report.size() - 1);
+}
+
+TEST_F(CopyAuditTest, RecordsAreAttributedToScope) {
+  {
+    AuditScope scope("my_pass");
+    RecordCopy("Bits", /*bytes=*/16);
+    RecordCopy("Bits", /*bytes=*/16);
+    RecordMove("Bits");
+  }
+  std::string report = ReportToString();
+  EXPECT_THAT(report, HasSubstr("my_pass"));
+  EXPECT_THAT(report, HasSubstr("Bits"));
+  EXPECT_THAT(report, HasSubstr("32"));
+}
+
+TEST_F(CopyAuditTest, UnscopedRecordsUseDefaultLabel) {
+  RecordCopy("Value", /*bytes=*/0);
+  EXPECT_THAT(ReportToString(), HasSubstr("(unscoped)"));
+}
+
+TEST_F(CopyAuditTest, ScopesNestAndRestore) {
+  AuditScope outer("outer");
+  {
+    AuditScope inner("inner");
+    RecordConstruction("Bits", /*bytes=*/8);
+  }
+  RecordConstruction("Bits", /*bytes=*/8);
+  std::string report = ReportToString();
+  EXPECT_THAT(report, HasSubstr("inner"));
+  EXPECT_THAT(report, HasSubstr("outer"));
+}
+
+TEST_F(CopyAuditTest, RowsSortedByCopiedBytesDescending) {
+  {
+    AuditScope scope("small");
+    RecordCopy("Bits", /*bytes=*/1);
+  }
+  {
+    AuditScope scope("large");
+    RecordCopy("Bits", /*bytes=*/1000);
+  }
+  std::string report = ReportToString();
+  EXPECT_LT(report.find("large"), report.find("small"));
+}
+
+TEST_F(CopyAuditTest, ResetDiscardsCounts) {
+  RecordCopy("Bits", /*bytes=*/4);
+  ResetForTest();
+  EXPECT_THAT(ReportToString(), ::testing::Not(HasSubstr("Bits")));
+}
+
+}  // namespace
+}  // namespace copy_audit
+}  // namespace xls
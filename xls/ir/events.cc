@@ -14,7 +14,73 @@
 
 #include "xls/ir/events.h"
 
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "absl/strings/str_cat.h"
+#include "xls/common/status/status_macros.h"
+
 namespace xls {
+namespace {
+
+// Writes the full buffer to the file descriptor, looping over partial writes.
+absl::Status WriteAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t written = write(fd, data, size);
+    if (written < 0) {
+      return absl::InternalError(
+          absl::StrCat("Error streaming trace record: ", strerror(errno)));
+    }
+    data += written;
+    size -= written;
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+TraceRingBuffer::TraceRingBuffer(int64_t capacity, int stream_fd)
+    : capacity_(capacity), stream_fd_(stream_fd), messages_(capacity) {}
+
+absl::Status TraceRingBuffer::Record(absl::string_view msg) {
+  absl::MutexLock lock(&mutex_);
+  if (stream_fd_ >= 0) {
+    // Length-prefixed binary record: little-endian uint32 length then the
+    // message bytes, preformatted so consumers need no parsing beyond the
+    // framing.
+    uint32_t length = static_cast<uint32_t>(msg.size());
+    XLS_RETURN_IF_ERROR(
+        WriteAll(stream_fd_, reinterpret_cast<const char*>(&length),
+                 sizeof(length)));
+    XLS_RETURN_IF_ERROR(WriteAll(stream_fd_, msg.data(), msg.size()));
+  }
+  if (size_ == capacity_) {
+    ++dropped_;
+  } else {
+    ++size_;
+  }
+  messages_[next_] = std::string(msg);
+  next_ = (next_ + 1) % capacity_;
+  return absl::OkStatus();
+}
+
+std::vector<std::string> TraceRingBuffer::GetMessages() const {
+  absl::MutexLock lock(&mutex_);
+  std::vector<std::string> result;
+  result.reserve(size_);
+  int64_t start = (next_ - size_ + capacity_) % capacity_;
+  for (int64_t i = 0; i < size_; ++i) {
+    result.push_back(messages_[(start + i) % capacity_]);
+  }
+  return result;
+}
+
+int64_t TraceRingBuffer::dropped_count() const {
+  absl::MutexLock lock(&mutex_);
+  return dropped_;
+}
 
 absl::Status InterpreterEventsToStatus(const InterpreterEvents& events) {
   if (events.assert_msgs.empty()) {
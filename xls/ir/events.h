@@ -15,17 +15,81 @@
 #ifndef XLS_IR_EVENTS_H_
 #define XLS_IR_EVENTS_H_
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 
 namespace xls {
 
+// A bounded sink for trace messages. Retains the most recent `capacity`
+// messages in a ring buffer so long-running simulations with trace!() enabled
+// use constant memory; older messages are overwritten and counted as dropped.
+// If a file descriptor is supplied, every message is additionally streamed to
+// it as a length-prefixed binary record (little-endian uint32 length followed
+// by the message bytes) before buffering, giving a complete on-disk trace
+// without unbounded in-process growth. Recording is thread-safe so a single
+// sink may be shared by concurrent evaluation shards.
+class TraceRingBuffer {
+ public:
+  // `stream_fd` of -1 disables streaming; the descriptor is borrowed, not
+  // owned.
+  explicit TraceRingBuffer(int64_t capacity, int stream_fd = -1);
+
+  // Records a trace message, evicting the oldest buffered message if the
+  // buffer is full. Returns a non-OK status only if streaming to the file
+  // descriptor fails.
+  absl::Status Record(absl::string_view msg);
+
+  // Returns the buffered messages, oldest first.
+  std::vector<std::string> GetMessages() const;
+
+  // Number of messages which have been evicted from the ring buffer. The
+  // messages themselves are only lost if streaming is disabled.
+  int64_t dropped_count() const;
+
+  int64_t capacity() const { return capacity_; }
+
+ private:
+  const int64_t capacity_;
+  const int stream_fd_;
+
+  mutable absl::Mutex mutex_;
+  // Ring storage; `next_` is the slot the next message lands in and `size_`
+  // the number of valid entries.
+  std::vector<std::string> messages_ ABSL_GUARDED_BY(mutex_);
+  int64_t next_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t size_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t dropped_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
 // Common structure capturing events that can be produced by any XLS interpreter
 // (DSLX, IR, JIT, etc.)
 struct InterpreterEvents {
   std::vector<std::string> trace_msgs;
   std::vector<std::string> assert_msgs;
 
+  // If non-null, trace messages are diverted to this bounded sink (not owned)
+  // instead of accumulating in trace_msgs. Not part of the value semantics of
+  // the events.
+  TraceRingBuffer* trace_sink = nullptr;
+
+  // Records a trace message in trace_msgs, or in the bounded sink when one is
+  // attached. All evaluators (interpreters and JIT callbacks) route trace
+  // output through here.
+  void RecordTrace(std::string msg) {
+    if (trace_sink != nullptr) {
+      trace_sink->Record(msg).IgnoreError();
+      return;
+    }
+    trace_msgs.push_back(std::move(msg));
+  }
+
   bool operator==(const InterpreterEvents& other) const {
     return trace_msgs == other.trace_msgs && assert_msgs == other.assert_msgs;
   }
@@ -0,0 +1,86 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/events.h"
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+
+namespace xls {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(EventsTest, RingBufferRetainsMostRecentMessages) {
+  TraceRingBuffer buffer(/*capacity=*/3);
+  XLS_ASSERT_OK(buffer.Record("a"));
+  XLS_ASSERT_OK(buffer.Record("b"));
+  EXPECT_THAT(buffer.GetMessages(), ElementsAre("a", "b"));
+  EXPECT_EQ(buffer.dropped_count(), 0);
+
+  XLS_ASSERT_OK(buffer.Record("c"));
+  XLS_ASSERT_OK(buffer.Record("d"));
+  XLS_ASSERT_OK(buffer.Record("e"));
+  EXPECT_THAT(buffer.GetMessages(), ElementsAre("c", "d", "e"));
+  EXPECT_EQ(buffer.dropped_count(), 2);
+}
+
+TEST(EventsTest, RingBufferStreamsLengthPrefixedRecords) {
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  TraceRingBuffer buffer(/*capacity=*/1, /*stream_fd=*/fds[1]);
+  XLS_ASSERT_OK(buffer.Record("hello"));
+  XLS_ASSERT_OK(buffer.Record("hi"));
+  close(fds[1]);
+
+  // Even though the buffer only retains one message, both were streamed.
+  std::string streamed;
+  char chunk[64];
+  ssize_t n;
+  while ((n = read(fds[0], chunk, sizeof(chunk))) > 0) {
+    streamed.append(chunk, n);
+  }
+  close(fds[0]);
+
+  std::string expected;
+  auto append_record = [&expected](absl::string_view msg) {
+    uint32_t length = msg.size();
+    expected.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    expected.append(msg.data(), msg.size());
+  };
+  append_record("hello");
+  append_record("hi");
+  EXPECT_EQ(streamed, expected);
+  EXPECT_THAT(buffer.GetMessages(), ElementsAre("hi"));
+}
+
+TEST(EventsTest, InterpreterEventsDivertToAttachedSink) {
+  TraceRingBuffer buffer(/*capacity=*/2);
+  InterpreterEvents events;
+  events.RecordTrace("unbounded");
+  events.trace_sink = &buffer;
+  events.RecordTrace("bounded");
+
+  EXPECT_THAT(events.trace_msgs, ElementsAre("unbounded"));
+  EXPECT_THAT(buffer.GetMessages(), ElementsAre("bounded"));
+}
+
+}  // namespace
+}  // namespace xls
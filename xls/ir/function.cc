@@ -14,6 +14,9 @@
 
 #include "xls/ir/function.h"
 
+#include <ostream>
+#include <sstream>
+
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
@@ -36,36 +39,40 @@ FunctionType* Function::GetType() {
 }
 
 std::string Function::DumpIr() const {
-  std::string res = "fn " + name() + "(";
+  std::ostringstream os;
+  DumpIrTo(os);
+  return os.str();
+}
+
+void Function::DumpIrTo(std::ostream& os) const {
+  os << "fn " << name() << "(";
   std::vector<std::string> param_strings;
   for (Param* param : params_) {
     param_strings.push_back(
         absl::StrFormat("%s: %s", param->name(), param->GetType()->ToString()));
   }
-  absl::StrAppend(&res, absl::StrJoin(param_strings, ", "));
-  absl::StrAppend(&res, ") -> ");
+  os << absl::StrJoin(param_strings, ", ") << ") -> ";
 
   if (return_value() != nullptr) {
-    absl::StrAppend(&res, return_value()->GetType()->ToString());
+    os << return_value()->GetType()->ToString();
   }
-  absl::StrAppend(&res, " {\n");
+  os << " {\n";
 
   for (Node* node : TopoSort(const_cast<Function*>(this))) {
     if (node->op() == Op::kParam && node == return_value()) {
-      absl::StrAppendFormat(&res, "  ret %s: %s = param(name=%s)\n",
-                            node->GetName(), node->GetType()->ToString(),
+      os << absl::StrFormat("  ret %s: %s = param(name=%s)\n", node->GetName(),
+                            node->GetType()->ToString(),
                             node->As<Param>()->name());
       continue;
     }
     if (node->op() == Op::kParam) {
       continue;  // Already accounted for in the signature.
     }
-    absl::StrAppend(&res, "  ", node == return_value() ? "ret " : "",
-                    node->ToString(), "\n");
+    os << "  " << (node == return_value() ? "ret " : "") << node->ToString()
+       << "\n";
   }
 
-  absl::StrAppend(&res, "}\n");
-  return res;
+  os << "}\n";
 }
 
 absl::StatusOr<Function*> Function::Clone(
@@ -78,6 +85,8 @@ absl::StatusOr<Function*> Function::Clone(
   }
   Function* cloned_function = target_package->AddFunction(
       std::make_unique<Function>(new_name, target_package));
+  cloned_function->ReserveNodes(node_count());
+  original_to_clone.reserve(node_count());
   for (Node* node : TopoSort(const_cast<Function*>(this))) {
     std::vector<Node*> cloned_operands;
     for (Node* operand : node->operands()) {
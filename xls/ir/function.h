@@ -53,6 +53,7 @@ class Function : public FunctionBase {
     XLS_RET_CHECK_EQ(n->function_base(), this) << absl::StreamFormat(
         "Return value node %s is not in this function %s (is in function %s)",
         n->GetName(), name(), n->function_base()->name());
+    RecordImplicitUseChanged(/*slot=*/0, return_value_);
     return_value_ = n;
     return absl::OkStatus();
   }
@@ -64,6 +65,7 @@ class Function : public FunctionBase {
   //   'recursive' if true, will dump counted-for body functions as well.
   //   This is only useful when dumping individual functions, and not packages.
   std::string DumpIr() const override;
+  void DumpIrTo(std::ostream& os) const override;
 
   // Creates a clone of the function with the new name 'new_name'. Function is
   // owned by targt_package.  call_remapping specifies any function
@@ -84,6 +86,12 @@ class Function : public FunctionBase {
     return node == return_value();
   }
 
+ protected:
+  absl::Status RestoreImplicitUse(int64_t slot, Node* old_value) override {
+    XLS_RET_CHECK_EQ(slot, 0);
+    return set_return_value(old_value);
+  }
+
  private:
   Node* return_value_ = nullptr;
 };
@@ -14,7 +14,10 @@
 
 #include "xls/ir/function_base.h"
 
+#include <vector>
+
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "xls/common/logging/logging.h"
@@ -28,6 +31,37 @@
 #include "xls/ir/proc.h"
 
 namespace xls {
+namespace {
+
+// Registered FunctionBase destruction observers. Guarded by a mutex as
+// packages may be constructed and destroyed on several threads. Leaked so
+// observers registered from other process-lifetime singletons never race
+// static destruction.
+absl::Mutex& DestructionObserverMutex() {
+  static absl::Mutex* mutex = new absl::Mutex;
+  return *mutex;
+}
+
+std::vector<void (*)(FunctionBase*)>& DestructionObservers() {
+  static std::vector<void (*)(FunctionBase*)>* observers =
+      new std::vector<void (*)(FunctionBase*)>;
+  return *observers;
+}
+
+}  // namespace
+
+FunctionBase::~FunctionBase() {
+  absl::MutexLock lock(&DestructionObserverMutex());
+  for (void (*observer)(FunctionBase*) : DestructionObservers()) {
+    observer(this);
+  }
+}
+
+/* static */ void FunctionBase::RegisterDestructionObserver(
+    void (*observer)(FunctionBase*)) {
+  absl::MutexLock lock(&DestructionObserverMutex());
+  DestructionObservers().push_back(observer);
+}
 
 absl::StatusOr<Param*> FunctionBase::GetParamByName(
     absl::string_view param_name) const {
@@ -67,8 +101,12 @@ absl::StatusOr<Node*> FunctionBase::GetNode(
 }
 
 absl::Status FunctionBase::RemoveNode(Node* node) {
+  XLS_RET_CHECK(!recording_changes_)
+      << "Cannot remove nodes while changes are being recorded; leave the "
+         "node dead and remove it after committing or rolling back";
   XLS_RET_CHECK(node->users().empty());
   XLS_RET_CHECK(!HasImplicitUse(node));
+  InvalidateTopoOrderCache();
   std::vector<Node*> unique_operands;
   for (Node* operand : node->operands()) {
     if (!absl::c_linear_search(unique_operands, operand)) {
@@ -82,10 +120,92 @@ absl::Status FunctionBase::RemoveNode(Node* node) {
     params_.erase(std::remove(params_.begin(), params_.end(), node),
                   params_.end());
   }
-  auto node_it = node_iterators_.find(node);
-  XLS_RET_CHECK(node_it != node_iterators_.end());
-  nodes_.erase(node_it->second);
-  node_iterators_.erase(node_it);
+  XLS_RET_CHECK(node->function_base() == this);
+  nodes_.erase(node->function_list_entry_);
+  return absl::OkStatus();
+}
+
+absl::Status FunctionBase::ReplaceUsesWith(
+    const absl::flat_hash_map<Node*, Node*>& replacements) {
+  if (replacements.empty()) {
+    return absl::OkStatus();
+  }
+
+  // Resolve chains of replacements (a->b, b->c) so each operand edge is
+  // rewritten at most once.
+  auto resolve = [&replacements](Node* node) -> absl::StatusOr<Node*> {
+    Node* result = node;
+    int64_t steps = 0;
+    auto it = replacements.find(result);
+    while (it != replacements.end()) {
+      result = it->second;
+      XLS_RET_CHECK_LE(++steps, static_cast<int64_t>(replacements.size()))
+          << "Cycle in replacement map involving " << node->GetName();
+      it = replacements.find(result);
+    }
+    return result;
+  };
+
+  absl::flat_hash_map<Node*, Node*> resolved;
+  resolved.reserve(replacements.size());
+  for (const auto& [node, replacement] : replacements) {
+    XLS_RET_CHECK(node != nullptr);
+    XLS_RET_CHECK(replacement != nullptr);
+    XLS_RET_CHECK(node->function_base() == this)
+        << node->GetName() << " is not in function " << name();
+    XLS_ASSIGN_OR_RETURN(Node * target, resolve(node));
+    XLS_RET_CHECK(node->GetType() == target->GetType())
+        << "type was: " << node->GetType()->ToString()
+        << " replacement: " << target->GetType()->ToString();
+    resolved[node] = target;
+  }
+
+  InvalidateTopoOrderCache();
+
+  // Rewrite all operand slots in one pass over the graph, updating user lists
+  // incrementally as Node::ReplaceOperand does.
+  for (Node* user : nodes()) {
+    std::vector<Node*> replaced_operands;
+    for (int64_t i = 0; i < user->operand_count(); ++i) {
+      Node* old_operand = user->operands_[i];
+      auto it = resolved.find(old_operand);
+      if (it == resolved.end()) {
+        continue;
+      }
+      Node* new_operand = it->second;
+      // Do not introduce a self-edge when the replacement is the user itself
+      // (see the commentary in Node::ReplaceOperand).
+      if (new_operand == user) {
+        continue;
+      }
+      RecordOperandChanged(user, i, old_operand);
+      user->operands_[i] = new_operand;
+      user->InvalidateFingerprint();
+      new_operand->AddUser(user);
+      if (!absl::c_linear_search(replaced_operands, old_operand)) {
+        replaced_operands.push_back(old_operand);
+      }
+    }
+    for (Node* old_operand : replaced_operands) {
+      if (!absl::c_linear_search(user->operands(), old_operand)) {
+        old_operand->RemoveUser(user);
+      }
+    }
+  }
+
+  for (const auto& [node, target] : resolved) {
+    // Handle replacement of nodes with special positions within the function
+    // (function return value, proc next state, etc).
+    XLS_RETURN_IF_ERROR(node->ReplaceImplicitUsesWith(target).status());
+
+    // As with Node::ReplaceUsesWith, move an assigned name over to an unnamed
+    // replacement to preserve the name.
+    if (!node->Is<Param>() && node->HasAssignedName() &&
+        !target->HasAssignedName()) {
+      target->name_ = node->name_;
+      node->ClearName();
+    }
+  }
   return absl::OkStatus();
 }
 
@@ -126,14 +246,71 @@ Block* FunctionBase::AsBlockOrDie() {
 }
 
 Node* FunctionBase::AddNodeInternal(std::unique_ptr<Node> node) {
+  InvalidateTopoOrderCache();
   if (node->Is<Param>()) {
     params_.push_back(node->As<Param>());
   }
   Node* ptr = node.get();
-  node_iterators_[ptr] = nodes_.insert(nodes_.end(), std::move(node));
+  ptr->function_list_entry_ = nodes_.insert(nodes_.end(), std::move(node));
+  RecordNodeAdded(ptr);
   return ptr;
 }
 
+void FunctionBase::StartRecordingChanges() {
+  XLS_CHECK(!recording_changes_)
+      << "Change recording already in progress in " << name();
+  recording_changes_ = true;
+  change_journal_.clear();
+}
+
+void FunctionBase::CommitRecordedChanges() {
+  XLS_CHECK(recording_changes_) << "No change recording in progress";
+  recording_changes_ = false;
+  change_journal_.clear();
+}
+
+absl::Status FunctionBase::RollbackRecordedChanges() {
+  XLS_RET_CHECK(recording_changes_) << "No change recording in progress";
+  // Disable recording before undoing anything so that the undo operations
+  // themselves are not journaled.
+  recording_changes_ = false;
+  std::vector<ChangeRecord> journal = std::move(change_journal_);
+  change_journal_.clear();
+  InvalidateTopoOrderCache();
+  for (auto it = journal.rbegin(); it != journal.rend(); ++it) {
+    switch (it->kind) {
+      case ChangeRecord::Kind::kNodeAdded:
+        // Edges to the node were recorded after its addition and have
+        // already been undone, so the node is dead by now.
+        XLS_RETURN_IF_ERROR(RemoveNode(it->node));
+        break;
+      case ChangeRecord::Kind::kOperandChanged: {
+        Node* user = it->node;
+        Node* current = user->operands_[it->slot];
+        user->operands_[it->slot] = it->old_value;
+        user->InvalidateFingerprint();
+        if (it->old_value != nullptr) {
+          it->old_value->AddUser(user);
+        }
+        if (current != nullptr &&
+            !absl::c_linear_search(user->operands(), current)) {
+          current->RemoveUser(user);
+        }
+        break;
+      }
+      case ChangeRecord::Kind::kImplicitUseChanged:
+        XLS_RETURN_IF_ERROR(RestoreImplicitUse(it->slot, it->old_value));
+        break;
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status FunctionBase::RestoreImplicitUse(int64_t slot, Node* old_value) {
+  return absl::InternalError(
+      absl::StrFormat("Function base %s has no implicit uses", name()));
+}
+
 /*static*/ std::vector<std::string> FunctionBase::GetIrReservedWords() {
   std::vector<std::string> words(Token::GetKeywords().begin(),
                                  Token::GetKeywords().end());
@@ -143,7 +320,7 @@ Node* FunctionBase::AddNodeInternal(std::unique_ptr<Node> node) {
 }
 
 std::ostream& operator<<(std::ostream& os, const FunctionBase& function) {
-  os << function.DumpIr();
+  function.DumpIrTo(os);
   return os;
 }
 
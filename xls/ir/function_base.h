@@ -15,6 +15,7 @@
 #ifndef XLS_IR_FUNCTION_BASE_H_
 #define XLS_IR_FUNCTION_BASE_H_
 
+#include <iosfwd>
 #include <memory>
 #include <string>
 #include <vector>
@@ -27,6 +28,7 @@
 #include "xls/ir/dfs_visitor.h"
 #include "xls/ir/name_uniquer.h"
 #include "xls/ir/node.h"
+#include "xls/ir/node_arena.h"
 #include "xls/ir/nodes.h"
 #include "xls/ir/package.h"
 #include "xls/ir/type.h"
@@ -48,7 +50,14 @@ class FunctionBase {
       : name_(name),
         qualified_name_(absl::StrCat(package->name(), "::", name_)),
         package_(package) {}
-  virtual ~FunctionBase() = default;
+  virtual ~FunctionBase();
+
+  // Registers a process-wide callback invoked with each FunctionBase as it is
+  // destroyed. Process-lifetime caches keyed by FunctionBase* use this to
+  // evict their entries before the heap address can be reused by a new
+  // function. Observers are never unregistered and must be safe to call from
+  // any thread that destroys a Package.
+  static void RegisterDestructionObserver(void (*observer)(FunctionBase*));
 
   Package* package() const { return package_; }
   const std::string& name() const { return name_; }
@@ -57,6 +66,11 @@ class FunctionBase {
   // DumpIr emits the IR in a parsable, hierarchical text format.
   virtual std::string DumpIr() const = 0;
 
+  // As DumpIr but writes the text to the given stream line by line rather
+  // than materializing the whole dump in one string. Prefer this form when
+  // emitting large functions to a file or stdout.
+  virtual void DumpIrTo(std::ostream& os) const = 0;
+
   // Return Span of parameters.
   absl::Span<Param* const> params() const { return params_; }
 
@@ -70,6 +84,15 @@ class FunctionBase {
 
   int64_t node_count() const { return nodes_.size(); }
 
+  // Hint that approximately 'additional' nodes are about to be added (e.g.,
+  // bulk unrolling of a map or loop, or parsing a large function body). Grows
+  // the name-registration tables once up front rather than through repeated
+  // rehashing. The node list itself is intrusively linked and needs no
+  // reservation.
+  void ReserveNodes(int64_t additional) {
+    node_name_uniquer_.Reserve(nodes_.size() + additional);
+  }
+
   // Expose Nodes, so that transformation passes can operate
   // on this function.
   xabsl::iterator_range<UnwrappingIterator<NodeList::iterator>> nodes() {
@@ -97,6 +120,7 @@ class FunctionBase {
   // to the newly constructed node.
   template <typename NodeT, typename... Args>
   absl::StatusOr<NodeT*> MakeNode(Args&&... args) {
+    NodeArena::Scope arena_scope(&node_arena_);
     NodeT* new_node = AddNode(std::make_unique<NodeT>(
         std::forward<Args>(args)..., /*name=*/"", this));
     XLS_RETURN_IF_ERROR(VerifyNode(new_node));
@@ -105,12 +129,41 @@ class FunctionBase {
 
   template <typename NodeT, typename... Args>
   absl::StatusOr<NodeT*> MakeNodeWithName(Args&&... args) {
+    NodeArena::Scope arena_scope(&node_arena_);
     NodeT* new_node =
         AddNode(std::make_unique<NodeT>(std::forward<Args>(args)..., this));
     XLS_RETURN_IF_ERROR(VerifyNode(new_node));
     return new_node;
   }
 
+  // Returns the arena from which this function's nodes are allocated.
+  NodeArena& node_arena() { return node_arena_; }
+
+  // The topological order computed by TopoSort (node_iterator.h) is cached
+  // here and reused until the graph is restructured. Holders of the returned
+  // vector must not mutate it; it may be shared by concurrent traversals.
+  const std::shared_ptr<std::vector<Node*>>& topo_order_cache() const {
+    return topo_order_cache_;
+  }
+  void SetTopoOrderCache(std::shared_ptr<std::vector<Node*>> order) {
+    topo_order_cache_ = std::move(order);
+  }
+
+  // Drops the cached topological order. Called whenever nodes are added or
+  // removed or operand edges change.
+  void InvalidateTopoOrderCache() {
+    topo_order_cache_.reset();
+    ++transform_count_;
+  }
+
+  // A counter which increases monotonically every time the graph is
+  // restructured (nodes added or removed, operand edges changed, implicit
+  // uses such as a function's return value reassigned). Consumers such as
+  // the incremental mode of the IR verifier use this to detect whether a
+  // function has changed since they last examined it. Metadata-only
+  // mutations (e.g. renames) do not bump the counter.
+  int64_t transform_count() const { return transform_count_; }
+
   // Find a node by it's name, as generated by DumpIr.
   absl::StatusOr<Node*> GetNode(absl::string_view standard_node_name);
 
@@ -119,6 +172,88 @@ class FunctionBase {
   // function type signature.
   virtual absl::Status RemoveNode(Node* n);
 
+  // Replaces all uses of each key node in `replacements` with the
+  // corresponding value node, with the same per-node semantics as
+  // Node::ReplaceUsesWith (type check, implicit uses, name preservation), but
+  // applied in a single pass over the graph so each operand edge and user
+  // list is touched at most once. Chains of replacements (a->b, b->c) are
+  // resolved before rewriting; a cycle in the map is an error. Prefer this to
+  // repeated Node::ReplaceUsesWith calls when performing mass rewrites.
+  absl::Status ReplaceUsesWith(
+      const absl::flat_hash_map<Node*, Node*>& replacements);
+
+  // Speculative change recording. A pass which wants to try a transform and
+  // keep the result only if it helps can record its structural mutations and
+  // roll them back; the cost is proportional to the number of changes made
+  // rather than the number of nodes in the function (unlike cloning the
+  // function up front).
+  //
+  // While recording, node additions, operand rewrites and implicit-use
+  // updates (function return value, proc next token/state) are journaled.
+  // Node removal is disallowed inside a recorded region -- leave nodes dead
+  // and let DCE collect them after committing, as passes already do.
+  // Metadata-only mutations such as renames are not journaled and are not
+  // undone by a rollback.
+
+  // One journaled mutation; see recorded_changes().
+  struct ChangeRecord {
+    enum class Kind {
+      kNodeAdded,           // `node` was added to the function.
+      kOperandChanged,      // `node`s operand `slot` held `old_value`.
+      kImplicitUseChanged,  // implicit use `slot` held `old_value`.
+    };
+    Kind kind;
+    Node* node;
+    int64_t slot;
+    Node* old_value;
+  };
+
+  // Starts journaling changes. Recording must not already be in progress.
+  void StartRecordingChanges();
+
+  // Keeps all changes made since StartRecordingChanges() and discards the
+  // journal.
+  void CommitRecordedChanges();
+
+  // Undoes, in reverse order, all changes made since StartRecordingChanges().
+  absl::Status RollbackRecordedChanges();
+
+  bool IsRecordingChanges() const { return recording_changes_; }
+
+  // The journal of changes recorded since StartRecordingChanges() in the
+  // order they were made. Useful for inspecting what a speculative transform
+  // actually did before deciding whether to commit it.
+  absl::Span<const ChangeRecord> recorded_changes() const {
+    return change_journal_;
+  }
+
+  // Journaling hooks called from the mutation sites in Node and the
+  // FunctionBase subclasses. No-ops unless recording is in progress.
+  void RecordNodeAdded(Node* node) {
+    if (recording_changes_) {
+      change_journal_.push_back(
+          ChangeRecord{ChangeRecord::Kind::kNodeAdded, node, 0, nullptr});
+    }
+  }
+  void RecordOperandChanged(Node* node, int64_t operand_no,
+                            Node* old_operand) {
+    if (recording_changes_) {
+      change_journal_.push_back(ChangeRecord{
+          ChangeRecord::Kind::kOperandChanged, node, operand_no, old_operand});
+    }
+  }
+  void RecordImplicitUseChanged(int64_t slot, Node* old_value) {
+    // Reassigning an implicit use changes the function's observable dataflow
+    // even though no operand edge moves (e.g. the old root may become dead);
+    // consumers polling transform_count() must see it. The topological order
+    // is unaffected, so the cache need not be dropped.
+    ++transform_count_;
+    if (recording_changes_) {
+      change_journal_.push_back(ChangeRecord{
+          ChangeRecord::Kind::kImplicitUseChanged, nullptr, slot, old_value});
+    }
+  }
+
   // Visit all nodes (including nodes not reachable from the root) in the
   // function using the given visitor.
   absl::Status Accept(DfsVisitor* visitor);
@@ -152,6 +287,11 @@ class FunctionBase {
   // added node.
   virtual Node* AddNodeInternal(std::unique_ptr<Node> node);
 
+  // Restores an implicit use journaled by RecordImplicitUseChanged during a
+  // rollback. `slot` is subclass-defined (function return value: 0; proc:
+  // 0 = next token, 1 = next state).
+  virtual absl::Status RestoreImplicitUse(int64_t slot, Node* old_value);
+
   // Returns a vector containing the reserved words in the IR.
   static std::vector<std::string> GetIrReservedWords();
 
@@ -159,16 +299,35 @@ class FunctionBase {
   std::string qualified_name_;
   Package* package_;
 
+  // Arena backing the storage of this function's nodes. Declared before
+  // nodes_ so the slabs outlive the node destructors which run when nodes_ is
+  // torn down; the slabs themselves are released in bulk when the function is
+  // destroyed.
+  NodeArena node_arena_;
+
   // Store Nodes in std::list as they can be added and removed arbitrarily and
-  // we want a stable iteration order. Keep a map from instruction pointer to
-  // location in the list for fast lookup.
+  // we want a stable iteration order. Each node records its own position in
+  // the list (Node::function_list_entry_) so membership is intrusive: no side
+  // map is consulted or rehashed on the construction path and removal is
+  // O(1).
   NodeList nodes_;
-  absl::flat_hash_map<const Node*, NodeList::iterator> node_iterators_;
 
   std::vector<Param*> params_;
 
   NameUniquer node_name_uniquer_ =
       NameUniquer(/*separator=*/"__", GetIrReservedWords());
+
+  // Cached topological order of the function's nodes, or nullptr if the graph
+  // has changed since the last TopoSort.
+  std::shared_ptr<std::vector<Node*>> topo_order_cache_;
+
+  // See transform_count().
+  int64_t transform_count_ = 0;
+
+  // Whether structural mutations are currently journaled, and the journal
+  // itself. See StartRecordingChanges().
+  bool recording_changes_ = false;
+  std::vector<ChangeRecord> change_journal_;
 };
 
 std::ostream& operator<<(std::ostream& os, const FunctionBase& function);
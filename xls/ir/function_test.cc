@@ -330,5 +330,65 @@ TEST_F(FunctionTest, IrReservedWordIdentifiers) {
   XLS_ASSERT_OK(ParsePackage(ir_text).status());
 }
 
+TEST_F(FunctionTest, RollbackRecordedChanges) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * func, ParseFunction(R"(
+fn foo(x: bits[32], y: bits[32]) -> bits[32] {
+ret add.3: bits[32] = add(x, y)
+}
+)",
+                                                          p.get()));
+  Node* add = func->return_value();
+  const int64_t node_count = func->node_count();
+  const std::string original_ir = func->DumpIr();
+
+  // Speculatively rewrite the return value to x + (x - y) and roll it back.
+  func->StartRecordingChanges();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Node * sub, func->MakeNode<BinOp>(absl::nullopt, func->param(0),
+                                        func->param(1), Op::kSub));
+  XLS_ASSERT_OK(add->ReplaceOperandNumber(1, sub));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Node * neg, func->MakeNode<UnOp>(absl::nullopt, add, Op::kNeg));
+  XLS_ASSERT_OK(add->ReplaceUsesWith(neg));
+  EXPECT_EQ(func->return_value(), neg);
+  // Journal: sub added, add operand 1 changed, neg added, return value
+  // changed (neg's use of add is skipped as a would-be self-edge).
+  EXPECT_EQ(func->recorded_changes().size(), 4);
+
+  XLS_ASSERT_OK(func->RollbackRecordedChanges());
+  EXPECT_FALSE(func->IsRecordingChanges());
+  EXPECT_EQ(func->node_count(), node_count);
+  EXPECT_EQ(func->return_value(), add);
+  EXPECT_EQ(add->operand(1), func->param(1));
+  EXPECT_EQ(func->DumpIr(), original_ir);
+  XLS_ASSERT_OK(VerifyFunction(func));
+}
+
+TEST_F(FunctionTest, CommitRecordedChanges) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * func, ParseFunction(R"(
+fn foo(x: bits[32], y: bits[32]) -> bits[32] {
+ret add.3: bits[32] = add(x, y)
+}
+)",
+                                                          p.get()));
+  Node* add = func->return_value();
+
+  func->StartRecordingChanges();
+  // Removal is deferred until after commit/rollback.
+  EXPECT_THAT(func->RemoveNode(add),
+              StatusIs(absl::StatusCode::kInternal,
+                       HasSubstr("while changes are being recorded")));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Node * neg, func->MakeNode<UnOp>(absl::nullopt, add, Op::kNeg));
+  XLS_ASSERT_OK(add->ReplaceUsesWith(neg));
+  func->CommitRecordedChanges();
+
+  EXPECT_EQ(func->return_value(), neg);
+  EXPECT_TRUE(func->recorded_changes().empty());
+  XLS_ASSERT_OK(VerifyFunction(func));
+}
+
 }  // namespace
 }  // namespace xls
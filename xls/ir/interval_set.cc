@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <list>
 #include <random>
 #include <string>
@@ -33,6 +34,110 @@
 #include "xls/ir/interval.h"
 
 namespace xls {
+namespace {
+
+// A dense representation of an interval over a bit count of at most 64: the
+// bounds as plain uint64s. Normalization and intersection of sets of these
+// run as branch-light merge loops over contiguous storage with no Bits heap
+// allocation, which matters because the overwhelming majority of interval
+// sets arising in range analysis are over sub-64-bit values and contain many
+// small intervals.
+struct DenseInterval {
+  uint64_t lo;
+  uint64_t hi;
+
+  bool operator<(const DenseInterval& other) const {
+    return lo != other.lo ? lo < other.lo : hi < other.hi;
+  }
+};
+
+uint64_t DenseValue(const Bits& bits) { return bits.ToUint64().value(); }
+
+// Normalizes (in the sense of IntervalSet::Normalize) a set of possibly
+// improper, possibly overlapping dense intervals in place. `max_value` is
+// the all-ones value of the bit count.
+void NormalizeDense(std::vector<DenseInterval>* intervals,
+                    uint64_t max_value) {
+  int64_t proper_count = intervals->size();
+  for (int64_t i = 0; i < proper_count; ++i) {
+    if ((*intervals)[i].lo > (*intervals)[i].hi) {
+      // An improper interval wraps around; split it. push_back may
+      // reallocate, so re-index rather than holding a reference across it.
+      intervals->push_back(DenseInterval{(*intervals)[i].lo, max_value});
+      (*intervals)[i].lo = 0;
+    }
+  }
+  std::sort(intervals->begin(), intervals->end());
+  int64_t merged = 0;
+  for (int64_t i = 1; i < static_cast<int64_t>(intervals->size()); ++i) {
+    DenseInterval& current = (*intervals)[merged];
+    const DenseInterval& next = (*intervals)[i];
+    // Merge overlapping or abutting intervals. When current.hi is the
+    // maximal uint64, current.hi + 1 wraps to zero but next.lo <= current.hi
+    // already holds, so the wrap is harmless.
+    if (next.lo <= current.hi || next.lo == current.hi + 1) {
+      current.hi = std::max(current.hi, next.hi);
+    } else {
+      (*intervals)[++merged] = next;
+    }
+  }
+  if (!intervals->empty()) {
+    intervals->resize(merged + 1);
+  }
+}
+
+// Intersects two normalized (sorted, disjoint, proper) sets of dense
+// intervals with a linear two-pointer sweep.
+std::vector<DenseInterval> IntersectDense(
+    absl::Span<const DenseInterval> lhs, absl::Span<const DenseInterval> rhs) {
+  std::vector<DenseInterval> result;
+  int64_t i = 0;
+  int64_t j = 0;
+  while (i < static_cast<int64_t>(lhs.size()) &&
+         j < static_cast<int64_t>(rhs.size())) {
+    uint64_t lo = std::max(lhs[i].lo, rhs[j].lo);
+    uint64_t hi = std::min(lhs[i].hi, rhs[j].hi);
+    if (lo <= hi) {
+      result.push_back(DenseInterval{lo, hi});
+    }
+    // Retire whichever interval ends first; the other may still intersect
+    // the next interval on the retired side.
+    if (lhs[i].hi < rhs[j].hi) {
+      ++i;
+    } else {
+      ++j;
+    }
+  }
+  return result;
+}
+
+std::vector<DenseInterval> ToDense(absl::Span<const Interval> intervals) {
+  std::vector<DenseInterval> dense;
+  dense.reserve(intervals.size());
+  for (const Interval& interval : intervals) {
+    dense.push_back(DenseInterval{DenseValue(interval.LowerBound()),
+                                  DenseValue(interval.UpperBound())});
+  }
+  return dense;
+}
+
+std::vector<Interval> FromDense(absl::Span<const DenseInterval> dense,
+                                int64_t bit_count) {
+  std::vector<Interval> intervals;
+  intervals.reserve(dense.size());
+  for (const DenseInterval& interval : dense) {
+    intervals.push_back(
+        Interval(UBits(interval.lo, bit_count), UBits(interval.hi, bit_count)));
+  }
+  return intervals;
+}
+
+uint64_t DenseMaxValue(int64_t bit_count) {
+  return bit_count == 64 ? std::numeric_limits<uint64_t>::max()
+                         : (uint64_t{1} << bit_count) - 1;
+}
+
+}  // namespace
 
 IntervalSet IntervalSet::Maximal(int64_t bit_count) {
   IntervalSet result(bit_count);
@@ -63,6 +168,14 @@ void IntervalSet::SetIntervals(absl::Span<const Interval> intervals) {
 }
 
 void IntervalSet::Normalize() {
+  if (BitCount() <= 64) {
+    std::vector<DenseInterval> dense = ToDense(intervals_);
+    NormalizeDense(&dense, DenseMaxValue(BitCount()));
+    intervals_ = FromDense(dense, BitCount());
+    is_normalized_ = true;
+    return;
+  }
+
   Bits zero(BitCount());
   Bits max = Bits::AllOnes(BitCount());
   std::vector<Interval> expand_improper;
@@ -149,6 +262,16 @@ IntervalSet IntervalSet::Intersect(const IntervalSet& lhs,
   XLS_CHECK_EQ(lhs.BitCount(), rhs.BitCount());
   XLS_CHECK(lhs.is_normalized_);
   XLS_CHECK(rhs.is_normalized_);
+  if (lhs.BitCount() <= 64) {
+    // Normalized inputs are sorted, disjoint and proper, so the dense
+    // two-pointer sweep applies directly and its output is normalized.
+    IntervalSet result(lhs.BitCount());
+    result.intervals_ = FromDense(
+        IntersectDense(ToDense(lhs.intervals_), ToDense(rhs.intervals_)),
+        lhs.BitCount());
+    result.is_normalized_ = true;
+    return result;
+  }
   IntervalSet result(lhs.BitCount());
   std::list<Interval> lhs_intervals(lhs.Intervals().begin(),
                                     lhs.Intervals().end());
@@ -35,6 +35,12 @@
 namespace xls {
 
 // This type represents a set of intervals.
+//
+// Sets over a bit count of at most 64 — the overwhelming majority in
+// practice — are normalized and intersected through a dense uint64-pair
+// representation in contiguous storage rather than through `Bits`
+// comparisons, so those operations do not allocate per interval. The
+// dispatch on width is internal; the interface is the same for all widths.
 class IntervalSet {
  public:
   // Create an empty `IntervalSet` with a `BitCount()` of -1. Every method in
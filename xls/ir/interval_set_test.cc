@@ -263,5 +263,52 @@ TEST(IntervalTest, ToString) {
             "[[10, 20], [15, 30], [31, 40], [70, 90], [80, 85], [50, 55]]");
 }
 
+TEST(IntervalTest, NormalizeAtWidth64Boundary) {
+  // Width 64 is the widest bit count handled by the dense representation;
+  // exercise the all-ones corner where the abutment check would wrap.
+  uint64_t max = std::numeric_limits<uint64_t>::max();
+
+  IntervalSet abutting_max(64);
+  abutting_max.AddInterval(MakeInterval(max - 10, max - 6, 64));
+  abutting_max.AddInterval(MakeInterval(max - 5, max, 64));
+  abutting_max.Normalize();
+  EXPECT_EQ(abutting_max.Intervals(),
+            (std::vector<Interval>{MakeInterval(max - 10, max, 64)}));
+
+  IntervalSet improper(64);
+  improper.AddInterval(MakeInterval(max - 5, 10, 64));
+  improper.Normalize();
+  EXPECT_EQ(improper.Intervals(),
+            (std::vector<Interval>{MakeInterval(0, 10, 64),
+                                   MakeInterval(max - 5, max, 64)}));
+}
+
+TEST(IntervalTest, WideWidthsMatchDenseSemantics) {
+  // Widths above 64 take the Bits-based path; the same interval structure
+  // must normalize and intersect identically in both representations.
+  for (int64_t width : {30, 100}) {
+    IntervalSet set(width);
+    set.AddInterval(MakeInterval(40, 20, width));  // improper
+    set.AddInterval(MakeInterval(21, 30, width));  // abuts the split piece
+    set.Normalize();
+    EXPECT_EQ(set.Intervals(),
+              (std::vector<Interval>{
+                  MakeInterval(0, 30, width),
+                  Interval(UBits(40, width), Bits::AllOnes(width))}))
+        << width;
+
+    IntervalSet lhs(width);
+    lhs.AddInterval(MakeInterval(100, 200, width));
+    lhs.AddInterval(MakeInterval(500, 600, width));
+    lhs.Normalize();
+    IntervalSet rhs(width);
+    rhs.AddInterval(MakeInterval(150, 550, width));
+    rhs.Normalize();
+    EXPECT_EQ(IntervalSet::Intersect(lhs, rhs).ToString(),
+              "[[150, 200], [500, 550]]")
+        << width;
+  }
+}
+
 }  // namespace
 }  // namespace xls
@@ -14,9 +14,14 @@
 
 #include "xls/ir/ir_parser.h"
 
+#include <cstring>
+
 #include "google/protobuf/text_format.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "xls/common/logging/logging.h"
@@ -1894,6 +1899,204 @@ absl::StatusOr<std::unique_ptr<Package>> Parser::ParsePackageWithEntry(
   return package;
 }
 
+// A top-level declaration located by the indexing scan in
+// Parser::ParsePackageForFunction: the declaration keyword, the declared
+// name, and the span of input text covering the whole declaration.
+struct TopLevelDeclaration {
+  absl::string_view keyword;
+  absl::string_view name;
+  absl::string_view text;
+};
+
+static bool IsIdentifierChar(char c) {
+  return absl::ascii_isalnum(c) || c == '_' || c == '.';
+}
+
+// Splits package text into its top-level declarations with a cheap character
+// scan -- no tokenization -- tracking line comments, quoted strings and
+// brace depth the same way the tokenizer's shard splitter does. Keywords are
+// only recognized at brace depth zero, so occurrences inside bodies, strings
+// and comments are ignored. Each declaration's text extends to the start of
+// the following declaration.
+static absl::StatusOr<std::vector<TopLevelDeclaration>>
+IndexTopLevelDeclarations(absl::string_view str) {
+  std::vector<TopLevelDeclaration> declarations;
+  const int64_t size = str.size();
+  int64_t depth = 0;
+  bool in_string = false;
+  bool in_triple_string = false;
+  int64_t pending_start = -1;
+  absl::string_view pending_keyword;
+  absl::string_view pending_name;
+  auto finish_pending = [&](int64_t end) {
+    if (pending_start >= 0) {
+      declarations.push_back(
+          TopLevelDeclaration{pending_keyword, pending_name,
+                              str.substr(pending_start, end - pending_start)});
+      pending_start = -1;
+    }
+  };
+  for (int64_t i = 0; i < size; ++i) {
+    const char c = str[i];
+    if (in_triple_string) {
+      if (c == '"' && i + 2 < size && str[i + 1] == '"' && str[i + 2] == '"') {
+        in_triple_string = false;
+        i += 2;
+      }
+      continue;
+    }
+    if (in_string) {
+      // An unterminated single-quoted string ends at the newline (as a
+      // tokenization error, reported later when the span is parsed).
+      if (c == '"' || c == '\n') {
+        in_string = false;
+      }
+      continue;
+    }
+    if (c == '"') {
+      if (i + 2 < size && str[i + 1] == '"' && str[i + 2] == '"') {
+        in_triple_string = true;
+        i += 2;
+      } else {
+        in_string = true;
+      }
+      continue;
+    }
+    if (c == '/' && i + 1 < size && str[i + 1] == '/') {
+      const char* newline =
+          static_cast<const char*>(memchr(str.data() + i, '\n', size - i));
+      if (newline == nullptr) {
+        break;
+      }
+      i = newline - str.data();
+      continue;
+    }
+    if (c == '{') {
+      ++depth;
+      continue;
+    }
+    if (c == '}') {
+      --depth;
+      continue;
+    }
+    if (depth == 0 && IsIdentifierChar(c) &&
+        (i == 0 || !IsIdentifierChar(str[i - 1]))) {
+      int64_t word_end = i;
+      while (word_end < size && IsIdentifierChar(str[word_end])) {
+        ++word_end;
+      }
+      absl::string_view word = str.substr(i, word_end - i);
+      if (word == "package" || word == "fn" || word == "proc" ||
+          word == "block" || word == "chan") {
+        finish_pending(i);
+        int64_t name_start = word_end;
+        while (name_start < size && absl::ascii_isspace(str[name_start])) {
+          ++name_start;
+        }
+        int64_t name_end = name_start;
+        while (name_end < size && IsIdentifierChar(str[name_end])) {
+          ++name_end;
+        }
+        if (name_end == name_start) {
+          return absl::InvalidArgumentError(
+              absl::StrFormat("Expected name after '%s' keyword", word));
+        }
+        pending_start = i;
+        pending_keyword = word;
+        pending_name = str.substr(name_start, name_end - name_start);
+        i = name_end - 1;
+        continue;
+      }
+      i = word_end - 1;
+    }
+  }
+  finish_pending(size);
+  return declarations;
+}
+
+// Returns the names referenced by the function-calling attributes (to_apply=
+// of invoke and map, body= of counted_for) in a declaration's text. May
+// contain false positives (e.g. matches inside format strings); callers
+// filter the result against the known function names.
+static std::vector<absl::string_view> FindCalleeReferences(
+    absl::string_view text) {
+  std::vector<absl::string_view> callees;
+  for (absl::string_view attribute :
+       {absl::string_view("to_apply="), absl::string_view("body=")}) {
+    absl::string_view::size_type pos = 0;
+    while ((pos = text.find(attribute, pos)) != absl::string_view::npos) {
+      bool at_boundary = pos == 0 || !IsIdentifierChar(text[pos - 1]);
+      pos += attribute.size();
+      if (!at_boundary) {
+        continue;
+      }
+      absl::string_view::size_type name_end = pos;
+      while (name_end < text.size() && IsIdentifierChar(text[name_end])) {
+        ++name_end;
+      }
+      if (name_end > pos) {
+        callees.push_back(text.substr(pos, name_end - pos));
+      }
+      pos = name_end;
+    }
+  }
+  return callees;
+}
+
+/* static */
+absl::StatusOr<std::unique_ptr<Package>> Parser::ParsePackageForFunction(
+    absl::string_view input_string, absl::string_view function_name,
+    absl::optional<absl::string_view> filename) {
+  XLS_ASSIGN_OR_RETURN(std::vector<TopLevelDeclaration> declarations,
+                       IndexTopLevelDeclarations(input_string));
+  if (declarations.empty() || declarations.front().keyword != "package") {
+    return absl::InvalidArgumentError(
+        "Expected 'package' keyword at start of input");
+  }
+  absl::flat_hash_map<absl::string_view, const TopLevelDeclaration*> functions;
+  for (const TopLevelDeclaration& declaration : declarations) {
+    if (declaration.keyword == "fn") {
+      functions[declaration.name] = &declaration;
+    }
+  }
+  if (!functions.contains(function_name)) {
+    return absl::NotFoundError(
+        absl::StrFormat("Package does not contain a function with name \"%s\"",
+                        function_name));
+  }
+
+  // Collect the requested function and its transitive callees.
+  absl::flat_hash_set<absl::string_view> needed = {function_name};
+  std::vector<absl::string_view> worklist = {function_name};
+  while (!worklist.empty()) {
+    const TopLevelDeclaration* declaration = functions.at(worklist.back());
+    worklist.pop_back();
+    for (absl::string_view callee : FindCalleeReferences(declaration->text)) {
+      if (functions.contains(callee) && needed.insert(callee).second) {
+        worklist.push_back(callee);
+      }
+    }
+  }
+
+  auto package =
+      std::make_unique<Package>(declarations.front().name, function_name);
+  std::string filename_str =
+      filename.has_value() ? std::string(*filename) : "<unknown file>";
+  // Callees precede their callers in valid package text, so parsing the
+  // needed declarations in file order resolves all callee references.
+  for (const TopLevelDeclaration& declaration : declarations) {
+    if (declaration.keyword != "fn" || !needed.contains(declaration.name)) {
+      continue;
+    }
+    XLS_ASSIGN_OR_RETURN(auto scanner, Scanner::Create(declaration.text));
+    Parser parser(std::move(scanner));
+    XLS_RETURN_IF_ERROR(parser.ParseFunction(package.get()).status())
+        << "@ " << filename_str;
+  }
+  XLS_RETURN_IF_ERROR(VerifyAndSwapError(package.get()));
+  return package;
+}
+
 /* static */
 absl::StatusOr<std::unique_ptr<Package>> Parser::ParsePackageNoVerify(
     absl::string_view input_string, absl::optional<absl::string_view> filename,
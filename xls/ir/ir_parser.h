@@ -59,6 +59,17 @@ class Parser {
       absl::string_view input_string, absl::string_view entry,
       absl::optional<absl::string_view> filename = absl::nullopt);
 
+  // As ParsePackage, but indexes the top-level declarations with a cheap
+  // character scan and fully parses only the function with the given name
+  // plus its transitive callees; all other declarations are skipped. The
+  // requested function becomes the entry function of the returned package.
+  // Intended for tools which operate on a single function of a large
+  // package. Returns a NotFoundError if the package has no function with
+  // the given name.
+  static absl::StatusOr<std::unique_ptr<Package>> ParsePackageForFunction(
+      absl::string_view input_string, absl::string_view function_name,
+      absl::optional<absl::string_view> filename = absl::nullopt);
+
   // Parse the input_string as a function into the given package.
   static absl::StatusOr<Function*> ParseFunction(absl::string_view input_string,
                                                  Package* package);
@@ -2642,4 +2642,60 @@ block my_block(x: bits[8], y: bits[32]) {
                                  "type of output_port operation: bits[32]")));
 }
 
+TEST(IrParserTest, ParsePackageForFunction) {
+  const std::string input = R"(package test
+
+fn helper(x: bits[32]) -> bits[32] {
+  ret not.1: bits[32] = not(x)
+}
+
+fn wanted(a: bits[32]) -> bits[32] {
+  ret invoke.2: bits[32] = invoke(a, to_apply=helper)
+}
+
+fn unwanted(b: bits[32]) -> bits[32] {
+  ret neg.3: bits[32] = neg(b)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> pkg,
+                           Parser::ParsePackageForFunction(input, "wanted"));
+  // Only the requested function and its transitive callees are materialized.
+  XLS_EXPECT_OK(pkg->GetFunction("wanted").status());
+  XLS_EXPECT_OK(pkg->GetFunction("helper").status());
+  EXPECT_THAT(pkg->GetFunction("unwanted").status(),
+              StatusIs(absl::StatusCode::kNotFound));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * entry, pkg->EntryFunction());
+  EXPECT_EQ(entry->name(), "wanted");
+}
+
+TEST(IrParserTest, ParsePackageForFunctionCountedForBody) {
+  const std::string input = R"(package test
+
+fn body(i: bits[4], accum: bits[32]) -> bits[32] {
+  zero_ext.1: bits[32] = zero_ext(i, new_bit_count=32)
+  ret add.2: bits[32] = add(zero_ext.1, accum)
+}
+
+fn loopy(init: bits[32]) -> bits[32] {
+  ret counted_for.3: bits[32] = counted_for(init, trip_count=4, stride=1, body=body)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> pkg,
+                           Parser::ParsePackageForFunction(input, "loopy"));
+  XLS_EXPECT_OK(pkg->GetFunction("loopy").status());
+  XLS_EXPECT_OK(pkg->GetFunction("body").status());
+}
+
+TEST(IrParserTest, ParsePackageForFunctionUnknownName) {
+  const std::string input = R"(package test
+
+fn f(x: bits[32]) -> bits[32] {
+  ret not.1: bits[32] = not(x)
+}
+)";
+  EXPECT_THAT(Parser::ParsePackageForFunction(input, "not_there").status(),
+              StatusIs(absl::StatusCode::kNotFound,
+                       HasSubstr("does not contain a function")));
+}
+
 }  // namespace xls
@@ -14,6 +14,10 @@
 
 #include "xls/ir/ir_scanner.h"
 
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
 
 #include "absl/status/statusor.h"
@@ -21,6 +25,7 @@
 #include "absl/strings/str_format.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/ir/number_parser.h"
 
 namespace xls {
@@ -114,37 +119,87 @@ std::string Token::ToString() const {
 
 namespace {
 
+// Character-class bitmasks used by the tokenizer's table-driven scanning
+// loops. Classifying via a single table load (rather than a chain of range
+// compares or a std::function call per character) is what keeps the hot
+// identifier/literal/whitespace loops tight; tokenization is the dominant
+// cost of parsing large IR files.
+constexpr uint8_t kWhitespaceClass = 1 << 0;  // [ \t\n\v\f\r]
+constexpr uint8_t kDigitClass = 1 << 1;       // [0-9]
+constexpr uint8_t kIdentStartClass = 1 << 2;  // [A-Za-z_]
+constexpr uint8_t kIdentContClass = 1 << 3;   // [A-Za-z0-9_.]
+constexpr uint8_t kLiteralContClass = 1 << 4;  // [A-Za-z0-9_]
+
+constexpr std::array<uint8_t, 256> BuildCharClassTable() {
+  std::array<uint8_t, 256> table{};
+  for (int c = 0; c < 256; ++c) {
+    if (c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+        c == '\r') {
+      table[c] |= kWhitespaceClass;
+    }
+    if (c >= '0' && c <= '9') {
+      table[c] |= kDigitClass | kIdentContClass | kLiteralContClass;
+    }
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_') {
+      table[c] |= kIdentStartClass | kIdentContClass | kLiteralContClass;
+    }
+    if (c == '.') {
+      table[c] |= kIdentContClass;
+    }
+  }
+  return table;
+}
+
+constexpr std::array<uint8_t, 256> kCharClassTable = BuildCharClassTable();
+
+// Returns whether `c` is in any of the classes in the bitmask `char_class`.
+inline bool InCharClass(char c, uint8_t char_class) {
+  return (kCharClassTable[static_cast<uint8_t>(c)] & char_class) != 0;
+}
+
 // Helper class for tokenizing a string.
 // TODO(meheff): This could be combined into Scanner class and made lazy at the
 // same time.
 class Tokenizer {
  public:
   // Tokenizes the given string and returns the vector of Tokens.
+  // `initial_lineno` is the line number of the first line of `str`; it is
+  // nonzero when a shard of a larger input is tokenized so that token
+  // positions refer to the original input.
   static absl::StatusOr<std::vector<Token>> TokenizeString(
-      absl::string_view str) {
-    Tokenizer tokenizer(str);
+      absl::string_view str, int64_t initial_lineno = 0) {
+    Tokenizer tokenizer(str, initial_lineno);
     return tokenizer.Tokenize();
   }
 
  private:
   // Drops all whitespace starting at current index. Returns true if any
-  // whitespace was dropped.
+  // whitespace was dropped. The extent of the run is found with one table
+  // lookup per character and the line/column accounting is done once for the
+  // whole run.
   bool DropWhiteSpace() {
-    int64_t old_index = index();
-    while (!EndOfString() && absl::ascii_isspace(current())) {
-      Advance();
+    int64_t i = index_;
+    const int64_t limit = str_.size();
+    while (i < limit && InCharClass(str_[i], kWhitespaceClass)) {
+      ++i;
     }
-    return old_index != index();
+    if (i == index_) {
+      return false;
+    }
+    AdvanceTo(i);
+    return true;
   }
 
   // Tries to drop an end of line comment starting with "//" at the current
   // index up to the newline. Returns true an end of line comment was found.
   bool DropEndOfLineComment() {
     if (MatchSubstring("//")) {
-      Advance(2);
-      while (!EndOfString() && current() != '\n') {
-        Advance(1);
-      }
+      // The comment extends to the next newline (or end of string); jump
+      // there directly rather than advancing a character at a time.
+      const char* newline = static_cast<const char*>(
+          memchr(str_.data() + index_, '\n', str_.size() - index_));
+      AdvanceTo(newline == nullptr ? static_cast<int64_t>(str_.size())
+                                   : newline - str_.data());
       return true;
     }
     return false;
@@ -180,7 +235,20 @@ class Tokenizer {
       if (!allow_multiline && current() == '\n') {
         break;
       }
-      Advance();
+      // The closing sequence can only begin at a quote character, so jump to
+      // the next one rather than re-testing the sequence at every position.
+      const char* next_quote = static_cast<const char*>(
+          memchr(str_.data() + index_ + 1, '"', str_.size() - index_ - 1));
+      int64_t target = next_quote == nullptr ? static_cast<int64_t>(str_.size())
+                                             : next_quote - str_.data();
+      if (!allow_multiline) {
+        const char* next_newline = static_cast<const char*>(
+            memchr(str_.data() + index_ + 1, '\n', target - index_ - 1));
+        if (next_newline != nullptr) {
+          target = next_newline - str_.data();
+        }
+      }
+      AdvanceTo(target);
     }
     return absl::InvalidArgumentError(
         absl::StrFormat("Unterminated quoted string starting at %s",
@@ -205,21 +273,53 @@ class Tokenizer {
     return index_;
   }
 
+  // Advances the current index to `target`, counting the newlines in the
+  // skipped region in bulk rather than testing one character at a time.
+  void AdvanceTo(int64_t target) {
+    XLS_CHECK_LE(target, str_.size());
+    int64_t last_newline = -1;
+    int64_t newlines = 0;
+    for (int64_t i = index_; i < target; ++i) {
+      if (str_[i] == '\n') {
+        ++newlines;
+        last_newline = i;
+      }
+    }
+    int64_t column_start = index_;
+    if (newlines > 0) {
+      lineno_ += newlines;
+      colno_ = 0;
+      column_start = last_newline + 1;
+    }
+    // Tabs count as two columns.
+    colno_ += target - column_start;
+    for (int64_t i = column_start; i < target; ++i) {
+      if (str_[i] == '\t') {
+        ++colno_;
+      }
+    }
+    index_ = target;
+  }
+
   // Returns whether the current index is at the end of the string.
   bool EndOfString() const { return index_ >= str_.size(); }
 
-  // Returns the sequence of all characters which satisfy the given test
-  // starting at the current index. Current index is updated to one past the
-  // last matching character. min_chars is the minimum number of characters
-  // which are unconditionally captured.
-  absl::string_view CaptureWhile(std::function<bool(char)> test_f,
-                                 int64_t min_chars = 0) {
-    int64_t start = index();
-    while (!EndOfString() &&
-           ((index() < min_chars + start) || test_f(current()))) {
-      Advance();
+  // Returns the sequence of characters in the classes of the bitmask
+  // `char_class` starting at the current index. Current index is updated to
+  // one past the last matching character. min_chars is the minimum number of
+  // characters which are unconditionally captured. The classes contain no
+  // newlines or tabs, so column accounting for the run is a single addition.
+  absl::string_view CaptureRun(uint8_t char_class, int64_t min_chars = 0) {
+    const int64_t start = index_;
+    const int64_t limit = str_.size();
+    int64_t i = index_;
+    while (i < limit &&
+           ((i < min_chars + start) || InCharClass(str_[i], char_class))) {
+      ++i;
     }
-    return absl::string_view(str_.data() + start, index_ - start);
+    colno_ += i - start;
+    index_ = i;
+    return absl::string_view(str_.data() + start, i - start);
   }
 
   // Tokenizes the internal string.
@@ -238,20 +338,18 @@ class Tokenizer {
       // digit. Literal numbers can also contain '_'s after the first
       // character which are used to improve readability (example:
       // '0xabcd_ef00').
-      if (isdigit(current()) ||
-          (current() == '-' && next().has_value() && isdigit(*next()))) {
-        absl::string_view value = CaptureWhile(
-            [](char c) { return absl::ascii_isalnum(c) || c == '_'; },
-            /*min_chars=*/1);
+      if (InCharClass(current(), kDigitClass) ||
+          (current() == '-' && next().has_value() &&
+           InCharClass(*next(), kDigitClass))) {
+        absl::string_view value =
+            CaptureRun(kLiteralContClass, /*min_chars=*/1);
         tokens.push_back(Token(LexicalTokenType::kLiteral, value, start_lineno,
                                start_colno));
         continue;
       }
 
-      if (isalpha(current()) || current() == '_') {
-        absl::string_view value = CaptureWhile([](char c) {
-          return isalpha(c) || c == '_' || c == '.' || isdigit(c);
-        });
+      if (InCharClass(current(), kIdentStartClass)) {
+        absl::string_view value = CaptureRun(kIdentContClass);
         tokens.push_back(
             Token::MakeIdentOrKeyword(value, start_lineno, start_colno));
         continue;
@@ -365,7 +463,8 @@ class Tokenizer {
   int64_t colno() const { return colno_; }
 
  private:
-  explicit Tokenizer(absl::string_view str) : str_(str) {}
+  explicit Tokenizer(absl::string_view str, int64_t initial_lineno = 0)
+      : str_(str), lineno_(initial_lineno) {}
 
   // The string being tokenized.
   absl::string_view str_;
@@ -378,10 +477,138 @@ class Tokenizer {
   int64_t colno_ = 0;
 };
 
+// Inputs at least this large have their tokenization sharded across worker
+// threads; below this the serial loop is faster than the thread fan-out.
+constexpr int64_t kParallelTokenizationThreshold = 1 << 20;
+
+// The start of a tokenization shard: a byte offset into the input (always the
+// first character of a line) and the line number of that line.
+struct TokenizerShard {
+  int64_t offset;
+  int64_t lineno;
+};
+
+// Splits `str` into roughly `num_shards` shards for independent tokenization.
+// Shard boundaries are placed at the start of a line outside of any
+// triple-quoted string, so every boundary falls between tokens (line comments
+// and single-quoted strings cannot span lines) and the per-shard token
+// vectors concatenate to exactly the tokens of a serial scan. All top-level
+// constructs (fn/proc/block/chan) begin on their own line in emitted IR, so
+// in practice shards split the package at those boundaries.
+std::vector<TokenizerShard> SplitForTokenization(absl::string_view str,
+                                                 int64_t num_shards) {
+  const int64_t size = str.size();
+  const int64_t target_size = size / num_shards;
+  std::vector<TokenizerShard> shards = {TokenizerShard{0, 0}};
+  int64_t next_target = target_size;
+  int64_t lineno = 0;
+  bool in_string = false;
+  bool in_triple_string = false;
+  for (int64_t i = 0; i < size; ++i) {
+    const char c = str[i];
+    if (c == '\n') {
+      ++lineno;
+      // An unterminated single-quoted string ends at the newline (as a
+      // tokenization error, reported later by the tokenizer itself).
+      in_string = false;
+      if (!in_triple_string && i + 1 >= next_target && i + 1 < size) {
+        shards.push_back(TokenizerShard{i + 1, lineno});
+        next_target = i + 1 + target_size;
+      }
+      continue;
+    }
+    if (in_triple_string) {
+      if (c == '"' && i + 2 < size && str[i + 1] == '"' && str[i + 2] == '"') {
+        in_triple_string = false;
+        i += 2;
+      }
+      continue;
+    }
+    if (in_string) {
+      if (c == '"') {
+        in_string = false;
+      }
+      continue;
+    }
+    if (c == '"') {
+      if (i + 2 < size && str[i + 1] == '"' && str[i + 2] == '"') {
+        in_triple_string = true;
+        i += 2;
+      } else {
+        in_string = true;
+      }
+      continue;
+    }
+    if (c == '/' && i + 1 < size && str[i + 1] == '/') {
+      // Jump over the line comment; the loop increment lands on the newline.
+      const char* newline = static_cast<const char*>(
+          memchr(str.data() + i, '\n', str.size() - i));
+      if (newline == nullptr) {
+        break;
+      }
+      i = newline - str.data() - 1;
+    }
+  }
+  return shards;
+}
+
 }  // namespace
 
 absl::StatusOr<std::vector<Token>> TokenizeString(absl::string_view str) {
-  return Tokenizer::TokenizeString(str);
+  // Token construction materializes a std::string per token, so tokenizing a
+  // multi-megabyte package is worth sharding across threads.
+  const int64_t num_threads = std::min<int64_t>(
+      std::thread::hardware_concurrency(),
+      static_cast<int64_t>(str.size()) / kParallelTokenizationThreshold);
+  if (num_threads <= 1) {
+    return Tokenizer::TokenizeString(str);
+  }
+  std::vector<TokenizerShard> shards = SplitForTokenization(str, num_threads);
+  if (shards.size() <= 1) {
+    return Tokenizer::TokenizeString(str);
+  }
+
+  std::vector<absl::StatusOr<std::vector<Token>>> results(shards.size());
+  std::atomic<int64_t> next_index(0);
+  std::vector<std::unique_ptr<Thread>> workers;
+  for (int64_t i = 0; i < std::min<int64_t>(num_threads, shards.size()); ++i) {
+    workers.push_back(std::make_unique<Thread>([&] {
+      int64_t index;
+      while ((index = next_index.fetch_add(1)) <
+             static_cast<int64_t>(shards.size())) {
+        const int64_t offset = shards[index].offset;
+        const int64_t limit = index + 1 < static_cast<int64_t>(shards.size())
+                                  ? shards[index + 1].offset
+                                  : static_cast<int64_t>(str.size());
+        results[index] = Tokenizer::TokenizeString(
+            str.substr(offset, limit - offset), shards[index].lineno);
+      }
+    }));
+  }
+  for (std::unique_ptr<Thread>& worker : workers) {
+    worker->Join();
+  }
+
+  for (const absl::StatusOr<std::vector<Token>>& result : results) {
+    if (!result.ok()) {
+      // Rescan serially so the error diagnostics (which log the surrounding
+      // text) are identical to the single-threaded path.
+      return Tokenizer::TokenizeString(str);
+    }
+  }
+
+  int64_t num_tokens = 0;
+  for (const absl::StatusOr<std::vector<Token>>& result : results) {
+    num_tokens += result.value().size();
+  }
+  std::vector<Token> tokens;
+  tokens.reserve(num_tokens);
+  for (absl::StatusOr<std::vector<Token>>& result : results) {
+    for (Token& token : result.value()) {
+      tokens.push_back(std::move(token));
+    }
+  }
+  return tokens;
 }
 
 absl::StatusOr<Scanner> Scanner::Create(absl::string_view text) {
@@ -60,7 +60,8 @@ struct TokenPos {
 
 class Token {
  public:
-  // Returns the (singleton) set of keyword strings.
+  // Returns the (singleton) set of keyword strings. Must be kept in sync with
+  // IsKeyword() below, which the tokenizer uses instead of this set.
   static const absl::flat_hash_set<std::string>& GetKeywords() {
     static auto* keywords = new absl::flat_hash_set<std::string>{
         "fn",   "bits", "token", "ret",   "package", "proc",
@@ -68,13 +69,35 @@ class Token {
     return *keywords;
   }
 
+  // Returns whether "value" is a keyword string. Dispatches on the length
+  // first so that the common case (an identifier) is decided with at most a
+  // couple of short string compares rather than a hash and probe.
+  static bool IsKeyword(absl::string_view value) {
+    switch (value.size()) {
+      case 2:
+        return value == "fn";
+      case 3:
+        return value == "ret" || value == "reg";
+      case 4:
+        return value == "bits" || value == "proc" || value == "chan" ||
+               value == "next";
+      case 5:
+        return value == "token" || value == "block" || value == "clock";
+      case 7:
+        return value == "package";
+      case 13:
+        return value == "instantiation";
+      default:
+        return false;
+    }
+  }
+
   // Helper factory, returns a token of kKeyword type if "value" is a keyword
   // string, and a token of kIdent type otherwise.
   static Token MakeIdentOrKeyword(absl::string_view value, int64_t lineno,
                                   int64_t colno) {
-    LexicalTokenType type = GetKeywords().contains(value)
-                                ? LexicalTokenType::kKeyword
-                                : LexicalTokenType::kIdent;
+    LexicalTokenType type = IsKeyword(value) ? LexicalTokenType::kKeyword
+                                             : LexicalTokenType::kIdent;
     if (value == "true" || value == "false") {
       type = LexicalTokenType::kLiteral;
     }
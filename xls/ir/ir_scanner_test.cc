@@ -14,6 +14,7 @@
 
 #include "xls/ir/ir_scanner.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "gmock/gmock.h"
@@ -176,5 +177,63 @@ TEST(IrScannerTest, UnterminatedTripleQuotedStrings) {
                HasSubstr("Unterminated quoted string starting at 1:1")));
 }
 
+TEST(IrScannerTest, TokenizeLargeInputMatchesSerialScan) {
+  // Build an input large enough to trigger the sharded tokenization path.
+  // The unit contains the constructs which constrain where shards may be
+  // split: comments and single-quoted strings containing quote and slash
+  // characters and a multiline triple-quoted string.
+  const std::string unit =
+      "fn foo(x: bits[32]) -> bits[32] {\n"
+      "  // comment with \"quote\" and // slashes\n"
+      "  ret identity.1: bits[32] = identity(x, id=1)\n"
+      "}\n"
+      "\n"
+      "chan ch(bits[32], id=0, metadata=\"\"\"multi\n"
+      "line \"quoted\" text // not a comment\n"
+      "\"\"\")\n";
+  const int64_t newlines_per_unit =
+      std::count(unit.begin(), unit.end(), '\n');
+  std::string input;
+  while (input.size() < (2 << 20)) {
+    input += unit;
+  }
+  const int64_t num_units = input.size() / unit.size();
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> unit_tokens,
+                           TokenizeString(unit));
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens, TokenizeString(input));
+  ASSERT_EQ(tokens.size(), unit_tokens.size() * num_units);
+  for (int64_t i = 0; i < num_units; ++i) {
+    const Token& first = tokens[i * unit_tokens.size()];
+    EXPECT_EQ(first.value(), "fn");
+    EXPECT_EQ(first.pos().lineno, i * newlines_per_unit);
+    EXPECT_EQ(first.pos().colno, 0);
+  }
+}
+
+TEST(IrScannerTest, IsKeywordMatchesKeywordSet) {
+  for (const std::string& keyword : Token::GetKeywords()) {
+    EXPECT_TRUE(Token::IsKeyword(keyword)) << keyword;
+  }
+  EXPECT_FALSE(Token::IsKeyword(""));
+  EXPECT_FALSE(Token::IsKeyword("fnord"));
+  EXPECT_FALSE(Token::IsKeyword("bit"));
+  EXPECT_FALSE(Token::IsKeyword("bitss"));
+}
+
+TEST(IrScannerTest, TokenPositionsAcrossWhitespaceAndComments) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<Token> tokens,
+                           TokenizeString("fn\n\t// comment\n  foo.2 42"));
+  ASSERT_EQ(3, tokens.size());
+  EXPECT_EQ(tokens[0].pos().lineno, 0);
+  EXPECT_EQ(tokens[0].pos().colno, 0);
+  EXPECT_EQ(tokens[1].value(), "foo.2");
+  EXPECT_EQ(tokens[1].pos().lineno, 2);
+  EXPECT_EQ(tokens[1].pos().colno, 2);
+  EXPECT_EQ(tokens[2].value(), "42");
+  EXPECT_EQ(tokens[2].pos().lineno, 2);
+  EXPECT_EQ(tokens[2].pos().colno, 8);
+}
+
 }  // namespace
 }  // namespace xls
@@ -0,0 +1,608 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/ir_serializer.h"
+
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/casts.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/channel.h"
+#include "xls/ir/channel_ops.h"
+#include "xls/ir/format_strings.h"
+#include "xls/ir/function.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/lsb_or_msb.h"
+#include "xls/ir/node_iterator.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/op.h"
+#include "xls/ir/proc.h"
+#include "xls/ir/value.h"
+#include "xls/ir/verifier.h"
+
+namespace xls {
+namespace {
+
+ValueProto ValueToProto(const Value& value) {
+  ValueProto proto;
+  if (value.IsBits()) {
+    BitsProto* bits = proto.mutable_bits();
+    bits->set_bit_count(value.bits().bit_count());
+    std::vector<uint8_t> bytes = value.bits().ToBytes();
+    bits->set_data(std::string(bytes.begin(), bytes.end()));
+  } else if (value.IsTuple()) {
+    ValueProto::Elements* tuple = proto.mutable_tuple();
+    for (const Value& element : value.elements()) {
+      *tuple->add_elements() = ValueToProto(element);
+    }
+  } else if (value.IsArray()) {
+    ValueProto::Elements* array = proto.mutable_array();
+    for (const Value& element : value.elements()) {
+      *array->add_elements() = ValueToProto(element);
+    }
+  } else {
+    XLS_CHECK(value.IsToken());
+    proto.set_token(true);
+  }
+  return proto;
+}
+
+absl::StatusOr<Value> ValueFromProto(const ValueProto& proto) {
+  switch (proto.variant_case()) {
+    case ValueProto::kBits: {
+      const std::string& data = proto.bits().data();
+      return Value(
+          Bits::FromBytes(absl::MakeSpan(reinterpret_cast<const uint8_t*>(
+                                             data.data()),
+                                         data.size()),
+                          proto.bits().bit_count()));
+    }
+    case ValueProto::kTuple: {
+      std::vector<Value> elements;
+      for (const ValueProto& element : proto.tuple().elements()) {
+        XLS_ASSIGN_OR_RETURN(Value value, ValueFromProto(element));
+        elements.push_back(value);
+      }
+      return Value::Tuple(elements);
+    }
+    case ValueProto::kArray: {
+      std::vector<Value> elements;
+      for (const ValueProto& element : proto.array().elements()) {
+        XLS_ASSIGN_OR_RETURN(Value value, ValueFromProto(element));
+        elements.push_back(value);
+      }
+      return Value::Array(elements);
+    }
+    case ValueProto::kToken:
+      return Value::Token();
+    case ValueProto::VARIANT_NOT_SET:
+      break;
+  }
+  return absl::InvalidArgumentError("ValueProto has no variant set");
+}
+
+// Serializes the generic fields and op-specific attributes of 'node'.
+absl::Status NodeToProto(Node* node, NodeProto* proto) {
+  proto->set_id(node->id());
+  if (node->HasAssignedName()) {
+    proto->set_name(node->GetName());
+  }
+  proto->set_op(OpToString(node->op()));
+  *proto->mutable_type() = node->GetType()->ToProto();
+  for (Node* operand : node->operands()) {
+    proto->add_operand_ids(operand->id());
+  }
+  switch (node->op()) {
+    case Op::kLiteral:
+      *proto->mutable_value() = ValueToProto(node->As<Literal>()->value());
+      break;
+    case Op::kBitSlice:
+      proto->set_start(node->As<BitSlice>()->start());
+      proto->set_width(node->As<BitSlice>()->width());
+      break;
+    case Op::kDynamicBitSlice:
+      proto->set_width(node->As<DynamicBitSlice>()->width());
+      break;
+    case Op::kArraySlice:
+      proto->set_width(node->As<ArraySlice>()->width());
+      break;
+    case Op::kDecode:
+      proto->set_width(node->As<Decode>()->width());
+      break;
+    case Op::kTupleIndex:
+      proto->set_index(node->As<TupleIndex>()->index());
+      break;
+    case Op::kSignExt:
+    case Op::kZeroExt:
+      proto->set_new_bit_count(node->As<ExtendOp>()->new_bit_count());
+      break;
+    case Op::kOneHot:
+      proto->set_lsb_priority(node->As<OneHot>()->priority() ==
+                              LsbOrMsb::kLsb);
+      break;
+    case Op::kSel:
+      proto->set_has_default(
+          node->As<Select>()->default_value().has_value());
+      break;
+    case Op::kCountedFor:
+      proto->set_trip_count(node->As<CountedFor>()->trip_count());
+      proto->set_stride(node->As<CountedFor>()->stride());
+      proto->set_function_name(node->As<CountedFor>()->body()->name());
+      break;
+    case Op::kDynamicCountedFor:
+      proto->set_function_name(node->As<DynamicCountedFor>()->body()->name());
+      break;
+    case Op::kInvoke:
+      proto->set_function_name(node->As<Invoke>()->to_apply()->name());
+      break;
+    case Op::kMap:
+      proto->set_function_name(node->As<Map>()->to_apply()->name());
+      break;
+    case Op::kReceive:
+      proto->set_channel_id(node->As<Receive>()->channel_id());
+      break;
+    case Op::kSend:
+      proto->set_channel_id(node->As<Send>()->channel_id());
+      break;
+    case Op::kAssert:
+      proto->set_message(node->As<Assert>()->message());
+      if (node->As<Assert>()->label().has_value()) {
+        proto->set_label(node->As<Assert>()->label().value());
+      }
+      break;
+    case Op::kCover:
+      proto->set_label(node->As<Cover>()->label());
+      break;
+    case Op::kTrace:
+      proto->set_format(StepsToXlsFormatString(node->As<Trace>()->format()));
+      break;
+    default:
+      // Remaining ops are fully described by their operands and type.
+      break;
+  }
+  return absl::OkStatus();
+}
+
+void ParamToProto(Param* param, ParamProto* proto) {
+  proto->set_name(param->name());
+  proto->set_id(param->id());
+  *proto->mutable_type() = param->GetType()->ToProto();
+}
+
+absl::Status FunctionToProto(Function* f, FunctionProto* proto) {
+  proto->set_name(f->name());
+  for (Param* param : f->params()) {
+    ParamToProto(param, proto->add_params());
+  }
+  for (Node* node : TopoSort(f)) {
+    if (node->Is<Param>()) {
+      continue;
+    }
+    XLS_RETURN_IF_ERROR(NodeToProto(node, proto->add_nodes()));
+  }
+  proto->set_return_id(f->return_value()->id());
+  return absl::OkStatus();
+}
+
+absl::Status ProcToProto(Proc* p, ProcProto* proto) {
+  proto->set_name(p->name());
+  *proto->mutable_init_value() = ValueToProto(p->InitValue());
+  ParamToProto(p->TokenParam(), proto->mutable_token_param());
+  ParamToProto(p->StateParam(), proto->mutable_state_param());
+  for (Node* node : TopoSort(p)) {
+    if (node->Is<Param>()) {
+      continue;
+    }
+    XLS_RETURN_IF_ERROR(NodeToProto(node, proto->add_nodes()));
+  }
+  proto->set_next_token_id(p->NextToken()->id());
+  proto->set_next_state_id(p->NextState()->id());
+  return absl::OkStatus();
+}
+
+void ChannelToProto(Channel* channel, PackageChannelProto* proto) {
+  proto->set_name(channel->name());
+  proto->set_id(channel->id());
+  proto->set_kind(ChannelKindToString(channel->kind()));
+  proto->set_supported_ops(ChannelOpsToString(channel->supported_ops()));
+  *proto->mutable_type() = channel->type()->ToProto();
+  for (const Value& value : channel->initial_values()) {
+    *proto->add_initial_values() = ValueToProto(value);
+  }
+  if (channel->kind() == ChannelKind::kStreaming) {
+    proto->set_flow_control(FlowControlToString(
+        down_cast<StreamingChannel*>(channel)->flow_control()));
+  }
+  *proto->mutable_metadata() = channel->metadata();
+}
+
+// Reconstructs the node described by 'proto' using the given builder,
+// mirroring the construction performed by Parser::ParseNode for the textual
+// format.
+absl::StatusOr<BValue> BuildNodeFromProto(
+    const NodeProto& proto, Package* package, BuilderBase* fb,
+    const absl::flat_hash_map<int64_t, BValue>& id_to_bvalue) {
+  XLS_ASSIGN_OR_RETURN(Op op, StringToOp(proto.op()));
+  XLS_ASSIGN_OR_RETURN(Type * type, package->GetTypeFromProto(proto.type()));
+  std::string node_name = proto.has_name() ? proto.name() : "";
+  std::vector<BValue> operands;
+  for (int64_t operand_id : proto.operand_ids()) {
+    auto it = id_to_bvalue.find(operand_id);
+    if (it == id_to_bvalue.end()) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Node id %d refers to undefined operand id %d", proto.id(),
+          operand_id));
+    }
+    operands.push_back(it->second);
+  }
+  auto check_arity = [&](int64_t expected) -> absl::Status {
+    XLS_RET_CHECK_EQ(operands.size(), expected)
+        << absl::StrFormat("for op %s (node id %d)", proto.op(), proto.id());
+    return absl::OkStatus();
+  };
+  absl::optional<SourceLocation> loc;
+
+  switch (op) {
+    case Op::kBitSlice:
+      XLS_RETURN_IF_ERROR(check_arity(1));
+      return fb->BitSlice(operands[0], proto.start(), proto.width(), loc,
+                          node_name);
+    case Op::kDynamicBitSlice:
+      XLS_RETURN_IF_ERROR(check_arity(2));
+      return fb->DynamicBitSlice(operands[0], operands[1], proto.width(), loc,
+                                 node_name);
+    case Op::kConcat:
+      return fb->Concat(operands, loc, node_name);
+    case Op::kLiteral: {
+      XLS_RETURN_IF_ERROR(check_arity(0));
+      XLS_ASSIGN_OR_RETURN(Value value, ValueFromProto(proto.value()));
+      return fb->Literal(value, loc, node_name);
+    }
+    case Op::kMap: {
+      XLS_RETURN_IF_ERROR(check_arity(1));
+      XLS_ASSIGN_OR_RETURN(Function * to_apply,
+                           package->GetFunction(proto.function_name()));
+      return fb->Map(operands[0], to_apply, loc, node_name);
+    }
+    case Op::kCountedFor: {
+      XLS_RET_CHECK_GE(operands.size(), 1);
+      XLS_ASSIGN_OR_RETURN(Function * body,
+                           package->GetFunction(proto.function_name()));
+      return fb->CountedFor(operands[0], proto.trip_count(), proto.stride(),
+                            body,
+                            absl::MakeSpan(operands).subspan(1), loc,
+                            node_name);
+    }
+    case Op::kDynamicCountedFor: {
+      XLS_RET_CHECK_GE(operands.size(), 3);
+      XLS_ASSIGN_OR_RETURN(Function * body,
+                           package->GetFunction(proto.function_name()));
+      return fb->DynamicCountedFor(operands[0], operands[1], operands[2], body,
+                                   absl::MakeSpan(operands).subspan(3), loc,
+                                   node_name);
+    }
+    case Op::kOneHot:
+      XLS_RETURN_IF_ERROR(check_arity(1));
+      return fb->OneHot(operands[0],
+                        proto.lsb_priority() ? LsbOrMsb::kLsb : LsbOrMsb::kMsb,
+                        loc, node_name);
+    case Op::kOneHotSel: {
+      XLS_RET_CHECK_GE(operands.size(), 2);
+      return fb->OneHotSelect(operands[0],
+                              absl::MakeSpan(operands).subspan(1), loc,
+                              node_name);
+    }
+    case Op::kSel: {
+      XLS_RET_CHECK_GE(operands.size(), proto.has_default() ? 3 : 2);
+      absl::optional<BValue> default_value;
+      int64_t num_cases = operands.size() - 1;
+      if (proto.has_default()) {
+        default_value = operands.back();
+        --num_cases;
+      }
+      return fb->Select(operands[0],
+                        absl::MakeSpan(operands).subspan(1, num_cases),
+                        default_value, loc, node_name);
+    }
+    case Op::kTuple:
+      return fb->Tuple(operands, loc, node_name);
+    case Op::kAfterAll:
+      return fb->AfterAll(operands, loc, node_name);
+    case Op::kArray: {
+      XLS_RET_CHECK(type->IsArray());
+      return fb->Array(operands, type->AsArrayOrDie()->element_type(), loc,
+                       node_name);
+    }
+    case Op::kTupleIndex:
+      XLS_RETURN_IF_ERROR(check_arity(1));
+      return fb->TupleIndex(operands[0], proto.index(), loc, node_name);
+    case Op::kArrayIndex: {
+      XLS_RET_CHECK_GE(operands.size(), 1);
+      return fb->ArrayIndex(operands[0], absl::MakeSpan(operands).subspan(1),
+                            loc, node_name);
+    }
+    case Op::kArrayUpdate: {
+      XLS_RET_CHECK_GE(operands.size(), 2);
+      return fb->ArrayUpdate(operands[0], operands[1],
+                             absl::MakeSpan(operands).subspan(2), loc,
+                             node_name);
+    }
+    case Op::kArrayConcat:
+      return fb->ArrayConcat(operands, loc, node_name);
+    case Op::kArraySlice:
+      XLS_RETURN_IF_ERROR(check_arity(2));
+      return fb->ArraySlice(operands[0], operands[1], proto.width(), loc,
+                            node_name);
+    case Op::kInvoke: {
+      XLS_ASSIGN_OR_RETURN(Function * to_apply,
+                           package->GetFunction(proto.function_name()));
+      return fb->Invoke(operands, to_apply, loc, node_name);
+    }
+    case Op::kZeroExt:
+      XLS_RETURN_IF_ERROR(check_arity(1));
+      return fb->ZeroExtend(operands[0], proto.new_bit_count(), loc,
+                            node_name);
+    case Op::kSignExt:
+      XLS_RETURN_IF_ERROR(check_arity(1));
+      return fb->SignExtend(operands[0], proto.new_bit_count(), loc,
+                            node_name);
+    case Op::kEncode:
+      XLS_RETURN_IF_ERROR(check_arity(1));
+      return fb->Encode(operands[0], loc, node_name);
+    case Op::kDecode:
+      XLS_RETURN_IF_ERROR(check_arity(1));
+      return fb->Decode(operands[0], proto.width(), loc, node_name);
+    case Op::kSMul:
+    case Op::kUMul:
+      XLS_RETURN_IF_ERROR(check_arity(2));
+      XLS_RET_CHECK(type->IsBits());
+      return fb->AddArithOp(op, operands[0], operands[1],
+                            type->AsBitsOrDie()->bit_count(), loc, node_name);
+    case Op::kReceive: {
+      ProcBuilder* pb = dynamic_cast<ProcBuilder*>(fb);
+      XLS_RET_CHECK(pb != nullptr)
+          << "receive operations only supported in procs";
+      XLS_ASSIGN_OR_RETURN(Channel * channel,
+                           package->GetChannel(proto.channel_id()));
+      if (operands.size() == 2) {
+        return pb->ReceiveIf(channel, operands[0], operands[1], loc,
+                             node_name);
+      }
+      XLS_RETURN_IF_ERROR(check_arity(1));
+      return pb->Receive(channel, operands[0], loc, node_name);
+    }
+    case Op::kSend: {
+      ProcBuilder* pb = dynamic_cast<ProcBuilder*>(fb);
+      XLS_RET_CHECK(pb != nullptr) << "send operations only supported in procs";
+      XLS_ASSIGN_OR_RETURN(Channel * channel,
+                           package->GetChannel(proto.channel_id()));
+      if (operands.size() == 3) {
+        return pb->SendIf(channel, operands[0], operands[2], operands[1], loc,
+                          node_name);
+      }
+      XLS_RETURN_IF_ERROR(check_arity(2));
+      return pb->Send(channel, operands[0], operands[1], loc, node_name);
+    }
+    case Op::kAssert: {
+      XLS_RETURN_IF_ERROR(check_arity(2));
+      absl::optional<std::string> label;
+      if (proto.has_label()) {
+        label = proto.label();
+      }
+      return fb->Assert(operands[0], operands[1], proto.message(), label, loc,
+                        node_name);
+    }
+    case Op::kTrace: {
+      XLS_RET_CHECK_GE(operands.size(), 2);
+      XLS_ASSIGN_OR_RETURN(std::vector<FormatStep> format,
+                           ParseFormatString(proto.format()));
+      return fb->Trace(operands[0], operands[1],
+                       absl::MakeSpan(operands).subspan(2), format, loc,
+                       node_name);
+    }
+    case Op::kCover:
+      XLS_RETURN_IF_ERROR(check_arity(2));
+      return fb->Cover(operands[0], operands[1], proto.label(), loc,
+                       node_name);
+    case Op::kBitSliceUpdate:
+      XLS_RETURN_IF_ERROR(check_arity(3));
+      return fb->BitSliceUpdate(operands[0], operands[1], operands[2], loc,
+                                node_name);
+    case Op::kGate:
+      XLS_RETURN_IF_ERROR(check_arity(2));
+      return fb->Gate(operands[0], operands[1], loc, node_name);
+    default:
+      break;
+  }
+
+  if (IsOpClass<BinOp>(op)) {
+    XLS_RETURN_IF_ERROR(check_arity(2));
+    return fb->AddBinOp(op, operands[0], operands[1], loc, node_name);
+  }
+  if (IsOpClass<UnOp>(op)) {
+    XLS_RETURN_IF_ERROR(check_arity(1));
+    return fb->AddUnOp(op, operands[0], loc, node_name);
+  }
+  if (IsOpClass<CompareOp>(op)) {
+    XLS_RETURN_IF_ERROR(check_arity(2));
+    return fb->AddCompareOp(op, operands[0], operands[1], loc, node_name);
+  }
+  if (IsOpClass<NaryOp>(op)) {
+    return fb->AddNaryOp(op, operands, loc, node_name);
+  }
+  if (IsOpClass<BitwiseReductionOp>(op)) {
+    XLS_RETURN_IF_ERROR(check_arity(1));
+    return fb->AddBitwiseReductionOp(op, operands[0], loc, node_name);
+  }
+  return absl::InvalidArgumentError(absl::StrFormat(
+      "Cannot deserialize operation \"%s\"", proto.op()));
+}
+
+// Builds the non-param nodes of a function or proc, recording the BValue and
+// restoring the serialized id of each.
+absl::Status BuildBody(
+    absl::Span<const NodeProto* const> nodes, Package* package,
+    BuilderBase* fb, absl::flat_hash_map<int64_t, BValue>* id_to_bvalue) {
+  for (const NodeProto* node_proto : nodes) {
+    XLS_ASSIGN_OR_RETURN(
+        BValue bvalue,
+        BuildNodeFromProto(*node_proto, package, fb, *id_to_bvalue));
+    if (bvalue.valid()) {
+      bvalue.node()->SetId(node_proto->id());
+    }
+    (*id_to_bvalue)[node_proto->id()] = bvalue;
+  }
+  return absl::OkStatus();
+}
+
+std::vector<const NodeProto*> NodePointers(
+    const google::protobuf::RepeatedPtrField<NodeProto>& nodes) {
+  std::vector<const NodeProto*> result;
+  for (const NodeProto& node : nodes) {
+    result.push_back(&node);
+  }
+  return result;
+}
+
+absl::Status DeserializeFunction(const FunctionProto& proto,
+                                 Package* package) {
+  FunctionBuilder fb(proto.name(), package);
+  absl::flat_hash_map<int64_t, BValue> id_to_bvalue;
+  for (const ParamProto& param : proto.params()) {
+    XLS_ASSIGN_OR_RETURN(Type * type, package->GetTypeFromProto(param.type()));
+    BValue bvalue = fb.Param(param.name(), type);
+    if (bvalue.valid()) {
+      bvalue.node()->SetId(param.id());
+    }
+    id_to_bvalue[param.id()] = bvalue;
+  }
+  XLS_RETURN_IF_ERROR(
+      BuildBody(NodePointers(proto.nodes()), package, &fb, &id_to_bvalue));
+  auto it = id_to_bvalue.find(proto.return_id());
+  XLS_RET_CHECK(it != id_to_bvalue.end())
+      << "Return id refers to undefined node: " << proto.return_id();
+  return fb.BuildWithReturnValue(it->second).status();
+}
+
+absl::Status DeserializeProc(const ProcProto& proto, Package* package) {
+  XLS_ASSIGN_OR_RETURN(Value init_value, ValueFromProto(proto.init_value()));
+  ProcBuilder pb(proto.name(), init_value, proto.token_param().name(),
+                 proto.state_param().name(), package);
+  absl::flat_hash_map<int64_t, BValue> id_to_bvalue;
+  pb.GetTokenParam().node()->SetId(proto.token_param().id());
+  pb.GetStateParam().node()->SetId(proto.state_param().id());
+  id_to_bvalue[proto.token_param().id()] = pb.GetTokenParam();
+  id_to_bvalue[proto.state_param().id()] = pb.GetStateParam();
+  XLS_RETURN_IF_ERROR(
+      BuildBody(NodePointers(proto.nodes()), package, &pb, &id_to_bvalue));
+  auto next_token_it = id_to_bvalue.find(proto.next_token_id());
+  XLS_RET_CHECK(next_token_it != id_to_bvalue.end());
+  auto next_state_it = id_to_bvalue.find(proto.next_state_id());
+  XLS_RET_CHECK(next_state_it != id_to_bvalue.end());
+  return pb.Build(next_token_it->second, next_state_it->second).status();
+}
+
+absl::Status DeserializeChannel(const PackageChannelProto& proto,
+                                Package* package) {
+  XLS_ASSIGN_OR_RETURN(Type * type, package->GetTypeFromProto(proto.type()));
+  XLS_ASSIGN_OR_RETURN(ChannelOps supported_ops,
+                       StringToChannelOps(proto.supported_ops()));
+  XLS_ASSIGN_OR_RETURN(ChannelKind kind, StringToChannelKind(proto.kind()));
+  std::vector<Value> initial_values;
+  for (const ValueProto& value_proto : proto.initial_values()) {
+    XLS_ASSIGN_OR_RETURN(Value value, ValueFromProto(value_proto));
+    initial_values.push_back(value);
+  }
+  switch (kind) {
+    case ChannelKind::kStreaming: {
+      XLS_ASSIGN_OR_RETURN(FlowControl flow_control,
+                           StringToFlowControl(proto.flow_control()));
+      return package
+          ->CreateStreamingChannel(proto.name(), supported_ops, type,
+                                   initial_values, flow_control,
+                                   proto.metadata(), proto.id())
+          .status();
+    }
+    case ChannelKind::kSingleValue: {
+      XLS_RET_CHECK(initial_values.empty());
+      return package
+          ->CreateSingleValueChannel(proto.name(), supported_ops, type,
+                                     proto.metadata(), proto.id())
+          .status();
+    }
+    default:
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Cannot deserialize channel of kind \"%s\"", proto.kind()));
+  }
+}
+
+}  // namespace
+
+absl::StatusOr<PackageProto> PackageToProto(Package* package) {
+  if (!package->blocks().empty()) {
+    return absl::UnimplementedError(
+        "Binary IR serialization does not support blocks; serialize before "
+        "codegen lowering.");
+  }
+  PackageProto proto;
+  proto.set_name(package->name());
+  for (Channel* channel : package->channels()) {
+    ChannelToProto(channel, proto.add_channels());
+  }
+  for (const std::unique_ptr<Function>& function : package->functions()) {
+    XLS_RETURN_IF_ERROR(
+        FunctionToProto(function.get(), proto.add_functions()));
+  }
+  for (const std::unique_ptr<Proc>& p : package->procs()) {
+    XLS_RETURN_IF_ERROR(ProcToProto(p.get(), proto.add_procs()));
+  }
+  return proto;
+}
+
+absl::StatusOr<std::string> SerializePackage(Package* package) {
+  XLS_ASSIGN_OR_RETURN(PackageProto proto, PackageToProto(package));
+  return proto.SerializeAsString();
+}
+
+absl::StatusOr<std::unique_ptr<Package>> PackageFromProto(
+    const PackageProto& proto) {
+  auto package = std::make_unique<Package>(proto.name());
+  for (const PackageChannelProto& channel : proto.channels()) {
+    XLS_RETURN_IF_ERROR(DeserializeChannel(channel, package.get()));
+  }
+  for (const FunctionProto& function : proto.functions()) {
+    XLS_RETURN_IF_ERROR(DeserializeFunction(function, package.get()));
+  }
+  for (const ProcProto& p : proto.procs()) {
+    XLS_RETURN_IF_ERROR(DeserializeProc(p, package.get()));
+  }
+  XLS_RETURN_IF_ERROR(VerifyPackage(package.get()));
+  return package;
+}
+
+absl::StatusOr<std::unique_ptr<Package>> DeserializePackage(
+    absl::string_view data) {
+  PackageProto proto;
+  if (!proto.ParseFromArray(data.data(), data.size())) {
+    return absl::InvalidArgumentError(
+        "Failed to parse binary-serialized package");
+  }
+  return PackageFromProto(proto);
+}
+
+}  // namespace xls
@@ -0,0 +1,54 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_IR_IR_SERIALIZER_H_
+#define XLS_IR_IR_SERIALIZER_H_
+
+#include <memory>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xls/ir/ir_serialization.pb.h"
+#include "xls/ir/package.h"
+
+namespace xls {
+
+// Binary serialization of packages. This is a fast alternative to the textual
+// IR round-trip (DumpIr/Parser::ParsePackage) for exchanging IR between
+// pipeline stages: loading skips tokenization and name resolution entirely as
+// nodes reference their operands by id. The format is tied to the XLS version
+// which produced it and makes no cross-version compatibility guarantees.
+//
+// Limitations: blocks are not serialized (serialize before codegen lowering),
+// and node source locations are dropped.
+
+// Converts the package to its proto form. Functions and procs are emitted
+// with their nodes in topological order so deserialization is a single
+// forward walk.
+absl::StatusOr<PackageProto> PackageToProto(Package* package);
+
+// Serializes the package to the binary wire form of PackageProto.
+absl::StatusOr<std::string> SerializePackage(Package* package);
+
+// Reconstructs a package from its proto (or binary wire) form. The resulting
+// package is verified before being returned.
+absl::StatusOr<std::unique_ptr<Package>> PackageFromProto(
+    const PackageProto& proto);
+absl::StatusOr<std::unique_ptr<Package>> DeserializePackage(
+    absl::string_view data);
+
+}  // namespace xls
+
+#endif  // XLS_IR_IR_SERIALIZER_H_
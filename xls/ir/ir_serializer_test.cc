@@ -0,0 +1,116 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/ir_serializer.h"
+
+#include <memory>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+
+namespace xls {
+namespace {
+
+using status_testing::IsOkAndHolds;
+
+// Round-trips the textual IR through the binary format and returns the
+// deserialized package's textual dump.
+absl::StatusOr<std::string> RoundTrip(absl::string_view ir_text) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       Parser::ParsePackage(ir_text));
+  XLS_ASSIGN_OR_RETURN(std::string serialized,
+                       SerializePackage(package.get()));
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> result,
+                       DeserializePackage(serialized));
+  return result->DumpIr();
+}
+
+TEST(IrSerializerTest, RoundTripsSimpleFunction) {
+  const std::string ir_text = R"(package simple
+
+fn main(x: bits[32], y: bits[32]) -> bits[32] {
+  add.3: bits[32] = add(x, y, id=3)
+  ret neg.4: bits[32] = neg(add.3, id=4)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(ir_text));
+  EXPECT_THAT(RoundTrip(ir_text), IsOkAndHolds(package->DumpIr()));
+}
+
+TEST(IrSerializerTest, RoundTripsAttributeOps) {
+  const std::string ir_text = R"(package attrs
+
+fn callee(x: bits[8]) -> bits[8] {
+  ret identity.2: bits[8] = identity(x, id=2)
+}
+
+fn main(a: bits[8], b: bits[1]) -> bits[4] {
+  literal.10: bits[8] = literal(value=42, id=10)
+  invoke.11: bits[8] = invoke(a, to_apply=callee, id=11)
+  sel.12: bits[8] = sel(b, cases=[literal.10, invoke.11], id=12)
+  one_hot.13: bits[9] = one_hot(sel.12, lsb_prio=true, id=13)
+  sign_ext.14: bits[16] = sign_ext(b, new_bit_count=16, id=14)
+  umul.15: bits[16] = umul(one_hot.13, sign_ext.14, id=15)
+  ret bit_slice.16: bits[4] = bit_slice(umul.15, start=2, width=4, id=16)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(ir_text));
+  EXPECT_THAT(RoundTrip(ir_text), IsOkAndHolds(package->DumpIr()));
+}
+
+TEST(IrSerializerTest, RoundTripsProcWithChannels) {
+  const std::string ir_text = R"(package procs
+
+chan in_ch(bits[32], id=0, kind=streaming, ops=receive_only, flow_control=ready_valid, metadata="""""")
+chan out_ch(bits[32], id=1, kind=streaming, ops=send_only, flow_control=ready_valid, metadata="""""")
+
+proc accum(tkn: token, st: bits[32], init=0) {
+  receive.4: (token, bits[32]) = receive(tkn, channel_id=0, id=4)
+  tuple_index.5: token = tuple_index(receive.4, index=0, id=5)
+  tuple_index.6: bits[32] = tuple_index(receive.4, index=1, id=6)
+  add.7: bits[32] = add(st, tuple_index.6, id=7)
+  send.8: token = send(tuple_index.5, add.7, channel_id=1, id=8)
+  next (send.8, add.7)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(ir_text));
+  EXPECT_THAT(RoundTrip(ir_text), IsOkAndHolds(package->DumpIr()));
+}
+
+TEST(IrSerializerTest, SerializedFormIsSmallerThanText) {
+  const std::string ir_text = R"(package size
+
+fn main(x: bits[32], y: bits[32]) -> bits[32] {
+  add.3: bits[32] = add(x, y, id=3)
+  sub.4: bits[32] = sub(add.3, y, id=4)
+  umul.5: bits[32] = umul(sub.4, x, id=5)
+  ret xor.6: bits[32] = xor(umul.5, add.3, id=6)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(ir_text));
+  XLS_ASSERT_OK_AND_ASSIGN(std::string serialized,
+                           SerializePackage(package.get()));
+  EXPECT_LT(serialized.size(), package->DumpIr().size());
+}
+
+}  // namespace
+}  // namespace xls
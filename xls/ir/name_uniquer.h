@@ -49,6 +49,11 @@ class NameUniquer {
   // Returns true if the given str is a valid identifier.
   static bool IsValidIdentifier(absl::string_view str);
 
+  // Hint that the uniquer will track approximately 'name_count' distinct name
+  // prefixes. Grows the internal table once up front so bulk registration
+  // (e.g. parsing or unrolling a large function) incurs a single rehash.
+  void Reserve(int64_t name_count) { generated_names_.reserve(name_count); }
+
  private:
   // Used to track and generate new identifiers for the same instruction name
   // root.
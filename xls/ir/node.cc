@@ -14,7 +14,11 @@
 
 #include "xls/ir/node.h"
 
+#include <algorithm>
+#include <memory>
+
 #include "absl/algorithm/container.h"
+#include "absl/hash/hash.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/str_cat.h"
@@ -26,6 +30,7 @@
 #include "xls/ir/dfs_visitor.h"
 #include "xls/ir/function.h"
 #include "xls/ir/instantiation.h"
+#include "xls/ir/node_arena.h"
 #include "xls/ir/nodes.h"
 #include "xls/ir/package.h"
 #include "xls/ir/proc.h"
@@ -33,6 +38,39 @@
 #include "xls/ir/verifier.h"
 
 namespace xls {
+namespace {
+
+// Each node allocation is prefixed with a max-aligned header word recording
+// whether the storage came from an arena or the global heap so operator
+// delete can tell them apart.
+constexpr size_t kAllocHeaderSize = alignof(std::max_align_t);
+constexpr uint64_t kArenaAllocTag = 0xa43a;
+constexpr uint64_t kHeapAllocTag = 0x4ea8;
+
+}  // namespace
+
+void* Node::operator new(size_t size) {
+  uint8_t* base;
+  uint64_t tag;
+  if (NodeArena* arena = NodeArena::current()) {
+    base = static_cast<uint8_t*>(arena->Allocate(
+        size + kAllocHeaderSize, alignof(std::max_align_t)));
+    tag = kArenaAllocTag;
+  } else {
+    base = static_cast<uint8_t*>(::operator new(size + kAllocHeaderSize));
+    tag = kHeapAllocTag;
+  }
+  *reinterpret_cast<uint64_t*>(base) = tag;
+  return base + kAllocHeaderSize;
+}
+
+void Node::operator delete(void* ptr) {
+  uint8_t* base = static_cast<uint8_t*>(ptr) - kAllocHeaderSize;
+  if (*reinterpret_cast<uint64_t*>(base) == kHeapAllocTag) {
+    ::operator delete(base);
+  }
+  // Arena-backed storage is released in bulk by the owning NodeArena.
+}
 
 Node::Node(Op op, Type* type, absl::optional<SourceLocation> loc,
            absl::string_view name, FunctionBase* function_base)
@@ -48,6 +86,8 @@ void Node::AddOperand(Node* operand) {
               << operands_.size() << " operand of " << GetName();
   operands_.push_back(operand);
   operand->AddUser(this);
+  // No-op during construction; matters for the rare post-construction use.
+  InvalidateFingerprint();
   XLS_VLOG(3) << " " << operand->GetName()
               << " user now: " << operand->GetUsersString();
 }
@@ -71,245 +111,83 @@ absl::Status Node::AddNodeToFunctionAndReplace(
   return ReplaceUsesWith(replacement_ptr);
 }
 
-void Node::AddUser(Node* user) { users_.insert(user); }
+namespace {
 
-void Node::RemoveUser(Node* user) { XLS_CHECK_EQ(users_.erase(user), 1); }
+// Fanout above which user bookkeeping switches from a sorted vector to a
+// hash-based index (see Node::user_index_). Chosen so the common case stays a
+// compact vector while sorted insertion never operates on large vectors.
+constexpr int64_t kHighFanoutUserThreshold = 64;
 
-absl::Status Node::VisitSingleNode(DfsVisitor* visitor) {
-  switch (op()) {
-    case Op::kAdd:
-      XLS_RETURN_IF_ERROR(visitor->HandleAdd(down_cast<BinOp*>(this)));
-      break;
-    case Op::kAnd:
-      XLS_RETURN_IF_ERROR(visitor->HandleNaryAnd(down_cast<NaryOp*>(this)));
-      break;
-    case Op::kAndReduce:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleAndReduce(down_cast<BitwiseReductionOp*>(this)));
-      break;
-    case Op::kAssert:
-      XLS_RETURN_IF_ERROR(visitor->HandleAssert(down_cast<Assert*>(this)));
-      break;
-    case Op::kCover:
-      XLS_RETURN_IF_ERROR(visitor->HandleCover(down_cast<Cover*>(this)));
-      break;
-    case Op::kTrace:
-      XLS_RETURN_IF_ERROR(visitor->HandleTrace(down_cast<Trace*>(this)));
-      break;
-    case Op::kReceive:
-      XLS_RETURN_IF_ERROR(visitor->HandleReceive(down_cast<Receive*>(this)));
-      break;
-    case Op::kSend:
-      XLS_RETURN_IF_ERROR(visitor->HandleSend(down_cast<Send*>(this)));
-      break;
-    case Op::kNand:
-      XLS_RETURN_IF_ERROR(visitor->HandleNaryNand(down_cast<NaryOp*>(this)));
-      break;
-    case Op::kNor:
-      XLS_RETURN_IF_ERROR(visitor->HandleNaryNor(down_cast<NaryOp*>(this)));
-      break;
-    case Op::kAfterAll:
-      XLS_RETURN_IF_ERROR(visitor->HandleAfterAll(down_cast<AfterAll*>(this)));
-      break;
-    case Op::kArray:
-      XLS_RETURN_IF_ERROR(visitor->HandleArray(down_cast<Array*>(this)));
-      break;
-    case Op::kBitSlice:
-      XLS_RETURN_IF_ERROR(visitor->HandleBitSlice(down_cast<BitSlice*>(this)));
-      break;
-    case Op::kDynamicBitSlice:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleDynamicBitSlice(down_cast<DynamicBitSlice*>(this)));
-      break;
-    case Op::kBitSliceUpdate:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleBitSliceUpdate(down_cast<BitSliceUpdate*>(this)));
-      break;
-    case Op::kConcat:
-      XLS_RETURN_IF_ERROR(visitor->HandleConcat(down_cast<Concat*>(this)));
-      break;
-    case Op::kDecode:
-      XLS_RETURN_IF_ERROR(visitor->HandleDecode(down_cast<Decode*>(this)));
-      break;
-    case Op::kEncode:
-      XLS_RETURN_IF_ERROR(visitor->HandleEncode(down_cast<Encode*>(this)));
-      break;
-    case Op::kEq:
-      XLS_RETURN_IF_ERROR(visitor->HandleEq(down_cast<CompareOp*>(this)));
-      break;
-    case Op::kIdentity:
-      XLS_RETURN_IF_ERROR(visitor->HandleIdentity(down_cast<UnOp*>(this)));
-      break;
-    case Op::kArrayIndex:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleArrayIndex(down_cast<ArrayIndex*>(this)));
-      break;
-    case Op::kArrayUpdate:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleArrayUpdate(down_cast<ArrayUpdate*>(this)));
-      break;
-    case Op::kArrayConcat:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleArrayConcat(down_cast<ArrayConcat*>(this)));
-      break;
-    case Op::kArraySlice:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleArraySlice(down_cast<ArraySlice*>(this)));
-      break;
-    case Op::kInvoke:
-      XLS_RETURN_IF_ERROR(visitor->HandleInvoke(down_cast<Invoke*>(this)));
-      break;
-    case Op::kCountedFor:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleCountedFor(down_cast<CountedFor*>(this)));
-      break;
-    case Op::kDynamicCountedFor:
-      XLS_RETURN_IF_ERROR(visitor->HandleDynamicCountedFor(
-          down_cast<DynamicCountedFor*>(this)));
-      break;
-    case Op::kLiteral:
-      XLS_RETURN_IF_ERROR(visitor->HandleLiteral(down_cast<Literal*>(this)));
-      break;
-    case Op::kMap:
-      XLS_RETURN_IF_ERROR(visitor->HandleMap(down_cast<Map*>(this)));
-      break;
-    case Op::kNe:
-      XLS_RETURN_IF_ERROR(visitor->HandleNe(down_cast<CompareOp*>(this)));
-      break;
-    case Op::kNeg:
-      XLS_RETURN_IF_ERROR(visitor->HandleNeg(down_cast<UnOp*>(this)));
-      break;
-    case Op::kNot:
-      XLS_RETURN_IF_ERROR(visitor->HandleNot(down_cast<UnOp*>(this)));
-      break;
-    case Op::kOneHot:
-      XLS_RETURN_IF_ERROR(visitor->HandleOneHot(down_cast<OneHot*>(this)));
-      break;
-    case Op::kOneHotSel:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleOneHotSel(down_cast<OneHotSelect*>(this)));
-      break;
-    case Op::kOr:
-      XLS_RETURN_IF_ERROR(visitor->HandleNaryOr(down_cast<NaryOp*>(this)));
-      break;
-    case Op::kOrReduce:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleOrReduce(down_cast<BitwiseReductionOp*>(this)));
-      break;
-    case Op::kParam:
-      XLS_RETURN_IF_ERROR(visitor->HandleParam(down_cast<Param*>(this)));
-      break;
-    case Op::kRegisterRead:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleRegisterRead(down_cast<RegisterRead*>(this)));
-      break;
-    case Op::kRegisterWrite:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleRegisterWrite(down_cast<RegisterWrite*>(this)));
-      break;
-    case Op::kReverse:
-      XLS_RETURN_IF_ERROR(visitor->HandleReverse(down_cast<UnOp*>(this)));
-      break;
-    case Op::kSDiv:
-      XLS_RETURN_IF_ERROR(visitor->HandleSDiv(down_cast<BinOp*>(this)));
-      break;
-    case Op::kSel:
-      XLS_RETURN_IF_ERROR(visitor->HandleSel(down_cast<Select*>(this)));
-      break;
-    case Op::kSGt:
-      XLS_RETURN_IF_ERROR(visitor->HandleSGt(down_cast<CompareOp*>(this)));
-      break;
-    case Op::kSGe:
-      XLS_RETURN_IF_ERROR(visitor->HandleSGe(down_cast<CompareOp*>(this)));
-      break;
-    case Op::kShll:
-      XLS_RETURN_IF_ERROR(visitor->HandleShll(down_cast<BinOp*>(this)));
-      break;
-    case Op::kShra:
-      XLS_RETURN_IF_ERROR(visitor->HandleShra(down_cast<BinOp*>(this)));
-      break;
-    case Op::kShrl:
-      XLS_RETURN_IF_ERROR(visitor->HandleShrl(down_cast<BinOp*>(this)));
-      break;
-    case Op::kSLe:
-      XLS_RETURN_IF_ERROR(visitor->HandleSLe(down_cast<CompareOp*>(this)));
-      break;
-    case Op::kSLt:
-      XLS_RETURN_IF_ERROR(visitor->HandleSLt(down_cast<CompareOp*>(this)));
-      break;
-    case Op::kSMod:
-      XLS_RETURN_IF_ERROR(visitor->HandleSMod(down_cast<BinOp*>(this)));
-      break;
-    case Op::kSMul:
-      XLS_RETURN_IF_ERROR(visitor->HandleSMul(down_cast<ArithOp*>(this)));
-      break;
-    case Op::kSub:
-      XLS_RETURN_IF_ERROR(visitor->HandleSub(down_cast<BinOp*>(this)));
-      break;
-    case Op::kTupleIndex:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleTupleIndex(down_cast<TupleIndex*>(this)));
-      break;
-    case Op::kTuple:
-      XLS_RETURN_IF_ERROR(visitor->HandleTuple(down_cast<Tuple*>(this)));
-      break;
-    case Op::kUDiv:
-      XLS_RETURN_IF_ERROR(visitor->HandleUDiv(down_cast<BinOp*>(this)));
-      break;
-    case Op::kUGe:
-      XLS_RETURN_IF_ERROR(visitor->HandleUGe(down_cast<CompareOp*>(this)));
-      break;
-    case Op::kUGt:
-      XLS_RETURN_IF_ERROR(visitor->HandleUGt(down_cast<CompareOp*>(this)));
-      break;
-    case Op::kULe:
-      XLS_RETURN_IF_ERROR(visitor->HandleULe(down_cast<CompareOp*>(this)));
-      break;
-    case Op::kULt:
-      XLS_RETURN_IF_ERROR(visitor->HandleULt(down_cast<CompareOp*>(this)));
-      break;
-    case Op::kUMod:
-      XLS_RETURN_IF_ERROR(visitor->HandleUMod(down_cast<BinOp*>(this)));
-      break;
-    case Op::kUMul:
-      XLS_RETURN_IF_ERROR(visitor->HandleUMul(down_cast<ArithOp*>(this)));
-      break;
-    case Op::kXor:
-      XLS_RETURN_IF_ERROR(visitor->HandleNaryXor(down_cast<NaryOp*>(this)));
-      break;
-    case Op::kXorReduce:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleXorReduce(down_cast<BitwiseReductionOp*>(this)));
-      break;
-    case Op::kSignExt:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleSignExtend(down_cast<ExtendOp*>(this)));
-      break;
-    case Op::kZeroExt:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleZeroExtend(down_cast<ExtendOp*>(this)));
-      break;
-    case Op::kInputPort:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleInputPort(down_cast<InputPort*>(this)));
-      break;
-    case Op::kOutputPort:
-      XLS_RETURN_IF_ERROR(
-          visitor->HandleOutputPort(down_cast<OutputPort*>(this)));
-      break;
-    case Op::kGate:
-      XLS_RETURN_IF_ERROR(visitor->HandleGate(down_cast<Gate*>(this)));
-      break;
-    case Op::kInstantiationInput:
-      XLS_RETURN_IF_ERROR(visitor->HandleInstantiationInput(
-          down_cast<InstantiationInput*>(this)));
-      break;
-    case Op::kInstantiationOutput:
-      XLS_RETURN_IF_ERROR(visitor->HandleInstantiationOutput(
-          down_cast<InstantiationOutput*>(this)));
-      break;
+}  // namespace
+
+void Node::AddUser(Node* user) {
+  if (user_index_ != nullptr) {
+    // High-fanout mode: O(1) duplicate check and append. Sorted order is
+    // restored lazily by users().
+    if (user_index_->emplace(user, users_.size()).second) {
+      users_.push_back(user);
+      users_sorted_ = false;
+    }
+    return;
+  }
+  // users_ is kept sorted (by NodeIdLessThan) and duplicate-free.
+  auto it = std::lower_bound(users_.begin(), users_.end(), user,
+                             NodeIdLessThan());
+  if (it == users_.end() || *it != user) {
+    users_.insert(it, user);
+  }
+  if (users_.size() > kHighFanoutUserThreshold) {
+    user_index_ = std::make_unique<absl::flat_hash_map<Node*, int64_t>>();
+    user_index_->reserve(users_.size());
+    for (int64_t i = 0; i < static_cast<int64_t>(users_.size()); ++i) {
+      user_index_->emplace(users_[i], i);
+    }
   }
-  return absl::OkStatus();
+}
+
+void Node::RemoveUser(Node* user) {
+  if (user_index_ != nullptr) {
+    auto it = user_index_->find(user);
+    XLS_CHECK(it != user_index_->end());
+    int64_t index = it->second;
+    user_index_->erase(it);
+    // Swap the last element into the vacated slot; order is restored lazily
+    // by users().
+    if (index + 1 != static_cast<int64_t>(users_.size())) {
+      users_[index] = users_.back();
+      (*user_index_)[users_[index]] = index;
+      users_sorted_ = false;
+    }
+    users_.pop_back();
+    if (static_cast<int64_t>(users_.size()) < kHighFanoutUserThreshold / 2) {
+      // Fanout has shrunk well below the threshold; return to the plain
+      // sorted-vector representation.
+      user_index_.reset();
+      SortUsers();
+    }
+    return;
+  }
+  auto it = std::lower_bound(users_.begin(), users_.end(), user,
+                             NodeIdLessThan());
+  XLS_CHECK(it != users_.end() && *it == user);
+  users_.erase(it);
+}
+
+void Node::SortUsers() const {
+  std::sort(users_.begin(), users_.end(), NodeIdLessThan());
+  if (user_index_ != nullptr) {
+    for (int64_t i = 0; i < static_cast<int64_t>(users_.size()); ++i) {
+      (*user_index_)[users_[i]] = i;
+    }
+  }
+  users_sorted_ = true;
+}
+
+absl::Status Node::VisitSingleNode(DfsVisitor* visitor) {
+  // The table is generated from op_specification.py alongside the node
+  // classes; entry i dispatches to the visitor handler for the op with
+  // underlying value i.
+  return kVisitorDispatchTable[static_cast<int64_t>(op())](visitor, this);
 }
 
 absl::Status Node::Accept(DfsVisitor* visitor) {
@@ -356,6 +234,71 @@ bool Node::IsDefinitelyEqualTo(const Node* other) const {
   return same_type(this, other);
 }
 
+uint64_t Node::PayloadFingerprint() const { return 0; }
+
+absl::uint128 Node::StructuralFingerprint() const {
+  if (fingerprint_valid_) {
+    return fingerprint_;
+  }
+  // Compute fingerprints bottom-up with an explicit stack; cones can be deep
+  // enough to overflow the call stack if done recursively. A node is popped
+  // and hashed only once all of its operands have valid fingerprints.
+  std::vector<const Node*> stack = {this};
+  while (!stack.empty()) {
+    const Node* node = stack.back();
+    if (node->fingerprint_valid_) {
+      stack.pop_back();
+      continue;
+    }
+    bool operands_ready = true;
+    for (Node* operand : node->operands_) {
+      if (!operand->fingerprint_valid_) {
+        stack.push_back(operand);
+        operands_ready = false;
+      }
+    }
+    if (!operands_ready) {
+      continue;
+    }
+    stack.pop_back();
+    absl::InlinedVector<uint64_t, 8> values;
+    values.push_back(static_cast<uint64_t>(node->op_));
+    values.push_back(absl::Hash<const Type*>()(node->type_));
+    values.push_back(node->PayloadFingerprint());
+    for (Node* operand : node->operands_) {
+      values.push_back(absl::Uint128High64(operand->fingerprint_));
+      values.push_back(absl::Uint128Low64(operand->fingerprint_));
+    }
+    // Two independently seeded 64-bit hashes form the 128-bit fingerprint.
+    using HashInput = std::pair<uint64_t, absl::InlinedVector<uint64_t, 8>>;
+    auto hash_with_seed = [&values](uint64_t seed) {
+      return absl::Hash<HashInput>()({seed, values});
+    };
+    node->fingerprint_ =
+        absl::MakeUint128(hash_with_seed(1), hash_with_seed(2));
+    node->fingerprint_valid_ = true;
+  }
+  return fingerprint_;
+}
+
+void Node::InvalidateFingerprint() const {
+  if (!fingerprint_valid_) {
+    return;
+  }
+  std::vector<const Node*> worklist = {this};
+  while (!worklist.empty()) {
+    const Node* node = worklist.back();
+    worklist.pop_back();
+    if (!node->fingerprint_valid_) {
+      continue;
+    }
+    node->fingerprint_valid_ = false;
+    for (Node* user : node->users_) {
+      worklist.push_back(user);
+    }
+  }
+}
+
 std::string Node::GetName() const {
   if (!name_.empty()) {
     return name_;
@@ -616,13 +559,17 @@ std::string Node::GetOperandsString() const {
 
 std::string Node::GetUsersString() const {
   return absl::StrFormat(
-      "[%s]", absl::StrJoin(users_, ", ", [](std::string* out, const Node* n) {
+      "[%s]", absl::StrJoin(users(), ", ", [](std::string* out, const Node* n) {
         absl::StrAppend(out, n->GetName());
       }));
 }
 
 bool Node::HasUser(const Node* target) const {
-  return users_.contains(const_cast<Node*>(target));
+  if (user_index_ != nullptr) {
+    return user_index_->contains(const_cast<Node*>(target));
+  }
+  return std::binary_search(users_.begin(), users_.end(),
+                            const_cast<Node*>(target), NodeIdLessThan());
 }
 
 bool Node::IsDead() const {
@@ -650,15 +597,18 @@ int64_t Node::OperandInstanceCount(const Node* target) const {
 }
 
 void Node::SetId(int64_t id) {
-  // The data structure (btree) containing the users of each node is sorted by
-  // node id. To avoid violating invariants of the data structure, remove this
-  // node from all users lists, change id, then read to users list.
+  // The users list of each node is sorted by node id. To avoid violating
+  // invariants of the data structure, remove this node from all users lists,
+  // change id, then re-add to users list.
   for (Node* operand : operands()) {
-    operand->users_.erase(this);
+    // Remove-if-present as an operand may appear more than once.
+    if (operand->HasUser(this)) {
+      operand->RemoveUser(this);
+    }
   }
   id_ = id;
   for (Node* operand : operands()) {
-    operand->users_.insert(this);
+    operand->AddUser(this);  // AddUser is idempotent.
   }
   package()->set_next_node_id(std::max(id + 1, package()->next_node_id()));
 }
@@ -676,6 +626,8 @@ bool Node::ReplaceOperand(Node* old_operand, Node* new_operand) {
   if (this == new_operand) {
     return true;
   }
+  function_base()->InvalidateTopoOrderCache();
+  InvalidateFingerprint();
   bool did_replace = false;
   for (int64_t i = 0; i < operand_count(); ++i) {
     if (operands_[i] == old_operand) {
@@ -684,6 +636,7 @@ bool Node::ReplaceOperand(Node* old_operand, Node* new_operand) {
         new_operand->AddUser(this);
       }
       did_replace = true;
+      function_base()->RecordOperandChanged(this, i, old_operand);
       operands_[i] = new_operand;
     }
   }
@@ -702,7 +655,10 @@ absl::Status Node::ReplaceOperandNumber(int64_t operand_no, Node* new_operand,
 
   // AddUser is idempotent so even if the new operand is already used by this
   // node in another operand slot, it is safe to call.
+  function_base()->InvalidateTopoOrderCache();
+  InvalidateFingerprint();
   new_operand->AddUser(this);
+  function_base()->RecordOperandChanged(this, operand_no, old_operand);
   operands_[operand_no] = new_operand;
 
   for (Node* operand : operands()) {
@@ -715,6 +671,14 @@ absl::Status Node::ReplaceOperandNumber(int64_t operand_no, Node* new_operand,
   return absl::OkStatus();
 }
 
+void Node::SwapOperands(int64_t a, int64_t b) {
+  // Operand/user chains already set up properly.
+  function_base()->RecordOperandChanged(this, a, operands_[a]);
+  function_base()->RecordOperandChanged(this, b, operands_[b]);
+  std::swap(operands_[a], operands_[b]);
+  InvalidateFingerprint();
+}
+
 absl::Status Node::ReplaceUsesWith(Node* replacement) {
   XLS_RET_CHECK(replacement != nullptr);
   XLS_RET_CHECK(GetType() == replacement->GetType())
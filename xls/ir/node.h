@@ -15,13 +15,18 @@
 #ifndef XLS_IR_NODE_H_
 #define XLS_IR_NODE_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <list>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
-#include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/numeric/int128.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
@@ -51,6 +56,14 @@ class Node {
  public:
   virtual ~Node() = default;
 
+  // Nodes draw their storage from the thread-local current NodeArena (if one
+  // is established via NodeArena::Scope) so nodes of a function are laid out
+  // contiguously in creation order. Allocations made outside any arena scope
+  // fall back to the global heap. Deleting an arena-backed node runs the
+  // destructor only; the storage is reclaimed in bulk when the arena dies.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr);
+
   // Accepts the visitor, instructing it to visit this node.
   //
   // The visitor is instructed to visit this node with:
@@ -120,10 +133,23 @@ class Node {
   absl::StatusOr<bool> ReplaceImplicitUsesWith(Node* replacement);
 
   // Swaps the operands at indices 'a' and 'b' in the operands sequence.
-  void SwapOperands(int64_t a, int64_t b) {
-    // Operand/user chains already set up properly.
-    std::swap(operands_[a], operands_[b]);
-  }
+  void SwapOperands(int64_t a, int64_t b);
+
+  // Returns a 128-bit structural fingerprint of the expression cone rooted at
+  // this node, hashed from (op, type, operand fingerprints, payload). Nodes
+  // with equal fingerprints root structurally identical cones -- identical
+  // modulo node ids and names -- with negligible probability of collision.
+  // The fingerprint is cached on the node and invalidated (transitively
+  // through users) when the cone is mutated, so repeated queries by analyses
+  // such as CSE bucketing or translation caches are cheap. Fingerprints hash
+  // interned Type pointers and are therefore only meaningful within the
+  // current process.
+  absl::uint128 StructuralFingerprint() const;
+
+  // Hash of this node's non-operand payload (e.g. a literal's value or a bit
+  // slice's start and width). Generated subclasses with data members override
+  // this in concert with IsDefinitelyEqualTo.
+  virtual uint64_t PayloadFingerprint() const;
 
   // Returns true if analysis indicates that this node always produces the
   // same value as 'other' when run with the same operands. The analysis is
@@ -197,7 +223,12 @@ class Node {
   };
 
   // Returns the unique set of users of this node sorted by id.
-  const absl::btree_set<Node*, NodeIdLessThan>& users() const { return users_; }
+  absl::Span<Node* const> users() const {
+    if (!users_sorted_) {
+      SortUsers();
+    }
+    return users_;
+  }
 
   // Helper for querying whether "target" is a user of this node.
   bool HasUser(const Node* target) const;
@@ -276,6 +307,17 @@ class Node {
   void AddUser(Node* user);
   void RemoveUser(Node* user);
 
+  // Drops the cached structural fingerprint of this node and, transitively,
+  // of its users. Called whenever an operand edge of this node changes.
+  // Propagation stops at nodes which are already invalid since their users
+  // are invalid as well (fingerprints are only ever validated bottom-up).
+  void InvalidateFingerprint() const;
+
+  // Restores the sorted-by-id order of users_ (and the positions recorded in
+  // user_index_, if present). Called lazily from users() after unordered
+  // mutations on high-fanout nodes.
+  void SortUsers() const;
+
   FunctionBase* function_base_;
   int64_t id_;
   Op op_;
@@ -283,10 +325,44 @@ class Node {
   absl::optional<SourceLocation> loc_;
   std::string name_;
 
-  std::vector<Node*> operands_;
+  // The vast majority of nodes have three or fewer operands, so a few slots
+  // of inline storage avoids a separate heap allocation (and an extra cache
+  // miss per node during traversal) in the common case.
+  absl::InlinedVector<Node*, 3> operands_;
 
-  // Set of users sorted by node_id for stability.
-  absl::btree_set<Node*, NodeIdLessThan> users_;
+  // Unique set of users, kept sorted by node id for stable iteration order.
+  // Maintained as a sorted inlined vector rather than a tree so small fanouts
+  // (the common case) stay inline with the node.
+  //
+  // Once the fanout exceeds kHighFanoutUserThreshold, sorted insertion and
+  // removal become a bottleneck (e.g. clock enables with tens of thousands of
+  // users make ReplaceUsesWith quadratic), so a side index from user to its
+  // position in users_ is built and mutations become O(1) amortized: adds
+  // append and removals swap with the back. users_ may then be temporarily out
+  // of order; users() re-sorts it lazily (see users_sorted_) so iteration
+  // order observed by callers is unchanged. Mutable to permit that lazy sort
+  // from the const accessor.
+  mutable absl::InlinedVector<Node*, 4> users_;
+
+  // Maps each user to its position in users_. Non-null only for high-fanout
+  // nodes; dropped again (with a re-sort) when the fanout shrinks well below
+  // the threshold. When null, users_ is always sorted.
+  mutable std::unique_ptr<absl::flat_hash_map<Node*, int64_t>> user_index_;
+
+  // False when users_ is possibly out of sorted order (only ever the case
+  // while user_index_ is non-null).
+  mutable bool users_sorted_ = true;
+
+  // Cached structural fingerprint, valid only when fingerprint_valid_ is set.
+  // Mutable so the lazy computation in StructuralFingerprint() (and the
+  // invalidation walk) can run from const accessors.
+  mutable absl::uint128 fingerprint_ = 0;
+  mutable bool fingerprint_valid_ = false;
+
+  // Position of this node in its function's node list, maintained by
+  // FunctionBase when the node is added. Storing the link intrusively makes
+  // node removal O(1) without a side map from node to list position.
+  std::list<std::unique_ptr<Node>>::iterator function_list_entry_;
 };
 
 inline std::ostream& operator<<(std::ostream& os, const Node& node) {
@@ -0,0 +1,62 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/node_arena.h"
+
+#include <algorithm>
+
+#include "xls/common/logging/logging.h"
+
+namespace xls {
+
+thread_local NodeArena* NodeArena::current_ = nullptr;
+
+void* NodeArena::Allocate(size_t size, size_t alignment) {
+  XLS_CHECK_NE(size, 0);
+  XLS_CHECK((alignment & (alignment - 1)) == 0)
+      << "Alignment must be a power of two: " << alignment;
+  if (slabs_.empty()) {
+    NewSlab(std::max(size + alignment, slab_size_));
+  }
+  Slab& slab = slabs_.back();
+  size_t aligned_offset = (offset_ + alignment - 1) & ~(alignment - 1);
+  if (aligned_offset + size > slab.size) {
+    NewSlab(std::max(size + alignment, slab_size_));
+    aligned_offset =
+        (offset_ + alignment - 1) & ~(alignment - 1);
+  }
+  void* result = slabs_.back().data.get() + aligned_offset;
+  offset_ = aligned_offset + size;
+  allocated_bytes_ += size;
+  return result;
+}
+
+bool NodeArena::Contains(const void* ptr) const {
+  const uint8_t* p = static_cast<const uint8_t*>(ptr);
+  for (const Slab& slab : slabs_) {
+    if (p >= slab.data.get() && p < slab.data.get() + slab.size) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void NodeArena::NewSlab(size_t min_size) {
+  size_t size = std::max(min_size, slab_size_);
+  slabs_.push_back(Slab{std::make_unique<uint8_t[]>(size), size});
+  offset_ = 0;
+  reserved_bytes_ += size;
+}
+
+}  // namespace xls
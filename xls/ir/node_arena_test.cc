@@ -0,0 +1,69 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/node_arena.h"
+
+#include <cstdint>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace xls {
+namespace {
+
+TEST(NodeArenaTest, AllocationsAreContiguousAndAligned) {
+  NodeArena arena;
+  uint8_t* first = static_cast<uint8_t*>(arena.Allocate(64, 16));
+  uint8_t* second = static_cast<uint8_t*>(arena.Allocate(64, 16));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % 16, 0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % 16, 0);
+  EXPECT_EQ(second, first + 64);
+  EXPECT_TRUE(arena.Contains(first));
+  EXPECT_TRUE(arena.Contains(second));
+  EXPECT_EQ(arena.allocated_bytes(), 128);
+}
+
+TEST(NodeArenaTest, OversizedAllocationGetsDedicatedSlab) {
+  NodeArena arena(/*slab_size=*/1024);
+  void* small = arena.Allocate(16, 8);
+  void* big = arena.Allocate(64 * 1024, 8);
+  EXPECT_TRUE(arena.Contains(small));
+  EXPECT_TRUE(arena.Contains(big));
+  EXPECT_GE(arena.reserved_bytes(), 64 * 1024 + 1024);
+}
+
+TEST(NodeArenaTest, ScopeSetsAndRestoresCurrent) {
+  EXPECT_EQ(NodeArena::current(), nullptr);
+  NodeArena outer_arena;
+  {
+    NodeArena::Scope outer(&outer_arena);
+    EXPECT_EQ(NodeArena::current(), &outer_arena);
+    NodeArena inner_arena;
+    {
+      NodeArena::Scope inner(&inner_arena);
+      EXPECT_EQ(NodeArena::current(), &inner_arena);
+    }
+    EXPECT_EQ(NodeArena::current(), &outer_arena);
+  }
+  EXPECT_EQ(NodeArena::current(), nullptr);
+}
+
+TEST(NodeArenaTest, ContainsRejectsForeignPointers) {
+  NodeArena arena;
+  int on_stack;
+  EXPECT_FALSE(arena.Contains(&on_stack));
+}
+
+}  // namespace
+}  // namespace xls
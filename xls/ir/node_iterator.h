@@ -15,6 +15,9 @@
 #ifndef XLS_IR_NODE_ITERATOR_H_
 #define XLS_IR_NODE_ITERATOR_H_
 
+#include <memory>
+#include <vector>
+
 #include "xls/ir/function_base.h"
 #include "xls/ir/node.h"
 
@@ -23,25 +26,46 @@ namespace xls {
 // A type that orders the reachable nodes in a function into a usable traversal
 // order. Currently just does a stable topological ordering.
 //
+// The computed forward order is cached on the FunctionBase and reused by
+// subsequent traversals until the graph is restructured (nodes added or
+// removed, or operand edges changed), so consecutive passes which do not
+// modify the function pay for the sort only once. The order held by a
+// NodeIterator is a snapshot: mutating the function mid-traversal invalidates
+// the function's cache but not the order being iterated.
+//
 // Note that this container value must outlive any iterators derived from it
 // (via begin()/end()).
 class NodeIterator {
  public:
   static NodeIterator Create(FunctionBase* f) {
     NodeIterator it(f);
+    if (f->topo_order_cache() != nullptr) {
+      it.ordered_ = f->topo_order_cache();
+      return it;
+    }
     it.Initialize();
     std::reverse(it.ordered_->begin(), it.ordered_->end());
+    f->SetTopoOrderCache(it.ordered_);
     return it;
   }
 
   static NodeIterator CreateReverse(FunctionBase* f) {
     NodeIterator it(f);
+    if (f->topo_order_cache() != nullptr) {
+      it.ordered_ = std::make_shared<std::vector<Node*>>(
+          f->topo_order_cache()->rbegin(), f->topo_order_cache()->rend());
+      return it;
+    }
     it.Initialize();
+    f->SetTopoOrderCache(std::make_shared<std::vector<Node*>>(
+        it.ordered_->rbegin(), it.ordered_->rend()));
     return it;
   }
 
-  std::vector<Node*>::iterator begin() { return ordered_->begin(); }
-  std::vector<Node*>::iterator end() { return ordered_->end(); }
+  std::vector<Node*>::const_iterator begin() const {
+    return ordered_->begin();
+  }
+  std::vector<Node*>::const_iterator end() const { return ordered_->end(); }
 
   const std::vector<Node*>& AsVector() const { return *ordered_; }
 
@@ -50,10 +74,10 @@ class NodeIterator {
 
   void Initialize();
 
-  // The vector of nodes is wrapped in a unique_ptr so that the
-  // NodeIterator may be movable but the iterators returned to the
-  // caller of begin()/end() are not invalidated by those moves.
-  std::unique_ptr<std::vector<Node*>> ordered_;
+  // The vector of nodes is held by shared_ptr so the NodeIterator is movable
+  // without invalidating iterators returned from begin()/end(), and so the
+  // order can be shared with the FunctionBase cache.
+  std::shared_ptr<std::vector<Node*>> ordered_;
   FunctionBase* f_;
 };
 
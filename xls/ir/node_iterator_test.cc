@@ -267,5 +267,32 @@ TEST(NodeIteratorTest, RpoVsTopo) {
   EXPECT_EQ(rni.end(), it);
 }
 
+TEST(NodeIteratorTest, OrderIsCachedUntilGraphChanges) {
+  std::string program = R"(
+  fn computation(a: bits[32]) -> bits[32] {
+    b: bits[32] = neg(a)
+    ret c: bits[32] = neg(b)
+  })";
+
+  Package p("p");
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, Parser::ParseFunction(program, &p));
+
+  EXPECT_EQ(f->topo_order_cache(), nullptr);
+  NodeIterator first = TopoSort(f);
+  ASSERT_NE(f->topo_order_cache(), nullptr);
+
+  // A second sort of the unchanged function reuses the cached order.
+  NodeIterator second = TopoSort(f);
+  EXPECT_EQ(&first.AsVector(), &second.AsVector());
+
+  // Restructuring the graph drops the cache; the next sort recomputes.
+  XLS_ASSERT_OK_AND_ASSIGN(Node * b, f->GetNode("b"));
+  XLS_ASSERT_OK_AND_ASSIGN(Node * a, f->GetNode("a"));
+  XLS_ASSERT_OK(b->ReplaceUsesWith(a));
+  EXPECT_EQ(f->topo_order_cache(), nullptr);
+  NodeIterator third = TopoSort(f);
+  EXPECT_NE(&first.AsVector(), &third.AsVector());
+}
+
 }  // namespace
 }  // namespace xls
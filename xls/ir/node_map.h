@@ -0,0 +1,119 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_IR_NODE_MAP_H_
+#define XLS_IR_NODE_MAP_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "xls/common/logging/logging.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
+#include "xls/ir/package.h"
+
+namespace xls {
+
+// A map from Node* to T backed by a flat vector indexed by Node::id(). Node
+// ids are densely allocated by the package so a lookup is a single indexed
+// load with no hashing. Intended for per-node side tables in analyses which
+// touch most nodes of a function; for maps holding only a few nodes
+// absl::flat_hash_map may use less memory.
+//
+// Node ids are not reused after node deletion so the index space can become
+// sparse after heavy IR rewriting. Package::CompactNodeIds() renumbers nodes
+// densely and can be called before building side tables over a
+// much-transformed package.
+template <typename T>
+class NodeMap {
+ public:
+  NodeMap() = default;
+
+  // Presizes the table to cover every node currently in f's package.
+  explicit NodeMap(FunctionBase* f) { Reserve(f); }
+
+  // Presizes the table to cover every node currently in f's package. Avoids
+  // repeated growth when the map is populated node by node.
+  void Reserve(FunctionBase* f) {
+    int64_t capacity = f->package()->next_node_id();
+    if (capacity > static_cast<int64_t>(values_.size())) {
+      values_.resize(capacity);
+      present_.resize(capacity);
+    }
+  }
+
+  // Returns the value for the given node, default-constructing (and
+  // inserting) it if not present. Mirrors the semantics of
+  // absl::flat_hash_map::operator[].
+  T& operator[](const Node* node) {
+    Grow(node->id());
+    if (!present_[node->id()]) {
+      present_[node->id()] = true;
+      ++size_;
+    }
+    return values_[node->id()];
+  }
+
+  // Returns the value for the given node which must be present.
+  const T& at(const Node* node) const {
+    XLS_CHECK(contains(node)) << node->GetName();
+    return values_[node->id()];
+  }
+  T& at(const Node* node) {
+    XLS_CHECK(contains(node)) << node->GetName();
+    return values_[node->id()];
+  }
+
+  bool contains(const Node* node) const {
+    return node->id() < static_cast<int64_t>(present_.size()) &&
+           present_[node->id()];
+  }
+
+  // Removes the entry for the given node if present.
+  void erase(const Node* node) {
+    if (contains(node)) {
+      values_[node->id()] = T();
+      present_[node->id()] = false;
+      --size_;
+    }
+  }
+
+  void clear() {
+    values_.clear();
+    present_.clear();
+    size_ = 0;
+  }
+
+  // Returns the number of present entries.
+  int64_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  void Grow(int64_t id) {
+    if (id >= static_cast<int64_t>(values_.size())) {
+      values_.resize(id + 1);
+      present_.resize(id + 1);
+    }
+  }
+
+  std::vector<T> values_;
+  // Deliberately not vector<bool>: byte loads/stores are cheaper than bit
+  // manipulation on the hot lookup path.
+  std::vector<uint8_t> present_;
+  int64_t size_ = 0;
+};
+
+}  // namespace xls
+
+#endif  // XLS_IR_NODE_MAP_H_
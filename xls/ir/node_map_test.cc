@@ -0,0 +1,106 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/node_map.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+
+namespace xls {
+namespace {
+
+class NodeMapTest : public IrTestBase {
+ protected:
+  absl::StatusOr<Function*> BuildAddFunction(Package* package) {
+    FunctionBuilder fb("add_func", package);
+    BValue x = fb.Param("x", package->GetBitsType(32));
+    BValue y = fb.Param("y", package->GetBitsType(32));
+    fb.Add(x, y);
+    return fb.Build();
+  }
+};
+
+TEST_F(NodeMapTest, BasicOperations) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BuildAddFunction(package.get()));
+
+  NodeMap<int64_t> map(f);
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.size(), 0);
+
+  int64_t i = 0;
+  for (Node* node : f->nodes()) {
+    EXPECT_FALSE(map.contains(node));
+    map[node] = i++;
+    EXPECT_TRUE(map.contains(node));
+  }
+  EXPECT_EQ(map.size(), f->node_count());
+
+  i = 0;
+  for (Node* node : f->nodes()) {
+    EXPECT_EQ(map.at(node), i++);
+  }
+
+  Node* first = *f->nodes().begin();
+  map.erase(first);
+  EXPECT_FALSE(map.contains(first));
+  EXPECT_EQ(map.size(), f->node_count() - 1);
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+}
+
+TEST_F(NodeMapTest, OperatorBracketDefaultConstructs) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BuildAddFunction(package.get()));
+
+  NodeMap<std::vector<int64_t>> map;
+  Node* node = f->return_value();
+  EXPECT_FALSE(map.contains(node));
+  map[node].push_back(42);
+  EXPECT_TRUE(map.contains(node));
+  EXPECT_EQ(map.at(node).size(), 1);
+}
+
+TEST_F(NodeMapTest, CompactNodeIds) {
+  auto package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BuildAddFunction(package.get()));
+
+  // Delete the function result and rebuild it to leave a gap in the id space.
+  Node* old_sum = f->return_value();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Node * new_sum,
+      old_sum->Clone({old_sum->operand(0), old_sum->operand(1)}));
+  XLS_ASSERT_OK(f->set_return_value(new_sum));
+  XLS_ASSERT_OK(f->RemoveNode(old_sum));
+
+  package->CompactNodeIds();
+
+  // Ids must be dense starting at one and next_node_id must directly follow
+  // the largest id.
+  int64_t max_id = 0;
+  for (Node* node : f->nodes()) {
+    EXPECT_GE(node->id(), 1);
+    EXPECT_LE(node->id(), f->node_count());
+    max_id = std::max(max_id, node->id());
+  }
+  EXPECT_EQ(max_id, f->node_count());
+  EXPECT_EQ(package->next_node_id(), max_id + 1);
+}
+
+}  // namespace
+}  // namespace xls
@@ -14,6 +14,8 @@
 
 #include "xls/ir/node.h"
 
+#include <algorithm>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "xls/common/status/matchers.h"
@@ -368,6 +370,58 @@ fn ReplaceUses(x: bits[8], y: bits[8]) -> bits[8] {
   EXPECT_TRUE(FindNode("and.1", f)->users().empty());
 }
 
+TEST_F(NodeTest, BatchReplaceUses) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn BatchReplaceUses(x: bits[8], y: bits[8]) -> bits[8] {
+  and.1: bits[8] = and(x, y)
+  or.2: bits[8] = or(and.1, y)
+  literal.4: bits[8] = literal(value=123)
+  literal.5: bits[8] = literal(value=42)
+  ret add.3: bits[8] = add(or.2, and.1)
+}
+)",
+                                                       p.get()));
+  // Replace and.1 with literal.4 and (chained) literal.4 with literal.5 in a
+  // single batch; all uses of and.1 end up on literal.5.
+  XLS_ASSERT_OK(
+      f->ReplaceUsesWith({{FindNode("and.1", f), FindNode("literal.4", f)},
+                          {FindNode("literal.4", f), FindNode("literal.5", f)}}));
+  EXPECT_THAT(FindNode("literal.5", f)->users(),
+              UnorderedElementsAre(FindNode("or.2", f), FindNode("add.3", f)));
+  EXPECT_TRUE(FindNode("and.1", f)->users().empty());
+  EXPECT_TRUE(FindNode("literal.4", f)->users().empty());
+}
+
+TEST_F(NodeTest, BatchReplaceUsesReturnValue) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn BatchReplaceUses(x: bits[8], y: bits[8]) -> bits[8] {
+  and.1: bits[8] = and(x, y)
+  ret and.2: bits[8] = and(y, x)
+}
+)",
+                                                       p.get()));
+  EXPECT_EQ(FindNode("and.2", f), f->return_value());
+  XLS_ASSERT_OK(
+      f->ReplaceUsesWith({{FindNode("and.2", f), FindNode("and.1", f)}}));
+  EXPECT_EQ(FindNode("and.1", f), f->return_value());
+}
+
+TEST_F(NodeTest, BatchReplaceUsesWrongType) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn BatchReplaceUses(x: bits[8], y: bits[8]) -> bits[16] {
+  and.1: bits[8] = and(x, y)
+  ret concat.2: bits[16] = concat(x, y)
+}
+)",
+                                                       p.get()));
+  EXPECT_THAT(
+      f->ReplaceUsesWith({{FindNode("concat.2", f), FindNode("and.1", f)}}),
+      StatusIs(absl::StatusCode::kInternal));
+}
+
 TEST_F(NodeTest, ReplaceUsesReturnValue) {
   auto p = CreatePackage();
   XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
@@ -471,6 +525,41 @@ TEST_F(NodeTest, NodeNames) {
   EXPECT_TRUE(f->return_value()->HasAssignedName());
 }
 
+TEST_F(NodeTest, HighFanoutUserBookkeeping) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(8));
+  // Enough users to push the node into the hash-indexed user representation.
+  std::vector<BValue> nots;
+  for (int64_t i = 0; i < 200; ++i) {
+    nots.push_back(fb.Not(x));
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.BuildWithReturnValue(nots.back()));
+
+  Node* x_node = x.node();
+  EXPECT_EQ(x_node->users().size(), 200);
+  EXPECT_TRUE(std::is_sorted(x_node->users().begin(), x_node->users().end(),
+                             Node::NodeIdLessThan()));
+  for (const BValue& n : nots) {
+    EXPECT_TRUE(x_node->HasUser(n.node()));
+  }
+
+  // Removing most of the users drops the node back to the small sorted-vector
+  // representation.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Node * zero,
+      f->MakeNode<Literal>(/*loc=*/absl::nullopt, Value(UBits(0, 8))));
+  for (int64_t i = 0; i + 1 < static_cast<int64_t>(nots.size()); ++i) {
+    EXPECT_TRUE(nots[i].node()->ReplaceOperand(x_node, zero));
+    EXPECT_FALSE(x_node->HasUser(nots[i].node()));
+  }
+  EXPECT_EQ(x_node->users().size(), 1);
+  EXPECT_TRUE(x_node->HasUser(nots.back().node()));
+  EXPECT_EQ(zero->users().size(), 199);
+  EXPECT_TRUE(std::is_sorted(zero->users().begin(), zero->users().end(),
+                             Node::NodeIdLessThan()));
+}
+
 TEST_F(NodeTest, IsDead) {
   auto p = CreatePackage();
   XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
@@ -486,5 +575,73 @@ fn ReplaceUses(x: bits[8], y: bits[8]) -> bits[8] {
   EXPECT_TRUE(FindNode("y", f)->IsDead());
 }
 
+TEST_F(NodeTest, StructuralFingerprint) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn fingerprints(x: bits[8], y: bits[8]) -> bits[8] {
+  a: bits[8] = add(x, y)
+  na: bits[8] = not(a)
+  b: bits[8] = add(x, y)
+  nb: bits[8] = not(b)
+  lit_one: bits[8] = literal(value=1)
+  lit_two: bits[8] = literal(value=2)
+  ret result: bits[8] = or(na, nb, lit_one, lit_two)
+}
+)",
+                                                       p.get()));
+  // Structurally identical cones have equal fingerprints; the node ids and
+  // names differ.
+  EXPECT_EQ(FindNode("na", f)->StructuralFingerprint(),
+            FindNode("nb", f)->StructuralFingerprint());
+  EXPECT_EQ(FindNode("x", f)->StructuralFingerprint(),
+            FindNode("y", f)->StructuralFingerprint());
+  // Different payloads produce different fingerprints.
+  EXPECT_NE(FindNode("lit_one", f)->StructuralFingerprint(),
+            FindNode("lit_two", f)->StructuralFingerprint());
+  EXPECT_NE(FindNode("a", f)->StructuralFingerprint(),
+            FindNode("na", f)->StructuralFingerprint());
+}
+
+TEST_F(NodeTest, StructuralFingerprintInvalidation) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn fingerprints(x: bits[8], y: bits[8]) -> bits[8] {
+  a: bits[8] = add(x, y)
+  b: bits[8] = add(x, x)
+  ret na: bits[8] = not(a)
+}
+)",
+                                                       p.get()));
+  Node* a = FindNode("a", f);
+  Node* b = FindNode("b", f);
+  Node* na = FindNode("na", f);
+  EXPECT_NE(a->StructuralFingerprint(), b->StructuralFingerprint());
+  absl::uint128 na_before = na->StructuralFingerprint();
+  // Rewriting a's operand changes the cones rooted at both a and its user na.
+  XLS_ASSERT_OK(a->ReplaceOperandNumber(1, FindNode("x", f)));
+  EXPECT_EQ(a->StructuralFingerprint(), b->StructuralFingerprint());
+  EXPECT_NE(na->StructuralFingerprint(), na_before);
+}
+
+TEST_F(NodeTest, StructurallyIdenticalCones) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+fn cones(x: bits[8], y: bits[8]) -> bits[8] {
+  a: bits[8] = add(x, y)
+  b: bits[8] = add(x, y)
+  ret c: bits[8] = not(a)
+}
+)",
+                                                       p.get()));
+  std::vector<std::vector<Node*>> groups = p->StructurallyIdenticalCones();
+  ASSERT_EQ(groups.size(), 2);
+  // Groups are ordered by first appearance: the two parameters, then the two
+  // structurally identical adds.
+  EXPECT_THAT(groups[0], UnorderedElementsAre(FindNode("x", f),
+                                              FindNode("y", f)));
+  EXPECT_THAT(groups[1], UnorderedElementsAre(FindNode("a", f),
+                                              FindNode("b", f)));
+}
+
 }  // namespace
 }  // namespace xls
@@ -14,7 +14,10 @@
 
 #include "xls/ir/node_util.h"
 
+#include <deque>
+
 #include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "xls/common/logging/logging.h"
@@ -178,4 +181,39 @@ absl::StatusOr<Channel*> GetChannelUsedByNode(Node* node) {
   return node->package()->GetChannel(channel_id);
 }
 
+absl::StatusOr<int64_t> RemoveDeadNodes(FunctionBase* f) {
+  auto is_deletable = [](Node* n) {
+    return !n->function_base()->HasImplicitUse(n) &&
+           !OpIsSideEffecting(n->op());
+  };
+
+  std::deque<Node*> worklist;
+  for (Node* n : f->nodes()) {
+    if (n->users().empty() && is_deletable(n)) {
+      worklist.push_back(n);
+    }
+  }
+  int64_t removed_count = 0;
+  absl::flat_hash_set<Node*> unique_operands;
+  while (!worklist.empty()) {
+    Node* node = worklist.front();
+    worklist.pop_front();
+
+    // A node may appear more than once as an operand of 'node'. Keep track of
+    // which operands have been handled in a set.
+    unique_operands.clear();
+    for (Node* operand : node->operands()) {
+      if (unique_operands.insert(operand).second) {
+        if (operand->users().size() == 1 && is_deletable(operand)) {
+          worklist.push_back(operand);
+        }
+      }
+    }
+    XLS_VLOG(3) << "DCE removing " << node->ToString();
+    XLS_RETURN_IF_ERROR(f->RemoveNode(node));
+    removed_count++;
+  }
+  return removed_count;
+}
+
 }  // namespace xls
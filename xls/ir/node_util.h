@@ -144,6 +144,15 @@ bool IsChannelNode(Node* node);
 // send/sendif/receive/receiveif node then an error is returned.
 absl::StatusOr<Channel*> GetChannelUsedByNode(Node* node);
 
+// Removes all dead nodes from the function: nodes without users or implicit
+// uses which are not side-effecting, including producers which become dead
+// once their users are removed. Uses a work list seeded from zero-user nodes
+// which follows operand edges transitively, so the entire dead fanin is
+// removed in a single invocation. Returns the number of nodes removed. Cheap
+// enough for passes which create large amounts of dead code (e.g. inlining,
+// unrolling) to invoke inline to keep the graph small mid-pipeline.
+absl::StatusOr<int64_t> RemoveDeadNodes(FunctionBase* f);
+
 }  // namespace xls
 
 #endif  // XLS_IR_NODE_UTIL_H_
@@ -386,14 +386,20 @@ class Op(object):
    name: The name of the op as it appears in textual IR (e.g., 'param').
    op_class: The OpClass value indicating the C++ Node subclass of the op.
    properties: A List of Properties describing the op.
+   visitor_method: The name of the DfsVisitor method handling the op.
+     Defaults to 'Handle' followed by the enum name without its 'k' prefix
+     (e.g., 'HandleParam'); ops whose handler deviates from this pattern
+     (e.g., 'kAnd' -> 'HandleNaryAnd') pass the name explicitly.
   """
 
   def __init__(self, enum_name: str, name: str, op_class: OpClass,
-               properties: List[Property]):
+               properties: List[Property],
+               visitor_method: Optional[str] = None):
     self.enum_name = enum_name
     self.name = name
     self.op_class = op_class
     self.properties = properties
+    self.visitor_method = visitor_method or 'Handle' + enum_name[1:]
 
 # pyformat: disable
 OpClass.kinds['AFTER_ALL'] = OpClass(
@@ -987,6 +993,7 @@ OPS = [
         enum_name='kAnd',
         name='and',
         op_class=OpClass.kinds['NARY_OP'],
+        visitor_method='HandleNaryAnd',
         properties=[Property.BITWISE,
                     Property.ASSOCIATIVE,
                     Property.COMMUTATIVE],
@@ -1025,6 +1032,7 @@ OPS = [
         enum_name='kNand',
         name='nand',
         op_class=OpClass.kinds['NARY_OP'],
+        visitor_method='HandleNaryNand',
         # Note: not associative, because of the inversion.
         properties=[Property.BITWISE,
                     Property.COMMUTATIVE],
@@ -1033,6 +1041,7 @@ OPS = [
         enum_name='kNor',
         name='nor',
         op_class=OpClass.kinds['NARY_OP'],
+        visitor_method='HandleNaryNor',
         # Note: not associative, because of the inversion.
         properties=[Property.BITWISE,
                     Property.COMMUTATIVE],
@@ -1194,6 +1203,7 @@ OPS = [
         enum_name='kOr',
         name='or',
         op_class=OpClass.kinds['NARY_OP'],
+        visitor_method='HandleNaryOr',
         properties=[Property.BITWISE,
                     Property.ASSOCIATIVE,
                     Property.COMMUTATIVE],
@@ -1298,6 +1308,7 @@ OPS = [
         enum_name='kSignExt',
         name='sign_ext',
         op_class=OpClass.kinds['EXTEND_OP'],
+        visitor_method='HandleSignExtend',
         properties=[],
     ),
     Op(
@@ -1384,6 +1395,7 @@ OPS = [
         enum_name='kXor',
         name='xor',
         op_class=OpClass.kinds['NARY_OP'],
+        visitor_method='HandleNaryXor',
         properties=[Property.BITWISE,
                     Property.ASSOCIATIVE,
                     Property.COMMUTATIVE],
@@ -1398,6 +1410,7 @@ OPS = [
         enum_name='kZeroExt',
         name='zero_ext',
         op_class=OpClass.kinds['EXTEND_OP'],
+        visitor_method='HandleZeroExtend',
         properties=[],
     ),
     Op(
@@ -14,14 +14,19 @@
 
 #include "xls/ir/package.h"
 
+#include <ostream>
+#include <sstream>
 #include <utility>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/numeric/int128.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/strong_int.h"
+#include "xls/data_structures/leaf_type_tree.h"
 #include "xls/ir/block.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/function.h"
@@ -38,6 +43,7 @@ constexpr char kMain[] = "main";
 Package::Package(absl::string_view name,
                  absl::optional<absl::string_view> entry)
     : entry_(entry), name_(name) {
+  absl::MutexLock lock(&intern_mutex_);
   owned_types_.insert(&token_type_);
 }
 
@@ -118,6 +124,50 @@ std::vector<FunctionBase*> Package::GetFunctionBases() const {
   return result;
 }
 
+std::vector<std::vector<Node*>> Package::StructurallyIdenticalCones() const {
+  std::vector<std::vector<Node*>> groups;
+  absl::flat_hash_map<absl::uint128, int64_t> group_index;
+  for (FunctionBase* function_base : GetFunctionBases()) {
+    for (Node* node : function_base->nodes()) {
+      absl::uint128 fingerprint = node->StructuralFingerprint();
+      auto [it, inserted] = group_index.insert(
+          {fingerprint, static_cast<int64_t>(groups.size())});
+      if (inserted) {
+        groups.emplace_back();
+      }
+      groups[it->second].push_back(node);
+    }
+  }
+  // Keep only the groups with actual duplication.
+  std::vector<std::vector<Node*>> result;
+  for (std::vector<Node*>& group : groups) {
+    if (group.size() > 1) {
+      result.push_back(std::move(group));
+    }
+  }
+  return result;
+}
+
+void Package::CompactNodeIds() {
+  // Renumbering is done in two passes to avoid transient id collisions: user
+  // lists are sorted by id and SetId assumes the new id is not already held
+  // by another user of the same operand. First shift every id above the
+  // current maximum, then assign the final dense ids.
+  int64_t offset = next_node_id();
+  for (FunctionBase* function_base : GetFunctionBases()) {
+    for (Node* node : function_base->nodes()) {
+      node->SetId(node->id() + offset);
+    }
+  }
+  int64_t next_id = 1;
+  for (FunctionBase* function_base : GetFunctionBases()) {
+    for (Node* node : function_base->nodes()) {
+      node->SetId(next_id++);
+    }
+  }
+  set_next_node_id(next_id);
+}
+
 absl::Status Package::RemoveFunction(Function* function) {
   auto it = std::remove_if(
       functions_.begin(), functions_.end(),
@@ -261,6 +311,7 @@ absl::StatusOr<Type*> Package::MapTypeFromOtherPackage(
 }
 
 BitsType* Package::GetBitsType(int64_t bit_count) {
+  absl::MutexLock lock(&intern_mutex_);
   if (bit_count_to_type_.find(bit_count) != bit_count_to_type_.end()) {
     return &bit_count_to_type_.at(bit_count);
   }
@@ -271,11 +322,12 @@ BitsType* Package::GetBitsType(int64_t bit_count) {
 }
 
 ArrayType* Package::GetArrayType(int64_t size, Type* element_type) {
+  absl::MutexLock lock(&intern_mutex_);
   ArrayKey key{size, element_type};
   if (array_types_.find(key) != array_types_.end()) {
     return &array_types_.at(key);
   }
-  XLS_CHECK(IsOwnedType(element_type))
+  XLS_CHECK(IsOwnedTypeLocked(element_type))
       << "Type is not owned by package: " << *element_type;
   auto it = array_types_.emplace(key, ArrayType(size, element_type));
   ArrayType* new_type = &(it.first->second);
@@ -284,12 +336,13 @@ ArrayType* Package::GetArrayType(int64_t size, Type* element_type) {
 }
 
 TupleType* Package::GetTupleType(absl::Span<Type* const> element_types) {
+  absl::MutexLock lock(&intern_mutex_);
   TypeVec key(element_types.begin(), element_types.end());
   if (tuple_types_.find(key) != tuple_types_.end()) {
     return &tuple_types_.at(key);
   }
   for (const Type* element_type : element_types) {
-    XLS_CHECK(IsOwnedType(element_type))
+    XLS_CHECK(IsOwnedTypeLocked(element_type))
         << "Type is not owned by package: " << *element_type;
   }
   auto it = tuple_types_.emplace(key, TupleType(element_types));
@@ -302,12 +355,13 @@ TokenType* Package::GetTokenType() { return &token_type_; }
 
 FunctionType* Package::GetFunctionType(absl::Span<Type* const> args_types,
                                        Type* return_type) {
+  absl::MutexLock lock(&intern_mutex_);
   std::string key = FunctionType(args_types, return_type).ToString();
   if (function_types_.find(key) != function_types_.end()) {
     return &function_types_.at(key);
   }
   for (Type* t : args_types) {
-    XLS_CHECK(IsOwnedType(t))
+    XLS_CHECK(IsOwnedTypeLocked(t))
         << "Parameter type is not owned by package: " << t->ToString();
   }
   auto it = function_types_.emplace(key, FunctionType(args_types, return_type));
@@ -316,6 +370,15 @@ FunctionType* Package::GetFunctionType(absl::Span<Type* const> args_types,
   return new_type;
 }
 
+const LeafTypeShape* Package::GetLeafTypeShape(Type* type) {
+  absl::MutexLock lock(&intern_mutex_);
+  std::unique_ptr<LeafTypeShape>& shape = leaf_type_shapes_[type];
+  if (shape == nullptr) {
+    shape = std::make_unique<LeafTypeShape>(type);
+  }
+  return shape.get();
+}
+
 absl::StatusOr<Type*> Package::GetTypeFromProto(const TypeProto& proto) {
   if (!proto.has_type_enum()) {
     return absl::InvalidArgumentError("Missing type_enum field in TypeProto.");
@@ -397,6 +460,11 @@ Type* Package::GetTypeForValue(const Value& value) {
   XLS_LOG(FATAL) << "Invalid value for type extraction.";
 }
 
+const Value* Package::InternValue(const Value& value) {
+  absl::MutexLock lock(&intern_mutex_);
+  return &*interned_values_.insert(value).first;
+}
+
 Fileno Package::GetOrCreateFileno(absl::string_view filename) {
   // Attempt to add a new fileno/filename pair to the map.
   auto this_fileno = Fileno(filename_to_fileno_.size());
@@ -433,30 +501,34 @@ bool Package::IsDefinitelyEqualTo(const Package* other) const {
 }
 
 std::string Package::DumpIr() const {
-  std::string out;
-  absl::StrAppend(&out, "package ", name(), "\n\n");
+  std::ostringstream os;
+  DumpIrTo(os);
+  return os.str();
+}
+
+void Package::DumpIrTo(std::ostream& os) const {
+  os << "package " << name() << "\n\n";
   if (!channels().empty()) {
     for (Channel* channel : channels()) {
-      absl::StrAppend(&out, channel->ToString(), "\n");
+      os << channel->ToString() << "\n";
     }
-    absl::StrAppend(&out, "\n");
-  }
-  std::vector<std::string> function_dumps;
-  for (auto& function : functions()) {
-    function_dumps.push_back(function->DumpIr());
-  }
-  for (auto& proc : procs()) {
-    function_dumps.push_back(proc->DumpIr());
-  }
-  for (auto& block : blocks()) {
-    function_dumps.push_back(block->DumpIr());
+    os << "\n";
+  }
+  // Stream each FunctionBase directly rather than collecting per-function
+  // strings and joining them, which would transiently hold two copies of the
+  // entire dump.
+  bool first = true;
+  for (FunctionBase* function_base : GetFunctionBases()) {
+    if (!first) {
+      os << "\n";
+    }
+    first = false;
+    function_base->DumpIrTo(os);
   }
-  absl::StrAppend(&out, absl::StrJoin(function_dumps, "\n"));
-  return out;
 }
 
 std::ostream& operator<<(std::ostream& os, const Package& package) {
-  os << package.DumpIr();
+  package.DumpIrTo(os);
   return os;
 }
 
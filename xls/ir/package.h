@@ -15,17 +15,22 @@
 #ifndef XLS_IR_PACKAGE_H_
 #define XLS_IR_PACKAGE_H_
 
+#include <atomic>
 #include <cstdint>
+#include <iosfwd>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/container/node_hash_map.h"
+#include "absl/container/node_hash_set.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/channel.pb.h"
 #include "xls/ir/channel_ops.h"
@@ -40,6 +45,7 @@ class Block;
 class Channel;
 class Function;
 class FunctionBase;
+class LeafTypeShape;
 class Proc;
 class SingleValueChannel;
 class StreamingChannel;
@@ -58,9 +64,11 @@ class Package {
 
   // Returns whether the given type is one of the types owned by this package.
   bool IsOwnedType(const Type* type) {
-    return owned_types_.find(type) != owned_types_.end();
+    absl::MutexLock lock(&intern_mutex_);
+    return IsOwnedTypeLocked(type);
   }
   bool IsOwnedFunctionType(const FunctionType* function_type) {
+    absl::MutexLock lock(&intern_mutex_);
     return owned_function_types_.find(function_type) !=
            owned_function_types_.end();
   }
@@ -72,6 +80,13 @@ class Package {
   FunctionType* GetFunctionType(absl::Span<Type* const> args_types,
                                 Type* return_type);
 
+  // Returns the shared LeafTypeTree shape descriptor for the given type,
+  // constructing and caching it on first use. One descriptor exists per
+  // distinct type, so analyses which keep a LeafTypeTree per node can share
+  // the type-shape metadata rather than rebuilding it per tree. The returned
+  // pointer is stable for the lifetime of the package.
+  const LeafTypeShape* GetLeafTypeShape(Type* type);
+
   // Returns a pointer to a type owned by this package that is of the same
   // type as 'other_package_type', which may be owned by another package.
   absl::StatusOr<Type*> MapTypeFromOtherPackage(Type* other_package_type);
@@ -83,6 +98,13 @@ class Package {
 
   Type* GetTypeForValue(const Value& value);
 
+  // Returns a pointer to a package-owned copy of the given value. Calls with
+  // structurally identical values return the same pointer, so constants which
+  // appear many times in the IR (e.g. wide literals replicated by unrolling)
+  // can share a single payload. The returned pointer is stable for the
+  // lifetime of the package.
+  const Value* InternValue(const Value& value);
+
   // Add a function, proc, or block to the package. Ownership is tranferred to
   // the package.
   Function* AddFunction(std::unique_ptr<Function> f);
@@ -131,8 +153,11 @@ class Package {
   std::string SourceLocationToString(const SourceLocation loc);
 
   // Retrieves the next node ID to assign to a node in the package and
-  // increments the next node counter. For use in node construction.
-  int64_t GetNextNodeId() { return next_node_id_++; }
+  // increments the next node counter. For use in node construction. Atomic so
+  // nodes may be created from concurrently optimized functions.
+  int64_t GetNextNodeId() {
+    return next_node_id_.fetch_add(1, std::memory_order_relaxed);
+  }
 
   // Adds a file to the file-number table and returns its corresponding number.
   // If it already exists, returns the existing file-number entry.
@@ -165,6 +190,13 @@ class Package {
   // TODO(meheff): Consider holding functions and procs in a common vector.
   std::vector<FunctionBase*> GetFunctionBases() const;
 
+  // Groups the nodes of the package by structural fingerprint (see
+  // Node::StructuralFingerprint) and returns the groups containing two or
+  // more nodes: each group roots a set of structurally identical expression
+  // cones, possibly spanning different functions. Groups and their members
+  // are ordered deterministically by first appearance.
+  std::vector<std::vector<Node*>> StructurallyIdenticalCones() const;
+
   const std::string& name() const { return name_; }
 
   // Returns true if analysis indicates that this package always produces the
@@ -175,15 +207,31 @@ class Package {
   // Dumps the IR in a parsable text format.
   std::string DumpIr() const;
 
+  // As DumpIr but streams the text to `os` without materializing the entire
+  // dump in memory. Prefer this form for large packages.
+  void DumpIrTo(std::ostream& os) const;
+
   std::vector<std::string> GetFunctionNames() const;
 
   // Returns whether this package contains a function with the "target" name.
   bool HasFunctionWithName(absl::string_view target) const;
 
-  int64_t next_node_id() const { return next_node_id_; }
+  int64_t next_node_id() const {
+    return next_node_id_.load(std::memory_order_relaxed);
+  }
 
   // Intended for use by the parser when node ids are suggested by the IR text.
-  void set_next_node_id(int64_t value) { next_node_id_ = value; }
+  void set_next_node_id(int64_t value) {
+    next_node_id_.store(value, std::memory_order_relaxed);
+  }
+
+  // Renumbers the nodes of the package with dense ids starting at one. Node
+  // ids are not reused after node deletion so the id space can become sparse
+  // after heavy IR rewriting; compaction keeps id-indexed side tables
+  // (NodeMap) small. The generated names of nodes without assigned names
+  // (e.g., "add.42") change as they are derived from the id. Must not be
+  // called while node ids are held elsewhere (e.g., in a live NodeMap).
+  void CompactNodeIds();
 
   // Create a channel. Channels are used with send/receive nodes in communicate
   // between procs or between procs and external (to XLS) components. If no
@@ -231,43 +279,70 @@ class Package {
   // to the functions themselves.
   absl::flat_hash_map<std::string, Function*> GetFunctionByName();
 
+  // As IsOwnedType but the caller must hold intern_mutex_.
+  bool IsOwnedTypeLocked(const Type* type) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(intern_mutex_) {
+    return owned_types_.find(type) != owned_types_.end();
+  }
+
   // Name of this package.
   std::string name_;
 
-  // Ordinal to assign to the next node created in this package.
-  int64_t next_node_id_ = 1;
+  // Ordinal to assign to the next node created in this package. Atomic so node
+  // creation is safe from concurrently optimized functions.
+  std::atomic<int64_t> next_node_id_{1};
 
   std::vector<std::unique_ptr<Function>> functions_;
   std::vector<std::unique_ptr<Proc>> procs_;
   std::vector<std::unique_ptr<Block>> blocks_;
 
+  // Guards the type- and value-interning pools below. Types and values may be
+  // interned from concurrently optimized functions when function-local passes
+  // run in parallel (see PassOptions::parallel_function_base_passes); all
+  // other package-level mutations remain single-threaded.
+  mutable absl::Mutex intern_mutex_;
+
   // Set of owned types in this package.
-  absl::flat_hash_set<const Type*> owned_types_;
+  absl::flat_hash_set<const Type*> owned_types_ ABSL_GUARDED_BY(intern_mutex_);
 
   // Set of owned function types in this package.
-  absl::flat_hash_set<const FunctionType*> owned_function_types_;
+  absl::flat_hash_set<const FunctionType*> owned_function_types_
+      ABSL_GUARDED_BY(intern_mutex_);
 
   // Mapping from bit count to the owned "bits" type with that many bits. Use
   // node_hash_map for pointer stability.
-  absl::node_hash_map<int64_t, BitsType> bit_count_to_type_;
+  absl::node_hash_map<int64_t, BitsType> bit_count_to_type_
+      ABSL_GUARDED_BY(intern_mutex_);
 
   // Mapping from the size and element type of an array type to the owned
   // ArrayType. Use node_hash_map for pointer stability.
   using ArrayKey = std::pair<int64_t, const Type*>;
-  absl::node_hash_map<ArrayKey, ArrayType> array_types_;
+  absl::node_hash_map<ArrayKey, ArrayType> array_types_
+      ABSL_GUARDED_BY(intern_mutex_);
 
   // Mapping from elements to the owned tuple type.
   //
   // Uses node_hash_map for pointer stability.
   using TypeVec = absl::InlinedVector<const Type*, 4>;
-  absl::node_hash_map<TypeVec, TupleType> tuple_types_;
+  absl::node_hash_map<TypeVec, TupleType> tuple_types_
+      ABSL_GUARDED_BY(intern_mutex_);
 
   // Owned token type.
   TokenType token_type_;
 
   // Mapping from Type:ToString to the owned function type. Use
   // node_hash_map for pointer stability.
-  absl::node_hash_map<std::string, FunctionType> function_types_;
+  absl::node_hash_map<std::string, FunctionType> function_types_
+      ABSL_GUARDED_BY(intern_mutex_);
+
+  // Pool of interned values (see InternValue). Use node_hash_set for pointer
+  // stability.
+  absl::node_hash_set<Value> interned_values_ ABSL_GUARDED_BY(intern_mutex_);
+
+  // Cached LeafTypeTree shape descriptors, one per distinct type (see
+  // GetLeafTypeShape).
+  absl::flat_hash_map<const Type*, std::unique_ptr<LeafTypeShape>>
+      leaf_type_shapes_ ABSL_GUARDED_BY(intern_mutex_);
 
   // Mapping of Fileno ids to string filenames, and vice-versa for reverse
   // lookups. These two data structures must be updated together for consistency
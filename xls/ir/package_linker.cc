@@ -0,0 +1,126 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "xls/ir/package_linker.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+
+namespace xls {
+namespace {
+
+// Appends 'function' and the functions it calls (via invoke, map or
+// counted_for) to 'post_order', callees first, so callers are always linked
+// after the definitions they reference.
+void PostOrderCallees(Function* function,
+                      absl::flat_hash_set<Function*>* visited,
+                      std::vector<Function*>* post_order) {
+  if (!visited->insert(function).second) {
+    return;
+  }
+  for (Node* node : function->nodes()) {
+    switch (node->op()) {
+      case Op::kCountedFor:
+        PostOrderCallees(node->As<CountedFor>()->body(), visited, post_order);
+        break;
+      case Op::kInvoke:
+        PostOrderCallees(node->As<Invoke>()->to_apply(), visited, post_order);
+        break;
+      case Op::kMap:
+        PostOrderCallees(node->As<Map>()->to_apply(), visited, post_order);
+        break;
+      default:
+        break;
+    }
+  }
+  post_order->push_back(function);
+}
+
+bool HasFunctionNamed(Package* package, absl::string_view name) {
+  return package->GetFunction(name).ok();
+}
+
+// Returns 'name', suffixed if necessary to not collide with any function in
+// 'package'.
+std::string UniquifyFunctionName(Package* package, absl::string_view name) {
+  if (!HasFunctionNamed(package, name)) {
+    return std::string(name);
+  }
+  for (int64_t i = 1;; ++i) {
+    std::string candidate = absl::StrCat(name, "_", i);
+    if (!HasFunctionNamed(package, candidate)) {
+      return candidate;
+    }
+  }
+}
+
+}  // namespace
+
+absl::StatusOr<absl::flat_hash_map<const Function*, Function*>> LinkPackages(
+    Package* destination, absl::Span<Package* const> sources) {
+  absl::flat_hash_map<const Function*, Function*> resolved;
+  for (Package* source : sources) {
+    XLS_RET_CHECK_NE(source, destination)
+        << "Cannot link a package into itself.";
+
+    absl::flat_hash_set<Function*> visited;
+    std::vector<Function*> post_order;
+    for (const std::unique_ptr<Function>& function : source->functions()) {
+      PostOrderCallees(function.get(), &visited, &post_order);
+    }
+
+    for (Function* function : post_order) {
+      if (resolved.contains(function)) {
+        continue;
+      }
+      Function* existing = nullptr;
+      if (HasFunctionNamed(destination, function->name())) {
+        XLS_ASSIGN_OR_RETURN(existing,
+                             destination->GetFunction(function->name()));
+      }
+      // On collision the clone is created under a name qualified by its
+      // source package; if it turns out to be a duplicate of the existing
+      // definition it is dropped again below.
+      std::string link_name =
+          existing == nullptr
+              ? std::string(function->name())
+              : UniquifyFunctionName(
+                    destination,
+                    absl::StrCat(source->name(), "__", function->name()));
+      XLS_ASSIGN_OR_RETURN(
+          Function * linked,
+          function->Clone(link_name, destination, /*call_remapping=*/resolved));
+      if (existing != nullptr && existing->IsDefinitelyEqualTo(linked)) {
+        XLS_VLOG(2) << absl::StrCat("Deduplicating linked function ",
+                                    function->name(), " from package ",
+                                    source->name());
+        XLS_RETURN_IF_ERROR(destination->RemoveFunction(linked));
+        linked = existing;
+      }
+      resolved[function] = linked;
+    }
+  }
+  return resolved;
+}
+
+}  // namespace xls
@@ -0,0 +1,48 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_IR_PACKAGE_LINKER_H_
+#define XLS_IR_PACKAGE_LINKER_H_
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/ir/function.h"
+#include "xls/ir/package.h"
+
+namespace xls {
+
+// Links the functions of each package in 'sources' into 'destination',
+// producing a single whole-program package from separately converted
+// libraries. Once linked, the ordinary optimization pipeline sees all
+// cross-library call sites and can inline or specialize through them.
+//
+// Cloning interns types (and literal payloads) into the destination's type
+// tables, so structurally identical types from different packages unify to a
+// single Type*. Symbols are resolved by name and structure: a source function
+// whose name is already taken in the destination is deduplicated onto the
+// existing function when the two are structurally equivalent
+// (IsDefinitelyEqualTo) and otherwise linked under a fresh name qualified by
+// its source package. Call sites (invoke, map, counted_for) in later-linked
+// functions are remapped to the resolved definitions.
+//
+// Returns a map from each source function to the destination function it
+// resolved to. The source packages are not modified. Procs and blocks are not
+// linked.
+absl::StatusOr<absl::flat_hash_map<const Function*, Function*>> LinkPackages(
+    Package* destination, absl::Span<Package* const> sources);
+
+}  // namespace xls
+
+#endif  // XLS_IR_PACKAGE_LINKER_H_
@@ -0,0 +1,124 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/package_linker.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/nodes.h"
+
+namespace xls {
+namespace {
+
+class PackageLinkerTest : public IrTestBase {};
+
+TEST_F(PackageLinkerTest, LinksFunctionsAndUnifiesTypes) {
+  Package p1("p1");
+  FunctionBuilder fb1("util", &p1);
+  BValue x = fb1.Param("x", p1.GetBitsType(32));
+  fb1.Add(x, x);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * util, fb1.Build());
+
+  Package p2("p2");
+  FunctionBuilder fb2("scale", &p2);
+  BValue y = fb2.Param("y", p2.GetBitsType(32));
+  fb2.UMul(y, y);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * scale, fb2.Build());
+
+  Package linked("linked");
+  XLS_ASSERT_OK_AND_ASSIGN(auto resolved, LinkPackages(&linked, {&p1, &p2}));
+  EXPECT_EQ(linked.functions().size(), 2);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * linked_util, linked.GetFunction("util"));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * linked_scale,
+                           linked.GetFunction("scale"));
+  EXPECT_EQ(resolved.at(util), linked_util);
+  EXPECT_EQ(resolved.at(scale), linked_scale);
+  // The cloned functions' types are interned into the destination's tables.
+  EXPECT_EQ(linked_util->return_value()->GetType(), linked.GetBitsType(32));
+  EXPECT_EQ(linked_scale->return_value()->GetType(), linked.GetBitsType(32));
+}
+
+TEST_F(PackageLinkerTest, DeduplicatesIdenticalFunctions) {
+  auto make_library = [](Package* p) -> absl::StatusOr<Function*> {
+    FunctionBuilder fb("helper", p);
+    BValue x = fb.Param("x", p->GetBitsType(16));
+    fb.Not(x);
+    return fb.Build();
+  };
+  Package p1("p1");
+  XLS_ASSERT_OK_AND_ASSIGN(Function * helper1, make_library(&p1));
+  Package p2("p2");
+  XLS_ASSERT_OK_AND_ASSIGN(Function * helper2, make_library(&p2));
+  FunctionBuilder fb("caller", &p2);
+  BValue y = fb.Param("y", p2.GetBitsType(16));
+  fb.Invoke({y}, helper2);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * caller, fb.Build());
+
+  Package linked("linked");
+  XLS_ASSERT_OK_AND_ASSIGN(auto resolved, LinkPackages(&linked, {&p1, &p2}));
+  // The two structurally identical helpers resolve to a single definition
+  // which the linked caller invokes.
+  EXPECT_EQ(linked.functions().size(), 2);
+  EXPECT_EQ(resolved.at(helper1), resolved.at(helper2));
+  Invoke* invoke = nullptr;
+  for (Node* node : resolved.at(caller)->nodes()) {
+    if (node->Is<Invoke>()) {
+      invoke = node->As<Invoke>();
+    }
+  }
+  ASSERT_NE(invoke, nullptr);
+  EXPECT_EQ(invoke->to_apply(), resolved.at(helper1));
+}
+
+TEST_F(PackageLinkerTest, RenamesConflictingFunctions) {
+  Package p1("p1");
+  FunctionBuilder fb1("helper", &p1);
+  BValue x = fb1.Param("x", p1.GetBitsType(16));
+  fb1.Add(x, x);
+  XLS_ASSERT_OK(fb1.Build().status());
+
+  Package p2("p2");
+  FunctionBuilder fb2("helper", &p2);
+  BValue y = fb2.Param("y", p2.GetBitsType(16));
+  fb2.Not(y);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * helper2, fb2.Build());
+  FunctionBuilder fb3("caller", &p2);
+  BValue z = fb3.Param("z", p2.GetBitsType(16));
+  fb3.Invoke({z}, helper2);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * caller, fb3.Build());
+
+  Package linked("linked");
+  XLS_ASSERT_OK_AND_ASSIGN(auto resolved, LinkPackages(&linked, {&p1, &p2}));
+  // p2's conflicting helper is linked under a package-qualified name and the
+  // linked caller is remapped to it.
+  EXPECT_EQ(linked.functions().size(), 3);
+  XLS_ASSERT_OK(linked.GetFunction("helper").status());
+  XLS_ASSERT_OK_AND_ASSIGN(Function * renamed,
+                           linked.GetFunction("p2__helper"));
+  EXPECT_EQ(resolved.at(helper2), renamed);
+  Invoke* invoke = nullptr;
+  for (Node* node : resolved.at(caller)->nodes()) {
+    if (node->Is<Invoke>()) {
+      invoke = node->As<Invoke>();
+    }
+  }
+  ASSERT_NE(invoke, nullptr);
+  EXPECT_EQ(invoke->to_apply(), renamed);
+}
+
+}  // namespace
+}  // namespace xls
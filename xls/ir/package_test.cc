@@ -375,5 +375,26 @@ TEST_F(PackageTest, ChannelRemoval) {
                        HasSubstr("cannot be removed because it is used")));
 }
 
+TEST_F(PackageTest, InternValue) {
+  Package p(TestName());
+
+  const Value* forty_two = p.InternValue(Value(UBits(42, 1000)));
+  EXPECT_EQ(*forty_two, Value(UBits(42, 1000)));
+
+  // Identical values yield the same pointer, distinct values do not. A value
+  // of the same bits but different width is a distinct value.
+  EXPECT_EQ(p.InternValue(Value(UBits(42, 1000))), forty_two);
+  EXPECT_NE(p.InternValue(Value(UBits(43, 1000))), forty_two);
+  EXPECT_NE(p.InternValue(Value(UBits(42, 999))), forty_two);
+
+  // Aggregate values are interned structurally.
+  Value tuple = Value::Tuple({Value(UBits(1, 8)), Value::Tuple({})});
+  const Value* interned_tuple = p.InternValue(tuple);
+  EXPECT_EQ(p.InternValue(Value::Tuple({Value(UBits(1, 8)), Value::Tuple({})})),
+            interned_tuple);
+  EXPECT_NE(p.InternValue(Value::Tuple({Value(UBits(2, 8)), Value::Tuple({})})),
+            interned_tuple);
+}
+
 }  // namespace
 }  // namespace xls
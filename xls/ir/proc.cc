@@ -14,6 +14,9 @@
 
 #include "xls/ir/proc.h"
 
+#include <ostream>
+#include <sstream>
+
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "xls/ir/channel.h"
@@ -25,7 +28,13 @@
 namespace xls {
 
 std::string Proc::DumpIr() const {
-  std::string res = absl::StrFormat(
+  std::ostringstream os;
+  DumpIrTo(os);
+  return os.str();
+}
+
+void Proc::DumpIrTo(std::ostream& os) const {
+  os << absl::StrFormat(
       "proc %s(%s: %s, %s: %s, init=%s) {\n", name(), TokenParam()->GetName(),
       TokenParam()->GetType()->ToString(), StateParam()->GetName(),
       StateParam()->GetType()->ToString(), InitValue().ToHumanString());
@@ -34,13 +43,12 @@ std::string Proc::DumpIr() const {
     if (node->op() == Op::kParam) {
       continue;
     }
-    absl::StrAppend(&res, "  ", node->ToString(), "\n");
+    os << "  " << node->ToString() << "\n";
   }
-  absl::StrAppend(&res, "  next (", NextToken()->GetName(), ", ",
-                  NextState()->GetName(), ")\n");
+  os << "  next (" << NextToken()->GetName() << ", " << NextState()->GetName()
+     << ")\n";
 
-  absl::StrAppend(&res, "}\n");
-  return res;
+  os << "}\n";
 }
 
 absl::Status Proc::SetNextToken(Node* next) {
@@ -49,6 +57,7 @@ absl::Status Proc::SetNextToken(Node* next) {
         "Cannot set next token to \"%s\", expected token type but has type %s",
         next->GetName(), next->GetType()->ToString()));
   }
+  RecordImplicitUseChanged(/*slot=*/0, next_token_);
   next_token_ = next;
   return absl::OkStatus();
 }
@@ -60,6 +69,7 @@ absl::Status Proc::SetNextState(Node* next) {
         "proc state type %s",
         next->GetName(), next->GetType()->ToString(), StateType()->ToString()));
   }
+  RecordImplicitUseChanged(/*slot=*/1, next_state_);
   next_state_ = next;
   return absl::OkStatus();
 }
@@ -77,6 +77,12 @@ class Proc : public FunctionBase {
   }
 
   std::string DumpIr() const override;
+  void DumpIrTo(std::ostream& os) const override;
+
+ protected:
+  absl::Status RestoreImplicitUse(int64_t slot, Node* old_value) override {
+    return slot == 0 ? SetNextToken(old_value) : SetNextState(old_value);
+  }
 
  private:
   Value init_value_;
@@ -0,0 +1,147 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/proc_firing_order.h"
+
+#include <algorithm>
+
+#include "absl/container/flat_hash_map.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+
+namespace xls {
+namespace {
+
+// Returns the successor lists of the inter-proc channel graph: succs[i]
+// contains j iff proc i sends on a channel which proc j receives on.
+std::vector<std::vector<int64_t>> ChannelGraphSuccessors(Package* package) {
+  absl::flat_hash_map<int64_t, std::vector<int64_t>> channel_senders;
+  absl::flat_hash_map<int64_t, std::vector<int64_t>> channel_receivers;
+  for (int64_t i = 0; i < package->procs().size(); ++i) {
+    for (Node* node : package->procs()[i]->nodes()) {
+      if (node->Is<Send>()) {
+        channel_senders[node->As<Send>()->channel_id()].push_back(i);
+      } else if (node->Is<Receive>()) {
+        channel_receivers[node->As<Receive>()->channel_id()].push_back(i);
+      }
+    }
+  }
+
+  std::vector<std::vector<int64_t>> succs(package->procs().size());
+  for (const auto& [channel_id, senders] : channel_senders) {
+    auto it = channel_receivers.find(channel_id);
+    if (it == channel_receivers.end()) {
+      // Channel communicates with the outside world.
+      continue;
+    }
+    for (int64_t sender : senders) {
+      for (int64_t receiver : it->second) {
+        succs[sender].push_back(receiver);
+      }
+    }
+  }
+  return succs;
+}
+
+}  // namespace
+
+std::vector<std::vector<Proc*>> ComputeProcFiringOrder(Package* package) {
+  const int64_t proc_count = package->procs().size();
+  std::vector<std::vector<int64_t>> succs = ChannelGraphSuccessors(package);
+
+  // Iterative Tarjan SCC. Tarjan emits each component only after every
+  // component reachable from it, i.e. in reverse topological order of the
+  // condensation, so reversing the emission order yields the firing order.
+  std::vector<int64_t> index(proc_count, -1);
+  std::vector<int64_t> lowlink(proc_count, 0);
+  std::vector<bool> on_stack(proc_count, false);
+  std::vector<int64_t> stack;
+  std::vector<std::vector<int64_t>> components;
+  int64_t next_index = 0;
+
+  struct Frame {
+    int64_t node;
+    int64_t next_child;
+  };
+  std::vector<Frame> frames;
+  for (int64_t root = 0; root < proc_count; ++root) {
+    if (index[root] != -1) {
+      continue;
+    }
+    index[root] = lowlink[root] = next_index++;
+    stack.push_back(root);
+    on_stack[root] = true;
+    frames.push_back(Frame{root, 0});
+    while (!frames.empty()) {
+      Frame& frame = frames.back();
+      if (frame.next_child < succs[frame.node].size()) {
+        int64_t child = succs[frame.node][frame.next_child++];
+        if (index[child] == -1) {
+          index[child] = lowlink[child] = next_index++;
+          stack.push_back(child);
+          on_stack[child] = true;
+          frames.push_back(Frame{child, 0});
+        } else if (on_stack[child]) {
+          lowlink[frame.node] = std::min(lowlink[frame.node], index[child]);
+        }
+        continue;
+      }
+      int64_t node = frame.node;
+      if (lowlink[node] == index[node]) {
+        std::vector<int64_t> component;
+        while (true) {
+          int64_t member = stack.back();
+          stack.pop_back();
+          on_stack[member] = false;
+          component.push_back(member);
+          if (member == node) {
+            break;
+          }
+        }
+        // Package order within a component for determinism.
+        std::sort(component.begin(), component.end());
+        components.push_back(std::move(component));
+      }
+      frames.pop_back();
+      if (!frames.empty()) {
+        lowlink[frames.back().node] =
+            std::min(lowlink[frames.back().node], lowlink[node]);
+      }
+    }
+  }
+  std::reverse(components.begin(), components.end());
+
+  std::vector<std::vector<Proc*>> result;
+  result.reserve(components.size());
+  for (const std::vector<int64_t>& component : components) {
+    std::vector<Proc*> group;
+    group.reserve(component.size());
+    for (int64_t proc_index : component) {
+      group.push_back(package->procs()[proc_index].get());
+    }
+    result.push_back(std::move(group));
+  }
+  return result;
+}
+
+std::vector<Proc*> ComputeFlatProcFiringOrder(Package* package) {
+  std::vector<Proc*> result;
+  result.reserve(package->procs().size());
+  for (const std::vector<Proc*>& group : ComputeProcFiringOrder(package)) {
+    result.insert(result.end(), group.begin(), group.end());
+  }
+  return result;
+}
+
+}  // namespace xls
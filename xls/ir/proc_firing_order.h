@@ -0,0 +1,44 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_IR_PROC_FIRING_ORDER_H_
+#define XLS_IR_PROC_FIRING_ORDER_H_
+
+#include <vector>
+
+#include "xls/ir/package.h"
+#include "xls/ir/proc.h"
+
+namespace xls {
+
+// Computes a static firing schedule for the procs of the package from the
+// inter-proc channel graph (an edge runs from the proc sending on a channel
+// to the proc receiving on it; channels communicating with the outside world
+// contribute no edges). The result groups the procs into the strongly
+// connected components of that graph, in topological order: every proc which
+// feeds data into a group appears in an earlier group. For feed-forward
+// networks every group is a singleton, so executing the procs in the returned
+// order completes a tick with each proc running exactly once; only groups
+// with more than one proc (feedback cycles) can require re-execution within a
+// tick. Procs within a group appear in package order so the result is
+// deterministic.
+std::vector<std::vector<Proc*>> ComputeProcFiringOrder(Package* package);
+
+// Flattened form of ComputeProcFiringOrder: the procs of the package in
+// firing order with groups concatenated.
+std::vector<Proc*> ComputeFlatProcFiringOrder(Package* package);
+
+}  // namespace xls
+
+#endif  // XLS_IR_PROC_FIRING_ORDER_H_
@@ -0,0 +1,126 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/proc_firing_order.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/channel.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/package.h"
+
+namespace xls {
+namespace {
+
+using ::testing::ElementsAre;
+
+class ProcFiringOrderTest : public IrTestBase {
+ protected:
+  // Creates a proc which receives a value from "in" and forwards it to "out".
+  // Either channel may be nullptr in which case the respective operation is
+  // omitted (the proc state is sent/forwarded instead).
+  absl::StatusOr<Proc*> CreateProc(absl::string_view name, Channel* in,
+                                   Channel* out, Package* package) {
+    ProcBuilder pb(name, /*init_value=*/Value(UBits(0, 32)),
+                   /*token_name=*/"tok", /*state_name=*/"st", package);
+    BValue token = pb.GetTokenParam();
+    BValue data = pb.GetStateParam();
+    if (in != nullptr) {
+      BValue receive = pb.Receive(in, token);
+      token = pb.TupleIndex(receive, 0);
+      data = pb.TupleIndex(receive, 1);
+    }
+    if (out != nullptr) {
+      token = pb.Send(out, token, data);
+    }
+    return pb.Build(token, data);
+  }
+};
+
+TEST_F(ProcFiringOrderTest, FeedForwardChainIsTopological) {
+  auto p = CreatePackage();
+  Type* u32 = p->GetBitsType(32);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * a_to_b,
+      p->CreateStreamingChannel("a_to_b", ChannelOps::kSendReceive, u32));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * b_to_c,
+      p->CreateStreamingChannel("b_to_c", ChannelOps::kSendReceive, u32));
+
+  // Create the procs in an order other than the firing order.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Proc * c, CreateProc("c", b_to_c, /*out=*/nullptr, p.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Proc * a, CreateProc("a", /*in=*/nullptr, a_to_b, p.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * b, CreateProc("b", a_to_b, b_to_c, p.get()));
+
+  EXPECT_THAT(ComputeProcFiringOrder(p.get()),
+              ElementsAre(ElementsAre(a), ElementsAre(b), ElementsAre(c)));
+  EXPECT_THAT(ComputeFlatProcFiringOrder(p.get()), ElementsAre(a, b, c));
+}
+
+TEST_F(ProcFiringOrderTest, FeedbackCycleFormsSingleGroup) {
+  auto p = CreatePackage();
+  Type* u32 = p->GetBitsType(32);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * src_to_x,
+      p->CreateStreamingChannel("src_to_x", ChannelOps::kSendReceive, u32));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * x_to_y,
+      p->CreateStreamingChannel("x_to_y", ChannelOps::kSendReceive, u32));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * y_to_x,
+      p->CreateStreamingChannel("y_to_x", ChannelOps::kSendReceive, u32));
+
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * y, CreateProc("y", x_to_y, y_to_x, p.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Proc * src, CreateProc("src", /*in=*/nullptr, src_to_x, p.get()));
+
+  // Proc x receives from both the source and the feedback channel.
+  ProcBuilder pb("x", /*init_value=*/Value(UBits(0, 32)),
+                 /*token_name=*/"tok", /*state_name=*/"st", p.get());
+  BValue recv_src = pb.Receive(src_to_x, pb.GetTokenParam());
+  BValue recv_y = pb.Receive(y_to_x, pb.TupleIndex(recv_src, 0));
+  BValue send = pb.Send(x_to_y, pb.TupleIndex(recv_y, 0),
+                        pb.TupleIndex(recv_src, 1));
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * x, pb.Build(send, pb.GetStateParam()));
+
+  // The cycle {x, y} forms one group, fired after the source feeding it.
+  // Within the group procs appear in package order (y precedes x).
+  EXPECT_THAT(ComputeProcFiringOrder(p.get()),
+              ElementsAre(ElementsAre(src), ElementsAre(y, x)));
+}
+
+TEST_F(ProcFiringOrderTest, ExternalChannelsContributeNoEdges) {
+  auto p = CreatePackage();
+  Type* u32 = p->GetBitsType(32);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * in,
+      p->CreateStreamingChannel("in", ChannelOps::kReceiveOnly, u32));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * out,
+      p->CreateStreamingChannel("out", ChannelOps::kSendOnly, u32));
+
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc, CreateProc("p", in, out, p.get()));
+
+  EXPECT_THAT(ComputeProcFiringOrder(p.get()),
+              ElementsAre(ElementsAre(proc)));
+}
+
+}  // namespace
+}  // namespace xls
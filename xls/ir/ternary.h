@@ -15,8 +15,7 @@
 #ifndef XLS_IR_TERNARY_H_
 #define XLS_IR_TERNARY_H_
 
-#include <vector>
-
+#include "absl/container/inlined_vector.h"
 #include "absl/status/statusor.h"
 #include "xls/ir/bits.h"
 
@@ -30,8 +29,10 @@ enum class TernaryValue : int8_t {
   kUnknown = 2
 };
 
-// A vector of ternary values. Analogous to the Bits object for concrete values.
-using TernaryVector = std::vector<TernaryValue>;
+// A vector of ternary values. Analogous to the Bits object for concrete
+// values. Ternary analysis overwhelmingly processes narrow control values, so
+// vectors of up to 64 elements are stored inline rather than on the heap.
+using TernaryVector = absl::InlinedVector<TernaryValue, 64>;
 
 // Format of the ternary vector is, for example: 0b10XX1
 std::string ToString(const TernaryVector& value);
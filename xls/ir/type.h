@@ -131,6 +131,17 @@ class TupleType : public Type {
     for (Type* t : members) {
       leaf_count_ += t->leaf_count();
     }
+    // Precompute the flattened layout of the tuple. Element zero occupies the
+    // highest-index bits of the flattened representation, in line with the
+    // Verilog concatenation operation, so offsets accumulate from the last
+    // element. Types are immutable so the table never goes stale.
+    flat_offsets_.resize(members_.size());
+    int64_t offset = 0;
+    for (int64_t i = members_.size() - 1; i >= 0; --i) {
+      flat_offsets_[i] = offset;
+      offset += members_[i]->GetFlatBitCount();
+    }
+    flat_bit_count_ = offset;
   }
   ~TupleType() override {}
   std::string ToString() const override;
@@ -149,17 +160,21 @@ class TupleType : public Type {
 
   int64_t leaf_count() const override { return leaf_count_; }
 
-  int64_t GetFlatBitCount() const override {
-    int64_t total = 0;
-    for (const Type* type : members_) {
-      total += type->GetFlatBitCount();
-    }
-    return total;
+  int64_t GetFlatBitCount() const override { return flat_bit_count_; }
+
+  // Returns the bit offset of the element at 'index' within the flattened
+  // representation of the tuple. Precomputed at construction, so querying
+  // every element of a wide tuple is linear rather than quadratic.
+  int64_t GetFlatBitOffsetOfElement(int64_t index) const {
+    return flat_offsets_.at(index);
   }
 
  private:
   int64_t leaf_count_;
+  int64_t flat_bit_count_;
   std::vector<Type*> members_;
+  // Flat bit offset of each element; see GetFlatBitOffsetOfElement().
+  std::vector<int64_t> flat_offsets_;
 };
 
 // Represents a type that is a one-dimensional array of identical types.
@@ -168,7 +183,10 @@ class TupleType : public Type {
 class ArrayType : public Type {
  public:
   explicit ArrayType(int64_t size, Type* element_type)
-      : Type(TypeKind::kArray), size_(size), element_type_(element_type) {}
+      : Type(TypeKind::kArray),
+        size_(size),
+        element_type_(element_type),
+        flat_bit_count_(size * element_type->GetFlatBitCount()) {}
   ~ArrayType() override {}
   std::string ToString() const override;
 
@@ -178,9 +196,7 @@ class ArrayType : public Type {
   Type* element_type() const { return element_type_; }
   int64_t size() const { return size_; }
 
-  int64_t GetFlatBitCount() const override {
-    return element_type_->GetFlatBitCount() * size_;
-  }
+  int64_t GetFlatBitCount() const override { return flat_bit_count_; }
 
   int64_t leaf_count() const override {
     return size_ * element_type()->leaf_count();
@@ -189,6 +205,7 @@ class ArrayType : public Type {
  private:
   int64_t size_;
   Type* element_type_;
+  int64_t flat_bit_count_;
 };
 
 // Represents a token type used for ordering channel accesses.
@@ -131,6 +131,25 @@ TEST(TypeTest, TestVariousTypes) {
   EXPECT_FALSE(f_type1.IsEqualTo(&f_type5));
 }
 
+TEST(TypeTest, FlatBitCountAndOffsets) {
+  BitsType b5(5);
+  BitsType b0(0);
+  BitsType b32(32);
+  TupleType tuple({&b5, &b0, &b32, &b5});
+  EXPECT_EQ(tuple.GetFlatBitCount(), 42);
+  // Element zero occupies the highest-index bits of the flattened
+  // representation.
+  EXPECT_EQ(tuple.GetFlatBitOffsetOfElement(0), 37);
+  EXPECT_EQ(tuple.GetFlatBitOffsetOfElement(1), 37);
+  EXPECT_EQ(tuple.GetFlatBitOffsetOfElement(2), 5);
+  EXPECT_EQ(tuple.GetFlatBitOffsetOfElement(3), 0);
+
+  ArrayType array(7, &b32);
+  EXPECT_EQ(array.GetFlatBitCount(), 224);
+  ArrayType array_2d(3, &array);
+  EXPECT_EQ(array_2d.GetFlatBitCount(), 672);
+}
+
 TEST(TypeTest, ArrayDimensionAndIndex) {
   BitsType b32(32);
   TokenType token;
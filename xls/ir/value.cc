@@ -232,7 +232,7 @@ void Value::FlattenTo(BitPushBuffer* buffer) const {
 }
 
 absl::StatusOr<std::vector<Value>> Value::GetElements() const {
-  if (!absl::holds_alternative<std::vector<Value>>(payload_)) {
+  if (!HasElements()) {
     return absl::InvalidArgumentError("Value does not hold elements.");
   }
   return std::vector<Value>(elements().begin(), elements().end());
@@ -345,6 +345,12 @@ bool Value::operator==(const Value& other) const {
   }
 
   // All non-Bits types are container types -- should have a size attribute.
+  // Structural sharing makes identical storage a common case; elements need
+  // not be compared if both values reference the same buffer.
+  if (absl::get<ElementStorage>(payload_) ==
+      absl::get<ElementStorage>(other.payload_)) {
+    return true;
+  }
   if (size() != other.size()) {
     return false;
   }
@@ -14,6 +14,11 @@
 
 #include "xls/ir/verifier.h"
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
@@ -22,6 +27,7 @@
 #include "xls/common/math_util.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/ir/block.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/dfs_visitor.h"
@@ -37,6 +43,46 @@ namespace {
 
 using ::absl::StrFormat;
 
+// Applies 'verify' to each element of 'items', sharding the calls across
+// worker threads. The checks run by the verifier only read the IR so they can
+// safely run concurrently. Returns the error of the lowest-indexed failing
+// element so the result is deterministic regardless of thread interleaving.
+template <typename T>
+absl::Status VerifyInParallel(absl::Span<T* const> items,
+                              const std::function<absl::Status(T*)>& verify) {
+  const int64_t num_threads = std::min<int64_t>(
+      items.size(), std::thread::hardware_concurrency());
+  if (num_threads <= 1) {
+    for (T* item : items) {
+      XLS_RETURN_IF_ERROR(verify(item));
+    }
+    return absl::OkStatus();
+  }
+  std::vector<absl::Status> statuses(items.size());
+  std::atomic<int64_t> next_index(0);
+  std::vector<std::unique_ptr<Thread>> workers;
+  for (int64_t i = 0; i < num_threads; ++i) {
+    workers.push_back(std::make_unique<Thread>([&] {
+      int64_t index;
+      while ((index = next_index.fetch_add(1)) <
+             static_cast<int64_t>(items.size())) {
+        statuses[index] = verify(items[index]);
+      }
+    }));
+  }
+  for (std::unique_ptr<Thread>& worker : workers) {
+    worker->Join();
+  }
+  for (absl::Status& status : statuses) {
+    XLS_RETURN_IF_ERROR(status);
+  }
+  return absl::OkStatus();
+}
+
+// Functions with at least this many nodes have their per-node checks sharded
+// across threads; below this the serial loop is faster than the fan-out.
+constexpr int64_t kParallelNodeVerificationThreshold = 1024;
+
 // Visitor which verifies various properties of Nodes including the types of the
 // operands and the type of the result.
 class NodeChecker : public DfsVisitor {
@@ -1309,9 +1355,23 @@ absl::Status VerifyFunctionBase(FunctionBase* function) {
     XLS_RETURN_IF_ERROR(VerifyNodeIdUnique(node, &ids));
   }
 
-  // Verify consistency of node::users() and node::operands().
-  for (Node* node : function->nodes()) {
-    XLS_RETURN_IF_ERROR(VerifyNode(node));
+  // Verify consistency of node::users() and node::operands(). For large
+  // functions shard the node checks across threads.
+  if (function->node_count() >= kParallelNodeVerificationThreshold) {
+    std::vector<Node*> nodes(function->nodes().begin(),
+                             function->nodes().end());
+    // Touch users() of every node serially first: high-fanout nodes sort
+    // their user list lazily on first access, which must not happen
+    // concurrently from the worker threads.
+    for (Node* node : nodes) {
+      node->users();
+    }
+    XLS_RETURN_IF_ERROR(VerifyInParallel<Node>(
+        nodes, [](Node* node) { return VerifyNode(node); }));
+  } else {
+    for (Node* node : function->nodes()) {
+      XLS_RETURN_IF_ERROR(VerifyNode(node));
+    }
   }
 
   // Verify the set of parameter nodes is exactly Function::params(), and that
@@ -1514,18 +1574,23 @@ absl::Status VerifyPackage(Package* package) {
   XLS_VLOG(4) << absl::StreamFormat("Verifying package %s:\n", package->name());
   XLS_VLOG_LINES(4, package->DumpIr());
 
-  for (auto& function : package->functions()) {
-    XLS_RETURN_IF_ERROR(VerifyFunction(function.get()));
-  }
-
-  for (auto& proc : package->procs()) {
-    XLS_RETURN_IF_ERROR(VerifyProc(proc.get()));
-  }
+  // FunctionBases are independent of each other so verify them concurrently.
+  std::vector<FunctionBase*> function_bases = package->GetFunctionBases();
+  XLS_RETURN_IF_ERROR(VerifyInParallel<FunctionBase>(
+      function_bases, [](FunctionBase* function_base) -> absl::Status {
+        if (function_base->IsFunction()) {
+          return VerifyFunction(function_base->AsFunctionOrDie());
+        }
+        if (function_base->IsProc()) {
+          return VerifyProc(function_base->AsProcOrDie());
+        }
+        return VerifyBlock(function_base->AsBlockOrDie());
+      }));
 
-  for (auto& block : package->blocks()) {
-    XLS_RETURN_IF_ERROR(VerifyBlock(block.get()));
-  }
+  return VerifyPackageInvariants(package);
+}
 
+absl::Status VerifyPackageInvariants(Package* package) {
   // Verify node IDs are unique within the package and uplinks point to this
   // package.
   absl::flat_hash_map<int64_t, absl::optional<SourceLocation>> ids;
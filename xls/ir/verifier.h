@@ -26,13 +26,23 @@ class Block;
 class Package;
 
 // Verifies numerous invariants of the IR for the given IR construct. Returns a
-// error status if a violation is found.
+// error status if a violation is found. VerifyPackage verifies independent
+// FunctionBases concurrently and shards the per-node checks of large
+// functions across threads.
 absl::Status VerifyPackage(Package* package);
 absl::Status VerifyFunction(Function* function);
 absl::Status VerifyProc(Proc* Proc);
 absl::Status VerifyBlock(Block* Block);
 absl::Status VerifyNode(Node* Node);
 
+// Verifies only the package-scoped invariants (node ID uniqueness across the
+// package, function/proc/block name uniqueness, channel invariants) without
+// re-running the per-node checks of each function. Used together with
+// VerifyFunction/VerifyProc/VerifyBlock to incrementally verify a package in
+// which only some FunctionBases have changed (see
+// FunctionBase::transform_count()).
+absl::Status VerifyPackageInvariants(Package* package);
+
 }  // namespace xls
 
 #endif  // XLS_IR_VERIFIER_H_
@@ -0,0 +1,217 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/waveform_capture.h"
+
+#include <cstring>
+#include <map>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/math_util.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/bit_push_buffer.h"
+
+namespace xls {
+namespace {
+
+// Magic bytes identifying the binary capture format, followed by a version.
+constexpr char kMagic[8] = {'X', 'L', 'S', 'W', 'A', 'V', 'E', '\0'};
+constexpr uint32_t kVersion = 1;
+
+// Little-endian fixed-width append/read helpers for the binary format.
+template <typename T>
+void AppendInt(std::string* out, T value) {
+  char bytes[sizeof(T)];
+  memcpy(bytes, &value, sizeof(T));
+  out->append(bytes, sizeof(T));
+}
+
+template <typename T>
+absl::StatusOr<T> ReadInt(absl::string_view* data) {
+  if (data->size() < sizeof(T)) {
+    return absl::InvalidArgumentError("Truncated waveform capture file");
+  }
+  T value;
+  memcpy(&value, data->data(), sizeof(T));
+  data->remove_prefix(sizeof(T));
+  return value;
+}
+
+// Returns a short printable VCD identifier for the given signal index.
+std::string VcdIdentifier(int64_t index) {
+  std::string id;
+  do {
+    id.push_back('!' + index % 94);
+    index /= 94;
+  } while (index > 0);
+  return id;
+}
+
+}  // namespace
+
+int64_t WaveformCapture::AddSignal(absl::string_view name, int64_t bit_count) {
+  Signal signal;
+  signal.name = std::string(name);
+  signal.bit_count = bit_count;
+  signals_.push_back(std::move(signal));
+  return signals_.size() - 1;
+}
+
+void WaveformCapture::Record(int64_t signal_index, int64_t cycle,
+                             const Bits& value) {
+  XLS_CHECK_LT(signal_index, static_cast<int64_t>(signals_.size()));
+  Signal& signal = signals_[signal_index];
+  XLS_DCHECK_EQ(value.bit_count(), signal.bit_count);
+  if (!signal.change_values.empty() && signal.change_values.back() == value) {
+    return;
+  }
+  signal.change_cycles.push_back(cycle);
+  signal.change_values.push_back(value);
+}
+
+void WaveformCapture::RecordValue(int64_t signal_index, int64_t cycle,
+                                  const Value& value) {
+  BitPushBuffer buffer;
+  value.FlattenTo(&buffer);
+  Record(signal_index, cycle,
+         Bits::FromBytes(buffer.GetUint8Data(),
+                         signals_[signal_index].bit_count));
+}
+
+int64_t WaveformCapture::change_count() const {
+  int64_t count = 0;
+  for (const Signal& signal : signals_) {
+    count += signal.change_cycles.size();
+  }
+  return count;
+}
+
+absl::Status WaveformCapture::WriteBinaryFile(
+    const std::filesystem::path& path) const {
+  std::string contents;
+  contents.append(kMagic, sizeof(kMagic));
+  AppendInt<uint32_t>(&contents, kVersion);
+  AppendInt<uint32_t>(&contents, signals_.size());
+  for (const Signal& signal : signals_) {
+    AppendInt<uint32_t>(&contents, signal.name.size());
+    contents.append(signal.name);
+    AppendInt<uint32_t>(&contents, signal.bit_count);
+    AppendInt<uint64_t>(&contents, signal.change_cycles.size());
+    for (int64_t i = 0; i < static_cast<int64_t>(signal.change_cycles.size());
+         ++i) {
+      AppendInt<uint64_t>(&contents, signal.change_cycles[i]);
+      std::vector<uint8_t> bytes = signal.change_values[i].ToBytes();
+      contents.append(reinterpret_cast<const char*>(bytes.data()),
+                      bytes.size());
+    }
+  }
+  return SetFileContents(path, contents);
+}
+
+/* static */ absl::StatusOr<WaveformCapture> WaveformCapture::FromBinaryFile(
+    const std::filesystem::path& path) {
+  XLS_ASSIGN_OR_RETURN(std::string contents, GetFileContents(path));
+  absl::string_view data = contents;
+  if (data.size() < sizeof(kMagic) ||
+      memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Not a waveform capture file: ", path.string()));
+  }
+  data.remove_prefix(sizeof(kMagic));
+  XLS_ASSIGN_OR_RETURN(uint32_t version, ReadInt<uint32_t>(&data));
+  if (version != kVersion) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unsupported waveform capture version: ", version));
+  }
+
+  WaveformCapture capture;
+  XLS_ASSIGN_OR_RETURN(uint32_t signal_count, ReadInt<uint32_t>(&data));
+  for (uint32_t s = 0; s < signal_count; ++s) {
+    XLS_ASSIGN_OR_RETURN(uint32_t name_size, ReadInt<uint32_t>(&data));
+    if (data.size() < name_size) {
+      return absl::InvalidArgumentError("Truncated waveform capture file");
+    }
+    std::string name(data.substr(0, name_size));
+    data.remove_prefix(name_size);
+    XLS_ASSIGN_OR_RETURN(uint32_t bit_count, ReadInt<uint32_t>(&data));
+    int64_t index = capture.AddSignal(name, bit_count);
+    Signal& signal = capture.signals_[index];
+
+    XLS_ASSIGN_OR_RETURN(uint64_t change_count, ReadInt<uint64_t>(&data));
+    int64_t byte_count = CeilOfRatio<int64_t>(bit_count, 8);
+    for (uint64_t c = 0; c < change_count; ++c) {
+      XLS_ASSIGN_OR_RETURN(uint64_t cycle, ReadInt<uint64_t>(&data));
+      if (static_cast<int64_t>(data.size()) < byte_count) {
+        return absl::InvalidArgumentError("Truncated waveform capture file");
+      }
+      signal.change_cycles.push_back(cycle);
+      signal.change_values.push_back(Bits::FromBytes(
+          absl::MakeConstSpan(reinterpret_cast<const uint8_t*>(data.data()),
+                              byte_count),
+          bit_count));
+      data.remove_prefix(byte_count);
+    }
+  }
+  return std::move(capture);
+}
+
+std::string WaveformCapture::ToVcd() const {
+  std::string vcd;
+  absl::StrAppend(&vcd, "$timescale 1ns $end\n");
+  absl::StrAppend(&vcd, "$scope module capture $end\n");
+  for (int64_t i = 0; i < static_cast<int64_t>(signals_.size()); ++i) {
+    absl::StrAppendFormat(&vcd, "$var wire %d %s %s $end\n",
+                          signals_[i].bit_count, VcdIdentifier(i),
+                          signals_[i].name);
+  }
+  absl::StrAppend(&vcd, "$upscope $end\n");
+  absl::StrAppend(&vcd, "$enddefinitions $end\n");
+
+  // Merge the per-signal change columns into time order.
+  std::map<int64_t, std::vector<std::pair<int64_t, int64_t>>> changes_by_cycle;
+  for (int64_t i = 0; i < static_cast<int64_t>(signals_.size()); ++i) {
+    const Signal& signal = signals_[i];
+    for (int64_t c = 0; c < static_cast<int64_t>(signal.change_cycles.size());
+         ++c) {
+      changes_by_cycle[signal.change_cycles[c]].push_back({i, c});
+    }
+  }
+
+  for (const auto& [cycle, changes] : changes_by_cycle) {
+    absl::StrAppendFormat(&vcd, "#%d\n", cycle);
+    for (const auto& [signal_index, change_index] : changes) {
+      const Signal& signal = signals_[signal_index];
+      const Bits& value = signal.change_values[change_index];
+      if (signal.bit_count == 1) {
+        absl::StrAppendFormat(&vcd, "%d%s\n", value.Get(0) ? 1 : 0,
+                              VcdIdentifier(signal_index));
+      } else {
+        std::string binary;
+        for (int64_t bit = value.bit_count() - 1; bit >= 0; --bit) {
+          binary.push_back(value.Get(bit) ? '1' : '0');
+        }
+        absl::StrAppendFormat(&vcd, "b%s %s\n", binary,
+                              VcdIdentifier(signal_index));
+      }
+    }
+  }
+  return vcd;
+}
+
+}  // namespace xls
@@ -0,0 +1,81 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_IR_WAVEFORM_CAPTURE_H_
+#define XLS_IR_WAVEFORM_CAPTURE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+
+// Captures signal history from a simulation run. Each signal is stored as a
+// column of (cycle, value) pairs recorded only when the value differs from
+// the previously recorded one, so capture cost and memory scale with
+// switching activity rather than cycle count. The capture can be serialized
+// to a compact binary file and converted to VCD for viewing.
+class WaveformCapture {
+ public:
+  // Adds a signal column of the given bit width and returns its index.
+  // Signals must be added before values are recorded for them.
+  int64_t AddSignal(absl::string_view name, int64_t bit_count);
+
+  // Records the value of the given signal at the given cycle. The value is
+  // stored only if it differs from the last recorded value of the signal.
+  // Cycles must be recorded in nondecreasing order per signal.
+  void Record(int64_t signal_index, int64_t cycle, const Bits& value);
+
+  // As Record() but flattens an arbitrary Value (e.g. tuple-typed register
+  // state) to its bit representation first.
+  void RecordValue(int64_t signal_index, int64_t cycle, const Value& value);
+
+  int64_t signal_count() const { return signals_.size(); }
+
+  // Total number of stored value changes across all signals.
+  int64_t change_count() const;
+
+  // Writes the capture to the given path in a compact binary columnar format.
+  absl::Status WriteBinaryFile(const std::filesystem::path& path) const;
+
+  // Reads a capture previously written with WriteBinaryFile().
+  static absl::StatusOr<WaveformCapture> FromBinaryFile(
+      const std::filesystem::path& path);
+
+  // Returns the capture as VCD text with one timescale unit per cycle.
+  std::string ToVcd() const;
+
+ private:
+  // Columnar storage for one signal: parallel vectors of the cycles at which
+  // the value changed and the values themselves.
+  struct Signal {
+    std::string name;
+    int64_t bit_count;
+    std::vector<int64_t> change_cycles;
+    std::vector<Bits> change_values;
+  };
+
+  std::vector<Signal> signals_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_IR_WAVEFORM_CAPTURE_H_
@@ -0,0 +1,88 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/waveform_capture.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/file/temp_file.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+using ::testing::HasSubstr;
+
+TEST(WaveformCaptureTest, ChangeOnlyEncoding) {
+  WaveformCapture capture;
+  int64_t sig = capture.AddSignal("data", 8);
+  capture.Record(sig, 0, UBits(1, 8));
+  capture.Record(sig, 1, UBits(1, 8));
+  capture.Record(sig, 2, UBits(1, 8));
+  capture.Record(sig, 3, UBits(7, 8));
+  capture.Record(sig, 4, UBits(7, 8));
+
+  // Only the cycle-0 and cycle-3 values are stored.
+  EXPECT_EQ(capture.signal_count(), 1);
+  EXPECT_EQ(capture.change_count(), 2);
+}
+
+TEST(WaveformCaptureTest, BinaryRoundTrip) {
+  WaveformCapture capture;
+  int64_t a = capture.AddSignal("a", 1);
+  int64_t b = capture.AddSignal("b", 16);
+  capture.Record(a, 0, UBits(0, 1));
+  capture.Record(b, 0, UBits(0xbeef, 16));
+  capture.Record(a, 5, UBits(1, 1));
+  capture.Record(b, 7, UBits(0x1234, 16));
+
+  XLS_ASSERT_OK_AND_ASSIGN(TempFile temp, TempFile::Create());
+  XLS_ASSERT_OK(capture.WriteBinaryFile(temp.path()));
+  XLS_ASSERT_OK_AND_ASSIGN(WaveformCapture read_back,
+                           WaveformCapture::FromBinaryFile(temp.path()));
+  EXPECT_EQ(read_back.signal_count(), 2);
+  EXPECT_EQ(read_back.change_count(), 4);
+  EXPECT_EQ(read_back.ToVcd(), capture.ToVcd());
+}
+
+TEST(WaveformCaptureTest, VcdOutput) {
+  WaveformCapture capture;
+  int64_t clk = capture.AddSignal("clk", 1);
+  int64_t bus = capture.AddSignal("bus", 4);
+  capture.Record(clk, 0, UBits(0, 1));
+  capture.Record(bus, 0, UBits(0b1010, 4));
+  capture.Record(clk, 1, UBits(1, 1));
+
+  std::string vcd = capture.ToVcd();
+  EXPECT_THAT(vcd, HasSubstr("$var wire 1 ! clk $end"));
+  EXPECT_THAT(vcd, HasSubstr("$var wire 4 \" bus $end"));
+  EXPECT_THAT(vcd, HasSubstr("#0\n0!\nb1010 \"\n#1\n1!\n"));
+}
+
+TEST(WaveformCaptureTest, RecordsFlattenedValues) {
+  WaveformCapture capture;
+  int64_t sig = capture.AddSignal("state", 12);
+  capture.RecordValue(sig, 0,
+                      Value::Tuple({Value(UBits(1, 4)), Value(UBits(2, 8))}));
+  capture.RecordValue(sig, 1,
+                      Value::Tuple({Value(UBits(1, 4)), Value(UBits(2, 8))}));
+  capture.RecordValue(sig, 2,
+                      Value::Tuple({Value(UBits(3, 4)), Value(UBits(2, 8))}));
+  EXPECT_EQ(capture.change_count(), 2);
+}
+
+}  // namespace
+}  // namespace xls
@@ -0,0 +1,217 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/aot_compiler.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/call_once.h"
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/substitute.h"
+#include "llvm/include/llvm-c/Target.h"
+#include "llvm/include/llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/include/llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/include/llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/include/llvm/IR/DerivedTypes.h"
+#include "llvm/include/llvm/IR/LLVMContext.h"
+#include "llvm/include/llvm/IR/LegacyPassManager.h"
+#include "llvm/include/llvm/IR/Module.h"
+#include "llvm/include/llvm/Support/CodeGen.h"
+#include "llvm/include/llvm/Support/raw_ostream.h"
+#include "llvm/include/llvm/Target/TargetMachine.h"
+#include "llvm/include/llvm/Transforms/IPO/PassManagerBuilder.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/type.h"
+#include "xls/jit/function_builder_visitor.h"
+#include "xls/jit/llvm_type_converter.h"
+
+namespace xls {
+namespace {
+
+absl::once_flag once;
+void OnceInit() {
+  LLVMInitializeNativeTarget();
+  LLVMInitializeNativeAsmPrinter();
+  LLVMInitializeNativeAsmParser();
+}
+
+}  // namespace
+
+absl::StatusOr<AotCompilationResult> CompileFunctionAheadOfTime(
+    Function* function, absl::string_view entry_symbol, int64_t opt_level) {
+  absl::call_once(once, OnceInit);
+
+  auto error_or_target_builder =
+      llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (!error_or_target_builder) {
+    return absl::InternalError(
+        absl::StrCat("Unable to detect host: ",
+                     llvm::toString(error_or_target_builder.takeError())));
+  }
+  auto error_or_target_machine = error_or_target_builder->createTargetMachine();
+  if (!error_or_target_machine) {
+    return absl::InternalError(
+        absl::StrCat("Unable to create target machine: ",
+                     llvm::toString(error_or_target_machine.takeError())));
+  }
+  std::unique_ptr<llvm::TargetMachine> target_machine =
+      std::move(error_or_target_machine.get());
+  llvm::DataLayout data_layout = target_machine->createDataLayout();
+
+  llvm::LLVMContext context;
+  LlvmTypeConverter type_converter(&context, data_layout);
+  auto module =
+      std::make_unique<llvm::Module>(std::string(entry_symbol), context);
+  module->setDataLayout(data_layout);
+
+  AotCompilationResult result;
+  result.entry_symbol = std::string(entry_symbol);
+
+  // Construct the same function type as IrJit::CompileFunction(): the inputs
+  // are an array of pointers to flat parameter buffers and the result is
+  // written through a pointer to a caller-allocated buffer.
+  std::vector<llvm::Type*> param_types;
+  param_types.push_back(llvm::PointerType::get(
+      llvm::ArrayType::get(
+          llvm::PointerType::get(llvm::Type::getInt8Ty(context),
+                                 /*AddressSpace=*/0),
+          function->params().size()),
+      /*AddressSpace=*/0));
+
+  for (const Param* param : function->params()) {
+    result.parameter_buffer_sizes.push_back(
+        type_converter.GetTypeByteSize(param->GetType()));
+  }
+
+  Type* return_type =
+      FunctionBuilderVisitor::GetEffectiveReturnValue(function)->GetType();
+  llvm::Type* llvm_return_type = type_converter.ConvertToLlvmType(return_type);
+  param_types.push_back(
+      llvm::PointerType::get(llvm_return_type, /*AddressSpace=*/0));
+  result.return_buffer_size = type_converter.GetTypeByteSize(return_type);
+
+  // Interpreter events, user data, and JIT runtime arguments (as int64_t
+  // values, matching the JIT).
+  llvm::Type* void_ptr_type = llvm::Type::getInt64Ty(context);
+  param_types.push_back(void_ptr_type);
+  param_types.push_back(void_ptr_type);
+  param_types.push_back(void_ptr_type);
+
+  llvm::FunctionType* function_type = llvm::FunctionType::get(
+      llvm::Type::getVoidTy(context),
+      llvm::ArrayRef<llvm::Type*>(param_types.data(), param_types.size()),
+      /*isVarArg=*/false);
+  llvm::Function* llvm_function = llvm::cast<llvm::Function>(
+      module->getOrInsertFunction(result.entry_symbol, function_type)
+          .getCallee());
+  XLS_RETURN_IF_ERROR(FunctionBuilderVisitor::Visit(
+      module.get(), llvm_function, function, &type_converter,
+      /*is_top=*/true, /*generate_packed=*/false));
+
+  // Run the same LLVM optimization pipeline as the JIT's transform layer.
+  llvm::PassManagerBuilder builder;
+  builder.OptLevel = opt_level;
+  builder.LibraryInfo =
+      new llvm::TargetLibraryInfoImpl(target_machine->getTargetTriple());
+
+  llvm::legacy::FunctionPassManager function_pass_manager(module.get());
+  builder.populateFunctionPassManager(function_pass_manager);
+  function_pass_manager.doInitialization();
+  for (auto& f : *module) {
+    function_pass_manager.run(f);
+  }
+  function_pass_manager.doFinalization();
+
+  // The ostream and its buffer must outlive the module_pass_manager (its
+  // destructor flushes the ostream).
+  llvm::SmallVector<char, 0> stream_buffer;
+  llvm::raw_svector_ostream ostream(stream_buffer);
+
+  llvm::legacy::PassManager module_pass_manager;
+  builder.populateModulePassManager(module_pass_manager);
+  module_pass_manager.add(llvm::createTargetTransformInfoWrapperPass(
+      target_machine->getTargetIRAnalysis()));
+  if (target_machine->addPassesToEmitFile(module_pass_manager, ostream,
+                                          nullptr, llvm::CGFT_ObjectFile)) {
+    return absl::InternalError(
+        "The host target machine cannot emit object files.");
+  }
+  module_pass_manager.run(*module);
+
+  result.object_code = std::string(stream_buffer.begin(), stream_buffer.end());
+  return result;
+}
+
+std::string GenerateAotHeader(const Function& function,
+                              const AotCompilationResult& result,
+                              const std::filesystem::path& header_path,
+                              const std::filesystem::path& genfiles_path) {
+  constexpr absl::string_view header_template =
+      R"(// Automatically-generated file. Do not edit!
+#ifndef $0
+#define $0
+
+#include <cstdint>
+
+extern "C" {
+
+// Ahead-of-time compiled XLS function "$1".
+//
+// "inputs" points to one flat buffer per parameter, with sizes in bytes of:
+//   $2
+// "output" is a caller-allocated buffer of $3 bytes receiving the return
+// value. The buffer layouts match the XLS JIT's unpacked representation (see
+// xls/jit/jit_runtime.h for packing Values into these buffers). The trailing
+// interpreter-events, user-data, and JIT-runtime arguments may be null for
+// functions without assert or trace operations.
+void $4(const uint8_t* const* inputs, uint8_t* output,
+        void* interpreter_events, void* user_data, void* jit_runtime);
+
+}  // extern "C"
+
+#endif  // $0
+)";
+
+  // Transform "blah/genfiles/xls/foo/bar.h" into "XLS_FOO_BAR_H_".
+  std::string header_guard = std::string(header_path);
+  if (!std::string(genfiles_path).empty()) {
+    header_guard = header_guard.substr(std::string(genfiles_path).size() + 1);
+  }
+  header_guard = absl::StrReplaceAll(
+      header_guard,
+      {
+          {absl::StrFormat("%c", header_path.preferred_separator), "_"},
+          {".", "_"},
+      });
+  header_guard = absl::StrCat(absl::AsciiStrToUpper(header_guard), "_");
+
+  std::vector<std::string> param_sizes;
+  for (int64_t i = 0; i < function.params().size(); ++i) {
+    param_sizes.push_back(absl::StrFormat(
+        "%s: %d", function.params()[i]->name(),
+        result.parameter_buffer_sizes[i]));
+  }
+  return absl::Substitute(header_template, header_guard, function.name(),
+                          absl::StrJoin(param_sizes, ", "),
+                          result.return_buffer_size, result.entry_symbol);
+}
+
+}  // namespace xls
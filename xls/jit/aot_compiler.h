@@ -0,0 +1,72 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_JIT_AOT_COMPILER_H_
+#define XLS_JIT_AOT_COMPILER_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xls/ir/function.h"
+
+namespace xls {
+
+// Result of ahead-of-time compiling an XLS function to host object code.
+struct AotCompilationResult {
+  // Contents of a relocatable object file (.o) defining "entry_symbol".
+  std::string object_code;
+
+  // Name of the emitted entry point symbol.
+  std::string entry_symbol;
+
+  // Flat buffer sizes in bytes of the function's parameters and return value,
+  // using the same (unpacked) layouts as the JIT.
+  std::vector<int64_t> parameter_buffer_sizes;
+  int64_t return_buffer_size;
+};
+
+// Compiles "function" into a relocatable object file for the host using the
+// same LLVM lowering and optimization pipeline as IrJit, but without loading
+// the result into the running process. Linking the object into a binary makes
+// the function a plain symbol call with no startup compilation. The emitted
+// entry point has the JIT's calling convention:
+//
+//   void entry_symbol(const uint8_t* const* inputs, uint8_t* output,
+//                     void* interpreter_events, void* user_data,
+//                     void* jit_runtime);
+//
+// where "inputs" points to one flat buffer per parameter and "output" is a
+// caller-allocated buffer for the return value (see the sizes in the result).
+// For functions without assert or trace operations the trailing three
+// arguments are unused and may be null.
+absl::StatusOr<AotCompilationResult> CompileFunctionAheadOfTime(
+    Function* function, absl::string_view entry_symbol, int64_t opt_level = 3);
+
+// Returns the contents of a C++ header which declares the entry point
+// produced by CompileFunctionAheadOfTime() along with comments documenting
+// the parameter and return buffer sizes. "header_path" determines the header
+// guard; "genfiles_path" (possibly empty) is the generated-file root prefix
+// to strip from it.
+std::string GenerateAotHeader(const Function& function,
+                              const AotCompilationResult& result,
+                              const std::filesystem::path& header_path,
+                              const std::filesystem::path& genfiles_path);
+
+}  // namespace xls
+
+#endif  // XLS_JIT_AOT_COMPILER_H_
@@ -0,0 +1,112 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Ahead-of-time compiles an XLS function to a relocatable object file plus a
+// C++ header declaring its entry point, so the function can be linked into a
+// binary and called with zero startup compilation.
+
+#include <filesystem>
+#include <string>
+
+#include "absl/flags/flag.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/strip.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/init_xls.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/jit/aot_compiler.h"
+
+ABSL_FLAG(std::string, function, "",
+          "Function to compile. "
+          "If unspecified, the package entry function will be used - "
+          "in that case, the package-scoping mangling will be removed.");
+ABSL_FLAG(std::string, ir_path, "", "Path to the IR to compile.");
+ABSL_FLAG(std::string, entry_symbol, "",
+          "Name of the emitted entry point symbol. "
+          "If unspecified, \"<package>_<function>\" will be used.");
+ABSL_FLAG(std::string, output_object, "",
+          "Path at which to write the object file.");
+ABSL_FLAG(std::string, output_header, "",
+          "Path at which to write the generated header.");
+ABSL_FLAG(std::string, genfiles_dir, "",
+          "The directory into which generated files are placed. "
+          "This prefix will be removed from the header guards.");
+ABSL_FLAG(int64_t, llvm_opt_level, 3,
+          "LLVM optimization level. Valid values are from 0 (no "
+          "optimizations) to 3 (maximum optimizations).");
+
+namespace xls {
+
+absl::Status RealMain(const std::filesystem::path& ir_path,
+                      const std::filesystem::path& object_path,
+                      const std::filesystem::path& header_path,
+                      const std::filesystem::path& genfiles_dir,
+                      std::string entry_symbol, std::string function_name,
+                      int64_t opt_level) {
+  XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(ir_path));
+  XLS_ASSIGN_OR_RETURN(auto package, Parser::ParsePackage(ir_text));
+
+  Function* function;
+  std::string package_prefix = absl::StrCat("__", package->name(), "__");
+  if (function_name.empty()) {
+    XLS_ASSIGN_OR_RETURN(function, package->EntryFunction());
+    function_name = absl::StripPrefix(function->name(), package_prefix);
+  } else {
+    // Apply the package prefix if not already there.
+    if (!absl::StartsWith(function_name, package_prefix)) {
+      function_name = absl::StrCat(package_prefix, function_name);
+    }
+    XLS_ASSIGN_OR_RETURN(function, package->GetFunction(function_name));
+    function_name = absl::StripPrefix(function_name, package_prefix);
+  }
+
+  if (entry_symbol.empty()) {
+    entry_symbol = absl::StrCat(package->name(), "_", function_name);
+  }
+
+  XLS_ASSIGN_OR_RETURN(
+      AotCompilationResult result,
+      CompileFunctionAheadOfTime(function, entry_symbol, opt_level));
+  XLS_RETURN_IF_ERROR(SetFileContents(object_path, result.object_code));
+  XLS_RETURN_IF_ERROR(SetFileContents(
+      header_path,
+      GenerateAotHeader(*function, result, header_path, genfiles_dir)));
+
+  return absl::OkStatus();
+}
+
+}  // namespace xls
+
+int main(int argc, char* argv[]) {
+  xls::InitXls(argv[0], argc, argv);
+
+  std::string ir_path = absl::GetFlag(FLAGS_ir_path);
+  XLS_QCHECK(!ir_path.empty()) << "-ir_path must be specified!";
+
+  std::string output_object = absl::GetFlag(FLAGS_output_object);
+  XLS_QCHECK(!output_object.empty()) << "-output_object must be specified!";
+
+  std::string output_header = absl::GetFlag(FLAGS_output_header);
+  XLS_QCHECK(!output_header.empty()) << "-output_header must be specified!";
+
+  XLS_QCHECK_OK(xls::RealMain(
+      ir_path, output_object, output_header,
+      absl::GetFlag(FLAGS_genfiles_dir), absl::GetFlag(FLAGS_entry_symbol),
+      absl::GetFlag(FLAGS_function), absl::GetFlag(FLAGS_llvm_opt_level)));
+
+  return 0;
+}
@@ -0,0 +1,70 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/aot_compiler.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/package.h"
+
+namespace xls {
+namespace {
+
+using ::testing::HasSubstr;
+
+absl::StatusOr<Function*> BuildAddFunction(Package* package) {
+  FunctionBuilder b("add", package);
+  BitsType* u32 = package->GetBitsType(32);
+  b.Add(b.Param("x", u32), b.Param("y", u32));
+  return b.Build();
+}
+
+TEST(AotCompilerTest, CompilesAddFunction) {
+  Package package("aot_test");
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function, BuildAddFunction(&package));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      AotCompilationResult result,
+      CompileFunctionAheadOfTime(function, "aot_test_add"));
+  EXPECT_FALSE(result.object_code.empty());
+  // The entry symbol should appear in the object file's symbol table.
+  EXPECT_THAT(result.object_code, HasSubstr("aot_test_add"));
+  EXPECT_EQ(result.parameter_buffer_sizes, std::vector<int64_t>({4, 4}));
+  EXPECT_EQ(result.return_buffer_size, 4);
+}
+
+TEST(AotCompilerTest, GeneratedHeaderDeclaresEntryPoint) {
+  Package package("aot_test");
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function, BuildAddFunction(&package));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      AotCompilationResult result,
+      CompileFunctionAheadOfTime(function, "aot_test_add"));
+
+  std::string header = GenerateAotHeader(
+      *function, result, "genfiles/xls/foo/add_aot.h", "genfiles");
+  EXPECT_THAT(header, HasSubstr("#ifndef XLS_FOO_ADD_AOT_H_"));
+  EXPECT_THAT(header,
+              HasSubstr("void aot_test_add(const uint8_t* const* inputs"));
+  EXPECT_THAT(header, HasSubstr("x: 4, y: 4"));
+}
+
+}  // namespace
+}  // namespace xls
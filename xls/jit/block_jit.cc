@@ -0,0 +1,231 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/block_jit.h"
+
+#include <utility>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/events.h"
+#include "xls/ir/function.h"
+#include "xls/ir/node_iterator.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/register.h"
+#include "xls/ir/value_helpers.h"
+
+namespace xls {
+namespace {
+
+// Builds a pure function in the block's package which computes one clock
+// cycle of the block. The parameters are the input ports followed by the
+// registers; the return value is a tuple of the output port values followed
+// by the next register values. Register write semantics (reset, load enable)
+// are lowered to selects.
+absl::StatusOr<Function*> BuildStepFunction(Block* block) {
+  Package* package = block->package();
+  Function* step = package->AddFunction(std::make_unique<Function>(
+      absl::StrCat(block->name(), "__block_jit_step"), package));
+
+  // Map from block node to the corresponding node in the step function.
+  absl::flat_hash_map<Node*, Node*> node_map;
+  // Map from register to the parameter holding its current value.
+  absl::flat_hash_map<Register*, Node*> reg_params;
+
+  for (InputPort* port : block->GetInputPorts()) {
+    XLS_ASSIGN_OR_RETURN(
+        Node * param,
+        step->MakeNode<Param>(port->loc(), port->GetName(), port->GetType()));
+    node_map[port] = param;
+  }
+  for (Register* reg : block->GetRegisters()) {
+    XLS_ASSIGN_OR_RETURN(
+        Node * param,
+        step->MakeNode<Param>(absl::nullopt, reg->name(), reg->type()));
+    reg_params[reg] = param;
+  }
+
+  for (Node* node : TopoSort(block)) {
+    if (node->Is<InputPort>()) {
+      continue;
+    }
+    if (node->Is<RegisterRead>()) {
+      node_map[node] = reg_params.at(node->As<RegisterRead>()->GetRegister());
+      continue;
+    }
+    if (node->Is<OutputPort>() || node->Is<RegisterWrite>()) {
+      // Side-effecting sinks; their operands are picked up below when
+      // assembling the return value.
+      continue;
+    }
+    std::vector<Node*> new_operands;
+    new_operands.reserve(node->operand_count());
+    for (Node* operand : node->operands()) {
+      new_operands.push_back(node_map.at(operand));
+    }
+    XLS_ASSIGN_OR_RETURN(Node * cloned,
+                         node->CloneInNewFunction(new_operands, step));
+    node_map[node] = cloned;
+  }
+
+  std::vector<Node*> return_elements;
+  return_elements.reserve(block->GetOutputPorts().size() +
+                          block->GetRegisters().size());
+  for (OutputPort* port : block->GetOutputPorts()) {
+    return_elements.push_back(node_map.at(port->operand(0)));
+  }
+  for (Register* reg : block->GetRegisters()) {
+    XLS_ASSIGN_OR_RETURN(RegisterWrite * reg_write,
+                         block->GetRegisterWrite(reg));
+    Node* next = node_map.at(reg_write->data());
+    if (reg_write->load_enable().has_value()) {
+      // A deasserted load enable holds the previous register value.
+      XLS_ASSIGN_OR_RETURN(
+          next, step->MakeNode<Select>(
+                    reg_write->loc(),
+                    node_map.at(reg_write->load_enable().value()),
+                    std::vector<Node*>{reg_params.at(reg), next},
+                    /*default_value=*/absl::nullopt));
+    }
+    if (reg_write->reset().has_value()) {
+      // An activated reset takes priority over the load enable. For an
+      // active-low reset the register resets when the signal is zero.
+      const Reset& reset = reg->reset().value();
+      XLS_ASSIGN_OR_RETURN(
+          Node * reset_value,
+          step->MakeNode<Literal>(reg_write->loc(), reset.reset_value));
+      std::vector<Node*> cases =
+          reset.active_low ? std::vector<Node*>{reset_value, next}
+                           : std::vector<Node*>{next, reset_value};
+      XLS_ASSIGN_OR_RETURN(
+          next, step->MakeNode<Select>(
+                    reg_write->loc(), node_map.at(reg_write->reset().value()),
+                    cases, /*default_value=*/absl::nullopt));
+    }
+    return_elements.push_back(next);
+  }
+
+  XLS_ASSIGN_OR_RETURN(Node * return_tuple,
+                       step->MakeNode<Tuple>(absl::nullopt, return_elements));
+  XLS_RETURN_IF_ERROR(step->set_return_value(return_tuple));
+  return step;
+}
+
+}  // namespace
+
+/* static */ absl::StatusOr<std::unique_ptr<BlockJit>> BlockJit::Create(
+    Block* block) {
+  XLS_ASSIGN_OR_RETURN(Function * step_function, BuildStepFunction(block));
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<IrJit> jit,
+                       IrJit::Create(step_function));
+  std::vector<Value> register_state;
+  register_state.reserve(block->GetRegisters().size());
+  for (Register* reg : block->GetRegisters()) {
+    register_state.push_back(ZeroOfType(reg->type()));
+  }
+  return absl::WrapUnique(
+      new BlockJit(block, std::move(jit), std::move(register_state)));
+}
+
+absl::StatusOr<absl::flat_hash_map<std::string, Value>> BlockJit::RunCycle(
+    const absl::flat_hash_map<std::string, Value>& inputs) {
+  // Verify each input corresponds to an input port.
+  absl::flat_hash_set<std::string> input_port_names;
+  for (InputPort* port : block_->GetInputPorts()) {
+    input_port_names.insert(port->GetName());
+  }
+  for (const auto& [name, value] : inputs) {
+    if (!input_port_names.contains(name)) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Block has no input port '%s'", name));
+    }
+  }
+
+  // Arguments are the input ports followed by the registers, matching the
+  // parameter order of the step function.
+  std::vector<Value> args;
+  args.reserve(block_->GetInputPorts().size() + register_state_.size());
+  for (InputPort* port : block_->GetInputPorts()) {
+    auto it = inputs.find(port->GetName());
+    if (it == inputs.end()) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Missing input for port '%s'", port->GetName()));
+    }
+    args.push_back(it->second);
+  }
+  for (const Value& reg_value : register_state_) {
+    args.push_back(reg_value);
+  }
+
+  XLS_ASSIGN_OR_RETURN(Value result, DropInterpreterEvents(jit_->Run(args)));
+
+  absl::flat_hash_map<std::string, Value> outputs;
+  int64_t element = 0;
+  for (OutputPort* port : block_->GetOutputPorts()) {
+    outputs[port->GetName()] = result.element(element++);
+  }
+  for (Value& reg_value : register_state_) {
+    reg_value = result.element(element++);
+  }
+  return std::move(outputs);
+}
+
+absl::flat_hash_map<std::string, Value> BlockJit::register_state() const {
+  absl::flat_hash_map<std::string, Value> state;
+  absl::Span<Register* const> registers = block_->GetRegisters();
+  for (int64_t i = 0; i < static_cast<int64_t>(registers.size()); ++i) {
+    state[registers[i]->name()] = register_state_[i];
+  }
+  return state;
+}
+
+absl::Status BlockJit::SetRegisterState(
+    const absl::flat_hash_map<std::string, Value>& reg_state) {
+  absl::Span<Register* const> registers = block_->GetRegisters();
+  for (const auto& [name, value] : reg_state) {
+    bool found = false;
+    for (int64_t i = 0; i < static_cast<int64_t>(registers.size()); ++i) {
+      if (registers[i]->name() == name) {
+        register_state_[i] = value;
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Block has no register '%s'", name));
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::vector<absl::flat_hash_map<std::string, Value>>>
+JitSequentialBlock(
+    Block* block,
+    absl::Span<const absl::flat_hash_map<std::string, Value>> inputs) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<BlockJit> jit, BlockJit::Create(block));
+  std::vector<absl::flat_hash_map<std::string, Value>> outputs;
+  outputs.reserve(inputs.size());
+  for (const absl::flat_hash_map<std::string, Value>& input_set : inputs) {
+    XLS_ASSIGN_OR_RETURN(absl::flat_hash_map<std::string, Value> output_set,
+                         jit->RunCycle(input_set));
+    outputs.push_back(std::move(output_set));
+  }
+  return std::move(outputs);
+}
+
+}  // namespace xls
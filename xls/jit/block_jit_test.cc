@@ -0,0 +1,152 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/block_jit.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+
+namespace xls {
+namespace {
+
+using status_testing::IsOkAndHolds;
+using status_testing::StatusIs;
+using testing::HasSubstr;
+using testing::Pair;
+using testing::UnorderedElementsAre;
+
+class BlockJitTest : public IrTestBase {};
+
+TEST_F(BlockJitTest, CombinationalBlock) {
+  auto package = CreatePackage();
+  BlockBuilder b(TestName(), package.get());
+  BValue x = b.InputPort("x", package->GetBitsType(32));
+  BValue y = b.InputPort("y", package->GetBitsType(32));
+  b.OutputPort("sum", b.Add(x, y));
+  b.OutputPort("diff", b.Subtract(x, y));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BlockJit> jit,
+                           BlockJit::Create(block));
+  EXPECT_THAT(
+      jit->RunCycle({{"x", Value(UBits(42, 32))}, {"y", Value(UBits(10, 32))}}),
+      IsOkAndHolds(UnorderedElementsAre(Pair("sum", Value(UBits(52, 32))),
+                                        Pair("diff", Value(UBits(32, 32))))));
+}
+
+TEST_F(BlockJitTest, RegisterState) {
+  // An accumulator which sums its input every cycle.
+  auto package = CreatePackage();
+  Type* u32 = package->GetBitsType(32);
+  BlockBuilder b(TestName(), package.get());
+  XLS_ASSERT_OK_AND_ASSIGN(Register * reg,
+                           b.block()->AddRegister("accum", u32));
+  BValue x = b.InputPort("x", u32);
+  BValue accum = b.RegisterRead(reg);
+  b.RegisterWrite(reg, b.Add(x, accum));
+  b.OutputPort("out", accum);
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BlockJit> jit,
+                           BlockJit::Create(block));
+  EXPECT_THAT(jit->RunCycle({{"x", Value(UBits(10, 32))}}),
+              IsOkAndHolds(UnorderedElementsAre(
+                  Pair("out", Value(UBits(0, 32))))));
+  EXPECT_THAT(jit->RunCycle({{"x", Value(UBits(32, 32))}}),
+              IsOkAndHolds(UnorderedElementsAre(
+                  Pair("out", Value(UBits(10, 32))))));
+  EXPECT_THAT(jit->register_state(),
+              UnorderedElementsAre(Pair("accum", Value(UBits(42, 32)))));
+
+  XLS_ASSERT_OK(jit->SetRegisterState({{"accum", Value(UBits(100, 32))}}));
+  EXPECT_THAT(jit->RunCycle({{"x", Value(UBits(1, 32))}}),
+              IsOkAndHolds(UnorderedElementsAre(
+                  Pair("out", Value(UBits(100, 32))))));
+}
+
+TEST_F(BlockJitTest, RegisterWithLoadEnable) {
+  auto package = CreatePackage();
+  Type* u32 = package->GetBitsType(32);
+  BlockBuilder b(TestName(), package.get());
+  XLS_ASSERT_OK_AND_ASSIGN(Register * reg, b.block()->AddRegister("r", u32));
+  BValue x = b.InputPort("x", u32);
+  BValue le = b.InputPort("le", package->GetBitsType(1));
+  b.RegisterWrite(reg, x, /*load_enable=*/le);
+  b.OutputPort("out", b.RegisterRead(reg));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BlockJit> jit,
+                           BlockJit::Create(block));
+  // Load enable deasserted: the register holds its value.
+  XLS_ASSERT_OK(jit->RunCycle(
+      {{"x", Value(UBits(42, 32))}, {"le", Value(UBits(0, 1))}}));
+  EXPECT_THAT(jit->register_state(),
+              UnorderedElementsAre(Pair("r", Value(UBits(0, 32)))));
+  // Load enable asserted: the register captures the input.
+  XLS_ASSERT_OK(jit->RunCycle(
+      {{"x", Value(UBits(42, 32))}, {"le", Value(UBits(1, 1))}}));
+  EXPECT_THAT(jit->register_state(),
+              UnorderedElementsAre(Pair("r", Value(UBits(42, 32)))));
+}
+
+TEST_F(BlockJitTest, InputErrors) {
+  auto package = CreatePackage();
+  BlockBuilder b(TestName(), package.get());
+  b.InputPort("x", package->GetBitsType(32));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BlockJit> jit,
+                           BlockJit::Create(block));
+  EXPECT_THAT(jit->RunCycle({{"a", Value(UBits(42, 32))},
+                             {"x", Value(UBits(42, 32))}}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Block has no input port 'a'")));
+  EXPECT_THAT(jit->RunCycle({}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Missing input for port 'x'")));
+  EXPECT_THAT(jit->SetRegisterState({{"r", Value(UBits(0, 32))}}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Block has no register 'r'")));
+}
+
+TEST_F(BlockJitTest, SequentialHelperMatchesInterpreterSemantics) {
+  // A single-register pipeline: the output is the input delayed one cycle.
+  auto package = CreatePackage();
+  Type* u32 = package->GetBitsType(32);
+  BlockBuilder b(TestName(), package.get());
+  XLS_ASSERT_OK_AND_ASSIGN(Register * reg, b.block()->AddRegister("p0", u32));
+  BValue x = b.InputPort("x", u32);
+  b.RegisterWrite(reg, x);
+  b.OutputPort("out", b.RegisterRead(reg));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * block, b.Build());
+
+  std::vector<absl::flat_hash_map<std::string, Value>> inputs = {
+      {{"x", Value(UBits(1, 32))}},
+      {{"x", Value(UBits(2, 32))}},
+      {{"x", Value(UBits(3, 32))}}};
+  XLS_ASSERT_OK_AND_ASSIGN(auto outputs, JitSequentialBlock(block, inputs));
+  ASSERT_EQ(outputs.size(), 3);
+  EXPECT_THAT(outputs[0],
+              UnorderedElementsAre(Pair("out", Value(UBits(0, 32)))));
+  EXPECT_THAT(outputs[1],
+              UnorderedElementsAre(Pair("out", Value(UBits(1, 32)))));
+  EXPECT_THAT(outputs[2],
+              UnorderedElementsAre(Pair("out", Value(UBits(2, 32)))));
+}
+
+}  // namespace
+}  // namespace xls
@@ -0,0 +1,68 @@
+# Copyright 2021 The XLS Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Contains macros for ahead-of-time compiling XLS functions."""
+
+load("//xls/build_rules:genrule_wrapper.bzl", "genrule_wrapper")
+
+def xls_aot_compile(
+        name,
+        src,
+        function = None,
+        entry_symbol = None,
+        llvm_opt_level = None,
+        **kwargs):
+    """Ahead-of-time compiles an XLS IR file into an object file and header.
+
+    Emits "<name>.o" and "<name>.h". The object file defines the function as
+    a plain symbol which can be linked into a binary (e.g. by listing this
+    target in the srcs of a cc_library) and called through the declaration in
+    the generated header with zero startup compilation.
+
+    Note that the object code targets the host on which the build runs; this
+    macro is not suitable for cross-compiled binaries.
+
+    Args:
+      name: Name of the generated genrule; also the basename of the outputs.
+      src: The IR file to compile. There should only be a single source file.
+      function: Optional name of the function in the IR file to compile. If
+        unspecified, the package entry function is used.
+      entry_symbol: Optional name for the emitted entry point symbol. If
+        unspecified, "<package>_<function>" is used.
+      llvm_opt_level: Optional LLVM optimization level (0-3).
+      **kwargs: Keyword args to pass to the genrule_wrapper rule.
+    """
+    args = [
+        "--ir_path=$(location {})".format(src),
+        "--output_object=$(location {}.o)".format(name),
+        "--output_header=$(location {}.h)".format(name),
+        "--genfiles_dir=$(GENDIR)",
+    ]
+    if function:
+        args.append("--function={}".format(function))
+    if entry_symbol:
+        args.append("--entry_symbol={}".format(entry_symbol))
+    if llvm_opt_level != None:
+        args.append("--llvm_opt_level={}".format(llvm_opt_level))
+    genrule_wrapper(
+        name = name,
+        srcs = [src],
+        outs = [
+            "{}.o".format(name),
+            "{}.h".format(name),
+        ],
+        cmd = "$(location //xls/jit:aot_compiler_main) " + " ".join(args),
+        exec_tools = ["//xls/jit:aot_compiler_main"],
+        **kwargs
+    )
@@ -13,8 +13,18 @@
 // limitations under the License.
 #include "xls/jit/function_builder_visitor.h"
 
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "absl/base/casts.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
 #include "llvm/include/llvm/IR/DerivedTypes.h"
+#include "llvm/include/llvm/IR/Intrinsics.h"
 #include "xls/common/logging/log_lines.h"
+#include "xls/jit/jit_profiler.h"
 #include "xls/common/logging/logging.h"
 #include "xls/ir/bits_ops.h"
 #include "xls/ir/events.h"
@@ -26,6 +36,7 @@
 
 #include "llvm/include/llvm/IR/Constants.h"
 #include "xls/codegen/vast.h"
+#include "xls/interpreter/function_interpreter.h"
 #include "xls/ir/function.h"
 #include "xls/ir/proc.h"
 
@@ -35,24 +46,27 @@ absl::Status FunctionBuilderVisitor::Visit(llvm::Module* module,
                                            llvm::Function* llvm_fn,
                                            FunctionBase* xls_fn,
                                            LlvmTypeConverter* type_converter,
-                                           bool is_top, bool generate_packed) {
+                                           bool is_top, bool generate_packed,
+                                           JitProfiler* profiler) {
   XLS_VLOG_LINES(3, std::string("Generating LLVM IR for XLS function/proc:\n") +
                         xls_fn->DumpIr());
   FunctionBuilderVisitor visitor(module, llvm_fn, xls_fn, type_converter,
-                                 is_top, generate_packed);
+                                 is_top, generate_packed, profiler);
   return visitor.BuildInternal();
 }
 
 FunctionBuilderVisitor::FunctionBuilderVisitor(
     llvm::Module* module, llvm::Function* llvm_fn, FunctionBase* xls_fn,
-    LlvmTypeConverter* type_converter, bool is_top, bool generate_packed)
+    LlvmTypeConverter* type_converter, bool is_top, bool generate_packed,
+    JitProfiler* profiler)
     : ctx_(module->getContext()),
       module_(module),
       llvm_fn_(llvm_fn),
       xls_fn_(xls_fn),
       type_converter_(type_converter),
       is_top_(is_top),
-      generate_packed_(generate_packed) {}
+      generate_packed_(generate_packed),
+      profiler_(profiler) {}
 
 absl::Status FunctionBuilderVisitor::BuildInternal() {
   auto basic_block = llvm::BasicBlock::Create(ctx_, "so_basic", llvm_fn_,
@@ -286,7 +300,7 @@ absl::Status FunctionBuilderVisitor::InvokeStringStepCallback(
 
 // This a shim to let JIT code record a completed trace as an interpreter event.
 static void RecordTrace(std::string* buffer, xls::InterpreterEvents* events) {
-  events->trace_msgs.push_back(*buffer);
+  events->RecordTrace(std::move(*buffer));
   delete buffer;
 }
 
@@ -967,7 +981,222 @@ absl::Status FunctionBuilderVisitor::HandleIdentity(UnOp* identity) {
   return StoreResult(identity, node_map_.at(identity->operand(0)));
 }
 
+namespace {
+
+// Packs an IEEE float, given as its raw bit pattern, into the
+// (sign, bexp, fraction) tuple representation used by the apfloat library.
+Value PackApfloat(uint64_t bits, int64_t exp_sz, int64_t frac_sz) {
+  uint64_t frac = bits & ((uint64_t{1} << frac_sz) - 1);
+  uint64_t bexp = (bits >> frac_sz) & ((uint64_t{1} << exp_sz) - 1);
+  uint64_t sign = (bits >> (exp_sz + frac_sz)) & 1;
+  return Value::Tuple({Value(UBits(sign, 1)), Value(UBits(bexp, exp_sz)),
+                       Value(UBits(frac, frac_sz))});
+}
+
+// Interprets 'callee' on a handful of probe inputs and compares each result
+// against the semantics of the native lowering: host float arithmetic with
+// subnormal inputs and outputs flushed to (signed) zero and NaN results
+// canonicalized to the library's qnan encoding. FloatT is float for binary32
+// and double for binary64 instantiations.
+template <typename FloatT, typename UintT>
+bool ApfloatProbesMatch(Function* callee, bool is_add, int64_t exp_sz,
+                        int64_t frac_sz) {
+  auto flush = [](FloatT value) {
+    return std::fpclassify(value) == FP_SUBNORMAL
+               ? std::copysign(FloatT{0}, value)
+               : value;
+  };
+  const FloatT inf = std::numeric_limits<FloatT>::infinity();
+  // Exactly representable values (no dependence on rounding), a subnormal
+  // which must flush, a signed-zero producing pair, and a NaN-producing pair
+  // which must canonicalize.
+  const std::pair<FloatT, FloatT> probes[] = {
+      {FloatT{1.5}, FloatT{2.25}},
+      {FloatT{-0.5}, FloatT{0.5}},
+      {std::numeric_limits<FloatT>::denorm_min(), FloatT{1.0}},
+      {inf, is_add ? -inf : FloatT{0}},
+  };
+  for (const auto& [a, b] : probes) {
+    FloatT expected = is_add ? flush(a) + flush(b) : flush(a) * flush(b);
+    expected = flush(expected);
+    uint64_t expected_bits;
+    if (std::isnan(expected)) {
+      // Canonical qnan: sign 0, all-ones exponent, leading fraction bit.
+      expected_bits = (((uint64_t{1} << exp_sz) - 1) << frac_sz) |
+                      (uint64_t{1} << (frac_sz - 1));
+    } else {
+      expected_bits = absl::bit_cast<UintT>(expected);
+    }
+    absl::StatusOr<InterpreterResult<Value>> result = InterpretFunction(
+        callee, {PackApfloat(absl::bit_cast<UintT>(a), exp_sz, frac_sz),
+                 PackApfloat(absl::bit_cast<UintT>(b), exp_sz, frac_sz)});
+    if (!result.ok() ||
+        result->value != PackApfloat(expected_bits, exp_sz, frac_sz)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool FunctionBuilderVisitor::VerifyApfloatCallee(Function* callee,
+                                                 ApfloatOp op, int64_t exp_sz,
+                                                 int64_t frac_sz) {
+  auto it = verified_apfloat_callees_.find(callee);
+  if (it != verified_apfloat_callees_.end()) {
+    return it->second;
+  }
+  bool is_add = op == ApfloatOp::kAdd;
+  bool verified =
+      exp_sz == 8 ? ApfloatProbesMatch<float, uint32_t>(callee, is_add, exp_sz,
+                                                        frac_sz)
+                  : ApfloatProbesMatch<double, uint64_t>(callee, is_add,
+                                                         exp_sz, frac_sz);
+  if (!verified) {
+    XLS_VLOG(2) << "Callee " << callee->name()
+                << " has an apfloat-mangled name but does not match apfloat "
+                   "semantics; not lowering to native float ops.";
+  }
+  verified_apfloat_callees_[callee] = verified;
+  return verified;
+}
+
+absl::StatusOr<bool> FunctionBuilderVisitor::TryLowerApfloatInvoke(
+    Invoke* invoke) {
+  // Match the DSLX mangled name of an apfloat add/mul instantiation,
+  // e.g. "__apfloat_add_2__add__8_23_9_10_28_29_27". The first two
+  // parametric values are EXP_SZ and FRACTION_SZ; the remainder are
+  // derived widths.
+  absl::string_view name = invoke->to_apply()->name();
+  ApfloatOp op;
+  if (absl::ConsumePrefix(&name, "__apfloat_add_2__add__")) {
+    op = ApfloatOp::kAdd;
+  } else if (absl::ConsumePrefix(&name, "__apfloat_mul_2__apfloat_mul_2__")) {
+    op = ApfloatOp::kMul;
+  } else {
+    return false;
+  }
+
+  std::vector<absl::string_view> parametrics = absl::StrSplit(name, '_');
+  int64_t exp_sz;
+  int64_t frac_sz;
+  if (parametrics.size() < 2 || !absl::SimpleAtoi(parametrics[0], &exp_sz) ||
+      !absl::SimpleAtoi(parametrics[1], &frac_sz)) {
+    return false;
+  }
+  // Only hardware-width instantiations map onto native instructions.
+  bool is_binary32 = exp_sz == 8 && frac_sz == 23;
+  bool is_binary64 = exp_sz == 11 && frac_sz == 52;
+  if (!is_binary32 && !is_binary64) {
+    return false;
+  }
+
+  // The operands and result must be (sign: u1, bexp: uN[E], fraction:
+  // uN[F]) tuples; anything else (e.g. a same-named user function)
+  // takes the ordinary call path.
+  auto is_apfloat_type = [&](Type* type) {
+    if (!type->IsTuple()) {
+      return false;
+    }
+    TupleType* tuple_type = type->AsTupleOrDie();
+    auto is_bits = [&](int64_t index, int64_t width) {
+      Type* element = tuple_type->element_type(index);
+      return element->IsBits() && element->GetFlatBitCount() == width;
+    };
+    return tuple_type->size() == 3 && is_bits(0, 1) && is_bits(1, exp_sz) &&
+           is_bits(2, frac_sz);
+  };
+  if (invoke->operand_count() != 2 ||
+      !is_apfloat_type(invoke->operand(0)->GetType()) ||
+      !is_apfloat_type(invoke->operand(1)->GetType()) ||
+      !is_apfloat_type(invoke->GetType())) {
+    return false;
+  }
+
+  // A matching name and signature is necessary but not sufficient: nothing
+  // stops a user function from carrying this name with different semantics,
+  // and the JIT must agree with the interpreter on every function. Probe the
+  // callee's actual behavior before substituting.
+  if (!VerifyApfloatCallee(invoke->to_apply(), op, exp_sz, frac_sz)) {
+    return false;
+  }
+
+  int64_t total_bits = 1 + exp_sz + frac_sz;
+  llvm::Type* bits_type = llvm::Type::getIntNTy(ctx(), total_bits);
+  llvm::Type* float_type = is_binary32 ? llvm::Type::getFloatTy(ctx())
+                                       : llvm::Type::getDoubleTy(ctx());
+  llvm::Value* exp_zero =
+      llvm::ConstantInt::get(llvm::Type::getIntNTy(ctx(), exp_sz), 0);
+  llvm::Value* exp_ones = llvm::ConstantInt::getSigned(
+      llvm::Type::getIntNTy(ctx(), exp_sz), -1);
+  llvm::Value* frac_zero =
+      llvm::ConstantInt::get(llvm::Type::getIntNTy(ctx(), frac_sz), 0);
+
+  // Flattens an apfloat struct into a native float, flushing subnormal
+  // inputs to (signed) zero as the library does.
+  auto to_native = [&](llvm::Value* apfloat) {
+    llvm::Value* sign = builder_->CreateExtractValue(apfloat, {0});
+    llvm::Value* bexp = builder_->CreateExtractValue(apfloat, {1});
+    llvm::Value* frac = builder_->CreateExtractValue(apfloat, {2});
+    frac = builder_->CreateSelect(builder_->CreateICmpEQ(bexp, exp_zero),
+                                  frac_zero, frac);
+    llvm::Value* bits = builder_->CreateOr(
+        builder_->CreateShl(builder_->CreateZExt(sign, bits_type),
+                            total_bits - 1),
+        builder_->CreateOr(
+            builder_->CreateShl(builder_->CreateZExt(bexp, bits_type),
+                                frac_sz),
+            builder_->CreateZExt(frac, bits_type)));
+    return builder_->CreateBitCast(bits, float_type);
+  };
+
+  llvm::Value* lhs = to_native(node_map_.at(invoke->operand(0)));
+  llvm::Value* rhs = to_native(node_map_.at(invoke->operand(1)));
+  llvm::Value* native_result = op == ApfloatOp::kAdd
+                                   ? builder_->CreateFAdd(lhs, rhs)
+                                   : builder_->CreateFMul(lhs, rhs);
+
+  // Unpack the result, flushing subnormal outputs to zero and
+  // canonicalizing any NaN to the library's qnan encoding (sign 0,
+  // fraction with only the leading bit set).
+  llvm::Value* bits = builder_->CreateBitCast(native_result, bits_type);
+  llvm::Value* sign = builder_->CreateTrunc(
+      builder_->CreateLShr(bits, total_bits - 1), llvm::Type::getInt1Ty(ctx()));
+  llvm::Value* bexp = builder_->CreateTrunc(
+      builder_->CreateLShr(bits, frac_sz), llvm::Type::getIntNTy(ctx(), exp_sz));
+  llvm::Value* frac =
+      builder_->CreateTrunc(bits, llvm::Type::getIntNTy(ctx(), frac_sz));
+
+  frac = builder_->CreateSelect(builder_->CreateICmpEQ(bexp, exp_zero),
+                                frac_zero, frac);
+  llvm::Value* is_nan =
+      builder_->CreateAnd(builder_->CreateICmpEQ(bexp, exp_ones),
+                          builder_->CreateICmpNE(frac, frac_zero));
+  sign = builder_->CreateSelect(
+      is_nan, llvm::ConstantInt::getFalse(ctx()), sign);
+  frac = builder_->CreateSelect(
+      is_nan,
+      llvm::ConstantInt::get(llvm::Type::getIntNTy(ctx(), frac_sz),
+                             uint64_t{1} << (frac_sz - 1)),
+      frac);
+
+  llvm::Type* result_type =
+      type_converter_->ConvertToLlvmType(invoke->GetType());
+  llvm::Value* result = CreateTypedZeroValue(result_type);
+  result = builder_->CreateInsertValue(result, sign, {0});
+  result = builder_->CreateInsertValue(result, bexp, {1});
+  result = builder_->CreateInsertValue(result, frac, {2});
+  XLS_RETURN_IF_ERROR(StoreResult(invoke, result));
+  return true;
+}
+
 absl::Status FunctionBuilderVisitor::HandleInvoke(Invoke* invoke) {
+  XLS_ASSIGN_OR_RETURN(bool lowered_as_apfloat, TryLowerApfloatInvoke(invoke));
+  if (lowered_as_apfloat) {
+    return absl::OkStatus();
+  }
+
   XLS_ASSIGN_OR_RETURN(llvm::Function * function,
                        GetModuleFunction(invoke->to_apply()));
 
@@ -1026,7 +1255,48 @@ absl::Status FunctionBuilderVisitor::HandleUMul(ArithOp* mul) {
   return HandleArithOp(mul);
 }
 
+bool FunctionBuilderVisitor::ShouldLowerAsWideVector(Node* node) {
+  return node->GetType()->IsBits() &&
+         node->BitCountOrDie() > kWideBitsVectorThreshold;
+}
+
+llvm::Value* FunctionBuilderVisitor::ToWideVector(llvm::Value* value,
+                                                  int64_t bit_count) {
+  int64_t num_limbs = (bit_count + 63) / 64;
+  llvm::Value* padded = builder_->CreateZExt(
+      value, llvm::IntegerType::get(ctx_, num_limbs * 64));
+  return builder_->CreateBitCast(
+      padded,
+      llvm::FixedVectorType::get(llvm::Type::getInt64Ty(ctx_), num_limbs));
+}
+
+llvm::Value* FunctionBuilderVisitor::FromWideVector(llvm::Value* vector,
+                                                    int64_t bit_count) {
+  int64_t num_limbs = (bit_count + 63) / 64;
+  llvm::Value* padded = builder_->CreateBitCast(
+      vector, llvm::IntegerType::get(ctx_, num_limbs * 64));
+  return builder_->CreateTrunc(padded,
+                               llvm::IntegerType::get(ctx_, bit_count));
+}
+
+absl::Status FunctionBuilderVisitor::HandleWideNaryOp(
+    NaryOp* op, llvm::Instruction::BinaryOps opcode, bool invert) {
+  int64_t bit_count = op->BitCountOrDie();
+  llvm::Value* result = ToWideVector(node_map_.at(op->operand(0)), bit_count);
+  for (int i = 1; i < op->operand_count(); ++i) {
+    result = builder_->CreateBinOp(
+        opcode, result, ToWideVector(node_map_.at(op->operand(i)), bit_count));
+  }
+  if (invert) {
+    result = builder_->CreateNot(result);
+  }
+  return StoreResult(op, FromWideVector(result, bit_count));
+}
+
 absl::Status FunctionBuilderVisitor::HandleNaryAnd(NaryOp* and_op) {
+  if (ShouldLowerAsWideVector(and_op)) {
+    return HandleWideNaryOp(and_op, llvm::Instruction::And, /*invert=*/false);
+  }
   llvm::Value* result = node_map_.at((and_op->operand(0)));
   for (int i = 1; i < and_op->operand_count(); ++i) {
     result = builder_->CreateAnd(result, node_map_.at(and_op->operand(i)));
@@ -1035,6 +1305,9 @@ absl::Status FunctionBuilderVisitor::HandleNaryAnd(NaryOp* and_op) {
 }
 
 absl::Status FunctionBuilderVisitor::HandleNaryNand(NaryOp* nand_op) {
+  if (ShouldLowerAsWideVector(nand_op)) {
+    return HandleWideNaryOp(nand_op, llvm::Instruction::And, /*invert=*/true);
+  }
   llvm::Value* result = node_map_.at((nand_op->operand(0)));
   for (int i = 1; i < nand_op->operand_count(); ++i) {
     result = builder_->CreateAnd(result, node_map_.at(nand_op->operand(i)));
@@ -1044,6 +1317,9 @@ absl::Status FunctionBuilderVisitor::HandleNaryNand(NaryOp* nand_op) {
 }
 
 absl::Status FunctionBuilderVisitor::HandleNaryNor(NaryOp* nor_op) {
+  if (ShouldLowerAsWideVector(nor_op)) {
+    return HandleWideNaryOp(nor_op, llvm::Instruction::Or, /*invert=*/true);
+  }
   llvm::Value* result = node_map_.at((nor_op->operand(0)));
   for (int i = 1; i < nor_op->operand_count(); ++i) {
     result = builder_->CreateOr(result, node_map_.at(nor_op->operand(i)));
@@ -1053,6 +1329,9 @@ absl::Status FunctionBuilderVisitor::HandleNaryNor(NaryOp* nor_op) {
 }
 
 absl::Status FunctionBuilderVisitor::HandleNaryOr(NaryOp* or_op) {
+  if (ShouldLowerAsWideVector(or_op)) {
+    return HandleWideNaryOp(or_op, llvm::Instruction::Or, /*invert=*/false);
+  }
   llvm::Value* result = node_map_.at((or_op->operand(0)));
   for (int i = 1; i < or_op->operand_count(); ++i) {
     result = builder_->CreateOr(result, node_map_.at(or_op->operand(i)));
@@ -1061,6 +1340,9 @@ absl::Status FunctionBuilderVisitor::HandleNaryOr(NaryOp* or_op) {
 }
 
 absl::Status FunctionBuilderVisitor::HandleNaryXor(NaryOp* xor_op) {
+  if (ShouldLowerAsWideVector(xor_op)) {
+    return HandleWideNaryOp(xor_op, llvm::Instruction::Xor, /*invert=*/false);
+  }
   llvm::Value* result = node_map_.at((xor_op->operand(0)));
   for (int i = 1; i < xor_op->operand_count(); ++i) {
     result = builder_->CreateXor(result, node_map_.at(xor_op->operand(i)));
@@ -1091,6 +1373,13 @@ absl::Status FunctionBuilderVisitor::HandleNeg(UnOp* neg) {
 }
 
 absl::Status FunctionBuilderVisitor::HandleNot(UnOp* not_op) {
+  if (ShouldLowerAsWideVector(not_op)) {
+    int64_t bit_count = not_op->BitCountOrDie();
+    llvm::Value* wide =
+        ToWideVector(node_map_.at(not_op->operand(0)), bit_count);
+    return StoreResult(not_op,
+                       FromWideVector(builder_->CreateNot(wide), bit_count));
+  }
   llvm::Value* llvm_not = builder_->CreateNot(node_map_.at(not_op->operand(0)));
   return StoreResult(not_op, llvm_not);
 }
@@ -1793,7 +2082,7 @@ absl::StatusOr<llvm::Function*> FunctionBuilderVisitor::GetModuleFunction(
   // TODO(rspringer): Need to override this for Procs.
   XLS_RETURN_IF_ERROR(FunctionBuilderVisitor::Visit(
       module_, llvm_function, xls_function, type_converter_,
-      /*is_top=*/false, /*generate_packed=*/false));
+      /*is_top=*/false, /*generate_packed=*/false, profiler_));
 
   return llvm_function;
 }
@@ -1806,10 +2095,47 @@ absl::Status FunctionBuilderVisitor::StoreResult(Node* node,
     return_value_ = value;
   }
   node_map_[node] = value;
+  if (profiler_ != nullptr) {
+    EmitProfileCounters(node);
+  }
 
   return absl::OkStatus();
 }
 
+void FunctionBuilderVisitor::EmitProfileCounters(Node* node) {
+  llvm::Type* i64_type = llvm::Type::getInt64Ty(ctx_);
+  llvm::Function* read_cycle_counter = llvm::Intrinsic::getDeclaration(
+      module_, llvm::Intrinsic::readcyclecounter);
+  llvm::Value* now = builder_->CreateCall(read_cycle_counter);
+  if (profile_last_cycles_ == nullptr) {
+    // The first instrumented node is emitted into the entry block, which
+    // dominates the rest of the function, so the alloca is visible to every
+    // later node. The first node is charged zero cycles.
+    profile_last_cycles_ = builder_->CreateAlloca(i64_type);
+    builder_->CreateStore(now, profile_last_cycles_);
+  }
+  llvm::Value* last = builder_->CreateLoad(i64_type, profile_last_cycles_);
+  llvm::Value* delta = builder_->CreateSub(now, last);
+  builder_->CreateStore(now, profile_last_cycles_);
+
+  // The counter slots live in the JitProfiler; their addresses are baked into
+  // the generated code, just like the assert/trace callback addresses above.
+  auto slot_ptr = [&](uint64_t* slot) {
+    return builder_->CreateIntToPtr(
+        llvm::ConstantInt::get(i64_type, absl::bit_cast<uint64_t>(slot)),
+        llvm::PointerType::get(i64_type, 0));
+  };
+  llvm::Value* count_ptr = slot_ptr(profiler_->GetCountSlot(node));
+  builder_->CreateStore(
+      builder_->CreateAdd(builder_->CreateLoad(i64_type, count_ptr),
+                          llvm::ConstantInt::get(i64_type, 1)),
+      count_ptr);
+  llvm::Value* cycles_ptr = slot_ptr(profiler_->GetCyclesSlot(node));
+  builder_->CreateStore(
+      builder_->CreateAdd(builder_->CreateLoad(i64_type, cycles_ptr), delta),
+      cycles_ptr);
+}
+
 absl::StatusOr<llvm::Value*> FunctionBuilderVisitor::PackElement(
     llvm::Value* element, Type* element_type, llvm::Value* buffer,
     int64_t bit_offset) {
@@ -29,6 +29,8 @@
 
 namespace xls {
 
+class JitProfiler;
+
 // Visitor to construct LLVM IR for each encountered XLS IR node. Based on
 // DfsVisitorWithDefault to highlight any unhandled IR nodes.
 class FunctionBuilderVisitor : public DfsVisitorWithDefault {
@@ -39,10 +41,14 @@ class FunctionBuilderVisitor : public DfsVisitorWithDefault {
   //   is_top: true if this is the top-level function being translated,
   //     false if this is a function invocation from already inside "LLVM
   //     space".
+  //   profiler: if non-null, per-node profiling counters are inserted after
+  //     every node's computation, with slots drawn from (and results reported
+  //     through) the given profiler.
   static absl::Status Visit(llvm::Module* module, llvm::Function* llvm_fn,
                             FunctionBase* xls_fn,
                             LlvmTypeConverter* type_converter, bool is_top,
-                            bool generate_packed);
+                            bool generate_packed,
+                            JitProfiler* profiler = nullptr);
 
   absl::Status DefaultHandler(Node* node) override {
     return absl::UnimplementedError(
@@ -130,7 +136,8 @@ class FunctionBuilderVisitor : public DfsVisitorWithDefault {
   FunctionBuilderVisitor(llvm::Module* module, llvm::Function* llvm_fn,
                          FunctionBase* xls_fn,
                          LlvmTypeConverter* type_converter, bool is_top,
-                         bool generate_packed);
+                         bool generate_packed,
+                         JitProfiler* profiler = nullptr);
 
   llvm::LLVMContext& ctx() { return ctx_; }
   llvm::Module* module() { return module_; }
@@ -150,6 +157,30 @@ class FunctionBuilderVisitor : public DfsVisitorWithDefault {
   // Array, or Tuple.
   llvm::Constant* CreateTypedZeroValue(llvm::Type* type);
 
+  // Bits values wider than this threshold have their bitwise operations
+  // lowered through vectors of i64 limbs rather than a single arbitrary
+  // precision iN value. LLVM legalizes wide iN bitwise operations into long
+  // scalar sequences; the equivalent <K x i64> operations map directly onto
+  // SIMD instructions. Arithmetic (carry-propagating) operations keep the iN
+  // lowering, whose legalization into add-with-carry chains is already good.
+  static constexpr int64_t kWideBitsVectorThreshold = 128;
+
+  // Returns true if "node" is a Bits value wide enough to profit from the
+  // vector-of-i64 bitwise lowering.
+  bool ShouldLowerAsWideVector(Node* node);
+
+  // Reinterprets the iN value "value" as a vector of i64 limbs (zero-padding
+  // the most significant limb), and the inverse transformation.
+  llvm::Value* ToWideVector(llvm::Value* value, int64_t bit_count);
+  llvm::Value* FromWideVector(llvm::Value* vector, int64_t bit_count);
+
+  // Lowers an n-ary bitwise operation over wide Bits values as element-wise
+  // vector instructions, inverting the result if "invert" is set (for
+  // nand/nor).
+  absl::Status HandleWideNaryOp(NaryOp* op,
+                                llvm::Instruction::BinaryOps opcode,
+                                bool invert);
+
   // After the original arguments, JIT-compiled functions always end with
   // the following four pointer arguments: output buffer, interpreter events
   // temporary, user data and JIT runtime. These are descriptive convenience
@@ -176,8 +207,27 @@ class FunctionBuilderVisitor : public DfsVisitorWithDefault {
   }
 
  private:
-  // Common handler for all arithmetic ops.
-  absl::Status HandleArithOp(ArithOp* arith_op);
+  // Recognized DSLX apfloat operations which can lower to native float
+  // instructions.
+  enum class ApfloatOp { kAdd, kMul };
+
+  // If the invoke targets a recognized apfloat add/mul instantiation at
+  // binary32/binary64 widths -- detected from the DSLX mangled callee
+  // name and verified against the callee's actual behavior -- emits
+  // native LLVM float arithmetic instead of a call, with flush-to-zero
+  // and NaN canonicalization wrappers matching the library's semantics.
+  // Returns true if the invoke was lowered this way, false to fall back
+  // to the ordinary call path.
+  absl::StatusOr<bool> TryLowerApfloatInvoke(Invoke* invoke);
+
+  // Returns whether 'callee' behaves as the apfloat operation its mangled
+  // name claims, by interpreting it on a handful of probe inputs (ordinary
+  // values, subnormals, and a NaN-producing pair) and comparing against the
+  // semantics the native lowering emits. A stubbed or otherwise modified
+  // body fails the probes and keeps the ordinary call path, so the name
+  // match alone never changes semantics. Results are cached per callee.
+  bool VerifyApfloatCallee(Function* callee, ApfloatOp op, int64_t exp_sz,
+                           int64_t frac_sz);
 
   // Common handler for all binary ops.
   absl::Status HandleBinOp(BinOp* binop);
@@ -222,6 +272,11 @@ class FunctionBuilderVisitor : public DfsVisitorWithDefault {
                                            llvm::Value* buffer,
                                            int64_t bit_offset);
 
+  // Emits the profiling instrumentation for "node": bumps its execution
+  // count and charges it the cycles elapsed since the previously completed
+  // node. Only called when profiler_ is non-null.
+  void EmitProfileCounters(Node* node);
+
   // Marks the output value as "unpoisoned" for MSAN - in other words, prevent
   // false positives from being thrown when running under MSAN (since it can't
   // yet follow values into LLVM space (it might be able to _technically_, but
@@ -272,6 +327,15 @@ class FunctionBuilderVisitor : public DfsVisitorWithDefault {
   // header comment for IrJit::RunWithPackedViews()).
   bool generate_packed_;
 
+  // If non-null, per-node profiling counters are emitted after every node
+  // (see EmitProfileCounters()).
+  JitProfiler* profiler_;
+
+  // Stack slot holding the cycle counter reading taken after the most
+  // recently completed node; created lazily in the entry block by the first
+  // instrumented node.
+  llvm::Value* profile_last_cycles_ = nullptr;
+
   // The last value constructed during this traversal - represents the return
   // from calculation.
   llvm::Value* return_value_;
@@ -283,6 +347,10 @@ class FunctionBuilderVisitor : public DfsVisitorWithDefault {
   // storage to extract elements (i.e., for GEPs), it makes sense to only create
   // and store the array once.
   absl::flat_hash_map<llvm::Value*, llvm::AllocaInst*> array_storage_;
+
+  // Caches VerifyApfloatCallee results so a callee invoked many times is
+  // only probed once per translation.
+  absl::flat_hash_map<Function*, bool> verified_apfloat_callees_;
 };
 
 }  // namespace xls
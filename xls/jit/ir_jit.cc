@@ -14,16 +14,21 @@
 
 #include "xls/jit/ir_jit.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <memory>
+#include <thread>  // NOLINT(build/c++11): only used for hardware_concurrency.
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/flags/flag.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "llvm/include/llvm-c/Target.h"
 #include "llvm/include/llvm/Analysis/TargetLibraryInfo.h"
@@ -55,6 +60,7 @@
 #include "llvm/include/llvm/Transforms/IPO/PassManagerBuilder.h"
 #include "xls/codegen/vast.h"
 #include "xls/common/logging/log_lines.h"
+#include "xls/common/thread.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/logging/vlog_is_on.h"
 #include "xls/common/math_util.h"
@@ -81,6 +87,38 @@ void OnceInit() {
   LLVMInitializeNativeAsmParser();
 }
 
+// Returns true if the code generated for "function" (or for any function it
+// transitively invokes) embeds the absolute address of a runtime callback in
+// the current process. Assert and trace operations are lowered to calls
+// through such addresses, so their object code cannot be reused across
+// process boundaries (e.g. via an on-disk object cache).
+bool HasProcessBoundCallbacks(FunctionBase* function) {
+  std::deque<FunctionBase*> worklist = {function};
+  absl::flat_hash_set<FunctionBase*> visited;
+  while (!worklist.empty()) {
+    FunctionBase* f = worklist.front();
+    worklist.pop_front();
+    if (!visited.insert(f).second) {
+      continue;
+    }
+    for (Node* node : f->nodes()) {
+      if (node->Is<Assert>() || node->Is<Trace>()) {
+        return true;
+      }
+      if (node->Is<Invoke>()) {
+        worklist.push_back(node->As<Invoke>()->to_apply());
+      } else if (node->Is<Map>()) {
+        worklist.push_back(node->As<Map>()->to_apply());
+      } else if (node->Is<CountedFor>()) {
+        worklist.push_back(node->As<CountedFor>()->body());
+      } else if (node->Is<DynamicCountedFor>()) {
+        worklist.push_back(node->As<DynamicCountedFor>()->body());
+      }
+    }
+  }
+  return false;
+}
+
 }  // namespace
 
 IrJit::~IrJit() {
@@ -89,12 +127,25 @@ IrJit::~IrJit() {
   }
 }
 
-absl::StatusOr<std::unique_ptr<IrJit>> IrJit::Create(Function* xls_function,
-                                                     int64_t opt_level) {
+absl::StatusOr<std::unique_ptr<IrJit>> IrJit::Create(
+    Function* xls_function, int64_t opt_level, JitObjectCache* object_cache) {
   absl::call_once(once, OnceInit);
 
   auto jit = absl::WrapUnique(new IrJit(xls_function, opt_level));
+#ifndef ABSL_HAVE_MEMORY_SANITIZER
+  // Under msan the generated code for *every* function embeds the address of
+  // __msan_unpoison, so cached objects are never reusable across processes.
+  if (object_cache != nullptr && !HasProcessBoundCallbacks(xls_function)) {
+    jit->object_cache_ = object_cache;
+  }
+#endif
   XLS_RETURN_IF_ERROR(jit->Init());
+  if (jit->object_cache_ != nullptr) {
+    jit->cache_key_ = JitObjectCache::MakeCacheKey(
+        xls_function->DumpIr(), opt_level,
+        jit->target_machine_->getTargetTriple().str(),
+        jit->data_layout_.getStringRepresentation());
+  }
   auto visit_fn = [&jit](llvm::Module* module, llvm::Function* llvm_function,
                          bool generate_packed) {
     return FunctionBuilderVisitor::Visit(
@@ -105,6 +156,65 @@ absl::StatusOr<std::unique_ptr<IrJit>> IrJit::Create(Function* xls_function,
   return jit;
 }
 
+absl::StatusOr<std::unique_ptr<IrJit>> IrJit::CreateProfiled(
+    Function* xls_function, int64_t opt_level) {
+  absl::call_once(once, OnceInit);
+
+  auto jit = absl::WrapUnique(new IrJit(xls_function, opt_level));
+  // The profiler's counter addresses are baked into the generated code, so
+  // instrumented objects are process-bound and never eligible for the object
+  // cache.
+  jit->profiler_ = std::make_unique<JitProfiler>();
+  XLS_RETURN_IF_ERROR(jit->Init());
+  auto visit_fn = [&jit](llvm::Module* module, llvm::Function* llvm_function,
+                         bool generate_packed) {
+    return FunctionBuilderVisitor::Visit(
+        module, llvm_function, jit->xls_function_, jit->type_converter_.get(),
+        /*is_top=*/true, generate_packed, jit->profiler_.get());
+  };
+  XLS_RETURN_IF_ERROR(jit->Compile(visit_fn));
+  return jit;
+}
+
+absl::StatusOr<std::vector<std::unique_ptr<IrJit>>> IrJit::CreateParallel(
+    absl::Span<Function* const> xls_functions, int64_t opt_level,
+    int64_t num_threads) {
+  if (num_threads == 0) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  num_threads = std::min<int64_t>(num_threads, xls_functions.size());
+
+  std::vector<std::unique_ptr<IrJit>> jits(xls_functions.size());
+  absl::Mutex mutex;
+  absl::Status first_error;
+
+  // Each IrJit carries its own LLVMContext and ExecutionSession, so whole
+  // compilations are independent and can simply be striped across threads.
+  std::vector<std::unique_ptr<Thread>> workers;
+  workers.reserve(num_threads);
+  for (int64_t thread_index = 0; thread_index < num_threads; ++thread_index) {
+    workers.push_back(std::make_unique<Thread>([&, thread_index]() {
+      for (int64_t i = thread_index; i < xls_functions.size();
+           i += num_threads) {
+        absl::StatusOr<std::unique_ptr<IrJit>> jit =
+            Create(xls_functions[i], opt_level);
+        absl::MutexLock lock(&mutex);
+        if (!jit.ok()) {
+          first_error.Update(jit.status());
+          return;
+        }
+        jits[i] = std::move(jit.value());
+      }
+    }));
+  }
+  for (auto& worker : workers) {
+    worker->Join();
+  }
+
+  XLS_RETURN_IF_ERROR(first_error);
+  return jits;
+}
+
 absl::StatusOr<std::unique_ptr<IrJit>> IrJit::CreateProc(
     Proc* proc, JitChannelQueueManager* queue_mgr,
     ProcBuilderVisitor::RecvFnT recv_fn, ProcBuilderVisitor::SendFnT send_fn,
@@ -126,7 +236,11 @@ absl::StatusOr<std::unique_ptr<IrJit>> IrJit::CreateProc(
 
 absl::Status IrJit::Compile(VisitFn visit_fn) {
   llvm::LLVMContext* bare_context = context_.getContext();
-  auto module = std::make_unique<llvm::Module>("the_module", *bare_context);
+  // When object caching is enabled the module is named after the cache key so
+  // the cache can identify the compilation from the module alone.
+  auto module = std::make_unique<llvm::Module>(
+      object_cache_ == nullptr ? std::string("the_module") : cache_key_,
+      *bare_context);
   module->setDataLayout(data_layout_);
   XLS_RETURN_IF_ERROR(CompileFunction(visit_fn, module.get()));
   XLS_RETURN_IF_ERROR(CompilePackedViewFunction(visit_fn, module.get()));
@@ -179,6 +293,15 @@ llvm::Expected<llvm::orc::ThreadSafeModule> IrJit::Optimizer(
     const llvm::orc::MaterializationResponsibility& responsibility) {
   llvm::Module* bare_module = module.getModuleUnlocked();
 
+  if (object_cache_ != nullptr &&
+      object_cache_->Contains(bare_module->getModuleIdentifier())) {
+    // The compile layer will satisfy this module from the object cache, so
+    // running the LLVM optimization pipeline here would be wasted work.
+    XLS_VLOG(2) << "Skipping LLVM optimization; object cache hit for "
+                << bare_module->getModuleIdentifier();
+    return module;
+  }
+
   XLS_VLOG(2) << "Unoptimized module IR:";
   XLS_VLOG(2).NoPrefix() << ir_runtime_->DumpToString(*bare_module);
 
@@ -256,7 +379,8 @@ absl::Status IrJit::Init() {
             data_layout_.getGlobalPrefix())));
   });
 
-  auto compiler = std::make_unique<llvm::orc::SimpleCompiler>(*target_machine_);
+  auto compiler = std::make_unique<llvm::orc::SimpleCompiler>(*target_machine_,
+                                                              object_cache_);
   compile_layer_ = std::make_unique<llvm::orc::IRCompileLayer>(
       execution_session_, object_layer_, std::move(compiler));
 
@@ -386,6 +510,57 @@ absl::StatusOr<InterpreterResult<Value>> IrJit::Run(
   return Run(positional_args, user_data);
 }
 
+absl::StatusOr<std::vector<InterpreterResult<Value>>> IrJit::RunBatch(
+    absl::Span<const std::vector<Value>> args_batch, void* user_data) {
+  absl::Span<Param* const> params = xls_function_->params();
+
+  // Allocate the argument and result buffers once up front; they are
+  // overwritten in place for each argument set in the batch.
+  std::vector<std::unique_ptr<uint8_t[]>> unique_arg_buffers;
+  std::vector<uint8_t*> arg_buffers;
+  unique_arg_buffers.reserve(params.size());
+  arg_buffers.reserve(params.size());
+  std::vector<Type*> param_types;
+  for (const Param* param : params) {
+    unique_arg_buffers.push_back(std::make_unique<uint8_t[]>(
+        type_converter_->GetTypeByteSize(param->GetType())));
+    arg_buffers.push_back(unique_arg_buffers.back().get());
+    param_types.push_back(param->GetType());
+  }
+  absl::InlinedVector<uint8_t, 16> result_buffer(return_type_bytes_);
+  Type* return_type =
+      FunctionBuilderVisitor::GetEffectiveReturnValue(xls_function_)->GetType();
+
+  std::vector<InterpreterResult<Value>> results;
+  results.reserve(args_batch.size());
+  for (const std::vector<Value>& args : args_batch) {
+    if (args.size() != params.size()) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Arg list to '%s' has the wrong size: %d vs expected %d.",
+          xls_function_->name(), args.size(), params.size()));
+    }
+    for (int i = 0; i < params.size(); i++) {
+      if (!ValueConformsToType(args[i], params[i]->GetType())) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "Got argument %s for parameter %d which is not of type %s",
+            args[i].ToString(), i, params[i]->GetType()->ToString()));
+      }
+    }
+
+    XLS_RETURN_IF_ERROR(
+        ir_runtime_->PackArgs(args, param_types, absl::MakeSpan(arg_buffers)));
+
+    InterpreterEvents events;
+    invoker_(arg_buffers.data(), result_buffer.data(), &events, user_data,
+             runtime());
+
+    results.push_back(InterpreterResult<Value>{
+        ir_runtime_->UnpackBuffer(result_buffer.data(), return_type),
+        std::move(events)});
+  }
+  return results;
+}
+
 absl::Status IrJit::RunWithViews(absl::Span<uint8_t*> args,
                                  absl::Span<uint8_t> result_buffer,
                                  void* user_data) {
@@ -35,6 +35,8 @@
 #include "xls/ir/value.h"
 #include "xls/ir/value_view.h"
 #include "xls/jit/jit_channel_queue.h"
+#include "xls/jit/jit_object_cache.h"
+#include "xls/jit/jit_profiler.h"
 #include "xls/jit/jit_runtime.h"
 #include "xls/jit/llvm_type_converter.h"
 #include "xls/jit/proc_builder_visitor.h"
@@ -48,9 +50,35 @@ class IrJit {
   ~IrJit();
 
   // Returns an object containing a host-compiled version of the specified XLS
-  // function.
-  static absl::StatusOr<std::unique_ptr<IrJit>> Create(Function* xls_function,
-                                                       int64_t opt_level = 3);
+  // function. If "object_cache" is non-null, compiled object code is loaded
+  // from and stored to the cache so repeated compilations of the same IR
+  // (possibly across processes) skip LLVM optimization and codegen. Functions
+  // which contain assert or trace operations are always compiled from scratch
+  // because their generated code embeds the addresses of runtime callbacks in
+  // the current process.
+  static absl::StatusOr<std::unique_ptr<IrJit>> Create(
+      Function* xls_function, int64_t opt_level = 3,
+      JitObjectCache* object_cache = nullptr);
+
+  // Compiles the given functions concurrently on "num_threads" threads (if
+  // zero, one per hardware thread) and returns one IrJit per function, in
+  // order. Each IrJit owns an independent LLVM context and session, so
+  // LLVM optimization and codegen for the functions proceed in parallel;
+  // for packages with many functions this makes JIT warm-up scale with the
+  // number of cores.
+  static absl::StatusOr<std::vector<std::unique_ptr<IrJit>>> CreateParallel(
+      absl::Span<Function* const> xls_functions, int64_t opt_level = 3,
+      int64_t num_threads = 0);
+
+  // As Create(), but compiles with per-node profiling instrumentation: every
+  // XLS node bumps an execution counter and is charged the cycles spent
+  // computing it, keyed by Node::id(). The collected profile is available
+  // through profiler() after running the function; it identifies which nodes
+  // dominate execution time even after LLVM has fused their instructions.
+  // Instrumented code is substantially slower than a plain Create() build, so
+  // use this mode for diagnosis, not deployment.
+  static absl::StatusOr<std::unique_ptr<IrJit>> CreateProfiled(
+      Function* xls_function, int64_t opt_level = 3);
   static absl::StatusOr<std::unique_ptr<IrJit>> CreateProc(
       Proc* proc, JitChannelQueueManager* queue_mgr,
       ProcBuilderVisitor::RecvFnT recv_fn, ProcBuilderVisitor::SendFnT send_fn,
@@ -68,6 +96,16 @@ class IrJit {
       const absl::flat_hash_map<std::string, Value>& kwargs,
       void* user_data = nullptr);
 
+  // Executes the compiled function over a batch of argument sets and returns
+  // one result per set, in order. Equivalent to calling Run() once per
+  // element of `args_batch` but the flat argument and result buffers are
+  // allocated once and reused across the whole batch, so per-call allocation
+  // and marshalling overhead is amortized. Prefer this form when invoking the
+  // same compiled function over many samples (e.g. regression suites).
+  absl::StatusOr<std::vector<InterpreterResult<Value>>> RunBatch(
+      absl::Span<const std::vector<Value>> args_batch,
+      void* user_data = nullptr);
+
   // Executes the compiled function with the arguments and results specified as
   // "views" - flat buffers onto which structures layouts can be applied (see
   // value_view.h).
@@ -132,6 +170,10 @@ class IrJit {
 
   LlvmTypeConverter* type_converter() { return type_converter_.get(); }
 
+  // Returns the per-node execution profile collector, or null unless this
+  // IrJit was built with CreateProfiled().
+  JitProfiler* profiler() { return profiler_.get(); }
+
  private:
   explicit IrJit(FunctionBase* xls_function, int64_t opt_level);
 
@@ -186,6 +228,17 @@ class IrJit {
   FunctionBase* xls_function_;
   int64_t opt_level_;
 
+  // Optional on-disk cache of compiled object code (may be null). When
+  // enabled, cache_key_ identifies the compilation and is used as the LLVM
+  // module name so the cache can key off of it.
+  JitObjectCache* object_cache_ = nullptr;
+  std::string cache_key_;
+
+  // Per-node profile collector for CreateProfiled() builds (else null). The
+  // generated code embeds the addresses of its counter slots, so it must live
+  // as long as the compiled function.
+  std::unique_ptr<JitProfiler> profiler_;
+
   // Size of the function's args or return type as flat bytes.
   std::vector<int64_t> arg_type_bytes_;
   int64_t return_type_bytes_;
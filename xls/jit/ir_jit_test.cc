@@ -87,6 +87,66 @@ TEST(IrJitTest, ReuseTest) {
               IsOkAndHolds(Value(UBits(7, 8))));
 }
 
+// Runs a batch of argument sets through a single compiled function and
+// verifies one result is returned per set, in order.
+TEST(IrJitTest, RunBatch) {
+  Package package("my_package");
+  std::string ir_text = R"(
+  fn get_sum(a: bits[32], b: bits[32]) -> bits[32] {
+    ret add.3: bits[32] = add(a, b)
+  }
+  )";
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, IrJit::Create(function));
+
+  std::vector<std::vector<Value>> args_batch;
+  for (int64_t i = 0; i < 100; ++i) {
+    args_batch.push_back({Value(UBits(i, 32)), Value(UBits(2 * i, 32))});
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<InterpreterResult<Value>> results,
+                           jit->RunBatch(args_batch));
+  ASSERT_EQ(results.size(), args_batch.size());
+  for (int64_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(results[i].value, Value(UBits(3 * i, 32)));
+  }
+
+  // A malformed argument set anywhere in the batch is an error.
+  args_batch.push_back({Value(UBits(0, 32))});
+  EXPECT_THAT(jit->RunBatch(args_batch).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       testing::HasSubstr("wrong size")));
+}
+
+// Compiles several independent functions concurrently and verifies each
+// resulting jit runs its own function.
+TEST(IrJitTest, CreateParallel) {
+  Package package("my_package");
+  std::string ir_template = R"(
+  fn add_$0(x: bits[32]) -> bits[32] {
+    literal.$1: bits[32] = literal(value=$0)
+    ret add.$2: bits[32] = add(x, literal.$1)
+  }
+  )";
+  std::vector<Function*> functions;
+  for (int64_t i = 0; i < 8; ++i) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        Function * function,
+        Parser::ParseFunction(
+            absl::Substitute(ir_template, i, 2 * i + 1, 2 * i + 2), &package));
+    functions.push_back(function);
+  }
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::unique_ptr<IrJit>> jits,
+      IrJit::CreateParallel(functions, /*opt_level=*/3, /*num_threads=*/4));
+  ASSERT_EQ(jits.size(), functions.size());
+  for (int64_t i = 0; i < 8; ++i) {
+    EXPECT_THAT(RunJitNoEvents(jits[i].get(), {Value(UBits(100, 32))}),
+                IsOkAndHolds(Value(UBits(100 + i, 32))));
+  }
+}
+
 TEST(IrJitTest, OneHotZeroBit) {
   Package package("my_package");
   std::string ir_text = R"(
@@ -189,6 +249,36 @@ TEST(IrJitTest, PackedBits) {
   XLS_ASSERT_OK(TestPackedBits<1000>(bitgen));
 }
 
+// Verifies the vectorized lowering of bitwise ops on wide Bits values against
+// the reference bits_ops implementations.
+TEST(IrJitTest, WideBitwiseOps) {
+  constexpr int64_t kBitWidth = 1024;
+  Package package("my_package");
+  std::string ir_text = absl::Substitute(R"(
+  fn wide_bitwise(x: bits[$0], y: bits[$0]) -> bits[$0] {
+    and.1: bits[$0] = and(x, y)
+    or.2: bits[$0] = or(x, y)
+    xor.3: bits[$0] = xor(and.1, or.2)
+    ret not.4: bits[$0] = not(xor.3)
+  }
+  )",
+                                         kBitWidth);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(ir_text, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, IrJit::Create(function));
+
+  std::minstd_rand bitgen;
+  for (int i = 0; i < 8; i++) {
+    Value x = RandomValue(package.GetBitsType(kBitWidth), &bitgen);
+    Value y = RandomValue(package.GetBitsType(kBitWidth), &bitgen);
+    Bits expected = bits_ops::Not(
+        bits_ops::Xor(bits_ops::And(x.bits(), y.bits()),
+                      bits_ops::Or(x.bits(), y.bits())));
+    XLS_ASSERT_OK_AND_ASSIGN(Value result, jit->Run({x, y}));
+    EXPECT_EQ(result.bits(), expected);
+  }
+}
+
 // Concatenates the contents of several Bits objects into a single one.
 // Operates differently than bits_ops::Concat, as input[0] remains the LSbits.
 Bits VectorToPackedBits(const std::vector<Bits>& input) {
@@ -589,5 +679,53 @@ TEST(IrJitTest, CompoundTokenCompareError) {
               StatusIs(absl::StatusCode::kInvalidArgument,
                        testing::HasSubstr("Tokens are incomparable")));
 }
+
+// Builds a binary32 apfloat value as its (sign, bexp, fraction) tuple.
+Value ApfloatValue32(uint64_t sign, uint64_t bexp, uint64_t fraction) {
+  return Value::Tuple({Value(UBits(sign, 1)), Value(UBits(bexp, 8)),
+                       Value(UBits(fraction, 23))});
+}
+
+// A function which merely carries the mangled name of an apfloat
+// instantiation must not be lowered to native float instructions: the
+// JIT probes the callee's behavior before substituting, and these
+// identity bodies fail the probes. The JIT must agree with the
+// interpreter and return the first argument unchanged.
+TEST(IrJitTest, ApfloatNamedImpostorIsNotLoweredToNativeFloat) {
+  std::string ir_text = R"(
+  package apfloat_native
+
+  fn __apfloat_add_2__add__8_23_9_10_28_29_27(x: (bits[1], bits[8], bits[23]), y: (bits[1], bits[8], bits[23])) -> (bits[1], bits[8], bits[23]) {
+    ret result: (bits[1], bits[8], bits[23]) = identity(x)
+  }
+
+  fn __apfloat_mul_2__apfloat_mul_2__8_23_9_10_24_48_22_24(x: (bits[1], bits[8], bits[23]), y: (bits[1], bits[8], bits[23])) -> (bits[1], bits[8], bits[23]) {
+    ret result: (bits[1], bits[8], bits[23]) = identity(x)
+  }
+
+  fn caller_add(x: (bits[1], bits[8], bits[23]), y: (bits[1], bits[8], bits[23])) -> (bits[1], bits[8], bits[23]) {
+    ret result: (bits[1], bits[8], bits[23]) = invoke(x, y, to_apply=__apfloat_add_2__add__8_23_9_10_28_29_27)
+  }
+
+  fn caller_mul(x: (bits[1], bits[8], bits[23]), y: (bits[1], bits[8], bits[23])) -> (bits[1], bits[8], bits[23]) {
+    ret result: (bits[1], bits[8], bits[23]) = invoke(x, y, to_apply=__apfloat_mul_2__apfloat_mul_2__8_23_9_10_24_48_22_24)
+  }
+  )";
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(ir_text));
+
+  Value two = ApfloatValue32(0, 128, 0);           // 2.0f
+  Value three = ApfloatValue32(0, 128, 0x400000);  // 3.0f
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * add_fn,
+                           package->GetFunction("caller_add"));
+  XLS_ASSERT_OK_AND_ASSIGN(auto add_jit, IrJit::Create(add_fn));
+  EXPECT_THAT(RunJitNoEvents(add_jit.get(), {two, three}), IsOkAndHolds(two));
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * mul_fn,
+                           package->GetFunction("caller_mul"));
+  XLS_ASSERT_OK_AND_ASSIGN(auto mul_jit, IrJit::Create(mul_fn));
+  EXPECT_THAT(RunJitNoEvents(mul_jit.get(), {two, three}), IsOkAndHolds(two));
+}
 }  // namespace
 }  // namespace xls
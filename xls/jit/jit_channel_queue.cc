@@ -21,18 +21,25 @@
 namespace xls {
 
 absl::StatusOr<std::unique_ptr<JitChannelQueueManager>>
-JitChannelQueueManager::Create(Package* package) {
-  auto queue_mgr = absl::WrapUnique(new JitChannelQueueManager(package));
+JitChannelQueueManager::Create(Package* package, QueueKind kind) {
+  auto queue_mgr = absl::WrapUnique(new JitChannelQueueManager(package, kind));
   XLS_RETURN_IF_ERROR(queue_mgr->Init());
   return queue_mgr;
 }
 
-JitChannelQueueManager::JitChannelQueueManager(Package* package)
-    : package_(package) {}
+JitChannelQueueManager::JitChannelQueueManager(Package* package,
+                                               QueueKind kind)
+    : package_(package), kind_(kind) {}
 
 absl::Status JitChannelQueueManager::Init() {
   for (const auto& chan : package_->channels()) {
-    queues_.insert({chan->id(), std::make_unique<JitChannelQueue>(chan->id())});
+    if (kind_ == QueueKind::kSpsc) {
+      queues_.insert(
+          {chan->id(), std::make_unique<SpscJitChannelQueue>(chan->id())});
+    } else {
+      queues_.insert(
+          {chan->id(), std::make_unique<JitChannelQueue>(chan->id())});
+    }
   }
   return absl::OkStatus();
 }
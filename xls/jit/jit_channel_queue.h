@@ -14,12 +14,16 @@
 #ifndef XLS_JIT_JIT_CHANNEL_QUEUE_H_
 #define XLS_JIT_JIT_CHANNEL_QUEUE_H_
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <deque>
+#include <memory>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/ir/package.h"
 
@@ -30,18 +34,20 @@ namespace xls {
 // Very similiar to interpreter/channel_queue.h, as they perform similar
 // functions, but for performance, we can't depend on passing XLS Values
 // (there's a high cost in marshaling LLVM data into a XLS Value).
-// If the need arises for custom queue implementations, this can be made
-// abstract.
 // TODO(rspringer): Add data pools to avoid extra memcpy and heap alloc.
 class JitChannelQueue {
  public:
   JitChannelQueue(int64_t channel_id) : channel_id_(channel_id) {}
+  virtual ~JitChannelQueue() = default;
 
   // Called to push data onto this queue/FIFO.
-  void Send(uint8_t* data, int64_t num_bytes) {
+  virtual void Send(uint8_t* data, int64_t num_bytes) {
 #ifdef ABSL_HAVE_MEMORY_SANITIZER
     __msan_unpoison(data, num_bytes);
 #endif
+    // The buffer pool must be accessed under the lock: the sending and
+    // receiving procs may run on different threads.
+    absl::MutexLock lock(&mutex_);
     std::unique_ptr<uint8_t[]> buffer;
     if (buffer_pool_.empty()) {
       buffer = std::make_unique<uint8_t[]>(num_bytes);
@@ -50,19 +56,18 @@ class JitChannelQueue {
       buffer_pool_.pop_back();
     }
     memcpy(buffer.get(), data, num_bytes);
-    absl::MutexLock lock(&mutex_);
     the_queue_.push_back(std::move(buffer));
   }
 
   // Called to pull data off of this queue/FIFO.
-  void Recv(uint8_t* buffer, int64_t num_bytes) {
+  virtual void Recv(uint8_t* buffer, int64_t num_bytes) {
     absl::MutexLock lock(&mutex_);
     memcpy(buffer, the_queue_.front().get(), num_bytes);
     buffer_pool_.push_back(std::move(the_queue_.front()));
     the_queue_.pop_front();
   }
 
-  bool Empty() {
+  virtual bool Empty() {
     absl::MutexLock lock(&mutex_);
     return the_queue_.empty();
   }
@@ -73,16 +78,178 @@ class JitChannelQueue {
   int64_t channel_id_;
   absl::Mutex mutex_;
   std::deque<std::unique_ptr<uint8_t[]>> the_queue_ ABSL_GUARDED_BY(mutex_);
-  std::vector<std::unique_ptr<uint8_t[]>> buffer_pool_;
+  std::vector<std::unique_ptr<uint8_t[]>> buffer_pool_ ABSL_GUARDED_BY(mutex_);
+};
+
+// A lock-free single-producer single-consumer queue backed by a fixed
+// capacity ring buffer. XLS channels have exactly one sending and one
+// receiving proc, so Send() and Recv() may each be called by (at most) one
+// thread concurrently without any locking; Empty() may be called from either
+// side. Every element passed through a channel has the same byte size, which
+// fixes the ring's element stride at the first Send().
+//
+// The capacity bounds the number of in-flight elements on the channel; a
+// Send() on a full queue spins until the consumer drains an element, so the
+// capacity must exceed the maximum queue depth of the design.
+class SpscJitChannelQueue : public JitChannelQueue {
+ public:
+  explicit SpscJitChannelQueue(int64_t channel_id, int64_t capacity = 1024)
+      : JitChannelQueue(channel_id), capacity_(capacity) {
+    XLS_CHECK_EQ(capacity_ & (capacity_ - 1), 0)
+        << "SpscJitChannelQueue capacity must be a power of two.";
+  }
+
+  void Send(uint8_t* data, int64_t num_bytes) override {
+#ifdef ABSL_HAVE_MEMORY_SANITIZER
+    __msan_unpoison(data, num_bytes);
+#endif
+    if (storage_ == nullptr) {
+      element_size_ = num_bytes;
+      storage_ = std::make_unique<uint8_t[]>(capacity_ * element_size_);
+    }
+    XLS_DCHECK_EQ(num_bytes, element_size_);
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    // Spin until a slot is free.
+    while (tail - head_.load(std::memory_order_acquire) ==
+           static_cast<uint64_t>(capacity_)) {
+    }
+    memcpy(SlotAt(tail), data, num_bytes);
+    // The release store publishes both the element and (for the first
+    // element) the ring storage itself to the consumer.
+    tail_.store(tail + 1, std::memory_order_release);
+  }
+
+  void Recv(uint8_t* buffer, int64_t num_bytes) override {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    XLS_DCHECK(head != tail_.load(std::memory_order_acquire));
+    memcpy(buffer, SlotAt(head), num_bytes);
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  bool Empty() override {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+
+  // As Send(), but enqueues "count" elements of "num_bytes" each stored
+  // contiguously at "data", amortizing the atomic operations over the batch.
+  void SendBatch(uint8_t* data, int64_t num_bytes, int64_t count) {
+#ifdef ABSL_HAVE_MEMORY_SANITIZER
+    __msan_unpoison(data, num_bytes * count);
+#endif
+    if (storage_ == nullptr) {
+      element_size_ = num_bytes;
+      storage_ = std::make_unique<uint8_t[]>(capacity_ * element_size_);
+    }
+    XLS_DCHECK_EQ(num_bytes, element_size_);
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    for (int64_t i = 0; i < count; ++i) {
+      while (tail - head_.load(std::memory_order_acquire) ==
+             static_cast<uint64_t>(capacity_)) {
+      }
+      memcpy(SlotAt(tail), &data[i * num_bytes], num_bytes);
+      ++tail;
+    }
+    tail_.store(tail, std::memory_order_release);
+  }
+
+  // Zero-copy ingress: returns a pointer to the next free ring slot, to be
+  // filled with one element of "num_bytes" in the flat buffer layout used by
+  // the JIT (see JitRuntime::BlitValueToBuffer()) and then published with
+  // CommitSendSlot(). Spins while the queue is full. This skips the copy out
+  // of a caller-side staging buffer that Send() performs; external producers
+  // streaming large volumes should write their data directly into the
+  // returned slot. Only the producer thread may call this, and at most one
+  // slot may be reserved at a time.
+  uint8_t* ReserveSendSlot(int64_t num_bytes) {
+    if (storage_ == nullptr) {
+      element_size_ = num_bytes;
+      storage_ = std::make_unique<uint8_t[]>(capacity_ * element_size_);
+    }
+    XLS_DCHECK_EQ(num_bytes, element_size_);
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    while (tail - head_.load(std::memory_order_acquire) ==
+           static_cast<uint64_t>(capacity_)) {
+    }
+    return SlotAt(tail);
+  }
+
+  // Publishes the slot returned by the last ReserveSendSlot() to the
+  // consumer.
+  void CommitSendSlot() {
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  // Zero-copy egress: returns a pointer to the oldest enqueued element, or
+  // nullptr if the queue is empty. The slot remains valid (and is not
+  // overwritten by the producer) until ReleaseRecvSlot() pops it. Only the
+  // consumer thread may call these.
+  uint8_t* PeekRecvSlot() {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return SlotAt(head);
+  }
+
+  // Pops the element returned by the last PeekRecvSlot(), returning its slot
+  // to the producer.
+  void ReleaseRecvSlot() {
+    head_.store(head_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  // Dequeues up to "max_count" elements of "num_bytes" each into "buffer"
+  // and returns the number dequeued, amortizing the atomic operations over
+  // the batch.
+  int64_t RecvBatch(uint8_t* buffer, int64_t num_bytes, int64_t max_count) {
+    XLS_DCHECK_EQ(num_bytes, element_size_);
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    int64_t count =
+        std::min(static_cast<int64_t>(tail - head), max_count);
+    for (int64_t i = 0; i < count; ++i) {
+      memcpy(&buffer[i * num_bytes], SlotAt(head + i), num_bytes);
+    }
+    head_.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+ private:
+  uint8_t* SlotAt(uint64_t cursor) {
+    return &storage_[(cursor & (capacity_ - 1)) * element_size_];
+  }
+
+  int64_t capacity_;
+  // Fixed by the first Send(); storage_ is allocated at the same time and
+  // only ever touched by the producer before being published via tail_.
+  int64_t element_size_ = 0;
+  std::unique_ptr<uint8_t[]> storage_;
+
+  // Monotonically increasing cursors; the slot index is cursor mod capacity.
+  // Producer and consumer cursors live on separate cache lines to avoid
+  // false sharing.
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  alignas(64) std::atomic<uint64_t> head_{0};
 };
 
 // JitChannelQueue respository. Holds the set of queues known by a given proc.
 class JitChannelQueueManager {
  public:
+  // Selects the JitChannelQueue implementation backing each channel.
+  enum class QueueKind {
+    // Mutex-guarded unbounded deque; safe for any number of threads on
+    // either side of the channel.
+    kMutex,
+    // Lock-free bounded SPSC ring buffer (see SpscJitChannelQueue).
+    kSpsc,
+  };
+
   // Returns a JitChannelQueueManager holding a JitChannelQueue for every proc
   // in the provided package.
   static absl::StatusOr<std::unique_ptr<JitChannelQueueManager>> Create(
-      Package* package);
+      Package* package, QueueKind kind = QueueKind::kMutex);
 
   absl::StatusOr<JitChannelQueue*> GetQueueById(int64_t channel_id) {
     XLS_RET_CHECK(queues_.contains(channel_id));
@@ -90,10 +257,11 @@ class JitChannelQueueManager {
   }
 
  private:
-  explicit JitChannelQueueManager(Package* package);
+  JitChannelQueueManager(Package* package, QueueKind kind);
   absl::Status Init();
 
   Package* package_;
+  QueueKind kind_;
   absl::flat_hash_map<int64_t, std::unique_ptr<JitChannelQueue>> queues_;
 };
 
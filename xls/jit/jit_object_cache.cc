@@ -0,0 +1,92 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/jit_object_cache.h"
+
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/logging/logging.h"
+
+namespace xls {
+namespace {
+
+// Stable 64-bit FNV-1a hash. The key names an on-disk entry that must be
+// found again by later processes; absl::Hash is seeded per process and
+// would turn the cache into a per-run scratch directory.
+uint64_t StableHash(absl::string_view data,
+                    uint64_t hash = 0xcbf29ce484222325ULL) {
+  for (char c : data) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+}  // namespace
+
+JitObjectCache::JitObjectCache(std::filesystem::path cache_dir)
+    : cache_dir_(std::move(cache_dir)) {
+  absl::Status status = RecursivelyCreateDir(cache_dir_);
+  if (!status.ok()) {
+    XLS_LOG(WARNING) << "Unable to create JIT object cache directory "
+                     << cache_dir_ << ": " << status;
+  }
+}
+
+/* static */ std::string JitObjectCache::MakeCacheKey(
+    absl::string_view ir_text, int64_t opt_level,
+    absl::string_view target_triple, absl::string_view data_layout) {
+  uint64_t hash = StableHash(absl::StrFormat(
+      "%d\n%s\n%s\n%s", opt_level, target_triple, data_layout, ir_text));
+  return absl::StrFormat("xls-jit-%d-%016x", ir_text.size(), hash);
+}
+
+bool JitObjectCache::Contains(absl::string_view key) const {
+  return FileExists(EntryPath(key)).ok();
+}
+
+void JitObjectCache::notifyObjectCompiled(const llvm::Module* module,
+                                          llvm::MemoryBufferRef object) {
+  absl::Status status = SetFileContents(
+      EntryPath(module->getModuleIdentifier()),
+      absl::string_view(object.getBufferStart(), object.getBufferSize()));
+  if (!status.ok()) {
+    // A write failure (e.g. read-only cache directory) only costs a
+    // recompilation on the next run; don't fail the compile.
+    XLS_LOG(WARNING) << "Unable to write JIT object cache entry: " << status;
+  }
+}
+
+std::unique_ptr<llvm::MemoryBuffer> JitObjectCache::getObject(
+    const llvm::Module* module) {
+  absl::StatusOr<std::string> contents =
+      GetFileContents(EntryPath(module->getModuleIdentifier()));
+  if (!contents.ok()) {
+    return nullptr;
+  }
+  XLS_VLOG(2) << "JIT object cache hit for " << module->getModuleIdentifier();
+  return llvm::MemoryBuffer::getMemBufferCopy(*contents,
+                                              module->getModuleIdentifier());
+}
+
+std::filesystem::path JitObjectCache::EntryPath(absl::string_view key) const {
+  return cache_dir_ / absl::StrCat(key, ".o");
+}
+
+}  // namespace xls
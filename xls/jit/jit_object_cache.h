@@ -0,0 +1,73 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_JIT_JIT_OBJECT_CACHE_H_
+#define XLS_JIT_JIT_OBJECT_CACHE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "llvm/include/llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/include/llvm/IR/Module.h"
+#include "llvm/include/llvm/Support/MemoryBuffer.h"
+
+namespace xls {
+
+// An llvm::ObjectCache which persists compiled object code on disk, keyed by
+// a hash of the XLS IR and the compilation configuration. Attaching an
+// instance to IrJit::Create() lets repeated invocations of a tool (e.g.
+// eval_ir_main) on the same IR load host machine code from disk instead of
+// re-running LLVM optimization and codegen on every process start.
+//
+// A cache entry is only valid for identical IR text, opt level, and host
+// target; MakeCacheKey() folds all of these into the key. Entries are never
+// evicted - the caller owns the lifetime of the cache directory.
+class JitObjectCache : public llvm::ObjectCache {
+ public:
+  // Creates a cache rooted at "cache_dir". The directory is created if it
+  // does not already exist.
+  explicit JitObjectCache(std::filesystem::path cache_dir);
+
+  // Returns the cache key for compiling "ir_text" (the textual dump of the
+  // XLS function) at "opt_level" for the given target triple and data layout.
+  // The key is a stable hash (identical across processes, so entries written
+  // by one run are found by later runs); distinct inputs can in principle
+  // collide, so the IR text length is folded into the key to make collisions
+  // less likely.
+  static std::string MakeCacheKey(absl::string_view ir_text, int64_t opt_level,
+                                  absl::string_view target_triple,
+                                  absl::string_view data_layout);
+
+  // Returns true if an entry for "key" exists on disk.
+  bool Contains(absl::string_view key) const;
+
+  // llvm::ObjectCache interface. The module's identifier is used as the cache
+  // key.
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef object) override;
+  std::unique_ptr<llvm::MemoryBuffer> getObject(
+      const llvm::Module* module) override;
+
+ private:
+  std::filesystem::path EntryPath(absl::string_view key) const;
+
+  std::filesystem::path cache_dir_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_JIT_JIT_OBJECT_CACHE_H_
@@ -0,0 +1,81 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/jit_object_cache.h"
+
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+#include "xls/jit/ir_jit.h"
+
+namespace xls {
+namespace {
+
+TEST(JitObjectCacheTest, CacheKeyIsDeterministicAndInputSensitive) {
+  std::string key = JitObjectCache::MakeCacheKey("ir", 3, "triple", "layout");
+  EXPECT_EQ(key, JitObjectCache::MakeCacheKey("ir", 3, "triple", "layout"));
+  // The key must be stable across processes (entries written by one run are
+  // looked up by later runs), so it is pinned to a golden value; a
+  // per-process-seeded hash would recompute the same key within one test
+  // binary and pass the checks above.
+  EXPECT_EQ(key, "xls-jit-2-dbc28086e8ba4555");
+  EXPECT_NE(key,
+            JitObjectCache::MakeCacheKey("other ir", 3, "triple", "layout"));
+  EXPECT_NE(key, JitObjectCache::MakeCacheKey("ir", 2, "triple", "layout"));
+  EXPECT_NE(key,
+            JitObjectCache::MakeCacheKey("ir", 3, "other-triple", "layout"));
+}
+
+TEST(JitObjectCacheTest, CompiledObjectIsPersistedAndReused) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  Package package("object_cache_test");
+  FunctionBuilder b("add", &package);
+  BitsType* u32 = package.GetBitsType(32);
+  b.Add(b.Param("x", u32), b.Param("y", u32));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function, b.Build());
+
+  JitObjectCache cache(temp_dir.path());
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<IrJit> jit,
+                           IrJit::Create(function, /*opt_level=*/3, &cache));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      InterpreterResult<Value> result,
+      jit->Run({Value(UBits(2, 32)), Value(UBits(3, 32))}));
+  EXPECT_EQ(result.value, Value(UBits(5, 32)));
+
+  // The compiled object should now be persisted on disk.
+  EXPECT_EQ(std::distance(std::filesystem::directory_iterator(temp_dir.path()),
+                          std::filesystem::directory_iterator()),
+            1);
+
+  // A second compilation against the same cache is satisfied from disk and
+  // must produce the same results.
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<IrJit> cached_jit,
+                           IrJit::Create(function, /*opt_level=*/3, &cache));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      result, cached_jit->Run({Value(UBits(7, 32)), Value(UBits(8, 32))}));
+  EXPECT_EQ(result.value, Value(UBits(15, 32)));
+}
+
+}  // namespace
+}  // namespace xls
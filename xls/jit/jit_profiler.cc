@@ -0,0 +1,72 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/jit_profiler.h"
+
+#include <algorithm>
+
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+
+namespace xls {
+
+JitProfiler::Slot& JitProfiler::GetSlot(Node* node) {
+  std::unique_ptr<Slot>& slot = slots_[node->id()];
+  if (slot == nullptr) {
+    slot = std::make_unique<Slot>();
+    slot->node_name = node->GetName();
+  }
+  return *slot;
+}
+
+uint64_t* JitProfiler::GetCountSlot(Node* node) { return &GetSlot(node).count; }
+
+uint64_t* JitProfiler::GetCyclesSlot(Node* node) {
+  return &GetSlot(node).cycles;
+}
+
+std::vector<JitProfiler::NodeProfile> JitProfiler::GetProfile() const {
+  std::vector<NodeProfile> profile;
+  profile.reserve(slots_.size());
+  for (const auto& [node_id, slot] : slots_) {
+    profile.push_back(NodeProfile{
+        .node_id = node_id,
+        .node_name = slot->node_name,
+        .execution_count = static_cast<int64_t>(slot->count),
+        .accumulated_cycles = static_cast<int64_t>(slot->cycles)});
+  }
+  std::sort(profile.begin(), profile.end(),
+            [](const NodeProfile& a, const NodeProfile& b) {
+              return a.accumulated_cycles > b.accumulated_cycles;
+            });
+  return profile;
+}
+
+std::string JitProfiler::ToString() const {
+  return absl::StrJoin(GetProfile(), "\n",
+                       [](std::string* out, const NodeProfile& p) {
+                         absl::StrAppendFormat(out, "%d\t%s\t%d\t%d", p.node_id,
+                                               p.node_name, p.execution_count,
+                                               p.accumulated_cycles);
+                       });
+}
+
+void JitProfiler::Reset() {
+  for (auto& [node_id, slot] : slots_) {
+    slot->count = 0;
+    slot->cycles = 0;
+  }
+}
+
+}  // namespace xls
@@ -0,0 +1,89 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_JIT_JIT_PROFILER_H_
+#define XLS_JIT_JIT_PROFILER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "xls/ir/node.h"
+
+namespace xls {
+
+// Collects per-XLS-node execution profiles from instrumented JIT-compiled
+// code (see IrJit::CreateProfiled()). The generated code embeds the addresses
+// of counter slots handed out by GetCountSlot()/GetCyclesSlot() and bumps
+// them inline, so a JitProfiler must outlive every function compiled against
+// it and must not be moved.
+//
+// Counter updates in the generated code are not atomic: profiles are only
+// meaningful when the instrumented function runs on a single thread at a
+// time. Cycle attribution is approximate - each node is charged the cycles
+// elapsed since the previously completed node, so instruction scheduling by
+// LLVM can shift a few cycles between adjacent nodes - but it is more than
+// accurate enough to rank nodes by cost.
+class JitProfiler {
+ public:
+  struct NodeProfile {
+    int64_t node_id;
+    std::string node_name;
+    // Number of times the node's computation was executed. This can exceed
+    // the function invocation count for nodes inside loop bodies.
+    int64_t execution_count;
+    // Total cycles attributed to the node across all executions, as measured
+    // by the CPU cycle counter.
+    int64_t accumulated_cycles;
+  };
+
+  // Returns the address of the execution-count (resp. accumulated-cycle)
+  // counter for "node", allocating a stable slot on first use. Called at
+  // compile time by the IR lowering; the returned addresses are baked into
+  // the generated code as constants.
+  uint64_t* GetCountSlot(Node* node);
+  uint64_t* GetCyclesSlot(Node* node);
+
+  // Returns a snapshot of all per-node counters, sorted by accumulated
+  // cycles, descending. Profiles are keyed by Node::id(), so they can be
+  // joined against other per-node analyses (e.g. analyze_critical_path
+  // output) for the same IR.
+  std::vector<NodeProfile> GetProfile() const;
+
+  // Renders the profile as one tab-separated line per node:
+  // "<node id>\t<node name>\t<execution count>\t<accumulated cycles>".
+  std::string ToString() const;
+
+  // Zeroes all counters.
+  void Reset();
+
+ private:
+  struct Slot {
+    std::string node_name;
+    uint64_t count = 0;
+    uint64_t cycles = 0;
+  };
+
+  // Returns the slot for "node", creating it if necessary. Slots are
+  // heap-allocated so their addresses stay stable as the map grows.
+  Slot& GetSlot(Node* node);
+
+  absl::flat_hash_map<int64_t, std::unique_ptr<Slot>> slots_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_JIT_JIT_PROFILER_H_
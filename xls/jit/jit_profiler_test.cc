@@ -0,0 +1,82 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/jit_profiler.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+#include "xls/jit/ir_jit.h"
+
+namespace xls {
+namespace {
+
+using ::testing::HasSubstr;
+
+constexpr const char kFunctionIr[] = R"(
+fn profiled(x: bits[32], y: bits[32]) -> bits[32] {
+  umul.3: bits[32] = umul(x, y)
+  ret add.4: bits[32] = add(umul.3, x)
+}
+)";
+
+TEST(JitProfilerTest, CountsNodeExecutions) {
+  Package package("p");
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(kFunctionIr, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, IrJit::CreateProfiled(function));
+  ASSERT_NE(jit->profiler(), nullptr);
+
+  constexpr int64_t kNumRuns = 5;
+  for (int i = 0; i < kNumRuns; i++) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        InterpreterResult<Value> result,
+        jit->Run({Value(UBits(6, 32)), Value(UBits(7, 32))}));
+    EXPECT_EQ(result.value, Value(UBits(48, 32)));
+  }
+
+  std::vector<JitProfiler::NodeProfile> profile = jit->profiler()->GetProfile();
+  // Two params plus the multiply and add.
+  EXPECT_EQ(profile.size(), 4);
+  for (const JitProfiler::NodeProfile& node_profile : profile) {
+    EXPECT_EQ(node_profile.execution_count, kNumRuns)
+        << node_profile.node_name;
+    EXPECT_GE(node_profile.accumulated_cycles, 0) << node_profile.node_name;
+  }
+}
+
+TEST(JitProfilerTest, ToStringAndReset) {
+  Package package("p");
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function,
+                           Parser::ParseFunction(kFunctionIr, &package));
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, IrJit::CreateProfiled(function));
+  XLS_ASSERT_OK(
+      jit->Run({Value(UBits(1, 32)), Value(UBits(2, 32))}).status());
+
+  EXPECT_THAT(jit->profiler()->ToString(), HasSubstr("umul.3"));
+  EXPECT_THAT(jit->profiler()->ToString(), HasSubstr("add.4"));
+
+  jit->profiler()->Reset();
+  for (const JitProfiler::NodeProfile& node_profile :
+       jit->profiler()->GetProfile()) {
+    EXPECT_EQ(node_profile.execution_count, 0);
+    EXPECT_EQ(node_profile.accumulated_cycles, 0);
+  }
+}
+
+}  // namespace
+}  // namespace xls
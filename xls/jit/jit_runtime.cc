@@ -39,10 +39,9 @@ absl::Status JitRuntime::PackArgs(absl::Span<const Value> args,
   }
   if (!args.empty()) {
     for (int i = 0; i < args.size(); ++i) {
-      BlitValueToBuffer(
-          args[i], arg_types[i],
-          absl::MakeSpan(arg_buffers[i],
-                         type_converter_->GetTypeByteSize(arg_types[i])));
+      const TypeLayout& layout = type_converter_->GetTypeLayout(arg_types[i]);
+      BlitValueToBuffer(args[i], arg_types[i],
+                        absl::MakeSpan(arg_buffers[i], layout.size));
     }
   }
 
@@ -70,17 +69,15 @@ Value JitRuntime::UnpackBuffer(const uint8_t* buffer, const Type* result_type) {
       return Value(Bits::FromBytes(absl::MakeSpan(data), bit_count));
     }
     case TypeKind::kTuple: {
-      // Just as with arg packing, we need the DataLayout to tell us where each
-      // arg is placed in the output buffer.
+      // Just as with arg packing, we need the precomputed layout to tell us
+      // where each element is placed in the output buffer.
       const TupleType* tuple_type = result_type->AsTupleOrDie();
-      llvm::Type* llvm_type = type_converter_->ConvertToLlvmType(tuple_type);
-      const llvm::StructLayout* layout =
-          data_layout_.getStructLayout(llvm::cast<llvm::StructType>(llvm_type));
+      const TypeLayout& layout = type_converter_->GetTypeLayout(tuple_type);
 
       std::vector<Value> values;
       values.reserve(tuple_type->size());
       for (int i = 0; i < tuple_type->size(); ++i) {
-        Value value = UnpackBuffer(buffer + layout->getElementOffset(i),
+        Value value = UnpackBuffer(buffer + layout.element_offsets[i],
                                    tuple_type->element_type(i));
         values.push_back(value);
       }
@@ -93,20 +90,12 @@ Value JitRuntime::UnpackBuffer(const uint8_t* buffer, const Type* result_type) {
       }
 
       const Type* element_type = array_type->element_type();
-      llvm::Type* llvm_element_type =
-          type_converter_->ConvertToLlvmType(array_type->element_type());
+      const TypeLayout& layout = type_converter_->GetTypeLayout(array_type);
       std::vector<Value> values;
       values.reserve(array_type->size());
-      // This BitsType is only used inside the ToLlvmConstantCall() (and isn't
-      // stored), so it's safe for it to live on the stack.
-      BitsType bits_type(64);
       for (int i = 0; i < array_type->size(); ++i) {
-        llvm::Constant* index =
-            type_converter_->ToLlvmConstant(&bits_type, Value(UBits(i, 64)))
-                .value();
-        int64_t offset =
-            data_layout_.getIndexedOffsetInType(llvm_element_type, index);
-        Value value = UnpackBuffer(buffer + offset, element_type);
+        Value value =
+            UnpackBuffer(buffer + i * layout.element_stride, element_type);
         values.push_back(value);
       }
 
@@ -137,25 +126,23 @@ void JitRuntime::BlitValueToBuffer(const Value& value, const Type* type,
     }
   } else if (value.IsArray()) {
     const ArrayType* array_type = type->AsArrayOrDie();
-    int64_t element_size =
-        type_converter_->GetTypeByteSize(array_type->element_type());
+    const TypeLayout& layout = type_converter_->GetTypeLayout(array_type);
     for (int i = 0; i < value.size(); ++i) {
       BlitValueToBuffer(value.element(i), array_type->element_type(), buffer);
-      buffer = buffer.subspan(element_size);
+      buffer = buffer.subspan(layout.element_stride);
     }
   } else if (value.IsTuple()) {
     // Due to per-target data packing (esp. as realized by the LLVM IR
     // load/store instructions), we need to make sure we blit args into LLVM
     // space as the underlying runtime expects, which means we need the
-    // DataLayout to tell us where each constituent element should be placed.
-    llvm::Type* llvm_type = type_converter_->ConvertToLlvmType(type);
-    const llvm::StructLayout* layout =
-        data_layout_.getStructLayout(llvm::cast<llvm::StructType>(llvm_type));
+    // precomputed layout to tell us where each constituent element should be
+    // placed.
+    const TypeLayout& layout = type_converter_->GetTypeLayout(type);
 
     const TupleType* tuple_type = type->AsTupleOrDie();
     for (int i = 0; i < value.size(); ++i) {
       BlitValueToBuffer(value.element(i), tuple_type->element_type(i),
-                        buffer.subspan(layout->getElementOffset(i)));
+                        buffer.subspan(layout.element_offsets[i]));
     }
   } else if (value.IsToken()) {
     // Tokens contain no data.
@@ -127,7 +127,32 @@ absl::StatusOr<llvm::Constant*> LlvmTypeConverter::ToIntegralConstant(
 }
 
 int64_t LlvmTypeConverter::GetTypeByteSize(const Type* type) {
-  return data_layout_.getTypeAllocSize(ConvertToLlvmType(type)).getFixedSize();
+  return GetTypeLayout(type).size;
+}
+
+const TypeLayout& LlvmTypeConverter::GetTypeLayout(const Type* type) {
+  auto it = layout_cache_.find(type);
+  if (it != layout_cache_.end()) {
+    return *it->second;
+  }
+  auto layout = std::make_unique<TypeLayout>();
+  llvm::Type* llvm_type = ConvertToLlvmType(type);
+  layout->size = data_layout_.getTypeAllocSize(llvm_type).getFixedSize();
+  if (type->IsTuple()) {
+    const llvm::StructLayout* struct_layout =
+        data_layout_.getStructLayout(llvm::cast<llvm::StructType>(llvm_type));
+    const TupleType* tuple_type = type->AsTupleOrDie();
+    layout->element_offsets.reserve(tuple_type->size());
+    for (int64_t i = 0; i < tuple_type->size(); ++i) {
+      layout->element_offsets.push_back(struct_layout->getElementOffset(i));
+    }
+  } else if (type->IsArray()) {
+    layout->element_stride =
+        GetTypeByteSize(type->AsArrayOrDie()->element_type());
+  }
+  const TypeLayout& result = *layout;
+  layout_cache_.insert({type, std::move(layout)});
+  return result;
 }
 
 llvm::Type* LlvmTypeConverter::GetTokenType() {
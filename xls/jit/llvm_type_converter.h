@@ -16,6 +16,8 @@
 #define XLS_JIT_LLVM_TYPE_CONVERTER_H_
 
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
@@ -29,6 +31,23 @@
 
 namespace xls {
 
+// Precomputed byte-level layout of an XLS type in the JIT's native
+// representation. Sizes and offsets are derived from the LLVM DataLayout once
+// and memoized (see LlvmTypeConverter::GetTypeLayout) so that argument and
+// result marshalling is table-driven rather than consulting LLVM per call.
+struct TypeLayout {
+  // Total allocated size of the type in bytes, including any padding.
+  int64_t size = 0;
+
+  // For array types: the stride in bytes between consecutive elements (the
+  // allocated size of the element type). Zero for other types.
+  int64_t element_stride = 0;
+
+  // For tuple types: the byte offset of each element from the start of the
+  // tuple, accounting for per-target padding. Empty for other types.
+  std::vector<int64_t> element_offsets;
+};
+
 // LlvmTypeConverter handles the work of translating from XLS types and values
 // into the corresponding LLVM elements.
 //
@@ -54,6 +73,11 @@ class LlvmTypeConverter {
   // DataLayout object can handle ~all of the work for us.
   int64_t GetTypeByteSize(const Type* type);
 
+  // Returns the precomputed layout descriptor for the given type. The
+  // descriptor is computed on first use and cached for the lifetime of this
+  // converter; the returned reference is stable.
+  const TypeLayout& GetTypeLayout(const Type* type);
+
   // Returns a new Value representing the LLVM form of a Token.
   llvm::Value* GetToken();
 
@@ -72,6 +96,10 @@ class LlvmTypeConverter {
 
   // Cache of XLS -> LLVM type conversions.
   TypeCache type_cache_;
+
+  // Cache of per-type layout descriptors. Values are held by pointer so
+  // references returned by GetTypeLayout remain stable across rehashes.
+  absl::flat_hash_map<const Type*, std::unique_ptr<TypeLayout>> layout_cache_;
 };
 
 }  // namespace xls
@@ -0,0 +1,323 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "xls/jit/pooled_proc_runtime.h"
+
+#include <thread>  // NOLINT(build/c++11): only used for hardware_concurrency.
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/proc.h"
+#include "xls/jit/function_builder_visitor.h"
+#include "xls/jit/jit_channel_queue.h"
+#include "xls/jit/proc_builder_visitor.h"
+
+namespace xls {
+
+void PooledProcRuntime::RecvFn(JitChannelQueue* queue, Receive* recv,
+                               uint8_t* data, int64_t data_bytes,
+                               void* user_data) {
+  // A proc is only scheduled when all of its input queues have data, so a
+  // receive never has to block. An empty queue here means the proc received
+  // more than once from the same channel in one activation, which this
+  // runtime does not support.
+  XLS_CHECK(!queue->Empty())
+      << "Receive on empty channel " << queue->channel_id()
+      << "; procs which receive multiple times from the same channel per "
+         "activation are not supported by PooledProcRuntime.";
+  queue->Recv(data, data_bytes);
+}
+
+void PooledProcRuntime::SendFn(JitChannelQueue* queue, Send* send,
+                               uint8_t* data, int64_t data_bytes,
+                               void* user_data) {
+  queue->Send(data, data_bytes);
+}
+
+absl::StatusOr<std::unique_ptr<PooledProcRuntime>> PooledProcRuntime::Create(
+    Package* package, int64_t num_workers) {
+  if (num_workers == 0) {
+    num_workers = std::thread::hardware_concurrency();
+  }
+  auto runtime =
+      absl::WrapUnique(new PooledProcRuntime(package, num_workers));
+  XLS_RETURN_IF_ERROR(runtime->Init());
+  return runtime;
+}
+
+PooledProcRuntime::PooledProcRuntime(Package* package, int64_t num_workers)
+    : package_(package), num_workers_(num_workers) {}
+
+PooledProcRuntime::~PooledProcRuntime() {
+  {
+    absl::MutexLock lock(&mutex_);
+    shutdown_ = true;
+  }
+  for (auto& worker : workers_) {
+    worker->Join();
+  }
+}
+
+absl::Status PooledProcRuntime::Init() {
+  XLS_ASSIGN_OR_RETURN(queue_mgr_, JitChannelQueueManager::Create(package_));
+
+  procs_.reserve(package_->procs().size());
+  for (int i = 0; i < package_->procs().size(); i++) {
+    auto proc_data = std::make_unique<ProcData>();
+    Proc* proc = package_->procs()[i].get();
+    XLS_ASSIGN_OR_RETURN(
+        proc_data->jit,
+        IrJit::CreateProc(proc, queue_mgr_.get(), &RecvFn, &SendFn));
+    auto* jit = proc_data->jit.get();
+
+    proc_data->proc_state_size = jit->GetReturnTypeSize();
+    proc_data->proc_state =
+        std::make_unique<uint8_t[]>(proc_data->proc_state_size);
+    jit->runtime()->BlitValueToBuffer(
+        proc->InitValue(),
+        FunctionBuilderVisitor::GetEffectiveReturnValue(proc)->GetType(),
+        absl::MakeSpan(proc_data->proc_state.get(), jit->GetReturnTypeSize()));
+
+    for (Node* node : proc->nodes()) {
+      if (node->Is<Receive>()) {
+        XLS_ASSIGN_OR_RETURN(
+            JitChannelQueue * queue,
+            queue_mgr_->GetQueueById(node->As<Receive>()->channel_id()));
+        proc_data->input_queues.push_back(queue);
+      }
+    }
+
+    proc_data->ticks_remaining = 0;
+    proc_data->scheduled = false;
+    procs_.push_back(std::move(proc_data));
+  }
+
+  // Enqueue initial values into channels.
+  for (Channel* channel : package_->channels()) {
+    if (channel->kind() != ChannelKind::kStreaming) {
+      return absl::UnimplementedError(
+          "Only streaming channels are supported in pooled proc runtime.");
+    }
+    for (const Value& value : channel->initial_values()) {
+      XLS_RETURN_IF_ERROR(EnqueueValueToChannel(channel, value));
+    }
+  }
+
+  workers_.reserve(num_workers_);
+  for (int64_t i = 0; i < num_workers_; i++) {
+    workers_.push_back(std::make_unique<Thread>([this]() { WorkerFn(); }));
+  }
+
+  return absl::OkStatus();
+}
+
+void PooledProcRuntime::ScheduleReadyProcs() {
+  for (auto& proc_data : procs_) {
+    if (proc_data->ticks_remaining == 0 || proc_data->scheduled) {
+      continue;
+    }
+    bool ready = true;
+    for (JitChannelQueue* queue : proc_data->input_queues) {
+      if (queue->Empty()) {
+        ready = false;
+        break;
+      }
+    }
+    if (ready) {
+      proc_data->scheduled = true;
+      ready_.push_back(proc_data.get());
+    }
+  }
+}
+
+bool PooledProcRuntime::WorkAvailable() const {
+  return shutdown_ || !ready_.empty();
+}
+
+bool PooledProcRuntime::TickQuiesced() const {
+  return num_pending_ == 0 || (ready_.empty() && num_running_ == 0);
+}
+
+void PooledProcRuntime::WorkerFn() {
+  while (true) {
+    ProcData* proc_data;
+    int64_t budget;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(this, &PooledProcRuntime::WorkAvailable));
+      if (shutdown_) {
+        return;
+      }
+      proc_data = ready_.front();
+      ready_.pop_front();
+      num_running_++;
+      // "scheduled" stays set while the proc runs, so no other worker can
+      // pick it up and only this thread touches its budget.
+      budget = proc_data->ticks_remaining;
+    }
+
+    // Run consecutive activations while the proc has budget and every input
+    // queue still has data, paying the scheduling cost once for the whole
+    // run instead of once per tick.
+    int64_t activations = 0;
+    while (true) {
+      // RunWithViews takes an array of arg view pointers - even if they're
+      // unused during execution, tokens still occupy one of those spots.
+      std::vector<uint8_t*> args = {nullptr, proc_data->proc_state.get()};
+      XLS_CHECK_OK(proc_data->jit->RunWithViews(
+          absl::MakeSpan(args),
+          absl::MakeSpan(proc_data->proc_state.get(),
+                         proc_data->proc_state_size),
+          proc_data));
+      activations++;
+      if (activations == budget) {
+        break;
+      }
+      bool ready = true;
+      for (JitChannelQueue* queue : proc_data->input_queues) {
+        if (queue->Empty()) {
+          ready = false;
+          break;
+        }
+      }
+      if (!ready) {
+        break;
+      }
+    }
+
+    {
+      absl::MutexLock lock(&mutex_);
+      num_running_--;
+      num_pending_ -= activations;
+      proc_data->ticks_remaining -= activations;
+      proc_data->scheduled = false;
+      // The activations' sends may have made downstream procs ready (or this
+      // proc itself, if it stopped early and data has arrived since).
+      ScheduleReadyProcs();
+    }
+  }
+}
+
+absl::Status PooledProcRuntime::Tick(int64_t num_ticks) {
+  XLS_RET_CHECK_GT(num_ticks, 0);
+  absl::MutexLock lock(&mutex_);
+  for (auto& proc_data : procs_) {
+    proc_data->ticks_remaining = num_ticks;
+    proc_data->scheduled = false;
+  }
+  num_pending_ = num_ticks * static_cast<int64_t>(procs_.size());
+  ScheduleReadyProcs();
+
+  while (true) {
+    mutex_.Await(absl::Condition(this, &PooledProcRuntime::TickQuiesced));
+    if (num_pending_ == 0) {
+      break;
+    }
+
+    // No proc is ready or running but some have not ticked: either the
+    // network is waiting on data from "outside" (a receive_only channel), or
+    // it is deadlocked.
+    bool blocked_by_external = false;
+    for (auto& proc_data : procs_) {
+      if (proc_data->ticks_remaining == 0) {
+        continue;
+      }
+      for (JitChannelQueue* queue : proc_data->input_queues) {
+        if (!queue->Empty()) {
+          continue;
+        }
+        XLS_ASSIGN_OR_RETURN(Channel * chan,
+                             package_->GetChannel(queue->channel_id()));
+        if (chan->supported_ops() == ChannelOps::kReceiveOnly) {
+          blocked_by_external = true;
+        }
+      }
+    }
+    if (!blocked_by_external) {
+      return absl::AbortedError(
+          "Deadlock detected; some procs were blocked with no data sent.");
+    }
+    // Wait for data from outside the network (e.g. EnqueueValueToChannel from
+    // another thread) to make a proc ready.
+    mutex_.Await(absl::Condition(this, &PooledProcRuntime::WorkAvailable));
+  }
+
+  return absl::OkStatus();
+}
+
+absl::Status PooledProcRuntime::EnqueueValueToChannel(Channel* channel,
+                                                      const Value& value) {
+  XLS_RET_CHECK_EQ(package_->GetTypeForValue(value), channel->type());
+  Type* type = package_->GetTypeForValue(value);
+
+  XLS_RET_CHECK(!procs_.empty());
+  IrJit* jit = procs_.front()->jit.get();
+  int64_t size = jit->type_converter()->GetTypeByteSize(type);
+  auto buffer = std::make_unique<uint8_t[]>(size);
+  jit->runtime()->BlitValueToBuffer(value, type,
+                                    absl::MakeSpan(buffer.get(), size));
+
+  XLS_ASSIGN_OR_RETURN(JitChannelQueue * queue,
+                       queue_mgr()->GetQueueById(channel->id()));
+  queue->Send(buffer.get(), size);
+
+  // New external data may make a proc ready mid-Tick().
+  absl::MutexLock lock(&mutex_);
+  if (num_pending_ > 0) {
+    ScheduleReadyProcs();
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<Value> PooledProcRuntime::DequeueValueFromChannel(
+    Channel* channel) {
+  Type* type = channel->type();
+
+  XLS_RET_CHECK(!procs_.empty());
+  IrJit* jit = procs_.front()->jit.get();
+  int64_t size = jit->type_converter()->GetTypeByteSize(type);
+  auto buffer = std::make_unique<uint8_t[]>(size);
+
+  XLS_ASSIGN_OR_RETURN(JitChannelQueue * queue,
+                       queue_mgr()->GetQueueById(channel->id()));
+  queue->Recv(buffer.get(), size);
+
+  return jit->runtime()->UnpackBuffer(buffer.get(), type);
+}
+
+int64_t PooledProcRuntime::NumProcs() const { return procs_.size(); }
+
+absl::StatusOr<Proc*> PooledProcRuntime::proc(int64_t index) const {
+  if (index > procs_.size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Valid indices are 0 - ", procs_.size(), "."));
+  }
+  return dynamic_cast<Proc*>(procs_[index]->jit->function());
+}
+
+absl::StatusOr<Value> PooledProcRuntime::ProcState(int64_t index) const {
+  if (index > procs_.size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Valid indices are 0 - ", procs_.size(), "."));
+  }
+
+  XLS_ASSIGN_OR_RETURN(Proc * p, proc(index));
+  return procs_[index]->jit->runtime()->UnpackBuffer(
+      procs_[index]->proc_state.get(), p->StateType());
+}
+
+}  // namespace xls
@@ -0,0 +1,151 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef XLS_JIT_POOLED_PROC_RUNTIME_H_
+#define XLS_JIT_POOLED_PROC_RUNTIME_H_
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/common/thread.h"
+#include "xls/ir/package.h"
+#include "xls/jit/ir_jit.h"
+#include "xls/jit/jit_channel_queue.h"
+
+namespace xls {
+
+// PooledProcRuntime executes a proc network by multiplexing proc activations
+// over a fixed pool of worker threads instead of dedicating an OS thread to
+// every proc (as SerialProcRuntime does). A proc is scheduled onto the pool
+// only when every channel it receives from has data queued, so an activation
+// never blocks a worker thread. For designs with many more procs than cores
+// this avoids the context-switch and handshake overhead of thread-per-proc
+// execution: throughput scales with the number of cores rather than degrading
+// with the number of procs.
+//
+// Within a Tick() every proc is activated exactly once, in data-dependency
+// order; independent procs run concurrently. Tick(n) batches n ticks into one
+// scheduling round: a proc scheduled onto a worker keeps running consecutive
+// activations for as long as its input channels have data and it has tick
+// budget left, so scheduling and synchronization cost is paid per batch
+// rather than per tick. Because readiness requires data on every receive
+// channel, a proc which receives more than once from the same channel in a
+// single activation is not supported.
+class PooledProcRuntime {
+ public:
+  // Creates a runtime for "package" executing on "num_workers" worker
+  // threads. If "num_workers" is zero, one worker per hardware thread is
+  // used.
+  static absl::StatusOr<std::unique_ptr<PooledProcRuntime>> Create(
+      Package* package, int64_t num_workers = 0);
+  ~PooledProcRuntime();
+
+  // Execute one cycle of every proc in the network.
+  absl::Status Tick() { return Tick(1); }
+
+  // Advances every proc in the network exactly "num_ticks" ticks. Unlike
+  // calling Tick() in a loop there is no barrier between ticks: each proc
+  // runs ahead as far as its channel occupancy and remaining budget allow
+  // before yielding its worker, which amortizes the per-activation
+  // scheduling cost over the batch. Channel queues may hold up to one
+  // batch's worth of in-flight elements while procs run ahead of their
+  // consumers.
+  absl::Status Tick(int64_t num_ticks);
+
+  Package* package() { return package_; }
+  JitChannelQueueManager* queue_mgr() { return queue_mgr_.get(); }
+
+  // Enqueues the given set of values into the given channel. 'values' must
+  // match the number and type of the data elements of the channel.
+  absl::Status EnqueueValueToChannel(Channel* channel, const Value& value);
+
+  // Dequeues a set of values into the given channel. The number and type of
+  // the returned values matches the number and type of the data elements of
+  // the channel.
+  absl::StatusOr<Value> DequeueValueFromChannel(Channel* channel);
+
+  // Returns the current number of procs in this runtime.
+  int64_t NumProcs() const;
+
+  // Returns the n'th Proc being executed.
+  absl::StatusOr<Proc*> proc(int64_t proc_index) const;
+
+  // Returns the current state value in the given proc.
+  absl::StatusOr<Value> ProcState(int64_t proc_index) const;
+
+ private:
+  // Per-proc execution state. Mutable fields are guarded by the runtime's
+  // mutex_ (absl thread annotations can't express that for a nested struct).
+  struct ProcData {
+    std::unique_ptr<IrJit> jit;
+
+    // The size of and actual buffer used to hold the Proc's carried state.
+    int64_t proc_state_size;
+    std::unique_ptr<uint8_t[]> proc_state;
+
+    // Queues feeding this proc's receive nodes. The proc is ready to run when
+    // all of them are non-empty.
+    std::vector<JitChannelQueue*> input_queues;
+
+    // Activations this proc still owes for the current Tick(n) batch.
+    int64_t ticks_remaining;
+
+    // True if the proc is currently on the ready list or running on a worker.
+    bool scheduled;
+  };
+
+  PooledProcRuntime(Package* package, int64_t num_workers);
+  absl::Status Init();
+
+  // Body of each worker thread: pops a ready proc and runs consecutive
+  // activations while input data and the proc's tick budget last.
+  void WorkerFn();
+
+  // Proc Receive handler function. Never blocks: readiness guarantees the
+  // queue has data.
+  static void RecvFn(JitChannelQueue* queue, Receive* recv, uint8_t* data,
+                     int64_t data_bytes, void* user_data);
+
+  // Proc Send handler function.
+  static void SendFn(JitChannelQueue* queue, Send* send, uint8_t* data,
+                     int64_t data_bytes, void* user_data);
+
+  // Moves every unscheduled proc with remaining tick budget whose input
+  // queues all have data onto the ready list.
+  void ScheduleReadyProcs() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Mutex condition predicates.
+  bool WorkAvailable() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  bool TickQuiesced() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  Package* package_;
+  int64_t num_workers_;
+  std::unique_ptr<JitChannelQueueManager> queue_mgr_;
+  std::vector<std::unique_ptr<ProcData>> procs_;
+  std::vector<std::unique_ptr<Thread>> workers_;
+
+  absl::Mutex mutex_;
+  std::deque<ProcData*> ready_ ABSL_GUARDED_BY(mutex_);
+  // Total proc activations outstanding in the current Tick(n) batch.
+  int64_t num_pending_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t num_running_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace xls
+
+#endif  // XLS_JIT_POOLED_PROC_RUNTIME_H_
@@ -0,0 +1,166 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "xls/jit/pooled_proc_runtime.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+#include "xls/jit/jit_channel_queue.h"
+
+namespace xls {
+namespace {
+
+template <typename T>
+void EnqueueData(JitChannelQueue* queue, T data) {
+  queue->Send(absl::bit_cast<uint8_t*>(&data), sizeof(T));
+}
+
+template <typename T>
+T DequeueData(JitChannelQueue* queue) {
+  T data;
+  queue->Recv(absl::bit_cast<uint8_t*>(&data), sizeof(T));
+  return data;
+}
+
+// A simple X -> A -> B -> Y network without internal state; the output should
+// be the input multiplied by 6. Mirrors the SerialProcRuntime test of the
+// same name.
+constexpr const char kSimpleNetworkIr[] = R"(
+package p
+
+chan a_in(bits[32], id=0, kind=streaming, ops=receive_only, flow_control=none, metadata="")
+chan a_to_b(bits[32], id=1, kind=streaming, ops=send_receive, flow_control=none, metadata="")
+chan b_out(bits[32], id=2, kind=streaming, ops=send_only, flow_control=none, metadata="")
+
+proc a(my_token: token, state: (), init=()) {
+  literal.1: bits[32] = literal(value=2)
+  receive.2: (token, bits[32]) = receive(my_token, channel_id=0)
+  tuple_index.3: token = tuple_index(receive.2, index=0)
+  tuple_index.4: bits[32] = tuple_index(receive.2, index=1)
+  umul.5: bits[32] = umul(literal.1, tuple_index.4)
+  send.6: token = send(tuple_index.3, umul.5, channel_id=1)
+  next (send.6, state)
+}
+
+proc b(my_token: token, state: (), init=()) {
+  literal.100: bits[32] = literal(value=3)
+  receive.200: (token, bits[32]) = receive(my_token, channel_id=1)
+  tuple_index.300: token = tuple_index(receive.200, index=0)
+  tuple_index.400: bits[32] = tuple_index(receive.200, index=1)
+  umul.500: bits[32] = umul(literal.100, tuple_index.400)
+  send.600: token = send(tuple_index.300, umul.500, channel_id=2)
+  next (send.600, state)
+}
+)";
+
+void RunSimpleNetwork(int64_t num_workers) {
+  constexpr int kNumCycles = 4;
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, Parser::ParsePackage(kSimpleNetworkIr));
+  XLS_ASSERT_OK_AND_ASSIGN(auto runtime,
+                           PooledProcRuntime::Create(p.get(), num_workers));
+  auto queue_mgr = runtime->queue_mgr();
+  XLS_ASSERT_OK_AND_ASSIGN(auto input_queue, queue_mgr->GetQueueById(0));
+  XLS_ASSERT_OK_AND_ASSIGN(auto internal_queue, queue_mgr->GetQueueById(1));
+  XLS_ASSERT_OK_AND_ASSIGN(auto output_queue, queue_mgr->GetQueueById(2));
+
+  // Prepopulate the non-output queues.
+  for (int i = 0; i < kNumCycles; i++) {
+    EnqueueData(input_queue, i);
+  }
+
+  int dummy = 0;
+  EnqueueData(internal_queue, dummy);
+
+  for (int i = 0; i < kNumCycles; i++) {
+    XLS_ASSERT_OK(runtime->Tick());
+  }
+
+  // Drop one output, since "b" doesn't get the actual input data until
+  // cycle 1.
+  DequeueData<int>(output_queue);
+  for (int i = 0; i < kNumCycles - 1; i++) {
+    int result = DequeueData<int>(output_queue);
+    EXPECT_EQ(result, i * 6);
+  }
+}
+
+TEST(PooledProcRuntimeTest, SimpleNetwork) { RunSimpleNetwork(4); }
+
+// A single batched Tick(n) produces the same results as n barrier-separated
+// ticks; procs run ahead within the batch as their input data allows.
+TEST(PooledProcRuntimeTest, BatchedTicks) {
+  constexpr int kNumCycles = 16;
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, Parser::ParsePackage(kSimpleNetworkIr));
+  XLS_ASSERT_OK_AND_ASSIGN(auto runtime,
+                           PooledProcRuntime::Create(p.get(), 2));
+  auto queue_mgr = runtime->queue_mgr();
+  XLS_ASSERT_OK_AND_ASSIGN(auto input_queue, queue_mgr->GetQueueById(0));
+  XLS_ASSERT_OK_AND_ASSIGN(auto internal_queue, queue_mgr->GetQueueById(1));
+  XLS_ASSERT_OK_AND_ASSIGN(auto output_queue, queue_mgr->GetQueueById(2));
+
+  for (int i = 0; i < kNumCycles; i++) {
+    EnqueueData(input_queue, i);
+  }
+  int dummy = 0;
+  EnqueueData(internal_queue, dummy);
+
+  XLS_ASSERT_OK(runtime->Tick(kNumCycles));
+
+  DequeueData<int>(output_queue);
+  for (int i = 0; i < kNumCycles - 1; i++) {
+    int result = DequeueData<int>(output_queue);
+    EXPECT_EQ(result, i * 6);
+  }
+  EXPECT_TRUE(output_queue->Empty());
+}
+
+// The runtime must make progress even with fewer workers than procs; with a
+// single worker the network executes correctly (if serially).
+TEST(PooledProcRuntimeTest, MoreProcsThanWorkers) { RunSimpleNetwork(1); }
+
+// A network which can never make progress reports deadlock instead of
+// hanging.
+TEST(PooledProcRuntimeTest, DetectsDeadlock) {
+  const std::string kIrText = R"(
+package p
+
+chan a_to_b(bits[32], id=0, kind=streaming, ops=send_receive, flow_control=none, metadata="")
+chan b_to_a(bits[32], id=1, kind=streaming, ops=send_receive, flow_control=none, metadata="")
+
+proc a(my_token: token, state: (), init=()) {
+  receive.1: (token, bits[32]) = receive(my_token, channel_id=1)
+  tuple_index.2: token = tuple_index(receive.1, index=0)
+  tuple_index.3: bits[32] = tuple_index(receive.1, index=1)
+  send.4: token = send(tuple_index.2, tuple_index.3, channel_id=0)
+  next (send.4, state)
+}
+
+proc b(my_token: token, state: (), init=()) {
+  receive.101: (token, bits[32]) = receive(my_token, channel_id=0)
+  tuple_index.102: token = tuple_index(receive.101, index=0)
+  tuple_index.103: bits[32] = tuple_index(receive.101, index=1)
+  send.104: token = send(tuple_index.102, tuple_index.103, channel_id=1)
+  next (send.104, state)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, Parser::ParsePackage(kIrText));
+  XLS_ASSERT_OK_AND_ASSIGN(auto runtime, PooledProcRuntime::Create(p.get()));
+  EXPECT_THAT(runtime->Tick(),
+              status_testing::StatusIs(absl::StatusCode::kAborted));
+}
+
+}  // namespace
+}  // namespace xls
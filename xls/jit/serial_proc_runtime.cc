@@ -13,9 +13,11 @@
 // limitations under the License.
 #include "xls/jit/serial_proc_runtime.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/proc.h"
+#include "xls/ir/proc_firing_order.h"
 #include "xls/jit/function_builder_visitor.h"
 #include "xls/jit/jit_channel_queue.h"
 #include "xls/jit/proc_builder_visitor.h"
@@ -102,13 +104,16 @@ void SerialProcRuntime::SendFn(JitChannelQueue* queue, Send* send,
 }
 
 absl::StatusOr<std::unique_ptr<SerialProcRuntime>> SerialProcRuntime::Create(
-    Package* package) {
-  auto runtime = absl::WrapUnique(new SerialProcRuntime(std::move(package)));
+    Package* package, JitChannelQueueManager::QueueKind queue_kind) {
+  auto runtime =
+      absl::WrapUnique(new SerialProcRuntime(std::move(package), queue_kind));
   XLS_RETURN_IF_ERROR(runtime->Init());
   return runtime;
 }
 
-SerialProcRuntime::SerialProcRuntime(Package* package) : package_(package) {}
+SerialProcRuntime::SerialProcRuntime(
+    Package* package, JitChannelQueueManager::QueueKind queue_kind)
+    : package_(package), queue_kind_(queue_kind) {}
 
 SerialProcRuntime::~SerialProcRuntime() {
   for (auto& thread_data : threads_) {
@@ -121,7 +126,8 @@ SerialProcRuntime::~SerialProcRuntime() {
 }
 
 absl::Status SerialProcRuntime::Init() {
-  XLS_ASSIGN_OR_RETURN(queue_mgr_, JitChannelQueueManager::Create(package_));
+  XLS_ASSIGN_OR_RETURN(queue_mgr_,
+                       JitChannelQueueManager::Create(package_, queue_kind_));
 
   threads_.reserve(package_->procs().size());
   for (int i = 0; i < package_->procs().size(); i++) {
@@ -151,6 +157,20 @@ absl::Status SerialProcRuntime::Init() {
         std::make_unique<Thread>([thread_ptr]() { ThreadFn(thread_ptr); });
   }
 
+  // Activate procs in the static firing order of the inter-proc channel
+  // graph (senders before the procs receiving from them) so each proc's
+  // inputs are available when it runs; a feed-forward network then completes
+  // each Tick() with one activation per proc instead of blocking and being
+  // retried.
+  absl::flat_hash_map<Proc*, int64_t> proc_to_thread;
+  for (int64_t i = 0; i < package_->procs().size(); ++i) {
+    proc_to_thread[package_->procs()[i].get()] = i;
+  }
+  firing_order_.reserve(threads_.size());
+  for (Proc* proc : ComputeFlatProcFiringOrder(package_)) {
+    firing_order_.push_back(proc_to_thread.at(proc));
+  }
+
   // Enqueue initial values into channels.
   for (Channel* channel : package_->channels()) {
     if (channel->kind() != ChannelKind::kStreaming) {
@@ -175,7 +195,8 @@ absl::Status SerialProcRuntime::Tick() {
     bool data_sent = false;
     // True if the proc network is blocked waiting on data from "outside".
     bool blocked_by_external = false;
-    for (auto& thread : threads_) {
+    for (int64_t thread_index : firing_order_) {
+      auto& thread = threads_[thread_index];
       absl::MutexLock lock(&thread->mutex);
       if (thread->thread_state == ThreadData::State::kDone) {
         continue;
@@ -215,6 +236,27 @@ absl::Status SerialProcRuntime::Tick() {
     thread->thread_state = ThreadData::State::kPending;
   }
 
+  if (capture_ != nullptr) {
+    for (int64_t i = 0; i < static_cast<int64_t>(threads_.size()); ++i) {
+      XLS_ASSIGN_OR_RETURN(Value state, ProcState(i));
+      capture_->RecordValue(capture_signals_[i], tick_count_, state);
+    }
+  }
+  ++tick_count_;
+
+  return absl::OkStatus();
+}
+
+absl::Status SerialProcRuntime::AttachWaveformCapture(
+    WaveformCapture* capture) {
+  capture_ = capture;
+  capture_signals_.clear();
+  for (int64_t i = 0; i < static_cast<int64_t>(threads_.size()); ++i) {
+    XLS_ASSIGN_OR_RETURN(Proc * p, proc(i));
+    capture_signals_.push_back(
+        capture->AddSignal(absl::StrCat(p->name(), ".state"),
+                           p->StateType()->GetFlatBitCount()));
+  }
   return absl::OkStatus();
 }
 
@@ -252,6 +294,13 @@ absl::StatusOr<Value> SerialProcRuntime::DequeueValueFromChannel(
   return jit->runtime()->UnpackBuffer(buffer.get(), type);
 }
 
+absl::StatusOr<int64_t> SerialProcRuntime::GetChannelFlatByteCount(
+    Channel* channel) {
+  XLS_RET_CHECK(!threads_.empty());
+  IrJit* jit = threads_.front()->jit.get();
+  return jit->type_converter()->GetTypeByteSize(channel->type());
+}
+
 int64_t SerialProcRuntime::NumProcs() const { return threads_.size(); }
 
 absl::StatusOr<Proc*> SerialProcRuntime::proc(int64_t index) const {
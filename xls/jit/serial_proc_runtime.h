@@ -20,16 +20,19 @@
 #include "absl/status/statusor.h"
 #include "xls/common/thread.h"
 #include "xls/ir/package.h"
+#include "xls/ir/waveform_capture.h"
 #include "xls/jit/ir_jit.h"
 #include "xls/jit/jit_channel_queue.h"
 
 namespace xls {
 
 // SerialProcRuntime is the "base case" for Proc runtimes. For each clock tick,
-// it iterates through the procs in its package and runs them once, all within a
-// single thread. While basic, this enables steady progression so that a
-// user can see how a Proc's internal state (or a proc network's internal state)
-// evolves over time.
+// it runs every proc in its package once, activating them in a statically
+// computed firing order over the inter-proc channel graph (senders before the
+// procs receiving from them, see ComputeProcFiringOrder) so feed-forward
+// networks complete a tick without partial executions. While basic, this
+// enables steady progression so that a user can see how a Proc's internal
+// state (or a proc network's internal state) evolves over time.
 // To be able to block/suspect a Proc when waiting on input, we use a thread per
 // Proc. When a receive is done on an empty queue, that Proc thread will
 // conditional-wait until data becomes available, at which point it will
@@ -38,8 +41,15 @@ namespace xls {
 // when a deadlock is detected.
 class SerialProcRuntime {
  public:
+  // "queue_kind" selects the JitChannelQueue implementation backing the
+  // network's channels. With QueueKind::kSpsc, external producers and
+  // consumers can stream flat data into and out of the network without Value
+  // marshalling via the zero-copy ReserveSendSlot()/PeekRecvSlot() APIs on
+  // SpscJitChannelQueue (use GetChannelFlatByteCount() for the element
+  // stride).
   static absl::StatusOr<std::unique_ptr<SerialProcRuntime>> Create(
-      Package* package);
+      Package* package, JitChannelQueueManager::QueueKind queue_kind =
+                            JitChannelQueueManager::QueueKind::kMutex);
   ~SerialProcRuntime();
 
   // Execute one cycle of every proc in the network.
@@ -57,6 +67,12 @@ class SerialProcRuntime {
   // channel.
   absl::StatusOr<Value> DequeueValueFromChannel(Channel* channel);
 
+  // Returns the size in bytes of one element of the given channel in the flat
+  // buffer layout used by the JIT (see JitRuntime::BlitValueToBuffer()). This
+  // is the element stride external code must use when reading or writing
+  // channel data directly through the zero-copy queue APIs.
+  absl::StatusOr<int64_t> GetChannelFlatByteCount(Channel* channel);
+
   // Returns the current number of procs in this runtime.
   int64_t NumProcs() const;
 
@@ -66,6 +82,12 @@ class SerialProcRuntime {
   // Returns the current state value in the given proc.
   absl::StatusOr<Value> ProcState(int64_t proc_index) const;
 
+  // Attaches a waveform capture (not owned): after every subsequent Tick()
+  // the state value of each proc is recorded into it under a
+  // "<proc_name>.state" signal. The capture's change-only encoding keeps the
+  // overhead proportional to how often proc state actually changes.
+  absl::Status AttachWaveformCapture(WaveformCapture* capture);
+
  private:
   // Utility structure to hold state needed by each proc thread.
   struct ThreadData {
@@ -95,7 +117,8 @@ class SerialProcRuntime {
     int64_t blocking_channel ABSL_GUARDED_BY(mutex);
   };
 
-  SerialProcRuntime(Package* package);
+  SerialProcRuntime(Package* package,
+                    JitChannelQueueManager::QueueKind queue_kind);
   absl::Status Init();
   static void ThreadFn(ThreadData* thread_data);
 
@@ -112,8 +135,21 @@ class SerialProcRuntime {
                          const absl::flat_hash_set<ThreadData::State>& states);
 
   Package* package_;
+  JitChannelQueueManager::QueueKind queue_kind_;
   std::vector<std::unique_ptr<ThreadData>> threads_;
+
+  // Indices into threads_ in the static firing order of the inter-proc
+  // channel graph; Tick() activates procs in this order.
+  std::vector<int64_t> firing_order_;
+
   std::unique_ptr<JitChannelQueueManager> queue_mgr_;
+
+  // Optional waveform capture of per-proc state, recorded at the end of each
+  // Tick(). Not owned. capture_signals_[i] is the capture column for the
+  // i'th proc.
+  WaveformCapture* capture_ = nullptr;
+  std::vector<int64_t> capture_signals_;
+  int64_t tick_count_ = 0;
 };
 
 }  // namespace xls
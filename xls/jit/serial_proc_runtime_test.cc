@@ -15,6 +15,7 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "xls/common/casts.h"
 #include "xls/common/status/matchers.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/thread.h"
@@ -445,5 +446,66 @@ TEST(SerialProcRuntimeTest, ChannelInitValues) {
   EXPECT_THAT(get_output(), IsOkAndHolds(Value(UBits(102, 32))));
 }
 
+// Streams data into and out of a network through the zero-copy slot APIs on
+// SPSC queues, without constructing any Values on the data path.
+TEST(SerialProcRuntimeTest, ZeroCopyStreaming) {
+  constexpr int kNumCycles = 4;
+  const std::string kIrText = R"(
+package p
+
+chan a_in(bits[32], id=0, kind=streaming, ops=receive_only, flow_control=none, metadata="")
+chan a_out(bits[32], id=1, kind=streaming, ops=send_only, flow_control=none, metadata="")
+
+proc a(my_token: token, state: (), init=()) {
+  literal.1: bits[32] = literal(value=2)
+  receive.2: (token, bits[32]) = receive(my_token, channel_id=0)
+  tuple_index.3: token = tuple_index(receive.2, index=0)
+  tuple_index.4: bits[32] = tuple_index(receive.2, index=1)
+  umul.5: bits[32] = umul(literal.1, tuple_index.4)
+  send.6: token = send(tuple_index.3, umul.5, channel_id=1)
+  next (send.6, state)
+}
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, Parser::ParsePackage(kIrText));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto runtime,
+      SerialProcRuntime::Create(
+          p.get(), JitChannelQueueManager::QueueKind::kSpsc));
+  XLS_ASSERT_OK_AND_ASSIGN(Channel * in_channel, p->GetChannel(0));
+  XLS_ASSERT_OK_AND_ASSIGN(Channel * out_channel, p->GetChannel(1));
+  XLS_ASSERT_OK_AND_ASSIGN(int64_t element_size,
+                           runtime->GetChannelFlatByteCount(in_channel));
+  ASSERT_EQ(element_size, sizeof(uint32_t));
+
+  XLS_ASSERT_OK_AND_ASSIGN(JitChannelQueue * in_queue,
+                           runtime->queue_mgr()->GetQueueById(in_channel->id()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      JitChannelQueue * out_queue,
+      runtime->queue_mgr()->GetQueueById(out_channel->id()));
+  auto* spsc_in = down_cast<SpscJitChannelQueue*>(in_queue);
+  auto* spsc_out = down_cast<SpscJitChannelQueue*>(out_queue);
+
+  // Write the inputs directly into the ring slots.
+  for (int i = 0; i < kNumCycles; i++) {
+    uint8_t* slot = spsc_in->ReserveSendSlot(element_size);
+    *absl::bit_cast<uint32_t*>(slot) = i;
+    spsc_in->CommitSendSlot();
+  }
+
+  for (int i = 0; i < kNumCycles; i++) {
+    XLS_ASSERT_OK(runtime->Tick());
+  }
+
+  // Read the outputs in place.
+  for (int i = 0; i < kNumCycles; i++) {
+    uint8_t* slot = spsc_out->PeekRecvSlot();
+    ASSERT_NE(slot, nullptr);
+    EXPECT_EQ(*absl::bit_cast<uint32_t*>(slot), i * 2);
+    spsc_out->ReleaseRecvSlot();
+  }
+  EXPECT_EQ(spsc_out->PeekRecvSlot(), nullptr);
+}
+
 }  // namespace
 }  // namespace xls
@@ -0,0 +1,107 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/tiered_ir_jit.h"
+
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+
+namespace xls {
+
+/* static */ absl::StatusOr<std::unique_ptr<TieredIrJit>> TieredIrJit::Create(
+    Function* xls_function, int64_t hot_call_threshold,
+    JitObjectCache* object_cache) {
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<IrJit> cold_jit,
+      IrJit::Create(xls_function, kColdOptLevel, object_cache));
+  return absl::WrapUnique(new TieredIrJit(xls_function, hot_call_threshold,
+                                          object_cache, std::move(cold_jit)));
+}
+
+TieredIrJit::TieredIrJit(Function* xls_function, int64_t hot_call_threshold,
+                         JitObjectCache* object_cache,
+                         std::unique_ptr<IrJit> cold_jit)
+    : xls_function_(xls_function),
+      hot_call_threshold_(hot_call_threshold),
+      object_cache_(object_cache),
+      cold_jit_(std::move(cold_jit)),
+      hot_compile_result_(nullptr) {}
+
+TieredIrJit::~TieredIrJit() {
+  if (compile_thread_ != nullptr) {
+    compile_thread_->Join();
+  }
+}
+
+void TieredIrJit::StartHotCompile() {
+  XLS_VLOG(2) << "Function " << xls_function_->name() << " is hot after "
+              << call_count_ << " calls; recompiling at opt level "
+              << kHotOptLevel << " in the background";
+  // Each IrJit owns an independent LLVM context and session, so the
+  // background compilation does not contend with the cold tier.
+  compile_thread_ = std::make_unique<Thread>([this]() {
+    absl::StatusOr<std::unique_ptr<IrJit>> result =
+        IrJit::Create(xls_function_, kHotOptLevel, object_cache_);
+    absl::MutexLock lock(&mutex_);
+    hot_compile_result_ = std::move(result);
+    hot_compile_done_ = true;
+  });
+}
+
+void TieredIrJit::MaybePromote() {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!hot_compile_done_) {
+      return;
+    }
+    hot_compile_done_ = false;
+    if (!hot_compile_result_.ok()) {
+      // Keep running the cold tier; it produces the same values.
+      XLS_LOG(WARNING) << "Background recompilation of "
+                       << xls_function_->name()
+                       << " failed: " << hot_compile_result_.status();
+      hot_compile_result_ = nullptr;
+    } else {
+      hot_jit_ = std::move(hot_compile_result_.value());
+    }
+  }
+  if (hot_jit_ != nullptr) {
+    XLS_VLOG(2) << "Function " << xls_function_->name()
+                << " promoted to opt level " << kHotOptLevel;
+    compile_thread_->Join();
+    compile_thread_.reset();
+    cold_jit_.reset();
+  }
+}
+
+absl::StatusOr<InterpreterResult<Value>> TieredIrJit::Run(
+    absl::Span<const Value> args, void* user_data) {
+  if (hot_jit_ != nullptr) {
+    ++call_count_;
+    return hot_jit_->Run(args, user_data);
+  }
+  if (compile_thread_ != nullptr) {
+    MaybePromote();
+  } else if (call_count_ + 1 >= hot_call_threshold_) {
+    StartHotCompile();
+  }
+  ++call_count_;
+  IrJit* jit = hot_jit_ != nullptr ? hot_jit_.get() : cold_jit_.get();
+  return jit->Run(args, user_data);
+}
+
+}  // namespace xls
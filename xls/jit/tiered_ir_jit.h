@@ -0,0 +1,109 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_JIT_TIERED_IR_JIT_H_
+#define XLS_JIT_TIERED_IR_JIT_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "xls/common/thread.h"
+#include "xls/ir/events.h"
+#include "xls/ir/function.h"
+#include "xls/ir/value.h"
+#include "xls/jit/ir_jit.h"
+#include "xls/jit/jit_object_cache.h"
+
+namespace xls {
+
+// A JIT with adaptive compilation tiers. Creation compiles the function at
+// opt level 0, which skips the LLVM IR optimization pipeline entirely and
+// keeps time-to-first-execution low; short-lived users (e.g. fuzz evals,
+// where the O2-style pipeline dominates total run time) never pay for more.
+// Once a function has been invoked `hot_call_threshold` times it is
+// recompiled at opt level 3 on a background thread and execution switches to
+// the optimized code when it is ready, so long-running users converge on
+// full-throughput code without configuration. Executions never block on the
+// background compilation.
+//
+// Like IrJit, a TieredIrJit instance must be invoked from a single thread at
+// a time; the tier promotion machinery is internally synchronized.
+class TieredIrJit {
+ public:
+  // Opt levels used by the two tiers.
+  static constexpr int64_t kColdOptLevel = 0;
+  static constexpr int64_t kHotOptLevel = 3;
+
+  // Returns a TieredIrJit with the cold tier compiled and ready to run. The
+  // default threshold amortizes the opt level 3 recompilation across enough
+  // calls that promoting is a clear win, while still promoting early in a
+  // long run.
+  static absl::StatusOr<std::unique_ptr<TieredIrJit>> Create(
+      Function* xls_function, int64_t hot_call_threshold = 256,
+      JitObjectCache* object_cache = nullptr);
+
+  // Joins the background compilation, if one is in flight.
+  ~TieredIrJit();
+
+  // Executes the compiled function with the specified arguments, using the
+  // hot tier if its compilation has completed.
+  absl::StatusOr<InterpreterResult<Value>> Run(absl::Span<const Value> args,
+                                               void* user_data = nullptr);
+
+  // Returns the function that the JIT executes.
+  Function* function() { return xls_function_; }
+
+  // The number of times Run() has been called.
+  int64_t call_count() const { return call_count_; }
+
+  // The opt level of the tier the next Run() call will execute.
+  int64_t current_opt_level() const {
+    return hot_jit_ == nullptr ? kColdOptLevel : kHotOptLevel;
+  }
+
+ private:
+  TieredIrJit(Function* xls_function, int64_t hot_call_threshold,
+              JitObjectCache* object_cache, std::unique_ptr<IrJit> cold_jit);
+
+  // Starts the background compilation of the hot tier.
+  void StartHotCompile();
+
+  // Promotes to the hot tier if the background compilation has finished.
+  void MaybePromote();
+
+  Function* xls_function_;
+  int64_t hot_call_threshold_;
+  JitObjectCache* object_cache_;
+  int64_t call_count_ = 0;
+
+  // The tier executing calls: cold from creation, hot after promotion. Only
+  // touched by the (single) Run() caller.
+  std::unique_ptr<IrJit> cold_jit_;
+  std::unique_ptr<IrJit> hot_jit_;
+
+  // The background compilation hands its result over under mutex_.
+  std::unique_ptr<Thread> compile_thread_;
+  absl::Mutex mutex_;
+  bool hot_compile_done_ ABSL_GUARDED_BY(mutex_) = false;
+  absl::StatusOr<std::unique_ptr<IrJit>> hot_compile_result_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace xls
+
+#endif  // XLS_JIT_TIERED_IR_JIT_H_
@@ -0,0 +1,80 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/tiered_ir_jit.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+
+namespace xls {
+namespace {
+
+using status_testing::IsOkAndHolds;
+
+class TieredIrJitTest : public IrTestBase {
+ protected:
+  absl::StatusOr<Function*> BuildAddOne(Package* p) {
+    FunctionBuilder fb("add_one", p);
+    BValue x = fb.Param("x", p->GetBitsType(32));
+    fb.Add(x, fb.Literal(UBits(1, 32)));
+    return fb.Build();
+  }
+
+  absl::StatusOr<Value> RunNoEvents(TieredIrJit* jit,
+                                    absl::Span<const Value> args) {
+    XLS_ASSIGN_OR_RETURN(InterpreterResult<Value> result, jit->Run(args));
+    return InterpreterResultToStatusOrValue(result);
+  }
+};
+
+TEST_F(TieredIrJitTest, ColdTierProducesCorrectValues) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BuildAddOne(p.get()));
+  // A high threshold so the hot tier is never compiled.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TieredIrJit> jit,
+      TieredIrJit::Create(f, /*hot_call_threshold=*/1000000));
+  EXPECT_EQ(jit->current_opt_level(), TieredIrJit::kColdOptLevel);
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_THAT(RunNoEvents(jit.get(), {Value(UBits(i, 32))}),
+                IsOkAndHolds(Value(UBits(i + 1, 32))));
+  }
+  EXPECT_EQ(jit->call_count(), 10);
+  EXPECT_EQ(jit->current_opt_level(), TieredIrJit::kColdOptLevel);
+}
+
+TEST_F(TieredIrJitTest, HotFunctionIsPromoted) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BuildAddOne(p.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TieredIrJit> jit,
+                           TieredIrJit::Create(f, /*hot_call_threshold=*/2));
+  // Promotion is asynchronous; keep running (with correct results
+  // throughout) until the optimized tier takes over.
+  int64_t i = 0;
+  while (jit->current_opt_level() != TieredIrJit::kHotOptLevel) {
+    ASSERT_THAT(RunNoEvents(jit.get(), {Value(UBits(i % 1000, 32))}),
+                IsOkAndHolds(Value(UBits(i % 1000 + 1, 32))));
+    ++i;
+  }
+  // The hot tier produces the same values.
+  EXPECT_THAT(RunNoEvents(jit.get(), {Value(UBits(41, 32))}),
+              IsOkAndHolds(Value(UBits(42, 32))));
+}
+
+}  // namespace
+}  // namespace xls
@@ -0,0 +1,85 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/netlist/cell_function.h"
+
+#include <functional>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/netlist/function_parser.h"
+
+namespace xls {
+namespace netlist {
+namespace function {
+
+/* static */ absl::StatusOr<CompiledFunction> CompiledFunction::Compile(
+    absl::string_view function) {
+  XLS_ASSIGN_OR_RETURN(Ast ast,
+                       Parser::ParseFunction(std::string(function)));
+  CompiledFunction result;
+  // Hash-cons gates so structurally identical subexpressions share one gate.
+  using GateKey = std::tuple<GateKind, int64_t, int64_t, std::string>;
+  absl::flat_hash_map<GateKey, int64_t> memo;
+  std::function<absl::StatusOr<int64_t>(const Ast&)> build =
+      [&](const Ast& node) -> absl::StatusOr<int64_t> {
+    GateKind kind;
+    int64_t operand0 = -1;
+    int64_t operand1 = -1;
+    std::string name;
+    switch (node.kind()) {
+      case Ast::Kind::kIdentifier:
+        kind = GateKind::kInput;
+        name = node.name();
+        break;
+      case Ast::Kind::kLiteralZero:
+        kind = GateKind::kLiteralZero;
+        break;
+      case Ast::Kind::kLiteralOne:
+        kind = GateKind::kLiteralOne;
+        break;
+      case Ast::Kind::kNot:
+        kind = GateKind::kNot;
+        XLS_ASSIGN_OR_RETURN(operand0, build(node.children()[0]));
+        break;
+      case Ast::Kind::kAnd:
+      case Ast::Kind::kOr:
+      case Ast::Kind::kXor:
+        kind = node.kind() == Ast::Kind::kAnd
+                   ? GateKind::kAnd
+                   : (node.kind() == Ast::Kind::kOr ? GateKind::kOr
+                                                    : GateKind::kXor);
+        XLS_ASSIGN_OR_RETURN(operand0, build(node.children()[0]));
+        XLS_ASSIGN_OR_RETURN(operand1, build(node.children()[1]));
+        break;
+    }
+    auto [it, inserted] =
+        memo.insert({GateKey{kind, operand0, operand1, name},
+                     static_cast<int64_t>(result.gates_.size())});
+    if (inserted) {
+      result.gates_.push_back(Gate{kind, operand0, operand1, name});
+    }
+    return it->second;
+  };
+  XLS_ASSIGN_OR_RETURN(result.output_, build(ast));
+  return result;
+}
+
+}  // namespace function
+}  // namespace netlist
+}  // namespace xls
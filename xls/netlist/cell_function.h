@@ -0,0 +1,78 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_NETLIST_CELL_FUNCTION_H_
+#define XLS_NETLIST_CELL_FUNCTION_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+
+namespace xls {
+namespace netlist {
+namespace function {
+
+// A cell output pin's "function" attribute compiled into a flat,
+// structurally deduplicated gate netlist. Compiling once per cell library
+// entry (see CellLibraryEntry::GetCompiledFunction) lets consumers such as
+// the netlist interpreter and the Z3 netlist translator evaluate cells
+// without re-parsing the attribute text for every cell instance, and the
+// dependency ordering of the gates turns evaluation into a single forward
+// pass over an array instead of an AST recursion.
+class CompiledFunction {
+ public:
+  enum class GateKind : uint8_t {
+    kInput,  // A named input pin or internal state-table signal.
+    kLiteralZero,
+    kLiteralOne,
+    kNot,
+    kAnd,
+    kOr,
+    kXor,
+  };
+
+  // One gate of the compiled netlist. Operand indices always refer to
+  // earlier gates.
+  struct Gate {
+    GateKind kind;
+    int64_t operand0 = -1;  // Unused for kInput and the literals.
+    int64_t operand1 = -1;  // Only used for the binary kinds.
+    std::string name;       // Only set for kInput.
+  };
+
+  // Parses and compiles the given function attribute text. Structurally
+  // identical subexpressions (e.g. a pin referenced several times) compile
+  // to a single shared gate.
+  static absl::StatusOr<CompiledFunction> Compile(absl::string_view function);
+
+  // The gates in dependency order (operands before users).
+  absl::Span<const Gate> gates() const { return gates_; }
+
+  // The index of the gate computing the function's result.
+  int64_t output() const { return output_; }
+
+ private:
+  std::vector<Gate> gates_;
+  int64_t output_ = -1;
+};
+
+}  // namespace function
+}  // namespace netlist
+}  // namespace xls
+
+#endif  // XLS_NETLIST_CELL_FUNCTION_H_
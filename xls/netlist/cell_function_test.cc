@@ -0,0 +1,100 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/netlist/cell_function.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+
+namespace xls {
+namespace netlist {
+namespace function {
+namespace {
+
+using GateKind = CompiledFunction::GateKind;
+
+TEST(CellFunctionTest, SingleIdentifier) {
+  XLS_ASSERT_OK_AND_ASSIGN(CompiledFunction f, CompiledFunction::Compile("A"));
+  ASSERT_EQ(f.gates().size(), 1);
+  EXPECT_EQ(f.gates()[0].kind, GateKind::kInput);
+  EXPECT_EQ(f.gates()[0].name, "A");
+  EXPECT_EQ(f.output(), 0);
+}
+
+TEST(CellFunctionTest, SimpleCompound) {
+  XLS_ASSERT_OK_AND_ASSIGN(CompiledFunction f,
+                           CompiledFunction::Compile("A*B+C"));
+  const auto& root = f.gates()[f.output()];
+  ASSERT_EQ(root.kind, GateKind::kOr);
+  const auto& lhs = f.gates()[root.operand0];
+  const auto& rhs = f.gates()[root.operand1];
+  EXPECT_EQ(lhs.kind, GateKind::kAnd);
+  EXPECT_EQ(f.gates()[lhs.operand0].name, "A");
+  EXPECT_EQ(f.gates()[lhs.operand1].name, "B");
+  EXPECT_EQ(rhs.kind, GateKind::kInput);
+  EXPECT_EQ(rhs.name, "C");
+}
+
+TEST(CellFunctionTest, OperandsPrecedeUsers) {
+  XLS_ASSERT_OK_AND_ASSIGN(CompiledFunction f,
+                           CompiledFunction::Compile("!(A^B)*(C+0)"));
+  EXPECT_EQ(f.output(), static_cast<int64_t>(f.gates().size()) - 1);
+  for (int64_t i = 0; i < static_cast<int64_t>(f.gates().size()); ++i) {
+    const auto& gate = f.gates()[i];
+    if (gate.operand0 >= 0) {
+      EXPECT_LT(gate.operand0, i);
+    }
+    if (gate.operand1 >= 0) {
+      EXPECT_LT(gate.operand1, i);
+    }
+  }
+}
+
+TEST(CellFunctionTest, RepeatedSubexpressionsAreShared) {
+  // "A" appears three times and "A*B" twice, but each compiles to a single
+  // gate.
+  XLS_ASSERT_OK_AND_ASSIGN(CompiledFunction f,
+                           CompiledFunction::Compile("(A*B)+(A*B)+!A"));
+  int64_t num_inputs_named_a = 0;
+  int64_t num_ands = 0;
+  for (const auto& gate : f.gates()) {
+    if (gate.kind == GateKind::kInput && gate.name == "A") {
+      num_inputs_named_a++;
+    }
+    if (gate.kind == GateKind::kAnd) {
+      num_ands++;
+    }
+  }
+  EXPECT_EQ(num_inputs_named_a, 1);
+  EXPECT_EQ(num_ands, 1);
+}
+
+TEST(CellFunctionTest, Literals) {
+  XLS_ASSERT_OK_AND_ASSIGN(CompiledFunction f,
+                           CompiledFunction::Compile("A*1+0"));
+  bool saw_one = false;
+  bool saw_zero = false;
+  for (const auto& gate : f.gates()) {
+    saw_one |= gate.kind == GateKind::kLiteralOne;
+    saw_zero |= gate.kind == GateKind::kLiteralZero;
+  }
+  EXPECT_TRUE(saw_one);
+  EXPECT_TRUE(saw_zero);
+}
+
+}  // namespace
+}  // namespace function
+}  // namespace netlist
+}  // namespace xls
@@ -370,6 +370,24 @@ absl::StatusOr<StateTableProto> StateTable::ToProto() const {
                           state_table);
 }
 
+absl::StatusOr<const function::CompiledFunction*>
+CellLibraryEntry::GetCompiledFunction(absl::string_view output_pin) const {
+  auto it = compiled_functions_.find(output_pin);
+  if (it != compiled_functions_.end()) {
+    return &it->second;
+  }
+  auto pin_it = output_pin_to_function_.find(output_pin);
+  if (pin_it == output_pin_to_function_.end()) {
+    return absl::NotFoundError(absl::StrFormat(
+        "Cell \"%s\" has no output pin \"%s\".", name_, output_pin));
+  }
+  XLS_ASSIGN_OR_RETURN(function::CompiledFunction compiled,
+                       function::CompiledFunction::Compile(pin_it->second));
+  return &compiled_functions_
+              .emplace(std::string(output_pin), std::move(compiled))
+              .first->second;
+}
+
 absl::StatusOr<CellLibraryEntryProto> CellLibraryEntry::ToProto() const {
   CellLibraryEntryProto proto;
   switch (kind_) {
@@ -447,11 +465,20 @@ absl::Status CellLibrary::AddEntry(CellLibraryEntry entry) {
 absl::StatusOr<const CellLibraryEntry*> CellLibrary::GetEntry(
     absl::string_view name) const {
   auto it = entries_.find(name);
-  if (it == entries_.end()) {
-    return absl::NotFoundError(
-        absl::StrCat("Cell not found in library: ", name));
+  if (it != entries_.end()) {
+    return it->second.get();
+  }
+  if (entry_loader_ != nullptr) {
+    XLS_ASSIGN_OR_RETURN(CellLibraryEntryProto entry_proto,
+                         entry_loader_(name));
+    XLS_ASSIGN_OR_RETURN(CellLibraryEntry entry,
+                         CellLibraryEntry::FromProto(entry_proto));
+    auto inserted = entries_.insert(
+        {entry.name(), std::make_unique<CellLibraryEntry>(std::move(entry))});
+    return inserted.first->second.get();
   }
-  return it->second.get();
+  return absl::NotFoundError(
+      absl::StrCat("Cell not found in library: ", name));
 }
 
 }  // namespace netlist
@@ -15,12 +15,14 @@
 #ifndef XLS_NETLIST_CELL_LIBRARY_H_
 #define XLS_NETLIST_CELL_LIBRARY_H_
 
+#include <functional>
 #include <string>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "xls/netlist/cell_function.h"
 #include "xls/netlist/netlist.pb.h"
 
 namespace xls {
@@ -174,6 +176,16 @@ class CellLibraryEntry {
   const absl::optional<StateTable>& state_table() const { return state_table_; }
   absl::optional<std::string> clock_name() const { return clock_name_; }
 
+  // Returns the compiled form of the given output pin's function attribute,
+  // compiling it on the first request and caching the result for the
+  // lifetime of the entry so per-instance consumers (the netlist
+  // interpreter, the Z3 translator) never re-parse the attribute text. Like
+  // lazy entry loading in CellLibrary, the cache is not thread-safe;
+  // concurrent callers must synchronize externally. Returns a NOT_FOUND
+  // status if the entry has no such output pin.
+  absl::StatusOr<const function::CompiledFunction*> GetCompiledFunction(
+      absl::string_view output_pin) const;
+
   absl::StatusOr<CellLibraryEntryProto> ToProto() const;
 
  private:
@@ -183,6 +195,11 @@ class CellLibraryEntry {
   OutputPinToFunction output_pin_to_function_;
   absl::optional<StateTable> state_table_;
   absl::optional<std::string> clock_name_;
+
+  // Cache for GetCompiledFunction(), keyed by output pin name. Mutable so
+  // the logically-const lookup can populate it.
+  mutable absl::flat_hash_map<std::string, function::CompiledFunction>
+      compiled_functions_;
 };
 
 // Represents a library of cells. The definitions (represented in
@@ -190,18 +207,42 @@ class CellLibraryEntry {
 // Module.
 class CellLibrary {
  public:
+  // Invoked on a GetEntry() miss to materialize an entry on demand, e.g.
+  // parsed out of a large Liberty file by
+  // function::LazyFunctionExtractor::ExtractCell. Returns a NOT_FOUND status
+  // if the backing library has no cell with the given name.
+  using EntryLoader =
+      std::function<absl::StatusOr<CellLibraryEntryProto>(absl::string_view)>;
+
   static absl::StatusOr<CellLibrary> FromProto(const CellLibraryProto& proto);
 
+  CellLibrary() = default;
+
+  // Constructs a library whose entries are materialized on demand by
+  // "entry_loader" rather than being populated up front. Only cells actually
+  // requested via GetEntry() are ever parsed, which keeps load cost
+  // proportional to the cells a netlist uses.
+  explicit CellLibrary(EntryLoader entry_loader)
+      : entry_loader_(std::move(entry_loader)) {}
+
   // Returns a NOT_FOUND status if there is not entry with the given name.
+  // Note that lazy loading of entries is not thread-safe; concurrent lookups
+  // must be externally synchronized if an entry loader is set.
   absl::StatusOr<const CellLibraryEntry*> GetEntry(
       absl::string_view name) const;
 
   absl::Status AddEntry(CellLibraryEntry entry);
 
+  // Note: for a lazily-loaded library this only contains the entries that have
+  // been materialized so far.
   absl::StatusOr<CellLibraryProto> ToProto() const;
 
  private:
-  absl::flat_hash_map<std::string, std::unique_ptr<CellLibraryEntry>> entries_;
+  // Mutable so the (logically const) GetEntry() can cache lazily-loaded
+  // entries.
+  mutable absl::flat_hash_map<std::string, std::unique_ptr<CellLibraryEntry>>
+      entries_;
+  EntryLoader entry_loader_;
 };
 
 }  // namespace netlist
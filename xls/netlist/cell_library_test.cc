@@ -20,6 +20,8 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "xls/common/status/matchers.h"
 #include "xls/netlist/netlist.pb.h"
 
@@ -163,6 +165,41 @@ TEST(CellLibraryTest, LutStateTable) {
   EXPECT_THAT(table.GetSignalValue(stimulus, "X"), IsOkAndHolds(false));
 }
 
+TEST(CellLibraryTest, LazyEntryLoader) {
+  int64_t num_loads = 0;
+  CellLibrary cell_library(
+      [&num_loads](
+          absl::string_view name) -> absl::StatusOr<CellLibraryEntryProto> {
+        if (name != "INV") {
+          return absl::NotFoundError(
+              absl::StrCat("Cell not found in library: ", name));
+        }
+        ++num_loads;
+        CellLibraryEntryProto proto;
+        proto.set_kind(CellKindProto::INVERTER);
+        proto.set_name("INV");
+        proto.add_input_names("A");
+        OutputPinProto* pin = proto.mutable_output_pin_list()->add_pins();
+        pin->set_name("Z");
+        pin->set_function("W");
+        return proto;
+      });
+
+  XLS_ASSERT_OK_AND_ASSIGN(const CellLibraryEntry* entry,
+                           cell_library.GetEntry("INV"));
+  EXPECT_EQ(entry->name(), "INV");
+  EXPECT_EQ(entry->kind(), CellKind::kInverter);
+
+  // The second lookup is served from the cache rather than the loader.
+  XLS_ASSERT_OK_AND_ASSIGN(const CellLibraryEntry* entry2,
+                           cell_library.GetEntry("INV"));
+  EXPECT_EQ(entry2, entry);
+  EXPECT_EQ(num_loads, 1);
+
+  EXPECT_THAT(cell_library.GetEntry("AND2"),
+              status_testing::StatusIs(absl::StatusCode::kNotFound));
+}
+
 }  // namespace
 }  // namespace netlist
 }  // namespace xls
@@ -14,57 +14,46 @@
 
 #include "xls/netlist/find_logic_clouds.h"
 
+#include <algorithm>
+#include <deque>
+
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/math_util.h"
+#include "xls/common/thread_pool.h"
 #include "xls/data_structures/union_find_map.h"
 
 namespace xls {
 namespace netlist {
 namespace rtl {
+namespace {
 
-void Cluster::Add(Cell* cell) {
-  if (cell->kind() == CellKind::kFlop) {
-    terminating_flops_.push_back(cell);
-  } else {
-    other_cells_.push_back(cell);
-  }
-}
+using CellUnionFind = UnionFindMap<Cell*, absl::monostate>;
 
-void Cluster::SortCells() {
-  auto cell_name_lt = [](const Cell* a, const Cell* b) {
-    return a->name() < b->name();
-  };
-  std::sort(terminating_flops_.begin(), terminating_flops_.end(), cell_name_lt);
-  std::sort(other_cells_.begin(), other_cells_.end(), cell_name_lt);
-}
+// Cell count per shard below which sharding the connectivity scan isn't worth
+// the per-shard merge overhead.
+constexpr int64_t kMinCellsPerShard = 4096;
 
-std::vector<Cluster> FindLogicClouds(const Module& module,
-                                     bool include_vacuous) {
-  UnionFindMap<Cell*, absl::monostate> cell_to_uf;
-
-  auto merge_monostate = [](absl::monostate x, absl::monostate y) {
-    return absl::monostate();
-  };
-
-  // Gets-or-adds the given cell to the UnionFindMap
-  auto get_uf = [&cell_to_uf](Cell* c) -> Cell* {
-    if (auto pair = cell_to_uf.Find(c)) {
-      return pair->first;
-    } else {
-      cell_to_uf.Insert(c, absl::monostate());
-      return c;
-    }
-  };
+absl::monostate MergeMonostate(absl::monostate x, absl::monostate y) {
+  return absl::monostate();
+}
 
-  // Helper for debugging that counts the number of equivalence classes in
-  // cell_to_uf.
-  auto count_equivalence_classes = [&cell_to_uf]() -> int64_t {
-    return cell_to_uf.GetRepresentatives().size();
-  };
+// Gets-or-adds the given cell to the UnionFindMap.
+Cell* GetOrAdd(CellUnionFind* cell_to_uf, Cell* c) {
+  if (auto pair = cell_to_uf->Find(c)) {
+    return pair->first;
+  }
+  cell_to_uf->Insert(c, absl::monostate());
+  return c;
+}
 
-  for (auto& item : module.cells()) {
-    Cell* cell = item.get();
+// Builds a union-find over the connectivity edges discovered by inspecting
+// the pins of the given cells. The slice only determines whose pins are
+// walked; the resulting map also contains the cells those pins connect to.
+CellUnionFind ScanCellConnectivity(absl::Span<Cell* const> cells) {
+  CellUnionFind cell_to_uf;
+  for (Cell* cell : cells) {
     XLS_VLOG(4) << "Considering cell: " << cell->name();
 
     // Flop output connectivity is excluded from the equivalence class, so we
@@ -72,10 +61,7 @@ std::vector<Cluster> FindLogicClouds(const Module& module,
     if (cell->kind() == CellKind::kFlop) {
       // For flops we just make sure an equivalence class is present in the
       // map, in case it doesn't have any cells on the input side.
-      (void)get_uf(cell);
-      XLS_VLOG(4) << "--- Now " << count_equivalence_classes()
-                  << " equivalence classes for " << cell_to_uf.GetKeys().size()
-                  << " cells.";
+      (void)GetOrAdd(&cell_to_uf, cell);
       continue;
     }
 
@@ -94,10 +80,8 @@ std::vector<Cluster> FindLogicClouds(const Module& module,
         }
         XLS_VLOG(4) << absl::StreamFormat("-- Cell %s is connected to cell %s",
                                           cell->name(), connected->name());
-        cell_to_uf.Union(get_uf(cell), get_uf(connected), merge_monostate);
-        XLS_VLOG(4) << "--- Now " << count_equivalence_classes()
-                    << " equivalence classes for "
-                    << cell_to_uf.GetKeys().size() << " cells.";
+        cell_to_uf.Union(GetOrAdd(&cell_to_uf, cell),
+                         GetOrAdd(&cell_to_uf, connected), MergeMonostate);
       }
     }
 
@@ -110,10 +94,134 @@ std::vector<Cluster> FindLogicClouds(const Module& module,
         }
         XLS_VLOG(4) << absl::StreamFormat("-- Cell %s is connected to cell %s",
                                           cell->name(), connected->name());
-        cell_to_uf.Union(get_uf(cell), get_uf(connected), merge_monostate);
-        XLS_VLOG(4) << "--- Now " << count_equivalence_classes()
-                    << " equivalence classes for "
-                    << cell_to_uf.GetKeys().size() << " cells.";
+        cell_to_uf.Union(GetOrAdd(&cell_to_uf, cell),
+                         GetOrAdd(&cell_to_uf, connected), MergeMonostate);
+      }
+    }
+  }
+  return cell_to_uf;
+}
+
+// Returns the longest combinational path through the cluster, counted in
+// non-flop cells. Runs a Kahn-style longest-path sweep over the in-cluster
+// driver->sink edges; cells on a combinational cycle (not expected in a
+// well-formed synthesized netlist) are never visited by the sweep and so
+// don't extend the depth.
+int64_t ComputeClusterDepth(const Cluster& cluster) {
+  absl::flat_hash_set<const Cell*> in_cluster(cluster.other_cells().begin(),
+                                              cluster.other_cells().end());
+  absl::flat_hash_map<const Cell*, std::vector<const Cell*>> sinks;
+  absl::flat_hash_map<const Cell*, int64_t> pending_drivers;
+  for (const Cell* cell : cluster.other_cells()) {
+    int64_t driver_count = 0;
+    for (const auto& input : cell->inputs()) {
+      for (const Cell* connected : input.netref->connected_cells()) {
+        if (connected == cell || !in_cluster.contains(connected)) {
+          continue;
+        }
+        // The connected cell only drives us if our input net is one of its
+        // output pins (connected_cells() holds sinks as well as drivers).
+        bool is_driver = false;
+        for (const auto& output : connected->outputs()) {
+          if (output.netref == input.netref) {
+            is_driver = true;
+            break;
+          }
+        }
+        if (!is_driver) {
+          continue;
+        }
+        sinks[connected].push_back(cell);
+        driver_count++;
+      }
+    }
+    pending_drivers[cell] = driver_count;
+  }
+
+  std::deque<const Cell*> ready;
+  absl::flat_hash_map<const Cell*, int64_t> depth;
+  for (const Cell* cell : cluster.other_cells()) {
+    if (pending_drivers.at(cell) == 0) {
+      ready.push_back(cell);
+      depth[cell] = 1;
+    }
+  }
+  int64_t max_depth = 0;
+  while (!ready.empty()) {
+    const Cell* cell = ready.front();
+    ready.pop_front();
+    max_depth = std::max(max_depth, depth.at(cell));
+    for (const Cell* sink : sinks[cell]) {
+      int64_t& sink_depth = depth[sink];
+      sink_depth = std::max(sink_depth, depth.at(cell) + 1);
+      if (--pending_drivers.at(sink) == 0) {
+        ready.push_back(sink);
+      }
+    }
+  }
+  return max_depth;
+}
+
+}  // namespace
+
+void Cluster::Add(Cell* cell) {
+  if (cell->kind() == CellKind::kFlop) {
+    terminating_flops_.push_back(cell);
+  } else {
+    other_cells_.push_back(cell);
+  }
+}
+
+void Cluster::SortCells() {
+  auto cell_name_lt = [](const Cell* a, const Cell* b) {
+    return a->name() < b->name();
+  };
+  std::sort(terminating_flops_.begin(), terminating_flops_.end(), cell_name_lt);
+  std::sort(other_cells_.begin(), other_cells_.end(), cell_name_lt);
+}
+
+std::vector<Cluster> FindLogicClouds(const Module& module,
+                                     bool include_vacuous) {
+  std::vector<Cell*> cells;
+  cells.reserve(module.cells().size());
+  for (auto& item : module.cells()) {
+    cells.push_back(item.get());
+  }
+
+  // Shard the connectivity scan across the thread pool: each shard unions the
+  // edges it discovers into a private map, and the per-shard maps are then
+  // merged below with one union per (cell, shard) rather than one per edge.
+  // The expensive part - walking every pin of every net - thus runs in
+  // parallel, while the merge touches each cell only once per shard.
+  ThreadPool* pool = &ThreadPool::Global();
+  int64_t shard_count = std::max<int64_t>(
+      std::min<int64_t>(pool->thread_count(),
+                        CeilOfRatio(static_cast<int64_t>(cells.size()),
+                                    kMinCellsPerShard)),
+      1);
+
+  CellUnionFind cell_to_uf;
+  if (shard_count == 1) {
+    cell_to_uf = ScanCellConnectivity(cells);
+  } else {
+    absl::StatusOr<std::vector<CellUnionFind>> shard_maps =
+        ParallelMap<CellUnionFind>(
+            shard_count, /*chunk_size=*/1, pool,
+            [&](int64_t shard) -> absl::StatusOr<CellUnionFind> {
+              int64_t begin = shard * cells.size() / shard_count;
+              int64_t end = (shard + 1) * cells.size() / shard_count;
+              return ScanCellConnectivity(
+                  absl::MakeConstSpan(cells).subspan(begin, end - begin));
+            });
+    // The scan itself is infallible; only an error-returning closure can make
+    // ParallelMap fail.
+    XLS_CHECK_OK(shard_maps.status());
+    for (CellUnionFind& shard_map : *shard_maps) {
+      for (Cell* key : shard_map.GetKeys()) {
+        Cell* root = shard_map.Find(key)->first;
+        (void)GetOrAdd(&cell_to_uf, key);
+        (void)GetOrAdd(&cell_to_uf, root);
+        cell_to_uf.Union(key, root, MergeMonostate);
       }
     }
   }
@@ -121,9 +229,8 @@ std::vector<Cluster> FindLogicClouds(const Module& module,
   // Run through the cells and put them into clusters according to their
   // equivalence classes.
   absl::flat_hash_map<Cell*, Cluster> equivalence_set_to_cluster;
-  for (auto& item : module.cells()) {
-    Cell* cell = item.get();
-    equivalence_set_to_cluster[get_uf(cell)].Add(cell);
+  for (Cell* cell : cells) {
+    equivalence_set_to_cluster[GetOrAdd(&cell_to_uf, cell)].Add(cell);
   }
 
   // Put them into a vector and sort each cluster's internal cells for
@@ -137,6 +244,7 @@ std::vector<Cluster> FindLogicClouds(const Module& module,
       continue;
     }
     cluster.SortCells();
+    cluster.set_depth(ComputeClusterDepth(cluster));
     clusters.push_back(std::move(cluster));
   }
 
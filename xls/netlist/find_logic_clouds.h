@@ -15,6 +15,7 @@
 #ifndef XLS_NETLIST_FIND_LOGIC_CLOUDS_H_
 #define XLS_NETLIST_FIND_LOGIC_CLOUDS_H_
 
+#include <cstdint>
 #include <vector>
 
 #include "xls/netlist/netlist.h"
@@ -38,9 +39,22 @@ class Cluster {
   }
   absl::Span<const Cell* const> other_cells() const { return other_cells_; }
 
+  // Number of cells in the cluster, terminating flops included.
+  int64_t size() const {
+    return terminating_flops_.size() + other_cells_.size();
+  }
+
+  // Longest combinational path through the cluster, counted in non-flop
+  // cells. Populated by FindLogicClouds. Together with size() this gives
+  // callers partitioning work across clusters (e.g. per-cluster equivalence
+  // checks, whose cost grows with logic depth) a cheap load estimate.
+  int64_t depth() const { return depth_; }
+  void set_depth(int64_t depth) { depth_ = depth; }
+
  private:
   std::vector<Cell*> terminating_flops_;
   std::vector<Cell*> other_cells_;
+  int64_t depth_ = 0;
 };
 
 // Finds the connected clusters of logic cells between flops in the given module
@@ -51,6 +65,10 @@ class Cluster {
 // include_vacuous indicates whether a terminating flop with no connected logic
 // (e.g. a layer of flops that flop input to the module) should be considered to
 // be a cluster, or just discarded.
+//
+// On large modules the connectivity scan is sharded across the global thread
+// pool; the returned clusters (and their order) are identical to a sequential
+// scan.
 std::vector<Cluster> FindLogicClouds(const Module& module,
                                      bool include_vacuous = false);
 
@@ -131,6 +131,37 @@ cluster {
             ClustersToString(clusters));
 }
 
+TEST(ClusterTest, ClusterMetadata) {
+  // Two levels of logic (an inverter feeding an and) terminate in dff_o, so
+  // that cluster has size 3 and depth 2; the input flops form vacuous
+  // clusters with no logic depth.
+  std::string netlist = R"(module main(clk, a0, b0, o);
+  input clk;
+  input a0, b0;
+  output o;
+  wire a1, a1n, ab, b1;
+
+  DFF dff_a(.D(a0), .Q(a1), .CLK(clk));
+  DFF dff_b(.D(b0), .Q(b1), .CLK(clk));
+  INV inv_a1(.A(a1), .ZN(a1n));
+  AND and_ab(.A(a1n), .B(b1), .Z(ab));
+  DFF dff_o(.D(ab), .Q(o), .CLK(clk));
+endmodule)";
+  Scanner scanner(netlist);
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Netlist> n,
+                           Parser::ParseNetlist(&cell_library, &scanner));
+  XLS_ASSERT_OK_AND_ASSIGN(const Module* m, n->GetModule("main"));
+  std::vector<Cluster> clusters = FindLogicClouds(*m, /*include_vacuous=*/true);
+  ASSERT_EQ(3, clusters.size());
+  EXPECT_EQ(clusters[0].size(), 1);
+  EXPECT_EQ(clusters[0].depth(), 0);
+  EXPECT_EQ(clusters[1].size(), 1);
+  EXPECT_EQ(clusters[1].depth(), 0);
+  EXPECT_EQ(clusters[2].size(), 3);
+  EXPECT_EQ(clusters[2].depth(), 2);
+}
+
 }  // namespace
 }  // namespace rtl
 }  // namespace netlist
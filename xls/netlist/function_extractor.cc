@@ -14,15 +14,22 @@
 
 #include "xls/netlist/function_extractor.h"
 
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "absl/types/variant.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/netlist/lib_parser.h"
 #include "xls/netlist/netlist.pb.h"
 
@@ -37,6 +44,7 @@ constexpr const char kNextStateKey[] = "next_state";
 constexpr const char kStateFunctionKey[] = "state_function";
 constexpr const char kInputValue[] = "input";
 constexpr const char kOutputValue[] = "output";
+constexpr const char kCellKind[] = "cell";
 constexpr const char kPinKind[] = "pin";
 constexpr const char kFfKind[] = "ff";
 constexpr const char kStateTableKind[] = "statetable";
@@ -264,6 +272,25 @@ absl::Status ExtractFromCell(const cell_lib::Block& cell,
   return absl::OkStatus();
 }
 
+// Parses the text of a single `cell (...) { ... }` block and extracts its
+// entry, as carved out of a library by cell_lib::ScanCellBlockOffsets.
+absl::StatusOr<CellLibraryEntryProto> ExtractCellFromText(
+    absl::string_view cell_text) {
+  XLS_ASSIGN_OR_RETURN(cell_lib::CharStream stream,
+                       cell_lib::CharStream::FromText(std::string(cell_text)));
+  cell_lib::Scanner scanner(&stream);
+  absl::flat_hash_set<std::string> kind_allowlist(
+      {"cell", "pin", "direction", "function", "ff", "next_state",
+       "statetable"});
+  cell_lib::Parser parser(&scanner, std::move(kind_allowlist));
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<cell_lib::Block> block,
+                       parser.ParseSingleBlock());
+  XLS_RET_CHECK(block->kind == kCellKind) << block->kind;
+  CellLibraryEntryProto entry_proto;
+  XLS_RETURN_IF_ERROR(ExtractFromCell(*block, &entry_proto));
+  return entry_proto;
+}
+
 }  // namespace
 
 absl::StatusOr<CellLibraryProto> ExtractFunctions(
@@ -280,7 +307,7 @@ absl::StatusOr<CellLibraryProto> ExtractFunctions(
   for (const cell_lib::BlockEntry& entry : block->entries) {
     if (absl::holds_alternative<std::unique_ptr<cell_lib::Block>>(entry)) {
       auto& block_entry = absl::get<std::unique_ptr<cell_lib::Block>>(entry);
-      if (block_entry->kind == "cell") {
+      if (block_entry->kind == kCellKind) {
         CellLibraryEntryProto* entry_proto = proto.add_entries();
         XLS_RETURN_IF_ERROR(ExtractFromCell(*block_entry.get(), entry_proto));
       }
@@ -290,6 +317,83 @@ absl::StatusOr<CellLibraryProto> ExtractFunctions(
   return proto;
 }
 
+/* static */ absl::StatusOr<LazyFunctionExtractor>
+LazyFunctionExtractor::Create(std::string lib_text) {
+  XLS_ASSIGN_OR_RETURN(auto offsets,
+                       cell_lib::ScanCellBlockOffsets(lib_text));
+  std::vector<std::string> cell_names;
+  cell_names.reserve(offsets.size());
+  for (const auto& name_and_offset : offsets) {
+    cell_names.push_back(name_and_offset.first);
+  }
+  // Present cells in file order, as ExtractFunctions() does.
+  std::sort(cell_names.begin(), cell_names.end(),
+            [&offsets](const std::string& a, const std::string& b) {
+              return offsets.at(a).start < offsets.at(b).start;
+            });
+  return LazyFunctionExtractor(std::move(lib_text), std::move(offsets),
+                               std::move(cell_names));
+}
+
+absl::StatusOr<CellLibraryEntryProto> LazyFunctionExtractor::ExtractCell(
+    absl::string_view cell_name) const {
+  auto it = offsets_.find(cell_name);
+  if (it == offsets_.end()) {
+    return absl::NotFoundError(
+        absl::StrCat("Cell not found in library: ", cell_name));
+  }
+  const cell_lib::CellBlockOffset& offset = it->second;
+  return ExtractCellFromText(absl::string_view(lib_text_).substr(
+      offset.start, offset.limit - offset.start));
+}
+
+absl::StatusOr<CellLibraryProto> LazyFunctionExtractor::ExtractAllFunctions(
+    int64_t max_parallelism) const {
+  if (max_parallelism <= 0) {
+    max_parallelism =
+        std::max<int64_t>(std::thread::hardware_concurrency(), 1);
+  }
+  const int64_t num_cells = cell_names_.size();
+  const int64_t num_threads = std::min(max_parallelism, num_cells);
+  // Each cell's entry is written to its own pre-allocated slot, so workers
+  // never touch overlapping memory.
+  std::vector<CellLibraryEntryProto> entries(num_cells);
+  auto extract_chunk = [&](int64_t thread_index) -> absl::Status {
+    for (int64_t i = thread_index; i < num_cells; i += num_threads) {
+      const cell_lib::CellBlockOffset& offset = offsets_.at(cell_names_[i]);
+      XLS_ASSIGN_OR_RETURN(
+          entries[i], ExtractCellFromText(absl::string_view(lib_text_).substr(
+                          offset.start, offset.limit - offset.start)));
+    }
+    return absl::OkStatus();
+  };
+  if (num_threads <= 1) {
+    if (num_cells > 0) {
+      XLS_RETURN_IF_ERROR(extract_chunk(0));
+    }
+  } else {
+    std::vector<absl::Status> statuses(num_threads);
+    std::vector<std::unique_ptr<Thread>> threads;
+    threads.reserve(num_threads - 1);
+    for (int64_t i = 1; i < num_threads; ++i) {
+      threads.push_back(
+          std::make_unique<Thread>([&, i] { statuses[i] = extract_chunk(i); }));
+    }
+    statuses[0] = extract_chunk(0);
+    for (std::unique_ptr<Thread>& thread : threads) {
+      thread->Join();
+    }
+    for (const absl::Status& status : statuses) {
+      XLS_RETURN_IF_ERROR(status);
+    }
+  }
+  CellLibraryProto proto;
+  for (CellLibraryEntryProto& entry : entries) {
+    *proto.add_entries() = std::move(entry);
+  }
+  return proto;
+}
+
 }  // namespace function
 }  // namespace netlist
 }  // namespace xls
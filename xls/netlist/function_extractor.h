@@ -16,8 +16,12 @@
 #define XLS_NETLIST_FUNCTION_EXTRACTOR_H_
 
 #include <string>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "xls/netlist/lib_parser.h"
 #include "xls/netlist/netlist.pb.h"
 
@@ -31,6 +35,45 @@ namespace function {
 // logical operation of the cell or pin (in the case of multiple output pins).
 absl::StatusOr<CellLibraryProto> ExtractFunctions(cell_lib::CharStream* stream);
 
+// Lazily extracts cell data from a Liberty-formatted library. Creation makes
+// a single cheap scan over the text that records the byte range of every cell
+// block (cell_lib::ScanCellBlockOffsets); a cell's block is only parsed when
+// that cell is requested. This keeps startup cost proportional to the cells a
+// netlist actually instantiates rather than to the size of the library, which
+// can run to gigabytes.
+class LazyFunctionExtractor {
+ public:
+  static absl::StatusOr<LazyFunctionExtractor> Create(std::string lib_text);
+
+  // Parses just the named cell's block and returns its extracted entry.
+  // Returns a NOT_FOUND status if the library has no such cell.
+  absl::StatusOr<CellLibraryEntryProto> ExtractCell(
+      absl::string_view cell_name) const;
+
+  // Parses every cell block and returns the full library proto, equivalent to
+  // ExtractFunctions() above. Cell blocks are independent of one another, so
+  // they are parsed with up to `max_parallelism` threads; values <= 0 use one
+  // thread per hardware thread.
+  absl::StatusOr<CellLibraryProto> ExtractAllFunctions(
+      int64_t max_parallelism = 1) const;
+
+  // Names of the cells in the library, in file order.
+  absl::Span<const std::string> cell_names() const { return cell_names_; }
+
+ private:
+  LazyFunctionExtractor(
+      std::string lib_text,
+      absl::flat_hash_map<std::string, cell_lib::CellBlockOffset> offsets,
+      std::vector<std::string> cell_names)
+      : lib_text_(std::move(lib_text)),
+        offsets_(std::move(offsets)),
+        cell_names_(std::move(cell_names)) {}
+
+  std::string lib_text_;
+  absl::flat_hash_map<std::string, cell_lib::CellBlockOffset> offsets_;
+  std::vector<std::string> cell_names_;
+};
+
 }  // namespace function
 }  // namespace netlist
 }  // namespace xls
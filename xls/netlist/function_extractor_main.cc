@@ -15,6 +15,8 @@
 // Simple driver function for FunctionExtractor; preprocesses a netlist into a
 // CellLibraryProto for colocation with the original library.
 
+#include <utility>
+
 #include "google/protobuf/text_format.h"
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
@@ -32,6 +34,10 @@ ABSL_FLAG(std::string, output_path, "",
           "Path to the file in which to write the output.");
 ABSL_FLAG(bool, output_textproto, false,
           "If true, write the output as a text-format protobuf.");
+ABSL_FLAG(int64_t, max_parallelism, 1,
+          "Maximum number of threads to use when parsing cell blocks. 1 "
+          "parses cells serially; 0 or less uses one thread per hardware "
+          "thread. Useful for large libraries.");
 
 namespace xls::netlist::function {
 
@@ -39,11 +45,12 @@ absl::Status RealMain(const std::string& cell_library_path,
                       const std::string& output_path, bool output_textproto) {
   XLS_ASSIGN_OR_RETURN(std::string cell_library_text,
                        GetFileContents(cell_library_path));
+  XLS_ASSIGN_OR_RETURN(netlist::function::LazyFunctionExtractor extractor,
+                       netlist::function::LazyFunctionExtractor::Create(
+                           std::move(cell_library_text)));
   XLS_ASSIGN_OR_RETURN(
-      auto char_stream,
-      netlist::cell_lib::CharStream::FromText(cell_library_text));
-  XLS_ASSIGN_OR_RETURN(netlist::CellLibraryProto lib_proto,
-                       netlist::function::ExtractFunctions(&char_stream));
+      netlist::CellLibraryProto lib_proto,
+      extractor.ExtractAllFunctions(absl::GetFlag(FLAGS_max_parallelism)));
 
   if (output_textproto) {
     std::string output;
@@ -17,6 +17,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
 #include "xls/common/status/matchers.h"
 #include "xls/netlist/lib_parser.h"
 #include "xls/netlist/netlist.pb.h"
@@ -162,6 +163,59 @@ library (blah) {
             STATE_TABLE_SIGNAL_NOCHANGE);
 }
 
+TEST(FunctionExtractorTest, LazyExtractionMatchesEager) {
+  std::string lib = R"(
+library (blah) {
+  blah (blah) {
+  }
+  blah: "blahblahblah";
+  cell (cell_1) {
+    pin (i0) {
+      direction: input;
+    }
+    pin (o) {
+      direction: output;
+      function: "!i0";
+    }
+  }
+  cell (cell_2) {
+    pin (i0) {
+      direction: input;
+    }
+    pin (i1) {
+      direction: input;
+    }
+    pin (o) {
+      direction: output;
+      function: "i0 * i1";
+    }
+  }
+}
+  )";
+  XLS_ASSERT_OK_AND_ASSIGN(auto stream, cell_lib::CharStream::FromText(lib));
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibraryProto eager, ExtractFunctions(&stream));
+
+  XLS_ASSERT_OK_AND_ASSIGN(LazyFunctionExtractor extractor,
+                           LazyFunctionExtractor::Create(lib));
+  ASSERT_EQ(extractor.cell_names().size(), 2);
+  EXPECT_EQ(extractor.cell_names()[0], "cell_1");
+  EXPECT_EQ(extractor.cell_names()[1], "cell_2");
+
+  // Extracting a single cell only parses that cell's block and matches the
+  // corresponding eagerly-extracted entry.
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibraryEntryProto entry,
+                           extractor.ExtractCell("cell_2"));
+  EXPECT_EQ(entry.DebugString(), eager.entries(1).DebugString());
+  EXPECT_THAT(extractor.ExtractCell("nonexistent"),
+              status_testing::StatusIs(absl::StatusCode::kNotFound));
+
+  // Bulk extraction (here with one thread per hardware thread) produces the
+  // same proto as the eager path.
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibraryProto parallel,
+                           extractor.ExtractAllFunctions(/*max_parallelism=*/0));
+  EXPECT_EQ(parallel.DebugString(), eager.DebugString());
+}
+
 }  // namespace
 }  // namespace function
 }  // namespace netlist
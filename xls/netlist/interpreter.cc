@@ -13,30 +13,94 @@
 // limitations under the License.
 #include "xls/netlist/interpreter.h"
 
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/flags/flag.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_split.h"
 #include "xls/codegen/flattening.h"
+#include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/bits_ops.h"
 #include "xls/netlist/netlist.h"
 
 namespace xls {
 namespace netlist {
+namespace {
+
+// Minimum number of cells in a topological level to warrant distributing the
+// level over worker threads; below this the cost of spawning threads
+// dominates.
+constexpr int64_t kMinCellsPerLevelForParallelism = 64;
+
+}  // namespace
+
+Interpreter::NetValueTable::NetValueTable(const rtl::Module* module) {
+  index_.reserve(module->nets().size());
+  for (const std::unique_ptr<rtl::NetDef>& net : module->nets()) {
+    index_.emplace(net.get(), index_.size());
+  }
+  values_.resize(index_.size());
+  assigned_.resize(index_.size());
+}
+
+uint64_t Interpreter::NetValueTable::Get(rtl::NetRef ref) const {
+  int64_t index = IndexOf(ref);
+  XLS_CHECK_EQ(assigned_[index], 1)
+      << "Net has no assigned value: " << ref->name();
+  return values_[index];
+}
 
-Interpreter::Interpreter(rtl::Netlist* netlist) : netlist_(netlist) {}
+Interpreter::Interpreter(rtl::Netlist* netlist, int64_t max_parallelism)
+    : netlist_(netlist),
+      max_parallelism_(max_parallelism > 0
+                           ? max_parallelism
+                           : std::thread::hardware_concurrency()) {}
 
 absl::StatusOr<absl::flat_hash_map<const rtl::NetRef, bool>>
 Interpreter::InterpretModule(
     const rtl::Module* module,
     const absl::flat_hash_map<const rtl::NetRef, bool>& inputs,
     absl::Span<const std::string> dump_cells) {
-  // Do a topological sort through all cells, evaluating each as its inputs are
-  // fully satisfied, and store those results with each output wire.
+  // Single-sample case of the batched evaluation: each net's word carries one
+  // valid bit lane.
+  absl::flat_hash_map<const rtl::NetRef, uint64_t> batched_inputs;
+  batched_inputs.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    batched_inputs[input.first] = input.second ? 1 : 0;
+  }
+  XLS_ASSIGN_OR_RETURN(auto batched_outputs,
+                       InterpretModuleBatched(module, batched_inputs,
+                                              /*num_samples=*/1, dump_cells));
+  absl::flat_hash_map<const rtl::NetRef, bool> outputs;
+  outputs.reserve(batched_outputs.size());
+  for (const auto& output : batched_outputs) {
+    outputs[output.first] = (output.second & 1) != 0;
+  }
+  return outputs;
+}
+
+absl::StatusOr<absl::flat_hash_map<const rtl::NetRef, uint64_t>>
+Interpreter::InterpretModuleBatched(
+    const rtl::Module* module,
+    const absl::flat_hash_map<const rtl::NetRef, uint64_t>& inputs,
+    int64_t num_samples, absl::Span<const std::string> dump_cells) {
+  XLS_RET_CHECK(num_samples >= 1 && num_samples <= kMaxBatchSamples)
+      << num_samples;
+  // Do a topological sort through all cells, grouping cells into "wavefront"
+  // levels whose inputs are fully satisfied by prior levels, and evaluate each
+  // level in turn (possibly across threads), storing the results with each
+  // output wire.
+  NetValueTable values(module);
 
   // The list of "unsatisfied" cells.
   absl::flat_hash_map<rtl::Cell*, absl::flat_hash_set<rtl::NetRef>> cell_inputs;
@@ -45,17 +109,15 @@ Interpreter::InterpretModule(
   // processed) but not yet processed.
   std::deque<rtl::NetRef> active_wires;
 
-  // Holds the [boolean] value of a wire that's been processed.
-  absl::flat_hash_map<const rtl::NetRef, bool> processed_wires;
+  // The cells of the current wavefront: all inputs satisfied, not yet
+  // evaluated. Cells within a level have no data dependencies on each other.
+  std::vector<rtl::Cell*> level;
 
-  // First, populate the unsatisfied cell list.
+  // First, populate the unsatisfied cell list. Cells with no inputs form the
+  // initial level.
   for (const auto& cell : module->cells()) {
-    // if a cell has no inputs, it's active, so process it now.
     if (cell->inputs().empty()) {
-      XLS_RETURN_IF_ERROR(InterpretCell(*cell, &processed_wires));
-      for (const auto& output : cell->outputs()) {
-        active_wires.push_back(output.netref);
-      }
+      level.push_back(cell.get());
     } else {
       absl::flat_hash_set<rtl::NetRef> inputs;
       for (const auto& input : cell->inputs()) {
@@ -78,51 +140,59 @@ Interpreter::InterpretModule(
   active_wires.push_back(net_1);
 
   for (const auto& input : inputs) {
-    processed_wires[input.first] = input.second;
+    values.Set(input.first, input.second);
     XLS_VLOG(2) << "Input : " << input.first->name() << " : "
-                << static_cast<int>(input.second);
+                << absl::StreamFormat("%#x", input.second);
   }
-  processed_wires[net_0] = false;
-  processed_wires[net_1] = true;
-
-  // Process all active wires : see if this wire satisfies all of a cell's
-  // inputs. If so, interpret the cell, and place its outputs on the active wire
-  // list.
-  while (!active_wires.empty()) {
-    rtl::NetRef wire = active_wires.front();
-    active_wires.pop_front();
-    XLS_VLOG(2) << "Processing wire: " << wire->name();
-
-    for (const auto& cell : wire->connected_cells()) {
-      if (IsCellOutput(*cell, wire)) {
-        continue;
+  values.Set(net_0, 0);
+  values.Set(net_1, ~uint64_t{0});
+
+  // Process the netlist level-by-level: evaluate the current level of ready
+  // cells, then drain the wires it activated to discover the next level, i.e.,
+  // the cells whose last remaining input was satisfied by this level.
+  while (!level.empty() || !active_wires.empty()) {
+    XLS_RETURN_IF_ERROR(InterpretCellLevel(level, &values, num_samples));
+    for (rtl::Cell* cell : level) {
+      for (const auto& output : cell->outputs()) {
+        active_wires.push_back(output.netref);
       }
 
-      cell_inputs[cell].erase(wire);
-      if (cell_inputs[cell].empty()) {
-        XLS_VLOG(2) << "Processing cell: " << cell->name();
-        XLS_RETURN_IF_ERROR(InterpretCell(*cell, &processed_wires));
+      if (dump_cell_set.contains(cell->name())) {
+        XLS_LOG(INFO) << "Cell " << cell->name() << " inputs:";
+        for (const auto& input : cell->inputs()) {
+          XLS_LOG(INFO) << "   " << input.netref->name() << " : "
+                        << absl::StreamFormat("%#x", values.Get(input.netref));
+        }
+
+        XLS_LOG(INFO) << "Cell " << cell->name() << " outputs:";
         for (const auto& output : cell->outputs()) {
-          active_wires.push_back(output.netref);
+          XLS_LOG(INFO) << "   " << output.netref->name() << " : "
+                        << absl::StreamFormat("%#x",
+                                              values.Get(output.netref));
         }
+      }
+    }
+    level.clear();
 
-        if (dump_cell_set.contains(cell->name())) {
-          XLS_LOG(INFO) << "Cell " << cell->name() << " inputs:";
-          for (const auto& input : cell->inputs()) {
-            XLS_LOG(INFO) << "   " << input.netref->name() << " : "
-                          << static_cast<int>(processed_wires[input.netref]);
-          }
+    while (!active_wires.empty()) {
+      rtl::NetRef wire = active_wires.front();
+      active_wires.pop_front();
+      XLS_VLOG(2) << "Processing wire: " << wire->name();
 
-          XLS_LOG(INFO) << "Cell " << cell->name() << " outputs:";
-          for (const auto& output : cell->outputs()) {
-            XLS_LOG(INFO) << "   " << output.netref->name() << " : "
-                          << static_cast<int>(processed_wires[output.netref]);
-          }
+      for (const auto& cell : wire->connected_cells()) {
+        if (IsCellOutput(*cell, wire)) {
+          continue;
         }
-      } else if (XLS_VLOG_IS_ON(2)) {
-        XLS_VLOG(2) << "Cell remaining: " << cell->name();
-        for (const auto& remaining : cell_inputs[cell]) {
-          XLS_VLOG(2) << " - " << remaining->name();
+
+        cell_inputs[cell].erase(wire);
+        if (cell_inputs[cell].empty()) {
+          XLS_VLOG(2) << "Cell ready: " << cell->name();
+          level.push_back(cell);
+        } else if (XLS_VLOG_IS_ON(2)) {
+          XLS_VLOG(2) << "Cell remaining: " << cell->name();
+          for (const auto& remaining : cell_inputs[cell]) {
+            XLS_VLOG(2) << " - " << remaining->name();
+          }
         }
       }
     }
@@ -132,7 +202,7 @@ Interpreter::InterpretModule(
   // unsatisfiable cells).
   for (const auto& cell : module->cells()) {
     for (const auto& output : cell->outputs()) {
-      if (!processed_wires.contains(output.netref)) {
+      if (!values.IsAssigned(output.netref)) {
         return absl::InvalidArgumentError(absl::StrFormat(
             "Netlist contains unconnected subgraphs and cannot be translated. "
             "Example: cell %s, output %s.",
@@ -141,18 +211,18 @@ Interpreter::InterpretModule(
     }
   }
 
-  absl::flat_hash_map<const rtl::NetRef, bool> outputs;
+  absl::flat_hash_map<const rtl::NetRef, uint64_t> outputs;
   outputs.reserve(module->outputs().size());
   for (const rtl::NetRef output : module->outputs()) {
-    if (processed_wires.contains(output)) {
-      outputs[output] = processed_wires.at(output);
+    if (values.IsAssigned(output)) {
+      outputs[output] = values.Get(output);
     } else {
       const absl::flat_hash_map<rtl::NetRef, rtl::NetRef>& assigns =
           module->assigns();
       XLS_RET_CHECK(assigns.contains(output));
       rtl::NetRef net_value = assigns.at(output);
       if (net_value == net_0 || net_value == net_1) {
-        outputs[output] = net_value == net_1;
+        outputs[output] = net_value == net_1 ? ~uint64_t{0} : 0;
       } else {
         XLS_RET_CHECK(inputs.contains(net_value));
         outputs[output] = inputs.at(net_value);
@@ -163,16 +233,61 @@ Interpreter::InterpretModule(
   return outputs;
 }
 
-absl::Status Interpreter::InterpretCell(
-    const rtl::Cell& cell,
-    absl::flat_hash_map<const rtl::NetRef, bool>* processed_wires) {
+absl::Status Interpreter::InterpretCellLevel(absl::Span<rtl::Cell* const> level,
+                                             NetValueTable* values,
+                                             int64_t num_samples) {
+  int64_t num_threads =
+      std::min(max_parallelism_,
+               static_cast<int64_t>(level.size()) /
+                   kMinCellsPerLevelForParallelism);
+  if (num_threads <= 1) {
+    for (rtl::Cell* cell : level) {
+      XLS_VLOG(2) << "Processing cell: " << cell->name();
+      XLS_RETURN_IF_ERROR(InterpretCell(*cell, values, num_samples));
+    }
+    return absl::OkStatus();
+  }
+
+  // Each cell writes only the table slots of its own output nets, so the
+  // workers share the table without synchronization.
+  std::vector<absl::Status> statuses(num_threads);
+  auto run_chunk = [&](int64_t thread_number) {
+    for (int64_t i = thread_number; i < static_cast<int64_t>(level.size());
+         i += num_threads) {
+      absl::Status status = InterpretCell(*level[i], values, num_samples);
+      if (!status.ok()) {
+        statuses[thread_number] = std::move(status);
+        return;
+      }
+    }
+  };
+  std::vector<std::unique_ptr<Thread>> threads;
+  threads.reserve(num_threads - 1);
+  for (int64_t i = 1; i < num_threads; ++i) {
+    threads.push_back(std::make_unique<Thread>([&run_chunk, i] {
+      run_chunk(i);
+    }));
+  }
+  run_chunk(0);
+  for (std::unique_ptr<Thread>& thread : threads) {
+    thread->Join();
+  }
+  for (const absl::Status& status : statuses) {
+    XLS_RETURN_IF_ERROR(status);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status Interpreter::InterpretCell(const rtl::Cell& cell,
+                                        NetValueTable* values,
+                                        int64_t num_samples) {
   const CellLibraryEntry* entry = cell.cell_library_entry();
   absl::StatusOr<const rtl::Module*> status_or_module =
       netlist_->GetModule(entry->name());
   if (status_or_module.ok()) {
     // If this "cell" is actually a module defined in the netlist,
     // then recursively evaluate it.
-    absl::flat_hash_map<const rtl::NetRef, bool> inputs;
+    absl::flat_hash_map<const rtl::NetRef, uint64_t> inputs;
     // who's input/output name - needs to be internal
     // need to map cell inputs to module inputs?
     auto module = status_or_module.value();
@@ -192,7 +307,7 @@ absl::Status Interpreter::InterpretCell(
       bool input_found = false;
       for (int i = 0; i < module_input_names.size(); i++) {
         if (module_input_names[i] == input.name) {
-          inputs[module_input_refs[i]] = processed_wires->at(input.netref);
+          inputs[module_input_refs[i]] = values->Get(input.netref);
           input_found = true;
           break;
         }
@@ -204,16 +319,16 @@ absl::Status Interpreter::InterpretCell(
           input.name, module->name(), cell.name());
     }
 
-    using ChildOutputsT = absl::flat_hash_map<const rtl::NetRef, bool>;
+    using ChildOutputsT = absl::flat_hash_map<const rtl::NetRef, uint64_t>;
     XLS_ASSIGN_OR_RETURN(ChildOutputsT child_outputs,
-                         InterpretModule(module, inputs));
+                         InterpretModuleBatched(module, inputs, num_samples));
     // We need to do the same here - map the NetRefs in the module's output
     // to the NetRefs in this module, using pin names as the matching keys.
     for (const auto& child_output : child_outputs) {
       bool output_found = false;
       for (const auto& cell_output : cell.outputs()) {
         if (child_output.first->name() == cell_output.name) {
-          (*processed_wires)[cell_output.netref] = child_output.second;
+          values->Set(cell_output.netref, child_output.second);
           output_found = true;
           break;
         }
@@ -228,101 +343,113 @@ absl::Status Interpreter::InterpretCell(
     return absl::OkStatus();
   }
 
-  const auto& pins = entry->output_pin_to_function();
   for (int i = 0; i < cell.outputs().size(); i++) {
     XLS_ASSIGN_OR_RETURN(
-        function::Ast ast,
-        function::Parser::ParseFunction(pins.at(cell.outputs()[i].name)));
-    XLS_ASSIGN_OR_RETURN(bool result,
-                         InterpretFunction(cell, ast, *processed_wires));
-    (*processed_wires)[cell.outputs()[i].netref] = result;
+        const function::CompiledFunction* function,
+        entry->GetCompiledFunction(cell.outputs()[i].name));
+    XLS_ASSIGN_OR_RETURN(
+        uint64_t result, InterpretFunction(cell, *function, *values,
+                                           num_samples));
+    values->Set(cell.outputs()[i].netref, result);
   }
 
   return absl::OkStatus();
 }
 
-absl::StatusOr<bool> Interpreter::InterpretFunction(
-    const rtl::Cell& cell, const function::Ast& ast,
-    const absl::flat_hash_map<const rtl::NetRef, bool>& processed_wires) {
-  switch (ast.kind()) {
-    case function::Ast::Kind::kAnd: {
-      XLS_ASSIGN_OR_RETURN(bool lhs, InterpretFunction(cell, ast.children()[0],
-                                                       processed_wires));
-      XLS_ASSIGN_OR_RETURN(bool rhs, InterpretFunction(cell, ast.children()[1],
-                                                       processed_wires));
-      return lhs & rhs;
-    }
-    case function::Ast::Kind::kIdentifier: {
-      rtl::NetRef ref = nullptr;
-      for (const auto& input : cell.inputs()) {
-        if (input.name == ast.name()) {
-          ref = input.netref;
+absl::StatusOr<uint64_t> Interpreter::InterpretFunction(
+    const rtl::Cell& cell, const function::CompiledFunction& function,
+    const NetValueTable& values, int64_t num_samples) {
+  // Words carry one bit lane per sample, so the bitwise operators below
+  // evaluate every sample of the batch at once. The compiled function's
+  // gates are in dependency order, so one forward pass suffices.
+  using Gate = function::CompiledFunction::Gate;
+  using GateKind = function::CompiledFunction::GateKind;
+  std::vector<uint64_t> gate_values(function.gates().size());
+  for (int64_t i = 0; i < static_cast<int64_t>(function.gates().size()); ++i) {
+    const Gate& gate = function.gates()[i];
+    switch (gate.kind) {
+      case GateKind::kInput: {
+        rtl::NetRef ref = nullptr;
+        for (const auto& input : cell.inputs()) {
+          if (input.name == gate.name) {
+            ref = input.netref;
+          }
         }
-      }
 
-      if (ref == nullptr) {
-        for (const auto& internal : cell.internal_pins()) {
-          if (internal.name == ast.name()) {
-            return InterpretStateTable(cell, internal.name, processed_wires);
+        if (ref == nullptr) {
+          bool is_internal = false;
+          for (const auto& internal : cell.internal_pins()) {
+            if (internal.name == gate.name) {
+              XLS_ASSIGN_OR_RETURN(
+                  gate_values[i],
+                  InterpretStateTable(cell, internal.name, values,
+                                      num_samples));
+              is_internal = true;
+              break;
+            }
           }
+          if (!is_internal) {
+            return absl::NotFoundError(
+                absl::StrFormat("Identifier \"%s\" not found in cell %s's "
+                                "inputs or internal signals.",
+                                gate.name, cell.name()));
+          }
+          break;
         }
-      }
 
-      if (ref == nullptr) {
-        return absl::NotFoundError(
-            absl::StrFormat("Identifier \"%s\" not found in cell %s's inputs "
-                            "or internal signals.",
-                            ast.name(), cell.name()));
+        gate_values[i] = values.Get(ref);
+        break;
       }
-
-      return processed_wires.at(ref);
-    }
-    case function::Ast::Kind::kLiteralOne:
-      return 1;
-    case function::Ast::Kind::kLiteralZero:
-      return 0;
-    case function::Ast::Kind::kNot: {
-      XLS_ASSIGN_OR_RETURN(
-          bool value,
-          InterpretFunction(cell, ast.children()[0], processed_wires));
-      return !value;
+      case GateKind::kLiteralOne:
+        gate_values[i] = ~uint64_t{0};
+        break;
+      case GateKind::kLiteralZero:
+        gate_values[i] = uint64_t{0};
+        break;
+      case GateKind::kNot:
+        gate_values[i] = ~gate_values[gate.operand0];
+        break;
+      case GateKind::kAnd:
+        gate_values[i] = gate_values[gate.operand0] &
+                         gate_values[gate.operand1];
+        break;
+      case GateKind::kOr:
+        gate_values[i] = gate_values[gate.operand0] |
+                         gate_values[gate.operand1];
+        break;
+      case GateKind::kXor:
+        gate_values[i] = gate_values[gate.operand0] ^
+                         gate_values[gate.operand1];
+        break;
     }
-    case function::Ast::Kind::kOr: {
-      XLS_ASSIGN_OR_RETURN(bool lhs, InterpretFunction(cell, ast.children()[0],
-                                                       processed_wires));
-      XLS_ASSIGN_OR_RETURN(bool rhs, InterpretFunction(cell, ast.children()[1],
-                                                       processed_wires));
-      return lhs | rhs;
-    }
-    case function::Ast::Kind::kXor: {
-      XLS_ASSIGN_OR_RETURN(bool lhs, InterpretFunction(cell, ast.children()[0],
-                                                       processed_wires));
-      XLS_ASSIGN_OR_RETURN(bool rhs, InterpretFunction(cell, ast.children()[1],
-                                                       processed_wires));
-      return lhs ^ rhs;
-    }
-    default:
-      return absl::InvalidArgumentError(
-          absl::StrCat("Unknown AST element type: ", ast.kind()));
   }
+  return gate_values[function.output()];
 }
 
-absl::StatusOr<bool> Interpreter::InterpretStateTable(
+absl::StatusOr<uint64_t> Interpreter::InterpretStateTable(
     const rtl::Cell& cell, const std::string& pin_name,
-    const absl::flat_hash_map<const rtl::NetRef, bool>& processed_wires) {
+    const NetValueTable& values, int64_t num_samples) {
   XLS_RET_CHECK(cell.cell_library_entry()->state_table());
   const StateTable& state_table =
       cell.cell_library_entry()->state_table().value();
 
-  StateTable::InputStimulus stimulus;
-  for (const auto& input : cell.inputs()) {
-    stimulus[input.name] = processed_wires.at(input.netref);
-  }
-
   for (const auto& pin : cell.internal_pins()) {
-    if (pin.name == pin_name) {
-      return state_table.GetSignalValue(stimulus, pin.name);
+    if (pin.name != pin_name) {
+      continue;
+    }
+    // State table rows are matched per sample, so each bit lane is evaluated
+    // separately.
+    uint64_t result = 0;
+    for (int64_t sample = 0; sample < num_samples; ++sample) {
+      StateTable::InputStimulus stimulus;
+      for (const auto& input : cell.inputs()) {
+        stimulus[input.name] = ((values.Get(input.netref) >> sample) & 1) != 0;
+      }
+      XLS_ASSIGN_OR_RETURN(bool value,
+                           state_table.GetSignalValue(stimulus, pin.name));
+      result |= static_cast<uint64_t>(value) << sample;
     }
+    return result;
   }
 
   return absl::NotFoundError(
@@ -14,15 +14,15 @@
 #ifndef XLS_NETLIST_INTERPRETER_H_
 #define XLS_NETLIST_INTERPRETER_H_
 
-#include <deque>
 #include <string>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "xls/ir/type.h"
 #include "xls/ir/value.h"
-#include "xls/netlist/function_parser.h"
+#include "xls/netlist/cell_function.h"
 #include "xls/netlist/netlist.h"
 
 namespace xls {
@@ -32,7 +32,16 @@ namespace netlist {
 // resulting value.
 class Interpreter {
  public:
-  explicit Interpreter(rtl::Netlist* netlist);
+  // `max_parallelism` bounds the number of threads used to evaluate cells
+  // within a topological level ("wavefront") of a module. A value of 1 (the
+  // default) evaluates cells serially; a value of 0 or less uses one thread
+  // per hardware thread. Parallel evaluation produces identical results as
+  // cells within a level have no data dependencies on each other.
+  explicit Interpreter(rtl::Netlist* netlist, int64_t max_parallelism = 1);
+
+  // Maximum number of independent samples evaluated by one batched
+  // interpretation: one bit lane per sample in a machine word.
+  static constexpr int64_t kMaxBatchSamples = 64;
 
   // Interprets the given module with the given input mapping.
   //  - inputs: Mapping of module input wire to value. Must have the same size
@@ -44,25 +53,84 @@ class Interpreter {
       const absl::flat_hash_map<const rtl::NetRef, bool>& inputs,
       absl::Span<const std::string> dump_cells = {});
 
+  // Bit-parallel variant of InterpretModule(): evaluates up to
+  // kMaxBatchSamples independent input samples in a single pass over the
+  // netlist. Bit i of each input (and output) word holds the net's value in
+  // sample i, and cell boolean functions are evaluated with word-wide
+  // AND/OR/XOR, so a full batch costs roughly the same as interpreting one
+  // sample. Cells defined by a state table fall back to per-sample
+  // evaluation.
+  //  - num_samples: Number of valid bit lanes in each input word, in
+  //    [1, kMaxBatchSamples]. Lanes at or above num_samples are undefined in
+  //    the returned words.
+  absl::StatusOr<absl::flat_hash_map<const rtl::NetRef, uint64_t>>
+  InterpretModuleBatched(
+      const rtl::Module* module,
+      const absl::flat_hash_map<const rtl::NetRef, uint64_t>& inputs,
+      int64_t num_samples,
+      absl::Span<const std::string> dump_cells = {});
+
  private:
+  // Flat, densely indexed storage for the value of each net in a module; one
+  // word per net with one bit lane per sample. Values live in a flat array
+  // indexed by the net's position in Module::nets() rather than in a hash map
+  // keyed by NetRef. Slots for distinct nets are distinct memory locations,
+  // so the cells of a wavefront may write their (distinct) output nets
+  // concurrently without synchronization.
+  class NetValueTable {
+   public:
+    explicit NetValueTable(const rtl::Module* module);
+
+    void Set(rtl::NetRef ref, uint64_t value) {
+      int64_t index = IndexOf(ref);
+      values_[index] = value;
+      assigned_[index] = 1;
+    }
+
+    // The value of the given net. The net must have been assigned a value.
+    uint64_t Get(rtl::NetRef ref) const;
+
+    bool IsAssigned(rtl::NetRef ref) const {
+      return assigned_[IndexOf(ref)] == 1;
+    }
+
+   private:
+    int64_t IndexOf(rtl::NetRef ref) const { return index_.at(ref); }
+
+    // Maps each net of the module to its slot in `values_`/`assigned_`.
+    absl::flat_hash_map<rtl::NetRef, int64_t> index_;
+    std::vector<uint64_t> values_;
+    std::vector<uint8_t> assigned_;
+  };
+
   // Returns true if the specified NetRef is an output of the given cell.
   bool IsCellOutput(const rtl::Cell& cell, const rtl::NetRef ref);
 
-  absl::Status InterpretCell(
-      const rtl::Cell& cell,
-      absl::flat_hash_map<const rtl::NetRef, bool>* processed_wires);
+  absl::Status InterpretCell(const rtl::Cell& cell, NetValueTable* values,
+                             int64_t num_samples);
+
+  absl::StatusOr<uint64_t> InterpretFunction(
+      const rtl::Cell& cell, const function::CompiledFunction& function,
+      const NetValueTable& values, int64_t num_samples);
 
-  absl::StatusOr<bool> InterpretFunction(
-      const rtl::Cell& cell, const function::Ast& ast,
-      const absl::flat_hash_map<const rtl::NetRef, bool>& processed_wires);
+  // Evaluates the given cells - one topological level of a module, with no
+  // data dependencies between them - writing their outputs into `values`.
+  // Cells are distributed over worker threads when parallelism is enabled and
+  // the level is large enough to cover the cost of spawning threads.
+  absl::Status InterpretCellLevel(absl::Span<rtl::Cell* const> level,
+                                  NetValueTable* values, int64_t num_samples);
 
   // Returns the value of the internal/output pin from the cell (defined by a
-  // "statetable" attribute under the conditions defined in "processed_wires".
-  absl::StatusOr<bool> InterpretStateTable(
-      const rtl::Cell& cell, const std::string& pin_name,
-      const absl::flat_hash_map<const rtl::NetRef, bool>& processed_wires);
+  // "statetable" attribute under the conditions defined in "values". State
+  // tables match rows sample-by-sample, so each of the num_samples bit lanes
+  // is evaluated separately.
+  absl::StatusOr<uint64_t> InterpretStateTable(const rtl::Cell& cell,
+                                               const std::string& pin_name,
+                                               const NetValueTable& values,
+                                               int64_t num_samples);
 
   rtl::Netlist* netlist_;
+  int64_t max_parallelism_;
 };
 
 }  // namespace netlist
@@ -15,7 +15,9 @@
 #include "xls/netlist/lib_parser.h"
 
 #include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/str_join.h"
+#include "absl/strings/strip.h"
 #include "xls/common/logging/logging.h"
 
 namespace xls {
@@ -373,6 +375,104 @@ absl::StatusOr<std::unique_ptr<Block>> Parser::ParseBlock(
   return block;
 }
 
+absl::StatusOr<absl::flat_hash_map<std::string, CellBlockOffset>>
+ScanCellBlockOffsets(absl::string_view text) {
+  constexpr absl::string_view kCellKeyword = "cell";
+  auto is_identifier_char = [](char c) {
+    return absl::ascii_isalnum(c) != 0 || c == '_';
+  };
+  absl::flat_hash_map<std::string, CellBlockOffset> result;
+  // Name and start offset of the cell block whose closing curly we're looking
+  // for, if any. A cell block sits directly inside the library block, so its
+  // closing curly is the one that brings the depth back down to one.
+  absl::optional<std::pair<std::string, int64_t>> pending;
+  int64_t depth = 0;
+  const int64_t size = text.size();
+  int64_t i = 0;
+  while (i < size) {
+    char c = text[i];
+    if (c == '/' && i + 1 < size && text[i + 1] == '/') {
+      absl::string_view::size_type eol = text.find('\n', i + 2);
+      i = eol == absl::string_view::npos ? size : static_cast<int64_t>(eol) + 1;
+      continue;
+    }
+    if (c == '/' && i + 1 < size && text[i + 1] == '*') {
+      absl::string_view::size_type end = text.find("*/", i + 2);
+      if (end == absl::string_view::npos) {
+        return absl::InvalidArgumentError(
+            "Unterminated block comment in library file.");
+      }
+      i = static_cast<int64_t>(end) + 2;
+      continue;
+    }
+    if (c == '"') {
+      absl::string_view::size_type close = text.find('"', i + 1);
+      if (close == absl::string_view::npos) {
+        return absl::InvalidArgumentError(
+            "Unterminated string in library file.");
+      }
+      i = static_cast<int64_t>(close) + 1;
+      continue;
+    }
+    if (c == '{') {
+      ++depth;
+      ++i;
+      continue;
+    }
+    if (c == '}') {
+      --depth;
+      if (depth == 1 && pending.has_value()) {
+        result.insert({std::move(pending->first),
+                       CellBlockOffset{pending->second, i + 1}});
+        pending.reset();
+      }
+      ++i;
+      continue;
+    }
+    int64_t after_keyword = i + static_cast<int64_t>(kCellKeyword.size());
+    if (depth == 1 && !pending.has_value() && c == kCellKeyword[0] &&
+        (i == 0 || !is_identifier_char(text[i - 1])) &&
+        text.substr(i, kCellKeyword.size()) == kCellKeyword &&
+        (after_keyword == size || !is_identifier_char(text[after_keyword]))) {
+      int64_t j = after_keyword;
+      while (j < size && absl::ascii_isspace(text[j]) != 0) {
+        ++j;
+      }
+      if (j < size && text[j] == '(') {
+        absl::string_view::size_type close_paren = text.find(')', j + 1);
+        if (close_paren == absl::string_view::npos) {
+          return absl::InvalidArgumentError(
+              "Unterminated cell arguments in library file.");
+        }
+        absl::string_view name = absl::StripAsciiWhitespace(
+            text.substr(j + 1, static_cast<int64_t>(close_paren) - j - 1));
+        absl::ConsumePrefix(&name, "\"");
+        absl::ConsumeSuffix(&name, "\"");
+        int64_t after_args = static_cast<int64_t>(close_paren) + 1;
+        int64_t k = after_args;
+        while (k < size && absl::ascii_isspace(text[k]) != 0) {
+          ++k;
+        }
+        // A semicolon here means `cell` was used as a group-less statement
+        // rather than opening a block; nothing to record.
+        if (k >= size || text[k] != ';') {
+          pending.emplace(std::string(name), i);
+        }
+        i = after_args;
+        continue;
+      }
+      i = j;
+      continue;
+    }
+    ++i;
+  }
+  if (pending.has_value()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unterminated cell block: ", pending->first));
+  }
+  return result;
+}
+
 }  // namespace cell_lib
 }  // namespace netlist
 }  // namespace xls
@@ -23,6 +23,7 @@
 #include <fstream>
 #include <string>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -370,6 +371,15 @@ class Parser {
     return ParseBlock("library");
   }
 
+  // Parses a single block of any kind instead of a whole library; e.g. one
+  // `cell (...) { ... }` group carved out of a larger file (see
+  // ScanCellBlockOffsets below). The token stream should be positioned at the
+  // block's kind identifier.
+  absl::StatusOr<std::unique_ptr<Block>> ParseSingleBlock() {
+    XLS_ASSIGN_OR_RETURN(std::string identifier, PopIdentifierOrError());
+    return ParseBlock(std::move(identifier));
+  }
+
  private:
   absl::StatusOr<bool> TryDropToken(TokenKind target, Pos* pos = nullptr);
   absl::Status DropTokenOrError(TokenKind kind);
@@ -411,6 +421,23 @@ class Parser {
   absl::optional<absl::flat_hash_set<std::string>> kind_allowlist_;
 };
 
+// Byte range of one `cell (<name>) { ... }` block within a library file:
+// [start, limit) brackets the block from the `cell` keyword through its
+// closing curly.
+struct CellBlockOffset {
+  int64_t start;
+  int64_t limit;
+};
+
+// Scans the text of a library file and records the byte range of every
+// top-level cell block, keyed by cell name. This is a single pass over the raw
+// characters -- no tokens or AST nodes are materialized -- so it is cheap even
+// for multi-gigabyte libraries; the recorded ranges let callers parse
+// individual cells on demand or in parallel instead of parsing the whole
+// library eagerly.
+absl::StatusOr<absl::flat_hash_map<std::string, CellBlockOffset>>
+ScanCellBlockOffsets(absl::string_view text);
+
 }  // namespace cell_lib
 }  // namespace netlist
 }  // namespace xls
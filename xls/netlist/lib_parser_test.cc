@@ -159,6 +159,50 @@ library (foo) {
             "))");
 }
 
+TEST(LibParserTest, ScanCellBlockOffsets) {
+  std::string text = R"(/* header comment with cell (bogus) { } inside */
+library (foo) {
+  operating_conditions (typical) {
+    process: 1;
+  }
+  default_cell_leakage_power: 0.0;
+  cell (AND2) {
+    pin (a);
+    pin (b);
+    pin (o) {
+      direction: output;
+      function: "a * b";  // comment with } brace
+    }
+  }
+  cell (INV) {
+    pin (a);
+    pin (o) {
+      direction: output;
+      function: "!a";
+    }
+  }
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto offsets, ScanCellBlockOffsets(text));
+  ASSERT_EQ(offsets.size(), 2);
+  ASSERT_TRUE(offsets.contains("AND2"));
+  ASSERT_TRUE(offsets.contains("INV"));
+  for (const auto& name_and_offset : offsets) {
+    const CellBlockOffset& offset = name_and_offset.second;
+    // Each recorded range should carve out exactly the cell's block, which
+    // then parses on its own.
+    absl::string_view block = absl::string_view(text).substr(
+        offset.start, offset.limit - offset.start);
+    XLS_ASSERT_OK_AND_ASSIGN(auto cs, CharStream::FromText(std::string(block)));
+    Scanner scanner(&cs);
+    Parser parser(&scanner);
+    XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Block> parsed,
+                             parser.ParseSingleBlock());
+    EXPECT_EQ(parsed->kind, "cell");
+    EXPECT_EQ(parsed->args[0], name_and_offset.first);
+  }
+}
+
 }  // namespace
 }  // namespace cell_lib
 }  // namespace netlist
@@ -132,6 +132,15 @@ enum class NetDeclKind {
 // Represents the module containing the netlist info.
 class Module {
  public:
+  // A port in the module parameter list. See DeclarePortsOrder/DeclarePort.
+  struct Port {
+    explicit Port(std::string name) : name_(name) {}
+    std::string name_;
+    int64_t width_ = 1;
+    bool is_output_ = false;
+    bool is_declared_ = false;
+  };
+
   explicit Module(absl::string_view name) : name_(name) {
     // Zero and one values are present in netlists as cell inputs (which we
     // interpret as wires), but aren't explicitly declared, so we create them as
@@ -246,15 +255,10 @@ class Module {
   // DeclarePortsOrder() needs to have been called previously.
   int64_t GetInputPortOffset(absl::string_view name) const;
 
- private:
-  struct Port {
-    explicit Port(std::string name) : name_(name) {}
-    std::string name_;
-    int64_t width_ = 1;
-    bool is_output_ = false;
-    bool is_declared_ = false;
-  };
+  // The ports declared via DeclarePortsOrder, in module-parameter-list order.
+  absl::Span<const std::unique_ptr<Port>> ports() const { return ports_; }
 
+ private:
   std::string name_;
   std::vector<std::unique_ptr<Port>> ports_;
   std::vector<NetRef> inputs_;
@@ -275,7 +279,9 @@ class Netlist {
  public:
   void AddModule(std::unique_ptr<Module> module);
   absl::StatusOr<const Module*> GetModule(const std::string& module_name) const;
-  const absl::Span<const std::unique_ptr<Module>> modules() { return modules_; }
+  const absl::Span<const std::unique_ptr<Module>> modules() const {
+    return modules_;
+  }
   absl::StatusOr<const CellLibraryEntry*> GetOrCreateLut4CellEntry(
       int64_t lut_mask);
 
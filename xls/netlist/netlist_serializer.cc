@@ -0,0 +1,326 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/netlist/netlist_serializer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/strip.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+
+namespace xls {
+namespace netlist {
+namespace rtl {
+namespace {
+
+NetDeclKindProto NetDeclKindToProto(NetDeclKind kind) {
+  switch (kind) {
+    case NetDeclKind::kInput:
+      return NET_DECL_KIND_INPUT;
+    case NetDeclKind::kOutput:
+      return NET_DECL_KIND_OUTPUT;
+    case NetDeclKind::kWire:
+      return NET_DECL_KIND_WIRE;
+  }
+  return NET_DECL_KIND_INVALID;
+}
+
+absl::StatusOr<NetDeclKind> NetDeclKindFromProto(NetDeclKindProto kind) {
+  switch (kind) {
+    case NET_DECL_KIND_INPUT:
+      return NetDeclKind::kInput;
+    case NET_DECL_KIND_OUTPUT:
+      return NetDeclKind::kOutput;
+    case NET_DECL_KIND_WIRE:
+      return NetDeclKind::kWire;
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Invalid net decl kind: %d", kind));
+  }
+}
+
+// Resolves the cell library entry the given cell proto instantiates: a cell
+// library entry, a LUT4 entry (named "<lut_0xNNNN>"), or a previously
+// deserialized module of the netlist.
+absl::StatusOr<const CellLibraryEntry*> ResolveEntry(
+    const CellInstanceProto& cell_proto, CellLibrary* cell_library,
+    Netlist* netlist) {
+  const std::string& entry_name = cell_proto.cell_library_entry();
+  absl::StatusOr<const CellLibraryEntry*> library_entry =
+      cell_library->GetEntry(entry_name);
+  if (library_entry.ok()) {
+    return library_entry.value();
+  }
+  absl::string_view lut_mask_str = entry_name;
+  if (absl::ConsumePrefix(&lut_mask_str, "<lut_0x") &&
+      absl::ConsumeSuffix(&lut_mask_str, ">")) {
+    int64_t lut_mask;
+    XLS_RET_CHECK(absl::SimpleHexAtoi(lut_mask_str, &lut_mask))
+        << "Malformed LUT cell entry name: " << entry_name;
+    return netlist->GetOrCreateLut4CellEntry(lut_mask);
+  }
+  absl::StatusOr<const Module*> entry_module = netlist->GetModule(entry_name);
+  if (entry_module.ok()) {
+    return entry_module.value()->AsCellLibraryEntry();
+  }
+  return absl::NotFoundError(absl::StrFormat(
+      "Cell \"%s\" instantiates \"%s\" which is neither a cell library entry "
+      "nor a preceding module of the netlist.",
+      cell_proto.name(), entry_name));
+}
+
+}  // namespace
+
+absl::StatusOr<NetlistProto> NetlistToProto(const Netlist& netlist) {
+  NetlistProto proto;
+  for (const std::unique_ptr<Module>& module : netlist.modules()) {
+    (*proto.mutable_module_index())[module->name()] = proto.modules_size();
+    NetlistModuleProto* module_proto = proto.add_modules();
+    module_proto->set_name(module->name());
+
+    for (const std::unique_ptr<Module::Port>& port : module->ports()) {
+      ModulePortProto* port_proto = module_proto->add_ports();
+      port_proto->set_name(port->name_);
+      port_proto->set_width(port->width_);
+      port_proto->set_is_output(port->is_output_);
+      port_proto->set_is_declared(port->is_declared_);
+    }
+
+    absl::flat_hash_set<NetRef> input_nets(module->inputs().begin(),
+                                           module->inputs().end());
+    absl::flat_hash_set<NetRef> output_nets(module->outputs().begin(),
+                                            module->outputs().end());
+    absl::flat_hash_map<NetRef, int64_t> net_index;
+    net_index.reserve(module->nets().size());
+    for (const std::unique_ptr<NetDef>& net : module->nets()) {
+      (*module_proto->mutable_net_index())[net->name()] =
+          module_proto->nets_size();
+      net_index[net.get()] = module_proto->nets_size();
+      NetDefProto* net_proto = module_proto->add_nets();
+      net_proto->set_name(net->name());
+      NetDeclKind kind = NetDeclKind::kWire;
+      if (input_nets.contains(net.get())) {
+        kind = NetDeclKind::kInput;
+      } else if (output_nets.contains(net.get())) {
+        kind = NetDeclKind::kOutput;
+      }
+      net_proto->set_kind(NetDeclKindToProto(kind));
+    }
+
+    for (const std::unique_ptr<Cell>& cell : module->cells()) {
+      (*module_proto->mutable_cell_index())[cell->name()] =
+          module_proto->cells_size();
+      CellInstanceProto* cell_proto = module_proto->add_cells();
+      cell_proto->set_name(cell->name());
+      cell_proto->set_cell_library_entry(cell->cell_library_entry()->name());
+      for (const Cell::Pin& pin : cell->inputs()) {
+        CellPinConnectionProto* pin_proto = cell_proto->add_inputs();
+        pin_proto->set_pin_name(pin.name);
+        pin_proto->set_net_index(net_index.at(pin.netref));
+      }
+      for (const Cell::Pin& pin : cell->outputs()) {
+        CellPinConnectionProto* pin_proto = cell_proto->add_outputs();
+        pin_proto->set_pin_name(pin.name);
+        pin_proto->set_net_index(net_index.at(pin.netref));
+      }
+      if (cell->clock().has_value()) {
+        cell_proto->set_clock_net_index(net_index.at(cell->clock().value()));
+      }
+    }
+
+    // Emit assigns sorted by net index for deterministic output.
+    std::vector<std::pair<int64_t, int64_t>> assigns;
+    assigns.reserve(module->assigns().size());
+    for (const auto& assign : module->assigns()) {
+      assigns.push_back(
+          {net_index.at(assign.first), net_index.at(assign.second)});
+    }
+    std::sort(assigns.begin(), assigns.end());
+    for (const auto& assign : assigns) {
+      NetlistModuleProto::AssignProto* assign_proto =
+          module_proto->add_assigns();
+      assign_proto->set_lhs_net_index(assign.first);
+      assign_proto->set_rhs_net_index(assign.second);
+    }
+  }
+  return proto;
+}
+
+absl::StatusOr<std::string> SerializeNetlist(const Netlist& netlist) {
+  XLS_ASSIGN_OR_RETURN(NetlistProto proto, NetlistToProto(netlist));
+  return proto.SerializeAsString();
+}
+
+absl::StatusOr<std::unique_ptr<Netlist>> NetlistFromProto(
+    const NetlistProto& proto, CellLibrary* cell_library) {
+  auto netlist = std::make_unique<Netlist>();
+  for (const NetlistModuleProto& module_proto : proto.modules()) {
+    auto module = std::make_unique<Module>(module_proto.name());
+
+    if (!module_proto.ports().empty()) {
+      std::vector<std::string> port_names;
+      port_names.reserve(module_proto.ports_size());
+      for (const ModulePortProto& port_proto : module_proto.ports()) {
+        port_names.push_back(port_proto.name());
+      }
+      module->DeclarePortsOrder(port_names);
+      for (const ModulePortProto& port_proto : module_proto.ports()) {
+        if (port_proto.is_declared()) {
+          XLS_RETURN_IF_ERROR(module->DeclarePort(
+              port_proto.name(), port_proto.width(), port_proto.is_output()));
+        }
+      }
+    }
+
+    // Nets, including the constant/dummy nets created implicitly by the
+    // Module constructor; `nets` maps the serialized net index to NetRef.
+    std::vector<NetRef> nets;
+    nets.reserve(module_proto.nets_size());
+    for (const NetDefProto& net_proto : module_proto.nets()) {
+      absl::StatusOr<NetRef> existing = module->ResolveNet(net_proto.name());
+      if (existing.ok()) {
+        nets.push_back(existing.value());
+        continue;
+      }
+      XLS_ASSIGN_OR_RETURN(NetDeclKind kind,
+                           NetDeclKindFromProto(net_proto.kind()));
+      XLS_RETURN_IF_ERROR(module->AddNetDecl(kind, net_proto.name()));
+      XLS_ASSIGN_OR_RETURN(NetRef net, module->ResolveNet(net_proto.name()));
+      nets.push_back(net);
+    }
+    auto net_at = [&](int64_t index) -> absl::StatusOr<NetRef> {
+      XLS_RET_CHECK(0 <= index && index < static_cast<int64_t>(nets.size()))
+          << "Net index out of range: " << index;
+      return nets[index];
+    };
+
+    for (const CellInstanceProto& cell_proto : module_proto.cells()) {
+      XLS_ASSIGN_OR_RETURN(
+          const CellLibraryEntry* entry,
+          ResolveEntry(cell_proto, cell_library, netlist.get()));
+      absl::flat_hash_map<std::string, NetRef> named_parameter_assignments;
+      for (const CellPinConnectionProto& pin_proto : cell_proto.inputs()) {
+        XLS_ASSIGN_OR_RETURN(NetRef net, net_at(pin_proto.net_index()));
+        named_parameter_assignments[pin_proto.pin_name()] = net;
+      }
+      for (const CellPinConnectionProto& pin_proto : cell_proto.outputs()) {
+        XLS_ASSIGN_OR_RETURN(NetRef net, net_at(pin_proto.net_index()));
+        named_parameter_assignments[pin_proto.pin_name()] = net;
+      }
+      absl::optional<NetRef> clock;
+      if (cell_proto.has_clock_net_index()) {
+        XLS_ASSIGN_OR_RETURN(NetRef clock_net,
+                             net_at(cell_proto.clock_net_index()));
+        clock = clock_net;
+      }
+      XLS_ASSIGN_OR_RETURN(
+          Cell cell,
+          Cell::Create(entry, cell_proto.name(), named_parameter_assignments,
+                       clock, module->GetDummyRef()));
+      XLS_ASSIGN_OR_RETURN(Cell * cell_ptr, module->AddCell(std::move(cell)));
+      // As when parsing, note each distinct connected net on the cell. The
+      // dummy net (absorbing unused cell outputs) is not considered
+      // connected.
+      absl::flat_hash_set<NetRef> connected_nets;
+      for (const auto& assignment : named_parameter_assignments) {
+        if (assignment.second == module->GetDummyRef() ||
+            (clock.has_value() && assignment.second == clock.value()) ||
+            connected_nets.contains(assignment.second)) {
+          continue;
+        }
+        assignment.second->NoteConnectedCell(cell_ptr);
+        connected_nets.insert(assignment.second);
+      }
+    }
+
+    for (const NetlistModuleProto::AssignProto& assign_proto :
+         module_proto.assigns()) {
+      XLS_ASSIGN_OR_RETURN(NetRef lhs, net_at(assign_proto.lhs_net_index()));
+      XLS_ASSIGN_OR_RETURN(NetRef rhs, net_at(assign_proto.rhs_net_index()));
+      XLS_RETURN_IF_ERROR(module->AddAssignDecl(lhs->name(), rhs->name()));
+    }
+
+    netlist->AddModule(std::move(module));
+  }
+  return netlist;
+}
+
+absl::StatusOr<std::unique_ptr<Netlist>> DeserializeNetlist(
+    absl::string_view data, CellLibrary* cell_library) {
+  NetlistProto proto;
+  if (!proto.ParseFromArray(data.data(), data.size())) {
+    return absl::InvalidArgumentError(
+        "Failed to parse serialized netlist proto.");
+  }
+  return NetlistFromProto(proto, cell_library);
+}
+
+absl::Status SaveNetlistToFile(const Netlist& netlist,
+                               absl::string_view path) {
+  XLS_ASSIGN_OR_RETURN(std::string serialized, SerializeNetlist(netlist));
+  return SetFileContents(path, serialized);
+}
+
+absl::StatusOr<std::unique_ptr<Netlist>> LoadNetlistFromFile(
+    absl::string_view path, CellLibrary* cell_library) {
+  std::string path_str(path);
+  int fd = open(path_str.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return absl::UnavailableError(absl::StrFormat(
+        "Unable to open serialized netlist %s: %s", path, strerror(errno)));
+  }
+  struct stat statbuf;
+  if (fstat(fd, &statbuf) != 0) {
+    close(fd);
+    return absl::UnavailableError(absl::StrFormat(
+        "Unable to stat serialized netlist %s: %s", path, strerror(errno)));
+  }
+  if (statbuf.st_size == 0) {
+    close(fd);
+    return DeserializeNetlist("", cell_library);
+  }
+  void* data =
+      mmap(nullptr, statbuf.st_size, PROT_READ, MAP_PRIVATE, fd, /*offset=*/0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return absl::UnavailableError(absl::StrFormat(
+        "Unable to mmap serialized netlist %s: %s", path, strerror(errno)));
+  }
+  absl::StatusOr<std::unique_ptr<Netlist>> netlist = DeserializeNetlist(
+      absl::string_view(static_cast<const char*>(data), statbuf.st_size),
+      cell_library);
+  munmap(data, statbuf.st_size);
+  return netlist;
+}
+
+}  // namespace rtl
+}  // namespace netlist
+}  // namespace xls
@@ -0,0 +1,66 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_NETLIST_NETLIST_SERIALIZER_H_
+#define XLS_NETLIST_NETLIST_SERIALIZER_H_
+
+#include <memory>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xls/netlist/cell_library.h"
+#include "xls/netlist/netlist.h"
+#include "xls/netlist/netlist.pb.h"
+
+namespace xls {
+namespace netlist {
+namespace rtl {
+
+// Binary serialization of parsed netlists. This is a fast alternative to
+// re-tokenizing gate-level Verilog for tools which run repeatedly over the
+// same netlist (LEC, simulation): loading walks the indexed proto structure
+// directly, with cells referencing their nets by dense index instead of by
+// name resolution against the source text. The cell library is not embedded;
+// deserialization binds cells against the same library (by entry name) that
+// was used when the netlist was parsed.
+
+// Converts the netlist to its proto form.
+absl::StatusOr<NetlistProto> NetlistToProto(const Netlist& netlist);
+
+// Serializes the netlist to the binary wire form of NetlistProto.
+absl::StatusOr<std::string> SerializeNetlist(const Netlist& netlist);
+
+// Reconstructs a netlist from its proto (or binary wire) form, binding cells
+// against entries of the given cell library (and against previously
+// reconstructed modules, for module instantiations).
+absl::StatusOr<std::unique_ptr<Netlist>> NetlistFromProto(
+    const NetlistProto& proto, CellLibrary* cell_library);
+absl::StatusOr<std::unique_ptr<Netlist>> DeserializeNetlist(
+    absl::string_view data, CellLibrary* cell_library);
+
+// Writes the binary serialized form of the netlist to the given file.
+absl::Status SaveNetlistToFile(const Netlist& netlist, absl::string_view path);
+
+// Loads a binary serialized netlist from the given file. The file contents
+// are mmapped rather than read into memory so deserialization of large
+// netlists streams directly out of the page cache.
+absl::StatusOr<std::unique_ptr<Netlist>> LoadNetlistFromFile(
+    absl::string_view path, CellLibrary* cell_library);
+
+}  // namespace rtl
+}  // namespace netlist
+}  // namespace xls
+
+#endif  // XLS_NETLIST_NETLIST_SERIALIZER_H_
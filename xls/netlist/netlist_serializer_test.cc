@@ -0,0 +1,170 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/netlist/netlist_serializer.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "xls/common/file/temp_file.h"
+#include "xls/common/status/matchers.h"
+#include "xls/netlist/fake_cell_library.h"
+#include "xls/netlist/netlist.h"
+#include "xls/netlist/netlist_parser.h"
+
+namespace xls {
+namespace netlist {
+namespace rtl {
+namespace {
+
+// A netlist with submodule instantiations, a state-table cell, and constant
+// nets, exercising the interesting corners of the serialized form.
+constexpr const char kNetlistText[] = R"(
+module child (c_i0, c_i1, c_o0);
+  input c_i0, c_i1;
+  output c_o0;
+
+  AND and0 ( .A(c_i0), .B(c_i1), .Z(c_o0) );
+endmodule
+
+module main (i0, i1, i2, i3, o0, o1);
+  input i0, i1, i2, i3;
+  output o0, o1;
+  wire and_o, st_o;
+
+  child sub0 ( .c_i0(i0), .c_i1(i1), .c_o0(and_o) );
+  STATETABLE_AND st0 ( .A(i2), .B(i3), .Z(st_o) );
+  XOR xor0 ( .A(and_o), .B(st_o), .Z(o0) );
+  assign o1 = 1'b1;
+endmodule
+)";
+
+// Asserts that `found` has the same structure as `expected`: the same
+// modules, ports, nets, cell/pin/net connectivity, and assigns.
+void ExpectNetlistsEquivalent(const Netlist& expected, const Netlist& found) {
+  ASSERT_EQ(found.modules().size(), expected.modules().size());
+  for (int64_t i = 0; i < expected.modules().size(); ++i) {
+    const Module* expected_module = expected.modules()[i].get();
+    const Module* found_module = found.modules()[i].get();
+    EXPECT_EQ(found_module->name(), expected_module->name());
+
+    ASSERT_EQ(found_module->ports().size(), expected_module->ports().size());
+    for (int64_t j = 0; j < expected_module->ports().size(); ++j) {
+      EXPECT_EQ(found_module->ports()[j]->name_,
+                expected_module->ports()[j]->name_);
+      EXPECT_EQ(found_module->ports()[j]->width_,
+                expected_module->ports()[j]->width_);
+      EXPECT_EQ(found_module->ports()[j]->is_output_,
+                expected_module->ports()[j]->is_output_);
+    }
+
+    ASSERT_EQ(found_module->nets().size(), expected_module->nets().size());
+    for (int64_t j = 0; j < expected_module->nets().size(); ++j) {
+      EXPECT_EQ(found_module->nets()[j]->name(),
+                expected_module->nets()[j]->name());
+      EXPECT_EQ(found_module->nets()[j]->connected_cells().size(),
+                expected_module->nets()[j]->connected_cells().size());
+    }
+
+    ASSERT_EQ(found_module->cells().size(), expected_module->cells().size());
+    for (int64_t j = 0; j < expected_module->cells().size(); ++j) {
+      const Cell* expected_cell = expected_module->cells()[j].get();
+      const Cell* found_cell = found_module->cells()[j].get();
+      EXPECT_EQ(found_cell->name(), expected_cell->name());
+      EXPECT_EQ(found_cell->cell_library_entry()->name(),
+                expected_cell->cell_library_entry()->name());
+      ASSERT_EQ(found_cell->inputs().size(), expected_cell->inputs().size());
+      for (int64_t k = 0; k < expected_cell->inputs().size(); ++k) {
+        EXPECT_EQ(found_cell->inputs()[k].name,
+                  expected_cell->inputs()[k].name);
+        EXPECT_EQ(found_cell->inputs()[k].netref->name(),
+                  expected_cell->inputs()[k].netref->name());
+      }
+      ASSERT_EQ(found_cell->outputs().size(), expected_cell->outputs().size());
+      for (int64_t k = 0; k < expected_cell->outputs().size(); ++k) {
+        EXPECT_EQ(found_cell->outputs()[k].name,
+                  expected_cell->outputs()[k].name);
+        EXPECT_EQ(found_cell->outputs()[k].netref->name(),
+                  expected_cell->outputs()[k].netref->name());
+      }
+      EXPECT_EQ(found_cell->internal_pins().size(),
+                expected_cell->internal_pins().size());
+      EXPECT_EQ(found_cell->clock().has_value(),
+                expected_cell->clock().has_value());
+    }
+
+    ASSERT_EQ(found_module->assigns().size(),
+              expected_module->assigns().size());
+    for (const auto& assign : expected_module->assigns()) {
+      XLS_ASSERT_OK_AND_ASSIGN(NetRef found_lhs,
+                               found_module->ResolveNet(assign.first->name()));
+      ASSERT_TRUE(found_module->assigns().contains(found_lhs));
+      EXPECT_EQ(found_module->assigns().at(found_lhs)->name(),
+                assign.second->name());
+    }
+  }
+}
+
+TEST(NetlistSerializerTest, ProtoRoundTrip) {
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  Scanner scanner(kNetlistText);
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Netlist> netlist,
+                           Parser::ParseNetlist(&cell_library, &scanner));
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::string serialized,
+                           SerializeNetlist(*netlist));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Netlist> deserialized,
+      DeserializeNetlist(serialized, &cell_library));
+  ExpectNetlistsEquivalent(*netlist, *deserialized);
+}
+
+TEST(NetlistSerializerTest, FileRoundTrip) {
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  Scanner scanner(kNetlistText);
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Netlist> netlist,
+                           Parser::ParseNetlist(&cell_library, &scanner));
+
+  XLS_ASSERT_OK_AND_ASSIGN(TempFile temp_file, TempFile::Create());
+  XLS_ASSERT_OK(SaveNetlistToFile(*netlist, temp_file.path().string()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Netlist> loaded,
+      LoadNetlistFromFile(temp_file.path().string(), &cell_library));
+  ExpectNetlistsEquivalent(*netlist, *loaded);
+}
+
+TEST(NetlistSerializerTest, IndexIsPopulated) {
+  XLS_ASSERT_OK_AND_ASSIGN(CellLibrary cell_library, MakeFakeCellLibrary());
+  Scanner scanner(kNetlistText);
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Netlist> netlist,
+                           Parser::ParseNetlist(&cell_library, &scanner));
+
+  XLS_ASSERT_OK_AND_ASSIGN(NetlistProto proto, NetlistToProto(*netlist));
+  ASSERT_EQ(proto.modules_size(), 2);
+  ASSERT_TRUE(proto.module_index().contains("main"));
+  const NetlistModuleProto& main_proto =
+      proto.modules(proto.module_index().at("main"));
+  EXPECT_EQ(main_proto.name(), "main");
+  ASSERT_TRUE(main_proto.cell_index().contains("xor0"));
+  EXPECT_EQ(
+      main_proto.cells(main_proto.cell_index().at("xor0")).name(), "xor0");
+  ASSERT_TRUE(main_proto.net_index().contains("and_o"));
+  EXPECT_EQ(
+      main_proto.nets(main_proto.net_index().at("and_o")).name(), "and_o");
+}
+
+}  // namespace
+}  // namespace rtl
+}  // namespace netlist
+}  // namespace xls
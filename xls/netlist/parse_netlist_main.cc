@@ -21,8 +21,13 @@
 #include "xls/common/status/status_macros.h"
 #include "xls/netlist/find_logic_clouds.h"
 #include "xls/netlist/netlist_parser.h"
+#include "xls/netlist/netlist_serializer.h"
 
 ABSL_FLAG(bool, show_clusters, false, "Show the logic clusters found.");
+ABSL_FLAG(std::string, output_proto_path, "",
+          "If specified, write the parsed netlist in its binary serialized "
+          "form to the given file. Tools accepting a serialized netlist can "
+          "then load it directly instead of re-parsing the Verilog.");
 
 namespace xls {
 namespace {
@@ -38,11 +43,18 @@ absl::Status RealMain(absl::string_view netlist_path,
                          netlist::CellLibrary::FromProto(cell_library_proto));
   }
 
-  XLS_ASSIGN_OR_RETURN(std::string netlist_text, GetFileContents(netlist_path));
-  netlist::rtl::Scanner scanner(netlist_text);
+  // Map the netlist rather than slurping it; large synthesized netlists are
+  // scanned once and need never be copied onto the heap.
+  XLS_ASSIGN_OR_RETURN(MappedFileContents netlist_file,
+                       MappedFileContents::Map(netlist_path));
+  netlist::rtl::Scanner scanner(netlist_file.contents());
   XLS_ASSIGN_OR_RETURN(
       std::unique_ptr<netlist::rtl::Netlist> netlist,
       netlist::rtl::Parser::ParseNetlist(&cell_library, &scanner));
+  if (!absl::GetFlag(FLAGS_output_proto_path).empty()) {
+    XLS_RETURN_IF_ERROR(netlist::rtl::SaveNetlistToFile(
+        *netlist, absl::GetFlag(FLAGS_output_proto_path)));
+  }
   netlist::rtl::Module* module = netlist->modules()[0].get();
   std::cout << "nets:  " << module->nets().size() << std::endl;
   std::cout << "cells: " << module->cells().size() << std::endl;
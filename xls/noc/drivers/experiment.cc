@@ -14,8 +14,11 @@
 
 #include "xls/noc/drivers/experiment.h"
 
+#include <memory>
+
 #include "absl/strings/str_format.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/thread.h"
 #include "xls/noc/simulation/common.h"
 #include "xls/noc/simulation/global_routing_table.h"
 #include "xls/noc/simulation/network_graph.h"
@@ -274,4 +277,44 @@ absl::StatusOr<ExperimentMetrics> ExperimentRunner::RunExperiment(
   return metrics;
 }
 
+absl::StatusOr<std::vector<ExperimentMetrics>> Experiment::RunSweep(
+    int64_t worker_count) const {
+  XLS_RET_CHECK_GE(worker_count, 1);
+
+  int64_t step_count = GetStepCount();
+  if (worker_count > step_count) {
+    worker_count = step_count;
+  }
+
+  // Each worker runs a strided subset of the steps. Steps only share the
+  // immutable base config and traffic description -- each run copies the
+  // config and builds its own simulation objects -- so they can proceed
+  // concurrently.
+  std::vector<absl::StatusOr<ExperimentMetrics>> step_metrics(step_count);
+  auto run_worker = [this, worker_count, step_count,
+                     &step_metrics](int64_t worker) {
+    for (int64_t step = worker; step < step_count; step += worker_count) {
+      step_metrics[step] = RunStep(step);
+    }
+  };
+
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int64_t worker = 1; worker < worker_count; ++worker) {
+    threads.push_back(std::make_unique<Thread>(
+        [&run_worker, worker]() { run_worker(worker); }));
+  }
+  run_worker(0);
+  for (std::unique_ptr<Thread>& thread : threads) {
+    thread->Join();
+  }
+
+  std::vector<ExperimentMetrics> metrics;
+  metrics.reserve(step_count);
+  for (absl::StatusOr<ExperimentMetrics>& step_metric : step_metrics) {
+    XLS_RETURN_IF_ERROR(step_metric.status());
+    metrics.push_back(std::move(step_metric).value());
+  }
+  return metrics;
+}
+
 }  // namespace xls::noc
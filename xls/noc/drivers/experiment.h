@@ -225,6 +225,15 @@ class Experiment {
     return metrics;
   }
 
+  // Create the configs and run the simulations for all steps of the
+  // experiment, distributing steps across worker_count threads.
+  //
+  // The base config and traffic description are shared; each step copies
+  // them and builds its own network graph and simulator, so steps are
+  // independent of each other. The returned metrics are indexed by step.
+  absl::StatusOr<std::vector<ExperimentMetrics>> RunSweep(
+      int64_t worker_count = 1) const;
+
   // Get the configuration for step N.
   absl::StatusOr<ExperimentConfig> GetConfigForStep(int64_t step) const {
     XLS_RET_CHECK(step >= 0 && step < GetStepCount());
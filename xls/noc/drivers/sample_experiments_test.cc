@@ -125,6 +125,31 @@ TEST(SampleExperimentsTest, SimpleVCExperiment) {
   EXPECT_EQ(static_cast<int64_t>(ex3_vc1_traffic_rate) / 100, 7);
 }
 
+TEST(SampleExperimentsTest, SimpleVCExperimentParallelSweep) {
+  ExperimentFactory experiment_factory;
+  XLS_ASSERT_OK(RegisterSampleExperiments(experiment_factory));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Experiment experiment,
+      experiment_factory.BuildExperiment("SimpleVCExperiment"));
+
+  // Runs all steps concurrently; metrics match the per-step RunStep results
+  // checked in SimpleVCExperiment above.
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<ExperimentMetrics> metrics,
+                           experiment.RunSweep(/*worker_count=*/2));
+  ASSERT_EQ(metrics.size(), 4);
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      double ex0_vc0_traffic_rate,
+      metrics.at(0).GetFloatMetric("Sink:RecvPort0:VC:0:TrafficRateInMiBps"));
+  EXPECT_EQ(static_cast<int64_t>(ex0_vc0_traffic_rate) / 100, 51);
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      double ex3_vc1_traffic_rate,
+      metrics.at(3).GetFloatMetric("Sink:RecvPort0:VC:1:TrafficRateInMiBps"));
+  EXPECT_EQ(static_cast<int64_t>(ex3_vc1_traffic_rate) / 100, 7);
+}
+
 TEST(SampleExperimentsTest, AggregateTreeTest) {
   ExperimentFactory experiment_factory;
   XLS_ASSERT_OK(RegisterSampleExperiments(experiment_factory));
@@ -168,11 +168,26 @@ absl::StatusOr<PortAndVCIndex> DistributedRoutingTable::GetRouterOutputPort(
 absl::StatusOr<PortAndVCIndex>
 DistributedRoutingTable::GetRouterOutputPortByIndex(PortAndVCIndex from,
                                                     int64_t destination_index) {
-  PortRoutingList& routes = GetRoutingList(from);
+  if (!dense_routing_tables_.empty()) {
+    // Dense per-destination lookup built by BuildDenseRoutingTables().
+    NetworkComponentId nc_id = from.port_id_.GetNetworkComponentId();
+    const std::vector<PortAndVCIndex>& hops =
+        dense_routing_tables_.at(nc_id.network())
+            .at(nc_id.id())
+            .routes.at(from.port_id_.id())
+            .at(from.vc_index_);
+    if (destination_index >= 0 &&
+        destination_index < static_cast<int64_t>(hops.size()) &&
+        hops[destination_index].port_id_ != PortId::kInvalid) {
+      return hops[destination_index];
+    }
+  } else {
+    PortRoutingList& routes = GetRoutingList(from);
 
-  for (std::pair<int64_t, PortAndVCIndex>& hop : routes) {
-    if (hop.first == destination_index) {
-      return hop.second;
+    for (std::pair<int64_t, PortAndVCIndex>& hop : routes) {
+      if (hop.first == destination_index) {
+        return hop.second;
+      }
     }
   }
 
@@ -267,6 +282,40 @@ void DistributedRoutingTable::AllocateTableForNetwork(NetworkId network_id,
   routing_tables_[network_index].resize(component_count);
 }
 
+void DistributedRoutingTable::BuildDenseRoutingTables() {
+  int64_t sink_count = sink_indices_.NetworkComponentCount();
+
+  dense_routing_tables_.clear();
+  dense_routing_tables_.resize(routing_tables_.size());
+  for (int64_t network = 0;
+       network < static_cast<int64_t>(routing_tables_.size()); ++network) {
+    dense_routing_tables_[network].resize(routing_tables_[network].size());
+
+    for (int64_t nc = 0;
+         nc < static_cast<int64_t>(routing_tables_[network].size()); ++nc) {
+      const RouterRoutingTable& table = routing_tables_[network][nc];
+      DenseRouterRoutingTable& dense_table =
+          dense_routing_tables_[network][nc];
+
+      dense_table.routes.resize(table.routes.size());
+      for (int64_t port = 0; port < static_cast<int64_t>(table.routes.size());
+           ++port) {
+        dense_table.routes[port].resize(table.routes[port].size());
+
+        for (int64_t vc = 0;
+             vc < static_cast<int64_t>(table.routes[port].size()); ++vc) {
+          std::vector<PortAndVCIndex>& hops = dense_table.routes[port][vc];
+          hops.resize(sink_count, PortAndVCIndex{PortId::kInvalid, 0});
+          for (const std::pair<int64_t, PortAndVCIndex>& hop :
+               table.routes[port][vc]) {
+            hops.at(hop.first) = hop.second;
+          }
+        }
+      }
+    }
+  }
+}
+
 absl::Status DistributedRoutingTableBuilderBase::BuildNetworkInterfaceIndices(
     NetworkId network_id, DistributedRoutingTable* routing_table) {
   NetworkComponentIndexMapBuilder source_index_builder;
@@ -360,6 +409,7 @@ DistributedRoutingTableBuilderForTrees::BuildNetworkRoutingTables(
   XLS_RET_CHECK_OK(
       BuildPortAndVirtualChannelIndices(network_id, &routing_table));
   XLS_RET_CHECK_OK(BuildRoutingTable(network_id, &routing_table));
+  routing_table.BuildDenseRoutingTables();
 
   return routing_table;
 }
@@ -489,6 +539,7 @@ DistributedRoutingTableBuilderForMultiplePaths::BuildNetworkRoutingTables(
   XLS_RET_CHECK_OK(
       BuildPortAndVirtualChannelIndices(network_id, &routing_table));
   XLS_RET_CHECK_OK(BuildRoutingTable(network_id, &routing_table));
+  routing_table.BuildDenseRoutingTables();
 
   return routing_table;
 }
@@ -67,6 +67,15 @@ class DistributedRoutingTable {
     std::vector<std::vector<PortRoutingList>> routes;
   };
 
+  // Dense mirror of RouterRoutingTable used for O(1) lookups.
+  //
+  // DenseRouterRoutingTable::routes[port_index][vc_input_index] is a vector
+  // indexed by destination index holding the next hop, with PortId::kInvalid
+  // marking destinations without a route.
+  struct DenseRouterRoutingTable {
+    std::vector<std::vector<std::vector<PortAndVCIndex>>> routes;
+  };
+
   // Returns route to destination from a particular source network interface
   // to a sink network interface.
   //
@@ -129,6 +138,11 @@ class DistributedRoutingTable {
   // number of components in a network.
   void AllocateTableForNetwork(NetworkId network_id, int64_t component_count);
 
+  // Flattens routing_tables_ into dense_routing_tables_ -- per-destination
+  // arrays indexed by sink index.  Called by builders once the routing
+  // lists are final so GetRouterOutputPortByIndex avoids a linear search.
+  void BuildDenseRoutingTables();
+
   // Get (and create if necessary) routing table associated for a component.
   RouterRoutingTable& GetRoutingTable(NetworkComponentId nc_id) {
     return routing_tables_[nc_id.network()][nc_id.id()];
@@ -157,6 +171,10 @@ class DistributedRoutingTable {
   // ie. routing table for ComponentId id is
   //  routing_tables_[id.network()][id.id()]
   std::vector<std::vector<RouterRoutingTable>> routing_tables_;
+
+  // Dense routing tables parallel to routing_tables_, indexed the same way.
+  // Empty until BuildDenseRoutingTables() is called.
+  std::vector<std::vector<DenseRouterRoutingTable>> dense_routing_tables_;
 };
 
 // Abstract base class for distributed routing table builder.
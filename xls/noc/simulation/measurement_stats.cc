@@ -0,0 +1,184 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/noc/simulation/measurement_stats.h"
+
+#include "xls/common/math_util.h"
+
+namespace xls {
+namespace noc {
+namespace {
+
+// Returns the histogram bucket for a latency -- 0 for zero-latency
+// samples, otherwise 1 + floor(log2(latency)).
+int64_t BucketForLatency(int64_t latency) {
+  if (latency <= 0) {
+    return 0;
+  }
+  return FloorOfLog2(static_cast<uint64_t>(latency)) + 1;
+}
+
+}  // namespace
+
+void LatencyHistogram::AddSample(int64_t latency) {
+  ++bucket_count_[BucketForLatency(latency)];
+  if (flit_count_ == 0 || latency < min_latency_) {
+    min_latency_ = latency;
+  }
+  if (flit_count_ == 0 || latency > max_latency_) {
+    max_latency_ = latency;
+  }
+  latency_sum_ += latency;
+  ++flit_count_;
+}
+
+void LatencyHistogram::Clear() { *this = LatencyHistogram(); }
+
+LatencyHistogramProto LatencyHistogram::ToProto() const {
+  LatencyHistogramProto proto;
+
+  // Trailing empty buckets are elided.
+  int64_t last_used_bucket = -1;
+  for (int64_t i = 0; i < kBucketCount; ++i) {
+    if (bucket_count_[i] != 0) {
+      last_used_bucket = i;
+    }
+  }
+  for (int64_t i = 0; i <= last_used_bucket; ++i) {
+    proto.add_bucket_count(bucket_count_[i]);
+  }
+
+  proto.set_min_latency(min_latency_);
+  proto.set_max_latency(max_latency_);
+  proto.set_latency_sum(latency_sum_);
+  proto.set_flit_count(flit_count_);
+  return proto;
+}
+
+void NocMeasurementStats::RecordSinkArrival(NetworkComponentId sink,
+                                            int64_t cycle, int64_t vc,
+                                            int64_t bit_count,
+                                            int64_t latency) {
+  SinkStats& stats = sink_stats_[sink];
+
+  if (window_cycle_count_ > 0) {
+    // Close any windows that ended before this cycle.  Empty windows
+    // are not emitted, so a long idle period costs nothing.
+    while (cycle >= stats.current_window.start_cycle + window_cycle_count_) {
+      RollWindow(stats,
+                 stats.current_window.start_cycle + window_cycle_count_ - 1);
+    }
+    stats.current_window.latency.AddSample(latency);
+    ++stats.current_window.flit_count;
+    stats.current_window.bit_count += bit_count;
+  }
+
+  stats.cumulative_latency.AddSample(latency);
+  if (vc >= stats.vc_flit_count.size()) {
+    stats.vc_flit_count.resize(vc + 1, 0);
+    stats.vc_bit_count.resize(vc + 1, 0);
+  }
+  ++stats.vc_flit_count[vc];
+  stats.vc_bit_count[vc] += bit_count;
+}
+
+void NocMeasurementStats::RecordRouterVcOccupancy(NetworkComponentId router,
+                                                  int64_t port_index,
+                                                  int64_t vc_index,
+                                                  int64_t occupancy) {
+  RouterStats& stats = router_stats_[router];
+  if (port_index >= stats.vc_occupancy.size()) {
+    stats.vc_occupancy.resize(port_index + 1);
+  }
+  std::vector<OccupancyStats>& port_stats = stats.vc_occupancy[port_index];
+  if (vc_index >= port_stats.size()) {
+    port_stats.resize(vc_index + 1);
+  }
+
+  OccupancyStats& occ = port_stats[vc_index];
+  occ.occupancy_sum += occupancy;
+  if (occupancy > occ.max_occupancy) {
+    occ.max_occupancy = occupancy;
+  }
+  ++occ.cycle_count;
+}
+
+void NocMeasurementStats::RollWindow(SinkStats& stats,
+                                     int64_t end_cycle) const {
+  if (stats.current_window.flit_count > 0) {
+    MeasurementWindowProto window;
+    window.set_start_cycle(stats.current_window.start_cycle);
+    window.set_end_cycle(end_cycle);
+    *window.mutable_latency() = stats.current_window.latency.ToProto();
+    window.set_flit_count(stats.current_window.flit_count);
+    window.set_bit_count(stats.current_window.bit_count);
+    stats.completed_windows.push_back(std::move(window));
+  }
+
+  stats.current_window = WindowAccumulator();
+  stats.current_window.start_cycle = end_cycle + 1;
+}
+
+NocSimulationResultsProto NocMeasurementStats::ToProto(
+    int64_t last_cycle) const {
+  NocSimulationResultsProto results;
+  results.set_window_cycle_count(window_cycle_count_);
+  results.set_cycle_count(last_cycle + 1);
+
+  for (auto& [sink_id, stats] : sink_stats_) {
+    SinkStatisticsProto* sink_proto = results.add_sink_statistics();
+    sink_proto->set_sink_id(sink_id.AsUInt64());
+    *sink_proto->mutable_cumulative_latency() =
+        stats.cumulative_latency.ToProto();
+
+    for (int64_t vc = 0; vc < stats.vc_flit_count.size(); ++vc) {
+      VcThroughputProto* vc_proto = sink_proto->add_vc_throughput();
+      vc_proto->set_vc_index(vc);
+      vc_proto->set_flit_count(stats.vc_flit_count[vc]);
+      vc_proto->set_bit_count(stats.vc_bit_count[vc]);
+    }
+
+    for (const MeasurementWindowProto& window : stats.completed_windows) {
+      *sink_proto->add_windows() = window;
+    }
+    if (window_cycle_count_ > 0 && stats.current_window.flit_count > 0) {
+      // Close the in-progress window as of the last simulated cycle.
+      SinkStats copy = stats;
+      RollWindow(copy, last_cycle);
+      *sink_proto->add_windows() = copy.completed_windows.back();
+    }
+  }
+
+  for (auto& [router_id, stats] : router_stats_) {
+    RouterStatisticsProto* router_proto = results.add_router_statistics();
+    router_proto->set_router_id(router_id.AsUInt64());
+
+    for (int64_t port = 0; port < stats.vc_occupancy.size(); ++port) {
+      for (int64_t vc = 0; vc < stats.vc_occupancy[port].size(); ++vc) {
+        const OccupancyStats& occ = stats.vc_occupancy[port][vc];
+        VcOccupancyProto* occ_proto = router_proto->add_vc_occupancy();
+        occ_proto->set_port_index(port);
+        occ_proto->set_vc_index(vc);
+        occ_proto->set_occupancy_sum(occ.occupancy_sum);
+        occ_proto->set_max_occupancy(occ.max_occupancy);
+        occ_proto->set_cycle_count(occ.cycle_count);
+      }
+    }
+  }
+
+  return results;
+}
+
+}  // namespace noc
+}  // namespace xls
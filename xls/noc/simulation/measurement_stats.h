@@ -0,0 +1,135 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_NOC_SIMULATION_MEASUREMENT_STATS_H_
+#define XLS_NOC_SIMULATION_MEASUREMENT_STATS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "xls/noc/simulation/common.h"
+#include "xls/noc/simulation/noc_simulation_results.pb.h"
+
+// Online statistics aggregation for the NocSimulator.
+//
+// Rather than post-processing the per-flit traces collected by
+// SimNetworkInterfaceSink, these accumulators compute latency
+// histograms, per-vc throughput counters, and per-vc router buffer
+// occupancy as the simulation runs.  Memory usage is constant per
+// (component, vc) plus one small summary per completed measurement
+// window, independent of the number of flits simulated.
+
+namespace xls {
+namespace noc {
+
+// Latency histogram with power-of-two-sized buckets.
+//
+// Bucket 0 counts zero-latency samples and bucket i counts samples in
+// [2^(i-1), 2^i), so a fixed 64-bucket array covers all int64 latencies.
+class LatencyHistogram {
+ public:
+  // Number of buckets -- covers all non-negative int64 latencies.
+  static constexpr int64_t kBucketCount = 64;
+
+  // Records a single latency sample (in cycles).
+  void AddSample(int64_t latency);
+
+  // Resets the histogram to its initial (empty) state.
+  void Clear();
+
+  int64_t flit_count() const { return flit_count_; }
+
+  LatencyHistogramProto ToProto() const;
+
+ private:
+  int64_t bucket_count_[kBucketCount] = {};
+  int64_t min_latency_ = 0;
+  int64_t max_latency_ = 0;
+  int64_t latency_sum_ = 0;
+  int64_t flit_count_ = 0;
+};
+
+// Accumulates measurement statistics for a simulation run.
+//
+// The NocSimulator owns one of these when measurements are enabled
+// (see NocSimulator::EnableMeasurements) and calls RecordSinkArrival
+// for each flit received at a sink and RecordRouterVcOccupancy once
+// per cycle per (router, input port, vc).
+class NocMeasurementStats {
+ public:
+  // window_cycle_count gives the width of each measurement window; a
+  // window summary is emitted each time the simulation crosses a
+  // window boundary.  A non-positive count disables windowing and only
+  // cumulative statistics are kept.
+  explicit NocMeasurementStats(int64_t window_cycle_count)
+      : window_cycle_count_(window_cycle_count) {}
+
+  // Records a flit received by the given sink on the given cycle.
+  // latency is measured in cycles from injection to arrival.
+  void RecordSinkArrival(NetworkComponentId sink, int64_t cycle, int64_t vc,
+                         int64_t bit_count, int64_t latency);
+
+  // Records the instantaneous depth of a router's input buffer for a
+  // single (input port, vc).  Expected to be called once per cycle.
+  void RecordRouterVcOccupancy(NetworkComponentId router, int64_t port_index,
+                               int64_t vc_index, int64_t occupancy);
+
+  // Returns the accumulated statistics.  last_cycle is the final cycle
+  // simulated; any in-progress window is closed as of that cycle.
+  NocSimulationResultsProto ToProto(int64_t last_cycle) const;
+
+ private:
+  // Per-window accumulators for a single sink.
+  struct WindowAccumulator {
+    int64_t start_cycle = 0;
+    LatencyHistogram latency;
+    int64_t flit_count = 0;
+    int64_t bit_count = 0;
+  };
+
+  struct SinkStats {
+    LatencyHistogram cumulative_latency;
+    // Indexed by vc; grown on demand.
+    std::vector<int64_t> vc_flit_count;
+    std::vector<int64_t> vc_bit_count;
+    WindowAccumulator current_window;
+    std::vector<MeasurementWindowProto> completed_windows;
+  };
+
+  struct OccupancyStats {
+    int64_t occupancy_sum = 0;
+    int64_t max_occupancy = 0;
+    int64_t cycle_count = 0;
+  };
+
+  struct RouterStats {
+    // Indexed by [port][vc]; grown on demand.
+    std::vector<std::vector<OccupancyStats>> vc_occupancy;
+  };
+
+  // Closes the sink's current window as of end_cycle (inclusive) and
+  // starts a new one.
+  void RollWindow(SinkStats& stats, int64_t end_cycle) const;
+
+  int64_t window_cycle_count_;
+
+  absl::flat_hash_map<NetworkComponentId, SinkStats> sink_stats_;
+  absl::flat_hash_map<NetworkComponentId, RouterStats> router_stats_;
+};
+
+}  // namespace noc
+}  // namespace xls
+
+#endif  // XLS_NOC_SIMULATION_MEASUREMENT_STATS_H_
@@ -0,0 +1,120 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/noc/simulation/measurement_stats.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+
+namespace xls {
+namespace noc {
+namespace {
+
+TEST(MeasurementStatsTest, LatencyHistogramBuckets) {
+  LatencyHistogram histogram;
+
+  histogram.AddSample(0);  // Bucket 0.
+  histogram.AddSample(1);  // Bucket 1.
+  histogram.AddSample(2);  // Bucket 2.
+  histogram.AddSample(3);  // Bucket 2.
+  histogram.AddSample(4);  // Bucket 3.
+  histogram.AddSample(7);  // Bucket 3.
+
+  LatencyHistogramProto proto = histogram.ToProto();
+  ASSERT_EQ(proto.bucket_count_size(), 4);
+  EXPECT_EQ(proto.bucket_count(0), 1);
+  EXPECT_EQ(proto.bucket_count(1), 1);
+  EXPECT_EQ(proto.bucket_count(2), 2);
+  EXPECT_EQ(proto.bucket_count(3), 2);
+  EXPECT_EQ(proto.min_latency(), 0);
+  EXPECT_EQ(proto.max_latency(), 7);
+  EXPECT_EQ(proto.latency_sum(), 17);
+  EXPECT_EQ(proto.flit_count(), 6);
+
+  histogram.Clear();
+  EXPECT_EQ(histogram.flit_count(), 0);
+  EXPECT_EQ(histogram.ToProto().bucket_count_size(), 0);
+}
+
+TEST(MeasurementStatsTest, SinkArrivalsAreWindowed) {
+  NocMeasurementStats stats(/*window_cycle_count=*/10);
+  NetworkComponentId sink(0, 1);
+
+  // Two flits in window [0, 10), one in window [20, 30) -- window
+  // [10, 20) is empty and should not be emitted.
+  stats.RecordSinkArrival(sink, /*cycle=*/2, /*vc=*/0, /*bit_count=*/64,
+                          /*latency=*/2);
+  stats.RecordSinkArrival(sink, /*cycle=*/9, /*vc=*/1, /*bit_count=*/64,
+                          /*latency=*/5);
+  stats.RecordSinkArrival(sink, /*cycle=*/25, /*vc=*/0, /*bit_count=*/128,
+                          /*latency=*/10);
+
+  NocSimulationResultsProto results = stats.ToProto(/*last_cycle=*/29);
+  EXPECT_EQ(results.window_cycle_count(), 10);
+  EXPECT_EQ(results.cycle_count(), 30);
+  ASSERT_EQ(results.sink_statistics_size(), 1);
+
+  const SinkStatisticsProto& sink_stats = results.sink_statistics(0);
+  EXPECT_EQ(sink_stats.sink_id(), sink.AsUInt64());
+  EXPECT_EQ(sink_stats.cumulative_latency().flit_count(), 3);
+  EXPECT_EQ(sink_stats.cumulative_latency().latency_sum(), 17);
+
+  ASSERT_EQ(sink_stats.vc_throughput_size(), 2);
+  EXPECT_EQ(sink_stats.vc_throughput(0).flit_count(), 2);
+  EXPECT_EQ(sink_stats.vc_throughput(0).bit_count(), 192);
+  EXPECT_EQ(sink_stats.vc_throughput(1).flit_count(), 1);
+  EXPECT_EQ(sink_stats.vc_throughput(1).bit_count(), 64);
+
+  ASSERT_EQ(sink_stats.windows_size(), 2);
+  EXPECT_EQ(sink_stats.windows(0).start_cycle(), 0);
+  EXPECT_EQ(sink_stats.windows(0).end_cycle(), 9);
+  EXPECT_EQ(sink_stats.windows(0).flit_count(), 2);
+  EXPECT_EQ(sink_stats.windows(0).bit_count(), 128);
+  EXPECT_EQ(sink_stats.windows(1).start_cycle(), 20);
+  EXPECT_EQ(sink_stats.windows(1).end_cycle(), 29);
+  EXPECT_EQ(sink_stats.windows(1).flit_count(), 1);
+}
+
+TEST(MeasurementStatsTest, RouterOccupancy) {
+  NocMeasurementStats stats(/*window_cycle_count=*/0);
+  NetworkComponentId router(0, 7);
+
+  stats.RecordRouterVcOccupancy(router, /*port_index=*/0, /*vc_index=*/0,
+                                /*occupancy=*/1);
+  stats.RecordRouterVcOccupancy(router, /*port_index=*/0, /*vc_index=*/0,
+                                /*occupancy=*/3);
+  stats.RecordRouterVcOccupancy(router, /*port_index=*/1, /*vc_index=*/0,
+                                /*occupancy=*/0);
+
+  NocSimulationResultsProto results = stats.ToProto(/*last_cycle=*/1);
+  ASSERT_EQ(results.router_statistics_size(), 1);
+
+  const RouterStatisticsProto& router_stats = results.router_statistics(0);
+  EXPECT_EQ(router_stats.router_id(), router.AsUInt64());
+  ASSERT_EQ(router_stats.vc_occupancy_size(), 2);
+
+  EXPECT_EQ(router_stats.vc_occupancy(0).port_index(), 0);
+  EXPECT_EQ(router_stats.vc_occupancy(0).occupancy_sum(), 4);
+  EXPECT_EQ(router_stats.vc_occupancy(0).max_occupancy(), 3);
+  EXPECT_EQ(router_stats.vc_occupancy(0).cycle_count(), 2);
+
+  EXPECT_EQ(router_stats.vc_occupancy(1).port_index(), 1);
+  EXPECT_EQ(router_stats.vc_occupancy(1).occupancy_sum(), 0);
+  EXPECT_EQ(router_stats.vc_occupancy(1).cycle_count(), 1);
+}
+
+}  // namespace
+}  // namespace noc
+}  // namespace xls
@@ -23,21 +23,16 @@
 
 namespace xls::noc {
 
-absl::Status NocTrafficInjector::RunCycle() {
-  if (simulator_ == nullptr) {
-    return absl::InternalError(
-        "Unable to run traffic injection without calling SetSimulatorShim().");
-  }
-
-  ++cycle_;
-
+template <typename SendFlitFunc>
+absl::Status NocTrafficInjector::GenerateCycleFlits(int64_t cycle,
+                                                    SendFlitFunc&& send_flit) {
   for (int64_t i = 0; i < traffic_models_.size(); ++i) {
     // Retrieve packets.
     std::vector<DataPacket> packets =
-        traffic_models_[i]->GetNewCyclePackets(cycle_);
+        traffic_models_[i]->GetNewCyclePackets(cycle);
 
     this->traffic_model_monitor_[i].AcceptNewPackets(absl::MakeSpan(packets),
-                                                     cycle_);
+                                                     cycle);
 
     // Convert to flits, and sequence them for injection.
     int64_t source_index = flows_index_to_sources_index_map_.at(i);
@@ -62,9 +57,9 @@ absl::Status NocTrafficInjector::RunCycle() {
         XLS_ASSIGN_OR_RETURN(DataFlit flit, depacketizer.ComputeNextFlit());
         // Add information defining the cycle iteration the flit is injected
         // into the network.
-        TimedDataFlitInfo info{cycle_};
-        TimedDataFlit timed_data_flit{cycle_, flit, info};
-        XLS_RET_CHECK_OK(simulator_->SendFlitAtTime(timed_data_flit, source));
+        TimedDataFlitInfo info{cycle};
+        TimedDataFlit timed_data_flit{cycle, flit, info};
+        XLS_RET_CHECK_OK(send_flit(source, timed_data_flit));
       }
     }
   }
@@ -72,6 +67,52 @@ absl::Status NocTrafficInjector::RunCycle() {
   return absl::OkStatus();
 }
 
+absl::Status NocTrafficInjector::RunCycle() {
+  if (simulator_ == nullptr) {
+    return absl::InternalError(
+        "Unable to run traffic injection without calling SetSimulatorShim().");
+  }
+
+  ++cycle_;
+
+  // Within the precompiled horizon injection is an array read; past it,
+  // generation resumes on-the-fly where the precomputation left off.
+  if (cycle_ + 1 < precomputed_cycle_start_.size()) {
+    for (int64_t index = precomputed_cycle_start_[cycle_];
+         index < precomputed_cycle_start_[cycle_ + 1]; ++index) {
+      XLS_RET_CHECK_OK(simulator_->SendFlitAtTime(
+          precomputed_flits_[index].flit, precomputed_flits_[index].source));
+    }
+    return absl::OkStatus();
+  }
+
+  return GenerateCycleFlits(
+      cycle_, [this](NetworkComponentId source, const TimedDataFlit& flit) {
+        return simulator_->SendFlitAtTime(flit, source);
+      });
+}
+
+absl::Status NocTrafficInjector::PrecomputeInjectionSchedule(
+    int64_t cycle_count) {
+  XLS_RET_CHECK_EQ(cycle_, -1) << "Injection schedule must be precompiled "
+                                  "before the first call to RunCycle().";
+  XLS_RET_CHECK(precomputed_cycle_start_.empty())
+      << "Injection schedule has already been precompiled.";
+
+  precomputed_cycle_start_.reserve(cycle_count + 1);
+  for (int64_t cycle = 0; cycle < cycle_count; ++cycle) {
+    precomputed_cycle_start_.push_back(precomputed_flits_.size());
+    XLS_RETURN_IF_ERROR(GenerateCycleFlits(
+        cycle, [this](NetworkComponentId source, const TimedDataFlit& flit) {
+          precomputed_flits_.push_back(PrecomputedFlit{source, flit});
+          return absl::OkStatus();
+        }));
+  }
+  precomputed_cycle_start_.push_back(precomputed_flits_.size());
+
+  return absl::OkStatus();
+}
+
 namespace {
 
 // Function that calls run_action(i, j) for each flow and network_component
@@ -45,6 +45,20 @@ class NocTrafficInjector {
   // on the current_cycle.
   absl::Status RunCycle();
 
+  // Precompiles the injection schedule for the first cycle_count cycles
+  // of simulation.
+  //
+  // The traffic models and depacketizers are run ahead of simulation and
+  // the resulting flits stored in a flat per-cycle array, so RunCycle()
+  // reduces to an array read per cycle instead of consulting the random
+  // number interface and traffic-mode logic per flow.  Cycles beyond
+  // cycle_count fall back to on-the-fly generation.
+  //
+  // Must be called before the first call to RunCycle().  Traffic
+  // measurements (MeasuredTrafficRateInMiBps / MeasuredBitsSent) account
+  // for the entire precompiled schedule once this returns.
+  absl::Status PrecomputeInjectionSchedule(int64_t cycle_count);
+
   // Provides the interface between this object and the NOC simulator.
   void SetSimulatorShim(NocSimulatorTrafficServiceShim& simulator) {
     simulator_ = &simulator;
@@ -104,6 +118,19 @@ class NocTrafficInjector {
  private:
   friend NocTrafficInjectorBuilder;
 
+  // A flit scheduled for injection by PrecomputeInjectionSchedule().
+  struct PrecomputedFlit {
+    NetworkComponentId source;
+    TimedDataFlit flit;
+  };
+
+  // Generates flits for a single cycle from the traffic models and
+  // depacketizers, calling send_flit(source, flit) for each flit in
+  // injection order.  Common implementation for RunCycle() and
+  // PrecomputeInjectionSchedule().
+  template <typename SendFlitFunc>
+  absl::Status GenerateCycleFlits(int64_t cycle, SendFlitFunc&& send_flit);
+
   // Interface to simulator for injecting flits.
   NocSimulatorTrafficServiceShim* simulator_ = nullptr;
 
@@ -145,6 +172,14 @@ class NocTrafficInjector {
 
   // Measure injected traffic rate.
   std::vector<TrafficModelMonitor> traffic_model_monitor_;
+
+  // Precompiled injection schedule (see PrecomputeInjectionSchedule()).
+  //
+  // Flits for cycle c are precomputed_flits_[precomputed_cycle_start_[c]]
+  // up to (exclusive) precomputed_flits_[precomputed_cycle_start_[c+1]].
+  // Empty when no schedule has been precompiled.
+  std::vector<PrecomputedFlit> precomputed_flits_;
+  std::vector<int64_t> precomputed_cycle_start_;
 };
 
 // Builder for constructing a NocTrafficInjector.
@@ -642,5 +642,93 @@ TEST(NocTrafficInjectorTest, ReplaySource) {
   EXPECT_DOUBLE_EQ(replay_model->GetPacketSizeInBits(), 128);
 }
 
+TEST(NocTrafficInjectorTest, PrecomputedInjectionSchedule) {
+  // Construct traffic flows
+  NocTrafficManager traffic_mgr;
+
+  XLS_ASSERT_OK_AND_ASSIGN(TrafficFlowId flow0_id,
+                           traffic_mgr.CreateTrafficFlow());
+  traffic_mgr.GetTrafficFlow(flow0_id)
+      .SetName("flow0")
+      .SetSource("SendPort0")
+      .SetDestination("RecvPort0")
+      .SetVC("VC0")
+      .SetPacketSizeInBits(128)
+      .SetClockCycleTimes({0, 2, 4});
+
+  XLS_ASSERT_OK_AND_ASSIGN(TrafficModeId mode0_id,
+                           traffic_mgr.CreateTrafficMode());
+  traffic_mgr.GetTrafficMode(mode0_id).SetName("Mode 0").RegisterTrafficFlow(
+      flow0_id);
+
+  // Build and assign simulation objects
+  NetworkConfigProto proto;
+  NetworkManager graph;
+  NocParameters params;
+  XLS_ASSERT_OK(BuildNetworkGraphLinear000(&proto, &graph, &params));
+
+  // Create global routing table.
+  DistributedRoutingTableBuilderForTrees route_builder;
+  XLS_ASSERT_OK_AND_ASSIGN(DistributedRoutingTable routing_table,
+                           route_builder.BuildNetworkRoutingTables(
+                               graph.GetNetworkIds()[0], graph, params));
+
+  // Build input traffic model
+  RandomNumberInterface rnd;
+  int64_t cycle_time_in_ps = 400;
+  rnd.SetSeed(1000);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      NocTrafficInjector traffic_injector,
+      NocTrafficInjectorBuilder().Build(
+          cycle_time_in_ps, mode0_id,
+          routing_table.GetSourceIndices().GetNetworkComponents(),
+          routing_table.GetSinkIndices().GetNetworkComponents(),
+          params.GetNetworkParam(graph.GetNetworkIds()[0])
+              ->GetVirtualChannels(),
+          traffic_mgr, graph, params, rnd));
+
+  // Counts flits per injection cycle.
+  class NocTrafficInjectorSink : public NocSimulatorTrafficServiceShim {
+   public:
+    absl::Status RunCycle() override { return absl::OkStatus(); }
+
+    absl::Status SendFlitAtTime(TimedDataFlit flit,
+                                NetworkComponentId source) override {
+      flits_per_cycle_[flit.cycle] += 1;
+      EXPECT_EQ(flit.metadata.injection_cycle_time, flit.cycle);
+      return absl::OkStatus();
+    }
+
+    int64_t FlitsSentOnCycle(int64_t cycle) { return flits_per_cycle_[cycle]; }
+
+   private:
+    absl::flat_hash_map<int64_t, int64_t> flits_per_cycle_;
+  };
+
+  NocTrafficInjectorSink sink;
+  traffic_injector.SetSimulatorShim(sink);
+
+  // Precompile the first four cycles; the packet at cycle 4 is then
+  // generated on-the-fly after the precompiled horizon is passed.
+  XLS_ASSERT_OK(traffic_injector.PrecomputeInjectionSchedule(4));
+
+  // Precompiling twice or after RunCycle() is an error.
+  EXPECT_FALSE(traffic_injector.PrecomputeInjectionSchedule(4).ok());
+
+  for (int64_t cycle = 0; cycle < 6; ++cycle) {
+    XLS_ASSERT_OK(traffic_injector.RunCycle());
+  }
+
+  // Each 128-bit packet depacketizes into two 64-bit payload flits.
+  EXPECT_EQ(sink.FlitsSentOnCycle(0), 2);
+  EXPECT_EQ(sink.FlitsSentOnCycle(1), 0);
+  EXPECT_EQ(sink.FlitsSentOnCycle(2), 2);
+  EXPECT_EQ(sink.FlitsSentOnCycle(3), 0);
+  EXPECT_EQ(sink.FlitsSentOnCycle(4), 2);
+  EXPECT_EQ(sink.FlitsSentOnCycle(5), 0);
+
+  EXPECT_EQ(traffic_injector.MeasuredBitsSent(0), 3 * 128);
+}
+
 }  // namespace
 }  // namespace xls::noc
@@ -14,12 +14,14 @@
 
 #include "xls/noc/simulation/sim_objects.h"
 
+#include <memory>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "xls/common/status/ret_check.h"
+#include "xls/common/thread.h"
 #include "xls/ir/bits.h"
 #include "xls/noc/config/network_config.pb.h"
 #include "xls/noc/simulation/common.h"
@@ -139,6 +141,23 @@ absl::Status NocSimulator::CreateSimulationObjects(NetworkId network) {
     XLS_RETURN_IF_ERROR(CreateNetworkComponent(id));
   }
 
+  // Cache pointers to the component simulation objects in serial tick order.
+  // The component vectors are stable after this point so the pointers remain
+  // valid for the lifetime of the simulator.
+  component_ptrs_.clear();
+  for (SimNetworkInterfaceSrc& nc : network_interface_sources_) {
+    component_ptrs_.push_back(&nc);
+  }
+  for (SimLink& nc : links_) {
+    component_ptrs_.push_back(&nc);
+  }
+  for (SimInputBufferedVCRouter& nc : routers_) {
+    component_ptrs_.push_back(&nc);
+  }
+  for (SimNetworkInterfaceSink& nc : network_interface_sinks_) {
+    component_ptrs_.push_back(&nc);
+  }
+
   return absl::OkStatus();
 }
 
@@ -285,6 +304,12 @@ absl::Status NocSimulator::RunCycle(int64_t max_ticks) {
     }
   }
 
+  if (measurements_ != nullptr) {
+    for (SimInputBufferedVCRouter& router : routers_) {
+      router.RecordInputBufferOccupancy(*measurements_);
+    }
+  }
+
   for (NocSimulatorServiceShim* svc : post_cycle_services_) {
     XLS_RET_CHECK_OK(svc->RunCycle());
   }
@@ -292,10 +317,24 @@ absl::Status NocSimulator::RunCycle(int64_t max_ticks) {
   return absl::OkStatus();
 }
 
+absl::StatusOr<NocSimulationResultsProto> NocSimulator::GetMeasurementResults()
+    const {
+  if (measurements_ == nullptr) {
+    return absl::FailedPreconditionError(
+        "Measurements have not been enabled, "
+        "call EnableMeasurements() before simulating.");
+  }
+  return measurements_->ToProto(cycle_);
+}
+
 bool NocSimulator::Tick() {
   // Goes through each simulator object and run atick.
   // Converges when everyone returns True -- that determines new cycle
 
+  if (worker_thread_count_ > 1) {
+    return ParallelTick();
+  }
+
   bool converged = true;
 
   XLS_VLOG(2) << " Network Interfaces";
@@ -337,6 +376,52 @@ bool NocSimulator::Tick() {
   return converged;
 }
 
+bool NocSimulator::ParallelTick() {
+  // During a parallel tick each component reads neighboring connection state
+  // from a snapshot taken at the start of the tick (served by
+  // GetPrevSimConnectionByIndex) while writing the live state, so components
+  // on different threads never touch the same data. Writes become visible to
+  // other components on the next tick, which adds ticks relative to the
+  // serial in-order sweep but converges to the same fixed point.
+  connections_snapshot_ = connections_;
+  read_connections_ = &connections_snapshot_;
+
+  int64_t worker_count = worker_thread_count_;
+  if (worker_count > static_cast<int64_t>(component_ptrs_.size())) {
+    worker_count = component_ptrs_.size();
+  }
+
+  // Each worker ticks a strided subset of the components and records whether
+  // its subset converged.
+  std::vector<char> worker_converged(worker_count, 1);
+  auto run_worker = [this, worker_count, &worker_converged](int64_t worker) {
+    bool converged = true;
+    for (int64_t i = worker; i < static_cast<int64_t>(component_ptrs_.size());
+         i += worker_count) {
+      converged &= component_ptrs_[i]->Tick(*this);
+    }
+    worker_converged[worker] = converged ? 1 : 0;
+  };
+
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int64_t worker = 1; worker < worker_count; ++worker) {
+    threads.push_back(std::make_unique<Thread>(
+        [&run_worker, worker]() { run_worker(worker); }));
+  }
+  run_worker(0);
+  for (std::unique_ptr<Thread>& thread : threads) {
+    thread->Join();
+  }
+
+  read_connections_ = &connections_;
+
+  bool converged = true;
+  for (char worker_result : worker_converged) {
+    converged &= (worker_result != 0);
+  }
+  return converged;
+}
+
 bool SimNetworkComponentBase::Tick(NocSimulator& simulator) {
   int64_t cycle = simulator.GetCurrentCycle();
 
@@ -469,6 +554,16 @@ absl::Status SimNetworkInterfaceSink::InitializeImpl(NocSimulator& simulator) {
 int64_t SimInputBufferedVCRouter::GetUtilizationCycleCount() const {
   return utilization_cycle_count_;
 }
+
+void SimInputBufferedVCRouter::RecordInputBufferOccupancy(
+    NocMeasurementStats& stats) const {
+  for (int64_t port = 0; port < input_buffers_.size(); ++port) {
+    for (int64_t vc = 0; vc < input_buffers_[port].size(); ++vc) {
+      stats.RecordRouterVcOccupancy(GetId(), port, vc,
+                                    input_buffers_[port][vc].queue.size());
+    }
+  }
+}
 absl::Status SimInputBufferedVCRouter::InitializeImpl(NocSimulator& simulator) {
   NetworkManager* network_manager = simulator.GetNetworkManager();
   NetworkComponent& nc = network_manager->GetNetworkComponent(id_);
@@ -536,12 +631,34 @@ absl::Status SimInputBufferedVCRouter::InitializeImpl(NocSimulator& simulator) {
   internal_propagated_cycle_ = simulator.GetCurrentCycle();
   utilization_cycle_count_ = 0;
 
+  // Flatten the routing table into a dense per-destination cache so the
+  // per-flit routing in forward propagation is a direct lookup.
+  int64_t sink_count =
+      simulator.GetRoutingTable()->GetSinkIndices().NetworkComponentCount();
+  output_route_cache_.resize(input_connection_count_);
+  for (int64_t i = 0; i < input_connection_count_; ++i) {
+    int64_t vc_count = input_buffers_[i].size();
+    output_route_cache_[i].resize(vc_count);
+    for (int64_t vc = 0; vc < vc_count; ++vc) {
+      output_route_cache_[i][vc].assign(sink_count,
+                                        PortIndexAndVCIndex{-1, -1});
+      for (int64_t destination = 0; destination < sink_count; ++destination) {
+        absl::StatusOr<PortIndexAndVCIndex> output =
+            GetDestinationPortIndexAndVcIndex(
+                simulator, PortIndexAndVCIndex{i, vc}, destination);
+        if (output.ok()) {
+          output_route_cache_[i][vc][destination] = output.value();
+        }
+      }
+    }
+  }
+
   return absl::OkStatus();
 }
 
 bool SimLink::TryForwardPropagation(NocSimulator& simulator) {
   SimConnectionState& src =
-      simulator.GetSimConnectionByIndex(src_connection_index_);
+      simulator.GetPrevSimConnectionByIndex(src_connection_index_);
   SimConnectionState& sink =
       simulator.GetSimConnectionByIndex(sink_connection_index_);
 
@@ -565,7 +682,7 @@ bool SimLink::TryReversePropagation(NocSimulator& simulator) {
   SimConnectionState& src =
       simulator.GetSimConnectionByIndex(src_connection_index_);
   SimConnectionState& sink =
-      simulator.GetSimConnectionByIndex(sink_connection_index_);
+      simulator.GetPrevSimConnectionByIndex(sink_connection_index_);
 
   int64_t vc_count = sink.reverse_channels.size();
   int64_t num_propagated = 0;
@@ -654,7 +771,7 @@ bool SimNetworkInterfaceSrc::TryForwardPropagation(NocSimulator& simulator) {
 bool SimNetworkInterfaceSrc::TryReversePropagation(NocSimulator& simulator) {
   int64_t current_cycle = simulator.GetCurrentCycle();
   SimConnectionState& sink =
-      simulator.GetSimConnectionByIndex(sink_connection_index_);
+      simulator.GetPrevSimConnectionByIndex(sink_connection_index_);
 
   int64_t vc_count = credit_update_.size();
   int64_t num_propagated = 0;
@@ -758,7 +875,7 @@ bool SimInputBufferedVCRouter::TryForwardPropagation(NocSimulator& simulator) {
   bool can_propagate_forward = true;
   for (int64_t i = 0; i < input_connection_count_; ++i) {
     SimConnectionState& input =
-        simulator.GetSimConnectionByIndex(input_connection_index[i]);
+        simulator.GetPrevSimConnectionByIndex(input_connection_index[i]);
 
     if (input.forward_channels.cycle != current_cycle) {
       can_propagate_forward = false;
@@ -782,7 +899,7 @@ bool SimInputBufferedVCRouter::TryForwardPropagation(NocSimulator& simulator) {
   // input can be routed to the output immediately.
   for (int64_t i = 0; i < input_connection_count_; ++i) {
     SimConnectionState& input =
-        simulator.GetSimConnectionByIndex(input_connection_index[i]);
+        simulator.GetPrevSimConnectionByIndex(input_connection_index[i]);
 
     if (input.forward_channels.flit.type != FlitType::kInvalid) {
       int64_t vc = input.forward_channels.flit.vc;
@@ -813,12 +930,13 @@ bool SimInputBufferedVCRouter::TryForwardPropagation(NocSimulator& simulator) {
       TimedDataFlitInfo metadata = input_buffers_[i][vc].queue.front().metadata;
       int64_t destination_index = flit.destination_index;
 
-      PortIndexAndVCIndex input{i, vc};
-      absl::StatusOr<PortIndexAndVCIndex> output_status =
-          GetDestinationPortIndexAndVcIndex(simulator, input,
-                                            destination_index);
-      XLS_CHECK_OK(output_status.status());
-      PortIndexAndVCIndex output = output_status.value();
+      // Routes were flattened into a dense per-destination cache during
+      // initialization.
+      XLS_CHECK_LT(destination_index,
+                   static_cast<int64_t>(output_route_cache_[i][vc].size()));
+      PortIndexAndVCIndex output =
+          output_route_cache_[i][vc][destination_index];
+      XLS_CHECK_GE(output.port_index, 0);
 
       // Now see if we have sufficient credits.
       if (credit_.at(output.port_index).at(output.vc_index) <= 0) {
@@ -931,7 +1049,7 @@ bool SimInputBufferedVCRouter::TryReversePropagation(NocSimulator& simulator) {
   int64_t possible_propagation = 0;
   for (int64_t i = 0; i < credit_update_.size(); ++i) {
     SimConnectionState& output =
-        simulator.GetSimConnectionByIndex(output_connection_index.at(i));
+        simulator.GetPrevSimConnectionByIndex(output_connection_index.at(i));
 
     for (int64_t vc = 0; vc < credit_update_[i].size(); ++vc) {
       TimedMetadataFlit possible_credit = output.reverse_channels[vc];
@@ -979,7 +1097,12 @@ bool SimInputBufferedVCRouter::TryReversePropagation(NocSimulator& simulator) {
 bool SimNetworkInterfaceSink::TryForwardPropagation(NocSimulator& simulator) {
   int64_t current_cycle = simulator.GetCurrentCycle();
 
+  // Forward channels are written by the upstream component so are read from
+  // the previous state; the reverse (credit) channels are written by this
+  // sink so go to the live state.
   SimConnectionState& src =
+      simulator.GetPrevSimConnectionByIndex(src_connection_index_);
+  SimConnectionState& src_out =
       simulator.GetSimConnectionByIndex(src_connection_index_);
 
   if (src.forward_channels.cycle != current_cycle) {
@@ -999,10 +1122,16 @@ bool SimNetworkInterfaceSink::TryForwardPropagation(NocSimulator& simulator) {
     received_flit.metadata = src.forward_channels.metadata;
     received_traffic_.push_back(received_flit);
 
+    if (NocMeasurementStats* stats = simulator.GetMeasurements()) {
+      stats->RecordSinkArrival(
+          GetId(), current_cycle, vc, received_flit.flit.data_bit_count,
+          current_cycle - received_flit.metadata.injection_cycle_time);
+    }
+
     // Send one credit back
-    src.reverse_channels[vc].cycle = current_cycle;
-    src.reverse_channels[vc].flit.type = FlitType::kTail;
-    src.reverse_channels[vc].flit.data = UBits(1, 32);
+    src_out.reverse_channels[vc].cycle = current_cycle;
+    src_out.reverse_channels[vc].flit.type = FlitType::kTail;
+    src_out.reverse_channels[vc].flit.data = UBits(1, 32);
 
     XLS_VLOG(2) << absl::StreamFormat(
         "... sink %x received data %s on vc %d cycle %d, sending 1 credit on "
@@ -1013,10 +1142,10 @@ bool SimNetworkInterfaceSink::TryForwardPropagation(NocSimulator& simulator) {
 
   // In cycle 0, a full credit update is sent
   if (current_cycle == 0) {
-    for (int64_t vc = 0; vc < src.reverse_channels.size(); ++vc) {
-      src.reverse_channels[vc].cycle = current_cycle;
-      src.reverse_channels[vc].flit.type = FlitType::kTail;
-      src.reverse_channels[vc].flit.data =
+    for (int64_t vc = 0; vc < src_out.reverse_channels.size(); ++vc) {
+      src_out.reverse_channels[vc].cycle = current_cycle;
+      src_out.reverse_channels[vc].flit.type = FlitType::kTail;
+      src_out.reverse_channels[vc].flit.data =
           UBits(input_buffers_[vc].max_queue_size, 32);
 
       XLS_VLOG(2) << absl::StreamFormat(
@@ -1024,11 +1153,11 @@ bool SimNetworkInterfaceSink::TryForwardPropagation(NocSimulator& simulator) {
           input_buffers_[vc].max_queue_size, vc, src.id.AsUInt64());
     }
   } else {
-    for (int64_t vc = 0; vc < src.reverse_channels.size(); ++vc) {
-      if (src.reverse_channels[vc].cycle != current_cycle) {
-        src.reverse_channels[vc].cycle = current_cycle;
-        src.reverse_channels[vc].flit.type = FlitType::kInvalid;
-        src.reverse_channels[vc].flit.data = Bits(32);
+    for (int64_t vc = 0; vc < src_out.reverse_channels.size(); ++vc) {
+      if (src_out.reverse_channels[vc].cycle != current_cycle) {
+        src_out.reverse_channels[vc].cycle = current_cycle;
+        src_out.reverse_channels[vc].flit.type = FlitType::kInvalid;
+        src_out.reverse_channels[vc].flit.data = Bits(32);
       }
     }
   }
@@ -16,6 +16,7 @@
 #define XLS_NOC_SIMULATION_SIM_OBJECTS_H_
 
 #include <cstdint>
+#include <memory>
 #include <queue>
 #include <vector>
 
@@ -23,6 +24,7 @@
 #include "xls/noc/simulation/common.h"
 #include "xls/noc/simulation/flit.h"
 #include "xls/noc/simulation/global_routing_table.h"
+#include "xls/noc/simulation/measurement_stats.h"
 #include "xls/noc/simulation/parameters.h"
 #include "xls/noc/simulation/simulator_shims.h"
 
@@ -290,6 +292,11 @@ class SimInputBufferedVCRouter : public SimNetworkComponentBase {
 
   int64_t GetUtilizationCycleCount() const;
 
+  // Records the current input buffer depth of each (input port, vc)
+  // into the given accumulator.  Called once per cycle by the simulator
+  // when measurements are enabled.
+  void RecordInputBufferOccupancy(NocMeasurementStats& stats) const;
+
  private:
   SimInputBufferedVCRouter() = default;
 
@@ -353,6 +360,14 @@ class SimInputBufferedVCRouter : public SimNetworkComponentBase {
   // the input buffers and hence credits that can be sent back upstream.
   std::vector<std::vector<int64_t>> input_credit_to_send_;
 
+  // Dense route lookup indexed by
+  //   [input port index][input vc index][destination index],
+  // precomputed at initialization so the per-flit routing in forward
+  // propagation avoids routing table searches.  A port_index of -1 marks
+  // destinations without a route.
+  std::vector<std::vector<std::vector<PortIndexAndVCIndex>>>
+      output_route_cache_;
+
   // The number of cycles that a transfer from input to output occurred.
   int64_t utilization_cycle_count_;
 };
@@ -392,6 +407,22 @@ class NocSimulator {
     return connections_[index];
   }
 
+  // Returns the connection state a component reads for channels which are
+  // written by the component at the other end of the connection. During a
+  // parallel tick (see SetWorkerThreadCount) this is a snapshot of the state
+  // at the start of the tick; otherwise it aliases
+  // GetSimConnectionByIndex.
+  SimConnectionState& GetPrevSimConnectionByIndex(int64_t index) {
+    return (*read_connections_)[index];
+  }
+
+  // Sets the number of worker threads used by Tick(). With more than one
+  // worker, components are partitioned across threads and each tick is
+  // double-buffered: components read neighboring connection state from a
+  // snapshot taken at the start of the tick while writing the live state.
+  // Simulation results are independent of the worker count.
+  void SetWorkerThreadCount(int64_t count) { worker_thread_count_ = count; }
+
   // Allocates and returns a new SimConnectionState object.
   SimConnectionState& NewConnection(ConnectionId id) {
     int64_t index = connections_.size();
@@ -465,7 +496,27 @@ class NocSimulator {
   // Returns the routers of the simulator.
   absl::Span<const SimInputBufferedVCRouter> GetRouters() const;
 
+  // Enables online statistics aggregation (see measurement_stats.h).
+  // Statistics are accumulated from the next cycle onwards; a window
+  // summary is emitted every window_cycle_count cycles (non-positive
+  // disables windowing).
+  void EnableMeasurements(int64_t window_cycle_count) {
+    measurements_ = std::make_unique<NocMeasurementStats>(window_cycle_count);
+  }
+
+  // Returns the measurement accumulator or nullptr if measurements
+  // have not been enabled.
+  NocMeasurementStats* GetMeasurements() { return measurements_.get(); }
+
+  // Returns the statistics measured so far as a results proto.
+  absl::StatusOr<NocSimulationResultsProto> GetMeasurementResults() const;
+
  private:
+  // Tick() implementation used when more than one worker thread is
+  // configured: components tick concurrently with connection reads served
+  // from a start-of-tick snapshot.
+  bool ParallelTick();
+
   absl::Status CreateSimulationObjects(NetworkId network);
   absl::Status CreateConnection(ConnectionId connection_id);
   absl::Status CreateNetworkComponent(NetworkComponentId nc_id);
@@ -502,6 +553,15 @@ class NocSimulator {
   std::vector<int64_t> component_to_connection_index_;
   std::vector<SimConnectionState> connections_;
 
+  // Snapshot of connections_ taken at the start of a parallel tick, read via
+  // GetPrevSimConnectionByIndex. Outside of a parallel tick
+  // read_connections_ aliases connections_.
+  std::vector<SimConnectionState> connections_snapshot_;
+  std::vector<SimConnectionState>* read_connections_ = &connections_;
+
+  // Number of worker threads used by Tick() (see SetWorkerThreadCount).
+  int64_t worker_thread_count_ = 1;
+
   // Stores port ids for routers.
   std::vector<PortId> port_id_store_;
 
@@ -510,11 +570,19 @@ class NocSimulator {
   std::vector<SimNetworkInterfaceSink> network_interface_sinks_;
   std::vector<SimInputBufferedVCRouter> routers_;
 
+  // Pointers to all component simulation objects, populated after component
+  // creation; used to partition components across worker threads.
+  std::vector<SimNetworkComponentBase*> component_ptrs_;
+
   // Shims to services to run at the beginning of each cycle.
   std::vector<NocSimulatorServiceShim*> pre_cycle_services_;
 
   // Shims to services to run at the end of each cycle.
   std::vector<NocSimulatorServiceShim*> post_cycle_services_;
+
+  // Online statistics accumulator, non-null once EnableMeasurements
+  // has been called.
+  std::unique_ptr<NocMeasurementStats> measurements_;
 };
 
 }  // namespace noc
@@ -295,6 +295,97 @@ TEST(SimObjectsTest, TreeNetwork0) {
       38146);
 }
 
+TEST(SimObjectsTest, TreeNetwork0Parallel) {
+  // Runs the tree network with multiple worker threads and expects
+  // cycle-accurate results identical to the single-threaded simulation.
+  NetworkConfigProto proto;
+  NetworkManager graph;
+  NocParameters params;
+  XLS_ASSERT_OK(BuildNetworkGraphTree000(&proto, &graph, &params));
+
+  DistributedRoutingTableBuilderForTrees route_builder;
+  XLS_ASSERT_OK_AND_ASSIGN(DistributedRoutingTable routing_table,
+                           route_builder.BuildNetworkRoutingTables(
+                               graph.GetNetworkIds()[0], graph, params));
+
+  NocSimulator simulator;
+  XLS_ASSERT_OK(simulator.Initialize(graph, params, routing_table,
+                                     graph.GetNetworkIds()[0]));
+  simulator.SetWorkerThreadCount(3);
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      NetworkComponentId send_port_0,
+      FindNetworkComponentByName("SendPort0", graph, params));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      NetworkComponentId send_port_1,
+      FindNetworkComponentByName("SendPort1", graph, params));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      NetworkComponentId recv_port_1,
+      FindNetworkComponentByName("RecvPort1", graph, params));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      NetworkComponentId recv_port_3,
+      FindNetworkComponentByName("RecvPort3", graph, params));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      int64_t dest_index_1,
+      simulator.GetRoutingTable()->GetSinkIndices().GetNetworkComponentIndex(
+          recv_port_1));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      int64_t dest_index_3,
+      simulator.GetRoutingTable()->GetSinkIndices().GetNetworkComponentIndex(
+          recv_port_3));
+
+  XLS_ASSERT_OK_AND_ASSIGN(TimedDataFlit flit0,
+                           DataFlitBuilder()
+                               .Cycle(1)
+                               .Type(FlitType::kTail)
+                               .VirtualChannel(0)
+                               .SourceIndex(0)
+                               .DestinationIndex(dest_index_1)
+                               .Data(UBits(707, 64))
+                               .BuildTimedFlit());
+
+  XLS_ASSERT_OK_AND_ASSIGN(TimedDataFlit flit1,
+                           DataFlitBuilder()
+                               .Cycle(1)
+                               .Type(FlitType::kTail)
+                               .VirtualChannel(1)
+                               .SourceIndex(0)
+                               .DestinationIndex(dest_index_3)
+                               .Data(UBits(1001, 64))
+                               .BuildTimedFlit());
+
+  XLS_ASSERT_OK_AND_ASSIGN(SimNetworkInterfaceSrc * sim_send_port_0,
+                           simulator.GetSimNetworkInterfaceSrc(send_port_0));
+  XLS_ASSERT_OK(sim_send_port_0->SendFlitAtTime(flit0));
+
+  XLS_ASSERT_OK_AND_ASSIGN(SimNetworkInterfaceSrc * sim_send_port_1,
+                           simulator.GetSimNetworkInterfaceSrc(send_port_1));
+  XLS_ASSERT_OK(sim_send_port_1->SendFlitAtTime(flit1));
+
+  for (int64_t i = 0; i < 10; ++i) {
+    XLS_ASSERT_OK(simulator.RunCycle());
+  }
+
+  XLS_ASSERT_OK_AND_ASSIGN(SimNetworkInterfaceSink * sim_recv_port_1,
+                           simulator.GetSimNetworkInterfaceSink(recv_port_1));
+  XLS_ASSERT_OK_AND_ASSIGN(SimNetworkInterfaceSink * sim_recv_port_3,
+                           simulator.GetSimNetworkInterfaceSink(recv_port_3));
+
+  absl::Span<const TimedDataFlit> traffic_recv_port_1 =
+      sim_recv_port_1->GetReceivedTraffic();
+  absl::Span<const TimedDataFlit> traffic_recv_port_3 =
+      sim_recv_port_3->GetReceivedTraffic();
+
+  // Arrival cycles match the single-threaded TreeNetwork0 results.
+  ASSERT_EQ(traffic_recv_port_1.size(), 1);
+  ASSERT_EQ(traffic_recv_port_3.size(), 1);
+  EXPECT_EQ(traffic_recv_port_1[0].cycle, 3);
+  EXPECT_EQ(traffic_recv_port_1[0].flit.data, UBits(707, 64));
+  EXPECT_EQ(traffic_recv_port_3[0].cycle, 2);
+  EXPECT_EQ(traffic_recv_port_3[0].flit.data, UBits(1001, 64));
+}
+
 }  // namespace
 }  // namespace noc
 }  // namespace xls
@@ -0,0 +1,60 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/backward_dataflow.h"
+
+#include <utility>
+
+#include "xls/ir/node_iterator.h"
+
+namespace xls {
+
+/* static */ BackwardBitsetDataflow BackwardBitsetDataflow::Run(
+    FunctionBase* f, Meet meet,
+    const std::function<void(Node*, int64_t, InlineBitmap*)>& transfer) {
+  BackwardBitsetDataflow result;
+  NodeIterator it = ReverseTopoSort(f);
+  result.nodes_.assign(it.begin(), it.end());
+  const int64_t node_count = result.nodes_.size();
+  result.node_index_.Reserve(f);
+  for (int64_t i = 0; i < node_count; ++i) {
+    result.node_index_[result.nodes_[i]] = i;
+  }
+
+  result.bitmaps_.reserve(node_count);
+  for (int64_t i = 0; i < node_count; ++i) {
+    Node* node = result.nodes_[i];
+    // In a reverse topological sort all users of a node precede it, so the
+    // bitsets of the users are already final when the node is visited.
+    InlineBitmap bitmap(node_count);
+    bool first_user = true;
+    for (Node* user : node->users()) {
+      const InlineBitmap& user_bitmap =
+          result.bitmaps_[result.node_index_.at(user)];
+      if (first_user) {
+        bitmap = user_bitmap;
+        first_user = false;
+      } else if (meet == Meet::kIntersection) {
+        bitmap.And(user_bitmap);
+      } else {
+        bitmap.Or(user_bitmap);
+      }
+    }
+    transfer(node, i, &bitmap);
+    result.bitmaps_.push_back(std::move(bitmap));
+  }
+  return result;
+}
+
+}  // namespace xls
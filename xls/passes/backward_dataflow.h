@@ -0,0 +1,82 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_PASSES_BACKWARD_DATAFLOW_H_
+#define XLS_PASSES_BACKWARD_DATAFLOW_H_
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "xls/data_structures/inline_bitmap.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
+#include "xls/ir/node_map.h"
+
+namespace xls {
+
+// A backward (use-to-def) dataflow pass over a function which computes one
+// set of nodes per node, represented as a dense bitset over indices in a
+// reverse topological sort. Because the IR is a DAG a single sweep in reverse
+// topological order reaches the fixpoint: when a node is visited the bitsets
+// of all of its users are already final. Set operations are done word-wise on
+// InlineBitmaps so the per-node cost is O(n / 64) rather than O(n) hash-set
+// operations, which keeps analyses like post-dominators (see
+// post_dominator_analysis.h) usable on functions with very large node counts.
+class BackwardBitsetDataflow {
+ public:
+  // How the bitsets of a node's users are combined to form the node's
+  // incoming state. kIntersection suits must-analyses (post-dominators);
+  // kUnion suits may-analyses (liveness-style reachability).
+  enum class Meet {
+    kIntersection,
+    kUnion,
+  };
+
+  // Runs the dataflow over 'f'. For each node, the bitsets of its users are
+  // combined with 'meet' (a node with no users starts with the empty set),
+  // then 'transfer' is invoked with the node, its dense index, and the
+  // combined bitset to apply the node's own effect -- typically setting its
+  // own bit.
+  static BackwardBitsetDataflow Run(
+      FunctionBase* f, Meet meet,
+      const std::function<void(Node*, int64_t, InlineBitmap*)>& transfer);
+
+  // The number of nodes in the analyzed function.
+  int64_t node_count() const { return nodes_.size(); }
+
+  // The node with the given dense index.
+  Node* node(int64_t index) const { return nodes_[index]; }
+
+  // The dense index of the given node which must be in the analyzed function.
+  int64_t node_index(const Node* node) const { return node_index_.at(node); }
+
+  // The computed bitset for the given node. Bit i corresponds to the node
+  // with dense index i (see node()).
+  const InlineBitmap& bitmap(const Node* node) const {
+    return bitmaps_[node_index_.at(node)];
+  }
+
+ private:
+  // The function's nodes in reverse topological order; a node's dense index
+  // is its position in this vector.
+  std::vector<Node*> nodes_;
+  NodeMap<int64_t> node_index_;
+  // Indexed by dense node index.
+  std::vector<InlineBitmap> bitmaps_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_PASSES_BACKWARD_DATAFLOW_H_
@@ -0,0 +1,113 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/backward_dataflow.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+
+namespace xls {
+namespace {
+
+class BackwardDataflowTest : public IrTestBase {};
+
+// Returns the nodes whose bits are set in the bitset of 'node'.
+std::vector<Node*> SetNodes(const BackwardBitsetDataflow& dataflow,
+                            Node* node) {
+  std::vector<Node*> nodes;
+  const InlineBitmap& bitmap = dataflow.bitmap(node);
+  for (int64_t i = 0; i < dataflow.node_count(); ++i) {
+    if (bitmap.Get(i)) {
+      nodes.push_back(dataflow.node(i));
+    }
+  }
+  return nodes;
+}
+
+TEST_F(BackwardDataflowTest, IntersectionMeet) {
+  // With intersection meet and a transfer which sets the node's own bit, the
+  // computed sets are the post-dominators.
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(1));
+  BValue a = fb.Not(x);
+  BValue b = fb.Not(x);
+  BValue and_op = fb.And(a, b);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  BackwardBitsetDataflow dataflow = BackwardBitsetDataflow::Run(
+      f, BackwardBitsetDataflow::Meet::kIntersection,
+      [](Node* node, int64_t index, InlineBitmap* bitmap) {
+        bitmap->Set(index, true);
+      });
+
+  EXPECT_EQ(dataflow.node_count(), 4);
+  // x reaches the sink via both a and b, so only x itself and the and
+  // post-dominate it.
+  EXPECT_THAT(SetNodes(dataflow, x.node()),
+              testing::UnorderedElementsAre(x.node(), and_op.node()));
+  EXPECT_THAT(SetNodes(dataflow, a.node()),
+              testing::UnorderedElementsAre(a.node(), and_op.node()));
+  EXPECT_THAT(SetNodes(dataflow, and_op.node()),
+              testing::UnorderedElementsAre(and_op.node()));
+}
+
+TEST_F(BackwardDataflowTest, UnionMeet) {
+  // With union meet and a transfer which sets the node's own bit, the
+  // computed set of a node is all nodes reachable through its users.
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(1));
+  BValue a = fb.Not(x);
+  BValue b = fb.Not(x);
+  BValue and_op = fb.And(a, b);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  BackwardBitsetDataflow dataflow = BackwardBitsetDataflow::Run(
+      f, BackwardBitsetDataflow::Meet::kUnion,
+      [](Node* node, int64_t index, InlineBitmap* bitmap) {
+        bitmap->Set(index, true);
+      });
+
+  EXPECT_THAT(SetNodes(dataflow, x.node()),
+              testing::UnorderedElementsAre(x.node(), a.node(), b.node(),
+                                            and_op.node()));
+  EXPECT_THAT(SetNodes(dataflow, b.node()),
+              testing::UnorderedElementsAre(b.node(), and_op.node()));
+}
+
+TEST_F(BackwardDataflowTest, NodeIndices) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(1));
+  BValue y = fb.Not(x);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  BackwardBitsetDataflow dataflow = BackwardBitsetDataflow::Run(
+      f, BackwardBitsetDataflow::Meet::kIntersection,
+      [](Node* node, int64_t index, InlineBitmap* bitmap) {});
+
+  EXPECT_EQ(dataflow.node_count(), 2);
+  for (Node* node : f->nodes()) {
+    EXPECT_EQ(dataflow.node(dataflow.node_index(node)), node);
+  }
+  // In a reverse topological sort users precede their operands.
+  EXPECT_LT(dataflow.node_index(y.node()), dataflow.node_index(x.node()));
+}
+
+}  // namespace
+}  // namespace xls
@@ -14,7 +14,10 @@
 
 #include "xls/passes/bdd_cse_pass.h"
 
+#include <atomic>
 #include <memory>
+#include <thread>  // NOLINT(build/c++11): only for hardware_concurrency.
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -22,6 +25,8 @@
 #include "absl/status/statusor.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/math_util.h"
+#include "xls/common/thread.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/delay_model/delay_estimator.h"
@@ -29,6 +34,7 @@
 #include "xls/ir/node.h"
 #include "xls/ir/node_iterator.h"
 #include "xls/passes/bdd_function.h"
+#include "xls/passes/bdd_function_cache.h"
 
 namespace xls {
 
@@ -90,12 +96,21 @@ absl::StatusOr<std::vector<Node*>> GetNodeOrder(FunctionBase* f) {
   return nodes;
 }
 
+// Minimum number of candidate nodes before signature hashing is spread over
+// worker threads. Below this size thread startup costs more than the hashing.
+constexpr int64_t kParallelHashMinCandidates = 1024;
+
+// Number of candidate nodes hashed per unit of worker-thread work.
+constexpr int64_t kHashChunkSize = 256;
+
 }  // namespace
 
 absl::StatusOr<bool> BddCsePass::RunOnFunctionBaseInternal(
     FunctionBase* f, const PassOptions& options, PassResults* results) const {
-  XLS_ASSIGN_OR_RETURN(std::unique_ptr<BddFunction> bdd_function,
-                       BddFunction::Run(f, BddFunction::kDefaultPathLimit));
+  BddFunctionCache& bdd_cache = BddFunctionCache::Global();
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<BddFunction> bdd_function,
+      bdd_cache.TakeOrRun(f, path_limit_));
 
   // To improve efficiency, bucket potentially common nodes together. The
   // bucketing is done via a int64_t hash value of the BDD node indices of each
@@ -122,16 +137,59 @@ absl::StatusOr<bool> BddCsePass::RunOnFunctionBaseInternal(
     return true;
   };
 
-  bool changed = false;
-  absl::flat_hash_map<int64_t, std::vector<Node*>> node_buckets;
-  node_buckets.reserve(f->node_count());
   XLS_ASSIGN_OR_RETURN(std::vector<Node*> node_order, GetNodeOrder(f));
+
+  // Gather the CSE candidates in replacement order. Signature hashing only
+  // reads the BddFunction, so the hash of every candidate can be computed up
+  // front on worker threads. The replacement loop below mutates the graph and
+  // remains sequential.
+  std::vector<Node*> candidates;
   for (Node* node : node_order) {
-    if (!node->GetType()->IsBits() || node->Is<Literal>()) {
-      continue;
+    if (node->GetType()->IsBits() && !node->Is<Literal>()) {
+      candidates.push_back(node);
     }
+  }
+  const int64_t candidate_count = candidates.size();
+  std::vector<int64_t> hashes(candidate_count);
+  if (candidate_count >= kParallelHashMinCandidates) {
+    const int64_t num_chunks =
+        CeilOfRatio(candidate_count, kHashChunkSize);
+    const int64_t num_threads = std::min(
+        num_chunks,
+        std::max(int64_t{1},
+                 static_cast<int64_t>(std::thread::hardware_concurrency())));
+    std::atomic<int64_t> next_chunk{0};
+    std::vector<std::unique_ptr<Thread>> workers;
+    workers.reserve(num_threads);
+    for (int64_t i = 0; i < num_threads; ++i) {
+      workers.push_back(std::make_unique<Thread>([&]() {
+        int64_t chunk;
+        while ((chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) <
+               num_chunks) {
+          const int64_t begin = chunk * kHashChunkSize;
+          const int64_t end =
+              std::min(begin + kHashChunkSize, candidate_count);
+          for (int64_t j = begin; j < end; ++j) {
+            hashes[j] = node_hash(candidates[j]);
+          }
+        }
+      }));
+    }
+    for (std::unique_ptr<Thread>& worker : workers) {
+      worker->Join();
+    }
+  } else {
+    for (int64_t i = 0; i < candidate_count; ++i) {
+      hashes[i] = node_hash(candidates[i]);
+    }
+  }
 
-    int64_t hash = node_hash(node);
+  bool changed = false;
+  absl::flat_hash_map<int64_t, std::vector<Node*>> node_buckets;
+  node_buckets.reserve(f->node_count());
+  for (int64_t i = 0; i < candidate_count; ++i) {
+    Node* node = candidates[i];
+    const int64_t hash = hashes[i];
     if (!node_buckets.contains(hash)) {
       node_buckets[hash].push_back(node);
       continue;
@@ -153,6 +211,9 @@ absl::StatusOr<bool> BddCsePass::RunOnFunctionBaseInternal(
     }
   }
 
+  // Return the BddFunction to the cache for reuse by later BDD-based passes.
+  // The cache drops it if this pass changed the function.
+  bdd_cache.Release(std::move(bdd_function));
   return changed;
 }
 
@@ -17,23 +17,29 @@
 
 #include "absl/status/statusor.h"
 #include "xls/ir/function.h"
+#include "xls/passes/bdd_function.h"
 #include "xls/passes/passes.h"
 
 namespace xls {
 
 // Pass which commons equivalent expressions in the graph using binary decision
-// diagrams.
+// diagrams. 'path_limit' bounds the number of paths in the constructed BDDs;
+// expressions whose BDDs exceed the limit are not commoned.
 class BddCsePass : public FunctionBasePass {
  public:
-  explicit BddCsePass()
+  explicit BddCsePass(int64_t path_limit = BddFunction::kDefaultPathLimit)
       : FunctionBasePass("bdd_cse",
-                         "BDD-based Common Subexpression Elimination") {}
+                         "BDD-based Common Subexpression Elimination"),
+        path_limit_(path_limit) {}
   ~BddCsePass() override {}
 
  protected:
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
       FunctionBase* f, const PassOptions& options,
       PassResults* results) const override;
+
+ private:
+  int64_t path_limit_;
 };
 
 }  // namespace xls
@@ -14,9 +14,16 @@
 
 #include "xls/passes/bdd_function.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <thread>  // NOLINT(build/c++11): only for hardware_concurrency.
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/memory/memory.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
@@ -25,12 +32,14 @@
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/interpreter/ir_interpreter.h"
 #include "xls/ir/abstract_evaluator.h"
 #include "xls/ir/abstract_node_evaluator.h"
 #include "xls/ir/dfs_visitor.h"
 #include "xls/ir/node.h"
 #include "xls/ir/node_iterator.h"
+#include "xls/ir/ternary.h"
 
 namespace xls {
 namespace {
@@ -76,9 +85,14 @@ BddNodeVector ToBddNodeVector(const SaturatingBddNodeVector& input) {
   return result;
 }
 
-// The abstract evaluator based on a BDD with path-saturating logic.
+// The abstract evaluator based on a BDD with path-saturating logic. Scratch
+// vectors produced during evaluation use inline storage so that the
+// intermediate results of evaluating typical (narrow) operations do not touch
+// the heap.
 class SaturatingBddEvaluator
-    : public AbstractEvaluator<SaturatingBddNodeIndex, SaturatingBddEvaluator> {
+    : public AbstractEvaluator<
+          SaturatingBddNodeIndex, SaturatingBddEvaluator,
+          absl::InlinedVector<SaturatingBddNodeIndex, 64>> {
  public:
   SaturatingBddEvaluator(int64_t path_limit, BinaryDecisionDiagram* bdd)
       : path_limit_(path_limit), bdd_(bdd) {}
@@ -131,6 +145,11 @@ class SaturatingBddEvaluator
   BinaryDecisionDiagram* bdd_;
 };
 
+// Minimum number of BDD nodes before garbage collection is considered while
+// constructing a BddFunction. Collections below this size are not worth the
+// cost of compacting and remapping.
+constexpr int64_t kGcMinNodeCount = 1 << 20;
+
 // Returns whether the given op should be included in BDD computations.
 bool ShouldEvaluate(Node* node) {
   if (!node->GetType()->IsBits()) {
@@ -250,78 +269,328 @@ bool ShouldEvaluate(Node* node) {
   XLS_LOG(FATAL) << "Invalid op: " << static_cast<int64_t>(node->op());
 }
 
+// Returns whether the given node's bits are computed as BDD expressions of
+// its operands (as opposed to being modeled as fresh BDD variables).
+bool IsBddEvaluated(Node* node,
+                    const absl::flat_hash_set<Op>& do_not_evaluate_ops) {
+  return ShouldEvaluate(node) && !do_not_evaluate_ops.contains(node->op()) &&
+         std::none_of(node->operands().begin(), node->operands().end(),
+                      [](Node* o) { return !o->GetType()->IsBits(); });
+}
+
+// Minimum number of bits-typed nodes in a function before partitioning BDD
+// construction across worker threads is worth the thread and merge overhead.
+constexpr int64_t kParallelConeMinNodeCount = 256;
+
+// State for constructing the BDD expressions of a set of nodes. In
+// partitioned construction each independent fanin cone gets its own builder
+// (including its own BDD) on a worker thread and the per-cone BDDs are merged
+// into the BddFunction's BDD afterwards.
+struct ConeBuilder {
+  explicit ConeBuilder(int64_t path_limit) : evaluator(path_limit, &bdd) {}
+
+  BinaryDecisionDiagram bdd;
+  SaturatingBddEvaluator evaluator;
+  absl::flat_hash_map<Node*, SaturatingBddNodeVector> values;
+  absl::flat_hash_set<Node*> saturated_expressions;
+  int64_t last_gc_size = 0;
+  absl::Status status = absl::OkStatus();
+};
+
+// Discards BDD nodes which are not reachable from the expression of any bit
+// in the builder's value map. Evaluating a multi-bit operation can create
+// many intermediate BDD nodes which do not appear in any final expression;
+// collecting them bounds memory growth on control-heavy functions.
+// GarbageCollect compacts node storage, so the indices held in the value map
+// are remapped afterwards.
+void CollectGarbage(ConeBuilder* builder) {
+  std::vector<BddNodeIndex> roots;
+  for (const auto& pair : builder->values) {
+    for (const SaturatingBddNodeIndex& value : pair.second) {
+      if (absl::holds_alternative<BddNodeIndex>(value)) {
+        roots.push_back(absl::get<BddNodeIndex>(value));
+      }
+    }
+  }
+  std::vector<BddNodeIndex> remap = builder->bdd.GarbageCollect(roots);
+  for (auto& pair : builder->values) {
+    for (SaturatingBddNodeIndex& value : pair.second) {
+      if (absl::holds_alternative<BddNodeIndex>(value)) {
+        value = remap.at(absl::get<BddNodeIndex>(value).value());
+      }
+    }
+  }
+}
+
+// Builds the BDD expressions for the bits of 'node' in the given builder.
+// Nodes which are not BDD-evaluated, and bits which exceed the path limit,
+// are modeled as fresh BDD variables. Bits of 'node' with an entry in
+// 'seeds' which a prior analysis established as known are modeled as BDD
+// constants.
+absl::Status EvaluateNode(
+    Node* node, const absl::flat_hash_set<Op>& do_not_evaluate_ops,
+    const absl::flat_hash_map<Node*, TernaryVector>& seeds,
+    ConeBuilder* builder) {
+  // Create and return a vector containing newly defined BDD variables.
+  auto create_new_node_vector = [&](Node* n) {
+    SaturatingBddEvaluator::Vector v;
+    for (int64_t i = 0; i < n->BitCountOrDie(); ++i) {
+      v.push_back(builder->bdd.NewVariable());
+    }
+    builder->saturated_expressions.insert(n);
+    return v;
+  };
+
+  auto seed_it = seeds.find(node);
+  const TernaryVector* seed =
+      seed_it == seeds.end() ? nullptr : &seed_it->second;
+
+  if (!IsBddEvaluated(node, do_not_evaluate_ops)) {
+    if (seed == nullptr) {
+      SaturatingBddEvaluator::Vector v = create_new_node_vector(node);
+      builder->values[node].assign(v.begin(), v.end());
+    } else {
+      // Bits which the seed analysis knows become BDD constants; the
+      // remaining bits are modeled as fresh variables as usual.
+      SaturatingBddNodeVector v;
+      for (TernaryValue value : *seed) {
+        if (value == TernaryValue::kUnknown) {
+          v.push_back(builder->bdd.NewVariable());
+          builder->saturated_expressions.insert(node);
+        } else {
+          v.push_back(value == TernaryValue::kKnownOne ? builder->bdd.one()
+                                                       : builder->bdd.zero());
+        }
+      }
+      builder->values[node] = std::move(v);
+    }
+  } else {
+    // The evaluator's scratch vectors use inline storage; the long-lived value
+    // map holds plain std::vectors to avoid carrying the inline capacity in
+    // every map entry. Convert at the boundary.
+    std::vector<SaturatingBddEvaluator::Vector> operand_values;
+    for (Node* operand : node->operands()) {
+      const SaturatingBddNodeVector& operand_value =
+          builder->values.at(operand);
+      operand_values.emplace_back(operand_value.begin(), operand_value.end());
+    }
+    absl::StatusOr<SaturatingBddEvaluator::Vector> result =
+        seed == nullptr
+            ? AbstractEvaluate(node, operand_values, &builder->evaluator,
+                               /*default_handler=*/create_new_node_vector)
+            : AbstractEvaluateSeeded(
+                  node, operand_values, &builder->evaluator,
+                  /*default_handler=*/create_new_node_vector, *seed);
+    XLS_RETURN_IF_ERROR(result.status());
+    builder->values[node].assign(result->begin(), result->end());
+
+    // Associate a new BDD variable with each bit that exceeded the path
+    // limit.
+    for (SaturatingBddNodeIndex& value : builder->values.at(node)) {
+      if (absl::holds_alternative<TooManyPaths>(value)) {
+        builder->saturated_expressions.insert(node);
+        value = builder->bdd.NewVariable();
+      }
+    }
+  }
+  XLS_VLOG(5) << "  " << node->GetName() << ":";
+  for (int64_t i = 0; i < node->BitCountOrDie(); ++i) {
+    XLS_VLOG(5) << absl::StreamFormat(
+        "    bit %d : %s", i,
+        builder->bdd.ToStringDnf(
+            absl::get<BddNodeIndex>(builder->values.at(node)[i]),
+            /*minterm_limit=*/15));
+  }
+
+  // Collect garbage when the BDD has doubled in size since the last
+  // collection so GC cost stays amortized against construction cost.
+  if (builder->bdd.size() > kGcMinNodeCount &&
+      builder->bdd.size() > 2 * builder->last_gc_size) {
+    CollectGarbage(builder);
+    builder->last_gc_size = builder->bdd.size();
+  }
+  return absl::OkStatus();
+}
+
+// Partitions the given bits-typed nodes (in topological order) into
+// independent fanin cones: a BDD-evaluated node is placed in the same cone as
+// each of its operands, so distinct cones share no BDD-evaluated logic and
+// their expressions range over disjoint sets of BDD variables. The nodes
+// within each cone remain in topological order.
+std::vector<std::vector<Node*>> PartitionIntoCones(
+    absl::Span<Node* const> nodes,
+    const absl::flat_hash_set<Op>& do_not_evaluate_ops) {
+  absl::flat_hash_map<Node*, int64_t> node_id;
+  for (Node* node : nodes) {
+    node_id[node] = node_id.size();
+  }
+  // Union-find with path halving over node ids.
+  std::vector<int64_t> parent(nodes.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&](int64_t x) {
+    while (parent[x] != x) {
+      parent[x] = parent[parent[x]];
+      x = parent[x];
+    }
+    return x;
+  };
+  for (Node* node : nodes) {
+    if (!IsBddEvaluated(node, do_not_evaluate_ops)) {
+      continue;
+    }
+    for (Node* operand : node->operands()) {
+      parent[find(node_id.at(node))] = find(node_id.at(operand));
+    }
+  }
+  std::vector<std::vector<Node*>> cones;
+  absl::flat_hash_map<int64_t, int64_t> root_to_cone;
+  for (Node* node : nodes) {
+    int64_t root = find(node_id.at(node));
+    auto [it, inserted] = root_to_cone.insert({root, cones.size()});
+    if (inserted) {
+      cones.emplace_back();
+    }
+    cones[it->second].push_back(node);
+  }
+  return cones;
+}
+
 }  // namespace
 
 /* static */ absl::StatusOr<std::unique_ptr<BddFunction>> BddFunction::Run(
     FunctionBase* f, int64_t path_limit,
-    absl::Span<const Op> do_not_evaluate_ops) {
+    absl::Span<const Op> do_not_evaluate_ops, const QueryEngine* seed_engine) {
   XLS_VLOG(1) << absl::StreamFormat("BddFunction::Run(%s):", f->name());
   XLS_VLOG_LINES(5, f->DumpIr());
 
   auto bdd_function = absl::WrapUnique(new BddFunction(f));
-  SaturatingBddEvaluator evaluator(path_limit, &bdd_function->bdd());
+  bdd_function->path_limit_ = path_limit;
+  bdd_function->do_not_evaluate_ops_.assign(do_not_evaluate_ops.begin(),
+                                            do_not_evaluate_ops.end());
+  bdd_function->ir_transform_count_ = f->transform_count();
   absl::flat_hash_set<Op> do_not_evaluate_ops_set;
   for (Op op : do_not_evaluate_ops) {
     do_not_evaluate_ops_set.insert(op);
   }
 
-  // Create and return a vector containing newly defined BDD variables.
-  auto create_new_node_vector = [&](Node* n) {
-    SaturatingBddNodeVector v;
-    for (int64_t i = 0; i < n->BitCountOrDie(); ++i) {
-      v.push_back(bdd_function->bdd().NewVariable());
-    }
-    bdd_function->saturated_expressions_.insert(n);
-    return v;
-  };
-
-  XLS_VLOG(3) << "BDD expressions:";
-  absl::flat_hash_map<Node*, SaturatingBddNodeVector> values;
+  std::vector<Node*> bits_nodes;
   for (Node* node : TopoSort(f)) {
-    if (!node->GetType()->IsBits()) {
-      continue;
+    if (node->GetType()->IsBits()) {
+      bits_nodes.push_back(node);
     }
-    // If we shouldn't evaluate this node, the node is to be modeled as
-    // variables, or the node includes some non-bits-typed operands, then just
-    // create a vector of new BDD variables for this node.
-    if (!ShouldEvaluate(node) || do_not_evaluate_ops_set.contains(node->op()) ||
-        std::any_of(node->operands().begin(), node->operands().end(),
-                    [](Node* o) { return !o->GetType()->IsBits(); })) {
-      values[node] = create_new_node_vector(node);
-    } else {
-      std::vector<SaturatingBddNodeVector> operand_values;
-      for (Node* operand : node->operands()) {
-        operand_values.push_back(values.at(operand));
+  }
+
+  // Extract the seed engine's known bits up front: engines may memoize
+  // internally when queried, so queries are made serially here and worker
+  // threads below only read the resulting immutable map.
+  absl::flat_hash_map<Node*, TernaryVector> seeds;
+  if (seed_engine != nullptr) {
+    for (Node* node : bits_nodes) {
+      if (!seed_engine->IsTracked(node)) {
+        continue;
       }
-      XLS_ASSIGN_OR_RETURN(
-          values[node],
-          AbstractEvaluate(node, operand_values, &evaluator,
-                           /*default_handler=*/create_new_node_vector));
-
-      // Associate a new BDD variable with each bit that exceeded the path
-      // limit.
-      for (SaturatingBddNodeIndex& value : values.at(node)) {
-        if (absl::holds_alternative<TooManyPaths>(value)) {
-          bdd_function->saturated_expressions_.insert(node);
-          value = bdd_function->bdd().NewVariable();
-        }
+      TernaryVector ternary = seed_engine->GetTernary(node).Get({});
+      if (!ternary_ops::AllUnknown(ternary)) {
+        seeds.emplace(node, std::move(ternary));
       }
     }
-    XLS_VLOG(5) << "  " << node->GetName() << ":";
-    for (int64_t i = 0; i < node->BitCountOrDie(); ++i) {
-      XLS_VLOG(5) << absl::StreamFormat(
-          "    bit %d : %s", i,
-          bdd_function->bdd().ToStringDnf(
-              absl::get<BddNodeIndex>(values.at(node)[i]),
-              /*minterm_limit=*/15));
+  }
+
+  XLS_VLOG(3) << "BDD expressions:";
+  std::vector<std::vector<Node*>> cones =
+      PartitionIntoCones(bits_nodes, do_not_evaluate_ops_set);
+  std::vector<std::unique_ptr<ConeBuilder>> builders;
+  builders.reserve(cones.size());
+  for (int64_t i = 0; i < static_cast<int64_t>(cones.size()); ++i) {
+    builders.push_back(std::make_unique<ConeBuilder>(path_limit));
+  }
+
+  const bool partitioned =
+      cones.size() > 1 &&
+      static_cast<int64_t>(bits_nodes.size()) >= kParallelConeMinNodeCount;
+  if (partitioned) {
+    // Partitioned construction: the cones share no logic so each can be built
+    // in its own BDD on a worker thread. The per-cone BDDs are merged below.
+    const int64_t num_threads = std::min(
+        static_cast<int64_t>(cones.size()),
+        std::max(int64_t{1},
+                 static_cast<int64_t>(std::thread::hardware_concurrency())));
+    std::atomic<int64_t> next_cone{0};
+    std::vector<std::unique_ptr<Thread>> workers;
+    workers.reserve(num_threads);
+    for (int64_t i = 0; i < num_threads; ++i) {
+      workers.push_back(std::make_unique<Thread>([&]() {
+        int64_t cone_index;
+        while ((cone_index = next_cone.fetch_add(
+                    1, std::memory_order_relaxed)) <
+               static_cast<int64_t>(cones.size())) {
+          ConeBuilder& builder = *builders[cone_index];
+          for (Node* node : cones[cone_index]) {
+            builder.status =
+                EvaluateNode(node, do_not_evaluate_ops_set, seeds, &builder);
+            if (!builder.status.ok()) {
+              break;
+            }
+          }
+          if (builder.status.ok()) {
+            // Compact the cone's BDD so only live nodes are merged.
+            CollectGarbage(&builder);
+          }
+        }
+      }));
+    }
+    for (std::unique_ptr<Thread>& worker : workers) {
+      worker->Join();
+    }
+    for (const std::unique_ptr<ConeBuilder>& builder : builders) {
+      XLS_RETURN_IF_ERROR(builder->status);
+    }
+  } else {
+    // Serial construction: build all cones in the first builder's BDD.
+    ConeBuilder& builder = *builders.front();
+    for (Node* node : bits_nodes) {
+      XLS_RETURN_IF_ERROR(
+          EvaluateNode(node, do_not_evaluate_ops_set, seeds, &builder));
+    }
+    // Final collection to drop intermediate nodes created since the last
+    // in-loop collection.
+    if (builder.bdd.size() > kGcMinNodeCount) {
+      CollectGarbage(&builder);
     }
+    // Everything was built directly in one BDD; adopt it without the merge
+    // translation below. At this point any TooManyPaths sentinel values have
+    // been replaced with new BDD variables.
+    bdd_function->bdd_ = std::move(builder.bdd);
+    for (const auto& pair : builder.values) {
+      bdd_function->node_map_[pair.first] = ToBddNodeVector(pair.second);
+    }
+    bdd_function->saturated_expressions_ =
+        std::move(builder.saturated_expressions);
+    return std::move(bdd_function);
   }
 
-  // Copy over the vector and BDD variables into the node map which is exposed
-  // via the BddFunction interface. At this point any TooManyPaths sentinel
-  // values have been replaced with new Bdd variables.
-  for (const auto& pair : values) {
-    bdd_function->node_map_[pair.first] = ToBddNodeVector(pair.second);
+  // Merge the per-builder BDDs and value maps into the BddFunction. Each
+  // builder's variables are assigned a contiguous block of variables in the
+  // merged BDD; within a block the relative variable order is unchanged so
+  // the imported expressions remain canonical. At this point any TooManyPaths
+  // sentinel values have been replaced with new BDD variables.
+  for (const std::unique_ptr<ConeBuilder>& builder : builders) {
+    BddVariable variable_offset(bdd_function->bdd().variable_count());
+    for (int64_t v = 0; v < builder->bdd.variable_count(); ++v) {
+      bdd_function->bdd().NewVariable();
+    }
+    std::vector<BddNodeIndex> translation =
+        bdd_function->bdd().ImportExpressions(builder->bdd, variable_offset);
+    for (const auto& pair : builder->values) {
+      BddNodeVector bdd_vector = ToBddNodeVector(pair.second);
+      for (BddNodeIndex& index : bdd_vector) {
+        index = translation.at(index.value());
+      }
+      bdd_function->node_map_[pair.first] = std::move(bdd_vector);
+    }
+    bdd_function->saturated_expressions_.insert(
+        builder->saturated_expressions.begin(),
+        builder->saturated_expressions.end());
   }
   return std::move(bdd_function);
 }
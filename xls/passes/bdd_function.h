@@ -15,18 +15,19 @@
 #ifndef XLS_PASSES_BDD_FUNCTION_H_
 #define XLS_PASSES_BDD_FUNCTION_H_
 
-#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "xls/common/logging/logging.h"
 #include "xls/data_structures/binary_decision_diagram.h"
 #include "xls/data_structures/leaf_type_tree.h"
 #include "xls/ir/function.h"
+#include "xls/ir/node_map.h"
 #include "xls/ir/op.h"
+#include "xls/passes/query_engine.h"
 
 namespace xls {
 
 using BddNodeVector = std::vector<BddNodeIndex>;
-using NodeMap = absl::flat_hash_map<const Node*, BddNodeVector>;
 
 // A class which represents an XLS function using a binary decision diagram
 // (BDD). The BDD is constructed by an abstract evaluation of the operations in
@@ -52,14 +53,38 @@ class BddFunction {
   // 'do_not_evaluate_ops', its bits are modeled as BDD variables. Otherwise,
   // bits are represented as BDD nodes whose values are determined by the values
   // of other BDD nodes.
+  //
+  // If 'seed_engine' is non-null, bits which the engine has already
+  // established as known are modeled as BDD constants rather than
+  // re-derived (or modeled as variables, for bits of nodes which are not
+  // BDD-evaluated). This refines the prior analysis instead of recomputing
+  // it: expressions downstream of the seeded constants fold away in the
+  // BDD. The engine must already be populated for 'f' and is only queried
+  // during construction.
   static absl::StatusOr<std::unique_ptr<BddFunction>> Run(
       FunctionBase* f, int64_t path_limit = 0,
-      absl::Span<const Op> do_not_evaluate_ops = {});
+      absl::Span<const Op> do_not_evaluate_ops = {},
+      const QueryEngine* seed_engine = nullptr);
 
   // Returns the underlying BDD.
   const BinaryDecisionDiagram& bdd() const { return bdd_; }
   BinaryDecisionDiagram& bdd() { return bdd_; }
 
+  // Returns the function/proc this BddFunction was built from.
+  FunctionBase* function_base() const { return func_base_; }
+
+  // Returns the parameters this BddFunction was built with.
+  int64_t path_limit() const { return path_limit_; }
+  absl::Span<const Op> do_not_evaluate_ops() const {
+    return do_not_evaluate_ops_;
+  }
+
+  // Returns the value of function_base()->transform_count() at the time this
+  // BddFunction was built. If it no longer matches the function's current
+  // transform count then the function has been restructured and this
+  // BddFunction may not reflect the IR.
+  int64_t ir_transform_count() const { return ir_transform_count_; }
+
   // Returns the node associated with the given bit.
   BddNodeIndex GetBddNode(Node* node, int64_t bit_index) const {
     XLS_CHECK(node->GetType()->IsBits());
@@ -79,9 +104,17 @@ class BddFunction {
   FunctionBase* func_base_;
   BinaryDecisionDiagram bdd_;
 
+  // Parameters passed to Run() and the transform count of the function when
+  // this object was built. Used by BddFunctionCache to decide whether a cached
+  // BddFunction can be reused.
+  int64_t path_limit_ = 0;
+  std::vector<Op> do_not_evaluate_ops_;
+  int64_t ir_transform_count_ = 0;
+
   // A map from XLS Node to vector of BDD nodes representing the XLS Node's
-  // expression.
-  NodeMap node_map_;
+  // expression. Node-id indexed (NodeMap) as query engines perform a lookup
+  // per queried bit.
+  NodeMap<BddNodeVector> node_map_;
 
   // Set containing the Nodes which have exceeded the maximum number of paths
   // from the XLS node's BDD node to the terminal nodes 0 and 1 in the
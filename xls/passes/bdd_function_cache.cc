@@ -0,0 +1,79 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/bdd_function_cache.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/synchronization/mutex.h"
+#include "xls/common/logging/logging.h"
+#include "xls/ir/function_base.h"
+
+namespace xls {
+
+absl::StatusOr<std::unique_ptr<BddFunction>> BddFunctionCache::TakeOrRun(
+    FunctionBase* f, int64_t path_limit,
+    absl::Span<const Op> do_not_evaluate_ops) {
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = cache_.find(f);
+    if (it != cache_.end()) {
+      std::unique_ptr<BddFunction> cached = std::move(it->second);
+      cache_.erase(it);
+      if (cached->ir_transform_count() == f->transform_count() &&
+          cached->path_limit() == path_limit &&
+          cached->do_not_evaluate_ops() == do_not_evaluate_ops) {
+        XLS_VLOG(3) << "Reusing cached BddFunction for " << f->name();
+        return std::move(cached);
+      }
+      // The entry is stale or was built with different parameters. It has
+      // been removed from the cache; fall through and rebuild.
+    }
+  }
+  return BddFunction::Run(f, path_limit, do_not_evaluate_ops);
+}
+
+void BddFunctionCache::Release(std::unique_ptr<BddFunction> bdd_function) {
+  if (bdd_function == nullptr) {
+    return;
+  }
+  FunctionBase* f = bdd_function->function_base();
+  if (bdd_function->ir_transform_count() != f->transform_count()) {
+    // The function was restructured after the BddFunction was built so the
+    // BDD no longer reflects the IR. Drop the object.
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  cache_[f] = std::move(bdd_function);
+}
+
+void BddFunctionCache::Evict(FunctionBase* f) {
+  absl::MutexLock lock(&mutex_);
+  cache_.erase(f);
+}
+
+/* static */ BddFunctionCache& BddFunctionCache::Global() {
+  static BddFunctionCache* cache = []() {
+    auto* c = new BddFunctionCache;
+    // Evict entries as their function is destroyed so a later function
+    // reusing the address can never hit them.
+    FunctionBase::RegisterDestructionObserver(
+        [](FunctionBase* f) { BddFunctionCache::Global().Evict(f); });
+    return c;
+  }();
+  return *cache;
+}
+
+}  // namespace xls
@@ -0,0 +1,83 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_PASSES_BDD_FUNCTION_CACHE_H_
+#define XLS_PASSES_BDD_FUNCTION_CACHE_H_
+
+#include <memory>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/passes/bdd_function.h"
+
+namespace xls {
+
+// A cache of BddFunctions which persists across pass invocations.
+// Constructing the BDD for a function from scratch dominates the cost of the
+// BDD-based passes, and the standard pipeline runs these passes several times.
+// When a function has not been restructured (FunctionBase::transform_count)
+// since its BddFunction was built, the cached object can be reused directly
+// instead of rebuilt.
+//
+// Entries are handed out with checkout semantics: TakeOrRun removes the entry
+// from the cache and transfers ownership to the caller, and Release returns
+// it. This keeps each BddFunction exclusively owned while in use (BDD queries
+// mutate the underlying diagram), so the cache is safe to share between
+// concurrently executing passes (see
+// PassOptions::parallel_function_base_passes).
+//
+// The Global() instance evicts entries when their FunctionBase is destroyed
+// (via a FunctionBase destruction observer). A locally constructed instance
+// has no such hook and must therefore be destroyed before the functions whose
+// entries it holds.
+class BddFunctionCache {
+ public:
+  // Returns a BddFunction for 'f' built with the given parameters: the cached
+  // one if 'f' has not been restructured since it was built with matching
+  // parameters, otherwise a freshly constructed one. Ownership transfers to
+  // the caller; pass the object back via Release when done with it.
+  absl::StatusOr<std::unique_ptr<BddFunction>> TakeOrRun(
+      FunctionBase* f, int64_t path_limit = 0,
+      absl::Span<const Op> do_not_evaluate_ops = {});
+
+  // Returns a BddFunction obtained from TakeOrRun to the cache for later
+  // reuse. The object is discarded if its function was restructured after the
+  // BddFunction was built as the BDD no longer reflects the IR.
+  void Release(std::unique_ptr<BddFunction> bdd_function);
+
+  // Drops any cached entry for 'f'. Must be called when 'f' is destroyed:
+  // entries are keyed by pointer, so without eviction a new function reusing
+  // the heap address could be handed a BddFunction full of dangling Node*,
+  // and entries for dead functions would accumulate for the life of the
+  // process.
+  void Evict(FunctionBase* f);
+
+  // Process-wide cache shared by the BDD-based passes. Entries are keyed by
+  // FunctionBase pointer and validated against the function's current
+  // transform count; a FunctionBase destruction observer evicts entries when
+  // their function is destroyed, so a stale entry can never be returned for a
+  // reused address.
+  static BddFunctionCache& Global();
+
+ private:
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<FunctionBase*, std::unique_ptr<BddFunction>> cache_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace xls
+
+#endif  // XLS_PASSES_BDD_FUNCTION_CACHE_H_
@@ -0,0 +1,112 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/bdd_function_cache.h"
+
+#include <memory>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/package.h"
+
+namespace xls {
+namespace {
+
+class BddFunctionCacheTest : public IrTestBase {};
+
+TEST_F(BddFunctionCacheTest, ReuseAndInvalidation) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  Type* t = p->GetBitsType(8);
+  fb.Or(fb.Param("x", t), fb.Param("y", t));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  BddFunctionCache cache;
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BddFunction> bdd_function,
+                           cache.TakeOrRun(f));
+  BddFunction* original = bdd_function.get();
+  cache.Release(std::move(bdd_function));
+
+  // Checking out again with matching parameters returns the same object.
+  XLS_ASSERT_OK_AND_ASSIGN(bdd_function, cache.TakeOrRun(f));
+  EXPECT_EQ(bdd_function.get(), original);
+  cache.Release(std::move(bdd_function));
+
+  // Different construction parameters force a rebuild.
+  XLS_ASSERT_OK_AND_ASSIGN(bdd_function,
+                           cache.TakeOrRun(f, BddFunction::kDefaultPathLimit));
+  EXPECT_NE(bdd_function.get(), original);
+  cache.Release(std::move(bdd_function));
+}
+
+TEST_F(BddFunctionCacheTest, StaleEntriesAreDropped) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  Type* t = p->GetBitsType(8);
+  fb.And(fb.Param("x", t), fb.Param("y", t));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  BddFunctionCache cache;
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BddFunction> bdd_function,
+                           cache.TakeOrRun(f));
+  BddFunction* original = bdd_function.get();
+  cache.Release(std::move(bdd_function));
+
+  // Restructuring the function invalidates the cached entry.
+  XLS_ASSERT_OK(
+      f->MakeNode<Literal>(/*loc=*/absl::nullopt, Value(UBits(0, 8))).status());
+  XLS_ASSERT_OK_AND_ASSIGN(bdd_function, cache.TakeOrRun(f));
+  EXPECT_NE(bdd_function.get(), original);
+
+  // Releasing an object built before a subsequent restructuring drops it.
+  BddFunction* rebuilt = bdd_function.get();
+  XLS_ASSERT_OK(
+      f->MakeNode<Literal>(/*loc=*/absl::nullopt, Value(UBits(1, 8))).status());
+  cache.Release(std::move(bdd_function));
+  XLS_ASSERT_OK_AND_ASSIGN(bdd_function, cache.TakeOrRun(f));
+  EXPECT_NE(bdd_function.get(), rebuilt);
+}
+
+TEST_F(BddFunctionCacheTest, GlobalEntriesEvictedOnFunctionDestruction) {
+  // Populate the global cache with an entry, then destroy the package. The
+  // destruction observer must evict the entry so a later function reusing the
+  // heap address cannot hit it; a regression here shows up as a stale (and
+  // under sanitizers, dangling) BddFunction below.
+  {
+    auto p = CreatePackage();
+    FunctionBuilder fb(TestName(), p.get());
+    Type* t = p->GetBitsType(8);
+    fb.Or(fb.Param("x", t), fb.Param("y", t));
+    XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+    XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BddFunction> bdd_function,
+                             BddFunctionCache::Global().TakeOrRun(f));
+    BddFunctionCache::Global().Release(std::move(bdd_function));
+  }
+
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  Type* t = p->GetBitsType(8);
+  fb.And(fb.Param("x", t), fb.Param("y", t));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * g, fb.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BddFunction> bdd_function,
+                           BddFunctionCache::Global().TakeOrRun(g));
+  EXPECT_EQ(bdd_function->function_base(), g);
+  BddFunctionCache::Global().Release(std::move(bdd_function));
+}
+
+}  // namespace
+}  // namespace xls
@@ -50,6 +50,33 @@ TEST_F(BddFunctionTest, SimpleOr) {
               IsOkAndHolds(Value(UBits(0b11111010, 8))));
 }
 
+TEST_F(BddFunctionTest, PartitionedConstruction) {
+  // A function with two independent fanin cones (joined only by the non-bits
+  // tuple return value) and enough nodes to trigger partitioned BDD
+  // construction on worker threads.
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  Type* t = p->GetBitsType(16);
+  BValue x = fb.Param("x", t);
+  BValue y = fb.Param("y", t);
+  BValue a = x;
+  BValue b = y;
+  for (int64_t i = 0; i < 150; ++i) {
+    a = fb.Not(a);
+    b = fb.Xor(b, y);
+  }
+  fb.Tuple({a, b});
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BddFunction> bdd_function,
+                           BddFunction::Run(f));
+  // An even number of inversions yields x; an even number of XORs with y
+  // yields y.
+  EXPECT_THAT(bdd_function->Evaluate(
+                  {Value(UBits(0x1234, 16)), Value(UBits(0xabcd, 16))}),
+              IsOkAndHolds(Value::Tuple(
+                  {Value(UBits(0x1234, 16)), Value(UBits(0xabcd, 16))})));
+}
+
 TEST_F(BddFunctionTest, JustAParam) {
   auto p = CreatePackage();
   FunctionBuilder fb(TestName(), p.get());
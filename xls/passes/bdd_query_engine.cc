@@ -14,6 +14,8 @@
 
 #include "xls/passes/bdd_query_engine.h"
 
+#include <utility>
+
 #include "absl/status/statusor.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
@@ -26,9 +28,28 @@
 
 namespace xls {
 
+BddQueryEngine::~BddQueryEngine() {
+  // Seeded BddFunctions are never released to the cache; see Populate.
+  if (cache_ != nullptr && seed_engine_ == nullptr &&
+      bdd_function_ != nullptr) {
+    cache_->Release(std::move(bdd_function_));
+  }
+}
+
 absl::StatusOr<ReachedFixpoint> BddQueryEngine::Populate(FunctionBase* f) {
-  XLS_ASSIGN_OR_RETURN(bdd_function_,
-                       BddFunction::Run(f, path_limit_, do_not_evaluate_ops_));
+  if (cache_ != nullptr && seed_engine_ == nullptr) {
+    // Return any previously held BddFunction before checking out another.
+    cache_->Release(std::move(bdd_function_));
+    XLS_ASSIGN_OR_RETURN(bdd_function_,
+                         cache_->TakeOrRun(f, path_limit_,
+                                           do_not_evaluate_ops_));
+  } else {
+    // Seeded construction bypasses the cache: cached BddFunctions are built
+    // without seeds and do not reflect the seed engine's known bits.
+    XLS_ASSIGN_OR_RETURN(bdd_function_,
+                         BddFunction::Run(f, path_limit_, do_not_evaluate_ops_,
+                                          seed_engine_));
+  }
   // Construct the Bits objects indication which bit values are statically known
   // for each node and what those values are (0 or 1) if known.
   BinaryDecisionDiagram& bdd = this->bdd();
@@ -23,6 +23,7 @@
 #include "xls/ir/function.h"
 #include "xls/ir/nodes.h"
 #include "xls/passes/bdd_function.h"
+#include "xls/passes/bdd_function_cache.h"
 #include "xls/passes/query_engine.h"
 
 namespace xls {
@@ -39,12 +40,25 @@ class BddQueryEngine : public QueryEngine {
   // 'path_limit' is the maximum number of paths from the BDD node to the
   // terminals 0 and 1 to allow for a BDD expression before truncating it. If a
   // node's op is in 'do_not_evaluate_ops', its bits are modeled as BDD
-  // variables. See BddFunction for details.
+  // variables. See BddFunction for details. If 'cache' is non-null, the
+  // underlying BddFunction is checked out of the cache (avoiding a rebuild if
+  // the function is unchanged since the cached one was built) and returned to
+  // it when the engine is destroyed. If 'seed_engine' is non-null, bits which
+  // that (already populated) engine knows are modeled as BDD constants so this
+  // engine refines the prior analysis rather than recomputing it; seeded
+  // construction bypasses the cache as cached BddFunctions are built without
+  // seeds.
   explicit BddQueryEngine(int64_t path_limit = 0,
-                          absl::Span<const Op> do_not_evaluate_ops = {})
+                          absl::Span<const Op> do_not_evaluate_ops = {},
+                          BddFunctionCache* cache = nullptr,
+                          const QueryEngine* seed_engine = nullptr)
       : path_limit_(path_limit),
         do_not_evaluate_ops_(do_not_evaluate_ops.begin(),
-                             do_not_evaluate_ops.end()) {}
+                             do_not_evaluate_ops.end()),
+        cache_(cache),
+        seed_engine_(seed_engine) {}
+
+  ~BddQueryEngine() override;
 
   absl::StatusOr<ReachedFixpoint> Populate(FunctionBase* f) override;
 
@@ -109,6 +123,14 @@ class BddQueryEngine : public QueryEngine {
   // See BddFunction for details.
   std::vector<Op> do_not_evaluate_ops_;
 
+  // Cache which bdd_function_ is checked out of and released back to. May be
+  // null in which case the BddFunction is always built from scratch.
+  BddFunctionCache* cache_;
+
+  // Previously populated engine whose known bits seed the BddFunction as
+  // constants. May be null in which case no seeding is performed.
+  const QueryEngine* seed_engine_;
+
   // Indicates the bits at the output of each node which have known values.
   absl::flat_hash_map<Node*, Bits> known_bits_;
 
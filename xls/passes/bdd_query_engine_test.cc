@@ -26,6 +26,7 @@
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_test_base.h"
 #include "xls/ir/package.h"
+#include "xls/passes/ternary_query_engine.h"
 
 namespace xls {
 namespace {
@@ -274,6 +275,32 @@ TEST_F(BddQueryEngineTest, ForceNodeToBeModeledAsVariable) {
       KnownEquals(query_engine_empty_op_set, orop.node(), my_zero.node()));
 }
 
+TEST_F(BddQueryEngineTest, SeedEngineRefinesUnevaluatedNodes) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(8));
+  BValue mul = fb.UMul(x, fb.Literal(UBits(0, 8)));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  // With multiplies excluded from BDD evaluation the product's bits are
+  // modeled as variables so nothing is known about them.
+  BddQueryEngine unseeded(/*path_limit=*/0, {Op::kUMul});
+  XLS_ASSERT_OK(unseeded.Populate(f).status());
+  EXPECT_FALSE(unseeded.AllBitsKnown(mul.node()));
+
+  // Ternary analysis knows the product is zero. Seeding the BDD engine with
+  // the ternary engine's results carries that knowledge over even though the
+  // multiply is still not BDD-evaluated.
+  TernaryQueryEngine ternary;
+  XLS_ASSERT_OK(ternary.Populate(f).status());
+  ASSERT_TRUE(ternary.IsAllZeros(mul.node()));
+
+  BddQueryEngine seeded(/*path_limit=*/0, {Op::kUMul},
+                        /*cache=*/nullptr, &ternary);
+  XLS_ASSERT_OK(seeded.Populate(f).status());
+  EXPECT_TRUE(seeded.IsAllZeros(mul.node()));
+}
+
 TEST_F(BddQueryEngineTest, BitValuesImplyNodeValuePredicateAlwaysFalse) {
   auto p = CreatePackage();
   FunctionBuilder fb(TestName(), p.get());
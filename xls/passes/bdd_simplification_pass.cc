@@ -33,6 +33,7 @@
 #include "xls/ir/node.h"
 #include "xls/ir/node_iterator.h"
 #include "xls/ir/nodes.h"
+#include "xls/passes/bdd_function_cache.h"
 #include "xls/passes/bdd_query_engine.h"
 #include "xls/passes/post_dominator_analysis.h"
 #include "xls/passes/query_engine.h"
@@ -324,7 +325,9 @@ absl::StatusOr<bool> SimplifyNode(Node* node, const QueryEngine& query_engine,
 
 absl::StatusOr<bool> BddSimplificationPass::RunOnFunctionBaseInternal(
     FunctionBase* f, const PassOptions& options, PassResults* results) const {
-  BddQueryEngine query_engine(BddFunction::kDefaultPathLimit);
+  BddQueryEngine query_engine(path_limit_,
+                              /*do_not_evaluate_ops=*/{},
+                              &BddFunctionCache::Global());
   XLS_RETURN_IF_ERROR(query_engine.Populate(f).status());
 
   bool modified = false;
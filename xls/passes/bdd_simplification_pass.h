@@ -17,6 +17,7 @@
 
 #include "absl/status/statusor.h"
 #include "xls/ir/function.h"
+#include "xls/passes/bdd_function.h"
 #include "xls/passes/passes.h"
 
 namespace xls {
@@ -27,9 +28,13 @@ namespace xls {
 // TODO(meheff): Add more BDD-based optimizations.
 class BddSimplificationPass : public FunctionBasePass {
  public:
-  explicit BddSimplificationPass(int64_t opt_level)
+  // 'path_limit' bounds the number of paths in the constructed BDDs; bits
+  // whose BDDs exceed the limit are treated as unknown.
+  explicit BddSimplificationPass(
+      int64_t opt_level, int64_t path_limit = BddFunction::kDefaultPathLimit)
       : FunctionBasePass("bdd_simp", "BDD-based Simplification"),
-        opt_level_(opt_level) {}
+        opt_level_(opt_level),
+        path_limit_(path_limit) {}
   ~BddSimplificationPass() override {}
 
  protected:
@@ -40,6 +45,7 @@ class BddSimplificationPass : public FunctionBasePass {
 
  private:
   int64_t opt_level_;
+  int64_t path_limit_;
 };
 
 }  // namespace xls
@@ -15,10 +15,13 @@
 #include "xls/passes/cse_pass.h"
 
 #include "absl/hash/hash.h"
+#include "absl/numeric/int128.h"
 #include "absl/status/statusor.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/node_iterator.h"
+#include "xls/ir/nodes.h"
 #include "xls/ir/op.h"
+#include "xls/ir/value.h"
 
 namespace xls {
 
@@ -62,8 +65,16 @@ absl::StatusOr<bool> CsePass::RunOnFunctionBaseInternal(
     for (Node* operand : GetOperandsForCse(n, &span_backing_store)) {
       values_to_hash.push_back(operand->id());
     }
-    // If this is slow because of many literals, the Literal values could be
-    // combined into the hash. As is, all literals get the same hash value.
+    // Combine the payload of literals into the hash so each distinct constant
+    // gets its own bucket. Otherwise all literals hash identically and
+    // literal-heavy graphs (e.g. after unrolling) degrade to quadratic
+    // bucket scans. The payload fingerprint is folded into the structural
+    // fingerprint which is cached on the node, so the value is not re-hashed
+    // on every pass run.
+    if (n->Is<Literal>()) {
+      values_to_hash.push_back(
+          static_cast<int64_t>(absl::Uint128Low64(n->StructuralFingerprint())));
+    }
     return hasher(values_to_hash);
   };
 
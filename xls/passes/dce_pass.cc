@@ -19,6 +19,7 @@
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/dfs_visitor.h"
 #include "xls/ir/node_iterator.h"
+#include "xls/ir/node_util.h"
 #include "xls/ir/op.h"
 #include "xls/ir/type.h"
 
@@ -26,38 +27,7 @@ namespace xls {
 
 absl::StatusOr<bool> DeadCodeEliminationPass::RunOnFunctionBaseInternal(
     FunctionBase* f, const PassOptions& options, PassResults* results) const {
-  auto is_deletable = [](Node* n) {
-    return !n->function_base()->HasImplicitUse(n) &&
-           !OpIsSideEffecting(n->op());
-  };
-
-  std::deque<Node*> worklist;
-  for (Node* n : f->nodes()) {
-    if (n->users().empty() && is_deletable(n)) {
-      worklist.push_back(n);
-    }
-  }
-  int64_t removed_count = 0;
-  absl::flat_hash_set<Node*> unique_operands;
-  while (!worklist.empty()) {
-    Node* node = worklist.front();
-    worklist.pop_front();
-
-    // A node may appear more than once as an operand of 'node'. Keep track of
-    // which operands have been handled in a set.
-    unique_operands.clear();
-    for (Node* operand : node->operands()) {
-      if (unique_operands.insert(operand).second) {
-        if (operand->users().size() == 1 && is_deletable(operand)) {
-          worklist.push_back(operand);
-        }
-      }
-    }
-    XLS_VLOG(3) << "DCE removing " << node->ToString();
-    XLS_RETURN_IF_ERROR(f->RemoveNode(node));
-    removed_count++;
-  }
-
+  XLS_ASSIGN_OR_RETURN(int64_t removed_count, RemoveDeadNodes(f));
   XLS_VLOG(2) << "Removed " << removed_count << " dead nodes";
   return removed_count > 0;
 }
@@ -0,0 +1,133 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/dead_proc_elimination_pass.h"
+
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "xls/common/logging/logging.h"
+#include "xls/ir/channel.h"
+
+namespace xls {
+namespace {
+
+// Returns whether the node has an effect observable outside the package
+// other than channel communication (which is handled by channel liveness).
+bool IsObservablySideEffecting(Node* node) {
+  return node->Is<Assert>() || node->Is<Cover>() || node->Is<Trace>();
+}
+
+}  // namespace
+
+absl::StatusOr<bool> DeadProcEliminationPass::RunInternal(
+    Package* p, const PassOptions& options, PassResults* results) const {
+  if (p->procs().empty()) {
+    return false;
+  }
+
+  // Map each channel id to the procs which communicate on it, and seed the
+  // worklist with the procs whose effects are externally observable.
+  absl::flat_hash_map<int64_t, std::vector<Proc*>> senders;
+  absl::flat_hash_map<int64_t, std::vector<Proc*>> receivers;
+  absl::flat_hash_set<Proc*> live;
+  std::vector<Proc*> worklist;
+  for (const std::unique_ptr<Proc>& proc : p->procs()) {
+    bool is_live = false;
+    for (Node* node : proc->nodes()) {
+      if (node->Is<Send>()) {
+        int64_t channel_id = node->As<Send>()->channel_id();
+        senders[channel_id].push_back(proc.get());
+        XLS_ASSIGN_OR_RETURN(Channel * channel, p->GetChannel(channel_id));
+        // Data sent on a send-only channel is consumed outside the package.
+        if (channel->supported_ops() == ChannelOps::kSendOnly) {
+          is_live = true;
+        }
+      } else if (node->Is<Receive>()) {
+        receivers[node->As<Receive>()->channel_id()].push_back(proc.get());
+      } else if (IsObservablySideEffecting(node)) {
+        is_live = true;
+      }
+    }
+    if (is_live) {
+      live.insert(proc.get());
+      worklist.push_back(proc.get());
+    }
+  }
+
+  // A live proc keeps its communication partners alive in both directions:
+  // the producers of everything it receives, and the consumers of everything
+  // it sends on package-internal (send_receive) channels. The latter matters
+  // for validity, not just conservatism -- every send_receive channel must
+  // retain its receive node -- so a live producer's otherwise-dead consumer
+  // cannot be removed in isolation.
+  while (!worklist.empty()) {
+    Proc* proc = worklist.back();
+    worklist.pop_back();
+    for (Node* node : proc->nodes()) {
+      if (node->Is<Receive>()) {
+        for (Proc* sender : senders[node->As<Receive>()->channel_id()]) {
+          if (live.insert(sender).second) {
+            worklist.push_back(sender);
+          }
+        }
+      } else if (node->Is<Send>()) {
+        for (Proc* receiver : receivers[node->As<Send>()->channel_id()]) {
+          if (live.insert(receiver).second) {
+            worklist.push_back(receiver);
+          }
+        }
+      }
+    }
+  }
+
+  std::vector<Proc*> to_unlink;
+  for (const std::unique_ptr<Proc>& proc : p->procs()) {
+    if (!live.contains(proc.get())) {
+      XLS_VLOG(2) << "Dead Proc Elimination: " << proc->name();
+      to_unlink.push_back(proc.get());
+    }
+  }
+  for (Proc* proc : to_unlink) {
+    XLS_RETURN_IF_ERROR(p->RemoveProc(proc));
+  }
+
+  // Remove channels which no remaining proc communicates on.
+  absl::flat_hash_set<int64_t> used_channels;
+  for (const std::unique_ptr<Proc>& proc : p->procs()) {
+    for (Node* node : proc->nodes()) {
+      if (node->Is<Send>()) {
+        used_channels.insert(node->As<Send>()->channel_id());
+      } else if (node->Is<Receive>()) {
+        used_channels.insert(node->As<Receive>()->channel_id());
+      }
+    }
+  }
+  std::vector<Channel*> dead_channels;
+  for (Channel* channel : p->channels()) {
+    if (!used_channels.contains(channel->id())) {
+      dead_channels.push_back(channel);
+    }
+  }
+  for (Channel* channel : dead_channels) {
+    XLS_VLOG(2) << "Dead Channel Elimination: " << channel->name();
+    XLS_RETURN_IF_ERROR(p->RemoveChannel(channel));
+  }
+
+  return !to_unlink.empty() || !dead_channels.empty();
+}
+
+}  // namespace xls
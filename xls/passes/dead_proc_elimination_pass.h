@@ -0,0 +1,45 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Dead Proc (and channel) Elimination.
+//
+#ifndef XLS_PASSES_DEAD_PROC_ELIMINATION_PASS_H_
+#define XLS_PASSES_DEAD_PROC_ELIMINATION_PASS_H_
+
+#include "absl/status/statusor.h"
+#include "xls/passes/passes.h"
+
+namespace xls {
+
+// Removes procs which cannot affect anything observable outside the package,
+// along with any channels left without a send or receive afterwards. A proc
+// is live only if it transitively feeds a send on an external (send-only)
+// channel or contains another observable side-effecting operation (assert,
+// cover, trace); liveness propagates from receivers to the procs sending on
+// the received channels. Generated proc networks often contain producers
+// whose consumers were specialized away -- without this pass the JIT and
+// interpreter tick them forever.
+class DeadProcEliminationPass : public Pass {
+ public:
+  DeadProcEliminationPass() : Pass("dead_proc_elim", "Dead Proc Elimination") {}
+  ~DeadProcEliminationPass() override {}
+
+ protected:
+  absl::StatusOr<bool> RunInternal(Package* p, const PassOptions& options,
+                                   PassResults* results) const override;
+};
+
+}  // namespace xls
+
+#endif  // XLS_PASSES_DEAD_PROC_ELIMINATION_PASS_H_
@@ -0,0 +1,143 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/dead_proc_elimination_pass.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/ir_test_base.h"
+
+namespace xls {
+namespace {
+
+using status_testing::IsOkAndHolds;
+
+class DeadProcEliminationPassTest : public IrTestBase {
+ protected:
+  absl::StatusOr<bool> Run(Package* p) {
+    PassResults results;
+    return DeadProcEliminationPass().Run(p, PassOptions(), &results);
+  }
+};
+
+TEST_F(DeadProcEliminationPassTest, DeadProducerConsumerPairIsRemoved) {
+  const std::string program = R"(package test
+
+chan out(bits[32], id=0, kind=streaming, ops=send_only, flow_control=none, metadata="""""")
+chan unused(bits[32], id=1, kind=streaming, ops=send_receive, flow_control=none, metadata="""""")
+
+proc live(t: token, st: bits[32], init=0) {
+  send.1: token = send(t, st, channel_id=0, id=1)
+  next (send.1, st)
+}
+
+proc dead_producer(t: token, st: bits[32], init=0) {
+  send.2: token = send(t, st, channel_id=1, id=2)
+  next (send.2, st)
+}
+
+proc dead_consumer(t: token, st: bits[32], init=0) {
+  receive.3: (token, bits[32]) = receive(t, channel_id=1, id=3)
+  tuple_index.4: token = tuple_index(receive.3, index=0, id=4)
+  next (tuple_index.4, st)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, ParsePackage(program));
+  EXPECT_THAT(Run(p.get()), IsOkAndHolds(true));
+  EXPECT_EQ(p->procs().size(), 1);
+  EXPECT_EQ(p->procs().front()->name(), "live");
+  // The channel of the removed pair is gone; the external one remains.
+  EXPECT_EQ(p->channels().size(), 1);
+  EXPECT_EQ(p->channels().front()->name(), "out");
+}
+
+TEST_F(DeadProcEliminationPassTest, ConsumerOfLiveProducerIsKept) {
+  // The consumer does nothing observable, but removing it would strand the
+  // live producer's send on a send_receive channel with no receive node.
+  const std::string program = R"(package test
+
+chan out(bits[32], id=0, kind=streaming, ops=send_only, flow_control=none, metadata="""""")
+chan internal(bits[32], id=1, kind=streaming, ops=send_receive, flow_control=none, metadata="""""")
+
+proc producer(t: token, st: bits[32], init=0) {
+  send.1: token = send(t, st, channel_id=0, id=1)
+  send.2: token = send(send.1, st, channel_id=1, id=2)
+  next (send.2, st)
+}
+
+proc consumer(t: token, st: bits[32], init=0) {
+  receive.3: (token, bits[32]) = receive(t, channel_id=1, id=3)
+  tuple_index.4: token = tuple_index(receive.3, index=0, id=4)
+  next (tuple_index.4, st)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, ParsePackage(program));
+  EXPECT_THAT(Run(p.get()), IsOkAndHolds(false));
+  EXPECT_EQ(p->procs().size(), 2);
+  EXPECT_EQ(p->channels().size(), 2);
+}
+
+TEST_F(DeadProcEliminationPassTest, ProducerOfLiveConsumerIsKept) {
+  const std::string program = R"(package test
+
+chan internal(bits[32], id=0, kind=streaming, ops=send_receive, flow_control=none, metadata="""""")
+chan out(bits[32], id=1, kind=streaming, ops=send_only, flow_control=none, metadata="""""")
+
+proc producer(t: token, st: bits[32], init=0) {
+  send.1: token = send(t, st, channel_id=0, id=1)
+  next (send.1, st)
+}
+
+proc consumer(t: token, st: bits[32], init=0) {
+  receive.2: (token, bits[32]) = receive(t, channel_id=0, id=2)
+  tuple_index.3: token = tuple_index(receive.2, index=0, id=3)
+  tuple_index.4: bits[32] = tuple_index(receive.2, index=1, id=4)
+  send.5: token = send(tuple_index.3, tuple_index.4, channel_id=1, id=5)
+  next (send.5, st)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, ParsePackage(program));
+  EXPECT_THAT(Run(p.get()), IsOkAndHolds(false));
+  EXPECT_EQ(p->procs().size(), 2);
+  EXPECT_EQ(p->channels().size(), 2);
+}
+
+TEST_F(DeadProcEliminationPassTest, ReceiveOnlyConsumerChainIsRemoved) {
+  const std::string program = R"(package test
+
+chan in(bits[32], id=0, kind=streaming, ops=receive_only, flow_control=none, metadata="""""")
+chan out(bits[32], id=1, kind=streaming, ops=send_only, flow_control=none, metadata="""""")
+
+proc live(t: token, st: bits[32], init=0) {
+  send.1: token = send(t, st, channel_id=1, id=1)
+  next (send.1, st)
+}
+
+proc dead_sink(t: token, st: bits[32], init=0) {
+  receive.2: (token, bits[32]) = receive(t, channel_id=0, id=2)
+  tuple_index.3: token = tuple_index(receive.2, index=0, id=3)
+  next (tuple_index.3, st)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, ParsePackage(program));
+  EXPECT_THAT(Run(p.get()), IsOkAndHolds(true));
+  EXPECT_EQ(p->procs().size(), 1);
+  EXPECT_EQ(p->procs().front()->name(), "live");
+  EXPECT_EQ(p->channels().size(), 1);
+  EXPECT_EQ(p->channels().front()->name(), "out");
+}
+
+}  // namespace
+}  // namespace xls
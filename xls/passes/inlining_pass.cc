@@ -14,6 +14,9 @@
 
 #include "xls/passes/inlining_pass.h"
 
+#include <algorithm>
+
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
@@ -77,6 +80,9 @@ std::string GetPrefixedLabel(Invoke* invoke, absl::string_view label,
 // function.
 absl::Status InlineInvoke(Invoke* invoke, int inline_count) {
   Function* invoked = invoke->to_apply();
+  // The invoked function's nodes are about to be copied into the caller;
+  // grow the caller's bookkeeping once up front.
+  invoke->function_base()->ReserveNodes(invoked->node_count());
   absl::flat_hash_map<Node*, Node*> invoked_node_to_replacement;
   for (int64_t i = 0; i < invoked->params().size(); ++i) {
     Node* param = invoked->param(i);
@@ -226,26 +232,126 @@ std::vector<FunctionBase*> FunctionsInPostOrder(Package* p) {
   return post_order;
 }
 
+// Pre-analyzed summary of a callee used by the budgeted cost model. Computed
+// once per callee after the callee itself has been processed so repeated
+// inlining decisions do not re-walk the callee.
+struct CalleeSummary {
+  // Number of non-param nodes, i.e. the number of nodes cloned into the
+  // caller when a callsite is inlined.
+  int64_t cloned_node_count = 0;
+  // Whether the callee still contains invokes (because its own callsites did
+  // not fit in the budget). Such callees cannot be inlined.
+  bool contains_invokes = false;
+};
+
+CalleeSummary SummarizeCallee(Function* f) {
+  CalleeSummary summary;
+  for (Node* node : f->nodes()) {
+    if (node->Is<Param>()) {
+      continue;
+    }
+    if (node->Is<Invoke>()) {
+      summary.contains_invokes = true;
+    }
+    ++summary.cloned_node_count;
+  }
+  return summary;
+}
+
 }  // namespace
 
 absl::StatusOr<bool> InliningPass::RunInternal(Package* p,
                                                const PassOptions& options,
                                                PassResults* results) const {
   bool changed = false;
-  // Inline all the invokes of each function where functions are processed in a
+  // Inline the invokes of each function where functions are processed in a
   // post order of the call graph (leaves first). This ensures that when a
   // function Foo is inlined into its callsites, no invokes remain in Foo. This
   // avoid duplicate work.
   int inline_count = 0;
+  if (!node_growth_budget_.has_value()) {
+    for (FunctionBase* f : FunctionsInPostOrder(p)) {
+      // Create copy of nodes() because we will be adding and removing nodes
+      // during inlining.
+      std::vector<Node*> nodes(f->nodes().begin(), f->nodes().end());
+      for (Node* node : nodes) {
+        if (node->Is<Invoke>()) {
+          XLS_RETURN_IF_ERROR(InlineInvoke(node->As<Invoke>(), inline_count++));
+          changed = true;
+        }
+      }
+    }
+    return changed;
+  }
+
+  // Budgeted mode. Count the callsites of each function up front; a callee
+  // with a single callsite is free to inline because its nodes move into the
+  // caller rather than being duplicated (the original becomes dead).
+  absl::flat_hash_map<FunctionBase*, int64_t> callsite_counts;
+  for (FunctionBase* f : p->GetFunctionBases()) {
+    for (Node* node : f->nodes()) {
+      if (node->Is<Invoke>()) {
+        ++callsite_counts[node->As<Invoke>()->to_apply()];
+      }
+    }
+  }
+
+  // Callee summaries are computed lazily on the first callsite decision. The
+  // post-order processing guarantees a callee is fully processed before any
+  // of its callers ask for its summary, so cached summaries never go stale.
+  absl::flat_hash_map<Function*, CalleeSummary> summaries;
+  auto summary_of = [&](Function* callee) -> const CalleeSummary& {
+    auto it = summaries.find(callee);
+    if (it == summaries.end()) {
+      it = summaries.insert({callee, SummarizeCallee(callee)}).first;
+    }
+    return it->second;
+  };
+  auto callsite_cost = [&](Invoke* invoke) {
+    if (callsite_counts.at(invoke->to_apply()) == 1) {
+      return int64_t{0};
+    }
+    // The invoke node itself is removed.
+    return std::max(int64_t{0},
+                    summary_of(invoke->to_apply()).cloned_node_count - 1);
+  };
+
+  int64_t remaining_budget = *node_growth_budget_;
   for (FunctionBase* f : FunctionsInPostOrder(p)) {
-    // Create copy of nodes() because we will be adding and removing nodes
-    // during inlining.
-    std::vector<Node*> nodes(f->nodes().begin(), f->nodes().end());
-    for (Node* node : nodes) {
+    std::vector<Invoke*> invokes;
+    for (Node* node : f->nodes()) {
       if (node->Is<Invoke>()) {
-        XLS_RETURN_IF_ERROR(InlineInvoke(node->As<Invoke>(), inline_count++));
-        changed = true;
+        invokes.push_back(node->As<Invoke>());
+      }
+    }
+    // Greedily admit the cheapest callsites first to maximize the number of
+    // eliminated invokes within the budget. When a profile is available,
+    // frequently executed callsites are admitted first instead so the budget
+    // is spent where it pays off at run time.
+    const ProfileData* profile = options.profile_data.get();
+    std::stable_sort(invokes.begin(), invokes.end(), [&](Invoke* a, Invoke* b) {
+      if (profile != nullptr) {
+        int64_t count_a = profile->GetExecutionCount(a);
+        int64_t count_b = profile->GetExecutionCount(b);
+        if (count_a != count_b) {
+          return count_a > count_b;
+        }
+      }
+      return callsite_cost(a) < callsite_cost(b);
+    });
+    for (Invoke* invoke : invokes) {
+      if (summary_of(invoke->to_apply()).contains_invokes) {
+        // The callee retained invokes of its own; inlining it would require
+        // transitively inlining those as well. Leave the callsite.
+        continue;
+      }
+      int64_t cost = callsite_cost(invoke);
+      if (cost > remaining_budget) {
+        continue;
       }
+      remaining_budget -= cost;
+      XLS_RETURN_IF_ERROR(InlineInvoke(invoke, inline_count++));
+      changed = true;
     }
   }
   return changed;
@@ -16,6 +16,7 @@
 #define XLS_PASSES_INLINING_PASS_H_
 
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
 #include "xls/ir/function.h"
 #include "xls/passes/passes.h"
 
@@ -23,11 +24,26 @@ namespace xls {
 
 class InliningPass : public Pass {
  public:
+  // Inlines all invocations unconditionally (full leaf inlining).
   InliningPass() : Pass("inlining", "Inlines invocations") {}
 
+  // Budget-aware mode: inlines invocations in increasing order of estimated
+  // node growth until inlining the next callsite would grow the package by
+  // more than 'node_growth_budget' nodes in total. Inlining the only callsite
+  // of a callee is free since the callee's nodes are duplicated rather than
+  // multiplied (the original becomes dead). Callsites which do not fit in the
+  // budget are left as invokes, so this mode trades some optimization
+  // opportunity for bounded node growth and is opt-in.
+  explicit InliningPass(int64_t node_growth_budget)
+      : Pass("inlining", "Inlines invocations (budgeted)"),
+        node_growth_budget_(node_growth_budget) {}
+
  protected:
   absl::StatusOr<bool> RunInternal(Package* p, const PassOptions& options,
                                    PassResults* results) const override;
+
+ private:
+  absl::optional<int64_t> node_growth_budget_;
 };
 
 }  // namespace xls
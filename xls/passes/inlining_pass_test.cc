@@ -14,6 +14,8 @@
 
 #include "xls/passes/inlining_pass.h"
 
+#include <memory>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/statusor.h"
@@ -22,6 +24,7 @@
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/ir_test_base.h"
 #include "xls/passes/dce_pass.h"
+#include "xls/passes/profile_data.h"
 
 namespace m = ::xls::op_matchers;
 
@@ -198,5 +201,128 @@ fn caller(the_token: token, x: bits[32]) -> (token, bits[32]) {
   }
 }
 
+int64_t InvokeCount(Function* f) {
+  int64_t count = 0;
+  for (Node* node : f->nodes()) {
+    if (node->Is<Invoke>()) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+TEST_F(InliningPassTest, BudgetAdmitsOnlyCallsitesThatFit) {
+  // The callee clones two nodes per callsite (the invoke node is removed), so
+  // each of the two callsites costs one node of growth. A budget of one admits
+  // exactly one of them.
+  const std::string program = R"(
+package some_package
+
+fn callee(x: bits[32], y: bits[32]) -> bits[32] {
+  add.1: bits[32] = add(x, y)
+  ret not.2: bits[32] = not(add.1)
+}
+
+fn caller(a: bits[32], b: bits[32]) -> bits[32] {
+  invoke.3: bits[32] = invoke(a, b, to_apply=callee)
+  invoke.4: bits[32] = invoke(b, a, to_apply=callee)
+  ret add.5: bits[32] = add(invoke.3, invoke.4)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto package, ParsePackage(program));
+  PassResults results;
+  EXPECT_THAT(InliningPass(/*node_growth_budget=*/1)
+                  .Run(package.get(), PassOptions(), &results),
+              IsOkAndHolds(true));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, package->GetFunction("caller"));
+  EXPECT_EQ(InvokeCount(f), 1);
+}
+
+TEST_F(InliningPassTest, ProfileBiasesBudgetTowardHotCallsites) {
+  // Both callsites cost one node of growth. Without a profile the first
+  // callsite in node order is admitted; the profile marks invoke.4 as much
+  // hotter, so the one-node budget is spent there instead.
+  const std::string program = R"(
+package some_package
+
+fn callee(x: bits[32], y: bits[32]) -> bits[32] {
+  add.1: bits[32] = add(x, y)
+  ret not.2: bits[32] = not(add.1)
+}
+
+fn caller(a: bits[32], b: bits[32]) -> bits[32] {
+  invoke.3: bits[32] = invoke(a, b, to_apply=callee)
+  invoke.4: bits[32] = invoke(b, a, to_apply=callee)
+  ret add.5: bits[32] = add(invoke.3, invoke.4)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto package, ParsePackage(program));
+  XLS_ASSERT_OK_AND_ASSIGN(ProfileData profile,
+                           ProfileData::Parse("3\tinvoke.3\t5\t100\n"
+                                              "4\tinvoke.4\t500\t100\n"));
+  PassOptions options;
+  options.profile_data = std::make_shared<ProfileData>(std::move(profile));
+  PassResults results;
+  EXPECT_THAT(InliningPass(/*node_growth_budget=*/1)
+                  .Run(package.get(), options, &results),
+              IsOkAndHolds(true));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, package->GetFunction("caller"));
+  EXPECT_EQ(InvokeCount(f), 1);
+  for (Node* node : f->nodes()) {
+    if (node->Is<Invoke>()) {
+      EXPECT_EQ(node->GetName(), "invoke.3");
+    }
+  }
+}
+
+TEST_F(InliningPassTest, ZeroBudgetLeavesMultiCallsiteCalleesAlone) {
+  const std::string program = R"(
+package some_package
+
+fn callee(x: bits[32], y: bits[32]) -> bits[32] {
+  add.1: bits[32] = add(x, y)
+  ret not.2: bits[32] = not(add.1)
+}
+
+fn caller(a: bits[32], b: bits[32]) -> bits[32] {
+  invoke.3: bits[32] = invoke(a, b, to_apply=callee)
+  invoke.4: bits[32] = invoke(b, a, to_apply=callee)
+  ret add.5: bits[32] = add(invoke.3, invoke.4)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto package, ParsePackage(program));
+  PassResults results;
+  EXPECT_THAT(InliningPass(/*node_growth_budget=*/0)
+                  .Run(package.get(), PassOptions(), &results),
+              IsOkAndHolds(false));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, package->GetFunction("caller"));
+  EXPECT_EQ(InvokeCount(f), 2);
+}
+
+TEST_F(InliningPassTest, SoleCallsiteIsFreeUnderZeroBudget) {
+  // A callee with a single callsite costs nothing: its nodes move into the
+  // caller and the original function becomes dead.
+  const std::string program = R"(
+package some_package
+
+fn callee(x: bits[32], y: bits[32]) -> bits[32] {
+  add.1: bits[32] = add(x, y)
+  ret not.2: bits[32] = not(add.1)
+}
+
+fn caller(a: bits[32], b: bits[32]) -> bits[32] {
+  ret invoke.3: bits[32] = invoke(a, b, to_apply=callee)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto package, ParsePackage(program));
+  PassResults results;
+  EXPECT_THAT(InliningPass(/*node_growth_budget=*/0)
+                  .Run(package.get(), PassOptions(), &results),
+              IsOkAndHolds(true));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, package->GetFunction("caller"));
+  EXPECT_EQ(InvokeCount(f), 0);
+  EXPECT_THAT(f->return_value(), m::Not(m::Add()));
+}
+
 }  // namespace
 }  // namespace xls
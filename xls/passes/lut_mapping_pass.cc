@@ -0,0 +1,205 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/lut_mapping_pass.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/status/statusor.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/bits_ops.h"
+#include "xls/ir/node.h"
+#include "xls/ir/node_iterator.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+// Returns whether the node's operation can be absorbed into a lookup table's
+// truth table. All are bitwise operations so a one-bit node implies one-bit
+// operands.
+bool IsMappableOp(Node* node) {
+  if (!node->GetType()->IsBits() || node->BitCountOrDie() != 1) {
+    return false;
+  }
+  switch (node->op()) {
+    case Op::kAnd:
+    case Op::kOr:
+    case Op::kXor:
+    case Op::kNand:
+    case Op::kNor:
+    case Op::kNot:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns whether the node is interior to the cloud of its (single) user:
+// absorbing it into the user's lookup table cannot duplicate logic or lose an
+// externally visible value. Mappable nodes which are not interior are the
+// roots of clouds and produce the mapped lookup-table outputs.
+bool IsInteriorNode(Node* node) {
+  return IsMappableOp(node) && !node->function_base()->HasImplicitUse(node) &&
+         node->users().size() == 1 && IsMappableOp(node->users().front());
+}
+
+// The boolean cloud rooted at a mappable node: the set of interior nodes
+// absorbed into the lookup table and the distinct inputs (in deterministic
+// discovery order) the table is indexed by.
+struct Cloud {
+  std::vector<Node*> leaves;
+  int64_t gate_count = 0;
+};
+
+// Gathers the cloud rooted at 'root' by expanding through interior nodes.
+Cloud GatherCloud(Node* root) {
+  Cloud cloud;
+  cloud.gate_count = 1;
+  absl::flat_hash_set<Node*> seen_leaves;
+  std::vector<Node*> worklist(root->operands().begin(),
+                              root->operands().end());
+  // Process in operand order for deterministic leaf discovery.
+  std::reverse(worklist.begin(), worklist.end());
+  while (!worklist.empty()) {
+    Node* node = worklist.back();
+    worklist.pop_back();
+    if (IsInteriorNode(node)) {
+      ++cloud.gate_count;
+      std::vector<Node*> operands(node->operands().begin(),
+                                  node->operands().end());
+      std::reverse(operands.begin(), operands.end());
+      for (Node* operand : operands) {
+        worklist.push_back(operand);
+      }
+    } else if (seen_leaves.insert(node).second) {
+      cloud.leaves.push_back(node);
+    }
+  }
+  return cloud;
+}
+
+// Returns the truth-table vector of leaf 'i' of 's': the value of bit
+// position 'v' is the value the leaf takes in input combination 'v', where
+// combination bits are ordered with leaf 0 as the most significant. This
+// matches the selector formed by concatenating the leaves below.
+Bits LeafVector(int64_t i, int64_t s) {
+  absl::InlinedVector<bool, 64> bits(int64_t{1} << s);
+  for (int64_t v = 0; v < static_cast<int64_t>(bits.size()); ++v) {
+    bits[v] = ((v >> (s - 1 - i)) & 1) != 0;
+  }
+  return Bits(bits);
+}
+
+// Computes the truth table of the cloud rooted at 'node' by bit-parallel
+// evaluation over all input combinations: each cloud input is bound to its
+// LeafVector and the boolean operations are applied bitwise.
+Bits ComputeTruthTable(Node* node, absl::flat_hash_map<Node*, Bits>* memo) {
+  auto it = memo->find(node);
+  if (it != memo->end()) {
+    return it->second;
+  }
+  std::vector<Bits> operands;
+  operands.reserve(node->operand_count());
+  for (Node* operand : node->operands()) {
+    operands.push_back(ComputeTruthTable(operand, memo));
+  }
+  Bits result;
+  switch (node->op()) {
+    case Op::kAnd:
+      result = bits_ops::NaryAnd(operands);
+      break;
+    case Op::kOr:
+      result = bits_ops::NaryOr(operands);
+      break;
+    case Op::kXor:
+      result = bits_ops::NaryXor(operands);
+      break;
+    case Op::kNand:
+      result = bits_ops::NaryNand(operands);
+      break;
+    case Op::kNor:
+      result = bits_ops::NaryNor(operands);
+      break;
+    case Op::kNot:
+      result = bits_ops::Not(operands.front());
+      break;
+    default:
+      XLS_LOG(FATAL) << "Non-mappable op in cloud: " << node->ToString();
+  }
+  memo->emplace(node, result);
+  return result;
+}
+
+// Replaces the cloud rooted at 'root' with a one-bit dynamic slice of the
+// cloud's truth-table literal, indexed by the concatenation of the cloud
+// inputs. The interior nodes become dead and are cleaned up by DCE.
+absl::Status MapCloud(Node* root, const Cloud& cloud, FunctionBase* f) {
+  const int64_t s = cloud.leaves.size();
+  absl::flat_hash_map<Node*, Bits> memo;
+  for (int64_t i = 0; i < s; ++i) {
+    memo[cloud.leaves[i]] = LeafVector(i, s);
+  }
+  Bits table = ComputeTruthTable(root, &memo);
+  XLS_RET_CHECK_EQ(table.bit_count(), int64_t{1} << s);
+
+  XLS_ASSIGN_OR_RETURN(Node * table_literal,
+                       f->MakeNode<Literal>(root->loc(), Value(table)));
+  Node* selector = cloud.leaves.front();
+  if (s > 1) {
+    XLS_ASSIGN_OR_RETURN(selector,
+                         f->MakeNode<Concat>(root->loc(), cloud.leaves));
+  }
+  return root
+      ->ReplaceUsesWithNew<DynamicBitSlice>(table_literal, selector,
+                                            /*width=*/1)
+      .status();
+}
+
+}  // namespace
+
+absl::StatusOr<bool> LutMappingPass::RunOnFunctionBaseInternal(
+    FunctionBase* f, const PassOptions& options, PassResults* results) const {
+  bool changed = false;
+  // Snapshot the cloud roots before rewriting; replacement adds nodes to the
+  // function. Clouds are gathered at mapping time so a root mapped earlier is
+  // seen as a (non-mappable) dynamic bit slice leaf by later clouds.
+  std::vector<Node*> roots;
+  for (Node* node : TopoSort(f)) {
+    if (IsMappableOp(node) && !IsInteriorNode(node)) {
+      roots.push_back(node);
+    }
+  }
+  for (Node* root : roots) {
+    Cloud cloud = GatherCloud(root);
+    // A cloud wider than the lookup table is left to downstream synthesis;
+    // single gates are not worth hiding behind a table.
+    if (static_cast<int64_t>(cloud.leaves.size()) > lut_width_ ||
+        cloud.gate_count < 2) {
+      continue;
+    }
+    XLS_RETURN_IF_ERROR(MapCloud(root, cloud, f));
+    changed = true;
+  }
+  return changed;
+}
+
+}  // namespace xls
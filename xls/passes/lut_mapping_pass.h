@@ -0,0 +1,54 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_PASSES_LUT_MAPPING_PASS_H_
+#define XLS_PASSES_LUT_MAPPING_PASS_H_
+
+#include <cstdint>
+
+#include "absl/status/statusor.h"
+#include "xls/ir/function.h"
+#include "xls/passes/passes.h"
+
+namespace xls {
+
+// A technology-mapping pass which maps clouds of single-bit boolean logic
+// onto k-input lookup-table structures: each mapped cloud is replaced with a
+// dynamic bit slice selecting one bit of a precomputed truth-table literal.
+// Targets FPGA flows where downstream synthesis consumes LUT structures
+// directly, avoiding a redundant re-synthesis of boolean logic XLS has
+// already optimized. This pass is not part of the standard pipeline by
+// default; see PipelineProfile::lut_width in standard_pipeline.h.
+class LutMappingPass : public FunctionBasePass {
+ public:
+  // Matches the LUT input width of common FPGA architectures.
+  static constexpr int64_t kDefaultLutWidth = 6;
+
+  explicit LutMappingPass(int64_t lut_width = kDefaultLutWidth)
+      : FunctionBasePass("lut_mapping", "k-LUT technology mapping"),
+        lut_width_(lut_width) {}
+
+ protected:
+  absl::StatusOr<bool> RunOnFunctionBaseInternal(
+      FunctionBase* f, const PassOptions& options,
+      PassResults* results) const override;
+
+ private:
+  // Maximum number of distinct cloud inputs which fit in one lookup table.
+  int64_t lut_width_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_PASSES_LUT_MAPPING_PASS_H_
@@ -0,0 +1,133 @@
+// Copyright 2022 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/lut_mapping_pass.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/status/matchers.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_matcher.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/passes/dce_pass.h"
+
+namespace m = ::xls::op_matchers;
+
+namespace xls {
+namespace {
+
+using status_testing::IsOkAndHolds;
+
+class LutMappingPassTest : public IrTestBase {
+ protected:
+  absl::StatusOr<bool> Run(
+      Function* f, int64_t lut_width = LutMappingPass::kDefaultLutWidth) {
+    PassResults results;
+    XLS_ASSIGN_OR_RETURN(bool changed,
+                         LutMappingPass(lut_width).RunOnFunctionBase(
+                             f, PassOptions(), &results));
+    // Run DCE to clean up the absorbed interior nodes.
+    XLS_RETURN_IF_ERROR(DeadCodeEliminationPass()
+                            .RunOnFunctionBase(f, PassOptions(), &results)
+                            .status());
+    return changed;
+  }
+};
+
+TEST_F(LutMappingPassTest, MapsBooleanCloudToLut) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue a = fb.Param("a", p->GetBitsType(1));
+  BValue b = fb.Param("b", p->GetBitsType(1));
+  BValue c = fb.Param("c", p->GetBitsType(1));
+  fb.Xor(fb.And(a, b), c);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  EXPECT_THAT(Run(f), IsOkAndHolds(true));
+  // Truth table of (a & b) ^ c indexed by the selector {a, b, c}: bit v holds
+  // the cloud's value for input combination v.
+  EXPECT_THAT(f->return_value(),
+              m::DynamicBitSlice(
+                  m::Literal(UBits(0b01101010, 8)),
+                  m::Concat(m::Param("a"), m::Param("b"), m::Param("c"))));
+}
+
+TEST_F(LutMappingPassTest, MapsCloudWithInversion) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue a = fb.Param("a", p->GetBitsType(1));
+  BValue b = fb.Param("b", p->GetBitsType(1));
+  fb.Xor(fb.Not(a), b);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  EXPECT_THAT(Run(f), IsOkAndHolds(true));
+  EXPECT_THAT(f->return_value(),
+              m::DynamicBitSlice(m::Literal(UBits(0b1001, 4)),
+                                 m::Concat(m::Param("a"), m::Param("b"))));
+}
+
+TEST_F(LutMappingPassTest, SingleGateIsNotMapped) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue a = fb.Param("a", p->GetBitsType(1));
+  BValue b = fb.Param("b", p->GetBitsType(1));
+  fb.And(a, b);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  EXPECT_THAT(Run(f), IsOkAndHolds(false));
+  EXPECT_THAT(f->return_value(), m::And(m::Param("a"), m::Param("b")));
+}
+
+TEST_F(LutMappingPassTest, CloudWiderThanLutIsNotMapped) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue acc = fb.Param("p0", p->GetBitsType(1));
+  for (int64_t i = 1; i < 8; ++i) {
+    acc = fb.Or(acc, fb.Param(absl::StrFormat("p%d", i), p->GetBitsType(1)));
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  // Eight distinct inputs do not fit in a six-input lookup table.
+  EXPECT_THAT(Run(f), IsOkAndHolds(false));
+  EXPECT_THAT(f->return_value(), m::Or());
+}
+
+TEST_F(LutMappingPassTest, MultiplyUsedSubexpressionBecomesLutInput) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue a = fb.Param("a", p->GetBitsType(1));
+  BValue b = fb.Param("b", p->GetBitsType(1));
+  BValue c = fb.Param("c", p->GetBitsType(1));
+  BValue shared = fb.And(a, b);
+  fb.Tuple({fb.Xor(fb.Not(shared), c), fb.Or(shared, c)});
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  EXPECT_THAT(Run(f), IsOkAndHolds(true));
+  // The multiply-used AND is not absorbed (that would duplicate it); it feeds
+  // the mapped cloud as an input. The single-gate OR is left alone.
+  EXPECT_THAT(
+      f->return_value(),
+      m::Tuple(m::DynamicBitSlice(
+                   m::Literal(UBits(0b1001, 4)),
+                   m::Concat(m::And(m::Param("a"), m::Param("b")),
+                             m::Param("c"))),
+               m::Or()));
+}
+
+}  // namespace
+}  // namespace xls
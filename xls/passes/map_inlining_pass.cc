@@ -29,6 +29,10 @@ namespace xls {
 MapInliningPass::MapInliningPass()
     : FunctionBasePass("map_inlining", "Inline map operations") {}
 
+MapInliningPass::MapInliningPass(int64_t large_map_limit)
+    : FunctionBasePass("map_inlining", "Inline map operations (size-limited)"),
+      large_map_limit_(large_map_limit) {}
+
 absl::StatusOr<bool> MapInliningPass::RunOnFunctionBaseInternal(
     FunctionBase* function, const PassOptions& options,
     PassResults* results) const {
@@ -36,6 +40,12 @@ absl::StatusOr<bool> MapInliningPass::RunOnFunctionBaseInternal(
   std::vector<Node*> map_nodes;
   for (Node* node : function->nodes()) {
     if (node->Is<Map>()) {
+      int64_t size = node->operand(0)->GetType()->AsArrayOrDie()->size();
+      if (large_map_limit_.has_value() && size >= *large_map_limit_) {
+        // Keep large maps as first-class nodes; a later unrestricted run of
+        // this pass lowers them after optimization.
+        continue;
+      }
       map_nodes.push_back(node);
       changed = true;
     }
@@ -52,11 +62,15 @@ absl::Status MapInliningPass::ReplaceMap(Map* map) const {
   FunctionBase* function = map->function_base();
 
   int map_inputs_size = map->operand(0)->GetType()->AsArrayOrDie()->size();
+  // Three nodes are created per element plus the final array; grow the
+  // function's per-node bookkeeping once rather than incrementally while
+  // unrolling.
+  function->ReserveNodes(3 * static_cast<int64_t>(map_inputs_size) + 1);
+  const int64_t index_bit_count = Bits::MinBitCountUnsigned(map_inputs_size);
   std::vector<Node*> invocations;
   invocations.reserve(map_inputs_size);
   for (int i = 0; i < map_inputs_size; i++) {
-    Value index_value =
-        Value(UBits(i, Bits::MinBitCountUnsigned(map_inputs_size)));
+    Value index_value = Value(UBits(i, index_bit_count));
     XLS_ASSIGN_OR_RETURN(Node * index,
                          function->MakeNode<Literal>(map->loc(), index_value));
     XLS_ASSIGN_OR_RETURN(Node * array_index, function->MakeNode<ArrayIndex>(
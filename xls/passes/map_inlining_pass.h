@@ -17,6 +17,7 @@
 
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "xls/passes/passes.h"
 
 namespace xls {
@@ -25,8 +26,16 @@ namespace xls {
 // maps to Verilog.
 class MapInliningPass : public FunctionBasePass {
  public:
+  // Inlines every map node.
   MapInliningPass();
 
+  // Leaves maps of 'large_map_limit' or more elements as first-class nodes so
+  // optimization passes iterate over a single map node instead of thousands
+  // of unrolled ones. A pipeline using this mode must run an unrestricted
+  // MapInliningPass after optimization since maps cannot be lowered to
+  // Verilog directly.
+  explicit MapInliningPass(int64_t large_map_limit);
+
  protected:
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
       FunctionBase* function, const PassOptions& options,
@@ -34,6 +43,11 @@ class MapInliningPass : public FunctionBasePass {
 
   // Replaces a single Map node with a CountedFor operation.
   absl::Status ReplaceMap(Map* map) const;
+
+ private:
+  // Maps with at least this many elements are not inlined. No limit if
+  // nullopt.
+  absl::optional<int64_t> large_map_limit_;
 };
 
 }  // namespace xls
@@ -93,5 +93,39 @@ fn main(a: bits[32][4]) -> bits[16][4] {
           m::Invoke(m::ArrayIndex(m::Param(), /*indices=*/{m::Literal(3)}))));
 }
 
+TEST(MapInliningPass, LargeMapLimitLeavesBigMapsAlone) {
+  const char kPackage[] = R"(
+package p
+
+fn map_fn(x: bits[32]) -> bits[16] {
+  ret bit_slice.1: bits[16] = bit_slice(x, start=0, width=16)
+}
+
+fn main(a: bits[32][2], b: bits[32][4]) -> (bits[16][2], bits[16][4]) {
+  small: bits[16][2] = map(a, to_apply=map_fn)
+  big: bits[16][4] = map(b, to_apply=map_fn)
+  ret result: (bits[16][2], bits[16][4]) = tuple(small, big)
+}
+)";
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto package, Parser::ParsePackage(kPackage));
+  XLS_ASSERT_OK_AND_ASSIGN(auto func, package->GetFunction("main"));
+  MapInliningPass pass(/*large_map_limit=*/4);
+  PassOptions options;
+  XLS_ASSERT_OK_AND_ASSIGN(bool changed,
+                           pass.RunOnFunctionBase(func, options, nullptr));
+  ASSERT_TRUE(changed);
+
+  // The two-element map is unrolled; the four-element map survives.
+  EXPECT_THAT(
+      func->return_value(),
+      m::Tuple(
+          m::Array(
+              m::Invoke(m::ArrayIndex(m::Param(), /*indices=*/{m::Literal(0)})),
+              m::Invoke(
+                  m::ArrayIndex(m::Param(), /*indices=*/{m::Literal(1)}))),
+          m::Map()));
+}
+
 }  // namespace
 }  // namespace xls
@@ -526,19 +526,24 @@ void RangeAnalysisLog(FunctionBase* f,
 
 absl::StatusOr<bool> NarrowingPass::RunOnFunctionBaseInternal(
     FunctionBase* f, const PassOptions& options, PassResults* results) const {
+  // The pass queries only a fraction of the nodes in the function, so ternary
+  // values are computed lazily over the fanin cones of queried nodes.
   std::unique_ptr<TernaryQueryEngine> ternary_query_engine =
-      std::make_unique<TernaryQueryEngine>();
+      std::make_unique<TernaryQueryEngine>(QueryEngine::AnalysisMode::kLazy);
   std::unique_ptr<RangeQueryEngine> range_query_engine =
-      std::make_unique<RangeQueryEngine>();
+      std::make_unique<RangeQueryEngine>(&RangeAnalysisCache::Global());
 
   if (XLS_VLOG_IS_ON(3)) {
     RangeAnalysisLog(f, *ternary_query_engine, *range_query_engine);
   }
 
+  // Engines are ordered cheapest first; the costlier range analysis only runs
+  // if a query is made which ternary analysis cannot answer.
   std::vector<std::unique_ptr<QueryEngine>> engines;
   engines.push_back(std::move(ternary_query_engine));
   engines.push_back(std::move(range_query_engine));
-  UnionQueryEngine query_engine(std::move(engines));
+  UnionQueryEngine query_engine(std::move(engines),
+                                QueryEngine::AnalysisMode::kLazy);
   XLS_RETURN_IF_ERROR(query_engine.Populate(f).status());
 
   bool modified = false;
@@ -0,0 +1,300 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/outlining_pass.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/function.h"
+#include "xls/ir/node.h"
+#include "xls/ir/node_util.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/op.h"
+#include "xls/ir/package.h"
+
+namespace xls {
+namespace {
+
+// One position in the parallel walk of a group of occurrences: the
+// corresponding node from each occurrence, in group order.
+using NodeTuple = std::vector<Node*>;
+
+// Returns the number of non-param nodes in the expression cone rooted at
+// 'root', descending through operands and stopping at params.
+int64_t ConeSize(Node* root) {
+  absl::flat_hash_set<Node*> visited;
+  std::vector<Node*> worklist = {root};
+  int64_t size = 0;
+  while (!worklist.empty()) {
+    Node* node = worklist.back();
+    worklist.pop_back();
+    if (node->Is<Param>() || !visited.insert(node).second) {
+      continue;
+    }
+    ++size;
+    for (Node* operand : node->operands()) {
+      worklist.push_back(operand);
+    }
+  }
+  return size;
+}
+
+// The result of walking the occurrences of one fingerprint group in
+// parallel: the shared shape of the cones as a DAG of positions.
+struct ConeWalk {
+  // All discovered positions. Index 0 is the tuple of occurrence roots.
+  std::vector<NodeTuple> tuples;
+  // Positions which become params of the outlined function, in deterministic
+  // discovery order. A position is cut when it is a param in every
+  // occurrence, or when all occurrences share the same node (passing the
+  // shared node as an argument preserves its sharing).
+  std::vector<int64_t> cut_indices;
+  // For each interior position, the indices of its operand positions; empty
+  // for cut positions.
+  std::vector<std::vector<int64_t>> operand_indices;
+  // Interior position indices in dependency order (operands before users).
+  std::vector<int64_t> topo_order;
+};
+
+// Walks the cones rooted at 'roots' in parallel and returns the common
+// shape, or nullopt if the group cannot (or should not) be outlined: a cone
+// contains a side-effecting op or a node in 'consumed', or diverging sharing
+// between the occurrences would expand the shape past 'max_positions'.
+//
+// The walk treats the cones as their tree unfoldings, memoized on the tuple
+// of corresponding nodes, so occurrences only need to agree on structure
+// position by position -- not on which subexpressions they share, and not on
+// which leaves they hang off of.
+absl::optional<ConeWalk> WalkCones(absl::Span<Node* const> roots,
+                                   const absl::flat_hash_set<Node*>& consumed,
+                                   int64_t max_positions) {
+  ConeWalk walk;
+  absl::flat_hash_map<NodeTuple, int64_t> tuple_index;
+  std::vector<int64_t> worklist;
+
+  // Returns the index of the position for 'tuple', adding it (and queueing it
+  // for expansion if interior) on first encounter. Returns nullopt if the
+  // position makes the group unoutlinable.
+  auto add_position = [&](NodeTuple tuple,
+                          bool is_root) -> absl::optional<int64_t> {
+    auto it = tuple_index.find(tuple);
+    if (it != tuple_index.end()) {
+      return it->second;
+    }
+    for (Node* node : tuple) {
+      if (consumed.contains(node)) {
+        return absl::nullopt;
+      }
+    }
+    Node* exemplar = tuple.front();
+    bool all_same = std::all_of(tuple.begin(), tuple.end(),
+                                [&](Node* n) { return n == exemplar; });
+    // Equal fingerprints imply equal ops, so if the exemplar is a param all
+    // the nodes are params.
+    bool cut = (all_same && !is_root) || exemplar->Is<Param>();
+    if (!cut && OpIsSideEffecting(exemplar->op())) {
+      return absl::nullopt;
+    }
+    if (static_cast<int64_t>(walk.tuples.size()) >= max_positions) {
+      return absl::nullopt;
+    }
+    int64_t index = walk.tuples.size();
+    tuple_index.emplace(tuple, index);
+    walk.tuples.push_back(std::move(tuple));
+    walk.operand_indices.emplace_back();
+    if (cut) {
+      walk.cut_indices.push_back(index);
+    } else {
+      worklist.push_back(index);
+    }
+    return index;
+  };
+
+  if (!add_position(NodeTuple(roots.begin(), roots.end()), /*is_root=*/true)
+           .has_value()) {
+    return absl::nullopt;
+  }
+  while (!worklist.empty()) {
+    int64_t index = worklist.back();
+    worklist.pop_back();
+    // Copy: add_position() may grow walk.tuples and invalidate references.
+    NodeTuple current = walk.tuples[index];
+    for (int64_t i = 0; i < current.front()->operand_count(); ++i) {
+      NodeTuple operand_tuple;
+      operand_tuple.reserve(current.size());
+      for (Node* node : current) {
+        operand_tuple.push_back(node->operand(i));
+      }
+      absl::optional<int64_t> operand_index =
+          add_position(std::move(operand_tuple), /*is_root=*/false);
+      if (!operand_index.has_value()) {
+        return absl::nullopt;
+      }
+      walk.operand_indices[index].push_back(*operand_index);
+    }
+  }
+
+  // Dependency-order the interior positions with an iterative post-order
+  // DFS. Cut positions are leaves of the position DAG and are excluded.
+  std::vector<char> state(walk.tuples.size(), 0);
+  for (int64_t cut_index : walk.cut_indices) {
+    state[cut_index] = 2;
+  }
+  std::vector<int64_t> stack = {0};
+  while (!stack.empty()) {
+    int64_t index = stack.back();
+    if (state[index] == 0) {
+      state[index] = 1;
+      for (int64_t operand_index : walk.operand_indices[index]) {
+        if (state[operand_index] == 0) {
+          stack.push_back(operand_index);
+        }
+      }
+    } else {
+      stack.pop_back();
+      if (state[index] == 1) {
+        state[index] = 2;
+        walk.topo_order.push_back(index);
+      }
+    }
+  }
+  return walk;
+}
+
+// Creates the shared function for the shape in 'walk' by cloning the
+// exemplar (first) node of each interior position. '*next_number' supplies
+// distinct function names across groups.
+absl::StatusOr<Function*> BuildOutlinedFunction(Package* p,
+                                                const ConeWalk& walk,
+                                                int64_t* next_number) {
+  std::string name;
+  do {
+    name = absl::StrCat("outlined_", (*next_number)++);
+  } while (p->HasFunctionWithName(name));
+  Function* outlined = p->AddFunction(std::make_unique<Function>(name, p));
+
+  std::vector<Node*> cloned(walk.tuples.size(), nullptr);
+  for (int64_t i = 0; i < static_cast<int64_t>(walk.cut_indices.size()); ++i) {
+    Node* exemplar = walk.tuples[walk.cut_indices[i]].front();
+    XLS_ASSIGN_OR_RETURN(cloned[walk.cut_indices[i]],
+                         outlined->MakeNodeWithName<Param>(
+                             exemplar->loc(), absl::StrFormat("arg_%d", i),
+                             exemplar->GetType()));
+  }
+  for (int64_t index : walk.topo_order) {
+    std::vector<Node*> operands;
+    operands.reserve(walk.operand_indices[index].size());
+    for (int64_t operand_index : walk.operand_indices[index]) {
+      operands.push_back(cloned[operand_index]);
+    }
+    XLS_ASSIGN_OR_RETURN(
+        cloned[index],
+        walk.tuples[index].front()->CloneInNewFunction(operands, outlined));
+  }
+  XLS_RETURN_IF_ERROR(outlined->set_return_value(cloned[0]));
+  return outlined;
+}
+
+}  // namespace
+
+absl::StatusOr<bool> OutliningPass::RunInternal(Package* p,
+                                                const PassOptions& options,
+                                                PassResults* results) const {
+  std::vector<std::vector<Node*>> groups = p->StructurallyIdenticalCones();
+
+  // Process groups largest-cone-first so nested repeats are claimed by the
+  // outermost (most profitable) shape.
+  std::vector<std::pair<int64_t, int64_t>> order;
+  for (int64_t i = 0; i < static_cast<int64_t>(groups.size()); ++i) {
+    int64_t size = ConeSize(groups[i].front());
+    if (size >= min_cone_size_) {
+      order.push_back({size, i});
+    }
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [](const std::pair<int64_t, int64_t>& a,
+                      const std::pair<int64_t, int64_t>& b) {
+                     return a.first > b.first;
+                   });
+
+  absl::flat_hash_set<Node*> consumed;
+  absl::flat_hash_set<FunctionBase*> changed_function_bases;
+  int64_t next_function_number = 0;
+  bool changed = false;
+  for (const auto& [size, group_index] : order) {
+    std::vector<Node*> roots;
+    for (Node* root : groups[group_index]) {
+      // Only live nodes in functions and procs can be replaced with invokes.
+      if (consumed.contains(root) || root->function_base()->IsBlock() ||
+          (root->users().empty() &&
+           !root->function_base()->HasImplicitUse(root))) {
+        continue;
+      }
+      roots.push_back(root);
+    }
+    if (roots.size() < 2) {
+      continue;
+    }
+    absl::optional<ConeWalk> walk =
+        WalkCones(roots, consumed, /*max_positions=*/2 * size + 16);
+    if (!walk.has_value()) {
+      continue;
+    }
+    XLS_ASSIGN_OR_RETURN(
+        Function * outlined,
+        BuildOutlinedFunction(p, *walk, &next_function_number));
+    XLS_VLOG(2) << absl::StreamFormat(
+        "Outlined %d occurrences of a %d-node cone into %s", roots.size(),
+        size, outlined->name());
+    for (int64_t i = 0; i < static_cast<int64_t>(roots.size()); ++i) {
+      std::vector<Node*> args;
+      args.reserve(walk->cut_indices.size());
+      for (int64_t cut_index : walk->cut_indices) {
+        args.push_back(walk->tuples[cut_index][i]);
+      }
+      Node* root = roots[i];
+      XLS_ASSIGN_OR_RETURN(Node * invoke,
+                           root->function_base()->MakeNode<Invoke>(
+                               root->loc(), absl::MakeSpan(args), outlined));
+      XLS_RETURN_IF_ERROR(root->ReplaceUsesWith(invoke));
+      changed_function_bases.insert(root->function_base());
+    }
+    // Later (smaller) groups must not outline from inside cones that have
+    // already been replaced.
+    for (int64_t index : walk->topo_order) {
+      for (Node* node : walk->tuples[index]) {
+        consumed.insert(node);
+      }
+    }
+    changed = true;
+  }
+  for (FunctionBase* function_base : changed_function_bases) {
+    XLS_RETURN_IF_ERROR(RemoveDeadNodes(function_base).status());
+  }
+  return changed;
+}
+
+}  // namespace xls
@@ -0,0 +1,59 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_PASSES_OUTLINING_PASS_H_
+#define XLS_PASSES_OUTLINING_PASS_H_
+
+#include "absl/status/statusor.h"
+#include "xls/passes/passes.h"
+
+namespace xls {
+
+// The inverse of inlining: finds repeated structurally identical expression
+// cones (detected via Node::StructuralFingerprint bucketing) and extracts
+// each repeated shape into a shared Function, replacing every occurrence
+// with an Invoke of that function. The cones need not compute the same
+// value -- occurrences hanging off different inputs pass their own leaf
+// nodes as invoke arguments -- which is exactly the duplication that CSE
+// cannot merge. Shrinking the graph by the repeat factor makes every
+// downstream pass over the package proportionally cheaper.
+//
+// Cones are cut at params, at subexpressions shared by all occurrences
+// (these are passed in as arguments to preserve sharing), and never contain
+// side-effecting ops. Interior nodes which also feed logic outside a cone
+// remain live after outlining, so their logic is duplicated inside the
+// outlined function; the minimum cone size threshold keeps such duplication
+// worthwhile. The pass is opt-in and not part of the standard pipeline
+// since it works against InliningPass.
+class OutliningPass : public Pass {
+ public:
+  // Cones with fewer than this many non-param nodes are not worth the
+  // invoke indirection.
+  static constexpr int64_t kDefaultMinConeSize = 8;
+
+  explicit OutliningPass(int64_t min_cone_size = kDefaultMinConeSize)
+      : Pass("outlining", "Outlines repeated structural cones"),
+        min_cone_size_(min_cone_size) {}
+
+ protected:
+  absl::StatusOr<bool> RunInternal(Package* p, const PassOptions& options,
+                                   PassResults* results) const override;
+
+ private:
+  int64_t min_cone_size_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_PASSES_OUTLINING_PASS_H_
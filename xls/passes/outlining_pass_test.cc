@@ -0,0 +1,141 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/outlining_pass.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/ir_matcher.h"
+#include "xls/ir/ir_test_base.h"
+
+namespace m = ::xls::op_matchers;
+
+namespace xls {
+namespace {
+
+using status_testing::IsOkAndHolds;
+
+class OutliningPassTest : public IrTestBase {
+ protected:
+  absl::StatusOr<bool> Run(Package* p, int64_t min_cone_size) {
+    PassResults results;
+    return OutliningPass(min_cone_size).Run(p, PassOptions(), &results);
+  }
+};
+
+TEST_F(OutliningPassTest, RepeatedConesOffDifferentParams) {
+  const std::string program = R"(
+package p
+
+fn f(a: bits[8], b: bits[8], c: bits[8], d: bits[8]) -> bits[8] {
+  not.1: bits[8] = not(a)
+  add.2: bits[8] = add(not.1, b)
+  not.3: bits[8] = not(add.2)
+  not.4: bits[8] = not(c)
+  add.5: bits[8] = add(not.4, d)
+  not.6: bits[8] = not(add.5)
+  ret add.7: bits[8] = add(not.3, not.6)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedPackage> p,
+                           ParsePackage(program));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, p->GetFunction("f"));
+  EXPECT_THAT(Run(p.get(), /*min_cone_size=*/2), IsOkAndHolds(true));
+
+  // The two three-node cones are replaced with invokes of a shared function
+  // which receives each occurrence's own leaves as arguments.
+  EXPECT_THAT(f->return_value(), m::Add(m::Invoke(), m::Invoke()));
+  Invoke* invoke0 = f->return_value()->operand(0)->As<Invoke>();
+  Invoke* invoke1 = f->return_value()->operand(1)->As<Invoke>();
+  EXPECT_EQ(invoke0->to_apply(), invoke1->to_apply());
+  EXPECT_THAT(invoke0->operands(),
+              testing::UnorderedElementsAre(m::Param("a"), m::Param("b")));
+  EXPECT_THAT(invoke1->operands(),
+              testing::UnorderedElementsAre(m::Param("c"), m::Param("d")));
+  EXPECT_THAT(invoke0->to_apply()->return_value(),
+              m::Not(m::Add(m::Not(m::Param()), m::Param())));
+}
+
+TEST_F(OutliningPassTest, RepeatedConesAcrossFunctions) {
+  const std::string program = R"(
+package p
+
+fn f(x: bits[32]) -> bits[32] {
+  neg.1: bits[32] = neg(x)
+  ret umul.2: bits[32] = umul(neg.1, neg.1)
+}
+
+fn g(y: bits[32]) -> bits[32] {
+  neg.3: bits[32] = neg(y)
+  ret umul.4: bits[32] = umul(neg.3, neg.3)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedPackage> p,
+                           ParsePackage(program));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, p->GetFunction("f"));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * g, p->GetFunction("g"));
+  EXPECT_THAT(Run(p.get(), /*min_cone_size=*/2), IsOkAndHolds(true));
+
+  EXPECT_THAT(f->return_value(), m::Invoke(m::Param("x")));
+  EXPECT_THAT(g->return_value(), m::Invoke(m::Param("y")));
+  EXPECT_EQ(f->return_value()->As<Invoke>()->to_apply(),
+            g->return_value()->As<Invoke>()->to_apply());
+}
+
+TEST_F(OutliningPassTest, SharedSubexpressionBecomesArgument) {
+  const std::string program = R"(
+package p
+
+fn f(a: bits[8], b: bits[8], c: bits[8]) -> bits[8] {
+  umul.1: bits[8] = umul(a, b)
+  add.2: bits[8] = add(umul.1, a)
+  not.3: bits[8] = not(add.2)
+  add.4: bits[8] = add(umul.1, c)
+  not.5: bits[8] = not(add.4)
+  ret xor.6: bits[8] = xor(not.3, not.5)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedPackage> p,
+                           ParsePackage(program));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, p->GetFunction("f"));
+  EXPECT_THAT(Run(p.get(), /*min_cone_size=*/2), IsOkAndHolds(true));
+
+  // The multiply feeds both cones, so it is passed in as an argument rather
+  // than being duplicated inside the outlined function.
+  EXPECT_THAT(f->return_value(),
+              m::Xor(m::Invoke(m::UMul(), m::Param("a")),
+                     m::Invoke(m::UMul(), m::Param("c"))));
+  EXPECT_EQ(f->return_value()->operand(0)->operand(0),
+            f->return_value()->operand(1)->operand(0));
+}
+
+TEST_F(OutliningPassTest, SmallConesAreLeftAlone) {
+  const std::string program = R"(
+package p
+
+fn f(a: bits[8], b: bits[8]) -> bits[8] {
+  not.1: bits[8] = not(a)
+  not.2: bits[8] = not(b)
+  ret add.3: bits[8] = add(not.1, not.2)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedPackage> p,
+                           ParsePackage(program));
+  EXPECT_THAT(Run(p.get(), OutliningPass::kDefaultMinConeSize),
+              IsOkAndHolds(false));
+}
+
+}  // namespace
+}  // namespace xls
@@ -16,25 +16,31 @@
 #define XLS_PASSES_PASS_BASE_H_
 
 #include <stdio.h>
+#include <sys/resource.h>
 
 #include <filesystem>
+#include <fstream>
 #include <memory>
 #include <set>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
-#include "xls/common/file/filesystem.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/sampling_profiler.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/function.h"
 #include "xls/ir/package.h"
+#include "xls/passes/profile_data.h"
 
 namespace xls {
 
@@ -57,6 +63,21 @@ struct PassOptions {
   // both run_only_passes and skip_passes are present, then only passes which
   // are present in run_only_passes and not present in skip_passes will be run.
   std::vector<std::string> skip_passes;
+
+  // If true, function-scoped passes (FunctionBasePass, ProcPass) run their
+  // per-FunctionBase invocations on worker threads rather than sequentially.
+  // Such passes only mutate the function they are invoked on but may read its
+  // callees, so work is sharded by call-graph component (functions related by
+  // a call edge stay on one worker); the package-level state shared across
+  // workers (type/value interning, node id allocation) is thread-safe.
+  // Package-scoped passes are unaffected.
+  bool parallel_function_base_passes = false;
+
+  // Per-node execution frequencies captured from an instrumented run of this
+  // IR (see ProfileData::Parse), or null if no profile is available. Passes
+  // with frequency-sensitive heuristics (e.g. the budgeted inlining cost
+  // model) consult this to favor frequently executed code.
+  std::shared_ptr<const ProfileData> profile_data;
 };
 
 // An object containing information about the invocation of a pass (single call
@@ -70,8 +91,49 @@ struct PassInvocation {
 
   // The run duration of the pass.
   absl::Duration run_duration;
+
+  // The change in the number of IR nodes across the invocation (negative if
+  // the pass removed nodes). Zero if the IR type the pass operates on does not
+  // expose a node count.
+  int64_t node_count_delta = 0;
+
+  // The increase in the process peak resident set size across the invocation,
+  // in bytes. Attribution is approximate: peak RSS is monotone for the
+  // process, so only passes which push the process to a new high-water mark
+  // show a nonzero delta.
+  int64_t peak_rss_delta_bytes = 0;
+};
+
+namespace internal {
+
+// Returns the peak resident set size of the process in bytes, or zero if it
+// cannot be determined. Used to attribute memory high-water-mark growth to
+// pass invocations.
+inline int64_t GetPeakResidentSetSizeBytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+  // ru_maxrss is in kilobytes on Linux.
+  return static_cast<int64_t>(usage.ru_maxrss) * 1024;
+}
+
+// Helper which returns the number of IR nodes in an IR object for IR types
+// which expose a `GetNodeCount` method (e.g., Package), and zero for other IR
+// types pass pipelines are instantiated on.
+template <typename IrT, typename = void>
+struct IrNodeCounter {
+  static int64_t GetNodeCount(const IrT* ir) { return 0; }
+};
+
+template <typename IrT>
+struct IrNodeCounter<
+    IrT, std::void_t<decltype(std::declval<const IrT&>().GetNodeCount())>> {
+  static int64_t GetNodeCount(const IrT* ir) { return ir->GetNodeCount(); }
 };
 
+}  // namespace internal
+
 // A object to which metadata may be written in each pass invocation. This data
 // structure is passed by mutable pointer to PassBase::Run.
 struct PassResults {
@@ -79,6 +141,24 @@ struct PassResults {
   std::vector<PassInvocation> invocations;
 };
 
+// Renders the per-pass invocation records accumulated by a pass pipeline as a
+// JSON document with one record per invocation, in invocation order. Used by
+// tools which expose a pass-profile flag (e.g., opt_main and codegen_main).
+inline std::string PassProfileToJson(const PassResults& results) {
+  std::vector<std::string> records;
+  records.reserve(results.invocations.size());
+  for (const PassInvocation& invocation : results.invocations) {
+    records.push_back(absl::StrFormat(
+        "    {\"pass\": \"%s\", \"changed\": %s, \"duration_us\": %d, "
+        "\"node_count_delta\": %d, \"peak_rss_delta_bytes\": %d}",
+        invocation.pass_name, invocation.ir_changed ? "true" : "false",
+        absl::ToInt64Microseconds(invocation.run_duration),
+        invocation.node_count_delta, invocation.peak_rss_delta_bytes));
+  }
+  return absl::StrCat("{\n  \"invocations\": [\n",
+                      absl::StrJoin(records, ",\n"), "\n  ]\n}\n");
+}
+
 // Base class for all compiler passes. Template parameters:
 //
 //   IrT : The data type that the pass operates on (e.g., xls::Package). The
@@ -233,7 +313,20 @@ class CompoundPassBase : public PassBase<IrT, OptionsT, ResultsT> {
         ir_dump_path / absl::StrFormat("%s.%s.%03d.%s.%s.ir", ir->name(),
                                        top_level_name, ordinal, tag,
                                        changed ? "changed" : "unchanged");
-    return SetFileContents(path, ir->DumpIr());
+    // Stream the IR to the file rather than materializing the entire dump as
+    // a string, which can be very large for big packages.
+    std::ofstream file(path);
+    if (!file.is_open()) {
+      return absl::UnavailableError(
+          absl::StrCat("Cannot open file for writing: ", path.string()));
+    }
+    ir->DumpIrTo(file);
+    file.close();
+    if (file.fail()) {
+      return absl::UnavailableError(
+          absl::StrCat("Error writing file: ", path.string()));
+    }
+    return absl::OkStatus();
   }
 
   std::vector<std::unique_ptr<Pass>> passes_;
@@ -332,14 +425,21 @@ absl::StatusOr<bool> CompoundPassBase<IrT, OptionsT, ResultsT>::RunNested(
     std::string ir_before = ir->DumpIr();
 #endif
     absl::Time start = absl::Now();
+    int64_t node_count_before = internal::IrNodeCounter<IrT>::GetNodeCount(ir);
+    int64_t peak_rss_before = internal::GetPeakResidentSetSizeBytes();
     bool pass_changed;
-    if (pass->IsCompound()) {
-      XLS_ASSIGN_OR_RETURN(
-          pass_changed,
-          (down_cast<CompoundPassBase<IrT, OptionsT, ResultsT>*>(pass.get())
-               ->RunNested(ir, options, results, top_level_name, checkers)));
-    } else {
-      XLS_ASSIGN_OR_RETURN(pass_changed, pass->Run(ir, options, results));
+    {
+      // Tag sampling-profiler samples taken while this pass runs with the
+      // pass name. Nested compound passes re-tag with the innermost pass.
+      ProfilerAnnotation profiler_annotation(pass->short_name());
+      if (pass->IsCompound()) {
+        XLS_ASSIGN_OR_RETURN(
+            pass_changed,
+            (down_cast<CompoundPassBase<IrT, OptionsT, ResultsT>*>(pass.get())
+                 ->RunNested(ir, options, results, top_level_name, checkers)));
+      } else {
+        XLS_ASSIGN_OR_RETURN(pass_changed, pass->Run(ir, options, results));
+      }
     }
     absl::Duration duration = absl::Now() - start;
 #ifdef DEBUG
@@ -366,7 +466,9 @@ absl::StatusOr<bool> CompoundPassBase<IrT, OptionsT, ResultsT>::RunNested(
         (pass_changed ? "changed IR" : "did not change IR"));
     if (!pass->IsCompound()) {
       results->invocations.push_back(
-          {pass->short_name(), pass_changed, duration});
+          {pass->short_name(), pass_changed, duration,
+           internal::IrNodeCounter<IrT>::GetNodeCount(ir) - node_count_before,
+           internal::GetPeakResidentSetSizeBytes() - peak_rss_before});
     }
     if (!options.ir_dump_path.empty()) {
       XLS_RETURN_IF_ERROR(DumpIr(options.ir_dump_path, ir, top_level_name,
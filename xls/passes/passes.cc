@@ -14,13 +14,119 @@
 
 #include "xls/passes/passes.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11): only for hardware_concurrency.
+
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "absl/types/variant.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
+#include "xls/data_structures/union_find_map.h"
+#include "xls/ir/nodes.h"
 
 namespace xls {
+namespace {
+
+// Runs 'run' over every element of 'items' sharded across worker threads and
+// returns whether any invocation changed the IR. If invocations fail, the
+// status of the lowest-index failure is returned so error reporting does not
+// depend on thread scheduling. The invocations must only mutate the item they
+// are given (plus the thread-safe package-level interning/allocation state).
+template <typename T>
+absl::StatusOr<bool> RunInParallel(
+    absl::Span<T* const> items,
+    const std::function<absl::StatusOr<bool>(T*)>& run) {
+  const int64_t num_threads = std::min(
+      static_cast<int64_t>(items.size()),
+      std::max(int64_t{1},
+               static_cast<int64_t>(std::thread::hardware_concurrency())));
+  std::vector<absl::Status> statuses(items.size(), absl::OkStatus());
+  // Per-item changed flags; avoid std::vector<bool> as adjacent elements would
+  // share bytes across threads.
+  std::vector<char> changed_flags(items.size(), 0);
+  std::atomic<int64_t> next_index{0};
+  std::vector<std::unique_ptr<Thread>> workers;
+  workers.reserve(num_threads);
+  for (int64_t i = 0; i < num_threads; ++i) {
+    workers.push_back(std::make_unique<Thread>([&]() {
+      int64_t index;
+      while ((index = next_index.fetch_add(1, std::memory_order_relaxed)) <
+             static_cast<int64_t>(items.size())) {
+        absl::StatusOr<bool> result = run(items[index]);
+        if (result.ok()) {
+          changed_flags[index] = *result ? 1 : 0;
+        } else {
+          statuses[index] = result.status();
+        }
+      }
+    }));
+  }
+  for (std::unique_ptr<Thread>& worker : workers) {
+    worker->Join();
+  }
+  for (absl::Status& status : statuses) {
+    XLS_RETURN_IF_ERROR(status);
+  }
+  return std::find(changed_flags.begin(), changed_flags.end(), 1) !=
+         changed_flags.end();
+}
+
+// Partitions 'function_bases' into the connected components of the call
+// graph: a caller and its callee (via Invoke, Map, or CountedFor) land in the
+// same component. A pass invocation mutates only the function it is given,
+// but it may *read* that function's callees -- constant folding interprets
+// invoked functions and unrolling clones nodes out of loop bodies -- so a
+// function and its callee must never be processed concurrently. Components
+// preserve the relative order of 'function_bases'.
+std::vector<std::vector<FunctionBase*>> CallGraphComponents(
+    absl::Span<FunctionBase* const> function_bases) {
+  UnionFindMap<FunctionBase*, absl::monostate> components;
+  for (FunctionBase* f : function_bases) {
+    components.Insert(f, absl::monostate());
+  }
+  auto merge = [](const absl::monostate&, const absl::monostate&) {
+    return absl::monostate();
+  };
+  for (FunctionBase* f : function_bases) {
+    for (Node* node : f->nodes()) {
+      switch (node->op()) {
+        case Op::kCountedFor:
+          components.Union(f, node->As<CountedFor>()->body(), merge);
+          break;
+        case Op::kInvoke:
+          components.Union(f, node->As<Invoke>()->to_apply(), merge);
+          break;
+        case Op::kMap:
+          components.Union(f, node->As<Map>()->to_apply(), merge);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+  std::vector<std::vector<FunctionBase*>> result;
+  absl::flat_hash_map<FunctionBase*, int64_t> group_of_representative;
+  for (FunctionBase* f : function_bases) {
+    FunctionBase* representative = components.Find(f)->first;
+    auto [it, inserted] =
+        group_of_representative.try_emplace(representative, result.size());
+    if (inserted) {
+      result.push_back({});
+    }
+    result[it->second].push_back(f);
+  }
+  return result;
+}
+
+}  // namespace
 
 absl::StatusOr<bool> FunctionBasePass::RunOnFunctionBase(
     FunctionBase* f, const PassOptions& options, PassResults* results) const {
@@ -38,13 +144,61 @@ absl::StatusOr<bool> FunctionBasePass::RunOnFunctionBase(
   return changed;
 }
 
+absl::StatusOr<bool> FunctionBasePass::RunOnFunctionBaseIfDirty(
+    FunctionBase* f, const PassOptions& options, PassResults* results) const {
+  {
+    absl::MutexLock lock(&clean_mutex_);
+    auto it = clean_transform_counts_.find(f);
+    if (it != clean_transform_counts_.end() &&
+        it->second == f->transform_count()) {
+      XLS_VLOG(3) << absl::StreamFormat(
+          "Skipping %s on unchanged function_base %s", long_name(), f->name());
+      return false;
+    }
+  }
+  XLS_ASSIGN_OR_RETURN(bool changed,
+                       RunOnFunctionBaseInternal(f, options, results));
+  if (!changed) {
+    absl::MutexLock lock(&clean_mutex_);
+    clean_transform_counts_[f] = f->transform_count();
+  }
+  return changed;
+}
+
 absl::StatusOr<bool> FunctionBasePass::RunInternal(Package* p,
                                                    const PassOptions& options,
                                                    PassResults* results) const {
+  std::vector<FunctionBase*> function_bases = p->GetFunctionBases();
+  if (options.parallel_function_base_passes && function_bases.size() > 1) {
+    // Invocations on call-graph-unrelated FunctionBases are independent;
+    // shard them across threads by call-graph component, processing each
+    // component serially on its worker so a pass never reads a callee that
+    // another worker is rewriting (see CallGraphComponents). PassResults is
+    // not written to by per-function invocations so aggregation (below the
+    // join) is single-threaded.
+    std::vector<std::vector<FunctionBase*>> components =
+        CallGraphComponents(function_bases);
+    std::vector<std::vector<FunctionBase*>*> component_ptrs;
+    component_ptrs.reserve(components.size());
+    for (std::vector<FunctionBase*>& component : components) {
+      component_ptrs.push_back(&component);
+    }
+    return RunInParallel<std::vector<FunctionBase*>>(
+        component_ptrs,
+        [&](std::vector<FunctionBase*>* component) -> absl::StatusOr<bool> {
+          bool changed = false;
+          for (FunctionBase* f : *component) {
+            XLS_ASSIGN_OR_RETURN(bool function_changed,
+                                 RunOnFunctionBaseIfDirty(f, options, results));
+            changed |= function_changed;
+          }
+          return changed;
+        });
+  }
   bool changed = false;
-  for (FunctionBase* f : p->GetFunctionBases()) {
+  for (FunctionBase* f : function_bases) {
     XLS_ASSIGN_OR_RETURN(bool function_changed,
-                         RunOnFunctionBaseInternal(f, options, results));
+                         RunOnFunctionBaseIfDirty(f, options, results));
     changed |= function_changed;
   }
   return changed;
@@ -105,6 +259,16 @@ absl::StatusOr<bool> ProcPass::RunOnProc(Proc* proc, const PassOptions& options,
 absl::StatusOr<bool> ProcPass::RunInternal(Package* p,
                                            const PassOptions& options,
                                            PassResults* results) const {
+  if (options.parallel_function_base_passes && p->procs().size() > 1) {
+    std::vector<Proc*> procs;
+    procs.reserve(p->procs().size());
+    for (const auto& proc : p->procs()) {
+      procs.push_back(proc.get());
+    }
+    return RunInParallel<Proc>(procs, [&](Proc* proc) {
+      return RunOnProcInternal(proc, options, results);
+    });
+  }
   bool changed = false;
   for (const auto& proc : p->procs()) {
     XLS_ASSIGN_OR_RETURN(bool proc_changed,
@@ -23,8 +23,11 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "xls/ir/function.h"
 #include "xls/ir/package.h"
@@ -79,6 +82,25 @@ class FunctionBasePass : public Pass {
   absl::StatusOr<bool> TransformNodesToFixedPoint(
       FunctionBase* f,
       std::function<absl::StatusOr<bool>(Node*)> simplify_f) const;
+
+ private:
+  // As RunOnFunctionBaseInternal, but skips the invocation entirely when 'f'
+  // has not been restructured (FunctionBase::transform_count) since the last
+  // invocation of this pass instance found nothing to do on it. Function-scoped
+  // passes are deterministic on the function alone, so re-running them on an
+  // untouched function cannot change the outcome. Used by RunInternal so
+  // fixed-point pipeline iterations only revisit dirty functions.
+  absl::StatusOr<bool> RunOnFunctionBaseIfDirty(FunctionBase* f,
+                                                const PassOptions& options,
+                                                PassResults* results) const;
+
+  // Maps each function to its transform count as of the last invocation of
+  // this pass which left it unchanged. Guarded by a mutex as functions may be
+  // processed on worker threads (see
+  // PassOptions::parallel_function_base_passes).
+  mutable absl::Mutex clean_mutex_;
+  mutable absl::flat_hash_map<FunctionBase*, int64_t> clean_transform_counts_
+      ABSL_GUARDED_BY(clean_mutex_);
 };
 
 // Abstract base class for passes operate on procs. The derived
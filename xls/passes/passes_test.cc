@@ -16,6 +16,7 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "xls/common/casts.h"
@@ -109,6 +110,43 @@ TEST(PassesTest, AddPasses) {
               ElementsAre("d1", "d2", "d3", "d4", "d5", "d6"));
 }
 
+// Pass which adds a single literal node to the first function of the package.
+class NodeAddingPass : public Pass {
+ public:
+  NodeAddingPass() : Pass("node_adder", "Node adding pass") {}
+
+  absl::StatusOr<bool> RunInternal(Package* p, const PassOptions& options,
+                                   PassResults* results) const override {
+    Function* f = p->functions().front().get();
+    XLS_RETURN_IF_ERROR(
+        f->MakeNode<Literal>(/*loc=*/absl::nullopt, Value(UBits(42, 32)))
+            .status());
+    return true;
+  }
+};
+
+TEST(PassesTest, InvocationInstrumentation) {
+  std::unique_ptr<Package> p = BuildShift0().first;
+  int64_t node_count_before = p->GetNodeCount();
+
+  CompoundPass pass_mgr("TOP", "Top level pass manager");
+  pass_mgr.Add<DummyPass>("d1", "Dummy Pass 1");
+  pass_mgr.Add<NodeAddingPass>();
+
+  PassResults results;
+  EXPECT_THAT(pass_mgr.Run(p.get(), PassOptions(), &results),
+              IsOkAndHolds(true));
+  ASSERT_EQ(results.invocations.size(), 2);
+  EXPECT_FALSE(results.invocations[0].ir_changed);
+  EXPECT_EQ(results.invocations[0].node_count_delta, 0);
+  EXPECT_TRUE(results.invocations[1].ir_changed);
+  EXPECT_EQ(results.invocations[1].node_count_delta, 1);
+  // Peak RSS is monotone for the process, so the recorded delta can never be
+  // negative.
+  EXPECT_GE(results.invocations[1].peak_rss_delta_bytes, 0);
+  EXPECT_EQ(p->GetNodeCount(), node_count_before + 1);
+}
+
 // Invariant checker which returns an error if the package has function with a
 // particular name.
 class PackageNameChecker : public InvariantChecker {
@@ -432,5 +470,126 @@ TEST(PassesTest, TestTransformNodesToFixedPointWhileRemovingNodes) {
               IsOkAndHolds(false));
 }
 
+// FunctionBasePass which tallies its invocations per function and changes
+// nothing.
+class InvocationCountingPass : public FunctionBasePass {
+ public:
+  explicit InvocationCountingPass(
+      absl::flat_hash_map<std::string, int64_t>* counts)
+      : FunctionBasePass("counter", "invocation counter"), counts_(counts) {}
+
+ protected:
+  absl::StatusOr<bool> RunOnFunctionBaseInternal(
+      FunctionBase* f, const PassOptions& options,
+      PassResults* results) const override {
+    (*counts_)[f->name()]++;
+    return false;
+  }
+
+ private:
+  absl::flat_hash_map<std::string, int64_t>* counts_;
+};
+
+TEST(PassesTest, UnchangedFunctionsSkippedOnReRun) {
+  auto m = std::make_unique<Package>("m");
+  std::vector<Function*> functions;
+  for (int64_t i = 0; i < 2; ++i) {
+    FunctionBuilder fb(absl::StrFormat("f_%d", i), m.get());
+    BValue x = fb.Param("x", m->GetBitsType(32));
+    XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.BuildWithReturnValue(fb.Not(x)));
+    functions.push_back(f);
+  }
+
+  absl::flat_hash_map<std::string, int64_t> counts;
+  InvocationCountingPass pass(&counts);
+  PassResults results;
+  EXPECT_THAT(pass.Run(m.get(), PassOptions(), &results), IsOkAndHolds(false));
+  EXPECT_EQ(counts["f_0"], 1);
+  EXPECT_EQ(counts["f_1"], 1);
+
+  // Nothing has changed since the pass last saw the functions, so a second
+  // run skips both.
+  EXPECT_THAT(pass.Run(m.get(), PassOptions(), &results), IsOkAndHolds(false));
+  EXPECT_EQ(counts["f_0"], 1);
+  EXPECT_EQ(counts["f_1"], 1);
+
+  // Restructuring one function makes only that function be revisited.
+  XLS_ASSERT_OK(functions[0]
+                    ->MakeNode<Literal>(/*loc=*/absl::nullopt,
+                                        Value(UBits(0, 32)))
+                    .status());
+  EXPECT_THAT(pass.Run(m.get(), PassOptions(), &results), IsOkAndHolds(false));
+  EXPECT_EQ(counts["f_0"], 2);
+  EXPECT_EQ(counts["f_1"], 1);
+
+  // Reassigning an implicit use changes the function without adding or
+  // removing a node or moving an operand edge; it must also trigger a
+  // revisit.
+  XLS_ASSERT_OK(functions[1]->set_return_value(functions[1]->params()[0]));
+  EXPECT_THAT(pass.Run(m.get(), PassOptions(), &results), IsOkAndHolds(false));
+  EXPECT_EQ(counts["f_0"], 2);
+  EXPECT_EQ(counts["f_1"], 2);
+}
+
+TEST(PassesTest, ParallelFunctionBasePassExecution) {
+  auto m = std::make_unique<Package>("m");
+  // Enough functions that the parallel dispatch shards across several worker
+  // threads.
+  constexpr int64_t kFunctionCount = 32;
+  std::vector<Function*> functions;
+  for (int64_t i = 0; i < kFunctionCount; ++i) {
+    FunctionBuilder fb(absl::StrFormat("f_%d", i), m.get());
+    BValue x = fb.Param("x", m->GetBitsType(32));
+    fb.Not(fb.Add(x, x));
+    XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.BuildWithReturnValue(x));
+    EXPECT_EQ(f->node_count(), 3);
+    functions.push_back(f);
+  }
+
+  PassOptions options;
+  options.parallel_function_base_passes = true;
+  PassResults results;
+  EXPECT_THAT(NaiveDcePass().Run(m.get(), options, &results),
+              IsOkAndHolds(true));
+  for (Function* f : functions) {
+    EXPECT_EQ(f->node_count(), 1);
+  }
+  // A second run has nothing left to eliminate in any function.
+  EXPECT_THAT(NaiveDcePass().Run(m.get(), options, &results),
+              IsOkAndHolds(false));
+}
+
+TEST(PassesTest, ParallelExecutionVisitsCallGraphComponents) {
+  // Callers and callees are grouped onto the same worker (a pass may read the
+  // callee of the function it rewrites); every function must still be
+  // visited exactly once.
+  auto m = std::make_unique<Package>("m");
+  constexpr int64_t kChainCount = 8;
+  std::vector<std::string> function_names;
+  for (int64_t i = 0; i < kChainCount; ++i) {
+    FunctionBuilder callee_fb(absl::StrFormat("callee_%d", i), m.get());
+    BValue y = callee_fb.Param("y", m->GetBitsType(32));
+    XLS_ASSERT_OK_AND_ASSIGN(Function * callee,
+                             callee_fb.BuildWithReturnValue(callee_fb.Not(y)));
+    FunctionBuilder caller_fb(absl::StrFormat("caller_%d", i), m.get());
+    BValue x = caller_fb.Param("x", m->GetBitsType(32));
+    XLS_ASSERT_OK(caller_fb
+                      .BuildWithReturnValue(caller_fb.Invoke({x}, callee))
+                      .status());
+    function_names.push_back(callee->name());
+    function_names.push_back(absl::StrFormat("caller_%d", i));
+  }
+
+  absl::flat_hash_map<std::string, int64_t> counts;
+  InvocationCountingPass pass(&counts);
+  PassOptions options;
+  options.parallel_function_base_passes = true;
+  PassResults results;
+  EXPECT_THAT(pass.Run(m.get(), options, &results), IsOkAndHolds(false));
+  for (const std::string& name : function_names) {
+    EXPECT_EQ(counts[name], 1) << name;
+  }
+}
+
 }  // namespace
 }  // namespace xls
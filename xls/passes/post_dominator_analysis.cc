@@ -15,139 +15,117 @@
 #include "xls/passes/post_dominator_analysis.h"
 
 #include <algorithm>
-#include <cstdio>
-#include <queue>
+#include <memory>
+#include <utility>
 
-#include "absl/algorithm/container.h"
-#include "absl/container/flat_hash_map.h"
-#include "absl/container/flat_hash_set.h"
-#include "absl/memory/memory.h"
-#include "absl/meta/type_traits.h"
-#include "absl/status/status.h"
-#include "absl/status/statusor.h"
-#include "xls/common/status/ret_check.h"
-#include "xls/ir/function.h"
-#include "xls/ir/node_iterator.h"
-#include "xls/ir/proc.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/common/logging/logging.h"
 
 namespace xls {
-namespace {
 
-using NodeIndex = int64_t;
+/* static */ absl::StatusOr<std::unique_ptr<PostDominatorAnalysis>>
+PostDominatorAnalysis::Run(FunctionBase* f) {
+  auto analysis = std::make_unique<PostDominatorAnalysis>();
+  analysis->function_base_ = f;
+  analysis->ir_transform_count_ = f->transform_count();
+
+  // The postdominators of a node are the intersection of the postdominators
+  // of its users plus the node itself. The intersections are done word-wise
+  // on the bitsets by the dataflow framework.
+  analysis->dataflow_ = BackwardBitsetDataflow::Run(
+      f, BackwardBitsetDataflow::Meet::kIntersection,
+      [](Node* node, int64_t index, InlineBitmap* bitmap) {
+        // A node always postdominates itself.
+        bitmap->Set(index, true);
+      });
 
-// Returns the intersection of the given sorted lists. Lists should be sorted in
-// ascending order.
-std::vector<NodeIndex> IntersectSortedLists(
-    absl::Span<const absl::Span<const NodeIndex>> lists) {
-  std::vector<NodeIndex> intersection;
-  if (lists.empty()) {
-    return intersection;
-  }
-  std::vector<int64_t> indices(lists.size(), 0);
+  return std::move(analysis);
+}
 
-  // Returns true if any of the indices are at the end of their respective
-  // lists.
-  auto at_end_of_a_list = [&]() {
-    for (int64_t i = 0; i < indices.size(); ++i) {
-      if (indices[i] == lists[i].size()) {
-        return true;
-      }
-    }
-    return false;
-  };
-  while (!at_end_of_a_list()) {
-    // Find the minimum value among the list elements at their respective
-    // indices.
-    NodeIndex min_value = lists[0][indices[0]];
-    for (int64_t i = 1; i < lists.size(); ++i) {
-      NodeIndex value = lists[i][indices[i]];
-      if (value < min_value) {
-        min_value = value;
+absl::Span<Node* const> PostDominatorAnalysis::GetPostDominatorsOfNode(
+    const Node* node) const {
+  if (!post_dominators_ordered_by_id_.contains(node)) {
+    std::vector<Node*>& post_dominators = post_dominators_ordered_by_id_[node];
+    const InlineBitmap& bitmap = dataflow_.bitmap(node);
+    for (int64_t i = 0; i < dataflow_.node_count(); ++i) {
+      if (bitmap.Get(i)) {
+        post_dominators.push_back(dataflow_.node(i));
       }
     }
+    std::sort(post_dominators.begin(), post_dominators.end(),
+              [](Node* a, Node* b) { return a->id() < b->id(); });
+  }
+  return post_dominators_ordered_by_id_.at(node);
+}
 
-    // Advance all list indices which hold the minimum value.
-    int64_t match_count = 0;
-    for (int64_t i = 0; i < lists.size(); ++i) {
-      if (lists[i][indices[i]] == min_value) {
-        indices[i]++;
-        match_count++;
+absl::Span<Node* const> PostDominatorAnalysis::GetNodesPostDominatedByNode(
+    const Node* node) const {
+  if (!dominated_nodes_ordered_by_id_.contains(node)) {
+    std::vector<Node*>& dominated_nodes = dominated_nodes_ordered_by_id_[node];
+    const int64_t node_index = dataflow_.node_index(node);
+    for (int64_t i = 0; i < dataflow_.node_count(); ++i) {
+      Node* dominated = dataflow_.node(i);
+      if (dataflow_.bitmap(dominated).Get(node_index)) {
+        dominated_nodes.push_back(dominated);
       }
     }
-
-    // If all lists contained the minimum value then add the value to the
-    // intersection.
-    if (match_count == lists.size()) {
-      intersection.push_back(min_value);
-    }
+    std::sort(dominated_nodes.begin(), dominated_nodes.end(),
+              [](Node* a, Node* b) { return a->id() < b->id(); });
   }
-  return intersection;
+  return dominated_nodes_ordered_by_id_.at(node);
 }
 
-}  // namespace
-
-/* static */ absl::StatusOr<std::unique_ptr<PostDominatorAnalysis>>
-PostDominatorAnalysis::Run(FunctionBase* f) {
-  auto analysis = std::make_unique<PostDominatorAnalysis>();
-
-  // A reverse topological sort of the function nodes.
-  NodeIterator r = ReverseTopoSort(f);
-  std::vector<Node*> reverse_toposort(r.begin(), r.end());
-
-  // Map from node to index in a reverse topo sort.
-  absl::flat_hash_map<Node*, NodeIndex> node_index;
-  for (NodeIndex i = 0; i < reverse_toposort.size(); ++i) {
-    node_index[reverse_toposort[i]] = i;
-  }
-
-  // Construct the postdominators for each node. Postdominators are gathered as
-  // a sorted vector containing the node indices (in a reverse toposort) of the
-  // post dominator nodes.
-  absl::flat_hash_map<Node*, std::vector<NodeIndex>> postdominators;
-  for (NodeIndex i = 0; i < reverse_toposort.size(); ++i) {
-    Node* node = reverse_toposort[i];
-    std::vector<absl::Span<const NodeIndex>> user_postdominators;
-    for (Node* user : node->users()) {
-      user_postdominators.push_back(postdominators.at(user));
+absl::StatusOr<std::unique_ptr<PostDominatorAnalysis>>
+PostDominatorAnalysisCache::TakeOrRun(FunctionBase* f) {
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = cache_.find(f);
+    if (it != cache_.end()) {
+      std::unique_ptr<PostDominatorAnalysis> cached = std::move(it->second);
+      cache_.erase(it);
+      if (cached->ir_transform_count() == f->transform_count()) {
+        XLS_VLOG(3) << "Reusing cached PostDominatorAnalysis for "
+                    << f->name();
+        return std::move(cached);
+      }
+      // The entry is stale. It has been removed from the cache; fall through
+      // and recompute.
     }
-    // The postdominators of a node is the intersection of the lists of
-    // postdominators for its users plus the node itself.
-    postdominators[node] = IntersectSortedLists(user_postdominators);
-    postdominators[node].push_back(i);
   }
+  return PostDominatorAnalysis::Run(f);
+}
 
-  for (Node* node : f->nodes()) {
-    for (NodeIndex postdominator_index : postdominators[node]) {
-      Node* postdominator = reverse_toposort.at(postdominator_index);
-      analysis->dominated_node_to_post_dominators_[node].insert(postdominator);
-      analysis->post_dominator_to_dominated_nodes_[postdominator].insert(node);
-    }
+void PostDominatorAnalysisCache::Release(
+    std::unique_ptr<PostDominatorAnalysis> analysis) {
+  if (analysis == nullptr) {
+    return;
+  }
+  FunctionBase* f = analysis->function_base();
+  if (analysis->ir_transform_count() != f->transform_count()) {
+    // The function was restructured after the analysis was computed so the
+    // result is stale. Drop the object.
+    return;
   }
+  absl::MutexLock lock(&mutex_);
+  cache_[f] = std::move(analysis);
+}
 
-  // Order nodes.
-  auto generate_ordered_by_id_nodes =
-      [](const absl::flat_hash_map<Node*, absl::flat_hash_set<Node*>>&
-             node_to_node_set,
-         absl::flat_hash_map<Node*, std::vector<Node*>>* node_to_node_vect) {
-        for (auto& [base_node, node_set] : node_to_node_set) {
-          auto& node_vect = (*node_to_node_vect)[base_node];
-          node_vect.insert(node_vect.begin(), node_set.begin(), node_set.end());
-          std::sort(node_vect.begin(), node_vect.end(),
-                    [](Node* a, Node* b) { return a->id() < b->id(); });
-        }
-      };
-  XLS_RET_CHECK(
-      analysis->dominated_node_to_post_dominators_ordered_by_id_.empty());
-  XLS_RET_CHECK(
-      analysis->post_dominator_to_dominated_nodes_ordered_by_id_.empty());
-  generate_ordered_by_id_nodes(
-      analysis->dominated_node_to_post_dominators_,
-      &analysis->dominated_node_to_post_dominators_ordered_by_id_);
-  generate_ordered_by_id_nodes(
-      analysis->post_dominator_to_dominated_nodes_,
-      &analysis->post_dominator_to_dominated_nodes_ordered_by_id_);
+void PostDominatorAnalysisCache::Evict(FunctionBase* f) {
+  absl::MutexLock lock(&mutex_);
+  cache_.erase(f);
+}
 
-  return std::move(analysis);
+/* static */ PostDominatorAnalysisCache& PostDominatorAnalysisCache::Global() {
+  static PostDominatorAnalysisCache* cache = []() {
+    auto* c = new PostDominatorAnalysisCache;
+    // Evict entries as their function is destroyed so a later function
+    // reusing the address can never hit them.
+    FunctionBase::RegisterDestructionObserver([](FunctionBase* f) {
+      PostDominatorAnalysisCache::Global().Evict(f);
+    });
+    return c;
+  }();
+  return *cache;
 }
 
 }  // namespace xls
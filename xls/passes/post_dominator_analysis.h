@@ -15,51 +15,112 @@
 #ifndef XLS_PASSES_POSTDOMINATOR_FUNCTION_H_
 #define XLS_PASSES_POSTDOMINATOR_FUNCTION_H_
 
-#include "absl/container/flat_hash_set.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xls/ir/function.h"
 #include "xls/ir/node.h"
+#include "xls/ir/node_map.h"
+#include "xls/passes/backward_dataflow.h"
 
 namespace xls {
 
 // A class for post-dominator analysis of the IR instructions in a function.
+// Post-dominator sets are held as dense bitsets (see
+// BackwardBitsetDataflow) so the pairwise queries are a single bit test and
+// memory is one bit per node pair rather than a hash set entry.
 class PostDominatorAnalysis {
  public:
   // Performs post-dominator analysis on the function and returns the result.
   static absl::StatusOr<std::unique_ptr<PostDominatorAnalysis>> Run(
       FunctionBase* f);
 
-  // Returns the nodes that post-dominate this node.
-  absl::Span<Node* const> GetPostDominatorsOfNode(const Node* node) const {
-    return dominated_node_to_post_dominators_ordered_by_id_.at(node);
-  }
-  // Returns the nodes that are post-dominated by this node.
-  absl::Span<Node* const> GetNodesPostDominatedByNode(const Node* node) const {
-    return post_dominator_to_dominated_nodes_ordered_by_id_.at(node);
-  }
+  // Returns the nodes that post-dominate this node, ordered by node id.
+  absl::Span<Node* const> GetPostDominatorsOfNode(const Node* node) const;
+  // Returns the nodes that are post-dominated by this node, ordered by node
+  // id.
+  absl::Span<Node* const> GetNodesPostDominatedByNode(const Node* node) const;
+
   // Returns true if 'node' is post-dominated by 'post_dominator'.
   bool NodeIsPostDominatedBy(const Node* node,
                              const Node* post_dominator) const {
-    return dominated_node_to_post_dominators_.at(node).contains(post_dominator);
+    return dataflow_.bitmap(node).Get(dataflow_.node_index(post_dominator));
   }
   // Returns true if 'node' post_dominates 'post_dominated'.
   bool NodePostDominates(const Node* node, const Node* post_dominated) const {
-    return post_dominator_to_dominated_nodes_.at(node).contains(post_dominated);
+    return dataflow_.bitmap(post_dominated).Get(dataflow_.node_index(node));
   }
 
+  // The function this analysis was computed over, and the function's
+  // transform count (FunctionBase::transform_count) at the time. Used by
+  // PostDominatorAnalysisCache to detect stale results.
+  FunctionBase* function_base() const { return function_base_; }
+  int64_t ir_transform_count() const { return ir_transform_count_; }
+
+ private:
+  FunctionBase* function_base_;
+  int64_t ir_transform_count_;
+
+  // Per-node post-dominator bitsets over dense reverse-toposort indices.
+  BackwardBitsetDataflow dataflow_;
+
+  // Id-ordered node vectors materialized from the bitsets on first request.
+  // Only the span-returning accessors need them; the pairwise queries used on
+  // the pass hot paths go directly to the bitsets. Mutable as the accessors
+  // are const.
+  mutable NodeMap<std::vector<Node*>> post_dominators_ordered_by_id_;
+  mutable NodeMap<std::vector<Node*>> dominated_nodes_ordered_by_id_;
+};
+
+// A cache of PostDominatorAnalysis results which persists across pass
+// invocations, mirroring BddFunctionCache (bdd_function_cache.h). When a
+// function has not been restructured (FunctionBase::transform_count) since
+// its analysis was computed, the cached result is reused instead of
+// recomputed.
+//
+// Entries are handed out with checkout semantics: TakeOrRun removes the entry
+// from the cache and transfers ownership to the caller, and Release returns
+// it. This keeps each analysis exclusively owned while in use (the
+// span-returning queries materialize ordered node lists lazily), so the cache
+// is safe to share between concurrently executing passes.
+//
+// The Global() instance evicts entries when their FunctionBase is destroyed
+// (via a FunctionBase destruction observer). A locally constructed instance
+// has no such hook and must therefore be destroyed before the functions whose
+// entries it holds.
+class PostDominatorAnalysisCache {
+ public:
+  // Returns an analysis of 'f': the cached one if 'f' has not been
+  // restructured since it was computed, otherwise a freshly computed one.
+  // Ownership transfers to the caller; pass the object back via Release when
+  // done with it.
+  absl::StatusOr<std::unique_ptr<PostDominatorAnalysis>> TakeOrRun(
+      FunctionBase* f);
+
+  // Returns an analysis obtained from TakeOrRun to the cache for later reuse.
+  // The object is discarded if its function was restructured after the
+  // analysis was computed.
+  void Release(std::unique_ptr<PostDominatorAnalysis> analysis);
+
+  // Drops any cached entry for 'f'. Must be called when 'f' is destroyed:
+  // entries are keyed by pointer, so without eviction a new function reusing
+  // the heap address could be handed an analysis full of dangling Node*, and
+  // entries for dead functions would accumulate for the life of the process.
+  void Evict(FunctionBase* f);
+
+  // Process-wide cache shared by the passes using this analysis. Entries are
+  // keyed by FunctionBase pointer and validated against the function's
+  // current transform count; a FunctionBase destruction observer evicts
+  // entries when their function is destroyed, so a stale entry can never be
+  // returned for a reused address.
+  static PostDominatorAnalysisCache& Global();
+
  private:
-  // Maps from a node to all nodes that post-dominate the node.
-  absl::flat_hash_map<Node*, absl::flat_hash_set<Node*>>
-      dominated_node_to_post_dominators_;
-  absl::flat_hash_map<Node*, std::vector<Node*>>
-      dominated_node_to_post_dominators_ordered_by_id_;
-
-  // Maps from a node to all nodes that are post-dominated by the node.
-  absl::flat_hash_map<Node*, absl::flat_hash_set<Node*>>
-      post_dominator_to_dominated_nodes_;
-  absl::flat_hash_map<Node*, std::vector<Node*>>
-      post_dominator_to_dominated_nodes_ordered_by_id_;
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<FunctionBase*, std::unique_ptr<PostDominatorAnalysis>>
+      cache_ ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace xls
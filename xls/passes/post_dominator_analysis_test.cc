@@ -220,5 +220,68 @@ TEST_F(PostDominatorAnalysisTest, DisconnectedNode) {
               ElementsAre(x.node(), z.node()));
 }
 
+TEST_F(PostDominatorAnalysisTest, CacheReuseAndInvalidation) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(1));
+  fb.Not(fb.Not(x));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  PostDominatorAnalysisCache cache;
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<PostDominatorAnalysis> analysis,
+                           cache.TakeOrRun(f));
+  PostDominatorAnalysis* original = analysis.get();
+  cache.Release(std::move(analysis));
+
+  // Checking out again without restructuring returns the same object.
+  XLS_ASSERT_OK_AND_ASSIGN(analysis, cache.TakeOrRun(f));
+  EXPECT_EQ(analysis.get(), original);
+  cache.Release(std::move(analysis));
+
+  // Restructuring the function invalidates the cached entry.
+  XLS_ASSERT_OK(
+      f->MakeNode<Literal>(/*loc=*/absl::nullopt, Value(UBits(0, 1)))
+          .status());
+  XLS_ASSERT_OK_AND_ASSIGN(analysis, cache.TakeOrRun(f));
+  EXPECT_NE(analysis.get(), original);
+
+  // Releasing an analysis computed before a subsequent restructuring drops
+  // it.
+  PostDominatorAnalysis* recomputed = analysis.get();
+  XLS_ASSERT_OK(
+      f->MakeNode<Literal>(/*loc=*/absl::nullopt, Value(UBits(1, 1)))
+          .status());
+  cache.Release(std::move(analysis));
+  XLS_ASSERT_OK_AND_ASSIGN(analysis, cache.TakeOrRun(f));
+  EXPECT_NE(analysis.get(), recomputed);
+}
+
+TEST_F(PostDominatorAnalysisTest, GlobalCacheEvictsOnFunctionDestruction) {
+  // Populate the global cache with an entry, then destroy the package. The
+  // destruction observer must evict the entry so a later function reusing the
+  // heap address cannot hit it; a regression here shows up as a stale (and
+  // under sanitizers, dangling) analysis below.
+  {
+    auto p = CreatePackage();
+    FunctionBuilder fb(TestName(), p.get());
+    BValue x = fb.Param("x", p->GetBitsType(1));
+    fb.Not(fb.Not(x));
+    XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+    XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<PostDominatorAnalysis> analysis,
+                             PostDominatorAnalysisCache::Global().TakeOrRun(f));
+    PostDominatorAnalysisCache::Global().Release(std::move(analysis));
+  }
+
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(1));
+  fb.Not(x);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * g, fb.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<PostDominatorAnalysis> analysis,
+                           PostDominatorAnalysisCache::Global().TakeOrRun(g));
+  EXPECT_EQ(analysis->function_base(), g);
+  PostDominatorAnalysisCache::Global().Release(std::move(analysis));
+}
+
 }  // namespace
 }  // namespace xls
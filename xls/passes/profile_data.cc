@@ -0,0 +1,55 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/profile_data.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+
+namespace xls {
+
+/* static */ absl::StatusOr<ProfileData> ProfileData::Parse(
+    absl::string_view text) {
+  ProfileData data;
+  for (absl::string_view line : absl::StrSplit(text, '\n')) {
+    if (line.empty()) {
+      continue;
+    }
+    std::vector<absl::string_view> fields = absl::StrSplit(line, '\t');
+    int64_t execution_count;
+    if (fields.size() != 4 || !absl::SimpleAtoi(fields[2], &execution_count) ||
+        execution_count < 0) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Invalid profile line: \"%s\"", line));
+    }
+    // The node id (fields[0]) and accumulated cycles (fields[3]) are not
+    // retained; lookups are by name and only frequencies bias the passes.
+    int64_t& count = data.counts_by_name_[fields[1]];
+    count += execution_count;
+    data.max_execution_count_ = std::max(data.max_execution_count_, count);
+  }
+  return data;
+}
+
+int64_t ProfileData::GetExecutionCount(absl::string_view name) const {
+  auto it = counts_by_name_.find(name);
+  return it == counts_by_name_.end() ? 0 : it->second;
+}
+
+}  // namespace xls
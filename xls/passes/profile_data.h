@@ -0,0 +1,69 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_PASSES_PROFILE_DATA_H_
+#define XLS_PASSES_PROFILE_DATA_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "xls/ir/node.h"
+
+namespace xls {
+
+// Per-node execution frequencies captured from an instrumented run of the IR,
+// e.g. by JitProfiler (xls/jit/jit_profiler.h). Passes receive this through
+// PassOptions::profile_data and use it to bias heuristics toward frequently
+// executed code.
+class ProfileData {
+ public:
+  // Parses the tab-separated per-node format produced by
+  // JitProfiler::ToString(): one line per node,
+  // "<node id>\t<node name>\t<execution count>\t<accumulated cycles>".
+  // Blank lines are ignored.
+  static absl::StatusOr<ProfileData> Parse(absl::string_view text);
+
+  // Returns the execution count recorded for the given node, or zero if the
+  // node does not appear in the profile. Nodes are matched by name:
+  // optimization passes preserve the names of surviving nodes while node ids
+  // may be reassigned when the IR is serialized and reparsed between the
+  // profiled run and the optimizing run.
+  int64_t GetExecutionCount(const Node* node) const {
+    return GetExecutionCount(node->GetName());
+  }
+  int64_t GetExecutionCount(absl::string_view name) const;
+
+  // The largest execution count of any node in the profile; zero for an
+  // empty profile.
+  int64_t max_execution_count() const { return max_execution_count_; }
+
+  // True if the node executed at least half as often as the most frequently
+  // executed node in the profile. This is the shared definition of "hot" so
+  // heuristics remain consistent across passes.
+  bool IsHot(const Node* node) const {
+    return max_execution_count_ > 0 &&
+           GetExecutionCount(node) * 2 >= max_execution_count_;
+  }
+
+ private:
+  absl::flat_hash_map<std::string, int64_t> counts_by_name_;
+  int64_t max_execution_count_ = 0;
+};
+
+}  // namespace xls
+
+#endif  // XLS_PASSES_PROFILE_DATA_H_
@@ -0,0 +1,61 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/profile_data.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+
+namespace xls {
+namespace {
+
+using status_testing::StatusIs;
+using ::testing::HasSubstr;
+
+TEST(ProfileDataTest, ParseAndLookup) {
+  XLS_ASSERT_OK_AND_ASSIGN(ProfileData data,
+                           ProfileData::Parse("1\tadd.1\t100\t2345\n"
+                                              "2\tumul.2\t10\t999\n"));
+  EXPECT_EQ(data.GetExecutionCount("add.1"), 100);
+  EXPECT_EQ(data.GetExecutionCount("umul.2"), 10);
+  EXPECT_EQ(data.GetExecutionCount("not_profiled"), 0);
+  EXPECT_EQ(data.max_execution_count(), 100);
+}
+
+TEST(ProfileDataTest, EmptyProfile) {
+  XLS_ASSERT_OK_AND_ASSIGN(ProfileData data, ProfileData::Parse(""));
+  EXPECT_EQ(data.max_execution_count(), 0);
+  EXPECT_EQ(data.GetExecutionCount("add.1"), 0);
+}
+
+TEST(ProfileDataTest, DuplicateNamesAccumulate) {
+  XLS_ASSERT_OK_AND_ASSIGN(ProfileData data,
+                           ProfileData::Parse("1\tadd.1\t60\t100\n"
+                                              "1\tadd.1\t40\t100\n"));
+  EXPECT_EQ(data.GetExecutionCount("add.1"), 100);
+  EXPECT_EQ(data.max_execution_count(), 100);
+}
+
+TEST(ProfileDataTest, MalformedLineIsError) {
+  EXPECT_THAT(ProfileData::Parse("1\tadd.1\t100\n").status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Invalid profile line")));
+  EXPECT_THAT(ProfileData::Parse("1\tadd.1\tbogus\t100\n").status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Invalid profile line")));
+}
+
+}  // namespace
+}  // namespace xls
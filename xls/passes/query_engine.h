@@ -73,6 +73,15 @@ enum class ReachedFixpoint { Unchanged, Changed, Unknown };
 // necessarily equal.
 class QueryEngine {
  public:
+  // The analysis strategy used by a query engine's Populate method. With
+  // kEager, Populate analyzes every node in the function up front. With
+  // kLazy, Populate only records the function, and a node's fanin cone is
+  // analyzed (with the result memoized) on the first query of that node. Lazy
+  // analysis is profitable when consumers query only a fraction of the nodes
+  // in the function. Engines which do not support lazy analysis ignore the
+  // mode and analyze eagerly.
+  enum class AnalysisMode { kEager, kLazy };
+
   virtual ~QueryEngine() = default;
 
   virtual absl::StatusOr<ReachedFixpoint> Populate(FunctionBase* f) = 0;
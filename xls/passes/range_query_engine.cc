@@ -14,17 +14,26 @@
 
 #include "xls/passes/range_query_engine.h"
 
+#include <algorithm>
 #include <limits>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/hash/hash.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/data_structures/leaf_type_tree.h"
 #include "xls/ir/abstract_node_evaluator.h"
 #include "xls/ir/bits_ops.h"
 #include "xls/ir/dfs_visitor.h"
 #include "xls/ir/node_iterator.h"
+#include "xls/ir/package.h"
 
 namespace xls {
 
@@ -357,10 +366,130 @@ IntervalSet MinimizeIntervals(IntervalSet intervals, int64_t size) {
   return result;
 }
 
+absl::optional<std::vector<IntervalSet>> RangeAnalysisCache::Lookup(
+    absl::string_view cone_text) {
+  absl::MutexLock lock(&mutex_);
+  auto it = cache_.find(cone_text);
+  if (it == cache_.end()) {
+    return absl::nullopt;
+  }
+  return it->second;
+}
+
+void RangeAnalysisCache::Insert(absl::string_view cone_text,
+                                const IntervalSetTree& interval_sets) {
+  absl::MutexLock lock(&mutex_);
+  if (cache_.size() >= kMaxEntries) {
+    cache_.clear();
+  }
+  cache_.insert_or_assign(
+      std::string(cone_text),
+      std::vector<IntervalSet>(interval_sets.elements().begin(),
+                               interval_sets.elements().end()));
+}
+
+/* static */ RangeAnalysisCache& RangeAnalysisCache::Global() {
+  static RangeAnalysisCache* cache = new RangeAnalysisCache;
+  return *cache;
+}
+
+namespace {
+
+// Bound on the size of a fanin cone that is cached. Nodes with larger cones
+// are simply recomputed; the bound keeps the cost of assembling the cache
+// keys linear in the function size.
+constexpr int64_t kMaxCachedConeNodes = 256;
+
+}  // namespace
+
 absl::StatusOr<ReachedFixpoint> RangeQueryEngine::Populate(FunctionBase* f) {
   RangeQueryVisitor visitor(this);
-  XLS_RETURN_IF_ERROR(f->Accept(&visitor));
-  return visitor.GetReachedFixpoint();
+  // Cached results may only be used when no interval sets have been seeded via
+  // `SetIntervalSetTree` before population, as seeded values are not captured
+  // by the cone texts.
+  if (cache_ == nullptr || !interval_sets_.empty()) {
+    XLS_RETURN_IF_ERROR(f->Accept(&visitor));
+    return visitor.GetReachedFixpoint();
+  }
+
+  ReachedFixpoint rf = ReachedFixpoint::Unchanged;
+  // Per node, the nodes of its fanin cone (node included), or `absl::nullopt`
+  // when the cone exceeds `kMaxCachedConeNodes` and the node is left
+  // uncached.
+  absl::flat_hash_map<Node*, absl::optional<std::vector<Node*>>> cones;
+  absl::flat_hash_map<Node*, int64_t> topo_index;
+  cones.reserve(f->node_count());
+  topo_index.reserve(f->node_count());
+  int64_t next_topo_index = 0;
+  for (Node* node : TopoSort(f)) {
+    topo_index[node] = next_topo_index++;
+
+    absl::optional<std::vector<Node*>> cone = std::vector<Node*>({node});
+    absl::flat_hash_set<Node*> cone_members = {node};
+    for (Node* operand : node->operands()) {
+      const absl::optional<std::vector<Node*>>& operand_cone =
+          cones.at(operand);
+      if (!operand_cone.has_value()) {
+        cone = absl::nullopt;
+        break;
+      }
+      for (Node* member : *operand_cone) {
+        if (cone_members.insert(member).second) {
+          cone->push_back(member);
+        }
+      }
+      if (static_cast<int64_t>(cone->size()) > kMaxCachedConeNodes) {
+        cone = absl::nullopt;
+        break;
+      }
+    }
+    if (!cone.has_value()) {
+      cones[node] = absl::nullopt;
+      XLS_RETURN_IF_ERROR(node->VisitSingleNode(&visitor));
+      continue;
+    }
+
+    // The key is the verbatim text of the entire fanin cone in topological
+    // order: each node's `ToString` captures its op, type, and op-specific
+    // attributes and refers to its operands by name, and the operands'
+    // defining lines precede it in the key, so equal keys imply identical
+    // cones. The interval sets of a node depend only on its fanin cone, so a
+    // hit is always valid to reuse.
+    std::sort(cone->begin(), cone->end(), [&](Node* a, Node* b) {
+      return topo_index.at(a) < topo_index.at(b);
+    });
+    std::string cone_text =
+        absl::StrJoin(*cone, "\n", [](std::string* out, Node* n) {
+          absl::StrAppend(out, n->ToString());
+        });
+    cones[node] = std::move(cone);
+
+    if (absl::optional<std::vector<IntervalSet>> cached =
+            cache_->Lookup(cone_text)) {
+      InitializeNode(node);
+      // Rebuild the tree against this node's own (package-owned) shape; the
+      // cached entry may originate from another package whose shape
+      // descriptors no longer exist.
+      IntervalSetTree tree(node->package()->GetLeafTypeShape(node->GetType()),
+                           *cached);
+      SetIntervalSetTree(node, tree);
+      for (const IntervalSet& set : tree.elements()) {
+        if (!set.IsMaximal()) {
+          rf = ReachedFixpoint::Changed;
+        }
+      }
+      continue;
+    }
+
+    XLS_RETURN_IF_ERROR(node->VisitSingleNode(&visitor));
+    if (interval_sets_.contains(node)) {
+      cache_->Insert(cone_text, interval_sets_.at(node));
+    }
+  }
+  if (visitor.GetReachedFixpoint() == ReachedFixpoint::Changed) {
+    rf = ReachedFixpoint::Changed;
+  }
+  return rf;
 }
 
 IntervalSetTree RangeQueryEngine::GetIntervalSetTree(Node* node) const {
@@ -368,8 +497,12 @@ IntervalSetTree RangeQueryEngine::GetIntervalSetTree(Node* node) const {
     return interval_sets_.at(node);
   }
 
+  // Share the package-cached shape descriptor rather than rebuilding the
+  // type-shape metadata for every node.
+  const LeafTypeShape* shape =
+      node->package()->GetLeafTypeShape(node->GetType());
   if (node->GetType()->IsTuple() || node->GetType()->IsArray()) {
-    IntervalSetTree result(node->GetType());
+    IntervalSetTree result(shape);
     int64_t i = 0;
     for (Type* type : result.leaf_types()) {
       int64_t size = type->GetFlatBitCount();
@@ -380,7 +513,7 @@ IntervalSetTree RangeQueryEngine::GetIntervalSetTree(Node* node) const {
   }
 
   int64_t size = node->GetType()->GetFlatBitCount();
-  IntervalSetTree result(node->GetType());
+  IntervalSetTree result(shape);
   result.Set({}, IntervalSet::Maximal(size));
   return result;
 }
@@ -15,11 +15,17 @@
 #ifndef XLS_PASSES_RANGE_QUERY_ENGINE_H_
 #define XLS_PASSES_RANGE_QUERY_ENGINE_H_
 
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
 #include "absl/container/btree_set.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 #include "xls/data_structures/leaf_type_tree.h"
 #include "xls/ir/bits.h"
@@ -28,6 +34,7 @@
 #include "xls/ir/function.h"
 #include "xls/ir/interval.h"
 #include "xls/ir/interval_set.h"
+#include "xls/ir/node_map.h"
 #include "xls/ir/nodes.h"
 #include "xls/passes/query_engine.h"
 
@@ -37,11 +44,54 @@ using IntervalSetTree = LeafTypeTree<IntervalSet>;
 
 class RangeQueryVisitor;
 
+// A cache of range analysis results which persists across
+// `RangeQueryEngine::Populate` invocations. Entries are keyed by the full
+// text of the node's fanin cone (the `ToString` of every node in the cone,
+// concatenated in topological order), so a result computed in an earlier pass
+// invocation is reused only for a cone that is verifiably identical to the
+// one it was computed from; key hashing is internal to the map and a
+// collision can only cause a miss, never a wrong result. Nodes along changed
+// def-use chains produce different cone texts and are simply recomputed; no
+// explicit invalidation is required. Nodes whose cones exceed an internal
+// size bound are not cached. Thread-safe.
+//
+// Entries hold only the flat leaf interval sets, not an IntervalSetTree: a
+// tree's shape descriptor is owned by the package it was built in, so caching
+// one would dangle once that package is destroyed. The caller rebuilds the
+// tree against the looked-up node's own type, which is safe even when the hit
+// comes from a different (possibly since-destroyed) package.
+class RangeAnalysisCache {
+ public:
+  // Returns the leaf interval sets cached under the given cone text (in
+  // IntervalSetTree element order), or `absl::nullopt` on a miss.
+  absl::optional<std::vector<IntervalSet>> Lookup(absl::string_view cone_text);
+
+  // Caches the leaf interval sets of the given tree under the given cone
+  // text.
+  void Insert(absl::string_view cone_text,
+              const IntervalSetTree& interval_sets);
+
+  // Returns a process-wide cache instance.
+  static RangeAnalysisCache& Global();
+
+ private:
+  // Bound on the number of cached entries. The cache is emptied when the
+  // bound is exceeded.
+  static constexpr int64_t kMaxEntries = 1 << 16;
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::vector<IntervalSet>> cache_
+      ABSL_GUARDED_BY(mutex_);
+};
+
 // A query engine which tracks sets of intervals that a value can be in.
 class RangeQueryEngine : public QueryEngine {
  public:
-  // Create a `RangeQueryEngine` that contains no data.
-  RangeQueryEngine() {}
+  // Create a `RangeQueryEngine` that contains no data. If `cache` is not null,
+  // `Populate` reuses results cached from earlier invocations where possible
+  // and contributes newly computed results back to the cache.
+  explicit RangeQueryEngine(RangeAnalysisCache* cache = nullptr)
+      : cache_(cache) {}
 
   // Populate the data in this `RangeQueryEngine` using the
   // given `FunctionBase*`;
@@ -118,9 +168,12 @@ class RangeQueryEngine : public QueryEngine {
  private:
   friend class RangeQueryVisitor;
 
-  absl::flat_hash_map<Node*, Bits> known_bits_;
-  absl::flat_hash_map<Node*, Bits> known_bit_values_;
-  absl::flat_hash_map<Node*, IntervalSetTree> interval_sets_;
+  RangeAnalysisCache* cache_ = nullptr;
+  // Node-id indexed (NodeMap) tables; the visitor performs several lookups
+  // per evaluated node.
+  NodeMap<Bits> known_bits_;
+  NodeMap<Bits> known_bit_values_;
+  NodeMap<IntervalSetTree> interval_sets_;
 };
 
 // Reduce the size of the given `IntervalSet` to the given size.
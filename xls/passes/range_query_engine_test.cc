@@ -1012,5 +1012,70 @@ TEST_F(RangeQueryEngineTest, ZeroExtend) {
             BitsLTT(expr.node(), {Interval(UBits(500, 40), UBits(700, 40))}));
 }
 
+TEST_F(RangeQueryEngineTest, AnalysisCache) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+
+  BValue x = fb.Param("x", fb.package()->GetBitsType(8));
+  BValue lit = fb.Literal(UBits(3, 10));
+  BValue expr = fb.Add(fb.ZeroExtend(x, 10), lit);
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  RangeQueryEngine uncached;
+  XLS_ASSERT_OK(uncached.Populate(f));
+
+  // A cached engine computes the same results as an uncached one, both when
+  // populating the cache and when hitting it.
+  RangeAnalysisCache cache;
+  RangeQueryEngine first(&cache);
+  XLS_ASSERT_OK(first.Populate(f));
+  EXPECT_EQ(first.GetIntervalSetTree(expr.node()),
+            uncached.GetIntervalSetTree(expr.node()));
+
+  RangeQueryEngine second(&cache);
+  XLS_ASSERT_OK(second.Populate(f));
+  EXPECT_EQ(second.GetIntervalSetTree(expr.node()),
+            uncached.GetIntervalSetTree(expr.node()));
+
+  // Changing a node in the fanin cone changes the cone texts of the nodes
+  // downstream of it, so stale cache entries are not reused.
+  XLS_ASSERT_OK(
+      lit.node()->ReplaceUsesWithNew<Literal>(Value(UBits(5, 10))).status());
+  RangeQueryEngine after_change(&cache);
+  XLS_ASSERT_OK(after_change.Populate(f));
+  EXPECT_EQ(after_change.GetIntervalSetTree(expr.node()),
+            BitsLTT(expr.node(), {Interval(UBits(5, 10), UBits(260, 10))}));
+}
+
+TEST_F(RangeQueryEngineTest, AnalysisCacheOutlivesOriginatingPackage) {
+  // Cache entries hold no pointers into the package they were computed from:
+  // a hit from an identically built function in another package must be
+  // usable after the originating package has been destroyed.
+  auto build = [&](Package* p) -> absl::StatusOr<Function*> {
+    FunctionBuilder fb(TestName(), p);
+    BValue x = fb.Param("x", p->GetBitsType(8));
+    fb.Add(fb.ZeroExtend(x, 10), fb.Literal(UBits(3, 10)));
+    return fb.Build();
+  };
+
+  RangeAnalysisCache cache;
+  {
+    auto p = CreatePackage();
+    XLS_ASSERT_OK_AND_ASSIGN(Function * f, build(p.get()));
+    RangeQueryEngine engine(&cache);
+    XLS_ASSERT_OK(engine.Populate(f));
+  }
+
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * g, build(p.get()));
+  RangeQueryEngine uncached;
+  XLS_ASSERT_OK(uncached.Populate(g));
+  RangeQueryEngine cached(&cache);
+  XLS_ASSERT_OK(cached.Populate(g));
+  EXPECT_EQ(cached.GetIntervalSetTree(g->return_value()),
+            uncached.GetIntervalSetTree(g->return_value()));
+}
+
 }  // namespace
 }  // namespace xls
@@ -0,0 +1,56 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/region_parallelism.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "xls/data_structures/union_find_map.h"
+#include "xls/ir/node_iterator.h"
+
+namespace xls {
+
+std::vector<std::vector<Node*>> PartitionIntoWeaklyConnectedRegions(
+    FunctionBase* f) {
+  // Union each node with its operands; the resulting equivalence classes are
+  // the weakly-connected components of the dataflow graph. The mapped value is
+  // unused.
+  UnionFindMap<Node*, int64_t> components;
+  for (Node* node : f->nodes()) {
+    components.Insert(node, 0);
+  }
+  auto keep_first = [](int64_t a, int64_t b) { return a; };
+  for (Node* node : f->nodes()) {
+    for (Node* operand : node->operands()) {
+      components.Union(node, operand, keep_first);
+    }
+  }
+
+  // Assign region numbers in order of first appearance in a topological sort
+  // so that both the regions and the nodes within each region are
+  // topologically ordered.
+  std::vector<std::vector<Node*>> regions;
+  absl::flat_hash_map<Node*, int64_t> representative_to_region;
+  for (Node* node : TopoSort(f)) {
+    Node* representative = components.Find(node)->first;
+    auto [it, inserted] = representative_to_region.insert(
+        {representative, static_cast<int64_t>(regions.size())});
+    if (inserted) {
+      regions.push_back({});
+    }
+    regions[it->second].push_back(node);
+  }
+  return regions;
+}
+
+}  // namespace xls
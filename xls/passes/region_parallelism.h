@@ -0,0 +1,107 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_PASSES_REGION_PARALLELISM_H_
+#define XLS_PASSES_REGION_PARALLELISM_H_
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11): only for hardware_concurrency.
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
+
+namespace xls {
+
+// Partitions the nodes of `f` into the weakly-connected components of its
+// dataflow graph. Each region is returned in topological order and the
+// regions themselves are ordered by the topological position of their first
+// node, so iterating the regions in order visits every node in a valid
+// topological order.
+//
+// Weak connectivity is a coarse partition: a function whose nodes all feed a
+// single return value forms one region. Multiple regions typically arise in
+// procs with independent channel operations and in graphs containing
+// disconnected (e.g. dead) logic cones.
+std::vector<std::vector<Node*>> PartitionIntoWeaklyConnectedRegions(
+    FunctionBase* f);
+
+// Runs `analyze` over each of `regions` on worker threads and then invokes
+// `commit` with each region's analysis result serially in region order.
+// Returns true iff any commit invocation returns true.
+//
+// `analyze` must not mutate the IR or any other shared state; it typically
+// inspects the region's nodes and returns a list of planned rewrites which
+// `commit` applies. Single-region (or single-threaded) inputs are processed
+// inline without spawning threads.
+template <typename AnalysisT>
+absl::StatusOr<bool> AnalyzeRegionsInParallel(
+    absl::Span<const std::vector<Node*>> regions,
+    absl::FunctionRef<absl::StatusOr<AnalysisT>(absl::Span<Node* const>)>
+        analyze,
+    absl::FunctionRef<absl::StatusOr<bool>(AnalysisT)> commit) {
+  const int64_t region_count = regions.size();
+  std::vector<absl::StatusOr<AnalysisT>> analyses;
+  analyses.reserve(region_count);
+  for (int64_t i = 0; i < region_count; ++i) {
+    analyses.push_back(absl::StatusOr<AnalysisT>());
+  }
+
+  const int64_t num_threads = std::min(
+      region_count,
+      std::max(int64_t{1},
+               static_cast<int64_t>(std::thread::hardware_concurrency())));
+  if (num_threads <= 1) {
+    for (int64_t i = 0; i < region_count; ++i) {
+      analyses[i] = analyze(regions[i]);
+    }
+  } else {
+    // Each worker claims regions via the shared atomic counter and writes its
+    // results into disjoint slots of `analyses`, so no locking is needed.
+    std::atomic<int64_t> next_region{0};
+    std::vector<std::unique_ptr<Thread>> workers;
+    workers.reserve(num_threads);
+    for (int64_t i = 0; i < num_threads; ++i) {
+      workers.push_back(std::make_unique<Thread>([&]() {
+        int64_t region;
+        while ((region = next_region.fetch_add(
+                    1, std::memory_order_relaxed)) < region_count) {
+          analyses[region] = analyze(regions[region]);
+        }
+      }));
+    }
+    for (std::unique_ptr<Thread>& worker : workers) {
+      worker->Join();
+    }
+  }
+
+  bool changed = false;
+  for (int64_t i = 0; i < region_count; ++i) {
+    XLS_ASSIGN_OR_RETURN(AnalysisT analysis, std::move(analyses[i]));
+    XLS_ASSIGN_OR_RETURN(bool region_changed, commit(std::move(analysis)));
+    changed = changed || region_changed;
+  }
+  return changed;
+}
+
+}  // namespace xls
+
+#endif  // XLS_PASSES_REGION_PARALLELISM_H_
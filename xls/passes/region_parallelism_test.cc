@@ -0,0 +1,129 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/region_parallelism.h"
+
+#include <algorithm>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/function.h"
+#include "xls/ir/ir_test_base.h"
+
+namespace xls {
+namespace {
+
+using status_testing::IsOkAndHolds;
+using ::testing::UnorderedElementsAre;
+
+class RegionParallelismTest : public IrTestBase {};
+
+TEST_F(RegionParallelismTest, FullyConnectedFunctionIsOneRegion) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+     fn func(x: bits[42], y: bits[42]) -> bits[42] {
+       ret add.1: bits[42] = add(x, y)
+     }
+  )",
+                                                       p.get()));
+  std::vector<std::vector<Node*>> regions =
+      PartitionIntoWeaklyConnectedRegions(f);
+  ASSERT_EQ(regions.size(), 1);
+  EXPECT_EQ(regions[0].size(), f->node_count());
+}
+
+TEST_F(RegionParallelismTest, DisconnectedConesAreSeparateRegions) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+     fn func(x: bits[42], y: bits[42]) -> bits[42] {
+       neg.1: bits[42] = neg(y)
+       not.2: bits[42] = not(neg.1)
+       ret add.3: bits[42] = add(x, x)
+     }
+  )",
+                                                       p.get()));
+  std::vector<std::vector<Node*>> regions =
+      PartitionIntoWeaklyConnectedRegions(f);
+  ASSERT_EQ(regions.size(), 2);
+  // Every node appears in exactly one region and each region is topologically
+  // ordered.
+  int64_t total = 0;
+  for (const std::vector<Node*>& region : regions) {
+    total += region.size();
+    for (int64_t i = 0; i < static_cast<int64_t>(region.size()); ++i) {
+      for (Node* operand : region[i]->operands()) {
+        auto it = std::find(region.begin(), region.begin() + i, operand);
+        EXPECT_NE(it, region.begin() + i)
+            << operand->GetName() << " must precede " << region[i]->GetName();
+      }
+    }
+  }
+  EXPECT_EQ(total, f->node_count());
+}
+
+TEST_F(RegionParallelismTest, AnalyzeRegionsInParallel) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+     fn func(x: bits[42], y: bits[42]) -> bits[42] {
+       neg.1: bits[42] = neg(y)
+       not.2: bits[42] = not(neg.1)
+       ret add.3: bits[42] = add(x, x)
+     }
+  )",
+                                                       p.get()));
+  std::vector<std::vector<Node*>> regions =
+      PartitionIntoWeaklyConnectedRegions(f);
+  ASSERT_EQ(regions.size(), 2);
+
+  // The analysis phase counts each region's nodes; the commit phase runs
+  // serially and gathers the counts.
+  std::vector<int64_t> committed_counts;
+  absl::StatusOr<bool> changed = AnalyzeRegionsInParallel<int64_t>(
+      regions,
+      [](absl::Span<Node* const> region) -> absl::StatusOr<int64_t> {
+        return static_cast<int64_t>(region.size());
+      },
+      [&](int64_t count) -> absl::StatusOr<bool> {
+        committed_counts.push_back(count);
+        return count > 2;
+      });
+  EXPECT_THAT(changed, IsOkAndHolds(true));
+  // Region of add.3 holds {x, add.3}; region of not.2 holds {y, neg.1, not.2}.
+  EXPECT_THAT(committed_counts, UnorderedElementsAre(2, 3));
+}
+
+TEST_F(RegionParallelismTest, AnalysisErrorIsPropagated) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+     fn func(x: bits[42]) -> bits[42] {
+       ret neg.1: bits[42] = neg(x)
+     }
+  )",
+                                                       p.get()));
+  std::vector<std::vector<Node*>> regions =
+      PartitionIntoWeaklyConnectedRegions(f);
+  absl::StatusOr<bool> result = AnalyzeRegionsInParallel<int64_t>(
+      regions,
+      [](absl::Span<Node* const> region) -> absl::StatusOr<int64_t> {
+        return absl::InternalError("analysis failed");
+      },
+      [](int64_t count) -> absl::StatusOr<bool> { return false; });
+  EXPECT_THAT(result.status(),
+              status_testing::StatusIs(absl::StatusCode::kInternal));
+}
+
+}  // namespace
+}  // namespace xls
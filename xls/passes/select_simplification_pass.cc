@@ -971,10 +971,14 @@ absl::StatusOr<bool> SimplifyNode(Node* node, const QueryEngine& query_engine,
 // then that case is not selected.
 absl::StatusOr<bool> SpecializeSelectArms(FunctionBase* func) {
   // To avoid having to recompute post-dominator analysis which is expensive,
-  // gather all opporunities in the graph before making any changes.
+  // gather all opporunities in the graph before making any changes. The
+  // analysis is checked out of the process-wide cache so it is also reused
+  // across pass invocations when the function has not changed in between.
+  PostDominatorAnalysisCache& analysis_cache =
+      PostDominatorAnalysisCache::Global();
   XLS_ASSIGN_OR_RETURN(
       std::unique_ptr<PostDominatorAnalysis> post_dominator_analysis,
-      PostDominatorAnalysis::Run(func));
+      analysis_cache.TakeOrRun(func));
 
   // Gather all the selectors of all the Select nodes. Create a map from the
   // selector to the associated Select nodes. A selector may be used in more
@@ -1033,6 +1037,10 @@ absl::StatusOr<bool> SpecializeSelectArms(FunctionBase* func) {
     }
   }
 
+  // All queries are done; return the analysis to the cache before mutating
+  // the function so it can be reused if no transformation is made.
+  analysis_cache.Release(std::move(post_dominator_analysis));
+
   for (const SelectorUse& selector_use : selector_uses) {
     XLS_ASSIGN_OR_RETURN(
         Literal * literal,
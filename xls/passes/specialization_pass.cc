@@ -0,0 +1,130 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "xls/passes/specialization_pass.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/function.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+// Returns a name for a specialization of 'callee' which does not collide with
+// any function in 'package'.
+std::string SpecializationName(Package* package, Function* callee) {
+  std::string base = absl::StrCat(callee->name(), "__spec");
+  if (!package->GetFunction(base).ok()) {
+    return base;
+  }
+  for (int64_t i = 1;; ++i) {
+    std::string candidate = absl::StrCat(base, "_", i);
+    if (!package->GetFunction(candidate).ok()) {
+      return candidate;
+    }
+  }
+}
+
+// Key identifying a specialization: the callee plus the literal value (or
+// placeholder) bound to each argument position.
+std::string SpecializationKey(
+    Function* callee, absl::Span<const absl::optional<Value>> literal_args) {
+  return absl::StrCat(
+      callee->name(), "(",
+      absl::StrJoin(literal_args, ",",
+                    [](std::string* out, const absl::optional<Value>& value) {
+                      absl::StrAppend(
+                          out, value.has_value() ? value->ToString() : "_");
+                    }),
+      ")");
+}
+
+}  // namespace
+
+absl::StatusOr<bool> SpecializationPass::RunInternal(
+    Package* p, const PassOptions& options, PassResults* results) const {
+  // Snapshot the invokes up front; specializing adds functions to the
+  // package.
+  std::vector<Invoke*> invokes;
+  for (const std::unique_ptr<Function>& function : p->functions()) {
+    for (Node* node : function->nodes()) {
+      if (node->Is<Invoke>()) {
+        invokes.push_back(node->As<Invoke>());
+      }
+    }
+  }
+
+  bool changed = false;
+  absl::flat_hash_map<std::string, Function*> specializations;
+  for (Invoke* invoke : invokes) {
+    Function* callee = invoke->to_apply();
+    std::vector<absl::optional<Value>> literal_args;
+    literal_args.reserve(invoke->operand_count());
+    bool any_literal = false;
+    for (Node* operand : invoke->operands()) {
+      if (operand->Is<Literal>()) {
+        literal_args.push_back(operand->As<Literal>()->value());
+        any_literal = true;
+      } else {
+        literal_args.push_back(absl::nullopt);
+      }
+    }
+    if (!any_literal) {
+      continue;
+    }
+
+    std::string key = SpecializationKey(callee, literal_args);
+    Function* specialized;
+    auto it = specializations.find(key);
+    if (it != specializations.end()) {
+      specialized = it->second;
+    } else {
+      XLS_ASSIGN_OR_RETURN(specialized,
+                           callee->Clone(SpecializationName(p, callee)));
+      // Pin the parameters with literal arguments inside the clone; the
+      // parameters themselves stay (the signature is unchanged) but become
+      // dead.
+      for (int64_t i = 0; i < static_cast<int64_t>(literal_args.size()); ++i) {
+        if (literal_args[i].has_value()) {
+          XLS_RETURN_IF_ERROR(specialized->param(i)
+                                  ->ReplaceUsesWithNew<Literal>(
+                                      literal_args[i].value())
+                                  .status());
+        }
+      }
+      XLS_VLOG(2) << absl::StrCat("Specialized ", key, " as ",
+                                  specialized->name());
+      specializations[key] = specialized;
+    }
+    XLS_RETURN_IF_ERROR(
+        invoke->ReplaceUsesWithNew<Invoke>(invoke->operands(), specialized)
+            .status());
+    changed = true;
+  }
+  return changed;
+}
+
+}  // namespace xls
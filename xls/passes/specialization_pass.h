@@ -0,0 +1,49 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_PASSES_SPECIALIZATION_PASS_H_
+#define XLS_PASSES_SPECIALIZATION_PASS_H_
+
+#include "absl/status/statusor.h"
+#include "xls/passes/passes.h"
+
+namespace xls {
+
+// Specializes invoked functions on their literal arguments: each invoke with
+// at least one literal operand is retargeted at a clone of the callee in
+// which the corresponding parameters are replaced by those literals, giving
+// constant folding and narrowing a whole-program view of the call without
+// duplicating the callee's body at every call site the way inlining does.
+// Invokes passing the same literals to the same callee share one
+// specialization.
+//
+// This is primarily useful after linking separately converted packages
+// together (see xls/ir/package_linker.h), where cross-library calls commonly
+// pin configuration-style parameters to constants. The standard pipeline
+// inlines all invokes, so this pass is opt-in for flows which keep the
+// function boundaries.
+class SpecializationPass : public Pass {
+ public:
+  SpecializationPass()
+      : Pass("specialization", "Specializes invokes on literal arguments") {}
+  ~SpecializationPass() override = default;
+
+ protected:
+  absl::StatusOr<bool> RunInternal(Package* p, const PassOptions& options,
+                                   PassResults* results) const override;
+};
+
+}  // namespace xls
+
+#endif  // XLS_PASSES_SPECIALIZATION_PASS_H_
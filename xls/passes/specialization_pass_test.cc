@@ -0,0 +1,107 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/specialization_pass.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/value.h"
+#include "xls/passes/pass_base.h"
+
+namespace xls {
+namespace {
+
+using status_testing::IsOkAndHolds;
+
+class SpecializationPassTest : public IrTestBase {
+ protected:
+  absl::StatusOr<bool> Run(Package* p) {
+    PassResults results;
+    return SpecializationPass().Run(p, PassOptions(), &results);
+  }
+};
+
+TEST_F(SpecializationPassTest, SpecializesInvokeWithLiteralArg) {
+  auto p = CreatePackage();
+  FunctionBuilder fb("callee", p.get());
+  BValue a = fb.Param("a", p->GetBitsType(32));
+  BValue b = fb.Param("b", p->GetBitsType(32));
+  fb.Add(a, b);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * callee, fb.Build());
+
+  FunctionBuilder cb("caller", p.get());
+  BValue x = cb.Param("x", p->GetBitsType(32));
+  cb.Invoke({x, cb.Literal(UBits(7, 32))}, callee);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * caller, cb.Build());
+
+  EXPECT_THAT(Run(p.get()), IsOkAndHolds(true));
+  Invoke* invoke = caller->return_value()->As<Invoke>();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * specialized,
+                           p->GetFunction("callee__spec"));
+  EXPECT_EQ(invoke->to_apply(), specialized);
+  // Inside the specialization the pinned parameter is dead and the literal
+  // has taken its place.
+  EXPECT_TRUE(specialized->param(1)->users().empty());
+  Node* rhs = specialized->return_value()->operand(1);
+  ASSERT_TRUE(rhs->Is<Literal>());
+  EXPECT_EQ(rhs->As<Literal>()->value(), Value(UBits(7, 32)));
+}
+
+TEST_F(SpecializationPassTest, SharesSpecializationAcrossCallSites) {
+  auto p = CreatePackage();
+  FunctionBuilder fb("callee", p.get());
+  BValue a = fb.Param("a", p->GetBitsType(32));
+  BValue b = fb.Param("b", p->GetBitsType(32));
+  fb.Add(a, b);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * callee, fb.Build());
+
+  FunctionBuilder cb("caller", p.get());
+  BValue x = cb.Param("x", p->GetBitsType(32));
+  BValue y = cb.Param("y", p->GetBitsType(32));
+  BValue lit = cb.Literal(UBits(3, 32));
+  cb.Add(cb.Invoke({x, lit}, callee), cb.Invoke({y, lit}, callee));
+  XLS_ASSERT_OK(cb.Build().status());
+
+  EXPECT_THAT(Run(p.get()), IsOkAndHolds(true));
+  // Both call sites share one specialization: callee, caller and the clone.
+  EXPECT_EQ(p->functions().size(), 3);
+}
+
+TEST_F(SpecializationPassTest, NoLiteralArgsNoChange) {
+  auto p = CreatePackage();
+  FunctionBuilder fb("callee", p.get());
+  BValue a = fb.Param("a", p->GetBitsType(32));
+  BValue b = fb.Param("b", p->GetBitsType(32));
+  fb.Add(a, b);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * callee, fb.Build());
+
+  FunctionBuilder cb("caller", p.get());
+  BValue x = cb.Param("x", p->GetBitsType(32));
+  BValue y = cb.Param("y", p->GetBitsType(32));
+  cb.Invoke({x, y}, callee);
+  XLS_ASSERT_OK(cb.Build().status());
+
+  EXPECT_THAT(Run(p.get()), IsOkAndHolds(false));
+  EXPECT_EQ(p->functions().size(), 2);
+}
+
+}  // namespace
+}  // namespace xls
@@ -17,7 +17,10 @@
 
 #include "xls/passes/standard_pipeline.h"
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
 #include "xls/passes/arith_simplification_pass.h"
 #include "xls/passes/array_simplification_pass.h"
 #include "xls/passes/useless_assert_removal_pass.h"
@@ -30,10 +33,12 @@
 #include "xls/passes/constant_folding_pass.h"
 #include "xls/passes/cse_pass.h"
 #include "xls/passes/dce_pass.h"
+#include "xls/passes/dead_proc_elimination_pass.h"
 #include "xls/passes/dfe_pass.h"
 #include "xls/passes/identity_removal_pass.h"
 #include "xls/passes/inlining_pass.h"
 #include "xls/passes/literal_uncommoning_pass.h"
+#include "xls/passes/lut_mapping_pass.h"
 #include "xls/passes/map_inlining_pass.h"
 #include "xls/passes/narrowing_pass.h"
 #include "xls/passes/reassociation_pass.h"
@@ -84,38 +89,91 @@ class SimplificationPass : public FixedPointCompoundPass {
   }
 };
 
-std::unique_ptr<CompoundPass> CreateStandardPassPipeline(int64_t opt_level) {
+/* static */ PipelineProfile PipelineProfile::O1() {
+  PipelineProfile profile;
+  profile.opt_level = 1;
+  profile.simplification_rounds = 1;
+  profile.run_bdd_passes = false;
+  return profile;
+}
+
+/* static */ PipelineProfile PipelineProfile::O2() { return PipelineProfile(); }
+
+/* static */ PipelineProfile PipelineProfile::O3() {
+  PipelineProfile profile;
+  // Give the BDD-based passes four times the path budget; path counts are
+  // the dominant cost and quality knob of these passes.
+  profile.bdd_path_limit = 4 * BddFunction::kDefaultPathLimit;
+  return profile;
+}
+
+/* static */ absl::StatusOr<PipelineProfile> PipelineProfile::ForName(
+    absl::string_view name) {
+  std::string upper = absl::AsciiStrToUpper(name);
+  if (upper == "O1") {
+    return O1();
+  }
+  if (upper == "O2") {
+    return O2();
+  }
+  if (upper == "O3") {
+    return O3();
+  }
+  return absl::InvalidArgumentError(absl::StrCat(
+      "Unknown optimization profile: \"", name, "\"; expected O1, O2, or O3"));
+}
+
+std::unique_ptr<CompoundPass> CreatePassPipeline(
+    const PipelineProfile& profile) {
   auto top = std::make_unique<CompoundPass>("ir", "Top level pass pipeline");
   top->AddInvariantChecker<VerifierChecker>();
 
   top->Add<DeadFunctionEliminationPass>();
+  top->Add<DeadProcEliminationPass>();
   top->Add<DeadCodeEliminationPass>();
   top->Add<IdentityRemovalPass>();
   // At this stage in the pipeline only optimizations up to level 2 should
   // run. 'opt_level' is the maximum level of optimization which should be run
   // in the entire pipeline so set the level of the simplification pass to the
   // minimum of the two values. Same below.
-  top->Add<SimplificationPass>(std::min(int64_t{2}, opt_level));
+  top->Add<SimplificationPass>(std::min(int64_t{2}, profile.opt_level));
   top->Add<UnrollPass>();
   top->Add<MapInliningPass>();
-  top->Add<InliningPass>();
+  if (profile.inlining_budget.has_value()) {
+    top->Add<InliningPass>(*profile.inlining_budget);
+  } else {
+    top->Add<InliningPass>();
+  }
   top->Add<DeadFunctionEliminationPass>();
-  top->Add<BddSimplificationPass>(std::min(int64_t{2}, opt_level));
-  top->Add<DeadCodeEliminationPass>();
-  top->Add<BddCsePass>();
-  top->Add<DeadCodeEliminationPass>();
-  top->Add<SimplificationPass>(std::min(int64_t{2}, opt_level));
-
-  top->Add<BddSimplificationPass>(std::min(int64_t{3}, opt_level));
-  top->Add<DeadCodeEliminationPass>();
-  top->Add<BddCsePass>();
-  top->Add<DeadCodeEliminationPass>();
-  top->Add<SimplificationPass>(std::min(int64_t{3}, opt_level));
+  for (int64_t round = 0; round < profile.simplification_rounds; ++round) {
+    int64_t level = std::min(int64_t{2} + round, profile.opt_level);
+    if (profile.run_bdd_passes) {
+      top->Add<BddSimplificationPass>(level, profile.bdd_path_limit);
+      top->Add<DeadCodeEliminationPass>();
+      top->Add<BddCsePass>(profile.bdd_path_limit);
+      top->Add<DeadCodeEliminationPass>();
+    }
+    top->Add<SimplificationPass>(level);
+  }
+  if (profile.lut_width > 0) {
+    // Technology mapping runs after all boolean optimization and before
+    // literal uncommoning so the truth-table literals it creates are handled
+    // like any other literal during codegen preparation.
+    top->Add<LutMappingPass>(profile.lut_width);
+    top->Add<DeadCodeEliminationPass>();
+  }
   top->Add<LiteralUncommoningPass>();
   top->Add<DeadFunctionEliminationPass>();
+  top->Add<DeadProcEliminationPass>();
   return top;
 }
 
+std::unique_ptr<CompoundPass> CreateStandardPassPipeline(int64_t opt_level) {
+  PipelineProfile profile = PipelineProfile::O2();
+  profile.opt_level = opt_level;
+  return CreatePassPipeline(profile);
+}
+
 absl::StatusOr<bool> RunStandardPassPipeline(Package* package,
                                              int64_t opt_level) {
   std::unique_ptr<CompoundPass> pipeline = CreateStandardPassPipeline();
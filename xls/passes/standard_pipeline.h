@@ -16,12 +16,63 @@
 #define XLS_PASSES_STANDARD_PIPELINE_H_
 
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "xls/passes/bdd_function.h"
 #include "xls/passes/passes.h"
 
 namespace xls {
 
+// A named configuration of the standard pass pipeline grouping the pass
+// schedule with its budget knobs. Profiles trade optimization quality for
+// compile time:
+//
+//   O1: fast. A single fixed-point simplification round around inlining and
+//       no BDD-based passes.
+//   O2: the standard pipeline with default budgets.
+//   O3: the standard pipeline with extra BDD path budget.
+struct PipelineProfile {
+  // Maximum optimization level passed to the constituent passes (see
+  // NarrowingEnabled()/SplitsEnabled() in passes.h).
+  int64_t opt_level = kMaxOptLevel;
+
+  // Number of post-inlining simplification rounds. Round i runs at
+  // optimization level min(2 + i, opt_level), matching the staging of the
+  // standard pipeline.
+  int64_t simplification_rounds = 2;
+
+  // Whether BDD-based passes (bdd_simp, bdd_cse) run at all, and the path
+  // limit for the BDDs they construct.
+  bool run_bdd_passes = true;
+  int64_t bdd_path_limit = BddFunction::kDefaultPathLimit;
+
+  // Node growth budget for inlining; nullopt inlines unconditionally (see
+  // InliningPass).
+  absl::optional<int64_t> inlining_budget;
+
+  // If positive, a technology-mapping stage runs after optimization which
+  // maps single-bit boolean clouds onto lookup tables with this many inputs
+  // (see LutMappingPass). Zero (the default) disables the stage; it is
+  // intended for FPGA flows whose downstream synthesis consumes LUT
+  // structures directly.
+  int64_t lut_width = 0;
+
+  static PipelineProfile O1();
+  static PipelineProfile O2();
+  static PipelineProfile O3();
+
+  // Resolves a profile by name ("O1", "O2", "O3"; case-insensitive). Returns
+  // an error for unknown names.
+  static absl::StatusOr<PipelineProfile> ForName(absl::string_view name);
+};
+
+// Creates the pass pipeline described by the given profile.
+std::unique_ptr<CompoundPass> CreatePassPipeline(
+    const PipelineProfile& profile);
+
 // CreateStandardPassPipeline connects together the various optimization
-// and analysis passes in the order of execution.
+// and analysis passes in the order of execution. Equivalent to
+// CreatePassPipeline with the O2 profile at the given opt_level.
 std::unique_ptr<CompoundPass> CreateStandardPassPipeline(
     int64_t opt_level = kMaxOptLevel);
 
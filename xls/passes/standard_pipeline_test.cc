@@ -86,6 +86,64 @@ class StandardPipelineTest : public IrTestBase {
   }
 };
 
+// Returns true if the pipeline contains a pass with the given short name.
+bool PipelineContainsPass(CompoundPass* pipeline,
+                          absl::string_view short_name) {
+  for (Pass* pass : pipeline->passes()) {
+    if (pass->short_name() == short_name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+TEST_F(StandardPipelineTest, ProfileForName) {
+  XLS_ASSERT_OK_AND_ASSIGN(PipelineProfile o1, PipelineProfile::ForName("O1"));
+  EXPECT_EQ(o1.opt_level, 1);
+  EXPECT_FALSE(o1.run_bdd_passes);
+  XLS_ASSERT_OK_AND_ASSIGN(PipelineProfile o3, PipelineProfile::ForName("o3"));
+  EXPECT_EQ(o3.opt_level, kMaxOptLevel);
+  EXPECT_GT(o3.bdd_path_limit, PipelineProfile::O2().bdd_path_limit);
+  EXPECT_FALSE(PipelineProfile::ForName("O4").ok());
+}
+
+TEST_F(StandardPipelineTest, ProfilePipelines) {
+  std::unique_ptr<CompoundPass> o1 =
+      CreatePassPipeline(PipelineProfile::O1());
+  EXPECT_FALSE(PipelineContainsPass(o1.get(), "bdd_simp"));
+  EXPECT_FALSE(PipelineContainsPass(o1.get(), "bdd_cse"));
+  EXPECT_TRUE(PipelineContainsPass(o1.get(), "simp"));
+
+  std::unique_ptr<CompoundPass> o2 =
+      CreatePassPipeline(PipelineProfile::O2());
+  EXPECT_TRUE(PipelineContainsPass(o2.get(), "bdd_simp"));
+  EXPECT_TRUE(PipelineContainsPass(o2.get(), "bdd_cse"));
+  // The O2 profile produces the same schedule as the standard pipeline.
+  std::unique_ptr<CompoundPass> standard = CreateStandardPassPipeline();
+  ASSERT_EQ(o2->passes().size(), standard->passes().size());
+  for (int64_t i = 0; i < o2->passes().size(); ++i) {
+    EXPECT_EQ(o2->passes()[i]->short_name(),
+              standard->passes()[i]->short_name());
+  }
+}
+
+TEST_F(StandardPipelineTest, O1ProfileOptimizes) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+     fn double_neg(x: bits[2]) -> bits[2] {
+        neg.2: bits[2] = neg(x)
+        ret result: bits[2] = neg(neg.2)
+     }
+)",
+                                                       p.get()));
+  std::unique_ptr<CompoundPass> pipeline =
+      CreatePassPipeline(PipelineProfile::O1());
+  PassResults results;
+  ASSERT_THAT(pipeline->Run(p.get(), PassOptions(), &results),
+              IsOkAndHolds(true));
+  EXPECT_THAT(f->return_value(), m::Param("x"));
+}
+
 TEST_F(StandardPipelineTest, IdentityRemoval) {
   auto p = CreatePackage();
   std::unique_ptr<CompoundPass> pass_mgr = CreateStandardPassPipeline();
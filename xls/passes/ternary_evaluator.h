@@ -23,8 +23,11 @@
 
 namespace xls {
 
+// Backing the evaluator's vectors with TernaryVector keeps its inline storage
+// (vectors of up to 64 elements never touch the heap) and makes evaluator
+// results directly usable with the ternary_ops utilities.
 class TernaryEvaluator
-    : public AbstractEvaluator<TernaryValue, TernaryEvaluator> {
+    : public AbstractEvaluator<TernaryValue, TernaryEvaluator, TernaryVector> {
  public:
   TernaryValue One() const { return TernaryValue::kKnownOne; }
 
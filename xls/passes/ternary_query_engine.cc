@@ -15,10 +15,14 @@
 #include "xls/passes/ternary_query_engine.h"
 
 #include <limits>
+#include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/data_structures/leaf_type_tree.h"
 #include "xls/ir/abstract_node_evaluator.h"
@@ -61,57 +65,133 @@ Bits TernaryVectorToValueBits(const TernaryEvaluator::Vector& ternary_vector) {
   return Bits(bits);
 }
 
+// Returns whether evaluation of the given node consults the ternary values of
+// its operands. Nodes which are expensive to evaluate or have non-bits-typed
+// operands are evaluated to an all-unknown vector instead.
+static bool EvaluationUsesOperands(Node* node) {
+  return !IsExpensiveToEvaluate(node) &&
+         std::all_of(node->operands().begin(), node->operands().end(),
+                     [](Node* o) { return o->GetType()->IsBits(); });
+}
+
+// Evaluates the given bits-typed node and adds the result to `values`. If
+// `EvaluationUsesOperands(node)` then the values of the node's operands must
+// already be present in `values`.
+static absl::Status EvaluateNode(
+    Node* node, TernaryEvaluator* evaluator,
+    absl::flat_hash_map<Node*, TernaryEvaluator::Vector>* values) {
+  auto create_unknown_vector = [](Node* n) {
+    return TernaryEvaluator::Vector(n->BitCountOrDie(), TernaryValue::kUnknown);
+  };
+  if (!EvaluationUsesOperands(node)) {
+    (*values)[node] = create_unknown_vector(node);
+    return absl::OkStatus();
+  }
+
+  std::vector<TernaryEvaluator::Vector> operand_values;
+  for (Node* operand : node->operands()) {
+    operand_values.push_back(values->at(operand));
+  }
+  XLS_ASSIGN_OR_RETURN(
+      (*values)[node],
+      AbstractEvaluate(node, operand_values, evaluator,
+                       /*default_handler=*/create_unknown_vector));
+  return absl::OkStatus();
+}
+
 absl::StatusOr<ReachedFixpoint> TernaryQueryEngine::Populate(FunctionBase* f) {
+  if (mode_ == AnalysisMode::kLazy) {
+    // Defer all evaluation to the first query of each node. Just (re)bind the
+    // function and drop previously memoized results which may be stale.
+    function_ = f;
+    values_.clear();
+    known_bits_.clear();
+    bits_values_.clear();
+    return ReachedFixpoint::Unknown;
+  }
+
   TernaryEvaluator evaluator;
   absl::flat_hash_map<Node*, TernaryEvaluator::Vector> values;
   for (Node* node : TopoSort(f)) {
     if (!node->GetType()->IsBits()) {
       continue;
     }
-    auto create_unknown_vector = [](Node* n) {
-      return TernaryEvaluator::Vector(n->BitCountOrDie(),
-                                      TernaryValue::kUnknown);
-    };
-    if (IsExpensiveToEvaluate(node) ||
-        std::any_of(node->operands().begin(), node->operands().end(),
-                    [](Node* o) { return !o->GetType()->IsBits(); })) {
-      values[node] = create_unknown_vector(node);
-      continue;
-    }
-
-    std::vector<TernaryEvaluator::Vector> operand_values;
-    for (Node* operand : node->operands()) {
-      operand_values.push_back(values.at(operand));
-    }
-    XLS_ASSIGN_OR_RETURN(
-        values[node],
-        AbstractEvaluate(node, operand_values, &evaluator,
-                         /*default_handler=*/create_unknown_vector));
+    XLS_RETURN_IF_ERROR(EvaluateNode(node, &evaluator, &values));
   }
 
   ReachedFixpoint rf = ReachedFixpoint::Unchanged;
   for (Node* node : f->nodes()) {
     // TODO(meheff): Handle types other than bits.
     if (node->GetType()->IsBits()) {
-      if (!known_bits_.contains(node)) {
-        known_bits_[node] = Bits(values.at(node).size());
-        bits_values_[node] = Bits(values.at(node).size());
-      }
-      Bits combined_known_bits = bits_ops::Or(
-          known_bits_[node], TernaryVectorToKnownBits(values.at(node)));
-      Bits combined_bits_values = bits_ops::Or(
-          bits_values_[node], TernaryVectorToValueBits(values.at(node)));
-      if ((combined_known_bits != known_bits_[node]) ||
-          (combined_bits_values != bits_values_[node])) {
+      ReachedFixpoint node_rf = RecordKnownBits(node, values.at(node));
+      if (node_rf == ReachedFixpoint::Changed) {
         rf = ReachedFixpoint::Changed;
       }
-      known_bits_[node] = combined_known_bits;
-      bits_values_[node] = combined_bits_values;
     }
   }
   return rf;
 }
 
+ReachedFixpoint TernaryQueryEngine::RecordKnownBits(
+    Node* node, const TernaryEvaluator::Vector& value) const {
+  ReachedFixpoint rf = ReachedFixpoint::Unchanged;
+  if (!known_bits_.contains(node)) {
+    known_bits_[node] = Bits(value.size());
+    bits_values_[node] = Bits(value.size());
+  }
+  Bits combined_known_bits =
+      bits_ops::Or(known_bits_[node], TernaryVectorToKnownBits(value));
+  Bits combined_bits_values =
+      bits_ops::Or(bits_values_[node], TernaryVectorToValueBits(value));
+  if ((combined_known_bits != known_bits_[node]) ||
+      (combined_bits_values != bits_values_[node])) {
+    rf = ReachedFixpoint::Changed;
+  }
+  known_bits_[node] = combined_known_bits;
+  bits_values_[node] = combined_bits_values;
+  return rf;
+}
+
+void TernaryQueryEngine::EnsureAnalyzed(Node* node) const {
+  if (mode_ != AnalysisMode::kLazy || function_ == nullptr ||
+      !node->GetType()->IsBits() || values_.contains(node)) {
+    return;
+  }
+
+  // Gather the not-yet-evaluated portion of the node's fanin cone in
+  // topological order (operands before users) with an iterative post-order
+  // walk. Nodes whose evaluation does not consult operand values bound the
+  // walk; their operands need not be evaluated.
+  std::vector<Node*> cone;
+  absl::flat_hash_set<Node*> discovered;
+  std::vector<std::pair<Node*, bool>> stack = {{node, false}};
+  while (!stack.empty()) {
+    auto [n, expanded] = stack.back();
+    stack.pop_back();
+    if (expanded) {
+      cone.push_back(n);
+      continue;
+    }
+    if (values_.contains(n) || !discovered.insert(n).second) {
+      continue;
+    }
+    stack.push_back({n, true});
+    if (EvaluationUsesOperands(n)) {
+      for (Node* operand : n->operands()) {
+        stack.push_back({operand, false});
+      }
+    }
+  }
+
+  TernaryEvaluator evaluator;
+  for (Node* n : cone) {
+    // Abstract evaluation of a bits-typed node with known operand values
+    // cannot fail.
+    XLS_CHECK_OK(EvaluateNode(n, &evaluator, &values_));
+    RecordKnownBits(n, values_.at(n));
+  }
+}
+
 bool TernaryQueryEngine::AtMostOneTrue(
     absl::Span<TreeBitLocation const> bits) const {
   int64_t maybe_one_count = 0;
@@ -15,12 +15,14 @@
 #ifndef XLS_PASSES_TERNARY_QUERY_ENGINE_H_
 #define XLS_PASSES_TERNARY_QUERY_ENGINE_H_
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "absl/types/optional.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/function.h"
 #include "xls/ir/nodes.h"
 #include "xls/passes/query_engine.h"
+#include "xls/passes/ternary_evaluator.h"
 
 namespace xls {
 
@@ -31,16 +33,22 @@ namespace xls {
 // function (implications, equality, etc).
 class TernaryQueryEngine : public QueryEngine {
  public:
-  TernaryQueryEngine() {}
+  // With `AnalysisMode::kLazy`, `Populate` defers all evaluation and the
+  // fanin cone of a node is evaluated (and memoized) on the first query of
+  // that node.
+  explicit TernaryQueryEngine(AnalysisMode mode = AnalysisMode::kEager)
+      : mode_(mode) {}
 
   absl::StatusOr<ReachedFixpoint> Populate(FunctionBase* f) override;
 
   bool IsTracked(Node* node) const override {
+    EnsureAnalyzed(node);
     return known_bits_.contains(node);
   }
 
   LeafTypeTree<TernaryVector> GetTernary(Node* node) const override {
     XLS_CHECK(node->GetType()->IsBits());
+    EnsureAnalyzed(node);
     TernaryVector ternary =
         ternary_ops::FromKnownBits(known_bits_.at(node), bits_values_.at(node));
     LeafTypeTree<TernaryVector> result(node->GetType());
@@ -68,13 +76,32 @@ class TernaryQueryEngine : public QueryEngine {
   }
 
  private:
+  // In lazy mode, evaluates the not-yet-evaluated portion of `node`'s fanin
+  // cone and records the known bits of each evaluated node. No-op in eager
+  // mode or if `node` has already been evaluated.
+  void EnsureAnalyzed(Node* node) const;
+
+  // Merges the given ternary value of `node` into the known-bits maps.
+  // Returns whether the merge changed the recorded information about `node`.
+  ReachedFixpoint RecordKnownBits(Node* node,
+                                  const TernaryEvaluator::Vector& value) const;
+
+  AnalysisMode mode_;
+
+  // The function being analyzed. Only bound in lazy mode.
+  FunctionBase* function_ = nullptr;
+
+  // Memoized per-node ternary values. Only used in lazy mode; eager analysis
+  // discards the raw values after distilling them into the known-bits maps.
+  mutable absl::flat_hash_map<Node*, TernaryEvaluator::Vector> values_;
+
   // Holds which bits values are known for nodes in the function. A one in a bit
   // position indications the respective bit value in the respective node is
   // statically known.
-  absl::flat_hash_map<Node*, Bits> known_bits_;
+  mutable absl::flat_hash_map<Node*, Bits> known_bits_;
 
   // Holds the values of statically known bits of nodes in the function.
-  absl::flat_hash_map<Node*, Bits> bits_values_;
+  mutable absl::flat_hash_map<Node*, Bits> bits_values_;
 };
 
 }  // namespace xls
@@ -130,5 +130,30 @@ TEST_F(TernaryQueryEngineTest, Ne) {
   EXPECT_THAT(RunOnBinaryOp("0b011", "0b011", make_ne), IsOkAndHolds("0b0"));
 }
 
+TEST_F(TernaryQueryEngineTest, LazyAnalysisMatchesEager) {
+  Package p("test_package");
+  FunctionBuilder fb("f", &p);
+  BValue x = MakeValueWithKnownBits(
+      "x", StringToTernaryVector("0b11XX").value(), &fb);
+  BValue y = MakeValueWithKnownBits(
+      "y", StringToTernaryVector("0bX0X1").value(), &fb);
+  BValue expr = fb.Or(x, y);
+  fb.Concat({expr, fb.And(x, y)});
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  TernaryQueryEngine eager;
+  XLS_ASSERT_OK(eager.Populate(f).status());
+  TernaryQueryEngine lazy(QueryEngine::AnalysisMode::kLazy);
+  XLS_ASSERT_OK(lazy.Populate(f).status());
+
+  // Lazy analysis of a queried node's fanin cone produces the same known bits
+  // as eager whole-function analysis, and repeated queries are consistent.
+  EXPECT_TRUE(lazy.IsTracked(expr.node()));
+  EXPECT_EQ(lazy.ToString(expr.node()), eager.ToString(expr.node()));
+  EXPECT_EQ(lazy.ToString(expr.node()), eager.ToString(expr.node()));
+  EXPECT_EQ(lazy.ToString(f->return_value()),
+            eager.ToString(f->return_value()));
+}
+
 }  // namespace
 }  // namespace xls
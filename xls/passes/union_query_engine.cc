@@ -14,11 +14,25 @@
 
 #include "xls/passes/union_query_engine.h"
 
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
 #include "xls/ir/bits_ops.h"
 
 namespace xls {
 
 absl::StatusOr<ReachedFixpoint> UnionQueryEngine::Populate(FunctionBase* f) {
+  function_ = f;
+  if (mode_ == AnalysisMode::kLazy) {
+    // Populate only the cheapest engine up front; each costlier engine is
+    // populated on the first query which the engines before it cannot answer.
+    num_populated_ = 0;
+    if (!engines_.empty()) {
+      XLS_RETURN_IF_ERROR(engines_.front()->Populate(f).status());
+      num_populated_ = 1;
+    }
+    return ReachedFixpoint::Unknown;
+  }
+
   ReachedFixpoint result = ReachedFixpoint::Unchanged;
   for (const std::unique_ptr<QueryEngine>& engine : engines_) {
     XLS_ASSIGN_OR_RETURN(ReachedFixpoint rf, engine->Populate(f));
@@ -34,12 +48,25 @@ absl::StatusOr<ReachedFixpoint> UnionQueryEngine::Populate(FunctionBase* f) {
     // No case needed for ReachedFixpoint::Unknown since it's already the bottom
     // of the lattice
   }
+  num_populated_ = engines_.size();
   return result;
 }
 
+void UnionQueryEngine::EnsurePopulated(int64_t i) const {
+  if (mode_ != AnalysisMode::kLazy || function_ == nullptr) {
+    return;
+  }
+  while (num_populated_ <= i) {
+    // A population failure here would also have failed an eager Populate.
+    XLS_CHECK_OK(engines_[num_populated_]->Populate(function_).status());
+    ++num_populated_;
+  }
+}
+
 bool UnionQueryEngine::IsTracked(Node* node) const {
-  for (const auto& engine : engines_) {
-    if (engine->IsTracked(node)) {
+  for (int64_t i = 0; i < static_cast<int64_t>(engines_.size()); ++i) {
+    EnsurePopulated(i);
+    if (engines_[i]->IsTracked(node)) {
       return true;
     }
   }
@@ -51,7 +78,13 @@ LeafTypeTree<TernaryVector> UnionQueryEngine::GetTernary(Node* node) const {
 
   Bits known(node->GetType()->GetFlatBitCount());
   Bits known_values(node->GetType()->GetFlatBitCount());
-  for (const auto& engine : engines_) {
+  for (int64_t i = 0; i < static_cast<int64_t>(engines_.size()); ++i) {
+    if (known.IsAllOnes()) {
+      // Every bit is already known; costlier engines cannot add information.
+      break;
+    }
+    EnsurePopulated(i);
+    const std::unique_ptr<QueryEngine>& engine = engines_[i];
     if (engine->IsTracked(node)) {
       TernaryVector ternary = engine->GetTernary(node).Get({});
       known = bits_ops::Or(known, ternary_ops::ToKnownBits(ternary));
@@ -67,8 +100,9 @@ LeafTypeTree<TernaryVector> UnionQueryEngine::GetTernary(Node* node) const {
 
 bool UnionQueryEngine::AtMostOneTrue(
     absl::Span<TreeBitLocation const> bits) const {
-  for (const auto& engine : engines_) {
-    if (engine->AtMostOneTrue(bits)) {
+  for (int64_t i = 0; i < static_cast<int64_t>(engines_.size()); ++i) {
+    EnsurePopulated(i);
+    if (engines_[i]->AtMostOneTrue(bits)) {
       return true;
     }
   }
@@ -77,8 +111,9 @@ bool UnionQueryEngine::AtMostOneTrue(
 
 bool UnionQueryEngine::AtLeastOneTrue(
     absl::Span<TreeBitLocation const> bits) const {
-  for (const auto& engine : engines_) {
-    if (engine->AtLeastOneTrue(bits)) {
+  for (int64_t i = 0; i < static_cast<int64_t>(engines_.size()); ++i) {
+    EnsurePopulated(i);
+    if (engines_[i]->AtLeastOneTrue(bits)) {
       return true;
     }
   }
@@ -87,8 +122,9 @@ bool UnionQueryEngine::AtLeastOneTrue(
 
 bool UnionQueryEngine::KnownEquals(const TreeBitLocation& a,
                                    const TreeBitLocation& b) const {
-  for (const auto& engine : engines_) {
-    if (engine->KnownEquals(a, b)) {
+  for (int64_t i = 0; i < static_cast<int64_t>(engines_.size()); ++i) {
+    EnsurePopulated(i);
+    if (engines_[i]->KnownEquals(a, b)) {
       return true;
     }
   }
@@ -97,8 +133,9 @@ bool UnionQueryEngine::KnownEquals(const TreeBitLocation& a,
 
 bool UnionQueryEngine::KnownNotEquals(const TreeBitLocation& a,
                                       const TreeBitLocation& b) const {
-  for (const auto& engine : engines_) {
-    if (engine->KnownNotEquals(a, b)) {
+  for (int64_t i = 0; i < static_cast<int64_t>(engines_.size()); ++i) {
+    EnsurePopulated(i);
+    if (engines_[i]->KnownNotEquals(a, b)) {
       return true;
     }
   }
@@ -107,8 +144,9 @@ bool UnionQueryEngine::KnownNotEquals(const TreeBitLocation& a,
 
 bool UnionQueryEngine::Implies(const TreeBitLocation& a,
                                const TreeBitLocation& b) const {
-  for (const auto& engine : engines_) {
-    if (engine->Implies(a, b)) {
+  for (int64_t i = 0; i < static_cast<int64_t>(engines_.size()); ++i) {
+    EnsurePopulated(i);
+    if (engines_[i]->Implies(a, b)) {
       return true;
     }
   }
@@ -118,9 +156,11 @@ bool UnionQueryEngine::Implies(const TreeBitLocation& a,
 absl::optional<Bits> UnionQueryEngine::ImpliedNodeValue(
     absl::Span<const std::pair<TreeBitLocation, bool>> predicate_bit_values,
     Node* node) const {
-  for (const auto& engine : engines_) {
-    if (auto i = engine->ImpliedNodeValue(predicate_bit_values, node)) {
-      return i;
+  for (int64_t i = 0; i < static_cast<int64_t>(engines_.size()); ++i) {
+    EnsurePopulated(i);
+    if (auto value =
+            engines_[i]->ImpliedNodeValue(predicate_bit_values, node)) {
+      return value;
     }
   }
   return absl::nullopt;
@@ -29,6 +29,13 @@ namespace xls {
 
 // A query engine that combines the results of multiple given query engines.
 //
+// The engines are consulted in the order given, so they should be ordered
+// cheapest first. With `AnalysisMode::kLazy`, `Populate` populates only the
+// first engine; each costlier engine is populated on the first query which
+// the engines before it cannot answer. This gives the strength of the most
+// powerful engine at close to the cost of the cheapest one when most queries
+// are answerable by the cheap engine.
+//
 // `GetKnownBits` and `GetKnownBitsValues` use `const_cast<...>(this)` under the
 // hood, so it is undefined behavior to define a `const UnionQueryEngine`
 // variable (but `const UnionQueryEngine*` is fine, the storage location just
@@ -36,9 +43,9 @@ namespace xls {
 // will be fixed at some point.
 class UnionQueryEngine : public QueryEngine {
  public:
-  explicit UnionQueryEngine(std::vector<std::unique_ptr<QueryEngine>> engines) {
-    engines_ = std::move(engines);
-  }
+  explicit UnionQueryEngine(std::vector<std::unique_ptr<QueryEngine>> engines,
+                            AnalysisMode mode = AnalysisMode::kEager)
+      : engines_(std::move(engines)), mode_(mode) {}
 
   absl::StatusOr<ReachedFixpoint> Populate(FunctionBase* f) override;
 
@@ -64,9 +71,19 @@ class UnionQueryEngine : public QueryEngine {
       Node* node) const override;
 
  private:
+  // Populates engines up to and including index 'i' in lazy mode. A no-op
+  // after an eager Populate.
+  void EnsurePopulated(int64_t i) const;
+
   absl::flat_hash_map<Node*, Bits> known_bits_;
   absl::flat_hash_map<Node*, Bits> known_bit_values_;
   std::vector<std::unique_ptr<QueryEngine>> engines_;
+  AnalysisMode mode_;
+
+  // The function bound by the most recent call to Populate, and the number of
+  // leading engines which have been populated on it.
+  FunctionBase* function_ = nullptr;
+  mutable int64_t num_populated_ = 0;
 };
 
 }  // namespace xls
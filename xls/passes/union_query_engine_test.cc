@@ -48,9 +48,13 @@ class FakeQueryEngine : public QueryEngine {
   FakeQueryEngine() {}
 
   absl::StatusOr<ReachedFixpoint> Populate(FunctionBase* f) override {
+    ++populate_count_;
     return ReachedFixpoint::Unchanged;
   }
 
+  // Returns the number of times Populate has been called.
+  int64_t populate_count() const { return populate_count_; }
+
   bool IsTracked(Node* node) const override { return tracked_.contains(node); }
 
   LeafTypeTree<TernaryVector> GetTernary(Node* node) const override {
@@ -206,6 +210,7 @@ class FakeQueryEngine : public QueryEngine {
   absl::flat_hash_map<std::pair<TreeBitLocation, TreeBitLocation>,
                       EqualityState>
       equality_states_;
+  int64_t populate_count_ = 0;
 };
 
 class UnionQueryEngineTest : public IrTestBase {};
@@ -282,5 +287,48 @@ TEST_F(UnionQueryEngineTest, Simple) {
       node));
 }
 
+TEST_F(UnionQueryEngineTest, LazyPopulatesCostlierEnginesOnDemand) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+
+  BValue param = fb.Param("param", fb.package()->GetBitsType(8));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  Node* node = param.node();
+
+  auto cheap_owned = std::make_unique<FakeQueryEngine>();
+  auto costly_owned = std::make_unique<FakeQueryEngine>();
+  FakeQueryEngine* cheap = cheap_owned.get();
+  FakeQueryEngine* costly = costly_owned.get();
+  cheap->AddAtMostOneTrue({TreeBitLocation(node, 2), TreeBitLocation(node, 3)});
+  costly->AddImplication(TreeBitLocation(node, 3), TreeBitLocation(node, 7));
+
+  std::vector<std::unique_ptr<QueryEngine>> engines;
+  engines.push_back(std::move(cheap_owned));
+  engines.push_back(std::move(costly_owned));
+  UnionQueryEngine union_query_engine(std::move(engines),
+                                      QueryEngine::AnalysisMode::kLazy);
+  XLS_ASSERT_OK(union_query_engine.Populate(f).status());
+
+  // Only the cheapest engine is populated up front.
+  EXPECT_EQ(cheap->populate_count(), 1);
+  EXPECT_EQ(costly->populate_count(), 0);
+
+  // A query the cheap engine can answer does not populate the costly engine.
+  EXPECT_TRUE(union_query_engine.AtMostOneTrue(
+      {TreeBitLocation(node, 2), TreeBitLocation(node, 3)}));
+  EXPECT_EQ(costly->populate_count(), 0);
+
+  // A query only the costly engine can answer populates it on demand.
+  EXPECT_TRUE(union_query_engine.Implies(TreeBitLocation(node, 3),
+                                         TreeBitLocation(node, 7)));
+  EXPECT_EQ(costly->populate_count(), 1);
+
+  // Subsequent queries do not re-populate.
+  EXPECT_TRUE(union_query_engine.Implies(TreeBitLocation(node, 3),
+                                         TreeBitLocation(node, 7)));
+  EXPECT_EQ(costly->populate_count(), 1);
+}
+
 }  // namespace
 }  // namespace xls
@@ -18,6 +18,7 @@
 #include "absl/status/statusor.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/node_iterator.h"
+#include "xls/ir/node_util.h"
 
 namespace xls {
 namespace {
@@ -74,6 +75,11 @@ absl::StatusOr<bool> UnrollPass::RunOnFunctionBaseInternal(
     XLS_RETURN_IF_ERROR(UnrollCountedFor(loop));
     changed = true;
   }
+  if (changed) {
+    // Unrolling strands the loops' trip-count and invariant-arg computations;
+    // clean them up here rather than carrying them to the next DCE pass.
+    XLS_RETURN_IF_ERROR(RemoveDeadNodes(f).status());
+  }
   return changed;
 }
 
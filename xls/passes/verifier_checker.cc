@@ -14,13 +14,40 @@
 
 #include "xls/passes/verifier_checker.h"
 
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/function_base.h"
 #include "xls/ir/verifier.h"
 
 namespace xls {
 
 absl::Status VerifierChecker::Run(Package* p, const PassOptions& options,
                                   PassResults* results) const {
-  return VerifyPackage(p);
+  if (!verify_changed_only_) {
+    return VerifyPackage(p);
+  }
+
+  // Re-verify only FunctionBases whose transform count has changed since the
+  // last successful verification. Package-scoped invariants are cheap and are
+  // always checked.
+  std::vector<FunctionBase*> function_bases = p->GetFunctionBases();
+  absl::MutexLock lock(&mutex_);
+  for (FunctionBase* function_base : function_bases) {
+    auto it = verified_transform_counts_.find(function_base);
+    if (it != verified_transform_counts_.end() &&
+        it->second == function_base->transform_count()) {
+      continue;
+    }
+    if (function_base->IsFunction()) {
+      XLS_RETURN_IF_ERROR(VerifyFunction(function_base->AsFunctionOrDie()));
+    } else if (function_base->IsProc()) {
+      XLS_RETURN_IF_ERROR(VerifyProc(function_base->AsProcOrDie()));
+    } else {
+      XLS_RETURN_IF_ERROR(VerifyBlock(function_base->AsBlockOrDie()));
+    }
+    verified_transform_counts_[function_base] =
+        function_base->transform_count();
+  }
+  return VerifyPackageInvariants(p);
 }
 
 }  // namespace xls
@@ -15,16 +15,41 @@
 #ifndef XLS_PASSES_VERIFIER_CHECKER_H_
 #define XLS_PASSES_VERIFIER_CHECKER_H_
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
 #include "xls/passes/passes.h"
 
 namespace xls {
 
 // Invariant checker which just runs xls::Verifier.
+//
+// If constructed with verify_changed_only=true, the checker records the
+// transform count (FunctionBase::transform_count()) of each FunctionBase it
+// has successfully verified and on subsequent runs re-verifies only those
+// whose count has changed; package-scoped invariants are always checked. This
+// avoids re-walking every node of a large package after each pass of a
+// pipeline. The transform count only tracks graph restructuring, so this mode
+// can miss violations introduced by metadata-only mutations; the default is
+// full verification.
 class VerifierChecker : public InvariantChecker {
  public:
+  explicit VerifierChecker(bool verify_changed_only = false)
+      : verify_changed_only_(verify_changed_only) {}
+
   absl::Status Run(Package* p, const PassOptions& options,
                    PassResults* results) const override;
+
+ private:
+  bool verify_changed_only_;
+
+  // Transform counts at the last successful verification, keyed by
+  // FunctionBase. Mutable because Run is const; guarded for the case of
+  // concurrently verified packages sharing a checker.
+  mutable absl::Mutex mutex_;
+  mutable absl::flat_hash_map<FunctionBase*, int64_t> verified_transform_counts_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace xls
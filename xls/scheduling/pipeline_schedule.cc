@@ -14,17 +14,22 @@
 
 #include "xls/scheduling/pipeline_schedule.h"
 
+#include <memory>
+#include <thread>
+
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/thread.h"
 #include "xls/common/status/ret_check.h"
-#include "xls/data_structures/binary_search.h"
 #include "xls/ir/node_iterator.h"
 #include "xls/scheduling/function_partition.h"
 #include "xls/scheduling/schedule_bounds.h"
+#include "xls/scheduling/schedule_refinement.h"
+#include "xls/scheduling/sdc_scheduler.h"
 
 namespace xls {
 namespace {
@@ -104,30 +109,62 @@ absl::StatusOr<ScheduleCycleMap> ScheduleToMinimizeRegisters(
   XLS_VLOG_LINES(4, bounds->ToString());
 
   // Try a number of different orderings of cycle boundary at which the min-cut
-  // is performed and keep the best one.
-  int64_t best_register_count;
-  absl::optional<sched::ScheduleBounds> best_bounds;
-  for (const std::vector<int64_t>& cut_order :
-       GetMinCutCycleOrders(pipeline_stages - 1)) {
+  // is performed and keep the best one. The orderings are evaluated
+  // concurrently, one thread per ordering: each trial works on its own copy
+  // of the bounds and otherwise only reads the function and the delay
+  // estimator, neither of which is mutated during scheduling.
+  std::vector<std::vector<int64_t>> cut_orders =
+      GetMinCutCycleOrders(pipeline_stages - 1);
+  std::vector<absl::Status> trial_statuses(cut_orders.size(),
+                                           absl::OkStatus());
+  std::vector<int64_t> trial_register_counts(cut_orders.size());
+  std::vector<absl::optional<sched::ScheduleBounds>> trial_bounds(
+      cut_orders.size());
+  auto run_trial = [&](int64_t trial) {
+    const std::vector<int64_t>& cut_order = cut_orders[trial];
     XLS_VLOG(3) << absl::StreamFormat("Trying cycle order: {%s}",
                                       absl::StrJoin(cut_order, ", "));
-    sched::ScheduleBounds trial_bounds = *bounds;
-    // Partition the nodes at each cycle boundary. For each iteration, this
-    // splits the nodes into those which must be scheduled at or before the
-    // cycle and those which must be scheduled after. Upon loop completion each
-    // node will have a range of exactly one cycle.
-    for (int64_t cycle : cut_order) {
-      XLS_RETURN_IF_ERROR(
-          SplitAfterCycle(f, cycle, delay_estimator, &trial_bounds));
-      XLS_RETURN_IF_ERROR(trial_bounds.PropagateLowerBounds());
-      XLS_RETURN_IF_ERROR(trial_bounds.PropagateUpperBounds());
+    sched::ScheduleBounds bounds_copy = *bounds;
+    auto trial_status = [&]() -> absl::Status {
+      // Partition the nodes at each cycle boundary. For each iteration, this
+      // splits the nodes into those which must be scheduled at or before the
+      // cycle and those which must be scheduled after. Upon loop completion
+      // each node will have a range of exactly one cycle.
+      for (int64_t cycle : cut_order) {
+        XLS_RETURN_IF_ERROR(
+            SplitAfterCycle(f, cycle, delay_estimator, &bounds_copy));
+        XLS_RETURN_IF_ERROR(bounds_copy.PropagateLowerBounds());
+        XLS_RETURN_IF_ERROR(bounds_copy.PropagateUpperBounds());
+      }
+      XLS_ASSIGN_OR_RETURN(trial_register_counts[trial],
+                           CountInteriorPipelineRegisters(f, bounds_copy));
+      return absl::OkStatus();
+    };
+    trial_statuses[trial] = trial_status();
+    if (trial_statuses[trial].ok()) {
+      trial_bounds[trial] = std::move(bounds_copy);
     }
-    XLS_ASSIGN_OR_RETURN(int64_t trial_register_count,
-                         CountInteriorPipelineRegisters(f, trial_bounds));
+  };
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int64_t trial = 1; trial < cut_orders.size(); ++trial) {
+    threads.push_back(
+        std::make_unique<Thread>([&run_trial, trial]() { run_trial(trial); }));
+  }
+  run_trial(0);
+  for (std::unique_ptr<Thread>& thread : threads) {
+    thread->Join();
+  }
+
+  // Keep the best trial; ties (and errors) resolve in cut-order enumeration
+  // order so the result is deterministic regardless of thread interleaving.
+  int64_t best_register_count;
+  absl::optional<sched::ScheduleBounds> best_bounds;
+  for (int64_t trial = 0; trial < cut_orders.size(); ++trial) {
+    XLS_RETURN_IF_ERROR(trial_statuses[trial]);
     if (!best_bounds.has_value() ||
-        best_register_count > trial_register_count) {
-      best_bounds = std::move(trial_bounds);
-      best_register_count = trial_register_count;
+        best_register_count > trial_register_counts[trial]) {
+      best_bounds = std::move(trial_bounds[trial]);
+      best_register_count = trial_register_counts[trial];
     }
   }
   *bounds = std::move(*best_bounds);
@@ -304,30 +341,65 @@ absl::StatusOr<int64_t> FindMinimumClockPeriod(
   // critical-path delay of the function.
   int64_t search_start = (function_cp + pipeline_stages - 1) / pipeline_stages;
   int64_t search_end = function_cp;
-  XLS_VLOG(4) << absl::StreamFormat("Binary searching over interval [%d, %d]",
+  XLS_VLOG(4) << absl::StreamFormat("Searching over interval [%d, %d]",
                                     search_start, search_end);
-  XLS_ASSIGN_OR_RETURN(int64_t min_period,
-                       BinarySearchMinTrueWithStatus(
-                           search_start, search_end,
-                           [&](int64_t clk_period_ps) -> absl::StatusOr<bool> {
-                             // If any node does not fit in the clock period,
-                             // fail outright.
-                             for (Node* node : f->nodes()) {
-                               XLS_ASSIGN_OR_RETURN(
-                                   int64_t node_delay,
-                                   delay_estimator.GetOperationDelayInPs(node));
-                               if (node_delay > clk_period_ps) {
-                                 return false;
-                               }
-                             }
-                             XLS_ASSIGN_OR_RETURN(
-                                 sched::ScheduleBounds bounds,
-                                 ConstructBounds(
-                                     f, clk_period_ps, topo_sort,
-                                     /*schedule_length=*/absl::nullopt,
-                                     delay_estimator));
-                             return bounds.max_lower_bound() < pipeline_stages;
-                           }));
+  auto is_feasible = [&](int64_t clk_period_ps) -> absl::StatusOr<bool> {
+    // If any node does not fit in the clock period, fail outright.
+    for (Node* node : f->nodes()) {
+      XLS_ASSIGN_OR_RETURN(int64_t node_delay,
+                           delay_estimator.GetOperationDelayInPs(node));
+      if (node_delay > clk_period_ps) {
+        return false;
+      }
+    }
+    XLS_ASSIGN_OR_RETURN(sched::ScheduleBounds bounds,
+                         ConstructBounds(f, clk_period_ps, topo_sort,
+                                         /*schedule_length=*/absl::nullopt,
+                                         delay_estimator));
+    return bounds.max_lower_bound() < pipeline_stages;
+  };
+
+  // Probing a candidate period only reads the IR and constructs bounds local
+  // to the probe, so candidates can be evaluated speculatively in
+  // parallel. Each round probes several evenly spaced periods in the search
+  // interval concurrently; feasibility is monotone in the period so the
+  // interval narrows to between the largest infeasible and smallest feasible
+  // probe. As with a serial binary search, the upper end of the initial
+  // interval (the critical path of the entire function) is feasible.
+  const int64_t max_probes = std::max<int64_t>(
+      1, static_cast<int64_t>(std::thread::hardware_concurrency()));
+  int64_t lo = search_start;
+  int64_t hi = search_end;
+  while (lo < hi) {
+    int64_t span = hi - lo;
+    int64_t probe_count = std::min(max_probes, span);
+    // Probe i is at the (i+1)-th (probe_count+1)-ile of [lo, hi); the probes
+    // are distinct and leave hi as the feasible fallback.
+    std::vector<int64_t> candidates(probe_count);
+    for (int64_t i = 0; i < probe_count; ++i) {
+      candidates[i] = lo + (span * (i + 1)) / (probe_count + 1);
+    }
+    std::vector<absl::StatusOr<bool>> results(probe_count, false);
+    auto run_probe = [&](int64_t i) { results[i] = is_feasible(candidates[i]); };
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int64_t i = 1; i < probe_count; ++i) {
+      threads.push_back(
+          std::make_unique<Thread>([&run_probe, i]() { run_probe(i); }));
+    }
+    run_probe(0);
+    for (auto& thread : threads) {
+      thread->Join();
+    }
+    for (int64_t i = 0; i < probe_count; ++i) {
+      XLS_ASSIGN_OR_RETURN(bool feasible, results[i]);
+      if (feasible) {
+        hi = std::min(hi, candidates[i]);
+      } else {
+        lo = std::max(lo, candidates[i] + 1);
+      }
+    }
+  }
+  int64_t min_period = hi;
   XLS_VLOG(4) << "minimum clock period = " << min_period;
   return min_period;
 }
@@ -451,8 +523,14 @@ std::vector<Node*> PipelineSchedule::GetLiveOutOfCycle(int64_t c) const {
 }
 
 /*static*/ absl::StatusOr<PipelineSchedule> PipelineSchedule::Run(
-    FunctionBase* f, const DelayEstimator& delay_estimator,
+    FunctionBase* f, const DelayEstimator& raw_delay_estimator,
     const SchedulingOptions& options) {
+  // Scheduling queries the delay of each node many times (clock period binary
+  // search, bounds propagation, each min-cut trial), so memoize the delay
+  // model up front.
+  CachingDelayEstimator delay_estimator(raw_delay_estimator);
+  XLS_RETURN_IF_ERROR(delay_estimator.PrefetchDelays(f));
+
   int64_t clock_period_ps;
   if (options.clock_period_ps().has_value()) {
     clock_period_ps = *options.clock_period_ps();
@@ -490,6 +568,19 @@ std::vector<Node*> PipelineSchedule::GetLiveOutOfCycle(int64_t c) const {
     XLS_ASSIGN_OR_RETURN(cycle_map,
                          ScheduleToMinimizeRegisters(f, schedule_length,
                                                      delay_estimator, &bounds));
+    // The min-cut minimizes each stage boundary independently, which
+    // undercharges values crossing several boundaries. Polish the result
+    // with a local search over single-node stage moves under a global
+    // multi-stage lifetime objective.
+    XLS_ASSIGN_OR_RETURN(
+        cycle_map, sched::RefineScheduleToMinimizeRegisters(
+                       f, std::move(cycle_map), schedule_length,
+                       clock_period_ps, delay_estimator));
+  } else if (options.strategy() == SchedulingStrategy::SDC_MINIMIZE_REGISTERS) {
+    XLS_ASSIGN_OR_RETURN(
+        cycle_map,
+        sched::SDCScheduleToMinimizeRegisters(
+            f, schedule_length, clock_period_ps, delay_estimator, bounds));
   } else {
     XLS_RET_CHECK(options.strategy() == SchedulingStrategy::ASAP);
     XLS_RET_CHECK(!options.pipeline_stages().has_value());
@@ -32,8 +32,17 @@ enum class SchedulingStrategy {
   // timing constraints.
   ASAP,
 
-  // Minimize the number of pipeline registers when scheduling.
-  MINIMIZE_REGISTERS
+  // Minimize the number of pipeline registers when scheduling using a series
+  // of min-cut computations, one per stage boundary.
+  MINIMIZE_REGISTERS,
+
+  // Minimize the number of pipeline registers by formulating the schedule as
+  // a system of difference constraints (SDC) and solving the resulting linear
+  // program exactly via its min-cost-flow dual. Considers all stage
+  // boundaries simultaneously rather than cutting one boundary at a time, so
+  // it typically produces schedules with fewer register bits than
+  // MINIMIZE_REGISTERS and scales to much larger functions.
+  SDC_MINIMIZE_REGISTERS
 };
 
 // Returns the list of ordering of cycles (pipeline stages) in which to compute
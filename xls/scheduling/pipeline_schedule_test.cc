@@ -242,6 +242,60 @@ TEST_F(PipelineScheduleTest, MinimizeRegisterBitslices) {
       UnorderedElementsAre(m::BitSlice(m::Param("x")), m::Neg(), m::Concat()));
 }
 
+TEST_F(PipelineScheduleTest, SdcMinimizeRegisterBitslices) {
+  // Same as MinimizeRegisterBitslices, but scheduled with the SDC strategy;
+  // the globally optimal schedule places the slices the same way.
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  auto x = fb.Param("x", p->GetBitsType(32));
+  auto y = fb.Param("y", p->GetBitsType(32));
+  auto x_slice = fb.BitSlice(x, /*start=*/8, /*width=*/8);
+  auto y_slice = fb.BitSlice(y, /*start=*/8, /*width=*/8);
+  auto neg_neg_y = fb.Negate(fb.Negate(y));
+  // 'x' is live throughout the function, 'y' is not.
+  fb.Concat({x, x_slice, y_slice, neg_neg_y});
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      PipelineSchedule schedule,
+      PipelineSchedule::Run(
+          f, TestDelayEstimator(),
+          SchedulingOptions(SchedulingStrategy::SDC_MINIMIZE_REGISTERS)
+              .clock_period_ps(1)));
+
+  EXPECT_EQ(schedule.length(), 2);
+  EXPECT_THAT(schedule.nodes_in_cycle(0),
+              UnorderedElementsAre(m::Param("x"), m::Param("y"),
+                                   m::BitSlice(m::Param("y")), m::Neg()));
+  EXPECT_THAT(
+      schedule.nodes_in_cycle(1),
+      UnorderedElementsAre(m::BitSlice(m::Param("x")), m::Neg(), m::Concat()));
+}
+
+TEST_F(PipelineScheduleTest, SdcScheduleMeetsTiming) {
+  // A chain of unit-delay operations with slack in the stage assignment; the
+  // SDC schedule must still respect the clock period within each stage
+  // (verified by PipelineSchedule::Run).
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue value = fb.Param("x", p->GetBitsType(32));
+  for (int64_t i = 0; i < 4; ++i) {
+    value = fb.Not(value);
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      PipelineSchedule schedule,
+      PipelineSchedule::Run(
+          f, TestDelayEstimator(),
+          SchedulingOptions(SchedulingStrategy::SDC_MINIMIZE_REGISTERS)
+              .clock_period_ps(2)
+              .pipeline_stages(3)));
+  EXPECT_EQ(schedule.length(), 3);
+  XLS_EXPECT_OK(schedule.Verify());
+}
+
 TEST_F(PipelineScheduleTest, AsapScheduleComplex) {
   auto p = CreatePackage();
   FunctionBuilder fb(TestName(), p.get());
@@ -14,6 +14,8 @@
 
 #include "xls/scheduling/schedule_bounds.h"
 
+#include <iterator>
+
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "xls/common/logging/logging.h"
@@ -44,8 +46,29 @@ ScheduleBounds::ScheduleBounds(FunctionBase* f, std::vector<Node*> topo_sort,
 void ScheduleBounds::Reset() {
   max_lower_bound_ = 0;
   min_upper_bound_ = 0;
-  for (Node* node : topo_sort_) {
+  topo_index_.clear();
+  lb_in_cycle_delay_.clear();
+  ub_in_cycle_delay_.clear();
+  lb_propagated_.clear();
+  ub_propagated_.clear();
+  lb_dirty_.clear();
+  ub_dirty_.clear();
+  if (!topo_sort_.empty()) {
+    FunctionBase* f = topo_sort_.front()->function_base();
+    bounds_.Reserve(f);
+    topo_index_.Reserve(f);
+    lb_in_cycle_delay_.Reserve(f);
+    ub_in_cycle_delay_.Reserve(f);
+    lb_propagated_.Reserve(f);
+    ub_propagated_.Reserve(f);
+  }
+  for (int64_t i = 0; i < topo_sort_.size(); ++i) {
+    Node* node = topo_sort_[i];
     bounds_[node] = {0, std::numeric_limits<int64_t>::max()};
+    topo_index_[node] = i;
+    // All nodes must be visited by the initial propagation.
+    lb_dirty_.insert(i);
+    ub_dirty_.insert(i);
     max_lower_bound_ = 0;
     min_upper_bound_ = std::numeric_limits<int64_t>::max();
   }
@@ -53,102 +76,129 @@ void ScheduleBounds::Reset() {
 
 std::string ScheduleBounds::ToString() const {
   std::string out = "Bounds:\n";
-  if (!bounds_.empty()) {
-    for (Node* node : TopoSort(bounds_.begin()->first->function_base())) {
-      if (bounds_.contains(node)) {
-        absl::StrAppendFormat(&out, "  %s : [%d, %d]\n", node->GetName(),
-                              lb(node), ub(node));
-      }
-    }
+  for (Node* node : topo_sort_) {
+    absl::StrAppendFormat(&out, "  %s : [%d, %d]\n", node->GetName(), lb(node),
+                          ub(node));
   }
   return out;
 }
 
 absl::Status ScheduleBounds::PropagateLowerBounds() {
   XLS_VLOG(4) << "PropagateLowerBounds()";
-  // The delay in picoseconds from the beginning of a cycle to the start of the
-  // node.
-  absl::flat_hash_map<Node*, int64_t> in_cycle_delay;
+  // Visit stale nodes in topological order (smallest dirty index first); a
+  // node's operands precede it in the order so their bounds and in-cycle
+  // delays are final when the node is visited. Users are enqueued only when a
+  // node's bound or in-cycle delay actually changed, so a propagation after a
+  // few tightenings touches only the affected cone of the graph.
+  while (!lb_dirty_.empty()) {
+    int64_t index = *lb_dirty_.begin();
+    lb_dirty_.erase(lb_dirty_.begin());
+    Node* node = topo_sort_[index];
 
-  // Compute the lower bound of each node based on the lower bounds of the
-  // operands of the node.
-  for (Node* node : topo_sort_) {
-    int64_t& node_in_cycle_delay = in_cycle_delay[node];
-    XLS_VLOG(4) << absl::StreamFormat("  %s : original lb=%d", node->GetName(),
-                                      lb(node));
+    int64_t new_lb = lb(node);
     for (Node* operand : node->operands()) {
-      int64_t operand_lb = lb(operand);
-      if (operand_lb < lb(node)) {
-        continue;
-      }
-      XLS_ASSIGN_OR_RETURN(int64_t operand_delay,
-                           delay_estimator_->GetOperationDelayInPs(operand));
-      if (operand_lb > lb(node)) {
-        XLS_VLOG(4) << absl::StreamFormat(
-            "    tightened lb to %d because of operand %s", operand_lb,
-            operand->GetName());
-        XLS_RETURN_IF_ERROR(TightenNodeLb(node, operand_lb));
-        node_in_cycle_delay = in_cycle_delay.at(operand) + operand_delay;
-        continue;
+      new_lb = std::max(new_lb, lb(operand));
+    }
+    // The delay in picoseconds from the beginning of the cycle to the start
+    // of the node.
+    int64_t node_in_cycle_delay = 0;
+    for (Node* operand : node->operands()) {
+      if (lb(operand) == new_lb) {
+        XLS_ASSIGN_OR_RETURN(int64_t operand_delay,
+                             delay_estimator_->GetOperationDelayInPs(operand));
+        node_in_cycle_delay =
+            std::max(node_in_cycle_delay,
+                     lb_in_cycle_delay_.at(operand) + operand_delay);
       }
-      node_in_cycle_delay = std::max(
-          node_in_cycle_delay, in_cycle_delay.at(operand) + operand_delay);
     }
     XLS_ASSIGN_OR_RETURN(int64_t node_delay,
                          delay_estimator_->GetOperationDelayInPs(node));
     XLS_RET_CHECK_LE(node_delay, clock_period_ps_) << node;
     if (node_in_cycle_delay + node_delay > clock_period_ps_) {
       // Node does not fit in this cycle. Move to next cycle.
-      XLS_VLOG(4) << "    overflows clock period, tightened lb to "
-                  << lb(node) + 1;
-      XLS_RETURN_IF_ERROR(TightenNodeLb(node, lb(node) + 1));
+      new_lb += 1;
       node_in_cycle_delay = 0;
     }
+    if (new_lb > lb(node)) {
+      XLS_VLOG(4) << absl::StreamFormat("  %s : tightened lb to %d",
+                                        node->GetName(), new_lb);
+      XLS_RETURN_IF_ERROR(TightenNodeLb(node, new_lb));
+      // TightenNodeLb re-inserts the node; it has just been brought up to
+      // date.
+      lb_dirty_.erase(index);
+    }
+    bool changed = !lb_propagated_.contains(node) ||
+                   lb_propagated_.at(node) != new_lb ||
+                   lb_in_cycle_delay_.at(node) != node_in_cycle_delay;
+    lb_propagated_[node] = new_lb;
+    lb_in_cycle_delay_[node] = node_in_cycle_delay;
+    if (changed) {
+      for (Node* user : node->users()) {
+        lb_dirty_.insert(topo_index_.at(user));
+      }
+    }
   }
   return absl::OkStatus();
 }
 
 absl::Status ScheduleBounds::PropagateUpperBounds() {
   XLS_VLOG(4) << "PropagateUpperBounds()";
-  // The delay in picoseconds from the end of a cycle to the end of the node.
-  absl::flat_hash_map<Node*, int64_t> in_cycle_delay;
+  // Mirror image of PropagateLowerBounds: visit stale nodes in reverse
+  // topological order (largest dirty index first) so the bounds and in-cycle
+  // delays of a node's users are final when the node is visited.
+  while (!ub_dirty_.empty()) {
+    auto dirty_it = std::prev(ub_dirty_.end());
+    int64_t index = *dirty_it;
+    ub_dirty_.erase(dirty_it);
+    Node* node = topo_sort_[index];
 
-  // Compute the upper bound of each node based on the upper bounds of the
-  // users of the node.
-  for (auto it = topo_sort_.rbegin(); it != topo_sort_.rend(); ++it) {
-    Node* node = *it;
-    int64_t& node_in_cycle_delay = in_cycle_delay[node];
-    XLS_VLOG(4) << absl::StreamFormat("  %s : original ub=%d", node->GetName(),
-                                      ub(node));
+    // Users with untightened (INT64_MAX) upper bounds impose no constraint.
+    int64_t new_ub = ub(node);
     for (Node* user : node->users()) {
-      int64_t user_ub = ub(user);
-      if (user_ub == std::numeric_limits<int64_t>::max() ||
-          user_ub > ub(node)) {
-        continue;
+      if (ub(user) != std::numeric_limits<int64_t>::max()) {
+        new_ub = std::min(new_ub, ub(user));
       }
-      XLS_ASSIGN_OR_RETURN(int64_t user_delay,
-                           delay_estimator_->GetOperationDelayInPs(user));
-      if (user_ub < ub(node)) {
-        XLS_VLOG(4) << absl::StreamFormat(
-            "    tightened ub to %d because of user %s", user_ub,
-            user->GetName());
-        XLS_RETURN_IF_ERROR(TightenNodeUb(node, user_ub));
-        node_in_cycle_delay = in_cycle_delay.at(user) + user_delay;
-        continue;
+    }
+    // The delay in picoseconds from the end of the cycle back to the end of
+    // the node.
+    int64_t node_in_cycle_delay = 0;
+    if (new_ub != std::numeric_limits<int64_t>::max()) {
+      for (Node* user : node->users()) {
+        if (ub(user) == new_ub) {
+          XLS_ASSIGN_OR_RETURN(int64_t user_delay,
+                               delay_estimator_->GetOperationDelayInPs(user));
+          node_in_cycle_delay =
+              std::max(node_in_cycle_delay,
+                       ub_in_cycle_delay_.at(user) + user_delay);
+        }
       }
-      node_in_cycle_delay =
-          std::max(node_in_cycle_delay, in_cycle_delay.at(user) + user_delay);
     }
     XLS_ASSIGN_OR_RETURN(int64_t node_delay,
                          delay_estimator_->GetOperationDelayInPs(node));
     XLS_RET_CHECK_LE(node_delay, clock_period_ps_) << node;
     if (node_in_cycle_delay + node_delay > clock_period_ps_) {
-      // Node does not fit in this cycle. Move to next cycle.
-      XLS_VLOG(4) << "    overflows clock period, tightened ub to "
-                  << ub(node) - 1;
-      XLS_RETURN_IF_ERROR(TightenNodeUb(node, ub(node) - 1));
+      // Node does not fit in this cycle. Move to previous cycle.
+      new_ub -= 1;
       node_in_cycle_delay = 0;
     }
+    if (new_ub < ub(node)) {
+      XLS_VLOG(4) << absl::StreamFormat("  %s : tightened ub to %d",
+                                        node->GetName(), new_ub);
+      XLS_RETURN_IF_ERROR(TightenNodeUb(node, new_ub));
+      // TightenNodeUb re-inserts the node; it has just been brought up to
+      // date.
+      ub_dirty_.erase(index);
+    }
+    bool changed = !ub_propagated_.contains(node) ||
+                   ub_propagated_.at(node) != new_ub ||
+                   ub_in_cycle_delay_.at(node) != node_in_cycle_delay;
+    ub_propagated_[node] = new_ub;
+    ub_in_cycle_delay_[node] = node_in_cycle_delay;
+    if (changed) {
+      for (Node* operand : node->operands()) {
+        ub_dirty_.insert(topo_index_.at(operand));
+      }
+    }
   }
   return absl::OkStatus();
 }
@@ -17,9 +17,9 @@
 
 #include <cstdint>
 #include <limits>
+#include <set>
 #include <utility>
 
-#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
@@ -28,6 +28,7 @@
 #include "xls/delay_model/delay_estimator.h"
 #include "xls/ir/function.h"
 #include "xls/ir/node.h"
+#include "xls/ir/node_map.h"
 
 namespace xls {
 namespace sched {
@@ -83,7 +84,10 @@ class ScheduleBounds {
           absl::StrFormat("Unable to tighten the lower bound of node %s to %d.",
                           node->GetName(), value));
     }
-    bounds_.at(node).first = std::max(bounds_.at(node).first, value);
+    if (value > bounds_.at(node).first) {
+      bounds_.at(node).first = value;
+      lb_dirty_.insert(topo_index_.at(node));
+    }
     max_lower_bound_ = std::max(max_lower_bound_, value);
     return absl::OkStatus();
   }
@@ -97,7 +101,10 @@ class ScheduleBounds {
           absl::StrFormat("Unable to tighten the upper bound of node %s to %d.",
                           node->GetName(), value));
     }
-    bounds_.at(node).second = std::min(bounds_.at(node).second, value);
+    if (value < bounds_.at(node).second) {
+      bounds_.at(node).second = value;
+      ub_dirty_.insert(topo_index_.at(node));
+    }
     min_upper_bound_ = std::min(min_upper_bound_, value);
     return absl::OkStatus();
   }
@@ -114,6 +121,12 @@ class ScheduleBounds {
   // throughout the graph. This method only tightens bounds (increases lower
   // bounds and decreases upper bounds). Returns an error if propagation results
   // in infeasible bounds (lower bound is greater than upper bound for a node).
+  //
+  // Propagation is incremental: only nodes downstream (upstream) of bounds
+  // tightened since the last call are revisited, and tightenings of multiple
+  // nodes are propagated together in a single worklist pass. Iterative users
+  // such as the min-cut scheduler and the clock-period binary search may
+  // therefore tighten batches of nodes and propagate cheaply each iteration.
   absl::Status PropagateLowerBounds();
   absl::Status PropagateUpperBounds();
 
@@ -124,8 +137,30 @@ class ScheduleBounds {
   int64_t clock_period_ps_;
   const DelayEstimator* delay_estimator_;
 
-  // The bounds of each node stored as a {lower, upper} pair.
-  absl::flat_hash_map<Node*, std::pair<int64_t, int64_t>> bounds_;
+  // The bounds of each node stored as a {lower, upper} pair. These per-node
+  // tables are all node-id indexed (NodeMap) as the bound propagation loops
+  // perform several lookups per visited edge.
+  NodeMap<std::pair<int64_t, int64_t>> bounds_;
+
+  // Position of each node in topo_sort_.
+  NodeMap<int64_t> topo_index_;
+
+  // The delay from the start (end) of a node's cycle to the start (end) of
+  // the node as of the last time the node was propagated. Kept across
+  // propagation calls so that only changed nodes need revisiting.
+  NodeMap<int64_t> lb_in_cycle_delay_;
+  NodeMap<int64_t> ub_in_cycle_delay_;
+
+  // The lower (upper) bound of each node as of the last time it was
+  // propagated; used to detect externally tightened bounds whose users
+  // (operands) have not yet been notified.
+  NodeMap<int64_t> lb_propagated_;
+  NodeMap<int64_t> ub_propagated_;
+
+  // Topo-sort indices of nodes whose bounds may be stale, ordered so that
+  // propagation visits them in (reverse) topological order.
+  std::set<int64_t> lb_dirty_;
+  std::set<int64_t> ub_dirty_;
 
   int64_t max_lower_bound_;
   int64_t min_upper_bound_;
@@ -160,6 +160,41 @@ TEST_F(ScheduleBoundsTest, SimpleExpressionTightenBounds) {
   EXPECT_EQ(bounds.lb(result.node()), 23);
 }
 
+TEST_F(ScheduleBoundsTest, BatchedSeedPropagation) {
+  // Tightening several nodes and then propagating once should update the
+  // affected cone of each seed, including where the cones are disjoint.
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  auto x = fb.Param("x", p->GetBitsType(32));
+  auto y = fb.Param("y", p->GetBitsType(32));
+  auto not_x = fb.Not(x);
+  auto not_not_x = fb.Not(not_x);
+  auto not_y = fb.Not(y);
+  auto not_not_y = fb.Not(not_y);
+  fb.Tuple({not_not_x, not_not_y});
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  ScheduleBounds bounds(f, /*clock_period_ps=*/1, delay_estimator_);
+  XLS_ASSERT_OK(bounds.PropagateLowerBounds());
+  EXPECT_EQ(bounds.lb(not_not_x.node()), 1);
+  EXPECT_EQ(bounds.lb(not_not_y.node()), 1);
+
+  // Seed both independent chains, then propagate once.
+  XLS_ASSERT_OK(bounds.TightenNodeLb(not_x.node(), 5));
+  XLS_ASSERT_OK(bounds.TightenNodeLb(not_y.node(), 7));
+  XLS_ASSERT_OK(bounds.PropagateLowerBounds());
+
+  EXPECT_EQ(bounds.lb(x.node()), 0);
+  EXPECT_EQ(bounds.lb(y.node()), 0);
+  EXPECT_EQ(bounds.lb(not_not_x.node()), 6);
+  EXPECT_EQ(bounds.lb(not_not_y.node()), 8);
+
+  // A propagation with no intervening tightenings changes nothing.
+  XLS_ASSERT_OK(bounds.PropagateLowerBounds());
+  EXPECT_EQ(bounds.lb(not_not_x.node()), 6);
+  EXPECT_EQ(bounds.lb(not_not_y.node()), 8);
+}
+
 }  // namespace
 }  // namespace sched
 }  // namespace xls
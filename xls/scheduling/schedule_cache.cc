@@ -0,0 +1,108 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/scheduling/schedule_cache.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/logging/logging.h"
+
+namespace xls {
+namespace {
+
+// Stable 64-bit FNV-1a hash. The key names an on-disk entry that must be
+// found again by later processes (a CI run caching for the next run), so a
+// per-process-seeded hash such as absl::Hash cannot be used.
+uint64_t StableHash(absl::string_view data,
+                    uint64_t hash = 0xcbf29ce484222325ULL) {
+  for (char c : data) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// Canonical textual serialization of the scheduling options, naming every
+// field. Any field added to SchedulingOptions must be added here, otherwise
+// runs differing only in that field share cache entries and one of them gets
+// a schedule computed under the wrong options.
+std::string SerializeOptions(const SchedulingOptions& options) {
+  return absl::StrFormat(
+      "strategy=%d clock_period_ps=%d pipeline_stages=%d "
+      "clock_margin_percent=%d",
+      static_cast<int64_t>(options.strategy()),
+      options.clock_period_ps().value_or(-1),
+      options.pipeline_stages().value_or(-1),
+      options.clock_margin_percent().value_or(-1));
+}
+
+}  // namespace
+
+ScheduleCache::ScheduleCache(std::filesystem::path cache_dir)
+    : cache_dir_(std::move(cache_dir)) {
+  absl::Status status = RecursivelyCreateDir(cache_dir_);
+  if (!status.ok()) {
+    XLS_LOG(WARNING) << "Unable to create schedule cache directory "
+                     << cache_dir_ << ": " << status;
+  }
+}
+
+/* static */ std::string ScheduleCache::MakeCacheKey(
+    FunctionBase* f, const SchedulingOptions& options,
+    absl::string_view delay_model_name) {
+  std::string ir_text = f->DumpIr();
+  uint64_t hash = StableHash(absl::StrCat(SerializeOptions(options), "\n",
+                                          delay_model_name, "\n", ir_text));
+  return absl::StrFormat("xls-sched-%d-%016x", ir_text.size(), hash);
+}
+
+absl::optional<PipelineSchedule> ScheduleCache::Lookup(
+    Function* function, absl::string_view key) const {
+  absl::StatusOr<PipelineScheduleProto> proto =
+      ParseTextProtoFile<PipelineScheduleProto>(EntryPath(key));
+  if (!proto.ok()) {
+    return absl::nullopt;
+  }
+  absl::StatusOr<PipelineSchedule> schedule =
+      PipelineSchedule::FromProto(function, *proto);
+  if (!schedule.ok() || !schedule->Verify().ok()) {
+    // The entry does not describe this function (e.g. a key collision);
+    // treat it as a miss and let the caller overwrite it.
+    XLS_LOG(WARNING) << "Ignoring inapplicable schedule cache entry for "
+                     << function->name();
+    return absl::nullopt;
+  }
+  XLS_VLOG(2) << "Schedule cache hit for " << function->name();
+  return std::move(schedule).value();
+}
+
+void ScheduleCache::Insert(absl::string_view key,
+                           const PipelineSchedule& schedule) {
+  absl::Status status = SetTextProtoFile(EntryPath(key), schedule.ToProto());
+  if (!status.ok()) {
+    XLS_LOG(WARNING) << "Unable to write schedule cache entry: " << status;
+  }
+}
+
+std::filesystem::path ScheduleCache::EntryPath(absl::string_view key) const {
+  return cache_dir_ / absl::StrCat(key, ".pbtxt");
+}
+
+}  // namespace xls
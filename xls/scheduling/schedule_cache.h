@@ -0,0 +1,72 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_SCHEDULING_SCHEDULE_CACHE_H_
+#define XLS_SCHEDULING_SCHEDULE_CACHE_H_
+
+#include <filesystem>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "xls/ir/function.h"
+#include "xls/scheduling/pipeline_schedule.h"
+
+namespace xls {
+
+// An on-disk cache of pipeline schedules, keyed by a hash of the function's
+// IR text and the scheduling configuration. Entries are stored as
+// PipelineScheduleProto text protos. Pointing a tool (e.g. codegen_main) at
+// a persistent cache directory lets repeated runs over unchanged functions
+// skip scheduling entirely, which on incremental changes is the large
+// majority of functions.
+//
+// A cache entry is only valid for identical IR text, scheduling options, and
+// delay model; MakeCacheKey() folds all of these into the key. Entries are
+// never evicted - the caller owns the lifetime of the cache directory.
+class ScheduleCache {
+ public:
+  // Creates a cache rooted at "cache_dir". The directory is created if it
+  // does not already exist.
+  explicit ScheduleCache(std::filesystem::path cache_dir);
+
+  // Returns the cache key for scheduling "f" with the given options under
+  // the named delay model. The function's textual IR dump serves as its
+  // structural fingerprint. The key is a hash, so distinct inputs can in
+  // principle collide; the IR text length is folded into the key to make
+  // collisions less likely.
+  static std::string MakeCacheKey(FunctionBase* f,
+                                  const SchedulingOptions& options,
+                                  absl::string_view delay_model_name);
+
+  // Returns the cached schedule for "function" under "key", or absl::nullopt
+  // if there is no entry or the entry does not apply to the function (e.g. a
+  // key collision left an entry naming different nodes). A returned schedule
+  // has passed PipelineSchedule::Verify().
+  absl::optional<PipelineSchedule> Lookup(Function* function,
+                                          absl::string_view key) const;
+
+  // Stores the given schedule under "key". A write failure only costs a
+  // re-schedule on the next run and is logged, not returned.
+  void Insert(absl::string_view key, const PipelineSchedule& schedule);
+
+ private:
+  std::filesystem::path EntryPath(absl::string_view key) const;
+
+  std::filesystem::path cache_dir_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_SCHEDULING_SCHEDULE_CACHE_H_
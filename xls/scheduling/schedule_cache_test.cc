@@ -0,0 +1,108 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/scheduling/schedule_cache.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+
+namespace xls {
+namespace {
+
+class ScheduleCacheTest : public IrTestBase {
+ protected:
+  absl::StatusOr<Function*> BuildFunction(Package* p,
+                                          absl::string_view name = "main") {
+    FunctionBuilder fb(name, p);
+    BValue x = fb.Param("x", p->GetBitsType(32));
+    fb.Not(fb.Negate(x));
+    return fb.Build();
+  }
+};
+
+TEST_F(ScheduleCacheTest, CacheKeyIsDeterministicAndInputSensitive) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BuildFunction(p.get()));
+
+  SchedulingOptions options;
+  options.pipeline_stages(2);
+  std::string key = ScheduleCache::MakeCacheKey(f, options, "unit");
+  EXPECT_EQ(key, ScheduleCache::MakeCacheKey(f, options, "unit"));
+  EXPECT_NE(key, ScheduleCache::MakeCacheKey(f, options, "other_model"));
+  EXPECT_NE(key, ScheduleCache::MakeCacheKey(
+                     f, SchedulingOptions().pipeline_stages(3), "unit"));
+  SchedulingOptions asap_options(SchedulingStrategy::ASAP);
+  asap_options.pipeline_stages(2);
+  EXPECT_NE(key, ScheduleCache::MakeCacheKey(f, asap_options, "unit"));
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * g, BuildFunction(p.get(), "other"));
+  EXPECT_NE(key, ScheduleCache::MakeCacheKey(g, options, "unit"));
+}
+
+TEST_F(ScheduleCacheTest, SchedulePersistsAndIsReloaded) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BuildFunction(p.get()));
+
+  ScheduleCycleMap cycle_map;
+  for (Node* node : f->nodes()) {
+    cycle_map[node] = node->Is<Param>() ? 0 : 1;
+  }
+  PipelineSchedule schedule(f, cycle_map, /*length=*/2);
+
+  SchedulingOptions options;
+  options.pipeline_stages(2);
+  std::string key = ScheduleCache::MakeCacheKey(f, options, "unit");
+
+  ScheduleCache cache(temp_dir.path());
+  EXPECT_EQ(cache.Lookup(f, key), absl::nullopt);
+  cache.Insert(key, schedule);
+
+  // A separate cache instance over the same directory sees the entry.
+  ScheduleCache reloaded_cache(temp_dir.path());
+  absl::optional<PipelineSchedule> reloaded = reloaded_cache.Lookup(f, key);
+  ASSERT_TRUE(reloaded.has_value());
+  EXPECT_EQ(reloaded->length(), 2);
+  for (Node* node : f->nodes()) {
+    EXPECT_EQ(reloaded->cycle(node), cycle_map.at(node)) << node->GetName();
+  }
+}
+
+TEST_F(ScheduleCacheTest, InapplicableEntryIsAMiss) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BuildFunction(p.get()));
+
+  ScheduleCycleMap cycle_map;
+  for (Node* node : f->nodes()) {
+    cycle_map[node] = 0;
+  }
+  PipelineSchedule schedule(f, cycle_map);
+
+  ScheduleCache cache(temp_dir.path());
+  cache.Insert("some-key", schedule);
+
+  // A function with differently-named nodes cannot use the entry.
+  FunctionBuilder fb("different", p.get());
+  fb.Param("y", p->GetBitsType(8));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * g, fb.Build());
+  EXPECT_EQ(cache.Lookup(g, "some-key"), absl::nullopt);
+}
+
+}  // namespace
+}  // namespace xls
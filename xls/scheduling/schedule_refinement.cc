@@ -0,0 +1,216 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/scheduling/schedule_refinement.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/node_iterator.h"
+#include "xls/ir/nodes.h"
+
+namespace xls {
+namespace sched {
+
+RegisterCostEvaluator::RegisterCostEvaluator(
+    FunctionBase* f, const absl::flat_hash_map<Node*, int64_t>& cycle_map,
+    int64_t schedule_length)
+    : schedule_length_(schedule_length) {
+  cycle_.Reserve(f);
+  width_.Reserve(f);
+  use_counts_.Reserve(f);
+  for (Node* node : f->nodes()) {
+    cycle_[node] = cycle_map.at(node);
+    width_[node] = node->GetType()->GetFlatBitCount();
+    use_counts_[node] = std::vector<int64_t>(schedule_length, 0);
+  }
+  for (Node* node : f->nodes()) {
+    for (Node* operand : node->operands()) {
+      ++use_counts_.at(operand)[cycle_.at(node)];
+    }
+    if (f->HasImplicitUse(node)) {
+      ++use_counts_.at(node)[schedule_length - 1];
+    }
+  }
+  for (Node* node : f->nodes()) {
+    total_cost_ += NodeCost(node);
+  }
+}
+
+int64_t RegisterCostEvaluator::LastUseCycle(Node* node) const {
+  const std::vector<int64_t>& counts = use_counts_.at(node);
+  for (int64_t c = schedule_length_ - 1; c >= 0; --c) {
+    if (counts[c] > 0) {
+      return std::max(c, cycle_.at(node));
+    }
+  }
+  return cycle_.at(node);
+}
+
+int64_t RegisterCostEvaluator::NodeCost(Node* node) const {
+  return width_.at(node) * (LastUseCycle(node) - cycle_.at(node));
+}
+
+int64_t RegisterCostEvaluator::MoveDelta(Node* node, int64_t cycle) {
+  int64_t old_cycle = cycle_.at(node);
+  if (cycle == old_cycle) {
+    return 0;
+  }
+  // Only the costs of the node itself (definition cycle changes) and of its
+  // operands (one use moves) are affected. Apply the move to the
+  // bookkeeping, measure, and restore.
+  int64_t delta = -NodeCost(node);
+  for (Node* operand : node->operands()) {
+    delta -= NodeCost(operand);
+    // Deduplicate: count each distinct operand's cost once but move every
+    // use. Duplicate operands are re-added (and re-subtracted) with the
+    // intermediate counts, which cancels out.
+    --use_counts_.at(operand)[old_cycle];
+    ++use_counts_.at(operand)[cycle];
+    delta += NodeCost(operand);
+  }
+  cycle_.at(node) = cycle;
+  delta += NodeCost(node);
+  cycle_.at(node) = old_cycle;
+  for (Node* operand : node->operands()) {
+    ++use_counts_.at(operand)[old_cycle];
+    --use_counts_.at(operand)[cycle];
+  }
+  return delta;
+}
+
+void RegisterCostEvaluator::ApplyMove(Node* node, int64_t cycle) {
+  total_cost_ += MoveDelta(node, cycle);
+  int64_t old_cycle = cycle_.at(node);
+  for (Node* operand : node->operands()) {
+    --use_counts_.at(operand)[old_cycle];
+    ++use_counts_.at(operand)[cycle];
+  }
+  cycle_.at(node) = cycle;
+}
+
+absl::StatusOr<absl::flat_hash_map<Node*, int64_t>>
+RefineScheduleToMinimizeRegisters(
+    FunctionBase* f, absl::flat_hash_map<Node*, int64_t> cycle_map,
+    int64_t schedule_length, int64_t clock_period_ps,
+    const DelayEstimator& delay_estimator, int64_t max_passes) {
+  RegisterCostEvaluator evaluator(f, cycle_map, schedule_length);
+  XLS_VLOG(3) << "RefineScheduleToMinimizeRegisters: initial register cost "
+              << evaluator.total_cost() << " bits";
+
+  std::vector<Node*> topo = TopoSort(f).AsVector();
+  NodeMap<int64_t> topo_index(f);
+  for (int64_t i = 0; i < static_cast<int64_t>(topo.size()); ++i) {
+    topo_index[topo[i]] = i;
+  }
+
+  NodeMap<int64_t> delays(f);
+  for (Node* node : topo) {
+    XLS_ASSIGN_OR_RETURN(delays[node],
+                         delay_estimator.GetOperationDelayInPs(node));
+  }
+
+  // The nodes of each stage in topological order, for the timing check.
+  std::vector<std::vector<Node*>> stage_nodes(schedule_length);
+  for (Node* node : topo) {
+    stage_nodes[cycle_map.at(node)].push_back(node);
+  }
+
+  // Returns true if the given stage meets the clock period with `moved`
+  // added to it. Only the destination stage of a move has to be rechecked;
+  // removing a node from a stage cannot lengthen its critical path.
+  auto stage_meets_timing = [&](int64_t stage, Node* moved) -> bool {
+    std::vector<Node*> nodes = stage_nodes[stage];
+    nodes.insert(std::upper_bound(nodes.begin(), nodes.end(), moved,
+                                  [&](Node* a, Node* b) {
+                                    return topo_index.at(a) < topo_index.at(b);
+                                  }),
+                 moved);
+    absl::flat_hash_map<Node*, int64_t> critical_path;
+    critical_path.reserve(nodes.size());
+    for (Node* node : nodes) {
+      int64_t start = 0;
+      for (Node* operand : node->operands()) {
+        auto it = critical_path.find(operand);
+        if (it != critical_path.end()) {
+          start = std::max(start, it->second);
+        }
+      }
+      int64_t path = start + delays.at(node);
+      if (path > clock_period_ps) {
+        return false;
+      }
+      critical_path[node] = path;
+    }
+    return true;
+  };
+
+  bool changed = true;
+  for (int64_t pass = 0; pass < max_passes && changed; ++pass) {
+    changed = false;
+    for (Node* node : topo) {
+      // Nodes pinned to the first or final stage stay put.
+      if (node->Is<Param>() || node->Is<Receive>() || node->Is<Send>() ||
+          f->HasImplicitUse(node)) {
+        continue;
+      }
+      int64_t current = evaluator.cycle(node);
+      int64_t lo = 0;
+      for (Node* operand : node->operands()) {
+        lo = std::max(lo, evaluator.cycle(operand));
+      }
+      int64_t hi = schedule_length - 1;
+      for (Node* user : node->users()) {
+        hi = std::min(hi, evaluator.cycle(user));
+      }
+      int64_t best_cycle = current;
+      int64_t best_delta = 0;
+      for (int64_t candidate = lo; candidate <= hi; ++candidate) {
+        if (candidate == current) {
+          continue;
+        }
+        int64_t delta = evaluator.MoveDelta(node, candidate);
+        if (delta < best_delta && stage_meets_timing(candidate, node)) {
+          best_delta = delta;
+          best_cycle = candidate;
+        }
+      }
+      if (best_cycle != current) {
+        evaluator.ApplyMove(node, best_cycle);
+        std::vector<Node*>& from = stage_nodes[current];
+        from.erase(std::find(from.begin(), from.end(), node));
+        std::vector<Node*>& to = stage_nodes[best_cycle];
+        to.insert(std::upper_bound(to.begin(), to.end(), node,
+                                   [&](Node* a, Node* b) {
+                                     return topo_index.at(a) <
+                                            topo_index.at(b);
+                                   }),
+                  node);
+        changed = true;
+      }
+    }
+  }
+
+  XLS_VLOG(3) << "RefineScheduleToMinimizeRegisters: final register cost "
+              << evaluator.total_cost() << " bits";
+  for (auto& [node, cycle] : cycle_map) {
+    cycle = evaluator.cycle(node);
+  }
+  return std::move(cycle_map);
+}
+
+}  // namespace sched
+}  // namespace xls
@@ -0,0 +1,95 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_SCHEDULING_SCHEDULE_REFINEMENT_H_
+#define XLS_SCHEDULING_SCHEDULE_REFINEMENT_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "xls/delay_model/delay_estimator.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
+#include "xls/ir/node_map.h"
+
+namespace xls {
+namespace sched {
+
+// Incremental evaluator of the global register cost of a pipeline schedule.
+// The cost is the total width in bits of the pipeline registers: a value
+// defined in stage s whose last use is in stage u crosses u - s stage
+// boundaries and is registered once per boundary, so it costs
+// width * (u - s) bits. Nodes with implicit uses (function return value,
+// proc next-state/token) are treated as used in the final stage. Unlike the
+// per-boundary accounting of the min-cut scheduler this objective charges
+// multi-stage lifetimes their full cost.
+class RegisterCostEvaluator {
+ public:
+  RegisterCostEvaluator(FunctionBase* f,
+                        const absl::flat_hash_map<Node*, int64_t>& cycle_map,
+                        int64_t schedule_length);
+
+  // The total register cost in bits of the current schedule.
+  int64_t total_cost() const { return total_cost_; }
+
+  // The cycle in which 'node' is currently scheduled.
+  int64_t cycle(Node* node) const { return cycle_.at(node); }
+
+  // Returns the change in total cost were 'node' moved to 'cycle'. The cost
+  // bookkeeping is adjusted and restored rather than recomputed, so a call
+  // is O(operand count * schedule length) and a local search can evaluate
+  // thousands of candidate moves per second on large functions.
+  int64_t MoveDelta(Node* node, int64_t cycle);
+
+  // Moves 'node' to 'cycle' and incrementally updates the cost.
+  void ApplyMove(Node* node, int64_t cycle);
+
+ private:
+  // The latest cycle in which 'node' is used, or its own cycle if unused.
+  int64_t LastUseCycle(Node* node) const;
+
+  // The register bits contributed by 'node' with the current placement.
+  int64_t NodeCost(Node* node) const;
+
+  int64_t schedule_length_;
+  NodeMap<int64_t> cycle_;
+  NodeMap<int64_t> width_;
+  // use_counts_.at(node)[c] is the number of uses of 'node' scheduled in
+  // cycle c, including one count in the final cycle for an implicit use.
+  NodeMap<std::vector<int64_t>> use_counts_;
+  int64_t total_cost_ = 0;
+};
+
+// Improves the given schedule by local search: nodes are moved between
+// stages, one at a time, when doing so reduces the total register cost as
+// measured by RegisterCostEvaluator. A move must keep every operand at or
+// before and every user at or after the node, and must not extend the
+// critical path of the destination stage beyond the clock period (checked by
+// recomputing only that stage). Nodes pinned to the first or final stage
+// (parameters, receives, sends, and nodes with implicit uses) are not
+// moved. The search sweeps the nodes in topological order until a sweep
+// yields no improvement, up to `max_passes` sweeps. Returns the refined
+// cycle map.
+absl::StatusOr<absl::flat_hash_map<Node*, int64_t>>
+RefineScheduleToMinimizeRegisters(
+    FunctionBase* f, absl::flat_hash_map<Node*, int64_t> cycle_map,
+    int64_t schedule_length, int64_t clock_period_ps,
+    const DelayEstimator& delay_estimator, int64_t max_passes = 16);
+
+}  // namespace sched
+}  // namespace xls
+
+#endif  // XLS_SCHEDULING_SCHEDULE_REFINEMENT_H_
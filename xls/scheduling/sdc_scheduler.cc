@@ -0,0 +1,344 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/scheduling/sdc_scheduler.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/node_iterator.h"
+
+namespace xls {
+namespace sched {
+namespace {
+
+constexpr int64_t kInfinity = std::numeric_limits<int64_t>::max();
+
+// A min-cost flow problem over a graph whose nodes are the variables of the
+// difference-constraint program. Each constraint `x_j - x_i <= b` becomes an
+// uncapacitated arc from variable i to variable j with cost b, and each
+// objective term `d_k * x_k` becomes a supply (d_k > 0) or demand (d_k < 0)
+// of |d_k| units at variable k. By linear-programming duality the node
+// potentials of an optimal flow are an optimal (and, because all constants
+// are integral, integral) assignment to the variables.
+//
+// The flow is computed with successive shortest augmenting paths using node
+// potentials (initialized by Bellman-Ford since constraint costs may be
+// negative), so each augmentation is a Dijkstra search.
+class MinCostFlow {
+ public:
+  explicit MinCostFlow(int64_t node_count)
+      : adjacency_(node_count), potential_(node_count, 0) {}
+
+  // Adds an arc with the given capacity and cost (and its zero-capacity
+  // reverse arc).
+  void AddArc(int64_t tail, int64_t head, int64_t capacity, int64_t cost) {
+    adjacency_[tail].push_back(arcs_.size());
+    arcs_.push_back(Arc{head, capacity, cost});
+    adjacency_[head].push_back(arcs_.size());
+    arcs_.push_back(Arc{tail, 0, -cost});
+  }
+
+  // Seeds the potential of the given node. Solve validates (and if necessary
+  // repairs) the seeded potentials with Bellman-Ford, so seeding with a
+  // feasible solution of the difference constraints reduces that step to a
+  // single pass over the arcs.
+  void SetInitialPotential(int64_t node, int64_t value) {
+    potential_[node] = value;
+  }
+
+  // Routes as much flow as possible from `source` to `sink` at minimum
+  // cost. Returns an error if the constraint system has a negative cycle
+  // (i.e., the difference constraints are unsatisfiable) or if not all
+  // supply can be routed.
+  absl::Status Solve(int64_t source, int64_t sink);
+
+  // The node potential of the given variable after solving; potentials are
+  // an optimal solution of the difference-constraint program up to a common
+  // additive constant.
+  int64_t potential(int64_t node) const { return potential_[node]; }
+
+ private:
+  struct Arc {
+    int64_t head;
+    int64_t residual;
+    int64_t cost;
+  };
+
+  // Arcs are stored in pairs; arc i's reverse arc is i^1.
+  std::vector<Arc> arcs_;
+  std::vector<std::vector<int64_t>> adjacency_;
+  std::vector<int64_t> potential_;
+};
+
+absl::Status MinCostFlow::Solve(int64_t source, int64_t sink) {
+  int64_t node_count = adjacency_.size();
+
+  // Establish feasible potentials with Bellman-Ford, starting from the
+  // seeded values. All nodes participate (rather than relaxing from a single
+  // origin) so the resulting potentials are feasible for every arc
+  // regardless of connectivity; if the seeded potentials are already
+  // feasible this converges after one pass.
+  for (int64_t iteration = 0; iteration < node_count; ++iteration) {
+    bool changed = false;
+    for (int64_t tail = 0; tail < node_count; ++tail) {
+      for (int64_t arc_index : adjacency_[tail]) {
+        const Arc& arc = arcs_[arc_index];
+        if (arc.residual > 0 &&
+            potential_[tail] + arc.cost < potential_[arc.head]) {
+          potential_[arc.head] = potential_[tail] + arc.cost;
+          changed = true;
+        }
+      }
+    }
+    if (!changed) {
+      break;
+    }
+    if (iteration == node_count - 1) {
+      return absl::ResourceExhaustedError(
+          "Scheduling constraints are unsatisfiable (difference-constraint "
+          "system contains a negative cycle).");
+    }
+  }
+
+  std::vector<int64_t> distance(node_count);
+  std::vector<int64_t> parent_arc(node_count);
+  while (true) {
+    // Dijkstra from the source over residual arcs using reduced costs.
+    std::fill(distance.begin(), distance.end(), kInfinity);
+    std::fill(parent_arc.begin(), parent_arc.end(), -1);
+    distance[source] = 0;
+    using QueueItem = std::pair<int64_t, int64_t>;  // (distance, node)
+    std::priority_queue<QueueItem, std::vector<QueueItem>,
+                        std::greater<QueueItem>>
+        queue;
+    queue.push({0, source});
+    while (!queue.empty()) {
+      auto [dist, tail] = queue.top();
+      queue.pop();
+      if (dist > distance[tail]) {
+        continue;
+      }
+      for (int64_t arc_index : adjacency_[tail]) {
+        const Arc& arc = arcs_[arc_index];
+        if (arc.residual <= 0) {
+          continue;
+        }
+        int64_t reduced_cost =
+            arc.cost + potential_[tail] - potential_[arc.head];
+        XLS_DCHECK_GE(reduced_cost, 0);
+        if (dist + reduced_cost < distance[arc.head]) {
+          distance[arc.head] = dist + reduced_cost;
+          parent_arc[arc.head] = arc_index;
+          queue.push({distance[arc.head], arc.head});
+        }
+      }
+    }
+    if (distance[sink] == kInfinity) {
+      break;
+    }
+
+    // Fold the found distances into the potentials, capping at the sink
+    // distance so reduced costs of residual arcs remain non-negative.
+    for (int64_t node = 0; node < node_count; ++node) {
+      potential_[node] += std::min(distance[node], distance[sink]);
+    }
+
+    // Augment along the shortest path by its bottleneck capacity.
+    int64_t bottleneck = kInfinity;
+    for (int64_t node = sink; node != source;
+         node = arcs_[parent_arc[node] ^ 1].head) {
+      bottleneck = std::min(bottleneck, arcs_[parent_arc[node]].residual);
+    }
+    for (int64_t node = sink; node != source;
+         node = arcs_[parent_arc[node] ^ 1].head) {
+      arcs_[parent_arc[node]].residual -= bottleneck;
+      arcs_[parent_arc[node] ^ 1].residual += bottleneck;
+    }
+  }
+
+  // All supply must have been routed; arcs out of the source are exactly the
+  // supplies of the problem.
+  for (int64_t arc_index : adjacency_[source]) {
+    if (arc_index % 2 == 0) {
+      XLS_RET_CHECK_EQ(arcs_[arc_index].residual, 0)
+          << "min-cost flow could not route all supply; difference "
+             "constraints are unsatisfiable";
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<absl::flat_hash_map<Node*, int64_t>>
+SDCScheduleToMinimizeRegisters(FunctionBase* f, int64_t pipeline_stages,
+                               int64_t clock_period_ps,
+                               const DelayEstimator& delay_estimator,
+                               const ScheduleBounds& bounds) {
+  XLS_VLOG(3) << "SDCScheduleToMinimizeRegisters()";
+  XLS_VLOG(3) << "  pipeline stages = " << pipeline_stages;
+
+  auto topo_sort_it = TopoSort(f);
+  std::vector<Node*> topo_sort(topo_sort_it.begin(), topo_sort_it.end());
+
+  absl::flat_hash_map<Node*, int64_t> node_delay;
+  for (Node* node : topo_sort) {
+    XLS_ASSIGN_OR_RETURN(int64_t delay,
+                         delay_estimator.GetOperationDelayInPs(node));
+    if (delay > clock_period_ps) {
+      return absl::ResourceExhaustedError(absl::StrFormat(
+          "Node %s has a delay of %dps which exceeds the clock period of %dps",
+          node->GetName(), delay, clock_period_ps));
+    }
+    node_delay[node] = delay;
+  }
+
+  // Assign a variable index to the cycle of each node and, for each node with
+  // users, to the cycle of its last use (its "lifetime"); the number of
+  // register bits contributed by a node is its bit width multiplied by the
+  // difference of the two. Variable 0 is an origin pinned (by convention, via
+  // the final shift below) to cycle zero against which the per-node bounds
+  // are expressed.
+  constexpr int64_t kOrigin = 0;
+  int64_t variable_count = 1;
+  absl::flat_hash_map<Node*, int64_t> cycle_variable;
+  absl::flat_hash_map<Node*, int64_t> lifetime_variable;
+  for (Node* node : topo_sort) {
+    cycle_variable[node] = variable_count++;
+  }
+  for (Node* node : topo_sort) {
+    if (!node->users().empty() && node->GetType()->GetFlatBitCount() > 0) {
+      lifetime_variable[node] = variable_count++;
+    }
+  }
+  int64_t source = variable_count++;
+  int64_t sink = variable_count++;
+
+  MinCostFlow flow(variable_count);
+
+  // Adds the difference constraint `x_j - x_i <= b` to the program.
+  auto add_constraint = [&](int64_t i, int64_t j, int64_t b) {
+    flow.AddArc(i, j, kInfinity, b);
+  };
+
+  for (Node* node : topo_sort) {
+    int64_t cycle = cycle_variable.at(node);
+    // bounds.lb(node) <= cycle(node) <= bounds.ub(node).
+    add_constraint(kOrigin, cycle, bounds.ub(node));
+    add_constraint(cycle, kOrigin, -bounds.lb(node));
+    // cycle(operand) <= cycle(node).
+    for (Node* operand : node->operands()) {
+      add_constraint(cycle, cycle_variable.at(operand), 0);
+    }
+  }
+
+  // Any pair of nodes connected by a combinational path whose delay exceeds
+  // the clock period must be separated by at least one stage boundary:
+  // cycle(b) >= cycle(a) + 1. Propagation from a source is pruned at
+  // constrained nodes because the separation applies transitively to
+  // everything downstream of them.
+  absl::flat_hash_map<Node*, int64_t> topo_index;
+  for (int64_t i = 0; i < topo_sort.size(); ++i) {
+    topo_index[topo_sort[i]] = i;
+  }
+  std::vector<int64_t> path_delay(topo_sort.size(), -1);
+  for (int64_t a_index = 0; a_index < topo_sort.size(); ++a_index) {
+    Node* a = topo_sort[a_index];
+    path_delay[a_index] = node_delay.at(a);
+    for (int64_t b_index = a_index; b_index < topo_sort.size(); ++b_index) {
+      if (path_delay[b_index] < 0) {
+        continue;
+      }
+      Node* b = topo_sort[b_index];
+      if (path_delay[b_index] > clock_period_ps) {
+        add_constraint(cycle_variable.at(b), cycle_variable.at(a), -1);
+        continue;
+      }
+      for (Node* user : b->users()) {
+        int64_t user_index = topo_index.at(user);
+        path_delay[user_index] = std::max(
+            path_delay[user_index], path_delay[b_index] + node_delay.at(user));
+      }
+    }
+    std::fill(path_delay.begin(), path_delay.end(), -1);
+  }
+
+  // The lifetime of a node extends from its cycle through the cycle of its
+  // last use, and never past the end of the pipeline. The objective weights
+  // each lifetime by the node's width: supply enters at the lifetime variable
+  // and is absorbed at the cycle variable, so the flow "pays" (in the dual)
+  // for each cycle the value is carried in a register.
+  for (Node* node : topo_sort) {
+    auto it = lifetime_variable.find(node);
+    if (it == lifetime_variable.end()) {
+      continue;
+    }
+    int64_t lifetime = it->second;
+    int64_t cycle = cycle_variable.at(node);
+    // cycle(node) <= lifetime(node), and cycle(user) <= lifetime(node) for
+    // each user.
+    add_constraint(lifetime, cycle, 0);
+    for (Node* user : node->users()) {
+      add_constraint(lifetime, cycle_variable.at(user), 0);
+    }
+    add_constraint(kOrigin, lifetime, pipeline_stages - 1);
+    int64_t width = node->GetType()->GetFlatBitCount();
+    flow.AddArc(source, lifetime, width, 0);
+    flow.AddArc(cycle, sink, width, 0);
+  }
+
+  // Seed the solver's potentials with the as-soon-as-possible schedule (and
+  // lifetimes ending at the last use thereunder), which is a feasible
+  // solution of the constraint system; this makes the solver's feasibility
+  // phase a single pass over the constraints.
+  flow.SetInitialPotential(kOrigin, 0);
+  flow.SetInitialPotential(sink, 0);
+  flow.SetInitialPotential(source, pipeline_stages - 1);
+  for (Node* node : topo_sort) {
+    flow.SetInitialPotential(cycle_variable.at(node), bounds.lb(node));
+    auto it = lifetime_variable.find(node);
+    if (it != lifetime_variable.end()) {
+      int64_t last_use = bounds.lb(node);
+      for (Node* user : node->users()) {
+        last_use = std::max(last_use, bounds.lb(user));
+      }
+      flow.SetInitialPotential(it->second, last_use);
+    }
+  }
+
+  XLS_RETURN_IF_ERROR(flow.Solve(source, sink));
+
+  absl::flat_hash_map<Node*, int64_t> cycle_map;
+  int64_t origin_potential = flow.potential(kOrigin);
+  for (Node* node : topo_sort) {
+    int64_t cycle = flow.potential(cycle_variable.at(node)) - origin_potential;
+    XLS_RET_CHECK_GE(cycle, bounds.lb(node)) << node->GetName();
+    XLS_RET_CHECK_LE(cycle, bounds.ub(node)) << node->GetName();
+    cycle_map[node] = cycle;
+  }
+  return cycle_map;
+}
+
+}  // namespace sched
+}  // namespace xls
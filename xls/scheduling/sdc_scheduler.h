@@ -0,0 +1,55 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_SCHEDULING_SDC_SCHEDULER_H_
+#define XLS_SCHEDULING_SDC_SCHEDULER_H_
+
+#include <cstdint>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "xls/delay_model/delay_estimator.h"
+#include "xls/ir/function_base.h"
+#include "xls/scheduling/schedule_bounds.h"
+
+namespace xls {
+namespace sched {
+
+// Schedules the given function into a pipeline of `pipeline_stages` stages
+// using an SDC (system of difference constraints) formulation. The schedule
+// minimizes the total width in bits of the pipeline registers, the same
+// objective the min-cut strategy optimizes one stage boundary at a time.
+//
+// The cycle of each node is a variable of a linear program whose constraints
+// are all of the form `x - y <= constant`: dependence constraints between a
+// node and its operands, clock-period constraints between nodes connected by
+// a combinational path longer than `clock_period_ps`, and the per-node
+// lower/upper bounds from `bounds` (which pin, e.g., parameters to the first
+// stage and the return value to the last). Such a program has an integral
+// optimum which is found exactly by solving its dual, a min-cost flow
+// problem. Unlike the min-cut strategy this considers all stage boundaries
+// simultaneously, so it typically finds schedules with fewer register bits
+// and it avoids the per-stage-order sweep entirely.
+//
+// The returned map contains the scheduled cycle of each node in `f`.
+absl::StatusOr<absl::flat_hash_map<Node*, int64_t>>
+SDCScheduleToMinimizeRegisters(FunctionBase* f, int64_t pipeline_stages,
+                               int64_t clock_period_ps,
+                               const DelayEstimator& delay_estimator,
+                               const ScheduleBounds& bounds);
+
+}  // namespace sched
+}  // namespace xls
+
+#endif  // XLS_SCHEDULING_SDC_SCHEDULER_H_
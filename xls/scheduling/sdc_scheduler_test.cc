@@ -0,0 +1,141 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/scheduling/sdc_scheduler.h"
+
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "xls/common/status/matchers.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/delay_model/delay_estimator.h"
+#include "xls/ir/function.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/node.h"
+#include "xls/ir/op.h"
+#include "xls/scheduling/schedule_bounds.h"
+
+namespace xls {
+namespace {
+
+class TestDelayEstimator : public DelayEstimator {
+ public:
+  absl::StatusOr<int64_t> GetOperationDelayInPs(Node* node) const override {
+    switch (node->op()) {
+      case Op::kBitSlice:
+      case Op::kConcat:
+      case Op::kLiteral:
+      case Op::kParam:
+      case Op::kSignExt:
+      case Op::kTupleIndex:
+        return 0;
+      default:
+        return 1;
+    }
+  }
+};
+
+class SdcSchedulerTest : public IrTestBase {
+ protected:
+  // Schedules `f` with bounds constructed the way PipelineSchedule::Run does:
+  // parameters in the first stage and the return value in the last.
+  absl::StatusOr<absl::flat_hash_map<Node*, int64_t>> Schedule(
+      Function* f, int64_t pipeline_stages, int64_t clock_period_ps) {
+    sched::ScheduleBounds bounds(f, clock_period_ps, delay_estimator_);
+    XLS_RETURN_IF_ERROR(bounds.PropagateLowerBounds());
+    XLS_RETURN_IF_ERROR(
+        bounds.TightenNodeLb(f->return_value(), pipeline_stages - 1));
+    XLS_RETURN_IF_ERROR(bounds.PropagateLowerBounds());
+    for (Node* node : f->nodes()) {
+      XLS_RETURN_IF_ERROR(bounds.TightenNodeUb(node, pipeline_stages - 1));
+    }
+    for (Param* param : f->params()) {
+      XLS_RETURN_IF_ERROR(bounds.TightenNodeUb(param, 0));
+    }
+    XLS_RETURN_IF_ERROR(bounds.PropagateUpperBounds());
+    return sched::SDCScheduleToMinimizeRegisters(
+        f, pipeline_stages, clock_period_ps, delay_estimator_, bounds);
+  }
+
+  TestDelayEstimator delay_estimator_;
+};
+
+TEST_F(SdcSchedulerTest, ScheduleRespectsDependenciesAndClockPeriod) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue value = fb.Param("x", p->GetBitsType(32));
+  for (int64_t i = 0; i < 6; ++i) {
+    value = fb.Not(value);
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  // Six unit-delay nodes with a 3ps clock require (exactly) two stages.
+  XLS_ASSERT_OK_AND_ASSIGN(auto cycle_map, Schedule(f, /*pipeline_stages=*/2,
+                                                    /*clock_period_ps=*/3));
+  for (Node* node : f->nodes()) {
+    for (Node* operand : node->operands()) {
+      EXPECT_LE(cycle_map.at(operand), cycle_map.at(node));
+    }
+  }
+  EXPECT_EQ(cycle_map.at(f->return_value()), 1);
+}
+
+TEST_F(SdcSchedulerTest, CutsAtNarrowPointOfGraph) {
+  // The 32-bit input is reduced to a single bit which feeds the rest of the
+  // pipeline; the cheapest stage boundary is after the reduction.
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(32));
+  BValue wide = fb.Not(x);
+  BValue narrow = fb.OrReduce(wide);
+  fb.Not(narrow);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto cycle_map, Schedule(f, /*pipeline_stages=*/2,
+                                                    /*clock_period_ps=*/10));
+  EXPECT_EQ(cycle_map.at(wide.node()), 0);
+  EXPECT_EQ(cycle_map.at(narrow.node()), 0);
+  EXPECT_EQ(cycle_map.at(f->return_value()), 1);
+}
+
+TEST_F(SdcSchedulerTest, DelaysWideningOperationUntilLastStage) {
+  // Sign-extending early would carry 32 bits across the stage boundary;
+  // the scheduler should carry the single-bit input instead.
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(1));
+  BValue bit = fb.Not(x);
+  BValue wide = fb.SignExtend(bit, 32);
+  fb.Not(wide);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto cycle_map, Schedule(f, /*pipeline_stages=*/2,
+                                                    /*clock_period_ps=*/10));
+  EXPECT_EQ(cycle_map.at(wide.node()), 1);
+  EXPECT_EQ(cycle_map.at(f->return_value()), 1);
+}
+
+TEST_F(SdcSchedulerTest, InfeasibleSchedule) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(32));
+  fb.Not(fb.Not(fb.Not(fb.Not(x))));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  // Four unit-delay nodes cannot fit in two 1ps stages.
+  EXPECT_FALSE(Schedule(f, /*pipeline_stages=*/2, /*clock_period_ps=*/1).ok());
+}
+
+}  // namespace
+}  // namespace xls
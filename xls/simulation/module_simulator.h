@@ -15,6 +15,8 @@
 #ifndef XLS_SIMULATION_MODULE_SIMULATOR_H_
 #define XLS_SIMULATION_MODULE_SIMULATOR_H_
 
+#include <memory>
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "xls/codegen/module_signature.h"
@@ -68,6 +70,12 @@ class ModuleSimulator {
   absl::StatusOr<Value> Run(absl::Span<const Value> inputs) const;
 
  private:
+  // Runs a single contiguous shard of a batch through one simulator
+  // invocation. RunBatched splits large batches into shards which are
+  // simulated concurrently (see --max_simulation_shards).
+  absl::StatusOr<std::vector<BitsMap>> RunBatchShard(
+      absl::Span<const BitsMap> inputs) const;
+
   // Deassert all control inputs on the module.
   absl::Status DeassertControlSignals(ModuleTestbench* tb) const;
 
@@ -16,6 +16,8 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/flags/flag.h"
+#include "absl/flags/reflection.h"
 #include "absl/status/statusor.h"
 #include "xls/codegen/module_signature.h"
 #include "xls/common/status/matchers.h"
@@ -23,6 +25,8 @@
 #include "xls/simulation/verilog_simulators.h"
 #include "xls/simulation/verilog_test_base.h"
 
+ABSL_DECLARE_FLAG(int64_t, max_simulation_shards);
+
 namespace xls {
 namespace verilog {
 namespace {
@@ -139,6 +143,27 @@ TEST_P(ModuleSimulatorTest, FixedLatencyBatched) {
   EXPECT_THAT(outputs[2], ElementsAre(Pair("out", UBits(14, 8))));
 }
 
+TEST_P(ModuleSimulatorTest, FixedLatencyBatchedSharded) {
+  // Same as FixedLatencyBatched but with the batch split across concurrent
+  // simulator invocations. Results must be merged in batch order.
+  absl::FlagSaver flag_saver;
+  absl::SetFlag(&FLAGS_max_simulation_shards, 2);
+
+  XLS_ASSERT_OK_AND_ASSIGN(auto verilog_signature, MakeFixedLatencyModule());
+  ModuleSimulator simulator(verilog_signature.second, verilog_signature.first,
+                            GetSimulator());
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::vector<ModuleSimulator::BitsMap> outputs,
+                           simulator.RunBatched({{{"x", UBits(44, 8)}},
+                                                 {{"x", UBits(123, 8)}},
+                                                 {{"x", UBits(7, 8)}}}));
+
+  EXPECT_EQ(outputs.size(), 3);
+  EXPECT_THAT(outputs[0], ElementsAre(Pair("out", UBits(88, 8))));
+  EXPECT_THAT(outputs[1], ElementsAre(Pair("out", UBits(246, 8))));
+  EXPECT_THAT(outputs[2], ElementsAre(Pair("out", UBits(14, 8))));
+}
+
 TEST_P(ModuleSimulatorTest, CombinationalBatched) {
   XLS_ASSERT_OK_AND_ASSIGN(auto verilog_signature, MakeCombinationalModule());
   ModuleSimulator simulator(verilog_signature.second, verilog_signature.first,
@@ -14,8 +14,13 @@
 
 #include "xls/simulation/module_testbench.h"
 
+#include <algorithm>
+
 #include "absl/strings/str_cat.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_file.h"
 #include "xls/common/logging/log_lines.h"
+#include "xls/common/math_util.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
@@ -40,6 +45,14 @@ std::string ToString(const xabsl::SourceLocation& loc) {
 // that the simulation logic does not terminate.
 static constexpr int64_t kSimulationCycleLimit = 10000;
 
+// Name of the plusarg via which session simulations receive the path of the
+// stimulus file holding Set() values (see GenerateSessionVerilog).
+static constexpr char kStimulusPlusarg[] = "xls_stimulus";
+
+// Name of the plusarg via which session simulations in binary capture mode
+// receive the path of the file to write captured values to.
+static constexpr char kCapturePlusarg[] = "xls_capture";
+
 std::string GetTimeoutMessage() {
   return absl::StrFormat("ERROR: timeout, simulation ran too long (%d cycles).",
                          kSimulationCycleLimit);
@@ -207,6 +220,11 @@ ModuleTestbench& ModuleTestbench::ExpectX(absl::string_view output_port,
   return *this;
 }
 
+ModuleTestbench& ModuleTestbench::UseBinaryCaptures() {
+  binary_captures_ = true;
+  return *this;
+}
+
 ModuleTestbench& ModuleTestbench::ExpectTrace(absl::string_view trace_message) {
   expected_traces_.push_back(std::string(trace_message));
   return *this;
@@ -273,21 +291,25 @@ absl::Status ModuleTestbench::CheckOutput(absl::string_view stdout_str) const {
   }
 
   // Write out module output port values to pointers passed in via Capture
-  // calls.
-  for (const auto& pair : captures_) {
-    auto cycle_port = pair.first;
-    Bits* value_ptr = pair.second;
-    if (!parsed_values.contains(cycle_port)) {
-      return absl::NotFoundError(absl::StrFormat(
-          "Output %s, instance #%d not found in Verilog simulator output.",
-          cycle_port.second, cycle_port.first));
-    }
-    if (absl::holds_alternative<IsX>(parsed_values.at(cycle_port))) {
-      return absl::NotFoundError(absl::StrFormat(
-          "Output %s, instance #%d holds X value in Verilog simulator output.",
-          cycle_port.second, cycle_port.first));
+  // calls. In binary capture mode these values arrive via the capture file
+  // and are handled by ParseBinaryCaptures instead.
+  if (!binary_captures_) {
+    for (const auto& pair : captures_) {
+      auto cycle_port = pair.first;
+      Bits* value_ptr = pair.second;
+      if (!parsed_values.contains(cycle_port)) {
+        return absl::NotFoundError(absl::StrFormat(
+            "Output %s, instance #%d not found in Verilog simulator output.",
+            cycle_port.second, cycle_port.first));
+      }
+      if (absl::holds_alternative<IsX>(parsed_values.at(cycle_port))) {
+        return absl::NotFoundError(absl::StrFormat(
+            "Output %s, instance #%d holds X value in Verilog simulator "
+            "output.",
+            cycle_port.second, cycle_port.first));
+      }
+      *value_ptr = absl::get<Bits>(parsed_values.at(cycle_port));
     }
-    *value_ptr = absl::get<Bits>(parsed_values.at(cycle_port));
   }
 
   // Check the module output port value against any expectations.
@@ -348,7 +370,8 @@ absl::Status ModuleTestbench::CheckOutput(absl::string_view stdout_str) const {
   return absl::OkStatus();
 }
 
-absl::Status ModuleTestbench::Run() {
+std::string ModuleTestbench::GenerateVerilog(bool use_stimulus_file,
+                                             absl::string_view capture_path) {
   VerilogFile file(/*use_system_verilog=*/false);
   Module* m = file.AddModule("testbench");
 
@@ -445,11 +468,90 @@ absl::Status ModuleTestbench::Run() {
     initial->statements()->Add<Monitor>(monitor_args);
   }
 
+  // When generating a session testbench the values driven by Set() actions
+  // live in a memory loaded with $readmemh from a file given by the
+  // +xls_stimulus plusarg rather than being compiled in as literals. Each
+  // memory element is as wide as the widest Set() input port; narrower ports
+  // are driven from a slice of their element.
+  LogicRef* stimulus = nullptr;
+  int64_t stimulus_width = 0;
+  if (use_stimulus_file) {
+    int64_t stimulus_count = 0;
+    for (const Action& action : actions_) {
+      if (absl::holds_alternative<SetInput>(action)) {
+        const SetInput& s = absl::get<SetInput>(action);
+        if (GetPortWidth(s.port) > 0) {
+          ++stimulus_count;
+          stimulus_width = std::max(stimulus_width, GetPortWidth(s.port));
+        }
+      }
+    }
+    if (stimulus_count > 0) {
+      stimulus = m->AddReg(
+          "__stimulus", file.UnpackedArrayType(stimulus_width,
+                                               /*dims=*/{stimulus_count}));
+      // Reg wide enough to hold the stimulus file path as a string.
+      LogicRef* stimulus_path =
+          m->AddReg("__stimulus_path", file.BitVectorType(8 * 256));
+      Initial* load = m->Add<Initial>();
+      Conditional* conditional = load->statements()->Add<Conditional>(
+          file.LogicalNot(file.Make<SystemFunctionCall>(
+              "value$plusargs",
+              std::vector<Expression*>{
+                  file.Make<QuotedString>(
+                      absl::StrCat(kStimulusPlusarg, "=%s")),
+                  stimulus_path})));
+      conditional->consequent()->Add<Display>(
+          std::vector<Expression*>{file.Make<QuotedString>(absl::StrCat(
+              "ERROR: missing +", kStimulusPlusarg, " plusarg."))});
+      conditional->consequent()->Add<Finish>();
+      load->statements()->Add<SystemTaskCall>(
+          "readmemh", std::vector<Expression*>{stimulus_path, stimulus});
+    }
+  }
+
+  // In binary capture mode Capture() values are written to a file as packed
+  // 32-bit words ($fstrobe "%u") rather than formatted as $strobe text. The
+  // file is opened at a literal path for one-shot runs, or at a path given
+  // by the +xls_capture plusarg for session testbenches.
+  LogicRef* capture_file_ref = nullptr;
+  if (binary_captures_ && !captures_.empty()) {
+    capture_file_ref = m->AddReg("__capture_file", file.BitVectorType(32));
+    Initial* open = m->Add<Initial>();
+    Expression* path_expr;
+    if (use_stimulus_file) {
+      // Reg wide enough to hold the capture file path as a string.
+      LogicRef* capture_path_reg =
+          m->AddReg("__capture_path", file.BitVectorType(8 * 256));
+      Conditional* conditional = open->statements()->Add<Conditional>(
+          file.LogicalNot(file.Make<SystemFunctionCall>(
+              "value$plusargs",
+              std::vector<Expression*>{
+                  file.Make<QuotedString>(
+                      absl::StrCat(kCapturePlusarg, "=%s")),
+                  capture_path_reg})));
+      conditional->consequent()->Add<Display>(
+          std::vector<Expression*>{file.Make<QuotedString>(absl::StrCat(
+              "ERROR: missing +", kCapturePlusarg, " plusarg."))});
+      conditional->consequent()->Add<Finish>();
+      path_expr = capture_path_reg;
+    } else {
+      XLS_CHECK(!capture_path.empty());
+      path_expr = file.Make<QuotedString>(capture_path);
+    }
+    open->statements()->Add<BlockingAssignment>(
+        capture_file_ref,
+        file.Make<SystemFunctionCall>(
+            "fopen", std::vector<Expression*>{
+                         path_expr, file.Make<QuotedString>("wb")}));
+  }
+
   Initial* initial = m->Add<Initial>();
   wait_n_cycles(initial->statements(), 1);
 
   // All actions occur at the falling edge of the clock to avoid races with
   // signals changing at the rising edge of the clock.
+  int64_t stimulus_index = 0;
   for (const Action& action : actions_) {
     absl::visit(
         Visitor{
@@ -457,9 +559,19 @@ absl::Status ModuleTestbench::Run() {
               wait_n_cycles(initial->statements(), a.amount);
             },
             [&](const SetInput& s) {
-              if (GetPortWidth(s.port) > 0) {
+              int64_t width = GetPortWidth(s.port);
+              if (width > 0) {
+                Expression* rhs;
+                if (use_stimulus_file) {
+                  Index* element = file.Index(stimulus, stimulus_index++);
+                  rhs = width == stimulus_width
+                            ? static_cast<Expression*>(element)
+                            : file.Slice(element, width - 1, 0);
+                } else {
+                  rhs = file.Literal(s.value);
+                }
                 initial->statements()->Add<NonblockingAssignment>(
-                    port_refs.at(s.port), file.Literal(s.value));
+                    port_refs.at(s.port), rhs);
               }
             },
             [&](const SetInputX& s) {
@@ -489,6 +601,17 @@ absl::Status ModuleTestbench::Run() {
               wait_n_cycles(whle->statements(), 1);
             },
             [&](const DisplayOutput& c) {
+              if (capture_file_ref != nullptr &&
+                  captures_.count({c.instance, c.port}) > 0) {
+                // $fstrobe has the same end-of-time-slot semantics as $strobe
+                // so the same race-avoidance reasoning applies.
+                initial->statements()->Add<SystemTaskCall>(
+                    "fstrobe",
+                    std::vector<Expression*>{capture_file_ref,
+                                             file.Make<QuotedString>("%u"),
+                                             port_refs.at(c.port)});
+                return;
+              }
               // Use $strobe rather than $display to print value after all
               // assignments in the simulator time slot and avoid any potential
               // race conditions.
@@ -505,11 +628,47 @@ absl::Status ModuleTestbench::Run() {
   // DisplayOutput runs before the final $finish.
   wait_n_cycles(initial->statements(), 1);
 
+  if (capture_file_ref != nullptr) {
+    initial->statements()->Add<SystemTaskCall>(
+        "fclose", std::vector<Expression*>{capture_file_ref});
+  }
+
   initial->statements()->Add<Finish>();
 
   // Concatentate the module Verilog with the testbench verilog to create the
   // verilog text to pass to the simulator.
-  std::string verilog_text = absl::StrCat(verilog_text_, "\n\n", file.Emit());
+  return absl::StrCat(verilog_text_, "\n\n", file.Emit());
+}
+
+std::string ModuleTestbench::GenerateSessionVerilog() {
+  return GenerateVerilog(/*use_stimulus_file=*/true, /*capture_path=*/"");
+}
+
+std::string ModuleTestbench::GenerateStimulusContents() {
+  std::string contents;
+  for (const Action& action : actions_) {
+    if (absl::holds_alternative<SetInput>(action)) {
+      const SetInput& s = absl::get<SetInput>(action);
+      if (GetPortWidth(s.port) > 0) {
+        absl::StrAppend(
+            &contents,
+            s.value.ToRawDigits(FormatPreference::kPlainHex,
+                                /*emit_leading_zeros=*/true),
+            "\n");
+      }
+    }
+  }
+  return contents;
+}
+
+absl::Status ModuleTestbench::Run() {
+  absl::optional<TempFile> capture_file;
+  if (binary_captures_ && !captures_.empty()) {
+    XLS_ASSIGN_OR_RETURN(capture_file, TempFile::Create());
+  }
+  std::string verilog_text = GenerateVerilog(
+      /*use_stimulus_file=*/false,
+      capture_file.has_value() ? capture_file->path().string() : "");
   XLS_VLOG(2) << verilog_text;
 
   std::pair<std::string, std::string> stdout_stderr;
@@ -519,10 +678,79 @@ absl::Status ModuleTestbench::Run() {
   XLS_VLOG(2) << "Verilog simulator stderr:\n" << stdout_stderr.second;
 
   const std::string& stdout_str = stdout_stderr.first;
-  return CheckOutput(stdout_str);
+  XLS_RETURN_IF_ERROR(CheckOutput(stdout_str));
+  if (capture_file.has_value()) {
+    XLS_ASSIGN_OR_RETURN(std::string capture_data,
+                         GetFileContents(capture_file->path()));
+    XLS_RETURN_IF_ERROR(ParseBinaryCaptures(capture_data));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ModuleTestbench::RunSession(
+    const VerilogSimulator::Session& session) {
+  XLS_ASSIGN_OR_RETURN(
+      TempFile stimulus_file,
+      TempFile::CreateWithContent(GenerateStimulusContents()));
+  std::vector<std::string> plusargs = {absl::StrCat(
+      "+", kStimulusPlusarg, "=", stimulus_file.path().string())};
+  absl::optional<TempFile> capture_file;
+  if (binary_captures_ && !captures_.empty()) {
+    XLS_ASSIGN_OR_RETURN(capture_file, TempFile::Create());
+    plusargs.push_back(absl::StrCat("+", kCapturePlusarg, "=",
+                                    capture_file->path().string()));
+  }
+
+  std::pair<std::string, std::string> stdout_stderr;
+  XLS_ASSIGN_OR_RETURN(stdout_stderr, session.Run(plusargs));
+
+  XLS_VLOG(2) << "Verilog simulator stdout:\n" << stdout_stderr.first;
+  XLS_VLOG(2) << "Verilog simulator stderr:\n" << stdout_stderr.second;
+
+  const std::string& stdout_str = stdout_stderr.first;
+  XLS_RETURN_IF_ERROR(CheckOutput(stdout_str));
+  if (capture_file.has_value()) {
+    XLS_ASSIGN_OR_RETURN(std::string capture_data,
+                         GetFileContents(capture_file->path()));
+    XLS_RETURN_IF_ERROR(ParseBinaryCaptures(capture_data));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ModuleTestbench::ParseBinaryCaptures(
+    absl::string_view data) const {
+  // $fstrobe "%u" emits each captured value as ceil(width / 32) 32-bit words,
+  // least-significant word first, in the simulator's native (little-endian)
+  // byte order. Records appear in capture instance order, matching the
+  // iteration order of captures_.
+  int64_t offset = 0;
+  for (const auto& pair : captures_) {
+    const std::string& port = pair.first.second;
+    Bits* value_ptr = pair.second;
+    const int64_t width = GetPortWidth(port);
+    const int64_t num_bytes = 4 * CeilOfRatio(width, int64_t{32});
+    if (offset + num_bytes > static_cast<int64_t>(data.size())) {
+      return absl::NotFoundError(absl::StrFormat(
+          "Output %s, instance #%d not found in binary capture file.", port,
+          pair.first.first));
+    }
+    // Reverse the little-endian record as Bits::FromBytes expects the most
+    // significant byte first.
+    std::vector<uint8_t> big_endian_bytes(num_bytes);
+    for (int64_t i = 0; i < num_bytes; ++i) {
+      big_endian_bytes[i] =
+          static_cast<uint8_t>(data[offset + num_bytes - 1 - i]);
+    }
+    offset += num_bytes;
+    *value_ptr =
+        Bits::FromBytes(big_endian_bytes, num_bytes * 8).Slice(0, width);
+  }
+  XLS_RET_CHECK_EQ(offset, static_cast<int64_t>(data.size()))
+      << "Binary capture file holds more data than expected.";
+  return absl::OkStatus();
 }
 
-int64_t ModuleTestbench::GetPortWidth(absl::string_view port) {
+int64_t ModuleTestbench::GetPortWidth(absl::string_view port) const {
   if (input_port_widths_.contains(port)) {
     return input_port_widths_.at(port);
   } else {
@@ -97,6 +97,15 @@ class ModuleTestbench {
       absl::string_view output_port,
       xabsl::SourceLocation loc = xabsl::SourceLocation::current());
 
+  // Enables binary capture mode: values captured with Capture() are written
+  // by the simulation to a file as packed little-endian 32-bit words
+  // ($fstrobe "%u") and parsed directly into Bits on the host side, rather
+  // than being formatted as hex text and scraped from stdout. Substantially
+  // faster for wide output ports. Expectations and traces still use the text
+  // path. Caveat: any X bits in a captured value are silently written as
+  // zero rather than raising an error as in text mode.
+  ModuleTestbench& UseBinaryCaptures();
+
   // Expect to find a particular string in the simulation output,
   // typically generated by a trace in the dut.
   // Trace strings must be found in the order of the ExpectTrace calls.
@@ -108,12 +117,46 @@ class ModuleTestbench {
   // Runs the simulation.
   absl::Status Run();
 
+  // Returns the testbench Verilog in a form where values passed to Set() are
+  // read from a stimulus file at simulation time rather than compiled in as
+  // literals. The stimulus file is passed to the simulation via the
+  // +xls_stimulus plusarg. Used together with RunSession() to run many
+  // testbenches of identical structure against a single compiled simulation.
+  std::string GenerateSessionVerilog();
+
+  // Runs the simulation using a session compiled (via
+  // VerilogSimulator::StartSession) from the GenerateSessionVerilog() text of
+  // a structurally identical testbench: same module, ports, and sequence of
+  // actions; only the values passed to Set() may differ. The Set() values of
+  // this testbench are streamed to the compiled simulation through a
+  // temporary stimulus file.
+  absl::Status RunSession(const VerilogSimulator::Session& session);
+
  private:
+  // Generates the testbench Verilog text (module-under-test text plus the
+  // generated testbench module). If use_stimulus_file is true then values
+  // passed to Set() are read at simulation time from a $readmemh-loaded
+  // memory rather than emitted as literals. In binary capture mode
+  // capture_path is the file the simulation writes capture values to; for
+  // session testbenches the path comes from the +xls_capture plusarg instead
+  // and capture_path must be empty.
+  std::string GenerateVerilog(bool use_stimulus_file,
+                              absl::string_view capture_path);
+
+  // Returns the contents of the stimulus file read by a session simulation:
+  // one hex entry per (non-zero-width) Set() call, in action order.
+  std::string GenerateStimulusContents();
+
   // Checks the stdout of a simulation run against expectations.
   absl::Status CheckOutput(absl::string_view stdout_str) const;
 
+  // Parses the contents of the binary capture file written by the simulation
+  // in binary capture mode and writes the values to the pointers passed in
+  // via Capture calls.
+  absl::Status ParseBinaryCaptures(absl::string_view data) const;
+
   // Returns the width of the given port.
-  int64_t GetPortWidth(absl::string_view port);
+  int64_t GetPortWidth(absl::string_view port) const;
 
   // CHECKs whether the given name is an input/output port.
   void CheckIsInput(absl::string_view name);
@@ -195,6 +238,10 @@ class ModuleTestbench {
   int64_t next_instance_ = 0;
 
   std::vector<std::string> expected_traces_;
+
+  // Whether Capture() values are exchanged in binary rather than as $strobe
+  // text (see UseBinaryCaptures()).
+  bool binary_captures_ = false;
 };
 
 }  // namespace verilog
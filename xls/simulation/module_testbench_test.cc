@@ -14,6 +14,9 @@
 
 #include "xls/simulation/module_testbench.h"
 
+#include <memory>
+
+#include "absl/status/statusor.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "xls/codegen/vast.h"
@@ -76,6 +79,67 @@ TEST_P(ModuleTestbenchTest, TwoStagePipeline) {
   XLS_ASSERT_OK(tb.Run());
 }
 
+TEST_P(ModuleTestbenchTest, TwoStagePipelineSession) {
+  VerilogFile f(UseSystemVerilog());
+  Module* m = MakeTwoStageIdentityPipeline(&f);
+
+  auto build_tb = [&](uint64_t first, uint64_t second) {
+    auto tb = std::make_unique<ModuleTestbench>(m, GetSimulator(), "clk");
+    tb->Set("in", first).ExpectX("out");
+    tb->NextCycle().Set("in", second).ExpectX("out");
+    tb->NextCycle().ExpectEq("out", first).SetX("in");
+    tb->NextCycle().ExpectEq("out", second);
+    return tb;
+  };
+
+  std::unique_ptr<ModuleTestbench> tb = build_tb(0xabcd, 0x1122);
+  absl::StatusOr<std::unique_ptr<VerilogSimulator::Session>> session =
+      GetSimulator()->StartSession(tb->GenerateSessionVerilog());
+  if (!session.ok()) {
+    // Not all simulators support sessions.
+    ASSERT_THAT(session.status(), StatusIs(absl::StatusCode::kUnimplemented));
+    return;
+  }
+  XLS_ASSERT_OK(tb->RunSession(*session.value()));
+
+  // A structurally identical testbench with different input values can reuse
+  // the compiled session.
+  XLS_ASSERT_OK(build_tb(0x1234, 0x4321)->RunSession(*session.value()));
+}
+
+TEST_P(ModuleTestbenchTest, CachedSessionIsSharedForIdenticalHarness) {
+  VerilogFile f(UseSystemVerilog());
+  Module* m = MakeTwoStageIdentityPipeline(&f);
+
+  auto build_tb = [&](uint64_t first, uint64_t second) {
+    auto tb = std::make_unique<ModuleTestbench>(m, GetSimulator(), "clk");
+    tb->Set("in", first).ExpectX("out");
+    tb->NextCycle().Set("in", second).ExpectX("out");
+    tb->NextCycle().ExpectEq("out", first).SetX("in");
+    tb->NextCycle().ExpectEq("out", second);
+    return tb;
+  };
+
+  // Structurally identical testbenches generate identical harness text, so
+  // the simulator-level cache hands back the same compiled session.
+  std::unique_ptr<ModuleTestbench> tb0 = build_tb(0xabcd, 0x1122);
+  std::unique_ptr<ModuleTestbench> tb1 = build_tb(0x1234, 0x4321);
+  absl::StatusOr<std::shared_ptr<VerilogSimulator::Session>> session0 =
+      GetSimulator()->GetOrStartCachedSession(tb0->GenerateSessionVerilog());
+  if (!session0.ok()) {
+    // Not all simulators support sessions.
+    ASSERT_THAT(session0.status(), StatusIs(absl::StatusCode::kUnimplemented));
+    return;
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<VerilogSimulator::Session> session1,
+      GetSimulator()->GetOrStartCachedSession(tb1->GenerateSessionVerilog()));
+  EXPECT_EQ(session0.value().get(), session1.get());
+
+  XLS_ASSERT_OK(tb0->RunSession(*session0.value()));
+  XLS_ASSERT_OK(tb1->RunSession(*session1));
+}
+
 TEST_P(ModuleTestbenchTest, WaitForXAndNotX) {
   VerilogFile f(UseSystemVerilog());
   Module* m = MakeTwoStageIdentityPipeline(&f);
@@ -185,6 +249,27 @@ TEST_P(ModuleTestbenchTest, MultipleOutputsWithCapture) {
   EXPECT_EQ(out1_captured, UBits(134, 8));
 }
 
+TEST_P(ModuleTestbenchTest, BinaryCaptures) {
+  // Use a port wider than one 32-bit capture word to exercise the multi-word
+  // binary encoding.
+  VerilogFile f(UseSystemVerilog());
+  Module* m = MakeTwoStageIdentityPipeline(&f, /*width=*/64);
+
+  Bits out0;
+  Bits out1;
+  ModuleTestbench tb(m, GetSimulator(), "clk");
+  tb.UseBinaryCaptures();
+  tb.Set("in", UBits(0x123456789abcdef0ULL, 64));
+  tb.NextCycle().Set("in", UBits(0xffff0000ffff0000ULL, 64));
+  tb.NextCycle().Capture("out", &out0).SetX("in");
+  tb.NextCycle().Capture("out", &out1);
+
+  XLS_ASSERT_OK(tb.Run());
+
+  EXPECT_EQ(out0, UBits(0x123456789abcdef0ULL, 64));
+  EXPECT_EQ(out1, UBits(0xffff0000ffff0000ULL, 64));
+}
+
 TEST_P(ModuleTestbenchTest, TestTimeout) {
   VerilogFile f(UseSystemVerilog());
   Module* m = f.AddModule("test_module");
@@ -56,6 +56,24 @@ absl::StatusOr<std::pair<std::string, std::string>> InvokeVvp(
   return InvokeSubprocess(args_vec);
 }
 
+// A compiled vvp program which can be run repeatedly with different plusargs
+// without reinvoking the compiler.
+class IcarusSession : public VerilogSimulator::Session {
+ public:
+  explicit IcarusSession(TempFile compiled) : compiled_(std::move(compiled)) {}
+
+  absl::StatusOr<std::pair<std::string, std::string>> Run(
+      absl::Span<const std::string> plusargs) const override {
+    std::vector<std::string> args;
+    args.push_back(compiled_.path().string());
+    args.insert(args.end(), plusargs.begin(), plusargs.end());
+    return InvokeVvp(args);
+  }
+
+ private:
+  TempFile compiled_;
+};
+
 class IcarusVerilogSimulator : public VerilogSimulator {
  public:
   absl::StatusOr<std::pair<std::string, std::string>> Run(
@@ -70,6 +88,17 @@ class IcarusVerilogSimulator : public VerilogSimulator {
     return InvokeVvp({temp_out.path().string()});
   }
 
+  absl::StatusOr<std::unique_ptr<Session>> StartSession(
+      absl::string_view text,
+      absl::Span<const VerilogInclude> includes) const override {
+    XLS_ASSIGN_OR_RETURN(TempFile temp, TempFile::CreateWithContent(text));
+    XLS_ASSIGN_OR_RETURN(TempFile temp_out, TempFile::Create());
+    XLS_RETURN_IF_ERROR(
+        InvokeIverilog({temp.path().string(), "-o", temp_out.path().string()})
+            .status());
+    return std::make_unique<IcarusSession>(std::move(temp_out));
+  }
+
   absl::Status RunSyntaxChecking(
       absl::string_view text,
       absl::Span<const VerilogInclude> includes) const override {
@@ -94,6 +94,52 @@ absl::Status VerilogSimulator::RunSyntaxChecking(absl::string_view text) const {
   return RunSyntaxChecking(text, /*includes=*/{});
 }
 
+absl::StatusOr<std::unique_ptr<VerilogSimulator::Session>>
+VerilogSimulator::StartSession(absl::string_view text,
+                               absl::Span<const VerilogInclude> includes) const {
+  return absl::UnimplementedError(
+      "This Verilog simulator does not support sessions.");
+}
+
+absl::StatusOr<std::unique_ptr<VerilogSimulator::Session>>
+VerilogSimulator::StartSession(absl::string_view text) const {
+  return StartSession(text, /*includes=*/{});
+}
+
+absl::StatusOr<std::shared_ptr<VerilogSimulator::Session>>
+VerilogSimulator::GetOrStartCachedSession(
+    absl::string_view text, absl::Span<const VerilogInclude> includes) const {
+  // Key on the exact compiler input: the testbench text plus the path and
+  // contents of every include.
+  std::string key(text);
+  for (const VerilogInclude& include : includes) {
+    absl::StrAppend(&key, "\n`include:", include.relative_path.string(), "\n",
+                    include.verilog_text);
+  }
+  {
+    absl::MutexLock lock(&session_cache_mutex_);
+    auto it = session_cache_.find(key);
+    if (it != session_cache_.end()) {
+      return it->second;
+    }
+  }
+  // Compile outside the lock so concurrent cache misses on different
+  // testbenches do not serialize on the compiler. A racing miss on the same
+  // key compiles twice; the first insertion wins and both callers get a
+  // working session.
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Session> session,
+                       StartSession(text, includes));
+  absl::MutexLock lock(&session_cache_mutex_);
+  auto [it, inserted] = session_cache_.emplace(std::move(key),
+                                               std::move(session));
+  return it->second;
+}
+
+absl::StatusOr<std::shared_ptr<VerilogSimulator::Session>>
+VerilogSimulator::GetOrStartCachedSession(absl::string_view text) const {
+  return GetOrStartCachedSession(text, /*includes=*/{});
+}
+
 absl::StatusOr<std::vector<Observation>>
 VerilogSimulator::SimulateCombinational(
     absl::string_view text, const NameToBitCount& to_observe) const {
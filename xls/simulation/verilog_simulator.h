@@ -15,12 +15,14 @@
 #ifndef XLS_SIMULATION_VERILOG_SIMULATOR_H_
 #define XLS_SIMULATION_VERILOG_SIMULATOR_H_
 
+#include <memory>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xls/codegen/name_to_bit_count.h"
 #include "xls/ir/bits.h"
@@ -38,6 +40,22 @@ struct Observation {
 // Interface wrapping a Verilog simulator such Icarus verilog.
 class VerilogSimulator {
  public:
+  // A compiled simulation which may be run multiple times without recompiling
+  // the Verilog text. Each Run invocation launches the compiled simulation
+  // with the given plusargs (e.g., "+foo=bar") so run-to-run variation in
+  // stimulus can be passed in without recompilation. Sessions are created
+  // with VerilogSimulator::StartSession and remain valid only as long as the
+  // simulator which created them.
+  class Session {
+   public:
+    virtual ~Session() = default;
+
+    // Runs the compiled simulation with the given plusargs and returns the
+    // stdout/stderr as a string pair.
+    virtual absl::StatusOr<std::pair<std::string, std::string>> Run(
+        absl::Span<const std::string> plusargs) const = 0;
+  };
+
   virtual ~VerilogSimulator() = default;
 
   // Runs the simulator with the given Verilog text as input and returns the
@@ -48,6 +66,28 @@ class VerilogSimulator {
   absl::StatusOr<std::pair<std::string, std::string>> Run(
       absl::string_view text) const;
 
+  // Compiles the given Verilog text once and returns a Session which can be
+  // run repeatedly with different plusargs. Returns an UnimplementedError for
+  // simulators which do not support sessions; callers should fall back to
+  // Run in that case.
+  virtual absl::StatusOr<std::unique_ptr<Session>> StartSession(
+      absl::string_view text, absl::Span<const VerilogInclude> includes) const;
+  absl::StatusOr<std::unique_ptr<Session>> StartSession(
+      absl::string_view text) const;
+
+  // Like StartSession, but reuses the previously compiled session when this
+  // simulator has already compiled identical text and includes. Simulators
+  // are registered as process-wide singletons, so the cache spares every
+  // testbench whose generated harness matches an earlier one (e.g. repeated
+  // batch simulations of the same DUT across tests) a compiler invocation.
+  // The returned session is shared; Session::Run is const and safe to invoke
+  // concurrently. Returns an UnimplementedError for simulators which do not
+  // support sessions.
+  absl::StatusOr<std::shared_ptr<Session>> GetOrStartCachedSession(
+      absl::string_view text, absl::Span<const VerilogInclude> includes) const;
+  absl::StatusOr<std::shared_ptr<Session>> GetOrStartCachedSession(
+      absl::string_view text) const;
+
   // Runs the simulator to check the Verilog syntax. Does not run simulation.
   virtual absl::Status RunSyntaxChecking(
       absl::string_view text,
@@ -67,6 +107,13 @@ class VerilogSimulator {
   // above.
   absl::StatusOr<std::vector<Observation>> SimulateCombinational(
       absl::string_view text, const NameToBitCount& to_observe) const;
+
+ private:
+  // Compiled sessions keyed by the exact Verilog text and include contents
+  // they were compiled from. See GetOrStartCachedSession().
+  mutable absl::Mutex session_cache_mutex_;
+  mutable absl::flat_hash_map<std::string, std::shared_ptr<Session>>
+      session_cache_ ABSL_GUARDED_BY(session_cache_mutex_);
 };
 
 // An abstraction which holds multiple VerilogSimulator objects organized by
@@ -0,0 +1,246 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/solvers/smtlib_solver_pool.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/common/strerror.h"
+
+namespace xls {
+namespace solvers {
+namespace {
+
+// Marker echoed after each query so the reader knows when the solver
+// has responded to everything sent so far.
+constexpr const char kQueryMarker[] = "xls-query-done";
+
+// Opens a Unix pipe; first element is the read end, second the write
+// end.  Both ends are close-on-exec; ends given to the child are dup2'd
+// over stdin/stdout after the fork.
+absl::StatusOr<std::pair<FileDescriptor, FileDescriptor>> OpenPipe() {
+  int descriptors[2];
+  if (pipe2(descriptors, O_CLOEXEC) == -1) {
+    return absl::InternalError(
+        absl::StrCat("Failed to pipe: ", Strerror(errno)));
+  }
+  return std::make_pair(FileDescriptor(descriptors[0]),
+                        FileDescriptor(descriptors[1]));
+}
+
+// Writes all of data to fd, retrying on EINTR.
+absl::Status WriteAll(int fd, absl::string_view data) {
+  while (!data.empty()) {
+    ssize_t written = write(fd, data.data(), data.size());
+    if (written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return absl::InternalError(
+          absl::StrCat("Failed to write to solver: ", Strerror(errno)));
+    }
+    data.remove_prefix(written);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<SmtlibSolverSession>> SmtlibSolverSession::Start(
+    absl::Span<const std::string> argv) {
+  XLS_RET_CHECK(!argv.empty()) << "Cannot start solver with empty argv list.";
+
+  std::vector<const char*> argv_pointers;
+  argv_pointers.reserve(argv.size() + 1);
+  for (const std::string& arg : argv) {
+    argv_pointers.push_back(arg.c_str());
+  }
+  argv_pointers.push_back(nullptr);
+
+  // to_solver: parent writes entrance, child reads exit (stdin).
+  // from_solver: child writes entrance (stdout), parent reads exit.
+  XLS_ASSIGN_OR_RETURN(auto to_solver_pipe, OpenPipe());
+  XLS_ASSIGN_OR_RETURN(auto from_solver_pipe, OpenPipe());
+
+  pid_t pid = fork();
+  if (pid == -1) {
+    return absl::InternalError(
+        absl::StrCat("Failed to fork: ", Strerror(errno)));
+  }
+  if (pid == 0) {
+    while ((dup2(to_solver_pipe.first.get(), STDIN_FILENO) == -1) &&
+           (errno == EINTR)) {
+    }
+    while ((dup2(from_solver_pipe.second.get(), STDOUT_FILENO) == -1) &&
+           (errno == EINTR)) {
+    }
+    execvp(argv_pointers[0], const_cast<char* const*>(argv_pointers.data()));
+    XLS_LOG(ERROR) << "Execvp syscall failed: " << Strerror(errno);
+    _exit(127);
+  }
+
+  auto session = absl::WrapUnique(new SmtlibSolverSession());
+  session->pid_ = pid;
+  session->to_solver_ = std::move(to_solver_pipe.second);
+  session->from_solver_ = std::move(from_solver_pipe.first);
+  return session;
+}
+
+SmtlibSolverSession::~SmtlibSolverSession() {
+  if (pid_ == -1) {
+    return;
+  }
+
+  // Ask the solver to exit; fall back to SIGKILL if it does not.
+  Send("(exit)").IgnoreError();
+  to_solver_.Close();
+
+  int wait_status;
+  pid_t waited = waitpid(pid_, &wait_status, WNOHANG);
+  if (waited == 0) {
+    kill(pid_, SIGKILL);
+    while (waitpid(pid_, &wait_status, 0) == -1 && errno == EINTR) {
+    }
+  }
+}
+
+absl::Status SmtlibSolverSession::Send(absl::string_view smtlib) {
+  XLS_RETURN_IF_ERROR(WriteAll(to_solver_.get(), smtlib));
+  return WriteAll(to_solver_.get(), "\n");
+}
+
+absl::StatusOr<std::vector<std::string>> SmtlibSolverSession::ReadUntilMarker(
+    absl::string_view marker) {
+  std::vector<std::string> lines;
+  char buffer[4096];
+
+  for (;;) {
+    // Consume complete lines already buffered.
+    size_t newline;
+    while ((newline = read_buffer_.find('\n')) != std::string::npos) {
+      std::string line = read_buffer_.substr(0, newline);
+      read_buffer_.erase(0, newline + 1);
+      if (absl::StripAsciiWhitespace(line) == marker) {
+        return lines;
+      }
+      lines.push_back(std::move(line));
+    }
+
+    ssize_t bytes = read(from_solver_.get(), buffer, sizeof(buffer));
+    if (bytes == 0) {
+      return absl::InternalError(
+          "Solver process closed its output before responding; "
+          "it may have crashed or rejected a command.");
+    }
+    if (bytes == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return absl::InternalError(
+          absl::StrCat("Failed to read from solver: ", Strerror(errno)));
+    }
+    read_buffer_.append(buffer, bytes);
+  }
+}
+
+absl::StatusOr<SmtSolverResult> SmtlibSolverSession::RunQuery(
+    absl::string_view smtlib) {
+  XLS_RETURN_IF_ERROR(Push());
+  XLS_RETURN_IF_ERROR(Send(smtlib));
+  XLS_RETURN_IF_ERROR(Send("(check-sat)"));
+  XLS_RETURN_IF_ERROR(Send(absl::StrCat("(echo \"", kQueryMarker, "\")")));
+
+  XLS_ASSIGN_OR_RETURN(std::vector<std::string> lines,
+                       ReadUntilMarker(kQueryMarker));
+  XLS_RETURN_IF_ERROR(Pop());
+
+  // The (check-sat) verdict is the last sat/unsat/unknown token before
+  // the marker; earlier lines may be solver chatter for other commands.
+  for (auto it = lines.rbegin(); it != lines.rend(); ++it) {
+    absl::string_view line = absl::StripAsciiWhitespace(*it);
+    if (line == "sat") {
+      return SmtSolverResult::kSat;
+    }
+    if (line == "unsat") {
+      return SmtSolverResult::kUnsat;
+    }
+    if (line == "unknown") {
+      return SmtSolverResult::kUnknown;
+    }
+  }
+
+  return absl::InternalError(absl::StrCat(
+      "Solver did not produce a (check-sat) verdict; output was: \"",
+      absl::StrJoin(lines, "\n"), "\""));
+}
+
+absl::StatusOr<std::unique_ptr<SmtlibSolverPool>> SmtlibSolverPool::Create(
+    absl::Span<const std::string> argv, int64_t size,
+    absl::string_view preamble) {
+  XLS_RET_CHECK_GT(size, 0);
+
+  auto pool = absl::WrapUnique(new SmtlibSolverPool());
+  for (int64_t i = 0; i < size; ++i) {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<SmtlibSolverSession> session,
+                         SmtlibSolverSession::Start(argv));
+    if (!preamble.empty()) {
+      XLS_RETURN_IF_ERROR(session->Send(preamble));
+    }
+    pool->idle_sessions_.push_back(std::move(session));
+  }
+  return pool;
+}
+
+std::unique_ptr<SmtlibSolverSession> SmtlibSolverPool::Acquire() {
+  absl::MutexLock lock(&mutex_);
+  mutex_.Await(absl::Condition(
+      +[](std::vector<std::unique_ptr<SmtlibSolverSession>>* idle) {
+        return !idle->empty();
+      },
+      &idle_sessions_));
+  std::unique_ptr<SmtlibSolverSession> session =
+      std::move(idle_sessions_.back());
+  idle_sessions_.pop_back();
+  return session;
+}
+
+void SmtlibSolverPool::Release(std::unique_ptr<SmtlibSolverSession> session) {
+  absl::MutexLock lock(&mutex_);
+  idle_sessions_.push_back(std::move(session));
+}
+
+absl::StatusOr<SmtSolverResult> SmtlibSolverPool::RunQuery(
+    absl::string_view smtlib) {
+  std::unique_ptr<SmtlibSolverSession> session = Acquire();
+  absl::StatusOr<SmtSolverResult> result = session->RunQuery(smtlib);
+  Release(std::move(session));
+  return result;
+}
+
+}  // namespace solvers
+}  // namespace xls
@@ -0,0 +1,125 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_SOLVERS_SMTLIB_SOLVER_POOL_H_
+#define XLS_SOLVERS_SMTLIB_SOLVER_POOL_H_
+
+#include <sys/types.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "xls/common/file/file_descriptor.h"
+
+// Long-lived sessions to external SMTLIB2 solvers, and a pool that keeps
+// several solver processes warm and multiplexes independent queries
+// across them.
+//
+// Spawning a fresh solver process per query dominates runtime when many
+// small, near-identical queries are issued (e.g. bit-width sweeps).  A
+// session instead keeps the solver process alive, shares a common
+// preamble (declarations and assertions) across queries, and scopes each
+// query with (push)/(pop) so only the query-specific assertions are
+// re-sent and re-solved.
+
+namespace xls {
+namespace solvers {
+
+// Result of a (check-sat) query.
+enum class SmtSolverResult {
+  kSat,
+  kUnsat,
+  kUnknown,
+};
+
+// A single warm solver process speaking SMTLIB2 on stdin/stdout.
+//
+// Not thread-safe; SmtlibSolverPool serializes access to each session.
+class SmtlibSolverSession {
+ public:
+  // Starts the solver process given by argv.  The solver must read
+  // SMTLIB2 from stdin and write responses to stdout (e.g. "z3 -in" or
+  // "cvc4 --incremental --lang smt2").
+  static absl::StatusOr<std::unique_ptr<SmtlibSolverSession>> Start(
+      absl::Span<const std::string> argv);
+
+  ~SmtlibSolverSession();
+
+  // Sends raw SMTLIB2 text to the solver.  No response is expected;
+  // commands which produce output should go through RunQuery().
+  absl::Status Send(absl::string_view smtlib);
+
+  // Enters / leaves an assertion scope.
+  absl::Status Push() { return Send("(push 1)"); }
+  absl::Status Pop() { return Send("(pop 1)"); }
+
+  // Runs a query in its own assertion scope: pushes, sends the given
+  // SMTLIB2 text, issues (check-sat), and pops.  Returns the solver's
+  // verdict.  The session's accumulated preamble stays in effect.
+  absl::StatusOr<SmtSolverResult> RunQuery(absl::string_view smtlib);
+
+ private:
+  SmtlibSolverSession() = default;
+
+  // Reads solver output until the given marker line is seen; returns
+  // the lines read (marker excluded).
+  absl::StatusOr<std::vector<std::string>> ReadUntilMarker(
+      absl::string_view marker);
+
+  pid_t pid_ = -1;
+  FileDescriptor to_solver_;
+  FileDescriptor from_solver_;
+  std::string read_buffer_;
+};
+
+// A fixed-size pool of warm solver sessions.
+//
+// Queries are dispatched to any idle session, blocking when all
+// sessions are busy, so independent queries issued from multiple
+// threads run on up to `size` solver processes concurrently.
+class SmtlibSolverPool {
+ public:
+  // Starts `size` solver processes from argv and sends each the given
+  // preamble (shared declarations/assertions emitted once per process
+  // rather than once per query).
+  static absl::StatusOr<std::unique_ptr<SmtlibSolverPool>> Create(
+      absl::Span<const std::string> argv, int64_t size,
+      absl::string_view preamble = "");
+
+  // Runs a query (see SmtlibSolverSession::RunQuery) on an idle
+  // session, blocking until one is available.  Thread-safe.
+  absl::StatusOr<SmtSolverResult> RunQuery(absl::string_view smtlib);
+
+ private:
+  SmtlibSolverPool() = default;
+
+  // Returns an idle session, blocking until one is available.
+  std::unique_ptr<SmtlibSolverSession> Acquire();
+  void Release(std::unique_ptr<SmtlibSolverSession> session);
+
+  absl::Mutex mutex_;
+  std::vector<std::unique_ptr<SmtlibSolverSession>> idle_sessions_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace solvers
+}  // namespace xls
+
+#endif  // XLS_SOLVERS_SMTLIB_SOLVER_POOL_H_
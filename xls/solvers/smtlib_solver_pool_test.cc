@@ -0,0 +1,98 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/solvers/smtlib_solver_pool.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/status/matchers.h"
+
+namespace xls {
+namespace solvers {
+namespace {
+
+// A /bin/sh stand-in for an incremental SMTLIB solver: answers
+// (check-sat) with "unsat" inside a scope that asserted false and "sat"
+// otherwise, and echoes (echo "...") strings like a real solver.
+const char kFakeSolverScript[] = R"(
+result=sat
+while IFS= read -r line; do
+  case "$line" in
+    "(assert false)") result=unsat ;;
+    "(pop 1)") result=sat ;;
+    "(check-sat)") echo "$result" ;;
+    "(exit)") exit 0 ;;
+    "(echo "*) s="${line#(echo \"}"; echo "${s%\")}" ;;
+  esac
+done
+)";
+
+std::vector<std::string> FakeSolverArgv() {
+  return {"/bin/sh", "-c", kFakeSolverScript};
+}
+
+TEST(SmtlibSolverPoolTest, SessionAnswersQueries) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<SmtlibSolverSession> session,
+                           SmtlibSolverSession::Start(FakeSolverArgv()));
+
+  XLS_ASSERT_OK_AND_ASSIGN(SmtSolverResult result,
+                           session->RunQuery("(assert true)"));
+  EXPECT_EQ(result, SmtSolverResult::kSat);
+
+  // The unsat assertion is scoped to its query by push/pop, so a
+  // following query on the same warm process is unaffected.
+  XLS_ASSERT_OK_AND_ASSIGN(result, session->RunQuery("(assert false)"));
+  EXPECT_EQ(result, SmtSolverResult::kUnsat);
+
+  XLS_ASSERT_OK_AND_ASSIGN(result, session->RunQuery("(assert true)"));
+  EXPECT_EQ(result, SmtSolverResult::kSat);
+}
+
+TEST(SmtlibSolverPoolTest, PoolRunsManyQueries) {
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SmtlibSolverPool> pool,
+      SmtlibSolverPool::Create(FakeSolverArgv(), /*size=*/2));
+
+  for (int64_t i = 0; i < 16; ++i) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        SmtSolverResult result,
+        pool->RunQuery(i % 2 == 0 ? "(assert true)" : "(assert false)"));
+    EXPECT_EQ(result,
+              i % 2 == 0 ? SmtSolverResult::kSat : SmtSolverResult::kUnsat);
+  }
+}
+
+TEST(SmtlibSolverPoolTest, PoolSendsPreamble) {
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SmtlibSolverPool> pool,
+      SmtlibSolverPool::Create(FakeSolverArgv(), /*size=*/1,
+                               /*preamble=*/"(assert false)"));
+
+  XLS_ASSERT_OK_AND_ASSIGN(SmtSolverResult result,
+                           pool->RunQuery("(assert true)"));
+  EXPECT_EQ(result, SmtSolverResult::kUnsat);
+}
+
+TEST(SmtlibSolverPoolTest, MissingSolverBinaryFails) {
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SmtlibSolverSession> session,
+      SmtlibSolverSession::Start({"/this/does/not/exist"}));
+
+  // The exec failure surfaces on the first query as a closed pipe.
+  EXPECT_FALSE(session->RunQuery("(assert true)").ok());
+}
+
+}  // namespace
+}  // namespace solvers
+}  // namespace xls
@@ -0,0 +1,282 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "xls/solvers/z3_concolic.h"
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/events.h"
+#include "xls/ir/format_preference.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/number_parser.h"
+#include "xls/ir/package.h"
+#include "xls/jit/ir_jit.h"
+#include "xls/solvers/z3_ir_translator.h"
+#include "xls/solvers/z3_utils.h"
+#include "../z3/src/api/z3_api.h"
+
+namespace xls {
+namespace solvers {
+namespace z3 {
+namespace {
+
+// A concrete execution whose branch outcomes are candidates for negation.
+struct PathRecord {
+  std::vector<Value> args;
+  // Observed value of each selector, in CollectSelectors order.
+  std::vector<Bits> observed;
+};
+
+// Returns the selector nodes of all select-like operations in 'function',
+// ordered by the id of the operation they steer and deduplicated. These are
+// the values whose concrete outcomes determine which path an execution takes.
+std::vector<Node*> CollectSelectors(Function* function) {
+  std::vector<Node*> selects;
+  for (Node* node : function->nodes()) {
+    if (node->Is<Select>() || node->Is<OneHotSelect>()) {
+      selects.push_back(node);
+    }
+  }
+  std::sort(selects.begin(), selects.end(),
+            [](Node* a, Node* b) { return a->id() < b->id(); });
+  std::vector<Node*> selectors;
+  absl::flat_hash_set<Node*> seen;
+  for (Node* node : selects) {
+    Node* selector = node->Is<Select>() ? node->As<Select>()->selector()
+                                        : node->As<OneHotSelect>()->selector();
+    if (seen.insert(selector).second) {
+      selectors.push_back(selector);
+    }
+  }
+  return selectors;
+}
+
+// Builds a clone of 'function' which returns the tuple of selector values
+// instead of the original return value. JIT-compiling this probe lets a run
+// report which path it took at native speed, without instrumenting the
+// generated code itself.
+absl::StatusOr<Function*> BuildProbeFunction(
+    Function* function, absl::Span<Node* const> selectors) {
+  XLS_ASSIGN_OR_RETURN(
+      Function * probe,
+      function->Clone(absl::StrCat(function->name(), "__concolic_probe")));
+  // Clone preserves node names, so the cloned selectors can be found by name.
+  std::vector<Node*> probe_selectors;
+  for (Node* selector : selectors) {
+    XLS_ASSIGN_OR_RETURN(Node * cloned, probe->GetNode(selector->GetName()));
+    probe_selectors.push_back(cloned);
+  }
+  XLS_ASSIGN_OR_RETURN(Node * tuple,
+                       probe->MakeNode<Tuple>(absl::nullopt, probe_selectors));
+  XLS_RETURN_IF_ERROR(probe->set_return_value(tuple));
+  return probe;
+}
+
+// Returns 'bits' as a Z3 bit-vector numeral.
+Z3_ast BitsToBvNumeral(Z3_context ctx, const Bits& bits) {
+  std::unique_ptr<bool[]> booleans(new bool[bits.bit_count()]);
+  for (int64_t i = 0; i < bits.bit_count(); ++i) {
+    booleans[i] = bits.Get(i);
+  }
+  return Z3_mk_bv_numeral(ctx, bits.bit_count(), &booleans[0]);
+}
+
+// Evaluates the (bits-typed) parameter 'param_ast' under the satisfying
+// 'model' and converts the result back into an IR Value.
+absl::StatusOr<Value> ExtractParamValue(Z3_context ctx, Z3_model model,
+                                        Z3_ast param_ast, int64_t bit_count) {
+  Z3_ast evaluated;
+  if (!Z3_model_eval(ctx, model, param_ast, /*model_completion=*/true,
+                     &evaluated)) {
+    return absl::InternalError(
+        "Z3 failed to evaluate a parameter under a satisfying model.");
+  }
+  std::string text = Z3_ast_to_string(ctx, evaluated);
+  Bits bits;
+  if (absl::StartsWith(text, "#x")) {
+    XLS_ASSIGN_OR_RETURN(
+        bits, ParseUnsignedNumberWithoutPrefix(
+                  text.substr(2), FormatPreference::kHex, bit_count));
+  } else if (absl::StartsWith(text, "#b")) {
+    XLS_ASSIGN_OR_RETURN(
+        bits, ParseUnsignedNumberWithoutPrefix(
+                  text.substr(2), FormatPreference::kBinary, bit_count));
+  } else {
+    return absl::InternalError(
+        absl::StrCat("Unexpected Z3 model value: ", text));
+  }
+  return Value(bits);
+}
+
+// Returns a string uniquely identifying the sequence of branch outcomes in
+// 'observed'; two runs with equal signatures took the same path.
+std::string PathSignature(absl::Span<const Bits> observed) {
+  return absl::StrJoin(observed, ",", [](std::string* out, const Bits& bits) {
+    absl::StrAppend(out, bits.ToString(FormatPreference::kHex));
+  });
+}
+
+}  // namespace
+
+absl::StatusOr<std::vector<std::vector<Value>>> GenerateConcolicInputs(
+    Function* function, absl::Span<const Value> seed_args,
+    const ConcolicOptions& options) {
+  XLS_RET_CHECK_EQ(seed_args.size(), function->params().size());
+  for (Param* param : function->params()) {
+    if (!param->GetType()->IsBits()) {
+      return absl::UnimplementedError(absl::StrFormat(
+          "Concolic input generation requires bits-typed parameters; "
+          "parameter '%s' of function '%s' has type %s.",
+          param->name(), function->name(), param->GetType()->ToString()));
+    }
+  }
+
+  std::vector<std::vector<Value>> results;
+  results.push_back(std::vector<Value>(seed_args.begin(), seed_args.end()));
+
+  std::vector<Node*> selectors = CollectSelectors(function);
+  if (selectors.empty() || options.max_inputs <= 1) {
+    return results;
+  }
+
+  XLS_ASSIGN_OR_RETURN(Function * probe,
+                       BuildProbeFunction(function, selectors));
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<IrJit> jit, IrJit::Create(probe));
+
+  // Runs the probe on 'args' and returns the observed selector values.
+  auto run_probe =
+      [&](absl::Span<const Value> args) -> absl::StatusOr<std::vector<Bits>> {
+    XLS_ASSIGN_OR_RETURN(Value observed_tuple,
+                         DropInterpreterEvents(jit->Run(args)));
+    std::vector<Bits> observed;
+    observed.reserve(selectors.size());
+    for (const Value& element : observed_tuple.elements()) {
+      observed.push_back(element.bits());
+    }
+    return observed;
+  };
+
+  // The symbolic side: one translation of the function, queried under a fresh
+  // solver per negated branch.
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<IrTranslator> translator,
+                       IrTranslator::CreateAndTranslate(function));
+  Z3_context ctx = translator->ctx();
+  std::vector<Z3_ast> selector_asts;
+  selector_asts.reserve(selectors.size());
+  for (Node* selector : selectors) {
+    selector_asts.push_back(translator->GetTranslation(selector));
+  }
+
+  absl::flat_hash_set<std::string> seen_signatures;
+  // Prefixes whose last branch has already been handed to the solver; keyed
+  // on the outcomes up to (and excluding) the negated selector, so the same
+  // flip is never attempted twice regardless of which run suggested it.
+  absl::flat_hash_set<std::string> attempted_flips;
+  std::deque<PathRecord> worklist;
+
+  XLS_ASSIGN_OR_RETURN(std::vector<Bits> seed_observed, run_probe(seed_args));
+  seen_signatures.insert(PathSignature(seed_observed));
+  worklist.push_back(PathRecord{results.front(), std::move(seed_observed)});
+
+  while (!worklist.empty() &&
+         static_cast<int64_t>(results.size()) < options.max_inputs) {
+    PathRecord record = std::move(worklist.front());
+    worklist.pop_front();
+    for (int64_t i = 0; i < static_cast<int64_t>(selectors.size()) &&
+                        static_cast<int64_t>(results.size()) <
+                            options.max_inputs;
+         ++i) {
+      absl::Span<const Bits> prefix =
+          absl::MakeConstSpan(record.observed).subspan(0, i);
+      std::string flip_key = absl::StrCat(i, ":", PathSignature(prefix));
+      if (!attempted_flips.insert(flip_key).second) {
+        continue;
+      }
+
+      // Constrain the first i branches to their observed outcomes and force
+      // branch i down a different path.
+      Z3_solver solver = CreateSolver(ctx, /*num_threads=*/1);
+      for (int64_t j = 0; j < i; ++j) {
+        Z3_solver_assert(
+            ctx, solver,
+            Z3_mk_eq(ctx, selector_asts[j],
+                     BitsToBvNumeral(ctx, record.observed[j])));
+      }
+      Z3_solver_assert(
+          ctx, solver,
+          Z3_mk_not(ctx, Z3_mk_eq(ctx, selector_asts[i],
+                                  BitsToBvNumeral(ctx, record.observed[i]))));
+      Z3_lbool satisfiable = Z3_solver_check(ctx, solver);
+      if (satisfiable != Z3_L_TRUE) {
+        Z3_solver_dec_ref(ctx, solver);
+        continue;
+      }
+      Z3_model model = Z3_solver_get_model(ctx, solver);
+      Z3_model_inc_ref(ctx, model);
+      std::vector<Value> new_args;
+      new_args.reserve(function->params().size());
+      absl::Status extract_status = absl::OkStatus();
+      for (Param* param : function->params()) {
+        absl::StatusOr<Value> value = ExtractParamValue(
+            ctx, model, translator->GetTranslation(param),
+            param->GetType()->AsBitsOrDie()->bit_count());
+        if (!value.ok()) {
+          extract_status = value.status();
+          break;
+        }
+        new_args.push_back(std::move(value).value());
+      }
+      Z3_model_dec_ref(ctx, model);
+      Z3_solver_dec_ref(ctx, solver);
+      XLS_RETURN_IF_ERROR(extract_status);
+
+      XLS_ASSIGN_OR_RETURN(std::vector<Bits> observed, run_probe(new_args));
+      if (!seen_signatures.insert(PathSignature(observed)).second) {
+        continue;
+      }
+      XLS_VLOG(2) << absl::StreamFormat(
+          "Concolic input %d of %s flips branch %d: [%s]", results.size(),
+          function->name(), i,
+          absl::StrJoin(new_args, ", ", [](std::string* out, const Value& v) {
+            absl::StrAppend(out, v.ToString());
+          }));
+      results.push_back(new_args);
+      worklist.push_back(PathRecord{std::move(new_args), std::move(observed)});
+    }
+  }
+
+  // The probe was only needed for compilation; drop it so repeated calls do
+  // not accumulate clones in the package.
+  XLS_RETURN_IF_ERROR(function->package()->RemoveFunction(probe));
+  return results;
+}
+
+}  // namespace z3
+}  // namespace solvers
+}  // namespace xls
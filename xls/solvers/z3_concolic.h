@@ -0,0 +1,64 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Concolic (concrete + symbolic) input generation for XLS IR functions:
+// coverage-directed argument sets produced by running the JIT-compiled
+// function on concrete inputs and using Z3 to negate the path constraints
+// each run took.
+
+#ifndef XLS_SOLVERS_Z3_CONCOLIC_H_
+#define XLS_SOLVERS_Z3_CONCOLIC_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/ir/function.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace solvers {
+namespace z3 {
+
+// Options controlling GenerateConcolicInputs.
+struct ConcolicOptions {
+  // Upper bound on the number of argument sets returned, including the seed.
+  int64_t max_inputs = 256;
+};
+
+// Generates argument sets for 'function' which exercise distinct branch
+// outcomes of its select operations. Starting from 'seed_args', the function
+// is run JIT-compiled while the concrete values feeding its select (and
+// one-hot select) operations are recorded; each recorded selector outcome is
+// then negated in turn (holding the outcomes of earlier selectors fixed) and
+// handed to Z3, whose satisfying models become new concrete inputs to
+// explore. Iterates until no negation yields an unseen path or
+// options.max_inputs argument sets have been produced.
+//
+// This sits between random sampling (fast, but plateaus on deeply nested
+// selects) and exhaustive proving (complete, but often intractable): each
+// solver query only has to find some input flipping a single branch, and all
+// actual evaluation runs at JIT speed.
+//
+// Only functions whose parameters are all bits-typed are currently supported.
+absl::StatusOr<std::vector<std::vector<Value>>> GenerateConcolicInputs(
+    Function* function, absl::Span<const Value> seed_args,
+    const ConcolicOptions& options = ConcolicOptions());
+
+}  // namespace z3
+}  // namespace solvers
+}  // namespace xls
+
+#endif  // XLS_SOLVERS_Z3_CONCOLIC_H_
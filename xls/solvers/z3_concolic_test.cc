@@ -0,0 +1,110 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/solvers/z3_concolic.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_set.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+using solvers::z3::ConcolicOptions;
+using solvers::z3::GenerateConcolicInputs;
+
+class Z3ConcolicTest : public IrTestBase {};
+
+TEST_F(Z3ConcolicTest, FunctionWithoutSelectsReturnsSeed) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(8));
+  BValue y = fb.Param("y", p->GetBitsType(8));
+  fb.Add(x, y);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::vector<Value>> inputs,
+      GenerateConcolicInputs(f, {Value(UBits(1, 8)), Value(UBits(2, 8))}));
+  ASSERT_EQ(inputs.size(), 1);
+  EXPECT_EQ(inputs[0][0], Value(UBits(1, 8)));
+  EXPECT_EQ(inputs[0][1], Value(UBits(2, 8)));
+}
+
+TEST_F(Z3ConcolicTest, CoversSelectLadder) {
+  // Two selects guarded by equality against "magic" constants: a random
+  // sampler has a 2^-8 chance per draw of taking either true branch, but
+  // concolic generation finds both by negating the path constraints.
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(8));
+  BValue is42 = fb.Eq(x, fb.Literal(UBits(42, 8)));
+  BValue inner = fb.Select(
+      is42, {fb.Literal(UBits(0, 8)), fb.Literal(UBits(1, 8))});
+  BValue is123 = fb.Eq(x, fb.Literal(UBits(123, 8)));
+  fb.Select(is123, {inner, fb.Literal(UBits(2, 8))});
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::vector<Value>> inputs,
+      GenerateConcolicInputs(f, {Value(UBits(0, 8))}));
+  // The seed (both branches false) plus one input per flipped branch; the
+  // remaining combination (x == 42 && x == 123) is unsatisfiable.
+  ASSERT_EQ(inputs.size(), 3);
+  absl::flat_hash_set<uint64_t> xs;
+  for (const std::vector<Value>& args : inputs) {
+    XLS_ASSERT_OK_AND_ASSIGN(uint64_t value, args[0].bits().ToUint64());
+    xs.insert(value);
+  }
+  EXPECT_TRUE(xs.contains(0));
+  EXPECT_TRUE(xs.contains(42));
+  EXPECT_TRUE(xs.contains(123));
+}
+
+TEST_F(Z3ConcolicTest, RespectsMaxInputs) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(8));
+  BValue is42 = fb.Eq(x, fb.Literal(UBits(42, 8)));
+  fb.Select(is42, {fb.Literal(UBits(0, 8)), fb.Literal(UBits(1, 8))});
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  ConcolicOptions options;
+  options.max_inputs = 1;
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::vector<Value>> inputs,
+      GenerateConcolicInputs(f, {Value(UBits(0, 8))}, options));
+  EXPECT_EQ(inputs.size(), 1);
+}
+
+TEST_F(Z3ConcolicTest, NonBitsParamsUnsupported) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetTupleType({p->GetBitsType(8)}));
+  fb.TupleIndex(x, 0);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  EXPECT_THAT(GenerateConcolicInputs(
+                  f, {Value::Tuple({Value(UBits(0, 8))})})
+                  .status(),
+              status_testing::StatusIs(absl::StatusCode::kUnimplemented));
+}
+
+}  // namespace
+}  // namespace xls
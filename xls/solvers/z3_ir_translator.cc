@@ -14,11 +14,16 @@
 
 #include "xls/solvers/z3_ir_translator.h"
 
+#include <filesystem>
+#include <tuple>
+
 #include "absl/debugging/leak_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/time/time.h"
+#include "xls/common/file/filesystem.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/logging/vlog_is_on.h"
 #include "xls/common/status/ret_check.h"
@@ -1149,20 +1154,30 @@ absl::Status IrTranslator::HandleOrReduce(BitwiseReductionOp* or_reduce) {
   return seh.status();
 }
 
-void IrTranslator::HandleMul(ArithOp* mul, bool is_signed) {
+const IrTranslator::OpTemplate& IrTranslator::GetMulTemplate(
+    Op op, int64_t lhs_size, int64_t rhs_size, int64_t result_size) {
+  auto key = std::make_tuple(op, lhs_size, rhs_size, result_size);
+  auto it = op_templates_.find(key);
+  if (it != op_templates_.end()) {
+    return it->second;
+  }
+
+  // Build the multiply body over fresh placeholder constants; instances
+  // substitute the actual operands for the placeholders.
+  Z3_ast lhs = Z3_mk_fresh_const(ctx_, "mul_template_lhs",
+                                 Z3_mk_bv_sort(ctx_, lhs_size));
+  Z3_ast rhs = Z3_mk_fresh_const(ctx_, "mul_template_rhs",
+                                 Z3_mk_bv_sort(ctx_, rhs_size));
+  OpTemplate tmpl;
+  tmpl.params = {lhs, rhs};
+
   // In XLS IR, multiply operands can potentially be of different widths. In Z3,
   // they can't, so we need to zext (for a umul) the operands to the size of the
   // result.
-  Z3_ast lhs = GetValue(mul->operand(0));
-  Z3_ast rhs = GetValue(mul->operand(1));
-  int lhs_size = Z3_get_bv_sort_size(ctx_, Z3_get_sort(ctx_, lhs));
-  int rhs_size = Z3_get_bv_sort_size(ctx_, Z3_get_sort(ctx_, rhs));
-
-  int result_size = mul->BitCountOrDie();
-  int operation_size = std::max(result_size, std::max(lhs_size, rhs_size));
+  int64_t operation_size = std::max(result_size, std::max(lhs_size, rhs_size));
   // Do the mul at maximum width, then truncate if necessary to the result
   // width.
-  if (is_signed) {
+  if (op == Op::kSMul) {
     if (lhs_size < operation_size) {
       lhs = Z3_mk_sign_ext(ctx_, operation_size - lhs_size, lhs);
     }
@@ -1182,6 +1197,23 @@ void IrTranslator::HandleMul(ArithOp* mul, bool is_signed) {
     result = Z3_mk_extract(ctx_, result_size - 1, 0, result);
   }
 
+  tmpl.body = result;
+  return op_templates_.emplace(key, std::move(tmpl)).first->second;
+}
+
+void IrTranslator::HandleMul(ArithOp* mul, bool is_signed) {
+  Z3_ast lhs = GetValue(mul->operand(0));
+  Z3_ast rhs = GetValue(mul->operand(1));
+  int64_t lhs_size = Z3_get_bv_sort_size(ctx_, Z3_get_sort(ctx_, lhs));
+  int64_t rhs_size = Z3_get_bv_sort_size(ctx_, Z3_get_sort(ctx_, rhs));
+
+  const OpTemplate& tmpl = GetMulTemplate(is_signed ? Op::kSMul : Op::kUMul,
+                                          lhs_size, rhs_size,
+                                          mul->BitCountOrDie());
+  Z3_ast args[] = {lhs, rhs};
+  Z3_ast result = Z3_substitute(ctx_, tmpl.body, /*num_exprs=*/2,
+                                tmpl.params.data(), args);
+
   NoteTranslation(mul, result);
 }
 
@@ -1259,42 +1291,140 @@ absl::StatusOr<Z3_ast> PredicateToObjective(Predicate p, Z3_ast a,
   return objective;
 }
 
-absl::StatusOr<bool> TryProve(Function* f, Node* subject, Predicate p,
-                              absl::Duration timeout) {
-  XLS_ASSIGN_OR_RETURN(auto translator, IrTranslator::CreateAndTranslate(f));
-  translator->SetTimeout(timeout);
-  Z3_ast value = translator->GetTranslation(subject);
+namespace {
+
+// A translated proof objective. The translator owns the Z3 context the
+// objective lives in; a nullopt objective denotes a trivially-true predicate
+// (e.g., comparing two token-typed nodes).
+struct TranslatedObjective {
+  std::unique_ptr<IrTranslator> translator;
+  absl::optional<Z3_ast> objective;
+};
+
+// Translates "f" and builds the satisfiability objective (the inverse of the
+// predicate to prove) for the subject node.
+absl::StatusOr<TranslatedObjective> TranslateObjective(Function* f,
+                                                       Node* subject,
+                                                       Predicate p,
+                                                       absl::Duration timeout) {
+  TranslatedObjective result;
+  XLS_ASSIGN_OR_RETURN(result.translator,
+                       IrTranslator::CreateAndTranslate(f));
+  result.translator->SetTimeout(timeout);
+  Z3_ast value = result.translator->GetTranslation(subject);
 
   // All token types are equal.
   if (subject->GetType()->IsToken() &&
       p.kind() == PredicateKind::kEqualToNode &&
       p.node()->GetType()->IsToken()) {
-    return true;
+    return result;
   }
-  if (translator->GetValueKind(value) != Z3_BV_SORT) {
+  if (result.translator->GetValueKind(value) != Z3_BV_SORT) {
     return absl::InvalidArgumentError(
         "Cannot prove properties of non-bits-typed node: " +
         subject->ToString());
   }
   XLS_ASSIGN_OR_RETURN(Z3_ast objective,
-                       PredicateToObjective(p, value, translator.get()));
-  Z3_context ctx = translator->ctx();
-  XLS_VLOG(2) << "objective:\n" << Z3_ast_to_string(ctx, objective);
+                       PredicateToObjective(p, value, result.translator.get()));
+  XLS_VLOG(2) << "objective:\n"
+              << Z3_ast_to_string(result.translator->ctx(), objective);
+  result.objective = objective;
+  return result;
+}
+
+// Checks the given objective with a fresh solver. We posit the inverse of the
+// predicate we want to check -- when that is unsatisfiable, the predicate has
+// been proven (there was no way found that we could not satisfy its inverse).
+bool ObjectiveUnsatisfiable(Z3_context ctx, Z3_ast objective) {
   Z3_solver solver = solvers::z3::CreateSolver(ctx, 1);
   Z3_solver_assert(ctx, solver, objective);
   Z3_lbool satisfiable = Z3_solver_check(ctx, solver);
   XLS_VLOG(2) << solvers::z3::SolverResultToString(ctx, solver, satisfiable)
               << std::endl;
   Z3_solver_dec_ref(ctx, solver);
+  return satisfiable == Z3_L_FALSE;
+}
 
-  if (Z3_solver_check(ctx, solver) == Z3_L_FALSE) {
-    // We posit the inverse of the predicate we want to check -- when that is
-    // unsatisfiable, the predicate has been proven (there was no way found that
-    // we could not satisfy its inverse).
+// Stable 64-bit FNV-1a hash, used to fingerprint proof inputs for the on-disk
+// translation cache (std::hash makes no cross-process stability guarantees).
+uint64_t Fingerprint(absl::string_view text) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (char c : text) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+}  // namespace
+
+absl::StatusOr<bool> TryProve(Function* f, Node* subject, Predicate p,
+                              absl::Duration timeout) {
+  XLS_ASSIGN_OR_RETURN(TranslatedObjective to,
+                       TranslateObjective(f, subject, p, timeout));
+  if (!to.objective.has_value()) {
     return true;
   }
+  return ObjectiveUnsatisfiable(to.translator->ctx(), to.objective.value());
+}
+
+absl::StatusOr<bool> TryProveWithCache(Function* f, Node* subject, Predicate p,
+                                       absl::Duration timeout,
+                                       absl::string_view cache_dir) {
+  uint64_t fingerprint = Fingerprint(
+      absl::StrCat(f->DumpIr(), "\n", subject->GetName(), "\n", p.ToString()));
+  std::filesystem::path cache_path =
+      std::filesystem::path(std::string(cache_dir)) /
+      absl::StrFormat("proof-%016x.smt2", fingerprint);
+
+  absl::StatusOr<std::string> cached = GetFileContents(cache_path);
+  if (cached.ok()) {
+    // Cache hit: the translated objective parses back much faster than the
+    // function can be re-translated.
+    XLS_VLOG(1) << "Proof cache hit: " << cache_path;
+    Z3_config config = Z3_mk_config();
+    Z3_context ctx = Z3_mk_context(config);
+    Z3_lbool satisfiable;
+    absl::Status parse_status;
+    {
+      ScopedErrorHandler seh(ctx);
+      Z3_ast_vector objectives = Z3_parse_smtlib2_string(
+          ctx, cached->c_str(), 0, nullptr, nullptr, 0, nullptr, nullptr);
+      Z3_ast_vector_inc_ref(ctx, objectives);
+      Z3_solver solver = solvers::z3::CreateSolver(ctx, 1);
+      for (unsigned int i = 0; i < Z3_ast_vector_size(ctx, objectives); i++) {
+        Z3_solver_assert(ctx, solver, Z3_ast_vector_get(ctx, objectives, i));
+      }
+      satisfiable = Z3_solver_check(ctx, solver);
+      Z3_solver_dec_ref(ctx, solver);
+      Z3_ast_vector_dec_ref(ctx, objectives);
+      parse_status = seh.status();
+    }
+    Z3_del_context(ctx);
+    Z3_del_config(config);
+    XLS_RETURN_IF_ERROR(parse_status);
+    return satisfiable == Z3_L_FALSE;
+  }
 
-  return false;
+  // Cache miss: translate and solve as TryProve() does, then persist the
+  // translated objective for next time.
+  XLS_ASSIGN_OR_RETURN(TranslatedObjective to,
+                       TranslateObjective(f, subject, p, timeout));
+  if (!to.objective.has_value()) {
+    return true;
+  }
+  Z3_context ctx = to.translator->ctx();
+  std::string smt = Z3_benchmark_to_smtlib_string(
+      ctx, /*name=*/"xls_proof", /*logic=*/"", /*status=*/"unknown",
+      /*attributes=*/"", /*num_assumptions=*/0, /*assumptions=*/nullptr,
+      to.objective.value());
+  absl::Status write_status = SetFileContents(cache_path, smt);
+  if (!write_status.ok()) {
+    // A failed cache write shouldn't fail the proof itself.
+    XLS_LOG(WARNING) << "Could not write proof cache entry " << cache_path
+                     << ": " << write_status;
+  }
+  return ObjectiveUnsatisfiable(ctx, to.objective.value());
 }
 
 }  // namespace z3
@@ -19,6 +19,7 @@
 #define XLS_TOOLS_Z3_IR_TRANSLATOR_H_
 
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "xls/common/logging/logging.h"
 #include "xls/data_structures/leaf_type_tree.h"
@@ -198,6 +199,21 @@ class IrTranslator : public DfsVisitorWithDefault {
   // Common multiply handling.
   void HandleMul(ArithOp* mul, bool is_signed);
 
+  // An operator translated once into a Z3 term over placeholder parameters.
+  // Per-node instances are produced by substituting the actual operands for
+  // the placeholders, so the term structure for a given (op, widths)
+  // signature is only built a single time no matter how many nodes in the
+  // function share that signature.
+  struct OpTemplate {
+    std::vector<Z3_ast> params;
+    Z3_ast body;
+  };
+
+  // Returns the template for a multiply with the given signature, creating
+  // and caching it on first use.
+  const OpTemplate& GetMulTemplate(Op op, int64_t lhs_size, int64_t rhs_size,
+                                   int64_t result_size);
+
   // Translates a OneHotSelect or Sel node whose (non-selector) operands are
   // Tuple typed. Accepts a function to actually call into the AbstractEvaluator
   // for that node. "FlatValue" is a helper to represent a value as a
@@ -248,6 +264,10 @@ class IrTranslator : public DfsVisitorWithDefault {
   // we shouldn't delete our context, etc.!
   bool borrowed_context_;
   absl::flat_hash_map<const Node*, Z3_ast> translations_;
+  // Cache of operator templates keyed by (op, lhs width, rhs width, result
+  // width). See GetMulTemplate().
+  absl::flat_hash_map<std::tuple<Op, int64_t, int64_t, int64_t>, OpTemplate>
+      op_templates_;
   // Params specified in the context-borrowing CreateAndTranslate() builder.
   // Parameters already translated in a separate function traversal that should
   // be used as this translation's parameter set.
@@ -289,6 +309,17 @@ class Predicate {
 absl::StatusOr<bool> TryProve(Function* f, Node* subject, Predicate p,
                               absl::Duration timeout);
 
+// As above, but memoizes translated proof objectives on disk: "cache_dir"
+// holds one SMT-LIB2 file per (function, subject, predicate) fingerprint.
+// When an entry matches, the objective is parsed back instead of
+// re-translating the function - a large savings when the same lemmas are
+// proved over mostly-unchanged IR (e.g. in nightly CI). Stale entries are
+// never matched (the fingerprint covers the full function text), but they are
+// not garbage-collected either.
+absl::StatusOr<bool> TryProveWithCache(Function* f, Node* subject, Predicate p,
+                                       absl::Duration timeout,
+                                       absl::string_view cache_dir);
+
 }  // namespace z3
 }  // namespace solvers
 }  // namespace xls
@@ -17,6 +17,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/strings/substitute.h"
+#include "xls/common/file/temp_directory.h"
 #include "xls/common/status/matchers.h"
 #include "xls/ir/bits_ops.h"
 #include "xls/ir/function_builder.h"
@@ -32,6 +33,7 @@ namespace {
 using solvers::z3::IrTranslator;
 using solvers::z3::Predicate;
 using solvers::z3::TryProve;
+using solvers::z3::TryProveWithCache;
 using status_testing::IsOkAndHolds;
 
 class Z3IrTranslatorTest : public IrTestBase {};
@@ -109,6 +111,45 @@ fn f(x: bits[32], y: bits[32]) -> bits[32] {
   EXPECT_TRUE(proven);
 }
 
+TEST_F(Z3IrTranslatorTest, RepeatedSameWidthMultipliesCommute) {
+  // Several multiplies with the same (op, width) signature; all share one
+  // cached operator template inside the translator.
+  const std::string program = R"(
+fn f(x: bits[8], y: bits[8], z: bits[8]) -> bits[8] {
+  a: bits[8] = umul(x, y)
+  b: bits[8] = umul(y, x)
+  c: bits[8] = umul(a, z)
+  d: bits[8] = umul(b, z)
+  ret e: bits[8] = sub(c, d)
+}
+)";
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(program, p.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      bool proven, TryProve(f, f->return_value(), Predicate::EqualToZero(),
+                            absl::InfiniteDuration()));
+  EXPECT_TRUE(proven);
+}
+
+TEST_F(Z3IrTranslatorTest, WideningSignedMultiplyByOneIsSignExtend) {
+  // Mixed-width signed multiply; exercises the operand-extension logic in the
+  // cached multiply template.
+  const std::string program = R"(
+fn f(x: bits[4]) -> bits[8] {
+  one: bits[4] = literal(value=1)
+  m: bits[8] = smul(x, one)
+  s: bits[8] = sign_ext(x, new_bit_count=8)
+  ret d: bits[8] = sub(m, s)
+}
+)";
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(program, p.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      bool proven, TryProve(f, f->return_value(), Predicate::EqualToZero(),
+                            absl::InfiniteDuration()));
+  EXPECT_TRUE(proven);
+}
+
 TEST_F(Z3IrTranslatorTest, TupleIndexMinusSelf) {
   const std::string program = R"(
 fn f(p: (bits[1], bits[32])) -> bits[32] {
@@ -1630,5 +1671,41 @@ fn f() -> bits[64] {
   }
 }
 
+TEST_F(Z3IrTranslatorTest, ProofCacheHitMatchesColdResult) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory cache_dir, TempDirectory::Create());
+
+  auto p = CreatePackage();
+  FunctionBuilder b("f", p.get());
+  auto x = b.Param("x", p->GetBitsType(4));
+  auto zero = b.And(x, b.Literal(UBits(0, /*bit_count=*/4)));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, b.Build());
+
+  // First call misses the cache and writes an entry; the second parses the
+  // cached translation. Both must agree (here, x & 0 == 0 is provable).
+  XLS_ASSERT_OK_AND_ASSIGN(
+      bool proven_cold,
+      TryProveWithCache(f, zero.node(), Predicate::EqualToZero(),
+                        absl::InfiniteDuration(), cache_dir.path().string()));
+  EXPECT_TRUE(proven_cold);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      bool proven_cached,
+      TryProveWithCache(f, zero.node(), Predicate::EqualToZero(),
+                        absl::InfiniteDuration(), cache_dir.path().string()));
+  EXPECT_TRUE(proven_cached);
+
+  // An unprovable predicate on the same function must use a different cache
+  // entry and stay unproven across a cold and a cached query.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      bool disproven_cold,
+      TryProveWithCache(f, x.node(), Predicate::EqualToZero(),
+                        absl::InfiniteDuration(), cache_dir.path().string()));
+  EXPECT_FALSE(disproven_cold);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      bool disproven_cached,
+      TryProveWithCache(f, x.node(), Predicate::EqualToZero(),
+                        absl::InfiniteDuration(), cache_dir.path().string()));
+  EXPECT_FALSE(disproven_cached);
+}
+
 }  // namespace
 }  // namespace xls
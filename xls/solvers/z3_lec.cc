@@ -23,6 +23,7 @@
 #include "absl/strings/strip.h"
 #include "xls/codegen/vast.h"
 #include "xls/common/status/ret_check.h"
+#include "xls/common/thread.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/bits_ops.h"
 #include "xls/ir/node_util.h"
@@ -64,7 +65,8 @@ absl::StatusOr<std::unique_ptr<Lec>> Lec::Create(const LecParams& params) {
 }
 
 // This is just sugar; we could add schedule & stage to LecParams, but I like
-// the more-explicit invocation style here.
+// the more-explicit invocation style here. Use AdvanceToStage() to step
+// through subsequent stages without rebuilding the solver.
 absl::StatusOr<std::unique_ptr<Lec>> Lec::CreateForStage(
     const LecParams& params, const PipelineSchedule& schedule, int stage) {
   auto lec = absl::WrapUnique<Lec>(
@@ -91,13 +93,33 @@ Lec::~Lec() {
   if (solver_) {
     Z3_solver_dec_ref(ctx(), solver_.value());
   }
+  if (netlist_ctx_ != nullptr) {
+    Z3_del_context(netlist_ctx_);
+    Z3_del_config(netlist_config_);
+  }
 }
 
 absl::Status Lec::Init() {
   XLS_ASSIGN_OR_RETURN(module_, netlist_->GetModule(netlist_module_name_));
-  XLS_RETURN_IF_ERROR(CreateIrTranslator());
-  XLS_RETURN_IF_ERROR(CreateNetlistTranslator());
 
+  // The IR and netlist translations are independent of each other (they only
+  // meet at the miter), so run them concurrently, each into its own context.
+  netlist_config_ = Z3_mk_config();
+  netlist_ctx_ = Z3_mk_context(netlist_config_);
+  absl::Status netlist_status;
+  xls::Thread netlist_thread([this, &netlist_status]() {
+    netlist_status = CreateNetlistTranslator();
+  });
+  absl::Status ir_status = CreateIrTranslator();
+  netlist_thread.Join();
+  XLS_RETURN_IF_ERROR(ir_status);
+  XLS_RETURN_IF_ERROR(netlist_status);
+
+  solver_ = CreateSolver(ctx(), std::thread::hardware_concurrency());
+  return AssertStageMiter();
+}
+
+absl::Status Lec::AssertStageMiter() {
   XLS_RETURN_IF_ERROR(CollectIrInputs());
   if (XLS_VLOG_IS_ON(2)) {
     for (const auto& pair : input_mapping_) {
@@ -142,12 +164,33 @@ absl::Status Lec::Init() {
 
   Z3_ast eval_node = Z3_mk_and(ctx(), eq_nodes.size(), eq_nodes.data());
   eval_node = Z3_mk_not(ctx(), eval_node);
-  solver_ = CreateSolver(ctx(), std::thread::hardware_concurrency());
+  // Assert within a backtracking scope, so AdvanceToStage() can retract just
+  // this stage's miter while keeping the solver (and its learned clauses).
+  Z3_solver_push(ctx(), solver_.value());
   Z3_solver_assert(ctx(), solver_.value(), eval_node);
 
   return absl::OkStatus();
 }
 
+absl::Status Lec::AdvanceToStage(int stage) {
+  XLS_RET_CHECK(schedule_.has_value())
+      << "AdvanceToStage() requires a LEC created via CreateForStage().";
+  XLS_RET_CHECK_GT(stage, stage_) << "Stages must be visited in order.";
+  if (model_) {
+    Z3_model_dec_ref(ctx(), model_.value());
+    model_ = absl::nullopt;
+  }
+  satisfiable_ = false;
+  Z3_solver_pop(ctx(), solver_.value(), 1);
+
+  input_mapping_.clear();
+  ir_output_nodes_.clear();
+  ir_outputs_.clear();
+  netlist_outputs_.clear();
+  stage_ = stage;
+  return AssertStageMiter();
+}
+
 absl::Status Lec::CollectIrInputs() {
   if (CheckingSingleStage(schedule_, stage_) && stage_ != 0) {
     // If we're evaluating a single stage (aside from the first), then we need
@@ -323,6 +366,11 @@ absl::Status Lec::CreateIrTranslator() {
 
 absl::Status Lec::BindNetlistInputs() {
   absl::flat_hash_map<std::string, Z3_ast> nl_inputs = FlattenNetlistInputs();
+  // The input bits were built in the IR context; move them over to the
+  // netlist's context before handing them to the netlist translator.
+  for (auto& pair : nl_inputs) {
+    pair.second = Z3_translate(ctx(), pair.second, netlist_ctx_);
+  }
   return netlist_translator_->Retranslate(nl_inputs);
 }
 
@@ -383,7 +431,10 @@ absl::StatusOr<std::vector<Z3_ast>> Lec::GetNetlistZ3ForIr(const Node* node) {
     } else {
       XLS_ASSIGN_OR_RETURN(Z3_ast z3_output,
                            netlist_translator_->GetTranslation(netref));
-      netlist_output.push_back(z3_output);
+      // Merge the netlist-context AST into the IR context, where the miter
+      // lives. Z3_translate() unifies constants by name, so the IR inputs
+      // threaded through BindNetlistInputs() line up again here.
+      netlist_output.push_back(Z3_translate(netlist_ctx_, z3_output, ctx()));
     }
   }
   return netlist_output;
@@ -397,9 +448,10 @@ absl::Status Lec::CreateNetlistTranslator() {
     }
   }
 
-  XLS_ASSIGN_OR_RETURN(netlist_translator_,
-                       NetlistTranslator::CreateAndTranslate(
-                           ir_translator_->ctx(), module_, module_refs));
+  XLS_ASSIGN_OR_RETURN(
+      netlist_translator_,
+      NetlistTranslator::CreateAndTranslate(netlist_ctx_, module_,
+                                            module_refs));
 
   return absl::OkStatus();
 }
@@ -76,6 +76,14 @@ class Lec {
   // Returns true of the netlist and IR are proved to be equivalent.
   bool Run();
 
+  // Repoints a per-stage LEC (created via CreateForStage()) at the given
+  // stage, retaining the solver - and thus the clauses Z3 has learned about
+  // the design - from the stages checked so far. The previous stage's miter
+  // is retracted (via solver push/pop) and the new stage's is asserted in its
+  // place. Stages must be visited in increasing order; call Run() after each
+  // advance.
+  absl::Status AdvanceToStage(int stage);
+
   // Dumps all Z3 values corresponding to IR nodes in the input function.
   void DumpIrTree();
 
@@ -92,6 +100,11 @@ class Lec {
   absl::Status CreateIrTranslator();
   absl::Status CreateNetlistTranslator();
 
+  // Builds the miter for the current stage (or the whole function) and
+  // asserts it on the solver inside a fresh push/pop scope, so that
+  // AdvanceToStage() can retract it without discarding the solver.
+  absl::Status AssertStageMiter();
+
   // Collects the XLS IR nodes that are inputs to this evaluation - either the
   // original function inputs for whole-function or first-stage equivalence
   // checks, or the stage inputs for all others.
@@ -146,6 +159,13 @@ class Lec {
   const netlist::rtl::Module* module_;
   std::unique_ptr<NetlistTranslator> netlist_translator_;
 
+  // The netlist is translated into its own Z3 context - a context may only be
+  // used by one thread at a time, so a second context lets the IR and netlist
+  // translations run concurrently. Netlist ASTs are merged into the IR
+  // context (via Z3_translate()) where the miter is built.
+  Z3_config netlist_config_ = nullptr;
+  Z3_context netlist_ctx_ = nullptr;
+
   // Cached copies of translation data (cached for post-proof output).
   absl::flat_hash_map<const Node*, Z3_ast> input_mapping_;
   std::vector<const Node*> ir_output_nodes_;
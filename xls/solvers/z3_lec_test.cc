@@ -218,6 +218,18 @@ endmodule
     ASSERT_TRUE(lec->Run());
     XLS_LOG(INFO) << "Pass stage " << i;
   }
+
+  // The same check should pass with a single Lec stepped through the stages
+  // incrementally (reusing the solver between stages).
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Lec> lec,
+                           Lec::CreateForStage(params, schedule, 0));
+  for (int i = 0; i < schedule.length(); i++) {
+    if (i != 0) {
+      XLS_ASSERT_OK(lec->AdvanceToStage(i));
+    }
+    ASSERT_TRUE(lec->Run());
+    XLS_LOG(INFO) << "Pass stage " << i << " (incremental)";
+  }
 }
 
 // This test verifies that a non-matching set of inputs "correctly" fails. This
@@ -309,6 +321,17 @@ endmodule
     }
     XLS_LOG(INFO) << "Pass stage " << i;
   }
+
+  // Incrementally: the stage 0 mismatch (and its model) must not leak into
+  // the later stages.
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Lec> lec,
+                           Lec::CreateForStage(params, schedule, 0));
+  ASSERT_FALSE(lec->Run());
+  for (int i = 1; i < schedule.length(); i++) {
+    XLS_ASSERT_OK(lec->AdvanceToStage(i));
+    ASSERT_TRUE(lec->Run());
+    XLS_LOG(INFO) << "Pass stage " << i << " (incremental)";
+  }
 }
 
 // This test verifies that we can do a multibit LEC with >1b inputs.
@@ -15,6 +15,7 @@
 #include "xls/solvers/z3_netlist_translator.h"
 
 #include <variant>
+#include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/status/statusor.h"
@@ -23,8 +24,8 @@
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/netlist/cell_function.h"
 #include "xls/netlist/cell_library.h"
-#include "xls/netlist/function_parser.h"
 #include "xls/netlist/netlist.h"
 #include "xls/solvers/z3_utils.h"
 #include "../z3/src/api/z3_api.h"
@@ -36,7 +37,6 @@ namespace z3 {
 using netlist::CellLibraryEntry;
 using netlist::StateTable;
 using netlist::StateTableSignal;
-using netlist::function::Ast;
 using netlist::rtl::Cell;
 using netlist::rtl::Module;
 using netlist::rtl::NetRef;
@@ -185,8 +185,6 @@ absl::Status NetlistTranslator::Translate() {
 }
 
 absl::Status NetlistTranslator::TranslateCell(const Cell& cell) {
-  using netlist::function::Ast;
-
   // If this cell is actually a reference to a module defined in this netlist,
   // then translate it into Z3-space here and grab its output nodes.
   std::string entry_name = cell.cell_library_entry()->name();
@@ -228,13 +226,13 @@ absl::Status NetlistTranslator::TranslateCell(const Cell& cell) {
     XLS_ASSIGN_OR_RETURN(state_table_values, TranslateStateTable(cell));
   }
 
-  const CellLibraryEntry::OutputPinToFunction& pins =
-      entry->output_pin_to_function();
   for (const auto& output : cell.outputs()) {
-    XLS_ASSIGN_OR_RETURN(Ast ast, netlist::function::Parser::ParseFunction(
-                                      pins.at(output.name)));
+    XLS_ASSIGN_OR_RETURN(
+        const netlist::function::CompiledFunction* function,
+        entry->GetCompiledFunction(output.name));
     XLS_ASSIGN_OR_RETURN(Z3_ast result,
-                         TranslateFunction(cell, ast, state_table_values));
+                         TranslateFunction(cell, *function,
+                                           state_table_values));
     translated_[output.netref] = result;
   }
 
@@ -243,67 +241,62 @@ absl::Status NetlistTranslator::TranslateCell(const Cell& cell) {
 
 // After all the above, this is the spot where any _ACTUAL_ translation happens.
 absl::StatusOr<Z3_ast> NetlistTranslator::TranslateFunction(
-    const Cell& cell, netlist::function::Ast ast,
+    const Cell& cell, const netlist::function::CompiledFunction& function,
     const absl::flat_hash_map<std::string, Z3_ast>& state_table_values) {
-  switch (ast.kind()) {
-    case Ast::Kind::kAnd: {
-      XLS_ASSIGN_OR_RETURN(
-          Z3_ast lhs,
-          TranslateFunction(cell, ast.children()[0], state_table_values));
-      XLS_ASSIGN_OR_RETURN(
-          Z3_ast rhs,
-          TranslateFunction(cell, ast.children()[1], state_table_values));
-      return Z3_mk_bvand(ctx_, lhs, rhs);
-    }
-    case Ast::Kind::kIdentifier: {
-      for (const auto& input : cell.inputs()) {
-        if (input.name == ast.name()) {
-          return translated_.at(input.netref);
+  using Gate = netlist::function::CompiledFunction::Gate;
+  using GateKind = netlist::function::CompiledFunction::GateKind;
+  // The compiled function's gates are in dependency order, so a single
+  // forward pass builds the Z3 expression. Shared gates translate once.
+  std::vector<Z3_ast> gate_asts(function.gates().size());
+  for (int64_t i = 0; i < static_cast<int64_t>(function.gates().size()); ++i) {
+    const Gate& gate = function.gates()[i];
+    switch (gate.kind) {
+      case GateKind::kInput: {
+        Z3_ast input_ast = nullptr;
+        for (const auto& input : cell.inputs()) {
+          if (input.name == gate.name) {
+            input_ast = translated_.at(input.netref);
+            break;
+          }
         }
+        if (input_ast == nullptr) {
+          if (!state_table_values.contains(gate.name)) {
+            return absl::NotFoundError(absl::StrFormat(
+                "Identifier \"%s\", was not found in cell %s's inputs.",
+                gate.name, cell.name()));
+          }
+          input_ast = state_table_values.at(gate.name);
+        }
+        gate_asts[i] = input_ast;
+        break;
       }
-
-      if (state_table_values.contains(ast.name())) {
-        return state_table_values.at(ast.name());
-      }
-
-      return absl::NotFoundError(absl::StrFormat(
-          "Identifier \"%s\", was not found in cell %s's inputs.", ast.name(),
-          cell.name()));
-    }
-    case Ast::Kind::kLiteralOne: {
-      return Z3_mk_int(ctx_, 1, Z3_mk_bv_sort(ctx_, 1));
-    }
-    case Ast::Kind::kLiteralZero: {
-      return Z3_mk_int(ctx_, 0, Z3_mk_bv_sort(ctx_, 1));
-    }
-    case Ast::Kind::kNot: {
-      XLS_ASSIGN_OR_RETURN(
-          Z3_ast child,
-          TranslateFunction(cell, ast.children()[0], state_table_values));
-      return Z3_mk_bvnot(ctx_, child);
-    }
-    case Ast::Kind::kOr: {
-      XLS_ASSIGN_OR_RETURN(
-          Z3_ast lhs,
-          TranslateFunction(cell, ast.children()[0], state_table_values));
-      XLS_ASSIGN_OR_RETURN(
-          Z3_ast rhs,
-          TranslateFunction(cell, ast.children()[1], state_table_values));
-      return Z3_mk_bvor(ctx_, lhs, rhs);
-    }
-    case Ast::Kind::kXor: {
-      XLS_ASSIGN_OR_RETURN(
-          Z3_ast lhs,
-          TranslateFunction(cell, ast.children()[0], state_table_values));
-      XLS_ASSIGN_OR_RETURN(
-          Z3_ast rhs,
-          TranslateFunction(cell, ast.children()[1], state_table_values));
-      return Z3_mk_bvxor(ctx_, lhs, rhs);
+      case GateKind::kLiteralOne:
+        gate_asts[i] = Z3_mk_int(ctx_, 1, Z3_mk_bv_sort(ctx_, 1));
+        break;
+      case GateKind::kLiteralZero:
+        gate_asts[i] = Z3_mk_int(ctx_, 0, Z3_mk_bv_sort(ctx_, 1));
+        break;
+      case GateKind::kNot:
+        gate_asts[i] = Z3_mk_bvnot(ctx_, gate_asts[gate.operand0]);
+        break;
+      case GateKind::kAnd:
+        gate_asts[i] =
+            Z3_mk_bvand(ctx_, gate_asts[gate.operand0],
+                        gate_asts[gate.operand1]);
+        break;
+      case GateKind::kOr:
+        gate_asts[i] =
+            Z3_mk_bvor(ctx_, gate_asts[gate.operand0],
+                       gate_asts[gate.operand1]);
+        break;
+      case GateKind::kXor:
+        gate_asts[i] =
+            Z3_mk_bvxor(ctx_, gate_asts[gate.operand0],
+                        gate_asts[gate.operand1]);
+        break;
     }
-    default:
-      return absl::InvalidArgumentError(absl::StrFormat(
-          "Unknown AST kind: %d", static_cast<int>(ast.kind())));
   }
+  return gate_asts[function.output()];
 }
 
 absl::StatusOr<absl::flat_hash_map<std::string, Z3_ast>>
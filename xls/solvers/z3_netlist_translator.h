@@ -19,7 +19,7 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
-#include "xls/netlist/function_parser.h"
+#include "xls/netlist/cell_function.h"
 #include "xls/netlist/netlist.h"
 #include "../z3/src/api/z3.h"
 
@@ -86,7 +86,8 @@ class NetlistTranslator {
   absl::Status Translate();
   absl::Status TranslateCell(const netlist::rtl::Cell& cell);
   absl::StatusOr<Z3_ast> TranslateFunction(
-      const netlist::rtl::Cell& cell, const netlist::function::Ast ast,
+      const netlist::rtl::Cell& cell,
+      const netlist::function::CompiledFunction& function,
       const absl::flat_hash_map<std::string, Z3_ast>& state_table_values);
   absl::StatusOr<absl::flat_hash_map<std::string, Z3_ast>> TranslateStateTable(
       const netlist::rtl::Cell& cell);
@@ -12,8 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <filesystem>
 #include <numeric>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_join.h"
@@ -31,10 +33,13 @@
 #include "xls/delay_model/delay_estimators.h"
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/node_iterator.h"
+#include "xls/ir/value_helpers.h"
+#include "xls/jit/ir_jit.h"
 #include "xls/passes/bdd_query_engine.h"
 #include "xls/passes/passes.h"
 #include "xls/passes/standard_pipeline.h"
 #include "xls/scheduling/pipeline_schedule.h"
+#include "xls/tools/benchmark_timing.pb.h"
 
 // TODO(meheff): These codegen flags are duplicated from codegen_main. Might be
 // easier to wrap all the options into a proto or something codegen_main and
@@ -62,10 +67,55 @@ ABSL_FLAG(std::string, entry, "",
           "Entry function to use in lieu of the default.");
 ABSL_FLAG(std::string, delay_model, "",
           "Delay model name to use from registry.");
+ABSL_FLAG(std::string, measure, "all",
+          "Comma-separated list of metric groups to compute: 'opt' (run the "
+          "optimization pipeline and print pass stats), 'nodes' (node "
+          "breakdown by op), 'critical_path' (critical path and BDD-based "
+          "known-bits analysis), 'schedule' (scheduling and codegen stats; "
+          "also requires --clock_period_ps or --pipeline_stages), 'jit' (JIT "
+          "compile and run times), or 'all'. Unlisted groups and their "
+          "analyses (e.g. BDD construction) are skipped entirely, so e.g. "
+          "--measure=jit gives quick throughput numbers. Note that "
+          "--measure without 'opt' benchmarks the input IR as-is, without "
+          "optimizing it first.");
+ABSL_FLAG(int64_t, jit_run_iterations, 100,
+          "Number of times the JIT-compiled entry function is run with "
+          "all-zero arguments per sample when measuring JIT run time.");
+ABSL_FLAG(int64_t, jit_samples, 1,
+          "Number of repeated JIT run-time samples to take. When greater "
+          "than one, a warm-up pass is run first and the median and 95th "
+          "percentile per-call times over the samples are reported, making "
+          "the number robust against machine noise.");
+ABSL_FLAG(std::string, timings_out_path, "",
+          "Path to which per-benchmark phase timings are written as a "
+          "BenchmarkTimingsProto textproto after a suite run. Only used when "
+          "the path argument is a directory of benchmark IR files.");
+ABSL_FLAG(std::string, baseline_timings_path, "",
+          "Path of a BenchmarkTimingsProto textproto written by an earlier "
+          "suite run. If specified, a per-phase delta report against it is "
+          "printed after the suite completes.");
 
 namespace xls {
 namespace {
 
+// Returns the set of metric groups selected by --measure. 'all' expands to
+// every group.
+absl::flat_hash_set<std::string> GetMeasureGroups() {
+  absl::flat_hash_set<std::string> groups;
+  for (absl::string_view group :
+       absl::StrSplit(absl::GetFlag(FLAGS_measure), ',', absl::SkipEmpty())) {
+    if (group == "all") {
+      return {"opt", "nodes", "critical_path", "schedule", "jit"};
+    }
+    XLS_QCHECK(group == "opt" || group == "nodes" ||
+               group == "critical_path" || group == "schedule" ||
+               group == "jit")
+        << "Invalid --measure group: " << group;
+    groups.insert(std::string(group));
+  }
+  return groups;
+}
+
 std::string KnownBitString(Node* node, const QueryEngine& query_engine) {
   if (!node->GetType()->IsBits()) {
     return "?";
@@ -335,6 +385,196 @@ absl::Status PrintCodegenInfo(Function* f, const PipelineSchedule& schedule,
   return absl::OkStatus();
 }
 
+// JIT-compiles the entry function and measures its steady-state run time
+// over all-zero arguments. Each sample times --jit_run_iterations calls;
+// with --jit_samples > 1 a warm-up sample is run first (so instruction and
+// data caches are hot and the timed samples measure steady state) and the
+// median and 95th percentile per-call times are reported.
+absl::Status RunJitAndPrintStats(Function* f) {
+  absl::Time compile_start = absl::Now();
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<IrJit> jit, IrJit::Create(f));
+  std::cout << absl::StreamFormat(
+      "JIT compile time: %dms\n",
+      (absl::Now() - compile_start) / absl::Milliseconds(1));
+
+  std::vector<Value> args;
+  for (Param* param : f->params()) {
+    args.push_back(ZeroOfType(param->GetType()));
+  }
+  int64_t iterations = absl::GetFlag(FLAGS_jit_run_iterations);
+  int64_t sample_count = absl::GetFlag(FLAGS_jit_samples);
+
+  auto time_sample = [&]() -> absl::StatusOr<double> {
+    absl::Time start = absl::Now();
+    for (int64_t i = 0; i < iterations; ++i) {
+      XLS_RETURN_IF_ERROR(jit->Run(args).status());
+    }
+    return static_cast<double>((absl::Now() - start) / absl::Nanoseconds(1)) /
+           iterations;
+  };
+
+  if (sample_count <= 1) {
+    XLS_ASSIGN_OR_RETURN(double per_call_ns, time_sample());
+    std::cout << absl::StreamFormat(
+        "JIT run time: %.0fns per call (%d calls)\n", per_call_ns, iterations);
+    return absl::OkStatus();
+  }
+
+  // Warm-up sample; not recorded.
+  XLS_RETURN_IF_ERROR(time_sample().status());
+  std::vector<double> samples;
+  for (int64_t i = 0; i < sample_count; ++i) {
+    XLS_ASSIGN_OR_RETURN(double per_call_ns, time_sample());
+    samples.push_back(per_call_ns);
+  }
+  std::sort(samples.begin(), samples.end());
+  double median = samples[samples.size() / 2];
+  double p95 = samples[((samples.size() - 1) * 95) / 100];
+  std::cout << absl::StreamFormat(
+      "JIT run time: median %.0fns, p95 %.0fns per call "
+      "(%d samples x %d calls)\n",
+      median, p95, sample_count, iterations);
+  return absl::OkStatus();
+}
+
+// Runs the compiler phases over the given package and records their wall
+// times in `timing`. Used by the suite mode, where the machine-readable
+// timings rather than the printed stats are the product. Scheduling is only
+// measured if a clock period or stage count was given.
+absl::Status MeasureBenchmark(Package* package,
+                              absl::optional<int64_t> clock_period_ps,
+                              absl::optional<int64_t> pipeline_stages,
+                              BenchmarkTimingProto* timing) {
+  auto to_us = [](absl::Duration d) { return d / absl::Microseconds(1); };
+
+  absl::Time opt_start = absl::Now();
+  PassResults pass_results;
+  XLS_RETURN_IF_ERROR(CreateStandardPassPipeline()
+                          ->Run(package, PassOptions(), &pass_results)
+                          .status());
+  timing->set_optimization_us(to_us(absl::Now() - opt_start));
+
+  XLS_ASSIGN_OR_RETURN(Function * f, package->EntryFunction());
+
+  if (clock_period_ps.has_value() || pipeline_stages.has_value()) {
+    SchedulingOptions options;
+    if (clock_period_ps.has_value()) {
+      options.clock_period_ps(*clock_period_ps);
+    }
+    if (pipeline_stages.has_value()) {
+      options.pipeline_stages(*pipeline_stages);
+    }
+    const DelayEstimator* delay_estimator = &GetStandardDelayEstimator();
+    if (!absl::GetFlag(FLAGS_delay_model).empty()) {
+      XLS_ASSIGN_OR_RETURN(
+          delay_estimator, GetDelayEstimator(absl::GetFlag(FLAGS_delay_model)));
+    }
+    absl::Time schedule_start = absl::Now();
+    XLS_RETURN_IF_ERROR(
+        PipelineSchedule::Run(f, *delay_estimator, options).status());
+    timing->set_scheduling_us(to_us(absl::Now() - schedule_start));
+  }
+
+  absl::Time jit_compile_start = absl::Now();
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<IrJit> jit, IrJit::Create(f));
+  timing->set_jit_compile_us(to_us(absl::Now() - jit_compile_start));
+
+  std::vector<Value> args;
+  for (Param* param : f->params()) {
+    args.push_back(ZeroOfType(param->GetType()));
+  }
+  absl::Time jit_run_start = absl::Now();
+  for (int64_t i = 0; i < absl::GetFlag(FLAGS_jit_run_iterations); ++i) {
+    XLS_RETURN_IF_ERROR(jit->Run(args).status());
+  }
+  timing->set_jit_run_us(to_us(absl::Now() - jit_run_start));
+
+  return absl::OkStatus();
+}
+
+// Prints the per-phase timing deltas of `results` against `baseline`,
+// matching benchmarks by name.
+void PrintTimingDeltas(const BenchmarkTimingsProto& baseline,
+                       const BenchmarkTimingsProto& results) {
+  absl::flat_hash_map<std::string, const BenchmarkTimingProto*> baseline_map;
+  for (const BenchmarkTimingProto& timing : baseline.benchmarks()) {
+    baseline_map[timing.name()] = &timing;
+  }
+  auto print_delta = [](absl::string_view phase, int64_t base_us,
+                        int64_t new_us) {
+    double percent =
+        base_us == 0 ? 0.0 : 100.0 * (new_us - base_us) / base_us;
+    std::cout << absl::StreamFormat("  %-12s : %8dus -> %8dus (%+6.1f%%)\n",
+                                    phase, base_us, new_us, percent);
+  };
+  std::cout << "Deltas against baseline:" << std::endl;
+  for (const BenchmarkTimingProto& timing : results.benchmarks()) {
+    std::cout << absl::StreamFormat("[%s]\n", timing.name());
+    if (!baseline_map.contains(timing.name())) {
+      std::cout << "  not present in baseline\n";
+      continue;
+    }
+    const BenchmarkTimingProto& base = *baseline_map.at(timing.name());
+    print_delta("optimization", base.optimization_us(),
+                timing.optimization_us());
+    if (timing.has_scheduling_us()) {
+      print_delta("scheduling", base.scheduling_us(), timing.scheduling_us());
+    }
+    print_delta("jit compile", base.jit_compile_us(), timing.jit_compile_us());
+    print_delta("jit run", base.jit_run_us(), timing.jit_run_us());
+  }
+}
+
+// Measures every '.ir' file in the given directory. A benchmark which fails
+// to compile is reported and skipped so one bad entry does not take down the
+// whole regression run.
+absl::Status RunSuite(absl::string_view dir_path,
+                      absl::optional<int64_t> clock_period_ps,
+                      absl::optional<int64_t> pipeline_stages) {
+  XLS_ASSIGN_OR_RETURN(std::vector<std::filesystem::path> entries,
+                       GetDirectoryEntries(std::string(dir_path)));
+  std::sort(entries.begin(), entries.end());
+
+  BenchmarkTimingsProto results;
+  for (const std::filesystem::path& entry : entries) {
+    if (entry.extension() != ".ir") {
+      continue;
+    }
+    BenchmarkTimingProto timing;
+    timing.set_name(entry.stem().string());
+    auto measure = [&]() -> absl::Status {
+      XLS_ASSIGN_OR_RETURN(std::string contents, GetFileContents(entry));
+      XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(contents, entry.string()));
+      return MeasureBenchmark(package.get(), clock_period_ps, pipeline_stages,
+                              &timing);
+    };
+    absl::Status status = measure();
+    if (!status.ok()) {
+      XLS_LOG(WARNING) << "Skipping benchmark " << entry << ": " << status;
+      continue;
+    }
+    std::cout << absl::StreamFormat(
+        "[%s] optimization: %dus, scheduling: %dus, jit compile: %dus, jit "
+        "run: %dus\n",
+        timing.name(), timing.optimization_us(), timing.scheduling_us(),
+        timing.jit_compile_us(), timing.jit_run_us());
+    *results.add_benchmarks() = timing;
+  }
+
+  if (!absl::GetFlag(FLAGS_timings_out_path).empty()) {
+    XLS_RETURN_IF_ERROR(
+        SetTextProtoFile(absl::GetFlag(FLAGS_timings_out_path), results));
+  }
+  if (!absl::GetFlag(FLAGS_baseline_timings_path).empty()) {
+    BenchmarkTimingsProto baseline;
+    XLS_RETURN_IF_ERROR(ParseTextProtoFile(
+        absl::GetFlag(FLAGS_baseline_timings_path), &baseline));
+    PrintTimingDeltas(baseline, results);
+  }
+  return absl::OkStatus();
+}
+
 absl::Status RealMain(absl::string_view path,
                       absl::optional<int64_t> clock_period_ps,
                       absl::optional<int64_t> pipeline_stages,
@@ -349,11 +589,26 @@ absl::Status RealMain(absl::string_view path,
                                       contents, absl::GetFlag(FLAGS_entry)));
   }
 
-  XLS_RETURN_IF_ERROR(RunOptimizationAndPrintStats(package.get()));
+  absl::flat_hash_set<std::string> groups = GetMeasureGroups();
+  if (groups.contains("opt")) {
+    XLS_RETURN_IF_ERROR(RunOptimizationAndPrintStats(package.get()));
+  }
   XLS_ASSIGN_OR_RETURN(Function * f, package->EntryFunction());
-  BddQueryEngine query_engine(BddFunction::kDefaultPathLimit);
-  XLS_RETURN_IF_ERROR(query_engine.Populate(f).status());
-  PrintNodeBreakdown(f);
+
+  // The BDD query engine is expensive to populate; build it lazily, only if
+  // a selected metric group actually consults it.
+  absl::optional<BddQueryEngine> query_engine;
+  auto get_query_engine = [&]() -> absl::StatusOr<BddQueryEngine*> {
+    if (!query_engine.has_value()) {
+      query_engine.emplace(BddFunction::kDefaultPathLimit);
+      XLS_RETURN_IF_ERROR(query_engine->Populate(f).status());
+    }
+    return &query_engine.value();
+  };
+
+  if (groups.contains("nodes")) {
+    PrintNodeBreakdown(f);
+  }
 
   absl::optional<int64_t> effective_clock_period_ps;
   if (clock_period_ps.has_value()) {
@@ -372,16 +627,26 @@ absl::Status RealMain(absl::string_view path,
                          GetDelayEstimator(absl::GetFlag(FLAGS_delay_model)));
   }
   const auto& delay_estimator = *pdelay_estimator;
-  XLS_RETURN_IF_ERROR(PrintCriticalPath(f, query_engine, delay_estimator,
-                                        effective_clock_period_ps));
 
-  if (clock_period_ps.has_value() || pipeline_stages.has_value()) {
+  if (groups.contains("critical_path")) {
+    XLS_ASSIGN_OR_RETURN(BddQueryEngine * engine, get_query_engine());
+    XLS_RETURN_IF_ERROR(PrintCriticalPath(f, *engine, delay_estimator,
+                                          effective_clock_period_ps));
+  }
+
+  if (groups.contains("schedule") &&
+      (clock_period_ps.has_value() || pipeline_stages.has_value())) {
     XLS_ASSIGN_OR_RETURN(
         PipelineSchedule schedule,
         ScheduleAndPrintStats(package.get(), delay_estimator, clock_period_ps,
                               pipeline_stages, clock_margin_percent));
-    XLS_RETURN_IF_ERROR(PrintCodegenInfo(f, schedule, query_engine,
-                                         delay_estimator, clock_period_ps));
+    XLS_ASSIGN_OR_RETURN(BddQueryEngine * engine, get_query_engine());
+    XLS_RETURN_IF_ERROR(PrintCodegenInfo(f, schedule, *engine, delay_estimator,
+                                         clock_period_ps));
+  }
+
+  if (groups.contains("jit")) {
+    XLS_RETURN_IF_ERROR(RunJitAndPrintStats(f));
   }
   return absl::OkStatus();
 }
@@ -410,6 +675,13 @@ int main(int argc, char** argv) {
   if (absl::GetFlag(FLAGS_clock_margin_percent) > 0) {
     clock_margin_percent = absl::GetFlag(FLAGS_clock_margin_percent);
   }
+  if (std::filesystem::is_directory(
+          std::filesystem::path(positional_arguments[0]))) {
+    // Suite mode: measure every benchmark IR file in the directory.
+    XLS_QCHECK_OK(xls::RunSuite(positional_arguments[0], clock_period_ps,
+                                pipeline_stages));
+    return EXIT_SUCCESS;
+  }
   XLS_QCHECK_OK(xls::RealMain(positional_arguments[0], clock_period_ps,
                               pipeline_stages, clock_margin_percent));
   return EXIT_SUCCESS;
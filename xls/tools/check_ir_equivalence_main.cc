@@ -12,7 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <memory>
 #include <thread>  // NOLINT(build/c++11)
+#include <vector>
 
 #include "absl/base/internal/sysinfo.h"
 #include "absl/flags/flag.h"
@@ -25,6 +28,7 @@
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/package.h"
 #include "xls/passes/dce_pass.h"
@@ -56,6 +60,13 @@ ABSL_FLAG(std::string, function, "",
           "and check an entry function for the package.");
 ABSL_FLAG(absl::Duration, timeout, absl::InfiniteDuration(),
           "How long to wait for any proof to complete.");
+ABSL_FLAG(int64_t, bits_per_slice, 0,
+          "When positive, partitions the proof by output bit: the flattened "
+          "function output is split into slices of this many bits, and each "
+          "slice is proved in its own solver on a worker thread. Wide "
+          "datapaths whose individual output bits have small logic cones "
+          "prove dramatically faster this way. The default (0) proves the "
+          "whole output in one monolithic query.");
 
 namespace xls {
 
@@ -76,9 +87,119 @@ absl::StatusOr<Z3_ast> CreateComparisonFunction(
   return Z3_mk_eq(ctx, result1, result2);
 }
 
+// The outcome of proving one slice of the output bits.
+struct SliceResult {
+  Z3_lbool satisfiable;
+  std::string message;
+};
+
+// Proves equivalence of output bits [start, limit) of the two functions.
+// Each slice gets its own Z3 context (and thus its own translation), since a
+// context may only be used by one thread at a time - this is what lets slices
+// be proved concurrently.
+absl::StatusOr<SliceResult> ProveSlice(Function* f0, Function* f1,
+                                       int64_t start, int64_t limit,
+                                       absl::Duration timeout) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<IrTranslator> translator0,
+                       IrTranslator::CreateAndTranslate(f0));
+  Z3_context ctx = translator0->ctx();
+  std::vector<Z3_ast> z3_params;
+  for (const Param* param : f0->params()) {
+    z3_params.push_back(translator0->GetTranslation(param));
+  }
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<IrTranslator> translator1,
+      IrTranslator::CreateAndTranslate(ctx, f1, absl::MakeSpan(z3_params)));
+  translator0->SetTimeout(timeout);
+
+  std::vector<Z3_ast> bits0 = translator0->FlattenValue(
+      f0->return_value()->GetType(), translator0->GetReturnNode());
+  std::vector<Z3_ast> bits1 = translator1->FlattenValue(
+      f1->return_value()->GetType(), translator1->GetReturnNode());
+  XLS_RET_CHECK_EQ(bits0.size(), bits1.size());
+
+  std::vector<Z3_ast> eq_bits;
+  eq_bits.reserve(limit - start);
+  for (int64_t i = start; i < limit; i++) {
+    eq_bits.push_back(Z3_mk_eq(ctx, bits0[i], bits1[i]));
+  }
+  Z3_ast slice_equal = Z3_mk_and(ctx, eq_bits.size(), eq_bits.data());
+
+  // Each slice runs on its own worker thread, so keep the solvers themselves
+  // single-threaded.
+  Z3_solver solver = solvers::z3::CreateSolver(ctx, 1);
+  Z3_solver_assert(ctx, solver, Z3_mk_eq(ctx, Z3_mk_false(ctx), slice_equal));
+
+  SliceResult result;
+  result.satisfiable = Z3_solver_check(ctx, solver);
+  result.message =
+      solvers::z3::SolverResultToString(ctx, solver, result.satisfiable);
+  Z3_solver_dec_ref(ctx, solver);
+  return result;
+}
+
+// Partitions the comparison of the two functions into independent per-slice
+// miters, proves them in parallel, and aggregates the results (including any
+// per-slice counterexamples).
+absl::Status RunSlicedProofs(const std::vector<Function*>& functions,
+                             absl::Duration timeout, int64_t bits_per_slice) {
+  int64_t bit_count =
+      functions[0]->return_value()->GetType()->GetFlatBitCount();
+  XLS_RET_CHECK_EQ(
+      functions[1]->return_value()->GetType()->GetFlatBitCount(), bit_count);
+  int64_t num_slices = (bit_count + bits_per_slice - 1) / bits_per_slice;
+  XLS_RET_CHECK_GT(num_slices, 0);
+
+  std::vector<SliceResult> results(num_slices);
+  int64_t num_threads = std::min<int64_t>(
+      std::max<int64_t>(std::thread::hardware_concurrency(), 1), num_slices);
+  auto run_slices = [&](int64_t worker) -> absl::Status {
+    for (int64_t slice = worker; slice < num_slices; slice += num_threads) {
+      int64_t start = slice * bits_per_slice;
+      int64_t limit = std::min(start + bits_per_slice, bit_count);
+      XLS_ASSIGN_OR_RETURN(
+          results[slice],
+          ProveSlice(functions[0], functions[1], start, limit, timeout));
+    }
+    return absl::OkStatus();
+  };
+
+  std::vector<absl::Status> statuses(num_threads, absl::OkStatus());
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int64_t i = 1; i < num_threads; i++) {
+    threads.push_back(std::make_unique<Thread>(
+        [&run_slices, &statuses, i]() { statuses[i] = run_slices(i); }));
+  }
+  statuses[0] = run_slices(0);
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+  for (const absl::Status& status : statuses) {
+    XLS_RETURN_IF_ERROR(status);
+  }
+
+  bool equivalent = true;
+  for (int64_t slice = 0; slice < num_slices; slice++) {
+    if (results[slice].satisfiable == Z3_L_FALSE) {
+      continue;
+    }
+    equivalent = false;
+    int64_t start = slice * bits_per_slice;
+    int64_t limit = std::min(start + bits_per_slice, bit_count);
+    std::cout << "Output bits [" << start << ", " << limit
+              << "):" << std::endl
+              << results[slice].message << std::endl;
+  }
+  if (equivalent) {
+    std::cout << "Verified equivalent (" << num_slices << " slices)"
+              << std::endl;
+  }
+  return absl::OkStatus();
+}
+
 absl::Status RealMain(const std::vector<absl::string_view>& ir_paths,
                       const std::string& entry_function,
-                      absl::Duration timeout) {
+                      absl::Duration timeout, int64_t bits_per_slice) {
   std::vector<std::unique_ptr<Package>> packages;
   for (const auto ir_path : ir_paths) {
     XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(ir_path));
@@ -122,6 +243,10 @@ absl::Status RealMain(const std::vector<absl::string_view>& ir_paths,
     }
   }
 
+  if (bits_per_slice > 0) {
+    return RunSlicedProofs(functions, timeout, bits_per_slice);
+  }
+
   std::vector<std::unique_ptr<IrTranslator>> translators;
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<IrTranslator> translator,
                        IrTranslator::CreateAndTranslate(functions[0]));
@@ -171,5 +296,6 @@ int main(int argc, char** argv) {
       xls::InitXls(kUsage, argc, argv);
   XLS_QCHECK_EQ(positional_args.size(), 2) << "Two IR files must be specified!";
   XLS_QCHECK_OK(xls::RealMain(positional_args, absl::GetFlag(FLAGS_function),
-                              absl::GetFlag(FLAGS_timeout)));
+                              absl::GetFlag(FLAGS_timeout),
+                              absl::GetFlag(FLAGS_bits_per_slice)));
 }
@@ -12,10 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fstream>
+#include <iostream>
+#include <ostream>
+
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "xls/codegen/combinational_generator.h"
 #include "xls/codegen/module_signature.pb.h"
 #include "xls/codegen/pipeline_generator.h"
@@ -27,8 +32,11 @@
 #include "xls/delay_model/delay_estimator.h"
 #include "xls/delay_model/delay_estimators.h"
 #include "xls/ir/ir_parser.h"
+#include "xls/ir/ir_serializer.h"
+#include "xls/passes/pass_base.h"
 #include "xls/passes/standard_pipeline.h"
 #include "xls/scheduling/pipeline_schedule.h"
+#include "xls/scheduling/schedule_cache.h"
 
 const char kUsage[] = R"(
 Generates Verilog RTL from a given IR file. Writes a Verilog file and a module
@@ -48,15 +56,35 @@ Emit a feed-forward pipelined module:
 ABSL_FLAG(int64_t, clock_period_ps, 0, "Target clock period, in picoseconds.");
 ABSL_FLAG(int64_t, pipeline_stages, 0,
           "The number of stages in the generated pipeline.");
+ABSL_FLAG(std::string, scheduling_strategy, "min_cut",
+          "The strategy to use when scheduling the pipeline. Valid values: "
+          "min_cut (minimize pipeline registers via a per-stage min-cut), "
+          "sdc (minimize pipeline registers via a system of difference "
+          "constraints; scales to larger functions), asap (schedule each node "
+          "as early as possible).");
 ABSL_FLAG(std::string, delay_model, "",
           "Delay model name to use from registry.");
 ABSL_FLAG(
     std::string, output_verilog_path, "",
     "Specific output path for the Verilog generated. If not specified then "
     "Verilog is written to stdout.");
+ABSL_FLAG(bool, stream_verilog, false,
+          "If true, stream the Verilog to --output_verilog_path (or stdout) "
+          "as it is emitted rather than materializing the entire text in "
+          "memory first. Useful for very large designs.");
+ABSL_FLAG(std::string, pass_profile_path, "",
+          "If specified, write a machine-readable (JSON) profile of the "
+          "codegen pass pipeline to the given file. The profile contains one "
+          "record per pass invocation with the pass name, whether the IR "
+          "changed, wall time, block node-count delta, and peak RSS delta.");
 ABSL_FLAG(std::string, output_schedule_path, "",
           "Specific output path for the generated pipeline schedule. "
           "If not specified, then no schedule is output.");
+ABSL_FLAG(std::string, schedule_cache_dir, "",
+          "If specified, cache pipeline schedules in the given directory, "
+          "keyed by the entry function's IR text, the scheduling options and "
+          "the delay model. Re-runs over an unchanged function load the "
+          "schedule from the cache and skip scheduling entirely.");
 ABSL_FLAG(
     std::string, output_signature_path, "",
     "Specific output path for the module signature. If not specified then "
@@ -70,6 +98,9 @@ ABSL_FLAG(std::string, top_level_proc, "",
 ABSL_FLAG(std::string, generator, "pipeline",
           "The generator to use when emitting the device function. Valid "
           "values: pipeline, combinational.");
+ABSL_FLAG(std::string, input_format, "text",
+          "Format of the input IR; one of 'text' or 'binary' (see "
+          "xls/ir/ir_serializer.h).");
 ABSL_FLAG(
     std::string, input_valid_signal, "",
     "If specified, the emitted module will use an external \"valid\" signal "
@@ -137,7 +168,20 @@ absl::StatusOr<SchedulingOptions> SetupSchedulingOptions() {
     return absl::InternalError("Scheduling only supported in pipeline mode.");
   }
 
-  SchedulingOptions scheduling_options;
+  SchedulingStrategy strategy;
+  const std::string strategy_string = absl::GetFlag(FLAGS_scheduling_strategy);
+  if (strategy_string == "min_cut") {
+    strategy = SchedulingStrategy::MINIMIZE_REGISTERS;
+  } else if (strategy_string == "sdc") {
+    strategy = SchedulingStrategy::SDC_MINIMIZE_REGISTERS;
+  } else if (strategy_string == "asap") {
+    strategy = SchedulingStrategy::ASAP;
+  } else {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Invalid scheduling strategy: %s", strategy_string));
+  }
+
+  SchedulingOptions scheduling_options(strategy);
 
   if (absl::GetFlag(FLAGS_pipeline_stages) != 0) {
     scheduling_options.pipeline_stages(absl::GetFlag(FLAGS_pipeline_stages));
@@ -230,14 +274,40 @@ absl::Status RealMain(absl::string_view ir_path, absl::string_view verilog_path,
   }
 
   XLS_ASSIGN_OR_RETURN(std::string ir_contents, GetFileContents(ir_path));
-  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> p,
-                       Parser::ParsePackage(ir_contents, ir_path));
+  std::unique_ptr<Package> p;
+  if (absl::GetFlag(FLAGS_input_format) == "binary") {
+    XLS_ASSIGN_OR_RETURN(p, DeserializePackage(ir_contents));
+  } else {
+    XLS_ASSIGN_OR_RETURN(p, Parser::ParsePackage(ir_contents, ir_path));
+  }
   verilog::ModuleGeneratorResult result;
 
   XLS_ASSIGN_OR_RETURN(FunctionBase * main, FindEntry(p.get()));
   XLS_ASSIGN_OR_RETURN(verilog::CodegenOptions codegen_options,
                        GetCodegenOptions());
 
+  // With --stream_verilog the generators write the Verilog through this
+  // stream as it is emitted instead of materializing it in
+  // result.verilog_text.
+  std::ofstream verilog_file_stream;
+  std::ostream* verilog_stream = nullptr;
+  if (absl::GetFlag(FLAGS_stream_verilog)) {
+    if (verilog_path.empty()) {
+      verilog_stream = &std::cout;
+    } else {
+      verilog_file_stream.open(std::string(verilog_path));
+      if (!verilog_file_stream.is_open()) {
+        return absl::UnavailableError(absl::StrFormat(
+            "Unable to open Verilog output file: %s", verilog_path));
+      }
+      verilog_stream = &verilog_file_stream;
+    }
+  }
+
+  // Per-pass invocation records of the codegen pass pipeline; written out as
+  // JSON if --pass_profile_path is given.
+  PassResults pass_results;
+
   if (absl::GetFlag(FLAGS_generator) == "pipeline") {
     XLS_QCHECK(absl::GetFlag(FLAGS_pipeline_stages) != 0 ||
                absl::GetFlag(FLAGS_clock_period_ps) != 0)
@@ -247,19 +317,38 @@ absl::Status RealMain(absl::string_view ir_path, absl::string_view verilog_path,
                          SetupSchedulingOptions());
     XLS_ASSIGN_OR_RETURN(const DelayEstimator* delay_estimator,
                          SetupDelayEstimator());
-    XLS_ASSIGN_OR_RETURN(
-        PipelineSchedule schedule,
-        RunSchedulingPipeline(main, scheduling_options, delay_estimator));
+
+    absl::optional<ScheduleCache> schedule_cache;
+    std::string schedule_cache_key;
+    absl::optional<PipelineSchedule> schedule;
+    if (!absl::GetFlag(FLAGS_schedule_cache_dir).empty() &&
+        main->IsFunction()) {
+      schedule_cache.emplace(absl::GetFlag(FLAGS_schedule_cache_dir));
+      schedule_cache_key = ScheduleCache::MakeCacheKey(
+          main, scheduling_options, absl::GetFlag(FLAGS_delay_model));
+      schedule =
+          schedule_cache->Lookup(main->AsFunctionOrDie(), schedule_cache_key);
+    }
+    if (!schedule.has_value()) {
+      XLS_ASSIGN_OR_RETURN(
+          schedule,
+          RunSchedulingPipeline(main, scheduling_options, delay_estimator));
+      if (schedule_cache.has_value()) {
+        schedule_cache->Insert(schedule_cache_key, *schedule);
+      }
+    }
 
     XLS_ASSIGN_OR_RETURN(
-        result, verilog::ToPipelineModuleText(schedule, main, codegen_options));
+        result, verilog::ToPipelineModuleText(*schedule, main, codegen_options,
+                                              verilog_stream, &pass_results));
 
     if (!schedule_path.empty()) {
-      XLS_RETURN_IF_ERROR(SetTextProtoFile(schedule_path, schedule.ToProto()));
+      XLS_RETURN_IF_ERROR(SetTextProtoFile(schedule_path, schedule->ToProto()));
     }
   } else if (absl::GetFlag(FLAGS_generator) == "combinational") {
     XLS_ASSIGN_OR_RETURN(
-        result, verilog::GenerateCombinationalModule(main, codegen_options));
+        result, verilog::GenerateCombinationalModule(
+                    main, codegen_options, verilog_stream, &pass_results));
   } else {
     XLS_LOG(QFATAL) << absl::StreamFormat(
         "Invalid value for --generator: %s. Expected 'pipeline' or "
@@ -271,7 +360,19 @@ absl::Status RealMain(absl::string_view ir_path, absl::string_view verilog_path,
     XLS_RETURN_IF_ERROR(
         SetTextProtoFile(signature_path, result.signature.proto()));
   }
-  if (verilog_path.empty()) {
+  if (!absl::GetFlag(FLAGS_pass_profile_path).empty()) {
+    XLS_RETURN_IF_ERROR(
+        SetFileContents(absl::GetFlag(FLAGS_pass_profile_path),
+                        PassProfileToJson(pass_results)));
+  }
+  if (verilog_stream != nullptr) {
+    // The Verilog was already written as it was emitted.
+    verilog_stream->flush();
+    if (verilog_file_stream.is_open() && !verilog_file_stream.good()) {
+      return absl::UnavailableError(absl::StrFormat(
+          "Error writing Verilog output file: %s", verilog_path));
+    }
+  } else if (verilog_path.empty()) {
     std::cout << result.verilog_text;
   } else {
     XLS_RETURN_IF_ERROR(SetFileContents(verilog_path, result.verilog_text));
@@ -0,0 +1,275 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/codegen/combinational_generator.h"
+#include "xls/codegen/module_signature.h"
+#include "xls/codegen/pipeline_generator.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/init_xls.h"
+#include "xls/common/logging/logging.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/delay_model/delay_estimator.h"
+#include "xls/delay_model/delay_estimators.h"
+#include "xls/dslx/command_line_utils.h"
+#include "xls/dslx/default_dslx_stdlib_path.h"
+#include "xls/dslx/import_data.h"
+#include "xls/dslx/ir_converter.h"
+#include "xls/dslx/mangle.h"
+#include "xls/dslx/parse_and_typecheck.h"
+#include "xls/ir/function.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+#include "xls/scheduling/pipeline_schedule.h"
+#include "xls/tools/opt.h"
+
+const char kUsage[] = R"(
+Runs the full compilation pipeline -- parse/convert, optimize, schedule, and
+codegen -- in a single process with the IR kept in memory between phases.
+Equivalent to running ir_converter_main, opt_main and codegen_main in
+sequence without serializing the IR to text between the steps. Wall time
+spent in each phase is logged on completion.
+
+Example invocations:
+
+Compile a DSLX file to a pipelined Verilog module:
+   compile_main --entry=main --pipeline_stages=5 DSLX_FILE
+
+Compile an IR file to a combinational module:
+   compile_main --generator=combinational IR_FILE
+)";
+
+ABSL_FLAG(std::string, input_format, "",
+          "Format of the input file; one of 'dslx' or 'ir'. If empty, 'dslx' "
+          "is inferred for files with a '.x' extension and 'ir' otherwise.");
+ABSL_FLAG(std::string, entry, "",
+          "Entry function to compile. For DSLX input this may be the DSL "
+          "function name; for IR input it is the (mangled) IR function name. "
+          "If empty, the package entry function is used.");
+ABSL_FLAG(std::string, stdlib_path, xls::kDefaultDslxStdlibPath,
+          "Path to DSLX standard library files.");
+ABSL_FLAG(std::string, dslx_path, "",
+          "Additional paths to search for DSLX modules (colon delimited).");
+ABSL_FLAG(int64_t, opt_level, xls::kMaxOptLevel, "Optimization level.");
+ABSL_FLAG(std::string, generator, "pipeline",
+          "The generator to use when emitting the device function. Valid "
+          "values: pipeline, combinational.");
+ABSL_FLAG(int64_t, pipeline_stages, 0,
+          "The number of stages in the generated pipeline.");
+ABSL_FLAG(int64_t, clock_period_ps, 0, "Target clock period, in picoseconds.");
+ABSL_FLAG(std::string, delay_model, "unit",
+          "Delay model name to use from registry.");
+ABSL_FLAG(std::string, module_name, "",
+          "Explicit name to use for the generated module; if not provided the "
+          "mangled IR function name is used.");
+ABSL_FLAG(bool, use_system_verilog, true,
+          "If true, emit SystemVerilog otherwise emit Verilog.");
+ABSL_FLAG(
+    std::string, output_verilog_path, "",
+    "Specific output path for the Verilog generated. If not specified then "
+    "Verilog is written to stdout.");
+ABSL_FLAG(
+    std::string, output_signature_path, "",
+    "Specific output path for the module signature. If not specified then "
+    "no module signature is written.");
+
+namespace xls {
+namespace {
+
+// Parses the input as DSLX and converts it to an IR package. `entry`, if
+// present, is resolved against both its literal and mangled names and
+// rewritten to the IR function name so later phases can look it up.
+absl::StatusOr<std::unique_ptr<Package>> ConvertDslxToPackage(
+    absl::string_view path, absl::string_view text, std::string* entry) {
+  std::vector<std::filesystem::path> dslx_paths;
+  for (absl::string_view dslx_path :
+       absl::StrSplit(absl::GetFlag(FLAGS_dslx_path), ':', absl::SkipEmpty())) {
+    dslx_paths.push_back(std::filesystem::path(dslx_path));
+  }
+  dslx::ImportData import_data(absl::GetFlag(FLAGS_stdlib_path), dslx_paths);
+
+  XLS_ASSIGN_OR_RETURN(std::string module_name, dslx::PathToName(path));
+  XLS_ASSIGN_OR_RETURN(
+      dslx::TypecheckedModule typechecked,
+      dslx::ParseAndTypecheck(text, path, module_name, &import_data));
+
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<Package> package,
+      dslx::ConvertModuleToPackage(typechecked.module, &import_data,
+                                   dslx::ConvertOptions{},
+                                   /*traverse_tests=*/false));
+
+  if (!entry->empty() && !package->HasFunctionWithName(*entry)) {
+    // The user gave the DSL name; translate it to the IR name.
+    XLS_ASSIGN_OR_RETURN(
+        std::string mangled_name,
+        dslx::MangleDslxName(module_name, *entry,
+                             dslx::CallingConvention::kTypical));
+    if (package->HasFunctionWithName(mangled_name)) {
+      *entry = mangled_name;
+    }
+  }
+
+  return package;
+}
+
+absl::StatusOr<Function*> FindEntry(Package* package,
+                                    absl::string_view entry) {
+  if (entry.empty()) {
+    return package->EntryFunction();
+  }
+  return package->GetFunction(entry);
+}
+
+absl::Status RealMain(absl::string_view input_path) {
+  if (input_path == "-") {
+    input_path = "/dev/stdin";
+  }
+
+  std::string input_format = absl::GetFlag(FLAGS_input_format);
+  if (input_format.empty()) {
+    input_format = absl::EndsWith(input_path, ".x") ? "dslx" : "ir";
+  }
+  if (input_format != "dslx" && input_format != "ir") {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Invalid --input_format value: %s", input_format));
+  }
+
+  XLS_ASSIGN_OR_RETURN(std::string input_text, GetFileContents(input_path));
+
+  std::string entry = absl::GetFlag(FLAGS_entry);
+
+  // Phase 1: parse the input (converting from DSLX if necessary).
+  absl::Time parse_start = absl::Now();
+  std::unique_ptr<Package> package;
+  if (input_format == "dslx") {
+    XLS_ASSIGN_OR_RETURN(package,
+                         ConvertDslxToPackage(input_path, input_text, &entry));
+  } else {
+    XLS_ASSIGN_OR_RETURN(package,
+                         Parser::ParsePackage(input_text, input_path));
+  }
+  absl::Duration parse_time = absl::Now() - parse_start;
+  XLS_LOG(INFO) << "Phase parse completed in " << parse_time;
+
+  // Phase 2: optimize, with the package kept in memory.
+  absl::Time opt_start = absl::Now();
+  tools::OptOptions opt_options;
+  opt_options.opt_level = absl::GetFlag(FLAGS_opt_level);
+  XLS_RETURN_IF_ERROR(tools::OptimizePackage(package.get(), opt_options));
+  absl::Duration opt_time = absl::Now() - opt_start;
+  XLS_LOG(INFO) << "Phase optimize completed in " << opt_time;
+
+  XLS_ASSIGN_OR_RETURN(Function * main, FindEntry(package.get(), entry));
+
+  verilog::ModuleGeneratorResult result;
+  absl::Duration schedule_time;
+  absl::Duration codegen_time;
+  if (absl::GetFlag(FLAGS_generator) == "combinational") {
+    // Phase 3/4: codegen only; no schedule is needed for a combinational
+    // module.
+    absl::Time codegen_start = absl::Now();
+    XLS_ASSIGN_OR_RETURN(
+        result, verilog::GenerateCombinationalModule(
+                    main, absl::GetFlag(FLAGS_use_system_verilog),
+                    absl::GetFlag(FLAGS_module_name)));
+    codegen_time = absl::Now() - codegen_start;
+  } else if (absl::GetFlag(FLAGS_generator) == "pipeline") {
+    // Phase 3: schedule.
+    absl::Time schedule_start = absl::Now();
+    XLS_ASSIGN_OR_RETURN(DelayEstimator * delay_estimator,
+                         GetDelayEstimator(absl::GetFlag(FLAGS_delay_model)));
+    SchedulingOptions scheduling_options;
+    if (absl::GetFlag(FLAGS_pipeline_stages) != 0) {
+      scheduling_options.pipeline_stages(absl::GetFlag(FLAGS_pipeline_stages));
+    }
+    if (absl::GetFlag(FLAGS_clock_period_ps) != 0) {
+      scheduling_options.clock_period_ps(absl::GetFlag(FLAGS_clock_period_ps));
+    }
+    XLS_ASSIGN_OR_RETURN(
+        PipelineSchedule schedule,
+        PipelineSchedule::Run(main, *delay_estimator, scheduling_options));
+    schedule_time = absl::Now() - schedule_start;
+    XLS_LOG(INFO) << "Phase schedule completed in " << schedule_time;
+
+    // Phase 4: codegen.
+    absl::Time codegen_start = absl::Now();
+    verilog::CodegenOptions codegen_options = verilog::BuildPipelineOptions();
+    codegen_options.use_system_verilog(
+        absl::GetFlag(FLAGS_use_system_verilog));
+    if (!absl::GetFlag(FLAGS_module_name).empty()) {
+      codegen_options.module_name(absl::GetFlag(FLAGS_module_name));
+    }
+    XLS_ASSIGN_OR_RETURN(result, verilog::ToPipelineModuleText(
+                                     schedule, main, codegen_options));
+    codegen_time = absl::Now() - codegen_start;
+  } else {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Invalid --generator value: %s", absl::GetFlag(FLAGS_generator)));
+  }
+  XLS_LOG(INFO) << "Phase codegen completed in " << codegen_time;
+
+  if (!absl::GetFlag(FLAGS_output_signature_path).empty()) {
+    XLS_RETURN_IF_ERROR(
+        SetTextProtoFile(absl::GetFlag(FLAGS_output_signature_path),
+                         result.signature.proto()));
+  }
+
+  if (absl::GetFlag(FLAGS_output_verilog_path).empty()) {
+    std::cout << result.verilog_text;
+  } else {
+    XLS_RETURN_IF_ERROR(SetFileContents(
+        absl::GetFlag(FLAGS_output_verilog_path), result.verilog_text));
+  }
+
+  XLS_LOG(INFO) << absl::StreamFormat(
+      "Total compile time %s (parse %s, optimize %s, schedule %s, codegen "
+      "%s)",
+      absl::FormatDuration(parse_time + opt_time + schedule_time +
+                           codegen_time),
+      absl::FormatDuration(parse_time), absl::FormatDuration(opt_time),
+      absl::FormatDuration(schedule_time), absl::FormatDuration(codegen_time));
+
+  return absl::OkStatus();
+}
+
+}  // namespace
+}  // namespace xls
+
+int main(int argc, char** argv) {
+  std::vector<absl::string_view> positional_arguments =
+      xls::InitXls(kUsage, argc, argv);
+
+  if (positional_arguments.size() != 1) {
+    XLS_LOG(QFATAL) << absl::StreamFormat(
+        "Expected invocation: %s INPUT_FILE", argv[0]);
+  }
+
+  XLS_QCHECK_OK(xls::RealMain(positional_arguments[0]));
+  return EXIT_SUCCESS;
+}
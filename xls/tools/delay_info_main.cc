@@ -61,12 +61,16 @@ absl::Status RealMain(absl::string_view input_path) {
     input_path = "/dev/stdin";
   }
   XLS_ASSIGN_OR_RETURN(std::string ir, GetFileContents(input_path));
-  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> p,
-                       Parser::ParsePackage(ir, input_path));
+  std::unique_ptr<Package> p;
   Function* function;
   if (absl::GetFlag(FLAGS_entry).empty()) {
+    XLS_ASSIGN_OR_RETURN(p, Parser::ParsePackage(ir, input_path));
     XLS_ASSIGN_OR_RETURN(function, p->EntryFunction());
   } else {
+    // Only the named function (and its callees) is analyzed, so skip parsing
+    // the rest of the package.
+    XLS_ASSIGN_OR_RETURN(p, Parser::ParsePackageForFunction(
+                                 ir, absl::GetFlag(FLAGS_entry), input_path));
     XLS_ASSIGN_OR_RETURN(function, p->GetFunction(absl::GetFlag(FLAGS_entry)));
   }
 
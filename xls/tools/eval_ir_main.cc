@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <random>
 
 #include "absl/flags/flag.h"
@@ -26,6 +27,7 @@
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/dslx/default_dslx_stdlib_path.h"
 #include "xls/dslx/ir_converter.h"
 #include "xls/dslx/mangle.h"
@@ -33,8 +35,11 @@
 #include "xls/interpreter/function_interpreter.h"
 #include "xls/interpreter/ir_interpreter.h"
 #include "xls/interpreter/random_value.h"
+#include "xls/ir/bit_push_buffer.h"
 #include "xls/ir/ir_parser.h"
 #include "xls/jit/ir_jit.h"
+#include "xls/interpreter/bytecode_interpreter.h"
+#include "xls/jit/jit_object_cache.h"
 #include "xls/passes/passes.h"
 #include "xls/passes/standard_pipeline.h"
 
@@ -82,6 +87,15 @@ Evaluate IR after every optimization pass:
 Evaluate IR using the JIT and with the interpreter and compare the results:
 
    eval_ir_main --test_llvm_jit --random_inputs=100  IR_FILE
+
+Differentially compare the JIT against the interpreter over a large batch,
+with the interpreter running in 8 parallel shards:
+
+   eval_ir_main --differential_shards=8 --random_inputs=100000 IR_FILE
+
+Evaluate a large batch of random inputs with 16 worker threads:
+
+   eval_ir_main --threads=16 --random_inputs=1000000 IR_FILE
 )";
 
 ABSL_FLAG(std::string, entry, "", "Entry function name to evaluate.");
@@ -112,12 +126,37 @@ ABSL_FLAG(
     "When specified with --optimize_ir, run evaluation after each pass. "
     "A non-zero error status is returned if any of the results do not match.");
 ABSL_FLAG(bool, use_llvm_jit, true, "Use the LLVM IR JIT for execution.");
+ABSL_FLAG(bool, use_bytecode_interpreter, false,
+          "If true and --use_llvm_jit is false, evaluate using the bytecode "
+          "interpreter: the function is compiled once into a linear bytecode "
+          "with pre-resolved operands and executed with a tight dispatch "
+          "loop. Faster than the tree-walking interpreter and much cheaper "
+          "to set up than the JIT.");
 ABSL_FLAG(bool, test_llvm_jit, false,
           "If true, then run the JIT and compare the results against the "
           "interpereter.");
+ABSL_FLAG(int64_t, differential_shards, 0,
+          "If non-zero, run a batched differential comparison of the JIT "
+          "against the interpreter: the input batch is generated once, the "
+          "JIT evaluates it on the main thread while the interpreter "
+          "evaluates it concurrently in this many parallel shards, and the "
+          "flattened output bytes are compared per sample. Unlike "
+          "--test_llvm_jit, individual results are not printed. Cannot be "
+          "used with --optimize_ir or expected values.");
+ABSL_FLAG(int64_t, threads, 0,
+          "If greater than one, evaluation samples are sharded across this "
+          "many worker threads, each with its own JIT or interpreter "
+          "instance. Results and any mismatch reports are emitted in input "
+          "order regardless of thread scheduling, so output is identical to "
+          "a serial run.");
 ABSL_FLAG(int64_t, llvm_opt_level, 3,
           "The optimization level of the LLVM JIT. Valid values are from 0 (no "
           "optimizations) to 3 (maximum optimizations).");
+ABSL_FLAG(std::string, llvm_jit_object_cache_dir, "",
+          "If set, directory in which compiled JIT object code is cached, "
+          "keyed by a hash of the IR and the compilation configuration. "
+          "Repeated invocations on the same IR then load machine code from "
+          "disk instead of re-running LLVM optimization and codegen.");
 ABSL_FLAG(std::string, input_validator_expr, "",
           "DSLX expression to validate randomly-generated inputs. "
           "The expression can reference entry function input arguments "
@@ -157,23 +196,34 @@ std::string ArgsToString(absl::Span<const Value> args) {
   });
 }
 
-// Evaluates the function with the given ArgSets. Returns an error if the result
-// does not match expectations (if any). 'actual_src' and 'expected_src' are
-// string descriptions of the sources of the actual results and expected
-// results, respectively. These strings are included in error messages.
-absl::StatusOr<std::vector<Value>> Eval(
-    Function* f, absl::Span<const ArgSet> arg_sets, bool use_jit,
-    absl::string_view actual_src = "actual",
-    absl::string_view expected_src = "expected") {
+// Evaluates the ArgSets with the indices congruent to `shard` (modulo
+// `num_shards`), writing the result of sample i to `results[i]`. The
+// execution engine (JIT, bytecode interpreter, or tree-walking interpreter)
+// is constructed locally so concurrent shards share no mutable state.
+absl::Status EvalShard(Function* f, absl::Span<const ArgSet> arg_sets,
+                       bool use_jit, int64_t shard, int64_t num_shards,
+                       absl::Span<Value> results) {
   std::unique_ptr<IrJit> jit;
+  std::unique_ptr<JitObjectCache> object_cache;
+  std::unique_ptr<BytecodeInterpreter> bytecode_interpreter;
+  if (!use_jit && absl::GetFlag(FLAGS_use_bytecode_interpreter)) {
+    XLS_ASSIGN_OR_RETURN(bytecode_interpreter, BytecodeInterpreter::Create(f));
+  }
   if (use_jit) {
+    std::string object_cache_dir =
+        absl::GetFlag(FLAGS_llvm_jit_object_cache_dir);
+    if (!object_cache_dir.empty()) {
+      object_cache = std::make_unique<JitObjectCache>(object_cache_dir);
+    }
     // No support for procs yet.
-    XLS_ASSIGN_OR_RETURN(jit,
-                         IrJit::Create(f, absl::GetFlag(FLAGS_llvm_opt_level)));
+    XLS_ASSIGN_OR_RETURN(
+        jit, IrJit::Create(f, absl::GetFlag(FLAGS_llvm_opt_level),
+                           object_cache.get()));
   }
 
-  std::vector<Value> results;
-  for (const ArgSet& arg_set : arg_sets) {
+  for (int64_t i = shard; i < static_cast<int64_t>(arg_sets.size());
+       i += num_shards) {
+    const ArgSet& arg_set = arg_sets[i];
     Value result;
     if (use_jit) {
       if (absl::GetFlag(FLAGS_test_only_inject_jit_result).empty()) {
@@ -183,6 +233,10 @@ absl::StatusOr<std::vector<Value>> Eval(
         XLS_ASSIGN_OR_RETURN(result, Parser::ParseTypedValue(absl::GetFlag(
                                          FLAGS_test_only_inject_jit_result)));
       }
+    } else if (bytecode_interpreter != nullptr) {
+      XLS_ASSIGN_OR_RETURN(
+          result,
+          DropInterpreterEvents(bytecode_interpreter->Run(arg_set.args)));
     } else {
       // TODO(https://github.com/google/xls/issues/506): 2021-10-12 Also compare
       // resulting events once the JIT fully supports events. Note: This will
@@ -191,6 +245,48 @@ absl::StatusOr<std::vector<Value>> Eval(
       XLS_ASSIGN_OR_RETURN(
           result, DropInterpreterEvents(InterpretFunction(f, arg_set.args)));
     }
+    results[i] = std::move(result);
+  }
+  return absl::OkStatus();
+}
+
+// Evaluates the function with the given ArgSets. Returns an error if the result
+// does not match expectations (if any). 'actual_src' and 'expected_src' are
+// string descriptions of the sources of the actual results and expected
+// results, respectively. These strings are included in error messages. If
+// --threads is greater than one the samples are sharded across that many
+// worker threads; results and mismatch reports are emitted in input order
+// either way.
+absl::StatusOr<std::vector<Value>> Eval(
+    Function* f, absl::Span<const ArgSet> arg_sets, bool use_jit,
+    absl::string_view actual_src = "actual",
+    absl::string_view expected_src = "expected") {
+  std::vector<Value> results(arg_sets.size());
+  int64_t num_shards = std::min(absl::GetFlag(FLAGS_threads),
+                                static_cast<int64_t>(arg_sets.size()));
+  if (num_shards > 1) {
+    std::vector<absl::Status> shard_statuses(num_shards, absl::OkStatus());
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int64_t shard = 0; shard < num_shards; ++shard) {
+      threads.push_back(std::make_unique<Thread>([&, shard]() {
+        shard_statuses[shard] = EvalShard(f, arg_sets, use_jit, shard,
+                                          num_shards, absl::MakeSpan(results));
+      }));
+    }
+    for (auto& thread : threads) {
+      thread->Join();
+    }
+    for (const absl::Status& status : shard_statuses) {
+      XLS_RETURN_IF_ERROR(status);
+    }
+  } else {
+    XLS_RETURN_IF_ERROR(EvalShard(f, arg_sets, use_jit, /*shard=*/0,
+                                  /*num_shards=*/1, absl::MakeSpan(results)));
+  }
+
+  for (int64_t i = 0; i < static_cast<int64_t>(arg_sets.size()); ++i) {
+    const ArgSet& arg_set = arg_sets[i];
+    const Value& result = results[i];
     std::cout << result.ToString(FormatPreference::kHex) << std::endl;
 
     if (arg_set.expected.has_value()) {
@@ -202,11 +298,83 @@ absl::StatusOr<std::vector<Value>> Eval(
             arg_set.expected->ToString(FormatPreference::kHex)));
       }
     }
-    results.push_back(result);
   }
   return results;
 }
 
+// Returns the bits of the given value flattened to bytes.
+std::vector<uint8_t> FlattenValue(const Value& value) {
+  BitPushBuffer buffer;
+  value.FlattenTo(&buffer);
+  return buffer.GetUint8Data();
+}
+
+// Batched differential comparison of the JIT against the interpreter over the
+// given ArgSets. The JIT evaluates the batch on the calling thread while the
+// interpreter evaluates it in parallel shards, then the flattened output
+// bytes of each sample are compared. Results of matching samples are not
+// printed.
+absl::Status RunDifferential(Function* f, absl::Span<const ArgSet> arg_sets) {
+  int64_t num_shards =
+      std::min(absl::GetFlag(FLAGS_differential_shards),
+               static_cast<int64_t>(arg_sets.size()));
+  std::vector<Value> interpreter_results(arg_sets.size());
+  std::vector<absl::Status> shard_statuses(num_shards, absl::OkStatus());
+
+  // Start the interpreter shards first; the JIT then evaluates the whole
+  // batch on the calling thread while they run. Each shard handles the sample
+  // indices congruent to its shard number.
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int64_t shard = 0; shard < num_shards; ++shard) {
+    threads.push_back(std::make_unique<Thread>([&, shard]() {
+      for (int64_t i = shard; i < static_cast<int64_t>(arg_sets.size());
+           i += num_shards) {
+        absl::StatusOr<Value> result =
+            DropInterpreterEvents(InterpretFunction(f, arg_sets[i].args));
+        if (!result.ok()) {
+          shard_statuses[shard] = result.status();
+          return;
+        }
+        interpreter_results[i] = std::move(result).value();
+      }
+    }));
+  }
+
+  std::vector<Value> jit_results;
+  absl::Status jit_status = [&]() -> absl::Status {
+    jit_results.reserve(arg_sets.size());
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<IrJit> jit,
+                         IrJit::Create(f, absl::GetFlag(FLAGS_llvm_opt_level)));
+    for (const ArgSet& arg_set : arg_sets) {
+      XLS_ASSIGN_OR_RETURN(Value result,
+                           DropInterpreterEvents(jit->Run(arg_set.args)));
+      jit_results.push_back(std::move(result));
+    }
+    return absl::OkStatus();
+  }();
+
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+  XLS_RETURN_IF_ERROR(jit_status);
+  for (const absl::Status& status : shard_statuses) {
+    XLS_RETURN_IF_ERROR(status);
+  }
+
+  for (int64_t i = 0; i < static_cast<int64_t>(arg_sets.size()); ++i) {
+    // Fast path: compare the flattened bytes; fall back to the structured
+    // values only to build the error message.
+    if (FlattenValue(jit_results[i]) != FlattenValue(interpreter_results[i])) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Miscompare for input \"%s\"\n  JIT: %s\n  interpreter: %s",
+          ArgsToString(arg_sets[i].args),
+          jit_results[i].ToString(FormatPreference::kHex),
+          interpreter_results[i].ToString(FormatPreference::kHex)));
+    }
+  }
+  return absl::OkStatus();
+}
+
 // An invariant checker which evaluates the entry function with the given
 // ArgSets. Raises an error if expectations are not matched.
 class EvalInvariantChecker : public InvariantChecker {
@@ -246,12 +414,22 @@ absl::Status Run(Package* package, absl::Span<const ArgSet> arg_sets_in) {
   // do not exist.
   std::vector<ArgSet> arg_sets(arg_sets_in.begin(), arg_sets_in.end());
 
+  if (absl::GetFlag(FLAGS_differential_shards) > 0) {
+    XLS_QCHECK(!absl::GetFlag(FLAGS_optimize_ir))
+        << "Cannot specify both --differential_shards and --optimize_ir";
+    for (const ArgSet& arg_set : arg_sets) {
+      XLS_QCHECK(!arg_set.expected.has_value())
+          << "Cannot specify expected values with --differential_shards";
+    }
+    return RunDifferential(f, arg_sets);
+  }
+
   if (absl::GetFlag(FLAGS_test_llvm_jit)) {
     XLS_QCHECK(!absl::GetFlag(FLAGS_optimize_ir))
         << "Cannot specify both --test_llvm_jit and --optimize_ir";
     XLS_ASSIGN_OR_RETURN(std::vector<Value> interpreter_results,
                          Eval(f, arg_sets, /*use_jit=*/false));
-    for (int64_t i = 0; i < arg_sets.size(); ++i) {
+    for (int64_t i = 0; i < static_cast<int64_t>(arg_sets.size()); ++i) {
       XLS_QCHECK(!arg_sets[i].expected.has_value())
           << "Cannot specify expected values when using --test_llvm_jit";
       arg_sets[i].expected = interpreter_results[i];
@@ -265,7 +443,7 @@ absl::Status Run(Package* package, absl::Span<const ArgSet> arg_sets_in) {
   // optimizations.
   XLS_ASSIGN_OR_RETURN(std::vector<Value> results,
                        Eval(f, arg_sets, absl::GetFlag(FLAGS_use_llvm_jit)));
-  for (int64_t i = 0; i < arg_sets.size(); ++i) {
+  for (int64_t i = 0; i < static_cast<int64_t>(arg_sets.size()); ++i) {
     if (!arg_sets[i].expected.has_value()) {
       arg_sets[i].expected = results[i];
     }
@@ -449,8 +627,19 @@ absl::Status RealMain(absl::string_view input_path,
       XLS_ASSIGN_OR_RETURN(validator, validator_pkg->GetFunction(mangled_name));
     }
 
-    for (ArgSet& arg_set : arg_sets) {
-      XLS_ASSIGN_OR_RETURN(arg_set, GenerateArgSet(f, validator, &rng_engine));
+    if (validator == nullptr) {
+      // Without a validator the samples can be generated in one batch which
+      // amortizes the scratch allocations of random value generation.
+      std::vector<std::vector<Value>> batch =
+          RandomFunctionArgumentsBatch(f, &rng_engine, arg_sets.size());
+      for (int64_t i = 0; i < static_cast<int64_t>(arg_sets.size()); ++i) {
+        arg_sets[i].args = std::move(batch[i]);
+      }
+    } else {
+      for (ArgSet& arg_set : arg_sets) {
+        XLS_ASSIGN_OR_RETURN(arg_set,
+                             GenerateArgSet(f, validator, &rng_engine));
+      }
     }
   }
 
@@ -482,7 +671,7 @@ absl::Status RealMain(absl::string_view input_path,
     XLS_QCHECK_EQ(expecteds.size(), arg_sets.size())
         << "Number of values in expected file does not match the number of "
            "inputs.";
-    for (int64_t i = 0; i < arg_sets.size(); ++i) {
+    for (int64_t i = 0; i < static_cast<int64_t>(arg_sets.size()); ++i) {
       arg_sets[i].expected = expecteds[i];
     }
   }
@@ -149,6 +149,22 @@ class EvalMainTest(absltest.TestCase):
     self.assertSequenceEqual(('bits[32]:0x165', 'bits[32]:0xf1f'),
                              results.decode('utf-8').strip().split('\n'))
 
+  def test_input_file_threaded(self):
+    ir_file = self.create_tempfile(content=ADD_IR)
+    input_file = self.create_tempfile(
+        content='\n'.join(('bits[32]:0x42; bits[32]:0x123',
+                           'bits[32]:0x10; bits[32]:0xf0f',
+                           'bits[32]:0x1; bits[32]:0x2',
+                           'bits[32]:0x0; bits[32]:0x0')))
+    # Results must come out in input order regardless of thread scheduling.
+    results = subprocess.check_output([
+        EVAL_IR_MAIN_PATH, '--input_file=' + input_file.full_path,
+        '--threads=3', ir_file.full_path
+    ])
+    self.assertSequenceEqual(
+        ('bits[32]:0x165', 'bits[32]:0xf1f', 'bits[32]:0x3', 'bits[32]:0x0'),
+        results.decode('utf-8').strip().split('\n'))
+
   def test_input_file_with_failed_expected_file(self):
     ir_file = self.create_tempfile(content=ADD_IR)
     input_file = self.create_tempfile(
@@ -14,16 +14,23 @@
 
 // Tool to evaluate the behavior of a Proc network.
 
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/init_xls.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/interpreter/channel_queue.h"
 #include "xls/interpreter/proc_network_interpreter.h"
@@ -36,6 +43,13 @@ fixed number of times (specified on the command line) and the final state
 value of each will be printed to the terminal upon completion.
 
 Initial states are set according their declarations inside the IR itself.
+
+Channel inputs and outputs may be bound to files with --inputs_for_channels
+and --outputs_for_channels. Input files hold one IR typed value per line
+(e.g. `bits[32]:0x2a`) and are read lazily as the evaluation consumes them;
+output files are appended to after every tick. Evaluations over arbitrarily
+large stimulus files therefore run in constant memory and produce output
+incrementally.
 )";
 
 ABSL_FLAG(int64_t, ticks, -1, "Number of clock ticks to execute.");
@@ -43,14 +57,158 @@ ABSL_FLAG(std::string, backend, "serial_jit",
           "Backend to use for evaluation. Valid options are:\n"
           " - serial_jit : JIT-backed single-stepping runtime.\n"
           " - ir_interpreter     : Interpreter at the IR level.");
+ABSL_FLAG(std::string, inputs_for_channels, "",
+          "Comma-separated list of channel=file pairs, for example: "
+          "ch_a=foo.values,ch_b=bar.values. Each file contains one "
+          "IR typed value per line and is streamed into the channel "
+          "as the evaluation consumes values.");
+ABSL_FLAG(std::string, outputs_for_channels, "",
+          "Comma-separated list of channel=file pairs, for example: "
+          "ch_out=result.values. Values sent on the channel are "
+          "appended to the file, one IR typed value per line, after "
+          "every tick.");
 
 namespace xls {
+namespace {
+
+// Produces the values of a stimulus file one line at a time so arbitrarily
+// large files are never resident in memory. Blank lines are skipped.
+class ChannelInputFile {
+ public:
+  explicit ChannelInputFile(std::string path)
+      : path_(std::move(path)), file_(path_) {}
+
+  absl::Status OpenStatus() const {
+    if (!file_.is_open()) {
+      return absl::NotFoundError(
+          absl::StrCat("Cannot open channel input file: ", path_));
+    }
+    return absl::OkStatus();
+  }
+
+  // Returns the next value in the file, or an OutOfRangeError once the file
+  // is exhausted.
+  absl::StatusOr<Value> Next() {
+    std::string line;
+    while (std::getline(file_, line)) {
+      absl::string_view stripped = absl::StripAsciiWhitespace(line);
+      if (stripped.empty()) {
+        continue;
+      }
+      return Parser::ParseTypedValue(stripped);
+    }
+    return absl::OutOfRangeError(
+        absl::StrCat("Channel input file exhausted: ", path_));
+  }
+
+ private:
+  std::string path_;
+  std::ifstream file_;
+};
+
+// Appends values to an output file as they are produced, flushing after each
+// value so consumers see output as soon as it exists.
+class ChannelOutputFile {
+ public:
+  explicit ChannelOutputFile(std::string path)
+      : path_(std::move(path)), file_(path_) {}
+
+  absl::Status OpenStatus() const {
+    if (!file_.is_open()) {
+      return absl::NotFoundError(
+          absl::StrCat("Cannot open channel output file: ", path_));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status Write(const Value& value) {
+    file_ << value.ToString() << "\n";
+    file_.flush();
+    if (!file_.good()) {
+      return absl::DataLossError(
+          absl::StrCat("Error writing channel output file: ", path_));
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  std::string path_;
+  std::ofstream file_;
+};
+
+using ChannelInputFileMap =
+    absl::flat_hash_map<Channel*, std::unique_ptr<ChannelInputFile>>;
+using ChannelOutputFileMap =
+    absl::flat_hash_map<Channel*, std::unique_ptr<ChannelOutputFile>>;
 
-absl::Status RunIrInterpreter(Package* package, int64_t ticks) {
+// Parses a comma-separated list of channel=file pairs into a map from channel
+// to file, verifying that the named channels exist in the package.
+absl::StatusOr<absl::flat_hash_map<Channel*, std::string>> ParseChannelFileMap(
+    Package* package, absl::string_view flag_value) {
+  absl::flat_hash_map<Channel*, std::string> result;
+  if (flag_value.empty()) {
+    return result;
+  }
+  for (absl::string_view entry : absl::StrSplit(flag_value, ',')) {
+    std::vector<absl::string_view> parts =
+        absl::StrSplit(entry, absl::MaxSplits('=', 1));
+    if (parts.size() != 2) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Malformed channel=file binding: \"", entry, "\""));
+    }
+    XLS_ASSIGN_OR_RETURN(Channel * channel, package->GetChannel(parts[0]));
+    result[channel] = std::string(parts[1]);
+  }
+  return result;
+}
+
+absl::StatusOr<ChannelInputFileMap> OpenChannelInputFiles(
+    const absl::flat_hash_map<Channel*, std::string>& paths) {
+  ChannelInputFileMap files;
+  for (const auto& [channel, path] : paths) {
+    auto file = std::make_unique<ChannelInputFile>(path);
+    XLS_RETURN_IF_ERROR(file->OpenStatus());
+    files[channel] = std::move(file);
+  }
+  return files;
+}
+
+absl::StatusOr<ChannelOutputFileMap> OpenChannelOutputFiles(
+    const absl::flat_hash_map<Channel*, std::string>& paths) {
+  ChannelOutputFileMap files;
+  for (const auto& [channel, path] : paths) {
+    auto file = std::make_unique<ChannelOutputFile>(path);
+    XLS_RETURN_IF_ERROR(file->OpenStatus());
+    files[channel] = std::move(file);
+  }
+  return files;
+}
+
+absl::Status RunIrInterpreter(Package* package, int64_t ticks,
+                              ChannelInputFileMap* input_files,
+                              ChannelOutputFileMap* output_files) {
+  // Back each file-bound input channel with a queue which pulls the next
+  // value out of the file only when the channel is actually received from.
+  std::vector<std::unique_ptr<ChannelQueue>> queues;
+  for (auto& [channel, file] : *input_files) {
+    ChannelInputFile* file_ptr = file.get();
+    queues.push_back(std::make_unique<GeneratedChannelQueue>(
+        channel, package, [file_ptr]() { return file_ptr->Next(); }));
+  }
   XLS_ASSIGN_OR_RETURN(auto interpreter,
-                       ProcNetworkInterpreter::Create(package, {}));
+                       ProcNetworkInterpreter::Create(package,
+                                                      std::move(queues)));
   for (int i = 0; i < ticks; i++) {
     XLS_RETURN_IF_ERROR(interpreter->Tick());
+    // Drain file-bound output channels after every tick so output appears
+    // incrementally and the queues never accumulate the full output set.
+    for (auto& [channel, file] : *output_files) {
+      ChannelQueue& queue = interpreter->queue_manager().GetQueue(channel);
+      while (!queue.empty()) {
+        XLS_ASSIGN_OR_RETURN(Value value, queue.Dequeue());
+        XLS_RETURN_IF_ERROR(file->Write(value));
+      }
+    }
   }
 
   // Sort the keys for stable print order.
@@ -69,14 +227,31 @@ absl::Status RunIrInterpreter(Package* package, int64_t ticks) {
   return absl::OkStatus();
 }
 
-absl::Status RunSerialJit(Package* package, int64_t ticks) {
+absl::Status RunSerialJit(Package* package, int64_t ticks,
+                          ChannelInputFileMap* input_files,
+                          ChannelOutputFileMap* output_files) {
   XLS_ASSIGN_OR_RETURN(auto runtime, SerialProcRuntime::Create(package));
   // If Tick() semantics change such that it returns once all Procs have run
   // _at_all_ (instead of only returning when all procs have fully completed),
   // then number-of-ticks-based timing won't work and we'll need to run based on
   // collecting some number of outputs.
   for (int64_t i = 0; i < ticks; i++) {
+    // Feed each file-bound input channel one value per tick so no more of the
+    // stimulus file is resident than the tick in flight requires.
+    for (auto& [channel, file] : *input_files) {
+      XLS_ASSIGN_OR_RETURN(Value value, file->Next());
+      XLS_RETURN_IF_ERROR(runtime->EnqueueValueToChannel(channel, value));
+    }
     XLS_RETURN_IF_ERROR(runtime->Tick());
+    for (auto& [channel, file] : *output_files) {
+      XLS_ASSIGN_OR_RETURN(JitChannelQueue * queue,
+                           runtime->queue_mgr()->GetQueueById(channel->id()));
+      while (!queue->Empty()) {
+        XLS_ASSIGN_OR_RETURN(Value value,
+                             runtime->DequeueValueFromChannel(channel));
+        XLS_RETURN_IF_ERROR(file->Write(value));
+      }
+    }
   }
 
   for (int64_t i = 0; i < runtime->NumProcs(); i++) {
@@ -88,17 +263,39 @@ absl::Status RunSerialJit(Package* package, int64_t ticks) {
 }
 
 absl::Status RealMain(absl::string_view ir_file, absl::string_view backend,
-                      int64_t ticks) {
+                      int64_t ticks, absl::string_view inputs_for_channels,
+                      absl::string_view outputs_for_channels) {
   XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(ir_file));
   XLS_ASSIGN_OR_RETURN(auto package, Parser::ParsePackage(ir_text));
 
+  XLS_ASSIGN_OR_RETURN(
+      auto input_paths,
+      ParseChannelFileMap(package.get(), inputs_for_channels));
+  XLS_ASSIGN_OR_RETURN(
+      auto output_paths,
+      ParseChannelFileMap(package.get(), outputs_for_channels));
+  for (const auto& [channel, path] : input_paths) {
+    XLS_RET_CHECK(channel->CanReceive()) << absl::StrCat(
+        "Input-bound channel cannot be received from: ", channel->name());
+  }
+  for (const auto& [channel, path] : output_paths) {
+    XLS_RET_CHECK(channel->CanSend()) << absl::StrCat(
+        "Output-bound channel cannot be sent on: ", channel->name());
+  }
+  XLS_ASSIGN_OR_RETURN(ChannelInputFileMap input_files,
+                       OpenChannelInputFiles(input_paths));
+  XLS_ASSIGN_OR_RETURN(ChannelOutputFileMap output_files,
+                       OpenChannelOutputFiles(output_paths));
+
   if (backend == "serial_jit") {
-    return RunSerialJit(package.get(), ticks);
+    return RunSerialJit(package.get(), ticks, &input_files, &output_files);
   } else {
-    return RunIrInterpreter(package.get(), ticks);
+    return RunIrInterpreter(package.get(), ticks, &input_files,
+                            &output_files);
   }
 }
 
+}  // namespace
 }  // namespace xls
 
 int main(int argc, char* argv[]) {
@@ -118,7 +315,9 @@ int main(int argc, char* argv[]) {
     XLS_LOG(QFATAL) << "--ticks must be specified (and > 0).";
   }
 
-  XLS_QCHECK_OK(xls::RealMain(positional_args[0], backend, ticks));
+  XLS_QCHECK_OK(xls::RealMain(positional_args[0], backend, ticks,
+                              absl::GetFlag(FLAGS_inputs_for_channels),
+                              absl::GetFlag(FLAGS_outputs_for_channels)));
 
   return 0;
 }
@@ -40,11 +40,16 @@ absl::Status RealMain(const std::string& ir_path,
                       const std::string& schedule_path, int stage,
                       const std::string& output_path) {
   XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(ir_path));
-  XLS_ASSIGN_OR_RETURN(auto package, Parser::ParsePackage(ir_text));
+  std::unique_ptr<Package> package;
   Function* function;
   if (function_name) {
+    // Only the named function (and its callees) is needed, so skip parsing
+    // the rest of the package.
+    XLS_ASSIGN_OR_RETURN(package, Parser::ParsePackageForFunction(
+                                      ir_text, function_name.value()));
     XLS_ASSIGN_OR_RETURN(function, package->GetFunction(function_name.value()));
   } else {
+    XLS_ASSIGN_OR_RETURN(package, Parser::ParsePackage(ir_text));
     XLS_ASSIGN_OR_RETURN(function, package->EntryFunction());
   }
 
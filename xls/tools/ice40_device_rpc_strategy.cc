@@ -21,6 +21,7 @@
 #include <termios.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <filesystem>
 
 #include "absl/status/statusor.h"
@@ -32,6 +33,7 @@
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/strerror.h"
+#include "xls/tools/wrap_io.h"
 
 namespace xls {
 namespace {
@@ -267,16 +269,40 @@ absl::StatusOr<Value> Ice40DeviceRpcStrategy::CallUnnamed(
 
   std::vector<uint8_t> u8_data = buffer.GetUint8Data();
 
+  // Frame the payload into length-prefixed burst packets. Within a burst the
+  // payload travels raw -- no per-byte escaping of control code values -- so
+  // the link carries exactly one wire byte per payload byte. The I/O wrapper's
+  // input shift register buffers an entire invocation, which serves as the
+  // write credit: the full frame sequence can be written without intermediate
+  // handshakes, and the credit is returned when the response is read below.
+  std::vector<uint8_t> framed;
+  framed.reserve(u8_data.size() +
+                 2 * CeilOfRatio(static_cast<int64_t>(u8_data.size()),
+                                 verilog::kMaxBurstPayloadBytes));
+  for (int64_t offset = 0; offset < u8_data.size();
+       offset += verilog::kMaxBurstPayloadBytes) {
+    int64_t chunk_size =
+        std::min(verilog::kMaxBurstPayloadBytes,
+                 static_cast<int64_t>(u8_data.size()) - offset);
+    framed.push_back(verilog::IoControlCode::kBurst);
+    framed.push_back(static_cast<uint8_t>(chunk_size));
+    framed.insert(framed.end(), u8_data.begin() + offset,
+                  u8_data.begin() + offset + chunk_size);
+  }
+
+  XLS_VLOG(3) << "Writing " << framed.size() << " framed bytes ("
+              << u8_data.size() << " payload bytes) to device.";
+
   int64_t bytes_written = 0;
-  while (bytes_written < buffer.size_in_bytes()) {
-    int ret = write(tty_fd_.value(), u8_data.data() + bytes_written,
-                    u8_data.size() - bytes_written);
+  while (bytes_written < framed.size()) {
+    int ret = write(tty_fd_.value(), framed.data() + bytes_written,
+                    framed.size() - bytes_written);
     if (ret < 0) {
       return absl::InternalError(
           absl::StrFormat("Could not write partial data of %d remaining bytes "
                           "(originally %d) to ICE40: %s",
-                          buffer.size_in_bytes() - bytes_written,
-                          buffer.size_in_bytes(), Strerror(errno)));
+                          framed.size() - bytes_written, framed.size(),
+                          Strerror(errno)));
     }
     bytes_written += ret;
   }
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <random>
 
 #include "absl/flags/flag.h"
@@ -26,6 +27,7 @@
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/subprocess.h"
+#include "xls/common/thread.h"
 #include "xls/interpreter/function_interpreter.h"
 #include "xls/ir/bits_ops.h"
 #include "xls/ir/ir_parser.h"
@@ -74,6 +76,18 @@ from the interpreter results. Example invocation:
   ir_minimizer_main --test_llvm_jit --use_optimization_pipeline \
     --input='bits[32]:42; bits[1]:0' IR_FILE
 
+The third mode reduces a test case where running the standard optimization
+pipeline on the IR returns an error. The check runs in process with the
+candidate IR held in memory, so no files are written and no subprocess is
+launched per attempt. Note that an abort (e.g. a CHECK failure) in the
+pipeline cannot be caught in process; use --test_executable for those.
+Example invocation:
+
+  ir_minimizer_main --test_optimization_pipeline IR_FILE
+
+Independent simplification candidates can be tried concurrently with
+--worker_count; the first candidate which still fails is accepted.
+
 )";
 
 ABSL_FLAG(bool, can_remove_params, false,
@@ -118,6 +132,16 @@ ABSL_FLAG(
     "Also, because this option runs a single pass at a time it often results "
     "in more minimization than --use_optimization_pipeline which "
     "which might optimize away the problematic bit of IR entirely.");
+ABSL_FLAG(bool, test_optimization_pipeline, false,
+          "Tests whether running the standard optimization pipeline on the IR "
+          "returns an error status, as the reduction test case. The check "
+          "runs in process without writing any files. Cannot be combined "
+          "with --use_optimization_pipeline.");
+ABSL_FLAG(int64_t, worker_count, 1,
+          "Number of worker threads used to try independent simplification "
+          "candidates concurrently. The first candidate which still fails is "
+          "accepted. Values above one perturb the random sequence, so the "
+          "reduction path may differ from a single-threaded run.");
 ABSL_FLAG(std::string, entry, "", "Entry function to use during minimization.");
 
 namespace xls {
@@ -180,6 +204,20 @@ absl::StatusOr<bool> StillFailsHelper(
     return result.ok();
   }
 
+  if (absl::GetFlag(FLAGS_test_optimization_pipeline)) {
+    // Test for bugs by running the standard optimization pipeline in process.
+    // An error status from the pipeline means the bug still reproduces.
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                         ParsePackage(ir_text));
+    absl::StatusOr<bool> pipeline_result =
+        RunStandardPassPipeline(package.get());
+    if (!pipeline_result.ok()) {
+      XLS_VLOG(1) << "Optimization pipeline failed: "
+                  << pipeline_result.status();
+    }
+    return !pipeline_result.ok();
+  }
+
   // Test for bugs by comparing the results of the JIT and interpreter.
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package, ParsePackage(ir_text));
   XLS_RET_CHECK(inputs.has_value());
@@ -512,6 +550,55 @@ absl::Status CleanUp(Function* f, bool can_remove_params) {
   return absl::OkStatus();
 }
 
+// Outcome of one speculative simplification attempt made from the known
+// failing IR text.
+struct AttemptResult {
+  SimplificationResult simplification = SimplificationResult::kDidNotChange;
+  std::string which_transform;
+  // Package IR text after simplification and cleanup. Only set if the
+  // simplification changed the graph.
+  std::string candidate_ir_text;
+  bool still_fails = false;
+  // Entry function IR text and node count, for reporting accepted candidates.
+  std::string candidate_function_ir;
+  int64_t node_count = 0;
+};
+
+// Parses the known failing IR text, applies one random simplification, and
+// tests whether the result still fails. The candidate is kept in memory
+// throughout; nothing is written to disk unless the test itself requires it.
+absl::StatusOr<AttemptResult> TrySimplification(
+    absl::string_view knownf_ir_text,
+    const absl::optional<std::vector<Value>>& inputs, bool can_remove_params,
+    std::mt19937* rng, absl::flat_hash_map<std::string, bool>* test_cache) {
+  AttemptResult result;
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       ParsePackage(knownf_ir_text));
+  XLS_ASSIGN_OR_RETURN(Function * candidate, package->EntryFunction());
+  XLS_VLOG_LINES(2,
+                 "=== Candidate for simplification:\n" + candidate->DumpIr());
+
+  XLS_ASSIGN_OR_RETURN(
+      result.simplification,
+      Simplify(candidate, inputs, rng, &result.which_transform));
+  if (result.simplification != SimplificationResult::kDidChange) {
+    return result;
+  }
+
+  // When we changed (simplified) it, clean it up then see if it still fails.
+  XLS_RETURN_IF_ERROR(CleanUp(candidate, can_remove_params));
+  XLS_VLOG_LINES(2, "=== After simplification [" + result.which_transform +
+                        "]\n" + candidate->DumpIr());
+
+  result.candidate_ir_text = package->DumpIr();
+  XLS_ASSIGN_OR_RETURN(
+      result.still_fails,
+      StillFails(result.candidate_ir_text, inputs, test_cache));
+  result.candidate_function_ir = candidate->DumpIr();
+  result.node_count = candidate->node_count();
+  return result;
+}
+
 absl::Status RealMain(absl::string_view path,
                       const int64_t failed_attempt_limit,
                       const int64_t total_attempt_limit) {
@@ -558,11 +645,15 @@ absl::Status RealMain(absl::string_view path,
   // If so, we start simplifying via this seeded RNG.
   std::mt19937 rng;  // Default constructor uses deterministic seed.
 
+  const int64_t worker_count =
+      std::max<int64_t>(1, absl::GetFlag(FLAGS_worker_count));
+
   // Smallest version of the function that's known to be failing.
   int64_t failed_simplification_attempts = 0;
   int64_t total_attempts = 0;
+  bool done = false;
 
-  while (true) {
+  while (!done) {
     if (failed_simplification_attempts >= failed_attempt_limit) {
       XLS_LOG(INFO) << "Hit failed-simplification-attempt-limit: "
                     << failed_simplification_attempts;
@@ -570,77 +661,93 @@ absl::Status RealMain(absl::string_view path,
       break;
     }
 
-    total_attempts++;
     if (total_attempts >= total_attempt_limit) {
       XLS_LOG(INFO) << "Hit total-attempt-limit: " << total_attempts;
       break;
     }
 
-    XLS_VLOG(1) << "=== Simplification attempt " << total_attempts;
-
-    XLS_ASSIGN_OR_RETURN(auto package, ParsePackage(knownf_ir_text));
-    XLS_ASSIGN_OR_RETURN(Function * candidate, package->EntryFunction());
-    XLS_VLOG_LINES(2,
-                   "=== Candidate for simplification:\n" + candidate->DumpIr());
-
-    // Simplify the function.
-    std::string which_transform;
-    XLS_ASSIGN_OR_RETURN(SimplificationResult simplification,
-                         Simplify(candidate, inputs, &rng, &which_transform));
-
-    // If we cannot change it, we're done.
-    if (simplification == SimplificationResult::kCannotChange) {
-      XLS_LOG(INFO) << "Cannot simplify any further, done!";
-      break;
+    // Make a round of speculative attempts from the current known failing
+    // text. With a single worker the attempt runs on this thread using the
+    // main RNG; with multiple workers each attempt gets its own seed drawn
+    // from the main RNG and the workers run concurrently. Workers skip the
+    // shared test cache; the main thread records their results below.
+    std::vector<absl::StatusOr<AttemptResult>> attempts(worker_count);
+    if (worker_count == 1) {
+      XLS_VLOG(1) << "=== Simplification attempt " << (total_attempts + 1);
+      attempts[0] = TrySimplification(knownf_ir_text, inputs,
+                                      can_remove_params, &rng, &test_cache);
+    } else {
+      std::vector<std::unique_ptr<Thread>> workers;
+      for (int64_t w = 0; w < worker_count; ++w) {
+        uint32_t seed = rng();
+        workers.push_back(std::make_unique<Thread>([&attempts, &knownf_ir_text,
+                                                    &inputs, can_remove_params,
+                                                    w, seed] {
+          std::mt19937 worker_rng(seed);
+          attempts[w] =
+              TrySimplification(knownf_ir_text, inputs, can_remove_params,
+                                &worker_rng, /*test_cache=*/nullptr);
+        }));
+      }
+      for (std::unique_ptr<Thread>& worker : workers) {
+        worker->Join();
+      }
     }
 
-    // If we happened to not change it (e.g. because the RNG said not to), keep
-    // going until we do. We still bump the counter to make sure we don't end up
-    // wedged in a state where we can't simplify anything.
-    if (simplification == SimplificationResult::kDidNotChange) {
-      XLS_VLOG(1) << "Did not change the sample.";
-      failed_simplification_attempts++;
-      continue;
-    }
-    XLS_LOG(INFO) << "Trying " << which_transform;
-
-    // When we changed (simplified) it, clean it up then see if it still fails.
-    XLS_CHECK(simplification == SimplificationResult::kDidChange);
-    XLS_RETURN_IF_ERROR(CleanUp(candidate, can_remove_params));
-
-    XLS_VLOG_LINES(2, "=== After simplification [" + which_transform + "]\n" +
-                          candidate->DumpIr());
-
-    std::string candidate_ir_text = package->DumpIr();
-    XLS_ASSIGN_OR_RETURN(bool still_fails,
-                         StillFails(candidate_ir_text, inputs, &test_cache));
-    if (!still_fails) {
-      failed_simplification_attempts++;
-      XLS_LOG(INFO) << "Sample no longer fails.";
-      XLS_LOG(INFO) << "Failed simplification attempts now: "
-                    << failed_simplification_attempts;
-      // That simplification caused it to stop failing, but keep going with the
-      // last known failing version and seeing if we can find something else
-      // from there.
-      continue;
-    }
+    // Process attempts in order, accepting the first one which still fails.
+    // The rest of the round is discarded as it was derived from the
+    // now-superseded known failing text.
+    for (absl::StatusOr<AttemptResult>& attempt_or : attempts) {
+      XLS_RETURN_IF_ERROR(attempt_or.status());
+      AttemptResult& attempt = *attempt_or;
+      total_attempts++;
+
+      // If we cannot change it, we're done.
+      if (attempt.simplification == SimplificationResult::kCannotChange) {
+        XLS_LOG(INFO) << "Cannot simplify any further, done!";
+        done = true;
+        break;
+      }
 
-    // We found something that definitely fails, update our "knownf" value and
-    // reset our failed simplification attempt count since we see we've made
-    // some forward progress.
-    XLS_RETURN_IF_ERROR(CleanUp(candidate, can_remove_params));
+      // If we happened to not change it (e.g. because the RNG said not to),
+      // keep going until we do. We still bump the counter to make sure we
+      // don't end up wedged in a state where we can't simplify anything.
+      if (attempt.simplification == SimplificationResult::kDidNotChange) {
+        XLS_VLOG(1) << "Did not change the sample.";
+        failed_simplification_attempts++;
+        continue;
+      }
+      XLS_CHECK(attempt.simplification == SimplificationResult::kDidChange);
+      XLS_LOG(INFO) << "Trying " << attempt.which_transform;
+      test_cache.insert({attempt.candidate_ir_text, attempt.still_fails});
+
+      if (!attempt.still_fails) {
+        failed_simplification_attempts++;
+        XLS_LOG(INFO) << "Sample no longer fails.";
+        XLS_LOG(INFO) << "Failed simplification attempts now: "
+                      << failed_simplification_attempts;
+        // That simplification caused it to stop failing, but keep going with
+        // the last known failing version and seeing if we can find something
+        // else from there.
+        continue;
+      }
 
-    XLS_RETURN_IF_ERROR(VerifyStillFails(
-        knownf_ir_text, inputs, "Known failure does not fail after cleanup!",
-        &test_cache));
+      // We found something that definitely fails, update our "knownf" value
+      // and reset our failed simplification attempt count since we see we've
+      // made some forward progress.
+      XLS_RETURN_IF_ERROR(VerifyStillFails(
+          knownf_ir_text, inputs, "Known failure does not fail after cleanup!",
+          &test_cache));
 
-    knownf_ir_text = candidate_ir_text;
+      knownf_ir_text = attempt.candidate_ir_text;
 
-    std::cerr << "---\ntransform: " << which_transform << "\n"
-              << candidate->DumpIr() << "(" << candidate->node_count()
-              << " nodes)" << std::endl;
+      std::cerr << "---\ntransform: " << attempt.which_transform << "\n"
+                << attempt.candidate_function_ir << "(" << attempt.node_count
+                << " nodes)" << std::endl;
 
-    failed_simplification_attempts = 0;
+      failed_simplification_attempts = 0;
+      break;
+    }
   }
 
   // Run the last test verification without the cache.
@@ -665,9 +772,24 @@ int main(int argc, char** argv) {
                     << " <ir_path>";
   }
 
-  XLS_QCHECK(!absl::GetFlag(FLAGS_test_executable).empty() ^
-             absl::GetFlag(FLAGS_test_llvm_jit))
-      << "Must specify either --test_executable or --test_llvm_jit";
+  int64_t test_modes = 0;
+  if (!absl::GetFlag(FLAGS_test_executable).empty()) {
+    test_modes++;
+  }
+  if (absl::GetFlag(FLAGS_test_llvm_jit)) {
+    test_modes++;
+  }
+  if (absl::GetFlag(FLAGS_test_optimization_pipeline)) {
+    test_modes++;
+  }
+  XLS_QCHECK_EQ(test_modes, 1)
+      << "Must specify exactly one of --test_executable, --test_llvm_jit, or "
+         "--test_optimization_pipeline";
+  XLS_QCHECK(!(absl::GetFlag(FLAGS_test_optimization_pipeline) &&
+               absl::GetFlag(FLAGS_use_optimization_pipeline)))
+      << "Cannot specify --use_optimization_pipeline with "
+         "--test_optimization_pipeline as the minimizer would fail on the "
+         "simplification itself";
 
   XLS_QCHECK_OK(xls::RealMain(positional_arguments[0],
                               absl::GetFlag(FLAGS_failed_attempt_limit),
@@ -20,6 +20,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/types/optional.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/file/get_runfile_path.h"
 #include "xls/common/init_xls.h"
@@ -78,6 +79,10 @@ ABSL_FLAG(int32_t, stage, -1,
           "Pipeline stage to evaluate. Requires --schedule.\n"
           "If \"schedule\" is set, but this is not, then the entire module "
           "will be evaluated.");
+ABSL_FLAG(bool, all_stages, false,
+          "Evaluate every pipeline stage in turn, reusing one solver across "
+          "stages (so clauses learned in one stage speed up the next). "
+          "Requires --schedule_path; incompatible with --stage.");
 
 namespace xls {
 namespace {
@@ -123,7 +128,8 @@ absl::Status RealMain(absl::string_view ir_path,
                       absl::string_view cell_proto_path,
                       absl::string_view netlist_path,
                       absl::string_view constraints_file,
-                      absl::string_view schedule_path, int stage) {
+                      absl::string_view schedule_path, int stage,
+                      bool all_stages) {
   solvers::z3::LecParams lec_params;
   XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(ir_path));
   XLS_ASSIGN_OR_RETURN(auto package, Parser::ParsePackage(ir_text));
@@ -143,15 +149,18 @@ absl::Status RealMain(absl::string_view ir_path,
   lec_params.netlist_module_name = netlist_module_name;
 
   std::unique_ptr<solvers::z3::Lec> lec;
+  absl::optional<PipelineSchedule> schedule;
   if (!schedule_path.empty()) {
     XLS_ASSIGN_OR_RETURN(
         PipelineScheduleProto proto,
         ParseTextProtoFile<PipelineScheduleProto>(schedule_path));
     XLS_ASSIGN_OR_RETURN(
-        PipelineSchedule schedule,
-        PipelineSchedule::FromProto(lec_params.ir_function, proto));
-    XLS_ASSIGN_OR_RETURN(lec, solvers::z3::Lec::CreateForStage(
-                                  std::move(lec_params), schedule, stage));
+        schedule, PipelineSchedule::FromProto(lec_params.ir_function, proto));
+    // With --all_stages, start at stage 0 and advance through the rest below.
+    XLS_ASSIGN_OR_RETURN(
+        lec, solvers::z3::Lec::CreateForStage(std::move(lec_params),
+                                              schedule.value(),
+                                              all_stages ? 0 : stage));
   } else {
     XLS_ASSIGN_OR_RETURN(lec, solvers::z3::Lec::Create(std::move(lec_params)));
   }
@@ -171,6 +180,22 @@ absl::Status RealMain(absl::string_view ir_path,
     XLS_RETURN_IF_ERROR(lec->AddConstraints(function));
   }
 
+  if (all_stages) {
+    for (int i = 0; i < schedule->length(); i++) {
+      if (i != 0) {
+        XLS_RETURN_IF_ERROR(lec->AdvanceToStage(i));
+      }
+      bool equal = lec->Run();
+      std::cout << "Stage " << i << ":" << std::endl;
+      std::cout << lec->ResultToString() << std::endl;
+      if (!equal) {
+        std::cout << std::endl << "IR/netlist value dump:" << std::endl;
+        lec->DumpIrTree();
+      }
+    }
+    return absl::OkStatus();
+  }
+
   bool equal = lec->Run();
   std::cout << lec->ResultToString() << std::endl;
   if (!equal) {
@@ -202,11 +227,16 @@ int main(int argc, char* argv[]) {
   int stage = absl::GetFlag(FLAGS_stage);
   XLS_QCHECK(stage == -1 || !schedule_path.empty())
       << "--schedule_path must be specified with --stage.";
+  bool all_stages = absl::GetFlag(FLAGS_all_stages);
+  XLS_QCHECK(!all_stages || !schedule_path.empty())
+      << "--schedule_path must be specified with --all_stages.";
+  XLS_QCHECK(!all_stages || stage == -1)
+      << "Only one of --stage and --all_stages may be specified.";
 
   XLS_QCHECK_OK(xls::RealMain(ir_path, absl::GetFlag(FLAGS_entry_function_name),
                               absl::GetFlag(FLAGS_netlist_module_name),
                               cell_lib_path, cell_proto_path, netlist_path,
                               absl::GetFlag(FLAGS_constraints_file),
-                              schedule_path, stage));
+                              schedule_path, stage, all_stages));
   return 0;
 }
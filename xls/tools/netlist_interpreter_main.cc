@@ -15,6 +15,9 @@
 // Driver for NetlistInterpreter: loads a netlist from disk, feeds Value input
 // (taken from the command line) into it, and prints the result.
 
+#include <memory>
+#include <utility>
+
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -30,9 +33,9 @@
 #include "xls/netlist/cell_library.h"
 #include "xls/netlist/function_extractor.h"
 #include "xls/netlist/interpreter.h"
-#include "xls/netlist/lib_parser.h"
 #include "xls/netlist/netlist.pb.h"
 #include "xls/netlist/netlist_parser.h"
+#include "xls/netlist/netlist_serializer.h"
 
 ABSL_FLAG(std::string, cell_library, "",
           "Cell library to use for interpretation.");
@@ -53,6 +56,14 @@ ABSL_FLAG(std::string, output_type, "",
           "output will be printed as flat uninterpreted bits.");
 ABSL_FLAG(std::string, module_name, "", "Module in the netlist to interpret.");
 ABSL_FLAG(std::string, netlist, "", "Path to the netlist to interpret.");
+ABSL_FLAG(bool, netlist_proto, false,
+          "Whether --netlist is a binary serialized netlist (as written by "
+          "parse_netlist_main --output_proto_path) rather than gate-level "
+          "Verilog. Loading a serialized netlist skips parsing entirely.");
+ABSL_FLAG(int64_t, max_parallelism, 1,
+          "Maximum number of threads to use when evaluating a topological "
+          "level of cells. 1 evaluates cells serially; 0 or less uses one "
+          "thread per hardware thread. Useful for large netlists.");
 
 namespace xls {
 
@@ -66,14 +77,21 @@ absl::StatusOr<netlist::CellLibrary> GetCellLibrary(
     XLS_RET_CHECK(lib_proto.ParseFromString(proto_text));
     return netlist::CellLibrary::FromProto(lib_proto);
   } else {
+    // Liberty libraries can be huge; instead of extracting every cell up
+    // front, scan the file for cell-block offsets and only parse the cells
+    // the netlist actually instantiates.
     XLS_ASSIGN_OR_RETURN(std::string cell_library_text,
                          GetFileContents(cell_library_path));
-    XLS_ASSIGN_OR_RETURN(
-        auto char_stream,
-        netlist::cell_lib::CharStream::FromText(cell_library_text));
-    XLS_ASSIGN_OR_RETURN(netlist::CellLibraryProto lib_proto,
-                         netlist::function::ExtractFunctions(&char_stream));
-    return netlist::CellLibrary::FromProto(lib_proto);
+    XLS_ASSIGN_OR_RETURN(netlist::function::LazyFunctionExtractor extractor,
+                         netlist::function::LazyFunctionExtractor::Create(
+                             std::move(cell_library_text)));
+    auto shared_extractor =
+        std::make_shared<netlist::function::LazyFunctionExtractor>(
+            std::move(extractor));
+    return netlist::CellLibrary(
+        [shared_extractor](absl::string_view cell_name) {
+          return shared_extractor->ExtractCell(cell_name);
+        });
   }
 }
 
@@ -88,10 +106,19 @@ absl::Status RealMain(const std::string& netlist_path,
       netlist::CellLibrary cell_library,
       GetCellLibrary(cell_library_path, cell_library_proto_path));
 
-  XLS_ASSIGN_OR_RETURN(std::string netlist_text, GetFileContents(netlist_path));
-  netlist::rtl::Scanner scanner(netlist_text);
-  XLS_ASSIGN_OR_RETURN(auto netlist, netlist::rtl::Parser::ParseNetlist(
-                                         &cell_library, &scanner));
+  std::unique_ptr<netlist::rtl::Netlist> netlist;
+  if (absl::GetFlag(FLAGS_netlist_proto)) {
+    // Serialized netlists (e.g. written by parse_netlist_main
+    // --output_proto_path) load without re-tokenizing the Verilog.
+    XLS_ASSIGN_OR_RETURN(netlist, netlist::rtl::LoadNetlistFromFile(
+                                      netlist_path, &cell_library));
+  } else {
+    XLS_ASSIGN_OR_RETURN(std::string netlist_text,
+                         GetFileContents(netlist_path));
+    netlist::rtl::Scanner scanner(netlist_text);
+    XLS_ASSIGN_OR_RETURN(netlist, netlist::rtl::Parser::ParseNetlist(
+                                      &cell_library, &scanner));
+  }
   XLS_ASSIGN_OR_RETURN(const auto* module, netlist->GetModule(module_name));
 
   // Input values are listed in the same order as inputs are declared by
@@ -124,7 +151,8 @@ absl::Status RealMain(const std::string& netlist_path,
     input_nets[in] = input_bits.Get(module->GetInputPortOffset(in->name()));
   }
 
-  netlist::Interpreter interpreter(netlist.get());
+  netlist::Interpreter interpreter(netlist.get(),
+                                   absl::GetFlag(FLAGS_max_parallelism));
   XLS_ASSIGN_OR_RETURN(auto output_nets, interpreter.InterpretModule(
                                              module, input_nets, dump_cells));
 
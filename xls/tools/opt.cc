@@ -14,20 +14,33 @@
 
 #include "xls/tools/opt.h"
 
+#include <ostream>
+
+#include "xls/common/file/filesystem.h"
 #include "xls/dslx/ir_converter.h"
 #include "xls/dslx/parse_and_typecheck.h"
 #include "xls/ir/ir_parser.h"
+#include "xls/ir/ir_serializer.h"
 #include "xls/passes/passes.h"
 #include "xls/passes/standard_pipeline.h"
 
 namespace xls::tools {
+namespace {
 
-absl::StatusOr<std::string> OptimizeIrForEntry(absl::string_view ir,
-                                               const OptOptions& options) {
+// Parses (or deserializes) the IR and runs the standard pass pipeline over it,
+// returning the optimized package.
+absl::StatusOr<std::unique_ptr<Package>> OptimizePackageForEntry(
+    absl::string_view ir, const OptOptions& options) {
   XLS_VLOG(3) << "OptimizeIrForEntry; entry: '" << options.entry
               << "'; opt_level: " << options.opt_level;
   std::unique_ptr<Package> package;
-  if (options.entry.empty()) {
+  if (options.binary_input) {
+    if (!options.entry.empty()) {
+      return absl::InvalidArgumentError(
+          "--entry is not supported with binary IR input");
+    }
+    XLS_ASSIGN_OR_RETURN(package, DeserializePackage(ir));
+  } else if (options.entry.empty()) {
     XLS_ASSIGN_OR_RETURN(package, Parser::ParsePackage(ir, options.ir_path));
   } else {
     XLS_ASSIGN_OR_RETURN(package, Parser::ParsePackageWithEntry(
@@ -35,17 +48,60 @@ absl::StatusOr<std::string> OptimizeIrForEntry(absl::string_view ir,
   }
   XLS_VLOG(3) << "Entry function: '" << package->EntryFunction().value()->name()
               << "'";
-  std::unique_ptr<CompoundPass> pipeline =
-      CreateStandardPassPipeline(options.opt_level);
+  XLS_RETURN_IF_ERROR(OptimizePackage(package.get(), options));
+  return package;
+}
+
+}  // namespace
+
+absl::Status OptimizePackage(Package* package, const OptOptions& options) {
+  std::unique_ptr<CompoundPass> pipeline;
+  if (!options.pipeline_profile.empty()) {
+    XLS_ASSIGN_OR_RETURN(PipelineProfile profile,
+                         PipelineProfile::ForName(options.pipeline_profile));
+    pipeline = CreatePassPipeline(profile);
+  } else {
+    pipeline = CreateStandardPassPipeline(options.opt_level);
+  }
   const PassOptions pass_options = {
       .ir_dump_path = options.ir_dump_path,
       .run_only_passes = options.run_only_passes,
       .skip_passes = options.skip_passes,
+      .parallel_function_base_passes = options.parallel_passes,
   };
   PassResults results;
   XLS_RETURN_IF_ERROR(
-      pipeline->Run(package.get(), pass_options, &results).status());
+      pipeline->Run(package, pass_options, &results).status());
+  if (!options.pass_profile_path.empty()) {
+    XLS_RETURN_IF_ERROR(
+        SetFileContents(std::string(options.pass_profile_path),
+                        PassProfileToJson(results)));
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::string> OptimizeIrForEntry(absl::string_view ir,
+                                               const OptOptions& options) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       OptimizePackageForEntry(ir, options));
+  if (options.binary_output) {
+    return SerializePackage(package.get());
+  }
   return package->DumpIr();
 }
 
+absl::Status OptimizeIrForEntry(absl::string_view ir, const OptOptions& options,
+                                std::ostream& os) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       OptimizePackageForEntry(ir, options));
+  if (options.binary_output) {
+    os << SerializePackage(package.get());
+  } else {
+    // Stream the dump directly to avoid materializing the entire optimized IR
+    // as one string.
+    package->DumpIrTo(os);
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace xls::tools
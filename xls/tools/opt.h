@@ -18,9 +18,11 @@
 #define XLS_TOOLS_OPT_H_
 
 #include <cstdint>
+#include <iosfwd>
 #include <string>
 #include <vector>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 
@@ -33,19 +35,45 @@ namespace xls::tools {
 // this consolidated library).
 struct OptOptions {
   int64_t opt_level = xls::kMaxOptLevel;
+  // If non-empty, the named pipeline profile ("O1", "O2", "O3"; see
+  // PipelineProfile in xls/passes/standard_pipeline.h) to run instead of the
+  // standard pipeline at `opt_level`.
+  std::string pipeline_profile;
   absl::string_view entry;
   absl::string_view ir_dump_path = "";
   absl::optional<absl::string_view> ir_path = absl::nullopt;
   absl::optional<std::vector<std::string>> run_only_passes = absl::nullopt;
   std::vector<std::string> skip_passes;
+  // Whether the input is (and the output should be) in the binary serialized
+  // form (see xls/ir/ir_serializer.h) rather than textual IR.
+  bool binary_input = false;
+  bool binary_output = false;
+  // Whether function-scoped passes run over distinct functions/procs in
+  // parallel (see PassOptions::parallel_function_base_passes).
+  bool parallel_passes = false;
+  // If non-empty, the path to which a JSON profile of the pass pipeline is
+  // written. The profile contains one record per pass invocation with the
+  // pass name, whether the IR changed, wall time, node-count delta, and peak
+  // RSS delta.
+  absl::string_view pass_profile_path = "";
 };
 
+// Runs the standard optimization pass pipeline over the given in-memory
+// package according to `options`. Used by drivers which already hold a
+// parsed package and want to avoid serializing the IR between phases.
+absl::Status OptimizePackage(Package* package, const OptOptions& options);
+
 // Helper used in the opt_main tool, optimizes the given IR for a particular
 // entry point function at the given opt level and returns the resulting
 // optimized IR.
 absl::StatusOr<std::string> OptimizeIrForEntry(absl::string_view ir,
                                                const OptOptions& options);
 
+// As above, but streams the optimized IR to `os` rather than returning it as a
+// string. This avoids holding the entire dump in memory for large packages.
+absl::Status OptimizeIrForEntry(absl::string_view ir, const OptOptions& options,
+                                std::ostream& os);
+
 }  // namespace xls::tools
 
 #endif  // XLS_TOOLS_OPT_H_
@@ -41,32 +41,76 @@ ABSL_FLAG(std::vector<std::string>, skip_passes, {},
 ABSL_FLAG(int64_t, opt_level, xls::kMaxOptLevel,
           absl::StrFormat("Optimization level. Ranges from 1 to %d.",
                           xls::kMaxOptLevel));
+ABSL_FLAG(std::string, profile, "",
+          "Named optimization profile to run; one of 'O1' (fast: single "
+          "simplification round, no BDD-based passes), 'O2' (the standard "
+          "pipeline), or 'O3' (extra BDD path budget). Takes precedence over "
+          "--opt_level when specified.");
+ABSL_FLAG(std::string, input_format, "text",
+          "Format of the input IR; one of 'text' or 'binary' (see "
+          "xls/ir/ir_serializer.h). Binary input avoids the cost of parsing "
+          "textual IR for large packages.");
+ABSL_FLAG(std::string, output_format, "text",
+          "Format of the emitted IR; one of 'text' or 'binary'.");
+ABSL_FLAG(bool, parallel_passes, false,
+          "Run function-scoped passes over distinct functions/procs of the "
+          "package in parallel.");
+ABSL_FLAG(std::string, pass_profile_path, "",
+          "If specified, write a machine-readable (JSON) profile of the pass "
+          "pipeline to the given file. The profile contains one record per "
+          "pass invocation with the pass name, whether the IR changed, wall "
+          "time, node-count delta, and peak RSS delta.");
 
 namespace xls::tools {
 namespace {
 
+absl::StatusOr<bool> FormatFlagIsBinary(const std::string& value) {
+  if (value == "binary") {
+    return true;
+  }
+  if (value == "text") {
+    return false;
+  }
+  return absl::InvalidArgumentError(
+      absl::StrFormat("Invalid IR format '%s'; expected 'text' or 'binary'",
+                      value));
+}
+
 absl::Status RealMain(absl::string_view input_path) {
   if (input_path == "-") {
     input_path = "/dev/stdin";
   }
-  XLS_ASSIGN_OR_RETURN(std::string ir, GetFileContents(input_path));
+  // Map the IR rather than slurping it so that multi-hundred-megabyte inputs
+  // are faulted in lazily as the parser scans them.
+  XLS_ASSIGN_OR_RETURN(MappedFileContents ir_file,
+                       MappedFileContents::Map(input_path));
+  absl::string_view ir = ir_file.contents();
+  XLS_ASSIGN_OR_RETURN(bool binary_input,
+                       FormatFlagIsBinary(absl::GetFlag(FLAGS_input_format)));
+  XLS_ASSIGN_OR_RETURN(bool binary_output,
+                       FormatFlagIsBinary(absl::GetFlag(FLAGS_output_format)));
   std::string entry = absl::GetFlag(FLAGS_entry);
   std::string ir_dump_path = absl::GetFlag(FLAGS_ir_dump_path);
+  std::string pass_profile_path = absl::GetFlag(FLAGS_pass_profile_path);
   std::vector<std::string> run_only_passes =
       absl::GetFlag(FLAGS_run_only_passes);
   const OptOptions options = {
       .opt_level = absl::GetFlag(FLAGS_opt_level),
+      .pipeline_profile = absl::GetFlag(FLAGS_profile),
       .entry = entry,
       .ir_dump_path = ir_dump_path,
       .run_only_passes = run_only_passes.empty()
                              ? absl::nullopt
                              : absl::make_optional(std::move(run_only_passes)),
       .skip_passes = absl::GetFlag(FLAGS_skip_passes),
+      .binary_input = binary_input,
+      .binary_output = binary_output,
+      .parallel_passes = absl::GetFlag(FLAGS_parallel_passes),
+      .pass_profile_path = pass_profile_path,
   };
-  XLS_ASSIGN_OR_RETURN(std::string opt_ir,
-                       tools::OptimizeIrForEntry(ir, options));
-  std::cout << opt_ir;
-  return absl::OkStatus();
+  // Stream the optimized IR directly to stdout rather than materializing it
+  // as a string first.
+  return tools::OptimizeIrForEntry(ir, options, std::cout);
 }
 
 }  // namespace
@@ -14,11 +14,14 @@
 
 #include "xls/tools/proto_to_dslx.h"
 
+#include <algorithm>
+
 #include "google/protobuf/compiler/importer.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/dynamic_message.h"
 #include "google/protobuf/text_format.h"
 #include "absl/container/btree_map.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/str_replace.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/file/temp_directory.h"
@@ -55,6 +58,10 @@ struct MessageRecord {
 
     // True if this element is of an unsupported type, such as "string".
     bool unsupported;
+
+    // True if this element was dropped because the consuming DSLX never
+    // references it (see ProtoToDslxOptions::consuming_dslx).
+    bool pruned;
   };
 
   // The name of this message type.
@@ -384,7 +391,8 @@ absl::Status CollectMessageLayout(const std::string& top_package,
     std::string field_name = fd->name();
 
     MessageRecord::ChildElement child_element{/*type=*/"", /*count=*/0,
-                                              /*unsupported=*/false};
+                                              /*unsupported=*/false,
+                                              /*pruned=*/false};
     if (fd->type() == FieldDescriptor::Type::TYPE_MESSAGE) {
       const Descriptor* sub_desc = fd->message_type();
       XLS_RETURN_IF_ERROR(
@@ -480,6 +488,81 @@ absl::Status CollectElementCounts(const std::string& top_package,
   return absl::OkStatus();
 }
 
+// Returns the set of identifier-shaped tokens in the given DSLX source. This
+// is a conservative over-approximation of the names the source can reference:
+// tokens inside comments or strings may keep extra fields alive, which costs
+// generated-module size but never correctness.
+absl::flat_hash_set<std::string> ExtractDslxIdentifiers(
+    absl::string_view text) {
+  auto is_name_char = [](char c) { return absl::ascii_isalnum(c) || c == '_'; };
+  absl::flat_hash_set<std::string> identifiers;
+  int64_t size = text.size();
+  int64_t i = 0;
+  while (i < size) {
+    if (!is_name_char(text[i])) {
+      i++;
+      continue;
+    }
+    int64_t start = i;
+    while (i < size && is_name_char(text[i])) {
+      i++;
+    }
+    if (!absl::ascii_isdigit(text[start])) {
+      identifiers.insert(std::string(text.substr(start, i - start)));
+    }
+  }
+  return identifiers;
+}
+
+// Drops fields that the consuming DSLX never names, then drops message/enum
+// records that are no longer reachable from the top-level message through the
+// surviving fields. A field survives if the consumer mentions either its name
+// or its "<name>_count" companion; the top-level message itself is always
+// retained since it's the type of the emitted binding.
+void PruneUnreferencedFields(
+    const std::string& top_package, const Descriptor& descriptor,
+    const absl::flat_hash_set<std::string>& referenced,
+    NameToRecord* name_to_record) {
+  for (auto& [name, message_record] : *name_to_record) {
+    for (auto& [field_name, element] : message_record->children) {
+      if (!referenced.contains(field_name) &&
+          !referenced.contains(absl::StrCat(field_name, "_count"))) {
+        element.pruned = true;
+      }
+    }
+  }
+
+  // Walk the surviving fields from the top-level message; any record never
+  // visited can't appear in the emitted types or data.
+  absl::flat_hash_set<std::string> reachable;
+  std::deque<std::string> to_visit(
+      {GetParentPrefixedName(top_package, &descriptor)});
+  while (!to_visit.empty()) {
+    std::string name = to_visit.front();
+    to_visit.pop_front();
+    if (!reachable.insert(name).second) {
+      continue;
+    }
+    for (const auto& [field_name, element] :
+         name_to_record->at(name)->children) {
+      if (!element.unsupported && !element.pruned &&
+          absl::holds_alternative<std::string>(element.type)) {
+        to_visit.push_back(absl::get<std::string>(element.type));
+      }
+    }
+  }
+
+  std::vector<std::string> to_erase;
+  for (const auto& [name, message_record] : *name_to_record) {
+    if (!reachable.contains(name)) {
+      to_erase.push_back(name);
+    }
+  }
+  for (const std::string& name : to_erase) {
+    name_to_record->erase(name);
+  }
+}
+
 // Emits an enum definition from the parsed protobuf schema into the passed
 // Module.
 absl::Status EmitEnumDef(dslx::Module* module, MessageRecord* message_record) {
@@ -532,7 +615,7 @@ absl::Status EmitStructDef(dslx::Module* module, MessageRecord* message_record,
     auto* name_def = module->Make<dslx::NameDef>(span, fd->name(), nullptr);
     MessageRecord::ChildElement element =
         message_record->children.at(fd->name());
-    if (element.unsupported) {
+    if (element.unsupported || element.pruned) {
       continue;
     }
 
@@ -616,7 +699,7 @@ absl::Status EmitTypeDefs(dslx::Module* module, NameToRecord* name_to_record) {
   for (const auto& [name, message_record] : *name_to_record) {
     blockers[message_record.get()] = BlockingSet();
     for (const auto& [field_name, element] : message_record->children) {
-      if (!element.unsupported &&
+      if (!element.unsupported && !element.pruned &&
           absl::holds_alternative<std::string>(element.type)) {
         std::string message_name = absl::get<std::string>(element.type);
         blockers[message_record.get()].insert(
@@ -895,7 +978,7 @@ absl::StatusOr<dslx::Expr*> EmitData(const std::string& top_package,
     std::string field_name = fd->name();
     MessageRecord::ChildElement element =
         message_record.children.at(field_name);
-    if (element.unsupported) {
+    if (element.unsupported || element.pruned) {
       continue;
     }
 
@@ -929,7 +1012,8 @@ absl::StatusOr<dslx::Expr*> EmitData(const std::string& top_package,
 
 absl::StatusOr<std::unique_ptr<dslx::Module>> ProtoToDslxWithDescriptorPool(
     absl::string_view message_name, absl::string_view text_proto,
-    absl::string_view binding_name, DescriptorPool* descriptor_pool) {
+    absl::string_view binding_name, DescriptorPool* descriptor_pool,
+    const ProtoToDslxOptions& options) {
   const Descriptor* descriptor =
       descriptor_pool->FindMessageTypeByName(ToProtoString(message_name));
   XLS_RET_CHECK_NE(descriptor, nullptr);
@@ -947,6 +1031,11 @@ absl::StatusOr<std::unique_ptr<dslx::Module>> ProtoToDslxWithDescriptorPool(
       CollectMessageLayout(top_package, *descriptor, &name_to_record));
   XLS_RETURN_IF_ERROR(
       CollectElementCounts(top_package, *new_message, &name_to_record));
+  if (options.consuming_dslx.has_value()) {
+    PruneUnreferencedFields(top_package, *descriptor,
+                            ExtractDslxIdentifiers(*options.consuming_dslx),
+                            &name_to_record);
+  }
   auto module = std::make_unique<dslx::Module>("the_module");
   XLS_RETURN_IF_ERROR(EmitTypeDefs(module.get(), &name_to_record));
   XLS_ASSIGN_OR_RETURN(
@@ -968,20 +1057,56 @@ absl::StatusOr<std::unique_ptr<dslx::Module>> ProtoToDslx(
     const std::filesystem::path& source_root,
     const std::filesystem::path& proto_schema_path,
     absl::string_view message_name, absl::string_view text_proto,
-    absl::string_view binding_name) {
+    absl::string_view binding_name, const ProtoToDslxOptions& options) {
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<DescriptorPool> descriptor_pool,
                        ProcessProtoSchema(source_root, proto_schema_path));
   return ProtoToDslxWithDescriptorPool(message_name, text_proto, binding_name,
-                                       descriptor_pool.get());
+                                       descriptor_pool.get(), options);
 }
 
 absl::StatusOr<std::unique_ptr<dslx::Module>> ProtoToDslxViaText(
     absl::string_view proto_def, absl::string_view message_name,
-    absl::string_view text_proto, absl::string_view binding_name) {
+    absl::string_view text_proto, absl::string_view binding_name,
+    const ProtoToDslxOptions& options) {
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<DescriptorPool> descriptor_pool,
                        ProcessStringProtoSchema(proto_def));
   return ProtoToDslxWithDescriptorPool(message_name, text_proto, binding_name,
-                                       descriptor_pool.get());
+                                       descriptor_pool.get(), options);
+}
+
+std::string ProtoToDslxCacheKey(absl::string_view proto_def,
+                                absl::string_view message_name,
+                                absl::string_view text_proto,
+                                absl::string_view binding_name,
+                                const ProtoToDslxOptions& options) {
+  // 64-bit FNV-1a with fixed constants, so the key is stable across processes
+  // and builds (unlike absl::Hash, which is seeded per-process).
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  auto mix = [&hash](absl::string_view text) {
+    for (char c : text) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ULL;
+    }
+    // Terminator, so moving bytes between adjacent inputs changes the key.
+    hash = (hash ^ 0xff) * 0x100000001b3ULL;
+  };
+  mix(proto_def);
+  mix(message_name);
+  mix(text_proto);
+  mix(binding_name);
+  if (options.consuming_dslx.has_value()) {
+    // Only the (sorted) identifier set participates - formatting-only edits
+    // to the consumer leave the generated module, and thus the key,
+    // unchanged.
+    absl::flat_hash_set<std::string> identifier_set =
+        ExtractDslxIdentifiers(*options.consuming_dslx);
+    std::vector<std::string> identifiers(identifier_set.begin(),
+                                         identifier_set.end());
+    std::sort(identifiers.begin(), identifiers.end());
+    for (const std::string& identifier : identifiers) {
+      mix(identifier);
+    }
+  }
+  return absl::StrCat(absl::Hex(hash, absl::kZeroPad16));
 }
 
 }  // namespace xls
@@ -17,16 +17,30 @@
 
 #include <filesystem>
 #include <memory>
+#include <string>
 
 #include "google/protobuf/descriptor.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
 #include "absl/types/variant.h"
 #include "xls/dslx/ast.h"
 
 namespace xls {
 
+// Options controlling how much of the proto schema is translated.
+struct ProtoToDslxOptions {
+  // When set, holds the text of the DSLX source that consumes the generated
+  // module. Only fields whose names appear as identifiers in that source (and
+  // the messages reachable through them from the top-level message) are
+  // emitted; everything else is dropped from both the struct definitions and
+  // the instantiating constant. Large config schemas typically have only a
+  // few fields actually read by a design, so pruning keeps the generated
+  // module - and its parse/typecheck time - proportional to what's used.
+  absl::optional<std::string> consuming_dslx;
+};
+
 // ProtoToDslx accepts a proto schema and textproto instantiating such, and
 // converts those definitions into a cooresponding DSLX file.
 // Args:
@@ -43,7 +57,8 @@ absl::StatusOr<std::unique_ptr<dslx::Module>> ProtoToDslx(
     const std::filesystem::path& source_root,
     const std::filesystem::path& proto_schema_path,
     absl::string_view message_name, absl::string_view text_proto,
-    absl::string_view binding_name);
+    absl::string_view binding_name,
+    const ProtoToDslxOptions& options = ProtoToDslxOptions());
 
 // As above, but doesn't refer directly to the filesystem for resolution.
 //
@@ -52,7 +67,22 @@ absl::StatusOr<std::unique_ptr<dslx::Module>> ProtoToDslx(
 //  ..rest: as above
 absl::StatusOr<std::unique_ptr<dslx::Module>> ProtoToDslxViaText(
     absl::string_view proto_def, absl::string_view message_name,
-    absl::string_view text_proto, absl::string_view binding_name);
+    absl::string_view text_proto, absl::string_view binding_name,
+    const ProtoToDslxOptions& options = ProtoToDslxOptions());
+
+// Returns a stable (process- and run-independent) fingerprint of everything
+// that determines the generated module: the schema, the textproto, the
+// message/binding names, and - when pruning is enabled - the set of
+// identifiers the consuming DSLX references. Equal keys imply identical
+// generated DSLX, so callers can skip regeneration (and downstream
+// parse/typecheck of the generated module) on a key hit. Note that
+// formatting-only edits to the consuming DSLX don't change the key, since
+// only its identifier set participates.
+std::string ProtoToDslxCacheKey(absl::string_view proto_def,
+                                absl::string_view message_name,
+                                absl::string_view text_proto,
+                                absl::string_view binding_name,
+                                const ProtoToDslxOptions& options);
 
 }  // namespace xls
 
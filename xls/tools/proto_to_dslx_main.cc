@@ -22,6 +22,11 @@
 #include "xls/common/logging/logging.h"
 #include "xls/tools/proto_to_dslx.h"
 
+ABSL_FLAG(std::string, consuming_dslx_path, "",
+          "Optional path to the DSLX source that imports the generated "
+          "module. When set, only the proto fields that source actually "
+          "references (and the messages reachable through them) are emitted, "
+          "keeping the generated module small for large config schemas.");
 ABSL_FLAG(std::string, proto_def_path, "",
           "Path to the [structure] definition of the proto "
           "(i.e., the '.proto' file) to parse.");
@@ -45,11 +50,17 @@ absl::Status RealMain(const std::string& source_root_path,
                       const std::string& proto_name,
                       const std::string& textproto_path,
                       const std::string& var_name,
+                      const std::string& consuming_dslx_path,
                       const std::string& output_path) {
   XLS_ASSIGN_OR_RETURN(std::string textproto, GetFileContents(textproto_path));
+  ProtoToDslxOptions options;
+  if (!consuming_dslx_path.empty()) {
+    XLS_ASSIGN_OR_RETURN(options.consuming_dslx,
+                         GetFileContents(consuming_dslx_path));
+  }
   XLS_ASSIGN_OR_RETURN(auto module,
                        ProtoToDslx(source_root_path, proto_def_path, proto_name,
-                                   textproto, var_name));
+                                   textproto, var_name, options));
   return SetFileContents(output_path, module->ToString());
 }
 
@@ -77,7 +88,9 @@ int main(int argc, char* argv[]) {
   std::string var_name = absl::GetFlag(FLAGS_var_name);
   XLS_QCHECK(!var_name.empty()) << "--var_name must be specified.";
   XLS_QCHECK_OK(xls::RealMain(source_root_path, proto_def_path, proto_name,
-                              textproto_path, var_name, output_path));
+                              textproto_path, var_name,
+                              absl::GetFlag(FLAGS_consuming_dslx_path),
+                              output_path));
 
   return 0;
 }
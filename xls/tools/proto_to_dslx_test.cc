@@ -394,5 +394,103 @@ pub struct Top {
 pub const foo = Top { submessage: [SubMessage { my_ints: [sN[64]:1, sN[64]:2, sN[64]:3, sN[64]:4], my_ints_count: u32:4 }, SubMessage { my_ints: [sN[64]:0, sN[64]:0, sN[64]:0, sN[64]:0], my_ints_count: u32:0 }], submessage_count: u32:2 };)");
 }
 
+TEST(ProtoToDslxTest, PrunesFieldsUnreferencedByConsumer) {
+  const std::string kSchema = R"(
+syntax = "proto2";
+
+package xls;
+
+message Unreferenced {
+  optional int32 whatever = 1;
+}
+
+message SubMessage {
+  optional uint32 used = 1;
+  optional uint32 ignored = 2;
+}
+
+message Top {
+  optional int64 my_int = 1;
+  optional int64 other_int = 2;
+  optional SubMessage sub = 3;
+  optional Unreferenced unreferenced = 4;
+}
+)";
+
+  const std::string kTextproto = R"(
+my_int: 3
+other_int: 4
+sub { used: 5 ignored: 6 }
+)";
+
+  // References only Top.my_int and Top.sub.used; everything else - including
+  // the entire Unreferenced message - should be dropped.
+  const std::string kConsumer = R"(
+fn main(cfg: Top) -> u64 {
+  cfg.my_int as u64 + cfg.sub.used as u64
+}
+)";
+
+  ProtoToDslxOptions options;
+  options.consuming_dslx = kConsumer;
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<dslx::Module> module,
+      ProtoToDslxViaText(kSchema, "xls.Top", kTextproto, "foo", options));
+  EXPECT_EQ(module->ToString(),
+            R"(pub struct SubMessage {
+  used: uN[32],
+}
+pub struct Top {
+  my_int: sN[64],
+  sub: SubMessage,
+}
+pub const foo = Top { my_int: sN[64]:3, sub: SubMessage { used: uN[32]:5 } };)");
+}
+
+TEST(ProtoToDslxTest, CacheKeyIsStableAcrossConsumerFormatting) {
+  const std::string kSchema = R"(
+syntax = "proto2";
+
+package xls;
+
+message Top {
+  optional int64 my_int = 1;
+  optional int64 other_int = 2;
+}
+)";
+  const std::string kTextproto = "my_int: 3 other_int: 4";
+
+  ProtoToDslxOptions options;
+  options.consuming_dslx = R"(
+fn main(cfg: Top) -> s64 { cfg.my_int }
+)";
+  std::string key =
+      ProtoToDslxCacheKey(kSchema, "xls.Top", kTextproto, "foo", options);
+
+  // The same inputs always produce the same key.
+  EXPECT_EQ(key,
+            ProtoToDslxCacheKey(kSchema, "xls.Top", kTextproto, "foo",
+                                options));
+
+  // Formatting-only edits to the consumer don't disturb its identifier set,
+  // so the key (and the generated module) is unchanged.
+  ProtoToDslxOptions reformatted;
+  reformatted.consuming_dslx = "fn main(cfg:Top)->s64{ cfg.my_int }";
+  EXPECT_EQ(key, ProtoToDslxCacheKey(kSchema, "xls.Top", kTextproto, "foo",
+                                     reformatted));
+
+  // Referencing another field changes what's generated, and so the key.
+  ProtoToDslxOptions more_fields;
+  more_fields.consuming_dslx = R"(
+fn main(cfg: Top) -> s64 { cfg.my_int + cfg.other_int }
+)";
+  EXPECT_NE(key, ProtoToDslxCacheKey(kSchema, "xls.Top", kTextproto, "foo",
+                                     more_fields));
+
+  // As does changing the instantiating data.
+  EXPECT_NE(key, ProtoToDslxCacheKey(kSchema, "xls.Top",
+                                     "my_int: 7 other_int: 4", "foo", options));
+}
+
 }  // namespace
 }  // namespace xls
@@ -63,8 +63,12 @@
 #include "xls/dslx/scanner.h"
 #include "xls/dslx/type_info.h"
 #include "xls/dslx/typecheck.h"
+#include "xls/ir/events.h"
 #include "xls/ir/function.h"
+#include "xls/ir/ir_parser.h"
 #include "xls/ir/package.h"
+#include "xls/ir/value.h"
+#include "xls/jit/ir_jit.h"
 #include "xls/passes/standard_pipeline.h"
 #include "xls/scheduling/pipeline_schedule.h"
 
@@ -119,7 +123,8 @@ enum class CommandName {
   kIr,
   kVerilog,
   kLlvm,
-  kType
+  kType,
+  kEval
 };
 
 // A parsed command, along with its arguments.
@@ -158,6 +163,9 @@ absl::optional<Command> ParseCommand(absl::string_view str) {
   } else if (munch_prefix(":type ") || munch_prefix(":t ")) {
     result.command = CommandName::kType;
     result.arguments.push_back(absl::StripAsciiWhitespace(str));
+  } else if (munch_prefix(":eval ") || munch_prefix(":e ")) {
+    result.command = CommandName::kEval;
+    result.arguments.push_back(absl::StripAsciiWhitespace(str));
   } else {
     XLS_VLOG(1) << "Unknown command prefix: \"" << stripped_str << "\"";
     return absl::nullopt;
@@ -168,6 +176,17 @@ absl::optional<Command> ParseCommand(absl::string_view str) {
 // This is necessary because linenoise takes C-style function pointers to
 // callbacks, without an extra `void*` parameter through which context can be
 // provided.
+// A JIT-compiled function together with the (optimized) IR text it was
+// compiled from and the package which owns the function. Holding a shared
+// reference to the package keeps the compiled function's IR alive even after
+// an edit replaces `Globals::ir_package`, so unchanged functions do not need
+// to be re-JITed.
+struct JittedFunction {
+  std::string ir_text;
+  std::shared_ptr<Package> package;
+  std::unique_ptr<IrJit> jit;
+};
+
 struct Globals {
   absl::string_view dslx_path;
   std::unique_ptr<dslx::Scanner> scanner;
@@ -175,7 +194,17 @@ struct Globals {
   std::unique_ptr<dslx::ImportData> import_data;
   std::unique_ptr<dslx::Module> module;
   dslx::TypeInfo* type_info;
-  std::unique_ptr<Package> ir_package;
+  // Contents of dslx_path as of the last successful load. Used to skip
+  // recompilation when the file has not actually changed.
+  std::string dslx_contents;
+  std::shared_ptr<Package> ir_package;
+  // Whether `module` has changed since `ir_package` was last rebuilt.
+  bool ir_dirty = true;
+  // Compiled functions from previous `ir_package` generations, keyed by
+  // (mangled) IR function name. Entries are dropped when the function's
+  // optimized IR changes; otherwise the warm ORC engine is reused across
+  // edits.
+  absl::flat_hash_map<std::string, JittedFunction> jit_cache;
   Trie identifier_trie;
   Trie command_trie;
 };
@@ -221,6 +250,11 @@ char* HintsCallback(const char* buf, int* color, int* bold) {
     *bold = 0;
     return (char*)" <id>";
   }
+  if (!strcasecmp(buf, ":e") || !strcasecmp(buf, ":eval")) {
+    *color = 90;
+    *bold = 0;
+    return (char*)" <id> <args>";
+  }
   return NULL;
 }
 
@@ -260,19 +294,56 @@ void PopulateIdentifierTrie() {
 
 // After this is called, the state of `GetSingletonGlobals()->ir_package` is
 // guaranteed to be up to date with respect to the state of
-// `GetSingletonGlobals()->module`.
+// `GetSingletonGlobals()->module`. Conversion and optimization are skipped
+// entirely when the module has not changed since the last call.
 absl::Status UpdateIr() {
   Globals* globals = GetSingletonGlobals();
+  if (!globals->ir_dirty && globals->ir_package != nullptr) {
+    return absl::OkStatus();
+  }
   XLS_ASSIGN_OR_RETURN(
-      globals->ir_package,
+      std::unique_ptr<Package> package,
       ConvertModuleToPackage(globals->module.get(), globals->import_data.get(),
                              dslx::ConvertOptions{},
                              /*traverse_tests=*/true));
-  XLS_RETURN_IF_ERROR(
-      RunStandardPassPipeline(globals->ir_package.get()).status());
+  XLS_RETURN_IF_ERROR(RunStandardPassPipeline(package.get()).status());
+  globals->ir_package = std::move(package);
+  globals->ir_dirty = false;
+
+  // Drop cached JITs for functions whose optimized IR changed (or which no
+  // longer exist); functions untouched by the edit keep their compiled code.
+  for (auto it = globals->jit_cache.begin(); it != globals->jit_cache.end();) {
+    auto current = it++;
+    if (!globals->ir_package->HasFunctionWithName(current->first)) {
+      globals->jit_cache.erase(current);
+      continue;
+    }
+    XLS_ASSIGN_OR_RETURN(Function * function,
+                         globals->ir_package->GetFunction(current->first));
+    if (function->DumpIr() != current->second.ir_text) {
+      globals->jit_cache.erase(current);
+    }
+  }
   return absl::OkStatus();
 }
 
+// Returns a JIT-compiled version of the given function (which must live in
+// `Globals::ir_package`), reusing the warm engine from a previous compilation
+// if the function's optimized IR is unchanged.
+absl::StatusOr<IrJit*> GetOrCreateJit(Function* function) {
+  Globals* globals = GetSingletonGlobals();
+  auto it = globals->jit_cache.find(function->name());
+  if (it != globals->jit_cache.end()) {
+    return it->second.jit.get();
+  }
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<IrJit> jit, IrJit::Create(function));
+  JittedFunction& entry = globals->jit_cache[function->name()];
+  entry.ir_text = function->DumpIr();
+  entry.package = globals->ir_package;
+  entry.jit = std::move(jit);
+  return entry.jit.get();
+}
+
 // Implementation note: commands should quash top-level-recoverable errors and
 // do their own printing to stderr (propagating OkStatus at the command top
 // level to the REPL despite the fact it quashed an error).
@@ -290,39 +361,59 @@ absl::Status CommandHelp() {
             << "    :llvm            Generate and print LLVM for file\n"
             << "    :type <id>       Show the type of identifier <id>\n"
             << "    :t <id>          Alias for :type\n"
+            << "    :eval <id> <args>\n"
+            << "                     JIT-compile function <id> and run it with\n"
+            << "                     the given semicolon-separated arguments\n"
+            << "    :e <id> <args>   Alias for :eval\n"
             << "\n";
   return absl::OkStatus();
 }
 
 // Function implementing the `:reload` command, which reloads the DSLX file from
-// disk and parses/typechecks it.
+// disk and parses/typechecks it. The persistent `ImportData` is reused across
+// reloads so imported modules (e.g. the stdlib) are only parsed and
+// typechecked once, and reloading an unchanged file is a no-op.
 absl::Status CommandReload() {
   Globals* globals = GetSingletonGlobals();
 
   XLS_ASSIGN_OR_RETURN(std::string dslx_contents,
                        GetFileContents(globals->dslx_path));
 
+  if (globals->module != nullptr && dslx_contents == globals->dslx_contents) {
+    std::cout << globals->dslx_path << " is unchanged.\n";
+    return absl::OkStatus();
+  }
+
   globals->scanner = std::make_unique<dslx::Scanner>(
       std::string(globals->dslx_path), dslx_contents);
   globals->parser =
       std::make_unique<dslx::Parser>("main", globals->scanner.get());
-  globals->import_data = std::make_unique<dslx::ImportData>(
-      /*dslx_stdlib_path=*/"",
-      /*additional_search_paths=*/std::vector<std::filesystem::path>{});
+  if (globals->import_data == nullptr) {
+    globals->import_data = std::make_unique<dslx::ImportData>(
+        /*dslx_stdlib_path=*/"",
+        /*additional_search_paths=*/std::vector<std::filesystem::path>{});
+  }
 
-  // TODO(taktoa): 2021-03-10 allow other kinds of failures to be recoverable
+  // Parse and typecheck into locals so that a failed reload leaves the
+  // previous (working) module in place.
   absl::StatusOr<std::unique_ptr<dslx::Module>> maybe_module =
       globals->parser->ParseModule();
-  if (maybe_module.ok()) {
-    globals->module = std::move(*maybe_module);
-  } else {
+  if (!maybe_module.ok()) {
     std::cout << maybe_module.status() << "\n";
     return absl::OkStatus();
   }
 
-  XLS_ASSIGN_OR_RETURN(
-      globals->type_info,
-      CheckModule(globals->module.get(), globals->import_data.get()));
+  absl::StatusOr<dslx::TypeInfo*> maybe_type_info =
+      CheckModule(maybe_module->get(), globals->import_data.get());
+  if (!maybe_type_info.ok()) {
+    std::cout << maybe_type_info.status() << "\n";
+    return absl::OkStatus();
+  }
+
+  globals->module = std::move(*maybe_module);
+  globals->type_info = *maybe_type_info;
+  globals->dslx_contents = std::move(dslx_contents);
+  globals->ir_dirty = true;
 
   PopulateIdentifierTrie();
 
@@ -398,6 +489,60 @@ absl::Status CommandVerilog(absl::optional<std::string> function_name) {
   return absl::OkStatus();
 }
 
+// Function implementing the `:eval` command, which JIT-compiles the given
+// function (if its compiled code is not already warm in the cache) and runs it
+// with the given arguments. Arguments are IR-typed values separated by
+// semicolons, e.g.:
+//
+//   :eval main bits[32]:42; (bits[7]:0, bits[20]:4)
+absl::Status CommandEval(absl::string_view args_text) {
+  Globals* globals = GetSingletonGlobals();
+  XLS_RETURN_IF_ERROR(UpdateIr());
+
+  std::pair<absl::string_view, absl::string_view> pieces =
+      absl::StrSplit(args_text, absl::MaxSplits(' ', 1));
+  absl::string_view function_name = pieces.first;
+  XLS_ASSIGN_OR_RETURN(Function * function,
+                       FindFunction(function_name, globals->module.get(),
+                                    globals->ir_package.get()));
+  if (function == nullptr) {
+    std::cerr << "Could not eval.\n";
+    return absl::OkStatus();
+  }
+
+  std::vector<Value> args;
+  for (absl::string_view value_string :
+       absl::StrSplit(pieces.second, ';', absl::SkipWhitespace())) {
+    absl::StatusOr<Value> value =
+        Parser::ParseTypedValue(absl::StripAsciiWhitespace(value_string));
+    if (!value.ok()) {
+      std::cout << value.status() << "\n";
+      return absl::OkStatus();
+    }
+    args.push_back(std::move(*value));
+  }
+  if (args.size() != function->params().size()) {
+    std::cout << absl::StreamFormat(
+        "Function \"%s\" wants %d arguments, got %d.\n", function->name(),
+        function->params().size(), args.size());
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<IrJit*> jit = GetOrCreateJit(function);
+  if (!jit.ok()) {
+    std::cout << jit.status() << "\n";
+    return absl::OkStatus();
+  }
+  absl::StatusOr<Value> result =
+      InterpreterResultToStatusOrValue((*jit)->Run(args));
+  if (!result.ok()) {
+    std::cout << result.status() << "\n";
+    return absl::OkStatus();
+  }
+  std::cout << result->ToString() << "\n";
+  return absl::OkStatus();
+}
+
 // Function implementing the `:llvm` command, which generates and dumps the
 // LLVM IR for the module.
 absl::Status CommandLlvm() {
@@ -461,7 +606,7 @@ absl::Status RealMain(absl::string_view dslx_path,
 
   globals->dslx_path = dslx_path;
   globals->command_trie = {{":help", ":quit", ":reload", ":reset", ":ir",
-                            ":verilog", ":llvm", ":type "}};
+                            ":verilog", ":llvm", ":type ", ":eval "}};
 
   XLS_RETURN_IF_ERROR(CommandReload());
 
@@ -530,6 +675,10 @@ absl::Status RealMain(absl::string_view dslx_path,
         XLS_RETURN_IF_ERROR(CommandType(command->arguments[0]));
         break;
       }
+      case CommandName::kEval: {
+        XLS_RETURN_IF_ERROR(CommandEval(command->arguments[0]));
+        break;
+      }
     }
   }
 
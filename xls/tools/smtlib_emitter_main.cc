@@ -18,16 +18,23 @@
 
 // TODO(rspringer): No array support yet. Should be pretty trivial to add.
 
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
 
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
 #include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/init_xls.h"
 #include "xls/common/logging/logging.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/ir/ir_parser.h"
+#include "xls/solvers/smtlib_solver_pool.h"
 #include "xls/solvers/z3_ir_translator.h"
 #include "../z3/src/api/z3.h"
 #include "../z3/src/api/z3_api.h"
@@ -37,13 +44,116 @@ ABSL_FLAG(std::string, function, "",
           "will be made to try to find the package's entry function. "
           "If that fails, an error will be returned.");
 ABSL_FLAG(std::string, ir_path, "", "Path to the XLS IR to process.");
+ABSL_FLAG(std::string, solver, "",
+          "Optional external SMTLIB2 solver command (e.g. \"z3 -in\"). "
+          "When given, instead of printing the SMTLIB the tool asks the "
+          "solver whether each function's return value can be nonzero, "
+          "dispatching the queries across a pool of warm solver "
+          "processes. With --function unset, every function in the "
+          "package is queried.");
+ABSL_FLAG(int64_t, pool_size, 1,
+          "Number of warm solver processes to multiplex queries across "
+          "when --solver is given.");
 
 namespace xls {
 
+// Builds a self-contained SMTLIB2 benchmark asserting that the
+// function's return value is nonzero.
+absl::StatusOr<std::string> BenchmarkSmtlibForFunction(Function* function) {
+  XLS_ASSIGN_OR_RETURN(auto translator,
+                       solvers::z3::IrTranslator::CreateAndTranslate(function));
+  Z3_context ctx = translator->ctx();
+  Z3_set_ast_print_mode(ctx, Z3_PRINT_SMTLIB2_COMPLIANT);
+
+  Z3_ast ret = translator->GetReturnNode();
+  Z3_sort sort = Z3_get_sort(ctx, ret);
+  if (Z3_get_sort_kind(ctx, sort) != Z3_BV_SORT) {
+    return absl::UnimplementedError(absl::StrFormat(
+        "Function %s does not return a bits value; cannot form a query.",
+        function->name()));
+  }
+  Z3_ast zero = Z3_mk_numeral(ctx, "0", sort);
+  Z3_ast formula = Z3_mk_not(ctx, Z3_mk_eq(ctx, ret, zero));
+
+  return std::string(Z3_benchmark_to_smtlib_string(
+      ctx, function->name().c_str(), /*logic=*/"", /*status=*/"unknown",
+      /*attributes=*/"", /*num_assumptions=*/0, /*assumptions=*/nullptr,
+      formula));
+}
+
+// Queries an external solver pool for whether each function's return
+// value can be nonzero, with one query issued per pool slot at a time.
+absl::Status RunQueriesOnSolverPool(absl::Span<Function* const> functions,
+                                    absl::Span<const std::string> solver_argv,
+                                    int64_t pool_size) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<solvers::SmtlibSolverPool> pool,
+                       solvers::SmtlibSolverPool::Create(
+                           solver_argv, std::min<int64_t>(pool_size,
+                                                          functions.size())));
+
+  std::vector<absl::StatusOr<solvers::SmtSolverResult>> results(
+      functions.size(), solvers::SmtSolverResult::kUnknown);
+  std::vector<std::string> queries(functions.size());
+  for (int64_t i = 0; i < functions.size(); ++i) {
+    XLS_ASSIGN_OR_RETURN(queries[i], BenchmarkSmtlibForFunction(functions[i]));
+  }
+
+  std::atomic<int64_t> next_query(0);
+  std::vector<std::unique_ptr<Thread>> workers;
+  for (int64_t i = 0; i < pool_size; ++i) {
+    workers.push_back(std::make_unique<Thread>([&]() {
+      for (int64_t index = next_query.fetch_add(1);
+           index < queries.size(); index = next_query.fetch_add(1)) {
+        results[index] = pool->RunQuery(queries[index]);
+      }
+    }));
+  }
+  for (std::unique_ptr<Thread>& worker : workers) {
+    worker->Join();
+  }
+
+  for (int64_t i = 0; i < functions.size(); ++i) {
+    XLS_ASSIGN_OR_RETURN(solvers::SmtSolverResult result, results[i]);
+    absl::string_view verdict;
+    switch (result) {
+      case solvers::SmtSolverResult::kSat:
+        verdict = "sat";
+        break;
+      case solvers::SmtSolverResult::kUnsat:
+        verdict = "unsat";
+        break;
+      case solvers::SmtSolverResult::kUnknown:
+        verdict = "unknown";
+        break;
+    }
+    std::cout << functions[i]->name() << ": return value != 0 is " << verdict
+              << std::endl;
+  }
+  return absl::OkStatus();
+}
+
 absl::Status RealMain(const std::filesystem::path& ir_path,
-                      absl::optional<std::string> function_name) {
+                      absl::optional<std::string> function_name,
+                      const std::string& solver, int64_t pool_size) {
   XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(ir_path));
   XLS_ASSIGN_OR_RETURN(auto package, Parser::ParsePackage(ir_text));
+
+  if (!solver.empty()) {
+    std::vector<std::string> solver_argv =
+        absl::StrSplit(solver, ' ', absl::SkipEmpty());
+    std::vector<Function*> functions;
+    if (function_name.has_value()) {
+      XLS_ASSIGN_OR_RETURN(Function * function,
+                           package->GetFunction(function_name.value()));
+      functions.push_back(function);
+    } else {
+      for (const std::unique_ptr<Function>& function : package->functions()) {
+        functions.push_back(function.get());
+      }
+    }
+    return RunQueriesOnSolverPool(functions, solver_argv, pool_size);
+  }
+
   Function* function;
   if (!function_name) {
     XLS_ASSIGN_OR_RETURN(function, package->EntryFunction());
@@ -68,6 +178,8 @@ int main(int argc, char* argv[]) {
   if (!absl::GetFlag(FLAGS_function).empty()) {
     function_name = absl::GetFlag(FLAGS_function);
   }
-  XLS_QCHECK_OK(xls::RealMain(absl::GetFlag(FLAGS_ir_path), function_name));
+  XLS_QCHECK_OK(xls::RealMain(absl::GetFlag(FLAGS_ir_path), function_name,
+                              absl::GetFlag(FLAGS_solver),
+                              absl::GetFlag(FLAGS_pool_size)));
   return 0;
 }
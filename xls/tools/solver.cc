@@ -32,6 +32,11 @@ ABSL_FLAG(std::string, other, "",
           "Node for comparison; e.g. when kind is eq_node");
 ABSL_FLAG(int64_t, timeout_ms, 60000,
           "Timeout for proof attempt, in milliseconds");
+ABSL_FLAG(std::string, proof_cache_dir, "",
+          "Optional directory holding cached proof translations, keyed by a "
+          "fingerprint of the IR and predicate. On a hit the translation "
+          "phase is skipped entirely; misses write their translation back to "
+          "the cache for later runs.");
 
 const char kUsage[] = R"(
 Attempts to prove a property of a node in an XLS IR entry function within a
@@ -56,7 +61,8 @@ using solvers::z3::Predicate;
 absl::Status RealMain(absl::string_view ir_path,
                       absl::string_view subject_node_name,
                       absl::string_view predicate_kind,
-                      absl::string_view other_node_name, int64_t timeout_ms) {
+                      absl::string_view other_node_name, int64_t timeout_ms,
+                      absl::string_view proof_cache_dir) {
   XLS_ASSIGN_OR_RETURN(std::string contents, GetFileContents(ir_path));
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
                        Parser::ParsePackage(contents, ir_path));
@@ -74,9 +80,15 @@ absl::Status RealMain(absl::string_view ir_path,
         absl::StrFormat("Invalid predicate kind: \"%s\"", predicate_kind));
   }
 
-  XLS_ASSIGN_OR_RETURN(
-      bool proved,
-      solvers::z3::TryProve(f, subject, predicate.value(), timeout));
+  bool proved;
+  if (proof_cache_dir.empty()) {
+    XLS_ASSIGN_OR_RETURN(
+        proved, solvers::z3::TryProve(f, subject, predicate.value(), timeout));
+  } else {
+    XLS_ASSIGN_OR_RETURN(
+        proved, solvers::z3::TryProveWithCache(f, subject, predicate.value(),
+                                               timeout, proof_cache_dir));
+  }
   std::cout << "Proved " << subject_node_name << " " << predicate->ToString()
             << " holds for all input?"
             << ": " << (proved ? "true" : "false") << std::endl;
@@ -99,6 +111,7 @@ int main(int argc, char** argv) {
   XLS_QCHECK_OK(
       xls::RealMain(positional_arguments[0], absl::GetFlag(FLAGS_subject),
                     absl::GetFlag(FLAGS_kind), absl::GetFlag(FLAGS_other),
-                    absl::GetFlag(FLAGS_timeout_ms)));
+                    absl::GetFlag(FLAGS_timeout_ms),
+                    absl::GetFlag(FLAGS_proof_cache_dir)));
   return EXIT_SUCCESS;
 }
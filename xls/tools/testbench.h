@@ -15,6 +15,7 @@
 #ifndef XLS_TOOLS_TESTBENCH_H_
 #define XLS_TOOLS_TESTBENCH_H_
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <thread>  // NOLINT(build/c++11)
@@ -35,10 +36,11 @@ namespace xls {
 // periodically printed to the terminal, as this class' primary use is for
 // exploring large test spaces.
 //
-// Presently, work is parititioned uniformly across threads at startup. This can
-// lead to work imbalance if certain areas of the input space execute faster
-// than others. More advanced strategies can be explored in the future if this
-// becomes a problem.
+// Work is distributed dynamically: all threads pull chunks of indices from a
+// shared atomic cursor, with chunk sizes shrinking as the remaining work does.
+// Workloads with non-uniform per-sample cost therefore finish in roughly
+// total-cost/num-threads time instead of waiting on whichever thread was
+// statically assigned the most expensive region of the input space.
 
 namespace internal {
 // Forward decl of common Testbench base class.
@@ -92,11 +94,12 @@ class Testbench : public internal::TestbenchBase<InputT, ResultT, ShardDataT> {
         create_shard_(create_shard),
         compute_expected_(compute_expected),
         compute_actual_(compute_actual) {
-    this->thread_create_fn_ = [this](uint64_t start, uint64_t end) {
+    this->thread_create_fn_ = [this]() {
       return std::make_unique<TestbenchThread<InputT, ResultT, ShardDataT>>(
-          &this->mutex_, &this->wake_me_, start, end, this->max_failures_,
-          this->index_to_input_, create_shard_, compute_expected_,
-          compute_actual_, this->compare_results_, this->log_errors_);
+          &this->mutex_, &this->wake_me_, &this->work_cursor_, this->end_,
+          this->num_threads_, this->max_failures_, this->index_to_input_,
+          create_shard_, compute_expected_, compute_actual_,
+          this->compare_results_, this->log_errors_);
     };
   }
 
@@ -124,11 +127,12 @@ class Testbench<InputT, ResultT, ShardDataT,
             compare_results, log_errors),
         compute_expected_(compute_expected),
         compute_actual_(compute_actual) {
-    this->thread_create_fn_ = [this](uint64_t start, uint64_t end) {
+    this->thread_create_fn_ = [this]() {
       return std::make_unique<TestbenchThread<InputT, ResultT, ShardDataT>>(
-          &this->mutex_, &this->wake_me_, start, end, this->max_failures_,
-          this->index_to_input_, compute_expected_, compute_actual_,
-          this->compare_results_, this->log_errors_);
+          &this->mutex_, &this->wake_me_, &this->work_cursor_, this->end_,
+          this->num_threads_, this->max_failures_, this->index_to_input_,
+          compute_expected_, compute_actual_, this->compare_results_,
+          this->log_errors_);
     };
   }
 
@@ -179,24 +183,11 @@ class TestbenchBase {
     started_ = true;
     start_time_ = absl::Now();
 
-    // Set up all the workers.
-    uint64_t chunk_size = (end_ - start_) / num_threads_;
-    uint64_t chunk_remainder =
-        chunk_size == 0 ? (end_ - start_) : (end_ - start_) % chunk_size;
-    uint64_t first = 0;
-    uint64_t last;
+    // Set up all the workers; they pull work from the shared cursor.
+    work_cursor_.store(start_);
     for (int i = 0; i < num_threads_; i++) {
-      last = first + chunk_size;
-      // Distribute any remainder evenly amongst the threads.
-      if (chunk_remainder > 0) {
-        last++;
-        chunk_remainder--;
-      }
-
-      threads_.push_back(thread_create_fn_(first, last));
+      threads_.push_back(thread_create_fn_());
       threads_.back()->Run();
-
-      first = last + 1;
     }
 
     // Now monitor them.
@@ -248,31 +239,25 @@ class TestbenchBase {
 
   // Prints the current execution status across all threads.
   void PrintStatus() {
-    // Get the remainder-adjusted chunk size for this thread.
-    auto thread_chunk_size = [this](int thread_index) {
-      uint64_t total_size = end_ - start_;
-      uint64_t chunk_size = total_size / threads_.size();
-      uint64_t remainder =
-          chunk_size == 0 ? total_size : total_size % chunk_size;
-      if (thread_index < remainder) {
-        chunk_size++;
-      }
-      return chunk_size;
-    };
-
-    // Ignore remainder issues here. It shouldn't matter much at all.
+    // With dynamic distribution threads don't own fixed chunks; report
+    // each thread's share of the processed samples instead.
     absl::Time now = absl::Now();
     auto delta = now - start_time_;
     uint64_t total_done = 0;
+    for (int64_t i = 0; i < threads_.size(); ++i) {
+      total_done += threads_[i]->num_passes() + threads_[i]->num_failures();
+    }
     for (int64_t i = 0; i < threads_.size(); ++i) {
       uint64_t num_passes = threads_[i]->num_passes();
       uint64_t num_failures = threads_[i]->num_failures();
       uint64_t thread_done = num_passes + num_failures;
-      uint64_t chunk_size = thread_chunk_size(i);
-      total_done += thread_done;
       std::cout << absl::StreamFormat(
-                       "thread %02d: %f%% @ %.1f us/sample :: failures %d", i,
-                       static_cast<double>(thread_done) / chunk_size * 100.0,
+                       "thread %02d: %f%% of samples @ %.1f us/sample :: "
+                       "failures %d",
+                       i,
+                       total_done == 0 ? 0.0
+                                       : static_cast<double>(thread_done) /
+                                             total_done * 100.0,
                        absl::ToDoubleMicroseconds(delta) / thread_done,
                        num_failures)
                 << "\n";
@@ -315,9 +300,12 @@ class TestbenchBase {
   std::function<void(int64_t, InputT, ResultT, ResultT)> log_errors_;
 
   using ThreadT = TestbenchThread<InputT, ResultT, ShardDataT>;
-  std::function<std::unique_ptr<ThreadT>(uint64_t, uint64_t)> thread_create_fn_;
+  std::function<std::unique_ptr<ThreadT>()> thread_create_fn_;
   std::vector<std::unique_ptr<ThreadT>> threads_;
 
+  // Cursor over [start_, end_) from which worker threads claim chunks.
+  std::atomic<uint64_t> work_cursor_;
+
   // The main thread sleeps while tests are running. As worker threads finish,
   // they'll wake us up via this condvar.
   absl::Mutex mutex_;
@@ -15,6 +15,9 @@
 #ifndef XLS_TOOLS_TESTBENCH_THREAD_H_
 #define XLS_TOOLS_TESTBENCH_THREAD_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 
 #include "absl/status/status.h"
@@ -48,6 +51,11 @@ class TestbenchThread
   // All specified functions must be thread-safe.
   //  - wake_parent_mutex: A mutex that protects:
   //  - wake_parent: A condvar to kick the parent when this thread has finished.
+  //  - work_cursor: Atomic cursor over the index space, shared between all
+  //                 worker threads; each thread repeatedly claims a chunk of
+  //                 indices by advancing the cursor.
+  //  - num_workers: The total number of worker threads sharing the cursor
+  //                 (used to size the claimed chunks).
   //  - max_failures: The number of failures that will cause us to bail out.
   //                  If 0, then there will be no limit.
   //  - index_to_input: A function that can convert an index to an input to the
@@ -57,7 +65,8 @@ class TestbenchThread
   //                     under test.
   TestbenchThread(
       absl::Mutex* wake_parent_mutex, absl::CondVar* wake_parent,
-      uint64_t start_index, uint64_t end_index, uint64_t max_failures,
+      std::atomic<uint64_t>* work_cursor, uint64_t end_index,
+      int64_t num_workers, uint64_t max_failures,
       std::function<InputT(uint64_t)> index_to_input,
       std::function<std::unique_ptr<ShardDataT>()> create_shard,
       std::function<ResultT(ShardDataT*, InputT)> generate_expected,
@@ -65,7 +74,7 @@ class TestbenchThread
       std::function<bool(ResultT, ResultT)> compare_results,
       std::function<void(int64_t, InputT, ResultT, ResultT)> log_errors)
       : TestbenchThreadBase<InputT, ResultT, ShardDataT>(
-            wake_parent_mutex, wake_parent, start_index, end_index,
+            wake_parent_mutex, wake_parent, work_cursor, end_index, num_workers,
             max_failures, index_to_input, compare_results, log_errors),
         shard_data_(create_shard()),
         generate_expected_(generate_expected),
@@ -94,14 +103,15 @@ class TestbenchThread<
  public:
   TestbenchThread(
       absl::Mutex* wake_parent_mutex, absl::CondVar* wake_parent,
-      uint64_t start_index, uint64_t end_index, uint64_t max_failures,
+      std::atomic<uint64_t>* work_cursor, uint64_t end_index,
+      int64_t num_workers, uint64_t max_failures,
       std::function<InputT(uint64_t)> index_to_input,
       std::function<ResultT(InputT)> generate_expected,
       std::function<ResultT(InputT)> generate_actual,
       std::function<bool(ResultT, ResultT)> compare_results,
       std::function<void(int64_t, InputT, ResultT, ResultT)> log_errors)
       : TestbenchThreadBase<InputT, ResultT, ShardDataT>(
-            wake_parent_mutex, wake_parent, start_index, end_index,
+            wake_parent_mutex, wake_parent, work_cursor, end_index, num_workers,
             max_failures, index_to_input, compare_results, log_errors),
         generate_expected_(generate_expected),
         generate_actual_(generate_actual) {
@@ -127,7 +137,8 @@ class TestbenchThreadBase {
  public:
   TestbenchThreadBase(
       absl::Mutex* wake_parent_mutex, absl::CondVar* wake_parent,
-      uint64_t start_index, uint64_t end_index, uint64_t max_failures,
+      std::atomic<uint64_t>* work_cursor, uint64_t end_index,
+      int64_t num_workers, uint64_t max_failures,
       std::function<InputT(uint64_t)> index_to_input,
       std::function<bool(ResultT, ResultT)> compare_results,
       std::function<void(int64_t, InputT, ResultT, ResultT)> log_errors)
@@ -135,8 +146,9 @@ class TestbenchThreadBase {
         wake_parent_(wake_parent),
         cancelled_(false),
         running_(false),
-        start_index_(start_index),
+        work_cursor_(work_cursor),
         end_index_(end_index),
+        num_workers_(num_workers),
         max_failures_(max_failures),
         num_passes_(0),
         num_failures_(0),
@@ -161,26 +173,49 @@ class TestbenchThreadBase {
     }
 
     running_.store(true);
-    for (uint64_t i = start_index_; i < end_index_; i++) {
-      // Don't check for cancelled on every iteration; it's a touch slow.
-      if (i % 128 == 0 && cancelled_.load()) {
-        return_status = absl::CancelledError("This thread was cancelled.");
+    // Threads claim work in chunks via the shared cursor, so threads
+    // landing in cheap regions of the input space simply claim more
+    // chunks instead of idling while expensive regions finish. Chunks
+    // shrink as the remaining work does ("guided" scheduling) to keep
+    // the tail balanced without paying cursor contention early on.
+    while (return_status.ok()) {
+      uint64_t remaining =
+          end_index_ - std::min(end_index_, work_cursor_->load());
+      uint64_t chunk_size = std::max<uint64_t>(
+          kMinChunkSize, remaining / (kChunksPerWorker * num_workers_));
+      uint64_t chunk_start = work_cursor_->fetch_add(chunk_size);
+      if (chunk_start >= end_index_) {
         break;
       }
-
-      InputT input = index_to_input_(i);
-      ResultT expected = generate_expected_fn_(input);
-      ResultT actual = generate_actual_fn_(input);
-      if (!compare_results_(expected, actual)) {
-        num_failures_.store(num_failures_.load() + 1);
-        log_errors_(i, input, expected, actual);
-        if (max_failures_ <= num_failures_.load()) {
-          return_status = absl::UnknownError("Maximum error count reached.");
+      uint64_t chunk_end = std::min(end_index_, chunk_start + chunk_size);
+
+      // Results are buffered per chunk and merged into the shared
+      // counters once per chunk.
+      uint64_t chunk_passes = 0;
+      for (uint64_t i = chunk_start; i < chunk_end; i++) {
+        // Don't check for cancelled on every iteration; it's a touch slow.
+        if (i % 128 == 0 && cancelled_.load()) {
+          return_status = absl::CancelledError("This thread was cancelled.");
           break;
         }
-      } else {
-        num_passes_.store(num_passes_.load() + 1);
+
+        InputT input = index_to_input_(i);
+        ResultT expected = generate_expected_fn_(input);
+        ResultT actual = generate_actual_fn_(input);
+        if (!compare_results_(expected, actual)) {
+          num_passes_.fetch_add(chunk_passes);
+          chunk_passes = 0;
+          num_failures_.fetch_add(1);
+          log_errors_(i, input, expected, actual);
+          if (max_failures_ <= num_failures_.load()) {
+            return_status = absl::UnknownError("Maximum error count reached.");
+            break;
+          }
+        } else {
+          chunk_passes++;
+        }
       }
+      num_passes_.fetch_add(chunk_passes);
     }
 
     running_.store(false);
@@ -231,8 +266,16 @@ class TestbenchThreadBase {
   std::atomic<bool> cancelled_;
   std::atomic<bool> running_;
 
-  uint64_t start_index_;
+  // Minimum number of indices claimed from the cursor at a time, and
+  // the (approximate) number of chunks each worker would claim if the
+  // remaining work were split evenly right now.
+  static constexpr uint64_t kMinChunkSize = 128;
+  static constexpr uint64_t kChunksPerWorker = 8;
+
+  // Parent-owned cursor over the index space shared by all workers.
+  std::atomic<uint64_t>* work_cursor_;
   uint64_t end_index_;
+  int64_t num_workers_;
 
   // Bookkeeping data.
   uint64_t max_failures_;
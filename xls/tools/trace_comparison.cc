@@ -0,0 +1,117 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/tools/trace_comparison.h"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/ir_parser.h"
+
+namespace xls {
+
+std::string TraceDivergence::ToString() const {
+  std::string rendered_values = absl::StrJoin(
+      values, ", ",
+      [](std::string* out,
+         const std::pair<std::string, absl::optional<Value>>& value) {
+        absl::StrAppend(out, value.first, "=",
+                        value.second.has_value()
+                            ? value.second->ToString()
+                            : std::string("<end of sequence>"));
+      });
+  return absl::StrFormat("Divergence on channel \"%s\" at index %d: %s",
+                         channel_name, index, rendered_values);
+}
+
+absl::StatusOr<absl::optional<TraceDivergence>> CompareChannelTraces(
+    absl::Span<TraceSource> sources) {
+  XLS_RET_CHECK_GE(sources.size(), 2)
+      << "Trace comparison requires at least two sources.";
+
+  // Compare channels in name order so divergence reports are deterministic.
+  std::vector<std::string> channel_names;
+  for (const auto& [name, source] : sources.front().channels) {
+    channel_names.push_back(name);
+  }
+  std::sort(channel_names.begin(), channel_names.end());
+  for (const TraceSource& source : sources) {
+    XLS_RET_CHECK_EQ(source.channels.size(), channel_names.size())
+        << absl::StrCat("Trace source \"", source.name,
+                        "\" covers a different channel set than \"",
+                        sources.front().name, "\"");
+    for (const std::string& channel_name : channel_names) {
+      XLS_RET_CHECK(source.channels.contains(channel_name)) << absl::StrCat(
+          "Trace source \"", source.name, "\" has no trace for channel \"",
+          channel_name, "\"");
+    }
+  }
+
+  for (const std::string& channel_name : channel_names) {
+    for (int64_t index = 0;; ++index) {
+      // Pull one value per source; a single divergent (or missing) value
+      // terminates the whole comparison without consuming the remainder of
+      // any stream.
+      std::vector<std::pair<std::string, absl::optional<Value>>> values;
+      for (TraceSource& source : sources) {
+        XLS_ASSIGN_OR_RETURN(absl::optional<Value> value,
+                             source.channels.at(channel_name)());
+        values.push_back({source.name, std::move(value)});
+      }
+      bool all_match = std::all_of(
+          values.begin(), values.end(),
+          [&](const std::pair<std::string, absl::optional<Value>>& value) {
+            return value.second == values.front().second;
+          });
+      if (!all_match) {
+        return TraceDivergence{channel_name, index, std::move(values)};
+      }
+      if (!values.front().second.has_value()) {
+        // All sequences ended together; channel matches.
+        break;
+      }
+    }
+  }
+  return absl::nullopt;
+}
+
+absl::StatusOr<ValueSource> MakeFileValueSource(const std::string& path) {
+  auto file = std::make_shared<std::ifstream>(path);
+  if (!file->is_open()) {
+    return absl::NotFoundError(
+        absl::StrCat("Cannot open trace file: ", path));
+  }
+  return [file, path]() -> absl::StatusOr<absl::optional<Value>> {
+    std::string line;
+    while (std::getline(*file, line)) {
+      absl::string_view stripped = absl::StripAsciiWhitespace(line);
+      if (stripped.empty()) {
+        continue;
+      }
+      XLS_ASSIGN_OR_RETURN(Value value, Parser::ParseTypedValue(stripped));
+      return value;
+    }
+    return absl::nullopt;
+  };
+}
+
+}  // namespace xls
@@ -0,0 +1,89 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_TOOLS_TRACE_COMPARISON_H_
+#define XLS_TOOLS_TRACE_COMPARISON_H_
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+
+// Utilities for cross-checking the channel traffic produced by different
+// evaluation backends (IrJit, ProcNetworkInterpreter, ModuleSimulator, ...)
+// of the same design. Each backend is exposed as a TraceSource which yields
+// the sequence of values observed on each channel; comparison is performed
+// in lockstep, value by value, and exits on the first divergence rather than
+// requiring complete runs up front.
+
+// A pull-based producer of the sequence of values observed on a single
+// channel by one backend. Returns absl::nullopt once the sequence is
+// exhausted. May be called lazily and incrementally; implementations backed
+// by a running simulation or a file should produce one value per call rather
+// than materializing the whole trace.
+using ValueSource = std::function<absl::StatusOr<absl::optional<Value>>()>;
+
+// The per-channel traces observed by a single backend.
+struct TraceSource {
+  // Name identifying the backend in divergence reports, e.g. "jit" or "rtl".
+  std::string name;
+
+  // Value sequences keyed by channel name. All TraceSources passed to a
+  // single comparison must cover the same set of channels.
+  absl::flat_hash_map<std::string, ValueSource> channels;
+};
+
+// Describes the first point at which the compared traces disagree.
+struct TraceDivergence {
+  // The channel on which the divergence was observed.
+  std::string channel_name;
+
+  // Zero-based position within the channel's value sequence.
+  int64_t index;
+
+  // The value each source produced at (channel_name, index), in source
+  // order. absl::nullopt indicates the source's sequence ended early.
+  std::vector<std::pair<std::string, absl::optional<Value>>> values;
+
+  // Renders a human-readable one-divergence report, e.g.:
+  //   Divergence on channel "out" at index 3: jit=bits[32]:7, rtl=bits[32]:8
+  std::string ToString() const;
+};
+
+// Compares the channel traces of two or more sources in lockstep, pulling
+// one value at a time from each, and returns the first divergence found or
+// absl::nullopt if all sequences match (including matching lengths).
+// Channels are compared in lexicographic name order for deterministic
+// reports. Returns an error if the sources do not cover identical channel
+// sets or if any ValueSource fails.
+absl::StatusOr<absl::optional<TraceDivergence>> CompareChannelTraces(
+    absl::Span<TraceSource> sources);
+
+// Returns a ValueSource which reads values from the given file lazily, one
+// textual IR value per line (the format written by eval_proc_main's
+// --outputs_for_channels). Blank lines are skipped. Returns an error if the
+// file cannot be opened.
+absl::StatusOr<ValueSource> MakeFileValueSource(const std::string& path);
+
+}  // namespace xls
+
+#endif  // XLS_TOOLS_TRACE_COMPARISON_H_
@@ -0,0 +1,151 @@
+// Copyright 2021 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/tools/trace_comparison.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "xls/common/file/temp_file.h"
+#include "xls/common/status/matchers.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+using status_testing::StatusIs;
+using ::testing::HasSubstr;
+
+// Returns a ValueSource which yields the given 32-bit values in order and
+// counts how many values have been pulled from it.
+ValueSource VectorSource(std::vector<uint64_t> values,
+                         std::shared_ptr<int64_t> pull_count = nullptr) {
+  auto index = std::make_shared<int64_t>(0);
+  return [values = std::move(values), index,
+          pull_count]() -> absl::StatusOr<absl::optional<Value>> {
+    if (pull_count != nullptr) {
+      ++*pull_count;
+    }
+    if (*index >= static_cast<int64_t>(values.size())) {
+      return absl::nullopt;
+    }
+    return Value(UBits(values[(*index)++], 32));
+  };
+}
+
+TEST(TraceComparisonTest, MatchingTraces) {
+  std::vector<TraceSource> sources(2);
+  sources[0].name = "jit";
+  sources[0].channels["out"] = VectorSource({1, 2, 3});
+  sources[1].name = "interpreter";
+  sources[1].channels["out"] = VectorSource({1, 2, 3});
+  XLS_ASSERT_OK_AND_ASSIGN(absl::optional<TraceDivergence> divergence,
+                           CompareChannelTraces(absl::MakeSpan(sources)));
+  EXPECT_FALSE(divergence.has_value());
+}
+
+TEST(TraceComparisonTest, DivergentValueReported) {
+  std::vector<TraceSource> sources(2);
+  sources[0].name = "jit";
+  sources[0].channels["out"] = VectorSource({1, 2, 3});
+  sources[1].name = "rtl";
+  sources[1].channels["out"] = VectorSource({1, 7, 3});
+  XLS_ASSERT_OK_AND_ASSIGN(absl::optional<TraceDivergence> divergence,
+                           CompareChannelTraces(absl::MakeSpan(sources)));
+  ASSERT_TRUE(divergence.has_value());
+  EXPECT_EQ(divergence->channel_name, "out");
+  EXPECT_EQ(divergence->index, 1);
+  EXPECT_THAT(divergence->ToString(),
+              HasSubstr("Divergence on channel \"out\" at index 1"));
+  EXPECT_THAT(divergence->ToString(), HasSubstr("jit=bits[32]:2"));
+  EXPECT_THAT(divergence->ToString(), HasSubstr("rtl=bits[32]:7"));
+}
+
+TEST(TraceComparisonTest, EarlyExitStopsPullingValues) {
+  auto long_pulls = std::make_shared<int64_t>(0);
+  std::vector<TraceSource> sources(2);
+  sources[0].name = "jit";
+  sources[0].channels["out"] = VectorSource({1, 2, 3, 4, 5, 6}, long_pulls);
+  sources[1].name = "rtl";
+  sources[1].channels["out"] = VectorSource({1, 9});
+  XLS_ASSERT_OK_AND_ASSIGN(absl::optional<TraceDivergence> divergence,
+                           CompareChannelTraces(absl::MakeSpan(sources)));
+  ASSERT_TRUE(divergence.has_value());
+  EXPECT_EQ(divergence->index, 1);
+  // Only the values up to and including the divergence are pulled.
+  EXPECT_EQ(*long_pulls, 2);
+}
+
+TEST(TraceComparisonTest, ShorterSequenceIsDivergence) {
+  std::vector<TraceSource> sources(2);
+  sources[0].name = "jit";
+  sources[0].channels["out"] = VectorSource({1, 2, 3});
+  sources[1].name = "rtl";
+  sources[1].channels["out"] = VectorSource({1, 2});
+  XLS_ASSERT_OK_AND_ASSIGN(absl::optional<TraceDivergence> divergence,
+                           CompareChannelTraces(absl::MakeSpan(sources)));
+  ASSERT_TRUE(divergence.has_value());
+  EXPECT_EQ(divergence->index, 2);
+  EXPECT_THAT(divergence->ToString(), HasSubstr("rtl=<end of sequence>"));
+}
+
+TEST(TraceComparisonTest, MismatchedChannelSetsError) {
+  std::vector<TraceSource> sources(2);
+  sources[0].name = "jit";
+  sources[0].channels["out"] = VectorSource({1});
+  sources[1].name = "rtl";
+  sources[1].channels["other"] = VectorSource({1});
+  EXPECT_THAT(CompareChannelTraces(absl::MakeSpan(sources)).status(),
+              StatusIs(absl::StatusCode::kInternal,
+                       HasSubstr("no trace for channel")));
+}
+
+TEST(TraceComparisonTest, ThreeSourceComparison) {
+  std::vector<TraceSource> sources(3);
+  sources[0].name = "jit";
+  sources[0].channels["out"] = VectorSource({1, 2});
+  sources[1].name = "interpreter";
+  sources[1].channels["out"] = VectorSource({1, 2});
+  sources[2].name = "rtl";
+  sources[2].channels["out"] = VectorSource({1, 3});
+  XLS_ASSERT_OK_AND_ASSIGN(absl::optional<TraceDivergence> divergence,
+                           CompareChannelTraces(absl::MakeSpan(sources)));
+  ASSERT_TRUE(divergence.has_value());
+  EXPECT_EQ(divergence->index, 1);
+  EXPECT_THAT(divergence->ToString(), HasSubstr("rtl=bits[32]:3"));
+}
+
+TEST(TraceComparisonTest, FileValueSource) {
+  XLS_ASSERT_OK_AND_ASSIGN(
+      TempFile temp_file,
+      TempFile::CreateWithContent("bits[32]:1\n\nbits[32]:2\n"));
+  std::vector<TraceSource> sources(2);
+  sources[0].name = "file";
+  XLS_ASSERT_OK_AND_ASSIGN(
+      sources[0].channels["out"],
+      MakeFileValueSource(temp_file.path().string()));
+  sources[1].name = "vector";
+  sources[1].channels["out"] = VectorSource({1, 2});
+  XLS_ASSERT_OK_AND_ASSIGN(absl::optional<TraceDivergence> divergence,
+                           CompareChannelTraces(absl::MakeSpan(sources)));
+  EXPECT_FALSE(divergence.has_value());
+}
+
+}  // namespace
+}  // namespace xls
@@ -247,6 +247,7 @@ absl::StatusOr<Module*> InputResetModule(VerilogFile* f) {
   auto byte_in = m->AddInput("byte_in", f->BitVectorType(8));
   auto byte_in_ready = m->AddOutput("byte_in_ready", f->ScalarType());
   auto byte_in_valid = m->AddInput("byte_in_valid", f->ScalarType());
+  auto burst_active = m->AddInput("burst_active", f->ScalarType());
   auto rst_n_in = m->AddInput("rst_n_in", f->ScalarType());
   auto rst_n_out = m->AddOutput("rst_n_out", f->ScalarType());
 
@@ -264,10 +265,13 @@ absl::StatusOr<Module*> InputResetModule(VerilogFile* f) {
   auto byte_in_ready_output = fsm.AddOutput1("byte_in_ready_reg", 0);
 
   // If byte_in is the reset control code and byte_in_valid is asserted then
-  // assert the reset signal.
+  // assert the reset signal. Bytes within the payload of a burst frame are
+  // data, not control codes, so reset detection is suppressed while
+  // burst_active is asserted.
   idle_state
-      ->OnCondition(
-          f->LogicalAnd(byte_in_valid, f->Equals(byte_in, reset_control_code)))
+      ->OnCondition(f->LogicalAnd(
+          f->LogicalAnd(byte_in_valid, f->LogicalNot(burst_active)),
+          f->Equals(byte_in, reset_control_code)))
       .NextState(reset_state);
 
   // In the reset state, assert byte_in_ready to clear the reset control code.
@@ -361,6 +365,8 @@ static absl::StatusOr<Module*> EscapeDecoderModule(VerilogFile* f) {
   //     byte_out = IoControlCode::kReset;
   //   } else if (is_escaped && byte_in == IoEscapeCode::kEscapeByte) {
   //     byte_out = IoControlCode::kEscape;
+  //   } else if (is_escaped && byte_in == IoEscapeCode::kBurstByte) {
+  //     byte_out = IoControlCode::kBurst;
   //   } else {
   //     byte_out = byte_in;
   //   }
@@ -368,10 +374,14 @@ static absl::StatusOr<Module*> EscapeDecoderModule(VerilogFile* f) {
       "EscapedResetByte", Hex8Literal(IoEscapeCode::kResetByte, f));
   LocalParamItemRef* escaped_escape_byte = m->Add<LocalParam>()->AddItem(
       "EscapedEscapedByte", Hex8Literal(IoEscapeCode::kResetByte, f));
+  LocalParamItemRef* escaped_burst_byte = m->Add<LocalParam>()->AddItem(
+      "EscapedBurstByte", Hex8Literal(IoEscapeCode::kBurstByte, f));
   LocalParamItemRef* reset_control_code = m->Add<LocalParam>()->AddItem(
       "ResetControlCode", Hex8Literal(IoControlCode::kReset, f));
   LocalParamItemRef* escape_control_code = m->Add<LocalParam>()->AddItem(
       "EscapeControlCode", Hex8Literal(IoControlCode::kEscape, f));
+  LocalParamItemRef* burst_control_code = m->Add<LocalParam>()->AddItem(
+      "BurstControlCode", Hex8Literal(IoControlCode::kBurst, f));
   LogicRef* byte_out_reg = m->AddReg("byte_out_reg", f->BitVectorType(8));
   auto ac = m->Add<Always>(
       std::vector<SensitivityListElement>({ImplicitEventExpression()}));
@@ -381,6 +391,9 @@ static absl::StatusOr<Module*> EscapeDecoderModule(VerilogFile* f) {
   cond->AddAlternate(
           f->LogicalAnd(is_escaped, f->Equals(byte_in, escaped_escape_byte)))
       ->Add<BlockingAssignment>(byte_out_reg, escape_control_code);
+  cond->AddAlternate(
+          f->LogicalAnd(is_escaped, f->Equals(byte_in, escaped_burst_byte)))
+      ->Add<BlockingAssignment>(byte_out_reg, burst_control_code);
   cond->AddAlternate()->Add<BlockingAssignment>(byte_out_reg, byte_in);
 
   m->Add<ContinuousAssignment>(byte_out, byte_out_reg);
@@ -421,12 +434,18 @@ absl::StatusOr<Module*> InputControllerModule(const ModuleSignature& signature,
   // the input byte when it is a reset control code.
   LogicRef* reset_fsm_byte_in_ready =
       m->AddWire("reset_fsm_byte_in_ready", f->ScalarType());
+
+  // Asserted by the receive FSM while a burst frame is in flight. Suppresses
+  // reset control code detection in the resetter as burst payload bytes are
+  // not interpreted as control codes.
+  LogicRef* burst_active = m->AddWire("burst_active", f->ScalarType());
   {
     std::vector<Connection> connections;
     connections.push_back(Connection{"clk", clk});
     connections.push_back(Connection{"byte_in", byte_in});
     connections.push_back(Connection{"byte_in_valid", byte_in_valid});
     connections.push_back(Connection{"byte_in_ready", reset_fsm_byte_in_ready});
+    connections.push_back(Connection{"burst_active", burst_active});
     connections.push_back(Connection{"rst_n_in", rst_n_in});
     connections.push_back(Connection{"rst_n_out", rst_n_out});
     m->Add<Instantiation>(reset_m->name(), "resetter",
@@ -465,16 +484,28 @@ absl::StatusOr<Module*> InputControllerModule(const ModuleSignature& signature,
   auto input_valid_state = fsm.AddState("InputValid");
   auto data_done_state = fsm.AddState("DataDone");
 
+  // States handling length-prefixed burst frames. The BurstLength states
+  // receive the payload length byte, the BurstData states shift in the raw
+  // payload bytes.
+  auto burst_length_state = fsm.AddState("BurstLength");
+  auto burst_length_valid_state = fsm.AddState("BurstLengthValid");
+  auto burst_data_state = fsm.AddState("BurstData");
+  auto burst_data_valid_state = fsm.AddState("BurstDataValid");
+
   auto shifter_clear_output = fsm.AddExistingOutput(
       shifter_clear, /*default_value=*/f->PlainLiteral(0));
   auto shifter_write_en_output = fsm.AddExistingOutput(
       shifter_write_en, /*default_value=*/f->PlainLiteral(0));
   auto data_out_valid_output = fsm.AddOutput1("data_out_valid_reg", 0);
   auto byte_in_ready_output = fsm.AddOutput1("byte_in_ready_reg", 0);
+  auto burst_active_output = fsm.AddOutput1("burst_active_reg", 0);
 
   auto is_escaped_reg =
       fsm.AddRegister("is_escaped", f->ScalarType(), f->PlainLiteral(0));
 
+  // Count of remaining payload bytes in the burst frame being received.
+  auto burst_countdown_reg = fsm.AddRegister("burst_countdown", 8);
+
   // The initial state clears the input shift register.
   init_state->SetOutput(shifter_clear_output, 1).NextState(idle_state);
 
@@ -486,9 +517,16 @@ absl::StatusOr<Module*> InputControllerModule(const ModuleSignature& signature,
   input_valid_state->SetOutput(byte_in_ready_output, 1)
       .NextState(idle_state)
 
+      // Burst control code received. The next byte is the frame's payload
+      // length.
+      .OnCondition(f->LogicalAnd(
+          f->LogicalNot(is_escaped_reg->logic_ref),
+          f->Equals(byte_in, Hex8Literal(IoControlCode::kBurst, f))))
+      .NextState(burst_length_state)
+
       // Not currently in escaped state and escape character received. Enter the
       // escaped state.
-      .OnCondition(f->LogicalAnd(
+      .ElseOnCondition(f->LogicalAnd(
           f->LogicalNot(is_escaped_reg->logic_ref),
           f->Equals(byte_in, Hex8Literal(IoControlCode::kEscape, f))))
       .SetRegisterNext(is_escaped_reg, 1)
@@ -503,10 +541,42 @@ absl::StatusOr<Module*> InputControllerModule(const ModuleSignature& signature,
       .OnCondition(data_out_ready)
       .NextState(init_state);
 
+  // Wait for the burst frame's length byte then latch it into the countdown
+  // register. A zero-length frame is degenerate and returns to Idle without
+  // shifting in any payload.
+  burst_length_state->SetOutput(burst_active_output, 1)
+      .OnCondition(byte_in_valid)
+      .NextState(burst_length_valid_state);
+
+  burst_length_valid_state->SetOutput(byte_in_ready_output, 1)
+      .SetOutput(burst_active_output, 1)
+      .SetRegisterNextAsExpression(burst_countdown_reg, byte_in)
+      .NextState(burst_data_state)
+      .OnCondition(f->Equals(byte_in, f->PlainLiteral(0)))
+      .NextState(idle_state);
+
+  // Shift in payload bytes raw -- without control code interpretation -- until
+  // the countdown expires.
+  burst_data_state->SetOutput(burst_active_output, 1)
+      .OnCondition(byte_in_valid)
+      .NextState(burst_data_valid_state);
+
+  burst_data_valid_state->SetOutput(byte_in_ready_output, 1)
+      .SetOutput(shifter_write_en_output, 1)
+      .SetOutput(burst_active_output, 1)
+      .SetRegisterNextAsExpression(
+          burst_countdown_reg,
+          f->Sub(burst_countdown_reg->logic_ref, f->PlainLiteral(1)))
+      .NextState(burst_data_state)
+      .OnCondition(
+          f->Equals(burst_countdown_reg->logic_ref, f->PlainLiteral(1)))
+      .NextState(idle_state);
+
   XLS_RETURN_IF_ERROR(fsm.Build());
 
   m->Add<ContinuousAssignment>(data_out_valid,
                                data_out_valid_output->logic_ref);
+  m->Add<ContinuousAssignment>(burst_active, burst_active_output->logic_ref);
 
   // The byte_in_ready signal can come from the FSM or the reset module (in case
   // of receiving a reset IO code). Or them together to generate the output
@@ -28,9 +28,17 @@ namespace verilog {
 // data, but rather initiate actions within the state machine. Passing data
 // bytes equal to these values requires an escape sequnce.
 enum IoControlCode : uint8_t {
+  // Begins a burst frame. The byte following this control code is the payload
+  // length (1-255), and the payload bytes after the length are shifted in raw
+  // without any control code interpretation. This avoids per-byte escaping
+  // when shuttling bulk data to the device; note that this means the reset
+  // control code is not recognized until the frame completes.
+  kBurst = 0xfd,
+
   // Resets the I/O state machine and the device function. This control code
   // cannot be escaped (a reset is initiated even if the previous character
-  // is the escape control code).
+  // is the escape control code), though it is not interpreted within the
+  // payload of a burst frame.
   kReset = 0xfe,
 
   // Escapes the next byte received. The interpretation of the escaped byte is
@@ -46,11 +54,19 @@ enum IoEscapeCode : uint8_t {
   // (IoControlCode::kReset).
   kResetByte = 0x00,
 
+  // Interpreted as a data byte equal to the "burst" control code value
+  // (IoControlCode::kBurst).
+  kBurstByte = 0x01,
+
   // Interpreted as a data byte equal to the "escape" control code value
   // (IoControlCode::kEscape).
   kEscapeByte = 0xff,
 };
 
+// Maximum number of payload bytes in a single burst frame, as bounded by the
+// byte-sized length prefix.
+constexpr int64_t kMaxBurstPayloadBytes = 255;
+
 // Decorates a Verilog module, that represents an HLS-codegen'd function entry
 // point, with an I/O state machine.
 //
@@ -261,6 +261,7 @@ TEST_P(WrapIoTest, InputResetModuleTest) {
 
   ModuleTestbench tb(m, GetSimulator(), /*clk_name=*/"clk");
   tb.Set("rst_n_in", 0);
+  tb.Set("burst_active", 0);
   tb.AdvanceNCycles(5);
   tb.Set("rst_n_in", 1);
   tb.Set("byte_in", 0);
@@ -293,6 +294,14 @@ TEST_P(WrapIoTest, InputResetModuleTest) {
   // Next cycle, everything shoud be back to normal.
   tb.NextCycle().ExpectEq("rst_n_out", 1).ExpectEq("byte_in_ready", 0);
 
+  // With burst_active asserted the reset control code is burst payload data
+  // and should not trigger a reset.
+  tb.Set("burst_active", 1)
+      .Set("byte_in", IoControlCode::kReset)
+      .Set("byte_in_valid", 1);
+  tb.NextCycle().ExpectEq("rst_n_out", 1).ExpectEq("byte_in_ready", 0);
+  tb.Set("burst_active", 0).Set("byte_in_valid", 0);
+
   // Asserting rst_in should assert rst_out.
   tb.NextCycle().Set("rst_n_in", 0);
   tb.NextCycle().ExpectEq("rst_n_out", 0);
@@ -401,6 +410,46 @@ TEST_P(WrapIoTest, InputControllerEscapedCharacters) {
   XLS_EXPECT_OK(tb.Run());
 }
 
+TEST_P(WrapIoTest, InputControllerBurstFrame) {
+  // Verify that a length-prefixed burst frame shifts in its payload bytes raw,
+  // including bytes equal to the control code values, without escaping and
+  // without triggering a reset.
+  ModuleSignatureBuilder mb("x_plus_y");
+  mb.WithClock("clk");
+  mb.WithFixedLatencyInterface(42);
+  mb.AddDataInput("x", 16);
+  mb.AddDataOutput("sum", 8);
+  XLS_ASSERT_OK_AND_ASSIGN(ModuleSignature signature, mb.Build());
+
+  VerilogFile file(UseSystemVerilog());
+  XLS_ASSERT_OK_AND_ASSIGN(Module * m, InputControllerModule(signature, &file));
+
+  ModuleTestbench tb(m, GetSimulator(), /*clk_name=*/"clk");
+  tb.Set("rst_n_in", 0);
+  tb.AdvanceNCycles(5);
+  tb.Set("rst_n_in", 1).Set("data_out_ready", 0).Set("byte_in_valid", 1);
+  tb.Set("byte_in", IoControlCode::kBurst)
+      .WaitFor("byte_in_ready")
+      .NextCycle();
+  // Payload length followed by two raw payload bytes.
+  tb.Set("byte_in", 2).WaitFor("byte_in_ready").NextCycle();
+  tb.Set("byte_in", IoControlCode::kReset)
+      .WaitFor("byte_in_ready")
+      .NextCycle();
+  tb.ExpectEq("rst_n_out", 1);
+  tb.Set("byte_in", IoControlCode::kEscape)
+      .WaitFor("byte_in_ready")
+      .NextCycle();
+  tb.Set("byte_in_valid", 0).Set("data_out_ready", 1);
+  tb.WaitFor("data_out_valid")
+      .ExpectEq("data_out",
+                (static_cast<uint16_t>(IoControlCode::kReset) << 8) |
+                    IoControlCode::kEscape)
+      .NextCycle();
+
+  XLS_EXPECT_OK(tb.Run());
+}
+
 TEST_P(WrapIoTest, InputControllerWideInput) {
   ModuleSignatureBuilder mb("wide_x");
   mb.WithClock("clk");
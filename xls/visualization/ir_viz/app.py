@@ -230,9 +230,17 @@ def example_handler(filename: str):
 def graph_handler():
   """Parses the posted text and returns a parse status."""
   text = flask.request.form['text']
+  # When 'max_nodes' is posted, stream a coarsened level of detail rather than
+  # the whole graph: clusters in the response can be expanded via /expand.
+  max_nodes = flask.request.form.get('max_nodes')
   try:
-    json_text = ir_to_json.ir_to_json(text, FLAGS.delay_model,
-                                      FLAGS.pipeline_stages, FLAGS.entry)
+    if max_nodes is not None:
+      json_text = ir_to_json.ir_to_json_at_level_of_detail(
+          text, FLAGS.delay_model, int(max_nodes), FLAGS.pipeline_stages,
+          FLAGS.entry)
+    else:
+      json_text = ir_to_json.ir_to_json(text, FLAGS.delay_model,
+                                        FLAGS.pipeline_stages, FLAGS.entry)
   except Exception as e:  # pylint: disable=broad-except
     # TODO(meheff): Switch to new pybind11 more-specific exception.
     return flask.jsonify({'error_code': 'error', 'message': str(e)})
@@ -242,6 +250,29 @@ def graph_handler():
   return jsonified
 
 
+@webapp.route('/expand', methods=['POST'])
+def expand_handler():
+  """Returns the subgraph inside one cluster of a level-of-detail view.
+
+  Expects 'text', 'max_nodes' (the same value posted to /graph, so the
+  cluster ids agree) and 'cluster' (the id of the cluster to expand). The
+  response graph holds the cluster's member nodes, their edges, and stubs for
+  neighboring vertices.
+  """
+  text = flask.request.form['text']
+  max_nodes = flask.request.form['max_nodes']
+  cluster = flask.request.form['cluster']
+  try:
+    json_text = ir_to_json.ir_cluster_to_json(text, FLAGS.delay_model,
+                                              int(max_nodes), cluster,
+                                              FLAGS.entry)
+  except Exception as e:  # pylint: disable=broad-except
+    return flask.jsonify({'error_code': 'error', 'message': str(e)})
+
+  graph = json.loads(json_text)
+  return flask.jsonify({'error_code': 'ok', 'graph': graph})
+
+
 def main(argv):
   if len(argv) > 1:
     raise app.UsageError('Too many command-line arguments.')
@@ -14,14 +14,19 @@
 
 #include "xls/visualization/ir_viz/ir_to_json.h"
 
+#include <algorithm>
+
 #include "google/protobuf/util/json_util.h"
+#include "absl/container/btree_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
 #include "xls/common/logging/logging.h"
+#include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/data_structures/graph_contraction.h"
 #include "xls/delay_model/analyze_critical_path.h"
 #include "xls/delay_model/delay_estimator.h"
 #include "xls/delay_model/delay_estimators.h"
@@ -96,67 +101,369 @@ absl::StatusOr<IrForVisualization::Attributes> NodeAttributes(
   return attributes;
 }
 
-}  // namespace
+std::string SanitizeName(absl::string_view name) {
+  return absl::StrReplaceAll(name, {{".", "_"}});
+}
 
-absl::StatusOr<std::string> IrToJson(FunctionBase* function,
-                                     const DelayEstimator& delay_estimator,
-                                     const PipelineSchedule* schedule) {
-  IrForVisualization ir;
+// Holds the critical path entries of a function along with an index by node.
+struct CriticalPathMap {
+  std::vector<CriticalPathEntry> entries;
+  absl::flat_hash_map<Node*, CriticalPathEntry*> by_node;
+};
+
+CriticalPathMap ComputeCriticalPathMap(FunctionBase* function,
+                                       const DelayEstimator& delay_estimator) {
+  CriticalPathMap map;
   absl::StatusOr<std::vector<CriticalPathEntry>> critical_path =
       AnalyzeCriticalPath(function, /*clock_period_ps=*/absl::nullopt,
                           delay_estimator);
-  absl::flat_hash_map<Node*, CriticalPathEntry*> node_to_critical_path_entry;
   if (critical_path.ok()) {
-    for (CriticalPathEntry& entry : critical_path.value()) {
-      node_to_critical_path_entry[entry.node] = &entry;
+    map.entries = std::move(critical_path).value();
+    for (CriticalPathEntry& entry : map.entries) {
+      map.by_node[entry.node] = &entry;
     }
   } else {
     XLS_LOG(WARNING) << "Could not analyze critical path for function: "
                      << critical_path.status();
   }
+  return map;
+}
+
+// Adds the full (attribute-bearing) representation of the given IR node to the
+// proto.
+absl::Status AddNodeToProto(
+    Node* node,
+    const absl::flat_hash_map<Node*, CriticalPathEntry*>& critical_path_map,
+    const QueryEngine& query_engine, const PipelineSchedule* schedule,
+    IrForVisualization* ir) {
+  IrForVisualization::Node* graph_node = ir->add_nodes();
+  graph_node->set_name(node->GetName());
+  graph_node->set_id(SanitizeName(node->GetName()));
+  graph_node->set_opcode(OpToString(node->op()));
+  graph_node->set_ir(node->ToStringWithOperandTypes());
+  XLS_ASSIGN_OR_RETURN(
+      *graph_node->mutable_attributes(),
+      NodeAttributes(node, critical_path_map, query_engine, schedule));
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::string> SerializeToJson(const IrForVisualization& ir) {
+  std::string serialized_json;
+  google::protobuf::util::JsonPrintOptions print_options;
+  print_options.add_whitespace = true;
+  print_options.preserve_proto_field_names = true;
+
+  auto status =
+      google::protobuf::util::MessageToJsonString(ir, &serialized_json, print_options);
+  if (!status.ok()) {
+    return absl::InternalError(std::string{status.message()});
+  }
+  return serialized_json;
+}
+
+// One level of detail of a function's graph: maps the smallest node id in
+// each cluster to the cluster's members, in id order. The smallest member id
+// also names the cluster, so ids are stable across separate computations of
+// the same level (which is how an overview request and a later expand request
+// agree on what "cluster_42" means).
+using ContractionLevel = absl::btree_map<int64_t, std::vector<Node*>>;
+
+std::string VertexId(int64_t min_id, const std::vector<Node*>& members) {
+  if (members.size() == 1) {
+    return SanitizeName(members.front()->GetName());
+  }
+  return absl::StrCat("cluster_", min_id);
+}
+
+// Deterministically coarsens the dataflow graph of `function` until at most
+// `max_nodes` vertices remain. Each round performs a matching: visiting
+// clusters in increasing min-member-id order, each unmatched cluster is
+// identified with its unmatched neighbor of smallest min member id. Matching
+// (rather than unrestricted chaining) keeps cluster growth balanced, which is
+// what makes the coarse view informative. The loop stops early if the graph
+// can't be contracted further (e.g. max_nodes is below the number of
+// connected components).
+ContractionLevel ComputeContractionLevel(FunctionBase* function,
+                                         int64_t max_nodes) {
+  std::vector<Node*> nodes_by_id;
+  nodes_by_id.reserve(function->node_count());
+  for (Node* node : function->nodes()) {
+    nodes_by_id.push_back(node);
+  }
+  std::sort(nodes_by_id.begin(), nodes_by_id.end(),
+            [](Node* a, Node* b) { return a->id() < b->id(); });
+
+  GraphContraction<Node*, int64_t, int64_t> graph;
+  for (Node* node : nodes_by_id) {
+    graph.AddVertex(node, 1);
+  }
+  for (Node* node : nodes_by_id) {
+    for (Node* operand : node->operands()) {
+      graph.AddEdge(operand, node, operand->GetType()->GetFlatBitCount());
+    }
+  }
+
+  auto plus = [](int64_t a, int64_t b) { return a + b; };
+  // Smallest member id of each cluster, keyed by the cluster's current
+  // representative. Entries keyed by non-representatives are stale and never
+  // consulted.
+  absl::flat_hash_map<Node*, int64_t> min_id;
+  for (Node* node : nodes_by_id) {
+    min_id[node] = node->id();
+  }
+
+  int64_t remaining = nodes_by_id.size();
+  while (remaining > max_nodes) {
+    absl::flat_hash_set<Node*> matched;
+    int64_t merges = 0;
+    for (Node* node : nodes_by_id) {
+      if (remaining <= max_nodes) {
+        break;
+      }
+      Node* rep = *graph.RepresentativeOf(node);
+      // Visit each cluster once, via its smallest member.
+      if (min_id.at(rep) != node->id() || matched.contains(rep)) {
+        continue;
+      }
+      Node* best = nullptr;
+      auto consider = [&](Node* neighbor) {
+        Node* neighbor_rep = *graph.RepresentativeOf(neighbor);
+        if (neighbor_rep == rep || matched.contains(neighbor_rep)) {
+          return;
+        }
+        if (best == nullptr || min_id.at(neighbor_rep) < min_id.at(best)) {
+          best = neighbor_rep;
+        }
+      };
+      for (const auto& [neighbor, weight] : graph.EdgesOutOf(rep)) {
+        consider(neighbor);
+      }
+      for (const auto& [neighbor, weight] : graph.EdgesInto(rep)) {
+        consider(neighbor);
+      }
+      if (best == nullptr) {
+        continue;
+      }
+      int64_t merged_min_id = std::min(min_id.at(rep), min_id.at(best));
+      graph.IdentifyVertices(rep, best, plus, plus);
+      Node* new_rep = *graph.RepresentativeOf(rep);
+      min_id[new_rep] = merged_min_id;
+      matched.insert(new_rep);
+      merges++;
+      remaining--;
+    }
+    if (merges == 0) {
+      break;
+    }
+  }
+
+  ContractionLevel level;
+  for (Node* node : nodes_by_id) {
+    Node* rep = *graph.RepresentativeOf(node);
+    level[min_id.at(rep)].push_back(node);
+  }
+  return level;
+}
+
+}  // namespace
+
+absl::StatusOr<std::string> IrToJson(FunctionBase* function,
+                                     const DelayEstimator& delay_estimator,
+                                     const PipelineSchedule* schedule) {
+  IrForVisualization ir;
+  CriticalPathMap critical_path = ComputeCriticalPathMap(function,
+                                                         delay_estimator);
 
   BddQueryEngine query_engine(BddFunction::kDefaultPathLimit);
   XLS_RETURN_IF_ERROR(query_engine.Populate(function).status());
 
-  auto sanitize_name = [](absl::string_view name) {
-    return absl::StrReplaceAll(name, {{".", "_"}});
-  };
   for (Node* node : function->nodes()) {
-    IrForVisualization::Node* graph_node = ir.add_nodes();
-    graph_node->set_name(node->GetName());
-    graph_node->set_id(sanitize_name(node->GetName()));
-    graph_node->set_opcode(OpToString(node->op()));
-    graph_node->set_ir(node->ToStringWithOperandTypes());
-    XLS_ASSIGN_OR_RETURN(*graph_node->mutable_attributes(),
-                         NodeAttributes(node, node_to_critical_path_entry,
-                                        query_engine, schedule));
+    XLS_RETURN_IF_ERROR(AddNodeToProto(node, critical_path.by_node,
+                                       query_engine, schedule, &ir));
   }
 
   for (Node* node : function->nodes()) {
     for (int64_t i = 0; i < node->operand_count(); ++i) {
       Node* operand = node->operand(i);
       IrForVisualization::Edge* graph_edge = ir.add_edges();
-      std::string source = sanitize_name(operand->GetName());
-      std::string target = sanitize_name(node->GetName());
+      std::string source = SanitizeName(operand->GetName());
+      std::string target = SanitizeName(node->GetName());
       graph_edge->set_id(absl::StrFormat("%s_to_%s_%d", source, target, i));
-      graph_edge->set_source(sanitize_name(operand->GetName()));
-      graph_edge->set_target(sanitize_name(node->GetName()));
+      graph_edge->set_source(source);
+      graph_edge->set_target(target);
       graph_edge->set_type(operand->GetType()->ToString());
       graph_edge->set_bit_width(operand->GetType()->GetFlatBitCount());
     }
   }
 
-  std::string serialized_json;
-  google::protobuf::util::JsonPrintOptions print_options;
-  print_options.add_whitespace = true;
-  print_options.preserve_proto_field_names = true;
+  return SerializeToJson(ir);
+}
 
-  auto status =
-      google::protobuf::util::MessageToJsonString(ir, &serialized_json, print_options);
-  if (!status.ok()) {
-    return absl::InternalError(std::string{status.message()});
+absl::StatusOr<std::string> IrToJsonAtLevelOfDetail(
+    FunctionBase* function, const DelayEstimator& delay_estimator,
+    int64_t max_nodes, const PipelineSchedule* schedule) {
+  XLS_RET_CHECK_GT(max_nodes, 0);
+  CriticalPathMap critical_path = ComputeCriticalPathMap(function,
+                                                         delay_estimator);
+
+  BddQueryEngine query_engine(BddFunction::kDefaultPathLimit);
+  XLS_RETURN_IF_ERROR(query_engine.Populate(function).status());
+
+  ContractionLevel level = ComputeContractionLevel(function, max_nodes);
+
+  IrForVisualization ir;
+  absl::flat_hash_map<Node*, std::string> node_to_vertex_id;
+  for (const auto& [min_id, members] : level) {
+    std::string vertex_id = VertexId(min_id, members);
+    for (Node* member : members) {
+      node_to_vertex_id[member] = vertex_id;
+    }
+    if (members.size() == 1) {
+      XLS_RETURN_IF_ERROR(AddNodeToProto(members.front(),
+                                         critical_path.by_node, query_engine,
+                                         schedule, &ir));
+      continue;
+    }
+    IrForVisualization::Node* graph_node = ir.add_nodes();
+    graph_node->set_name(vertex_id);
+    graph_node->set_id(vertex_id);
+    graph_node->set_opcode("cluster");
+    graph_node->set_ir(
+        absl::StrFormat("cluster of %d nodes", members.size()));
+    IrForVisualization::Attributes* attributes =
+        graph_node->mutable_attributes();
+    attributes->set_node_count(members.size());
+    for (Node* member : members) {
+      if (critical_path.by_node.contains(member)) {
+        attributes->set_on_critical_path(true);
+        break;
+      }
+    }
   }
-  return serialized_json;
+
+  // Aggregate the original edges between the level's vertices into bundles.
+  struct BundledEdge {
+    int64_t bit_width = 0;
+    int64_t edge_count = 0;
+    std::string type;
+  };
+  absl::btree_map<std::pair<std::string, std::string>, BundledEdge> bundles;
+  for (Node* node : function->nodes()) {
+    for (Node* operand : node->operands()) {
+      const std::string& source = node_to_vertex_id.at(operand);
+      const std::string& target = node_to_vertex_id.at(node);
+      if (source == target) {
+        continue;
+      }
+      BundledEdge& bundle = bundles[{source, target}];
+      bundle.bit_width += operand->GetType()->GetFlatBitCount();
+      bundle.edge_count++;
+      if (bundle.edge_count == 1) {
+        bundle.type = operand->GetType()->ToString();
+      }
+    }
+  }
+  for (const auto& [endpoints, bundle] : bundles) {
+    const auto& [source, target] = endpoints;
+    IrForVisualization::Edge* graph_edge = ir.add_edges();
+    graph_edge->set_id(absl::StrFormat("%s_to_%s", source, target));
+    graph_edge->set_source(source);
+    graph_edge->set_target(target);
+    graph_edge->set_type(bundle.edge_count == 1
+                             ? bundle.type
+                             : absl::StrFormat("bundle of %d edges",
+                                               bundle.edge_count));
+    graph_edge->set_bit_width(bundle.bit_width);
+  }
+
+  return SerializeToJson(ir);
+}
+
+absl::StatusOr<std::string> IrClusterToJson(FunctionBase* function,
+                                            const DelayEstimator& delay_estimator,
+                                            int64_t max_nodes,
+                                            absl::string_view cluster_id,
+                                            const PipelineSchedule* schedule) {
+  XLS_RET_CHECK_GT(max_nodes, 0);
+  ContractionLevel level = ComputeContractionLevel(function, max_nodes);
+
+  absl::flat_hash_map<Node*, std::string> node_to_vertex_id;
+  const std::vector<Node*>* members = nullptr;
+  for (const auto& [min_id, level_members] : level) {
+    std::string vertex_id = VertexId(min_id, level_members);
+    for (Node* member : level_members) {
+      node_to_vertex_id[member] = vertex_id;
+    }
+    if (vertex_id == cluster_id) {
+      members = &level_members;
+    }
+  }
+  if (members == nullptr) {
+    return absl::NotFoundError(absl::StrFormat(
+        "No cluster named '%s' at a %d-node level of detail", cluster_id,
+        max_nodes));
+  }
+
+  CriticalPathMap critical_path = ComputeCriticalPathMap(function,
+                                                         delay_estimator);
+  BddQueryEngine query_engine(BddFunction::kDefaultPathLimit);
+  XLS_RETURN_IF_ERROR(query_engine.Populate(function).status());
+
+  IrForVisualization ir;
+  absl::flat_hash_set<Node*> member_set(members->begin(), members->end());
+  for (Node* member : *members) {
+    XLS_RETURN_IF_ERROR(AddNodeToProto(member, critical_path.by_node,
+                                       query_engine, schedule, &ir));
+  }
+
+  // Emit the edges touching the cluster. Edges crossing the cluster boundary
+  // attach to the neighboring vertex's coarse id, and a stub node is emitted
+  // for each such neighbor so the fragment splices cleanly into the coarse
+  // view.
+  absl::btree_map<std::string, int64_t> boundary_neighbors;  // id -> size
+  for (Node* node : function->nodes()) {
+    for (int64_t i = 0; i < node->operand_count(); ++i) {
+      Node* operand = node->operand(i);
+      bool source_inside = member_set.contains(operand);
+      bool target_inside = member_set.contains(node);
+      if (!source_inside && !target_inside) {
+        continue;
+      }
+      std::string source = source_inside ? SanitizeName(operand->GetName())
+                                         : node_to_vertex_id.at(operand);
+      std::string target = target_inside ? SanitizeName(node->GetName())
+                                         : node_to_vertex_id.at(node);
+      if (!source_inside) {
+        boundary_neighbors.insert({source, 0});
+      }
+      if (!target_inside) {
+        boundary_neighbors.insert({target, 0});
+      }
+      IrForVisualization::Edge* graph_edge = ir.add_edges();
+      graph_edge->set_id(absl::StrFormat("%s_to_%s_%d", source, target, i));
+      graph_edge->set_source(source);
+      graph_edge->set_target(target);
+      graph_edge->set_type(operand->GetType()->ToString());
+      graph_edge->set_bit_width(operand->GetType()->GetFlatBitCount());
+    }
+  }
+  for (const auto& [min_id, level_members] : level) {
+    std::string vertex_id = VertexId(min_id, level_members);
+    auto it = boundary_neighbors.find(vertex_id);
+    if (it != boundary_neighbors.end()) {
+      it->second = level_members.size();
+    }
+  }
+  for (const auto& [vertex_id, size] : boundary_neighbors) {
+    IrForVisualization::Node* graph_node = ir.add_nodes();
+    graph_node->set_name(vertex_id);
+    graph_node->set_id(vertex_id);
+    graph_node->set_opcode("cluster");
+    graph_node->set_ir(absl::StrFormat("cluster of %d nodes", size));
+    graph_node->mutable_attributes()->set_node_count(size);
+  }
+
+  return SerializeToJson(ir);
 }
 
 }  // namespace xls
@@ -31,6 +31,28 @@ absl::StatusOr<std::string> IrToJson(
     FunctionBase* function, const DelayEstimator& delay_estimator,
     const PipelineSchedule* schedule = nullptr);
 
+// As IrToJson, but coarsens the graph until at most `max_nodes` vertices
+// remain so very large functions stay renderable. Groups of nodes are folded
+// into "cluster" vertices (opcode "cluster", id "cluster_<N>") which carry
+// the member count and whether any member lies on the critical path; edges
+// between clusters are aggregated into bundles. The contraction is
+// deterministic for a given function and max_nodes, so cluster ids remain
+// valid across requests and can be expanded with IrClusterToJson.
+absl::StatusOr<std::string> IrToJsonAtLevelOfDetail(
+    FunctionBase* function, const DelayEstimator& delay_estimator,
+    int64_t max_nodes, const PipelineSchedule* schedule = nullptr);
+
+// Returns the JSON for the contents of the cluster named `cluster_id` at the
+// level of detail produced by IrToJsonAtLevelOfDetail with the same
+// `max_nodes`: the cluster's member nodes with full attributes, the edges
+// among them, and the edges to (stubs of) the neighboring vertices so the
+// fragment can be spliced into the coarse view on expand. Returns
+// kNotFound if no such cluster exists at this level of detail.
+absl::StatusOr<std::string> IrClusterToJson(
+    FunctionBase* function, const DelayEstimator& delay_estimator,
+    int64_t max_nodes, absl::string_view cluster_id,
+    const PipelineSchedule* schedule = nullptr);
+
 }  // namespace xls
 
 #endif  // XLS_IR_VISUALIZATION_IR_TO_JSON_H_
@@ -100,5 +100,58 @@ TEST_F(IrToJsonTest, SimpleFunctionWithSchedule) {
   EXPECT_THAT(json, HasSubstr(R"("cycle": 2)"));
 }
 
+TEST_F(IrToJsonTest, LevelOfDetailCoarsensGraph) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(32));
+  BValue n1 = fb.Negate(x);
+  BValue n2 = fb.Negate(n1);
+  fb.Negate(n2);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(DelayEstimator * delay_estimator,
+                           GetDelayEstimator("unit"));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::string json,
+      IrToJsonAtLevelOfDetail(f, *delay_estimator, /*max_nodes=*/2));
+  XLS_VLOG(1) << json;
+  // The four-node chain contracts into two clusters named after their
+  // smallest member ids, joined by a bundled edge.
+  EXPECT_THAT(json, HasSubstr(R"("opcode": "cluster")"));
+  EXPECT_THAT(json, HasSubstr(R"("id": "cluster_1")"));
+  EXPECT_THAT(json, HasSubstr(R"("id": "cluster_3")"));
+  EXPECT_THAT(json, HasSubstr(R"("node_count": 2)"));
+  EXPECT_THAT(json, HasSubstr(R"("id": "cluster_1_to_cluster_3")"));
+}
+
+TEST_F(IrToJsonTest, LevelOfDetailClusterExpansion) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(32));
+  BValue n1 = fb.Negate(x);
+  BValue n2 = fb.Negate(n1);
+  fb.Negate(n2);
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(DelayEstimator * delay_estimator,
+                           GetDelayEstimator("unit"));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::string json,
+      IrClusterToJson(f, *delay_estimator, /*max_nodes=*/2, "cluster_3"));
+  XLS_VLOG(1) << json;
+  // The expansion holds the cluster's members with full attributes, the edge
+  // between them, and a boundary edge from a stub of the neighboring cluster.
+  EXPECT_THAT(json, HasSubstr(R"("name": "neg.3")"));
+  EXPECT_THAT(json, HasSubstr(R"("name": "neg.4")"));
+  EXPECT_THAT(json, HasSubstr(R"("id": "neg_3_to_neg_4_0")"));
+  EXPECT_THAT(json, HasSubstr(R"("id": "cluster_1_to_neg_3_0")"));
+  EXPECT_THAT(json, HasSubstr(R"("id": "cluster_1")"));
+
+  EXPECT_THAT(
+      IrClusterToJson(f, *delay_estimator, /*max_nodes=*/2, "cluster_99")
+          .status(),
+      status_testing::StatusIs(absl::StatusCode::kNotFound));
+}
+
 }  // namespace
 }  // namespace xls
@@ -77,12 +77,69 @@ absl::StatusOr<std::string> IrToJsonWrapper(
   }
 }
 
+// As IrToJsonWrapper, but produces the graph coarsened to at most `max_nodes`
+// vertices (see IrToJsonAtLevelOfDetail).
+absl::StatusOr<std::string> IrToJsonAtLevelOfDetailWrapper(
+    absl::string_view ir_text, absl::string_view delay_model_name,
+    int64_t max_nodes, absl::optional<int64_t> pipeline_stages,
+    absl::optional<absl::string_view> entry_name) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       Parser::ParsePackage(ir_text));
+  FunctionBase* func_base;
+  if (entry_name.has_value()) {
+    XLS_ASSIGN_OR_RETURN(func_base, package->GetFunction(entry_name.value()));
+  } else {
+    XLS_ASSIGN_OR_RETURN(func_base, GetFunctionBaseToView(package.get()));
+  }
+
+  XLS_ASSIGN_OR_RETURN(DelayEstimator * delay_estimator,
+                       GetDelayEstimator(delay_model_name));
+  if (pipeline_stages.has_value()) {
+    XLS_RET_CHECK(func_base->IsFunction());
+    XLS_ASSIGN_OR_RETURN(
+        PipelineSchedule schedule,
+        PipelineSchedule::Run(
+            func_base->AsFunctionOrDie(), *delay_estimator,
+            SchedulingOptions().pipeline_stages(pipeline_stages.value())));
+    return IrToJsonAtLevelOfDetail(func_base, *delay_estimator, max_nodes,
+                                   &schedule);
+  }
+  return IrToJsonAtLevelOfDetail(func_base, *delay_estimator, max_nodes);
+}
+
+// Expands the named cluster at the given level of detail (see
+// IrClusterToJson).
+absl::StatusOr<std::string> IrClusterToJsonWrapper(
+    absl::string_view ir_text, absl::string_view delay_model_name,
+    int64_t max_nodes, absl::string_view cluster_id,
+    absl::optional<absl::string_view> entry_name) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       Parser::ParsePackage(ir_text));
+  FunctionBase* func_base;
+  if (entry_name.has_value()) {
+    XLS_ASSIGN_OR_RETURN(func_base, package->GetFunction(entry_name.value()));
+  } else {
+    XLS_ASSIGN_OR_RETURN(func_base, GetFunctionBaseToView(package.get()));
+  }
+
+  XLS_ASSIGN_OR_RETURN(DelayEstimator * delay_estimator,
+                       GetDelayEstimator(delay_model_name));
+  return IrClusterToJson(func_base, *delay_estimator, max_nodes, cluster_id);
+}
+
 PYBIND11_MODULE(ir_to_json, m) {
   ImportStatusModule();
 
   m.def("ir_to_json", &IrToJsonWrapper, py::arg("ir_text"),
         py::arg("delay_model_name"), py::arg("pipeline_stages") = absl::nullopt,
         py::arg("entry") = absl::nullopt);
+  m.def("ir_to_json_at_level_of_detail", &IrToJsonAtLevelOfDetailWrapper,
+        py::arg("ir_text"), py::arg("delay_model_name"), py::arg("max_nodes"),
+        py::arg("pipeline_stages") = absl::nullopt,
+        py::arg("entry") = absl::nullopt);
+  m.def("ir_cluster_to_json", &IrClusterToJsonWrapper, py::arg("ir_text"),
+        py::arg("delay_model_name"), py::arg("max_nodes"),
+        py::arg("cluster_id"), py::arg("entry") = absl::nullopt);
 }
 
 }  // namespace xls